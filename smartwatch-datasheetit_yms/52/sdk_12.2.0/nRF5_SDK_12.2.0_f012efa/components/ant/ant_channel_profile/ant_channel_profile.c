@@ -0,0 +1,323 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(ANT_CHANNEL_PROFILE)
+#include <string.h>
+#include "ant_channel_profile.h"
+#include "ant_key_manager.h"
+#include "ant_interface.h"
+#include "ant_parameters.h"
+
+/**@brief Configuration last applied to a channel. */
+typedef struct
+{
+    ant_channel_config_t channel;       ///< Channel configuration.
+    ant_search_config_t  search;        ///< Search configuration.
+    bool                 channel_valid; ///< The channel configuration is the one of the stack.
+    bool                 search_valid;  ///< The search configuration is the one of the stack.
+} channel_shadow_t;
+
+static channel_shadow_t m_channels[ANT_CONFIG_TOTAL_CHANNELS_ALLOCATED];
+
+static struct
+{
+    uint8_t key[ANT_CHANNEL_PROFILE_KEY_SIZE];
+    bool    valid;
+} m_networks[ANT_CHANNEL_PROFILE_CONFIG_NETWORKS];
+
+
+/**@brief Function for setting a network key, if it changed. */
+static ret_code_t key_apply(uint8_t network_number, uint8_t const * p_key)
+{
+    ret_code_t err_code;
+
+    if (network_number >= ANT_CHANNEL_PROFILE_CONFIG_NETWORKS)
+    {
+        return ant_custom_key_set(network_number, (uint8_t *)p_key);
+    }
+
+    if (m_networks[network_number].valid
+     && (memcmp(m_networks[network_number].key, p_key, ANT_CHANNEL_PROFILE_KEY_SIZE) == 0))
+    {
+        return NRF_SUCCESS;
+    }
+
+    m_networks[network_number].valid = false;
+    err_code = ant_custom_key_set(network_number, (uint8_t *)p_key);
+    VERIFY_SUCCESS(err_code);
+
+    memcpy(m_networks[network_number].key, p_key, ANT_CHANNEL_PROFILE_KEY_SIZE);
+    m_networks[network_number].valid = true;
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for applying a channel configuration, sending only the settings that changed.
+ *
+ * @param[in]  p_shadow        Configuration of the stack.
+ * @param[in]  p_config        New configuration.
+ * @param[in]  state           Channel state, from @ref sd_ant_channel_status_get.
+ */
+static ret_code_t channel_apply(channel_shadow_t           * p_shadow,
+                                ant_channel_config_t const * p_config,
+                                uint8_t                      state)
+{
+    ant_channel_config_t const * p_old = &p_shadow->channel;
+    ret_code_t                   err_code;
+    bool                         all;
+
+    all = !p_shadow->channel_valid
+       || (state == STATUS_UNASSIGNED_CHANNEL)
+       || (p_old->channel_type != p_config->channel_type)
+       || (p_old->network_number != p_config->network_number)
+       || (p_old->ext_assign != p_config->ext_assign);
+
+    p_shadow->channel_valid = false;
+
+    if (all)
+    {
+        // Assigning resets all settings of the channel, the search ones too.
+        p_shadow->search_valid = false;
+        if (state != STATUS_UNASSIGNED_CHANNEL)
+        {
+            err_code = sd_ant_channel_unassign(p_config->channel_number);
+            VERIFY_SUCCESS(err_code);
+        }
+        err_code = ant_channel_init(p_config);
+        VERIFY_SUCCESS(err_code);
+    }
+    else
+    {
+        if ((p_old->device_number != p_config->device_number)
+         || (p_old->device_type != p_config->device_type)
+         || (p_old->transmission_type != p_config->transmission_type))
+        {
+            err_code = sd_ant_channel_id_set(p_config->channel_number,
+                                             p_config->device_number,
+                                             p_config->device_type,
+                                             p_config->transmission_type);
+            VERIFY_SUCCESS(err_code);
+        }
+
+        if (p_old->rf_freq != p_config->rf_freq)
+        {
+            err_code = sd_ant_channel_radio_freq_set(p_config->channel_number, p_config->rf_freq);
+            VERIFY_SUCCESS(err_code);
+        }
+
+        if (!(p_config->ext_assign & EXT_PARAM_ALWAYS_SEARCH)
+         && (p_old->channel_period != p_config->channel_period))
+        {
+            err_code = sd_ant_channel_period_set(p_config->channel_number,
+                                                 p_config->channel_period);
+            VERIFY_SUCCESS(err_code);
+        }
+
+#if ANT_CONFIG_ENCRYPTED_CHANNELS > 0
+        if (p_old->p_crypto_settings != p_config->p_crypto_settings)
+        {
+            err_code = ant_channel_encrypt_config(p_config->channel_type,
+                                                  p_config->channel_number,
+                                                  p_config->p_crypto_settings);
+            VERIFY_SUCCESS(err_code);
+        }
+#endif
+    }
+
+    p_shadow->channel       = *p_config;
+    p_shadow->channel_valid = true;
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for applying a search configuration, sending only the settings that changed. */
+static ret_code_t search_apply(channel_shadow_t * p_shadow, ant_search_config_t const * p_config)
+{
+    ant_search_config_t const * p_old = &p_shadow->search;
+    ret_code_t                  err_code;
+
+    if (!p_shadow->search_valid)
+    {
+        err_code = ant_search_init(p_config);
+        VERIFY_SUCCESS(err_code);
+
+        p_shadow->search       = *p_config;
+        p_shadow->search_valid = true;
+        return NRF_SUCCESS;
+    }
+
+    if (p_config->low_priority_timeout == ANT_LOW_PRIORITY_SEARCH_DISABLE
+     && p_config->high_priority_timeout == ANT_HIGH_PRIORITY_SEARCH_DISABLE)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    p_shadow->search_valid = false;
+
+    if (p_old->search_priority != p_config->search_priority)
+    {
+        err_code = sd_ant_search_channel_priority_set(p_config->channel_number,
+                                                      p_config->search_priority);
+        VERIFY_SUCCESS(err_code);
+    }
+
+    if (p_old->waveform != p_config->waveform)
+    {
+        err_code = sd_ant_search_waveform_set(p_config->channel_number, p_config->waveform);
+        VERIFY_SUCCESS(err_code);
+    }
+
+    if (p_old->high_priority_timeout != p_config->high_priority_timeout)
+    {
+        err_code = sd_ant_channel_rx_search_timeout_set(p_config->channel_number,
+                                                        p_config->high_priority_timeout);
+        VERIFY_SUCCESS(err_code);
+    }
+
+    if (p_old->low_priority_timeout != p_config->low_priority_timeout)
+    {
+        err_code = sd_ant_channel_low_priority_rx_search_timeout_set(p_config->channel_number,
+                                                                     p_config->low_priority_timeout);
+        VERIFY_SUCCESS(err_code);
+    }
+
+    if (p_old->search_sharing_cycles != p_config->search_sharing_cycles)
+    {
+        err_code = sd_ant_active_search_sharing_cycles_set(p_config->channel_number,
+                                                           p_config->search_sharing_cycles);
+        VERIFY_SUCCESS(err_code);
+    }
+
+    p_shadow->search       = *p_config;
+    p_shadow->search_valid = true;
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for getting the state of a channel. */
+static ret_code_t channel_state_get(uint8_t channel_number, uint8_t * p_state)
+{
+    ret_code_t err_code;
+    uint8_t    status;
+
+    err_code = sd_ant_channel_status_get(channel_number, &status);
+    VERIFY_SUCCESS(err_code);
+
+    *p_state = status & STATUS_CHANNEL_STATE_MASK;
+    return NRF_SUCCESS;
+}
+
+
+void ant_channel_profile_init(void)
+{
+    memset(m_channels, 0, sizeof(m_channels));
+    memset(m_networks, 0, sizeof(m_networks));
+}
+
+
+/**@brief Function for applying a profile to a channel that is in the given state. */
+static ret_code_t profile_apply(ant_channel_profile_t const * p_profile, uint8_t state)
+{
+    ant_channel_config_t const * p_config = p_profile->p_channel_config;
+    channel_shadow_t           * p_shadow;
+    ret_code_t                   err_code;
+
+    if (p_config->channel_number >= ANT_CONFIG_TOTAL_CHANNELS_ALLOCATED)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    p_shadow = &m_channels[p_config->channel_number];
+
+    if (p_profile->p_network_key != NULL)
+    {
+        err_code = key_apply(p_config->network_number, p_profile->p_network_key);
+        VERIFY_SUCCESS(err_code);
+    }
+
+    err_code = channel_apply(p_shadow, p_config, state);
+    VERIFY_SUCCESS(err_code);
+
+    if (p_profile->p_search_config != NULL)
+    {
+        err_code = search_apply(p_shadow, p_profile->p_search_config);
+    }
+    return err_code;
+}
+
+
+ret_code_t ant_channel_profile_apply(ant_channel_profile_t const * p_profile)
+{
+    ret_code_t err_code;
+    uint8_t    state;
+
+    VERIFY_PARAM_NOT_NULL(p_profile);
+    VERIFY_PARAM_NOT_NULL(p_profile->p_channel_config);
+
+    err_code = channel_state_get(p_profile->p_channel_config->channel_number, &state);
+    VERIFY_SUCCESS(err_code);
+
+    if ((state == STATUS_SEARCHING_CHANNEL) || (state == STATUS_TRACKING_CHANNEL))
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    return profile_apply(p_profile, state);
+}
+
+
+ret_code_t ant_channel_profile_open(ant_channel_profile_t const * p_profiles, uint8_t count)
+{
+    ret_code_t err_code;
+    uint32_t   closed = 0;  // Bit mask of the profiles whose channel is opened.
+    uint8_t    state;
+
+    VERIFY_PARAM_NOT_NULL(p_profiles);
+
+    if (count > ANT_CONFIG_TOTAL_CHANNELS_ALLOCATED)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        VERIFY_PARAM_NOT_NULL(p_profiles[i].p_channel_config);
+
+        err_code = channel_state_get(p_profiles[i].p_channel_config->channel_number, &state);
+        VERIFY_SUCCESS(err_code);
+
+        if ((state == STATUS_SEARCHING_CHANNEL) || (state == STATUS_TRACKING_CHANNEL))
+        {
+            continue;
+        }
+
+        err_code = profile_apply(&p_profiles[i], state);
+        VERIFY_SUCCESS(err_code);
+
+        closed |= 1UL << i;
+    }
+
+    // Open all channels at once. The stack searches for them together, so the time to the first
+    // data of each sensor does not add up.
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (closed & (1UL << i))
+        {
+            err_code = sd_ant_channel_open(p_profiles[i].p_channel_config->channel_number);
+            VERIFY_SUCCESS(err_code);
+        }
+    }
+
+    return NRF_SUCCESS;
+}
+
+#endif // NRF_MODULE_ENABLED(ANT_CHANNEL_PROFILE)
@@ -0,0 +1,113 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#ifndef ANT_CHANNEL_PROFILE_H__
+#define ANT_CHANNEL_PROFILE_H__
+
+/** @file
+ *
+ * @defgroup ant_channel_profile ANT channel profile
+ * @{
+ * @ingroup ant_sdk_utils
+ * @brief Module for reopening sets of ANT channels with the fewest SoftDevice calls.
+ *
+ * @details A channel profile groups the network key, the channel configuration and the search
+ *          configuration of one channel. Profiles are constant tables, built at compile time with
+ *          the configuration macros of the ANT profiles.
+ *
+ *          The module keeps a copy of the configuration that was last applied to each channel
+ *          and network. When a profile is applied again, only the settings that differ are sent
+ *          to the SoftDevice, so reopening a channel that was only closed costs a single
+ *          status call before @ref sd_ant_channel_open. A channel that the stack has unassigned
+ *          is detected from its status and configured again.
+ *
+ *          @ref ant_channel_profile_open applies a set of profiles and then opens all channels
+ *          back to back, so that the stack searches for all of them at the same time.
+ *
+ * @note The channels and network keys of the profiles must only be configured through this
+ *       module, or the copy must be dropped with @ref ant_channel_profile_init.
+ */
+
+#include <stdint.h>
+#include "sdk_errors.h"
+#include "sdk_config.h"
+#include "ant_channel_config.h"
+#include "ant_search_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of network keys that are tracked.
+ *
+ * Keys of higher network numbers are set at every apply.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef ANT_CHANNEL_PROFILE_CONFIG_NETWORKS
+#define ANT_CHANNEL_PROFILE_CONFIG_NETWORKS 8
+#endif
+
+#define ANT_CHANNEL_PROFILE_KEY_SIZE    8   ///< Size of an ANT network key.
+
+/**@brief ANT channel profile. */
+typedef struct
+{
+    uint8_t              const * p_network_key;     ///< Network key of the network of the channel, or NULL if it is set by the application.
+    ant_channel_config_t const * p_channel_config;  ///< Channel configuration.
+    ant_search_config_t  const * p_search_config;   ///< Search configuration, or NULL to keep the one of the stack.
+} ant_channel_profile_t;
+
+/**@brief Function for dropping the copy of the applied configurations.
+ *
+ * @details Call it after @ref sd_ant_enable, and after configuring a channel or a network key of
+ *          a profile without this module.
+ */
+void ant_channel_profile_init(void);
+
+/**@brief Function for applying a profile to its channel, with the fewest SoftDevice calls.
+ *
+ * @details The channel is assigned again only when its type, network or extended assignment
+ *          changed, or when it is unassigned. The key is set only when it changed.
+ *
+ * @param[in]  p_profile       Pointer to the profile.
+ *
+ * @retval     NRF_SUCCESS              If the channel was configured.
+ * @retval     NRF_ERROR_INVALID_STATE  If the channel is open.
+ * @retval     NRF_ERROR_INVALID_PARAM  If both search time-outs disable the search.
+ * @return     Any other error code returned by the SoftDevice.
+ */
+ret_code_t ant_channel_profile_apply(ant_channel_profile_t const * p_profile);
+
+/**@brief Function for applying a set of profiles and opening their channels.
+ *
+ * @details All profiles are applied first, and the channels are then opened one after the
+ *          other without waiting for any event. Channels that are already open are left as they
+ *          are. Give each channel low priority search or search sharing cycles in its search
+ *          configuration, so that no high priority search holds the searches of the others.
+ *
+ * @param[in]  p_profiles      Array of profiles.
+ * @param[in]  count           Number of profiles.
+ *
+ * @retval     NRF_SUCCESS              If all channels were opened.
+ * @retval     NRF_ERROR_INVALID_PARAM  If there are more profiles than channels.
+ * @return     Otherwise, the error of the first profile that failed. No channel is opened if a
+ *             profile could not be applied.
+ */
+ret_code_t ant_channel_profile_open(ant_channel_profile_t const * p_profiles, uint8_t count);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ANT_CHANNEL_PROFILE_H__
+/** @} */
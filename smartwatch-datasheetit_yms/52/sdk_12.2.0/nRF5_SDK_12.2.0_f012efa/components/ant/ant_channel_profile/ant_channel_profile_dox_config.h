@@ -0,0 +1,24 @@
+/**
+ *
+ * @defgroup ant_channel_profile_config ANT channel profile configuration
+ * @{
+ * @ingroup ant_channel_profile
+ */
+/** @brief Enable ANT channel profile
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ANT_CHANNEL_PROFILE_ENABLED
+
+
+/** @brief Number of network keys that are tracked
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ANT_CHANNEL_PROFILE_CONFIG_NETWORKS
+
+
+/** @} */
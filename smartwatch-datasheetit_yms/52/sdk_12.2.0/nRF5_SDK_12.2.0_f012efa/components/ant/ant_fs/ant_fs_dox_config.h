@@ -133,6 +133,34 @@
 #define ANTFS_CONFIG_UPLOAD_ENABLED
 
 
+/** @brief Number of burst packets (8 bytes each) requested from the application per download data event.
+ *
+ *  Larger blocks mean fewer reads from the file system per burst.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ANTFS_CONFIG_BURST_BLOCK_SIZE
+
+
+/** @brief Size of the event queue. A power of two.
+ *
+ *  Every burst packet of an upload is one event: a deeper queue gives the application
+ *  more time to write the data to the file system.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ANTFS_CONFIG_EVENT_QUEUE_SIZE
+
+
+/** @brief Use a byte lookup table for the CRC (512 bytes of flash) instead of a nibble table.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ANTFS_CONFIG_CRC_BYTE_TABLE_ENABLED
+
+
 /** @brief Enables LED debug in the module.
  *
  *  Set to 1 to activate.
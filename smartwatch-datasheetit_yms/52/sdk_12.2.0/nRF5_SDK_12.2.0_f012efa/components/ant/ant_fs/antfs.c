@@ -121,7 +121,10 @@ All rights reserved.
 
 #define AUTHENTICATION_RETRIES             0x05u                         /**< Max number of retries for authentication responses */
 
-#define ANTFS_EVENT_QUEUE_SIZE             0x04u                         /**< ANT-FS event queue size. */
+#ifndef ANTFS_CONFIG_EVENT_QUEUE_SIZE
+#define ANTFS_CONFIG_EVENT_QUEUE_SIZE      0x04u
+#endif
+#define ANTFS_EVENT_QUEUE_SIZE             ANTFS_CONFIG_EVENT_QUEUE_SIZE /**< ANT-FS event queue size. */
 #define SAVE_DISTANCE                       256u                         /**< Save distance required because of nRF buffer to line up data offset on retry. */
 
 // Buffer Indices.
@@ -200,6 +203,8 @@ static uint16_t m_saved_transfer_crc;                                     /**< 1
 static uint16_t m_saved_buffer_crc;                                       /**< 16-bit CRC saved at last CRC update (save point) for buffering the nRF */
 
 // ANT-FS event handling.
+STATIC_ASSERT(IS_POWER_OF_TWO(ANTFS_EVENT_QUEUE_SIZE));
+
 static antfs_event_return_t m_event_queue_buffer[ANTFS_EVENT_QUEUE_SIZE]; /**< Event queue storage. */
 static antfs_event_queue_t m_event_queue;                                 /**< Event queue. */
 
@@ -885,6 +890,12 @@ uint32_t antfs_input_data_download(uint16_t index,
                 APP_ERROR_CHECK(err_code);
             }
 
+            // The burst handler only reads the buffer: run the CRC while the packets go out,
+            // instead of after they have.
+            m_transfer_crc = crc_crc16_update(m_transfer_crc,
+                                              &(p_message[block_offset]),
+                                              num_bytes);
+
             wait_burst_request_to_complete();
 
             // Update current burst index.
@@ -894,10 +905,6 @@ uint32_t antfs_input_data_download(uint16_t index,
 
             m_is_data_request_pending = false;
 
-            m_transfer_crc = crc_crc16_update(m_transfer_crc,
-                                              &(p_message[block_offset]),
-                                              num_bytes);
-
             if ((m_link_burst_index.data - m_temp_crc_offset) > SAVE_DISTANCE)
             {
                 // Set CRC save point
@@ -98,7 +98,10 @@ extern "C" {
 #define ANTFS_DIR_APPEND_MASK             0x08u                                                                                          /**< Append (can append to file only). */
 
 #define ANTFS_MAX_FILE_SIZE               0xFFFFFFFFu                                                                                    /**< Maximum file size, as specified by directory structure. */
-#define ANTFS_BURST_BLOCK_SIZE            16u                                                                                            /**< Size of each block of burst data that the client attempts to send when it processes a data request event. */
+#ifndef ANTFS_CONFIG_BURST_BLOCK_SIZE
+#define ANTFS_CONFIG_BURST_BLOCK_SIZE     16u
+#endif
+#define ANTFS_BURST_BLOCK_SIZE            ANTFS_CONFIG_BURST_BLOCK_SIZE                                                                  /**< Size of each block of burst data that the client attempts to send when it processes a data request event. */
 
 /**@brief ANT-FS beacon status. */
 typedef union
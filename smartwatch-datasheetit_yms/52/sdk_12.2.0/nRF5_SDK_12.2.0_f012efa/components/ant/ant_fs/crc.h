@@ -20,11 +20,26 @@ All rights reserved.
 #define CRC_H__
 
 #include <stdint.h>
+#include "sdk_config.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**@brief Use a 256-entry (512-byte) lookup table, one lookup per byte, instead of the 16-entry
+ *        (32-byte) nibble table with two lookups per byte.
+ *
+ * Burst transfers run the CRC over every byte sent or received. The default is the byte table,
+ * except on nRF51 where flash is tight.
+ */
+#ifndef ANTFS_CONFIG_CRC_BYTE_TABLE_ENABLED
+#ifdef NRF51
+#define ANTFS_CONFIG_CRC_BYTE_TABLE_ENABLED 0
+#else
+#define ANTFS_CONFIG_CRC_BYTE_TABLE_ENABLED 1
+#endif
+#endif
+
 /**@brief Function for calculating CRC-16 in blocks.
  *
  * Feed each consecutive data block into this function, along with the current value of current_crc
@@ -0,0 +1,96 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "sdk_common.h"
+#include "ant_page_codec.h"
+#include "nrf_assert.h"
+
+
+void ant_page_encode(ant_page_desc_t const * p_desc,
+                     uint8_t               * p_payload,
+                     void const            * p_page_data)
+{
+    uint8_t const * p_data = (uint8_t const *)p_page_data;
+
+    for (uint8_t i = 0; i < p_desc->field_count; i++)
+    {
+        ant_page_field_t const * p_field = &p_desc->p_fields[i];
+        uint32_t                 value;
+
+        switch (p_field->data_size)
+        {
+            case sizeof(uint8_t):
+                value = p_data[p_field->data_offset];
+                break;
+
+            case sizeof(uint16_t):
+                value = *(uint16_t const *)&p_data[p_field->data_offset];
+                break;
+
+            default:
+                ASSERT(p_field->data_size == sizeof(uint32_t));
+                value = *(uint32_t const *)&p_data[p_field->data_offset];
+                break;
+        }
+
+        for (uint8_t j = 0; j < p_field->payload_size; j++)
+        {
+            p_payload[p_field->payload_offset + j] = (uint8_t)value;
+            value >>= 8;
+        }
+    }
+
+    if (p_desc->log != NULL)
+    {
+        p_desc->log(p_page_data);
+    }
+}
+
+
+void ant_page_decode(ant_page_desc_t const * p_desc,
+                     uint8_t const         * p_payload,
+                     void                  * p_page_data)
+{
+    uint8_t * p_data = (uint8_t *)p_page_data;
+
+    for (uint8_t i = 0; i < p_desc->field_count; i++)
+    {
+        ant_page_field_t const * p_field = &p_desc->p_fields[i];
+        uint32_t                 value   = 0;
+
+        for (uint8_t j = p_field->payload_size; j > 0; j--)
+        {
+            value = (value << 8) | p_payload[p_field->payload_offset + j - 1];
+        }
+
+        switch (p_field->data_size)
+        {
+            case sizeof(uint8_t):
+                p_data[p_field->data_offset] = (uint8_t)value;
+                break;
+
+            case sizeof(uint16_t):
+                *(uint16_t *)&p_data[p_field->data_offset] = (uint16_t)value;
+                break;
+
+            default:
+                ASSERT(p_field->data_size == sizeof(uint32_t));
+                *(uint32_t *)&p_data[p_field->data_offset] = value;
+                break;
+        }
+    }
+
+    if (p_desc->log != NULL)
+    {
+        p_desc->log(p_page_data);
+    }
+}
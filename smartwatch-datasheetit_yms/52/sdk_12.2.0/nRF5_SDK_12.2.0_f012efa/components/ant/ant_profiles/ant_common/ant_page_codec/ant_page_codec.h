@@ -0,0 +1,112 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ant_page_codec ANT page codec
+ * @{
+ * @ingroup ant_sdk_utils
+ *
+ * @brief   Module for encoding and decoding ANT+ data pages from field descriptors.
+ *
+ * @details A page is described by a constant table of fields, built at compile time with
+ *          @ref ANT_PAGE_FIELD from the page data structure. Each field maps a little-endian
+ *          value of 1 to 4 bytes in the page payload to an unsigned member of the structure.
+ *          The same table is used to encode and to decode the page, so a profile can keep a
+ *          table of pages indexed by page number in place of a switch over page functions.
+ */
+
+#ifndef ANT_PAGE_CODEC_H__
+#define ANT_PAGE_CODEC_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**@brief Field of a page. */
+typedef struct
+{
+    uint8_t payload_offset; ///< Offset of the value in the page payload.
+    uint8_t payload_size;   ///< Size of the value in the page payload, 1 to 4 bytes.
+    uint8_t data_offset;    ///< Offset of the member in the page data structure.
+    uint8_t data_size;      ///< Size of the member: 1, 2 or 4 bytes.
+} ant_page_field_t;
+
+/**@brief Page descriptor. */
+typedef struct
+{
+    ant_page_field_t const * p_fields;    ///< Fields of the page.
+    uint8_t                  field_count; ///< Number of fields.
+    void                  (* log)(void const * p_page_data); ///< Function for tracing the page data, or NULL.
+} ant_page_desc_t;
+
+/**@brief Macro for describing a field of a page.
+ *
+ * @param[in] TYPE           Page data structure type.
+ * @param[in] MEMBER         Unsigned member of the structure.
+ * @param[in] PAYLOAD_OFFSET Offset of the value in the page payload.
+ * @param[in] PAYLOAD_SIZE   Size of the value in the page payload, in bytes.
+ */
+#define ANT_PAGE_FIELD(TYPE, MEMBER, PAYLOAD_OFFSET, PAYLOAD_SIZE)  \
+    {                                                               \
+        .payload_offset = (PAYLOAD_OFFSET),                         \
+        .payload_size   = (PAYLOAD_SIZE),                           \
+        .data_offset    = offsetof(TYPE, MEMBER),                   \
+        .data_size      = sizeof(((TYPE *)0)->MEMBER),              \
+    }
+
+/**@brief Macro for defining a page descriptor from an array of fields.
+ *
+ * @param[in] NAME     Name of the descriptor.
+ * @param[in] FIELDS   Array of @ref ant_page_field_t.
+ * @param[in] LOG_FUNC Function for tracing the page data, or NULL.
+ */
+#define ANT_PAGE_DESC_DEF(NAME, FIELDS, LOG_FUNC)                   \
+    const ant_page_desc_t NAME =                                    \
+    {                                                               \
+        .p_fields    = (FIELDS),                                    \
+        .field_count = sizeof(FIELDS) / sizeof((FIELDS)[0]),        \
+        .log         = (LOG_FUNC),                                  \
+    }
+
+/**@brief Function for encoding a page.
+ *
+ * Only the bytes of the fields are written to the payload.
+ *
+ * @param[in]  p_desc      Page descriptor.
+ * @param[out] p_payload   Page payload.
+ * @param[in]  p_page_data Page data structure.
+ */
+void ant_page_encode(ant_page_desc_t const * p_desc,
+                     uint8_t               * p_payload,
+                     void const            * p_page_data);
+
+/**@brief Function for decoding a page.
+ *
+ * @param[in]  p_desc      Page descriptor.
+ * @param[in]  p_payload   Page payload.
+ * @param[out] p_page_data Page data structure.
+ */
+void ant_page_decode(ant_page_desc_t const * p_desc,
+                     uint8_t const         * p_payload,
+                     void                  * p_page_data);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ANT_PAGE_CODEC_H__
+/** @} */
@@ -42,6 +42,26 @@ typedef struct
     uint8_t        page_payload[7];
 } ant_hrm_message_layout_t;
 
+/**@brief HRM page, as an entry of the page table. */
+typedef struct
+{
+    ant_page_desc_t const * p_desc;      ///< Page descriptor, or NULL if the page has only page 0 data.
+    uint8_t                 data_offset; ///< Offset of the page data in @ref ant_hrm_profile_t.
+} ant_hrm_page_entry_t;
+
+#define HRM_PAGE_ENTRY(NUM) {&ant_hrm_page_##NUM##_desc, offsetof(ant_hrm_profile_t, page_##NUM)}
+
+/**@brief Pages indexed by page number. Page 0 is present in each message, so it is handled
+ *        separately. */
+static const ant_hrm_page_entry_t m_pages[] =
+{
+    [ANT_HRM_PAGE_0] = {NULL, 0},
+    [ANT_HRM_PAGE_1] = HRM_PAGE_ENTRY(1),
+    [ANT_HRM_PAGE_2] = HRM_PAGE_ENTRY(2),
+    [ANT_HRM_PAGE_3] = HRM_PAGE_ENTRY(3),
+    [ANT_HRM_PAGE_4] = HRM_PAGE_ENTRY(4),
+};
+
 /**@brief Function for initializing the ANT HRM profile instance.
  *
  * @param[in]  p_profile        Pointer to the profile instance.
@@ -163,30 +183,18 @@ static void sens_message_encode(ant_hrm_profile_t * p_profile, uint8_t * p_messa
 
     ant_hrm_page_0_encode(p_hrm_message_payload->page_payload, &(p_profile->page_0)); // Page 0 is present in each message
 
-    switch (p_hrm_message_payload->page_number)
+    if (p_hrm_message_payload->page_number >= ARRAY_SIZE(m_pages))
     {
-        case ANT_HRM_PAGE_0:
-            // No implementation needed
-            break;
-
-        case ANT_HRM_PAGE_1:
-            ant_hrm_page_1_encode(p_hrm_message_payload->page_payload, &(p_profile->page_1));
-            break;
-
-        case ANT_HRM_PAGE_2:
-            ant_hrm_page_2_encode(p_hrm_message_payload->page_payload, &(p_profile->page_2));
-            break;
-
-        case ANT_HRM_PAGE_3:
-            ant_hrm_page_3_encode(p_hrm_message_payload->page_payload, &(p_profile->page_3));
-            break;
+        return;
+    }
 
-        case ANT_HRM_PAGE_4:
-            ant_hrm_page_4_encode(p_hrm_message_payload->page_payload, &(p_profile->page_4));
-            break;
+    ant_hrm_page_entry_t const * p_entry = &m_pages[p_hrm_message_payload->page_number];
 
-        default:
-            return;
+    if (p_entry->p_desc != NULL)
+    {
+        ant_page_encode(p_entry->p_desc,
+                        p_hrm_message_payload->page_payload,
+                        (uint8_t const *)p_profile + p_entry->data_offset);
     }
 
     p_profile->evt_handler(p_profile, (ant_hrm_evt_t)p_hrm_message_payload->page_number);
@@ -262,30 +270,18 @@ static void disp_message_decode(ant_hrm_profile_t * p_profile, uint8_t * p_messa
 
     ant_hrm_page_0_decode(p_hrm_message_payload->page_payload, &(p_profile->page_0)); // Page 0 is present in each message
 
-    switch (p_hrm_message_payload->page_number)
+    if (p_hrm_message_payload->page_number >= ARRAY_SIZE(m_pages))
     {
-        case ANT_HRM_PAGE_0:
-            // No implementation needed
-            break;
-
-        case ANT_HRM_PAGE_1:
-            ant_hrm_page_1_decode(p_hrm_message_payload->page_payload, &(p_profile->page_1));
-            break;
-
-        case ANT_HRM_PAGE_2:
-            ant_hrm_page_2_decode(p_hrm_message_payload->page_payload, &(p_profile->page_2));
-            break;
-
-        case ANT_HRM_PAGE_3:
-            ant_hrm_page_3_decode(p_hrm_message_payload->page_payload, &(p_profile->page_3));
-            break;
+        return;
+    }
 
-        case ANT_HRM_PAGE_4:
-            ant_hrm_page_4_decode(p_hrm_message_payload->page_payload, &(p_profile->page_4));
-            break;
+    ant_hrm_page_entry_t const * p_entry = &m_pages[p_hrm_message_payload->page_number];
 
-        default:
-            return;
+    if (p_entry->p_desc != NULL)
+    {
+        ant_page_decode(p_entry->p_desc,
+                        p_hrm_message_payload->page_payload,
+                        (uint8_t *)p_profile + p_entry->data_offset);
     }
 
     p_profile->evt_handler(p_profile, (ant_hrm_evt_t)p_hrm_message_payload->page_number);
@@ -25,23 +25,15 @@
 #endif // ANT_HRM_PAGE_0_LOG_ENABLED
 #include "nrf_log.h"
 
-/**@brief HRM page 0 data layout structure. */
-typedef struct
-{
-    uint8_t reserved[3];
-    uint8_t heart_beat_evt_time_LSB;
-    uint8_t heart_beat_evt_time_MSB;
-    uint8_t heart_beat_count;
-    uint8_t computed_heart_rate;
-}ant_hrm_page0_data_layout_t;
-
 /**@brief Function for tracing page 0 and common data.
  *
  * @param[in]  p_common_data    Pointer to the common data.
  * @param[in]  p_page_data      Pointer to the page 0 data.
  */
-static void page0_data_log(ant_hrm_page0_data_t const * p_page_data)
+static void page0_data_log(void const * p_data)
 {
+    ant_hrm_page0_data_t const * p_page_data = (ant_hrm_page0_data_t const *)p_data;
+
     NRF_LOG_INFO("Heart beat count:                 %u\r\n", (unsigned int)p_page_data->beat_count);
     NRF_LOG_INFO("Computed heart rate:              %u\r\n",
                  (unsigned int) p_page_data->computed_heart_rate);
@@ -51,38 +43,30 @@ static void page0_data_log(ant_hrm_page0_data_t const * p_page_data)
 }
 
 
-void ant_hrm_page_0_encode(uint8_t                    * p_page_buffer,
-                           ant_hrm_page0_data_t const * p_page_data)
+/**@brief HRM page 0 fields. */
+static const ant_page_field_t m_page0_fields[] =
 {
-    ant_hrm_page0_data_layout_t * p_outcoming_data = (ant_hrm_page0_data_layout_t *)p_page_buffer;
-    uint32_t                      beat_time        = p_page_data->beat_time;
+    ANT_PAGE_FIELD(ant_hrm_page0_data_t, beat_time,           3, 2),
+    ANT_PAGE_FIELD(ant_hrm_page0_data_t, beat_count,          5, 1),
+    ANT_PAGE_FIELD(ant_hrm_page0_data_t, computed_heart_rate, 6, 1),
+};
+
+ANT_PAGE_DESC_DEF(ant_hrm_page_0_desc, m_page0_fields, page0_data_log);
 
-    p_outcoming_data->reserved[0]             = UINT8_MAX;
-    p_outcoming_data->reserved[1]             = UINT8_MAX;
-    p_outcoming_data->reserved[2]             = UINT8_MAX;
-    p_outcoming_data->heart_beat_evt_time_LSB = (uint8_t)(beat_time & UINT8_MAX);
-    p_outcoming_data->heart_beat_evt_time_MSB = (uint8_t)((beat_time >> 8) & UINT8_MAX);
-    p_outcoming_data->heart_beat_count        = (uint8_t)p_page_data->beat_count;
-    p_outcoming_data->computed_heart_rate     = (uint8_t)p_page_data->computed_heart_rate;
 
-    page0_data_log(p_page_data);
+void ant_hrm_page_0_encode(uint8_t                    * p_page_buffer,
+                           ant_hrm_page0_data_t const * p_page_data)
+{
+    // Reserved bytes, overwritten by the other pages.
+    memset(p_page_buffer, UINT8_MAX, 3);
+    ant_page_encode(&ant_hrm_page_0_desc, p_page_buffer, p_page_data);
 }
 
 
 void ant_hrm_page_0_decode(uint8_t const        * p_page_buffer,
                            ant_hrm_page0_data_t * p_page_data)
 {
-    ant_hrm_page0_data_layout_t const * p_incoming_data =
-        (ant_hrm_page0_data_layout_t *)p_page_buffer;
-
-    uint32_t beat_time = (uint32_t)((p_incoming_data->heart_beat_evt_time_MSB << 8)
-                                    + p_incoming_data->heart_beat_evt_time_LSB);
-
-    p_page_data->beat_count          = (uint32_t)p_incoming_data->heart_beat_count;
-    p_page_data->computed_heart_rate = (uint32_t)p_incoming_data->computed_heart_rate;
-    p_page_data->beat_time           = beat_time;
-
-    page0_data_log(p_page_data);
+    ant_page_decode(&ant_hrm_page_0_desc, p_page_buffer, p_page_data);
 }
 
 #endif // NRF_MODULE_ENABLED(ANT_HRM)
@@ -20,6 +20,7 @@
  */
 
 #include <stdint.h>
+#include "ant_page_codec.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -46,6 +47,9 @@ typedef struct
         .beat_time           = 0, \
     }
 
+/**@brief Descriptor of page 0, for @ref ant_page_encode and @ref ant_page_decode. */
+extern const ant_page_desc_t ant_hrm_page_0_desc;
+
 /**@brief Function for encoding page 0.
  *
  * @param[in]  p_page_data      Pointer to the page data.
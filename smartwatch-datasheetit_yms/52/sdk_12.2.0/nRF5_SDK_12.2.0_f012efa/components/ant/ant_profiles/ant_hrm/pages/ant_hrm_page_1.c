@@ -25,20 +25,15 @@
 #endif // ANT_HRM_PAGE_1_LOG_ENABLED
 #include "nrf_log.h"
 
-/**@brief HRM page 1 data layout structure. */
-typedef struct
-{
-    uint8_t cumulative_operating_time[3];
-    uint8_t reserved[4];
-}ant_hrm_page1_data_layout_t;
-
 /**@brief Function for tracing page 1 and common data.
  *
  * @param[in]  p_common_data    Pointer to the common data.
  * @param[in]  p_page_data      Pointer to the page 1 data.
  */
-static void page1_data_log(ant_hrm_page1_data_t const * p_page_data)
+static void page1_data_log(void const * p_data)
 {
+    ant_hrm_page1_data_t const * p_page_data = (ant_hrm_page1_data_t const *)p_data;
+
     NRF_LOG_INFO("Cumulative operating time:        %ud %uh %um %us\r\n\n",
                  (unsigned int) ANT_HRM_OPERATING_DAYS(p_page_data->operating_time),
                  (unsigned int) ANT_HRM_OPERATING_HOURS(p_page_data->operating_time),
@@ -47,28 +42,26 @@ static void page1_data_log(ant_hrm_page1_data_t const * p_page_data)
 }
 
 
+/**@brief HRM page 1 fields. */
+static const ant_page_field_t m_page1_fields[] =
+{
+    ANT_PAGE_FIELD(ant_hrm_page1_data_t, operating_time, 0, 3),
+};
+
+ANT_PAGE_DESC_DEF(ant_hrm_page_1_desc, m_page1_fields, page1_data_log);
+
+
 void ant_hrm_page_1_encode(uint8_t                    * p_page_buffer,
                            ant_hrm_page1_data_t const * p_page_data)
 {
-    ant_hrm_page1_data_layout_t * p_outcoming_data = (ant_hrm_page1_data_layout_t *)p_page_buffer;
-    uint32_t                      operating_time   = p_page_data->operating_time;
-
-    UNUSED_PARAMETER(uint24_encode(operating_time, p_outcoming_data->cumulative_operating_time));
-    page1_data_log(p_page_data);
+    ant_page_encode(&ant_hrm_page_1_desc, p_page_buffer, p_page_data);
 }
 
 
 void ant_hrm_page_1_decode(uint8_t const        * p_page_buffer,
                            ant_hrm_page1_data_t * p_page_data)
 {
-    ant_hrm_page1_data_layout_t const * p_incoming_data =
-        (ant_hrm_page1_data_layout_t *)p_page_buffer;
-
-    uint32_t operating_time = uint24_decode(p_incoming_data->cumulative_operating_time);
-
-    p_page_data->operating_time = operating_time;
-
-    page1_data_log(p_page_data);
+    ant_page_decode(&ant_hrm_page_1_desc, p_page_buffer, p_page_data);
 }
 
 #endif // NRF_MODULE_ENABLED(ANT_HRM)
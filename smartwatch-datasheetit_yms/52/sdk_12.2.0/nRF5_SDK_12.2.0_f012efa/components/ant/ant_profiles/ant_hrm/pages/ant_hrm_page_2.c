@@ -24,55 +24,41 @@
 #endif // ANT_HRM_PAGE_2_LOG_ENABLED
 #include "nrf_log.h"
 
-/**@brief HRM page 2 data layout structure. */
-typedef struct
-{
-    uint8_t manuf_id;
-    uint8_t serial_num_LSB;
-    uint8_t serial_num_MSB;
-    uint8_t reserved[4];
-}ant_hrm_page2_data_layout_t;
-
 /**@brief Function for tracing page 2 and common data.
  *
  * @param[in]  p_common_data    Pointer to the common data.
  * @param[in]  p_page_data      Pointer to the page 2 data.
  */
-static void page2_data_log(ant_hrm_page2_data_t const * p_page_data)
+static void page2_data_log(void const * p_data)
 {
+    ant_hrm_page2_data_t const * p_page_data = (ant_hrm_page2_data_t const *)p_data;
+
     NRF_LOG_INFO("Manufacturer ID:                  %u\r\n", (unsigned int)p_page_data->manuf_id);
     NRF_LOG_INFO("Serial No (upper 16-bits):        0x%X\r\n\n", (unsigned int)p_page_data->serial_num);
 }
 
 
-void ant_hrm_page_2_encode(uint8_t                    * p_page_buffer,
-                           ant_hrm_page2_data_t const * p_page_data)
+/**@brief HRM page 2 fields. */
+static const ant_page_field_t m_page2_fields[] =
 {
-    ant_hrm_page2_data_layout_t * p_outcoming_data = (ant_hrm_page2_data_layout_t *)p_page_buffer;
-    uint32_t                      serial_num       = p_page_data->serial_num;
+    ANT_PAGE_FIELD(ant_hrm_page2_data_t, manuf_id,   0, 1),
+    ANT_PAGE_FIELD(ant_hrm_page2_data_t, serial_num, 1, 2),
+};
+
+ANT_PAGE_DESC_DEF(ant_hrm_page_2_desc, m_page2_fields, page2_data_log);
 
-    p_outcoming_data->manuf_id       = (uint8_t)p_page_data->manuf_id;
-    p_outcoming_data->serial_num_LSB = (uint8_t)(serial_num & UINT8_MAX);
-    p_outcoming_data->serial_num_MSB = (uint8_t)((serial_num >> 8) & UINT8_MAX);
 
-    page2_data_log(p_page_data);
+void ant_hrm_page_2_encode(uint8_t                    * p_page_buffer,
+                           ant_hrm_page2_data_t const * p_page_data)
+{
+    ant_page_encode(&ant_hrm_page_2_desc, p_page_buffer, p_page_data);
 }
 
 
 void ant_hrm_page_2_decode(uint8_t const        * p_page_buffer,
                            ant_hrm_page2_data_t * p_page_data)
 {
-    ant_hrm_page2_data_layout_t const * p_incoming_data =
-        (ant_hrm_page2_data_layout_t *)p_page_buffer;
-    uint32_t serial_num =
-        (uint32_t)((p_incoming_data->serial_num_MSB << 8)
-                   + p_incoming_data->
-                   serial_num_LSB);
-
-    p_page_data->manuf_id   = (uint32_t)p_incoming_data->manuf_id;
-    p_page_data->serial_num = serial_num;
-
-    page2_data_log(p_page_data);
+    ant_page_decode(&ant_hrm_page_2_desc, p_page_buffer, p_page_data);
 }
 
 #endif // NRF_MODULE_ENABLED(ANT_HRM)
@@ -24,52 +24,43 @@
 #endif // ANT_HRM_PAGE_3_LOG_ENABLED
 #include "nrf_log.h"
 
-/**@brief HRM page 3 data layout structure. */
-typedef struct
-{
-    uint8_t hw_version;
-    uint8_t sw_version;
-    uint8_t model_num;
-    uint8_t reserved[4];
-}ant_hrm_page3_data_layout_t;
-
 /**@brief Function for tracing page 3 and common data.
  *
  * @param[in]  p_common_data    Pointer to the common data.
  * @param[in]  p_page_data      Pointer to the page 3 data.
  */
-static void page3_data_log(ant_hrm_page3_data_t const * p_page_data)
+static void page3_data_log(void const * p_data)
 {
+    ant_hrm_page3_data_t const * p_page_data = (ant_hrm_page3_data_t const *)p_data;
+
     NRF_LOG_INFO("Hardware Rev ID                   %u\r\n", (unsigned int)p_page_data->hw_version);
     NRF_LOG_INFO("Model                             %u\r\n", (unsigned int)p_page_data->model_num);
     NRF_LOG_INFO("Software Ver ID                   %u\r\n\n", (unsigned int)p_page_data->sw_version);
 }
 
 
-void ant_hrm_page_3_encode(uint8_t                    * p_page_buffer,
-                           ant_hrm_page3_data_t const * p_page_data)
+/**@brief HRM page 3 fields. */
+static const ant_page_field_t m_page3_fields[] =
 {
-    ant_hrm_page3_data_layout_t * p_outcoming_data = (ant_hrm_page3_data_layout_t *)p_page_buffer;
+    ANT_PAGE_FIELD(ant_hrm_page3_data_t, hw_version, 0, 1),
+    ANT_PAGE_FIELD(ant_hrm_page3_data_t, sw_version, 1, 1),
+    ANT_PAGE_FIELD(ant_hrm_page3_data_t, model_num,  2, 1),
+};
+
+ANT_PAGE_DESC_DEF(ant_hrm_page_3_desc, m_page3_fields, page3_data_log);
 
-    p_outcoming_data->hw_version = (uint8_t)p_page_data->hw_version;
-    p_outcoming_data->sw_version = (uint8_t)p_page_data->sw_version;
-    p_outcoming_data->model_num  = (uint8_t)p_page_data->model_num;
 
-    page3_data_log(p_page_data);
+void ant_hrm_page_3_encode(uint8_t                    * p_page_buffer,
+                           ant_hrm_page3_data_t const * p_page_data)
+{
+    ant_page_encode(&ant_hrm_page_3_desc, p_page_buffer, p_page_data);
 }
 
 
 void ant_hrm_page_3_decode(uint8_t const        * p_page_buffer,
                            ant_hrm_page3_data_t * p_page_data)
 {
-    ant_hrm_page3_data_layout_t const * p_incoming_data =
-        (ant_hrm_page3_data_layout_t *)p_page_buffer;
-
-    p_page_data->hw_version = (uint32_t)p_incoming_data->hw_version;
-    p_page_data->sw_version = (uint32_t)p_incoming_data->sw_version;
-    p_page_data->model_num  = (uint32_t)p_incoming_data->model_num;
-
-    page3_data_log(p_page_data);
+    ant_page_decode(&ant_hrm_page_3_desc, p_page_buffer, p_page_data);
 }
 
 #endif // NRF_MODULE_ENABLED(ANT_HRM)
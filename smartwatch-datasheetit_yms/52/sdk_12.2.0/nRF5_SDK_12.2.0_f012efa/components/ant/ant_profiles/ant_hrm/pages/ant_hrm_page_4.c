@@ -25,55 +25,42 @@
 #endif // ANT_HRM_PAGE_4_LOG_ENABLED
 #include "nrf_log.h"
 
-/**@brief HRM page 4 data layout structure. */
-typedef struct
-{
-    uint8_t manuf_spec;
-    uint8_t prev_beat_LSB;
-    uint8_t prev_beat_MSB;
-    uint8_t reserved[4];
-}ant_hrm_page4_data_layout_t;
-
 /**@brief Function for tracing page 4 and common data.
  *
  * @param[in]  p_common_data    Pointer to the common data.
  * @param[in]  p_page_data      Pointer to the page 4 data.
  */
-static void page4_data_log(ant_hrm_page4_data_t const * p_page_data)
+static void page4_data_log(void const * p_data)
 {
+    ant_hrm_page4_data_t const * p_page_data = (ant_hrm_page4_data_t const *)p_data;
+
     NRF_LOG_INFO("Previous heart beat event time:   %u.%03us\r\n\n",
                  (unsigned int)ANT_HRM_BEAT_TIME_SEC(p_page_data->prev_beat),
                  (unsigned int)ANT_HRM_BEAT_TIME_MSEC(p_page_data->prev_beat));
 }
 
 
-void ant_hrm_page_4_encode(uint8_t                    * p_page_buffer,
-                           ant_hrm_page4_data_t const * p_page_data)
+/**@brief HRM page 4 fields. */
+static const ant_page_field_t m_page4_fields[] =
 {
-    ant_hrm_page4_data_layout_t * p_outcoming_data = (ant_hrm_page4_data_layout_t *)p_page_buffer;
-    uint32_t                      prev_beat        = p_page_data->prev_beat;
+    ANT_PAGE_FIELD(ant_hrm_page4_data_t, manuf_spec, 0, 1),
+    ANT_PAGE_FIELD(ant_hrm_page4_data_t, prev_beat,  1, 2),
+};
+
+ANT_PAGE_DESC_DEF(ant_hrm_page_4_desc, m_page4_fields, page4_data_log);
 
-    p_outcoming_data->manuf_spec    = p_page_data->manuf_spec;
-    p_outcoming_data->prev_beat_LSB = (uint8_t)(prev_beat & UINT8_MAX);
-    p_outcoming_data->prev_beat_MSB = (uint8_t)((prev_beat >> 8) & UINT8_MAX);
 
-    page4_data_log(p_page_data);
+void ant_hrm_page_4_encode(uint8_t                    * p_page_buffer,
+                           ant_hrm_page4_data_t const * p_page_data)
+{
+    ant_page_encode(&ant_hrm_page_4_desc, p_page_buffer, p_page_data);
 }
 
 
 void ant_hrm_page_4_decode(uint8_t const        * p_page_buffer,
                            ant_hrm_page4_data_t * p_page_data)
 {
-    ant_hrm_page4_data_layout_t const * p_incoming_data =
-        (ant_hrm_page4_data_layout_t *)p_page_buffer;
-
-    uint32_t prev_beat = (uint32_t)((p_incoming_data->prev_beat_MSB << 8)
-                                    + p_incoming_data->prev_beat_LSB);
-
-    p_page_data->manuf_spec = p_incoming_data->manuf_spec;
-    p_page_data->prev_beat  = prev_beat;
-
-    page4_data_log(p_page_data);
+    ant_page_decode(&ant_hrm_page_4_desc, p_page_buffer, p_page_data);
 }
 
 #endif // NRF_MODULE_ENABLED(ANT_HRM)
@@ -0,0 +1,242 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(ANT_SCAN)
+#include <string.h>
+#include "ant_scan.h"
+#include "ant_interface.h"
+#include "ant_parameters.h"
+#include "ant_channel_config.h"
+#include "app_timer.h"
+
+#define DEVICE_TYPE_MASK    0x7F    ///< Device type without the pairing bit.
+
+// Offsets in the extended data, with the device ID and the RSSI enabled.
+#define EXT_DEVICE_NUMBER   0
+#define EXT_DEVICE_TYPE     2
+#define EXT_TRANS_TYPE      3
+#define EXT_RSSI            5
+
+
+static void evt_send(ant_scan_t * p_scan, ant_scan_evt_type_t evt_type, ant_scan_device_t * p_device)
+{
+    if (p_scan->p_config->evt_handler != NULL)
+    {
+        ant_scan_evt_t evt = {.evt_type = evt_type, .p_device = p_device};
+
+        p_scan->p_config->evt_handler(&evt);
+    }
+}
+
+
+ret_code_t ant_scan_init(ant_scan_t * p_scan, ant_scan_config_t const * p_config)
+{
+    ret_code_t err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_scan);
+    VERIFY_PARAM_NOT_NULL(p_config);
+
+    memset(p_scan, 0, sizeof(*p_scan));
+    p_scan->p_config = p_config;
+
+    err_code = sd_ant_lib_config_set(ANT_LIB_CONFIG_MESG_OUT_INC_RSSI
+                                     | ANT_LIB_CONFIG_MESG_OUT_INC_DEVICE_ID);
+    VERIFY_SUCCESS(err_code);
+
+    // Wildcard channel ID, the channel period is not used in scanning mode.
+    ant_channel_config_t channel_config =
+    {
+        .channel_number    = p_config->channel_number,
+        .channel_type      = CHANNEL_TYPE_SLAVE,
+        .ext_assign        = 0x00,
+        .rf_freq           = p_config->rf_freq,
+        .transmission_type = 0x00,
+        .device_type       = p_config->device_type,
+        .device_number     = 0x00,
+        .channel_period    = 0x00,
+        .network_number    = p_config->network_number,
+#if ANT_CONFIG_ENCRYPTED_CHANNELS > 0
+        .p_crypto_settings = NULL,
+#endif
+    };
+
+    return ant_channel_init(&channel_config);
+}
+
+
+ret_code_t ant_scan_start(ant_scan_t * p_scan)
+{
+    UNUSED_PARAMETER(p_scan);
+
+    // Receive the messages of all devices, not only the synchronous ones.
+    return sd_ant_rx_scan_mode_start(false);
+}
+
+
+ret_code_t ant_scan_stop(ant_scan_t * p_scan)
+{
+    return sd_ant_channel_close(p_scan->p_config->channel_number);
+}
+
+
+ant_scan_device_t * ant_scan_device_find(ant_scan_t * p_scan, uint16_t device_number, uint8_t device_type)
+{
+    for (uint32_t i = 0; i < ANT_SCAN_CONFIG_DEVICE_COUNT; i++)
+    {
+        ant_scan_device_t * p_device = &p_scan->devices[i];
+
+        if ((p_device->device_number == device_number)
+            && ((device_type == ANT_SCAN_DEVICE_TYPE_ANY) || (p_device->device_type == device_type)))
+        {
+            return p_device;
+        }
+    }
+    return NULL;
+}
+
+
+/**@brief Function for adding a device to the cache.
+ *
+ * @return     The device, or NULL if the cache is full.
+ */
+static ant_scan_device_t * device_add(ant_scan_t * p_scan,
+                                      uint16_t     device_number,
+                                      uint8_t      device_type,
+                                      uint8_t      transmission_type,
+                                      int8_t       rssi)
+{
+    ant_scan_device_t * p_device = ant_scan_device_find(p_scan, 0, ANT_SCAN_DEVICE_TYPE_ANY);
+    ant_scan_device_t   device;
+
+    if (p_device == NULL)
+    {
+        p_device = &device;
+    }
+
+    memset(p_device, 0, sizeof(*p_device));
+    p_device->device_number     = device_number;
+    p_device->device_type       = device_type;
+    p_device->transmission_type = transmission_type;
+    p_device->rssi_avg          = (int16_t)(rssi * (1 << ANT_SCAN_CONFIG_RSSI_SHIFT));
+
+    if (p_device == &device)
+    {
+        evt_send(p_scan, ANT_SCAN_EVT_CACHE_FULL, p_device);
+        return NULL;
+    }
+
+    evt_send(p_scan, ANT_SCAN_EVT_DEVICE_NEW, p_device);
+    return p_device;
+}
+
+
+/**@brief Function for passing a message to the route of the device type. */
+static void message_route(ant_scan_t * p_scan, ant_scan_device_t * p_device, ant_evt_t * p_ant_evt)
+{
+    ant_scan_config_t const * p_config = p_scan->p_config;
+
+    for (uint32_t i = 0; i < p_config->route_count; i++)
+    {
+        ant_scan_route_t const * p_route = &p_config->p_routes[i];
+
+        if ((p_route->device_type == ANT_SCAN_DEVICE_TYPE_ANY)
+            || (p_route->device_type == p_device->device_type))
+        {
+            p_scan->stats.routed++;
+            p_route->handler(p_device, p_ant_evt);
+            return;
+        }
+    }
+    p_scan->stats.unrouted++;
+}
+
+
+void ant_scan_evt_handler(ant_scan_t * p_scan, ant_evt_t * p_ant_evt)
+{
+    ANT_MESSAGE * p_message = (ANT_MESSAGE *)p_ant_evt->msg.evt_buffer;
+
+    if ((p_ant_evt->channel != p_scan->p_config->channel_number)
+        || (p_ant_evt->event != EVENT_RX)
+        || !p_message->ANT_MESSAGE_stExtMesgBF.bANTDeviceID)
+    {
+        return;
+    }
+
+    uint8_t const * p_ext_data        = p_message->ANT_MESSAGE_aucExtData;
+    uint16_t        device_number     = uint16_decode(&p_ext_data[EXT_DEVICE_NUMBER]);
+    uint8_t         device_type       = p_ext_data[EXT_DEVICE_TYPE] & DEVICE_TYPE_MASK;
+    uint8_t         transmission_type = p_ext_data[EXT_TRANS_TYPE];
+    bool            rssi_valid        = p_message->ANT_MESSAGE_stExtMesgBF.bANTRssi;
+    int8_t          rssi              = rssi_valid ? (int8_t)p_ext_data[EXT_RSSI] : 0;
+
+    p_scan->stats.rx++;
+
+    ant_scan_device_t * p_device = ant_scan_device_find(p_scan, device_number, device_type);
+
+    if (p_device == NULL)
+    {
+        p_device = device_add(p_scan, device_number, device_type, transmission_type, rssi);
+        if (p_device == NULL)
+        {
+            p_scan->stats.unrouted++;
+            return;
+        }
+    }
+    else if (rssi_valid)
+    {
+        // Exponential average, in a fixed point scaled by 2^ANT_SCAN_CONFIG_RSSI_SHIFT.
+        p_device->rssi_avg += (int16_t)(rssi - ANT_SCAN_DEVICE_RSSI(p_device));
+    }
+
+    p_device->last_seen = app_timer_cnt_get();
+    p_device->rx_count++;
+
+    if (p_scan->p_config->drop_repeated
+        && (p_device->rx_count > 1)
+        && (memcmp(p_device->last_payload,
+                   p_message->ANT_MESSAGE_aucPayload,
+                   ANT_STANDARD_DATA_PAYLOAD_SIZE) == 0))
+    {
+        p_scan->stats.repeated++;
+        return;
+    }
+    memcpy(p_device->last_payload, p_message->ANT_MESSAGE_aucPayload, ANT_STANDARD_DATA_PAYLOAD_SIZE);
+
+    message_route(p_scan, p_device, p_ant_evt);
+}
+
+
+void ant_scan_expire(ant_scan_t * p_scan)
+{
+    uint32_t now = app_timer_cnt_get();
+
+    for (uint32_t i = 0; i < ANT_SCAN_CONFIG_DEVICE_COUNT; i++)
+    {
+        ant_scan_device_t * p_device = &p_scan->devices[i];
+        uint32_t            age;
+
+        if (p_device->device_number == 0)
+        {
+            continue;
+        }
+
+        (void)app_timer_cnt_diff_compute(now, p_device->last_seen, &age);
+        if (age >= p_scan->p_config->lost_timeout_ticks)
+        {
+            evt_send(p_scan, ANT_SCAN_EVT_DEVICE_LOST, p_device);
+            p_device->device_number = 0;
+        }
+    }
+}
+
+#endif // NRF_MODULE_ENABLED(ANT_SCAN)
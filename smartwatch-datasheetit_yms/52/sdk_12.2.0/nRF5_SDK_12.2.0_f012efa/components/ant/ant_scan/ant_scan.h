@@ -0,0 +1,208 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#ifndef ANT_SCAN_H__
+#define ANT_SCAN_H__
+
+/** @file
+ *
+ * @defgroup ant_scan ANT continuous scanning receiver
+ * @{
+ * @ingroup ant_sdk_utils
+ * @brief Module for receiving several ANT+ sensors on one channel in continuous scanning mode.
+ *
+ * @details One slave channel with a wildcard channel ID is opened with @ref sd_ant_rx_scan_mode_start,
+ *          so the radio receives all broadcast devices on its frequency, instead of one slave
+ *          channel per sensor tracking each device separately. The received messages carry the
+ *          device number, device type and RSSI as extended data.
+ *
+ *          The devices are kept in a cache of @ref ANT_SCAN_CONFIG_DEVICE_COUNT entries, with a
+ *          smoothed RSSI. The messages of a known device are passed to the route of its device type,
+ *          with the device entry, so that each device can have its own profile instance. Repeated
+ *          payloads can be dropped.
+ *
+ *          An ANT+ profile display instance can be used as the decoder of a route, with its channel
+ *          number set to the scanning channel:
+ *          @code
+ *          static void hrm_route(ant_scan_device_t * p_device, ant_evt_t * p_ant_evt)
+ *          {
+ *              ant_hrm_disp_evt_handler((ant_hrm_profile_t *)p_device->p_context, p_ant_evt);
+ *          }
+ *          @endcode
+ *
+ * @note While the channel is in scanning mode, no other channel can be opened.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ant_stack_handler_types.h"
+#include "ant_parameters.h"
+#include "sdk_errors.h"
+#include "sdk_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of devices in the cache.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef ANT_SCAN_CONFIG_DEVICE_COUNT
+#define ANT_SCAN_CONFIG_DEVICE_COUNT    8
+#endif
+
+/** @brief Smoothing of the RSSI. Each message moves the average by 1 / 2^shift of the difference.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef ANT_SCAN_CONFIG_RSSI_SHIFT
+#define ANT_SCAN_CONFIG_RSSI_SHIFT      3
+#endif
+
+#define ANT_SCAN_ANT_PLUS_RF_FREQ       57u     ///< ANT+ radio frequency offset from 2400 MHz.
+#define ANT_SCAN_DEVICE_TYPE_ANY        0u      ///< Wildcard device type, for the channel ID and the routes.
+
+/**@brief Device in the cache. */
+typedef struct
+{
+    uint16_t device_number;                             ///< Device number. 0 if the entry is free.
+    uint8_t  device_type;                               ///< Device type, without the pairing bit.
+    uint8_t  transmission_type;                         ///< Transmission type.
+    int16_t  rssi_avg;                                  ///< Smoothed RSSI, in dBm scaled by 2^ANT_SCAN_CONFIG_RSSI_SHIFT.
+    uint32_t last_seen;                                 ///< Time of the last message, in RTC1 ticks of @ref app_timer.
+    uint32_t rx_count;                                  ///< Messages received.
+    uint8_t  last_payload[ANT_STANDARD_DATA_PAYLOAD_SIZE]; ///< Last payload, for the dropping of repeated payloads.
+    void   * p_context;                                 ///< User context, for example a profile instance. Set on @ref ANT_SCAN_EVT_DEVICE_NEW.
+} ant_scan_device_t;
+
+/**@brief Macro for getting the smoothed RSSI of a device, in dBm. */
+#define ANT_SCAN_DEVICE_RSSI(P_DEVICE)  ((int8_t)((P_DEVICE)->rssi_avg >> ANT_SCAN_CONFIG_RSSI_SHIFT))
+
+/**@brief Handler for the messages of a device.
+ *
+ * @param[in] p_device  Device.
+ * @param[in] p_ant_evt ANT event, as received on the scanning channel.
+ */
+typedef void (* ant_scan_route_handler_t)(ant_scan_device_t * p_device, ant_evt_t * p_ant_evt);
+
+/**@brief Route of a device type to its decoder. */
+typedef struct
+{
+    uint8_t                  device_type; ///< Device type, or @ref ANT_SCAN_DEVICE_TYPE_ANY for all.
+    ant_scan_route_handler_t handler;     ///< Handler for the messages.
+} ant_scan_route_t;
+
+/**@brief Event types. */
+typedef enum
+{
+    ANT_SCAN_EVT_DEVICE_NEW,   ///< A device was added to the cache. Its context can be set.
+    ANT_SCAN_EVT_DEVICE_LOST,  ///< A device was not seen within the timeout and was removed.
+    ANT_SCAN_EVT_CACHE_FULL,   ///< A device was not added because the cache is full.
+} ant_scan_evt_type_t;
+
+/**@brief Event. */
+typedef struct
+{
+    ant_scan_evt_type_t evt_type; ///< Event type.
+    ant_scan_device_t * p_device; ///< Device. For @ref ANT_SCAN_EVT_CACHE_FULL, a temporary copy.
+} ant_scan_evt_t;
+
+/**@brief Event handler. Called from @ref ant_scan_evt_handler and @ref ant_scan_expire. */
+typedef void (* ant_scan_evt_handler_t)(ant_scan_evt_t const * p_evt);
+
+/**@brief Configuration. */
+typedef struct
+{
+    uint8_t                  channel_number;     ///< Scanning channel. Channel 0 is required by the SoftDevice.
+    uint8_t                  network_number;     ///< Network number of the ANT+ network key.
+    uint8_t                  rf_freq;            ///< Radio frequency offset, usually @ref ANT_SCAN_ANT_PLUS_RF_FREQ.
+    uint8_t                  device_type;        ///< Device type of the channel ID, or @ref ANT_SCAN_DEVICE_TYPE_ANY.
+    bool                     drop_repeated;      ///< Do not route a payload equal to the previous one of the device.
+    uint32_t                 lost_timeout_ticks; ///< Time without message after which a device is lost, in RTC1 ticks.
+    ant_scan_route_t const * p_routes;           ///< Routes, checked in order.
+    uint8_t                  route_count;        ///< Number of routes.
+    ant_scan_evt_handler_t   evt_handler;        ///< Event handler, or NULL.
+} ant_scan_config_t;
+
+/**@brief Statistics. */
+typedef struct
+{
+    uint32_t rx;          ///< Messages received with a device ID.
+    uint32_t routed;      ///< Messages passed to a route.
+    uint32_t repeated;    ///< Repeated payloads dropped.
+    uint32_t unrouted;    ///< Messages without a route, or from devices that are not in the cache.
+} ant_scan_stats_t;
+
+/**@brief Scanning receiver instance. */
+typedef struct
+{
+    ant_scan_config_t const * p_config;                             ///< Configuration.
+    ant_scan_device_t         devices[ANT_SCAN_CONFIG_DEVICE_COUNT]; ///< Device cache.
+    ant_scan_stats_t          stats;                                ///< Statistics.
+} ant_scan_t;
+
+
+/**@brief Function for initializing a scanning receiver and configuring its channel.
+ *
+ * The extended data of the received messages is enabled with @ref sd_ant_lib_config_set.
+ *
+ * @param[out] p_scan   Instance. It must be kept in memory.
+ * @param[in]  p_config Configuration. It must be kept in memory.
+ *
+ * @retval     NRF_SUCCESS If the channel was configured. Otherwise, an error code is returned.
+ */
+ret_code_t ant_scan_init(ant_scan_t * p_scan, ant_scan_config_t const * p_config);
+
+/**@brief Function for opening the channel in continuous scanning mode.
+ *
+ * @retval     NRF_SUCCESS If the scanning was started. Otherwise, an error code is returned.
+ */
+ret_code_t ant_scan_start(ant_scan_t * p_scan);
+
+/**@brief Function for closing the scanning channel. The cache is kept.
+ *
+ * @retval     NRF_SUCCESS If the channel is closing. Otherwise, an error code is returned.
+ */
+ret_code_t ant_scan_stop(ant_scan_t * p_scan);
+
+/**@brief Function for handling the ANT events of the scanning channel.
+ *
+ * @param[in]  p_scan    Instance.
+ * @param[in]  p_ant_evt ANT event. Events of other channels are ignored.
+ */
+void ant_scan_evt_handler(ant_scan_t * p_scan, ant_evt_t * p_ant_evt);
+
+/**@brief Function for removing the devices that were not seen within the timeout.
+ *
+ * To be called periodically, for example from an app_timer handler.
+ *
+ * @param[in]  p_scan    Instance.
+ */
+void ant_scan_expire(ant_scan_t * p_scan);
+
+/**@brief Function for finding a device in the cache.
+ *
+ * @param[in]  p_scan        Instance.
+ * @param[in]  device_number Device number.
+ * @param[in]  device_type   Device type, or @ref ANT_SCAN_DEVICE_TYPE_ANY.
+ *
+ * @return     The device, or NULL if it is not in the cache.
+ */
+ant_scan_device_t * ant_scan_device_find(ant_scan_t * p_scan, uint16_t device_number, uint8_t device_type);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ANT_SCAN_H__
+/** @} */
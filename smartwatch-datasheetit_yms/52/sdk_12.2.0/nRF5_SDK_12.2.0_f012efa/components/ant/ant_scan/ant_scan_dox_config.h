@@ -0,0 +1,32 @@
+/**
+ *
+ * @defgroup ant_scan_config ANT continuous scanning receiver configuration
+ * @{
+ * @ingroup ant_scan
+ */
+/** @brief Enable ANT continuous scanning receiver.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ANT_SCAN_ENABLED
+
+/** @brief Number of devices in the cache.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ANT_SCAN_CONFIG_DEVICE_COUNT
+
+/** @brief Smoothing of the RSSI, as a shift.
+ *
+ *  Minimum value: 0
+ *  Maximum value: 7
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ANT_SCAN_CONFIG_RSSI_SHIFT
+
+
+
+/** @} */
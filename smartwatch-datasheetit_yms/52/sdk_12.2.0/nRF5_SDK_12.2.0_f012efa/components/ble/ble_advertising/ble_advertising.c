@@ -44,6 +44,15 @@ static uint16_t                        m_current_slave_link_conn_handle;
 static ble_advertising_evt_handler_t   m_evt_handler;                               /**< Handler for the advertising events. Can be initialized as NULL if no handling is implemented on in the main application. */
 static ble_advertising_error_handler_t m_error_handler;                             /**< Handler for the advertising error events. */
 
+#if NRF_MODULE_ENABLED(BLE_ADVERTISING_PAYLOAD_CACHE)
+static uint8_t                         m_adv_payload[2][BLE_GAP_ADV_MAX_SIZE];      /**< Encoded advertising data. The active buffer holds the data last passed to the SoftDevice, the other one is used to prepare updates. */
+static uint16_t                        m_adv_payload_len;                           /**< Length of the encoded advertising data. */
+static uint8_t                         m_adv_payload_active;                        /**< Index of the active buffer. */
+static uint16_t                        m_adv_flags_offset;                          /**< Offset of the flags in the encoded advertising data. */
+static uint16_t                        m_adv_field_offset[BLE_ADV_FIELD_COUNT];     /**< Offset of the data of every field in the encoded advertising data. */
+static uint16_t                        m_adv_field_len[BLE_ADV_FIELD_COUNT];        /**< Length of the data of every field, 0 if the field is not advertised. */
+#endif // NRF_MODULE_ENABLED(BLE_ADVERTISING_PAYLOAD_CACHE)
+
 static bool                            m_whitelist_temporarily_disabled;            /**< Flag to keep track of temporary disabling of the whitelist. */
 static bool                            m_whitelist_reply_expected;
 
@@ -186,6 +195,105 @@ static bool flash_access_in_progress()
 }
 
 
+#if NRF_MODULE_ENABLED(BLE_ADVERTISING_PAYLOAD_CACHE)
+/**@brief Function for encoding the advertising data once and finding the offsets of its fields.
+ *
+ * @return NRF_SUCCESS or an error from @ref adv_data_encode().
+ */
+static ret_code_t adv_payload_build(void)
+{
+    ret_code_t ret;
+    uint16_t   offset;
+    uint16_t   len;
+
+    m_adv_payload_len    = BLE_GAP_ADV_MAX_SIZE;
+    m_adv_payload_active = 0;
+
+    ret = adv_data_encode(&m_advdata, m_adv_payload[0], &m_adv_payload_len);
+    VERIFY_SUCCESS(ret);
+
+    // The flags are always encoded, ble_advdata_set() has rejected the data otherwise.
+    m_adv_flags_offset = 0;
+    (void)ble_advdata_search(m_adv_payload[0],
+                             m_adv_payload_len,
+                             &m_adv_flags_offset,
+                             BLE_GAP_AD_TYPE_FLAGS);
+
+    offset = 0;
+    len    = ble_advdata_search(m_adv_payload[0],
+                                m_adv_payload_len,
+                                &offset,
+                                BLE_GAP_AD_TYPE_MANUFACTURER_SPECIFIC_DATA);
+
+    m_adv_field_offset[BLE_ADV_FIELD_MANUF_DATA] = offset + AD_TYPE_MANUF_SPEC_DATA_ID_SIZE;
+    m_adv_field_len[BLE_ADV_FIELD_MANUF_DATA]    =
+        (len > AD_TYPE_MANUF_SPEC_DATA_ID_SIZE) ? (len - AD_TYPE_MANUF_SPEC_DATA_ID_SIZE) : 0;
+
+    offset = 0;
+    len    = ble_advdata_search(m_adv_payload[0],
+                                m_adv_payload_len,
+                                &offset,
+                                BLE_GAP_AD_TYPE_SERVICE_DATA);
+
+    m_adv_field_offset[BLE_ADV_FIELD_SERVICE_DATA] = offset + AD_TYPE_SERV_DATA_16BIT_UUID_SIZE;
+    m_adv_field_len[BLE_ADV_FIELD_SERVICE_DATA]    =
+        (len > AD_TYPE_SERV_DATA_16BIT_UUID_SIZE) ? (len - AD_TYPE_SERV_DATA_16BIT_UUID_SIZE) : 0;
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for patching the encoded advertising data and passing it to the SoftDevice.
+ *
+ * @details The patch is written to the inactive buffer, which becomes active only once the
+ *          SoftDevice has accepted it.
+ *
+ * @param[in] offset Offset of the first byte to patch in the encoded advertising data.
+ * @param[in] p_data New bytes.
+ * @param[in] len    Number of bytes to patch.
+ *
+ * @return NRF_SUCCESS or an error from @ref sd_ble_gap_adv_data_set().
+ */
+static ret_code_t adv_payload_patch(uint16_t offset, uint8_t const * p_data, uint16_t len)
+{
+    ret_code_t ret;
+    uint8_t    next = m_adv_payload_active ^ 1;
+
+    memcpy(m_adv_payload[next], m_adv_payload[m_adv_payload_active], m_adv_payload_len);
+    memcpy(&m_adv_payload[next][offset], p_data, len);
+
+    // The scan response data is not changed.
+    ret = sd_ble_gap_adv_data_set(m_adv_payload[next], m_adv_payload_len, NULL, 0);
+    VERIFY_SUCCESS(ret);
+
+    m_adv_payload_active = next;
+    return NRF_SUCCESS;
+}
+#endif // NRF_MODULE_ENABLED(BLE_ADVERTISING_PAYLOAD_CACHE)
+
+
+/**@brief Function for changing the advertising flags.
+ *
+ * @param[in] flags New flags.
+ *
+ * @return NRF_SUCCESS or an error from @ref ble_advdata_set().
+ */
+static ret_code_t adv_flags_set(uint8_t flags)
+{
+    m_advdata.flags = flags;
+
+#if NRF_MODULE_ENABLED(BLE_ADVERTISING_PAYLOAD_CACHE)
+    if (m_adv_payload[m_adv_payload_active][m_adv_flags_offset] == flags)
+    {
+        return NRF_SUCCESS;
+    }
+    return adv_payload_patch(m_adv_flags_offset, &flags, sizeof(flags));
+#else
+    return ble_advdata_set(&m_advdata, NULL);
+#endif // NRF_MODULE_ENABLED(BLE_ADVERTISING_PAYLOAD_CACHE)
+}
+
+
 /**@brief Get the next available advertising mode.
  *
  * @param[in] adv_mode Requested advertising mode.
@@ -294,9 +402,8 @@ static ret_code_t set_adv_mode_fast(ble_gap_adv_params_t * p_adv_params)
         #endif
 
         p_adv_params->fp = BLE_GAP_ADV_FP_FILTER_CONNREQ;
-        m_advdata.flags  = BLE_GAP_ADV_FLAG_BR_EDR_NOT_SUPPORTED;
 
-        ret = ble_advdata_set(&m_advdata, NULL);
+        ret = adv_flags_set(BLE_GAP_ADV_FLAG_BR_EDR_NOT_SUPPORTED);
         if (ret != NRF_SUCCESS)
         {
             return ret;
@@ -337,9 +444,8 @@ static ret_code_t set_adv_mode_slow(ble_gap_adv_params_t * p_adv_params)
         #endif
 
         p_adv_params->fp = BLE_GAP_ADV_FP_FILTER_CONNREQ;
-        m_advdata.flags  = BLE_GAP_ADV_FLAG_BR_EDR_NOT_SUPPORTED;
 
-        ret = ble_advdata_set(&m_advdata, NULL);
+        ret = adv_flags_set(BLE_GAP_ADV_FLAG_BR_EDR_NOT_SUPPORTED);
         if (ret != NRF_SUCCESS)
         {
             return ret;
@@ -444,6 +550,11 @@ uint32_t ble_advertising_init(ble_advdata_t                   const * p_advdata,
 #endif
 
     ret = ble_advdata_set(&m_advdata, p_srdata);
+    VERIFY_SUCCESS(ret);
+
+#if NRF_MODULE_ENABLED(BLE_ADVERTISING_PAYLOAD_CACHE)
+    ret = adv_payload_build();
+#endif // NRF_MODULE_ENABLED(BLE_ADVERTISING_PAYLOAD_CACHE)
     return ret;
 }
 
@@ -670,9 +781,7 @@ uint32_t ble_advertising_restart_without_whitelist(void)
         m_whitelist_in_use = false;
     #endif
 
-    m_advdata.flags = BLE_GAP_ADV_FLAGS_LE_ONLY_GENERAL_DISC_MODE;
-
-    ret = ble_advdata_set(&m_advdata, NULL);
+    ret = adv_flags_set(BLE_GAP_ADV_FLAGS_LE_ONLY_GENERAL_DISC_MODE);
     if (ret != NRF_SUCCESS)
     {
         return ret;
@@ -687,4 +796,32 @@ uint32_t ble_advertising_restart_without_whitelist(void)
     return NRF_SUCCESS;
 }
 
+
+#if NRF_MODULE_ENABLED(BLE_ADVERTISING_PAYLOAD_CACHE)
+uint32_t ble_advertising_payload_update(ble_adv_field_t         field,
+                                        uint16_t                offset,
+                                        uint8_t         const * p_data,
+                                        uint16_t                len)
+{
+    if (m_initialized == false)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    VERIFY_PARAM_NOT_NULL(p_data);
+
+    if ((field >= BLE_ADV_FIELD_COUNT) || (m_adv_field_len[field] == 0))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    if ((len == 0) || (offset + len > m_adv_field_len[field]))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    return adv_payload_patch(m_adv_field_offset[field] + offset, p_data, len);
+}
+#endif // NRF_MODULE_ENABLED(BLE_ADVERTISING_PAYLOAD_CACHE)
+
 #endif // NRF_MODULE_ENABLED(BLE_ADVERTISING)
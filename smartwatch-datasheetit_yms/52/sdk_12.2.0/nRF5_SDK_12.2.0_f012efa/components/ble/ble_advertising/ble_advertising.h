@@ -75,6 +75,14 @@ typedef enum
     BLE_ADV_EVT_PEER_ADDR_REQUEST    /**< Request a peer address from the main application. For directed advertising to work, the peer address must be set when this event occurs. */
 } ble_adv_evt_t;
 
+/**@brief Fields of the advertising data that can be updated with @ref ble_advertising_payload_update. */
+typedef enum
+{
+    BLE_ADV_FIELD_MANUF_DATA,        /**< Data of the Manufacturer Specific Data, after the company identifier. */
+    BLE_ADV_FIELD_SERVICE_DATA,      /**< Data of the first Service Data, after the service UUID. */
+    BLE_ADV_FIELD_COUNT              /**< Number of fields. */
+} ble_adv_field_t;
+
 
 /**@brief Options for the different advertisement modes.
  *
@@ -222,6 +230,37 @@ uint32_t ble_advertising_whitelist_reply(ble_gap_addr_t const * p_gap_addrs,
  */
 uint32_t ble_advertising_restart_without_whitelist(void);
 
+
+/**@brief Function for updating part of a field of the advertising data.
+ *
+ * @details The advertising data is encoded once, in @ref ble_advertising_init, and the offset of
+ *          every field is stored. An update copies the encoded data to a second buffer, writes
+ *          the changed bytes, and passes that buffer to the SoftDevice. Advertising is not
+ *          stopped. If the SoftDevice rejects the data, the previous data remains in use.
+ *
+ *          The length of a field is fixed by the data given to @ref ble_advertising_init.
+ *
+ * @note Available only when BLE_ADVERTISING_PAYLOAD_CACHE_ENABLED is set. When it is set, the
+ *       advertising data is not encoded again, so a device name set after initialization is
+ *       not advertised.
+ *
+ * @param[in] field   Field to update.
+ * @param[in] offset  Offset of the first byte to update, from the start of the data of the field.
+ * @param[in] p_data  New bytes.
+ * @param[in] len     Number of bytes to update.
+ *
+ * @retval @ref NRF_SUCCESS                 If the advertising data was updated.
+ * @retval @ref NRF_ERROR_INVALID_STATE     If the module is not initialized.
+ * @retval @ref NRF_ERROR_NULL              If @p p_data was NULL.
+ * @retval @ref NRF_ERROR_NOT_FOUND         If the field is not in the advertising data.
+ * @retval @ref NRF_ERROR_INVALID_LENGTH    If the bytes do not fit in the field.
+ * @return Any error returned by @ref sd_ble_gap_adv_data_set.
+ */
+uint32_t ble_advertising_payload_update(ble_adv_field_t         field,
+                                        uint16_t                offset,
+                                        uint8_t         const * p_data,
+                                        uint16_t                len);
+
 /** @} */
 
 
@@ -12,5 +12,13 @@
  */
 #define BLE_ADVERTISING_ENABLED
 
+/** @brief Encode the advertising data once and patch it on updates.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_ADVERTISING_PAYLOAD_CACHE_ENABLED
+
 
 /** @} */
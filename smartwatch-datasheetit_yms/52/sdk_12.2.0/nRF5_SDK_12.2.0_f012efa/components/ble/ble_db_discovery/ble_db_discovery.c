@@ -15,6 +15,9 @@
 #include <stdlib.h>
 #include "ble.h"
 #include "ble_srv_common.h"
+#if NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_CACHE)
+#include "peer_manager.h"
+#endif
 #define NRF_LOG_MODULE_NAME "BLE_DB_DISC"
 #include "nrf_log.h"
 
@@ -23,27 +26,84 @@
 #define MODULE_INITIALIZED (m_initialized == true)       /**< Macro designating whether the module has been initialized properly. */
 
 
-/**@brief Array of structures containing information about the registered application modules. */
-static ble_uuid_t m_registered_handlers[DB_DISCOVERY_MAX_USERS];
+#if (BLE_DB_DISCOVERY_CHAR_POOL_SIZE < 1) || (BLE_DB_DISCOVERY_CHAR_POOL_SIZE > 255)
+#error "BLE_DB_DISCOVERY_CHAR_POOL_SIZE must be from 1 to 255."
+#endif
 
+#define CHAR_POOL_WORDS ((BLE_DB_DISCOVERY_CHAR_POOL_SIZE + 31) / 32)  /**< Number of words of the allocation map of the characteristic pool. */
 
-/**@brief   Array of structures containing pending events to be sent to the application modules.
+
+/**@brief   Array of structures containing information about the registered application modules.
  *
- * @details Whenever a discovery related event is to be raised to a user module, it will be stored
- *          in this array first. When all services needed to be discovered have been
- *          discovered, all pending events will be sent to the corresponding user modules.
- **/
+ * @details The array is sorted by the type and the value of the UUID, so that the handler of a
+ *          service is found with a binary search. The services are discovered in this order.
+ */
 static struct
 {
-    ble_db_discovery_evt_t         evt;          /**< The pending event. */
-    ble_db_discovery_evt_handler_t evt_handler;  /**< The event handler which should be called to raise this event. */
-} m_pending_user_evts[DB_DISCOVERY_MAX_USERS];
+    ble_uuid_t                     uuid;         /**< UUID of the service. */
+    ble_db_discovery_evt_handler_t evt_handler;  /**< The event handler of the service. */
+} m_registered_handlers[DB_DISCOVERY_MAX_USERS];
+
+static ble_gatt_db_char_t m_chars[BLE_DB_DISCOVERY_CHAR_POOL_SIZE];  /**< Characteristics of the services being discovered on all connections. */
+static uint32_t           m_chars_used[CHAR_POOL_WORDS];             /**< Allocation map of m_chars, one bit per characteristic. */
 
 static ble_db_discovery_evt_handler_t m_evt_handler;
-static uint32_t m_pending_usr_evt_index;    /**< The index to the pending user event array, pointing to the last added pending user event. */
 static uint32_t m_num_of_handlers_reg;      /**< The number of handlers registered with the DB Discovery module. */
 static bool     m_initialized = false;      /**< This variable Indicates if the module is initialized or not. */
 
+#if NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_CACHE)
+// The Peer Manager stores data in whole words.
+STATIC_ASSERT((sizeof(ble_gatt_db_srv_t) % sizeof(uint32_t)) == 0);
+#endif
+
+
+/**@brief     Function for getting the sort key of a UUID.
+ */
+static __INLINE uint32_t uuid_key(const ble_uuid_t * const p_uuid)
+{
+    return ((uint32_t)p_uuid->type << 16) | p_uuid->uuid;
+}
+
+
+/**@brief     Function for searching the registered services.
+ *
+ * @param[in] p_srv_uuid UUID of the service.
+ * @param[out] p_index   Index of the service, or the index at which it is to be inserted.
+ *
+ * @retval    True  If the service is registered.
+ * @retval    False If the service is not registered.
+ */
+static bool registered_handler_find(const ble_uuid_t * const p_srv_uuid, uint32_t * p_index)
+{
+    uint32_t key   = uuid_key(p_srv_uuid);
+    uint32_t lower = 0;
+    uint32_t upper = m_num_of_handlers_reg;
+
+    while (lower < upper)
+    {
+        uint32_t middle     = (lower + upper) / 2;
+        uint32_t middle_key = uuid_key(&(m_registered_handlers[middle].uuid));
+
+        if (middle_key == key)
+        {
+            *p_index = middle;
+            return true;
+        }
+        if (middle_key < key)
+        {
+            lower = middle + 1;
+        }
+        else
+        {
+            upper = middle;
+        }
+    }
+
+    *p_index = lower;
+    return false;
+}
+
+
 /**@brief     Function for fetching the event handler provided by a registered application module.
  *
  * @param[in] srv_uuid UUID of the service.
@@ -53,14 +113,11 @@ static bool     m_initialized = false;      /**< This variable Indicates if the
  */
 static ble_db_discovery_evt_handler_t registered_handler_get(const ble_uuid_t * const p_srv_uuid)
 {
-    uint32_t i;
+    uint32_t index;
 
-    for (i = 0; i < m_num_of_handlers_reg; i++)
+    if (registered_handler_find(p_srv_uuid, &index))
     {
-        if (BLE_UUID_EQ(&(m_registered_handlers[i]), p_srv_uuid))
-        {
-            return (m_evt_handler);
-        }
+        return m_registered_handlers[index].evt_handler;
     }
 
     return NULL;
@@ -78,13 +135,20 @@ static ble_db_discovery_evt_handler_t registered_handler_get(const ble_uuid_t *
 static uint32_t registered_handler_set(const ble_uuid_t * const       p_srv_uuid,
                                        ble_db_discovery_evt_handler_t p_evt_handler)
 {
-    if (registered_handler_get(p_srv_uuid) != NULL)
+    uint32_t index;
+
+    if (registered_handler_find(p_srv_uuid, &index))
     {
         return NRF_SUCCESS;
     }
     if (m_num_of_handlers_reg < DB_DISCOVERY_MAX_USERS)
     {
-        m_registered_handlers[m_num_of_handlers_reg] = *p_srv_uuid;
+        memmove(&(m_registered_handlers[index + 1]),
+                &(m_registered_handlers[index]),
+                (m_num_of_handlers_reg - index) * sizeof(m_registered_handlers[0]));
+
+        m_registered_handlers[index].uuid        = *p_srv_uuid;
+        m_registered_handlers[index].evt_handler = p_evt_handler;
 
         m_num_of_handlers_reg++;
 
@@ -97,18 +161,116 @@ static uint32_t registered_handler_set(const ble_uuid_t * const       p_srv_uuid
 }
 
 
-/**@brief Function for sending all pending discovery events to the corresponding user modules.
+/**@brief     Function for taking characteristics from the pool.
+ *
+ * @details   The characteristics of a service are consecutive. The first free run that is long
+ *            enough is taken.
+ *
+ * @param[in] p_srv Service to take the characteristics for. Its characteristics must be given back.
+ * @param[in] count Number of characteristics.
+ *
+ * @retval    NRF_SUCCESS      If the characteristics were taken, or count was 0.
+ * @retval    NRF_ERROR_NO_MEM If the pool has no free run of count characteristics.
+ */
+static uint32_t srv_chars_alloc(ble_db_discovery_srv_t * const p_srv, uint32_t count)
+{
+    uint32_t run = 0;
+
+    p_srv->char_first = 0;
+    p_srv->char_count = 0;
+    p_srv->char_space = 0;
+
+    if (count == 0)
+    {
+        return NRF_SUCCESS;
+    }
+
+    for (uint32_t i = 0; i < BLE_DB_DISCOVERY_CHAR_POOL_SIZE; i++)
+    {
+        if (m_chars_used[i / 32] & (1UL << (i % 32)))
+        {
+            run = 0;
+            continue;
+        }
+
+        run++;
+        if (run == count)
+        {
+            uint32_t first = i + 1 - count;
+
+            for (uint32_t j = first; j <= i; j++)
+            {
+                m_chars_used[j / 32] |= (1UL << (j % 32));
+            }
+
+            p_srv->char_first = first;
+            p_srv->char_space = count;
+
+            return NRF_SUCCESS;
+        }
+    }
+
+    return NRF_ERROR_NO_MEM;
+}
+
+
+/**@brief     Function for giving back the characteristics of a service that are not used.
+ *
+ * @param[in] p_srv     Service.
+ * @param[in] new_space Number of characteristics the service keeps.
  */
-static void pending_user_evts_send(void)
+static void srv_chars_trim(ble_db_discovery_srv_t * const p_srv, uint32_t new_space)
 {
-    uint32_t i = 0;
+    for (uint32_t i = p_srv->char_first + new_space; i < p_srv->char_first + p_srv->char_space; i++)
+    {
+        m_chars_used[i / 32] &= ~(1UL << (i % 32));
+    }
+
+    p_srv->char_space = new_space;
+}
 
-    for (i = 0; i < m_num_of_handlers_reg; i++)
+
+/**@brief     Function for giving back the characteristics of all services of a connection.
+ *
+ * @param[in] p_db_discovery Pointer to the DB discovery structure.
+ */
+static void chars_free(ble_db_discovery_t * const p_db_discovery)
+{
+    for (uint32_t i = 0; i < BLE_DB_DISCOVERY_MAX_SRV; i++)
     {
-        // Pass the event to the corresponding event handler.
-        m_pending_user_evts[i].evt_handler(&(m_pending_user_evts[i].evt));
+        srv_chars_trim(&(p_db_discovery->services[i]), 0);
+
+        p_db_discovery->services[i].char_count = 0;
     }
-    m_pending_usr_evt_index = 0;
+}
+
+
+/**@brief     Function for getting a characteristic of a service.
+ *
+ * @param[in] p_srv Service.
+ * @param[in] index Index of the characteristic in the service.
+ */
+static __INLINE ble_gatt_db_char_t * srv_char_get(ble_db_discovery_srv_t const * const p_srv,
+                                                  uint32_t                             index)
+{
+    return &(m_chars[p_srv->char_first + index]);
+}
+
+
+/**@brief     Function for copying a service into the format of the events.
+ *
+ * @param[in]  p_srv  Service.
+ * @param[out] p_dest Service in the format of the events.
+ */
+static void srv_expand(ble_db_discovery_srv_t const * const p_srv, ble_gatt_db_srv_t * p_dest)
+{
+    p_dest->srv_uuid     = p_srv->srv_uuid;
+    p_dest->handle_range = p_srv->handle_range;
+    p_dest->char_count   = p_srv->char_count;
+
+    memcpy(p_dest->charateristics,
+           srv_char_get(p_srv, 0),
+           p_srv->char_count * sizeof(ble_gatt_db_char_t));
 }
 
 
@@ -116,8 +278,9 @@ static void pending_user_evts_send(void)
  *
  * @details   This function will fetch the event handler based on the UUID of the service being
  *            discovered. (The event handler is registered by the application beforehand).
- *            The error code is added to the pending events together with the event handler.
- *            If no event handler was found, then this function will do nothing.
+ *            The characteristics of the connection are given back to the pool, and the error
+ *            code is sent to the event handler. If no event handler was found, then no event is
+ *            sent.
  *
  * @param[in] p_db_discovery Pointer to the DB discovery structure.
  * @param[in] err_code       Error code that should be provided to the application.
@@ -129,12 +292,14 @@ static void discovery_error_evt_trigger(ble_db_discovery_t * const p_db_discover
                                         uint16_t const             conn_handle)
 {
     ble_db_discovery_evt_handler_t p_evt_handler;
-    ble_gatt_db_srv_t            * p_srv_being_discovered;
+    ble_db_discovery_srv_t       * p_srv_being_discovered;
 
     p_srv_being_discovered = &(p_db_discovery->services[p_db_discovery->curr_srv_ind]);
 
     p_evt_handler = registered_handler_get(&(p_srv_being_discovered->srv_uuid));
 
+    chars_free(p_db_discovery);
+
     if (p_evt_handler != NULL)
     {
         ble_db_discovery_evt_t evt;
@@ -148,65 +313,241 @@ static void discovery_error_evt_trigger(ble_db_discovery_t * const p_db_discover
 }
 
 
-/**@brief     Function for triggering a Discovery Complete or Service Not Found event to the
+/**@brief     Function for triggering the Discovery Complete or Service Not Found events to the
  *            application.
  *
- * @details   This function will fetch the event handler based on the UUID of the service being
- *            discovered. (The event handler is registered by the application beforehand).
- *            It then triggers an event indicating the completion of the service discovery.
- *            If no event handler was found, then this function will do nothing.
+ * @details   The events are held back until the last registered service has been discovered.
+ *            Then one event per service is sent to the event handler registered for it. A
+ *            service was found at the peer if its start handle is not 0.
  *
  * @param[in] p_db_discovery Pointer to the DB discovery structure.
- * @param[in] is_srv_found   Variable to indicate if the service was found at the peer.
  * @param[in] conn_handle    Connection Handle.
  */
 static void discovery_complete_evt_trigger(ble_db_discovery_t * const p_db_discovery,
-                                           bool                       is_srv_found,
                                            uint16_t const             conn_handle)
 {
-    ble_db_discovery_evt_handler_t p_evt_handler;
-    ble_gatt_db_srv_t            * p_srv_being_discovered;
+    if ((p_db_discovery->curr_srv_ind + 1) != m_num_of_handlers_reg)
+    {
+        return;
+    }
 
-    p_srv_being_discovered = &(p_db_discovery->services[p_db_discovery->curr_srv_ind]);
+    for (uint32_t i = 0; i < m_num_of_handlers_reg; i++)
+    {
+        ble_db_discovery_srv_t * p_srv = &(p_db_discovery->services[i]);
+        ble_db_discovery_evt_t   evt;
 
-    p_evt_handler = registered_handler_get(&(p_srv_being_discovered->srv_uuid));
+        evt.conn_handle = conn_handle;
+        evt.evt_type    = (p_srv->handle_range.start_handle != 0) ? BLE_DB_DISCOVERY_COMPLETE :
+                                                                    BLE_DB_DISCOVERY_SRV_NOT_FOUND;
+        srv_expand(p_srv, &(evt.params.discovered_db));
 
-    if (p_evt_handler != NULL)
+        m_registered_handlers[i].evt_handler(&evt);
+    }
+}
+
+
+#if NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_CACHE)
+/**@brief     Function for finding the Service Changed characteristic in the stored format of the
+ *            database.
+ *
+ * @param[in] p_db_discovery Pointer to the DB Discovery structure.
+ */
+static void sc_handle_find(ble_db_discovery_t * const p_db_discovery)
+{
+    p_db_discovery->sc_handle = BLE_GATT_HANDLE_INVALID;
+
+    for (uint32_t i = 0; i < m_num_of_handlers_reg; i++)
     {
-        if (m_pending_usr_evt_index < DB_DISCOVERY_MAX_USERS)
-        {
-            // Insert an event into the pending event list.
-            m_pending_user_evts[m_pending_usr_evt_index].evt.conn_handle = conn_handle;
+        ble_gatt_db_srv_t * p_srv = &(p_db_discovery->cache_image[i]);
 
-            m_pending_user_evts[m_pending_usr_evt_index].evt.params.discovered_db =
-                *p_srv_being_discovered;
-            if (is_srv_found)
-            {
-                m_pending_user_evts[m_pending_usr_evt_index].evt.evt_type =
-                    BLE_DB_DISCOVERY_COMPLETE;
-            }
-            else
+        if ((p_srv->srv_uuid.type != BLE_UUID_TYPE_BLE) || (p_srv->srv_uuid.uuid != BLE_UUID_GATT))
+        {
+            continue;
+        }
+        for (uint32_t j = 0; j < p_srv->char_count; j++)
+        {
+            if (p_srv->charateristics[j].characteristic.uuid.uuid ==
+                BLE_UUID_GATT_CHARACTERISTIC_SERVICE_CHANGED)
             {
-                m_pending_user_evts[m_pending_usr_evt_index].evt.evt_type =
-                    BLE_DB_DISCOVERY_SRV_NOT_FOUND;
+                p_db_discovery->sc_handle = p_srv->charateristics[j].characteristic.handle_value;
             }
-            m_pending_user_evts[m_pending_usr_evt_index].evt_handler = p_evt_handler;
+        }
+    }
+}
 
-            m_pending_usr_evt_index++;
 
-            if (m_pending_usr_evt_index == m_num_of_handlers_reg)
-            {
-                // All registered modules have pending events. Send all pending events to the user
-                // modules.
-                pending_user_evts_send();
-            }
-            else
-            {
-                // Too many events pending. Do nothing. (Ideally this should not happen.)
-            }
+/**@brief     Function for storing the discovered database of a bonded peer.
+ *
+ * @details   The services are copied into the stored format, which is written to flash
+ *            asynchronously. It is not modified until the next discovery on the connection.
+ *
+ * @param[in] p_db_discovery Pointer to the DB Discovery structure.
+ * @param[in] conn_handle    Connection Handle.
+ */
+static void cache_store(ble_db_discovery_t * const p_db_discovery, uint16_t const conn_handle)
+{
+    pm_peer_id_t peer_id;
+    uint32_t     err_code;
+
+    memset(p_db_discovery->cache_image, 0, sizeof(p_db_discovery->cache_image));
+    for (uint32_t i = 0; i < m_num_of_handlers_reg; i++)
+    {
+        srv_expand(&(p_db_discovery->services[i]), &(p_db_discovery->cache_image[i]));
+    }
+
+    sc_handle_find(p_db_discovery);
+
+    err_code = pm_peer_id_get(conn_handle, &peer_id);
+    if ((err_code != NRF_SUCCESS) || (peer_id == PM_PEER_ID_INVALID))
+    {
+        // The peer is not bonded.
+        return;
+    }
+
+    err_code = pm_peer_data_remote_db_store(peer_id,
+                                            p_db_discovery->cache_image,
+                                            m_num_of_handlers_reg * sizeof(ble_gatt_db_srv_t),
+                                            NULL);
+    if (err_code != NRF_SUCCESS)
+    {
+        NRF_LOG_WARNING("Storing the database of peer %d failed, error 0x%x\r\n", peer_id, err_code);
+    }
+}
+
+
+/**@brief     Function for loading the stored database of a bonded peer.
+ *
+ * @param[in] p_db_discovery Pointer to the DB Discovery structure.
+ * @param[in] conn_handle    Connection Handle.
+ *
+ * @retval    True  If a database of all registered services was loaded into p_db_discovery.
+ * @retval    False If there is no valid stored database for the peer.
+ */
+static bool cache_load(ble_db_discovery_t * const p_db_discovery, uint16_t const conn_handle)
+{
+    pm_peer_id_t peer_id;
+    uint16_t     len = sizeof(p_db_discovery->cache_image);
+    uint32_t     err_code;
+
+    err_code = pm_peer_id_get(conn_handle, &peer_id);
+    if ((err_code != NRF_SUCCESS) || (peer_id == PM_PEER_ID_INVALID))
+    {
+        return false;
+    }
+
+    err_code = pm_peer_data_remote_db_load(peer_id, p_db_discovery->cache_image, &len);
+    if ((err_code != NRF_SUCCESS) || (len != m_num_of_handlers_reg * sizeof(ble_gatt_db_srv_t)))
+    {
+        return false;
+    }
+
+    // The stored database is only valid for the same registrations in the same order.
+    for (uint32_t i = 0; i < m_num_of_handlers_reg; i++)
+    {
+        if (!BLE_UUID_EQ(&(p_db_discovery->cache_image[i].srv_uuid),
+                         &(m_registered_handlers[i].uuid)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**@brief     Function for raising the discovery events from a stored database.
+ *
+ * @param[in] p_db_discovery Pointer to the DB Discovery structure.
+ * @param[in] conn_handle    Connection Handle.
+ */
+static void cache_evts_trigger(ble_db_discovery_t * const p_db_discovery, uint16_t const conn_handle)
+{
+    for (uint32_t i = 0; i < m_num_of_handlers_reg; i++)
+    {
+        ble_db_discovery_evt_t evt;
+
+        evt.conn_handle          = conn_handle;
+        evt.evt_type             = (p_db_discovery->cache_image[i].handle_range.start_handle != 0) ?
+                                   BLE_DB_DISCOVERY_COMPLETE : BLE_DB_DISCOVERY_SRV_NOT_FOUND;
+        evt.params.discovered_db = p_db_discovery->cache_image[i];
+
+        m_registered_handlers[i].evt_handler(&evt);
+    }
+
+    p_db_discovery->discoveries_count = m_num_of_handlers_reg;
+    sc_handle_find(p_db_discovery);
+}
+#endif // NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_CACHE)
+
+
+/**@brief     Function for finishing the discovery after the last service.
+ *
+ * @details   The events have been sent, so the characteristics are given back to the pool.
+ *
+ * @param[in] p_db_discovery Pointer to the DB Discovery Structure.
+ * @param[in] conn_handle    Connection Handle.
+ */
+static void discovery_finish(ble_db_discovery_t * p_db_discovery,
+                             uint16_t const       conn_handle)
+{
+    p_db_discovery->discovery_in_progress  = false;
+
+#if NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_CACHE)
+    cache_store(p_db_discovery, conn_handle);
+#endif
+
+    chars_free(p_db_discovery);
+}
+
+
+#if NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_BATCH)
+static uint32_t characteristics_discover(ble_db_discovery_t * const p_db_discovery,
+                                         uint16_t const             conn_handle);
+
+
+/**@brief     Function for discovering the characteristics of the next service that was found.
+ *
+ * @details   The handle ranges of all registered services are known at this point. Services
+ *            that were not found at the peer are reported with a Service Not Found event.
+ *
+ * @param[in] p_db_discovery Pointer to the DB Discovery Structure.
+ * @param[in] conn_handle    Connection Handle.
+ */
+static void found_srv_discover(ble_db_discovery_t * p_db_discovery,
+                               uint16_t const       conn_handle)
+{
+    while (p_db_discovery->discoveries_count < m_num_of_handlers_reg)
+    {
+        ble_db_discovery_srv_t * p_srv_being_discovered;
+        uint32_t                 err_code;
+
+        p_db_discovery->curr_srv_ind  = p_db_discovery->discoveries_count;
+        p_db_discovery->curr_char_ind = 0;
+
+        p_srv_being_discovered = &(p_db_discovery->services[p_db_discovery->curr_srv_ind]);
+
+        if (p_srv_being_discovered->handle_range.start_handle == 0)
+        {
+            NRF_LOG_INFO("Service UUID 0x%x Not found\r\n", p_srv_being_discovered->srv_uuid.uuid);
+
+            discovery_complete_evt_trigger(p_db_discovery, conn_handle);
+            p_db_discovery->discoveries_count++;
+            continue;
         }
+
+        err_code = characteristics_discover(p_db_discovery, conn_handle);
+        if (err_code != NRF_SUCCESS)
+        {
+            p_db_discovery->discovery_in_progress = false;
+
+            discovery_error_evt_trigger(p_db_discovery, err_code, conn_handle);
+        }
+        return;
     }
+
+    discovery_finish(p_db_discovery, conn_handle);
 }
+#endif // NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_BATCH)
 
 
 /**@brief     Function for handling service discovery completion.
@@ -222,6 +563,9 @@ static void on_srv_disc_completion(ble_db_discovery_t * p_db_discovery,
 {
     p_db_discovery->discoveries_count++;
 
+#if NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_BATCH)
+    found_srv_discover(p_db_discovery, conn_handle);
+#else
     // Check if more services need to be discovered.
     if (p_db_discovery->discoveries_count < m_num_of_handlers_reg)
     {
@@ -231,11 +575,11 @@ static void on_srv_disc_completion(ble_db_discovery_t * p_db_discovery,
         // Initiate discovery of the next service.
         p_db_discovery->curr_srv_ind++;
 
-        ble_gatt_db_srv_t * p_srv_being_discovered;
+        ble_db_discovery_srv_t * p_srv_being_discovered;
 
         p_srv_being_discovered = &(p_db_discovery->services[p_db_discovery->curr_srv_ind]);
 
-        p_srv_being_discovered->srv_uuid = m_registered_handlers[p_db_discovery->curr_srv_ind];
+        p_srv_being_discovered->srv_uuid = m_registered_handlers[p_db_discovery->curr_srv_ind].uuid;
 
         // Reset the characteristic count in the current service to zero since a new service
         // discovery is about to start.
@@ -260,21 +604,15 @@ static void on_srv_disc_completion(ble_db_discovery_t * p_db_discovery,
             // Indicate the error to the registered user application.
             discovery_error_evt_trigger(p_db_discovery, err_code, conn_handle);
 
-            m_pending_user_evts[0].evt.evt_type    = BLE_DB_DISCOVERY_AVAILABLE;
-            m_pending_user_evts[0].evt.conn_handle = conn_handle;
-//            m_evt_handler(&m_pending_user_evts[0].evt);
-
             return;
         }
     }
     else
     {
         // No more service discovery is needed.
-        p_db_discovery->discovery_in_progress  = false;
-        m_pending_user_evts[0].evt.evt_type    = BLE_DB_DISCOVERY_AVAILABLE;
-        m_pending_user_evts[0].evt.conn_handle = conn_handle;
-        //m_evt_handler(&m_pending_user_evts[0].evt);
+        discovery_finish(p_db_discovery, conn_handle);
     }
+#endif // NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_BATCH)
 }
 
 
@@ -311,6 +649,7 @@ static bool is_char_discovery_reqd(ble_db_discovery_t * const p_db_discovery,
 }
 
 
+#if !NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_BATCH)
 /**@brief      Function to find out if a descriptor discovery is required.
  *
  * @details    This function finds out if there is a possibility of existence of descriptors between
@@ -373,21 +712,27 @@ static bool is_desc_discovery_reqd(ble_db_discovery_t       * p_db_discovery,
 
     return true;
 }
+#endif // !NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_BATCH)
 
 
 /**@brief     Function for performing characteristic discovery.
+ *
+ * @details   Before the first characteristic discovery of a service, characteristics are taken
+ *            from the pool for as many characteristics as the handle range of the service can
+ *            hold. A characteristic takes at least two handles, and the service declaration one.
  *
  * @param[in] p_db_discovery Pointer to the DB Discovery structure.
  * @param[in] conn_handle    Connection Handle.
  *
  * @return    NRF_SUCCESS if the SoftDevice was successfully requested to perform the characteristic
- *            discovery. Otherwise an error code. This function returns the error code returned
- *            by the SoftDevice API @ref sd_ble_gattc_characteristics_discover.
+ *            discovery. NRF_ERROR_NO_MEM if the pool has no room for the characteristics of the
+ *            service. Otherwise this function returns the error code returned by the SoftDevice
+ *            API @ref sd_ble_gattc_characteristics_discover.
  */
 static uint32_t characteristics_discover(ble_db_discovery_t * const p_db_discovery,
                                          uint16_t const             conn_handle)
 {
-    ble_gatt_db_srv_t      * p_srv_being_discovered;
+    ble_db_discovery_srv_t * p_srv_being_discovered;
     ble_gattc_handle_range_t handle_range;
 
     p_srv_being_discovered = &(p_db_discovery->services[p_db_discovery->curr_srv_ind]);
@@ -401,13 +746,20 @@ static uint32_t characteristics_discover(ble_db_discovery_t * const p_db_discove
 
         p_srv_being_discovered = &(p_db_discovery->services[p_db_discovery->curr_srv_ind]);
 
-        p_prev_char = &(p_srv_being_discovered->charateristics[prev_char_ind].characteristic);
+        p_prev_char = &(srv_char_get(p_srv_being_discovered, prev_char_ind)->characteristic);
 
         handle_range.start_handle = p_prev_char->handle_value + 1;
     }
     else
     {
         // This is the first characteristic of this service being discovered.
+        uint32_t max_chars = (p_srv_being_discovered->handle_range.end_handle -
+                              p_srv_being_discovered->handle_range.start_handle) / 2;
+        uint32_t err_code;
+
+        err_code = srv_chars_alloc(p_srv_being_discovered, MIN(max_chars, BLE_GATT_DB_MAX_CHARS));
+        VERIFY_SUCCESS(err_code);
+
         handle_range.start_handle = p_srv_being_discovered->handle_range.start_handle;
     }
 
@@ -417,6 +769,7 @@ static uint32_t characteristics_discover(ble_db_discovery_t * const p_db_discove
 }
 
 
+#if !NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_BATCH)
 /**@brief      Function for performing descriptor discovery, if required.
  *
  * @details    This function will check if descriptor discovery is required and then perform it if
@@ -441,13 +794,13 @@ static uint32_t descriptors_discover(ble_db_discovery_t * const p_db_discovery,
 {
     ble_gattc_handle_range_t   handle_range;
     ble_gatt_db_char_t       * p_curr_char_being_discovered;
-    ble_gatt_db_srv_t        * p_srv_being_discovered;
+    ble_db_discovery_srv_t   * p_srv_being_discovered;
     bool                       is_discovery_reqd = false;
 
     p_srv_being_discovered = &(p_db_discovery->services[p_db_discovery->curr_srv_ind]);
 
     p_curr_char_being_discovered =
-        &(p_srv_being_discovered->charateristics[p_db_discovery->curr_char_ind]);
+        srv_char_get(p_srv_being_discovered, p_db_discovery->curr_char_ind);
 
     if ((p_db_discovery->curr_char_ind + 1) == p_srv_being_discovered->char_count)
     {
@@ -474,7 +827,7 @@ static uint32_t descriptors_discover(ble_db_discovery_t * const p_db_discovery,
             }
             else
             {
-                p_next_char = &(p_srv_being_discovered->charateristics[i + 1]);
+                p_next_char = srv_char_get(p_srv_being_discovered, i + 1);
             }
 
             // Check if it is possible for the current characteristic to have a descriptor.
@@ -508,8 +861,50 @@ static uint32_t descriptors_discover(ble_db_discovery_t * const p_db_discovery,
 
     return sd_ble_gattc_descriptors_discover(conn_handle, &handle_range);
 }
+#else
+/**@brief      Function for discovering the descriptors of all characteristics of a service.
+ *
+ * @details    One descriptor discovery covers the handles from @p start_handle to the end of the
+ *             service, instead of one discovery per characteristic.
+ *
+ * @param[in]  p_db_discovery           Pointer to the DB Discovery structure.
+ * @param[in]  start_handle             First handle to discover.
+ * @param[out] p_raise_discov_complete  Set to true if no more descriptors can exist in the service.
+ * @param[in]  conn_handle              Connection Handle.
+ *
+ * @return     NRF_SUCCESS, or the error code returned by the SoftDevice API
+ *             @ref sd_ble_gattc_descriptors_discover.
+ */
+static uint32_t srv_descriptors_discover(ble_db_discovery_t * const p_db_discovery,
+                                         uint16_t                   start_handle,
+                                         bool *                     p_raise_discov_complete,
+                                         uint16_t const             conn_handle)
+{
+    ble_gattc_handle_range_t handle_range;
+    ble_db_discovery_srv_t * p_srv_being_discovered;
 
+    p_srv_being_discovered = &(p_db_discovery->services[p_db_discovery->curr_srv_ind]);
+
+    handle_range.start_handle = start_handle;
+    handle_range.end_handle   = p_srv_being_discovered->handle_range.end_handle;
 
+    if ((p_srv_being_discovered->char_count == 0) ||
+        (start_handle == 0)                        ||
+        (start_handle > handle_range.end_handle))
+    {
+        *p_raise_discov_complete = true;
+
+        return NRF_SUCCESS;
+    }
+
+    *p_raise_discov_complete = false;
+
+    return sd_ble_gattc_descriptors_discover(conn_handle, &handle_range);
+}
+#endif // !NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_BATCH)
+
+
+#if !NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_BATCH)
 /**@brief     Function for handling primary service discovery response.
  *
  * @details   This function will handle the primary service discovery response and start the
@@ -521,7 +916,7 @@ static uint32_t descriptors_discover(ble_db_discovery_t * const p_db_discovery,
 static void on_primary_srv_discovery_rsp(ble_db_discovery_t * const    p_db_discovery,
                                          const ble_gattc_evt_t * const p_ble_gattc_evt)
 {
-    ble_gatt_db_srv_t                        * p_srv_being_discovered;
+    ble_db_discovery_srv_t                   * p_srv_being_discovered;
     p_srv_being_discovered = &(p_db_discovery->services[p_db_discovery->curr_srv_ind]);
 
     if (p_ble_gattc_evt->conn_handle != p_db_discovery->conn_handle)
@@ -552,25 +947,25 @@ static void on_primary_srv_discovery_rsp(ble_db_discovery_t * const    p_db_disc
             discovery_error_evt_trigger(p_db_discovery,
                                         err_code,
                                         p_ble_gattc_evt->conn_handle);
-
-            m_pending_user_evts[0].evt.evt_type    = BLE_DB_DISCOVERY_AVAILABLE;
-            m_pending_user_evts[0].evt.conn_handle = p_ble_gattc_evt->conn_handle;
-            //m_evt_handler(&m_pending_user_evts[0].evt);
         }
     }
     else
     {
         NRF_LOG_INFO("Service UUID 0x%x Not found\r\n", p_srv_being_discovered->srv_uuid.uuid);
+
+        p_srv_being_discovered->handle_range.start_handle = 0;
+        p_srv_being_discovered->handle_range.end_handle   = 0;
+
         // Trigger Service Not Found event to the application.
-        discovery_complete_evt_trigger(p_db_discovery,
-                                       false,
-                                       p_ble_gattc_evt->conn_handle);
+        discovery_complete_evt_trigger(p_db_discovery, p_ble_gattc_evt->conn_handle);
 
         on_srv_disc_completion(p_db_discovery,
                                p_ble_gattc_evt->conn_handle);
     }
 }
 
+#endif // !NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_BATCH)
+
 
 /**@brief     Function for handling characteristic discovery response.
  *
@@ -581,7 +976,7 @@ static void on_characteristic_discovery_rsp(ble_db_discovery_t * const    p_db_d
                              const ble_gattc_evt_t * const                p_ble_gattc_evt)
 {
     uint32_t                 err_code;
-    ble_gatt_db_srv_t      * p_srv_being_discovered;
+    ble_db_discovery_srv_t * p_srv_being_discovered;
     bool                     perform_desc_discov = false;
 
     if (p_ble_gattc_evt->conn_handle != p_db_discovery->conn_handle)
@@ -604,8 +999,9 @@ static void on_characteristic_discovery_rsp(ble_db_discovery_t * const    p_db_d
         // characteristic discovery response being handled).
         uint8_t num_chars_curr_disc = p_char_disc_rsp_evt->count;
 
-        // Check if the total number of discovered characteristics are supported by this module.
-        if ((num_chars_prev_disc + num_chars_curr_disc) <= BLE_GATT_DB_MAX_CHARS)
+        // Check if the total number of discovered characteristics fit in the characteristics
+        // taken for the service.
+        if ((num_chars_prev_disc + num_chars_curr_disc) <= p_srv_being_discovered->char_space)
         {
             // Update the characteristics count.
             p_srv_being_discovered->char_count += num_chars_curr_disc;
@@ -614,7 +1010,7 @@ static void on_characteristic_discovery_rsp(ble_db_discovery_t * const    p_db_d
         {
             // The number of characteristics discovered at the peer is more than the supported
             // maximum. This module will store only the characteristics found up to this point.
-            p_srv_being_discovered->char_count = BLE_GATT_DB_MAX_CHARS;
+            p_srv_being_discovered->char_count = p_srv_being_discovered->char_space;
         }
 
         uint32_t i;
@@ -622,25 +1018,20 @@ static void on_characteristic_discovery_rsp(ble_db_discovery_t * const    p_db_d
 
         for (i = num_chars_prev_disc, j = 0; i < p_srv_being_discovered->char_count; i++, j++)
         {
-            p_srv_being_discovered->charateristics[i].characteristic =
-                p_char_disc_rsp_evt->chars[j];
+            ble_gatt_db_char_t * p_char = srv_char_get(p_srv_being_discovered, i);
 
-            p_srv_being_discovered->charateristics[i].cccd_handle       = BLE_GATT_HANDLE_INVALID;
-            p_srv_being_discovered->charateristics[i].ext_prop_handle   = BLE_GATT_HANDLE_INVALID;
-            p_srv_being_discovered->charateristics[i].user_desc_handle  = BLE_GATT_HANDLE_INVALID;
-            p_srv_being_discovered->charateristics[i].report_ref_handle = BLE_GATT_HANDLE_INVALID;
+            p_char->characteristic    = p_char_disc_rsp_evt->chars[j];
+            p_char->cccd_handle       = BLE_GATT_HANDLE_INVALID;
+            p_char->ext_prop_handle   = BLE_GATT_HANDLE_INVALID;
+            p_char->user_desc_handle  = BLE_GATT_HANDLE_INVALID;
+            p_char->report_ref_handle = BLE_GATT_HANDLE_INVALID;
         }
 
-        ble_gattc_char_t * p_last_known_char;
-
-        p_last_known_char = &(p_srv_being_discovered->charateristics[i - 1].characteristic);
-
         // If no more characteristic discovery is required, or if the maximum number of supported
         // characteristic per service has been reached, descriptor discovery will be performed.
-        if (
-            !is_char_discovery_reqd(p_db_discovery, p_last_known_char) ||
-            (p_srv_being_discovered->char_count == BLE_GATT_DB_MAX_CHARS)
-           )
+        if ((p_srv_being_discovered->char_count == p_srv_being_discovered->char_space) ||
+            !is_char_discovery_reqd(p_db_discovery,
+                                    &(srv_char_get(p_srv_being_discovered, i - 1)->characteristic)))
         {
             perform_desc_discov = true;
         }
@@ -661,10 +1052,6 @@ static void on_characteristic_discovery_rsp(ble_db_discovery_t * const    p_db_d
                                             err_code,
                                             p_ble_gattc_evt->conn_handle);
 
-                m_pending_user_evts[0].evt.evt_type    = BLE_DB_DISCOVERY_AVAILABLE;
-                m_pending_user_evts[0].evt.conn_handle = p_ble_gattc_evt->conn_handle;
-                //m_evt_handler(&m_pending_user_evts[0].evt);
-
                 return;
             }
         }
@@ -682,9 +1069,26 @@ static void on_characteristic_discovery_rsp(ble_db_discovery_t * const    p_db_d
 
         p_db_discovery->curr_char_ind = 0;
 
+        // All characteristics of the service are known. Give back the ones that were not found.
+        srv_chars_trim(p_srv_being_discovered, p_srv_being_discovered->char_count);
+
+#if NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_BATCH)
+        uint16_t start_handle = 0;
+
+        if (p_srv_being_discovered->char_count != 0)
+        {
+            start_handle = srv_char_get(p_srv_being_discovered, 0)->characteristic.handle_value + 1;
+        }
+
+        err_code = srv_descriptors_discover(p_db_discovery,
+                                            start_handle,
+                                            &raise_discov_complete,
+                                            p_ble_gattc_evt->conn_handle);
+#else
         err_code = descriptors_discover(p_db_discovery,
                                         &raise_discov_complete,
                                         p_ble_gattc_evt->conn_handle);
+#endif
 
         if (err_code != NRF_SUCCESS)
         {
@@ -694,10 +1098,6 @@ static void on_characteristic_discovery_rsp(ble_db_discovery_t * const    p_db_d
                                         err_code,
                                         p_ble_gattc_evt->conn_handle);
 
-            m_pending_user_evts[0].evt.evt_type    = BLE_DB_DISCOVERY_AVAILABLE;
-            m_pending_user_evts[0].evt.conn_handle = p_ble_gattc_evt->conn_handle;
-            //m_evt_handler(&m_pending_user_evts[0].evt);
-
             return;
         }
         if (raise_discov_complete)
@@ -708,9 +1108,7 @@ static void on_characteristic_discovery_rsp(ble_db_discovery_t * const    p_db_d
                    " handle %d\r\n", p_srv_being_discovered->srv_uuid.uuid,
                    p_ble_gattc_evt->conn_handle);
 
-            discovery_complete_evt_trigger(p_db_discovery,
-                                           true,
-                                           p_ble_gattc_evt->conn_handle);
+            discovery_complete_evt_trigger(p_db_discovery, p_ble_gattc_evt->conn_handle);
 
             on_srv_disc_completion(p_db_discovery,
                                    p_ble_gattc_evt->conn_handle);
@@ -719,6 +1117,36 @@ static void on_characteristic_discovery_rsp(ble_db_discovery_t * const    p_db_d
 }
 
 
+/**@brief     Function for storing the handle of a descriptor that is used by this module.
+ *
+ * @param[in] p_char Pointer to the characteristic the descriptor belongs to.
+ * @param[in] p_desc Pointer to the discovered descriptor.
+ */
+static void descriptor_handle_store(ble_gatt_db_char_t     * p_char,
+                                    const ble_gattc_desc_t * p_desc)
+{
+    switch (p_desc->uuid.uuid)
+    {
+        case BLE_UUID_DESCRIPTOR_CLIENT_CHAR_CONFIG:
+            p_char->cccd_handle = p_desc->handle;
+            break;
+
+        case BLE_UUID_DESCRIPTOR_CHAR_EXT_PROP:
+            p_char->ext_prop_handle = p_desc->handle;
+            break;
+
+        case BLE_UUID_DESCRIPTOR_CHAR_USER_DESC:
+            p_char->user_desc_handle = p_desc->handle;
+            break;
+
+        case BLE_UUID_REPORT_REF_DESCR:
+            p_char->report_ref_handle = p_desc->handle;
+            break;
+    }
+}
+
+
+#if !NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_BATCH)
 /**@brief     Function for handling descriptor discovery response.
  *
  * @param[in] p_db_discovery    Pointer to the DB Discovery structure.
@@ -728,7 +1156,7 @@ static void on_descriptor_discovery_rsp(ble_db_discovery_t * const    p_db_disco
                                         const ble_gattc_evt_t * const p_ble_gattc_evt)
 {
     const ble_gattc_evt_desc_disc_rsp_t * p_desc_disc_rsp_evt;
-    ble_gatt_db_srv_t                   * p_srv_being_discovered;
+    ble_db_discovery_srv_t              * p_srv_being_discovered;
 
     if (p_ble_gattc_evt->conn_handle != p_db_discovery->conn_handle)
     {
@@ -740,7 +1168,7 @@ static void on_descriptor_discovery_rsp(ble_db_discovery_t * const    p_db_disco
     p_desc_disc_rsp_evt = &(p_ble_gattc_evt->params.desc_disc_rsp);
 
     ble_gatt_db_char_t * p_char_being_discovered =
-        &(p_srv_being_discovered->charateristics[p_db_discovery->curr_char_ind]);
+        srv_char_get(p_srv_being_discovered, p_db_discovery->curr_char_ind);
 
     if (p_ble_gattc_evt->gatt_status == BLE_GATT_STATUS_SUCCESS)
     {
@@ -749,28 +1177,7 @@ static void on_descriptor_discovery_rsp(ble_db_discovery_t * const    p_db_disco
         // User Description & Report Reference descriptor handles.
         for (uint32_t i = 0; i < p_desc_disc_rsp_evt->count; i++)
         {
-            switch (p_desc_disc_rsp_evt->descs[i].uuid.uuid)
-            {
-                case BLE_UUID_DESCRIPTOR_CLIENT_CHAR_CONFIG:
-                    p_char_being_discovered->cccd_handle =
-                        p_desc_disc_rsp_evt->descs[i].handle;
-                    break;
-
-                case BLE_UUID_DESCRIPTOR_CHAR_EXT_PROP:
-                    p_char_being_discovered->ext_prop_handle =
-                        p_desc_disc_rsp_evt->descs[i].handle;
-                    break;
-
-                case BLE_UUID_DESCRIPTOR_CHAR_USER_DESC:
-                    p_char_being_discovered->user_desc_handle =
-                        p_desc_disc_rsp_evt->descs[i].handle;
-                    break;
-
-                case BLE_UUID_REPORT_REF_DESCR:
-                    p_char_being_discovered->report_ref_handle =
-                        p_desc_disc_rsp_evt->descs[i].handle;
-                    break;
-            }
+            descriptor_handle_store(p_char_being_discovered, &(p_desc_disc_rsp_evt->descs[i]));
 
             /* Break if we've found all the descriptors we are looking for. */
             if (p_char_being_discovered->cccd_handle       != BLE_GATT_HANDLE_INVALID &&
@@ -813,8 +1220,175 @@ static void on_descriptor_discovery_rsp(ble_db_discovery_t * const    p_db_disco
                                         err_code,
                                         p_ble_gattc_evt->conn_handle);
 
-            m_pending_user_evts[0].evt.evt_type    = BLE_DB_DISCOVERY_AVAILABLE;
-            m_pending_user_evts[0].evt.conn_handle = p_ble_gattc_evt->conn_handle;
+            return;
+        }
+    }
+
+    if (raise_discov_complete)
+    {
+        NRF_LOG_INFO("Discovery of service with UUID 0x%x completed with success for Connection"
+               " handle %d\r\n", p_srv_being_discovered->srv_uuid.uuid,
+               p_ble_gattc_evt->conn_handle);
+
+        discovery_complete_evt_trigger(p_db_discovery, p_ble_gattc_evt->conn_handle);
+
+        on_srv_disc_completion(p_db_discovery,
+                               p_ble_gattc_evt->conn_handle);
+    }
+}
+
+#endif // !NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_BATCH)
+
+
+#if NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_BATCH)
+/**@brief     Function for handling the response to the discovery of all primary services.
+ *
+ * @details   The handle range of every registered service in the response is stored. The
+ *            discovery continues after the last service in the response until all registered
+ *            services are found or the end of the database is reached.
+ *
+ * @param[in] p_db_discovery    Pointer to the DB Discovery structure.
+ * @param[in] p_ble_gattc_evt   Pointer to the GATT Client event.
+ */
+static void on_all_srv_discovery_rsp(ble_db_discovery_t * const    p_db_discovery,
+                                     const ble_gattc_evt_t * const p_ble_gattc_evt)
+{
+    const ble_gattc_evt_prim_srvc_disc_rsp_t * p_prim_srvc_disc_rsp_evt;
+    uint16_t                                   last_end_handle = 0xFFFF;
+    uint32_t                                   found_count     = 0;
+
+    if (p_ble_gattc_evt->conn_handle != p_db_discovery->conn_handle)
+    {
+        return;
+    }
+
+    p_prim_srvc_disc_rsp_evt = &(p_ble_gattc_evt->params.prim_srvc_disc_rsp);
+
+    if ((p_ble_gattc_evt->gatt_status == BLE_GATT_STATUS_SUCCESS) &&
+        (p_prim_srvc_disc_rsp_evt->count != 0))
+    {
+        for (uint32_t i = 0; i < p_prim_srvc_disc_rsp_evt->count; i++)
+        {
+            ble_db_discovery_srv_t * p_srv;
+            uint32_t                 j;
+
+            // The services are in the order of the registrations.
+            if (!registered_handler_find(&(p_prim_srvc_disc_rsp_evt->services[i].uuid), &j))
+            {
+                continue;
+            }
+
+            p_srv = &(p_db_discovery->services[j]);
+
+            // Only the first instance of a service is used.
+            if (p_srv->handle_range.start_handle == 0)
+            {
+                NRF_LOG_INFO("Found service UUID 0x%x\r\n", p_srv->srv_uuid.uuid);
+
+                p_srv->handle_range = p_prim_srvc_disc_rsp_evt->services[i].handle_range;
+            }
+        }
+
+        last_end_handle =
+            p_prim_srvc_disc_rsp_evt->services[p_prim_srvc_disc_rsp_evt->count - 1].handle_range.end_handle;
+    }
+
+    for (uint32_t j = 0; j < m_num_of_handlers_reg; j++)
+    {
+        if (p_db_discovery->services[j].handle_range.start_handle != 0)
+        {
+            found_count++;
+        }
+    }
+
+    if ((last_end_handle != 0xFFFF) && (found_count < m_num_of_handlers_reg))
+    {
+        uint32_t err_code;
+
+        err_code = sd_ble_gattc_primary_services_discover(p_ble_gattc_evt->conn_handle,
+                                                          last_end_handle + 1,
+                                                          NULL);
+        if (err_code != NRF_SUCCESS)
+        {
+            p_db_discovery->discovery_in_progress = false;
+
+            discovery_error_evt_trigger(p_db_discovery, err_code, p_ble_gattc_evt->conn_handle);
+        }
+        return;
+    }
+
+    found_srv_discover(p_db_discovery, p_ble_gattc_evt->conn_handle);
+}
+
+
+/**@brief     Function for handling the response to the descriptor discovery of a service.
+ *
+ * @details   The response holds all attributes after the first characteristic value, including
+ *            the declarations and values of the other characteristics. A descriptor belongs to
+ *            the last characteristic declared before it.
+ *
+ * @param[in] p_db_discovery    Pointer to the DB Discovery structure.
+ * @param[in] p_ble_gattc_evt   Pointer to the GATT Client event.
+ */
+static void on_srv_descriptor_discovery_rsp(ble_db_discovery_t * const    p_db_discovery,
+                                            const ble_gattc_evt_t * const p_ble_gattc_evt)
+{
+    const ble_gattc_evt_desc_disc_rsp_t * p_desc_disc_rsp_evt;
+    ble_db_discovery_srv_t              * p_srv_being_discovered;
+    uint16_t                              next_handle           = 0;
+    bool                                  raise_discov_complete = true;
+
+    if (p_ble_gattc_evt->conn_handle != p_db_discovery->conn_handle)
+    {
+        return;
+    }
+
+    p_srv_being_discovered = &(p_db_discovery->services[p_db_discovery->curr_srv_ind]);
+
+    p_desc_disc_rsp_evt = &(p_ble_gattc_evt->params.desc_disc_rsp);
+
+    if ((p_ble_gattc_evt->gatt_status == BLE_GATT_STATUS_SUCCESS) &&
+        (p_desc_disc_rsp_evt->count != 0))
+    {
+        for (uint32_t i = 0; i < p_desc_disc_rsp_evt->count; i++)
+        {
+            const ble_gattc_desc_t * p_desc = &(p_desc_disc_rsp_evt->descs[i]);
+            ble_gatt_db_char_t     * p_char;
+
+            // The handles are in ascending order, so curr_char_ind only moves forward.
+            while (((p_db_discovery->curr_char_ind + 1) < p_srv_being_discovered->char_count) &&
+                   (p_desc->handle >=
+                    srv_char_get(p_srv_being_discovered, p_db_discovery->curr_char_ind + 1)->characteristic.handle_decl))
+            {
+                p_db_discovery->curr_char_ind++;
+            }
+
+            p_char = srv_char_get(p_srv_being_discovered, p_db_discovery->curr_char_ind);
+
+            // Vendor specific UUIDs of characteristic values must not be taken for descriptors.
+            if ((p_desc->handle > p_char->characteristic.handle_value) &&
+                (p_desc->uuid.type == BLE_UUID_TYPE_BLE))
+            {
+                descriptor_handle_store(p_char, p_desc);
+            }
+        }
+
+        next_handle = p_desc_disc_rsp_evt->descs[p_desc_disc_rsp_evt->count - 1].handle + 1;
+    }
+
+    if (next_handle != 0)
+    {
+        uint32_t err_code;
+
+        err_code = srv_descriptors_discover(p_db_discovery,
+                                            next_handle,
+                                            &raise_discov_complete,
+                                            p_ble_gattc_evt->conn_handle);
+        if (err_code != NRF_SUCCESS)
+        {
+            p_db_discovery->discovery_in_progress = false;
+
+            discovery_error_evt_trigger(p_db_discovery, err_code, p_ble_gattc_evt->conn_handle);
 
             return;
         }
@@ -826,14 +1400,13 @@ static void on_descriptor_discovery_rsp(ble_db_discovery_t * const    p_db_disco
                " handle %d\r\n", p_srv_being_discovered->srv_uuid.uuid,
                p_ble_gattc_evt->conn_handle);
 
-        discovery_complete_evt_trigger(p_db_discovery,
-                                       true,
-                                       p_ble_gattc_evt->conn_handle);
+        discovery_complete_evt_trigger(p_db_discovery, p_ble_gattc_evt->conn_handle);
 
         on_srv_disc_completion(p_db_discovery,
                                p_ble_gattc_evt->conn_handle);
     }
 }
+#endif // NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_BATCH)
 
 
 uint32_t ble_db_discovery_init(const ble_db_discovery_evt_handler_t evt_handler)
@@ -843,9 +1416,10 @@ uint32_t ble_db_discovery_init(const ble_db_discovery_evt_handler_t evt_handler)
 
     m_num_of_handlers_reg      = 0;
     m_initialized              = true;
-    m_pending_usr_evt_index    = 0;
     m_evt_handler              = evt_handler;
 
+    memset(m_chars_used, 0, sizeof(m_chars_used));
+
     return err_code;
 
 }
@@ -855,7 +1429,6 @@ uint32_t ble_db_discovery_close()
 {
     m_num_of_handlers_reg      = 0;
     m_initialized              = false;
-    m_pending_usr_evt_index    = 0;
 
     return NRF_SUCCESS;
 }
@@ -870,6 +1443,54 @@ uint32_t ble_db_discovery_evt_register(const ble_uuid_t * const p_uuid)
 }
 
 
+/**@brief     Function for starting the discovery of the first registered service at the peer.
+ *
+ * @param[in] p_db_discovery Pointer to the DB Discovery structure.
+ * @param[in] conn_handle    Connection Handle.
+ *
+ * @return    This function returns the error code returned by the SoftDevice API
+ *            @ref sd_ble_gattc_primary_services_discover.
+ */
+static uint32_t discovery_start(ble_db_discovery_t * const p_db_discovery,
+                                uint16_t                   conn_handle)
+{
+    uint32_t err_code;
+
+#if NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_BATCH)
+    for (uint32_t i = 0; i < m_num_of_handlers_reg; i++)
+    {
+        p_db_discovery->services[i].srv_uuid                  = m_registered_handlers[i].uuid;
+        p_db_discovery->services[i].char_count                = 0;
+        p_db_discovery->services[i].handle_range.start_handle = 0;
+        p_db_discovery->services[i].handle_range.end_handle   = 0;
+    }
+
+    NRF_LOG_INFO("Starting discovery of all primary services for Connection handle %d\r\n",
+           conn_handle);
+
+    err_code = sd_ble_gattc_primary_services_discover(conn_handle, SRV_DISC_START_HANDLE, NULL);
+#else
+    ble_db_discovery_srv_t * p_srv_being_discovered;
+
+    p_srv_being_discovered = &(p_db_discovery->services[p_db_discovery->curr_srv_ind]);
+
+    p_srv_being_discovered->srv_uuid   = m_registered_handlers[p_db_discovery->curr_srv_ind].uuid;
+    p_srv_being_discovered->char_count = 0;
+
+    NRF_LOG_INFO("Starting discovery of service with UUID 0x%x for Connection handle %d\r\n",
+           p_srv_being_discovered->srv_uuid.uuid, conn_handle);
+
+    err_code = sd_ble_gattc_primary_services_discover(conn_handle,
+                                                      SRV_DISC_START_HANDLE,
+                                                      &(p_srv_being_discovered->srv_uuid));
+#endif
+    VERIFY_SUCCESS(err_code);
+    p_db_discovery->discovery_in_progress = true;
+
+    return NRF_SUCCESS;
+}
+
+
 uint32_t ble_db_discovery_start(ble_db_discovery_t * const p_db_discovery,
                                 uint16_t                   conn_handle)
 {
@@ -888,30 +1509,26 @@ uint32_t ble_db_discovery_start(ble_db_discovery_t * const p_db_discovery,
     }
 
     p_db_discovery->conn_handle = conn_handle;
-    ble_gatt_db_srv_t * p_srv_being_discovered;
 
-    m_pending_usr_evt_index   = 0;
+    chars_free(p_db_discovery);
+
 
     p_db_discovery->discoveries_count = 0;
     p_db_discovery->curr_srv_ind      = 0;
     p_db_discovery->curr_char_ind     = 0;
 
-    p_srv_being_discovered = &(p_db_discovery->services[p_db_discovery->curr_srv_ind]);
-
-    p_srv_being_discovered->srv_uuid = m_registered_handlers[p_db_discovery->curr_srv_ind];
+#if NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_CACHE)
+    if (cache_load(p_db_discovery, conn_handle))
+    {
+        NRF_LOG_INFO("Using the stored database for Connection handle %d\r\n", conn_handle);
 
-    NRF_LOG_INFO("Starting discovery of service with UUID 0x%x for Connection handle %d\r\n",
-           p_srv_being_discovered->srv_uuid.uuid, conn_handle);
+        cache_evts_trigger(p_db_discovery, conn_handle);
 
-    uint32_t err_code;
-
-    err_code = sd_ble_gattc_primary_services_discover(conn_handle,
-                                                      SRV_DISC_START_HANDLE,
-                                                      &(p_srv_being_discovered->srv_uuid));
-    VERIFY_SUCCESS(err_code);
-    p_db_discovery->discovery_in_progress = true;
+        return NRF_SUCCESS;
+    }
+#endif
 
-    return NRF_SUCCESS;
+    return discovery_start(p_db_discovery, conn_handle);
 }
 
 
@@ -926,10 +1543,70 @@ static void on_disconnected(ble_db_discovery_t * const  p_db_discovery,
     if (p_evt->conn_handle == p_db_discovery->conn_handle)
     {
         p_db_discovery->discovery_in_progress = false;
+        p_db_discovery->sc_handle             = BLE_GATT_HANDLE_INVALID;
+
+        chars_free(p_db_discovery);
     }
 }
 
 
+#if NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_CACHE)
+/**@brief     Function for handling a Service Changed indication from the peer.
+ *
+ * @details   The stored database of the peer is deleted and the discovery is restarted.
+ *
+ * @param[in] p_db_discovery    Pointer to the DB Discovery structure.
+ * @param[in] p_ble_gattc_evt   Pointer to the GATT Client event.
+ */
+static void on_hvx(ble_db_discovery_t * const    p_db_discovery,
+                   const ble_gattc_evt_t * const p_ble_gattc_evt)
+{
+    pm_peer_id_t peer_id;
+    uint32_t     err_code;
+
+    if ((p_ble_gattc_evt->conn_handle != p_db_discovery->conn_handle) ||
+        (p_db_discovery->sc_handle == BLE_GATT_HANDLE_INVALID)        ||
+        (p_ble_gattc_evt->params.hvx.handle != p_db_discovery->sc_handle))
+    {
+        return;
+    }
+
+    NRF_LOG_INFO("Service Changed indication for Connection handle %d\r\n",
+                 p_ble_gattc_evt->conn_handle);
+
+    if (p_ble_gattc_evt->params.hvx.type == BLE_GATT_HVX_INDICATION)
+    {
+        (void)sd_ble_gattc_hv_confirm(p_ble_gattc_evt->conn_handle, p_db_discovery->sc_handle);
+    }
+
+    err_code = pm_peer_id_get(p_ble_gattc_evt->conn_handle, &peer_id);
+    if ((err_code == NRF_SUCCESS) && (peer_id != PM_PEER_ID_INVALID))
+    {
+        (void)pm_peer_data_delete(peer_id, PM_PEER_DATA_ID_GATT_REMOTE);
+    }
+
+    p_db_discovery->sc_handle = BLE_GATT_HANDLE_INVALID;
+
+    if (p_db_discovery->discovery_in_progress)
+    {
+        // The ongoing discovery already reads the database again.
+        return;
+    }
+
+    p_db_discovery->discoveries_count = 0;
+    p_db_discovery->curr_srv_ind      = 0;
+    p_db_discovery->curr_char_ind     = 0;
+
+    // The stored database is not used, its deletion is asynchronous.
+    err_code = discovery_start(p_db_discovery, p_ble_gattc_evt->conn_handle);
+    if (err_code != NRF_SUCCESS)
+    {
+        discovery_error_evt_trigger(p_db_discovery, err_code, p_ble_gattc_evt->conn_handle);
+    }
+}
+#endif // NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_CACHE)
+
+
 void ble_db_discovery_on_ble_evt(ble_db_discovery_t * const p_db_discovery,
                                  const ble_evt_t * const    p_ble_evt)
 {
@@ -940,7 +1617,11 @@ void ble_db_discovery_on_ble_evt(ble_db_discovery_t * const p_db_discovery,
     switch (p_ble_evt->header.evt_id)
     {
         case BLE_GATTC_EVT_PRIM_SRVC_DISC_RSP:
+#if NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_BATCH)
+            on_all_srv_discovery_rsp(p_db_discovery, &(p_ble_evt->evt.gattc_evt));
+#else
             on_primary_srv_discovery_rsp(p_db_discovery, &(p_ble_evt->evt.gattc_evt));
+#endif
             break;
 
         case BLE_GATTC_EVT_CHAR_DISC_RSP:
@@ -948,13 +1629,23 @@ void ble_db_discovery_on_ble_evt(ble_db_discovery_t * const p_db_discovery,
             break;
 
         case BLE_GATTC_EVT_DESC_DISC_RSP:
+#if NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_BATCH)
+            on_srv_descriptor_discovery_rsp(p_db_discovery, &(p_ble_evt->evt.gattc_evt));
+#else
             on_descriptor_discovery_rsp(p_db_discovery, &(p_ble_evt->evt.gattc_evt));
+#endif
             break;
 
         case BLE_GAP_EVT_DISCONNECTED:
             on_disconnected(p_db_discovery, &(p_ble_evt->evt.gap_evt));
             break;
 
+#if NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_CACHE)
+        case BLE_GATTC_EVT_HVX:
+            on_hvx(p_db_discovery, &(p_ble_evt->evt.gattc_evt));
+            break;
+#endif
+
         default:
             break;
     }
@@ -23,9 +23,9 @@
  *           desired services in multiple remote devices.
  *
  * @warning  The maximum number of characteristics per service that can be discovered by this module
- *           is determined by the number of characteristics in the service structure defined in
- *           db_disc_config.h. If the peer has more than the supported number of characteristics, then
- *           the first found will be discovered and any further characteristics will be ignored. Only the
+ *           is @ref BLE_GATT_DB_MAX_CHARS. If the peer has more than the supported number of
+ *           characteristics, then the first found will be discovered and any further characteristics
+ *           will be ignored. Only the
  *           following descriptors will be searched for at the peer: Client Characteristic Configuration,
  *           Characteristic Extended Properties, Characteristic User Description, and Report Reference.
  *
@@ -36,6 +36,21 @@
  * @note     The application must propagate BLE stack events to this module by calling
  *           ble_db_discovery_on_ble_evt().
  *
+ * @note     The discovered characteristics are stored in a pool of
+ *           @ref BLE_DB_DISCOVERY_CHAR_POOL_SIZE characteristics that is shared by all connections.
+ *           A service takes as many characteristics as its handle range can hold, and gives back
+ *           the ones that were not found when its characteristic discovery is complete. All are
+ *           given back when the events of the connection have been raised. If the pool is
+ *           exhausted, a @ref BLE_DB_DISCOVERY_ERROR event with NRF_ERROR_NO_MEM is raised.
+ *
+ * @note     If @ref BLE_DB_DISCOVERY_CACHE_ENABLED is set, the discovered database of a bonded
+ *           peer is stored through the Peer Manager (@ref PM_PEER_DATA_ID_GATT_REMOTE). On the
+ *           next connection to the peer, @ref ble_db_discovery_start raises the events from
+ *           the stored database without discovering it again. To be notified about changes of
+ *           the database, register the Generic Attribute service (@ref BLE_UUID_GATT) and enable
+ *           indications of its Service Changed characteristic. On a Service Changed
+ *           indication, the stored database is deleted and the discovery is restarted.
+ *
  */
 
 #ifndef BLE_DB_DISCOVERY_H__
@@ -47,6 +62,7 @@
 #include "ble_gattc.h"
 #include "ble_srv_common.h"
 #include "ble_gatt_db.h"
+#include "sdk_common.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -55,6 +71,14 @@ extern "C" {
 
 #define BLE_DB_DISCOVERY_MAX_SRV          6  /**< Maximum number of services supported by this module. This also indicates the maximum number of users allowed to be registered to this module. (one user per service). */
 
+/** @brief Number of characteristics in the pool shared by the discoveries of all connections, from 1 to 255.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_DB_DISCOVERY_CHAR_POOL_SIZE
+#define BLE_DB_DISCOVERY_CHAR_POOL_SIZE 16
+#endif
+
 
 /**@brief   Type of the DB Discovery event.
  */
@@ -68,6 +92,21 @@ typedef enum
 
 
 
+/**@brief   Structure for holding a discovered service. This is intended for internal use.
+ *
+ * @details The characteristics are not part of the structure. They are the characteristics
+ *          char_first to char_first + char_count - 1 of the pool.
+ */
+typedef struct
+{
+    ble_uuid_t               srv_uuid;      /**< UUID of the service. */
+    ble_gattc_handle_range_t handle_range;  /**< Service Handle Range. The start handle is 0 if the service was not found. */
+    uint8_t                  char_first;    /**< Index of the first characteristic in the pool. */
+    uint8_t                  char_count;    /**< Number of characteristics discovered. */
+    uint8_t                  char_space;    /**< Number of characteristics taken from the pool. */
+} ble_db_discovery_srv_t;
+
+
 /**@brief   Structure for holding the information related to the GATT database at the server.
  *
  * @details This module identifies a remote database. Use one instance of this structure per
@@ -77,13 +116,17 @@ typedef enum
  */
 typedef struct
 {
-    ble_gatt_db_srv_t   services[BLE_DB_DISCOVERY_MAX_SRV];  /**< Information related to the current service being discovered. This is intended for internal use during service discovery.*/
+    ble_db_discovery_srv_t services[BLE_DB_DISCOVERY_MAX_SRV]; /**< Information related to the current service being discovered. This is intended for internal use during service discovery.*/
     uint8_t             srv_count;                           /**< Number of services at the peers GATT database.*/
     uint8_t             curr_char_ind;                       /**< Index of the current characteristic being discovered. This is intended for internal use during service discovery.*/
     uint8_t             curr_srv_ind;                        /**< Index of the current service being discovered. This is intended for internal use during service discovery.*/
     bool                discovery_in_progress;               /**< Variable to indicate if there is a service discovery in progress. */
     uint8_t             discoveries_count;                   /**< Number of service discoveries made, both successful and unsuccessful. */
     uint16_t            conn_handle;                         /**< Connection handle on which the discovery is started*/
+    uint16_t            sc_handle;                           /**< Value handle of the Service Changed characteristic of the peer, or BLE_GATT_HANDLE_INVALID. Used with @ref BLE_DB_DISCOVERY_CACHE_ENABLED. */
+#if NRF_MODULE_ENABLED(BLE_DB_DISCOVERY_CACHE) || defined(__SDK_DOXYGEN__)
+    ble_gatt_db_srv_t   cache_image[BLE_DB_DISCOVERY_MAX_SRV]; /**< Database of the peer in the stored format. It is written to flash asynchronously, so it must stay valid until the next discovery on the connection. */
+#endif
 } ble_db_discovery_t;
 
 
@@ -149,6 +192,10 @@ uint32_t ble_db_discovery_evt_register(const ble_uuid_t * const             p_uu
 
 
 /**@brief Function for starting the discovery of the GATT database at the server.
+ *
+ * @details If @ref BLE_DB_DISCOVERY_CACHE_ENABLED is set and a database of all registered
+ *          services is stored for the bonded peer, the events are raised from the stored
+ *          database before this function returns.
  *
  * @warning p_db_discovery structure must be zero-initialized.
  *
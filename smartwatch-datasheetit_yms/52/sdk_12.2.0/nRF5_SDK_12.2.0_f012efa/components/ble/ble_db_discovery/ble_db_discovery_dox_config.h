@@ -12,5 +12,28 @@
  */
 #define BLE_DB_DISCOVERY_ENABLED
 
+/** @brief Enable storing the discovered database of bonded peers through the Peer Manager.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_DB_DISCOVERY_CACHE_ENABLED
+
+/** @brief Discover all primary services in one pass and the descriptors of a service with one range.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_DB_DISCOVERY_BATCH_ENABLED
+
+/** @brief Number of characteristics in the pool shared by the discoveries of all connections, from 1 to 255.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_DB_DISCOVERY_CHAR_POOL_SIZE
+
 
 /** @} */
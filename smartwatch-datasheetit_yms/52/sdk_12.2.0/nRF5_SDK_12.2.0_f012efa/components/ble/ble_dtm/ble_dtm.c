@@ -84,9 +84,30 @@ typedef enum
     STATE_IDLE,                                                              /**< State when system has just initialized, or current test has completed. */
     STATE_TRANSMITTER_TEST,                                                  /**< State used when a DTM Transmission test is running. */
     STATE_CARRIER_TEST,                                                      /**< State used when a DTM Carrier test is running (Vendor specific test). */
-    STATE_RECEIVER_TEST                                                      /**< State used when a DTM Receive test is running. */
+    STATE_RECEIVER_TEST,                                                     /**< State used when a DTM Receive test is running. */
+    STATE_SWEEP                                                              /**< State used when a sweep is running. */
 } state_t;
 
+/**@brief Sweep state.
+ */
+typedef struct
+{
+    dtm_sweep_config_t   config;                                             /**< Configuration. */
+    dtm_sweep_result_t * p_results;                                          /**< Results of the steps. */
+    uint32_t             max_results;                                        /**< Number of elements in p_results. */
+    uint32_t             step_count;                                         /**< Number of steps. */
+    uint32_t             step;                                               /**< Current step. */
+    uint32_t             tick;                                               /**< Packet intervals since the start of the step. */
+    uint32_t             sync_ticks;                                         /**< Packet intervals waited for the first packet. */
+    uint32_t             rssi_sum;                                           /**< Sum of the RSSI of the current step. */
+    uint8_t              channel;                                            /**< Channel of the current step. */
+    uint8_t              mode;                                               /**< Radio mode of the current step. */
+    uint8_t              pattern;                                            /**< Payload pattern of the current step. */
+    bool                 configured;                                         /**< A configuration was set. */
+    bool                 rx;                                                 /**< This is the receiving device. */
+    dtm_sweep_status_t   status;                                             /**< Status. */
+} sweep_t;
+
 // Internal variables set as side effects of commands or events.
 static state_t           m_state = STATE_UNINITIALIZED;                      /**< Current machine state. */
 static uint16_t          m_rx_pkt_count;                                     /**< Number of valid packets received. */
@@ -119,6 +140,7 @@ static uint32_t          m_crc_poly          = 0x0000065B;                   /**
 static uint32_t          m_crc_init          = 0x00555555;                   /**< Initial value for CRC calculation. */
 static uint8_t           m_radio_mode        = RADIO_MODE_MODE_Ble_1Mbit;    /**< nRF51 specific radio mode value. */
 static uint32_t          m_txIntervaluS      = 2500;                          /**< Time between start of Tx packets (in uS). */
+static sweep_t           m_sweep;                                            /**< Sweep state. */
 
 
 /**@brief Function for verifying that a received PDU has the expected structure and content.
@@ -165,6 +187,64 @@ static bool check_pdu(void)
 }
 
 
+/**@brief Function for filling the PDU to transmit.
+ *
+ * @param[in] type    Payload pattern, one of the DTM_PKT_ values except DTM_PKT_VENDORSPECIFIC.
+ * @param[in] length  Payload length.
+ */
+static void pdu_fill(dtm_pkt_type_t type, uint32_t length)
+{
+    // Note that PDU uses 4 bits even though BLE DTM uses only 2 (the HCI SDU uses all 4)
+    m_pdu.content[DTM_HEADER_OFFSET] = ((uint8_t)type & 0x0F);
+    m_pdu.content[DTM_LENGTH_OFFSET] = length;
+
+    switch (type)
+    {
+        case DTM_PKT_PRBS9:
+            // Non-repeated, must copy entire pattern to PDU
+            memcpy(m_pdu.content + DTM_HEADER_SIZE, m_prbs_content, length);
+            break;
+
+        case DTM_PKT_0X0F:
+            // Bit pattern 00001111 repeated
+            memset(m_pdu.content + DTM_HEADER_SIZE, RFPHY_TEST_0X0F_REF_PATTERN, length);
+            break;
+
+        default:
+            // Bit pattern 01010101 repeated
+            memset(m_pdu.content + DTM_HEADER_SIZE, RFPHY_TEST_0X55_REF_PATTERN, length);
+            break;
+    }
+}
+
+
+/**@brief Function for getting the interval between the start of two packets.
+ *
+ * @details The delay between each packet is described in the Bluetooth Core Specification
+ *          version 4.2 Vol. 6 Part F Section 4.1.6.
+ *
+ * @param[in] length  Payload length.
+ *
+ * @return Interval in microseconds.
+ */
+static uint32_t tx_interval_get(uint32_t length)
+{
+    if ((length + DTM_ON_AIR_OVERHEAD_SIZE ) * 8  <= 376)
+    {
+        return 625;
+    }
+    else if ((length + DTM_ON_AIR_OVERHEAD_SIZE ) * 8  <= 1000)
+    {
+        return 1250;
+    }
+    else if ((length + DTM_ON_AIR_OVERHEAD_SIZE ) * 8  <= 1624)
+    {
+        return 1875;
+    }
+    return 2500;
+}
+
+
 /**@brief Function for turning off the radio after a test.
  *        Also called after test done, to be ready for next test.
  */
@@ -261,6 +341,12 @@ static void radio_prepare(bool rx)
  */
 static void dtm_test_done(void)
 {
+    if (m_state == STATE_SWEEP)
+    {
+        m_sweep.status  = DTM_SWEEP_STOPPED;
+        NRF_RADIO->MODE = m_radio_mode << RADIO_MODE_MODE_Pos;
+    }
+
     dtm_turn_off_test();
     NRF_PPI->CHENCLR = 0x01;
     NRF_PPI->CH[0].EEP = 0;     // Break connection from timer to radio to stop transmit loop
@@ -305,6 +391,227 @@ static uint32_t timer_init(void)
 }
 
 
+/**@brief Function for getting the value of the nth set bit of a mask.
+ */
+static uint8_t mask_nth_bit(uint64_t mask, uint32_t n)
+{
+    uint8_t bit = 0;
+
+    for (;;)
+    {
+        if ((mask & 1) && (n-- == 0))
+        {
+            return bit;
+        }
+        mask >>= 1;
+        bit++;
+    }
+}
+
+
+/**@brief Function for counting the set bits of a mask.
+ */
+static uint32_t mask_bit_count(uint64_t mask)
+{
+    uint32_t count = 0;
+
+    for (; mask != 0; mask &= mask - 1)
+    {
+        count++;
+    }
+    return count;
+}
+
+
+/**@brief Function for tuning the radio to a sweep step.
+ *
+ * @details The channel is the fastest changing parameter, then the radio mode, then the pattern.
+ *          The radio must be disabled.
+ */
+static void sweep_step_prepare(void)
+{
+    uint32_t channels = mask_bit_count(m_sweep.config.channel_mask);
+    uint32_t modes    = mask_bit_count(m_sweep.config.mode_mask);
+    uint32_t step     = m_sweep.step;
+
+    m_sweep.channel  = mask_nth_bit(m_sweep.config.channel_mask, step % channels);
+    step            /= channels;
+    m_sweep.mode     = mask_nth_bit(m_sweep.config.mode_mask, step % modes);
+    step            /= modes;
+    m_sweep.pattern  = mask_nth_bit(m_sweep.config.pattern_mask, step);
+    m_sweep.tick     = 0;
+    m_sweep.rssi_sum = 0;
+
+    NRF_RADIO->MODE      = m_sweep.mode << RADIO_MODE_MODE_Pos;
+    NRF_RADIO->FREQUENCY = (m_sweep.channel << 1) + 2;
+
+    if (m_sweep.rx)
+    {
+        dtm_sweep_result_t * p_result = &m_sweep.p_results[m_sweep.step];
+
+        memset(p_result, 0, sizeof(dtm_sweep_result_t));
+        p_result->channel = m_sweep.channel;
+        p_result->mode    = m_sweep.mode;
+        p_result->pattern = m_sweep.pattern;
+
+        memset(&m_pdu, 0, DTM_PDU_MAX_MEMORY_SIZE);
+        NRF_RADIO->EVENTS_END = 0;
+        NRF_RADIO->TASKS_RXEN = 1;
+    }
+    else
+    {
+        pdu_fill(m_sweep.pattern, m_sweep.config.length);
+    }
+}
+
+
+/**@brief Function for disabling the radio between two sweep steps.
+ */
+static void sweep_radio_disable(void)
+{
+    NRF_RADIO->EVENTS_DISABLED = 0;
+    NRF_RADIO->TASKS_DISABLE   = 1;
+
+    while (NRF_RADIO->EVENTS_DISABLED == 0)
+    {
+        // Do nothing
+    }
+    NRF_RADIO->EVENTS_DISABLED = 0;
+}
+
+
+/**@brief Function for ending a sweep.
+ */
+static void sweep_end(dtm_sweep_status_t status)
+{
+    dtm_test_done();
+    m_sweep.status = status;
+}
+
+
+/**@brief Function for handling a packet received during a sweep.
+ */
+static void sweep_on_end(void)
+{
+    dtm_sweep_result_t * p_result = &m_sweep.p_results[m_sweep.step];
+    uint8_t              rssi     = NRF_RADIO->RSSISAMPLE;
+    bool                 valid;
+
+    NRF_RADIO->TASKS_RXEN = 1;
+
+    // A packet of a wrong pattern or length is a payload error, not a packet of another step.
+    valid = (NRF_RADIO->CRCSTATUS == 1) && check_pdu()
+         && ((m_pdu.content[DTM_HEADER_OFFSET] & 0x0F) == m_sweep.pattern)
+         && (m_pdu.content[DTM_LENGTH_OFFSET] == m_sweep.config.length);
+    memset(&m_pdu, 0, DTM_PDU_MAX_MEMORY_SIZE);
+
+    if (!valid)
+    {
+        if (m_sweep.status == DTM_SWEEP_RUNNING)
+        {
+            p_result->crc_errors++;
+        }
+        return;
+    }
+
+    if (m_sweep.status == DTM_SWEEP_SYNC)
+    {
+        // Take this packet as the first of the sweep, and the start of the interval in which it
+        // was sent as the start of the timer period.
+        mp_timer->TASKS_CLEAR       = 1;
+        mp_timer->EVENTS_COMPARE[0] = 0;
+        m_sweep.tick                = (DTM_SWEEP_GUARD_INTERVALS / 2) + 1;
+        m_sweep.status              = DTM_SWEEP_RUNNING;
+    }
+
+    m_rx_pkt_count++;
+    p_result->received++;
+    m_sweep.rssi_sum += rssi;
+
+    if ((p_result->received == 1) || (rssi < p_result->rssi_min))
+    {
+        p_result->rssi_min = rssi;
+    }
+    if (rssi > p_result->rssi_max)
+    {
+        p_result->rssi_max = rssi;
+    }
+
+    if (rssi < BLE_DTM_SWEEP_RSSI_FIRST)
+    {
+        p_result->rssi_hist[0]++;
+    }
+    else
+    {
+        uint32_t bin = ((rssi - BLE_DTM_SWEEP_RSSI_FIRST) / BLE_DTM_SWEEP_RSSI_BIN_WIDTH) + 1;
+
+        p_result->rssi_hist[MIN(bin, BLE_DTM_SWEEP_RSSI_BINS - 1)]++;
+    }
+}
+
+
+/**@brief Function for handling a packet interval during a sweep.
+ *
+ * @details A step lasts the packets of the step and DTM_SWEEP_GUARD_INTERVALS packet intervals.
+ *          The transmitting device sends the packets in the middle of the step, so that both
+ *          devices have half of the guard intervals to tune to the next step.
+ */
+static void sweep_on_tick(void)
+{
+    uint32_t const first = DTM_SWEEP_GUARD_INTERVALS / 2;
+
+    if (m_sweep.status == DTM_SWEEP_SYNC)
+    {
+        m_sweep.sync_ticks++;
+        if ((m_sweep.config.sync_timeout_ms != 0) &&
+            (m_sweep.sync_ticks * mp_timer->CC[0] >= m_sweep.config.sync_timeout_ms * 1000UL))
+        {
+            sweep_end(DTM_SWEEP_SYNC_TIMEOUT);
+        }
+        return;
+    }
+
+    m_sweep.tick++;
+
+    if (!m_sweep.rx)
+    {
+        // The timer starts a packet on the interval after the PPI channel is enabled.
+        if (m_sweep.tick == first)
+        {
+            NRF_PPI->CHENSET = 0x01;
+        }
+        else if (m_sweep.tick == first + m_sweep.config.packets)
+        {
+            NRF_PPI->CHENCLR = 0x01;
+        }
+    }
+
+    if (m_sweep.tick < m_sweep.config.packets + DTM_SWEEP_GUARD_INTERVALS)
+    {
+        return;
+    }
+
+    if (m_sweep.rx)
+    {
+        dtm_sweep_result_t * p_result = &m_sweep.p_results[m_sweep.step];
+
+        if (p_result->received != 0)
+        {
+            p_result->rssi_avg = (m_sweep.rssi_sum + (p_result->received / 2)) / p_result->received;
+        }
+    }
+
+    if (++m_sweep.step == m_sweep.step_count)
+    {
+        sweep_end(DTM_SWEEP_DONE);
+        return;
+    }
+
+    sweep_radio_disable();
+    sweep_step_prepare();
+}
+
+
 /**@brief Function for handling vendor specific commands.
  *        Used when packet type is set to Vendor specific.
  *        The length field is used for encoding vendor specific command.
@@ -350,6 +657,10 @@ static uint32_t dtm_vendor_specific_pkt(uint32_t vendor_cmd, dtm_freq_t vendor_o
                 return DTM_ERROR_ILLEGAL_CONFIGURATION;
             }
             break;
+
+        case SWEEP_RX_START:
+        case SWEEP_TX_START:
+            return dtm_sweep_start(vendor_cmd == SWEEP_RX_START);
     }
     // Event code is unchanged, successful
     return DTM_SUCCESS;
@@ -387,7 +698,14 @@ uint32_t dtm_wait(void)
             NRF_RADIO->EVENTS_END = 0;
             NVIC_ClearPendingIRQ(RADIO_IRQn);
 
-            if (m_state == STATE_RECEIVER_TEST)
+            if (m_state == STATE_SWEEP)
+            {
+                if (m_sweep.rx)
+                {
+                    sweep_on_end();
+                }
+            }
+            else if (m_state == STATE_RECEIVER_TEST)
             {
                 NRF_RADIO->TASKS_RXEN = 1;
                 if ((NRF_RADIO->CRCSTATUS == 1) && check_pdu())
@@ -407,6 +725,11 @@ uint32_t dtm_wait(void)
         if (mp_timer->EVENTS_COMPARE[0] != 0)
         {
             mp_timer->EVENTS_COMPARE[0] = 0;
+
+            if (m_state == STATE_SWEEP)
+            {
+                sweep_on_tick();
+            }
         }
         else if (mp_timer->EVENTS_COMPARE[1] != 0)
         {
@@ -464,7 +787,7 @@ uint32_t dtm_cmd(dtm_cmd_t cmd, dtm_freq_t freq, uint32_t length, dtm_pkt_type_t
             m_event = LE_TEST_STATUS_EVENT_ERROR;
             return DTM_ERROR_INVALID_STATE;
         }
-        m_event = LE_PACKET_REPORTING_EVENT | m_rx_pkt_count;
+        m_event = LE_PACKET_REPORTING_EVENT | (m_rx_pkt_count & 0x7FFF);
         dtm_test_done();
         return DTM_SUCCESS;
     }
@@ -507,58 +830,24 @@ uint32_t dtm_cmd(dtm_cmd_t cmd, dtm_freq_t freq, uint32_t length, dtm_pkt_type_t
             return DTM_ERROR_ILLEGAL_LENGTH;
         }
 
-        // Note that PDU uses 4 bits even though BLE DTM uses only 2 (the HCI SDU uses all 4)
-        m_pdu.content[DTM_HEADER_OFFSET] = ((uint8_t)m_packet_type & 0x0F);
-        m_pdu.content[DTM_LENGTH_OFFSET] = m_packet_length;
-
-        switch (m_packet_type)
+        if (m_packet_type == DTM_PKT_VENDORSPECIFIC)
         {
-            case DTM_PKT_PRBS9:
-                // Non-repeated, must copy entire pattern to PDU
-                memcpy(m_pdu.content + DTM_HEADER_SIZE, m_prbs_content, m_packet_length);
-                break;
-
-            case DTM_PKT_0X0F:
-                // Bit pattern 00001111 repeated
-                memset(m_pdu.content + DTM_HEADER_SIZE, RFPHY_TEST_0X0F_REF_PATTERN, m_packet_length);
-                break;
-
-            case DTM_PKT_0X55:
-                // Bit pattern 01010101 repeated
-                memset(m_pdu.content + DTM_HEADER_SIZE, RFPHY_TEST_0X55_REF_PATTERN, m_packet_length);
-                break;
-
-            case DTM_PKT_VENDORSPECIFIC:
-                // The length field is for indicating the vendor specific command to execute.
-                // The frequency field is used for vendor specific options to the command.
-                return dtm_vendor_specific_pkt(length, freq);
-
-            default:
-                // Parameter error
-                m_event = LE_TEST_STATUS_EVENT_ERROR;
-                return DTM_ERROR_ILLEGAL_CONFIGURATION;
+            // The length field is for indicating the vendor specific command to execute.
+            // The frequency field is used for vendor specific options to the command.
+            return dtm_vendor_specific_pkt(length, freq);
         }
+        if (m_packet_type > PACKET_TYPE_MAX)
+        {
+            // Parameter error
+            m_event = LE_TEST_STATUS_EVENT_ERROR;
+            return DTM_ERROR_ILLEGAL_CONFIGURATION;
+        }
+        pdu_fill(m_packet_type, m_packet_length);
 
         // Initialize CRC value, set channel:
         radio_prepare(TX_MODE);
-        // Set the timer to the correct period. The delay between each packet is described in the
-        // Bluetooth Core Spsification version 4.2 Vol. 6 Part F Section 4.1.6.
-        if ((m_packet_length + DTM_ON_AIR_OVERHEAD_SIZE ) * 8  <= 376)
-        {
-            mp_timer->CC[0]       = 625;                        // 625uS with 1MHz clock to the timer
-        }
-        else if ((m_packet_length + DTM_ON_AIR_OVERHEAD_SIZE ) * 8  <= 1000)
-        {
-            mp_timer->CC[0]       = 1250;                        // 625uS with 1MHz clock to the timer
-        }
-        else if ((m_packet_length + DTM_ON_AIR_OVERHEAD_SIZE ) * 8  <= 1624)
-        {
-            mp_timer->CC[0]       = 1875;                        // 625uS with 1MHz clock to the timer
-        }
-        else
-        {
-            mp_timer->CC[0]       = 2500;                        // 625uS with 1MHz clock to the timer
-        }
+        // Set the timer to the correct period, with 1MHz clock to the timer.
+        mp_timer->CC[0] = tx_interval_get(m_packet_length);
 
         // Configure PPI so that timer will activate radio every 625 us
         NRF_PPI->CH[0].EEP = (uint32_t)&mp_timer->EVENTS_COMPARE[0];
@@ -631,5 +920,89 @@ bool dtm_set_timer(uint32_t new_timer)
     return dtm_hw_set_timer(&mp_timer, &m_timer_irq, new_timer);
 }
 
+uint32_t dtm_sweep_config_set(dtm_sweep_config_t const * p_config,
+                              dtm_sweep_result_t       * p_results,
+                              uint32_t                   max_results)
+{
+    uint32_t const valid_modes = (1 << RADIO_MODE_MODE_Nrf_1Mbit) |
+                                 (1 << RADIO_MODE_MODE_Nrf_2Mbit) |
+                                 (1 << RADIO_MODE_MODE_Ble_1Mbit);
+
+    if (m_state > STATE_IDLE)
+    {
+        return DTM_ERROR_INVALID_STATE;
+    }
+
+    // The packet interval is chosen for 1 Mbit, so the 250 kbit mode is not valid.
+    if ((p_config->channel_mask == 0) || (p_config->channel_mask >> (PHYS_CH_MAX + 1)) ||
+        (p_config->mode_mask == 0)    || (p_config->mode_mask & ~valid_modes)          ||
+        (p_config->pattern_mask == 0) || (p_config->pattern_mask >> (PACKET_TYPE_MAX + 1)) ||
+        (p_config->packets == 0))
+    {
+        return DTM_ERROR_ILLEGAL_CONFIGURATION;
+    }
+
+    m_sweep.config      = *p_config;
+    m_sweep.p_results   = p_results;
+    m_sweep.max_results = max_results;
+    m_sweep.step_count  = mask_bit_count(p_config->channel_mask) *
+                          mask_bit_count(p_config->mode_mask)    *
+                          mask_bit_count(p_config->pattern_mask);
+    m_sweep.configured  = true;
+
+    return DTM_SUCCESS;
+}
+
+
+uint32_t dtm_sweep_start(bool rx)
+{
+    if (m_state > STATE_IDLE)
+    {
+        return DTM_ERROR_INVALID_STATE;
+    }
+
+    if (!m_sweep.configured ||
+        (rx && ((m_sweep.p_results == NULL) || (m_sweep.max_results < m_sweep.step_count))))
+    {
+        return DTM_ERROR_ILLEGAL_CONFIGURATION;
+    }
+
+    m_rx_pkt_count     = 0;
+    m_sweep.rx         = rx;
+    m_sweep.step       = 0;
+    m_sweep.sync_ticks = 0;
+    m_sweep.status     = rx ? DTM_SWEEP_SYNC : DTM_SWEEP_RUNNING;
+
+    memset(&m_pdu, 0, DTM_PDU_MAX_MEMORY_SIZE);
+    radio_prepare(TX_MODE);
+    mp_timer->CC[0] = tx_interval_get(m_sweep.config.length);
+
+    if (rx)
+    {
+        NRF_RADIO->SHORTS |= RADIO_SHORTS_ADDRESS_RSSISTART_Msk;
+    }
+    else
+    {
+        // Enabled during each step by sweep_on_tick().
+        NRF_PPI->CH[0].EEP = (uint32_t)&mp_timer->EVENTS_COMPARE[0];
+        NRF_PPI->CH[0].TEP = (uint32_t)&NRF_RADIO->TASKS_TXEN;
+    }
+
+    sweep_step_prepare();
+    m_state = STATE_SWEEP;
+
+    return DTM_SUCCESS;
+}
+
+
+dtm_sweep_status_t dtm_sweep_status_get(uint32_t * p_steps)
+{
+    if (p_steps != NULL)
+    {
+        *p_steps = m_sweep.step;
+    }
+    return m_sweep.status;
+}
+
 /// @}
 #endif // NRF_MODULE_ENABLED(BLE_DTM)
@@ -16,6 +16,18 @@
  * @{
  * @ingroup ble_sdk_lib
  * @brief Module for testing RF/PHY using DTM commands.
+ *
+ * @details Besides the standard commands, the module has a sweep mode for production tests. A
+ *          sweep runs a list of steps, one for each combination of channel, radio mode and
+ *          payload pattern given by @ref dtm_sweep_config_set, without commands between the steps.
+ *          One device transmits a fixed number of packets in each step, and the other receives
+ *          them and counts the packets, the CRC errors and the RSSI of each step (@ref
+ *          dtm_sweep_result_t). The receiving device must be started first: it takes the first
+ *          packet it receives as the start of the sweep, and then follows the same timing.
+ *
+ *          A sweep is started with the vendor specific commands @ref SWEEP_RX_START and
+ *          @ref SWEEP_TX_START, or with @ref dtm_sweep_start, and stopped early with LE_TEST_END.
+ *          The results stay in RAM until the next sweep, for the application to send out.
  */
 
 #ifndef BLE_DTM_H__
@@ -52,6 +64,8 @@ typedef uint32_t dtm_cmd_t;                                             /**< DTM
 #define CARRIER_TEST_STUDIO             1                               /**< nRFgo Studio uses value 1 in length field, to indicate a constant, unmodulated carrier until LE_TEST_END or LE_RESET */
 #define SET_TX_POWER                    2                               /**< Set transmission power, value -40..+4 dBm in steps of 4 */
 #define SELECT_TIMER                    3                               /**< Select on of the 16 MHz timers 0, 1 or 2 */
+#define SWEEP_RX_START                  4                               /**< Start a sweep as the receiving device. */
+#define SWEEP_TX_START                  5                               /**< Start a sweep as the transmitting device. */
 
 #define LE_PACKET_REPORTING_EVENT       0x8000                          /**< DTM Packet reporting event, returned by the device to the tester. */
 #define LE_TEST_STATUS_EVENT_SUCCESS    0x0000                          /**< DTM Status event, indicating success. */
@@ -70,6 +84,32 @@ typedef uint32_t dtm_cmd_t;                                             /**< DTM
 #define DTM_ERROR_ILLEGAL_CONFIGURATION 0x04                            /**< Parameter out of range (legal range is function dependent). */
 #define DTM_ERROR_UNINITIALIZED         0x05                            /**< DTM module has not been initialized by the application. */
 
+/** @brief Number of bins of the RSSI histogram of a sweep step.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_DTM_SWEEP_RSSI_BINS
+#define BLE_DTM_SWEEP_RSSI_BINS         8
+#endif
+
+/** @brief Upper bound of the first bin of the RSSI histogram, in -dBm.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_DTM_SWEEP_RSSI_FIRST
+#define BLE_DTM_SWEEP_RSSI_FIRST        30
+#endif
+
+/** @brief Width of a bin of the RSSI histogram, in dB.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_DTM_SWEEP_RSSI_BIN_WIDTH
+#define BLE_DTM_SWEEP_RSSI_BIN_WIDTH    8
+#endif
+
+#define DTM_SWEEP_GUARD_INTERVALS       4                               /**< Packet intervals without packets in each sweep step, for changing channel. */
+
 /**@details The UART poll cycle in micro seconds.
  *          A baud rate of e.g. 19200 bits / second, and 8 data bits, 1 start/stop bit, no flow control,
  *          give the time to transmit a byte: 10 bits * 1/19200 = approx: 520 us.
@@ -120,6 +160,49 @@ typedef uint32_t dtm_freq_t;                                            /**< Phy
 typedef uint32_t dtm_pkt_type_t;                                        /**< Type for holding the requested DTM payload type.*/
 
 
+/**@brief Sweep configuration. */
+typedef struct
+{
+    uint64_t channel_mask;    /**< Channels to test, bit n for channel n (0..39). */
+    uint8_t  mode_mask;       /**< Radio modes to test, bit n for RADIO MODE value n: RADIO_MODE_MODE_Nrf_1Mbit, RADIO_MODE_MODE_Nrf_2Mbit or RADIO_MODE_MODE_Ble_1Mbit. */
+    uint8_t  pattern_mask;    /**< Payload patterns to test, bit n for DTM_PKT_ value n. */
+    uint8_t  length;          /**< Payload length, 0..255. */
+    uint16_t packets;         /**< Packets sent in each step. */
+    uint16_t sync_timeout_ms; /**< Time the receiving device waits for the first packet, 0 for no limit. */
+} dtm_sweep_config_t;
+
+/**@brief Result of a sweep step, on the receiving device.
+ *
+ * @details The packet error rate is 1 - received / packets. RSSI values are in -dBm, so larger
+ *          values are weaker signals. Bin 0 of the histogram counts the packets with an RSSI
+ *          below BLE_DTM_SWEEP_RSSI_FIRST, each next bin the next BLE_DTM_SWEEP_RSSI_BIN_WIDTH,
+ *          and the last bin all weaker ones.
+ */
+typedef struct
+{
+    uint8_t  channel;                            /**< Channel. */
+    uint8_t  mode;                               /**< Radio mode. */
+    uint8_t  pattern;                            /**< Payload pattern. */
+    uint8_t  rssi_min;                           /**< Strongest RSSI. 0 if no packet was received. */
+    uint8_t  rssi_max;                           /**< Weakest RSSI. */
+    uint8_t  rssi_avg;                           /**< Average RSSI. */
+    uint16_t received;                           /**< Packets received with the right CRC and payload. */
+    uint16_t crc_errors;                         /**< Packets received with a CRC or payload error. */
+    uint16_t rssi_hist[BLE_DTM_SWEEP_RSSI_BINS]; /**< RSSI histogram of the received packets. */
+} dtm_sweep_result_t;
+
+/**@brief Sweep status. */
+typedef enum
+{
+    DTM_SWEEP_IDLE,         /**< No sweep has run. */
+    DTM_SWEEP_SYNC,         /**< The receiving device waits for the first packet. */
+    DTM_SWEEP_RUNNING,      /**< The sweep is running. */
+    DTM_SWEEP_DONE,         /**< All steps have run. */
+    DTM_SWEEP_STOPPED,      /**< The sweep was stopped with LE_TEST_END or LE_RESET. */
+    DTM_SWEEP_SYNC_TIMEOUT, /**< No packet was received before the timeout. */
+} dtm_sweep_status_t;
+
+
 /**@brief Function for initializing or re-initializing DTM module
  *
  * @return DTM_SUCCESS on successful initialization of the DTM module.
@@ -180,6 +263,43 @@ bool dtm_set_timer(uint32_t new_timer);
 bool dtm_set_txpower(uint32_t new_tx_power);
 
 
+/**@brief Function for setting the sweep configuration.
+ *
+ * @note        Must be called when no DTM test is running.
+ *
+ * @param[in]   p_config      Configuration. Copied.
+ * @param[in]   p_results     Results of the steps, used by the receiving device. Can be NULL on
+ *                            the transmitting device.
+ * @param[in]   max_results   Number of elements in @p p_results.
+ *
+ * @return      DTM_SUCCESS, DTM_ERROR_INVALID_STATE if a test is running, or
+ *              DTM_ERROR_ILLEGAL_CONFIGURATION if a mask is empty or contains invalid values.
+ */
+uint32_t dtm_sweep_config_set(dtm_sweep_config_t const * p_config,
+                              dtm_sweep_result_t       * p_results,
+                              uint32_t                   max_results);
+
+
+/**@brief Function for starting a sweep.
+ *
+ * @param[in]   rx   true for the receiving device, false for the transmitting device.
+ *
+ * @return      DTM_SUCCESS, DTM_ERROR_INVALID_STATE if a test is running, or
+ *              DTM_ERROR_ILLEGAL_CONFIGURATION if there is no configuration, or too few results
+ *              for the receiving device.
+ */
+uint32_t dtm_sweep_start(bool rx);
+
+
+/**@brief Function for getting the status of the last sweep.
+ *
+ * @param[out]  p_steps   Number of steps finished. Can be NULL.
+ *
+ * @return      Status.
+ */
+dtm_sweep_status_t dtm_sweep_status_get(uint32_t * p_steps);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -12,5 +12,23 @@
  */
 #define BLE_DTM_ENABLED
 
+/** @brief Number of bins of the RSSI histogram of a sweep step.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_DTM_SWEEP_RSSI_BINS
+
+/** @brief Upper bound of the first bin of the RSSI histogram, in -dBm.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_DTM_SWEEP_RSSI_FIRST
+
+/** @brief Width of a bin of the RSSI histogram, in dB.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_DTM_SWEEP_RSSI_BIN_WIDTH
+
 
 /** @} */
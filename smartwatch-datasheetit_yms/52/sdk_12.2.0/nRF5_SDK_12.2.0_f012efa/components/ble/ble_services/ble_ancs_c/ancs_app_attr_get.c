@@ -13,6 +13,7 @@
  * Server implementations such as the ones found in iOS can be changed at any time by Apple and may cause this client implementation to stop working.
  */
 
+#include "sdk_common.h"
 #include "ancs_app_attr_get.h"
 #include "nrf_ble_ancs_c.h"
 #include "ancs_tx_buffer.h"
@@ -307,7 +308,9 @@ static uint32_t app_attr_get(ble_ancs_c_t  * p_ancs,
                            p_ancs->service.control_point_char.handle_value,
                            &p_msg);
     
+#if !NRF_MODULE_ENABLED(BLE_ANCS_C_PIPELINE)
     p_ancs->parse_info.expected_number_of_attrs = p_ancs->number_of_requested_attr;
+#endif
     
     tx_buffer_process();
     return NRF_SUCCESS;
@@ -329,7 +332,12 @@ uint32_t ancs_c_app_attr_request(ble_ancs_c_t          * p_ancs,
         return NRF_ERROR_INVALID_PARAM;
     }
 
+#if NRF_MODULE_ENABLED(BLE_ANCS_C_PIPELINE)
+    // The response is parsed after the responses to the requests that were sent before.
+    p_ancs->rsp_pending++;
+#else
     p_ancs->parse_info.parse_state = COMMAND_ID;
+#endif
     err_code                       = app_attr_get(p_ancs, p_app_id, len);
     VERIFY_SUCCESS(err_code);
     return NRF_SUCCESS;
@@ -13,6 +13,7 @@
  * Server implementations such as the ones found in iOS can be changed at any time by Apple and may cause this client implementation to stop working.
  */
 
+ #include "sdk_common.h"
  #include "nrf_ble_ancs_c.h"
  #include "ancs_attr_parser.h"
  #include "nrf_log.h"
@@ -27,6 +28,53 @@ static bool all_req_attrs_parsed(ble_ancs_c_t * p_ancs)
     return false;
 }
 
+#if NRF_MODULE_ENABLED(BLE_ANCS_C_PIPELINE)
+/**@brief Function for counting the attributes that are requested from a given attribute list.
+ *
+ * @param[in] p_attr_list List of attributes.
+ * @param[in] nb_of_attr  Number of attributes in the list.
+ *
+ * @return Number of requested attributes.
+ */
+static uint32_t attr_requested_count(ble_ancs_c_attr_list_t const * p_attr_list, uint32_t nb_of_attr)
+{
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; i < nb_of_attr; i++)
+    {
+        if (p_attr_list[i].get)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+#endif // NRF_MODULE_ENABLED(BLE_ANCS_C_PIPELINE)
+
+/**@brief Function for ending the parsing of a response, after all requested attributes have been received.
+ *
+ * @details With pipelining, the response to the next request can follow directly. The parser then
+ *          starts over with the command ID.
+ *
+ * @param[in] p_ancs Pointer to an ANCS instance to which the event belongs.
+ *
+ * @return The next parse state.
+ */
+static ble_ancs_c_parse_state_t rsp_done(ble_ancs_c_t * p_ancs)
+{
+#if NRF_MODULE_ENABLED(BLE_ANCS_C_PIPELINE)
+    if (p_ancs->rsp_pending > 0)
+    {
+        p_ancs->rsp_pending--;
+    }
+    if (p_ancs->rsp_pending > 0)
+    {
+        return COMMAND_ID;
+    }
+#endif
+    return DONE;
+}
+
 static bool attr_is_requested(ble_ancs_c_t * p_ancs, ble_ancs_c_attr_t attr)
 {
     if(p_ancs->parse_info.p_attr_list[attr.attr_id].get == true)
@@ -71,15 +119,22 @@ static ble_ancs_c_parse_state_t command_id_parse(ble_ancs_c_t  * p_ancs,
             p_ancs->evt.evt_type = BLE_ANCS_C_EVT_APP_ATTRIBUTE;
             p_ancs->parse_info.p_attr_list  = p_ancs->ancs_app_attr_list;
             p_ancs->parse_info.nb_of_attr   = BLE_ANCS_NB_OF_APP_ATTR;
+            p_ancs->parse_info.current_app_id_index = 0;
             parse_state                     = APP_ID;
             break;
 
         default:
             //no valid command_id, abort the rest of the parsing procedure.
             NRF_LOG_DEBUG("[ANCS]: Invalid Command ID");
-            parse_state = DONE;
-            break;
+            return DONE;
     }
+
+#if NRF_MODULE_ENABLED(BLE_ANCS_C_PIPELINE)
+    // Requests of both types can be outstanding, so the count stored when the request was made
+    // might belong to another response.
+    p_ancs->parse_info.expected_number_of_attrs = attr_requested_count(p_ancs->parse_info.p_attr_list,
+                                                                       p_ancs->parse_info.nb_of_attr);
+#endif
     return parse_state;
 }
 
@@ -101,7 +156,11 @@ static ble_ancs_c_parse_state_t app_id_parse(ble_ancs_c_t  * p_ancs,
 
     if(p_ancs->evt.app_id[p_ancs->parse_info.current_app_id_index] != '\0')
     { 
-        p_ancs->parse_info.current_app_id_index++;
+        // Keep the last byte for the NUL termination. Longer identifiers are truncated.
+        if (p_ancs->parse_info.current_app_id_index < (BLE_ANCS_ATTR_DATA_MAX - 1))
+        {
+            p_ancs->parse_info.current_app_id_index++;
+        }
         return APP_ID;
     }
     else
@@ -127,17 +186,17 @@ static ble_ancs_c_parse_state_t attr_id_parse(ble_ancs_c_t  * p_ancs,
                                               uint32_t      * index)
 {
         p_ancs->evt.attr.attr_id     = p_data_src[(*index)++];
-        p_ancs->evt.attr.p_attr_data = p_ancs->parse_info.p_attr_list[p_ancs->evt.attr.attr_id].p_attr_data;
 
-        if(p_ancs->evt.attr.attr_id > p_ancs->parse_info.nb_of_attr)
+        if(p_ancs->evt.attr.attr_id >= p_ancs->parse_info.nb_of_attr)
         {
             return DONE;
         }
+        p_ancs->evt.attr.p_attr_data = p_ancs->parse_info.p_attr_list[p_ancs->evt.attr.attr_id].p_attr_data;
         
         if (all_req_attrs_parsed(p_ancs))
         {
             NRF_LOG_DEBUG("[ANCS]: All requested attributes received\n\r");
-            return DONE;
+            return rsp_done(p_ancs);
         }
         else
         {
@@ -201,7 +260,7 @@ static ble_ancs_c_parse_state_t attr_len2_parse(ble_ancs_c_t * p_ancs, const uin
         }
         if(all_req_attrs_parsed(p_ancs))
         {
-            return DONE;
+            return rsp_done(p_ancs);
         }
         else
         {
@@ -210,118 +269,100 @@ static ble_ancs_c_parse_state_t attr_len2_parse(ble_ancs_c_t * p_ancs, const uin
     }
 }
 
-/*
-static ble_ancs_c_parse_state_t skip_data
-    if (!attr_is_requested(p_ancs, p_ancs->evt.attr))
-    {
-        // Since this attribute is not in the list of requested attrtibutes,
-        // We can not risk writing to the attributes memory location.
-        if (p_ancs->current_attr_index < p_ancs->evt.attr.attr_len)
-        {
-            p_ancs->current_attr_index++;
-            (*index)++;
-        }
-    }
-*/
-
-static void attr_terminate(ble_ancs_c_t * p_ancs, const uint8_t * p_data_src, uint32_t * index)
+#if NRF_MODULE_ENABLED(BLE_ANCS_C_ATTR_STREAM)
+/**@brief Function for passing a fragment of the current attribute to the application.
+ *
+ * @param[in] p_ancs Pointer to an ANCS instance to which the event belongs.
+ * @param[in] p_data Fragment data, in the received GATTC notification.
+ * @param[in] offset Offset of the fragment in the attribute data.
+ * @param[in] len    Length of the fragment.
+ */
+static void attr_frag_evt_send(ble_ancs_c_t  * p_ancs,
+                               const uint8_t * p_data,
+                               uint16_t        offset,
+                               uint16_t        len)
 {
-    if (p_ancs->parse_info.current_attr_index == p_ancs->evt.attr.attr_len)
-    {
-        p_ancs->evt.attr.p_attr_data[p_ancs->parse_info.current_attr_index] = '\0';
-    }
-//    if (p_ancs->current_attr_index == p_ancs->p_attr_list[p_ancs->evt.attr.attr_id].attr_len)
-    else
-    {
-        p_ancs->evt.attr.p_attr_data[p_ancs->parse_info.current_attr_index - 1] = '\0';
-    }
+    ble_ancs_c_evt_type_t evt_type = p_ancs->evt.evt_type;
+
+    p_ancs->evt.attr_frag.attr_id  = p_ancs->evt.attr.attr_id;
+    p_ancs->evt.attr_frag.attr_len = p_ancs->evt.attr.attr_len;
+    p_ancs->evt.attr_frag.offset   = offset;
+    p_ancs->evt.attr_frag.len      = len;
+    p_ancs->evt.attr_frag.p_data   = p_data;
+
+    p_ancs->evt.evt_type = (evt_type == BLE_ANCS_C_EVT_NOTIF_ATTRIBUTE) ?
+                           BLE_ANCS_C_EVT_NOTIF_ATTRIBUTE_FRAGMENT :
+                           BLE_ANCS_C_EVT_APP_ATTRIBUTE_FRAGMENT;
+    p_ancs->evt_handler(&p_ancs->evt);
+
+    // The event is reused for the complete attribute.
+    p_ancs->evt.evt_type = evt_type;
 }
+#endif // NRF_MODULE_ENABLED(BLE_ANCS_C_ATTR_STREAM)
 
 /**@brief Function for parsing the data of an iOS attribute.
  *        Used in the @ref parse_get_notif_attrs_response state machine.
  *
- * @details Read the data of the attribute into our local buffer.
+ * @details All data of the attribute that is in the current GATTC notification is handled at once.
+ *          The data is copied into the buffer of the attribute, as much as fits. Data that does
+ *          not fit in the buffer, and the data of attributes that were not requested, is skipped.
+ *          With @ref BLE_ANCS_C_ATTR_STREAM_ENABLED, the data is also passed to the application
+ *          in a fragment event.
  *
- * @param[in] p_ancs     Pointer to an ANCS instance to which the event belongs.
- * @param[in] p_data_src Pointer to data that was received from the Notification Provider.
- * @param[in] index      Pointer to an index that helps us keep track of the current data to be parsed.
+ * @param[in] p_ancs       Pointer to an ANCS instance to which the event belongs.
+ * @param[in] p_data_src   Pointer to data that was received from the Notification Provider.
+ * @param[in] index        Pointer to an index that helps us keep track of the current data to be parsed.
+ * @param[in] hvx_data_len Length of the data that was received from the Notification Provider.
  *
  * @return The next parse state.
  */
 static ble_ancs_c_parse_state_t attr_data_parse(ble_ancs_c_t  * p_ancs,
                                                 const uint8_t * p_data_src,
-                                                uint32_t      * index)
+                                                uint32_t      * index,
+                                                uint16_t        hvx_data_len)
 {
+    ble_ancs_c_attr_list_t * p_attr    = &p_ancs->parse_info.p_attr_list[p_ancs->evt.attr.attr_id];
+    bool                     requested = attr_is_requested(p_ancs, p_ancs->evt.attr);
+    uint16_t                 offset    = p_ancs->parse_info.current_attr_index;
+    uint16_t                 len       = MIN(p_ancs->evt.attr.attr_len - offset,
+                                             hvx_data_len - *index);
 
-    // We have not reached the end of the attribute, nor our max allocated internal size.
-    // Proceed with copying data over to our buffer.
-    if (   (p_ancs->parse_info.current_attr_index < p_ancs->parse_info.p_attr_list[p_ancs->evt.attr.attr_id].attr_len)
-        && (p_ancs->parse_info.current_attr_index < p_ancs->evt.attr.attr_len))
+    if (requested)
     {
-        p_ancs->evt.attr.p_attr_data[p_ancs->parse_info.current_attr_index++] = p_data_src[(*index)++];
-    }
-
-    // We have reached the end of the attribute, or our max allocated internal size.
-    // Stop copying data over to our buffer. NUL-terminate at the current index.
-    if ( (p_ancs->parse_info.current_attr_index == p_ancs->evt.attr.attr_len) ||
-         (p_ancs->parse_info.current_attr_index == p_ancs->parse_info.p_attr_list[p_ancs->evt.attr.attr_id].attr_len))
-    {
-        if (attr_is_requested(p_ancs, p_ancs->evt.attr))
-        {
-            attr_terminate(p_ancs, p_data_src, index);
-        }
-
-        // If our max buffer size is smaller than the remaining attribute data, we must
-        // increase index to skip the data until the start of the next attribute.
-        if (p_ancs->parse_info.current_attr_index < p_ancs->evt.attr.attr_len)
+#if NRF_MODULE_ENABLED(BLE_ANCS_C_ATTR_STREAM)
+        attr_frag_evt_send(p_ancs, &p_data_src[*index], offset, len);
+#endif
+        if ((p_attr->p_attr_data != NULL) && (offset < p_attr->attr_len))
         {
-            return ATTR_SKIP;
-        }
-        NRF_LOG_DEBUG("[ANCS]: Attribute finished!\n\r");
-        if(attr_is_requested(p_ancs, p_ancs->evt.attr))
-        {
-            p_ancs->evt_handler(&p_ancs->evt);
-        }
-        if(all_req_attrs_parsed(p_ancs))
-        {
-            return DONE;
-        }
-        else
-        {
-            return ATTR_ID;
+            memcpy(&p_attr->p_attr_data[offset],
+                   &p_data_src[*index],
+                   MIN(len, p_attr->attr_len - offset));
         }
     }
-    return ATTR_DATA;
-}
 
+    *index                                += len;
+    p_ancs->parse_info.current_attr_index += len;
 
-static ble_ancs_c_parse_state_t attr_skip(ble_ancs_c_t * p_ancs, const uint8_t * p_data_src, uint32_t * index)
-{
-    // We have not reached the end of the attribute, nor our max allocated internal size.
-    // Proceed with copying data over to our buffer.
     if (p_ancs->parse_info.current_attr_index < p_ancs->evt.attr.attr_len)
     {
-        p_ancs->parse_info.current_attr_index++;
-        (*index)++;
+        return ATTR_DATA;
     }
-    // At the end of the attribute, determine if it should be passed to event handler and
-    // continue parsing the next attribute ID if we are not done with all the attributes.
-    if (p_ancs->parse_info.current_attr_index == p_ancs->evt.attr.attr_len)
+
+    NRF_LOG_DEBUG("[ANCS]: Attribute finished!\n\r");
+    if (requested)
     {
-        if(attr_is_requested(p_ancs, p_ancs->evt.attr))
-        {
-            p_ancs->evt_handler(&p_ancs->evt);
-        }
-        if(all_req_attrs_parsed(p_ancs))
-        {
-            return DONE;
-        }
-        else
+        // NUL-terminate after the data, or at the last byte of the buffer if the data was truncated.
+        if (p_attr->p_attr_data != NULL)
         {
-            return ATTR_ID;
+            p_attr->p_attr_data[MIN(p_ancs->evt.attr.attr_len, p_attr->attr_len - 1)] = '\0';
         }
+        p_ancs->evt_handler(&p_ancs->evt);
+    }
+    if (all_req_attrs_parsed(p_ancs))
+    {
+        return rsp_done(p_ancs);
     }
-    return ATTR_SKIP;
+    return ATTR_ID;
 }
 
 
@@ -331,6 +372,14 @@ void ancs_parse_get_attrs_response(ble_ancs_c_t  * p_ancs,
 {
     uint32_t index;
 
+#if NRF_MODULE_ENABLED(BLE_ANCS_C_PIPELINE)
+    // A new response starts with this GATTC notification.
+    if ((p_ancs->parse_info.parse_state == DONE) && (p_ancs->rsp_pending > 0))
+    {
+        p_ancs->parse_info.parse_state = COMMAND_ID;
+    }
+#endif
+
     for (index = 0; index < hvx_data_len;)
     {
         switch (p_ancs->parse_info.parse_state)
@@ -360,11 +409,7 @@ void ancs_parse_get_attrs_response(ble_ancs_c_t  * p_ancs,
                 break;
 
             case ATTR_DATA:
-                p_ancs->parse_info.parse_state = attr_data_parse(p_ancs, p_data_src, &index);
-                break;
-
-            case ATTR_SKIP:
-                p_ancs->parse_info.parse_state = attr_skip(p_ancs, p_data_src, &index);
+                p_ancs->parse_info.parse_state = attr_data_parse(p_ancs, p_data_src, &index, hvx_data_len);
                 break;
 
             case DONE:
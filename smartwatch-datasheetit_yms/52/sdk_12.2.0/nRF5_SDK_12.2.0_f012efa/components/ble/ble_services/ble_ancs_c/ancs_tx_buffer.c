@@ -83,3 +83,9 @@ void tx_buffer_process(void)
         }
     }
 }
+
+
+tx_message_t const * tx_buffer_last_sent_get(void)
+{
+    return &m_tx_buffer[(m_tx_index - 1) & TX_BUFFER_MASK];
+}
@@ -69,6 +69,15 @@ void tx_buffer_insert(tx_message_t * p_msg);
 */
 void tx_buffer_process(void);
 
+/**@brief Function for getting the message that was passed to the stack last.
+ *
+ * @details Only one message is passed to the stack at a time, so a write response belongs to
+ *          this message.
+ *
+ * @return Pointer to the message.
+ */
+tx_message_t const * tx_buffer_last_sent_get(void);
+
 /** @} */
 
 #endif // ANCS_TX_BUFFER_H__
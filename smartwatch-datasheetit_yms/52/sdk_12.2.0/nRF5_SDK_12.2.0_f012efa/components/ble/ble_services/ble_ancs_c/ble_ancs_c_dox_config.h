@@ -12,5 +12,35 @@
  */
 #define BLE_ANCS_C_ENABLED
 
+/** @brief Pass attribute data to the application as it is received.
+ *
+ *  The data of requested attributes is passed in @ref BLE_ANCS_C_EVT_NOTIF_ATTRIBUTE_FRAGMENT
+ *  and @ref BLE_ANCS_C_EVT_APP_ATTRIBUTE_FRAGMENT events, directly from the received GATTC
+ *  notifications. Attribute buffers become optional.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_ANCS_C_ATTR_STREAM_ENABLED
+
+/** @brief Send attribute requests while the response to the previous request is being received.
+ *
+ *  Requests made with @ref nrf_ble_ancs_c_request_attrs are queued. One request is sent ahead
+ *  of the response that is being received. The Notification Provider must send all requested
+ *  attributes in every response.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_ANCS_C_PIPELINE_ENABLED
+
+/** @brief Number of notification attribute requests that can be queued.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_ANCS_C_PIPELINE_QUEUE_SIZE
+
 
 /** @} */
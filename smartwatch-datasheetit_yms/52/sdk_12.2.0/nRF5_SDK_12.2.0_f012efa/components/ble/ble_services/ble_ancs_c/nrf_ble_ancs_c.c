@@ -36,6 +36,12 @@
 
 #define TIME_STRING_LEN                  15     /**< Unicode Technical Standard (UTS) #35 date format pattern "yyyyMMdd'T'HHmmSS" + "'\0'". */
 
+#define ANCS_PIPELINE_DEPTH              2      /**< Number of attribute requests that are sent before their responses have been received. One request is sent ahead of the response that is being received. */
+
+#if NRF_MODULE_ENABLED(BLE_ANCS_C_PIPELINE)
+static void pipeline_process(ble_ancs_c_t * p_ancs);
+#endif
+
 
 /**@brief 128-bit service UUID for the Apple Notification Center Service.
  */
@@ -98,6 +104,11 @@ static void on_disconnected(ble_ancs_c_t * p_ancs, const ble_evt_t * p_ble_evt)
     if (p_ancs->conn_handle == p_ble_evt->evt.gap_evt.conn_handle)
     {
         p_ancs->conn_handle = BLE_CONN_HANDLE_INVALID;
+#if NRF_MODULE_ENABLED(BLE_ANCS_C_PIPELINE)
+        p_ancs->req_queue_count        = 0;
+        p_ancs->rsp_pending            = 0;
+        p_ancs->parse_info.parse_state = DONE;
+#endif
     }
 }
 
@@ -266,6 +277,9 @@ static void on_evt_gattc_notif(ble_ancs_c_t * p_ancs, const ble_evt_t * p_ble_ev
     else if (p_notif->handle == p_ancs->service.data_source_char.handle_value)
     {
         ancs_parse_get_attrs_response(p_ancs, p_notif->data, p_notif->len);
+#if NRF_MODULE_ENABLED(BLE_ANCS_C_PIPELINE)
+        pipeline_process(p_ancs);
+#endif
     }
     else
     {
@@ -303,6 +317,20 @@ static void on_write_rsp(ble_ancs_c_t * p_ancs, const ble_evt_t * p_ble_evt)
     if ((p_ble_evt->evt.gattc_evt.error_handle != BLE_GATT_HANDLE_INVALID)
         && (p_ble_evt->evt.gattc_evt.error_handle == p_ancs->service.control_point_char.handle_value))
     {
+#if NRF_MODULE_ENABLED(BLE_ANCS_C_PIPELINE)
+        // No response follows a rejected attribute request. The response to a Get App Attributes
+        // request is rejected on the execute write.
+        tx_message_t const * p_msg = tx_buffer_last_sent_get();
+
+        if (   (p_ancs->rsp_pending > 0)
+            && (   (p_msg->req.write_req.gattc_params.write_op == BLE_GATT_OP_EXEC_WRITE_REQ)
+                || (   (p_msg->req.write_req.gattc_params.write_op == BLE_GATT_OP_WRITE_REQ)
+                    && (p_msg->req.write_req.gattc_value[0] == BLE_ANCS_COMMAND_ID_GET_NOTIF_ATTRIBUTES))))
+        {
+            p_ancs->rsp_pending--;
+            pipeline_process(p_ancs);
+        }
+#endif
          on_ctrlpt_error_rsp(p_ancs,p_ble_evt);
     }
     // Check if there is any message to be sent across to the peer and send it.
@@ -346,6 +374,12 @@ ret_code_t ble_ancs_c_init(ble_ancs_c_t * p_ancs, const ble_ancs_c_init_t * p_an
     p_ancs->parse_info.p_data_dest = NULL;
     p_ancs->parse_info.current_attr_index   = 0;
     p_ancs->parse_info.current_app_id_index = 0;
+#if NRF_MODULE_ENABLED(BLE_ANCS_C_PIPELINE)
+    p_ancs->parse_info.parse_state = DONE;
+    p_ancs->req_queue_start        = 0;
+    p_ancs->req_queue_count        = 0;
+    p_ancs->rsp_pending            = 0;
+#endif
 
     p_ancs->evt_handler    = p_ancs_init->evt_handler;
     p_ancs->error_handler  = p_ancs_init->error_handler;
@@ -480,7 +514,10 @@ uint32_t ble_ancs_get_notif_attrs(ble_ancs_c_t * p_ancs,
     p_msg.req.write_req.gattc_params.len        = index;
     p_msg.conn_handle                           = p_ancs->conn_handle;
     p_msg.type                                  = WRITE_REQ;
+#if !NRF_MODULE_ENABLED(BLE_ANCS_C_PIPELINE)
+    // With pipelining, the count is set when the response starts, see command_id_parse in ancs_attr_parser.c.
     p_ancs->parse_info.expected_number_of_attrs = p_ancs->number_of_requested_attr;
+#endif
 
     tx_buffer_insert(&p_msg);
     tx_buffer_process();
@@ -494,12 +531,20 @@ ret_code_t nrf_ble_ancs_c_attr_add(ble_ancs_c_t                       * p_ancs,
                                    uint8_t                            * p_data,
                                    const uint16_t                       len)
 {
+#if NRF_MODULE_ENABLED(BLE_ANCS_C_ATTR_STREAM)
+    // Without a buffer, the data is only passed in fragment events and the length is not limited.
+    if((len == 0) || ((p_data != NULL) && (len > BLE_ANCS_ATTR_DATA_MAX)))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+#else
     VERIFY_PARAM_NOT_NULL(p_data);
 
     if((len == 0) || (len > BLE_ANCS_ATTR_DATA_MAX))
     {
         return NRF_ERROR_INVALID_LENGTH;
     }
+#endif
 
     p_ancs->ancs_notif_attr_list[id].get         = true;
     p_ancs->ancs_notif_attr_list[id].attr_len    = len;
@@ -515,12 +560,20 @@ ret_code_t nrf_ble_ancs_c_app_attr_add(ble_ancs_c_t                     * p_ancs
                                        const uint16_t                     len)
 {
     VERIFY_PARAM_NOT_NULL(p_ancs);
+#if NRF_MODULE_ENABLED(BLE_ANCS_C_ATTR_STREAM)
+    // Without a buffer, the data is only passed in fragment events and the length is not limited.
+    if((len == 0) || ((p_data != NULL) && (len > BLE_ANCS_ATTR_DATA_MAX)))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+#else
     VERIFY_PARAM_NOT_NULL(p_data);
 
     if((len == 0) || (len > BLE_ANCS_ATTR_DATA_MAX))
     {
         return NRF_ERROR_INVALID_LENGTH;
     }
+#endif
 
     p_ancs->ancs_app_attr_list[id].get         = true;
     p_ancs->ancs_app_attr_list[id].attr_len    = len;
@@ -562,13 +615,49 @@ ret_code_t nrf_ble_ancs_c_request_attrs(ble_ancs_c_t * p_ancs,
     err_code = ble_ancs_verify_notification_format(p_notif);
     VERIFY_SUCCESS(err_code);
 
+#if NRF_MODULE_ENABLED(BLE_ANCS_C_PIPELINE)
+    if (p_ancs->req_queue_count == BLE_ANCS_C_PIPELINE_QUEUE_SIZE)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    p_ancs->req_queue[(p_ancs->req_queue_start + p_ancs->req_queue_count)
+                      % BLE_ANCS_C_PIPELINE_QUEUE_SIZE] = p_notif->notif_uid;
+    p_ancs->req_queue_count++;
+
+    pipeline_process(p_ancs);
+#else
     err_code                       = ble_ancs_get_notif_attrs(p_ancs, p_notif->notif_uid);
     p_ancs->parse_info.parse_state = COMMAND_ID;
     VERIFY_SUCCESS(err_code);
+#endif
 
     return NRF_SUCCESS;
 }
 
+#if NRF_MODULE_ENABLED(BLE_ANCS_C_PIPELINE)
+/**@brief Function for sending queued attribute requests.
+ *
+ * @details Requests are sent until @ref ANCS_PIPELINE_DEPTH responses are outstanding. The parser
+ *          reduces the number of outstanding responses when a response has been received.
+ *
+ * @param[in] p_ancs Pointer to the ANCS client structure.
+ */
+static void pipeline_process(ble_ancs_c_t * p_ancs)
+{
+    while ((p_ancs->req_queue_count > 0) && (p_ancs->rsp_pending < ANCS_PIPELINE_DEPTH))
+    {
+        uint32_t uid = p_ancs->req_queue[p_ancs->req_queue_start];
+
+        p_ancs->req_queue_start = (p_ancs->req_queue_start + 1) % BLE_ANCS_C_PIPELINE_QUEUE_SIZE;
+        p_ancs->req_queue_count--;
+        p_ancs->rsp_pending++;
+
+        (void)ble_ancs_get_notif_attrs(p_ancs, uid);
+    }
+}
+#endif // NRF_MODULE_ENABLED(BLE_ANCS_C_PIPELINE)
+
 static uint16_t encode_notif_action(uint8_t * p_encoded_data, uint32_t uid, ble_ancs_c_action_id_values_t action_id)
 {
     uint8_t index = 0;
@@ -52,6 +52,15 @@
  * @ref nrf_ancs_perform_notif_action can be used to make the Notification Provider perform an
  * action based on the provided notification.
  *
+ * With @ref BLE_ANCS_C_ATTR_STREAM_ENABLED, the data of requested attributes is also passed to the
+ * application as it arrives, in @ref BLE_ANCS_C_EVT_NOTIF_ATTRIBUTE_FRAGMENT and
+ * @ref BLE_ANCS_C_EVT_APP_ATTRIBUTE_FRAGMENT events. The fragments point into the received GATTC
+ * notification, so attributes of any length can be received without an attribute buffer.
+ *
+ * With @ref BLE_ANCS_C_PIPELINE_ENABLED, @ref nrf_ble_ancs_c_request_attrs can be called again
+ * before all attributes of the previous request have been received. The requests are queued, and
+ * the next one is sent while the response to the current one is still arriving.
+ *
  * @msc
  * hscale = "1.5";
  * Application, ANCS_C;
@@ -95,6 +104,10 @@ extern "C" {
 #define BLE_ANCS_NB_OF_APP_ATTR             1   //!< Number of iOS application attributes: DisplayName.
 #define BLE_ANCS_NB_OF_EVT_ID               3   //!< Number of iOS notification events: Added, Modified, Removed.
 
+#ifndef BLE_ANCS_C_PIPELINE_QUEUE_SIZE
+#define BLE_ANCS_C_PIPELINE_QUEUE_SIZE      8   //!< Number of notification attribute requests that can be queued when @ref BLE_ANCS_C_PIPELINE_ENABLED is set.
+#endif
+
 /** @brief Length of the iOS notification data.
  *
  * @details 8 bytes:
@@ -133,6 +146,8 @@ typedef enum
     BLE_ANCS_C_EVT_NOTIF_ATTRIBUTE,            /**< A received iOS notification attribute has been parsed. */
     BLE_ANCS_C_EVT_APP_ATTRIBUTE,              /**< An iOS app attribute has been parsed. */
     BLE_ANCS_C_EVT_NP_ERROR,                   /**< An error has been sent on the ANCS Control Point from the iOS Notification Provider. */
+    BLE_ANCS_C_EVT_NOTIF_ATTRIBUTE_FRAGMENT,   /**< Data of a requested iOS notification attribute has been received. Only used with @ref BLE_ANCS_C_ATTR_STREAM_ENABLED. */
+    BLE_ANCS_C_EVT_APP_ATTRIBUTE_FRAGMENT,     /**< Data of a requested app attribute has been received. Only used with @ref BLE_ANCS_C_ATTR_STREAM_ENABLED. */
 } ble_ancs_c_evt_type_t;
 
 /**@brief Category IDs for iOS notifications. */
@@ -244,6 +259,16 @@ typedef struct
     uint8_t                         * p_attr_data;  //!< Pointer to where the memory is allocated for storing incoming attributes.
 } ble_ancs_c_attr_t;
 
+/**@brief Fragment of an iOS attribute. This type is used for both notification attributes and app attributes. */
+typedef struct
+{
+    uint32_t                          attr_id;      //!< Classification of the attribute type, for example, title or date.
+    uint16_t                          attr_len;     //!< Total length of the attribute data sent by the Notification Provider.
+    uint16_t                          offset;       //!< Offset of the fragment in the attribute data.
+    uint16_t                          len;          //!< Length of the fragment.
+    uint8_t const                   * p_data;       //!< Fragment data. Points into the received GATTC notification and is only valid in the event handler.
+} ble_ancs_c_attr_frag_t;
+
 /**@brief iOS notification attribute structure for incoming attributes. */
 typedef struct
 {
@@ -293,6 +318,7 @@ typedef struct
     ble_ancs_c_evt_notif_t notif;                          //!< iOS notification. This field will be filled if @p evt_type is @ref BLE_ANCS_C_EVT_NOTIF.
     uint16_t               err_code_np;                    //!< An error coming from the Notification Provider. This field will be filled with @ref BLE_ANCS_NP_ERROR_CODES if @p evt_type is @ref BLE_ANCS_C_EVT_NP_ERROR.
     ble_ancs_c_attr_t      attr;                           //!< iOS notification attribute or app attribute, depending on the event type. 
+    ble_ancs_c_attr_frag_t attr_frag;                      //!< Attribute fragment. This field will be filled if @p evt_type is @ref BLE_ANCS_C_EVT_NOTIF_ATTRIBUTE_FRAGMENT or @ref BLE_ANCS_C_EVT_APP_ATTRIBUTE_FRAGMENT.
     uint32_t               notif_uid;                      //!< Notification UID.
     uint8_t                app_id[BLE_ANCS_ATTR_DATA_MAX]; //!< App identifier.
     ble_ancs_c_service_t   service;                        //!< Information on the discovered Alert Notification Service. This field will be filled if the @p evt_type is @ref BLE_ANCS_C_EVT_DISCOVERY_COMPLETE.
@@ -328,6 +354,10 @@ typedef struct
     uint32_t                 number_of_requested_attr;                        //!< The number of attributes that will be requested when an iOS notification attribute request is made.
     ble_ancs_parse_sm_t      parse_info;                                      //!< Structure containing different information used to parse incoming attributes (from data_source characteristic) correctly.
     ble_ancs_c_evt_t         evt;                                             //!< The event is filled with several iterations of the @ref ancs_parse_get_attrs_response function when requesting iOS notification attributes. So we must allocate memory for it here.
+    uint32_t                 req_queue[BLE_ANCS_C_PIPELINE_QUEUE_SIZE];       //!< UIDs of the iOS notifications whose attributes have not been requested yet. Only used with @ref BLE_ANCS_C_PIPELINE_ENABLED.
+    uint8_t                  req_queue_start;                                 //!< Index of the oldest UID in @ref ble_ancs_c_t::req_queue.
+    uint8_t                  req_queue_count;                                 //!< Number of UIDs in @ref ble_ancs_c_t::req_queue.
+    uint8_t                  rsp_pending;                                     //!< Number of attribute requests that have been sent and whose response has not been completely received.
 } ble_ancs_c_t;
 
 
@@ -430,6 +460,9 @@ ret_code_t ble_ancs_c_data_source_notif_disable(const ble_ancs_c_t * p_ancs);
  * @param[in] p_ancs ANCS client instance on which the attribute will be registered.
  * @param[in] id     ID of the attribute that will be added.
  * @param[in] p_data Pointer to a buffer where the data of the attribute can be stored.
+ *                   With @ref BLE_ANCS_C_ATTR_STREAM_ENABLED, this can be NULL. The data is
+ *                   then only passed in @ref BLE_ANCS_C_EVT_NOTIF_ATTRIBUTE_FRAGMENT events,
+ *                   and @p len is the maximum length requested from the Notification Provider.
  * @param[in] len    Length of the buffer where the data of the attribute can be stored.
   
  * @retval NRF_SUCCESS If all operations were successful. Otherwise, an error code is returned.
@@ -469,6 +502,8 @@ ret_code_t nrf_ble_ancs_c_app_attr_remove(ble_ancs_c_t                     * p_a
  * @param[in] p_ancs ANCS client instance on which the attribute will be registered.
  * @param[in] id     ID of the attribute that will be added.
  * @param[in] p_data Pointer to a buffer where the data of the attribute can be stored.
+ *                   With @ref BLE_ANCS_C_ATTR_STREAM_ENABLED, this can be NULL. The data is
+ *                   then only passed in @ref BLE_ANCS_C_EVT_APP_ATTRIBUTE_FRAGMENT events.
  * @param[in] len    Length of the buffer where the data of the attribute can be stored.
  *
  * @retval NRF_SUCCESS If all operations were successful. Otherwise, an error code is returned.
@@ -493,7 +528,8 @@ ret_code_t nrf_ble_ancs_c_attr_req_clear_all(ble_ancs_c_t * p_ancs);
  * @param[in] p_notif  Pointer to the notification whose attributes will be requested from
  *                     the Notification Provider.
  *
- * @retval NRF_SUCCESS If all operations were successful. Otherwise, an error code is returned.
+ * @retval NRF_SUCCESS      If all operations were successful. Otherwise, an error code is returned.
+ * @retval NRF_ERROR_NO_MEM If @ref BLE_ANCS_C_PIPELINE_ENABLED is set and the request queue is full.
  */
 ret_code_t nrf_ble_ancs_c_request_attrs(ble_ancs_c_t                 * p_ancs,
                                         const ble_ancs_c_evt_notif_t * p_notif);
@@ -0,0 +1,397 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(BLE_BAS_MONITOR)
+#include "ble_bas_monitor.h"
+#include "nrf_drv_saadc.h"
+#include "app_timer.h"
+#include "app_util_platform.h"
+#if BLE_BAS_MONITOR_CONFIG_RADIO_SYNC
+#include "ble_hvx_coalesce.h"
+#endif
+
+#define MONITOR_CHANNEL       0                      /**< SAADC channel used for the measurements. */
+#define MONITOR_FULL_SCALE_MV 3600                   /**< Full scale with gain 1/6 and the internal 0.6 V reference. */
+#define MONITOR_RESOLUTION    NRF_SAADC_RESOLUTION_12BIT
+#define MONITOR_RESULT_BITS   12
+#define INVALID_LEVEL         0xFF
+
+/**@brief Acquisition time of the configuration in microseconds. */
+#define MONITOR_ACQTIME_US                                                 \
+    ((BLE_BAS_MONITOR_CONFIG_ACQTIME == NRF_SAADC_ACQTIME_3US)  ? 3  :    \
+     (BLE_BAS_MONITOR_CONFIG_ACQTIME == NRF_SAADC_ACQTIME_5US)  ? 5  :    \
+     (BLE_BAS_MONITOR_CONFIG_ACQTIME == NRF_SAADC_ACQTIME_10US) ? 10 :    \
+     (BLE_BAS_MONITOR_CONFIG_ACQTIME == NRF_SAADC_ACQTIME_15US) ? 15 :    \
+     (BLE_BAS_MONITOR_CONFIG_ACQTIME == NRF_SAADC_ACQTIME_20US) ? 20 : 40)
+
+/**@brief Duration of a measurement in microseconds: every sample takes the acquisition time and 2 us of conversion. */
+#define MONITOR_CONVERSION_US \
+    ((1UL << BLE_BAS_MONITOR_CONFIG_OVERSAMPLE) * (MONITOR_ACQTIME_US + 2))
+
+#if BLE_BAS_MONITOR_CONFIG_RADIO_SYNC
+// The conversion must be done before the radio event that follows the notification.
+STATIC_ASSERT(MONITOR_CONVERSION_US <= BLE_BAS_MONITOR_CONFIG_WINDOW_US);
+#endif
+
+typedef enum
+{
+    MONITOR_STATE_IDLE,       /**< Waiting for the next measurement. */
+    MONITOR_STATE_WAIT_RADIO, /**< Waiting for the radio notification before a conversion. */
+    MONITOR_STATE_BUSY,       /**< SAADC calibration or conversion in progress. */
+} monitor_state_t;
+
+/**@brief Discharge curve of a Li-ion cell at low load. */
+static const ble_bas_monitor_curve_point_t m_default_curve[] =
+{
+    {4200, 100},
+    {4100, 90},
+    {4000, 78},
+    {3900, 66},
+    {3800, 52},
+    {3750, 40},
+    {3700, 28},
+    {3650, 18},
+    {3600, 10},
+    {3500, 5},
+    {3400, 2},
+    {3300, 0},
+};
+
+static struct
+{
+    ble_bas_monitor_config_t config;
+    volatile monitor_state_t state;
+    uint16_t                 conversions;    /**< Conversions since the last offset calibration. */
+    uint32_t                 filtered;       /**< Filtered voltage in mV, multiplied by 2^BLE_BAS_MONITOR_CONFIG_IIR_SHIFT. */
+    bool                     filter_valid;
+    uint16_t                 reported_mv;    /**< Filtered voltage when the level was last reported. */
+    uint8_t                  reported_level;
+    nrf_saadc_value_t        result;
+#if BLE_BAS_MONITOR_CONFIG_RADIO_SYNC
+    ble_hvx_coalesce_t       hvx;
+#endif
+} m_cb;
+
+APP_TIMER_DEF(m_monitor_timer);
+
+
+static void error_report(ret_code_t err_code)
+{
+    if ((err_code != NRF_SUCCESS) && (m_cb.config.error_handler != NULL))
+    {
+        m_cb.config.error_handler(err_code);
+    }
+}
+
+
+static bool state_change(monitor_state_t from, monitor_state_t to)
+{
+    bool changed = false;
+
+    CRITICAL_REGION_ENTER();
+    if (m_cb.state == from)
+    {
+        m_cb.state = to;
+        changed    = true;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return changed;
+}
+
+
+static void timer_start(uint32_t ticks)
+{
+    // The measurements do not need exact times, so the timer can share its wakeup with others.
+    uint32_t slack = MIN(ticks / 16, APP_TIMER_MAX_SLACK_TICKS);
+
+    error_report(app_timer_start_with_slack(m_monitor_timer, ticks, slack, NULL));
+}
+
+
+/**@brief Function for starting the offset calibration if it is due, otherwise a conversion. Called in the BUSY state. */
+static void conversion_start(void)
+{
+    ret_code_t err_code;
+
+    if (m_cb.conversions >= BLE_BAS_MONITOR_CONFIG_CALIBRATION_INTERVAL)
+    {
+        err_code = nrf_drv_saadc_calibrate_offset();
+    }
+    else
+    {
+        // Burst mode: one sample task makes all the oversampled conversions.
+        err_code = nrf_drv_saadc_buffer_convert(&m_cb.result, 1);
+        if (err_code == NRF_SUCCESS)
+        {
+            err_code = nrf_drv_saadc_sample();
+        }
+    }
+
+    if (err_code != NRF_SUCCESS)
+    {
+        error_report(err_code);
+        m_cb.state = MONITOR_STATE_IDLE;
+        timer_start(m_cb.config.period_ticks);
+    }
+}
+
+
+/**@brief Function for starting a measurement, before the next radio event if it is synchronized. */
+static bool measurement_request(void)
+{
+#if BLE_BAS_MONITOR_CONFIG_RADIO_SYNC
+    if (!state_change(MONITOR_STATE_IDLE, MONITOR_STATE_WAIT_RADIO))
+    {
+        return false;
+    }
+    // Started before the request, so that the flush handler can stop it.
+    timer_start(m_cb.config.radio_wait_ticks);
+    ble_hvx_coalesce_request(&m_cb.hvx);
+#else
+    if (!state_change(MONITOR_STATE_IDLE, MONITOR_STATE_BUSY))
+    {
+        return false;
+    }
+    conversion_start();
+#endif
+    return true;
+}
+
+
+static void monitor_timeout_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    if (m_cb.state == MONITOR_STATE_IDLE)
+    {
+        (void)measurement_request();
+    }
+    else if (state_change(MONITOR_STATE_WAIT_RADIO, MONITOR_STATE_BUSY))
+    {
+        // No radio event in the wait time, so the radio is idle.
+        conversion_start();
+    }
+}
+
+
+#if BLE_BAS_MONITOR_CONFIG_RADIO_SYNC
+static void radio_flush_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    if (state_change(MONITOR_STATE_WAIT_RADIO, MONITOR_STATE_BUSY))
+    {
+        error_report(app_timer_stop(m_monitor_timer));
+        conversion_start();
+    }
+}
+#endif
+
+
+static uint8_t level_get(uint16_t voltage_mv)
+{
+    ble_bas_monitor_curve_point_t const * p_curve = m_cb.config.p_curve;
+
+    if (voltage_mv >= p_curve[0].voltage_mv)
+    {
+        return p_curve[0].level;
+    }
+
+    for (uint32_t i = 1; i < m_cb.config.curve_points; i++)
+    {
+        if (voltage_mv >= p_curve[i].voltage_mv)
+        {
+            uint32_t span  = p_curve[i - 1].voltage_mv - p_curve[i].voltage_mv;
+            int32_t  delta = (int32_t)p_curve[i - 1].level - p_curve[i].level;
+
+            return (uint8_t)(p_curve[i].level +
+                             (int32_t)(voltage_mv - p_curve[i].voltage_mv) * delta / (int32_t)span);
+        }
+    }
+
+    return p_curve[m_cb.config.curve_points - 1].level;
+}
+
+
+static void measurement_process(nrf_saadc_value_t result)
+{
+    ble_bas_monitor_evt_t evt;
+    uint32_t              input_mv;
+    uint32_t              voltage_mv;
+
+    input_mv   = ((uint32_t)MAX(result, 0) * MONITOR_FULL_SCALE_MV) >> MONITOR_RESULT_BITS;
+    voltage_mv = input_mv * m_cb.config.divider_ratio / 1000;
+
+    if (m_cb.filter_valid)
+    {
+        m_cb.filtered += voltage_mv - (m_cb.filtered >> BLE_BAS_MONITOR_CONFIG_IIR_SHIFT);
+    }
+    else
+    {
+        m_cb.filtered     = voltage_mv << BLE_BAS_MONITOR_CONFIG_IIR_SHIFT;
+        m_cb.filter_valid = true;
+    }
+
+    evt.voltage_mv = (uint16_t)(m_cb.filtered >> BLE_BAS_MONITOR_CONFIG_IIR_SHIFT);
+    evt.level      = level_get(evt.voltage_mv);
+    evt.reported   = false;
+
+    // A level is reported only after the voltage has moved enough, so that it does not toggle
+    // between two values at a point of the curve.
+    if ((evt.level != m_cb.reported_level) &&
+        ((m_cb.reported_level == INVALID_LEVEL) ||
+         (evt.voltage_mv >= m_cb.reported_mv + BLE_BAS_MONITOR_CONFIG_HYSTERESIS_MV) ||
+         (evt.voltage_mv + BLE_BAS_MONITOR_CONFIG_HYSTERESIS_MV <= m_cb.reported_mv)))
+    {
+        ret_code_t err_code = NRF_SUCCESS;
+
+        if (m_cb.config.p_bas != NULL)
+        {
+            err_code = ble_bas_battery_level_update(m_cb.config.p_bas, evt.level);
+        }
+
+        // The other errors are about the notification: the value has been stored.
+        if ((err_code == NRF_SUCCESS) ||
+            (err_code == NRF_ERROR_INVALID_STATE) ||
+            (err_code == BLE_ERROR_NO_TX_PACKETS) ||
+            (err_code == BLE_ERROR_GATTS_SYS_ATTR_MISSING))
+        {
+            m_cb.reported_level = evt.level;
+            m_cb.reported_mv    = evt.voltage_mv;
+            evt.reported        = true;
+        }
+        else
+        {
+            error_report(err_code);
+        }
+    }
+
+    if (m_cb.config.evt_handler != NULL)
+    {
+        m_cb.config.evt_handler(&evt);
+    }
+}
+
+
+static void saadc_event_handler(nrf_drv_saadc_evt_t const * p_event)
+{
+    if (p_event->type == NRF_DRV_SAADC_EVT_CALIBRATEDONE)
+    {
+        m_cb.conversions = 0;
+        m_cb.state       = MONITOR_STATE_IDLE;
+        (void)measurement_request();
+    }
+    else if (p_event->type == NRF_DRV_SAADC_EVT_DONE)
+    {
+        m_cb.conversions++;
+        measurement_process(p_event->data.done.p_buffer[0]);
+        m_cb.state = MONITOR_STATE_IDLE;
+        timer_start(m_cb.config.period_ticks);
+    }
+}
+
+
+ret_code_t ble_bas_monitor_init(ble_bas_monitor_config_t const * p_config)
+{
+    ret_code_t err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_config);
+
+    if ((p_config->divider_ratio == 0) || (p_config->period_ticks == 0))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+#if BLE_BAS_MONITOR_CONFIG_RADIO_SYNC
+    if (p_config->radio_wait_ticks == 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+#endif
+
+    m_cb.config = *p_config;
+    if (m_cb.config.p_curve == NULL)
+    {
+        m_cb.config.p_curve      = m_default_curve;
+        m_cb.config.curve_points = ARRAY_SIZE(m_default_curve);
+    }
+    else
+    {
+        if (m_cb.config.curve_points == 0)
+        {
+            return NRF_ERROR_INVALID_PARAM;
+        }
+        for (uint32_t i = 1; i < m_cb.config.curve_points; i++)
+        {
+            if (m_cb.config.p_curve[i].voltage_mv >= m_cb.config.p_curve[i - 1].voltage_mv)
+            {
+                return NRF_ERROR_INVALID_PARAM;
+            }
+        }
+    }
+
+    nrf_drv_saadc_config_t saadc_config = NRF_DRV_SAADC_DEFAULT_CONFIG;
+    saadc_config.resolution     = MONITOR_RESOLUTION;
+    saadc_config.oversample     = BLE_BAS_MONITOR_CONFIG_OVERSAMPLE;
+    saadc_config.low_power_mode = true;
+
+    err_code = nrf_drv_saadc_init(&saadc_config, saadc_event_handler);
+    VERIFY_SUCCESS(err_code);
+
+    nrf_saadc_channel_config_t channel_config =
+        NRF_DRV_SAADC_DEFAULT_CHANNEL_CONFIG_SE(p_config->input);
+    channel_config.acq_time = BLE_BAS_MONITOR_CONFIG_ACQTIME;
+    channel_config.burst    = (BLE_BAS_MONITOR_CONFIG_OVERSAMPLE == NRF_SAADC_OVERSAMPLE_DISABLED) ?
+                              NRF_SAADC_BURST_DISABLED : NRF_SAADC_BURST_ENABLED;
+
+    err_code = nrf_drv_saadc_channel_init(MONITOR_CHANNEL, &channel_config);
+    VERIFY_SUCCESS(err_code);
+
+    err_code = app_timer_create(&m_monitor_timer, APP_TIMER_MODE_SINGLE_SHOT,
+                                monitor_timeout_handler);
+    VERIFY_SUCCESS(err_code);
+
+#if BLE_BAS_MONITOR_CONFIG_RADIO_SYNC
+    err_code = ble_hvx_coalesce_register(&m_cb.hvx, radio_flush_handler, NULL);
+    VERIFY_SUCCESS(err_code);
+#endif
+
+    // The first measurement starts with the offset calibration.
+    m_cb.conversions    = BLE_BAS_MONITOR_CONFIG_CALIBRATION_INTERVAL;
+    m_cb.filter_valid   = false;
+    m_cb.reported_level = INVALID_LEVEL;
+    m_cb.state          = MONITOR_STATE_IDLE;
+
+    (void)measurement_request();
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ble_bas_monitor_measure(void)
+{
+    ret_code_t err_code;
+
+    if (m_cb.state != MONITOR_STATE_IDLE)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    err_code = app_timer_stop(m_monitor_timer);
+    VERIFY_SUCCESS(err_code);
+
+    m_cb.filter_valid = false;
+
+    return measurement_request() ? NRF_SUCCESS : NRF_ERROR_BUSY;
+}
+
+#endif // NRF_MODULE_ENABLED(BLE_BAS_MONITOR)
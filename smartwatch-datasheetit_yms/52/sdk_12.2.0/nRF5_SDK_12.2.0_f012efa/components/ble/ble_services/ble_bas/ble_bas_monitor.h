@@ -0,0 +1,170 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ble_bas_monitor Battery monitor
+ * @{
+ * @ingroup ble_bas
+ *
+ * @brief Module for measuring the battery level and updating the Battery Service.
+ *
+ * @details The battery voltage is measured periodically with one SAADC conversion, averaged by
+ *          the hardware oversampling in burst mode. The voltage is smoothed with an IIR filter and
+ *          converted to a level with a discharge curve. The Battery Service is updated only when
+ *          the level changes and the voltage has moved by @ref BLE_BAS_MONITOR_CONFIG_HYSTERESIS_MV
+ *          since the last update. The SAADC offset calibration is reused for
+ *          @ref BLE_BAS_MONITOR_CONFIG_CALIBRATION_INTERVAL measurements.
+ *
+ *          If @ref BLE_BAS_MONITOR_CONFIG_RADIO_SYNC is set, conversions are started from the
+ *          flush handler of @ref ble_hvx_coalesce, shortly before a radio event, so that they
+ *          are done before the radio starts and the supply drops under the TX current. If there
+ *          is no radio event within the wait time, the conversion is started anyway.
+ *
+ * @note The module uses the SAADC driver, which cannot be used by the application at the same
+ *       time. The driver must not be initialized when @ref ble_bas_monitor_init is called.
+ */
+
+#ifndef BLE_BAS_MONITOR_H__
+#define BLE_BAS_MONITOR_H__
+
+#include <stdint.h>
+#include "ble_bas.h"
+#include "ble_srv_common.h"
+#include "nrf_saadc.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Oversampling of a measurement.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_BAS_MONITOR_CONFIG_OVERSAMPLE
+#define BLE_BAS_MONITOR_CONFIG_OVERSAMPLE NRF_SAADC_OVERSAMPLE_16X
+#endif
+
+/** @brief Acquisition time of a sample. Long enough for the source resistance of the input.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_BAS_MONITOR_CONFIG_ACQTIME
+#define BLE_BAS_MONITOR_CONFIG_ACQTIME NRF_SAADC_ACQTIME_10US
+#endif
+
+/** @brief Number of measurements done with one offset calibration.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_BAS_MONITOR_CONFIG_CALIBRATION_INTERVAL
+#define BLE_BAS_MONITOR_CONFIG_CALIBRATION_INTERVAL 64
+#endif
+
+/** @brief Weight of a new measurement in the IIR filter, as a shift: 1/2^shift.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_BAS_MONITOR_CONFIG_IIR_SHIFT
+#define BLE_BAS_MONITOR_CONFIG_IIR_SHIFT 2
+#endif
+
+/** @brief Change of the filtered voltage, in mV, needed before a new level is reported.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_BAS_MONITOR_CONFIG_HYSTERESIS_MV
+#define BLE_BAS_MONITOR_CONFIG_HYSTERESIS_MV 10
+#endif
+
+/** @brief Start conversions shortly before radio events, using @ref ble_hvx_coalesce.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_BAS_MONITOR_CONFIG_RADIO_SYNC
+#define BLE_BAS_MONITOR_CONFIG_RADIO_SYNC NRF_MODULE_ENABLED(BLE_HVX_COALESCE)
+#endif
+
+/** @brief Longest duration of a conversion, in microseconds, when it is synchronized with the radio.
+ *         Must be shorter than the distance of the radio notification.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_BAS_MONITOR_CONFIG_WINDOW_US
+#define BLE_BAS_MONITOR_CONFIG_WINDOW_US 500
+#endif
+
+/**@brief Point of a discharge curve. */
+typedef struct
+{
+    uint16_t voltage_mv; /**< Battery voltage. */
+    uint8_t  level;      /**< Battery level at this voltage, in percent. */
+} ble_bas_monitor_curve_point_t;
+
+/**@brief Measurement, passed to the event handler. */
+typedef struct
+{
+    uint16_t voltage_mv; /**< Filtered battery voltage. */
+    uint8_t  level;      /**< Battery level of the filtered voltage, in percent. */
+    bool     reported;   /**< The level was sent to the Battery Service. */
+} ble_bas_monitor_evt_t;
+
+/**@brief Event handler, called from the SAADC interrupt after every measurement. */
+typedef void (* ble_bas_monitor_evt_handler_t)(ble_bas_monitor_evt_t const * p_evt);
+
+/**@brief Module configuration. */
+typedef struct
+{
+    ble_bas_t                           * p_bas;            /**< Battery Service to update, or NULL. */
+    nrf_saadc_input_t                     input;            /**< Analog input, for example @ref NRF_SAADC_INPUT_VDD. */
+    uint16_t                              divider_ratio;    /**< Ratio of the battery voltage to the input voltage, times 1000. 1000 without a resistor divider. */
+    uint32_t                              period_ticks;     /**< Time between measurements, in app_timer ticks. */
+    uint32_t                              radio_wait_ticks; /**< Longest wait for a radio event before a measurement, in app_timer ticks. */
+    ble_bas_monitor_curve_point_t const * p_curve;          /**< Discharge curve ordered by decreasing voltage, or NULL for a Li-ion cell. Kept by the module. */
+    uint8_t                               curve_points;     /**< Number of points of the discharge curve. */
+    ble_bas_monitor_evt_handler_t         evt_handler;      /**< Event handler, or NULL. */
+    ble_srv_error_handler_t               error_handler;    /**< Handler of errors of the SAADC driver, the timer, or the Battery Service, or NULL. */
+} ble_bas_monitor_config_t;
+
+/**@brief Function for initializing the module and the SAADC driver, and starting the
+ *        measurements.
+ *
+ * @details The first measurement is made right away, after an offset calibration. The app_timer
+ *          module must be initialized.
+ *
+ * @param[in] p_config Module configuration.
+ *
+ * @retval NRF_SUCCESS             If the module was initialized.
+ * @retval NRF_ERROR_NULL          If p_config was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If the configuration was invalid.
+ * @return Any error returned by the SAADC driver or app_timer.
+ */
+ret_code_t ble_bas_monitor_init(ble_bas_monitor_config_t const * p_config);
+
+/**@brief Function for starting a measurement now, for example after the charger was removed.
+ *
+ * @details The filter is restarted from the new measurement.
+ *
+ * @retval NRF_SUCCESS             If the measurement was requested.
+ * @retval NRF_ERROR_BUSY          If a measurement is in progress.
+ * @return Any error returned by app_timer.
+ */
+ret_code_t ble_bas_monitor_measure(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLE_BAS_MONITOR_H__
+
+/** @} */
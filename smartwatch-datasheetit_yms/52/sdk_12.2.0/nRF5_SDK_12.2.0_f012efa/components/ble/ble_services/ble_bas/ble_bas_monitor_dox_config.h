@@ -0,0 +1,60 @@
+/**
+ *
+ * @defgroup ble_bas_monitor_config Battery monitor configuration
+ * @{
+ * @ingroup ble_bas_monitor
+ */
+/** @brief Enabling the battery monitor
+ *
+ *  Requires the SAADC driver and app_timer.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_BAS_MONITOR_ENABLED
+
+/** @brief Oversampling of a measurement.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_BAS_MONITOR_CONFIG_OVERSAMPLE
+
+/** @brief Acquisition time of a sample.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_BAS_MONITOR_CONFIG_ACQTIME
+
+/** @brief Number of measurements done with one offset calibration.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_BAS_MONITOR_CONFIG_CALIBRATION_INTERVAL
+
+/** @brief Weight of a new measurement in the IIR filter, as a shift.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_BAS_MONITOR_CONFIG_IIR_SHIFT
+
+/** @brief Change of the filtered voltage, in mV, needed before a new level is reported.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_BAS_MONITOR_CONFIG_HYSTERESIS_MV
+
+/** @brief Start conversions shortly before radio events. Requires ble_hvx_coalesce.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_BAS_MONITOR_CONFIG_RADIO_SYNC
+
+/** @brief Longest duration of a conversion, in microseconds, when it is synchronized with the radio.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_BAS_MONITOR_CONFIG_WINDOW_US
+
+
+/** @} */
@@ -0,0 +1,1014 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(BLE_BTS)
+#include "ble_bts.h"
+#include "ble_srv_common.h"
+#include "app_util.h"
+#include "crc32.h"
+
+#define BLE_UUID_BTS_CP_CHARACTERISTIC   0x0002 /**< The UUID of the Control Point Characteristic. */
+#define BLE_UUID_BTS_DATA_CHARACTERISTIC 0x0003 /**< The UUID of the Data Characteristic. */
+
+#define BLE_BTS_CP_MAX_LEN               14     /**< Length of the longest Control Point message, the response. */
+#define BLE_BTS_PUT_LEN                  11     /**< Length of a PUT request. */
+#define BLE_BTS_GET_LEN                  12     /**< Length of a GET request. */
+#define BLE_BTS_RECEIPT_LEN              11     /**< Length of a receipt. */
+#define BLE_BTS_ABORT_LEN                3      /**< Length of an abort. */
+
+#define BTS_BASE_UUID                    {{0x3C, 0x71, 0x5A, 0xE2, 0x84, 0x1F, 0x4B, 0x90, 0xA6, 0x2D, 0xC8, 0x57, 0x00, 0x00, 0x6B, 0x1E}} /**< Used vendor specific UUID. */
+
+// Control Point messages waiting to be sent, in the order in which they are sent.
+#define CP_RSP_PUT                       0x01
+#define CP_RSP_GET                       0x02
+#define CP_ABORT_PUT                     0x04
+#define CP_ABORT_GET                     0x08
+#define CP_RECEIPT                       0x10
+#define CP_RECEIPT_REQ                   0x20
+
+#define IDX_PUT                          0
+#define IDX_GET                          1
+
+#define MAX_PKT_COUNT                    0xFFFF
+
+
+/**@brief Function for getting a mask of the lowest @p count bits. */
+static uint32_t bit_mask(uint32_t count)
+{
+    return (count >= 32) ? 0xFFFFFFFF : ((1UL << count) - 1);
+}
+
+
+/**@brief Function for getting the packet size of a new transfer from the effective ATT_MTU. */
+static uint16_t pkt_size_get(ble_bts_t * p_bts)
+{
+    uint16_t mtu = nrf_ble_gatt_eff_mtu_get(p_bts->p_gatt, p_bts->conn_handle);
+
+    mtu = MAX(mtu, GATT_MTU_SIZE_DEFAULT);
+    return MIN(mtu - 3, BLE_BTS_MAX_DATA_CHAR_LEN) - BLE_BTS_PKT_HDR_LEN;
+}
+
+
+/**@brief Function for getting the offset of a packet, limited to the size of the object. */
+static uint32_t pkt_offset(uint32_t size, uint32_t start_offset, uint16_t pkt_size, uint16_t seq)
+{
+    return MIN(start_offset + (uint32_t)seq * pkt_size, size);
+}
+
+
+/**@brief Function for getting the length of a packet. Only the last packet is shorter. */
+static uint16_t pkt_len(uint32_t size, uint32_t start_offset, uint16_t pkt_size, uint16_t seq)
+{
+    return (uint16_t)MIN(pkt_size, size - pkt_offset(size, start_offset, pkt_size, seq));
+}
+
+
+static void evt_send(ble_bts_t * p_bts, ble_bts_evt_t * p_evt)
+{
+    if (p_bts->evt_handler != NULL)
+    {
+        p_bts->evt_handler(p_bts, p_evt);
+    }
+}
+
+
+static uint32_t notify(ble_bts_t * p_bts, uint16_t handle, uint8_t const * p_data, uint16_t len)
+{
+    ble_gatts_hvx_params_t hvx_params;
+
+    memset(&hvx_params, 0, sizeof(hvx_params));
+
+    hvx_params.handle = handle;
+    hvx_params.p_data = (uint8_t *)p_data;
+    hvx_params.p_len  = &len;
+    hvx_params.type   = BLE_GATT_HVX_NOTIFICATION;
+
+    return sd_ble_gatts_hvx(p_bts->conn_handle, &hvx_params);
+}
+
+
+/**@brief Function for encoding a pending Control Point message.
+ *
+ * @return Length of the message.
+ */
+static uint16_t cp_msg_encode(ble_bts_t * p_bts, uint8_t msg, uint8_t * p_buf)
+{
+    uint16_t len = 0;
+
+    switch (msg)
+    {
+        case CP_RSP_PUT:
+        case CP_RSP_GET:
+        {
+            bool     put    = (msg == CP_RSP_PUT);
+            uint8_t  result = p_bts->rsp_result[put ? IDX_PUT : IDX_GET];
+            uint32_t offset = put ? p_bts->rx.start_offset : p_bts->tx.start_offset;
+            uint32_t size   = put ? p_bts->rx.size         : p_bts->tx.size;
+            uint16_t pkt    = put ? p_bts->rx.pkt_size     : p_bts->tx.pkt_size;
+            uint8_t  window = put ? p_bts->rx.window       : p_bts->tx.window;
+
+            if (result != BLE_BTS_RESULT_SUCCESS)
+            {
+                offset = 0;
+                size   = 0;
+                pkt    = 0;
+                window = 0;
+            }
+
+            p_buf[len++] = BLE_BTS_OP_RESPONSE;
+            p_buf[len++] = put ? BLE_BTS_OP_PUT : BLE_BTS_OP_GET;
+            p_buf[len++] = result;
+            len         += uint32_encode(offset, &p_buf[len]);
+            len         += uint32_encode(size, &p_buf[len]);
+            len         += uint16_encode(pkt, &p_buf[len]);
+            p_buf[len++] = window;
+        } break;
+
+        case CP_ABORT_PUT:
+        case CP_ABORT_GET:
+            p_buf[len++] = BLE_BTS_OP_ABORT;
+            p_buf[len++] = (msg == CP_ABORT_PUT) ? BLE_BTS_OP_PUT : BLE_BTS_OP_GET;
+            p_buf[len++] = p_bts->abort_result[(msg == CP_ABORT_PUT) ? IDX_PUT : IDX_GET];
+            break;
+
+        case CP_RECEIPT:
+            // Bit 0 of the received packets is always clear, it is the first missing packet.
+            p_buf[len++] = BLE_BTS_OP_RECEIPT;
+            len         += uint16_encode(p_bts->rx.base, &p_buf[len]);
+            len         += uint32_encode(p_bts->rx.received >> 1, &p_buf[len]);
+            len         += uint32_encode(p_bts->rx.crc_prefix, &p_buf[len]);
+            break;
+
+        case CP_RECEIPT_REQ:
+            p_buf[len++] = BLE_BTS_OP_RECEIPT_REQUEST;
+            break;
+
+        default:
+            break;
+    }
+
+    return len;
+}
+
+
+/**@brief Function for sending the pending Control Point messages until the SoftDevice buffers are full. */
+static void cp_pump(ble_bts_t * p_bts)
+{
+    if (p_bts->conn_handle == BLE_CONN_HANDLE_INVALID)
+    {
+        p_bts->cp_pending = 0;
+        return;
+    }
+
+    while ((p_bts->cp_pending != 0) && !p_bts->busy)
+    {
+        uint8_t  buf[BLE_BTS_CP_MAX_LEN];
+        uint8_t  msg = p_bts->cp_pending & (uint8_t)(~(p_bts->cp_pending - 1)); // Lowest bit.
+        uint32_t err_code;
+
+        err_code = notify(p_bts, p_bts->cp_handles.value_handle, buf, cp_msg_encode(p_bts, msg, buf));
+        if (err_code == BLE_ERROR_NO_TX_PACKETS)
+        {
+            // Retried on BLE_EVT_TX_COMPLETE.
+            p_bts->busy = true;
+            break;
+        }
+
+        // Other errors, for example notifications not enabled, drop the message.
+        p_bts->cp_pending &= (uint8_t)~msg;
+    }
+}
+
+
+static void cp_queue(ble_bts_t * p_bts, uint8_t msg)
+{
+    if (p_bts->conn_handle != BLE_CONN_HANDLE_INVALID)
+    {
+        p_bts->cp_pending |= msg;
+        cp_pump(p_bts);
+    }
+}
+
+
+static void rsp_queue(ble_bts_t * p_bts, uint8_t index, ble_bts_result_t result)
+{
+    p_bts->rsp_result[index] = result;
+    cp_queue(p_bts, (index == IDX_PUT) ? CP_RSP_PUT : CP_RSP_GET);
+}
+
+
+/**@brief Function for ending a PUT.
+ *
+ * @param[in] p_bts       Bulk Transfer Service structure.
+ * @param[in] result      Result of the transfer.
+ * @param[in] notify_peer Send an abort to the peer.
+ */
+static void rx_end(ble_bts_t * p_bts, ble_bts_result_t result, bool notify_peer)
+{
+    ble_bts_rx_t * p_rx = &p_bts->rx;
+    ble_bts_evt_t  evt;
+
+    p_rx->state = BLE_BTS_STATE_IDLE;
+
+    if (notify_peer)
+    {
+        p_bts->abort_result[IDX_PUT] = result;
+        cp_queue(p_bts, CP_ABORT_PUT);
+    }
+
+    memset(&evt, 0, sizeof(evt));
+    evt.evt_type  = BLE_BTS_EVT_RX_DONE;
+    evt.op        = BLE_BTS_OP_PUT;
+    evt.object_id = p_rx->object_id;
+    evt.size      = p_rx->size;
+    evt.offset    = pkt_offset(p_rx->size, p_rx->start_offset, p_rx->pkt_size, p_rx->base);
+    evt.result    = result;
+    evt_send(p_bts, &evt);
+}
+
+
+/**@brief Function for ending a PUT when all packets have been received, checking the CRC. */
+static void rx_complete(ble_bts_t * p_bts)
+{
+    if (p_bts->rx.crc_prefix != p_bts->rx.crc)
+    {
+        p_bts->stats.crc_errors++;
+        rx_end(p_bts, BLE_BTS_RESULT_CRC_ERROR, true);
+        return;
+    }
+
+    // The last receipt tells the peer that the object was received.
+    cp_queue(p_bts, CP_RECEIPT);
+    rx_end(p_bts, BLE_BTS_RESULT_SUCCESS, false);
+}
+
+
+/**@brief Function for ending a GET.
+ *
+ * @param[in] p_bts       Bulk Transfer Service structure.
+ * @param[in] result      Result of the transfer.
+ * @param[in] notify_peer Send an abort to the peer.
+ */
+static void tx_end(ble_bts_t * p_bts, ble_bts_result_t result, bool notify_peer)
+{
+    ble_bts_tx_t * p_tx = &p_bts->tx;
+    ble_bts_evt_t  evt;
+
+    p_tx->state = BLE_BTS_STATE_IDLE;
+
+    if (notify_peer)
+    {
+        p_bts->abort_result[IDX_GET] = result;
+        cp_queue(p_bts, CP_ABORT_GET);
+    }
+
+    memset(&evt, 0, sizeof(evt));
+    evt.evt_type  = BLE_BTS_EVT_TX_DONE;
+    evt.op        = BLE_BTS_OP_GET;
+    evt.object_id = p_tx->object_id;
+    evt.size      = p_tx->size;
+    evt.offset    = pkt_offset(p_tx->size, p_tx->start_offset, p_tx->pkt_size, p_tx->base);
+    evt.result    = result;
+    evt_send(p_bts, &evt);
+}
+
+
+/**@brief Function for sending the packets of a GET until the SoftDevice buffers are full.
+ *
+ * @details Missing packets are sent first, then new packets while the window allows it. When
+ *          all packets of the window are sent, a receipt is requested, so that the loss of the
+ *          last packets is detected.
+ */
+static void tx_pump(ble_bts_t * p_bts)
+{
+    ble_bts_tx_t * p_tx = &p_bts->tx;
+    uint8_t        pkt[BLE_BTS_MAX_DATA_CHAR_LEN];
+
+    while ((p_tx->state == BLE_BTS_STATE_ACTIVE) && !p_bts->busy)
+    {
+        bool     resend = (p_tx->resend != 0);
+        uint16_t seq;
+        uint16_t len;
+        uint32_t err_code;
+
+        if (resend)
+        {
+            uint16_t i = 0;
+
+            while ((p_tx->resend & (1UL << i)) == 0)
+            {
+                i++;
+            }
+            seq = p_tx->base + i;
+        }
+        else if ((p_tx->next < p_tx->pkt_count) && ((uint16_t)(p_tx->next - p_tx->base) < p_tx->window))
+        {
+            seq = p_tx->next;
+        }
+        else
+        {
+            if (!p_tx->receipt_requested && (p_tx->next != p_tx->base))
+            {
+                p_tx->receipt_requested = true;
+                cp_queue(p_bts, CP_RECEIPT_REQ);
+            }
+            break;
+        }
+
+        len = pkt_len(p_tx->size, p_tx->start_offset, p_tx->pkt_size, seq);
+        (void)uint16_encode(seq, pkt);
+
+        err_code = p_bts->data_read(p_bts,
+                                    p_tx->object_id,
+                                    pkt_offset(p_tx->size, p_tx->start_offset, p_tx->pkt_size, seq),
+                                    &pkt[BLE_BTS_PKT_HDR_LEN],
+                                    len);
+        if (err_code != NRF_SUCCESS)
+        {
+            tx_end(p_bts, BLE_BTS_RESULT_ABORTED, true);
+            break;
+        }
+
+        err_code = notify(p_bts, p_bts->data_handles.value_handle, pkt, len + BLE_BTS_PKT_HDR_LEN);
+        if (err_code == BLE_ERROR_NO_TX_PACKETS)
+        {
+            // Retried on BLE_EVT_TX_COMPLETE.
+            p_bts->busy = true;
+            break;
+        }
+        if (err_code != NRF_SUCCESS)
+        {
+            tx_end(p_bts, BLE_BTS_RESULT_ABORTED, true);
+            break;
+        }
+
+        if (resend)
+        {
+            p_tx->resend &= ~(1UL << (seq - p_tx->base));
+            p_bts->stats.tx_resent++;
+        }
+        else
+        {
+            // New packets are sent in order, so the CRC of the data up to each one is known.
+            p_tx->crc_next = crc32_compute(&pkt[BLE_BTS_PKT_HDR_LEN], len, &p_tx->crc_next);
+            p_tx->crc_end[seq % BLE_BTS_CONFIG_WINDOW_MAX] = p_tx->crc_next;
+            p_tx->next++;
+        }
+    }
+}
+
+
+/**@brief Function for handling a data packet of a PUT.
+ *
+ * @details The packets of the window are stored in the receive buffer, at the slot given by
+ *          their sequence number. The packets that follow the last delivered one are passed to
+ *          the application in order.
+ */
+static void on_data_write(ble_bts_t * p_bts, uint8_t const * p_data, uint16_t len)
+{
+    ble_bts_rx_t * p_rx = &p_bts->rx;
+    uint16_t       seq;
+    bool           new_gap;
+
+    if ((p_rx->state != BLE_BTS_STATE_ACTIVE) || (len < BLE_BTS_PKT_HDR_LEN))
+    {
+        return;
+    }
+
+    seq = uint16_decode(p_data);
+    if ((seq < p_rx->base) ||
+        (seq >= p_rx->pkt_count) ||
+        ((uint16_t)(seq - p_rx->base) >= p_rx->window) ||
+        ((p_rx->received & (1UL << (seq - p_rx->base))) != 0))
+    {
+        p_bts->stats.rx_duplicates++;
+        return;
+    }
+
+    if (len - BLE_BTS_PKT_HDR_LEN != pkt_len(p_rx->size, p_rx->start_offset, p_rx->pkt_size, seq))
+    {
+        return;
+    }
+
+    new_gap = (p_rx->received == 0) && (seq != p_rx->base);
+
+    memcpy(&p_bts->p_rx_buf[(seq % p_rx->window) * p_rx->pkt_size],
+           &p_data[BLE_BTS_PKT_HDR_LEN],
+           len - BLE_BTS_PKT_HDR_LEN);
+    p_rx->received |= (1UL << (seq - p_rx->base));
+
+    while ((p_rx->received & 1) != 0)
+    {
+        ble_bts_evt_t   evt;
+        uint8_t const * p_slot = &p_bts->p_rx_buf[(p_rx->base % p_rx->window) * p_rx->pkt_size];
+
+        memset(&evt, 0, sizeof(evt));
+        evt.evt_type  = BLE_BTS_EVT_RX_DATA;
+        evt.op        = BLE_BTS_OP_PUT;
+        evt.object_id = p_rx->object_id;
+        evt.size      = p_rx->size;
+        evt.offset    = pkt_offset(p_rx->size, p_rx->start_offset, p_rx->pkt_size, p_rx->base);
+        evt.p_data    = p_slot;
+        evt.len       = pkt_len(p_rx->size, p_rx->start_offset, p_rx->pkt_size, p_rx->base);
+
+        p_rx->crc_prefix      = crc32_compute(p_slot, evt.len, &p_rx->crc_prefix);
+        p_rx->received      >>= 1;
+        p_rx->base++;
+        p_rx->since_receipt++;
+        p_bts->stats.rx_bytes += evt.len;
+
+        evt_send(p_bts, &evt);
+        if (p_rx->state != BLE_BTS_STATE_ACTIVE)
+        {
+            // Aborted by the application.
+            return;
+        }
+    }
+
+    if (p_rx->base == p_rx->pkt_count)
+    {
+        rx_complete(p_bts);
+    }
+    else if (new_gap || (p_rx->since_receipt >= MAX(p_rx->window / 2, 1)))
+    {
+        p_rx->since_receipt = 0;
+        cp_queue(p_bts, CP_RECEIPT);
+    }
+}
+
+
+/**@brief Function for handling a PUT request. */
+static void on_put(ble_bts_t * p_bts, uint8_t const * p_data, uint16_t len)
+{
+    ble_bts_rx_t * p_rx = &p_bts->rx;
+    ble_bts_evt_t  evt;
+    uint16_t       object_id;
+    uint32_t       size;
+    uint32_t       crc;
+    uint32_t       offset     = 0;
+    uint32_t       crc_prefix = 0;
+    uint16_t       pkt_size   = pkt_size_get(p_bts);
+    uint32_t       pkt_count;
+    uint8_t        window     = MIN(BLE_BTS_CONFIG_WINDOW_MAX, p_bts->rx_buf_size / pkt_size);
+
+    if ((len < BLE_BTS_PUT_LEN) || (p_bts->p_rx_buf == NULL))
+    {
+        rsp_queue(p_bts, IDX_PUT, BLE_BTS_RESULT_INVALID);
+        return;
+    }
+
+    object_id = uint16_decode(&p_data[1]);
+    size      = uint32_decode(&p_data[3]);
+    crc       = uint32_decode(&p_data[7]);
+
+    if ((p_rx->state == BLE_BTS_STATE_ACTIVE) || (p_rx->state == BLE_BTS_STATE_PAUSED))
+    {
+        if ((p_rx->object_id == object_id) && (p_rx->size == size) && (p_rx->crc == crc))
+        {
+            // Resume after the data that was passed to the application.
+            offset     = pkt_offset(p_rx->size, p_rx->start_offset, p_rx->pkt_size, p_rx->base);
+            crc_prefix = p_rx->crc_prefix;
+        }
+        else
+        {
+            rx_end(p_bts, BLE_BTS_RESULT_ABORTED, false);
+        }
+    }
+
+    pkt_count = (size - offset + pkt_size - 1) / pkt_size;
+    if (pkt_count > MAX_PKT_COUNT)
+    {
+        p_rx->state = BLE_BTS_STATE_IDLE;
+        rsp_queue(p_bts, IDX_PUT, BLE_BTS_RESULT_INVALID);
+        return;
+    }
+    if (window == 0)
+    {
+        p_rx->state = BLE_BTS_STATE_IDLE;
+        rsp_queue(p_bts, IDX_PUT, BLE_BTS_RESULT_NO_MEM);
+        return;
+    }
+
+    p_rx->state         = BLE_BTS_STATE_PENDING;
+    p_rx->object_id     = object_id;
+    p_rx->size          = size;
+    p_rx->crc           = crc;
+    p_rx->start_offset  = offset;
+    p_rx->pkt_size      = pkt_size;
+    p_rx->pkt_count     = (uint16_t)pkt_count;
+    p_rx->window        = window;
+    p_rx->base          = 0;
+    p_rx->received      = 0;
+    p_rx->crc_prefix    = crc_prefix;
+    p_rx->since_receipt = 0;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.evt_type  = BLE_BTS_EVT_RX_START;
+    evt.op        = BLE_BTS_OP_PUT;
+    evt.object_id = object_id;
+    evt.size      = size;
+    evt.offset    = offset;
+    evt_send(p_bts, &evt);
+
+    if (p_rx->state != BLE_BTS_STATE_PENDING)
+    {
+        // Rejected by the application with ble_bts_abort().
+        rsp_queue(p_bts, IDX_PUT, BLE_BTS_RESULT_REJECTED);
+        return;
+    }
+
+    p_rx->state = BLE_BTS_STATE_ACTIVE;
+    rsp_queue(p_bts, IDX_PUT, BLE_BTS_RESULT_SUCCESS);
+
+    if (p_rx->pkt_count == 0)
+    {
+        rx_complete(p_bts);
+    }
+}
+
+
+/**@brief Function for handling a GET request. */
+static void on_get(ble_bts_t * p_bts, uint8_t const * p_data, uint16_t len)
+{
+    ble_bts_tx_t * p_tx = &p_bts->tx;
+    ble_bts_evt_t  evt;
+
+    if (p_tx->state == BLE_BTS_STATE_ACTIVE)
+    {
+        tx_end(p_bts, BLE_BTS_RESULT_ABORTED, false);
+    }
+    // A paused GET is replaced, the peer gives the offset to resume at.
+    p_tx->state = BLE_BTS_STATE_IDLE;
+
+    if ((len < BLE_BTS_GET_LEN) || (p_data[11] == 0))
+    {
+        rsp_queue(p_bts, IDX_GET, BLE_BTS_RESULT_INVALID);
+        return;
+    }
+    if (p_bts->data_read == NULL)
+    {
+        rsp_queue(p_bts, IDX_GET, BLE_BTS_RESULT_REJECTED);
+        return;
+    }
+
+    p_tx->state        = BLE_BTS_STATE_PENDING;
+    p_tx->object_id    = uint16_decode(&p_data[1]);
+    p_tx->start_offset = uint32_decode(&p_data[3]);
+    p_tx->crc_base     = uint32_decode(&p_data[7]);
+    p_tx->window       = MIN(p_data[11], BLE_BTS_CONFIG_WINDOW_MAX);
+
+    memset(&evt, 0, sizeof(evt));
+    evt.evt_type  = BLE_BTS_EVT_TX_REQUEST;
+    evt.op        = BLE_BTS_OP_GET;
+    evt.object_id = p_tx->object_id;
+    evt.offset    = p_tx->start_offset;
+    evt_send(p_bts, &evt);
+}
+
+
+/**@brief Function for handling a receipt of a GET.
+ *
+ * @details The receipt acknowledges the packets before the first missing one, if the CRC32 of
+ *          their data matches. The missing packets before the last received one are sent again.
+ *          If the receipt answers a request, all packets that are not acknowledged are missing.
+ */
+static void on_receipt(ble_bts_t * p_bts, uint8_t const * p_data, uint16_t len)
+{
+    ble_bts_tx_t * p_tx = &p_bts->tx;
+    uint16_t       first_missing;
+    uint32_t       received;
+    uint32_t       crc;
+    uint32_t       crc_acked;
+    uint16_t       in_flight;
+
+    if ((p_tx->state != BLE_BTS_STATE_ACTIVE) || (len < BLE_BTS_RECEIPT_LEN))
+    {
+        return;
+    }
+
+    first_missing = uint16_decode(&p_data[1]);
+    received      = uint32_decode(&p_data[3]);
+    crc           = uint32_decode(&p_data[7]);
+
+    if ((first_missing < p_tx->base) || (first_missing > p_tx->next))
+    {
+        // Older than the last receipt.
+        return;
+    }
+
+    crc_acked = (first_missing == p_tx->base) ? p_tx->crc_base :
+                p_tx->crc_end[(first_missing - 1) % BLE_BTS_CONFIG_WINDOW_MAX];
+    if (crc != crc_acked)
+    {
+        p_bts->stats.crc_errors++;
+        tx_end(p_bts, BLE_BTS_RESULT_CRC_ERROR, true);
+        return;
+    }
+
+    p_bts->stats.tx_bytes += pkt_offset(p_tx->size, p_tx->start_offset, p_tx->pkt_size, first_missing)
+                           - pkt_offset(p_tx->size, p_tx->start_offset, p_tx->pkt_size, p_tx->base);
+
+    p_tx->resend   = ((first_missing - p_tx->base) >= 32) ? 0 : (p_tx->resend >> (first_missing - p_tx->base));
+    p_tx->base     = first_missing;
+    p_tx->crc_base = crc_acked;
+    in_flight      = p_tx->next - p_tx->base;
+
+    if (received != 0)
+    {
+        uint32_t span = 1;
+
+        for (uint32_t bits = received; bits != 0; bits >>= 1)
+        {
+            span++;
+        }
+        p_tx->resend |= ~(received << 1) & bit_mask(span);
+    }
+    else if (p_tx->receipt_requested)
+    {
+        p_tx->resend |= bit_mask(in_flight);
+    }
+    p_tx->resend           &= bit_mask(in_flight);
+    p_tx->receipt_requested = false;
+
+    if (p_tx->base == p_tx->pkt_count)
+    {
+        tx_end(p_bts, BLE_BTS_RESULT_SUCCESS, false);
+    }
+    else
+    {
+        tx_pump(p_bts);
+    }
+}
+
+
+/**@brief Function for handling a write to the Control Point. */
+static void on_cp_write(ble_bts_t * p_bts, uint8_t const * p_data, uint16_t len)
+{
+    if (len == 0)
+    {
+        return;
+    }
+
+    switch (p_data[0])
+    {
+        case BLE_BTS_OP_PUT:
+            on_put(p_bts, p_data, len);
+            break;
+
+        case BLE_BTS_OP_GET:
+            on_get(p_bts, p_data, len);
+            break;
+
+        case BLE_BTS_OP_RECEIPT:
+            on_receipt(p_bts, p_data, len);
+            break;
+
+        case BLE_BTS_OP_RECEIPT_REQUEST:
+            if (p_bts->rx.state == BLE_BTS_STATE_ACTIVE)
+            {
+                p_bts->rx.since_receipt = 0;
+                cp_queue(p_bts, CP_RECEIPT);
+            }
+            break;
+
+        case BLE_BTS_OP_ABORT:
+            if (len < BLE_BTS_ABORT_LEN)
+            {
+                break;
+            }
+            if ((p_data[1] == BLE_BTS_OP_PUT) && (p_bts->rx.state != BLE_BTS_STATE_IDLE))
+            {
+                rx_end(p_bts, BLE_BTS_RESULT_ABORTED, false);
+            }
+            else if ((p_data[1] == BLE_BTS_OP_GET) && (p_bts->tx.state != BLE_BTS_STATE_IDLE))
+            {
+                tx_end(p_bts, BLE_BTS_RESULT_ABORTED, false);
+            }
+            break;
+
+        default:
+            // Unknown op code, ignored.
+            break;
+    }
+}
+
+
+/**@brief Function for handling the @ref BLE_GAP_EVT_DISCONNECTED event from the SoftDevice.
+ *
+ * @details The transfers in progress are paused, so that the peer can resume them.
+ *
+ * @param[in] p_bts     Bulk Transfer Service structure.
+ */
+static void on_disconnect(ble_bts_t * p_bts)
+{
+    ble_bts_evt_t evt;
+
+    p_bts->conn_handle = BLE_CONN_HANDLE_INVALID;
+    p_bts->busy        = false;
+    p_bts->cp_pending  = 0;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.evt_type = BLE_BTS_EVT_PAUSED;
+
+    if (p_bts->rx.state == BLE_BTS_STATE_ACTIVE)
+    {
+        p_bts->rx.state = BLE_BTS_STATE_PAUSED;
+
+        evt.op        = BLE_BTS_OP_PUT;
+        evt.object_id = p_bts->rx.object_id;
+        evt.size      = p_bts->rx.size;
+        evt.offset    = pkt_offset(p_bts->rx.size, p_bts->rx.start_offset, p_bts->rx.pkt_size, p_bts->rx.base);
+        evt_send(p_bts, &evt);
+    }
+
+    if (p_bts->tx.state == BLE_BTS_STATE_PENDING)
+    {
+        tx_end(p_bts, BLE_BTS_RESULT_ABORTED, false);
+    }
+    else if (p_bts->tx.state == BLE_BTS_STATE_ACTIVE)
+    {
+        p_bts->tx.state = BLE_BTS_STATE_PAUSED;
+
+        evt.op        = BLE_BTS_OP_GET;
+        evt.object_id = p_bts->tx.object_id;
+        evt.size      = p_bts->tx.size;
+        evt.offset    = pkt_offset(p_bts->tx.size, p_bts->tx.start_offset, p_bts->tx.pkt_size, p_bts->tx.base);
+        evt_send(p_bts, &evt);
+    }
+}
+
+
+/**@brief Function for handling the @ref BLE_GATTS_EVT_WRITE event from the SoftDevice.
+ *
+ * @param[in] p_bts     Bulk Transfer Service structure.
+ * @param[in] p_ble_evt Pointer to the event received from BLE stack.
+ */
+static void on_write(ble_bts_t * p_bts, ble_evt_t * p_ble_evt)
+{
+    ble_gatts_evt_write_t * p_evt_write = &p_ble_evt->evt.gatts_evt.params.write;
+
+    if (p_evt_write->handle == p_bts->data_handles.value_handle)
+    {
+        on_data_write(p_bts, p_evt_write->data, p_evt_write->len);
+    }
+    else if (p_evt_write->handle == p_bts->cp_handles.value_handle)
+    {
+        on_cp_write(p_bts, p_evt_write->data, p_evt_write->len);
+    }
+    else
+    {
+        // Do Nothing. This event is not relevant for this service.
+    }
+}
+
+
+/**@brief Function for adding a characteristic.
+ *
+ * @param[in]  p_bts     Bulk Transfer Service structure.
+ * @param[in]  uuid      UUID of the characteristic.
+ * @param[in]  max_len   Maximum length of the value.
+ * @param[in]  write     The characteristic takes writes with response, otherwise without response.
+ * @param[out] p_handles Handles of the characteristic.
+ *
+ * @return NRF_SUCCESS on success, otherwise an error code.
+ */
+static uint32_t char_add(ble_bts_t                * p_bts,
+                         uint16_t                   uuid,
+                         uint16_t                   max_len,
+                         bool                       write,
+                         ble_gatts_char_handles_t * p_handles)
+{
+    ble_gatts_char_md_t char_md;
+    ble_gatts_attr_md_t cccd_md;
+    ble_gatts_attr_t    attr_char_value;
+    ble_uuid_t          ble_uuid;
+    ble_gatts_attr_md_t attr_md;
+
+    memset(&cccd_md, 0, sizeof(cccd_md));
+
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&cccd_md.read_perm);
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&cccd_md.write_perm);
+
+    cccd_md.vloc = BLE_GATTS_VLOC_STACK;
+
+    memset(&char_md, 0, sizeof(char_md));
+
+    char_md.char_props.notify        = 1;
+    char_md.char_props.write         = write ? 1 : 0;
+    char_md.char_props.write_wo_resp = write ? 0 : 1;
+    char_md.p_cccd_md                = &cccd_md;
+
+    ble_uuid.type = p_bts->uuid_type;
+    ble_uuid.uuid = uuid;
+
+    memset(&attr_md, 0, sizeof(attr_md));
+
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&attr_md.read_perm);
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&attr_md.write_perm);
+
+    attr_md.vloc    = BLE_GATTS_VLOC_STACK;
+    attr_md.rd_auth = 0;
+    attr_md.wr_auth = 0;
+    attr_md.vlen    = 1;
+
+    memset(&attr_char_value, 0, sizeof(attr_char_value));
+
+    attr_char_value.p_uuid    = &ble_uuid;
+    attr_char_value.p_attr_md = &attr_md;
+    attr_char_value.init_len  = sizeof(uint8_t);
+    attr_char_value.init_offs = 0;
+    attr_char_value.max_len   = max_len;
+
+    return sd_ble_gatts_characteristic_add(p_bts->service_handle,
+                                           &char_md,
+                                           &attr_char_value,
+                                           p_handles);
+}
+
+
+void ble_bts_on_ble_evt(ble_bts_t * p_bts, ble_evt_t * p_ble_evt)
+{
+    if ((p_bts == NULL) || (p_ble_evt == NULL))
+    {
+        return;
+    }
+
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GAP_EVT_CONNECTED:
+            p_bts->conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+            break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            on_disconnect(p_bts);
+            break;
+
+        case BLE_GATTS_EVT_WRITE:
+            on_write(p_bts, p_ble_evt);
+            break;
+
+        case BLE_EVT_TX_COMPLETE:
+            if (p_ble_evt->evt.common_evt.conn_handle == p_bts->conn_handle)
+            {
+                p_bts->busy = false;
+                cp_pump(p_bts);
+                tx_pump(p_bts);
+            }
+            break;
+
+        default:
+            // No implementation needed.
+            break;
+    }
+}
+
+
+uint32_t ble_bts_init(ble_bts_t * p_bts, const ble_bts_init_t * p_bts_init)
+{
+    uint32_t      err_code;
+    ble_uuid_t    ble_uuid;
+    ble_uuid128_t bts_base_uuid = BTS_BASE_UUID;
+
+    VERIFY_PARAM_NOT_NULL(p_bts);
+    VERIFY_PARAM_NOT_NULL(p_bts_init);
+
+    // Initialize the service structure.
+    memset(p_bts, 0, sizeof(ble_bts_t));
+    p_bts->conn_handle = BLE_CONN_HANDLE_INVALID;
+    p_bts->evt_handler = p_bts_init->evt_handler;
+    p_bts->data_read   = p_bts_init->data_read;
+    p_bts->p_gatt      = p_bts_init->p_gatt;
+    p_bts->p_rx_buf    = p_bts_init->p_rx_buf;
+    p_bts->rx_buf_size = p_bts_init->rx_buf_size;
+
+    // Add a custom base UUID.
+    err_code = sd_ble_uuid_vs_add(&bts_base_uuid, &p_bts->uuid_type);
+    VERIFY_SUCCESS(err_code);
+
+    ble_uuid.type = p_bts->uuid_type;
+    ble_uuid.uuid = BLE_UUID_BTS_SERVICE;
+
+    // Add the service.
+    err_code = sd_ble_gatts_service_add(BLE_GATTS_SRVC_TYPE_PRIMARY,
+                                        &ble_uuid,
+                                        &p_bts->service_handle);
+    VERIFY_SUCCESS(err_code);
+
+    // Add the Control Point Characteristic.
+    err_code = char_add(p_bts, BLE_UUID_BTS_CP_CHARACTERISTIC, BLE_BTS_CP_MAX_LEN, true, &p_bts->cp_handles);
+    VERIFY_SUCCESS(err_code);
+
+    // Add the Data Characteristic.
+    return char_add(p_bts, BLE_UUID_BTS_DATA_CHARACTERISTIC, BLE_BTS_MAX_DATA_CHAR_LEN, false, &p_bts->data_handles);
+}
+
+
+uint32_t ble_bts_send_start(ble_bts_t * p_bts, uint32_t size)
+{
+    ble_bts_tx_t * p_tx;
+    uint32_t       pkt_count;
+
+    VERIFY_PARAM_NOT_NULL(p_bts);
+
+    p_tx = &p_bts->tx;
+
+    if (p_tx->state != BLE_BTS_STATE_PENDING)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if (p_tx->start_offset > size)
+    {
+        p_tx->state = BLE_BTS_STATE_IDLE;
+        rsp_queue(p_bts, IDX_GET, BLE_BTS_RESULT_INVALID);
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    p_tx->pkt_size = pkt_size_get(p_bts);
+    pkt_count      = (size - p_tx->start_offset + p_tx->pkt_size - 1) / p_tx->pkt_size;
+    if (pkt_count > MAX_PKT_COUNT)
+    {
+        p_tx->state = BLE_BTS_STATE_IDLE;
+        rsp_queue(p_bts, IDX_GET, BLE_BTS_RESULT_INVALID);
+        return NRF_ERROR_DATA_SIZE;
+    }
+
+    p_tx->state             = BLE_BTS_STATE_ACTIVE;
+    p_tx->size              = size;
+    p_tx->pkt_count         = (uint16_t)pkt_count;
+    p_tx->base              = 0;
+    p_tx->next              = 0;
+    p_tx->resend            = 0;
+    p_tx->crc_next          = p_tx->crc_base;
+    p_tx->receipt_requested = false;
+
+    rsp_queue(p_bts, IDX_GET, BLE_BTS_RESULT_SUCCESS);
+
+    if (p_tx->pkt_count == 0)
+    {
+        tx_end(p_bts, BLE_BTS_RESULT_SUCCESS, false);
+    }
+    else
+    {
+        tx_pump(p_bts);
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ble_bts_abort(ble_bts_t * p_bts, ble_bts_op_t op)
+{
+    VERIFY_PARAM_NOT_NULL(p_bts);
+
+    if (op == BLE_BTS_OP_PUT)
+    {
+        switch (p_bts->rx.state)
+        {
+            case BLE_BTS_STATE_PENDING:
+                // The PUT handler sends the rejection.
+                p_bts->rx.state = BLE_BTS_STATE_IDLE;
+                return NRF_SUCCESS;
+
+            case BLE_BTS_STATE_ACTIVE:
+            case BLE_BTS_STATE_PAUSED:
+                rx_end(p_bts, BLE_BTS_RESULT_ABORTED, true);
+                return NRF_SUCCESS;
+
+            default:
+                return NRF_ERROR_INVALID_STATE;
+        }
+    }
+
+    if (op == BLE_BTS_OP_GET)
+    {
+        switch (p_bts->tx.state)
+        {
+            case BLE_BTS_STATE_PENDING:
+                p_bts->tx.state = BLE_BTS_STATE_IDLE;
+                rsp_queue(p_bts, IDX_GET, BLE_BTS_RESULT_REJECTED);
+                return NRF_SUCCESS;
+
+            case BLE_BTS_STATE_ACTIVE:
+            case BLE_BTS_STATE_PAUSED:
+                tx_end(p_bts, BLE_BTS_RESULT_ABORTED, true);
+                return NRF_SUCCESS;
+
+            default:
+                return NRF_ERROR_INVALID_STATE;
+        }
+    }
+
+    return NRF_ERROR_INVALID_PARAM;
+}
+
+#endif // NRF_MODULE_ENABLED(BLE_BTS)
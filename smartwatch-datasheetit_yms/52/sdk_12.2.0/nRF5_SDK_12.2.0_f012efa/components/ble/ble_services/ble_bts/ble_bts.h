@@ -0,0 +1,296 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @defgroup ble_bts Bulk Transfer Service
+ * @{
+ * @ingroup  ble_sdk_srv
+ * @brief    Bulk Transfer Service implementation.
+ *
+ * @details The Bulk Transfer Service moves objects (files, images, logs) of up to several
+ *          megabytes in both directions. It has two characteristics:
+ *          - Control Point (write, notify): requests, responses and receipts.
+ *          - Data (write without response, notify): data packets.
+ *
+ *          A data packet is a 16-bit sequence number followed by up to @p pkt_size bytes.
+ *          Packet n holds the data at offset start + n * pkt_size, where start is the offset
+ *          at which the transfer was started or resumed. The packet size is the effective
+ *          ATT_MTU of the link minus 5 bytes. It is set when the transfer starts.
+ *
+ *          The sender keeps up to @p window packets in flight. The receiver sends a receipt
+ *          with the first missing packet, a bitmap of the packets received after it, and the
+ *          CRC32 of all data up to the first missing packet. Receipts are sent every half
+ *          window, when a packet is missing, and when the sender asks for one. The sender
+ *          checks the CRC and sends again only the missing packets.
+ *
+ *          Control Point messages, all values little endian:
+ *          - PUT (peer to server): op, object ID (2), size (4), CRC32 of the object (4).
+ *          - GET (peer to server): op, object ID (2), offset (4), CRC32 of the data before the
+ *            offset (4), window (1).
+ *          - RECEIPT: op, first missing packet (2), bitmap (4), CRC32 (4).
+ *          - RECEIPT_REQUEST: op.
+ *          - ABORT: op, PUT or GET, result.
+ *          - RESPONSE (server to peer): op, request op, result, offset (4), size (4),
+ *            packet size (2), window (1).
+ *
+ *          When the link is lost, the state of the transfers is kept. A PUT of the same
+ *          object, size and CRC resumes at the last acknowledged offset, which the response
+ *          returns. A GET resumes at the offset given by the peer.
+ *
+ * @note The application must propagate SoftDevice events to the Bulk Transfer Service module
+ *       by calling the ble_bts_on_ble_evt() function from the ble_stack_handler callback.
+ * @note For the highest throughput, apply @ref NRF_BLE_GATT_LINK_PROFILE_BULK to the link
+ *       before the transfer starts. The service keeps the SoftDevice transmit buffers full,
+ *       so the packets fill the connection events.
+ */
+
+#ifndef BLE_BTS_H__
+#define BLE_BTS_H__
+
+#include "ble.h"
+#include "ble_srv_common.h"
+#include "nrf_ble_gatt.h"
+#include "sdk_errors.h"
+#include "sdk_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Largest number of packets in flight. At most 32.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_BTS_CONFIG_WINDOW_MAX
+#define BLE_BTS_CONFIG_WINDOW_MAX 16
+#endif
+
+#define BLE_UUID_BTS_SERVICE     0x0001                            /**< The UUID of the Bulk Transfer Service. */
+#define BLE_BTS_PKT_HDR_LEN      2                                 /**< Length of the header of a data packet. */
+#define BLE_BTS_MAX_DATA_CHAR_LEN (NRF_BLE_GATT_MAX_MTU_SIZE - 3)  /**< Maximum length of the Data characteristic. */
+#define BLE_BTS_MAX_PKT_SIZE     (BLE_BTS_MAX_DATA_CHAR_LEN - BLE_BTS_PKT_HDR_LEN) /**< Maximum data in one packet. */
+
+/**@brief Control Point op codes. */
+typedef enum
+{
+    BLE_BTS_OP_PUT             = 0x01, /**< Transfer an object from the peer to the server. */
+    BLE_BTS_OP_GET             = 0x02, /**< Transfer an object from the server to the peer. */
+    BLE_BTS_OP_RECEIPT         = 0x03, /**< Receipt from the receiver of a transfer. */
+    BLE_BTS_OP_RECEIPT_REQUEST = 0x04, /**< Request for a receipt from the sender of a transfer. */
+    BLE_BTS_OP_ABORT           = 0x05, /**< Abort a transfer. */
+    BLE_BTS_OP_RESPONSE        = 0x80, /**< Response to PUT or GET. */
+} ble_bts_op_t;
+
+/**@brief Results of a request or a transfer. */
+typedef enum
+{
+    BLE_BTS_RESULT_SUCCESS   = 0x00, /**< Success. */
+    BLE_BTS_RESULT_REJECTED  = 0x01, /**< The application rejected the request. */
+    BLE_BTS_RESULT_INVALID   = 0x02, /**< The request is not valid. */
+    BLE_BTS_RESULT_CRC_ERROR = 0x03, /**< The CRC of the data does not match. */
+    BLE_BTS_RESULT_ABORTED   = 0x04, /**< The transfer was aborted. */
+    BLE_BTS_RESULT_NO_MEM    = 0x05, /**< The receive buffer cannot hold one packet. */
+} ble_bts_result_t;
+
+/**@brief Bulk Transfer Service event types. */
+typedef enum
+{
+    BLE_BTS_EVT_RX_START,   /**< A PUT was received. Call @ref ble_bts_abort to reject it. */
+    BLE_BTS_EVT_RX_DATA,    /**< Data of a PUT, in order. */
+    BLE_BTS_EVT_RX_DONE,    /**< A PUT ended, see the result. */
+    BLE_BTS_EVT_TX_REQUEST, /**< A GET was received. Call @ref ble_bts_send_start or @ref ble_bts_abort. */
+    BLE_BTS_EVT_TX_DONE,    /**< A GET ended, see the result. */
+    BLE_BTS_EVT_PAUSED,     /**< The link was lost during a transfer. It can be resumed by the peer. */
+} ble_bts_evt_type_t;
+
+/**@brief Bulk Transfer Service event. */
+typedef struct
+{
+    ble_bts_evt_type_t evt_type;  /**< Type of the event. */
+    ble_bts_op_t       op;        /**< @ref BLE_BTS_OP_PUT or @ref BLE_BTS_OP_GET. */
+    uint16_t           object_id; /**< Object ID. */
+    uint32_t           size;      /**< Size of the object. Not used for @ref BLE_BTS_EVT_TX_REQUEST. */
+    uint32_t           offset;    /**< Offset at which the transfer starts or resumes, offset of the data, or offset reached. */
+    uint8_t const    * p_data;    /**< Data. Only for @ref BLE_BTS_EVT_RX_DATA. Valid during the event only. */
+    uint16_t           len;       /**< Length of the data. Only for @ref BLE_BTS_EVT_RX_DATA. */
+    ble_bts_result_t   result;    /**< Result. Only for @ref BLE_BTS_EVT_RX_DONE and @ref BLE_BTS_EVT_TX_DONE. */
+} ble_bts_evt_t;
+
+/* Forward declaration of the ble_bts_t type. */
+typedef struct ble_bts_s ble_bts_t;
+
+/**@brief Bulk Transfer Service event handler type. */
+typedef void (*ble_bts_evt_handler_t) (ble_bts_t * p_bts, ble_bts_evt_t const * p_evt);
+
+/**@brief Function type for reading the data of a GET.
+ *
+ * @param[in]  p_bts     Bulk Transfer Service structure.
+ * @param[in]  object_id Object ID.
+ * @param[in]  offset    Offset of the data.
+ * @param[out] p_buf     Buffer for the data.
+ * @param[in]  len       Length of the data.
+ *
+ * @retval NRF_SUCCESS If the data was read. Otherwise, the transfer is aborted.
+ */
+typedef ret_code_t (*ble_bts_data_read_t) (ble_bts_t * p_bts,
+                                           uint16_t    object_id,
+                                           uint32_t    offset,
+                                           uint8_t   * p_buf,
+                                           uint16_t    len);
+
+/**@brief Bulk Transfer Service initialization structure. */
+typedef struct
+{
+    ble_bts_evt_handler_t evt_handler; /**< Event handler. */
+    ble_bts_data_read_t   data_read;   /**< Function for reading the data of a GET. Can be NULL if GET is not used. */
+    nrf_ble_gatt_t      * p_gatt;      /**< GATT module that holds the effective ATT_MTU of the link. */
+    uint8_t             * p_rx_buf;    /**< Buffer for the packets of a PUT that are received out of order. Can be NULL if PUT is not used. */
+    uint16_t              rx_buf_size; /**< Size of the buffer. The receive window is the number of packets it holds, up to @ref BLE_BTS_CONFIG_WINDOW_MAX. */
+} ble_bts_init_t;
+
+/**@brief Statistics. */
+typedef struct
+{
+    uint32_t rx_bytes;      /**< Bytes of PUT data passed to the application. */
+    uint32_t rx_duplicates; /**< PUT packets dropped because they were received before, or outside of the window. */
+    uint32_t tx_bytes;      /**< Bytes of GET data acknowledged by the peer. */
+    uint32_t tx_resent;     /**< GET packets sent again. */
+    uint32_t crc_errors;    /**< Transfers aborted because of a CRC mismatch. */
+} ble_bts_stats_t;
+
+/**@brief State of a transfer. */
+typedef enum
+{
+    BLE_BTS_STATE_IDLE,    /**< No transfer. */
+    BLE_BTS_STATE_PENDING, /**< GET received, waiting for @ref ble_bts_send_start. */
+    BLE_BTS_STATE_ACTIVE,  /**< Transfer in progress. */
+    BLE_BTS_STATE_PAUSED,  /**< Link lost during the transfer. */
+} ble_bts_state_t;
+
+/**@brief Receiving side of a PUT. */
+typedef struct
+{
+    ble_bts_state_t state;
+    uint16_t        object_id;
+    uint32_t        size;
+    uint32_t        crc;           /**< CRC32 of the object, from the PUT. */
+    uint32_t        start_offset;  /**< Offset of packet 0. */
+    uint16_t        pkt_size;
+    uint16_t        pkt_count;     /**< Number of packets from start_offset to the end. */
+    uint8_t         window;
+    uint16_t        base;          /**< First missing packet. */
+    uint32_t        received;      /**< Bit i is set if packet base + i was received. */
+    uint32_t        crc_prefix;    /**< CRC32 of the data before packet base. */
+    uint8_t         since_receipt; /**< Packets delivered since the last receipt. */
+} ble_bts_rx_t;
+
+/**@brief Sending side of a GET. */
+typedef struct
+{
+    ble_bts_state_t state;
+    uint16_t        object_id;
+    uint32_t        size;
+    uint32_t        start_offset;
+    uint16_t        pkt_size;
+    uint16_t        pkt_count;
+    uint8_t         window;
+    uint16_t        base;                              /**< First packet not acknowledged. */
+    uint16_t        next;                              /**< Next packet sent for the first time. */
+    uint32_t        resend;                            /**< Bit i is set if packet base + i must be sent again. */
+    uint32_t        crc_base;                          /**< CRC32 of the data before packet base. */
+    uint32_t        crc_next;                          /**< CRC32 of the data before packet next. */
+    uint32_t        crc_end[BLE_BTS_CONFIG_WINDOW_MAX]; /**< CRC32 of the data up to the end of each packet in flight. */
+    bool            receipt_requested;
+} ble_bts_tx_t;
+
+/**@brief Bulk Transfer Service structure.
+ *
+ * @details This structure contains status information related to the service.
+ */
+struct ble_bts_s
+{
+    uint8_t                  uuid_type;       /**< UUID type for Bulk Transfer Service Base UUID. */
+    uint16_t                 service_handle;  /**< Handle of Bulk Transfer Service (as provided by the SoftDevice). */
+    ble_gatts_char_handles_t cp_handles;      /**< Handles related to the Control Point characteristic. */
+    ble_gatts_char_handles_t data_handles;    /**< Handles related to the Data characteristic. */
+    uint16_t                 conn_handle;     /**< Handle of the current connection. BLE_CONN_HANDLE_INVALID if not in a connection. */
+    ble_bts_evt_handler_t    evt_handler;     /**< Event handler. */
+    ble_bts_data_read_t      data_read;       /**< Function for reading the data of a GET. */
+    nrf_ble_gatt_t         * p_gatt;          /**< GATT module. */
+    uint8_t                * p_rx_buf;        /**< Buffer for the packets of a PUT. */
+    uint16_t                 rx_buf_size;     /**< Size of the buffer. */
+    bool                     busy;            /**< The SoftDevice transmit buffers are full. */
+    uint8_t                  cp_pending;      /**< Control Point messages waiting to be sent. */
+    uint8_t                  rsp_result[2];   /**< Results of the pending responses to PUT and GET. */
+    uint8_t                  abort_result[2]; /**< Results of the pending aborts of PUT and GET. */
+    ble_bts_rx_t             rx;              /**< PUT in progress. */
+    ble_bts_tx_t             tx;              /**< GET in progress. */
+    ble_bts_stats_t          stats;           /**< Statistics. */
+};
+
+/**@brief Function for initializing the Bulk Transfer Service.
+ *
+ * @param[out] p_bts      Bulk Transfer Service structure. This structure must be supplied
+ *                        by the application. It is initialized by this function and will
+ *                        later be used to identify this particular service instance.
+ * @param[in] p_bts_init  Information needed to initialize the service.
+ *
+ * @retval NRF_SUCCESS If the service was successfully initialized. Otherwise, an error code is returned.
+ * @retval NRF_ERROR_NULL If either of the pointers p_bts or p_bts_init is NULL.
+ */
+uint32_t ble_bts_init(ble_bts_t * p_bts, const ble_bts_init_t * p_bts_init);
+
+/**@brief Function for handling the Bulk Transfer Service's BLE events.
+ *
+ * @param[in] p_bts       Bulk Transfer Service structure.
+ * @param[in] p_ble_evt   Event received from the SoftDevice.
+ */
+void ble_bts_on_ble_evt(ble_bts_t * p_bts, ble_evt_t * p_ble_evt);
+
+/**@brief Function for starting the GET requested with @ref BLE_BTS_EVT_TX_REQUEST.
+ *
+ * Can be called from the event handler or later.
+ *
+ * @param[in] p_bts     Bulk Transfer Service structure.
+ * @param[in] size      Size of the object.
+ *
+ * @retval NRF_SUCCESS             If the transfer was started.
+ * @retval NRF_ERROR_INVALID_STATE If no GET is pending.
+ * @retval NRF_ERROR_INVALID_PARAM If the requested offset is past @p size. The request is rejected.
+ * @retval NRF_ERROR_DATA_SIZE     If the object needs more than 65535 packets. The request is rejected.
+ */
+uint32_t ble_bts_send_start(ble_bts_t * p_bts, uint32_t size);
+
+/**@brief Function for aborting or rejecting a transfer.
+ *
+ * A rejected request is answered with @ref BLE_BTS_RESULT_REJECTED. A transfer in progress
+ * or paused is ended, and the peer is informed if connected.
+ *
+ * @param[in] p_bts     Bulk Transfer Service structure.
+ * @param[in] op        @ref BLE_BTS_OP_PUT or @ref BLE_BTS_OP_GET.
+ *
+ * @retval NRF_SUCCESS             If the transfer was aborted.
+ * @retval NRF_ERROR_INVALID_STATE If there is no such transfer.
+ */
+uint32_t ble_bts_abort(ble_bts_t * p_bts, ble_bts_op_t op);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLE_BTS_H__
+
+/** @} */
@@ -0,0 +1,22 @@
+/**
+ *
+ * @defgroup ble_bts_config Bulk Transfer Service configuration
+ * @{
+ * @ingroup ble_bts
+ */
+/** @brief Enable Bulk Transfer Service.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_BTS_ENABLED
+
+/** @brief Largest number of packets in flight, at most 32
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_BTS_CONFIG_WINDOW_MAX
+
+
+/** @} */
@@ -47,9 +47,12 @@ static gls_state_t      m_gls_state;                                   /**< Curr
 static uint16_t         m_next_seq_num;                                /**< Sequence number of the next database record. */
 static uint8_t          m_racp_proc_operator;                          /**< Operator of current request. */
 static uint16_t         m_racp_proc_seq_num;                           /**< Sequence number of current request. */
-static uint8_t          m_racp_proc_record_ndx;                        /**< Current record index. */
-static uint8_t          m_racp_proc_records_reported;                  /**< Number of reported records. */
-static uint8_t          m_racp_proc_records_reported_since_txcomplete; /**< Number of reported records since last TX_COMPLETE event. */
+static uint16_t         m_racp_proc_record_ndx;                        /**< Index of the next record to be read from the database. */
+static uint16_t         m_racp_proc_record_end;                        /**< Index after the last record of the current request. */
+static uint16_t         m_racp_proc_records_reported;                  /**< Number of reported records. */
+static uint8_t          m_racp_proc_tx_pending;                        /**< Number of reported records not yet confirmed by a TX_COMPLETE event. */
+static bool             m_racp_proc_rec_ready;                         /**< m_racp_proc_rec holds a record that is still to be sent. */
+static ble_gls_rec_t    m_racp_proc_rec;                               /**< Record read ahead of the next notification. */
 static ble_racp_value_t m_pending_racp_response;                       /**< RACP response to be sent. */
 static uint8_t          m_pending_racp_response_operand[2];            /**< Operand of RACP response to be sent. */
 
@@ -344,7 +347,7 @@ uint32_t ble_gls_init(ble_gls_t * p_gls, const ble_gls_init_t * p_gls_init)
 
     // Initialize global variables
     state_set(STATE_NO_COMM);
-    m_racp_proc_records_reported_since_txcomplete = 0;
+    m_racp_proc_tx_pending = 0;
 
     // Add service
     BLE_UUID_BLE_ASSIGN(ble_uuid, BLE_UUID_GLUCOSE_SERVICE);
@@ -396,7 +399,7 @@ static void racp_send(ble_gls_t * p_gls, ble_racp_value_t * p_racp_val)
     if (
         (m_gls_state != STATE_RACP_RESPONSE_PENDING)
         &&
-        (m_racp_proc_records_reported_since_txcomplete > 0)
+        (m_racp_proc_tx_pending > 0)
        )
     {
         state_set(STATE_RACP_RESPONSE_PENDING);
@@ -510,7 +513,7 @@ static uint32_t glucose_meas_send(ble_gls_t * p_gls, ble_gls_rec_t * p_rec)
         {
             // Measurement successfully sent
             m_racp_proc_records_reported++;
-            m_racp_proc_records_reported_since_txcomplete++;
+            m_racp_proc_tx_pending++;
         }
     }
 
@@ -518,125 +521,67 @@ static uint32_t glucose_meas_send(ble_gls_t * p_gls, ble_gls_rec_t * p_rec)
 }
 
 
-/**@brief Function for responding to the ALL operation.
+/**@brief Function for setting the range of database records of a REPORT RECORDS request.
  *
- * @param[in] p_gls  Service instance.
- *
- * @return NRF_SUCCESS on success, otherwise an error code.
+ * @details The range is fixed when the request is received. Records added to the database
+ *          during the procedure are not reported.
  */
-static uint32_t racp_report_records_all(ble_gls_t * p_gls)
+static void racp_report_records_range_set(void)
 {
     uint16_t total_records = ble_gls_db_num_records_get();
 
-    if (m_racp_proc_record_ndx >= total_records)
-    {
-        state_set(STATE_NO_COMM);
-    }
-    else
-    {
-        uint32_t      err_code;
-        ble_gls_rec_t rec;
-
-        err_code = ble_gls_db_record_get(m_racp_proc_record_ndx, &rec);
-        if (err_code != NRF_SUCCESS)
-        {
-            return err_code;
-        }
-
-        err_code = glucose_meas_send(p_gls, &rec);
-        if (err_code != NRF_SUCCESS)
-        {
-            return err_code;
-        }
-    }
-
-    return NRF_SUCCESS;
-}
-
-
-/**@brief Function for responding to the FIRST or the LAST operation.
- *
- * @param[in] p_gls  Service instance.
- *
- * @return  NRF_SUCCESS on success, otherwise an error code.
- */
-static uint32_t racp_report_records_first_last(ble_gls_t * p_gls)
-{
-    uint32_t      err_code;
-    ble_gls_rec_t rec;
-    uint16_t      total_records;
-
-    total_records = ble_gls_db_num_records_get();
+    m_racp_proc_record_ndx = 0;
+    m_racp_proc_record_end = total_records;
 
-    if ((m_racp_proc_records_reported != 0) || (total_records == 0))
+    if (total_records == 0)
     {
-        state_set(STATE_NO_COMM);
+        return;
     }
-    else
+
+    switch (m_racp_proc_operator)
     {
-        if (m_racp_proc_operator == RACP_OPERATOR_FIRST)
-        {
-            err_code = ble_gls_db_record_get(0, &rec);
-            if (err_code != NRF_SUCCESS)
-            {
-                return err_code;
-            }
-        }
-        else if (m_racp_proc_operator == RACP_OPERATOR_LAST)
-        {
-            err_code = ble_gls_db_record_get(total_records - 1, &rec);
-            if (err_code != NRF_SUCCESS)
-            {
-                return err_code;
-            }
-        }
+        case RACP_OPERATOR_FIRST:
+            m_racp_proc_record_end = 1;
+            break;
 
-        err_code = glucose_meas_send(p_gls, &rec);
-        if (err_code != NRF_SUCCESS)
-        {
-            return err_code;
-        }
-    }
+        case RACP_OPERATOR_LAST:
+            m_racp_proc_record_ndx = total_records - 1;
+            break;
 
-    return NRF_SUCCESS;
+        default:
+            // ALL and GREATER_OR_EQUAL. The filter is applied to each record.
+            break;
+    }
 }
 
 
-/**@brief Function for responding to the GREATER_OR_EQUAL operation.
+/**@brief Function for reading the next record to be reported from the database.
  *
- * @param[in] p_gls  Service instance.
+ * @param[out] p_found  true if a record was read, false if all records have been reported.
  *
  * @return NRF_SUCCESS on success, otherwise an error code.
  */
-static uint32_t racp_report_records_greater_or_equal(ble_gls_t * p_gls)
+static uint32_t racp_report_record_prefetch(bool * p_found)
 {
-    uint16_t total_records = ble_gls_db_num_records_get();
+    *p_found = false;
 
-    while (m_racp_proc_record_ndx < total_records)
+    while (m_racp_proc_record_ndx < m_racp_proc_record_end)
     {
-        uint32_t      err_code;
-        ble_gls_rec_t rec;
+        uint32_t err_code;
 
-        err_code = ble_gls_db_record_get(m_racp_proc_record_ndx, &rec);
+        err_code = ble_gls_db_record_get(m_racp_proc_record_ndx, &m_racp_proc_rec);
         if (err_code != NRF_SUCCESS)
         {
             return err_code;
         }
+        m_racp_proc_record_ndx++;
 
-        if (rec.meas.sequence_number >= m_racp_proc_seq_num)
+        if ((m_racp_proc_operator != RACP_OPERATOR_GREATER_OR_EQUAL) ||
+            (m_racp_proc_rec.meas.sequence_number >= m_racp_proc_seq_num))
         {
-            err_code = glucose_meas_send(p_gls, &rec);
-            if (err_code != NRF_SUCCESS)
-            {
-                return err_code;
-            }
+            *p_found = true;
             break;
         }
-        m_racp_proc_record_ndx++;
-    }
-    if (m_racp_proc_record_ndx == total_records)
-    {
-        state_set(STATE_NO_COMM);
     }
 
     return NRF_SUCCESS;
@@ -665,6 +610,11 @@ static void racp_report_records_completed(ble_gls_t * p_gls)
 
 
 /**@brief Function for the RACP report records procedure.
+ *
+ * @details Sends notifications until the SoftDevice has no more TX buffers, and is called again
+ *          on each TX_COMPLETE event to refill them. The record that could not be sent is kept,
+ *          so it is not read again from the database. An ABORT OPERATION request ends the
+ *          procedure by changing the state.
  *
  * @param[in] p_gls  Service instance.
  */
@@ -674,46 +624,31 @@ static void racp_report_records_procedure(ble_gls_t * p_gls)
 
     while (m_gls_state == STATE_RACP_PROC_ACTIVE)
     {
-        // Execute requested procedure
-        switch (m_racp_proc_operator)
+        if (!m_racp_proc_rec_ready)
         {
-            case RACP_OPERATOR_ALL:
-                err_code = racp_report_records_all(p_gls);
-                break;
-
-            case RACP_OPERATOR_FIRST:
-            case RACP_OPERATOR_LAST:
-                err_code = racp_report_records_first_last(p_gls);
-                break;
-
-            case RACP_OPERATOR_GREATER_OR_EQUAL:
-                err_code = racp_report_records_greater_or_equal(p_gls);
-                break;
-
-            default:
-                // Report error to application
-                if (p_gls->error_handler != NULL)
-                {
-                    p_gls->error_handler(NRF_ERROR_INTERNAL);
-                }
-
-                // Make sure state machine returns to the default state
+            err_code = racp_report_record_prefetch(&m_racp_proc_rec_ready);
+            if ((err_code == NRF_SUCCESS) && !m_racp_proc_rec_ready)
+            {
                 state_set(STATE_NO_COMM);
+                racp_report_records_completed(p_gls);
                 return;
+            }
+        }
+        else
+        {
+            err_code = NRF_SUCCESS;
+        }
+
+        if (err_code == NRF_SUCCESS)
+        {
+            err_code = glucose_meas_send(p_gls, &m_racp_proc_rec);
         }
 
         // Error handling
         switch (err_code)
         {
             case NRF_SUCCESS:
-                if (m_gls_state == STATE_RACP_PROC_ACTIVE)
-                {
-                    m_racp_proc_record_ndx++;
-                }
-                else
-                {
-                    racp_report_records_completed(p_gls);
-                }
+                m_racp_proc_rec_ready = false;
                 break;
 
             case BLE_ERROR_NO_TX_PACKETS:
@@ -869,10 +804,12 @@ static void report_records_request_execute(ble_gls_t * p_gls, ble_racp_value_t *
 
     state_set(STATE_RACP_PROC_ACTIVE);
 
-    m_racp_proc_record_ndx       = 0;
     m_racp_proc_operator         = p_racp_request->operator;
     m_racp_proc_records_reported = 0;
     m_racp_proc_seq_num          = seq_num;
+    m_racp_proc_rec_ready        = false;
+
+    racp_report_records_range_set();
 
     racp_report_records_procedure(p_gls);
 }
@@ -1160,16 +1097,21 @@ static void on_write(ble_gls_t * p_gls, ble_evt_t * p_ble_evt)
 
 /**@brief Function for handling the TX_COMPLETE event.
  *
- * @details Handles TX_COMPLETE events from the BLE stack.
+ * @details Handles TX_COMPLETE events from the BLE stack. The event reports the number of
+ *          packets sent, so that many TX buffers are free again. A pending RACP response is
+ *          sent once all reported records are out.
  *
  * @param[in] p_gls      Glucose Service structure.
  * @param[in] p_ble_evt  Event received from the BLE stack.
  */
 static void on_tx_complete(ble_gls_t * p_gls, ble_evt_t * p_ble_evt)
 {
-    m_racp_proc_records_reported_since_txcomplete = 0;
+    uint8_t count = p_ble_evt->evt.common_evt.params.tx_complete.count;
+
+    // The count includes packets of other services, so do not go below zero.
+    m_racp_proc_tx_pending = (count < m_racp_proc_tx_pending) ? (m_racp_proc_tx_pending - count) : 0;
 
-    if (m_gls_state == STATE_RACP_RESPONSE_PENDING)
+    if ((m_gls_state == STATE_RACP_RESPONSE_PENDING) && (m_racp_proc_tx_pending == 0))
     {
         racp_send(p_gls, &m_pending_racp_response);
     }
@@ -1241,7 +1183,8 @@ void ble_gls_on_ble_evt(ble_gls_t * p_gls, ble_evt_t * p_ble_evt)
             break;
 
         case BLE_GAP_EVT_DISCONNECTED:
-            p_gls->conn_handle = BLE_CONN_HANDLE_INVALID;
+            p_gls->conn_handle     = BLE_CONN_HANDLE_INVALID;
+            m_racp_proc_tx_pending = 0;
             break;
 
         case BLE_GATTS_EVT_WRITE:
@@ -12,6 +12,93 @@
 #if NRF_MODULE_ENABLED(BLE_GLS)
 #include "ble_gls_db.h"
 
+#if NRF_MODULE_ENABLED(BLE_GLS_DB_TS_STORE)
+#include "ts_store.h"
+
+TS_STORE_DEF(m_gls_store,
+             BLE_GLS_DB_FILE_ID,
+             BLE_GLS_DB_RECORD_KEY,
+             sizeof(ble_gls_rec_t),
+             BLE_GLS_DB_BLOCK_RECORDS,
+             BLE_GLS_DB_MAX_BLOCKS,
+             NULL);
+
+
+/**@brief Function for converting the base time of a measurement to seconds since 2000,
+ *        assuming months of 31 days. The result keeps the order of the dates.
+ */
+static uint32_t base_time_key(ble_date_time_t const * p_time)
+{
+    uint32_t years = (p_time->year > 2000) ? (p_time->year - 2000) : 0;
+
+    return ((((years * 12 + p_time->month) * 31 + p_time->day) * 24 + p_time->hours) * 60
+            + p_time->minutes) * 60 + p_time->seconds;
+}
+
+
+/**@brief Function for getting the number of records that can be addressed by an index.
+ *
+ * @details The indexes of this API are 8 bits, so only the newest records are visible.
+ */
+static uint16_t visible_records(void)
+{
+    return (uint16_t)MIN(ts_store_count(&m_gls_store), UINT8_MAX + 1);
+}
+
+
+uint32_t ble_gls_db_init(void)
+{
+    return ts_store_init(&m_gls_store);
+}
+
+
+uint16_t ble_gls_db_num_records_get(void)
+{
+    return visible_records();
+}
+
+
+uint32_t ble_gls_db_record_get(uint8_t rec_ndx, ble_gls_rec_t * p_rec)
+{
+    uint16_t num_records = visible_records();
+
+    if (rec_ndx >= num_records)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    return ts_store_read(&m_gls_store,
+                         ts_store_next_seq(&m_gls_store) - num_records + rec_ndx,
+                         NULL,
+                         p_rec);
+}
+
+
+uint32_t ble_gls_db_record_add(ble_gls_rec_t * p_rec)
+{
+    return ts_store_append(&m_gls_store, base_time_key(&p_rec->meas.base_time), p_rec, NULL);
+}
+
+
+uint32_t ble_gls_db_record_delete(uint8_t rec_ndx)
+{
+    uint16_t num_records = visible_records();
+
+    if (rec_ndx >= num_records)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    if (num_records != ts_store_count(&m_gls_store) || (rec_ndx != 0))
+    {
+        // Only the oldest records can be deleted from the store.
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+
+    return ts_store_delete_before(&m_gls_store, ts_store_first_seq(&m_gls_store) + 1);
+}
+
+#else
+
 
 typedef struct
 {
@@ -111,4 +198,6 @@ uint32_t ble_gls_db_record_delete(uint8_t rec_ndx)
 
     return NRF_SUCCESS;
 }
+
+#endif // NRF_MODULE_ENABLED(BLE_GLS_DB_TS_STORE)
 #endif // NRF_MODULE_ENABLED(BLE_GLS)
@@ -36,6 +36,22 @@ extern "C" {
 
 #define BLE_GLS_DB_MAX_RECORDS      20
 
+/* Settings of the flash database, used when BLE_GLS_DB_TS_STORE_ENABLED is set in sdk_config.h.
+ * The records are then kept in a @ref ts_store. These defines should be defined in the
+ * sdk_config.h file to override the defaults. */
+#ifndef BLE_GLS_DB_FILE_ID
+#define BLE_GLS_DB_FILE_ID          0x6C57      /**< FDS file of the records. */
+#endif
+#ifndef BLE_GLS_DB_RECORD_KEY
+#define BLE_GLS_DB_RECORD_KEY       0x0001      /**< FDS record key of the blocks of records. */
+#endif
+#ifndef BLE_GLS_DB_BLOCK_RECORDS
+#define BLE_GLS_DB_BLOCK_RECORDS    16          /**< Records in a block. */
+#endif
+#ifndef BLE_GLS_DB_MAX_BLOCKS
+#define BLE_GLS_DB_MAX_BLOCKS       64          /**< Blocks in the index. */
+#endif
+
 /**@brief Function for initializing the glucose record database.
  *
  * @details This call initializes the database holding glucose records.
@@ -12,5 +12,13 @@
  */
 #define BLE_GLS_ENABLED
 
+/** @brief Keep the glucose records in flash, in a time-series record store.
+ *
+ *  Set to 1 to activate. Requires TS_STORE_ENABLED and FDS.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_GLS_DB_TS_STORE_ENABLED
+
 
 /** @} */
@@ -19,6 +19,7 @@
 #include "ble_hids.h"
 #include <string.h>
 #include "app_error.h"
+#include "app_timer.h"
 #include "ble_srv_common.h"
 
 
@@ -106,6 +107,161 @@ static void on_disconnect(ble_hids_t * p_hids, ble_evt_t * p_ble_evt)
 {
     UNUSED_PARAMETER(p_ble_evt);
     p_hids->conn_handle = BLE_CONN_HANDLE_INVALID;
+
+    // Drop the queued reports, they are not sent on the next connection.
+    p_hids->rep_queue.stats.dropped += p_hids->rep_queue.count;
+    p_hids->rep_queue.count          = 0;
+    p_hids->rep_queue.tx_count       = 0;
+}
+
+
+/**@brief Function for encoding a queued report.
+ *
+ * @param[in]   p_hids      HID Service structure.
+ * @param[in]   p_entry     Queued report.
+ * @param[out]  p_data      Encoded report.
+ *
+ * @return      Length of the encoded report.
+ */
+static uint16_t rep_queue_entry_encode(ble_hids_t                       * p_hids,
+                                       ble_hids_rep_queue_entry_t const * p_entry,
+                                       uint8_t                          * p_data)
+{
+    if (!p_entry->is_mouse)
+    {
+        memcpy(p_data, p_entry->rep.data, p_entry->len);
+        return p_entry->len;
+    }
+
+    if (p_entry->value_handle == p_hids->boot_mouse_inp_rep_handles.value_handle)
+    {
+        p_data[0] = p_entry->rep.mouse.buttons;
+        p_data[1] = (uint8_t)p_entry->rep.mouse.x_delta;
+        p_data[2] = (uint8_t)p_entry->rep.mouse.y_delta;
+        return BOOT_MOUSE_INPUT_REPORT_MIN_SIZE;
+    }
+
+    return p_hids->mouse_rep_encode(p_entry->rep.mouse.buttons,
+                                    p_entry->rep.mouse.x_delta,
+                                    p_entry->rep.mouse.y_delta,
+                                    p_data);
+}
+
+
+/**@brief Function for sending the queued reports until the SoftDevice has no transmit buffers.
+ *
+ * @param[in]   p_hids      HID Service structure.
+ */
+static void rep_queue_process(ble_hids_t * p_hids)
+{
+    ble_hids_rep_queue_t * p_queue = &p_hids->rep_queue;
+
+    while (p_queue->count > 0)
+    {
+        ble_hids_rep_queue_entry_t * p_entry = &p_queue->entries[p_queue->rp];
+        uint8_t                      data[BLE_HIDS_CONFIG_REP_QUEUE_DATA_LEN];
+        uint16_t                     len;
+        uint16_t                     hvx_len;
+        ble_gatts_hvx_params_t       hvx_params;
+        uint32_t                     err_code;
+
+        len     = rep_queue_entry_encode(p_hids, p_entry, data);
+        hvx_len = len;
+
+        memset(&hvx_params, 0, sizeof(hvx_params));
+
+        hvx_params.handle = p_entry->value_handle;
+        hvx_params.type   = BLE_GATT_HVX_NOTIFICATION;
+        hvx_params.offset = 0;
+        hvx_params.p_len  = &hvx_len;
+        hvx_params.p_data = data;
+
+        err_code = sd_ble_gatts_hvx(p_hids->conn_handle, &hvx_params);
+        if (err_code == BLE_ERROR_NO_TX_PACKETS)
+        {
+            // Wait for TX_COMPLETE event to resume transmission.
+            return;
+        }
+
+        if (err_code == NRF_SUCCESS)
+        {
+            // Keep the queue time until the TX_COMPLETE event. If more reports are in flight than
+            // the queue holds, the oldest time is dropped.
+            if (p_queue->tx_count == BLE_HIDS_CONFIG_REP_QUEUE_SIZE)
+            {
+                p_queue->tx_rp = (p_queue->tx_rp + 1) % BLE_HIDS_CONFIG_REP_QUEUE_SIZE;
+                p_queue->tx_count--;
+            }
+            p_queue->tx_times[(p_queue->tx_rp + p_queue->tx_count) % BLE_HIDS_CONFIG_REP_QUEUE_SIZE] =
+                p_entry->queue_time;
+            p_queue->tx_count++;
+
+            if (hvx_len != len)
+            {
+                err_code = NRF_ERROR_DATA_SIZE;
+            }
+        }
+        else
+        {
+            p_queue->stats.dropped++;
+        }
+
+        // Notifications not enabled by the peer are not reported as errors.
+        if ((err_code != NRF_SUCCESS) &&
+            (err_code != NRF_ERROR_INVALID_STATE) &&
+            (err_code != BLE_ERROR_GATTS_SYS_ATTR_MISSING) &&
+            (p_hids->error_handler != NULL))
+        {
+            p_hids->error_handler(err_code);
+        }
+
+        p_queue->rp = (p_queue->rp + 1) % BLE_HIDS_CONFIG_REP_QUEUE_SIZE;
+        p_queue->count--;
+    }
+}
+
+
+/**@brief Function for handling the TX_COMPLETE event.
+ *
+ * @details The event reports the number of packets sent. They are taken as the oldest reports in
+ *          flight, to measure the latency, and the queue is refilled. Packets of other services on
+ *          the same connection are counted too, so the latency is a lower bound when they are
+ *          sent at the same time.
+ *
+ * @param[in]   p_hids      HID Service structure.
+ * @param[in]   p_ble_evt   Event received from the BLE stack.
+ */
+static void on_tx_complete(ble_hids_t * p_hids, ble_evt_t * p_ble_evt)
+{
+    ble_hids_rep_queue_t * p_queue = &p_hids->rep_queue;
+    uint8_t                count   = p_ble_evt->evt.common_evt.params.tx_complete.count;
+    uint32_t               now;
+
+    if (p_queue->tx_count > 0)
+    {
+        now = app_timer_cnt_get();
+
+        while ((count > 0) && (p_queue->tx_count > 0))
+        {
+            uint32_t latency;
+
+            (void)app_timer_cnt_diff_compute(now, p_queue->tx_times[p_queue->tx_rp], &latency);
+
+            p_queue->stats.sent++;
+            p_queue->stats.latency_last  = latency;
+            p_queue->stats.latency_sum  += latency;
+            if (latency > p_queue->stats.latency_max)
+            {
+                p_queue->stats.latency_max = latency;
+            }
+
+            p_queue->tx_rp = (p_queue->tx_rp + 1) % BLE_HIDS_CONFIG_REP_QUEUE_SIZE;
+            p_queue->tx_count--;
+            count--;
+        }
+    }
+
+    rep_queue_process(p_hids);
 }
 
 
@@ -415,6 +571,11 @@ void ble_hids_on_ble_evt(ble_hids_t * p_hids, ble_evt_t * p_ble_evt)
         case BLE_GATTS_EVT_RW_AUTHORIZE_REQUEST:
             on_rw_authorize_request(p_hids, p_ble_evt);
             break;
+
+        case BLE_EVT_TX_COMPLETE:
+            on_tx_complete(p_hids, p_ble_evt);
+            break;
+
         default:
             // No implementation needed.
             break;
@@ -1107,6 +1268,10 @@ uint32_t ble_hids_init(ble_hids_t * p_hids, const ble_hids_init_t * p_hids_init)
     p_hids->outp_rep_count    = p_hids_init->outp_rep_count;
     p_hids->feature_rep_count = p_hids_init->feature_rep_count;
     p_hids->conn_handle       = BLE_CONN_HANDLE_INVALID;
+    p_hids->mouse_rep_encode  = p_hids_init->mouse_rep_encode;
+    p_hids->mouse_delta_max   = p_hids_init->mouse_delta_max;
+
+    memset(&p_hids->rep_queue, 0, sizeof(p_hids->rep_queue));
 
     // Add service.
     BLE_UUID_BLE_ASSIGN(ble_uuid, BLE_UUID_HUMAN_INTERFACE_DEVICE_SERVICE);
@@ -1374,6 +1539,182 @@ uint32_t ble_hids_outp_rep_get(ble_hids_t * p_hids,
                                   &gatts_value);
 }
 
+
+/**@brief Function for getting the handle of an Input Report characteristic of the report queue.
+ *
+ * @param[in]   p_hids      HID Service structure.
+ * @param[in]   rep_index   Index of the characteristic, or one of the boot report indexes.
+ *
+ * @return      Value handle, or BLE_GATT_HANDLE_INVALID if the characteristic does not exist.
+ */
+static uint16_t rep_queue_handle_get(ble_hids_t * p_hids, uint8_t rep_index)
+{
+    if (rep_index == BLE_HIDS_BOOT_KB_REP_INDEX)
+    {
+        return p_hids->boot_kb_inp_rep_handles.value_handle;
+    }
+    if (rep_index == BLE_HIDS_BOOT_MOUSE_REP_INDEX)
+    {
+        return p_hids->boot_mouse_inp_rep_handles.value_handle;
+    }
+    if (rep_index < p_hids->inp_rep_count)
+    {
+        return p_hids->inp_rep_array[rep_index].char_handles.value_handle;
+    }
+    return BLE_GATT_HANDLE_INVALID;
+}
+
+
+/**@brief Function for adding an entry at the end of the report queue.
+ *
+ * @param[in]   p_hids      HID Service structure.
+ *
+ * @return      The entry, or NULL if the queue is full.
+ */
+static ble_hids_rep_queue_entry_t * rep_queue_entry_add(ble_hids_t * p_hids)
+{
+    ble_hids_rep_queue_t       * p_queue = &p_hids->rep_queue;
+    ble_hids_rep_queue_entry_t * p_entry;
+
+    if (p_queue->count == BLE_HIDS_CONFIG_REP_QUEUE_SIZE)
+    {
+        p_queue->stats.dropped++;
+        return NULL;
+    }
+
+    p_entry = &p_queue->entries[(p_queue->rp + p_queue->count) % BLE_HIDS_CONFIG_REP_QUEUE_SIZE];
+    memset(p_entry, 0, sizeof(*p_entry));
+    p_entry->queue_time = app_timer_cnt_get();
+
+    p_queue->count++;
+    p_queue->stats.queued++;
+
+    return p_entry;
+}
+
+
+uint32_t ble_hids_inp_rep_queue(ble_hids_t * p_hids,
+                                uint8_t      rep_index,
+                                uint16_t     len,
+                                uint8_t    * p_data)
+{
+    ble_hids_rep_queue_entry_t * p_entry;
+    uint16_t                     value_handle;
+
+    if (p_hids->conn_handle == BLE_CONN_HANDLE_INVALID)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    value_handle = rep_queue_handle_get(p_hids, rep_index);
+    if ((value_handle == BLE_GATT_HANDLE_INVALID) || (rep_index == BLE_HIDS_BOOT_MOUSE_REP_INDEX))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (len > BLE_HIDS_CONFIG_REP_QUEUE_DATA_LEN)
+    {
+        return NRF_ERROR_DATA_SIZE;
+    }
+
+    p_entry = rep_queue_entry_add(p_hids);
+    if (p_entry == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    p_entry->value_handle = value_handle;
+    p_entry->len          = (uint8_t)len;
+    memcpy(p_entry->rep.data, p_data, len);
+
+    rep_queue_process(p_hids);
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ble_hids_mouse_rep_queue(ble_hids_t * p_hids,
+                                  uint8_t      rep_index,
+                                  uint8_t      buttons,
+                                  int16_t      x_delta,
+                                  int16_t      y_delta)
+{
+    ble_hids_rep_queue_t       * p_queue = &p_hids->rep_queue;
+    ble_hids_rep_queue_entry_t * p_entry;
+    uint16_t                     value_handle;
+    int16_t                      delta_max;
+
+    if (p_hids->conn_handle == BLE_CONN_HANDLE_INVALID)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    value_handle = rep_queue_handle_get(p_hids, rep_index);
+    if ((value_handle == BLE_GATT_HANDLE_INVALID) ||
+        (rep_index == BLE_HIDS_BOOT_KB_REP_INDEX) ||
+        ((rep_index != BLE_HIDS_BOOT_MOUSE_REP_INDEX) && (p_hids->mouse_rep_encode == NULL)))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if ((rep_index == BLE_HIDS_BOOT_MOUSE_REP_INDEX) || (p_hids->mouse_delta_max == 0))
+    {
+        delta_max = INT8_MAX;
+    }
+    else
+    {
+        delta_max = p_hids->mouse_delta_max;
+    }
+
+    x_delta = MAX(MIN(x_delta, delta_max), -delta_max);
+    y_delta = MAX(MIN(y_delta, delta_max), -delta_max);
+
+    // Merge into the last queued movement while the link is backlogged. A change of buttons is
+    // never merged, so no click is lost.
+    if (p_queue->count > 0)
+    {
+        p_entry = &p_queue->entries[(p_queue->rp + p_queue->count - 1) % BLE_HIDS_CONFIG_REP_QUEUE_SIZE];
+
+        if (p_entry->is_mouse &&
+            (p_entry->value_handle == value_handle) &&
+            (p_entry->rep.mouse.buttons == buttons))
+        {
+            int32_t x_sum = p_entry->rep.mouse.x_delta + x_delta;
+            int32_t y_sum = p_entry->rep.mouse.y_delta + y_delta;
+
+            if ((x_sum <= delta_max) && (x_sum >= -delta_max) &&
+                (y_sum <= delta_max) && (y_sum >= -delta_max))
+            {
+                p_entry->rep.mouse.x_delta = (int16_t)x_sum;
+                p_entry->rep.mouse.y_delta = (int16_t)y_sum;
+                p_queue->stats.merged++;
+                return NRF_SUCCESS;
+            }
+        }
+    }
+
+    p_entry = rep_queue_entry_add(p_hids);
+    if (p_entry == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    p_entry->value_handle      = value_handle;
+    p_entry->is_mouse          = true;
+    p_entry->rep.mouse.buttons = buttons;
+    p_entry->rep.mouse.x_delta = x_delta;
+    p_entry->rep.mouse.y_delta = y_delta;
+
+    rep_queue_process(p_hids);
+
+    return NRF_SUCCESS;
+}
+
+
+void ble_hids_rep_queue_stats_get(ble_hids_t const * p_hids, ble_hids_rep_queue_stats_t * p_stats)
+{
+    *p_stats = p_hids->rep_queue.stats;
+}
+
 /**
   @}
 */
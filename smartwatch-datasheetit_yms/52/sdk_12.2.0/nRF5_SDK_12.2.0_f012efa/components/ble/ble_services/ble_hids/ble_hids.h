@@ -28,6 +28,15 @@
  *          If an event handler is supplied by the application, the Human Interface Device Service
  *          will generate Human Interface Device Service events to the application.
  *
+ *          Input reports can also be passed to a report queue with the ble_hids_xx_rep_queue()
+ *          functions. Queued reports are sent in order as soon as the SoftDevice has transmit
+ *          buffers, and are refilled on each @ref BLE_EVT_TX_COMPLETE event, so the application
+ *          does not need to retry on @ref BLE_ERROR_NO_TX_PACKETS. While the link is backlogged,
+ *          relative mouse movements with the same button state are merged into the last queued
+ *          report, so the pointer position is kept without growing the queue. Key reports are never
+ *          merged. The time from queuing to transmission is measured, see
+ *          @ref ble_hids_rep_queue_stats_t.
+ *
  * @note The application must propagate BLE stack events to the Human Interface Device Service
  *       module by calling ble_hids_on_ble_evt() from the @ref softdevice_handler callback.
  *
@@ -43,6 +52,7 @@
 #include <stdbool.h>
 #include "ble.h"
 #include "ble_srv_common.h"
+#include "sdk_config.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -66,6 +76,26 @@ extern "C" {
 #define HID_INFO_FLAG_REMOTE_WAKE_MSK           0x01
 #define HID_INFO_FLAG_NORMALLY_CONNECTABLE_MSK  0x02
 
+/** @brief Number of input reports in the report queue.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_HIDS_CONFIG_REP_QUEUE_SIZE
+#define BLE_HIDS_CONFIG_REP_QUEUE_SIZE          8
+#endif
+
+/** @brief Maximum length of a queued input report.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_HIDS_CONFIG_REP_QUEUE_DATA_LEN
+#define BLE_HIDS_CONFIG_REP_QUEUE_DATA_LEN      8
+#endif
+
+// Report indexes of the boot reports, for the report queue
+#define BLE_HIDS_BOOT_KB_REP_INDEX              0xFE
+#define BLE_HIDS_BOOT_MOUSE_REP_INDEX           0xFF
+
 /**@brief HID Service characteristic id. */
 typedef struct
 {
@@ -168,6 +198,64 @@ typedef struct
     ble_srv_security_mode_t       security_mode;    /**< Security mode for the HID Service Report Map characteristic. */
 } ble_hids_rep_map_init_t;
 
+/**@brief Function for encoding a mouse movement into an Input Report, for the report queue.
+ *
+ * @param[in]   buttons     State of mouse buttons.
+ * @param[in]   x_delta     Horizontal movement.
+ * @param[in]   y_delta     Vertical movement.
+ * @param[out]  p_data      Report, of up to @ref BLE_HIDS_CONFIG_REP_QUEUE_DATA_LEN bytes.
+ *
+ * @return      Length of the report.
+ */
+typedef uint16_t (*ble_hids_mouse_rep_encode_t) (uint8_t   buttons,
+                                                 int16_t   x_delta,
+                                                 int16_t   y_delta,
+                                                 uint8_t * p_data);
+
+/**@brief Report queue entry. */
+typedef struct
+{
+    uint16_t                      value_handle;     /**< Handle of the Input Report characteristic. */
+    uint8_t                       is_mouse;         /**< TRUE if the entry is a mouse movement, encoded when it is sent. */
+    uint8_t                       len;              /**< Length of the report (not used for mouse movements). */
+    uint32_t                      queue_time;       /**< Time the report was queued, in RTC1 ticks of @ref app_timer. */
+    union
+    {
+        uint8_t                   data[BLE_HIDS_CONFIG_REP_QUEUE_DATA_LEN]; /**< Report. */
+        struct
+        {
+            int16_t               x_delta;          /**< Horizontal movement. */
+            int16_t               y_delta;          /**< Vertical movement. */
+            uint8_t               buttons;          /**< State of mouse buttons. */
+        } mouse;                                    /**< Mouse movement. */
+    } rep;
+} ble_hids_rep_queue_entry_t;
+
+/**@brief Report queue statistics. Latencies are from queuing to the @ref BLE_EVT_TX_COMPLETE
+ *        event of the notification, in RTC1 ticks of @ref app_timer. */
+typedef struct
+{
+    uint32_t                      queued;           /**< Reports queued. */
+    uint32_t                      merged;           /**< Mouse movements merged into a queued report. */
+    uint32_t                      dropped;          /**< Reports dropped because the queue was full or the report could not be sent. */
+    uint32_t                      sent;             /**< Reports confirmed by a TX_COMPLETE event. */
+    uint32_t                      latency_last;     /**< Latency of the last report. */
+    uint32_t                      latency_max;      /**< Largest latency. */
+    uint32_t                      latency_sum;      /**< Sum of the latencies, for the average over @p sent. */
+} ble_hids_rep_queue_stats_t;
+
+/**@brief Input report queue. */
+typedef struct
+{
+    ble_hids_rep_queue_entry_t    entries[BLE_HIDS_CONFIG_REP_QUEUE_SIZE];      /**< Reports waiting for a transmit buffer. */
+    uint32_t                      tx_times[BLE_HIDS_CONFIG_REP_QUEUE_SIZE];     /**< Queue times of the reports given to the SoftDevice, waiting for TX_COMPLETE. */
+    uint8_t                       rp;                                           /**< Index of the oldest entry. */
+    uint8_t                       count;                                        /**< Number of entries. */
+    uint8_t                       tx_rp;                                        /**< Index of the oldest entry of tx_times. */
+    uint8_t                       tx_count;                                     /**< Number of entries of tx_times. */
+    ble_hids_rep_queue_stats_t    stats;                                        /**< Statistics. */
+} ble_hids_rep_queue_t;
+
 /**@brief HID Report characteristic structure. */
 typedef struct
 {
@@ -198,6 +286,8 @@ typedef struct
     ble_srv_cccd_security_mode_t  security_mode_boot_mouse_inp_rep;             /**< Security settings for HID service Mouse input report attribute */
     ble_srv_cccd_security_mode_t  security_mode_boot_kb_inp_rep;                /**< Security settings for HID service Keyboard input report attribute */
     ble_srv_security_mode_t       security_mode_boot_kb_outp_rep;               /**< Security settings for HID service Keyboard output report attribute */
+    ble_hids_mouse_rep_encode_t   mouse_rep_encode;                             /**< Encoder of the mouse movements queued on Input Reports, NULL if only the Boot Mouse Input Report is queued. */
+    int16_t                       mouse_delta_max;                              /**< Largest movement of an encoded Input Report, for the merging of queued movements. 0 for the Boot Mouse Input Report range. */
 } ble_hids_init_t;
 
 /**@brief HID Service structure. This contains various status information for the service. */
@@ -221,6 +311,9 @@ struct ble_hids_s
     ble_gatts_char_handles_t      hid_information_handles;                      /**< Handles related to the Report Map characteristic. */
     ble_gatts_char_handles_t      hid_control_point_handles;                    /**< Handles related to the Report Map characteristic. */
     uint16_t                      conn_handle;                                  /**< Handle of the current connection (as provided by the BLE stack, is BLE_CONN_HANDLE_INVALID if not in a connection). */
+    ble_hids_mouse_rep_encode_t   mouse_rep_encode;                             /**< Encoder of the queued mouse movements. */
+    int16_t                       mouse_delta_max;                              /**< Largest movement of an encoded Input Report. */
+    ble_hids_rep_queue_t          rep_queue;                                    /**< Input report queue. */
 };
 
 /**@brief Function for initializing the HID Service.
@@ -313,6 +406,61 @@ uint32_t ble_hids_outp_rep_get(ble_hids_t * p_hids,
                                uint8_t      offset,
                                uint8_t *    p_outp_rep);
 
+/**@brief Function for queuing an Input Report.
+ *
+ * @details The report is sent after the reports queued before it. It is copied, so the data can
+ *          be reused when the function returns.
+ *
+ * @param[in]   p_hids       HID Service structure.
+ * @param[in]   rep_index    Index of the characteristic (corresponding to the index in
+ *                           ble_hids_t.inp_rep_array as passed to ble_hids_init()), or
+ *                           @ref BLE_HIDS_BOOT_KB_REP_INDEX.
+ * @param[in]   len          Length of data to be sent.
+ * @param[in]   p_data       Pointer to data to be sent.
+ *
+ * @retval      NRF_SUCCESS              If the report was queued.
+ * @retval      NRF_ERROR_INVALID_STATE  If not in a connection.
+ * @retval      NRF_ERROR_INVALID_PARAM  If the report index is invalid.
+ * @retval      NRF_ERROR_DATA_SIZE      If the report is longer than
+ *                                       @ref BLE_HIDS_CONFIG_REP_QUEUE_DATA_LEN.
+ * @retval      NRF_ERROR_NO_MEM         If the queue is full.
+ */
+uint32_t ble_hids_inp_rep_queue(ble_hids_t * p_hids,
+                                uint8_t      rep_index,
+                                uint16_t     len,
+                                uint8_t *    p_data);
+
+/**@brief Function for queuing a mouse movement.
+ *
+ * @details If the last queued report, not yet sent, is a movement on the same characteristic
+ *          with the same button state, the movement is added to it.
+ *
+ * @param[in]   p_hids       HID Service structure.
+ * @param[in]   rep_index    Index of the Input Report characteristic, encoded with
+ *                           ble_hids_init_t.mouse_rep_encode, or @ref BLE_HIDS_BOOT_MOUSE_REP_INDEX.
+ * @param[in]   buttons      State of mouse buttons.
+ * @param[in]   x_delta      Horizontal movement.
+ * @param[in]   y_delta      Vertical movement.
+ *
+ * @retval      NRF_SUCCESS              If the movement was queued or merged.
+ * @retval      NRF_ERROR_INVALID_STATE  If not in a connection.
+ * @retval      NRF_ERROR_INVALID_PARAM  If the report index is invalid, or there is no encoder
+ *                                       for Input Reports.
+ * @retval      NRF_ERROR_NO_MEM         If the queue is full.
+ */
+uint32_t ble_hids_mouse_rep_queue(ble_hids_t * p_hids,
+                                  uint8_t      rep_index,
+                                  uint8_t      buttons,
+                                  int16_t      x_delta,
+                                  int16_t      y_delta);
+
+/**@brief Function for getting the statistics of the report queue.
+ *
+ * @param[in]   p_hids       HID Service structure.
+ * @param[out]  p_stats      Statistics.
+ */
+void ble_hids_rep_queue_stats_get(ble_hids_t const * p_hids, ble_hids_rep_queue_stats_t * p_stats);
+
 
 #ifdef __cplusplus
 }
@@ -12,5 +12,17 @@
  */
 #define BLE_HIDS_ENABLED
 
+/** @brief Number of input reports in the report queue.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_HIDS_CONFIG_REP_QUEUE_SIZE
+
+/** @brief Maximum length of a queued input report.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_HIDS_CONFIG_REP_QUEUE_DATA_LEN
+
 
 /** @} */
@@ -20,6 +20,7 @@
 #include <string.h>
 #include "ble_l2cap.h"
 #include "ble_srv_common.h"
+#include "app_util_platform.h"
 
 
 #define OPCODE_LENGTH 1                                                              /**< Length of opcode inside Heart Rate Measurement packet. */
@@ -299,6 +300,27 @@ static uint32_t body_sensor_location_char_add(ble_hrs_t * p_hrs, const ble_hrs_i
 }
 
 
+#if NRF_MODULE_ENABLED(BLE_HVX_COALESCE)
+/**@brief Function for sending the coalesced heart rate measurement before a radio event.
+ *
+ * @param[in]   p_context   Heart Rate Service structure.
+ */
+static void on_coalesce_flush(void * p_context)
+{
+    ble_hrs_t * p_hrs = (ble_hrs_t *)p_context;
+    uint32_t    err_code;
+
+    err_code = ble_hrs_heart_rate_measurement_send(p_hrs, p_hrs->coalesced_heart_rate);
+    if ((err_code == BLE_ERROR_NO_TX_PACKETS) ||
+        ((err_code == NRF_SUCCESS) && (p_hrs->rr_interval_count != 0)))
+    {
+        // Send the rest before the next radio event.
+        ble_hvx_coalesce_request(&p_hrs->coalesce);
+    }
+}
+#endif
+
+
 uint32_t ble_hrs_init(ble_hrs_t * p_hrs, const ble_hrs_init_t * p_hrs_init)
 {
     uint32_t   err_code;
@@ -312,6 +334,14 @@ uint32_t ble_hrs_init(ble_hrs_t * p_hrs, const ble_hrs_init_t * p_hrs_init)
     p_hrs->rr_interval_count           = 0;
     p_hrs->max_hrm_len                 = INIT_MAX_HRM_LEN;
 
+#if NRF_MODULE_ENABLED(BLE_HVX_COALESCE)
+    err_code = ble_hvx_coalesce_register(&p_hrs->coalesce, on_coalesce_flush, p_hrs);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+#endif
+
     // Add service
     BLE_UUID_BLE_ASSIGN(ble_uuid, BLE_UUID_HEART_RATE_SERVICE);
 
@@ -383,8 +413,28 @@ uint32_t ble_hrs_heart_rate_measurement_send(ble_hrs_t * p_hrs, uint16_t heart_r
 }
 
 
+#if NRF_MODULE_ENABLED(BLE_HVX_COALESCE)
+uint32_t ble_hrs_heart_rate_measurement_coalesce(ble_hrs_t * p_hrs, uint16_t heart_rate)
+{
+    if (p_hrs->conn_handle == BLE_CONN_HANDLE_INVALID)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    p_hrs->coalesced_heart_rate = heart_rate;
+    ble_hvx_coalesce_request(&p_hrs->coalesce);
+
+    return NRF_SUCCESS;
+}
+#endif
+
+
 void ble_hrs_rr_interval_add(ble_hrs_t * p_hrs, uint16_t rr_interval)
 {
+#if NRF_MODULE_ENABLED(BLE_HVX_COALESCE)
+    // The buffer is also encoded from the radio notification interrupt.
+    CRITICAL_REGION_ENTER();
+#endif
     if (p_hrs->rr_interval_count == BLE_HRS_MAX_BUFFERED_RR_INTERVALS)
     {
         // The rr_interval buffer is full, delete the oldest value
@@ -396,6 +446,9 @@ void ble_hrs_rr_interval_add(ble_hrs_t * p_hrs, uint16_t rr_interval)
 
     // Add new value
     p_hrs->rr_interval[p_hrs->rr_interval_count++] = rr_interval;
+#if NRF_MODULE_ENABLED(BLE_HVX_COALESCE)
+    CRITICAL_REGION_EXIT();
+#endif
 }
 
 
@@ -49,6 +49,7 @@
 #include "ble.h"
 #include "ble_srv_common.h"
 #include "nrf_ble_gatt.h"
+#include "ble_hvx_coalesce.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -110,6 +111,8 @@ struct ble_hrs_s
     uint16_t                     rr_interval[BLE_HRS_MAX_BUFFERED_RR_INTERVALS];       /**< Set of RR Interval measurements since the last Heart Rate Measurement transmission. */
     uint16_t                     rr_interval_count;                                    /**< Number of RR Interval measurements since the last Heart Rate Measurement transmission. */
     uint8_t                      max_hrm_len;                                          /**< Current maximum HR measurement length, adjusted according to the current ATT MTU. */
+    ble_hvx_coalesce_t           coalesce;                                             /**< Coalescing instance, used by @ref ble_hrs_heart_rate_measurement_coalesce. */
+    uint16_t                     coalesced_heart_rate;                                 /**< Newest heart rate measurement, sent before the next radio event. */
 };
 
 /**@brief Function for initializing the Heart Rate Service.
@@ -156,6 +159,21 @@ void ble_hrs_on_ble_evt(ble_hrs_t * p_hrs, ble_evt_t * p_ble_evt);
  */
 uint32_t ble_hrs_heart_rate_measurement_send(ble_hrs_t * p_hrs, uint16_t heart_rate);
 
+/**@brief Function for sending heart rate measurement before the next radio event.
+ *
+ * @details Instead of sending a notification for every measurement, the measurement is stored
+ *          and one notification with the newest heart rate and the buffered RR Interval
+ *          measurements is sent shortly before the next connection event. RR Interval
+ *          measurements that do not fit into the notification are sent before the following
+ *          connection event. Requires the @ref ble_hvx_coalesce module.
+ *
+ * @param[in]   p_hrs                    Heart Rate Service structure.
+ * @param[in]   heart_rate               New heart rate measurement.
+ *
+ * @return      NRF_SUCCESS on success, NRF_ERROR_INVALID_STATE if not in a connection.
+ */
+uint32_t ble_hrs_heart_rate_measurement_coalesce(ble_hrs_t * p_hrs, uint16_t heart_rate);
+
 /**@brief Function for adding a RR Interval measurement to the RR Interval buffer.
  *
  * @details All buffered RR Interval measurements will be included in the next heart rate
@@ -17,6 +17,9 @@
 #include "ble_types.h"
 #include "ble_srv_common.h"
 #include "ble_gattc.h"
+#if NRF_MODULE_ENABLED(NRF_BLE_GQ)
+#include "nrf_ble_gq.h"
+#endif
 
 #define NRF_LOG_MODULE_NAME "BLE_HRS_C"
 #include "nrf_log.h"
@@ -258,6 +261,7 @@ uint32_t ble_hrs_c_init(ble_hrs_c_t * p_ble_hrs_c, ble_hrs_c_init_t * p_ble_hrs_
 
 
     p_ble_hrs_c->evt_handler                 = p_ble_hrs_c_init->evt_handler;
+    p_ble_hrs_c->p_gatt_queue                = p_ble_hrs_c_init->p_gatt_queue;
     p_ble_hrs_c->conn_handle                 = BLE_CONN_HANDLE_INVALID;
     p_ble_hrs_c->peer_hrs_db.hrm_cccd_handle = BLE_GATT_HANDLE_INVALID;
     p_ble_hrs_c->peer_hrs_db.hrm_handle      = BLE_GATT_HANDLE_INVALID;
@@ -295,14 +299,37 @@ void ble_hrs_c_on_ble_evt(ble_hrs_c_t * p_ble_hrs_c, const ble_evt_t * p_ble_evt
 
 /**@brief Function for creating a message for writing to the CCCD.
  */
-static uint32_t cccd_configure(uint16_t conn_handle, uint16_t handle_cccd, bool enable)
+static uint32_t cccd_configure(ble_hrs_c_t * p_ble_hrs_c, uint16_t handle_cccd, bool enable)
 {
+    uint16_t conn_handle = p_ble_hrs_c->conn_handle;
+
     NRF_LOG_INFO("Configuring CCCD. CCCD Handle = %d, Connection Handle = %d\r\n",
         handle_cccd,conn_handle);
 
     tx_message_t * p_msg;
     uint16_t       cccd_val = enable ? BLE_GATT_HVX_NOTIFICATION : 0;
 
+#if NRF_MODULE_ENABLED(NRF_BLE_GQ)
+    if (p_ble_hrs_c->p_gatt_queue != NULL)
+    {
+        nrf_ble_gq_req_t req;
+        uint8_t          cccd[WRITE_MESSAGE_LENGTH];
+
+        cccd[0] = LSB_16(cccd_val);
+        cccd[1] = MSB_16(cccd_val);
+
+        memset(&req, 0, sizeof(req));
+        req.type                         = NRF_BLE_GQ_REQ_GATTC_WRITE;
+        req.params.gattc_write.handle    = handle_cccd;
+        req.params.gattc_write.len       = WRITE_MESSAGE_LENGTH;
+        req.params.gattc_write.p_value   = cccd;
+        req.params.gattc_write.offset    = 0;
+        req.params.gattc_write.write_op  = BLE_GATT_OP_WRITE_REQ;
+
+        return nrf_ble_gq_item_add(p_ble_hrs_c->p_gatt_queue, &req, conn_handle);
+    }
+#endif
+
     p_msg              = &m_tx_buffer[m_tx_insert_index++];
     m_tx_insert_index &= TX_BUFFER_MASK;
 
@@ -325,7 +352,7 @@ uint32_t ble_hrs_c_hrm_notif_enable(ble_hrs_c_t * p_ble_hrs_c)
 {
     VERIFY_PARAM_NOT_NULL(p_ble_hrs_c);
 
-    return cccd_configure(p_ble_hrs_c->conn_handle,
+    return cccd_configure(p_ble_hrs_c,
                           p_ble_hrs_c->peer_hrs_db.hrm_cccd_handle,
                           true);
 }
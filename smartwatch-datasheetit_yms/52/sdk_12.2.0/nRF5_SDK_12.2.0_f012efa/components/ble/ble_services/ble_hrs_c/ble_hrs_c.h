@@ -132,6 +132,7 @@ struct ble_hrs_c_s
     uint16_t                conn_handle;      /**< Connection handle as provided by the SoftDevice. */
     hrs_db_t                peer_hrs_db;      /**< Handles related to HRS on the peer*/
     ble_hrs_c_evt_handler_t evt_handler;      /**< Application event handler to be called when there is an event related to the heart rate service. */
+    struct nrf_ble_gq_s   * p_gatt_queue;     /**< GATT queue used for the writes to the peer, or NULL. */
 };
 
 /**@brief Heart Rate Client initialization structure.
@@ -139,6 +140,7 @@ struct ble_hrs_c_s
 typedef struct
 {
     ble_hrs_c_evt_handler_t evt_handler;  /**< Event handler to be called by the Heart Rate Client module whenever there is an event related to the Heart Rate Service. */
+    struct nrf_ble_gq_s   * p_gatt_queue; /**< GATT queue (@ref nrf_ble_gq) to add the writes to the peer to, shared with other modules. If NULL, or if the GATT queue is not enabled, an internal buffer of the module is used. */
 } ble_hrs_c_init_t;
 
 /** @} */
@@ -0,0 +1,144 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(BLE_MTS)
+#include "ble_mts.h"
+#include <string.h>
+#include "mem_telemetry.h"
+
+
+/**@brief Function for handling a read of the Telemetry characteristic.
+ *
+ * @details A read at offset 0 gets a new value. The Read Blob requests that follow get the rest of
+ *          the value already given to the SoftDevice.
+ */
+static void on_read(ble_mts_t * p_mts, ble_evt_t * p_ble_evt)
+{
+    ble_gatts_evt_read_t const *          p_evt_read =
+        &p_ble_evt->evt.gatts_evt.params.authorize_request.request.read;
+    ble_gatts_rw_authorize_reply_params_t reply;
+
+    if (p_evt_read->handle != p_mts->telemetry_handles.value_handle)
+    {
+        return;
+    }
+
+    memset(&reply, 0, sizeof(reply));
+
+    reply.type                    = BLE_GATTS_AUTHORIZE_TYPE_READ;
+    reply.params.read.gatt_status = BLE_GATT_STATUS_SUCCESS;
+
+    if (p_evt_read->offset == 0)
+    {
+        reply.params.read.update = 1;
+        reply.params.read.offset = 0;
+        reply.params.read.len    = (uint16_t)mem_telemetry_encode(p_mts->value,
+                                                                  sizeof(p_mts->value));
+        reply.params.read.p_data = p_mts->value;
+    }
+
+    (void)sd_ble_gatts_rw_authorize_reply(p_ble_evt->evt.gatts_evt.conn_handle, &reply);
+}
+
+
+void ble_mts_on_ble_evt(ble_mts_t * p_mts, ble_evt_t * p_ble_evt)
+{
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GAP_EVT_CONNECTED:
+            p_mts->conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+            break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            p_mts->conn_handle = BLE_CONN_HANDLE_INVALID;
+            break;
+
+        case BLE_GATTS_EVT_RW_AUTHORIZE_REQUEST:
+            if (p_ble_evt->evt.gatts_evt.params.authorize_request.type ==
+                BLE_GATTS_AUTHORIZE_TYPE_READ)
+            {
+                on_read(p_mts, p_ble_evt);
+            }
+            break;
+
+        default:
+            // No implementation needed.
+            break;
+    }
+}
+
+
+/**@brief Function for adding the Telemetry characteristic. */
+static ret_code_t telemetry_char_add(ble_mts_t * p_mts, ble_mts_init_t const * p_mts_init)
+{
+    ble_gatts_char_md_t char_md;
+    ble_gatts_attr_t    attr_char_value;
+    ble_uuid_t          ble_uuid;
+    ble_gatts_attr_md_t attr_md;
+
+    memset(&char_md, 0, sizeof(char_md));
+
+    char_md.char_props.read = 1;
+
+    ble_uuid.type = p_mts->uuid_type;
+    ble_uuid.uuid = BLE_MTS_UUID_TELEMETRY_CHAR;
+
+    memset(&attr_md, 0, sizeof(attr_md));
+
+    attr_md.read_perm = p_mts_init->read_perm;
+    BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&attr_md.write_perm);
+    attr_md.vloc    = BLE_GATTS_VLOC_STACK;
+    attr_md.rd_auth = 1;
+    attr_md.wr_auth = 0;
+    attr_md.vlen    = 1;
+
+    memset(&attr_char_value, 0, sizeof(attr_char_value));
+
+    attr_char_value.p_uuid    = &ble_uuid;
+    attr_char_value.p_attr_md = &attr_md;
+    attr_char_value.init_len  = 0;
+    attr_char_value.init_offs = 0;
+    attr_char_value.max_len   = BLE_MTS_CONFIG_MAX_LEN;
+    attr_char_value.p_value   = NULL;
+
+    return sd_ble_gatts_characteristic_add(p_mts->service_handle,
+                                           &char_md,
+                                           &attr_char_value,
+                                           &p_mts->telemetry_handles);
+}
+
+
+ret_code_t ble_mts_init(ble_mts_t * p_mts, ble_mts_init_t const * p_mts_init)
+{
+    ret_code_t    err_code;
+    ble_uuid_t    ble_uuid;
+    ble_uuid128_t base_uuid = BLE_MTS_UUID_BASE;
+
+    VERIFY_PARAM_NOT_NULL(p_mts);
+    VERIFY_PARAM_NOT_NULL(p_mts_init);
+
+    p_mts->conn_handle = BLE_CONN_HANDLE_INVALID;
+
+    err_code = sd_ble_uuid_vs_add(&base_uuid, &p_mts->uuid_type);
+    VERIFY_SUCCESS(err_code);
+
+    ble_uuid.type = p_mts->uuid_type;
+    ble_uuid.uuid = BLE_MTS_UUID_SERVICE;
+
+    err_code = sd_ble_gatts_service_add(BLE_GATTS_SRVC_TYPE_PRIMARY, &ble_uuid,
+                                        &p_mts->service_handle);
+    VERIFY_SUCCESS(err_code);
+
+    return telemetry_char_add(p_mts, p_mts_init);
+}
+
+#endif // NRF_MODULE_ENABLED(BLE_MTS)
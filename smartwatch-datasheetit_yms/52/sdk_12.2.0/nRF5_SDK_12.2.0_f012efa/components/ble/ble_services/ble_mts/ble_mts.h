@@ -0,0 +1,100 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @defgroup ble_mts Memory Telemetry Service
+ * @{
+ * @ingroup  ble_sdk_srv
+ * @brief    Memory Telemetry Service implementation.
+ *
+ * @details The Memory Telemetry Service is a debug service that gives a peer the high-water
+ *          marks of the stacks, pools and queues registered with @ref mem_telemetry. It has
+ *          one characteristic:
+ *          - Telemetry (read): the records, as encoded by @ref mem_telemetry_encode.
+ *
+ *          The records are encoded again when a read starts at offset 0, so each read gives the
+ *          current peaks. The following Read Blob requests of a long read get the rest of the
+ *          same value.
+ *
+ * @note The application must propagate SoftDevice events to the Memory Telemetry Service module
+ *       by calling the ble_mts_on_ble_evt() function from the ble_stack_handler callback.
+ */
+
+#ifndef BLE_MTS_H__
+#define BLE_MTS_H__
+
+#include "ble.h"
+#include "ble_srv_common.h"
+#include "sdk_errors.h"
+#include "sdk_config.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Largest value of the Telemetry characteristic, in bytes.
+ *
+ * Records that do not fit are left out. This define should be defined in the sdk_config.h file
+ * to override the default.
+ */
+#ifndef BLE_MTS_CONFIG_MAX_LEN
+#define BLE_MTS_CONFIG_MAX_LEN 256
+#endif
+
+#define BLE_MTS_UUID_BASE           {{0x4E, 0x2C, 0x6A, 0x91, 0x07, 0xB3, 0x5D, 0x88, \
+                                      0xC1, 0x4F, 0x3A, 0xE0, 0x00, 0x00, 0x7D, 0x52}} /**< Vendor specific base UUID. */
+#define BLE_MTS_UUID_SERVICE        0x0001 /**< UUID of the service. */
+#define BLE_MTS_UUID_TELEMETRY_CHAR 0x0002 /**< UUID of the Telemetry characteristic. */
+
+/**@brief Memory Telemetry Service initialization structure. */
+typedef struct
+{
+    ble_gap_conn_sec_mode_t read_perm; /**< Security needed to read the Telemetry characteristic. */
+} ble_mts_init_t;
+
+/**@brief Memory Telemetry Service structure. */
+typedef struct
+{
+    uint8_t                  uuid_type;                      /**< UUID type of the service. */
+    uint16_t                 service_handle;                 /**< Handle of the service. */
+    ble_gatts_char_handles_t telemetry_handles;              /**< Handles of the Telemetry characteristic. */
+    uint16_t                 conn_handle;                    /**< Handle of the connection, or BLE_CONN_HANDLE_INVALID. */
+    uint8_t                  value[BLE_MTS_CONFIG_MAX_LEN];  /**< Value given to the SoftDevice on a read. */
+} ble_mts_t;
+
+/**@brief Function for initializing the Memory Telemetry Service.
+ *
+ * @param[out] p_mts      Memory Telemetry Service structure.
+ * @param[in]  p_mts_init Information needed to initialize the service.
+ *
+ * @retval NRF_SUCCESS    If the service was initialized.
+ * @retval NRF_ERROR_NULL If a parameter was NULL.
+ * @return Other errors from the SoftDevice.
+ */
+ret_code_t ble_mts_init(ble_mts_t * p_mts, ble_mts_init_t const * p_mts_init);
+
+/**@brief Function for handling the SoftDevice events.
+ *
+ * @param[in] p_mts     Memory Telemetry Service structure.
+ * @param[in] p_ble_evt Event received from the SoftDevice.
+ */
+void ble_mts_on_ble_evt(ble_mts_t * p_mts, ble_evt_t * p_ble_evt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLE_MTS_H__
+
+/** @} */
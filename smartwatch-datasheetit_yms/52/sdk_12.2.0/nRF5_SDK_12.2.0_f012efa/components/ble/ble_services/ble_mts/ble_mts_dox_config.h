@@ -0,0 +1,22 @@
+/**
+ *
+ * @defgroup ble_mts_config Memory Telemetry Service configuration
+ * @{
+ * @ingroup ble_mts
+ */
+/** @brief Enable Memory Telemetry Service.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_MTS_ENABLED
+
+/** @brief Largest value of the Telemetry characteristic, in bytes
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_MTS_CONFIG_MAX_LEN
+
+
+/** @} */
@@ -17,7 +17,12 @@
 #define BLE_UUID_NUS_TX_CHARACTERISTIC 0x0002                      /**< The UUID of the TX Characteristic. */
 #define BLE_UUID_NUS_RX_CHARACTERISTIC 0x0003                      /**< The UUID of the RX Characteristic. */
 
+#if NRF_MODULE_ENABLED(BLE_NUS_STREAM)
+#include "ble_nus_stream.h"
+#define BLE_NUS_MAX_RX_CHAR_LEN        BLE_NUS_STREAM_MAX_DATA_LEN /**< Maximum length of the RX Characteristic (in bytes). Notifications of the stream use the full ATT_MTU. */
+#else
 #define BLE_NUS_MAX_RX_CHAR_LEN        BLE_NUS_MAX_DATA_LEN        /**< Maximum length of the RX Characteristic (in bytes). */
+#endif
 #define BLE_NUS_MAX_TX_CHAR_LEN        BLE_NUS_MAX_DATA_LEN        /**< Maximum length of the TX Characteristic (in bytes). */
 
 #define NUS_BASE_UUID                  {{0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0, 0x93, 0xF3, 0xA3, 0xB5, 0x00, 0x00, 0x40, 0x6E}} /**< Used vendor specific UUID. */
@@ -12,5 +12,16 @@
  */
 #define BLE_NUS_ENABLED
 
+/** @brief Enable the stream module of the Nordic UART Service
+ *
+ * Sends a byte stream as notifications of the effective ATT_MTU size and refills
+ * the SoftDevice buffers on @ref BLE_EVT_TX_COMPLETE. Requires @ref APP_FIFO_ENABLED.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_NUS_STREAM_ENABLED
+
 
 /** @} */
@@ -0,0 +1,231 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(BLE_NUS_STREAM)
+#include "ble_nus_stream.h"
+#include "app_timer.h"
+#include <string.h>
+
+
+static void evt_send(ble_nus_stream_t * p_stream, ble_nus_stream_evt_type_t type)
+{
+    ble_nus_stream_evt_t evt;
+
+    if (p_stream->evt_handler != NULL)
+    {
+        evt.type = type;
+        p_stream->evt_handler(p_stream, &evt);
+    }
+}
+
+
+/**@brief Function for getting the maximum length of the data in one notification. */
+static uint16_t packet_len_max(ble_nus_stream_t * p_stream)
+{
+    uint16_t mtu = nrf_ble_gatt_eff_mtu_get(p_stream->p_gatt, p_stream->p_nus->conn_handle);
+
+    mtu = MAX(mtu, GATT_MTU_SIZE_DEFAULT);
+    return MIN(mtu - 3, BLE_NUS_STREAM_MAX_DATA_LEN);
+}
+
+
+/**@brief Function for queuing notifications until the FIFO is empty or the SoftDevice buffers
+ *        are full.
+ */
+static ret_code_t stream_pump(ble_nus_stream_t * p_stream)
+{
+    ble_gatts_hvx_params_t hvx_params;
+    ret_code_t             err_code = NRF_SUCCESS;
+
+    memset(&hvx_params, 0, sizeof(hvx_params));
+    hvx_params.handle = p_stream->p_nus->rx_handles.value_handle;
+    hvx_params.type   = BLE_GATT_HVX_NOTIFICATION;
+
+    while (!p_stream->busy)
+    {
+        uint32_t  avail   = 0;
+        uint16_t  len_max = packet_len_max(p_stream);
+        uint32_t  span;
+        uint16_t  len;
+        uint8_t * p_span;
+
+        (void)app_fifo_read(&p_stream->fifo, NULL, &avail);
+        len = MIN(avail, len_max);
+
+        // A short packet is held back while earlier ones are in flight, so that more data
+        // can be added to it.
+        if ((len == 0) || ((len < len_max) && (p_stream->in_flight != 0)))
+        {
+            break;
+        }
+
+        // The data is sent from the FIFO memory, unless it wraps around its end. Then the
+        // rest of it is at the start of the FIFO memory.
+        (void)app_fifo_read_span(&p_stream->fifo, &p_span, &span);
+        if (span >= len)
+        {
+            hvx_params.p_data = p_span;
+        }
+        else
+        {
+            memcpy(p_stream->packet, p_span, span);
+            memcpy(&p_stream->packet[span], p_stream->fifo.p_buf, len - span);
+            hvx_params.p_data = p_stream->packet;
+        }
+        hvx_params.p_len = &len;
+
+        err_code = sd_ble_gatts_hvx(p_stream->p_nus->conn_handle, &hvx_params);
+        if ((err_code == BLE_ERROR_NO_TX_PACKETS) || (err_code == NRF_ERROR_BUSY))
+        {
+            // Retried on BLE_EVT_TX_COMPLETE.
+            p_stream->busy = true;
+            return NRF_SUCCESS;
+        }
+        VERIFY_SUCCESS(err_code);
+
+        if (p_stream->packets_sent == 0)
+        {
+            p_stream->first_ticks = app_timer_cnt_get();
+            p_stream->last_ticks  = p_stream->first_ticks;
+        }
+        p_stream->packets_sent++;
+        p_stream->bytes_sent += len;
+        p_stream->in_flight++;
+        (void)app_fifo_read_span_commit(&p_stream->fifo, len);
+    }
+
+    return err_code;
+}
+
+
+ret_code_t ble_nus_stream_init(ble_nus_stream_t * p_stream, ble_nus_stream_init_t const * p_init)
+{
+    VERIFY_PARAM_NOT_NULL(p_stream);
+    VERIFY_PARAM_NOT_NULL(p_init);
+    VERIFY_PARAM_NOT_NULL(p_init->p_nus);
+
+    memset(p_stream, 0, sizeof(ble_nus_stream_t));
+    p_stream->p_nus           = p_init->p_nus;
+    p_stream->p_gatt          = p_init->p_gatt;
+    p_stream->evt_handler     = p_init->evt_handler;
+    p_stream->timer_prescaler = p_init->timer_prescaler;
+
+    return app_fifo_init(&p_stream->fifo, p_init->p_buf, p_init->buf_size);
+}
+
+
+void ble_nus_stream_on_ble_evt(ble_nus_stream_t * p_stream, ble_evt_t * p_ble_evt)
+{
+    if ((p_stream == NULL) || (p_ble_evt == NULL))
+    {
+        return;
+    }
+
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GAP_EVT_DISCONNECTED:
+            (void)app_fifo_flush(&p_stream->fifo);
+            p_stream->in_flight = 0;
+            p_stream->busy      = false;
+            break;
+
+        case BLE_EVT_TX_COMPLETE:
+        {
+            uint32_t avail = 0;
+
+            if (p_ble_evt->evt.common_evt.conn_handle != p_stream->p_nus->conn_handle)
+            {
+                break;
+            }
+
+            // The count includes packets of other services on the link.
+            p_stream->in_flight -= MIN(p_stream->in_flight,
+                                       p_ble_evt->evt.common_evt.params.tx_complete.count);
+            p_stream->busy       = false;
+            p_stream->last_ticks = app_timer_cnt_get();
+
+            (void)stream_pump(p_stream);
+
+            (void)app_fifo_write(&p_stream->fifo, NULL, &avail);
+            if (p_stream->tx_rdy_pending && (avail != 0))
+            {
+                p_stream->tx_rdy_pending = false;
+                evt_send(p_stream, BLE_NUS_STREAM_EVT_TX_RDY);
+            }
+            if ((avail == (uint32_t)p_stream->fifo.buf_size_mask + 1) && (p_stream->in_flight == 0))
+            {
+                evt_send(p_stream, BLE_NUS_STREAM_EVT_TX_DONE);
+            }
+        } break;
+
+        default:
+            // No implementation needed.
+            break;
+    }
+}
+
+
+ret_code_t ble_nus_stream_write(ble_nus_stream_t * p_stream, uint8_t const * p_data, uint32_t * p_len)
+{
+    ret_code_t err_code;
+    uint32_t   requested_len;
+
+    VERIFY_PARAM_NOT_NULL(p_stream);
+    VERIFY_PARAM_NOT_NULL(p_data);
+    VERIFY_PARAM_NOT_NULL(p_len);
+
+    if ((p_stream->p_nus->conn_handle == BLE_CONN_HANDLE_INVALID) ||
+        (!p_stream->p_nus->is_notification_enabled))
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    requested_len = *p_len;
+    err_code      = app_fifo_write(&p_stream->fifo, p_data, p_len);
+    if ((err_code == NRF_ERROR_NO_MEM) || (*p_len < requested_len))
+    {
+        p_stream->tx_rdy_pending = true;
+    }
+    if (err_code == NRF_ERROR_NO_MEM)
+    {
+        *p_len = 0;
+        return err_code;
+    }
+
+    return stream_pump(p_stream);
+}
+
+
+void ble_nus_stream_stats_get(ble_nus_stream_t const * p_stream, ble_nus_stream_stats_t * p_stats)
+{
+    uint32_t ticks = 0;
+
+    (void)app_timer_cnt_diff_compute(p_stream->last_ticks, p_stream->first_ticks, &ticks);
+
+    p_stats->bytes_sent    = p_stream->bytes_sent;
+    p_stats->packets_sent  = p_stream->packets_sent;
+    p_stats->ticks         = ticks;
+    p_stats->bytes_per_sec = (ticks == 0) ? 0 :
+        (uint32_t)(((uint64_t)p_stream->bytes_sent * APP_TIMER_CLOCK_FREQ) /
+                   ((uint64_t)ticks * (p_stream->timer_prescaler + 1)));
+}
+
+
+void ble_nus_stream_stats_reset(ble_nus_stream_t * p_stream)
+{
+    p_stream->bytes_sent   = 0;
+    p_stream->packets_sent = 0;
+    p_stream->first_ticks  = 0;
+    p_stream->last_ticks   = 0;
+}
+
+#endif // NRF_MODULE_ENABLED(BLE_NUS_STREAM)
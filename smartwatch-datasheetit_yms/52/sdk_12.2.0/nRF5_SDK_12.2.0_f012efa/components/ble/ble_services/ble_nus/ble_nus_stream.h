@@ -0,0 +1,166 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @defgroup ble_nus_stream Nordic UART Service stream
+ * @{
+ * @ingroup  ble_nus
+ * @brief    Byte stream over the Nordic UART Service.
+ *
+ * @details The stream module sends a byte stream to the peer as notifications of the Nordic
+ *          UART Service. The application writes data to a FIFO. The module packs the data into
+ *          notifications of the effective ATT_MTU size of the link and keeps the transmit
+ *          buffers of the SoftDevice full. New notifications are queued when the SoftDevice
+ *          reports @ref BLE_EVT_TX_COMPLETE, so the application does not have to retry when
+ *          the buffers are full.
+ *
+ *          A notification shorter than the ATT_MTU is sent only when no other notification of
+ *          the stream is in flight. This way the tail of the data is not delayed, while data
+ *          that is written in small parts is still sent in full packets.
+ *
+ * @note The application must propagate SoftDevice events to the module by calling
+ *       @ref ble_nus_stream_on_ble_evt after @ref ble_nus_on_ble_evt.
+ * @note To send notifications longer than 20 bytes, the RX characteristic of the service is
+ *       sized to @ref NRF_BLE_GATT_MAX_MTU_SIZE when this module is enabled.
+ */
+
+#ifndef BLE_NUS_STREAM_H__
+#define BLE_NUS_STREAM_H__
+
+#include "ble.h"
+#include "ble_nus.h"
+#include "nrf_ble_gatt.h"
+#include "app_fifo.h"
+#include "sdk_errors.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BLE_NUS_STREAM_MAX_DATA_LEN (NRF_BLE_GATT_MAX_MTU_SIZE - 3) /**< Maximum length of the data in one notification. */
+
+/* Forward declaration of the ble_nus_stream_t type. */
+typedef struct ble_nus_stream_s ble_nus_stream_t;
+
+/**@brief Stream event types. */
+typedef enum
+{
+    BLE_NUS_STREAM_EVT_TX_RDY,  /**< There is free space in the FIFO again after @ref ble_nus_stream_write returned @ref NRF_ERROR_NO_MEM or wrote less data than requested. */
+    BLE_NUS_STREAM_EVT_TX_DONE, /**< All data in the FIFO have been sent. */
+} ble_nus_stream_evt_type_t;
+
+/**@brief Stream event. */
+typedef struct
+{
+    ble_nus_stream_evt_type_t type; /**< Type of the event. */
+} ble_nus_stream_evt_t;
+
+/**@brief Stream event handler type. */
+typedef void (*ble_nus_stream_evt_handler_t)(ble_nus_stream_t * p_stream, ble_nus_stream_evt_t const * p_evt);
+
+/**@brief Stream statistics. */
+typedef struct
+{
+    uint32_t bytes_sent;    /**< Number of bytes sent since the statistics were reset. */
+    uint32_t packets_sent;  /**< Number of notifications sent since the statistics were reset. */
+    uint32_t ticks;         /**< Number of app_timer ticks from the first notification to the last completed one. */
+    uint32_t bytes_per_sec; /**< Average throughput over @p ticks. */
+} ble_nus_stream_stats_t;
+
+/**@brief Stream initialization structure. */
+typedef struct
+{
+    ble_nus_t                  * p_nus;           /**< Nordic UART Service used to send the data. */
+    nrf_ble_gatt_t             * p_gatt;          /**< GATT module that holds the effective ATT_MTU of the link. */
+    uint8_t                    * p_buf;           /**< Memory of the FIFO. */
+    uint16_t                     buf_size;        /**< Size of the FIFO. Must be a power of two. */
+    uint32_t                     timer_prescaler; /**< Prescaler of the app_timer module, used for the throughput. */
+    ble_nus_stream_evt_handler_t evt_handler;     /**< Event handler. Can be NULL. */
+} ble_nus_stream_init_t;
+
+/**@brief Stream structure. Its content must not be accessed by the application. */
+struct ble_nus_stream_s
+{
+    ble_nus_t                  * p_nus;
+    nrf_ble_gatt_t             * p_gatt;
+    ble_nus_stream_evt_handler_t evt_handler;
+    app_fifo_t                   fifo;
+    uint32_t                     timer_prescaler;
+    uint16_t                     in_flight;       /**< Number of notifications queued in the SoftDevice. */
+    bool                         tx_rdy_pending;  /**< The application waits for @ref BLE_NUS_STREAM_EVT_TX_RDY. */
+    bool                         busy;            /**< The SoftDevice buffers are full. */
+    uint32_t                     bytes_sent;
+    uint32_t                     packets_sent;
+    uint32_t                     first_ticks;
+    uint32_t                     last_ticks;
+    uint8_t                      packet[BLE_NUS_STREAM_MAX_DATA_LEN]; /**< Notification data that wraps around the end of the FIFO. */
+};
+
+/**@brief Function for initializing the stream.
+ *
+ * @param[out] p_stream Stream structure.
+ * @param[in]  p_init   Information needed to initialize the stream.
+ *
+ * @retval NRF_SUCCESS              If the stream was initialized.
+ * @retval NRF_ERROR_NULL           If a NULL pointer was passed.
+ * @retval NRF_ERROR_INVALID_LENGTH If the size of the FIFO is not a power of two.
+ */
+ret_code_t ble_nus_stream_init(ble_nus_stream_t * p_stream, ble_nus_stream_init_t const * p_init);
+
+/**@brief Function for handling BLE events.
+ *
+ * @param[in] p_stream  Stream structure.
+ * @param[in] p_ble_evt Event received from the SoftDevice.
+ */
+void ble_nus_stream_on_ble_evt(ble_nus_stream_t * p_stream, ble_evt_t * p_ble_evt);
+
+/**@brief Function for writing data to the stream.
+ *
+ * The data is copied to the FIFO and sent as soon as the SoftDevice has free buffers. If
+ * the FIFO cannot take all data, @ref BLE_NUS_STREAM_EVT_TX_RDY is generated when there is
+ * free space again.
+ *
+ * @param[in]    p_stream Stream structure.
+ * @param[in]    p_data   Data to write.
+ * @param[inout] p_len    Number of bytes to write. Overwritten with the number of bytes written.
+ *
+ * @retval NRF_SUCCESS             If some or all data was written.
+ * @retval NRF_ERROR_NULL          If a NULL pointer was passed.
+ * @retval NRF_ERROR_INVALID_STATE If there is no connection or notifications are not enabled.
+ * @retval NRF_ERROR_NO_MEM        If the FIFO is full.
+ * @return Other errors from @ref sd_ble_gatts_hvx.
+ */
+ret_code_t ble_nus_stream_write(ble_nus_stream_t * p_stream, uint8_t const * p_data, uint32_t * p_len);
+
+/**@brief Function for getting the statistics of the stream.
+ *
+ * @param[in]  p_stream Stream structure.
+ * @param[out] p_stats  Statistics.
+ */
+void ble_nus_stream_stats_get(ble_nus_stream_t const * p_stream, ble_nus_stream_stats_t * p_stats);
+
+/**@brief Function for resetting the statistics of the stream.
+ *
+ * @param[in] p_stream Stream structure.
+ */
+void ble_nus_stream_stats_reset(ble_nus_stream_t * p_stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLE_NUS_STREAM_H__
+
+/** @} */
@@ -68,6 +68,44 @@ void ble_nus_c_on_db_disc_evt(ble_nus_c_t * p_ble_nus_c, ble_db_discovery_evt_t
  * @param[in] p_ble_nus_c Pointer to the NUS Client structure.
  * @param[in] p_ble_evt   Pointer to the BLE event received.
  */
+#if NRF_MODULE_ENABLED(BLE_NUS_C_RX_FIFO)
+/**@brief     Function for appending the data of a notification to the RX FIFO.
+ *
+ * @param[in] p_ble_nus_c Pointer to the NUS Client structure.
+ * @param[in] p_data      Data of the notification.
+ * @param[in] len         Length of the data.
+ */
+static void rx_fifo_append(ble_nus_c_t * p_ble_nus_c, uint8_t const * p_data, uint16_t len)
+{
+    ble_nus_c_evt_t ble_nus_c_evt;
+    uint32_t        size      = 0;
+    bool            was_empty = (app_fifo_read(p_ble_nus_c->p_rx_fifo, NULL, &size) == NRF_ERROR_NOT_FOUND);
+
+    size = len;
+    (void)app_fifo_write(p_ble_nus_c->p_rx_fifo, p_data, &size);
+
+    ble_nus_c_evt.conn_handle = p_ble_nus_c->conn_handle;
+    ble_nus_c_evt.p_data      = NULL;
+
+    if (size < len)
+    {
+        p_ble_nus_c->rx_dropped += len - size;
+
+        ble_nus_c_evt.evt_type = BLE_NUS_C_EVT_RX_FIFO_OVERFLOW;
+        ble_nus_c_evt.data_len = len - size;
+        p_ble_nus_c->evt_handler(p_ble_nus_c, &ble_nus_c_evt);
+    }
+
+    // Data arriving while the FIFO is being drained are picked up by the reader.
+    if (was_empty && (size > 0))
+    {
+        ble_nus_c_evt.evt_type = BLE_NUS_C_EVT_RX_FIFO_DATA;
+        ble_nus_c_evt.data_len = size;
+        p_ble_nus_c->evt_handler(p_ble_nus_c, &ble_nus_c_evt);
+    }
+}
+#endif
+
 static void on_hvx(ble_nus_c_t * p_ble_nus_c, const ble_evt_t * p_ble_evt)
 {
     // HVX can only occur from client sending.
@@ -78,6 +116,16 @@ static void on_hvx(ble_nus_c_t * p_ble_nus_c, const ble_evt_t * p_ble_evt)
     {
         ble_nus_c_evt_t ble_nus_c_evt;
 
+#if NRF_MODULE_ENABLED(BLE_NUS_C_RX_FIFO)
+        if (p_ble_nus_c->p_rx_fifo != NULL)
+        {
+            rx_fifo_append(p_ble_nus_c,
+                           p_ble_evt->evt.gattc_evt.params.hvx.data,
+                           p_ble_evt->evt.gattc_evt.params.hvx.len);
+            return;
+        }
+#endif
+
         ble_nus_c_evt.evt_type = BLE_NUS_C_EVT_NUS_RX_EVT;
         ble_nus_c_evt.p_data   = (uint8_t *)p_ble_evt->evt.gattc_evt.params.hvx.data;
         ble_nus_c_evt.data_len = p_ble_evt->evt.gattc_evt.params.hvx.len;
@@ -105,6 +153,10 @@ uint32_t ble_nus_c_init(ble_nus_c_t * p_ble_nus_c, ble_nus_c_init_t * p_ble_nus_
     p_ble_nus_c->evt_handler           = p_ble_nus_c_init->evt_handler;
     p_ble_nus_c->handles.nus_rx_handle = BLE_GATT_HANDLE_INVALID;
     p_ble_nus_c->handles.nus_tx_handle = BLE_GATT_HANDLE_INVALID;
+#if NRF_MODULE_ENABLED(BLE_NUS_C_RX_FIFO)
+    p_ble_nus_c->p_rx_fifo             = p_ble_nus_c_init->p_rx_fifo;
+    p_ble_nus_c->rx_dropped            = 0;
+#endif
 
     return ble_db_discovery_evt_register(&uart_uuid);
 }
@@ -219,4 +271,30 @@ uint32_t ble_nus_c_handles_assign(ble_nus_c_t * p_ble_nus,
     }
     return NRF_SUCCESS;
 }
+
+#if NRF_MODULE_ENABLED(BLE_NUS_C_RX_FIFO)
+uint32_t ble_nus_c_rx_span_get(ble_nus_c_t * p_ble_nus_c, uint8_t ** pp_data, uint32_t * p_size)
+{
+    VERIFY_PARAM_NOT_NULL(p_ble_nus_c);
+
+    if (p_ble_nus_c->p_rx_fifo == NULL)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    return app_fifo_read_span(p_ble_nus_c->p_rx_fifo, pp_data, p_size);
+}
+
+
+uint32_t ble_nus_c_rx_span_release(ble_nus_c_t * p_ble_nus_c, uint32_t size)
+{
+    VERIFY_PARAM_NOT_NULL(p_ble_nus_c);
+
+    if (p_ble_nus_c->p_rx_fifo == NULL)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    return app_fifo_read_span_commit(p_ble_nus_c->p_rx_fifo, size);
+}
+#endif
+
 #endif // NRF_MODULE_ENABLED(BLE_NUS_C)
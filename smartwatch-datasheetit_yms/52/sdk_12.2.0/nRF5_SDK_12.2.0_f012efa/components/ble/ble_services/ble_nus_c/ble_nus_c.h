@@ -21,6 +21,13 @@
  * @note     The application must propagate BLE stack events to this module by calling
  *           ble_nus_c_on_ble_evt().
  *
+ * @details  When BLE_NUS_C_RX_FIFO_ENABLED is set and an RX FIFO is given at initialization,
+ *           the payload of each notification is appended to the FIFO in the BLE event context,
+ *           with one copy. The application is told with @ref BLE_NUS_C_EVT_RX_FIFO_DATA when the
+ *           FIFO goes from empty to not empty, and drains it in large blocks with
+ *           @ref ble_nus_c_rx_span_get and @ref ble_nus_c_rx_span_release, for example straight
+ *           to flash or to UART. @ref BLE_NUS_C_EVT_NUS_RX_EVT is then not used.
+ *
  */
 
 
@@ -32,6 +39,10 @@
 #include "ble.h"
 #include "ble_gatt.h"
 #include "ble_db_discovery.h"
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(BLE_NUS_C_RX_FIFO)
+#include "app_fifo.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -50,7 +61,9 @@ typedef enum
 {
     BLE_NUS_C_EVT_DISCOVERY_COMPLETE = 1, /**< Event indicating that the NUS service and its characteristics was found. */
     BLE_NUS_C_EVT_NUS_RX_EVT,             /**< Event indicating that the central has received something from a peer. */
-    BLE_NUS_C_EVT_DISCONNECTED            /**< Event indicating that the NUS server has disconnected. */
+    BLE_NUS_C_EVT_DISCONNECTED,           /**< Event indicating that the NUS server has disconnected. */
+    BLE_NUS_C_EVT_RX_FIFO_DATA,           /**< Event indicating that the RX FIFO was empty and has received data. data_len is the length of the notification. */
+    BLE_NUS_C_EVT_RX_FIFO_OVERFLOW        /**< Event indicating that a notification did not fit in the RX FIFO. data_len is the number of bytes dropped. */
 } ble_nus_c_evt_type_t;
 
 
@@ -92,12 +105,19 @@ struct ble_nus_c_s
     uint16_t                conn_handle;        /**< Handle of the current connection. Set with @ref ble_nus_c_handles_assign when connected. */
     ble_nus_c_handles_t     handles;            /**< Handles on the connected peer device needed to interact with it. */
     ble_nus_c_evt_handler_t evt_handler;        /**< Application event handler to be called when there is an event related to the NUS. */
+#if NRF_MODULE_ENABLED(BLE_NUS_C_RX_FIFO)
+    app_fifo_t            * p_rx_fifo;          /**< FIFO the received data is appended to, or NULL to pass each notification to the event handler. */
+    uint32_t                rx_dropped;         /**< Number of received bytes that did not fit in the RX FIFO. */
+#endif
 };
 
 /**@brief NUS Client initialization structure.
  */
 typedef struct {
     ble_nus_c_evt_handler_t evt_handler;
+#if NRF_MODULE_ENABLED(BLE_NUS_C_RX_FIFO)
+    app_fifo_t            * p_rx_fifo;          /**< Initialized FIFO for the received data, or NULL. */
+#endif
 } ble_nus_c_init_t;
 
 
@@ -191,6 +211,40 @@ uint32_t ble_nus_c_string_send(ble_nus_c_t * p_ble_nus_c, uint8_t * p_string, ui
 uint32_t ble_nus_c_handles_assign(ble_nus_c_t * p_ble_nus_c, const uint16_t conn_handle, const ble_nus_c_handles_t * p_peer_handles);
 
 
+#if NRF_MODULE_ENABLED(BLE_NUS_C_RX_FIFO)
+/**@brief Function for getting the contiguous block of received data at the start of the RX FIFO.
+ *
+ * @details The data stay in the FIFO until @ref ble_nus_c_rx_span_release is called. At the wrap
+ *          point of the FIFO, the data are returned in two blocks, by two calls. The function can
+ *          be called from another context than the BLE events, as the FIFO has one reader and one
+ *          writer.
+ *
+ * @param[in]  p_ble_nus_c Pointer to the NUS client structure.
+ * @param[out] pp_data     Start of the block.
+ * @param[out] p_size      Size of the block, in bytes.
+ *
+ * @retval NRF_SUCCESS             If a block was returned.
+ * @retval NRF_ERROR_NULL          If a NULL pointer was passed.
+ * @retval NRF_ERROR_INVALID_STATE If no RX FIFO was given at initialization.
+ * @retval NRF_ERROR_NOT_FOUND     If the FIFO is empty.
+ */
+uint32_t ble_nus_c_rx_span_get(ble_nus_c_t * p_ble_nus_c, uint8_t ** pp_data, uint32_t * p_size);
+
+
+/**@brief Function for removing data from the start of the RX FIFO, after they were used.
+ *
+ * @param[in] p_ble_nus_c Pointer to the NUS client structure.
+ * @param[in] size        Number of bytes to remove. At most the size of the block.
+ *
+ * @retval NRF_SUCCESS              If the data were removed.
+ * @retval NRF_ERROR_NULL           If a NULL pointer was passed.
+ * @retval NRF_ERROR_INVALID_STATE  If no RX FIFO was given at initialization.
+ * @retval NRF_ERROR_INVALID_LENGTH If size is larger than the data in the FIFO.
+ */
+uint32_t ble_nus_c_rx_span_release(ble_nus_c_t * p_ble_nus_c, uint32_t size);
+#endif
+
+
 
 #ifdef __cplusplus
 }
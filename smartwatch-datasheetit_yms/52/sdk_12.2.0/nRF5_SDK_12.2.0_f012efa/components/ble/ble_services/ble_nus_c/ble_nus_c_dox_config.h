@@ -12,5 +12,13 @@
  */
 #define BLE_NUS_C_ENABLED
 
+/** @brief Append the received data to an RX FIFO, drained in blocks by the application.
+ *
+ *  Set to 1 to activate. Requires APP_FIFO_ENABLED.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_NUS_C_RX_FIFO_ENABLED
+
 
 /** @} */
@@ -104,11 +104,92 @@ static void resp_send(ble_lncp_t * p_lncp)
 }
 
 
+#if NRF_MODULE_ENABLED(BLE_LN_TRACK)
+/**@brief Function for notifying the chunks of a track until the SoftDevice has no buffer left.
+ *
+ * @param[in]   p_lncp       Location and Navigation Service structure.
+ */
+static void track_stream_process(ble_lncp_t * p_lncp)
+{
+    ble_lncp_track_stream_t * p_stream = &p_lncp->track_stream;
+    uint8_t                   hvx_data[LNCP_TRACK_DATA_MAX_LEN];
+    ble_gatts_hvx_params_t    hvx_params;
+    uint32_t                  err_code;
+
+    memset(&hvx_params, 0, sizeof(hvx_params));
+    hvx_params.handle = p_lncp->ctrlpt_handles.value_handle;
+    hvx_params.type   = BLE_GATT_HVX_NOTIFICATION;
+    hvx_params.p_data = hvx_data;
+
+    hvx_data[0] = LNCP_OP_ROUTE_TRACK_DATA;
+
+    while (p_lncp->procedure_status == LNCP_STATE_TRACK_STREAMING)
+    {
+        if (p_stream->offset == p_stream->len)
+        {
+            // Read the next chunk. At the end, an empty notification is sent.
+            p_stream->offset = 0;
+            err_code = ble_ln_track_chunk_read(&p_stream->cursor, p_stream->chunk, &p_stream->len);
+            if (err_code == NRF_ERROR_NOT_FOUND)
+            {
+                p_stream->len = 0;
+            }
+            else if (err_code != NRF_SUCCESS)
+            {
+                p_lncp->procedure_status = LNCP_STATE_NO_PROC_IN_PROGRESS;
+                if (p_lncp->error_handler != NULL)
+                {
+                    p_lncp->error_handler(err_code);
+                }
+                return;
+            }
+        }
+
+        uint16_t data_len = MIN(p_stream->len - p_stream->offset, LNCP_TRACK_DATA_MAX_LEN - OPCODE_LENGTH);
+        uint16_t hvx_len  = OPCODE_LENGTH + data_len;
+
+        memcpy(&hvx_data[OPCODE_LENGTH], &p_stream->chunk[p_stream->offset], data_len);
+        hvx_params.p_len = &hvx_len;
+
+        err_code = sd_ble_gatts_hvx(p_lncp->conn_handle, &hvx_params);
+        if ((err_code == NRF_SUCCESS) && (hvx_len != OPCODE_LENGTH + data_len))
+        {
+            err_code = NRF_ERROR_DATA_SIZE;
+        }
+
+        if (err_code == BLE_ERROR_NO_TX_PACKETS)
+        {
+            // Wait for TX_COMPLETE event to go on
+            return;
+        }
+        if (err_code != NRF_SUCCESS)
+        {
+            p_lncp->procedure_status = LNCP_STATE_NO_PROC_IN_PROGRESS;
+            if (p_lncp->error_handler != NULL)
+            {
+                p_lncp->error_handler(err_code);
+            }
+            return;
+        }
+
+        if (data_len == 0)
+        {
+            p_lncp->procedure_status = LNCP_STATE_NO_PROC_IN_PROGRESS;
+        }
+        p_stream->offset += data_len;
+    }
+}
+#endif
+
+
 static void on_connect(ble_lncp_t * p_lncp, ble_evt_t const * p_ble_evt)
 {
     memset(&p_lncp->mask, 0, sizeof(ble_lncp_mask_t));
     p_lncp->conn_handle        = p_ble_evt->evt.gap_evt.conn_handle;
     p_lncp->procedure_status   = LNCP_STATE_NO_PROC_IN_PROGRESS;
+#if NRF_MODULE_ENABLED(BLE_LN_TRACK)
+    p_lncp->track_stream.is_pending = false;
+#endif
 }
 
 
@@ -127,6 +208,14 @@ static void on_hvc_confirm(ble_lncp_t * p_lncp, ble_evt_t const * p_ble_evt)
         if (p_lncp->procedure_status == LNCP_STATE_CONFIRMATION_PENDING)
         {
             p_lncp->procedure_status = LNCP_STATE_NO_PROC_IN_PROGRESS;
+#if NRF_MODULE_ENABLED(BLE_LN_TRACK)
+            if (p_lncp->track_stream.is_pending)
+            {
+                p_lncp->track_stream.is_pending = false;
+                p_lncp->procedure_status        = LNCP_STATE_TRACK_STREAMING;
+                track_stream_process(p_lncp);
+            }
+#endif
         }
         else
         {
@@ -145,6 +234,12 @@ static void on_tx_complete(ble_lncp_t * p_lncp)
     {
         resp_send(p_lncp);
     }
+#if NRF_MODULE_ENABLED(BLE_LN_TRACK)
+    else if (p_lncp->procedure_status == LNCP_STATE_TRACK_STREAMING)
+    {
+        track_stream_process(p_lncp);
+    }
+#endif
 }
 
 
@@ -159,6 +254,9 @@ static void on_lncp_cccd_write(ble_lncp_t * p_lncp, ble_gatts_evt_write_t const
     {
         // CCCD written, update indications state
         p_lncp->is_ctrlpt_indication_enabled = ble_srv_is_indication_enabled(p_evt_write->data);
+#if NRF_MODULE_ENABLED(BLE_LN_TRACK)
+        p_lncp->is_ctrlpt_notification_enabled = ble_srv_is_notification_enabled(p_evt_write->data);
+#endif
     }
 }
 
@@ -481,6 +579,61 @@ static void on_set_elevation(ble_lncp_t * p_lncp, ble_gatts_evt_write_t const *
 }
 
 
+#if NRF_MODULE_ENABLED(BLE_LN_TRACK)
+/**@brief Event handler for control point write.
+ *
+ * @param[in]   p_lncp     Location and Navigation Service structure.
+ * @param[in]   p_ble_evt Event received from the BLE stack.
+ */
+static void on_req_route_track(ble_lncp_t * p_lncp, ble_gatts_evt_write_t const * p_evt_write)
+{
+    ble_lns_route_t route;
+    uint16_t        chunk_count;
+    uint32_t        err_code;
+
+    p_lncp->pending_rsp.rsp_code = LNCP_RSP_SUCCESS;
+
+    if ( !(p_lncp->is_navigation_present) )
+    {
+        p_lncp->pending_rsp.rsp_code = LNCP_RSP_OP_CODE_NOT_SUPPORTED;
+        return;
+    }
+
+    if (p_evt_write->len != OPCODE_LENGTH + INT16_LEN)
+    {
+        p_lncp->pending_rsp.rsp_code = LNCP_RSP_INVALID_PARAMETER;
+        return;
+    }
+
+    /*lint --e{415} --e{416} -save suppress Warning 415: possible access out of bond */
+    const uint16_t route_num = uint16_decode(&p_evt_write->data[1]);
+    /*lint -restore*/
+
+    if (route_num >= ble_ln_db_num_records_get())
+    {
+        p_lncp->pending_rsp.rsp_code = LNCP_RSP_INVALID_PARAMETER;
+        return;
+    }
+
+    err_code = ble_ln_db_record_get((uint8_t)route_num, &route);
+    if (err_code == NRF_SUCCESS)
+    {
+        err_code = ble_ln_track_cursor_init(route.route_id, &p_lncp->track_stream.cursor, &chunk_count);
+    }
+    if (err_code != NRF_SUCCESS)
+    {
+        p_lncp->pending_rsp.rsp_code = LNCP_RSP_OPERATION_FAILED;
+        return;
+    }
+
+    p_lncp->track_stream.len          = 0;
+    p_lncp->track_stream.offset       = 0;
+    p_lncp->track_stream.is_pending   = true;
+    p_lncp->pending_rsp.rsp_param_len = uint16_encode(chunk_count, &p_lncp->pending_rsp.rsp_param[0]);
+}
+#endif
+
+
 /**@brief Handle write events to the Location and Navigation Service Control Point characteristic.
  *
  * @param[in]   p_lncp         Location and Navigation Service structure.
@@ -517,6 +670,16 @@ static void on_ctrlpt_write(ble_lncp_t * p_lncp, ble_gatts_evt_write_t const * p
                     }
                 }
             }
+
+#if NRF_MODULE_ENABLED(BLE_LN_TRACK)
+            // the track is notified on the control point
+            if (   p_evt_write->len > 0
+                && p_evt_write->data[0] == LNCP_OP_REQ_ROUTE_TRACK
+                && !p_lncp->is_ctrlpt_notification_enabled)
+            {
+                write_authorize_reply.params.write.gatt_status = LNCP_RSP_CCCD_CONFIG_IMPROPER;
+            }
+#endif
         }
         else
         {
@@ -585,6 +748,12 @@ static void on_ctrlpt_write(ble_lncp_t * p_lncp, ble_gatts_evt_write_t const * p
                 on_set_elevation(p_lncp, p_evt_write);
                 break;
 
+#if NRF_MODULE_ENABLED(BLE_LN_TRACK)
+            case LNCP_OP_REQ_ROUTE_TRACK:
+                on_req_route_track(p_lncp, p_evt_write);
+                break;
+#endif
+
             // Unrecognized Op Code
             default:
                 p_lncp->pending_rsp.rsp_code = LNCP_RSP_OP_CODE_NOT_SUPPORTED;
@@ -772,6 +941,10 @@ ret_code_t ble_lncp_init(ble_lncp_t * p_lncp, ble_lncp_init_t const * p_lncp_ini
     p_lncp->is_navigation_running        = false;
     p_lncp->is_nav_notification_enabled  = false;
     p_lncp->is_ctrlpt_indication_enabled = false;
+#if NRF_MODULE_ENABLED(BLE_LN_TRACK)
+    p_lncp->is_ctrlpt_notification_enabled = false;
+    p_lncp->track_stream.is_pending        = false;
+#endif
 
     memset(&p_lncp->mask, 0, sizeof(ble_lncp_mask_t));
 
@@ -779,6 +952,9 @@ ret_code_t ble_lncp_init(ble_lncp_t * p_lncp, ble_lncp_init_t const * p_lncp_ini
     add_char_params.max_len              = 0;
     add_char_params.char_props.indicate  = true;
     add_char_params.char_props.write     = true;
+#if NRF_MODULE_ENABLED(BLE_LN_TRACK)
+    add_char_params.char_props.notify    = true;
+#endif
     add_char_params.is_defered_write     = true;
     add_char_params.is_var_len           = true;
     add_char_params.max_len              = BLE_L2CAP_MTU_DEF;
@@ -25,6 +25,9 @@
 
 #include "ble_srv_common.h"
 #include "sdk_common.h"
+#if NRF_MODULE_ENABLED(BLE_LN_TRACK)
+#include "ble_ln_track.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,6 +35,7 @@ extern "C" {
 
 #define BLE_LNS_MAX_ROUTE_NAME_LEN                                  (BLE_L2CAP_MTU_DEF - 5)           /**< The maximum length of length of a route name. */
 #define MAX_CTRL_POINT_RESP_PARAM_LEN                               BLE_LNS_MAX_ROUTE_NAME_LEN + 3  /**< Maximum length of a control point response. */
+#define LNCP_TRACK_DATA_MAX_LEN                                     (GATT_MTU_SIZE_DEFAULT - 3)     /**< Maximum length of a Route Track Data notification. */
 
 typedef struct ble_lncp_s ble_lncp_t;
 
@@ -136,7 +140,9 @@ typedef enum
     LNCP_OP_SELECT_ROUTE                     = 0x06, /**< Select Route. */
     LNCP_OP_SET_FIX_RATE                     = 0x07, /**< Set Fix Rate. */
     LNCP_OP_SET_ELEVATION                    = 0x08, /**< Set Elevation. */
-    LNCP_OP_RESPONSE_CODE                    = 0x20  /**< Response code. */
+    LNCP_OP_RESPONSE_CODE                    = 0x20, /**< Response code. */
+    LNCP_OP_REQ_ROUTE_TRACK                  = 0x80, /**< Request Route Track. Vendor specific. */
+    LNCP_OP_ROUTE_TRACK_DATA                 = 0x81  /**< Route Track Data, notified after the response to Request Route Track. Vendor specific. */
 } ble_lncp_op_code_t;
 
 
@@ -146,9 +152,30 @@ typedef enum
     LNCP_STATE_NO_PROC_IN_PROGRESS,                        /**< No procedure in progress. */
     LNCP_STATE_INDICATION_PENDING,                         /**< Control Point indication is pending. */
     LNCP_STATE_CONFIRMATION_PENDING,                 /**< Waiting for the indication confirmation. */
+    LNCP_STATE_TRACK_STREAMING,                            /**< Route Track Data is being notified. */
 } ble_lncp_procedure_status_t;
 
 
+#if NRF_MODULE_ENABLED(BLE_LN_TRACK)
+/** @brief State of a Request Route Track procedure.
+ *
+ * @details After the response, which holds the number of chunks, the chunks of the track are
+ *          notified on the control point, each split in Route Track Data notifications of the op
+ *          code followed by up to @ref LNCP_TRACK_DATA_MAX_LEN - 1 bytes. Notifications are queued
+ *          until the SoftDevice has no buffer left, and refilled on each TX complete event. A
+ *          notification with only the op code ends the track. Only one chunk is held in RAM.
+ */
+typedef struct
+{
+    bool                  is_pending;                             /**< The stream starts when the response is confirmed. */
+    ble_ln_track_cursor_t cursor;                                 /**< Next chunk to read. */
+    uint16_t              len;                                    /**< Length of the chunk being sent. */
+    uint16_t              offset;                                 /**< Bytes of the chunk already sent. */
+    uint8_t               chunk[BLE_LN_TRACK_CONFIG_CHUNK_SIZE];  /**< Chunk being sent. */
+} ble_lncp_track_stream_t;
+#endif
+
+
 /** @brief Information included in a control point write response indication. */
 typedef struct
 {
@@ -203,6 +230,10 @@ struct ble_lncp_s
 
     bool                        is_ctrlpt_indication_enabled;   /**< True if indication is enabled on the Control Point characteristic. */
     bool                        is_nav_notification_enabled;    /**< True if notification is enabled on the Navigation characteristic. */
+#if NRF_MODULE_ENABLED(BLE_LN_TRACK)
+    bool                        is_ctrlpt_notification_enabled; /**< True if notification is enabled on the Control Point characteristic, for Route Track Data. */
+    ble_lncp_track_stream_t     track_stream;                   /**< Request Route Track procedure. */
+#endif
 };
 
 
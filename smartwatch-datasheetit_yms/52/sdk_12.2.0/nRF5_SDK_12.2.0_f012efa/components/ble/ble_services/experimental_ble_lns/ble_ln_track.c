@@ -0,0 +1,402 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(BLE_LN_TRACK)
+#include "ble_ln_track.h"
+
+// Chunk layout.
+#define CHUNK_ROUTE_ID      0
+#define CHUNK_FLAGS         2
+#define CHUNK_FIX_COUNT     3
+#define CHUNK_LEN           4
+#define CHUNK_FIRST_FIX     5
+#define FIRST_FIX_LEN       15                      /**< Time, latitude, longitude and 24-bit elevation. */
+#define CHUNK_DELTAS        (CHUNK_FIRST_FIX + FIRST_FIX_LEN)
+#define VARINT_MAX_LEN      5
+#define DELTA_MAX_LEN       (4 * VARINT_MAX_LEN)
+
+STATIC_ASSERT(BLE_LN_TRACK_CONFIG_CHUNK_SIZE <= UINT8_MAX);
+STATIC_ASSERT(BLE_LN_TRACK_CONFIG_CHUNK_SIZE >= CHUNK_DELTAS + DELTA_MAX_LEN);
+
+/**@brief Track of a route. */
+typedef struct
+{
+    uint32_t first_seq;   /**< Sequence number of the first chunk. */
+    uint32_t last_seq;    /**< Sequence number of the last chunk. */
+    uint16_t chunk_count; /**< Number of chunks. 0 if the route has no track. */
+} track_t;
+
+static struct
+{
+    ts_store_t       * p_store;
+    track_t            tracks[BLE_LNS_MAX_NUM_ROUTES];
+    bool               recording;
+    uint16_t           route_id;                               /**< Route being recorded. */
+    uint8_t            flags;                                  /**< Flags of the chunk being filled. */
+    uint8_t            len;                                    /**< Length of the chunk being filled. 0 if it has no fix. */
+    ble_ln_track_fix_t last_fix;                               /**< Last fix of the chunk being filled. */
+    uint8_t            chunk[BLE_LN_TRACK_CONFIG_CHUNK_SIZE];  /**< Chunk being filled. */
+} m_cb;
+
+
+static uint8_t varint_encode(uint32_t value, uint8_t * p_encoded_data)
+{
+    uint8_t len = 0;
+
+    while (value >= 0x80)
+    {
+        p_encoded_data[len++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    p_encoded_data[len++] = (uint8_t)value;
+
+    return len;
+}
+
+
+static bool varint_decode(uint8_t const * p_data, uint8_t end, uint8_t * p_pos, uint32_t * p_value)
+{
+    uint32_t value = 0;
+    uint8_t  shift = 0;
+
+    while ((*p_pos < end) && (shift < 7 * VARINT_MAX_LEN))
+    {
+        uint8_t byte = p_data[(*p_pos)++];
+
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            *p_value = value;
+            return true;
+        }
+        shift += 7;
+    }
+
+    return false;
+}
+
+
+static uint32_t zigzag_encode(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+
+static int32_t zigzag_decode(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+
+/**@brief Function for subtracting two coordinates. A longitude difference can exceed the range of
+ *        int32_t, so it wraps around, and adding it back wraps the same way.
+ */
+static int32_t coord_diff(int32_t a, int32_t b)
+{
+    return (int32_t)((uint32_t)a - (uint32_t)b);
+}
+
+
+/**@brief Function for sign-extending a 24-bit elevation. */
+static int32_t elevation_decode(uint8_t const * p_data)
+{
+    return ((int32_t)(uint24_decode(p_data) << 8)) >> 8;
+}
+
+
+/**@brief Function for updating the track index with a chunk of the store. */
+static void track_index_update(uint8_t const * p_chunk, uint32_t seq)
+{
+    uint16_t route_id = uint16_decode(&p_chunk[CHUNK_ROUTE_ID]);
+
+    if (route_id >= BLE_LNS_MAX_NUM_ROUTES)
+    {
+        return;
+    }
+
+    track_t * p_track = &m_cb.tracks[route_id];
+
+    if ((p_chunk[CHUNK_FLAGS] & BLE_LN_TRACK_FLAG_START) || (p_track->chunk_count == 0))
+    {
+        p_track->first_seq   = seq;
+        p_track->chunk_count = 0;
+    }
+    p_track->last_seq = seq;
+    p_track->chunk_count++;
+}
+
+
+/**@brief Function for appending the chunk being filled to the store. */
+static ret_code_t chunk_store(void)
+{
+    ret_code_t err_code;
+    uint32_t   seq;
+
+    uint16_encode(m_cb.route_id, &m_cb.chunk[CHUNK_ROUTE_ID]);
+    m_cb.chunk[CHUNK_FLAGS] = m_cb.flags;
+    m_cb.chunk[CHUNK_LEN]   = m_cb.len;
+
+    err_code = ts_store_append(m_cb.p_store,
+                               uint32_decode(&m_cb.chunk[CHUNK_FIRST_FIX]),
+                               m_cb.chunk,
+                               &seq);
+    VERIFY_SUCCESS(err_code);
+
+    track_index_update(m_cb.chunk, seq);
+    m_cb.flags = 0;
+    m_cb.len   = 0;
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for starting a new chunk with a fix. */
+static void chunk_begin(ble_ln_track_fix_t const * p_fix)
+{
+    uint8_t len = CHUNK_FIRST_FIX;
+
+    memset(m_cb.chunk, 0, sizeof(m_cb.chunk));
+    len += uint32_encode(p_fix->time,                &m_cb.chunk[len]);
+    len += uint32_encode((uint32_t)p_fix->latitude,  &m_cb.chunk[len]);
+    len += uint32_encode((uint32_t)p_fix->longitude, &m_cb.chunk[len]);
+    len += uint24_encode((uint32_t)p_fix->elevation, &m_cb.chunk[len]);
+
+    m_cb.chunk[CHUNK_FIX_COUNT] = 1;
+    m_cb.len = len;
+}
+
+
+ret_code_t ble_ln_track_init(ts_store_t * p_store)
+{
+    ret_code_t        err_code;
+    ts_store_cursor_t cursor;
+    uint16_t          count;
+
+    VERIFY_PARAM_NOT_NULL(p_store);
+
+    if (p_store->record_size != BLE_LN_TRACK_CONFIG_CHUNK_SIZE)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    memset(&m_cb, 0, sizeof(m_cb));
+    m_cb.p_store = p_store;
+
+    // Rebuild the index from the chunk headers, one chunk at a time.
+    ts_store_cursor_init(p_store, &cursor, ts_store_first_seq(p_store), UINT32_MAX);
+    do
+    {
+        err_code = ts_store_cursor_read(p_store, &cursor, NULL, m_cb.chunk, 1, &count);
+        VERIFY_SUCCESS(err_code);
+
+        if (count > 0)
+        {
+            track_index_update(m_cb.chunk, cursor.next_seq - 1);
+        }
+    } while (count > 0);
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ble_ln_track_start(uint16_t route_id)
+{
+    if (route_id >= BLE_LNS_MAX_NUM_ROUTES)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if (m_cb.recording)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    m_cb.recording = true;
+    m_cb.route_id  = route_id;
+    m_cb.flags     = BLE_LN_TRACK_FLAG_START;
+    m_cb.len       = 0;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ble_ln_track_fix_add(ble_ln_track_fix_t const * p_fix)
+{
+    ret_code_t err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_fix);
+
+    if (!m_cb.recording)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if (m_cb.len > 0)
+    {
+        uint8_t delta[DELTA_MAX_LEN];
+        uint8_t len = 0;
+
+        if (p_fix->time < m_cb.last_fix.time)
+        {
+            return NRF_ERROR_INVALID_PARAM;
+        }
+
+        len += varint_encode(p_fix->time - m_cb.last_fix.time, &delta[len]);
+        len += varint_encode(zigzag_encode(coord_diff(p_fix->latitude,  m_cb.last_fix.latitude)),  &delta[len]);
+        len += varint_encode(zigzag_encode(coord_diff(p_fix->longitude, m_cb.last_fix.longitude)), &delta[len]);
+        len += varint_encode(zigzag_encode(p_fix->elevation - m_cb.last_fix.elevation), &delta[len]);
+
+        if ((m_cb.len + len <= BLE_LN_TRACK_CONFIG_CHUNK_SIZE) && (m_cb.chunk[CHUNK_FIX_COUNT] < UINT8_MAX))
+        {
+            memcpy(&m_cb.chunk[m_cb.len], delta, len);
+            m_cb.len += len;
+            m_cb.chunk[CHUNK_FIX_COUNT]++;
+            m_cb.last_fix = *p_fix;
+            return NRF_SUCCESS;
+        }
+
+        err_code = chunk_store();
+        VERIFY_SUCCESS(err_code);
+    }
+
+    chunk_begin(p_fix);
+    m_cb.last_fix = *p_fix;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ble_ln_track_stop(void)
+{
+    ret_code_t err_code;
+
+    if (m_cb.recording && (m_cb.len > 0))
+    {
+        err_code = chunk_store();
+        VERIFY_SUCCESS(err_code);
+    }
+    m_cb.recording = false;
+
+    return ts_store_flush(m_cb.p_store);
+}
+
+
+ret_code_t ble_ln_track_cursor_init(uint16_t                route_id,
+                                    ble_ln_track_cursor_t * p_cursor,
+                                    uint16_t              * p_chunk_count)
+{
+    VERIFY_PARAM_NOT_NULL(p_cursor);
+
+    if ((route_id >= BLE_LNS_MAX_NUM_ROUTES) || (m_cb.tracks[route_id].chunk_count == 0))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    track_t const * p_track = &m_cb.tracks[route_id];
+
+    ts_store_cursor_init(m_cb.p_store, &p_cursor->store_cursor, p_track->first_seq, p_track->last_seq);
+    p_cursor->route_id = route_id;
+
+    if (p_chunk_count != NULL)
+    {
+        *p_chunk_count = p_track->chunk_count;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ble_ln_track_chunk_read(ble_ln_track_cursor_t * p_cursor,
+                                   uint8_t               * p_chunk,
+                                   uint16_t              * p_len)
+{
+    ret_code_t err_code;
+    uint16_t   count;
+
+    // Chunks of other routes recorded in between are skipped.
+    do
+    {
+        err_code = ts_store_cursor_read(m_cb.p_store, &p_cursor->store_cursor, NULL, p_chunk, 1, &count);
+        VERIFY_SUCCESS(err_code);
+
+        if (count == 0)
+        {
+            return NRF_ERROR_NOT_FOUND;
+        }
+    } while (uint16_decode(&p_chunk[CHUNK_ROUTE_ID]) != p_cursor->route_id);
+
+    *p_len = p_chunk[CHUNK_LEN];
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ble_ln_track_chunk_decode(uint8_t const      * p_chunk,
+                                     ble_ln_track_fix_t * p_fixes,
+                                     uint8_t              max_fixes,
+                                     uint8_t            * p_count)
+{
+    uint8_t const      end = p_chunk[CHUNK_LEN];
+    uint8_t            pos = CHUNK_DELTAS;
+    uint8_t            count;
+    ble_ln_track_fix_t fix;
+
+    if ((end < CHUNK_DELTAS) || (end > BLE_LN_TRACK_CONFIG_CHUNK_SIZE) || (p_chunk[CHUNK_FIX_COUNT] == 0))
+    {
+        return NRF_ERROR_INVALID_DATA;
+    }
+
+    fix.time      = uint32_decode(&p_chunk[CHUNK_FIRST_FIX]);
+    fix.latitude  = (int32_t)uint32_decode(&p_chunk[CHUNK_FIRST_FIX + 4]);
+    fix.longitude = (int32_t)uint32_decode(&p_chunk[CHUNK_FIRST_FIX + 8]);
+    fix.elevation = elevation_decode(&p_chunk[CHUNK_FIRST_FIX + 12]);
+
+    for (count = 0; (count < max_fixes) && (count < p_chunk[CHUNK_FIX_COUNT]); count++)
+    {
+        if (count > 0)
+        {
+            uint32_t dt, dlat, dlon, delev;
+
+            if (   !varint_decode(p_chunk, end, &pos, &dt)
+                || !varint_decode(p_chunk, end, &pos, &dlat)
+                || !varint_decode(p_chunk, end, &pos, &dlon)
+                || !varint_decode(p_chunk, end, &pos, &delev))
+            {
+                *p_count = count;
+                return NRF_ERROR_INVALID_DATA;
+            }
+
+            fix.time      += dt;
+            fix.latitude  = (int32_t)((uint32_t)fix.latitude  + (uint32_t)zigzag_decode(dlat));
+            fix.longitude = (int32_t)((uint32_t)fix.longitude + (uint32_t)zigzag_decode(dlon));
+            fix.elevation += zigzag_decode(delev);
+        }
+        p_fixes[count] = fix;
+    }
+
+    *p_count = count;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ble_ln_track_clear(void)
+{
+    memset(m_cb.tracks, 0, sizeof(m_cb.tracks));
+
+    // A track being recorded goes on from its next chunk.
+    m_cb.flags |= BLE_LN_TRACK_FLAG_START;
+
+    return ts_store_clear(m_cb.p_store);
+}
+
+#endif // NRF_MODULE_ENABLED(BLE_LN_TRACK)
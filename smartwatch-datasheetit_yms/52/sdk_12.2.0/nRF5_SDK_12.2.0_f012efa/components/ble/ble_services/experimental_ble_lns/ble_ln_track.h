@@ -0,0 +1,187 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ble_sdk_srv_ln_track Location and Navigation track store
+ * @{
+ * @ingroup ble_sdk_srv
+ * @brief Location and Navigation track store module.
+ *
+ * @details This module records the position fixes of a route in flash, delta-encoded, and reads
+ *          them back chunk by chunk for the Request Route Track procedure of the control point.
+ *
+ *          Fixes are packed into chunks of @ref BLE_LN_TRACK_CONFIG_CHUNK_SIZE bytes. A chunk
+ *          starts with a header and the first fix in full, followed by the differences from one
+ *          fix to the next: time, latitude, longitude and elevation, each as a variable-length
+ *          integer of 7 bits per byte, zigzag-encoded when signed. At 1 Hz, a fix takes 5 to 7
+ *          bytes instead of the 20 bytes of a Location and Speed notification, and two hours fit
+ *          in about 45 kB. Each chunk is one record of a @ref ts_store, which collects chunks into
+ *          FDS records.
+ *
+ *          Chunk format, little endian:
+ *          - route ID (2 bytes), flags (1 byte), number of fixes (1 byte), length of the chunk
+ *            in bytes, header included (1 byte),
+ *          - first fix: time (4 bytes), latitude (4 bytes), longitude (4 bytes), elevation
+ *            (3 bytes),
+ *          - for each following fix: time difference (unsigned), then latitude, longitude and
+ *            elevation differences (zigzag).
+ *
+ *          The first chunk of a track has the @ref BLE_LN_TRACK_FLAG_START flag. Starting a new
+ *          track for a route hides its previous track. The chunk index of the routes is rebuilt
+ *          from flash by @ref ble_ln_track_init.
+ *
+ * @note The functions must be called in the context of the FDS events, see @ref ts_store.
+ */
+
+#ifndef BLE_LN_TRACK_H__
+#define BLE_LN_TRACK_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_ln_common.h"
+#include "ts_store.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Size of a chunk, in bytes. At most 255. The record size of the store must be the same.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_LN_TRACK_CONFIG_CHUNK_SIZE
+#define BLE_LN_TRACK_CONFIG_CHUNK_SIZE 128
+#endif
+
+#define BLE_LN_TRACK_FLAG_START  0x01 /**< The chunk is the first one of a track. */
+
+/**@brief Position fix. */
+typedef struct
+{
+    uint32_t time;      /**< Time of the fix, in seconds. Must not decrease within a track. */
+    int32_t  latitude;  /**< Latitude (10e-7 degrees). */
+    int32_t  longitude; /**< Longitude (10e-7 degrees). */
+    int32_t  elevation; /**< Elevation (1/100 meters), size=24 bits. */
+} ble_ln_track_fix_t;
+
+/**@brief Cursor for reading the chunks of a track. */
+typedef struct
+{
+    ts_store_cursor_t store_cursor; /**< Cursor in the store. */
+    uint16_t          route_id;     /**< Route of the track. */
+} ble_ln_track_cursor_t;
+
+/**@brief Function for initializing the module and rebuilding the index of the tracks.
+ *
+ * @param[in] p_store Initialized store, with records of @ref BLE_LN_TRACK_CONFIG_CHUNK_SIZE bytes.
+ *
+ * @retval NRF_SUCCESS             If the module was initialized.
+ * @retval NRF_ERROR_NULL          If p_store was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If the record size of the store does not match.
+ * @return Other errors from the store.
+ */
+ret_code_t ble_ln_track_init(ts_store_t * p_store);
+
+/**@brief Function for starting the track of a route.
+ *
+ * @param[in] route_id ID of the route, as given by @ref ble_lns_add_route.
+ *
+ * @retval NRF_SUCCESS             If the track was started.
+ * @retval NRF_ERROR_INVALID_PARAM If the route ID is out of range.
+ * @retval NRF_ERROR_INVALID_STATE If a track is already being recorded.
+ */
+ret_code_t ble_ln_track_start(uint16_t route_id);
+
+/**@brief Function for adding a fix to the track being recorded.
+ *
+ * @details The fix is added to the chunk in RAM. When it does not fit, the chunk is appended to
+ *          the store and a new chunk is started with this fix.
+ *
+ * @param[in] p_fix Fix.
+ *
+ * @retval NRF_SUCCESS             If the fix was added.
+ * @retval NRF_ERROR_NULL          If p_fix was NULL.
+ * @retval NRF_ERROR_INVALID_STATE If no track is being recorded.
+ * @retval NRF_ERROR_INVALID_PARAM If the time is older than the previous fix.
+ * @retval NRF_ERROR_BUSY          If the chunk is full and the store is busy. The fix was not added.
+ * @return Other errors from the store.
+ */
+ret_code_t ble_ln_track_fix_add(ble_ln_track_fix_t const * p_fix);
+
+/**@brief Function for ending the track being recorded and writing it to flash.
+ *
+ * @retval NRF_SUCCESS    If the last chunk was appended and the store was flushed.
+ * @retval NRF_ERROR_BUSY If the store is busy. The function must be called again.
+ * @return Other errors from the store.
+ */
+ret_code_t ble_ln_track_stop(void);
+
+/**@brief Function for initializing a cursor over the track of a route.
+ *
+ * @param[in]  route_id      ID of the route.
+ * @param[out] p_cursor      Cursor.
+ * @param[out] p_chunk_count Number of chunks of the track. Less are read if the oldest chunks of
+ *                           the store were deleted to make room. Can be NULL.
+ *
+ * @retval NRF_SUCCESS         If the cursor was initialized.
+ * @retval NRF_ERROR_NULL      If p_cursor was NULL.
+ * @retval NRF_ERROR_NOT_FOUND If the route has no track.
+ */
+ret_code_t ble_ln_track_cursor_init(uint16_t                route_id,
+                                    ble_ln_track_cursor_t * p_cursor,
+                                    uint16_t              * p_chunk_count);
+
+/**@brief Function for reading the next chunk of a track.
+ *
+ * @param[in,out] p_cursor Cursor.
+ * @param[out]    p_chunk  Buffer of @ref BLE_LN_TRACK_CONFIG_CHUNK_SIZE bytes.
+ * @param[out]    p_len    Length of the chunk. The bytes after it are not used.
+ *
+ * @retval NRF_SUCCESS         If a chunk was read.
+ * @retval NRF_ERROR_NOT_FOUND If there are no more chunks.
+ * @return Other errors from the store.
+ */
+ret_code_t ble_ln_track_chunk_read(ble_ln_track_cursor_t * p_cursor,
+                                   uint8_t               * p_chunk,
+                                   uint16_t              * p_len);
+
+/**@brief Function for decoding the fixes of a chunk.
+ *
+ * @param[in]  p_chunk   Chunk.
+ * @param[out] p_fixes   Fixes.
+ * @param[in]  max_fixes Size of p_fixes.
+ * @param[out] p_count   Number of fixes decoded.
+ *
+ * @retval NRF_SUCCESS            If the fixes were decoded, up to max_fixes.
+ * @retval NRF_ERROR_INVALID_DATA If the chunk is malformed.
+ */
+ret_code_t ble_ln_track_chunk_decode(uint8_t const      * p_chunk,
+                                     ble_ln_track_fix_t * p_fixes,
+                                     uint8_t              max_fixes,
+                                     uint8_t            * p_count);
+
+/**@brief Function for deleting all tracks.
+ *
+ * @return Errors from the store.
+ */
+ret_code_t ble_ln_track_clear(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLE_LN_TRACK_H__
+
+/** @} */
@@ -115,6 +115,9 @@ static void on_connect(ble_lns_t * p_lns, ble_evt_t const * p_ble_evt)
     p_lns->pending_loc_speed_notifications[0].is_pending    = false;
     p_lns->pending_loc_speed_notifications[1].is_pending    = false;
     p_lns->pending_navigation_notification.is_pending       = false;
+
+    // the first sample is sent
+    p_lns->loc_speed_countdown                              = 0;
 }
 
 
@@ -174,6 +177,7 @@ static void on_loc_speed_cccd_write(ble_lns_t                   * p_lns,
     {
         // CCCD written, update notification state
         p_lns->is_loc_speed_notification_enabled = ble_srv_is_notification_enabled(p_evt_write->data);
+        p_lns->loc_speed_countdown               = 0;
         if (p_lns->evt_handler != NULL)
         {
             ble_lns_evt_t evt;
@@ -796,6 +800,9 @@ ret_code_t ble_lns_init(ble_lns_t * p_lns, ble_lns_init_t const * p_lns_init)
     p_lns->is_loc_speed_notification_enabled             = false;
     p_lns->is_nav_notification_enabled                   = false;
 
+    p_lns->loc_speed_decimation                          = MAX(p_lns_init->loc_speed_decimation, 1);
+    p_lns->loc_speed_countdown                           = 0;
+
     ble_ln_db_init();
 
     // Add service
@@ -883,6 +890,14 @@ ret_code_t ble_lns_loc_speed_send(ble_lns_t * p_lns)
         return NRF_ERROR_INVALID_STATE;
     }
 
+    // only one of every loc_speed_decimation samples is sent
+    if (p_lns->loc_speed_countdown > 0)
+    {
+        p_lns->loc_speed_countdown--;
+        return NRF_SUCCESS;
+    }
+    p_lns->loc_speed_countdown = p_lns->loc_speed_decimation - 1;
+
     notification_t * notif1 = &p_lns->pending_loc_speed_notifications[0];
     notification_t * notif2 = &p_lns->pending_loc_speed_notifications[1];
 
@@ -922,6 +937,17 @@ ret_code_t ble_lns_loc_speed_send(ble_lns_t * p_lns)
 }
 
 
+ret_code_t ble_lns_loc_speed_decimation_set(ble_lns_t * p_lns, uint8_t decimation)
+{
+    VERIFY_PARAM_NOT_NULL(p_lns);
+
+    p_lns->loc_speed_decimation = MAX(decimation, 1);
+    p_lns->loc_speed_countdown  = 0;
+
+    return NRF_SUCCESS;
+}
+
+
 ret_code_t ble_lns_navigation_send(ble_lns_t * p_lns)
 {
     VERIFY_PARAM_NOT_NULL(p_lns);
@@ -95,6 +95,7 @@ struct ble_lns_init_s
     security_req_t              ctrl_point_security_req_cccd_write_perm; /**< CCCD write security level of the LN Control Point characteristic. */
 
     uint32_t                    available_features;                      /**< Value of the LN feature. */
+    uint8_t                     loc_speed_decimation;                    /**< Only one of every loc_speed_decimation calls to @ref ble_lns_loc_speed_send is notified. 0 or 1 to notify all of them. */
     ble_lns_loc_speed_t         * p_location_speed;                      /**< Initial Location and Speed. */
     ble_lns_pos_quality_t       * p_position_quality;                    /**< Initial Position Quality. */
     ble_lns_navigation_t        * p_navigation;                          /**< Initial Navigation data structure. */
@@ -128,6 +129,8 @@ struct ble_lns_s
 
     bool                              is_loc_speed_notification_enabled;                 /**< True if notification is enabled on the Location and Speed characteristic. */
     bool                              is_nav_notification_enabled;                       /**< True if notification is enabled on the Navigation characteristic. */
+    uint8_t                           loc_speed_decimation;                              /**< One of every loc_speed_decimation Location and Speed samples is notified. */
+    uint8_t                           loc_speed_countdown;                               /**< Samples to skip before the next notification. */
 
     notification_t                    pending_loc_speed_notifications[2];                /**< This buffer holds location and speed notifications. */
     notification_t                    pending_navigation_notification;                   /**< This buffer holds navigation notifications. */
@@ -281,12 +284,30 @@ void ble_lns_on_ble_evt(ble_lns_t * p_lns, ble_evt_t const * p_ble_evt);
  *
  * @param[in]     p_lns                   Location and Navigation Service structure holding the location and speed data.
  *
- * @retval        NRF_SUCCESS             If the data was sent successfully.
+ * @retval        NRF_SUCCESS             If the data was sent successfully, or skipped because of the
+ *                                        decimation.
  * @retval        NRF_ERROR_NULL          If a NULL parameter was provided.
  * @retval        NRF_ERROR_INVALID_STATE If notification is disabled.
  */
 ret_code_t ble_lns_loc_speed_send(ble_lns_t * p_lns);
 
+/**@brief   Function for setting the decimation of the location and speed notifications.
+ *
+ * @details With a decimation of N, only one of every N calls to @ref ble_lns_loc_speed_send is
+ *          notified, starting with the first one after notification was enabled. A fix rate
+ *          requested through the control point, see @ref LNCP_EVT_FIX_RATE_SET, can be applied
+ *          here while the positions are still recorded at the rate of the receiver, for example
+ *          with @ref ble_ln_track_fix_add.
+ *
+ * @param[in]     p_lns                   Location and Navigation Service structure.
+ * @param[in]     decimation              One of every decimation samples is notified. 0 or 1 to
+ *                                        notify all of them.
+ *
+ * @retval        NRF_SUCCESS             If the decimation was set.
+ * @retval        NRF_ERROR_NULL          If a NULL parameter was provided.
+ */
+ret_code_t ble_lns_loc_speed_decimation_set(ble_lns_t * p_lns, uint8_t decimation);
+
 /**@brief Function for sending navigation data if notification has been enabled.
  *
  * @details The application calls this function after having performed a navigation determination.
@@ -0,0 +1,23 @@
+/**
+ *
+ * @defgroup ble_lns_config Location and Navigation Service configuration
+ * @{
+ * @ingroup ble_lns
+ */
+/** @brief Record the tracks of the routes in flash, and stream them through the control point.
+ *
+ *  Set to 1 to activate. Requires TS_STORE_ENABLED and FDS.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_LN_TRACK_ENABLED
+
+/** @brief Size of a track chunk, in bytes. At most 255.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_LN_TRACK_CONFIG_CHUNK_SIZE
+
+
+
+/** @} */
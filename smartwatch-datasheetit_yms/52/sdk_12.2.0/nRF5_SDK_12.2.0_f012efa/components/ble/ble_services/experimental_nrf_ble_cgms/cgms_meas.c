@@ -164,7 +164,7 @@ ret_code_t cgms_meas_send(nrf_ble_cgms_t * p_cgms, ble_cgms_rec_t * p_rec, uint8
         {
             // Measurement successfully sent
             p_cgms->racp_data.racp_proc_records_reported++;
-            p_cgms->racp_data.racp_proc_records_reported_since_txcomplete++;
+            p_cgms->racp_data.racp_proc_tx_pending++;
         }
     }
 
@@ -66,7 +66,7 @@ static void racp_send(nrf_ble_cgms_t * p_cgms, ble_racp_value_t * p_racp_val)
     if (
         (p_cgms->cgms_com_state != STATE_RACP_RESPONSE_PENDING)
         &&
-        (p_cgms->racp_data.racp_proc_records_reported_since_txcomplete > 0)
+        (p_cgms->racp_data.racp_proc_tx_pending > 0)
        )
     {
         p_cgms->cgms_com_state = STATE_RACP_RESPONSE_PENDING;
@@ -145,256 +145,101 @@ static void racp_response_code_send(nrf_ble_cgms_t * p_cgms, uint8_t opcode, uin
 }
 
 
-/**@brief Function for responding to the ALL operation.
+/**@brief Function for setting the range of database records of a REPORT RECORDS request.
  *
- * @param[in]   p_cgms   Service instance.
+ * @details The range is fixed when the request is received. Records added to the database
+ *          during the procedure are not reported.
  *
- * @return      NRF_SUCCESS on success, otherwise an error code.
+ * @param[in]   p_cgms   Service instance.
  */
-static uint32_t racp_report_records_all(nrf_ble_cgms_t * p_cgms)
+static void racp_report_records_range_set(nrf_ble_cgms_t * p_cgms)
 {
-    uint16_t total_records = cgms_db_num_records_get();
-    uint16_t cur_nb_rec;
-    uint8_t  i;
-    uint8_t  nb_rec_to_send;
+    nrf_ble_cgms_racp_t * p_racp        = &p_cgms->racp_data;
+    uint16_t              total_records = cgms_db_num_records_get();
+    uint16_t              offset;
 
-    if (p_cgms->racp_data.racp_proc_record_ndx >= total_records)
-    {
-        p_cgms->cgms_com_state = STATE_NO_COMM;
-    }
-    else
+    p_racp->racp_proc_record_ndx = 0;
+    p_racp->racp_proc_record_end = total_records;
+
+    switch (p_racp->racp_proc_operator)
     {
-        uint32_t       err_code;
-        ble_cgms_rec_t rec[NRF_BLE_CGMS_MEAS_REC_PER_NOTIF_MAX];
+        case RACP_OPERATOR_ALL:
+            break;
 
-        cur_nb_rec = total_records - p_cgms->racp_data.racp_proc_record_ndx;
-        if (cur_nb_rec > NRF_BLE_CGMS_MEAS_REC_PER_NOTIF_MAX)
-        {
-            cur_nb_rec = NRF_BLE_CGMS_MEAS_REC_PER_NOTIF_MAX;
-        }
-        nb_rec_to_send = (uint8_t)cur_nb_rec;
+        case RACP_OPERATOR_FIRST:
+            p_racp->racp_proc_record_end = (total_records > 0) ? 1 : 0;
+            break;
 
-        for (i = 0; i < cur_nb_rec; i++)
-        {
-            err_code = cgms_db_record_get(p_cgms->racp_data.racp_proc_record_ndx + i, &(rec[i]));
-            if (err_code != NRF_SUCCESS)
+        case RACP_OPERATOR_LAST:
+            p_racp->racp_proc_record_ndx = (total_records > 0) ? (total_records - 1) : 0;
+            break;
+
+        case RACP_OPERATOR_GREATER_OR_EQUAL:
+        case RACP_OPERATOR_LESS_OR_EQUAL:
+            if (p_racp->racp_request.operand_len != 2)
             {
-                return err_code;
+                if (p_cgms->error_handler != NULL)
+                {
+                    p_cgms->error_handler(NRF_ERROR_INVALID_LENGTH);
+                }
             }
-        }
-        err_code = cgms_meas_send(p_cgms, rec, &nb_rec_to_send);
-        if (err_code != NRF_SUCCESS)
-        {
-            return err_code;
-        }
-        p_cgms->racp_data.racp_proc_record_ndx += nb_rec_to_send;
-    }
-
-    return NRF_SUCCESS;
-}
-
-
-/**@brief Function for responding to the FIRST or the LAST operation.
- *
- * @param[in]   p_cgms   Service instance.
- *
- * @return      NRF_SUCCESS on success, otherwise an error code.
- */
-static uint32_t racp_report_records_first_last(nrf_ble_cgms_t * p_cgms)
-{
-    uint32_t       err_code;
-    ble_cgms_rec_t rec;
-    uint16_t       total_records;
-    uint8_t        nb_rec_to_send = 1;
 
-    total_records = cgms_db_num_records_get();
-
-    if ((p_cgms->racp_data.racp_proc_records_reported != 0) || (total_records == 0))
-    {
-        p_cgms->cgms_com_state = STATE_NO_COMM;
-    }
-    else
-    {
-        if (p_cgms->racp_data.racp_proc_operator == RACP_OPERATOR_FIRST)
-        {
-            err_code = cgms_db_record_get(0, &rec);
-            if (err_code != NRF_SUCCESS)
+            offset = uint16_decode(p_racp->racp_request.p_operand);
+            if (offset >= total_records)
             {
-                return err_code;
+                // Nothing to report.
+                p_racp->racp_proc_record_end = 0;
             }
-        }
-        else if (p_cgms->racp_data.racp_proc_operator == RACP_OPERATOR_LAST)
-        {
-            err_code = cgms_db_record_get(total_records - 1, &rec);
-            if (err_code != NRF_SUCCESS)
+            else if (p_racp->racp_proc_operator == RACP_OPERATOR_GREATER_OR_EQUAL)
             {
-                return err_code;
+                p_racp->racp_proc_record_ndx = offset;
             }
-        }
-
-        err_code = cgms_meas_send(p_cgms, &rec, &nb_rec_to_send);
-        if (err_code != NRF_SUCCESS)
-        {
-            return err_code;
-        }
-        p_cgms->racp_data.racp_proc_record_ndx++;
-    }
-
-    return NRF_SUCCESS;
-}
-
-
-/**@brief Function for responding to the LESS OR EQUAL operation.
- *
- * @param[in]   p_cgms   Service instance.
- *
- * @return      NRF_SUCCESS on success, otherwise an error code.
- */
-static ret_code_t racp_report_records_less_equal(nrf_ble_cgms_t * p_cgms)
-{
-    uint16_t total_rec_nb;
-    uint16_t total_rec_nb_to_send;
-    uint16_t rec_nb_left_to_send;
-    uint8_t nb_rec_to_send;
-    uint16_t offset;
-    uint16_t i;
-
-    if(p_cgms->racp_data.racp_request.operand_len != 2)
-    {
-        if (p_cgms->error_handler != NULL)
-        {
-            p_cgms->error_handler(NRF_ERROR_INVALID_LENGTH);
-        }
-    }
-
-    total_rec_nb         = cgms_db_num_records_get();
-
-    offset = uint16_decode(p_cgms->racp_data.racp_request.p_operand);
-    if (offset >= total_rec_nb)
-    {
-        p_cgms->cgms_com_state = STATE_NO_COMM;
-        return NRF_SUCCESS;
-    }
-
-    total_rec_nb_to_send = offset;
-
-    if (p_cgms->racp_data.racp_proc_record_ndx >= total_rec_nb_to_send)
-    {
-        p_cgms->cgms_com_state = STATE_NO_COMM;
-    }
-    else
-    {
-        uint32_t       err_code;
-        ble_cgms_rec_t rec[NRF_BLE_CGMS_MEAS_REC_PER_NOTIF_MAX];
-
-        rec_nb_left_to_send = total_rec_nb_to_send - p_cgms->racp_data.racp_proc_records_reported;
-        
-        if (rec_nb_left_to_send > NRF_BLE_CGMS_MEAS_REC_PER_NOTIF_MAX)
-        {
-            nb_rec_to_send = NRF_BLE_CGMS_MEAS_REC_PER_NOTIF_MAX;
-        }
-        else
-        {
-            nb_rec_to_send = (uint8_t)rec_nb_left_to_send;
-        }
-
-        p_cgms->racp_data.racp_proc_record_ndx = 0;
-
-        for (i = 0; i < nb_rec_to_send; i++)
-        {
-            err_code = cgms_db_record_get(p_cgms->racp_data.racp_proc_record_ndx + i, &(rec[i]));
-            if (err_code != NRF_SUCCESS)
+            else
             {
-                return err_code;
+                p_racp->racp_proc_record_end = offset + 1;
             }
-        }
-        err_code = cgms_meas_send(p_cgms, rec, &nb_rec_to_send);
-        if (err_code != NRF_SUCCESS)
-        {
-            return err_code;
-        }
-        p_cgms->racp_data.racp_proc_record_ndx += nb_rec_to_send;
+            break;
+
+        default:
+            p_racp->racp_proc_record_end = 0;
+            break;
     }
-   
-   return NRF_SUCCESS;
 }
 
 
-/**@brief Function for responding to the GREATER OR EQUAL operation.
+/**@brief Function for reading the records of the next notification from the database.
  *
  * @param[in]   p_cgms   Service instance.
  *
  * @return      NRF_SUCCESS on success, otherwise an error code.
  */
-static ret_code_t racp_report_records_greater_equal(nrf_ble_cgms_t * p_cgms)
+static ret_code_t racp_report_records_prefetch(nrf_ble_cgms_t * p_cgms)
 {
-    uint16_t total_rec_nb;
-    uint16_t total_rec_nb_to_send;
-    uint16_t rec_nb_left_to_send;
-    uint8_t nb_rec_to_send;
-    uint16_t offset;
-    uint16_t i;
-
-    if(p_cgms->racp_data.racp_request.operand_len != 2)
-    {
-        if (p_cgms->error_handler != NULL)
-        {
-            p_cgms->error_handler(NRF_ERROR_INVALID_LENGTH);
-        }
-    }
+    nrf_ble_cgms_racp_t * p_racp = &p_cgms->racp_data;
+    uint16_t              count  = p_racp->racp_proc_record_end - p_racp->racp_proc_record_ndx;
+    uint8_t               i;
 
-    total_rec_nb         = cgms_db_num_records_get();
-
-    offset = uint16_decode(p_cgms->racp_data.racp_request.p_operand);
-    if (offset >= total_rec_nb)
+    if (count > NRF_BLE_CGMS_MEAS_REC_PER_NOTIF_MAX)
     {
-        p_cgms->cgms_com_state = STATE_NO_COMM;
-        return NRF_SUCCESS;
+        count = NRF_BLE_CGMS_MEAS_REC_PER_NOTIF_MAX;
     }
 
-    total_rec_nb_to_send = total_rec_nb - offset;
-
-    if (p_cgms->racp_data.racp_proc_record_ndx >= total_rec_nb_to_send)
-    {
-        p_cgms->cgms_com_state = STATE_NO_COMM;
-    }
-    else
+    for (i = 0; i < count; i++)
     {
-        uint32_t       err_code;
-        ble_cgms_rec_t rec[NRF_BLE_CGMS_MEAS_REC_PER_NOTIF_MAX];
-
-        rec_nb_left_to_send = total_rec_nb_to_send - p_cgms->racp_data.racp_proc_records_reported;
-        
-        if (rec_nb_left_to_send > NRF_BLE_CGMS_MEAS_REC_PER_NOTIF_MAX)
-        {
-            nb_rec_to_send = NRF_BLE_CGMS_MEAS_REC_PER_NOTIF_MAX;
-        }
-        else
-        {
-            nb_rec_to_send = (uint8_t)rec_nb_left_to_send;
-        }
-
-        p_cgms->racp_data.racp_proc_record_ndx = offset;
-
-        for (i = 0; i < nb_rec_to_send; i++)
-        {
-            err_code = cgms_db_record_get(p_cgms->racp_data.racp_proc_record_ndx + i, &(rec[i]));
-            if (err_code != NRF_SUCCESS)
-            {
-                return err_code;
-            }
-        }
-        err_code = cgms_meas_send(p_cgms, rec, &nb_rec_to_send);
+        ret_code_t err_code = cgms_db_record_get(p_racp->racp_proc_record_ndx + i,
+                                                 &p_racp->racp_proc_recs[i]);
         if (err_code != NRF_SUCCESS)
         {
             return err_code;
         }
-        p_cgms->racp_data.racp_proc_record_ndx += nb_rec_to_send;
     }
-   
-   return NRF_SUCCESS;
+    p_racp->racp_proc_record_ndx += count;
+    p_racp->racp_proc_rec_count   = (uint8_t)count;
+
+    return NRF_SUCCESS;
 }
 
+
 /**@brief Function for informing that the REPORT RECORDS procedure is completed.
  *
  * @param[in]   p_cgms   Service instance.
@@ -417,57 +262,53 @@ static void racp_report_records_completed(nrf_ble_cgms_t * p_cgms)
 
 
 /**@brief Function for the RACP report records procedure.
+ *
+ * @details Sends notifications until the SoftDevice has no more TX buffers, and is called again
+ *          on each TX_COMPLETE event to refill them. The records that could not be sent are kept,
+ *          so they are not read again from the database. An ABORT OPERATION request ends the
+ *          procedure by changing the state.
  *
  * @param[in]   p_cgms   Service instance.
  */
 static void racp_report_records_procedure(nrf_ble_cgms_t * p_cgms)
 {
-    uint32_t err_code;
+    nrf_ble_cgms_racp_t * p_racp = &p_cgms->racp_data;
+    ret_code_t            err_code;
 
     while (p_cgms->cgms_com_state == STATE_RACP_PROC_ACTIVE)
     {
-        // Execute requested procedure
-        switch (p_cgms->racp_data.racp_proc_operator)
-        {
-            case RACP_OPERATOR_ALL:
-                err_code = racp_report_records_all(p_cgms);
-                break;
+        uint8_t nb_rec_sent = 0;
 
-            case RACP_OPERATOR_FIRST:
-            case RACP_OPERATOR_LAST:
-                err_code = racp_report_records_first_last(p_cgms);
-                break;
-            case RACP_OPERATOR_GREATER_OR_EQUAL:
-                err_code = racp_report_records_greater_equal(p_cgms);
-                break;
-            case RACP_OPERATOR_LESS_OR_EQUAL:
-                err_code = racp_report_records_less_equal(p_cgms);
-                break;
-            default:
-                // Report error to application
-                if (p_cgms->error_handler != NULL)
-                {
-                    p_cgms->error_handler(NRF_ERROR_INTERNAL);
-                }
-
-                // Make sure state machine returns to the default state
-                // state_set(STATE_NO_COMM);
+        if (p_racp->racp_proc_rec_count == 0)
+        {
+            if (p_racp->racp_proc_record_ndx >= p_racp->racp_proc_record_end)
+            {
                 p_cgms->cgms_com_state = STATE_NO_COMM;
+                racp_report_records_completed(p_cgms);
                 return;
+            }
+            err_code = racp_report_records_prefetch(p_cgms);
+        }
+        else
+        {
+            err_code = NRF_SUCCESS;
+        }
+
+        if (err_code == NRF_SUCCESS)
+        {
+            nb_rec_sent = p_racp->racp_proc_rec_count;
+            err_code    = cgms_meas_send(p_cgms, p_racp->racp_proc_recs, &nb_rec_sent);
         }
 
         // Error handling
         switch (err_code)
         {
             case NRF_SUCCESS:
-                if (p_cgms->cgms_com_state == STATE_RACP_PROC_ACTIVE)
-                {
-                    //p_cgms->racp_data.racp_proc_record_ndx++;
-                }
-                else
-                {
-                    racp_report_records_completed(p_cgms);
-                }
+                // Keep the records that did not fit in the notification for the next one.
+                p_racp->racp_proc_rec_count -= nb_rec_sent;
+                memmove(&p_racp->racp_proc_recs[0],
+                        &p_racp->racp_proc_recs[nb_rec_sent],
+                        p_racp->racp_proc_rec_count * sizeof(ble_cgms_rec_t));
                 break;
 
             case BLE_ERROR_NO_TX_PACKETS:
@@ -599,10 +440,11 @@ static void report_records_request_execute(nrf_ble_cgms_t   * p_cgms,
 {
     p_cgms->cgms_com_state = STATE_RACP_PROC_ACTIVE;
 
-    p_cgms->racp_data.racp_proc_record_ndx       = 0;
     p_cgms->racp_data.racp_proc_operator         = p_racp_request->operator;
     p_cgms->racp_data.racp_proc_records_reported = 0;
-    //p_cgms->
+    p_cgms->racp_data.racp_proc_rec_count        = 0;
+
+    racp_report_records_range_set(p_cgms);
     racp_report_records_procedure(p_cgms);
 }
 
@@ -751,14 +593,23 @@ void cgms_racp_on_rw_auth_req(nrf_ble_cgms_t                       * p_cgms,
 
 
 /**@brief Function for handling the TX_COMPLETE event.
+ *
+ * @details The event reports the number of packets sent, so that many TX buffers are free
+ *          again. A pending RACP response is sent once all reported notifications are out.
  *
  * @param[in]   p_cgms      Glucose Service structure.
+ * @param[in]   count       Number of packets sent.
  */
-void cgms_racp_on_tx_complete(nrf_ble_cgms_t * p_cgms)
+void cgms_racp_on_tx_complete(nrf_ble_cgms_t * p_cgms, uint8_t count)
 {
-    p_cgms->racp_data.racp_proc_records_reported_since_txcomplete = 0;
+    nrf_ble_cgms_racp_t * p_racp = &p_cgms->racp_data;
+
+    // The count includes packets of other characteristics, so do not go below zero.
+    p_racp->racp_proc_tx_pending = (count < p_racp->racp_proc_tx_pending) ?
+                                   (p_racp->racp_proc_tx_pending - count) : 0;
 
-    if (p_cgms->cgms_com_state == STATE_RACP_RESPONSE_PENDING)
+    if ((p_cgms->cgms_com_state == STATE_RACP_RESPONSE_PENDING) &&
+        (p_racp->racp_proc_tx_pending == 0))
     {
         racp_send(p_cgms, &p_cgms->racp_data.pending_racp_response);
     }
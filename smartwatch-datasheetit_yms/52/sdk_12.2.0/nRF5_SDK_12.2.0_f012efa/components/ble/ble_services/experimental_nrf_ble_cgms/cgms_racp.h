@@ -59,8 +59,9 @@ void cgms_racp_on_rw_auth_req(nrf_ble_cgms_t                       * p_cgms,
 /**@brief Function for handling @ref BLE_EVT_TX_COMPLETE events.
  *
  * @param[in] p_cgms Instance of the CGM Service.
+ * @param[in] count  Number of packets sent, from the event.
  */
-void cgms_racp_on_tx_complete(nrf_ble_cgms_t * p_cgms);
+void cgms_racp_on_tx_complete(nrf_ble_cgms_t * p_cgms, uint8_t count);
 
 #ifdef __cplusplus
 }
@@ -222,7 +222,7 @@ ret_code_t nrf_ble_cgms_init(nrf_ble_cgms_t * p_cgms, const nrf_ble_cgms_init_t
 
     // Initialize global variables
     p_cgms->cgms_com_state = STATE_NO_COMM;
-    p_cgms->racp_data.racp_proc_records_reported_since_txcomplete = 0;
+    p_cgms->racp_data.racp_proc_tx_pending = 0;
 
     // Add service
     BLE_UUID_BLE_ASSIGN(ble_uuid, BLE_UUID_CGM_SERVICE);
@@ -312,9 +312,7 @@ static void on_write(nrf_ble_cgms_t * p_cgms, ble_evt_t * p_ble_evt)
  */
 static void on_tx_complete(nrf_ble_cgms_t * p_cgms, ble_evt_t * p_ble_evt)
 {
-    p_cgms->racp_data.racp_proc_records_reported_since_txcomplete = 0;
-
-    cgms_racp_on_tx_complete(p_cgms);
+    cgms_racp_on_tx_complete(p_cgms, p_ble_evt->evt.common_evt.params.tx_complete.count);
     cgms_socp_on_tx_complete(p_cgms);
 }
 
@@ -386,7 +384,8 @@ void nrf_ble_cgms_on_ble_evt(nrf_ble_cgms_t * p_cgms, ble_evt_t * p_ble_evt)
             break;
 
         case BLE_GAP_EVT_DISCONNECTED:
-            p_cgms->conn_handle = BLE_CONN_HANDLE_INVALID;
+            p_cgms->conn_handle                    = BLE_CONN_HANDLE_INVALID;
+            p_cgms->racp_data.racp_proc_tx_pending = 0;
             break;
 
         case BLE_GATTS_EVT_WRITE:
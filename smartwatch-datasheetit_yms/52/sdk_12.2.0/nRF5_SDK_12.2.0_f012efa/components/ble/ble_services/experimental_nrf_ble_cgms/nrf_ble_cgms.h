@@ -272,9 +272,12 @@ typedef struct
 typedef struct
 {
     uint8_t          racp_proc_operator;                                                    /**< Operator of the current request. */
-    uint8_t          racp_proc_record_ndx;                                                  /**< Current record index. */
-    uint8_t          racp_proc_records_reported;                                            /**< Number of reported records. */
-    uint8_t          racp_proc_records_reported_since_txcomplete;                           /**< Number of reported records since the last TX_COMPLETE event. */
+    uint16_t         racp_proc_record_ndx;                                                  /**< Index of the next record to be read from the database. */
+    uint16_t         racp_proc_record_end;                                                  /**< Index after the last record of the current request. */
+    uint16_t         racp_proc_records_reported;                                            /**< Number of reported notifications. */
+    uint8_t          racp_proc_tx_pending;                                                  /**< Number of reported notifications not yet confirmed by a TX_COMPLETE event. */
+    uint8_t          racp_proc_rec_count;                                                   /**< Number of records in racp_proc_recs that are still to be sent. */
+    ble_cgms_rec_t   racp_proc_recs[NRF_BLE_CGMS_MEAS_REC_PER_NOTIF_MAX];                   /**< Records read ahead of the next notification. */
     ble_racp_value_t racp_request;
     ble_racp_value_t pending_racp_response;                                                 /**< RACP response to be sent. */
     uint8_t          pending_racp_response_operand[NRF_BLE_CGMS_RACP_PENDING_OPERANDS_MAX]; /**< Operand of the RACP response to be sent. */
@@ -652,3 +652,38 @@ uint32_t ble_advdata_set(const ble_advdata_t * p_advdata, const ble_advdata_t *
     // Pass encoded advertising data and/or scan response data to the stack.
     return sd_ble_gap_adv_data_set(p_encoded_advdata, len_advdata, p_encoded_srdata, len_srdata);
 }
+
+
+uint16_t ble_advdata_search(uint8_t const * p_encoded_data,
+                            uint16_t        data_len,
+                            uint16_t      * p_offset,
+                            uint8_t         ad_type)
+{
+    uint16_t i;
+
+    if ((p_encoded_data == NULL) || (p_offset == NULL))
+    {
+        return 0;
+    }
+
+    i = *p_offset;
+
+    // Every AD structure starts with its length, which covers the AD type and the data.
+    while ((i + ADV_AD_DATA_OFFSET <= data_len) && (p_encoded_data[i] != 0))
+    {
+        uint16_t len = p_encoded_data[i];
+
+        if (i + ADV_LENGTH_FIELD_SIZE + len > data_len)
+        {
+            break;
+        }
+        if (p_encoded_data[i + ADV_LENGTH_FIELD_SIZE] == ad_type)
+        {
+            *p_offset = i + ADV_AD_DATA_OFFSET;
+            return len - ADV_AD_TYPE_FIELD_SIZE;
+        }
+        i += ADV_LENGTH_FIELD_SIZE + len;
+    }
+
+    return 0;
+}
@@ -194,6 +194,22 @@ uint32_t adv_data_encode(ble_advdata_t const * const p_advdata,
 uint32_t ble_advdata_set(const ble_advdata_t * p_advdata, const ble_advdata_t * p_srdata);
 
 
+/**@brief Function for searching encoded Advertising or Scan Response data for an AD type.
+ *
+ * @param[in]     p_encoded_data Data buffer containing the encoded Advertising data.
+ * @param[in]     data_len       Length of the data buffer \p p_encoded_data.
+ * @param[in,out] p_offset       \c in: Offset to start searching from.
+ *                               \c out: If the AD type was found, offset of its data.
+ * @param[in]     ad_type        AD type to search for. See @ref BLE_GAP_AD_TYPE_DEFINITIONS.
+ *
+ * @return Length of the data of the AD type, or 0 if the AD type was not found.
+ */
+uint16_t ble_advdata_search(uint8_t const * p_encoded_data,
+                            uint16_t        data_len,
+                            uint16_t      * p_offset,
+                            uint8_t         ad_type);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,273 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(BLE_ALERT_AGG)
+#include <string.h>
+#include "ble_alert_agg.h"
+#include "ble_srv_common.h"
+#include "app_timer.h"
+#include "app_util_platform.h"
+
+#define NO_CATEGORY 0xFF /**< Alert of the Immediate Alert Service, which has no category. */
+
+/**@brief Urgency of each alert category. */
+static const uint8_t m_urgency[BLE_ALERT_AGG_CATEGORY_COUNT] =
+{
+    [ANS_TYPE_SIMPLE_ALERT]           = BLE_ALERT_AGG_URGENCY_LOW,
+    [ANS_TYPE_EMAIL]                  = BLE_ALERT_AGG_URGENCY_LOW,
+    [ANS_TYPE_NEWS]                   = BLE_ALERT_AGG_URGENCY_LOW,
+    [ANS_TYPE_NOTIFICATION_CALL]      = BLE_ALERT_AGG_URGENCY_HIGH,
+    [ANS_TYPE_MISSED_CALL]            = BLE_ALERT_AGG_URGENCY_NORMAL,
+    [ANS_TYPE_SMS_MMS]                = BLE_ALERT_AGG_URGENCY_NORMAL,
+    [ANS_TYPE_VOICE_MAIL]             = BLE_ALERT_AGG_URGENCY_LOW,
+    [ANS_TYPE_SCHEDULE]               = BLE_ALERT_AGG_URGENCY_LOW,
+    [ANS_TYPE_HIGH_PRIORITIZED_ALERT] = BLE_ALERT_AGG_URGENCY_HIGH,
+    [ANS_TYPE_INSTANT_MESSAGE]        = BLE_ALERT_AGG_URGENCY_NORMAL
+};
+
+static struct
+{
+    ble_alert_agg_evt_handler_t evt_handler;
+    uint32_t                    prescaler;
+    uint8_t                     channel_mask;
+    ble_alert_agg_effect_t      effects[BLE_ALERT_AGG_URGENCY_COUNT];
+    uint8_t                     new_count[BLE_ALERT_AGG_CATEGORY_COUNT];   /**< Alerts of the open batch. */
+    uint8_t                     batch_count[BLE_ALERT_AGG_CATEGORY_COUNT]; /**< Alerts of the last batch, for the event. */
+    uint8_t                     unread[BLE_ALERT_AGG_CATEGORY_COUNT];
+    uint16_t                    mask;          /**< Categories of the open batch. */
+    uint8_t                     urgency;       /**< Highest urgency of the open batch. */
+    bool                        open;          /**< A batch is open, and the timer running. */
+    bool                        flushed;       /**< A batch has ended since initialization. */
+    uint32_t                    window_ms;     /**< Window of the open or last batch. */
+    uint32_t                    last_flush;    /**< RTC1 counter at the end of the last batch. */
+} m_cb;
+
+APP_TIMER_DEF(m_window_timer);
+
+
+/**@brief Function for ending the open batch: the effect is played and the event sent. */
+static void batch_flush(void)
+{
+    ble_alert_agg_evt_t evt;
+    bool                open;
+
+    CRITICAL_REGION_ENTER();
+    open = m_cb.open;
+    if (open)
+    {
+        memcpy(m_cb.batch_count, m_cb.new_count, sizeof(m_cb.batch_count));
+        memset(m_cb.new_count, 0, sizeof(m_cb.new_count));
+
+        evt.evt_type      = BLE_ALERT_AGG_EVT_BATCH;
+        evt.urgency       = (ble_alert_agg_urgency_t)m_cb.urgency;
+        evt.category_mask = m_cb.mask;
+        evt.p_new         = m_cb.batch_count;
+        evt.p_unread      = m_cb.unread;
+
+        m_cb.mask       = 0;
+        m_cb.urgency    = BLE_ALERT_AGG_URGENCY_LOW;
+        m_cb.open       = false;
+        m_cb.flushed    = true;
+        m_cb.last_flush = app_timer_cnt_get();
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (!open)
+    {
+        return;
+    }
+
+    UNUSED_RETURN_VALUE(app_timer_stop(m_window_timer));
+
+    if (m_cb.effects[evt.urgency].p_segments != NULL)
+    {
+        UNUSED_RETURN_VALUE(pwm_effects_play(m_cb.channel_mask,
+                                             m_cb.effects[evt.urgency].p_segments,
+                                             m_cb.effects[evt.urgency].count,
+                                             false));
+    }
+
+    m_cb.evt_handler(&evt);
+}
+
+
+static void window_timeout_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+    batch_flush();
+}
+
+
+/**@brief Function for getting the window of a new batch: doubled while batches follow each
+ *        other closely.
+ */
+static uint32_t window_next(void)
+{
+    uint32_t elapsed;
+
+    if (!m_cb.flushed)
+    {
+        return BLE_ALERT_AGG_CONFIG_WINDOW_MS;
+    }
+
+    UNUSED_RETURN_VALUE(app_timer_cnt_diff_compute(app_timer_cnt_get(), m_cb.last_flush, &elapsed));
+    if (elapsed >= APP_TIMER_TICKS(BLE_ALERT_AGG_CONFIG_STORM_MS, m_cb.prescaler))
+    {
+        return BLE_ALERT_AGG_CONFIG_WINDOW_MS;
+    }
+
+    return MIN(m_cb.window_ms * 2, BLE_ALERT_AGG_CONFIG_WINDOW_MAX_MS);
+}
+
+
+static void alert_add(uint8_t category, ble_alert_agg_urgency_t urgency)
+{
+    bool start;
+
+    CRITICAL_REGION_ENTER();
+    if (category != NO_CATEGORY)
+    {
+        if (m_cb.new_count[category] < UINT8_MAX)
+        {
+            m_cb.new_count[category]++;
+        }
+        m_cb.mask |= (1 << category);
+    }
+    m_cb.urgency = MAX(m_cb.urgency, (uint8_t)urgency);
+
+    start     = !m_cb.open;
+    m_cb.open = true;
+    if (start)
+    {
+        m_cb.window_ms = window_next();
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (urgency == BLE_ALERT_AGG_URGENCY_HIGH)
+    {
+        batch_flush();
+    }
+    else if (start)
+    {
+        uint32_t err_code = app_timer_start(m_window_timer,
+                                            APP_TIMER_TICKS(m_cb.window_ms, m_cb.prescaler),
+                                            NULL);
+        if (err_code != NRF_SUCCESS)
+        {
+            // Without a timer, the alert is not delayed.
+            batch_flush();
+        }
+    }
+}
+
+
+ret_code_t ble_alert_agg_init(ble_alert_agg_init_t const * p_init)
+{
+    VERIFY_PARAM_NOT_NULL(p_init);
+    VERIFY_PARAM_NOT_NULL(p_init->evt_handler);
+
+    memset(&m_cb, 0, sizeof(m_cb));
+    m_cb.evt_handler  = p_init->evt_handler;
+    m_cb.prescaler    = p_init->prescaler;
+    m_cb.channel_mask = p_init->channel_mask;
+    m_cb.window_ms    = BLE_ALERT_AGG_CONFIG_WINDOW_MS;
+    memcpy(m_cb.effects, p_init->effects, sizeof(m_cb.effects));
+
+    return app_timer_create(&m_window_timer, APP_TIMER_MODE_SINGLE_SHOT, window_timeout_handler);
+}
+
+
+void ble_alert_agg_on_ans_c_evt(ble_ans_c_evt_t const * p_evt)
+{
+    uint8_t category;
+
+    if (p_evt->evt_type == BLE_ANS_C_EVT_DISCONN_COMPLETE)
+    {
+        // Alerts of the peer that are still collected are reported now.
+        batch_flush();
+        return;
+    }
+
+    if (p_evt->evt_type != BLE_ANS_C_EVT_NOTIFICATION)
+    {
+        return;
+    }
+
+    category = p_evt->data.alert.alert_category;
+    if (category >= BLE_ALERT_AGG_CATEGORY_COUNT)
+    {
+        return;
+    }
+
+    if (p_evt->uuid.uuid == BLE_UUID_NEW_ALERT_CHAR)
+    {
+        alert_add(category, (ble_alert_agg_urgency_t)m_urgency[category]);
+    }
+    else if (p_evt->uuid.uuid == BLE_UUID_UNREAD_ALERT_CHAR)
+    {
+        ble_alert_agg_evt_t evt;
+
+        if (m_cb.unread[category] == p_evt->data.alert.alert_category_count)
+        {
+            return;
+        }
+        m_cb.unread[category] = p_evt->data.alert.alert_category_count;
+
+        evt.evt_type      = BLE_ALERT_AGG_EVT_UNREAD;
+        evt.urgency       = (ble_alert_agg_urgency_t)m_urgency[category];
+        evt.category_mask = (1 << category);
+        evt.p_new         = m_cb.batch_count;
+        evt.p_unread      = m_cb.unread;
+        m_cb.evt_handler(&evt);
+    }
+}
+
+
+void ble_alert_agg_on_ias_evt(ble_ias_evt_t const * p_evt)
+{
+    if (p_evt->evt_type != BLE_IAS_EVT_ALERT_LEVEL_UPDATED)
+    {
+        return;
+    }
+
+    if (p_evt->params.alert_level == BLE_CHAR_ALERT_LEVEL_NO_ALERT)
+    {
+        ble_alert_agg_evt_t evt;
+
+        pwm_effects_stop();
+
+        memset(&evt, 0, sizeof(evt));
+        evt.evt_type = BLE_ALERT_AGG_EVT_STOP;
+        evt.p_new    = m_cb.batch_count;
+        evt.p_unread = m_cb.unread;
+        m_cb.evt_handler(&evt);
+    }
+    else
+    {
+        alert_add(NO_CATEGORY, BLE_ALERT_AGG_URGENCY_HIGH);
+    }
+}
+
+
+void ble_alert_agg_unread_clear(ble_ans_category_id_t category)
+{
+    if (category == ANS_TYPE_ALL_ALERTS)
+    {
+        memset(m_cb.unread, 0, sizeof(m_cb.unread));
+    }
+    else if ((uint32_t)category < BLE_ALERT_AGG_CATEGORY_COUNT)
+    {
+        m_cb.unread[category] = 0;
+    }
+}
+
+#endif // NRF_MODULE_ENABLED(BLE_ALERT_AGG)
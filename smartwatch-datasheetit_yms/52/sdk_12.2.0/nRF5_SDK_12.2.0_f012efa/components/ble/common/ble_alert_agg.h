@@ -0,0 +1,159 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ble_alert_agg Alert aggregation
+ * @{
+ * @ingroup ble_sdk_lib
+ *
+ * @brief Module for merging the alerts of the Alert Notification and Immediate Alert services.
+ *
+ * @details The New Alert notifications received by @ref ble_ans_c are collected for a window
+ *          that starts with the first alert. When the window ends, one haptic effect is played
+ *          with @ref pwm_effects, the effect of the most urgent category of the batch, and one
+ *          @ref BLE_ALERT_AGG_EVT_BATCH event is sent, on which the application wakes the display.
+ *
+ *          When a batch starts less than @ref BLE_ALERT_AGG_CONFIG_STORM_MS after the previous
+ *          one, the window is doubled, up to @ref BLE_ALERT_AGG_CONFIG_WINDOW_MAX_MS, so a burst
+ *          of messages gives fewer and fewer wake-ups. It is reset after a quiet period.
+ *
+ *          Incoming calls, high priority alerts and alerts of @ref ble_ias are urgent: the batch
+ *          ends at once. An Immediate Alert with no alert level stops the effect.
+ *
+ *          Unread Alert Status notifications only update the unread count of the category, and
+ *          are reported with @ref BLE_ALERT_AGG_EVT_UNREAD, without an effect.
+ *
+ * @note The module uses @ref app_timer, with a single-shot timer.
+ */
+
+#ifndef BLE_ALERT_AGG_H__
+#define BLE_ALERT_AGG_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+#include "ble_ans_c.h"
+#include "ble_ias.h"
+#include "pwm_effects.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Window of a batch after a quiet period, in milliseconds.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_ALERT_AGG_CONFIG_WINDOW_MS
+#define BLE_ALERT_AGG_CONFIG_WINDOW_MS 1500
+#endif
+
+/** @brief Longest window of a batch, in milliseconds.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_ALERT_AGG_CONFIG_WINDOW_MAX_MS
+#define BLE_ALERT_AGG_CONFIG_WINDOW_MAX_MS 30000
+#endif
+
+/** @brief Time after a batch within which the next batch gets a longer window, in milliseconds.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_ALERT_AGG_CONFIG_STORM_MS
+#define BLE_ALERT_AGG_CONFIG_STORM_MS 10000
+#endif
+
+#define BLE_ALERT_AGG_CATEGORY_COUNT (ANS_TYPE_INSTANT_MESSAGE + 1) /**< Number of alert categories. */
+
+/**@brief Urgency of an alert category. */
+typedef enum
+{
+    BLE_ALERT_AGG_URGENCY_LOW,    /**< Simple alerts, email, news, voice mail, schedule. */
+    BLE_ALERT_AGG_URGENCY_NORMAL, /**< SMS/MMS, instant messages, missed calls. */
+    BLE_ALERT_AGG_URGENCY_HIGH,   /**< Incoming calls, high priority alerts, Immediate Alerts. The batch ends at once. */
+    BLE_ALERT_AGG_URGENCY_COUNT   /**< Number of urgencies. */
+} ble_alert_agg_urgency_t;
+
+/**@brief Event types. */
+typedef enum
+{
+    BLE_ALERT_AGG_EVT_BATCH,  /**< A batch of alerts ended. The effect was started. */
+    BLE_ALERT_AGG_EVT_UNREAD, /**< The unread count of a category changed. */
+    BLE_ALERT_AGG_EVT_STOP    /**< The peer stopped the Immediate Alert. The effect was stopped. */
+} ble_alert_agg_evt_type_t;
+
+/**@brief Event. */
+typedef struct
+{
+    ble_alert_agg_evt_type_t evt_type;      /**< Type of event. */
+    ble_alert_agg_urgency_t  urgency;       /**< Batch: highest urgency of the batch. */
+    uint16_t                 category_mask; /**< Batch: categories with new alerts. Unread: the category. Bit n is category n. */
+    uint8_t const          * p_new;         /**< Batch: number of new alerts of each category in the batch. */
+    uint8_t const          * p_unread;      /**< Unread count of each category, as last reported by the peer. */
+} ble_alert_agg_evt_t;
+
+/**@brief Event handler type. Called from the context of the BLE events or of the app_timer. */
+typedef void (* ble_alert_agg_evt_handler_t)(ble_alert_agg_evt_t const * p_evt);
+
+/**@brief Haptic effect of an urgency. */
+typedef struct
+{
+    pwm_effects_segment_t const * p_segments; /**< Segments, or NULL for no effect. */
+    uint16_t                      count;      /**< Number of segments. */
+} ble_alert_agg_effect_t;
+
+/**@brief Initialization parameters. */
+typedef struct
+{
+    ble_alert_agg_evt_handler_t evt_handler;                            /**< Event handler. */
+    uint32_t                    prescaler;                              /**< Prescaler of the app_timer module. */
+    uint8_t                     channel_mask;                           /**< PWM channels of the vibration motor. */
+    ble_alert_agg_effect_t      effects[BLE_ALERT_AGG_URGENCY_COUNT];   /**< Effect of each urgency. Must stay valid. */
+} ble_alert_agg_init_t;
+
+/**@brief Function for initializing the module. @ref pwm_effects must be initialized.
+ *
+ * @param[in] p_init Initialization parameters.
+ *
+ * @retval NRF_SUCCESS    If the module was initialized.
+ * @retval NRF_ERROR_NULL If p_init or the event handler was NULL.
+ * @return Other errors from @ref app_timer_create.
+ */
+ret_code_t ble_alert_agg_init(ble_alert_agg_init_t const * p_init);
+
+/**@brief Function for handling the events of @ref ble_ans_c.
+ *
+ * @param[in] p_evt Event.
+ */
+void ble_alert_agg_on_ans_c_evt(ble_ans_c_evt_t const * p_evt);
+
+/**@brief Function for handling the events of @ref ble_ias.
+ *
+ * @param[in] p_evt Event.
+ */
+void ble_alert_agg_on_ias_evt(ble_ias_evt_t const * p_evt);
+
+/**@brief Function for clearing the unread count of a category, when the user has seen it.
+ *
+ * @param[in] category Category, or @ref ANS_TYPE_ALL_ALERTS.
+ */
+void ble_alert_agg_unread_clear(ble_ans_category_id_t category);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLE_ALERT_AGG_H__
+
+/** @} */
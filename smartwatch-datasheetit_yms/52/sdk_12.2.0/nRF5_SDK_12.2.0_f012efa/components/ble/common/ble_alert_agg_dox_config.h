@@ -0,0 +1,34 @@
+/**
+ *
+ * @defgroup ble_alert_agg_config ble_alert_agg module configuration
+ * @{
+ * @ingroup ble_alert_agg
+ */
+/** @brief Enabling ble_alert_agg module
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_ALERT_AGG_ENABLED
+
+/** @brief Window of a batch after a quiet period, in milliseconds.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_ALERT_AGG_CONFIG_WINDOW_MS
+
+/** @brief Longest window of a batch, in milliseconds.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_ALERT_AGG_CONFIG_WINDOW_MAX_MS
+
+/** @brief Time after a batch within which the next batch gets a longer window, in milliseconds.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_ALERT_AGG_CONFIG_STORM_MS
+
+
+/** @} */
@@ -10,6 +10,7 @@
  *
  */
 
+#include "sdk_common.h"
 #include "ble_conn_params.h"
 #include <stdlib.h>
 #include "nordic_common.h"
@@ -28,6 +29,17 @@ APP_TIMER_DEF(m_conn_params_timer_id);                  /**< Connection paramete
 
 static bool m_change_param = false;
 
+#if NRF_MODULE_ENABLED(BLE_CONN_PARAMS_ADAPTIVE)
+static ble_conn_params_adaptive_init_t m_adaptive_config;       /**< Configuration of the adaptive scheduler. */
+static bool                            m_adaptive_enabled;      /**< True if the adaptive scheduler has been initialized. */
+static ble_conn_params_profile_t       m_profile;               /**< Profile last requested by the adaptive scheduler. */
+static uint32_t                        m_period_bytes;          /**< Number of bytes reported in the current evaluation period. */
+static bool                            m_ui_active;             /**< True if the user interface is active. */
+static uint8_t                         m_step_down_count;       /**< Number of consecutive periods the activity has called for a lower profile. */
+static uint8_t                         m_periods_since_update;  /**< Number of periods since the last requested update. */
+APP_TIMER_DEF(m_adaptive_timer_id);                             /**< Evaluation period timer of the adaptive scheduler. */
+#endif // NRF_MODULE_ENABLED(BLE_CONN_PARAMS_ADAPTIVE)
+
 static bool is_conn_params_ok(ble_gap_conn_params_t * p_conn_params)
 {
     // Check if interval is within the acceptable range.
@@ -134,6 +146,14 @@ uint32_t ble_conn_params_init(const ble_conn_params_init_t * p_init)
 
 uint32_t ble_conn_params_stop(void)
 {
+#if NRF_MODULE_ENABLED(BLE_CONN_PARAMS_ADAPTIVE)
+    if (m_adaptive_enabled)
+    {
+        uint32_t err_code = app_timer_stop(m_adaptive_timer_id);
+        VERIFY_SUCCESS(err_code);
+    }
+#endif // NRF_MODULE_ENABLED(BLE_CONN_PARAMS_ADAPTIVE)
+
     return app_timer_stop(m_conn_params_timer_id);
 }
 
@@ -191,6 +211,124 @@ static void conn_params_negotiation(void)
 }
 
 
+#if NRF_MODULE_ENABLED(BLE_CONN_PARAMS_ADAPTIVE)
+/**@brief Function for selecting the profile that the activity of the current period calls for. */
+static ble_conn_params_profile_t profile_target_get(void)
+{
+    uint32_t queue_depth = 0;
+
+    if (m_adaptive_config.queue_depth_get != NULL)
+    {
+        queue_depth = m_adaptive_config.queue_depth_get(m_conn_handle);
+    }
+
+    if (   (m_period_bytes >= m_adaptive_config.streaming_bytes)
+        || (   (m_adaptive_config.streaming_queue_depth != 0)
+            && (queue_depth >= m_adaptive_config.streaming_queue_depth)))
+    {
+        return BLE_CONN_PARAMS_PROFILE_STREAMING;
+    }
+
+    if (   m_ui_active
+        || (queue_depth != 0)
+        || ((m_period_bytes != 0) && (m_period_bytes >= m_adaptive_config.interactive_bytes)))
+    {
+        return BLE_CONN_PARAMS_PROFILE_INTERACTIVE;
+    }
+
+    return BLE_CONN_PARAMS_PROFILE_IDLE;
+}
+
+
+/**@brief Function for requesting the parameters of a profile, unless an update was requested
+ *        too recently.
+ *
+ * @details If the SoftDevice is busy with another procedure, the request is repeated in the next
+ *          evaluation period.
+ */
+static void profile_request(ble_conn_params_profile_t profile)
+{
+    uint32_t err_code;
+
+    if ((profile == m_profile) || (m_periods_since_update < m_adaptive_config.min_update_periods))
+    {
+        return;
+    }
+
+    err_code = ble_conn_params_change_conn_params(&m_adaptive_config.profiles[profile]);
+    if (err_code == NRF_SUCCESS)
+    {
+        m_profile              = profile;
+        m_step_down_count      = 0;
+        m_periods_since_update = 0;
+    }
+    else if ((err_code != NRF_ERROR_BUSY) && (m_conn_params_config.error_handler != NULL))
+    {
+        m_conn_params_config.error_handler(err_code);
+    }
+}
+
+
+static void adaptive_timeout_handler(void * p_context)
+{
+    ble_conn_params_profile_t target;
+
+    UNUSED_PARAMETER(p_context);
+
+    if (m_conn_handle == BLE_CONN_HANDLE_INVALID)
+    {
+        return;
+    }
+
+    target         = profile_target_get();
+    m_period_bytes = 0;
+
+    if (m_periods_since_update < UINT8_MAX)
+    {
+        m_periods_since_update++;
+    }
+
+    // Step up at once, but step down only after the activity has stayed low.
+    if (target >= m_profile)
+    {
+        m_step_down_count = 0;
+    }
+    else if (m_step_down_count < m_adaptive_config.step_down_periods)
+    {
+        m_step_down_count++;
+        return;
+    }
+
+    profile_request(target);
+}
+
+
+/**@brief Function for starting the adaptive scheduler on a new connection. */
+static void adaptive_start(void)
+{
+    uint32_t err_code;
+
+    m_profile              = BLE_CONN_PARAMS_PROFILE_INTERACTIVE;
+    m_period_bytes         = 0;
+    m_step_down_count      = 0;
+    m_periods_since_update = 0;
+
+    m_preferred_conn_params = m_adaptive_config.profiles[BLE_CONN_PARAMS_PROFILE_INTERACTIVE];
+    err_code = sd_ble_gap_ppcp_set(&m_preferred_conn_params);
+    if ((err_code != NRF_SUCCESS) && (m_conn_params_config.error_handler != NULL))
+    {
+        m_conn_params_config.error_handler(err_code);
+    }
+
+    err_code = app_timer_start(m_adaptive_timer_id, m_adaptive_config.eval_period, NULL);
+    if ((err_code != NRF_SUCCESS) && (m_conn_params_config.error_handler != NULL))
+    {
+        m_conn_params_config.error_handler(err_code);
+    }
+}
+#endif // NRF_MODULE_ENABLED(BLE_CONN_PARAMS_ADAPTIVE)
+
+
 static void on_connect(ble_evt_t * p_ble_evt)
 {
     // Save connection parameters
@@ -198,6 +336,13 @@ static void on_connect(ble_evt_t * p_ble_evt)
     m_current_conn_params = p_ble_evt->evt.gap_evt.params.connected.conn_params;
     m_update_count        = 0;  // Connection parameter negotiation should re-start every connection
 
+#if NRF_MODULE_ENABLED(BLE_CONN_PARAMS_ADAPTIVE)
+    if (m_adaptive_enabled)
+    {
+        adaptive_start();
+    }
+#endif // NRF_MODULE_ENABLED(BLE_CONN_PARAMS_ADAPTIVE)
+
     // Check if we shall handle negotiation on connect
     if (m_conn_params_config.start_on_notify_cccd_handle == BLE_GATT_HANDLE_INVALID)
     {
@@ -220,6 +365,17 @@ static void on_disconnect(ble_evt_t * p_ble_evt)
     {
         m_conn_params_config.error_handler(err_code);
     }
+
+#if NRF_MODULE_ENABLED(BLE_CONN_PARAMS_ADAPTIVE)
+    if (m_adaptive_enabled)
+    {
+        err_code = app_timer_stop(m_adaptive_timer_id);
+        if ((err_code != NRF_SUCCESS) && (m_conn_params_config.error_handler != NULL))
+        {
+            m_conn_params_config.error_handler(err_code);
+        }
+    }
+#endif // NRF_MODULE_ENABLED(BLE_CONN_PARAMS_ADAPTIVE)
 }
 
 
@@ -321,3 +477,55 @@ uint32_t ble_conn_params_change_conn_params(ble_gap_conn_params_t * new_params)
     }
     return err_code;
 }
+
+
+#if NRF_MODULE_ENABLED(BLE_CONN_PARAMS_ADAPTIVE)
+uint32_t ble_conn_params_adaptive_init(ble_conn_params_adaptive_init_t const * p_init)
+{
+    uint32_t err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_init);
+    if (p_init->eval_period == 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    m_adaptive_config = *p_init;
+    m_profile         = BLE_CONN_PARAMS_PROFILE_INTERACTIVE;
+    m_ui_active       = false;
+
+    err_code = app_timer_create(&m_adaptive_timer_id,
+                                APP_TIMER_MODE_REPEATED,
+                                adaptive_timeout_handler);
+    VERIFY_SUCCESS(err_code);
+
+    m_adaptive_enabled = true;
+    return NRF_SUCCESS;
+}
+
+
+void ble_conn_params_activity_add(uint32_t bytes)
+{
+    m_period_bytes = (m_period_bytes > UINT32_MAX - bytes) ? UINT32_MAX : (m_period_bytes + bytes);
+}
+
+
+void ble_conn_params_ui_active_set(bool active)
+{
+    m_ui_active = active;
+
+    if (   active
+        && m_adaptive_enabled
+        && (m_conn_handle != BLE_CONN_HANDLE_INVALID)
+        && (m_profile < BLE_CONN_PARAMS_PROFILE_INTERACTIVE))
+    {
+        profile_request(profile_target_get());
+    }
+}
+
+
+ble_conn_params_profile_t ble_conn_params_profile_get(void)
+{
+    return m_profile;
+}
+#endif // NRF_MODULE_ENABLED(BLE_CONN_PARAMS_ADAPTIVE)
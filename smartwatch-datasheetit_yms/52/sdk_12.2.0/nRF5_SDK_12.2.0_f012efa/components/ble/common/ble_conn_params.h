@@ -22,6 +22,7 @@
 #define BLE_CONN_PARAMS_H__
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "ble.h"
 #include "ble_srv_common.h"
 
@@ -59,6 +60,41 @@ typedef struct
     ble_srv_error_handler_t       error_handler;                    /**< Function to be called in case of an error. */
 } ble_conn_params_init_t;
 
+/**@brief Connection parameter profiles of the adaptive scheduler, from lowest to highest activity. */
+typedef enum
+{
+    BLE_CONN_PARAMS_PROFILE_IDLE,                                   /**< No data is transferred and the user interface is inactive. */
+    BLE_CONN_PARAMS_PROFILE_INTERACTIVE,                            /**< The user interface is active, or little data is transferred. */
+    BLE_CONN_PARAMS_PROFILE_STREAMING,                              /**< Much data is transferred. */
+    BLE_CONN_PARAMS_PROFILE_COUNT                                   /**< Number of profiles. */
+} ble_conn_params_profile_t;
+
+/**@brief Function for getting the number of GATT requests that are waiting to be sent on a connection. */
+typedef uint32_t (*ble_conn_params_queue_depth_get_t) (uint16_t conn_handle);
+
+/**@brief Adaptive scheduler init structure.
+ *
+ * @details At every evaluation period, the scheduler selects a profile from the activity of the
+ *          period. A higher profile is selected as soon as the activity calls for it. A lower
+ *          profile is selected only once the activity has been lower for
+ *          @ref step_down_periods consecutive periods. Updates of the connection parameters are
+ *          requested at most once every @ref min_update_periods periods.
+ *
+ * @note The interval ranges of the profiles should not overlap, as the parameters of the
+ *       connection are checked against the interval range of the profile only.
+ */
+typedef struct
+{
+    ble_gap_conn_params_t             profiles[BLE_CONN_PARAMS_PROFILE_COUNT]; /**< Connection parameters of every profile. */
+    uint32_t                          eval_period;                  /**< Evaluation period (in number of timer ticks). */
+    uint32_t                          streaming_bytes;              /**< Number of bytes per period at or above which the streaming profile is selected. */
+    uint32_t                          interactive_bytes;            /**< Number of bytes per period at or above which at least the interactive profile is selected. */
+    uint32_t                          streaming_queue_depth;        /**< Number of waiting GATT requests at or above which the streaming profile is selected. Waiting requests select at least the interactive profile. */
+    ble_conn_params_queue_depth_get_t queue_depth_get;              /**< Function for getting the number of waiting GATT requests, or NULL if not used. */
+    uint8_t                           step_down_periods;            /**< Number of consecutive periods of lower activity before a lower profile is selected. */
+    uint8_t                           min_update_periods;           /**< Minimum number of periods between two requested updates. */
+} ble_conn_params_adaptive_init_t;
+
 
 /**@brief Function for initializing the Connection Parameters module.
  *
@@ -102,6 +138,45 @@ uint32_t ble_conn_params_stop(void);
  */
 uint32_t ble_conn_params_change_conn_params(ble_gap_conn_params_t *new_params);
 
+/**@brief Function for initializing the adaptive scheduler.
+ *
+ * @details The scheduler moves the connection between the idle, interactive and streaming profiles
+ *          based on the activity reported with @ref ble_conn_params_activity_add,
+ *          @ref ble_conn_params_ui_active_set and the GATT queue depth. Every connection starts in the
+ *          interactive profile, whose parameters replace those given to @ref ble_conn_params_init.
+ *
+ * @note Must be called after @ref ble_conn_params_init. Available only when
+ *       BLE_CONN_PARAMS_ADAPTIVE_ENABLED is set.
+ *
+ * @param[in]   p_init  Configuration of the scheduler. The structure is copied.
+ *
+ * @retval      NRF_SUCCESS             If the scheduler was initialized.
+ * @retval      NRF_ERROR_NULL          If @p p_init was NULL.
+ * @retval      NRF_ERROR_INVALID_PARAM If the evaluation period was 0.
+ * @return      Any error returned by @ref app_timer_create.
+ */
+uint32_t ble_conn_params_adaptive_init(ble_conn_params_adaptive_init_t const * p_init);
+
+/**@brief Function for reporting data transferred on the connection.
+ *
+ * @param[in]   bytes   Number of bytes sent or queued for sending.
+ */
+void ble_conn_params_activity_add(uint32_t bytes);
+
+/**@brief Function for reporting the state of the user interface.
+ *
+ * @details Activating the user interface selects at least the interactive profile at once.
+ *
+ * @param[in]   active  True if the user interface is active.
+ */
+void ble_conn_params_ui_active_set(bool active);
+
+/**@brief Function for getting the profile of the connection.
+ *
+ * @return      Profile that was last requested by the adaptive scheduler.
+ */
+ble_conn_params_profile_t ble_conn_params_profile_get(void);
+
 /**@brief Function for handling the Application's BLE Stack events.
  *
  * @details Handles all events from the BLE stack that are of interest to this module.
@@ -0,0 +1,16 @@
+/**
+ *
+ * @defgroup ble_conn_params_config Connection Parameters Negotiation configuration
+ * @{
+ * @ingroup ble_sdk_lib_conn_params
+ */
+/** @brief Enable the adaptive connection parameter scheduler.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_CONN_PARAMS_ADAPTIVE_ENABLED
+
+
+/** @} */
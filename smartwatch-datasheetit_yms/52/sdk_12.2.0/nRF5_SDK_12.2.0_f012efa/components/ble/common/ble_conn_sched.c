@@ -0,0 +1,475 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "ble_conn_sched.h"
+#include <string.h>
+#include "sdk_common.h"
+
+#define NRF_LOG_MODULE_NAME "CONN_SCHED"
+#include "nrf_log.h"
+
+STATIC_ASSERT(BLE_CONN_SCHED_PEER_MAX <= BLE_GAP_WHITELIST_ADDR_MAX_COUNT);
+
+/**@brief Known peer. */
+typedef struct
+{
+    ble_gap_addr_t addr;          /**< Address of the peer. */
+    uint16_t       conn_handle;   /**< Link, or BLE_CONN_HANDLE_INVALID. */
+    uint16_t       interval;      /**< Current interval of the link. */
+    uint8_t        interval_mult; /**< Interval of the peer, in multiples of the base interval. */
+    bool           used;          /**< The entry holds a peer. */
+} peer_t;
+
+static peer_t                m_peers[BLE_CONN_SCHED_PEER_MAX]; /**< Known peers. */
+static ble_conn_sched_init_t m_init;                           /**< Initialization parameters. */
+static bool                  m_connecting;                     /**< A connection procedure is running. */
+static bool                  m_stopped;                        /**< ble_conn_sched_stop() was called. */
+
+
+/**@brief Function for sending an event without parameters. */
+static void evt_send(ble_conn_sched_evt_type_t evt_type, uint8_t peer_id)
+{
+    ble_conn_sched_evt_t evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.evt_type    = evt_type;
+    evt.peer_id     = peer_id;
+    evt.conn_handle = (peer_id == BLE_CONN_SCHED_PEER_ID_INVALID) ? BLE_CONN_HANDLE_INVALID
+                                                                  : m_peers[peer_id].conn_handle;
+    m_init.evt_handler(&evt);
+}
+
+
+/**@brief Function for sending an error event. */
+static void error_send(uint32_t err_code)
+{
+    ble_conn_sched_evt_t evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.evt_type        = BLE_CONN_SCHED_EVT_ERROR;
+    evt.peer_id         = BLE_CONN_SCHED_PEER_ID_INVALID;
+    evt.conn_handle     = BLE_CONN_HANDLE_INVALID;
+    evt.params.err_code = err_code;
+    m_init.evt_handler(&evt);
+}
+
+
+/**@brief Function for finding the peer of a link. */
+static uint8_t peer_by_conn_handle(uint16_t conn_handle)
+{
+    for (uint8_t i = 0; i < BLE_CONN_SCHED_PEER_MAX; i++)
+    {
+        if (m_peers[i].used && (m_peers[i].conn_handle == conn_handle))
+        {
+            return i;
+        }
+    }
+    return BLE_CONN_SCHED_PEER_ID_INVALID;
+}
+
+
+uint8_t ble_conn_sched_peer_find(ble_gap_addr_t const * p_addr)
+{
+    for (uint8_t i = 0; i < BLE_CONN_SCHED_PEER_MAX; i++)
+    {
+        if (m_peers[i].used &&
+            (m_peers[i].addr.addr_type == p_addr->addr_type) &&
+            (memcmp(m_peers[i].addr.addr, p_addr->addr, BLE_GAP_ADDR_LEN) == 0))
+        {
+            return i;
+        }
+    }
+    return BLE_CONN_SCHED_PEER_ID_INVALID;
+}
+
+
+/**@brief Function for getting the connection parameters of an interval. */
+static void conn_params_get(uint16_t interval, ble_gap_conn_params_t * p_params)
+{
+    p_params->min_conn_interval = interval;
+    p_params->max_conn_interval = interval;
+    p_params->slave_latency     = m_init.slave_latency;
+    p_params->conn_sup_timeout  = m_init.sup_timeout;
+}
+
+
+/**@brief Function for starting a connection procedure to all the known peers that are not
+ *        connected, or reporting that there is nothing to connect.
+ */
+static void connect_next(void)
+{
+    ble_gap_addr_t const * p_addrs[BLE_CONN_SCHED_PEER_MAX];
+    ble_gap_scan_params_t  scan_params;
+    ble_gap_conn_params_t  conn_params;
+    uint8_t                count    = 0;
+    uint8_t                mult_min = UINT8_MAX;
+    uint32_t               err_code;
+
+    if (m_connecting || m_stopped)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < BLE_CONN_SCHED_PEER_MAX; i++)
+    {
+        if (m_peers[i].used && (m_peers[i].conn_handle == BLE_CONN_HANDLE_INVALID))
+        {
+            p_addrs[count++] = &m_peers[i].addr;
+            mult_min         = MIN(mult_min, m_peers[i].interval_mult);
+        }
+    }
+
+    if (count == 0)
+    {
+        evt_send(BLE_CONN_SCHED_EVT_IDLE, BLE_CONN_SCHED_PEER_ID_INVALID);
+        return;
+    }
+
+    memset(&scan_params, 0, sizeof(scan_params));
+    scan_params.active   = 0;
+    scan_params.interval = m_init.scan_interval;
+    scan_params.window   = m_init.scan_window;
+    scan_params.timeout  = m_init.connect_timeout;
+
+    // The whitelist lets the SoftDevice connect to whichever peer advertises first.
+#if (NRF_SD_BLE_API_VERSION == 2)
+    ble_gap_whitelist_t whitelist;
+
+    memset(&whitelist, 0, sizeof(whitelist));
+    whitelist.pp_addrs      = (ble_gap_addr_t **)p_addrs;
+    whitelist.addr_count    = count;
+    scan_params.selective   = 1;
+    scan_params.p_whitelist = &whitelist;
+#else
+    err_code = sd_ble_gap_whitelist_set(p_addrs, count);
+    if (err_code != NRF_SUCCESS)
+    {
+        error_send(err_code);
+        return;
+    }
+    scan_params.use_whitelist = 1;
+#endif
+
+    // The peer is not known until it connects. Its own interval is set after the connection.
+    conn_params_get(mult_min * m_init.base_interval, &conn_params);
+
+    err_code = sd_ble_gap_connect(NULL, &scan_params, &conn_params);
+    if (err_code != NRF_SUCCESS)
+    {
+        error_send(err_code);
+        return;
+    }
+
+    NRF_LOG_DEBUG("Connecting to %d peers.\r\n", count);
+    m_connecting = true;
+}
+
+
+/**@brief Function for cancelling the connection procedure. */
+static void connect_cancel(void)
+{
+    if (m_connecting)
+    {
+        (void)sd_ble_gap_connect_cancel();
+        m_connecting = false;
+    }
+}
+
+
+uint16_t ble_conn_sched_load_get(void)
+{
+    uint32_t load = 0;
+
+    for (uint32_t i = 0; i < BLE_CONN_SCHED_PEER_MAX; i++)
+    {
+        if (m_peers[i].used && (m_peers[i].conn_handle != BLE_CONN_HANDLE_INVALID))
+        {
+            // The interval is in 1.25 ms units.
+            load += (BLE_CONN_SCHED_EVENT_LEN_US * 1000UL) / (m_peers[i].interval * 1250UL);
+        }
+    }
+    return (uint16_t)MIN(load, UINT16_MAX);
+}
+
+
+/**@brief Function for reporting the conflicts caused by the interval of a link. */
+static void conflicts_check(uint8_t peer_id)
+{
+    ble_conn_sched_evt_t evt;
+    uint16_t             load = ble_conn_sched_load_get();
+
+    memset(&evt, 0, sizeof(evt));
+    evt.evt_type                      = BLE_CONN_SCHED_EVT_CONFLICT;
+    evt.peer_id                       = peer_id;
+    evt.conn_handle                   = m_peers[peer_id].conn_handle;
+    evt.params.conflict.load_permille = load;
+
+    if ((m_peers[peer_id].interval % m_init.base_interval) != 0)
+    {
+        evt.params.conflict.kind = BLE_CONN_SCHED_CONFLICT_INTERVAL;
+        m_init.evt_handler(&evt);
+    }
+    if (load > 1000)
+    {
+        evt.params.conflict.kind = BLE_CONN_SCHED_CONFLICT_LOAD;
+        m_init.evt_handler(&evt);
+    }
+}
+
+
+ret_code_t ble_conn_sched_init(ble_conn_sched_init_t const * p_init)
+{
+    VERIFY_PARAM_NOT_NULL(p_init);
+    VERIFY_PARAM_NOT_NULL(p_init->evt_handler);
+
+    if ((p_init->base_interval < BLE_GAP_CP_MIN_CONN_INTVL_MIN) ||
+        (p_init->base_interval > BLE_GAP_CP_MAX_CONN_INTVL_MAX))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    memset(m_peers, 0, sizeof(m_peers));
+    m_init       = *p_init;
+    m_connecting = false;
+    m_stopped    = false;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ble_conn_sched_peer_add(ble_gap_addr_t const * p_addr,
+                                   uint8_t                interval_mult,
+                                   uint8_t              * p_peer_id)
+{
+    uint8_t peer_id;
+
+    VERIFY_PARAM_NOT_NULL(p_addr);
+
+    if ((interval_mult == 0) ||
+        ((interval_mult * m_init.base_interval) > BLE_GAP_CP_MAX_CONN_INTVL_MAX))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    peer_id = ble_conn_sched_peer_find(p_addr);
+    if (peer_id == BLE_CONN_SCHED_PEER_ID_INVALID)
+    {
+        for (uint8_t i = 0; i < BLE_CONN_SCHED_PEER_MAX; i++)
+        {
+            if (!m_peers[i].used)
+            {
+                m_peers[i].addr          = *p_addr;
+                m_peers[i].conn_handle   = BLE_CONN_HANDLE_INVALID;
+                m_peers[i].interval      = 0;
+                m_peers[i].interval_mult = interval_mult;
+                m_peers[i].used          = true;
+                peer_id                  = i;
+                break;
+            }
+        }
+        if (peer_id == BLE_CONN_SCHED_PEER_ID_INVALID)
+        {
+            return NRF_ERROR_NO_MEM;
+        }
+
+        // A running procedure has the old whitelist.
+        connect_cancel();
+    }
+
+    if (p_peer_id != NULL)
+    {
+        *p_peer_id = peer_id;
+    }
+
+    connect_next();
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ble_conn_sched_peer_remove(uint8_t peer_id)
+{
+    if ((peer_id >= BLE_CONN_SCHED_PEER_MAX) || !m_peers[peer_id].used)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    m_peers[peer_id].used = false;
+
+    if (m_connecting)
+    {
+        connect_cancel();
+        connect_next();
+    }
+    return NRF_SUCCESS;
+}
+
+
+void ble_conn_sched_start(void)
+{
+    m_stopped = false;
+    connect_next();
+}
+
+
+void ble_conn_sched_stop(void)
+{
+    bool was_connecting = m_connecting;
+
+    m_stopped = true;
+    connect_cancel();
+    if (was_connecting)
+    {
+        evt_send(BLE_CONN_SCHED_EVT_IDLE, BLE_CONN_SCHED_PEER_ID_INVALID);
+    }
+}
+
+
+/**@brief Function for handling the connection of a central link. */
+static void on_connected(ble_gap_evt_t const * p_gap_evt)
+{
+    ble_gap_evt_connected_t const * p_connected = &p_gap_evt->params.connected;
+    uint8_t                         peer_id;
+
+    if (p_connected->role != BLE_GAP_ROLE_CENTRAL)
+    {
+        return;
+    }
+
+    // Only one central connection procedure can run at a time, so ours has ended.
+    m_connecting = false;
+
+    peer_id = ble_conn_sched_peer_find(&p_connected->peer_addr);
+    if (peer_id != BLE_CONN_SCHED_PEER_ID_INVALID)
+    {
+        peer_t             * p_peer   = &m_peers[peer_id];
+        uint16_t             wanted   = p_peer->interval_mult * m_init.base_interval;
+        ble_conn_sched_evt_t evt;
+
+        p_peer->conn_handle = p_gap_evt->conn_handle;
+        p_peer->interval    = p_connected->conn_params.max_conn_interval;
+
+        memset(&evt, 0, sizeof(evt));
+        evt.evt_type        = BLE_CONN_SCHED_EVT_CONNECTED;
+        evt.peer_id         = peer_id;
+        evt.conn_handle     = p_peer->conn_handle;
+        evt.params.interval = p_peer->interval;
+        m_init.evt_handler(&evt);
+
+        if (p_peer->interval != wanted)
+        {
+            ble_gap_conn_params_t conn_params;
+            uint32_t              err_code;
+
+            conn_params_get(wanted, &conn_params);
+            err_code = sd_ble_gap_conn_param_update(p_peer->conn_handle, &conn_params);
+            if (err_code != NRF_SUCCESS)
+            {
+                error_send(err_code);
+            }
+        }
+        else
+        {
+            conflicts_check(peer_id);
+        }
+    }
+
+    connect_next();
+}
+
+
+/**@brief Function for answering a parameter update request of a peripheral.
+ *
+ * @details The interval of the peer is kept if it is in the requested range. Otherwise the
+ *          shortest multiple of the base interval in the range is used. If there is none, the
+ *          request is accepted, and the conflict is reported when the update is done.
+ */
+static void on_conn_param_update_request(ble_gap_evt_t const * p_gap_evt)
+{
+    ble_gap_conn_params_t conn_params = p_gap_evt->params.conn_param_update_request.conn_params;
+    uint8_t               peer_id     = peer_by_conn_handle(p_gap_evt->conn_handle);
+    uint16_t              base        = m_init.base_interval;
+    uint16_t              interval;
+    uint32_t              err_code;
+
+    if (peer_id != BLE_CONN_SCHED_PEER_ID_INVALID)
+    {
+        interval = m_peers[peer_id].interval_mult * base;
+        if ((interval < conn_params.min_conn_interval) || (interval > conn_params.max_conn_interval))
+        {
+            interval = CEIL_DIV(conn_params.min_conn_interval, base) * base;
+        }
+        if (interval <= conn_params.max_conn_interval)
+        {
+            conn_params.min_conn_interval = interval;
+            conn_params.max_conn_interval = interval;
+        }
+    }
+
+    err_code = sd_ble_gap_conn_param_update(p_gap_evt->conn_handle, &conn_params);
+    if (err_code != NRF_SUCCESS)
+    {
+        error_send(err_code);
+    }
+}
+
+
+void ble_conn_sched_on_ble_evt(ble_evt_t const * p_ble_evt)
+{
+    ble_gap_evt_t const * p_gap_evt = &p_ble_evt->evt.gap_evt;
+    uint8_t               peer_id;
+
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GAP_EVT_CONNECTED:
+            on_connected(p_gap_evt);
+            break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            peer_id = peer_by_conn_handle(p_gap_evt->conn_handle);
+            if (peer_id != BLE_CONN_SCHED_PEER_ID_INVALID)
+            {
+                evt_send(BLE_CONN_SCHED_EVT_DISCONNECTED, peer_id);
+                m_peers[peer_id].conn_handle = BLE_CONN_HANDLE_INVALID;
+                m_peers[peer_id].interval    = 0;
+
+                connect_cancel();
+                connect_next();
+            }
+            break;
+
+        case BLE_GAP_EVT_CONN_PARAM_UPDATE:
+            peer_id = peer_by_conn_handle(p_gap_evt->conn_handle);
+            if (peer_id != BLE_CONN_SCHED_PEER_ID_INVALID)
+            {
+                m_peers[peer_id].interval =
+                    p_gap_evt->params.conn_param_update.conn_params.max_conn_interval;
+                conflicts_check(peer_id);
+            }
+            break;
+
+        case BLE_GAP_EVT_CONN_PARAM_UPDATE_REQUEST:
+            on_conn_param_update_request(p_gap_evt);
+            break;
+
+        case BLE_GAP_EVT_TIMEOUT:
+            if (m_connecting && (p_gap_evt->params.timeout.src == BLE_GAP_TIMEOUT_SRC_CONN))
+            {
+                // Started again by ble_conn_sched_start() or ble_conn_sched_peer_add().
+                m_connecting = false;
+                evt_send(BLE_CONN_SCHED_EVT_IDLE, BLE_CONN_SCHED_PEER_ID_INVALID);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
@@ -0,0 +1,201 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ble_conn_sched Central connection scheduler
+ * @{
+ * @ingroup ble_sdk_lib
+ * @brief Module for keeping several central links to known peers, with intervals that fit together.
+ *
+ * @details Every known peer gets a connection interval that is a multiple of a common base
+ *          interval. The SoftDevice places the connection events of a new central link after the
+ *          events of the existing central links, and when the intervals are multiples of each
+ *          other, these events do not drift into each other, so no events are dropped. The
+ *          anchor points themselves can not be set by the application.
+ *
+ *          The module connects to all known peers that are not connected, with one connection
+ *          procedure using a whitelist of these peers, so whichever advertises first is connected
+ *          first. The procedure is started again after every connection and disconnection, until
+ *          all the peers are connected or the procedure times out. After the connection, the
+ *          interval of the peer is set with a connection parameter update. Parameter update
+ *          requests of the peers are answered with a multiple of the base interval in the
+ *          requested range.
+ *
+ *          A link whose interval is not a multiple of the base interval, or connection events
+ *          that take more than the whole time, is reported as a @ref BLE_CONN_SCHED_EVT_CONFLICT.
+ *
+ * @note The SoftDevice stops scanning when a connection procedure is started. The application
+ *       must only scan after @ref BLE_CONN_SCHED_EVT_IDLE.
+ * @note Peers are matched by address. Peers that use resolvable private addresses are not
+ *       supported.
+ */
+
+#ifndef BLE_CONN_SCHED_H__
+#define BLE_CONN_SCHED_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble.h"
+#include "ble_gap.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Largest number of known peers, at most @ref BLE_GAP_WHITELIST_ADDR_MAX_COUNT.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_CONN_SCHED_PEER_MAX
+#define BLE_CONN_SCHED_PEER_MAX     8
+#endif
+
+/** @brief Time the SoftDevice reserves for a connection event of a link, in microseconds.
+ *
+ * Depends on the connection bandwidth configuration. Used to compute the load of the links.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_CONN_SCHED_EVENT_LEN_US
+#define BLE_CONN_SCHED_EVENT_LEN_US 2500
+#endif
+
+#define BLE_CONN_SCHED_PEER_ID_INVALID 0xFF /**< Peer ID of a link that is not to a known peer. */
+
+/**@brief Event types. */
+typedef enum
+{
+    BLE_CONN_SCHED_EVT_CONNECTED,    /**< A known peer was connected. */
+    BLE_CONN_SCHED_EVT_DISCONNECTED, /**< A known peer was disconnected. */
+    BLE_CONN_SCHED_EVT_CONFLICT,     /**< The links can not be scheduled without dropped events. */
+    BLE_CONN_SCHED_EVT_IDLE,         /**< No connection procedure is running. The application can scan. */
+    BLE_CONN_SCHED_EVT_ERROR,        /**< A SoftDevice call failed. */
+} ble_conn_sched_evt_type_t;
+
+/**@brief Kinds of conflicts. */
+typedef enum
+{
+    BLE_CONN_SCHED_CONFLICT_INTERVAL, /**< The interval of the link is not a multiple of the base interval. */
+    BLE_CONN_SCHED_CONFLICT_LOAD,     /**< The connection events take more time than there is. */
+} ble_conn_sched_conflict_t;
+
+/**@brief Event. */
+typedef struct
+{
+    ble_conn_sched_evt_type_t evt_type;    /**< Type of the event. */
+    uint8_t                   peer_id;     /**< Peer, or @ref BLE_CONN_SCHED_PEER_ID_INVALID. */
+    uint16_t                  conn_handle; /**< Link, or BLE_CONN_HANDLE_INVALID. */
+    union
+    {
+        uint16_t interval;                 /**< @ref BLE_CONN_SCHED_EVT_CONNECTED: interval of the link, in 1.25 ms units. */
+        struct
+        {
+            ble_conn_sched_conflict_t kind;          /**< Kind of conflict. */
+            uint16_t                  load_permille; /**< Share of the time taken by the connection events. */
+        } conflict;                        /**< @ref BLE_CONN_SCHED_EVT_CONFLICT. */
+        uint32_t err_code;                 /**< @ref BLE_CONN_SCHED_EVT_ERROR: error of the SoftDevice. */
+    } params;
+} ble_conn_sched_evt_t;
+
+/**@brief Event handler type. */
+typedef void (*ble_conn_sched_evt_handler_t)(ble_conn_sched_evt_t const * p_evt);
+
+/**@brief Initialization parameters. */
+typedef struct
+{
+    uint16_t                     base_interval;     /**< Base connection interval, in 1.25 ms units. */
+    uint16_t                     slave_latency;     /**< Slave latency of the links. */
+    uint16_t                     sup_timeout;       /**< Supervision timeout of the links, in 10 ms units. */
+    uint16_t                     scan_interval;     /**< Scan interval of the connection procedure, in 0.625 ms units. */
+    uint16_t                     scan_window;       /**< Scan window of the connection procedure, in 0.625 ms units. */
+    uint16_t                     connect_timeout;   /**< Timeout of the connection procedure, in seconds. 0 for none. */
+    ble_conn_sched_evt_handler_t evt_handler;       /**< Event handler. */
+} ble_conn_sched_init_t;
+
+
+/**@brief Function for initializing the module.
+ *
+ * @param[in] p_init Initialization parameters.
+ *
+ * @retval NRF_SUCCESS             If the module was initialized.
+ * @retval NRF_ERROR_NULL          If a NULL pointer was passed.
+ * @retval NRF_ERROR_INVALID_PARAM If the base interval was not valid.
+ */
+ret_code_t ble_conn_sched_init(ble_conn_sched_init_t const * p_init);
+
+
+/**@brief Function for adding a known peer, and connecting to it.
+ *
+ * @details If the peer is known already, its ID is returned.
+ *
+ * @param[in]  p_addr        Address of the peer.
+ * @param[in]  interval_mult Interval of the peer, in multiples of the base interval.
+ * @param[out] p_peer_id     ID of the peer. Can be NULL.
+ *
+ * @retval NRF_SUCCESS             If the peer was added.
+ * @retval NRF_ERROR_NULL          If p_addr was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If the interval was not valid.
+ * @retval NRF_ERROR_NO_MEM        If there are @ref BLE_CONN_SCHED_PEER_MAX known peers.
+ */
+ret_code_t ble_conn_sched_peer_add(ble_gap_addr_t const * p_addr,
+                                   uint8_t                interval_mult,
+                                   uint8_t              * p_peer_id);
+
+
+/**@brief Function for removing a known peer. Its link, if any, is kept.
+ *
+ * @retval NRF_SUCCESS             If the peer was removed.
+ * @retval NRF_ERROR_INVALID_PARAM If the peer was not known.
+ */
+ret_code_t ble_conn_sched_peer_remove(uint8_t peer_id);
+
+
+/**@brief Function for finding a known peer.
+ *
+ * @return ID of the peer, or @ref BLE_CONN_SCHED_PEER_ID_INVALID.
+ */
+uint8_t ble_conn_sched_peer_find(ble_gap_addr_t const * p_addr);
+
+
+/**@brief Function for starting the connection procedure to the known peers that are not connected.
+ *
+ * @details Also used after a timeout or @ref ble_conn_sched_stop.
+ */
+void ble_conn_sched_start(void);
+
+
+/**@brief Function for stopping the connection procedure. The links are kept. */
+void ble_conn_sched_stop(void);
+
+
+/**@brief Function for getting the share of the time taken by the connection events.
+ *
+ * @return Load in permille.
+ */
+uint16_t ble_conn_sched_load_get(void);
+
+
+/**@brief Function for handling BLE events.
+ *
+ * @param[in] p_ble_evt Event.
+ */
+void ble_conn_sched_on_ble_evt(ble_evt_t const * p_ble_evt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLE_CONN_SCHED_H__
+
+/** @} */
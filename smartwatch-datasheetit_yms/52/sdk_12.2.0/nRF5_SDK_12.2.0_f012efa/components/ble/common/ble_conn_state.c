@@ -10,6 +10,7 @@
  *
  */
 
+#include "sdk_common.h"
 #include "ble_conn_state.h"
 #include <stdbool.h>
 #include <stdint.h>
@@ -55,7 +56,7 @@ typedef struct
     union
     {
         ble_conn_state_flag_collections_t flags;                              /**< Flag collections kept by the Connection State module. */
-        sdk_mapped_flags_t                flag_array[BLE_CONN_STATE_N_FLAGS]; /**< Flag collections as array to allow use of @ref sdk_mapped_flags_bulk_update_by_key() when setting all flags. */
+        sdk_mapped_flags_t                flag_array[BLE_CONN_STATE_N_FLAGS]; /**< Flag collections as array to allow clearing all flags of a record. */
     };
 } ble_conn_state_t;
 
@@ -80,61 +81,161 @@ void bcs_internal_state_reset(void)
 }
 
 
+#if NRF_MODULE_ENABLED(BLE_CONN_STATE_CTX)
+// Create section "ble_conn_state_ctx".
+//lint -esym(526, ble_conn_state_ctxBase) -esym(526, ble_conn_state_ctxLimit)
+NRF_SECTION_VARS_CREATE_SECTION(ble_conn_state_ctx, ble_conn_state_ctx_t const);
+
+// Helper macros for section variables.
+#define BCS_CTX_SECTION_VARS_GET(i)     NRF_SECTION_VARS_GET((i),                      \
+                                                             ble_conn_state_ctx_t const, \
+                                                             ble_conn_state_ctx)
+#define BCS_CTX_SECTION_VARS_COUNT      NRF_SECTION_VARS_COUNT(ble_conn_state_ctx_t const, \
+                                                               ble_conn_state_ctx)
+
+
+/**@brief Function for clearing the elements of a record in all context slots.
+ *
+ * @param[in]  index  Index of the record.
+ */
+static void ctx_clear(uint16_t index)
+{
+    for (uint32_t i = 0; i < BCS_CTX_SECTION_VARS_COUNT; i++)
+    {
+        ble_conn_state_ctx_t const * p_ctx = BCS_CTX_SECTION_VARS_GET(i);
+
+        memset((uint8_t *)p_ctx->p_data + (index * p_ctx->size), 0, p_ctx->size);
+    }
+}
+#endif // NRF_MODULE_ENABLED(BLE_CONN_STATE_CTX)
+
+
+/**@brief Function for getting the state of a flag of a record.
+ *
+ * @param[in]  flags  The collection of flags to read.
+ * @param[in]  index  Index of the record, or @ref BLE_CONN_STATE_CONN_IDX_INVALID.
+ *
+ * @return  The state of the flag, false if the index is invalid.
+ */
+static bool flag_get(sdk_mapped_flags_t flags, uint16_t index)
+{
+    return (index < SDK_MAPPED_FLAGS_N_KEYS) && ((flags & (1U << index)) != 0);
+}
+
+
+/**@brief Function for setting the state of a flag of a record.
+ *
+ * @param[in]  p_flags  The collection of flags to modify.
+ * @param[in]  index    Index of the record, or @ref BLE_CONN_STATE_CONN_IDX_INVALID.
+ * @param[in]  value    The new state of the flag.
+ */
+static void flag_update(sdk_mapped_flags_t * p_flags, uint16_t index, bool value)
+{
+    if (index < SDK_MAPPED_FLAGS_N_KEYS)
+    {
+        if (value)
+        {
+            *p_flags |= (1U << index);
+        }
+        else
+        {
+            *p_flags &= ~(1U << index);
+        }
+    }
+}
+
+
+/**@brief Function for checking whether a record is valid and holds a connection handle.
+ */
+static bool record_matches(uint16_t index, uint16_t conn_handle)
+{
+    return (m_bcs.valid_conn_handles[index] == conn_handle) && flag_get(m_bcs.flags.valid_flags, index);
+}
+
+
+/**@brief Function for finding the record of a connection.
+ *
+ * @details The SoftDevice assigns connection handles counting from 0, so records are placed at
+ *          the index equal to their connection handle whenever possible. The records are searched
+ *          only if that is not the case.
+ *
+ * @param[in]  conn_handle  The connection handle to find.
+ *
+ * @return  The index of the record, or @ref BLE_CONN_STATE_CONN_IDX_INVALID if there is none.
+ */
+static uint16_t record_index_get(uint16_t conn_handle)
+{
+    if ((conn_handle < SDK_MAPPED_FLAGS_N_KEYS) && record_matches(conn_handle, conn_handle))
+    {
+        return conn_handle;
+    }
+
+    for (uint16_t i = 0; i < SDK_MAPPED_FLAGS_N_KEYS; i++)
+    {
+        if (record_matches(i, conn_handle))
+        {
+            return i;
+        }
+    }
+
+    return BLE_CONN_STATE_CONN_IDX_INVALID;
+}
+
+
 /**@brief Function for activating a connection record.
  *
- * @param p_record     The record to activate.
  * @param conn_handle  The connection handle to copy into the record.
- * @param role         The role of the connection.
  *
- * @return whether the record was activated successfully.
+ * @return The index of the record, or @ref BLE_CONN_STATE_CONN_IDX_INVALID if no record was available.
  */
-static bool record_activate(uint16_t conn_handle)
+static uint16_t record_activate(uint16_t conn_handle)
 {
-    uint16_t available_index = sdk_mapped_flags_first_key_index_get(~m_bcs.flags.valid_flags);
+    uint16_t available_index;
+
+    if ((conn_handle < SDK_MAPPED_FLAGS_N_KEYS) && !flag_get(m_bcs.flags.valid_flags, conn_handle))
+    {
+        available_index = conn_handle;
+    }
+    else
+    {
+        available_index = sdk_mapped_flags_first_key_index_get(~m_bcs.flags.valid_flags);
+    }
 
     if (available_index != SDK_MAPPED_FLAGS_INVALID_INDEX)
     {
         m_bcs.valid_conn_handles[available_index] = conn_handle;
-        sdk_mapped_flags_update_by_key(m_bcs.valid_conn_handles,
-                                      &m_bcs.flags.connected_flags,
-                                       conn_handle,
-                                       1);
-        sdk_mapped_flags_update_by_key(m_bcs.valid_conn_handles,
-                                      &m_bcs.flags.valid_flags,
-                                       conn_handle,
-                                       1);
-
-        return true;
+        flag_update(&m_bcs.flags.connected_flags, available_index, true);
+        flag_update(&m_bcs.flags.valid_flags,     available_index, true);
+
+#if NRF_MODULE_ENABLED(BLE_CONN_STATE_CTX)
+        ctx_clear(available_index);
+#endif // NRF_MODULE_ENABLED(BLE_CONN_STATE_CTX)
     }
 
-    return false;
+    return available_index;
 }
 
 
 /**@brief Function for marking a connection record as invalid and resetting the values.
  *
- * @param p_record  The record to invalidate.
+ * @param index  Index of the record to invalidate.
  */
-static void record_invalidate(uint16_t conn_handle)
+static void record_invalidate(uint16_t index)
 {
-    sdk_mapped_flags_bulk_update_by_key(m_bcs.valid_conn_handles,
-                                        m_bcs.flag_array,
-                                        BLE_CONN_STATE_N_FLAGS,
-                                        conn_handle,
-                                        0);
+    for (uint32_t i = 0; i < BLE_CONN_STATE_N_FLAGS; i++)
+    {
+        flag_update(&m_bcs.flag_array[i], index, false);
+    }
 }
 
 
 /**@brief Function for marking a connection as disconnected. See @ref BLE_CONN_STATUS_DISCONNECTED.
  *
- * @param p_record   The record of the connection to set as disconnected.
+ * @param conn_handle  The connection handle of the connection to set as disconnected.
  */
 static void record_set_disconnected(uint16_t conn_handle)
 {
-    sdk_mapped_flags_update_by_key(m_bcs.valid_conn_handles,
-                                  &m_bcs.flags.connected_flags,
-                                   conn_handle,
-                                   0);
+    flag_update(&m_bcs.flags.connected_flags, record_index_get(conn_handle), false);
 }
 
 
@@ -143,15 +244,12 @@ static void record_set_disconnected(uint16_t conn_handle)
  */
 static void record_purge_disconnected()
 {
-    sdk_mapped_flags_key_list_t disconnected_list;
+    sdk_mapped_flags_t disconnected_flags = (~m_bcs.flags.connected_flags) & (m_bcs.flags.valid_flags);
+    uint16_t           index;
 
-    disconnected_list = sdk_mapped_flags_key_list_get(
-                                   m_bcs.valid_conn_handles,
-                                 (~m_bcs.flags.connected_flags) & (m_bcs.flags.valid_flags));
-
-    for (uint32_t i = 0; i < disconnected_list.len; i++)
+    while ((index = sdk_mapped_flags_next_index_get(&disconnected_flags)) != SDK_MAPPED_FLAGS_INVALID_INDEX)
     {
-        record_invalidate(disconnected_list.flag_keys[i]);
+        record_invalidate(index);
     }
 }
 
@@ -186,12 +284,15 @@ void ble_conn_state_init(void)
 
 void ble_conn_state_on_ble_evt(ble_evt_t * p_ble_evt)
 {
+    uint16_t index;
+
     switch (p_ble_evt->header.evt_id)
     {
         case BLE_GAP_EVT_CONNECTED:
             record_purge_disconnected();
 
-            if ( !record_activate(p_ble_evt->evt.gap_evt.conn_handle) )
+            index = record_activate(p_ble_evt->evt.gap_evt.conn_handle);
+            if (index == BLE_CONN_STATE_CONN_IDX_INVALID)
             {
                 // No more records available. Should not happen.
                 APP_ERROR_HANDLER(NRF_ERROR_NO_MEM);
@@ -201,10 +302,7 @@ void ble_conn_state_on_ble_evt(ble_evt_t * p_ble_evt)
                 bool is_central =
                         (p_ble_evt->evt.gap_evt.params.connected.role == BLE_GAP_ROLE_CENTRAL);
 
-                sdk_mapped_flags_update_by_key(m_bcs.valid_conn_handles,
-                                              &m_bcs.flags.central_flags,
-                                               p_ble_evt->evt.gap_evt.conn_handle,
-                                               is_central);
+                flag_update(&m_bcs.flags.central_flags, index, is_central);
             }
 
             break;
@@ -214,16 +312,13 @@ void ble_conn_state_on_ble_evt(ble_evt_t * p_ble_evt)
             break;
 
         case BLE_GAP_EVT_CONN_SEC_UPDATE:
-            sdk_mapped_flags_update_by_key(
-                          m_bcs.valid_conn_handles,
-                         &m_bcs.flags.encrypted_flags,
-                          p_ble_evt->evt.gap_evt.conn_handle,
-                         (p_ble_evt->evt.gap_evt.params.conn_sec_update.conn_sec.sec_mode.lv > 1));
-            sdk_mapped_flags_update_by_key(
-                          m_bcs.valid_conn_handles,
-                         &m_bcs.flags.mitm_protected_flags,
-                          p_ble_evt->evt.gap_evt.conn_handle,
-                         (p_ble_evt->evt.gap_evt.params.conn_sec_update.conn_sec.sec_mode.lv > 2));
+            index = record_index_get(p_ble_evt->evt.gap_evt.conn_handle);
+            flag_update(&m_bcs.flags.encrypted_flags,
+                         index,
+                        (p_ble_evt->evt.gap_evt.params.conn_sec_update.conn_sec.sec_mode.lv > 1));
+            flag_update(&m_bcs.flags.mitm_protected_flags,
+                         index,
+                        (p_ble_evt->evt.gap_evt.params.conn_sec_update.conn_sec.sec_mode.lv > 2));
             break;
     }
 }
@@ -231,21 +326,24 @@ void ble_conn_state_on_ble_evt(ble_evt_t * p_ble_evt)
 
 bool ble_conn_state_valid(uint16_t conn_handle)
 {
-    return sdk_mapped_flags_get_by_key(m_bcs.valid_conn_handles,
-                                       m_bcs.flags.valid_flags,
-                                       conn_handle);
+    return (record_index_get(conn_handle) != BLE_CONN_STATE_CONN_IDX_INVALID);
+}
+
+
+uint16_t ble_conn_state_conn_idx(uint16_t conn_handle)
+{
+    return record_index_get(conn_handle);
 }
 
 
 uint8_t ble_conn_state_role(uint16_t conn_handle)
 {
-    uint8_t role = BLE_GAP_ROLE_INVALID;
+    uint8_t  role  = BLE_GAP_ROLE_INVALID;
+    uint16_t index = record_index_get(conn_handle);
 
-    if ( sdk_mapped_flags_get_by_key(m_bcs.valid_conn_handles, m_bcs.flags.valid_flags, conn_handle) )
+    if (index != BLE_CONN_STATE_CONN_IDX_INVALID)
     {
-        bool central = sdk_mapped_flags_get_by_key(m_bcs.valid_conn_handles,
-                                                   m_bcs.flags.central_flags,
-                                                   conn_handle);
+        bool central = flag_get(m_bcs.flags.central_flags, index);
 
         role = central ? BLE_GAP_ROLE_CENTRAL : BLE_GAP_ROLE_PERIPH;
     }
@@ -257,15 +355,11 @@ uint8_t ble_conn_state_role(uint16_t conn_handle)
 ble_conn_state_status_t ble_conn_state_status(uint16_t conn_handle)
 {
     ble_conn_state_status_t conn_status = BLE_CONN_STATUS_INVALID;
-    bool valid = sdk_mapped_flags_get_by_key(m_bcs.valid_conn_handles,
-                                             m_bcs.flags.valid_flags,
-                                             conn_handle);
+    uint16_t                index       = record_index_get(conn_handle);
 
-    if (valid)
+    if (index != BLE_CONN_STATE_CONN_IDX_INVALID)
     {
-        bool connected = sdk_mapped_flags_get_by_key(m_bcs.valid_conn_handles,
-                                                     m_bcs.flags.connected_flags,
-                                                     conn_handle);
+        bool connected = flag_get(m_bcs.flags.connected_flags, index);
 
         conn_status = connected ? BLE_CONN_STATUS_CONNECTED : BLE_CONN_STATUS_DISCONNECTED;
     }
@@ -276,17 +370,13 @@ ble_conn_state_status_t ble_conn_state_status(uint16_t conn_handle)
 
 bool ble_conn_state_encrypted(uint16_t conn_handle)
 {
-    return sdk_mapped_flags_get_by_key(m_bcs.valid_conn_handles,
-                                       m_bcs.flags.encrypted_flags,
-                                       conn_handle);
+    return flag_get(m_bcs.flags.encrypted_flags, record_index_get(conn_handle));
 }
 
 
 bool ble_conn_state_mitm_protected(uint16_t conn_handle)
 {
-    return sdk_mapped_flags_get_by_key(m_bcs.valid_conn_handles,
-                                       m_bcs.flags.mitm_protected_flags,
-                                       conn_handle);
+    return flag_get(m_bcs.flags.mitm_protected_flags, record_index_get(conn_handle));
 }
 
 
@@ -349,9 +439,7 @@ bool ble_conn_state_user_flag_get(uint16_t conn_handle, ble_conn_state_user_flag
 {
     if (user_flag_is_acquired(flag_id))
     {
-        return sdk_mapped_flags_get_by_key(m_bcs.valid_conn_handles,
-                                           m_bcs.flags.user_flags[flag_id],
-                                           conn_handle);
+        return flag_get(m_bcs.flags.user_flags[flag_id], record_index_get(conn_handle));
     }
     else
     {
@@ -366,10 +454,7 @@ void ble_conn_state_user_flag_set(uint16_t                      conn_handle,
 {
     if (user_flag_is_acquired(flag_id))
     {
-        sdk_mapped_flags_update_by_key(m_bcs.valid_conn_handles,
-                                      &m_bcs.flags.user_flags[flag_id],
-                                       conn_handle,
-                                       value);
+        flag_update(&m_bcs.flags.user_flags[flag_id], record_index_get(conn_handle), value);
     }
 }
 
@@ -385,3 +470,18 @@ sdk_mapped_flags_t ble_conn_state_user_flag_collection(ble_conn_state_user_flag_
         return 0;
     }
 }
+
+
+#if NRF_MODULE_ENABLED(BLE_CONN_STATE_CTX)
+void * ble_conn_state_ctx_get(ble_conn_state_ctx_t const * p_ctx, uint16_t conn_handle)
+{
+    uint16_t index = record_index_get(conn_handle);
+
+    if ((p_ctx == NULL) || (index == BLE_CONN_STATE_CONN_IDX_INVALID))
+    {
+        return NULL;
+    }
+
+    return (uint8_t *)p_ctx->p_data + (index * p_ctx->size);
+}
+#endif // NRF_MODULE_ENABLED(BLE_CONN_STATE_CTX)
@@ -44,6 +44,10 @@
 #include <stdint.h>
 #include "ble.h"
 #include "sdk_mapped_flags.h"
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(BLE_CONN_STATE_CTX)
+#include "section_vars.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -94,6 +98,43 @@ typedef enum
     BLE_CONN_STATE_USER_FLAG_INVALID,
 } ble_conn_state_user_flag_id_t;
 
+#define BLE_CONN_STATE_CONN_IDX_INVALID SDK_MAPPED_FLAGS_INVALID_INDEX  /**< Index returned for connection handles without a record. */
+
+
+#if NRF_MODULE_ENABLED(BLE_CONN_STATE_CTX) || defined(__SDK_DOXYGEN__)
+/**@brief Per-connection context slot.
+ *
+ * @details A slot holds one element for every connection record. Slots are defined with
+ *          @ref BLE_CONN_STATE_CTX_DEF, and their elements are cleared when a new connection is
+ *          recorded.
+ */
+typedef struct
+{
+    void     * p_data;  /**< Storage of the slot, @ref SDK_MAPPED_FLAGS_N_KEYS elements. */
+    uint32_t   size;    /**< Size of one element. */
+} ble_conn_state_ctx_t;
+
+
+/**@brief Macro for defining a per-connection context slot.
+ *
+ * @details This macro places the slot in a section named "ble_conn_state_ctx". The element of a
+ *          connection is fetched with @ref ble_conn_state_ctx_get.
+ *
+ * @note The linker script must keep the section, like for other section variables.
+ *
+ * @param[in]   _name   Name of the slot.
+ * @param[in]   _type   Type of the element of every connection.
+ */
+#define BLE_CONN_STATE_CTX_DEF(_name, _type)                                            \
+    static _type CONCAT_2(_name, _data)[SDK_MAPPED_FLAGS_N_KEYS];                       \
+    NRF_SECTION_VARS_REGISTER_VAR(ble_conn_state_ctx,                                   \
+                                  ble_conn_state_ctx_t const _name) =                   \
+    {                                                                                   \
+        .p_data = CONCAT_2(_name, _data),                                               \
+        .size   = sizeof(_type),                                                        \
+    }
+#endif // NRF_MODULE_ENABLED(BLE_CONN_STATE_CTX) || defined(__SDK_DOXYGEN__)
+
 
 /**
  * @defgroup ble_conn_state_functions BLE connection state functions
@@ -129,6 +170,20 @@ void ble_conn_state_on_ble_evt(ble_evt_t * p_ble_evt);
 bool ble_conn_state_valid(uint16_t conn_handle);
 
 
+/**@brief Function for getting the index of the record of a connection.
+ *
+ * @details The index is in the range 0 to @ref SDK_MAPPED_FLAGS_N_KEYS - 1, and is the same as
+ *          the index of the connection in the flag collections. It can be used to index
+ *          per-connection tables directly. Records are placed at the index equal to their
+ *          connection handle whenever possible, so the lookup seldom needs a search.
+ *
+ * @param[in]  conn_handle  Handle of the connection.
+ *
+ * @return  The index, or @ref BLE_CONN_STATE_CONN_IDX_INVALID if the connection handle is not valid.
+ */
+uint16_t ble_conn_state_conn_idx(uint16_t conn_handle);
+
+
 /**@brief Function for querying the role of the local device in a connection.
  *
  * @param[in]  conn_handle  Handle of the connection to get the role for.
@@ -273,6 +328,18 @@ void ble_conn_state_user_flag_set(uint16_t                      conn_handle,
  */
 sdk_mapped_flags_t ble_conn_state_user_flag_collection(ble_conn_state_user_flag_id_t flag_id);
 
+
+#if NRF_MODULE_ENABLED(BLE_CONN_STATE_CTX) || defined(__SDK_DOXYGEN__)
+/**@brief Function for getting the element of a connection in a context slot.
+ *
+ * @param[in]  p_ctx        Slot defined with @ref BLE_CONN_STATE_CTX_DEF.
+ * @param[in]  conn_handle  Handle of the connection.
+ *
+ * @return  Pointer to the element, or NULL if the connection handle is not valid.
+ */
+void * ble_conn_state_ctx_get(ble_conn_state_ctx_t const * p_ctx, uint16_t conn_handle);
+#endif // NRF_MODULE_ENABLED(BLE_CONN_STATE_CTX) || defined(__SDK_DOXYGEN__)
+
 /** @} */
 /** @} */
 
@@ -0,0 +1,18 @@
+/**
+ *
+ * @defgroup ble_conn_state_config Connection state configuration
+ * @{
+ * @ingroup ble_conn_state
+ */
+/** @brief Enable per-connection context slots.
+ *
+ *  The linker script must keep the "ble_conn_state_ctx" section.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_CONN_STATE_CTX_ENABLED
+
+
+/** @} */
@@ -0,0 +1,105 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(BLE_HVX_COALESCE)
+#include "ble_hvx_coalesce.h"
+#include "nrf_soc.h"
+#include "nrf_nvic.h"
+#include "app_util_platform.h"
+
+#ifndef BLE_HVX_COALESCE_DISTANCE
+#define BLE_HVX_COALESCE_DISTANCE NRF_RADIO_NOTIFICATION_DISTANCE_800US
+#endif
+
+static ble_hvx_coalesce_t * mp_head = NULL; /**< List of registered instances. */
+
+
+static void instances_flush(void)
+{
+    for (ble_hvx_coalesce_t * p_inst = mp_head; p_inst != NULL; p_inst = p_inst->p_next)
+    {
+        if (p_inst->pending)
+        {
+            // Cleared first, so that a request from the handler is served by the next radio event.
+            p_inst->pending = false;
+            p_inst->flush(p_inst->p_context);
+        }
+    }
+}
+
+
+#if NRF_MODULE_ENABLED(BLE_RADIO_GAP)
+void ble_hvx_coalesce_on_radio_evt(bool radio_active)
+{
+    if (radio_active)
+    {
+        instances_flush();
+    }
+}
+#else
+void RADIO_NOTIFICATION_IRQHandler(void)
+{
+    instances_flush();
+}
+#endif
+
+
+ret_code_t ble_hvx_coalesce_init(uint8_t irq_priority)
+{
+#if NRF_MODULE_ENABLED(BLE_RADIO_GAP)
+    // The radio notification is set up by ble_radio_gap, which forwards it.
+    UNUSED_PARAMETER(irq_priority);
+    return NRF_SUCCESS;
+#else
+    ret_code_t err_code;
+
+    err_code = sd_nvic_ClearPendingIRQ(RADIO_NOTIFICATION_IRQn);
+    VERIFY_SUCCESS(err_code);
+
+    err_code = sd_nvic_SetPriority(RADIO_NOTIFICATION_IRQn, irq_priority);
+    VERIFY_SUCCESS(err_code);
+
+    err_code = sd_nvic_EnableIRQ(RADIO_NOTIFICATION_IRQn);
+    VERIFY_SUCCESS(err_code);
+
+    return sd_radio_notification_cfg_set(NRF_RADIO_NOTIFICATION_TYPE_INT_ON_ACTIVE,
+                                         BLE_HVX_COALESCE_DISTANCE);
+#endif
+}
+
+
+ret_code_t ble_hvx_coalesce_register(ble_hvx_coalesce_t     * p_inst,
+                                     ble_hvx_coalesce_flush_t flush,
+                                     void                   * p_context)
+{
+    VERIFY_PARAM_NOT_NULL(p_inst);
+    VERIFY_PARAM_NOT_NULL(flush);
+
+    p_inst->flush     = flush;
+    p_inst->p_context = p_context;
+    p_inst->pending   = false;
+
+    CRITICAL_REGION_ENTER();
+    p_inst->p_next = mp_head;
+    mp_head        = p_inst;
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+
+
+void ble_hvx_coalesce_request(ble_hvx_coalesce_t * p_inst)
+{
+    p_inst->pending = true;
+}
+
+#endif // NRF_MODULE_ENABLED(BLE_HVX_COALESCE)
@@ -0,0 +1,110 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ble_hvx_coalesce Notification coalescing
+ * @{
+ * @ingroup ble_sdk_lib
+ * @brief Module for sending the notifications of a service once per radio event.
+ *
+ * @details A service that produces measurements faster than the connection interval stores
+ *          them and calls @ref ble_hvx_coalesce_request instead of sending a notification for
+ *          every sample. Shortly before the next radio event, the module calls the flush
+ *          handler of every instance with a pending request. The handler encodes the newest
+ *          value together with the stored data in one notification.
+ *
+ *          The timing comes from the radio notification of the SoftDevice. The notification
+ *          interrupt fires @ref BLE_HVX_COALESCE_DISTANCE before every radio event, and the
+ *          flush handlers run in this interrupt.
+ *
+ * @note The module uses the radio notification interrupt (@ref RADIO_NOTIFICATION_IRQHandler)
+ *       and cannot be used together with other users of the radio notification. If
+ *       @ref ble_radio_gap is enabled, it owns the interrupt instead, and
+ *       @ref ble_hvx_coalesce_on_radio_evt must be passed to it as the radio event handler.
+ */
+
+#ifndef BLE_HVX_COALESCE_H__
+#define BLE_HVX_COALESCE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**@brief Flush handler type. The handler sends the stored data of the service.
+ *
+ * @param[in] p_context Context passed to @ref ble_hvx_coalesce_register.
+ */
+typedef void (*ble_hvx_coalesce_flush_t)(void * p_context);
+
+/**@brief Coalescing instance of a service. Its content must not be accessed by the service. */
+typedef struct ble_hvx_coalesce_s
+{
+    ble_hvx_coalesce_flush_t    flush;      /**< Flush handler. */
+    void                      * p_context;  /**< Context of the flush handler. */
+    volatile bool               pending;    /**< A flush has been requested. */
+    struct ble_hvx_coalesce_s * p_next;     /**< Next registered instance. */
+} ble_hvx_coalesce_t;
+
+/**@brief Function for initializing the module.
+ *
+ * @details The radio notification is enabled with the distance @ref BLE_HVX_COALESCE_DISTANCE.
+ *          The SoftDevice must be enabled first. If @ref ble_radio_gap is enabled, the radio
+ *          notification is left to it, with its distance, and this function does nothing.
+ *
+ * @param[in] irq_priority Priority of the radio notification interrupt. Must be an application
+ *                         priority, the flush handlers call the SoftDevice.
+ *
+ * @return NRF_SUCCESS or an error from the SoftDevice.
+ */
+ret_code_t ble_hvx_coalesce_init(uint8_t irq_priority);
+
+/**@brief Function for registering a coalescing instance.
+ *
+ * @param[out] p_inst    Instance to register. Must stay valid while the module is running.
+ * @param[in]  flush     Flush handler.
+ * @param[in]  p_context Context passed to the flush handler.
+ *
+ * @retval NRF_SUCCESS    If the instance was registered.
+ * @retval NRF_ERROR_NULL If a NULL pointer was passed.
+ */
+ret_code_t ble_hvx_coalesce_register(ble_hvx_coalesce_t     * p_inst,
+                                     ble_hvx_coalesce_flush_t flush,
+                                     void                   * p_context);
+
+/**@brief Function for requesting a flush before the next radio event.
+ *
+ * @details Several requests before the same radio event result in one call of the flush handler.
+ *
+ * @param[in] p_inst Instance.
+ */
+void ble_hvx_coalesce_request(ble_hvx_coalesce_t * p_inst);
+
+/**@brief Function for handling the radio events forwarded by @ref ble_radio_gap.
+ *
+ * @details Only used if @ref ble_radio_gap is enabled.
+ *
+ * @param[in] radio_active True shortly before a radio event.
+ */
+void ble_hvx_coalesce_on_radio_evt(bool radio_active);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLE_HVX_COALESCE_H__
+
+/** @} */
@@ -0,0 +1,32 @@
+/**
+ *
+ * @defgroup ble_hvx_coalesce_config Notification coalescing configuration
+ * @{
+ * @ingroup ble_hvx_coalesce
+ */
+/** @brief Enable notification coalescing.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_HVX_COALESCE_ENABLED
+
+/** @brief Distance between the radio notification and the start of a radio event.
+ *
+ *  Must be large enough for the flush handlers to queue their notifications.
+ *
+ *  The following values are supported:
+ *  - NRF_RADIO_NOTIFICATION_DISTANCE_800US
+ *  - NRF_RADIO_NOTIFICATION_DISTANCE_1740US
+ *  - NRF_RADIO_NOTIFICATION_DISTANCE_2680US
+ *  - NRF_RADIO_NOTIFICATION_DISTANCE_3620US
+ *  - NRF_RADIO_NOTIFICATION_DISTANCE_4560US
+ *  - NRF_RADIO_NOTIFICATION_DISTANCE_5500US
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_HVX_COALESCE_DISTANCE
+
+
+/** @} */
@@ -0,0 +1,338 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(BLE_LINK_ADAPT)
+#include <string.h>
+#include "ble_link_adapt.h"
+
+#define RSSI_SHIFT   4 /**< Fraction bits of the filtered RSSI. */
+#define RSSI_WEIGHT  2 /**< The filter weights a new sample by 1 / (1 << RSSI_WEIGHT). */
+
+/**@brief TX powers supported by the SoftDevice, in dBm. */
+static const int8_t m_levels[BLE_LINK_ADAPT_LEVELS] = {-40, -20, -16, -12, -8, -4, 0, 3, 4};
+
+/**@brief Typical radio TX current of nRF52832 with the DC/DC converter, in microamperes, for each
+ *        TX power. Only used for the statistics.
+ */
+static const uint16_t m_tx_current_ua[BLE_LINK_ADAPT_LEVELS] =
+    {2700, 3100, 3200, 3500, 3800, 4200, 5300, 7000, 7500};
+
+typedef struct
+{
+    uint16_t conn_handle; /**< BLE_CONN_HANDLE_INVALID if the entry is free. */
+    int16_t  rssi;        /**< Filtered RSSI, with RSSI_SHIFT fraction bits. */
+    bool     rssi_valid;  /**< At least one RSSI sample was received. */
+    uint8_t  level;       /**< TX power needed by the link, as an index in m_levels. */
+    uint8_t  down_count;  /**< Samples in a row with enough margin to step down. */
+    uint8_t  hold;        /**< Samples left at the highest TX power after a loss. */
+} link_t;
+
+static struct
+{
+    link_t                       links[BLE_LINK_ADAPT_CONFIG_MAX_LINKS];
+    uint8_t                      min;       /**< Index of the lowest TX power. */
+    uint8_t                      max;       /**< Index of the highest TX power. */
+    uint8_t                      idle;      /**< Index of the TX power without links. */
+    uint8_t                      current;   /**< Index of the TX power set. */
+    uint8_t                      untracked; /**< Links without an entry, kept at the highest TX power. */
+    ble_link_adapt_evt_handler_t evt_handler;
+    uint32_t                     changes;
+    uint32_t                     losses;
+    uint32_t                     packets[BLE_LINK_ADAPT_LEVELS];
+} m_cb;
+
+
+/**@brief Function for getting the index of a TX power, or BLE_LINK_ADAPT_LEVELS if unsupported. */
+static uint8_t level_find(int8_t tx_power)
+{
+    uint8_t idx;
+
+    for (idx = 0; idx < BLE_LINK_ADAPT_LEVELS; idx++)
+    {
+        if (m_levels[idx] == tx_power)
+        {
+            break;
+        }
+    }
+    return idx;
+}
+
+
+static link_t * link_find(uint16_t conn_handle)
+{
+    for (uint32_t i = 0; i < BLE_LINK_ADAPT_CONFIG_MAX_LINKS; i++)
+    {
+        if (m_cb.links[i].conn_handle == conn_handle)
+        {
+            return &m_cb.links[i];
+        }
+    }
+    return NULL;
+}
+
+
+/**@brief Function for estimating the RSSI at the peer of our packets sent at a TX power. */
+static int32_t peer_rssi(link_t const * p_link, uint8_t level)
+{
+    int32_t rssi = p_link->rssi / (1 << RSSI_SHIFT);
+
+    return rssi - BLE_LINK_ADAPT_CONFIG_PEER_TX_DBM + m_levels[level];
+}
+
+
+/**@brief Function for setting the highest TX power needed by the links. */
+static void tx_power_apply(void)
+{
+    bool    linked = (m_cb.untracked > 0);
+    uint8_t level  = linked ? m_cb.max : m_cb.min;
+
+    for (uint32_t i = 0; i < BLE_LINK_ADAPT_CONFIG_MAX_LINKS; i++)
+    {
+        if (m_cb.links[i].conn_handle != BLE_CONN_HANDLE_INVALID)
+        {
+            linked = true;
+            level  = MAX(level, m_cb.links[i].level);
+        }
+    }
+    if (!linked)
+    {
+        level = m_cb.idle;
+    }
+
+    if (level == m_cb.current)
+    {
+        return;
+    }
+
+    // On failure the current TX power is kept, and the change tried again on the next sample.
+    if (sd_ble_gap_tx_power_set(m_levels[level]) == NRF_SUCCESS)
+    {
+        m_cb.current = level;
+        m_cb.changes++;
+        if (m_cb.evt_handler != NULL)
+        {
+            m_cb.evt_handler(m_levels[level]);
+        }
+    }
+}
+
+
+static void on_rssi(link_t * p_link, int8_t rssi)
+{
+    if (!p_link->rssi_valid)
+    {
+        p_link->rssi       = (int16_t)(rssi * (1 << RSSI_SHIFT));
+        p_link->rssi_valid = true;
+    }
+    else
+    {
+        p_link->rssi += (int16_t)((rssi * (1 << RSSI_SHIFT) - p_link->rssi) / (1 << RSSI_WEIGHT));
+    }
+
+    if (p_link->hold > 0)
+    {
+        p_link->hold--;
+        return;
+    }
+
+    uint8_t needed = m_cb.min;
+    while ((needed < m_cb.max) && (peer_rssi(p_link, needed) < BLE_LINK_ADAPT_CONFIG_TARGET_RSSI))
+    {
+        needed++;
+    }
+
+    if (needed >= p_link->level)
+    {
+        // Raised at once: a weak link costs retransmissions and risks a supervision timeout.
+        p_link->level      = needed;
+        p_link->down_count = 0;
+    }
+    else if (peer_rssi(p_link, p_link->level - 1) >=
+             BLE_LINK_ADAPT_CONFIG_TARGET_RSSI + BLE_LINK_ADAPT_CONFIG_HYST_DB)
+    {
+        if (++p_link->down_count >= BLE_LINK_ADAPT_CONFIG_DOWN_SAMPLES)
+        {
+            p_link->level--;
+            p_link->down_count = 0;
+        }
+    }
+    else
+    {
+        p_link->down_count = 0;
+    }
+}
+
+
+static void on_loss(link_t * p_link)
+{
+    p_link->level      = m_cb.max;
+    p_link->down_count = 0;
+    p_link->hold       = BLE_LINK_ADAPT_CONFIG_LOSS_HOLD_SAMPLES;
+    m_cb.losses++;
+}
+
+
+static void on_connected(uint16_t conn_handle)
+{
+    link_t * p_link = link_find(BLE_CONN_HANDLE_INVALID);
+
+    if (p_link == NULL)
+    {
+        m_cb.untracked++;
+        return;
+    }
+
+    // Started at the highest TX power until the RSSI is known.
+    p_link->conn_handle = conn_handle;
+    p_link->rssi_valid  = false;
+    p_link->level       = m_cb.max;
+    p_link->down_count  = 0;
+    p_link->hold        = 0;
+
+    // A threshold of 0 dBm reports a sample after every skip_count samples.
+    if (sd_ble_gap_rssi_start(conn_handle, 0, BLE_LINK_ADAPT_CONFIG_RSSI_SKIP) != NRF_SUCCESS)
+    {
+        p_link->conn_handle = BLE_CONN_HANDLE_INVALID;
+        m_cb.untracked++;
+    }
+}
+
+
+ret_code_t ble_link_adapt_init(ble_link_adapt_init_t const * p_init)
+{
+    ret_code_t err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_init);
+
+    m_cb.min  = level_find(p_init->tx_power_min);
+    m_cb.max  = level_find(p_init->tx_power_max);
+    m_cb.idle = level_find(p_init->tx_power_idle);
+    if ((m_cb.min  >= BLE_LINK_ADAPT_LEVELS) ||
+        (m_cb.max  >= BLE_LINK_ADAPT_LEVELS) ||
+        (m_cb.idle >= BLE_LINK_ADAPT_LEVELS) ||
+        (m_cb.min > m_cb.max))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    for (uint32_t i = 0; i < BLE_LINK_ADAPT_CONFIG_MAX_LINKS; i++)
+    {
+        m_cb.links[i].conn_handle = BLE_CONN_HANDLE_INVALID;
+    }
+    m_cb.untracked   = 0;
+    m_cb.evt_handler = p_init->evt_handler;
+    m_cb.changes     = 0;
+    m_cb.losses      = 0;
+    memset(m_cb.packets, 0, sizeof(m_cb.packets));
+
+    err_code = sd_ble_gap_tx_power_set(m_levels[m_cb.idle]);
+    VERIFY_SUCCESS(err_code);
+    m_cb.current = m_cb.idle;
+
+    return NRF_SUCCESS;
+}
+
+
+void ble_link_adapt_on_ble_evt(ble_evt_t const * p_ble_evt)
+{
+    link_t * p_link;
+
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GAP_EVT_CONNECTED:
+            on_connected(p_ble_evt->evt.gap_evt.conn_handle);
+            break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            p_link = link_find(p_ble_evt->evt.gap_evt.conn_handle);
+            if (p_link != NULL)
+            {
+                p_link->conn_handle = BLE_CONN_HANDLE_INVALID;
+            }
+            else if (m_cb.untracked > 0)
+            {
+                m_cb.untracked--;
+            }
+            break;
+
+        case BLE_GAP_EVT_RSSI_CHANGED:
+            p_link = link_find(p_ble_evt->evt.gap_evt.conn_handle);
+            if (p_link != NULL)
+            {
+                on_rssi(p_link, p_ble_evt->evt.gap_evt.params.rssi_changed.rssi);
+            }
+            break;
+
+        case BLE_GATTC_EVT_TIMEOUT:
+            p_link = link_find(p_ble_evt->evt.gattc_evt.conn_handle);
+            if (p_link != NULL)
+            {
+                on_loss(p_link);
+            }
+            break;
+
+        case BLE_GATTS_EVT_TIMEOUT:
+            p_link = link_find(p_ble_evt->evt.gatts_evt.conn_handle);
+            if (p_link != NULL)
+            {
+                on_loss(p_link);
+            }
+            break;
+
+        case BLE_EVT_TX_COMPLETE:
+            m_cb.packets[m_cb.current] += p_ble_evt->evt.common_evt.params.tx_complete.count;
+            return;
+
+        default:
+            return;
+    }
+
+    tx_power_apply();
+}
+
+
+void ble_link_adapt_loss_report(uint16_t conn_handle)
+{
+    link_t * p_link = link_find(conn_handle);
+
+    if ((p_link == NULL) || (conn_handle == BLE_CONN_HANDLE_INVALID))
+    {
+        return;
+    }
+
+    on_loss(p_link);
+    tx_power_apply();
+}
+
+
+void ble_link_adapt_stats_get(ble_link_adapt_stats_t * p_stats)
+{
+    uint64_t charge  = 0;
+    uint32_t packets = 0;
+
+    p_stats->tx_power = m_levels[m_cb.current];
+    p_stats->changes  = m_cb.changes;
+    p_stats->losses   = m_cb.losses;
+
+    for (uint32_t i = 0; i < BLE_LINK_ADAPT_LEVELS; i++)
+    {
+        p_stats->packets[i] = m_cb.packets[i];
+        packets            += m_cb.packets[i];
+        charge             += (uint64_t)m_cb.packets[i] * m_tx_current_ua[i];
+    }
+
+    // A bit lasts 1 us on the 1 Mbps PHY: uA * mV * us is fJ.
+    p_stats->energy_per_bit_pj = (packets == 0) ? 0 :
+        (uint32_t)(charge * BLE_LINK_ADAPT_CONFIG_VDD_MV / packets / 1000);
+}
+
+#endif // NRF_MODULE_ENABLED(BLE_LINK_ADAPT)
@@ -0,0 +1,180 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ble_link_adapt TX power adaptation
+ * @{
+ * @ingroup ble_sdk_lib
+ *
+ * @brief Module for lowering the TX power while the link margin is high.
+ *
+ * @details The RSSI of every connection is sampled by the SoftDevice and filtered. Assuming the
+ *          path loss is the same both ways, and that the peer transmits at
+ *          @ref BLE_LINK_ADAPT_CONFIG_PEER_TX_DBM, the RSSI of our packets at the peer is estimated
+ *          for each TX power. The TX power of a link is the lowest one that keeps this estimate
+ *          above @ref BLE_LINK_ADAPT_CONFIG_TARGET_RSSI.
+ *
+ *          The TX power is raised at once when needed, and lowered one step at a time, only after
+ *          @ref BLE_LINK_ADAPT_CONFIG_DOWN_SAMPLES samples with @ref BLE_LINK_ADAPT_CONFIG_HYST_DB
+ *          of margin above the next lower step. A loss, reported with
+ *          @ref ble_link_adapt_loss_report or seen as a GATT timeout, sets the highest TX power for
+ *          @ref BLE_LINK_ADAPT_CONFIG_LOSS_HOLD_SAMPLES samples.
+ *
+ *          The SoftDevice has one TX power for all roles, so the highest TX power needed by the
+ *          links is set, and the idle TX power when there are none.
+ *
+ *          The module counts the packets sent at each TX power, from @ref BLE_EVT_TX_COMPLETE,
+ *          and derives the mean energy per transmitted bit from the typical radio current.
+ */
+
+#ifndef BLE_LINK_ADAPT_H__
+#define BLE_LINK_ADAPT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of links adapted at the same time.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_LINK_ADAPT_CONFIG_MAX_LINKS
+#define BLE_LINK_ADAPT_CONFIG_MAX_LINKS 2
+#endif
+
+/** @brief Lowest acceptable RSSI of our packets at the peer, in dBm, margin included.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_LINK_ADAPT_CONFIG_TARGET_RSSI
+#define BLE_LINK_ADAPT_CONFIG_TARGET_RSSI -75
+#endif
+
+/** @brief TX power assumed for the peer, in dBm.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_LINK_ADAPT_CONFIG_PEER_TX_DBM
+#define BLE_LINK_ADAPT_CONFIG_PEER_TX_DBM 0
+#endif
+
+/** @brief Margin above the next lower TX power needed to step down, in dB.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_LINK_ADAPT_CONFIG_HYST_DB
+#define BLE_LINK_ADAPT_CONFIG_HYST_DB 6
+#endif
+
+/** @brief Number of RSSI samples in a row with enough margin before stepping down.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_LINK_ADAPT_CONFIG_DOWN_SAMPLES
+#define BLE_LINK_ADAPT_CONFIG_DOWN_SAMPLES 8
+#endif
+
+/** @brief Number of RSSI samples the highest TX power is kept after a loss.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_LINK_ADAPT_CONFIG_LOSS_HOLD_SAMPLES
+#define BLE_LINK_ADAPT_CONFIG_LOSS_HOLD_SAMPLES 32
+#endif
+
+/** @brief Number of RSSI samples the SoftDevice skips between reports.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_LINK_ADAPT_CONFIG_RSSI_SKIP
+#define BLE_LINK_ADAPT_CONFIG_RSSI_SKIP 4
+#endif
+
+/** @brief Supply voltage used for the energy statistics, in millivolts.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_LINK_ADAPT_CONFIG_VDD_MV
+#define BLE_LINK_ADAPT_CONFIG_VDD_MV 3000
+#endif
+
+/** @brief Number of TX powers: -40, -20, -16, -12, -8, -4, 0, 3 and 4 dBm. */
+#define BLE_LINK_ADAPT_LEVELS 9
+
+/**@brief TX power change handler type.
+ *
+ * @param[in] tx_power New TX power, in dBm.
+ */
+typedef void (* ble_link_adapt_evt_handler_t)(int8_t tx_power);
+
+/**@brief Initialization parameters. */
+typedef struct
+{
+    int8_t                       tx_power_min;  /**< Lowest TX power of a link, in dBm. */
+    int8_t                       tx_power_max;  /**< Highest TX power, in dBm. */
+    int8_t                       tx_power_idle; /**< TX power without links, for advertising, in dBm. */
+    ble_link_adapt_evt_handler_t evt_handler;   /**< Handler of TX power changes, or NULL. */
+} ble_link_adapt_init_t;
+
+/**@brief Statistics. */
+typedef struct
+{
+    int8_t   tx_power;                         /**< Current TX power, in dBm. */
+    uint32_t changes;                          /**< Number of TX power changes. */
+    uint32_t losses;                           /**< Number of losses. */
+    uint32_t packets[BLE_LINK_ADAPT_LEVELS];   /**< Packets sent at each TX power, lowest first. */
+    uint32_t energy_per_bit_pj;                /**< Mean radio energy per transmitted bit, in pJ. */
+} ble_link_adapt_stats_t;
+
+/**@brief Function for initializing the module. The idle TX power is set.
+ *
+ * @param[in] p_init Initialization parameters.
+ *
+ * @retval NRF_SUCCESS             If the module was initialized.
+ * @retval NRF_ERROR_NULL          If p_init was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If a TX power was not supported, or the minimum above the maximum.
+ * @return Other errors from @ref sd_ble_gap_tx_power_set.
+ */
+ret_code_t ble_link_adapt_init(ble_link_adapt_init_t const * p_init);
+
+/**@brief Function for handling BLE events.
+ *
+ * @param[in] p_ble_evt Event received from the BLE stack.
+ */
+void ble_link_adapt_on_ble_evt(ble_evt_t const * p_ble_evt);
+
+/**@brief Function for reporting a loss on a link, for example a missing acknowledgment of the
+ *        application protocol.
+ *
+ * @param[in] conn_handle Connection handle.
+ */
+void ble_link_adapt_loss_report(uint16_t conn_handle);
+
+/**@brief Function for getting the statistics.
+ *
+ * @param[out] p_stats Statistics.
+ */
+void ble_link_adapt_stats_get(ble_link_adapt_stats_t * p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLE_LINK_ADAPT_H__
+
+/** @} */
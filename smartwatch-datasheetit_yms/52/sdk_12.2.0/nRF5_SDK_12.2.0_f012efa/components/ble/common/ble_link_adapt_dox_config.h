@@ -0,0 +1,64 @@
+/**
+ *
+ * @defgroup ble_link_adapt_config ble_link_adapt module configuration
+ * @{
+ * @ingroup ble_link_adapt
+ */
+/** @brief Enabling ble_link_adapt module
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_LINK_ADAPT_ENABLED
+
+/** @brief Number of links adapted at the same time.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_LINK_ADAPT_CONFIG_MAX_LINKS
+
+/** @brief Lowest acceptable RSSI of our packets at the peer, in dBm, margin included.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_LINK_ADAPT_CONFIG_TARGET_RSSI
+
+/** @brief TX power assumed for the peer, in dBm.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_LINK_ADAPT_CONFIG_PEER_TX_DBM
+
+/** @brief Margin above the next lower TX power needed to step down, in dB.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_LINK_ADAPT_CONFIG_HYST_DB
+
+/** @brief Number of RSSI samples in a row with enough margin before stepping down.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_LINK_ADAPT_CONFIG_DOWN_SAMPLES
+
+/** @brief Number of RSSI samples the highest TX power is kept after a loss.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_LINK_ADAPT_CONFIG_LOSS_HOLD_SAMPLES
+
+/** @brief Number of RSSI samples the SoftDevice skips between reports.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_LINK_ADAPT_CONFIG_RSSI_SKIP
+
+/** @brief Supply voltage used for the energy statistics, in millivolts.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_LINK_ADAPT_CONFIG_VDD_MV
+
+
+/** @} */
@@ -0,0 +1,282 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(BLE_RADIO_GAP)
+#include "ble_radio_gap.h"
+#include "nrf_nvic.h"
+#include "app_timer.h"
+#include "app_util_platform.h"
+
+#define GAP_UNLIMITED UINT32_MAX /**< Gap left when the radio is not used. */
+
+static ble_radio_gap_job_t       * mp_head = NULL;    /**< List of registered jobs. */
+static ble_radio_gap_evt_handler_t m_evt_handler;
+static uint32_t                    m_prescaler;
+static uint32_t                    m_margin_ticks;
+static bool                        m_radio_active;    /**< The last notification was for the start of a radio event. */
+static bool                        m_active_seen;     /**< A radio event has started since initialization. */
+static uint32_t                    m_last_active;     /**< RTC1 counter at the last notification of a radio event start. */
+static uint32_t                    m_period;          /**< Ticks between the last two radio event starts, 0 if unknown. */
+static bool                        m_timer_running;
+
+APP_TIMER_DEF(m_idle_timer);
+
+
+static uint32_t us_to_ticks(uint32_t us)
+{
+    uint64_t divisor = (uint64_t)(m_prescaler + 1) * 1000000;
+
+    // Rounded up: a job must not be assumed shorter than it is.
+    return (uint32_t)(((uint64_t)us * APP_TIMER_CLOCK_FREQ + divisor - 1) / divisor);
+}
+
+
+/**@brief Function for predicting the time left before the next radio event. */
+static uint32_t gap_left(uint32_t now)
+{
+    uint32_t elapsed;
+
+    if (m_radio_active)
+    {
+        return 0;
+    }
+    if (!m_active_seen || (m_period == 0))
+    {
+        return GAP_UNLIMITED;
+    }
+
+    (void)app_timer_cnt_diff_compute(now, m_last_active, &elapsed);
+
+    if (elapsed >= 2 * m_period)
+    {
+        // Radio events have been missing, so the radio has stopped.
+        return GAP_UNLIMITED;
+    }
+    if (elapsed + m_margin_ticks >= m_period)
+    {
+        return 0;
+    }
+    return m_period - elapsed - m_margin_ticks;
+}
+
+
+static bool job_take(ble_radio_gap_job_t * p_job)
+{
+    bool taken = false;
+
+    CRITICAL_REGION_ENTER();
+    if (p_job->pending)
+    {
+        p_job->pending = false;
+        taken          = true;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return taken;
+}
+
+
+/**@brief Function for running the pending jobs that fit in a gap.
+ *
+ * @param[in] gap        Predicted ticks before the next radio event.
+ * @param[in] radio_gap  The gap follows a radio event, so jobs that do not fit are counted as skipped.
+ *
+ * @return True if jobs are still pending.
+ */
+static bool jobs_run(uint32_t gap, bool radio_gap)
+{
+    bool pending = false;
+
+    for (ble_radio_gap_job_t * p_job = mp_head; p_job != NULL; p_job = p_job->p_next)
+    {
+        if (!p_job->pending)
+        {
+            continue;
+        }
+
+        if ((p_job->duration_ticks <= gap) ||
+            (radio_gap && (p_job->skipped >= BLE_RADIO_GAP_CONFIG_MAX_SKIPS)))
+        {
+            if (job_take(p_job))
+            {
+                // Jobs run one after the other, so the next one has less time.
+                if (gap != GAP_UNLIMITED)
+                {
+                    gap -= MIN(gap, p_job->duration_ticks);
+                }
+                p_job->handler(p_job->p_context);
+            }
+        }
+        else
+        {
+            if (radio_gap)
+            {
+                p_job->skipped++;
+            }
+            pending = true;
+        }
+    }
+
+    return pending;
+}
+
+
+static void idle_timer_start(void)
+{
+    bool start = false;
+
+    CRITICAL_REGION_ENTER();
+    if (!m_timer_running)
+    {
+        m_timer_running = true;
+        start           = true;
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (start)
+    {
+        uint32_t err_code = app_timer_start(m_idle_timer,
+                                            APP_TIMER_TICKS(BLE_RADIO_GAP_CONFIG_IDLE_CHECK_MS,
+                                                            m_prescaler),
+                                            NULL);
+        APP_ERROR_CHECK(err_code);
+    }
+}
+
+
+static void idle_timeout_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    m_timer_running = false;
+
+    if (jobs_run(gap_left(app_timer_cnt_get()), false))
+    {
+        idle_timer_start();
+    }
+}
+
+
+void RADIO_NOTIFICATION_IRQHandler(void)
+{
+    uint32_t now = app_timer_cnt_get();
+
+    // The notifications for the start and the end of radio events alternate.
+    m_radio_active = !m_radio_active;
+
+    if (m_evt_handler != NULL)
+    {
+        m_evt_handler(m_radio_active);
+    }
+
+    if (m_radio_active)
+    {
+        if (m_active_seen)
+        {
+            (void)app_timer_cnt_diff_compute(now, m_last_active, &m_period);
+        }
+        m_last_active = now;
+        m_active_seen = true;
+    }
+    else
+    {
+        (void)jobs_run(gap_left(now), true);
+    }
+}
+
+
+ret_code_t ble_radio_gap_init(uint8_t                     irq_priority,
+                              uint32_t                    prescaler,
+                              ble_radio_gap_evt_handler_t evt_handler)
+{
+    ret_code_t err_code;
+
+    m_evt_handler   = evt_handler;
+    m_prescaler     = prescaler;
+    m_margin_ticks  = us_to_ticks(BLE_RADIO_GAP_CONFIG_MARGIN_US);
+    m_radio_active  = false;
+    m_active_seen   = false;
+    m_period        = 0;
+    m_timer_running = false;
+
+    err_code = app_timer_create(&m_idle_timer, APP_TIMER_MODE_SINGLE_SHOT, idle_timeout_handler);
+    VERIFY_SUCCESS(err_code);
+
+    err_code = sd_nvic_ClearPendingIRQ(RADIO_NOTIFICATION_IRQn);
+    VERIFY_SUCCESS(err_code);
+
+    err_code = sd_nvic_SetPriority(RADIO_NOTIFICATION_IRQn, irq_priority);
+    VERIFY_SUCCESS(err_code);
+
+    err_code = sd_nvic_EnableIRQ(RADIO_NOTIFICATION_IRQn);
+    VERIFY_SUCCESS(err_code);
+
+    return sd_radio_notification_cfg_set(NRF_RADIO_NOTIFICATION_TYPE_INT_ON_BOTH,
+                                         BLE_RADIO_GAP_CONFIG_DISTANCE);
+}
+
+
+ret_code_t ble_radio_gap_job_init(ble_radio_gap_job_t       * p_job,
+                                  ble_radio_gap_job_handler_t handler,
+                                  void                      * p_context,
+                                  uint32_t                    duration_us)
+{
+    VERIFY_PARAM_NOT_NULL(p_job);
+    VERIFY_PARAM_NOT_NULL(handler);
+
+    p_job->handler        = handler;
+    p_job->p_context      = p_context;
+    p_job->duration_ticks = us_to_ticks(duration_us);
+    p_job->pending        = false;
+    p_job->skipped        = 0;
+
+    CRITICAL_REGION_ENTER();
+    p_job->p_next = mp_head;
+    mp_head       = p_job;
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+
+
+void ble_radio_gap_schedule(ble_radio_gap_job_t * p_job)
+{
+    bool scheduled = false;
+
+    CRITICAL_REGION_ENTER();
+    if (!p_job->pending)
+    {
+        p_job->skipped = 0;
+        p_job->pending = true;
+        scheduled      = true;
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (!scheduled)
+    {
+        return;
+    }
+
+    if (p_job->duration_ticks <= gap_left(app_timer_cnt_get()))
+    {
+        if (job_take(p_job))
+        {
+            p_job->handler(p_job->p_context);
+        }
+    }
+    else
+    {
+        idle_timer_start();
+    }
+}
+
+#endif // NRF_MODULE_ENABLED(BLE_RADIO_GAP)
@@ -0,0 +1,151 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ble_radio_gap Radio gap scheduling
+ * @{
+ * @ingroup ble_sdk_lib
+ *
+ * @brief Module for running application jobs between radio events.
+ *
+ * @details Jobs that draw a high current or need a quiet supply, like a display refresh over SPI,
+ *          sensor polling over TWI, or SAADC sampling, are registered with the time they need.
+ *          A scheduled job is run at the end of a radio event, if the time until the next radio
+ *          event is long enough for it. The time is predicted from the interval between the last
+ *          two radio events. A job that did not fit in @ref BLE_RADIO_GAP_CONFIG_MAX_SKIPS gaps
+ *          is run in the next one anyway. If the radio is not used, jobs are run right away.
+ *
+ *          The timing comes from the radio notification of the SoftDevice, configured for both
+ *          the start and the end of radio events. The radio event handler passed to
+ *          @ref ble_radio_gap_init gets every notification, so that other users, like
+ *          @ref ble_hvx_coalesce_on_radio_evt, can share the interrupt.
+ *
+ * @note The module uses the radio notification interrupt (@ref RADIO_NOTIFICATION_IRQHandler)
+ *       and the app_timer module.
+ */
+
+#ifndef BLE_RADIO_GAP_H__
+#define BLE_RADIO_GAP_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nrf_soc.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Distance between the radio notification and the start of a radio event.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_RADIO_GAP_CONFIG_DISTANCE
+#define BLE_RADIO_GAP_CONFIG_DISTANCE NRF_RADIO_NOTIFICATION_DISTANCE_800US
+#endif
+
+/** @brief Time kept free before the predicted start of the next radio event, in microseconds.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_RADIO_GAP_CONFIG_MARGIN_US
+#define BLE_RADIO_GAP_CONFIG_MARGIN_US 500
+#endif
+
+/** @brief Number of gaps a job can be skipped because it does not fit, before it is run anyway.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_RADIO_GAP_CONFIG_MAX_SKIPS
+#define BLE_RADIO_GAP_CONFIG_MAX_SKIPS 8
+#endif
+
+/** @brief Interval of checks for pending jobs when the radio stops, in milliseconds.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_RADIO_GAP_CONFIG_IDLE_CHECK_MS
+#define BLE_RADIO_GAP_CONFIG_IDLE_CHECK_MS 1000
+#endif
+
+/**@brief Radio event handler type.
+ *
+ * @param[in] radio_active True shortly before a radio event, false at its end.
+ */
+typedef void (* ble_radio_gap_evt_handler_t)(bool radio_active);
+
+/**@brief Job handler type. The handler does the work of the job, or starts it.
+ *
+ * @param[in] p_context Context passed to @ref ble_radio_gap_job_init.
+ */
+typedef void (* ble_radio_gap_job_handler_t)(void * p_context);
+
+/**@brief Job. Its content must not be accessed by the application. */
+typedef struct ble_radio_gap_job_s
+{
+    ble_radio_gap_job_handler_t  handler;        /**< Job handler. */
+    void                       * p_context;      /**< Context of the job handler. */
+    uint32_t                     duration_ticks; /**< Time needed by the job, in RTC1 ticks. */
+    volatile bool                pending;        /**< The job has been scheduled. */
+    uint8_t                      skipped;        /**< Number of gaps the job did not fit in. */
+    struct ble_radio_gap_job_s * p_next;         /**< Next registered job. */
+} ble_radio_gap_job_t;
+
+/**@brief Function for initializing the module.
+ *
+ * @details The radio notification is enabled for the start and the end of radio events, with the
+ *          distance @ref BLE_RADIO_GAP_CONFIG_DISTANCE. The SoftDevice must be enabled, and the
+ *          app_timer module initialized, first.
+ *
+ * @param[in] irq_priority Priority of the radio notification interrupt, in which jobs are run.
+ *                         Must be an application priority.
+ * @param[in] prescaler    Prescaler of the app_timer module.
+ * @param[in] evt_handler  Handler of radio events, or NULL.
+ *
+ * @return NRF_SUCCESS or an error from the SoftDevice or app_timer.
+ */
+ret_code_t ble_radio_gap_init(uint8_t irq_priority, uint32_t prescaler, ble_radio_gap_evt_handler_t evt_handler);
+
+/**@brief Function for registering a job.
+ *
+ * @param[out] p_job       Job to register. Must stay valid while the module is running.
+ * @param[in]  handler     Job handler.
+ * @param[in]  p_context   Context passed to the job handler.
+ * @param[in]  duration_us Time needed by the job before the next radio event, in microseconds.
+ *
+ * @retval NRF_SUCCESS    If the job was registered.
+ * @retval NRF_ERROR_NULL If a NULL pointer was passed.
+ */
+ret_code_t ble_radio_gap_job_init(ble_radio_gap_job_t       * p_job,
+                                  ble_radio_gap_job_handler_t handler,
+                                  void                      * p_context,
+                                  uint32_t                    duration_us);
+
+/**@brief Function for scheduling a job in the next gap between radio events.
+ *
+ * @details If the radio is idle and the job fits before the next radio event, or the radio is not
+ *          used, the job handler is called from this function. Otherwise it is called from the
+ *          radio notification interrupt, or from the app_timer interrupt if the radio stops.
+ *          Scheduling a job again before it has run has no effect.
+ *
+ * @param[in] p_job Registered job.
+ */
+void ble_radio_gap_schedule(ble_radio_gap_job_t * p_job);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLE_RADIO_GAP_H__
+
+/** @} */
@@ -0,0 +1,50 @@
+/**
+ *
+ * @defgroup ble_radio_gap_config Radio gap scheduling configuration
+ * @{
+ * @ingroup ble_radio_gap
+ */
+/** @brief Enable radio gap scheduling.
+ *
+ *  Requires app_timer.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_RADIO_GAP_ENABLED
+
+/** @brief Distance between the radio notification and the start of a radio event.
+ *
+ *  The following values are supported:
+ *  - NRF_RADIO_NOTIFICATION_DISTANCE_800US
+ *  - NRF_RADIO_NOTIFICATION_DISTANCE_1740US
+ *  - NRF_RADIO_NOTIFICATION_DISTANCE_2680US
+ *  - NRF_RADIO_NOTIFICATION_DISTANCE_3620US
+ *  - NRF_RADIO_NOTIFICATION_DISTANCE_4560US
+ *  - NRF_RADIO_NOTIFICATION_DISTANCE_5500US
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_RADIO_GAP_CONFIG_DISTANCE
+
+/** @brief Time kept free before the predicted start of the next radio event, in microseconds.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_RADIO_GAP_CONFIG_MARGIN_US
+
+/** @brief Number of gaps a job can be skipped before it is run anyway.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_RADIO_GAP_CONFIG_MAX_SKIPS
+
+/** @brief Interval of checks for pending jobs when the radio stops, in milliseconds.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_RADIO_GAP_CONFIG_IDLE_CHECK_MS
+
+
+/** @} */
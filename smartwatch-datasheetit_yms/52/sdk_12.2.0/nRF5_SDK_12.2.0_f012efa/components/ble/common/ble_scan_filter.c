@@ -0,0 +1,369 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "ble_scan_filter.h"
+#include <string.h>
+#include "sdk_common.h"
+#include "app_util.h"
+
+STATIC_ASSERT((BLE_SCAN_FILTER_ADDR_HASH_SIZE & (BLE_SCAN_FILTER_ADDR_HASH_SIZE - 1)) == 0);
+STATIC_ASSERT(BLE_SCAN_FILTER_ADDR_HASH_SIZE > BLE_SCAN_FILTER_ADDR_COUNT);
+
+#define DATA_FILTERS (BLE_SCAN_FILTER_MATCH_UUID | BLE_SCAN_FILTER_MATCH_NAME | BLE_SCAN_FILTER_MATCH_MANUF) /**< Filters that look at the advertising data. */
+
+
+/**@brief Function for getting the bucket of an address in the hash set. */
+static uint32_t addr_bucket_get(ble_gap_addr_t const * p_addr)
+{
+    uint32_t hash = p_addr->addr_type;
+
+    for (uint32_t i = 0; i < BLE_GAP_ADDR_LEN; i++)
+    {
+        hash = (hash * 31) + p_addr->addr[i];
+    }
+    return hash & (BLE_SCAN_FILTER_ADDR_HASH_SIZE - 1);
+}
+
+
+/**@brief Function for comparing two addresses. */
+static bool addr_equal(ble_gap_addr_t const * p_a, ble_gap_addr_t const * p_b)
+{
+    return (p_a->addr_type == p_b->addr_type)
+           && (memcmp(p_a->addr, p_b->addr, BLE_GAP_ADDR_LEN) == 0);
+}
+
+
+/**@brief Function for finding an address in the hash set. Linear probing. */
+static bool addr_find(ble_scan_filter_t const * p_filter, ble_gap_addr_t const * p_addr)
+{
+    uint32_t bucket = addr_bucket_get(p_addr);
+
+    while (p_filter->addr_hash[bucket] != 0)
+    {
+        if (addr_equal(&p_filter->addrs[p_filter->addr_hash[bucket] - 1], p_addr))
+        {
+            return true;
+        }
+        bucket = (bucket + 1) & (BLE_SCAN_FILTER_ADDR_HASH_SIZE - 1);
+    }
+    return false;
+}
+
+
+/**@brief Function for adding an address to the hash set.
+ *
+ * @param[in] p_filter Filter.
+ * @param[in] p_addr   Address, not in the set yet.
+ * @param[in] index    Free entry of the address array.
+ */
+static void addr_add(ble_scan_filter_t * p_filter, ble_gap_addr_t const * p_addr, uint8_t index)
+{
+    uint32_t bucket = addr_bucket_get(p_addr);
+
+    // There are more buckets than addresses, so a free one is always found.
+    while (p_filter->addr_hash[bucket] != 0)
+    {
+        bucket = (bucket + 1) & (BLE_SCAN_FILTER_ADDR_HASH_SIZE - 1);
+    }
+
+    p_filter->addrs[index]      = *p_addr;
+    p_filter->addr_hash[bucket] = index + 1;
+}
+
+
+ret_code_t ble_scan_filter_init(ble_scan_filter_t * p_filter, ble_scan_filter_config_t const * p_config)
+{
+    VERIFY_PARAM_NOT_NULL(p_filter);
+    VERIFY_PARAM_NOT_NULL(p_config);
+
+    if ((p_config->uuid_count > BLE_SCAN_FILTER_UUID_COUNT) ||
+        (p_config->addr_count > BLE_SCAN_FILTER_ADDR_COUNT))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (((p_config->uuid_count != 0) && (p_config->p_uuids == NULL)) ||
+        ((p_config->addr_count != 0) && (p_config->p_addrs == NULL)))
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    memset(p_filter, 0, sizeof(ble_scan_filter_t));
+    p_filter->mode     = p_config->mode;
+    p_filter->rssi_min = p_config->rssi_min;
+
+    if (p_config->uuid_count != 0)
+    {
+        memcpy(p_filter->uuids, p_config->p_uuids, p_config->uuid_count * sizeof(uint16_t));
+        p_filter->uuid_count = p_config->uuid_count;
+        p_filter->enabled   |= BLE_SCAN_FILTER_MATCH_UUID;
+    }
+
+    if ((p_config->p_name_prefix != NULL) && (p_config->p_name_prefix[0] != '\0'))
+    {
+        size_t len = strlen(p_config->p_name_prefix);
+
+        // The name and its AD structure header must fit in the advertising data.
+        if (len > (BLE_GAP_ADV_MAX_SIZE - 2))
+        {
+            return NRF_ERROR_INVALID_PARAM;
+        }
+        p_filter->p_name_prefix   = p_config->p_name_prefix;
+        p_filter->name_prefix_len = (uint8_t)len;
+        p_filter->enabled        |= BLE_SCAN_FILTER_MATCH_NAME;
+    }
+
+    if (p_config->addr_count != 0)
+    {
+        uint8_t count = 0;
+
+        for (uint32_t i = 0; i < p_config->addr_count; i++)
+        {
+            if (!addr_find(p_filter, &p_config->p_addrs[i]))
+            {
+                addr_add(p_filter, &p_config->p_addrs[i], count++);
+            }
+        }
+        p_filter->enabled |= BLE_SCAN_FILTER_MATCH_ADDR;
+    }
+
+    if (p_config->company_id_enabled)
+    {
+        p_filter->company_id = p_config->company_id;
+        p_filter->enabled   |= BLE_SCAN_FILTER_MATCH_MANUF;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for finding one of the UUIDs of the filter in a list of 16-bit UUIDs. */
+static bool uuid_find(ble_scan_filter_t const * p_filter, uint8_t const * p_data, uint8_t len)
+{
+    for (uint32_t i = 0; (i + sizeof(uint16_t)) <= len; i += sizeof(uint16_t))
+    {
+        uint16_t uuid = uint16_decode(&p_data[i]);
+
+        for (uint32_t j = 0; j < p_filter->uuid_count; j++)
+        {
+            if (uuid == p_filter->uuids[j])
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+
+/**@brief Function for checking the data filters, in one pass over the AD structures.
+ *
+ * @return The data filters that matched.
+ */
+static uint8_t data_match(ble_scan_filter_t const * p_filter, uint8_t const * p_data, uint8_t len)
+{
+    uint8_t  wanted  = p_filter->enabled & DATA_FILTERS;
+    uint8_t  matched = 0;
+    uint32_t index   = 0;
+
+    while ((index + 1) < len)
+    {
+        uint8_t         field_len = p_data[index];
+        uint8_t const * p_field   = &p_data[index + 2];
+        uint8_t         data_len  = field_len - 1;
+
+        // A length of 0 ends the data early, and a field can not run past the end.
+        if ((field_len == 0) || ((index + 1 + field_len) > len))
+        {
+            break;
+        }
+
+        switch (p_data[index + 1])
+        {
+            case BLE_GAP_AD_TYPE_16BIT_SERVICE_UUID_MORE_AVAILABLE:
+            case BLE_GAP_AD_TYPE_16BIT_SERVICE_UUID_COMPLETE:
+                if ((wanted & BLE_SCAN_FILTER_MATCH_UUID) && uuid_find(p_filter, p_field, data_len))
+                {
+                    matched |= BLE_SCAN_FILTER_MATCH_UUID;
+                }
+                break;
+
+            case BLE_GAP_AD_TYPE_SHORT_LOCAL_NAME:
+            case BLE_GAP_AD_TYPE_COMPLETE_LOCAL_NAME:
+                if ((wanted & BLE_SCAN_FILTER_MATCH_NAME) &&
+                    (data_len >= p_filter->name_prefix_len) &&
+                    (memcmp(p_field, p_filter->p_name_prefix, p_filter->name_prefix_len) == 0))
+                {
+                    matched |= BLE_SCAN_FILTER_MATCH_NAME;
+                }
+                break;
+
+            case BLE_GAP_AD_TYPE_MANUFACTURER_SPECIFIC_DATA:
+                if ((wanted & BLE_SCAN_FILTER_MATCH_MANUF) &&
+                    (data_len >= sizeof(uint16_t)) &&
+                    (uint16_decode(p_field) == p_filter->company_id))
+                {
+                    matched |= BLE_SCAN_FILTER_MATCH_MANUF;
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        if (matched == wanted)
+        {
+            break;
+        }
+        index += field_len + 1;
+    }
+
+    return matched;
+}
+
+
+#if (BLE_SCAN_FILTER_CACHE_SIZE > 0)
+/**@brief Function for hashing advertising data (32-bit FNV-1a). */
+static uint32_t data_hash_get(uint8_t const * p_data, uint8_t len)
+{
+    uint32_t hash = 2166136261UL;
+
+    for (uint32_t i = 0; i < len; i++)
+    {
+        hash = (hash ^ p_data[i]) * 16777619UL;
+    }
+    return hash;
+}
+
+
+/**@brief Function for finding the data of a report in the cache. */
+static ble_scan_filter_cache_entry_t const * cache_find(ble_scan_filter_t const        * p_filter,
+                                                        ble_gap_evt_adv_report_t const * p_report,
+                                                        uint32_t                         data_hash)
+{
+    for (uint32_t i = 0; i < p_filter->cache_count; i++)
+    {
+        ble_scan_filter_cache_entry_t const * p_entry = &p_filter->cache[i];
+
+        if ((p_entry->data_hash == data_hash) &&
+            (p_entry->scan_rsp == p_report->scan_rsp) &&
+            addr_equal(&p_entry->peer_addr, &p_report->peer_addr))
+        {
+            return p_entry;
+        }
+    }
+    return NULL;
+}
+
+
+/**@brief Function for adding the result of a report to the cache, replacing the oldest entry. */
+static void cache_add(ble_scan_filter_t              * p_filter,
+                      ble_gap_evt_adv_report_t const * p_report,
+                      uint32_t                         data_hash,
+                      uint8_t                          matched)
+{
+    ble_scan_filter_cache_entry_t * p_entry = &p_filter->cache[p_filter->cache_next];
+
+    p_entry->data_hash = data_hash;
+    p_entry->peer_addr = p_report->peer_addr;
+    p_entry->scan_rsp  = p_report->scan_rsp;
+    p_entry->matched   = matched;
+
+    p_filter->cache_next = (p_filter->cache_next + 1) % BLE_SCAN_FILTER_CACHE_SIZE;
+    if (p_filter->cache_count < BLE_SCAN_FILTER_CACHE_SIZE)
+    {
+        p_filter->cache_count++;
+    }
+}
+#endif // (BLE_SCAN_FILTER_CACHE_SIZE > 0)
+
+
+/**@brief Function for checking the data filters of a report, through the cache. */
+static uint8_t report_data_match(ble_scan_filter_t * p_filter, ble_gap_evt_adv_report_t const * p_report)
+{
+#if (BLE_SCAN_FILTER_CACHE_SIZE > 0)
+    uint32_t                              data_hash = data_hash_get(p_report->data, p_report->dlen);
+    ble_scan_filter_cache_entry_t const * p_entry   = cache_find(p_filter, p_report, data_hash);
+    uint8_t                               matched;
+
+    if (p_entry != NULL)
+    {
+        p_filter->stats.cache_hits++;
+        return p_entry->matched;
+    }
+
+    matched = data_match(p_filter, p_report->data, p_report->dlen);
+    cache_add(p_filter, p_report, data_hash, matched);
+    return matched;
+#else
+    return data_match(p_filter, p_report->data, p_report->dlen);
+#endif
+}
+
+
+uint8_t ble_scan_filter_match(ble_scan_filter_t * p_filter, ble_gap_evt_adv_report_t const * p_report)
+{
+    uint8_t matched = 0;
+
+    p_filter->stats.reports++;
+
+    if (p_report->rssi < p_filter->rssi_min)
+    {
+        p_filter->stats.rssi_rejected++;
+        return 0;
+    }
+
+    // The address is checked first, it is cheaper than the data.
+    if ((p_filter->enabled & BLE_SCAN_FILTER_MATCH_ADDR) && addr_find(p_filter, &p_report->peer_addr))
+    {
+        matched |= BLE_SCAN_FILTER_MATCH_ADDR;
+    }
+
+    if (p_filter->mode == BLE_SCAN_FILTER_MODE_ALL)
+    {
+        if ((p_filter->enabled & BLE_SCAN_FILTER_MATCH_ADDR) && (matched == 0))
+        {
+            return 0;
+        }
+    }
+    else if (matched != 0)
+    {
+        p_filter->stats.matches++;
+        return matched;
+    }
+
+    if (p_filter->enabled & DATA_FILTERS)
+    {
+        matched |= report_data_match(p_filter, p_report);
+    }
+
+    if ((p_filter->mode == BLE_SCAN_FILTER_MODE_ALL) && (matched != p_filter->enabled))
+    {
+        return 0;
+    }
+
+    if (matched != 0)
+    {
+        p_filter->stats.matches++;
+    }
+    return matched;
+}
+
+
+void ble_scan_filter_cache_clear(ble_scan_filter_t * p_filter)
+{
+#if (BLE_SCAN_FILTER_CACHE_SIZE > 0)
+    p_filter->cache_count = 0;
+    p_filter->cache_next  = 0;
+#else
+    UNUSED_PARAMETER(p_filter);
+#endif
+}
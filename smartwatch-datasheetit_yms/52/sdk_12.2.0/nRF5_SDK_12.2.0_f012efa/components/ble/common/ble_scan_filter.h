@@ -0,0 +1,183 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ble_scan_filter Advertising report filter
+ * @{
+ * @ingroup ble_sdk_lib
+ * @brief Module for matching advertising reports against a set of filters.
+ *
+ * @details The filters are compiled by @ref ble_scan_filter_init: the 16-bit service UUIDs,
+ *          a name prefix, the peer addresses, a manufacturer (company) ID and a minimum RSSI.
+ *          @ref ble_scan_filter_match then checks a report in one pass over its AD structures,
+ *          and stops as soon as all the filters that look at the data have matched.
+ *
+ *          The addresses are kept in a hash set, so checking the address of a report does not
+ *          depend on the number of addresses.
+ *
+ *          The result of the data filters is kept in a cache, by peer address and a hash of the
+ *          data. A device that keeps sending the same advertising data is only parsed once,
+ *          until it is pushed out of the cache by @ref BLE_SCAN_FILTER_CACHE_SIZE other reports.
+ *          Advertising data and scan response data are cached separately.
+ */
+
+#ifndef BLE_SCAN_FILTER_H__
+#define BLE_SCAN_FILTER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_gap.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Largest number of 16-bit service UUIDs of a filter.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_SCAN_FILTER_UUID_COUNT
+#define BLE_SCAN_FILTER_UUID_COUNT      4
+#endif
+
+/** @brief Largest number of peer addresses of a filter.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_SCAN_FILTER_ADDR_COUNT
+#define BLE_SCAN_FILTER_ADDR_COUNT      8
+#endif
+
+/** @brief Number of buckets of the address hash set. A power of two, larger than
+ *         @ref BLE_SCAN_FILTER_ADDR_COUNT.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_SCAN_FILTER_ADDR_HASH_SIZE
+#define BLE_SCAN_FILTER_ADDR_HASH_SIZE  16
+#endif
+
+/** @brief Number of devices in the result cache. 0 to disable the cache.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BLE_SCAN_FILTER_CACHE_SIZE
+#define BLE_SCAN_FILTER_CACHE_SIZE      8
+#endif
+
+#define BLE_SCAN_FILTER_RSSI_ANY        INT8_MIN /**< Value of @ref ble_scan_filter_config_t::rssi_min to accept all reports. */
+
+/**@defgroup BLE_SCAN_FILTER_MATCHES Filters
+ * @{ */
+#define BLE_SCAN_FILTER_MATCH_UUID      (1 << 0) /**< A 16-bit service UUID. */
+#define BLE_SCAN_FILTER_MATCH_NAME      (1 << 1) /**< The name prefix, in the complete or the short local name. */
+#define BLE_SCAN_FILTER_MATCH_ADDR      (1 << 2) /**< A peer address. */
+#define BLE_SCAN_FILTER_MATCH_MANUF     (1 << 3) /**< The company ID of the manufacturer specific data. */
+/** @} */
+
+/**@brief How the filters are combined. */
+typedef enum
+{
+    BLE_SCAN_FILTER_MODE_ANY, /**< A report matches if one of the enabled filters does. */
+    BLE_SCAN_FILTER_MODE_ALL, /**< A report matches if all the enabled filters do. The data of one report is checked, a name in the scan response does not combine with a UUID in the advertising data. */
+} ble_scan_filter_mode_t;
+
+/**@brief Filter configuration. A filter with no value is disabled. */
+typedef struct
+{
+    ble_scan_filter_mode_t mode;               /**< How the filters are combined. */
+    uint16_t const       * p_uuids;            /**< 16-bit service UUIDs. */
+    uint8_t                uuid_count;         /**< Number of UUIDs, at most @ref BLE_SCAN_FILTER_UUID_COUNT. */
+    char const           * p_name_prefix;      /**< Name prefix, NULL or empty to disable. Must stay valid. */
+    ble_gap_addr_t const * p_addrs;            /**< Peer addresses. */
+    uint8_t                addr_count;         /**< Number of addresses, at most @ref BLE_SCAN_FILTER_ADDR_COUNT. */
+    bool                   company_id_enabled; /**< Filter by company ID. */
+    uint16_t               company_id;         /**< Company ID of the manufacturer specific data. */
+    int8_t                 rssi_min;           /**< Reports with a lower RSSI are ignored, before any other filter. */
+} ble_scan_filter_config_t;
+
+/**@brief Filter statistics. */
+typedef struct
+{
+    uint32_t reports;       /**< Reports checked. */
+    uint32_t rssi_rejected; /**< Reports ignored because of their RSSI. */
+    uint32_t cache_hits;    /**< Reports whose data was not parsed because it was in the cache. */
+    uint32_t matches;       /**< Reports that matched. */
+} ble_scan_filter_stats_t;
+
+/**@brief Result cache entry. */
+typedef struct
+{
+    uint32_t       data_hash; /**< Hash of the data. */
+    ble_gap_addr_t peer_addr; /**< Address of the device. */
+    uint8_t        scan_rsp;  /**< 1 for scan response data. */
+    uint8_t        matched;   /**< Data filters that matched. */
+} ble_scan_filter_cache_entry_t;
+
+/**@brief Compiled filter. Its content must not be accessed by the application, except stats. */
+typedef struct
+{
+    uint8_t                       enabled;                                   /**< Enabled filters, see @ref BLE_SCAN_FILTER_MATCHES. */
+    ble_scan_filter_mode_t        mode;                                      /**< How the filters are combined. */
+    int8_t                        rssi_min;                                  /**< Minimum RSSI. */
+    uint8_t                       uuid_count;                                /**< Number of UUIDs. */
+    uint16_t                      uuids[BLE_SCAN_FILTER_UUID_COUNT];         /**< 16-bit service UUIDs. */
+    char const                  * p_name_prefix;                             /**< Name prefix. */
+    uint8_t                       name_prefix_len;                           /**< Length of the name prefix. */
+    uint16_t                      company_id;                                /**< Company ID. */
+    ble_gap_addr_t                addrs[BLE_SCAN_FILTER_ADDR_COUNT];         /**< Peer addresses. */
+    uint8_t                       addr_hash[BLE_SCAN_FILTER_ADDR_HASH_SIZE]; /**< Index + 1 in addrs of each bucket, 0 for empty. */
+#if (BLE_SCAN_FILTER_CACHE_SIZE > 0)
+    ble_scan_filter_cache_entry_t cache[BLE_SCAN_FILTER_CACHE_SIZE];         /**< Result cache. */
+    uint8_t                       cache_count;                               /**< Entries in use. */
+    uint8_t                       cache_next;                                /**< Entry to replace next. */
+#endif
+    ble_scan_filter_stats_t       stats;                                     /**< Statistics. */
+} ble_scan_filter_t;
+
+
+/**@brief Function for compiling a filter.
+ *
+ * @param[out] p_filter Filter.
+ * @param[in]  p_config Configuration. Only the name prefix is used after the call.
+ *
+ * @retval NRF_SUCCESS             If the filter was compiled.
+ * @retval NRF_ERROR_NULL          If a NULL pointer was passed, or a count was set without its array.
+ * @retval NRF_ERROR_INVALID_PARAM If there were too many UUIDs or addresses, or the name prefix
+ *                                 was longer than an advertising packet.
+ */
+ret_code_t ble_scan_filter_init(ble_scan_filter_t * p_filter, ble_scan_filter_config_t const * p_config);
+
+
+/**@brief Function for matching an advertising report.
+ *
+ * @param[in] p_filter Filter.
+ * @param[in] p_report Report of a @ref BLE_GAP_EVT_ADV_REPORT event.
+ *
+ * @return The filters that matched, see @ref BLE_SCAN_FILTER_MATCHES. 0 if the report does not
+ *         match.
+ */
+uint8_t ble_scan_filter_match(ble_scan_filter_t * p_filter, ble_gap_evt_adv_report_t const * p_report);
+
+
+/**@brief Function for emptying the result cache. The statistics are kept. */
+void ble_scan_filter_cache_clear(ble_scan_filter_t * p_filter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLE_SCAN_FILTER_H__
+
+/** @} */
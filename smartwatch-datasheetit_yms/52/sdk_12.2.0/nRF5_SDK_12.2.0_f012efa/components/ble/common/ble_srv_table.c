@@ -0,0 +1,261 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(BLE_SRV_TABLE)
+#include "ble_srv_table.h"
+#include "ble_gatts.h"
+#include <string.h>
+
+NRF_SECTION_VARS_CREATE_SECTION(ble_srv_table, ble_srv_table_entry_t const);
+
+// Helper macros for section variables.
+#define SRV_TABLE_SECTION_VARS_GET(i)   NRF_SECTION_VARS_GET((i),                              \
+                                                             ble_srv_table_entry_t const,      \
+                                                             ble_srv_table)
+#define SRV_TABLE_SECTION_VARS_COUNT    NRF_SECTION_VARS_COUNT(ble_srv_table_entry_t const,    \
+                                                               ble_srv_table)
+
+static bool m_built; /**< The table has been added to the GATT database. */
+
+
+/**@brief Function for finding the first handle that is not in the GATT database.
+ *
+ * @details The SoftDevice gives handles in increasing order.
+ */
+static uint16_t free_handle_find(uint16_t handle)
+{
+    ble_uuid_t uuid;
+
+    while (sd_ble_gatts_attr_get(handle, &uuid, NULL) == NRF_SUCCESS)
+    {
+        handle++;
+    }
+    return handle;
+}
+
+
+/**@brief Function for adding a declarative service.
+ */
+static ret_code_t decl_add(ble_srv_table_decl_t const * p_decl)
+{
+    ble_uuid_t uuid;
+    uint16_t   srv_handle;
+    ret_code_t err_code;
+
+    uuid.uuid = p_decl->uuid;
+    uuid.type = BLE_UUID_TYPE_BLE;
+
+    if (p_decl->p_uuid_base != NULL)
+    {
+        err_code = sd_ble_uuid_vs_add(p_decl->p_uuid_base, &uuid.type);
+        VERIFY_SUCCESS(err_code);
+    }
+
+    err_code = sd_ble_gatts_service_add(BLE_GATTS_SRVC_TYPE_PRIMARY, &uuid, &srv_handle);
+    VERIFY_SUCCESS(err_code);
+
+    if (p_decl->p_srv_handle != NULL)
+    {
+        *p_decl->p_srv_handle = srv_handle;
+    }
+
+    for (uint32_t i = 0; i < p_decl->char_count; i++)
+    {
+        // characteristic_add() takes a non-const pointer, and the UUID type may be replaced.
+        ble_add_char_params_t params = p_decl->p_chars[i];
+
+        if (params.uuid_type == BLE_SRV_TABLE_UUID_TYPE_SERVICE)
+        {
+            params.uuid_type = uuid.type;
+        }
+
+        err_code = characteristic_add(srv_handle, &params, &p_decl->p_char_handles[i]);
+        VERIFY_SUCCESS(err_code);
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ble_srv_table_build(ble_srv_table_stats_t * p_stats)
+{
+    ble_srv_table_stats_t stats;
+    ret_code_t            err_code;
+    uint16_t              handle;
+
+    if (m_built)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    err_code = sd_ble_gatts_initial_user_handle_get(&handle);
+    VERIFY_SUCCESS(err_code);
+
+    memset(&stats, 0, sizeof(stats));
+    handle             = free_handle_find(handle);
+    stats.first_handle = handle;
+    stats.entry_count  = SRV_TABLE_SECTION_VARS_COUNT;
+
+    for (uint32_t i = 0; i < stats.entry_count; i++)
+    {
+        ble_srv_table_entry_t const * p_entry = SRV_TABLE_SECTION_VARS_GET(i);
+
+        if (p_entry->p_decl != NULL)
+        {
+            err_code = decl_add(p_entry->p_decl);
+        }
+        else if (p_entry->init != NULL)
+        {
+            err_code = p_entry->init(p_entry->p_context);
+        }
+        else
+        {
+            err_code = NRF_ERROR_NULL;
+        }
+
+        // An entry that added nothing has an empty range, which no handle falls into.
+        p_entry->p_range->start_handle = handle;
+        handle                         = free_handle_find(handle);
+        p_entry->p_range->end_handle   = handle - 1;
+
+        if (err_code != NRF_SUCCESS)
+        {
+            stats.failed_entry = i;
+            break;
+        }
+    }
+
+    stats.last_handle = handle - 1;
+    stats.attr_count  = handle - stats.first_handle;
+
+    if (p_stats != NULL)
+    {
+        *p_stats = stats;
+    }
+
+    m_built = (err_code == NRF_SUCCESS);
+    return err_code;
+}
+
+
+ble_srv_table_entry_t const * ble_srv_table_find(uint16_t handle)
+{
+    uint32_t lo = 0;
+    uint32_t hi = m_built ? SRV_TABLE_SECTION_VARS_COUNT : 0;
+
+    // The ranges follow each other in the order of the entries.
+    while (lo < hi)
+    {
+        uint32_t                      mid     = (lo + hi) / 2;
+        ble_srv_table_entry_t const * p_entry = SRV_TABLE_SECTION_VARS_GET(mid);
+
+        if (handle < p_entry->p_range->start_handle)
+        {
+            hi = mid;
+        }
+        else if (handle > p_entry->p_range->end_handle)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            return p_entry;
+        }
+    }
+    return NULL;
+}
+
+
+/**@brief Function for getting the attribute handle of an event.
+ *
+ * @return Handle, or BLE_GATT_HANDLE_INVALID if the event is not about one attribute.
+ */
+static uint16_t evt_handle_get(ble_evt_t const * p_ble_evt)
+{
+    ble_gatts_evt_t const * p_gatts_evt = &p_ble_evt->evt.gatts_evt;
+
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GATTS_EVT_WRITE:
+            return p_gatts_evt->params.write.handle;
+
+        case BLE_GATTS_EVT_RW_AUTHORIZE_REQUEST:
+            if (p_gatts_evt->params.authorize_request.type == BLE_GATTS_AUTHORIZE_TYPE_READ)
+            {
+                return p_gatts_evt->params.authorize_request.request.read.handle;
+            }
+            // The handle of an execute write request is 0.
+            return p_gatts_evt->params.authorize_request.request.write.handle;
+
+        case BLE_GATTS_EVT_HVC:
+            return p_gatts_evt->params.hvc.handle;
+
+        default:
+            return BLE_GATT_HANDLE_INVALID;
+    }
+}
+
+
+/**@brief Function for getting the event mask bit of an event which is not about an attribute.
+ */
+static uint32_t evt_mask_get(uint16_t evt_id)
+{
+    if ((evt_id >= BLE_GAP_EVT_BASE) && (evt_id <= BLE_GAP_EVT_LAST))
+    {
+        return BLE_SRV_TABLE_EVT_GAP;
+    }
+    if (evt_id == BLE_EVT_TX_COMPLETE)
+    {
+        return BLE_SRV_TABLE_EVT_TX_COMPLETE;
+    }
+    if ((evt_id >= BLE_GATTS_EVT_BASE) && (evt_id <= BLE_GATTS_EVT_LAST))
+    {
+        return BLE_SRV_TABLE_EVT_GATTS;
+    }
+    return BLE_SRV_TABLE_EVT_OTHER;
+}
+
+
+void ble_srv_table_on_ble_evt(ble_evt_t * p_ble_evt)
+{
+    uint16_t handle = evt_handle_get(p_ble_evt);
+    uint32_t mask;
+
+    if (handle != BLE_GATT_HANDLE_INVALID)
+    {
+        ble_srv_table_entry_t const * p_entry = ble_srv_table_find(handle);
+
+        if (p_entry != NULL)
+        {
+            if (p_entry->evt_handler != NULL)
+            {
+                p_entry->evt_handler(p_entry->p_context, p_ble_evt);
+            }
+            return;
+        }
+    }
+
+    // Not about an attribute of the table, for example the device name of the GAP service.
+    mask = evt_mask_get(p_ble_evt->header.evt_id);
+
+    for (uint32_t i = 0; i < SRV_TABLE_SECTION_VARS_COUNT; i++)
+    {
+        ble_srv_table_entry_t const * p_entry = SRV_TABLE_SECTION_VARS_GET(i);
+
+        if ((p_entry->evt_mask & mask) && (p_entry->evt_handler != NULL))
+        {
+            p_entry->evt_handler(p_entry->p_context, p_ble_evt);
+        }
+    }
+}
+
+#endif // NRF_MODULE_ENABLED(BLE_SRV_TABLE)
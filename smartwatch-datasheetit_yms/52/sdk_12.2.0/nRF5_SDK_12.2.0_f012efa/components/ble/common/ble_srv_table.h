@@ -0,0 +1,185 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ble_srv_table Service table
+ * @{
+ * @ingroup ble_sdk_lib
+ * @brief Module for building the GATT database from a table of services, and for dispatching
+ *        BLE events to the services by attribute handle.
+ *
+ * @details Every service is an entry of the table, defined with @ref BLE_SRV_TABLE_DEF anywhere
+ *          in the application. An entry is either declarative (a service UUID and a list of
+ *          characteristics, see @ref ble_srv_table_decl_t) or an init function, for example one
+ *          that calls the init function of an SDK service. @ref ble_srv_table_build adds all
+ *          entries in one pass and records the range of attribute handles of each entry.
+ *
+ *          @ref ble_srv_table_on_ble_evt replaces the chain of service event handlers in
+ *          ble_evt_dispatch(). An event about an attribute (a write, an authorization request
+ *          or a confirmation) is passed only to the service that owns the attribute, found by
+ *          a binary search of the handle ranges. Other events are passed only to the services
+ *          that ask for them in their event mask.
+ *
+ *          The order of the entries is the order in which the linker places them, so the
+ *          handles only change when the build changes.
+ *
+ * @note The entries are placed in a section named "ble_srv_table". The linker script must keep
+ *       the section, like for other section variables.
+ * @note All services must be added through the table, or before @ref ble_srv_table_build is
+ *       called. A service added after the table would be taken as a part of the last entry.
+ */
+
+#ifndef BLE_SRV_TABLE_H__
+#define BLE_SRV_TABLE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble.h"
+#include "ble_srv_common.h"
+#include "sdk_errors.h"
+#include "section_vars.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**@brief Events, other than the events about the attributes of a service, that are passed to
+ *        its event handler.
+ * @{ */
+#define BLE_SRV_TABLE_EVT_GAP           (1UL << 0)  /**< GAP events, for example connected and disconnected. */
+#define BLE_SRV_TABLE_EVT_TX_COMPLETE   (1UL << 1)  /**< BLE_EVT_TX_COMPLETE. */
+#define BLE_SRV_TABLE_EVT_GATTS         (1UL << 2)  /**< GATTS events without a handle of the service, for example BLE_GATTS_EVT_SYS_ATTR_MISSING. */
+#define BLE_SRV_TABLE_EVT_OTHER         (1UL << 3)  /**< All other events. */
+#define BLE_SRV_TABLE_EVT_ALL           0x0FUL      /**< Every event, like a handler in ble_evt_dispatch(). */
+/** @} */
+
+/**@brief Value of @ref ble_add_char_params_t::uuid_type for a characteristic UUID on the base UUID
+ *        of its service. */
+#define BLE_SRV_TABLE_UUID_TYPE_SERVICE 0xFF
+
+/**@brief Declarative service. */
+typedef struct
+{
+    uint16_t                      uuid;           /**< UUID of the service, 16 bits. */
+    ble_uuid128_t         const * p_uuid_base;    /**< Vendor specific base UUID, or NULL for a Bluetooth SIG UUID. */
+    ble_add_char_params_t const * p_chars;        /**< Characteristics. */
+    uint8_t                       char_count;     /**< Number of characteristics. */
+    uint16_t                    * p_srv_handle;   /**< Handle of the service. Can be NULL. */
+    ble_gatts_char_handles_t    * p_char_handles; /**< Handles of the characteristics, char_count elements. */
+} ble_srv_table_decl_t;
+
+/**@brief Init function of a service.
+ *
+ * @param[in] p_context   Context of the entry.
+ *
+ * @return NRF_SUCCESS, or an error code of the service.
+ */
+typedef uint32_t (*ble_srv_table_init_t)(void * p_context);
+
+/**@brief Event handler of a service. Same as the on_ble_evt() functions of the SDK services.
+ *
+ * @param[in] p_context   Context of the entry.
+ * @param[in] p_ble_evt   Event.
+ */
+typedef void (*ble_srv_table_evt_handler_t)(void * p_context, ble_evt_t * p_ble_evt);
+
+/**@brief Attribute handles of an entry. */
+typedef struct
+{
+    uint16_t start_handle; /**< First handle, the service declaration. */
+    uint16_t end_handle;   /**< Last handle. */
+} ble_srv_table_range_t;
+
+/**@brief Entry of the table. Defined with @ref BLE_SRV_TABLE_DEF. */
+typedef struct
+{
+    ble_srv_table_decl_t  const * p_decl;      /**< Declarative service, or NULL. */
+    ble_srv_table_init_t          init;        /**< Init function, used if p_decl is NULL. */
+    ble_srv_table_evt_handler_t   evt_handler; /**< Event handler. Can be NULL. */
+    void                        * p_context;   /**< Context of init and evt_handler. */
+    uint32_t                      evt_mask;    /**< Other events for evt_handler, see @ref BLE_SRV_TABLE_EVT_GAP. */
+    ble_srv_table_range_t       * p_range;     /**< Handles of the entry, set by @ref ble_srv_table_build. */
+} ble_srv_table_entry_t;
+
+/**@brief Result of @ref ble_srv_table_build. */
+typedef struct
+{
+    uint16_t first_handle; /**< First handle of the table. */
+    uint16_t last_handle;  /**< Last handle of the table. */
+    uint16_t attr_count;   /**< Attributes added by the table. */
+    uint16_t entry_count;  /**< Entries of the table. */
+    uint16_t failed_entry; /**< Index of the entry that failed, if the build failed. */
+} ble_srv_table_stats_t;
+
+
+/**@brief Macro for defining an entry of the service table.
+ *
+ * @param[in] _name          Name of the entry.
+ * @param[in] _p_decl        Declarative service (@ref ble_srv_table_decl_t), or NULL.
+ * @param[in] _init          Init function (@ref ble_srv_table_init_t), if _p_decl is NULL.
+ * @param[in] _evt_handler   Event handler, for example (ble_srv_table_evt_handler_t)ble_bas_on_ble_evt.
+ * @param[in] _p_context     Context, for example the instance of the service.
+ * @param[in] _evt_mask      Other events for the handler, see @ref BLE_SRV_TABLE_EVT_GAP.
+ */
+#define BLE_SRV_TABLE_DEF(_name, _p_decl, _init, _evt_handler, _p_context, _evt_mask)     \
+    static ble_srv_table_range_t CONCAT_2(_name, _range);                               \
+    NRF_SECTION_VARS_REGISTER_VAR(ble_srv_table, ble_srv_table_entry_t const _name) =   \
+    {                                                                                   \
+        .p_decl      = (_p_decl),                                                       \
+        .init        = (_init),                                                         \
+        .evt_handler = (_evt_handler),                                                  \
+        .p_context   = (_p_context),                                                    \
+        .evt_mask    = (_evt_mask),                                                     \
+        .p_range     = &CONCAT_2(_name, _range),                                        \
+    }
+
+
+/**@brief Function for adding all services of the table to the GATT database.
+ *
+ * @details Must be called once, after the SoftDevice is enabled. The entries are added in order.
+ *          The handles of each entry are found with sd_ble_gatts_attr_get(), which also gives
+ *          the number of attributes, to compare with the attribute table size of the SoftDevice.
+ *
+ * @param[out] p_stats   Handles and attributes of the table. Can be NULL.
+ *
+ * @retval NRF_SUCCESS       If all entries were added.
+ * @retval NRF_ERROR_NO_MEM  If the attribute table of the SoftDevice is full. The failed entry
+ *                           is in @p p_stats.
+ * @return Otherwise, the error code of the entry that failed.
+ */
+ret_code_t ble_srv_table_build(ble_srv_table_stats_t * p_stats);
+
+
+/**@brief Function for finding the entry that owns an attribute.
+ *
+ * @param[in] handle   Attribute handle.
+ *
+ * @return Entry, or NULL if the handle is not in the table.
+ */
+ble_srv_table_entry_t const * ble_srv_table_find(uint16_t handle);
+
+
+/**@brief Function for passing a BLE event to the services of the table.
+ *
+ * @param[in] p_ble_evt   Event.
+ */
+void ble_srv_table_on_ble_evt(ble_evt_t * p_ble_evt);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLE_SRV_TABLE_H__
+
+/** @} */
@@ -0,0 +1,16 @@
+/**
+ *
+ * @defgroup ble_srv_table_config Service table configuration
+ * @{
+ * @ingroup ble_srv_table
+ */
+/** @brief Enable the service table.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BLE_SRV_TABLE_ENABLED
+
+
+/** @} */
@@ -0,0 +1,293 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(NRF_BLE_GQ)
+#include "nrf_ble_gq.h"
+#include <string.h>
+#include "ble_err.h"
+#define NRF_LOG_MODULE_NAME "NRF_BLE_GQ"
+#include "nrf_log.h"
+
+
+/**@brief Function for checking if an error of the SoftDevice means that the request can be
+ *        passed again later.
+ */
+static bool is_busy(uint32_t err_code)
+{
+    return (err_code == NRF_ERROR_BUSY) || (err_code == BLE_ERROR_NO_TX_PACKETS);
+}
+
+
+/**@brief Function for passing a request to the SoftDevice.
+ *
+ * @param[in] conn_handle Connection handle of the request.
+ * @param[in] p_req       Request.
+ *
+ * @return The error returned by the SoftDevice.
+ */
+static uint32_t request_submit(uint16_t conn_handle, nrf_ble_gq_req_t const * p_req)
+{
+    switch (p_req->type)
+    {
+        case NRF_BLE_GQ_REQ_GATTC_READ:
+            return sd_ble_gattc_read(conn_handle,
+                                     p_req->params.gattc_read.handle,
+                                     p_req->params.gattc_read.offset);
+
+        case NRF_BLE_GQ_REQ_GATTC_WRITE:
+            return sd_ble_gattc_write(conn_handle, &p_req->params.gattc_write);
+
+        case NRF_BLE_GQ_REQ_GATTS_HVX:
+            return sd_ble_gatts_hvx(conn_handle, &p_req->params.gatts_hvx);
+
+        default:
+            return NRF_ERROR_INVALID_PARAM;
+    }
+}
+
+
+/**@brief Function for finding the link of a connection.
+ *
+ * @param[in] p_gq        GATT queue instance.
+ * @param[in] conn_handle Connection handle.
+ *
+ * @return Index of the link, or @ref nrf_ble_gq_t::link_count if the connection has no link.
+ */
+static uint32_t link_find(nrf_ble_gq_t const * p_gq, uint16_t conn_handle)
+{
+    uint32_t i;
+
+    for (i = 0; i < p_gq->link_count; i++)
+    {
+        if (p_gq->p_conn_handles[i] == conn_handle)
+        {
+            break;
+        }
+    }
+    return i;
+}
+
+
+/**@brief Function for passing the queued requests of a link to the SoftDevice.
+ *
+ * @details Requests are passed in order, until the SoftDevice is busy. Requests that are rejected
+ *          are removed and reported to their error handler.
+ *
+ * @param[in] p_gq GATT queue instance.
+ * @param[in] link Index of the link.
+ */
+static void queue_process(nrf_ble_gq_t * p_gq, uint32_t link)
+{
+    nrf_queue_t const * p_queue     = &p_gq->p_queues[link];
+    uint16_t            conn_handle = p_gq->p_conn_handles[link];
+    nrf_queue_span_t    spans[2];
+
+    while (nrf_queue_read_peek_contiguous(p_queue, spans) > 0)
+    {
+        nrf_ble_gq_item_t * p_item = (nrf_ble_gq_item_t *)spans[0].p_data;
+        uint16_t            len    = p_item->len;
+        uint32_t            err_code;
+
+        // The item may have been moved by the queue, so its data is pointed to here.
+        switch (p_item->req.type)
+        {
+            case NRF_BLE_GQ_REQ_GATTC_WRITE:
+                p_item->req.params.gattc_write.p_value = p_item->data;
+                break;
+
+            case NRF_BLE_GQ_REQ_GATTS_HVX:
+                if (p_item->req.params.gatts_hvx.p_data != NULL)
+                {
+                    p_item->req.params.gatts_hvx.p_data = p_item->data;
+                }
+                p_item->req.params.gatts_hvx.p_len = &len;
+                break;
+
+            default:
+                break;
+        }
+
+        err_code = request_submit(conn_handle, &p_item->req);
+        if (is_busy(err_code))
+        {
+            return;
+        }
+
+        if ((err_code != NRF_SUCCESS) && (p_item->req.error_handler != NULL))
+        {
+            NRF_LOG_WARNING("Request rejected by the SoftDevice, error 0x%x.\r\n", err_code);
+            p_item->req.error_handler(conn_handle, err_code, p_item->req.p_ctx);
+        }
+
+        (void)nrf_queue_read_release(p_queue, 1);
+    }
+}
+
+
+/**@brief Function for copying a request and its data into a queue item.
+ *
+ * @param[out] p_item Queue item.
+ * @param[in]  p_req  Request.
+ *
+ * @retval NRF_SUCCESS         If the request was copied.
+ * @retval NRF_ERROR_DATA_SIZE If the data does not fit in the item.
+ */
+static ret_code_t item_fill(nrf_ble_gq_item_t * p_item, nrf_ble_gq_req_t const * p_req)
+{
+    uint8_t const * p_data = NULL;
+
+    p_item->req = *p_req;
+    p_item->len = 0;
+
+    switch (p_req->type)
+    {
+        case NRF_BLE_GQ_REQ_GATTC_WRITE:
+            p_data      = p_req->params.gattc_write.p_value;
+            p_item->len = p_req->params.gattc_write.len;
+            break;
+
+        case NRF_BLE_GQ_REQ_GATTS_HVX:
+            p_data      = p_req->params.gatts_hvx.p_data;
+            p_item->len = (p_req->params.gatts_hvx.p_len != NULL) ? *p_req->params.gatts_hvx.p_len : 0;
+            break;
+
+        default:
+            break;
+    }
+
+    if (p_item->len > NRF_BLE_GQ_DATA_MAX_LEN)
+    {
+        return NRF_ERROR_DATA_SIZE;
+    }
+    if (p_data != NULL)
+    {
+        memcpy(p_item->data, p_data, p_item->len);
+    }
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_ble_gq_init(nrf_ble_gq_t * p_gq)
+{
+    VERIFY_PARAM_NOT_NULL(p_gq);
+
+    for (uint32_t i = 0; i < p_gq->link_count; i++)
+    {
+        p_gq->p_conn_handles[i] = BLE_CONN_HANDLE_INVALID;
+
+        p_gq->p_queues[i].p_cb         = &p_gq->p_queue_cbs[i];
+        p_gq->p_queues[i].p_buffer     = &p_gq->p_items[i * (p_gq->queue_size + 1)];
+        p_gq->p_queues[i].size         = p_gq->queue_size;
+        p_gq->p_queues[i].element_size = sizeof(nrf_ble_gq_item_t);
+        p_gq->p_queues[i].mode         = NRF_QUEUE_MODE_NO_OVERFLOW;
+        p_gq->p_queues[i].concurrency  = NRF_QUEUE_CONCURRENCY_LOCKED;
+
+        nrf_queue_reset(&p_gq->p_queues[i]);
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_ble_gq_item_add(nrf_ble_gq_t           * p_gq,
+                               nrf_ble_gq_req_t const * p_req,
+                               uint16_t                 conn_handle)
+{
+    nrf_ble_gq_item_t item;
+    uint32_t          link;
+    ret_code_t        err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_gq);
+    VERIFY_PARAM_NOT_NULL(p_req);
+
+    link = link_find(p_gq, conn_handle);
+    if (link == p_gq->link_count)
+    {
+        // Assign a free link to the connection.
+        link = link_find(p_gq, BLE_CONN_HANDLE_INVALID);
+        if (link == p_gq->link_count)
+        {
+            return NRF_ERROR_NO_MEM;
+        }
+        p_gq->p_conn_handles[link] = conn_handle;
+    }
+
+    // Requests that wait in the queue go first.
+    if (nrf_queue_is_empty(&p_gq->p_queues[link]))
+    {
+        err_code = request_submit(conn_handle, p_req);
+        if (!is_busy(err_code))
+        {
+            return err_code;
+        }
+    }
+
+    err_code = item_fill(&item, p_req);
+    VERIFY_SUCCESS(err_code);
+
+    err_code = nrf_queue_push(&p_gq->p_queues[link], &item);
+    VERIFY_SUCCESS(err_code);
+
+    queue_process(p_gq, link);
+    return NRF_SUCCESS;
+}
+
+
+void nrf_ble_gq_on_ble_evt(nrf_ble_gq_t * p_gq, ble_evt_t const * p_ble_evt)
+{
+    uint16_t conn_handle;
+    uint32_t link;
+
+    if ((p_gq == NULL) || (p_ble_evt == NULL))
+    {
+        return;
+    }
+
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GAP_EVT_DISCONNECTED:
+            link = link_find(p_gq, p_ble_evt->evt.gap_evt.conn_handle);
+            if (link < p_gq->link_count)
+            {
+                nrf_queue_reset(&p_gq->p_queues[link]);
+                p_gq->p_conn_handles[link] = BLE_CONN_HANDLE_INVALID;
+            }
+            return;
+
+        case BLE_EVT_TX_COMPLETE:
+            conn_handle = p_ble_evt->evt.common_evt.conn_handle;
+            break;
+
+        case BLE_GATTS_EVT_HVC:
+            conn_handle = p_ble_evt->evt.gatts_evt.conn_handle;
+            break;
+
+        default:
+            // All GATT client procedures end with a response or timeout event.
+            if ((p_ble_evt->header.evt_id < BLE_GATTC_EVT_BASE) ||
+                (p_ble_evt->header.evt_id > BLE_GATTC_EVT_LAST) ||
+                (p_ble_evt->header.evt_id == BLE_GATTC_EVT_HVX))
+            {
+                return;
+            }
+            conn_handle = p_ble_evt->evt.gattc_evt.conn_handle;
+            break;
+    }
+
+    link = link_find(p_gq, conn_handle);
+    if (link < p_gq->link_count)
+    {
+        queue_process(p_gq, link);
+    }
+}
+
+#endif // NRF_MODULE_ENABLED(NRF_BLE_GQ)
@@ -0,0 +1,177 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup nrf_ble_gq GATT queue
+ * @{
+ * @ingroup ble_sdk_lib
+ * @brief Module for queuing GATT procedures of several modules on the same links.
+ *
+ * @details The SoftDevice runs one GATT client procedure per link at a time, and returns
+ *          @ref NRF_ERROR_BUSY when another one is in progress. Notifications and write commands
+ *          fail with @ref BLE_ERROR_NO_TX_PACKETS when the application packet buffers are full.
+ *          Instead of calling the SoftDevice directly, modules add their requests to a GATT queue.
+ *          A request that cannot be passed to the SoftDevice yet is stored in the queue of its
+ *          link, and passed again when the SoftDevice reports that the previous procedure has
+ *          completed or that packet buffers have been freed.
+ *
+ *          The data of a queued request is copied, so the buffer of the caller can be reused
+ *          after @ref nrf_ble_gq_item_add returns.
+ *
+ *          A link is assigned to a connection when the first request for the connection is added.
+ *          The link is freed, and its queued requests are discarded, when the connection is
+ *          disconnected.
+ *
+ * @note The application must propagate BLE stack events to this module by calling
+ *       @ref nrf_ble_gq_on_ble_evt. Requests must be added from the same interrupt priority as
+ *       the BLE stack events are handled in.
+ */
+
+#ifndef NRF_BLE_GQ_H__
+#define NRF_BLE_GQ_H__
+
+#include <stdint.h>
+#include "ble.h"
+#include "ble_gattc.h"
+#include "ble_gatts.h"
+#include "nrf_queue.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Maximum length of the data of a queued request.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef NRF_BLE_GQ_DATA_MAX_LEN
+#define NRF_BLE_GQ_DATA_MAX_LEN (GATT_MTU_SIZE_DEFAULT - 3)
+#endif
+
+/**@brief Macro for defining a GATT queue instance.
+ *
+ * @param[in] _name       Name of the instance.
+ * @param[in] _link_count Number of links that can use the queue at the same time.
+ * @param[in] _queue_size Number of requests that can be queued for every link.
+ */
+#define NRF_BLE_GQ_DEF(_name, _link_count, _queue_size)                                 \
+    static uint16_t          _name##_conn_handles[(_link_count)];                       \
+    static nrf_queue_t       _name##_queues[(_link_count)];                             \
+    static nrf_queue_cb_t    _name##_queue_cbs[(_link_count)];                          \
+    static nrf_ble_gq_item_t _name##_items[(_link_count)][(_queue_size) + 1];           \
+    static nrf_ble_gq_t      _name =                                                    \
+    {                                                                                   \
+        .link_count     = (_link_count),                                                \
+        .queue_size     = (_queue_size),                                                \
+        .p_conn_handles = _name##_conn_handles,                                         \
+        .p_queues       = _name##_queues,                                               \
+        .p_queue_cbs    = _name##_queue_cbs,                                            \
+        .p_items        = &_name##_items[0][0],                                         \
+    }
+
+/**@brief Types of requests. */
+typedef enum
+{
+    NRF_BLE_GQ_REQ_GATTC_READ,  /**< GATT client read, see @ref sd_ble_gattc_read. */
+    NRF_BLE_GQ_REQ_GATTC_WRITE, /**< GATT client write, see @ref sd_ble_gattc_write. */
+    NRF_BLE_GQ_REQ_GATTS_HVX,   /**< GATT server notification or indication, see @ref sd_ble_gatts_hvx. */
+} nrf_ble_gq_req_type_t;
+
+/**@brief Handler for requests that were rejected by the SoftDevice after being queued.
+ *
+ * @param[in] conn_handle Connection handle of the request.
+ * @param[in] nrf_error   Error returned by the SoftDevice.
+ * @param[in] p_ctx       Context of the request.
+ */
+typedef void (*nrf_ble_gq_req_error_cb_t)(uint16_t conn_handle, uint32_t nrf_error, void * p_ctx);
+
+/**@brief GATT request. */
+typedef struct
+{
+    nrf_ble_gq_req_type_t     type;          /**< Type of the request. */
+    nrf_ble_gq_req_error_cb_t error_handler; /**< Called if the request is rejected after being queued. Can be NULL. */
+    void                    * p_ctx;         /**< Context passed to @p error_handler. */
+    union
+    {
+        struct
+        {
+            uint16_t handle;                 /**< Handle of the attribute to read. */
+            uint16_t offset;                 /**< Offset to read from. */
+        } gattc_read;                        /**< Parameters of @ref NRF_BLE_GQ_REQ_GATTC_READ. */
+        ble_gattc_write_params_t gattc_write;/**< Parameters of @ref NRF_BLE_GQ_REQ_GATTC_WRITE. */
+        ble_gatts_hvx_params_t   gatts_hvx;  /**< Parameters of @ref NRF_BLE_GQ_REQ_GATTS_HVX. */
+    } params;
+} nrf_ble_gq_req_t;
+
+/**@brief Queued request, with a copy of its data. Its content must not be accessed by the user. */
+typedef struct
+{
+    nrf_ble_gq_req_t req;                           /**< Request. */
+    uint16_t         len;                           /**< Length of the data. */
+    uint8_t          data[NRF_BLE_GQ_DATA_MAX_LEN]; /**< Data of the request. */
+} nrf_ble_gq_item_t;
+
+/**@brief GATT queue instance. Defined with @ref NRF_BLE_GQ_DEF. */
+typedef struct nrf_ble_gq_s
+{
+    uint8_t             link_count;     /**< Number of links. */
+    uint8_t             queue_size;     /**< Number of requests that can be queued for every link. */
+    uint16_t          * p_conn_handles; /**< Connection handle of every link, or BLE_CONN_HANDLE_INVALID if the link is free. */
+    nrf_queue_t       * p_queues;       /**< Request queue of every link. */
+    nrf_queue_cb_t    * p_queue_cbs;    /**< Control blocks of the request queues. */
+    nrf_ble_gq_item_t * p_items;        /**< Storage of the request queues. */
+} nrf_ble_gq_t;
+
+/**@brief Function for initializing a GATT queue instance.
+ *
+ * @param[in] p_gq Instance defined with @ref NRF_BLE_GQ_DEF.
+ *
+ * @retval NRF_SUCCESS    If the instance was initialized.
+ * @retval NRF_ERROR_NULL If @p p_gq was NULL.
+ */
+ret_code_t nrf_ble_gq_init(nrf_ble_gq_t * p_gq);
+
+/**@brief Function for adding a request to the GATT queue.
+ *
+ * @details If the queue of the link is empty, the request is passed to the SoftDevice at once.
+ *          If the SoftDevice is busy, or other requests are waiting, the request is queued.
+ *
+ * @param[in] p_gq        GATT queue instance.
+ * @param[in] p_req       Request. The request and its data are copied.
+ * @param[in] conn_handle Connection handle of the request.
+ *
+ * @retval NRF_SUCCESS             If the request was passed to the SoftDevice or queued.
+ * @retval NRF_ERROR_NULL          If a NULL pointer was passed.
+ * @retval NRF_ERROR_DATA_SIZE     If the data is longer than @ref NRF_BLE_GQ_DATA_MAX_LEN.
+ * @retval NRF_ERROR_NO_MEM        If the queue of the link is full, or all links are in use.
+ * @return Any error returned by the SoftDevice that does not mean busy.
+ */
+ret_code_t nrf_ble_gq_item_add(nrf_ble_gq_t           * p_gq,
+                               nrf_ble_gq_req_t const * p_req,
+                               uint16_t                 conn_handle);
+
+/**@brief Function for handling BLE stack events.
+ *
+ * @param[in] p_gq      GATT queue instance.
+ * @param[in] p_ble_evt Event received from the BLE stack.
+ */
+void nrf_ble_gq_on_ble_evt(nrf_ble_gq_t * p_gq, ble_evt_t const * p_ble_evt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_BLE_GQ_H__
+
+/** @} */
@@ -0,0 +1,25 @@
+/**
+ *
+ * @defgroup nrf_ble_gq_config GATT queue configuration
+ * @{
+ * @ingroup nrf_ble_gq
+ */
+/** @brief Enable the GATT queue.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_BLE_GQ_ENABLED
+
+/** @brief Maximum length of the data of a queued request.
+ *
+ *  Write requests and notifications with more data are rejected. The default fits the default
+ *  ATT MTU.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_BLE_GQ_DATA_MAX_LEN
+
+
+/** @} */
@@ -21,8 +21,162 @@
 #define NRF_LOG_MODULE_NAME "BLE_GATT"
 #include "nrf_log.h"
 
+#define LL_DATA_LENGTH_DEFAULT  27  /**< Link layer payload size without data length extension. */
+
+/**@brief States of the link profile procedure. */
+enum
+{
+    LINK_PROFILE_STATE_IDLE,        /**< No procedure is ongoing. */
+    LINK_PROFILE_STATE_MTU,         /**< Waiting for the ATT_MTU exchange. */
+    LINK_PROFILE_STATE_CONN_PARAMS, /**< The connection parameter update must be requested. */
+    LINK_PROFILE_STATE_WAIT,        /**< Waiting for the connection parameter update. */
+};
+
 
 #if (NRF_SD_BLE_API_VERSION == 3)
+/**@brief Start the ATT_MTU exchange, or mark it pending if the SoftDevice is busy.
+ *
+ * @param[in]   p_gatt       GATT structure.
+ * @param[in]   conn_handle  Connection handle of the link.
+ */
+static void mtu_request_send(nrf_ble_gatt_t * p_gatt, uint16_t conn_handle)
+{
+    ret_code_t err_code;
+
+    p_gatt->links[conn_handle].is_request_pending = false;
+    err_code = sd_ble_gattc_exchange_mtu_request(conn_handle,
+                                                 p_gatt->links[conn_handle].att_mtu_desired);
+    if (err_code == NRF_ERROR_BUSY)
+    {
+        NRF_LOG_DEBUG("exchange_mtu_request for conn_handle %d returned busy, will retry\r\n",
+                      conn_handle);
+        p_gatt->links[conn_handle].is_request_pending = true;
+    }
+    if (err_code == NRF_SUCCESS)
+    {
+        NRF_LOG_INFO("request ATT MTU %d for conn_handle %d \r\n",
+                     p_gatt->links[conn_handle].att_mtu_desired, conn_handle);
+        p_gatt->links[conn_handle].is_request_sent = true;
+    }
+}
+
+
+/**@brief Finish the link profile procedure and notify the application.
+ *
+ * @param[in]   p_gatt       GATT structure.
+ * @param[in]   conn_handle  Connection handle of the link.
+ * @param[in]   status       Result of the connection parameter update request.
+ */
+static void link_profile_done(nrf_ble_gatt_t * p_gatt, uint16_t conn_handle, ret_code_t status)
+{
+    nrf_ble_gatt_link_t * p_link = &p_gatt->links[conn_handle];
+
+    p_link->profile_state = LINK_PROFILE_STATE_IDLE;
+    NRF_LOG_INFO("link profile %d done for conn_handle %d, status %d\r\n",
+                 p_link->profile, conn_handle, status);
+
+    if (p_gatt->evt_handler != NULL)
+    {
+        nrf_ble_gatt_evt_t evt;
+        evt.evt_id            = NRF_BLE_GATT_EVT_LINK_PROFILE_DONE;
+        evt.conn_handle       = conn_handle;
+        evt.att_mtu_effective = p_link->att_mtu_effective;
+        evt.profile           = p_link->profile;
+        evt.status            = status;
+        evt.data_length       = p_link->data_length;
+        evt.conn_params       = p_link->conn_params;
+        p_gatt->evt_handler(p_gatt, &evt);
+    }
+}
+
+
+/**@brief Run the link profile procedure as far as possible.
+ *
+ * @param[in]   p_gatt       GATT structure.
+ * @param[in]   conn_handle  Connection handle of the link.
+ */
+static void link_profile_advance(nrf_ble_gatt_t * p_gatt, uint16_t conn_handle)
+{
+    nrf_ble_gatt_link_t * p_link = &p_gatt->links[conn_handle];
+    ble_gap_conn_params_t params;
+    ret_code_t            err_code;
+
+    if (p_link->profile_state == LINK_PROFILE_STATE_MTU)
+    {
+        if (!p_link->is_mtu_exchanged)
+        {
+            // The request is sent only once per link. A request from the connected event or from
+            // the peer is awaited.
+            if (!p_link->is_request_sent && !p_link->is_request_pending)
+            {
+                mtu_request_send(p_gatt, conn_handle);
+            }
+            return;
+        }
+        p_link->profile_state = LINK_PROFILE_STATE_CONN_PARAMS;
+    }
+
+    if (p_link->profile_state != LINK_PROFILE_STATE_CONN_PARAMS)
+    {
+        return;
+    }
+
+    if (p_link->profile == NRF_BLE_GATT_LINK_PROFILE_BULK)
+    {
+        params.min_conn_interval = NRF_BLE_GATT_BULK_MIN_CONN_INTERVAL;
+        params.max_conn_interval = NRF_BLE_GATT_BULK_MAX_CONN_INTERVAL;
+        params.slave_latency     = 0;
+        params.conn_sup_timeout  = NRF_BLE_GATT_BULK_CONN_SUP_TIMEOUT;
+    }
+    else
+    {
+        params.min_conn_interval = NRF_BLE_GATT_IDLE_MIN_CONN_INTERVAL;
+        params.max_conn_interval = NRF_BLE_GATT_IDLE_MAX_CONN_INTERVAL;
+        params.slave_latency     = NRF_BLE_GATT_IDLE_SLAVE_LATENCY;
+        params.conn_sup_timeout  = NRF_BLE_GATT_IDLE_CONN_SUP_TIMEOUT;
+    }
+
+    // Nothing to negotiate if the link already uses suitable parameters.
+    if ((p_link->conn_params.max_conn_interval >= params.min_conn_interval) &&
+        (p_link->conn_params.max_conn_interval <= params.max_conn_interval) &&
+        (p_link->conn_params.slave_latency     == params.slave_latency))
+    {
+        link_profile_done(p_gatt, conn_handle, NRF_SUCCESS);
+        return;
+    }
+
+    err_code = sd_ble_gap_conn_param_update(conn_handle, &params);
+    if (err_code == NRF_ERROR_BUSY)
+    {
+        // Retried on the next BLE event of the link.
+        return;
+    }
+    if (err_code != NRF_SUCCESS)
+    {
+        link_profile_done(p_gatt, conn_handle, err_code);
+        return;
+    }
+    p_link->profile_state = LINK_PROFILE_STATE_WAIT;
+}
+
+
+/**@brief Reset the information of a link.
+ *
+ * @param[in]   p_link       Link information.
+ */
+static void link_reset(nrf_ble_gatt_link_t * p_link)
+{
+    p_link->att_mtu_desired    = NRF_BLE_GATT_MAX_MTU_SIZE;
+    p_link->att_mtu_effective  = GATT_MTU_SIZE_DEFAULT;
+    p_link->is_request_pending = false;
+    p_link->is_request_sent    = false;
+    p_link->is_mtu_exchanged   = false;
+    p_link->profile_state      = LINK_PROFILE_STATE_IDLE;
+    p_link->data_length        = LL_DATA_LENGTH_DEFAULT;
+    memset(&p_link->conn_params, 0, sizeof(p_link->conn_params));
+}
+
+
 /**@brief Handle a connected event.
  *
  * @param[in]   p_gatt       GATT structure.
@@ -30,9 +184,11 @@
  */
 void on_connected_evt(nrf_ble_gatt_t * p_gatt, ble_evt_t * p_ble_evt)
 {
-    ret_code_t err_code;
     uint16_t   conn_handle = p_ble_evt->evt.common_evt.conn_handle;
 
+    link_reset(&p_gatt->links[conn_handle]);
+    p_gatt->links[conn_handle].conn_params = p_ble_evt->evt.gap_evt.params.connected.conn_params;
+
     if(p_ble_evt->evt.gap_evt.params.connected.role == BLE_GAP_ROLE_PERIPH)
     {
         p_gatt->links[conn_handle].att_mtu_desired = p_gatt->att_mtu_desired_periph;
@@ -43,19 +199,7 @@ void on_connected_evt(nrf_ble_gatt_t * p_gatt, ble_evt_t * p_ble_evt)
     }
     if (p_gatt->links[conn_handle].att_mtu_desired > GATT_MTU_SIZE_DEFAULT)
     {
-        err_code = sd_ble_gattc_exchange_mtu_request(conn_handle,
-                                                     p_gatt->links[conn_handle].att_mtu_desired);
-        if (err_code == NRF_ERROR_BUSY)
-        {
-            NRF_LOG_DEBUG("exchange_mtu_request for conn_handle %d returned busy, will retry\r\n",
-                          conn_handle);
-            p_gatt->links[conn_handle].is_request_pending = true;
-        }
-        if (err_code == NRF_SUCCESS)
-        {
-            NRF_LOG_INFO("request ATT MTU %d for conn_handle %d \r\n",
-                        p_gatt->links[conn_handle].att_mtu_desired, conn_handle);
-        }
+        mtu_request_send(p_gatt, conn_handle);
     }
 }
 #endif //(NRF_SD_BLE_API_VERSION == 3)
@@ -84,11 +228,15 @@ void on_exchange_mtu_rsp_evt(nrf_ble_gatt_t * p_gatt, ble_evt_t * p_ble_evt)
     if(p_gatt->evt_handler != NULL)
     {
         nrf_ble_gatt_evt_t evt;
+        memset(&evt, 0, sizeof(evt));
+        evt.evt_id      = NRF_BLE_GATT_EVT_ATT_MTU_UPDATED;
         evt.conn_handle = conn_handle;
         evt.att_mtu_effective = p_gatt->links[conn_handle].att_mtu_effective;
         p_gatt->evt_handler(p_gatt, &evt);
     }
     p_gatt->links[conn_handle].is_request_pending = false;
+    p_gatt->links[conn_handle].is_mtu_exchanged   = true;
+    link_profile_advance(p_gatt, conn_handle);
 }
 #endif //(NRF_SD_BLE_API_VERSION == 3)
 
@@ -120,11 +268,15 @@ void on_exchange_mtu_request_evt(nrf_ble_gatt_t * p_gatt, ble_evt_t * p_ble_evt)
     if(p_gatt->evt_handler != NULL)
     {
         nrf_ble_gatt_evt_t evt;
+        memset(&evt, 0, sizeof(evt));
+        evt.evt_id      = NRF_BLE_GATT_EVT_ATT_MTU_UPDATED;
         evt.conn_handle = conn_handle;
         evt.att_mtu_effective = p_gatt->links[conn_handle].att_mtu_effective;
         p_gatt->evt_handler(p_gatt, &evt);
     }
     p_gatt->links[conn_handle].is_request_pending = false;
+    p_gatt->links[conn_handle].is_mtu_exchanged   = true;
+    link_profile_advance(p_gatt, conn_handle);
 }
 #endif //(NRF_SD_BLE_API_VERSION == 3)
 
@@ -148,6 +300,28 @@ void on_data_length_changed_evt(nrf_ble_gatt_t * p_gatt, ble_evt_t * p_ble_evt)
                   p_ble_evt->evt.common_evt.params.data_length_changed.max_tx_octets);
     NRF_LOG_DEBUG("max_tx_time %d \r\n",
                   p_ble_evt->evt.common_evt.params.data_length_changed.max_tx_time);
+    p_gatt->links[conn_handle].data_length =
+        p_ble_evt->evt.common_evt.params.data_length_changed.max_tx_octets;
+}
+#endif //(NRF_SD_BLE_API_VERSION == 3)
+
+
+#if (NRF_SD_BLE_API_VERSION == 3)
+/**@brief Handle a CONN_PARAM_UPDATE event.
+ *
+ * @param[in]   p_gatt       GATT structure.
+ * @param[in]   p_ble_evt   Event received from the BLE stack.
+ */
+void on_conn_param_update_evt(nrf_ble_gatt_t * p_gatt, ble_evt_t * p_ble_evt)
+{
+    uint16_t conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+
+    p_gatt->links[conn_handle].conn_params =
+        p_ble_evt->evt.gap_evt.params.conn_param_update.conn_params;
+    if (p_gatt->links[conn_handle].profile_state == LINK_PROFILE_STATE_WAIT)
+    {
+        link_profile_done(p_gatt, conn_handle, NRF_SUCCESS);
+    }
 }
 #endif //(NRF_SD_BLE_API_VERSION == 3)
 
@@ -160,9 +334,7 @@ ret_code_t nrf_ble_gatt_init(nrf_ble_gatt_t * p_gatt, nrf_ble_gatt_evt_handler_t
     p_gatt->att_mtu_desired_central = NRF_BLE_GATT_MAX_MTU_SIZE;
     for (uint8_t i = 0; i < NRF_BLE_GATT_LINK_COUNT; i++)
     {
-        p_gatt->links[i].att_mtu_desired    = NRF_BLE_GATT_MAX_MTU_SIZE;
-        p_gatt->links[i].att_mtu_effective  = GATT_MTU_SIZE_DEFAULT;
-        p_gatt->links[i].is_request_pending = false;
+        link_reset(&p_gatt->links[i]);
     }
     p_gatt->evt_handler = evt_handler;
 #endif
@@ -224,6 +396,43 @@ uint16_t nrf_ble_gatt_eff_mtu_get(nrf_ble_gatt_t * p_gatt, uint16_t conn_handle)
 }
 
 
+ret_code_t nrf_ble_gatt_link_profile_set(nrf_ble_gatt_t            * p_gatt,
+                                         uint16_t                    conn_handle,
+                                         nrf_ble_gatt_link_profile_t profile)
+{
+#if (NRF_SD_BLE_API_VERSION == 3)
+    VERIFY_PARAM_NOT_NULL(p_gatt);
+
+    if ((conn_handle >= NRF_BLE_GATT_LINK_COUNT) ||
+        ((profile != NRF_BLE_GATT_LINK_PROFILE_BULK) && (profile != NRF_BLE_GATT_LINK_PROFILE_IDLE)))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    p_gatt->links[conn_handle].profile = profile;
+    if (profile == NRF_BLE_GATT_LINK_PROFILE_BULK)
+    {
+        // The maximum ATT_MTU is requested if this device has not sent its request yet.
+        if (!p_gatt->links[conn_handle].is_request_sent)
+        {
+            p_gatt->links[conn_handle].att_mtu_desired = NRF_BLE_GATT_MAX_MTU_SIZE;
+        }
+        p_gatt->links[conn_handle].profile_state = LINK_PROFILE_STATE_MTU;
+    }
+    else
+    {
+        p_gatt->links[conn_handle].profile_state = LINK_PROFILE_STATE_CONN_PARAMS;
+    }
+    link_profile_advance(p_gatt, conn_handle);
+
+    return NRF_SUCCESS;
+#endif
+#if (NRF_SD_BLE_API_VERSION == 2)
+    return NRF_ERROR_NOT_SUPPORTED;
+#endif
+}
+
+
 void nrf_ble_gatt_on_ble_evt(nrf_ble_gatt_t * p_gatt, ble_evt_t * p_ble_evt)
 {
 #if (NRF_SD_BLE_API_VERSION == 3)
@@ -250,24 +459,25 @@ void nrf_ble_gatt_on_ble_evt(nrf_ble_gatt_t * p_gatt, ble_evt_t * p_ble_evt)
             on_data_length_changed_evt(p_gatt, p_ble_evt);
             break; // BLE_EVT_DATA_LENGTH_CHANGED
 
+        case BLE_GAP_EVT_CONN_PARAM_UPDATE:
+            on_conn_param_update_evt(p_gatt, p_ble_evt);
+            break; // BLE_GAP_EVT_CONN_PARAM_UPDATE
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            link_reset(&p_gatt->links[conn_handle]);
+            break; // BLE_GAP_EVT_DISCONNECTED
+
         default:
             break;
     }
     if (p_gatt->links[conn_handle].is_request_pending)
     {
-        ret_code_t err_code;
-        p_gatt->links[conn_handle].is_request_pending = false;
-        err_code = sd_ble_gattc_exchange_mtu_request(conn_handle,
-                                                     p_gatt->links[conn_handle].att_mtu_desired);
-        if (err_code == NRF_ERROR_BUSY)
-        {
-            p_gatt->links[conn_handle].is_request_pending = true;
-        }
-        if (err_code == NRF_SUCCESS)
-        {
-            NRF_LOG_INFO("sent pending request ATT MTU %d for conn_handle %d \r\n",
-                         p_gatt->links[conn_handle].att_mtu_desired, conn_handle);
-        }
+        mtu_request_send(p_gatt, conn_handle);
+    }
+    if (p_gatt->links[conn_handle].profile_state == LINK_PROFILE_STATE_CONN_PARAMS)
+    {
+        // The connection parameter update returned busy before.
+        link_profile_advance(p_gatt, conn_handle);
     }
 #endif //(NRF_SD_BLE_API_VERSION == 3)
 }
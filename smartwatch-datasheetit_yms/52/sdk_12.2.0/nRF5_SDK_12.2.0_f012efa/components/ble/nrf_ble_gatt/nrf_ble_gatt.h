@@ -16,6 +16,13 @@
  * @{
  * @ingroup ble_sdk_lib
  * @brief Module for negotiating and keeping track of the maximum ATT_MTU size.
+ *
+ * @details The module can also switch a link between two link profiles, see
+ *          @ref nrf_ble_gatt_link_profile_set. The bulk profile negotiates the maximum ATT_MTU
+ *          first and then requests the shortest connection interval without slave latency.
+ *          The idle profile requests a long connection interval with slave latency. The
+ *          SoftDevice extends the data length (DLE) on its own after the ATT_MTU exchange,
+ *          and the module reports the result.
  */
 
 #ifndef NRF_BLE_GATT_H__
@@ -64,12 +71,56 @@ extern "C" {
 /** @brief The maximum number of peripheral and central links combined. */
 #define NRF_BLE_GATT_LINK_COUNT (NRF_BLE_PERIPHERAL_LINK_COUNT + NRF_BLE_CENTRAL_LINK_COUNT)
 
+/** @brief Connection parameters of the bulk transfer profile, see @ref nrf_ble_gatt_config. */
+#ifndef NRF_BLE_GATT_BULK_MIN_CONN_INTERVAL
+    #define NRF_BLE_GATT_BULK_MIN_CONN_INTERVAL 6       // 7.5 ms
+#endif
+#ifndef NRF_BLE_GATT_BULK_MAX_CONN_INTERVAL
+    #define NRF_BLE_GATT_BULK_MAX_CONN_INTERVAL 12      // 15 ms
+#endif
+#ifndef NRF_BLE_GATT_BULK_CONN_SUP_TIMEOUT
+    #define NRF_BLE_GATT_BULK_CONN_SUP_TIMEOUT  400     // 4 s
+#endif
+
+/** @brief Connection parameters of the idle profile, see @ref nrf_ble_gatt_config. */
+#ifndef NRF_BLE_GATT_IDLE_MIN_CONN_INTERVAL
+    #define NRF_BLE_GATT_IDLE_MIN_CONN_INTERVAL 320     // 400 ms
+#endif
+#ifndef NRF_BLE_GATT_IDLE_MAX_CONN_INTERVAL
+    #define NRF_BLE_GATT_IDLE_MAX_CONN_INTERVAL 400     // 500 ms
+#endif
+#ifndef NRF_BLE_GATT_IDLE_SLAVE_LATENCY
+    #define NRF_BLE_GATT_IDLE_SLAVE_LATENCY     4
+#endif
+#ifndef NRF_BLE_GATT_IDLE_CONN_SUP_TIMEOUT
+    #define NRF_BLE_GATT_IDLE_CONN_SUP_TIMEOUT  600     // 6 s
+#endif
+
+
+/**@brief GATT module event types. */
+typedef enum
+{
+    NRF_BLE_GATT_EVT_ATT_MTU_UPDATED,                          //!< The ATT_MTU of the link has been negotiated.
+    NRF_BLE_GATT_EVT_LINK_PROFILE_DONE,                        //!< A link profile has been applied, see @ref nrf_ble_gatt_link_profile_set.
+} nrf_ble_gatt_evt_id_t;
+
+/**@brief Link profiles. */
+typedef enum
+{
+    NRF_BLE_GATT_LINK_PROFILE_BULK,                            //!< Maximum ATT_MTU and data length, shortest connection interval, no slave latency.
+    NRF_BLE_GATT_LINK_PROFILE_IDLE,                            //!< Long connection interval and slave latency.
+} nrf_ble_gatt_link_profile_t;
 
 /**@brief GATT module event. */
 typedef struct
 {
-    uint16_t conn_handle;                                      //!< Connection handle on which the event happened.
-    uint16_t att_mtu_effective;                                //!< Effective MTU after the event.
+    nrf_ble_gatt_evt_id_t       evt_id;                        //!< Type of the event.
+    uint16_t                    conn_handle;                   //!< Connection handle on which the event happened.
+    uint16_t                    att_mtu_effective;             //!< Effective MTU after the event.
+    nrf_ble_gatt_link_profile_t profile;                       //!< Profile that was applied. Only for @ref NRF_BLE_GATT_EVT_LINK_PROFILE_DONE.
+    ret_code_t                  status;                        //!< Result of the connection parameter update request. Only for @ref NRF_BLE_GATT_EVT_LINK_PROFILE_DONE.
+    uint16_t                    data_length;                   //!< Maximum number of octets in a transmitted link layer packet. Only for @ref NRF_BLE_GATT_EVT_LINK_PROFILE_DONE.
+    ble_gap_conn_params_t       conn_params;                   //!< Connection parameters of the link. Only for @ref NRF_BLE_GATT_EVT_LINK_PROFILE_DONE.
 }nrf_ble_gatt_evt_t;
 
 
@@ -85,9 +136,15 @@ typedef void (*nrf_ble_gatt_evt_handler_t) (nrf_ble_gatt_t * p_gatt, nrf_ble_gat
 /**@brief GATT information for each link. */
 typedef struct
 {
-    uint16_t att_mtu_desired;                                  //!< Requested ATT_MTU size for the link.
-    uint16_t att_mtu_effective;                                //!< Effective ATT_MTU size for the link.
-    bool     is_request_pending;                               //!< Flag that indicates if a request to extend the MTU size is pending for the link (if the call to @ref sd_ble_gattc_exchange_mtu_request returned @ref NRF_ERROR_BUSY).
+    uint16_t                    att_mtu_desired;               //!< Requested ATT_MTU size for the link.
+    uint16_t                    att_mtu_effective;             //!< Effective ATT_MTU size for the link.
+    bool                        is_request_pending;            //!< Flag that indicates if a request to extend the MTU size is pending for the link (if the call to @ref sd_ble_gattc_exchange_mtu_request returned @ref NRF_ERROR_BUSY).
+    bool                        is_request_sent;               //!< Flag that indicates if this device has started the ATT_MTU exchange on the link.
+    bool                        is_mtu_exchanged;              //!< Flag that indicates if the ATT_MTU exchange has been completed on the link.
+    uint8_t                     profile_state;                 //!< State of the link profile procedure.
+    nrf_ble_gatt_link_profile_t profile;                       //!< Link profile that is being applied.
+    uint16_t                    data_length;                   //!< Maximum number of octets in a transmitted link layer packet.
+    ble_gap_conn_params_t       conn_params;                   //!< Current connection parameters of the link.
 }nrf_ble_gatt_link_t;
 
 
@@ -160,6 +217,31 @@ void nrf_ble_gatt_on_ble_evt(nrf_ble_gatt_t * p_gatt, ble_evt_t * p_ble_evt);
  */
 uint16_t nrf_ble_gatt_eff_mtu_get(nrf_ble_gatt_t * p_gatt, uint16_t conn_handle);
 
+
+/**@brief Function for applying a link profile to a connection.
+ *
+ * @details The bulk profile first negotiates the maximum ATT_MTU, unless the ATT_MTU exchange
+ *          has already been done on the link. Then the connection parameters of the profile
+ *          are requested. The idle profile only requests its connection parameters. When the
+ *          procedure is finished, @ref NRF_BLE_GATT_EVT_LINK_PROFILE_DONE is sent with the
+ *          resulting ATT_MTU, data length and connection parameters.
+ *
+ * @note If the peer ignores the connection parameter update request, the event is not sent.
+ *       Calling the function again restarts the procedure.
+ *
+ * @param[in]   p_gatt      Pointer to the GATT structure.
+ * @param[in]   conn_handle Connection handle of the link.
+ * @param[in]   profile     Link profile to apply.
+ *
+ * @retval NRF_SUCCESS             If the procedure was started.
+ * @retval NRF_ERROR_NULL          If the pointer to @p p_gatt is NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If @p conn_handle or @p profile is not valid.
+ * @retval NRF_ERROR_NOT_SUPPORTED If the SoftDevice API version does not support the ATT_MTU exchange.
+ */
+ret_code_t nrf_ble_gatt_link_profile_set(nrf_ble_gatt_t            * p_gatt,
+                                         uint16_t                    conn_handle,
+                                         nrf_ble_gatt_link_profile_t profile);
+
 #ifdef __cplusplus
 }
 #endif
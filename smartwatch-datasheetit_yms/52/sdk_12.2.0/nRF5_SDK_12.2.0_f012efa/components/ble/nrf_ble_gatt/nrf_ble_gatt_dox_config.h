@@ -19,6 +19,57 @@
  */
 #define NRF_BLE_GATT_MAX_MTU_SIZE
 
+/** @brief Minimum connection interval of the bulk transfer profile, in 1.25 ms units
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_BLE_GATT_BULK_MIN_CONN_INTERVAL
+
+/** @brief Maximum connection interval of the bulk transfer profile, in 1.25 ms units
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_BLE_GATT_BULK_MAX_CONN_INTERVAL
+
+/** @brief Supervision timeout of the bulk transfer profile, in 10 ms units
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_BLE_GATT_BULK_CONN_SUP_TIMEOUT
+
+/** @brief Minimum connection interval of the idle profile, in 1.25 ms units
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_BLE_GATT_IDLE_MIN_CONN_INTERVAL
+
+/** @brief Maximum connection interval of the idle profile, in 1.25 ms units
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_BLE_GATT_IDLE_MAX_CONN_INTERVAL
+
+/** @brief Slave latency of the idle profile, in connection events
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_BLE_GATT_IDLE_SLAVE_LATENCY
+
+/** @brief Supervision timeout of the idle profile, in 10 ms units
+ *
+ * Must be larger than (1 + slave latency) * maximum connection interval * 2.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_BLE_GATT_IDLE_CONN_SUP_TIMEOUT
+
 
 
 /** @} */
@@ -20,6 +20,120 @@
 #define MODULE_INITIALIZED      (p_qwr->initialized == NRF_BLE_QWR_INITIALIZED)
 #include "sdk_macros.h"
 
+
+/**@brief Function for building the free list of a pool. */
+static void pool_init(nrf_ble_qwr_pool_t * p_pool)
+{
+    p_pool->p_free = NULL;
+
+    for (uint16_t i = p_pool->chunk_count; i > 0; i--)
+    {
+        p_pool->p_chunks[i - 1].p_next = p_pool->p_free;
+        p_pool->p_free                 = &p_pool->p_chunks[i - 1];
+    }
+
+    p_pool->free_count  = p_pool->chunk_count;
+    p_pool->initialized = true;
+}
+
+
+/**@brief Function for appending received data to the chunks of a written attribute.
+ *
+ * @param[in]   p_qwr        QWR structure.
+ * @param[in]   index        Index of the attribute in written_attr_handles.
+ * @param[in]   p_evt_write  Prepare write request.
+ *
+ * @retval NRF_SUCCESS       If the data was stored.
+ * @retval NRF_ERROR_NO_MEM  If the pool has no free chunk.
+ */
+static ret_code_t chunks_append(nrf_ble_qwr_t               * p_qwr,
+                                uint32_t                      index,
+                                ble_gatts_evt_write_t const * p_evt_write)
+{
+    uint8_t const * p_data = p_evt_write->data;
+    uint16_t        offset = p_evt_write->offset;
+    uint16_t        len    = p_evt_write->len;
+
+    while (len > 0)
+    {
+        nrf_ble_qwr_chunk_t * p_tail = p_qwr->p_chunks_tail[index];
+        uint16_t              copy_len;
+
+        // Continue the last chunk if the data follows it, otherwise start a new one.
+        if ((p_tail == NULL) ||
+            (p_tail->len == NRF_BLE_QWR_CONFIG_CHUNK_SIZE) ||
+            (p_tail->offset + p_tail->len != offset))
+        {
+            nrf_ble_qwr_chunk_t * p_chunk = p_qwr->p_pool->p_free;
+
+            if (p_chunk == NULL)
+            {
+                return NRF_ERROR_NO_MEM;
+            }
+            p_qwr->p_pool->p_free = p_chunk->p_next;
+            p_qwr->p_pool->free_count--;
+
+            p_chunk->p_next      = NULL;
+            p_chunk->attr_handle = p_evt_write->handle;
+            p_chunk->offset      = offset;
+            p_chunk->len         = 0;
+
+            if (p_tail == NULL)
+            {
+                p_qwr->p_chunks_head[index] = p_chunk;
+            }
+            else
+            {
+                p_tail->p_next = p_chunk;
+            }
+            p_qwr->p_chunks_tail[index] = p_chunk;
+            p_tail                      = p_chunk;
+        }
+
+        copy_len = MIN(len, NRF_BLE_QWR_CONFIG_CHUNK_SIZE - p_tail->len);
+        memcpy(&p_tail->data[p_tail->len], p_data, copy_len);
+
+        p_tail->len += copy_len;
+        offset      += copy_len;
+        p_data      += copy_len;
+        len         -= copy_len;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for ending the current queued write operation, returning its chunks to the pool.
+ *
+ * @param[in]   p_qwr        QWR structure.
+ */
+static void written_handles_clear(nrf_ble_qwr_t * p_qwr)
+{
+    if (p_qwr->p_pool != NULL)
+    {
+        for (uint32_t i = 0; i < p_qwr->nb_written_handles; i++)
+        {
+            nrf_ble_qwr_chunk_t * p_chunk = p_qwr->p_chunks_head[i];
+
+            while (p_chunk != NULL)
+            {
+                nrf_ble_qwr_chunk_t * p_next = p_chunk->p_next;
+
+                p_chunk->p_next       = p_qwr->p_pool->p_free;
+                p_qwr->p_pool->p_free = p_chunk;
+                p_qwr->p_pool->free_count++;
+
+                p_chunk = p_next;
+            }
+            p_qwr->p_chunks_head[i] = NULL;
+            p_qwr->p_chunks_tail[i] = NULL;
+        }
+    }
+
+    p_qwr->nb_written_handles = 0;
+}
+
+
 ret_code_t nrf_ble_qwr_init(nrf_ble_qwr_t            * p_qwr,
                             nrf_ble_qwr_init_t const * p_qwr_init)
 {
@@ -39,6 +153,15 @@ ret_code_t nrf_ble_qwr_init(nrf_ble_qwr_t            * p_qwr,
     p_qwr->mem_buffer                = p_qwr_init->mem_buffer;
     p_qwr->callback                  = p_qwr_init->callback;
     p_qwr->nb_written_handles        = 0;
+    p_qwr->p_pool                    = p_qwr_init->p_pool;
+
+    memset(p_qwr->p_chunks_head, 0, sizeof(p_qwr->p_chunks_head));
+    memset(p_qwr->p_chunks_tail, 0, sizeof(p_qwr->p_chunks_tail));
+
+    if ((p_qwr->p_pool != NULL) && !p_qwr->p_pool->initialized)
+    {
+        pool_init(p_qwr->p_pool);
+    }
     return NRF_SUCCESS;
 }
 
@@ -75,6 +198,34 @@ ret_code_t nrf_ble_qwr_value_get(nrf_ble_qwr_t * p_qwr,
     VERIFY_PARAM_NOT_NULL(p_len);
     VERIFY_MODULE_INITIALIZED();
 
+    if (p_qwr->p_pool != NULL)
+    {
+        uint16_t cur_len = 0;
+
+        for (uint32_t i = 0; i < p_qwr->nb_written_handles; i++)
+        {
+            if (p_qwr->written_attr_handles[i] != attr_handle)
+            {
+                continue;
+            }
+
+            for (nrf_ble_qwr_chunk_t const * p_chunk = p_qwr->p_chunks_head[i];
+                 p_chunk != NULL;
+                 p_chunk = p_chunk->p_next)
+            {
+                if (p_chunk->offset + p_chunk->len > *p_len)
+                {
+                    return NRF_ERROR_NO_MEM;
+                }
+                memcpy(p_mem + p_chunk->offset, p_chunk->data, p_chunk->len);
+                cur_len = MAX(cur_len, p_chunk->offset + p_chunk->len);
+            }
+        }
+
+        *p_len = cur_len;
+        return NRF_SUCCESS;
+    }
+
     uint16_t i          = 0;
     uint16_t handle     = BLE_GATT_HANDLE_INVALID;
     uint16_t val_len    = 0;
@@ -138,7 +289,9 @@ static void on_user_mem_request(nrf_ble_qwr_t          * p_qwr,
 {
     if (p_common_evt->conn_handle == p_qwr->conn_handle)
     {
-        uint32_t err_code = sd_ble_user_mem_reply(p_common_evt->conn_handle, &p_qwr->mem_buffer);
+        // With a pool, no memory is given, so that the prepare writes are passed to the module.
+        uint32_t err_code = sd_ble_user_mem_reply(p_common_evt->conn_handle,
+                                                  (p_qwr->p_pool != NULL) ? NULL : &p_qwr->mem_buffer);
         if (err_code == NRF_SUCCESS)
         {
             p_qwr->is_user_mem_reply_pending = false;
@@ -188,17 +341,26 @@ static void on_prepare_write(nrf_ble_qwr_t               * p_qwr,
             if (p_qwr->attr_handles[i] == p_evt_write->handle)
             {
                 auth_reply.params.write.gatt_status                      = BLE_GATT_STATUS_SUCCESS;
+                i                                                        = p_qwr->nb_written_handles;
                 p_qwr->written_attr_handles[p_qwr->nb_written_handles++] = p_evt_write->handle;
                 break;
             }
         }
     }
 
+    // With a pool, the data is not stored by the SoftDevice.
+    if ((p_qwr->p_pool != NULL) &&
+        (auth_reply.params.write.gatt_status == BLE_GATT_STATUS_SUCCESS) &&
+        (chunks_append(p_qwr, i, p_evt_write) != NRF_SUCCESS))
+    {
+        auth_reply.params.write.gatt_status = BLE_GATT_STATUS_ATTERR_PREPARE_QUEUE_FULL;
+    }
+
     err_code = sd_ble_gatts_rw_authorize_reply(p_qwr->conn_handle, &auth_reply);
     if (err_code != NRF_SUCCESS)
     {
         // Cancel the current operation.
-        p_qwr->nb_written_handles = 0;
+        written_handles_clear(p_qwr);
 
         // Report error to application.
         p_qwr->error_handler(err_code);
@@ -241,6 +403,7 @@ static void on_execute_write(nrf_ble_qwr_t               * p_qwr,
 
         evt.evt_type    = NRF_BLE_QWR_EVT_AUTH_REQUEST;
         evt.attr_handle = p_qwr->written_attr_handles[i];
+        evt.p_chunks    = p_qwr->p_chunks_head[i];
         ret_val         = p_qwr->callback(p_qwr, &evt);
         if (ret_val != BLE_GATT_STATUS_SUCCESS)
         {
@@ -263,6 +426,7 @@ static void on_execute_write(nrf_ble_qwr_t               * p_qwr,
             nrf_ble_qwr_evt_t evt;
             evt.evt_type    = NRF_BLE_QWR_EVT_EXECUTE_WRITE;
             evt.attr_handle = p_qwr->written_attr_handles[i];
+            evt.p_chunks    = p_qwr->p_chunks_head[i];
             /*lint -e534 -save "Ignoring return value of function" */
             p_qwr->callback(p_qwr, &evt);
             /*lint -restore*/
@@ -270,7 +434,7 @@ static void on_execute_write(nrf_ble_qwr_t               * p_qwr,
             auth_reply.params.write.gatt_status = BLE_GATT_STATUS_SUCCESS;
         }
     }
-    p_qwr->nb_written_handles = 0;
+    written_handles_clear(p_qwr);
 }
 
 
@@ -295,7 +459,7 @@ static void on_cancel_write(nrf_ble_qwr_t               * p_qwr,
         // Report error to application.
         p_qwr->error_handler(err_code);
     }
-    p_qwr->nb_written_handles = 0;
+    written_handles_clear(p_qwr);
 }
 
 
@@ -364,8 +528,8 @@ void nrf_ble_qwr_on_ble_evt(nrf_ble_qwr_t * p_qwr,
         case BLE_GAP_EVT_DISCONNECTED:
             if (p_ble_evt->evt.gap_evt.conn_handle == p_qwr->conn_handle)
             {
-                p_qwr->conn_handle        = BLE_CONN_HANDLE_INVALID;
-                p_qwr->nb_written_handles = 0;
+                p_qwr->conn_handle = BLE_CONN_HANDLE_INVALID;
+                written_handles_clear(p_qwr);
             }
             break; // BLE_GAP_EVT_DISCONNECTED
 
@@ -20,6 +20,18 @@
  * @details This module handles prepare write, execute write, and cancel write
  * commands. It also manages memory requests related to these operations.
  *
+ * The received data is stored in one of two ways:
+ * - In a memory buffer given to the SoftDevice on each memory request. The SoftDevice stores the
+ *   prepared writes in it and writes the attribute values on execute. The buffer must hold the
+ *   largest queued write.
+ * - In chunks of @ref NRF_BLE_QWR_CONFIG_CHUNK_SIZE bytes taken from a pool, defined with
+ *   @ref NRF_BLE_QWR_POOL_DEF. No memory is given to the SoftDevice, so it passes each prepare
+ *   write to the module, which appends it to the chunk chain of the attribute. Contiguous
+ *   writes fill the chunks. On execute, the events carry the chain of each attribute as a
+ *   scatter list, and the application applies the data (with @ref sd_ble_gatts_value_set, or
+ *   directly to flash for a large upload) without a linear copy. The chunks are returned to the
+ *   pool after the execute or cancel, so a pool can be shared by the instances of several links.
+ *
  * @note     The application must propagate BLE stack events to this module by calling
  *           @ref nrf_ble_qwr_on_ble_evt().
  */
@@ -41,6 +53,14 @@ extern "C" {
 #define NRF_BLE_QWR_ATTR_LIST_SIZE    10        //!< Maximum number of attribute handles that can be registered. This number must be adjusted according to the number of attributes for which Queued Writes will be enabled.
 #endif
 
+/** @brief Number of data bytes in a chunk of a pool.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef NRF_BLE_QWR_CONFIG_CHUNK_SIZE
+#define NRF_BLE_QWR_CONFIG_CHUNK_SIZE 64
+#endif
+
 #define NRF_BLE_QWR_REJ_REQUEST_ERR_CODE BLE_GATT_STATUS_ATTERR_APP_BEGIN + 0                  //!< Error code used by the module to reject prepare write requests on non-registered attributes.
 
 /**@brief Queued Writes module event types. */
@@ -51,11 +71,49 @@ typedef enum
 } nrf_ble_qwr_evt_type_t;
 
 
+/**@brief Chunk of received data. */
+typedef struct nrf_ble_qwr_chunk_s
+{
+    struct nrf_ble_qwr_chunk_s * p_next;                              //!< Next chunk of the attribute, or NULL.
+    uint16_t                     attr_handle;                         //!< Handle of the attribute.
+    uint16_t                     offset;                              //!< Offset of the data in the attribute value.
+    uint16_t                     len;                                 //!< Length of the data.
+    uint8_t                      data[NRF_BLE_QWR_CONFIG_CHUNK_SIZE]; //!< Data.
+} nrf_ble_qwr_chunk_t;
+
+
+/**@brief Pool of chunks. Use @ref NRF_BLE_QWR_POOL_DEF to define it. */
+typedef struct
+{
+    nrf_ble_qwr_chunk_t * p_chunks;             //!< Chunks.
+    uint16_t              chunk_count;          //!< Number of chunks.
+    uint16_t              free_count;           //!< Number of free chunks.
+    nrf_ble_qwr_chunk_t * p_free;               //!< List of free chunks.
+    bool                  initialized;          //!< Flag that indicates whether the free list has been built.
+} nrf_ble_qwr_pool_t;
+
+
+/**@brief Macro for defining a pool of chunks.
+ *
+ * @param[in] NAME        Name of the pool.
+ * @param[in] CHUNK_COUNT Number of chunks. A queued write of n bytes on one attribute uses about
+ *                        n / @ref NRF_BLE_QWR_CONFIG_CHUNK_SIZE chunks.
+ */
+#define NRF_BLE_QWR_POOL_DEF(NAME, CHUNK_COUNT)         \
+    static nrf_ble_qwr_chunk_t NAME##_chunks[CHUNK_COUNT];  \
+    static nrf_ble_qwr_pool_t  NAME =                       \
+    {                                                       \
+        .p_chunks    = NAME##_chunks,                       \
+        .chunk_count = (CHUNK_COUNT),                       \
+    }
+
+
 /**@brief Queued Writes module events. */
 typedef struct
 {
-    nrf_ble_qwr_evt_type_t evt_type;            //!< Type of the event.
-    uint16_t               attr_handle;         //!< Handle of the attribute to which the event relates.
+    nrf_ble_qwr_evt_type_t      evt_type;       //!< Type of the event.
+    uint16_t                    attr_handle;    //!< Handle of the attribute to which the event relates.
+    nrf_ble_qwr_chunk_t const * p_chunks;       //!< Data received for the attribute, in chunks linked in the order of arrival. NULL if the module uses a memory buffer.
 } nrf_ble_qwr_evt_t;
 
 
@@ -85,6 +143,9 @@ typedef struct nrf_ble_qwr_t
     bool                          is_user_mem_reply_pending;                                    //!< Flag that indicates whether a mem_reply is pending (because a previous attempt returned busy).
     uint16_t                      conn_handle;                                                  //!< Connection handle.
     nrf_ble_qwr_evt_handler_t     callback;                                                     //!< Event handler function that is called for events concerning the handles of all registered attributes.
+    nrf_ble_qwr_pool_t          * p_pool;                                                       //!< Pool of chunks, or NULL if the memory buffer is used.
+    nrf_ble_qwr_chunk_t         * p_chunks_head[NRF_BLE_QWR_ATTR_LIST_SIZE];                    //!< First chunk of each written attribute, in the order of written_attr_handles.
+    nrf_ble_qwr_chunk_t         * p_chunks_tail[NRF_BLE_QWR_ATTR_LIST_SIZE];                    //!< Last chunk of each written attribute.
 } nrf_ble_qwr_t;
 
 
@@ -94,8 +155,9 @@ typedef struct nrf_ble_qwr_t
 typedef struct
 {
     ble_srv_error_handler_t   error_handler;        //!< Error handler.
-    ble_user_mem_block_t      mem_buffer;           //!< Memory buffer that is provided to the SoftDevice on an ON_USER_MEM_REQUEST event.
+    ble_user_mem_block_t      mem_buffer;           //!< Memory buffer that is provided to the SoftDevice on an ON_USER_MEM_REQUEST event. Not used if p_pool is set.
     nrf_ble_qwr_evt_handler_t callback;             //!< Event handler function that is called for events concerning the handles of all registered attributes.
+    nrf_ble_qwr_pool_t      * p_pool;               //!< Pool of chunks for the received data, or NULL to use mem_buffer. Can be shared by several instances.
 } nrf_ble_qwr_init_t;
 
 
@@ -148,6 +210,7 @@ void nrf_ble_qwr_on_ble_evt(nrf_ble_qwr_t * p_qwr, ble_evt_t * p_ble_evt);
  *
  * @details Call this function after receiving an @ref NRF_BLE_QWR_EVT_AUTH_REQUEST
  * event to retrieve a linear copy of the data that was received for the given attribute.
+ * With a pool, the chunks of the event can be used instead, without the copy.
  *
  * @param[in]     p_qwr       Queued Writes structure.
  * @param[in]     attr_handle Handle of the attribute.
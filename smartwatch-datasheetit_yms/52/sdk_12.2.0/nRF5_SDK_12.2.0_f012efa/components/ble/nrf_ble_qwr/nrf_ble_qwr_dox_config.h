@@ -12,5 +12,11 @@
  */
 #define NRF_BLE_QWR_ENABLED
 
+/** @brief Number of data bytes in a chunk of a pool
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_BLE_QWR_CONFIG_CHUNK_SIZE
+
 
 /** @} */
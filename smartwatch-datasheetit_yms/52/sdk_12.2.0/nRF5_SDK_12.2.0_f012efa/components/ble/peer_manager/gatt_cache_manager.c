@@ -21,8 +21,18 @@
 #include "id_manager.h"
 #include "security_dispatcher.h"
 #include "gatts_cache_manager.h"
+#if NRF_MODULE_ENABLED(PM_LOCAL_DB_WRITE_BACK)
+#include "app_timer.h"
+#endif
 
 
+#if NRF_MODULE_ENABLED(PM_LOCAL_DB_WRITE_BACK)
+// The time without CCCD writes after which the CCCD changes are stored in flash, in app_timer ticks.
+#ifndef PM_LOCAL_DB_WRITE_BACK_DELAY
+#define PM_LOCAL_DB_WRITE_BACK_DELAY    APP_TIMER_TICKS(2000, 0)
+#endif
+#endif
+
 // The number of registered event handlers.
 #define GCM_EVENT_HANDLERS_CNT      (sizeof(m_evt_handlers) / sizeof(m_evt_handlers[0]))
 
@@ -42,8 +52,14 @@ static ble_conn_state_user_flag_id_t  m_flag_local_db_apply_pending;  /**< Flag
 static ble_conn_state_user_flag_id_t  m_flag_service_changed_pending; /**< Flag ID for flag collection to keep track of which connections need to be sent a service changed indication. */
 static ble_conn_state_user_flag_id_t  m_flag_service_changed_sent;    /**< Flag ID for flag collection to keep track of which connections have been sent a service changed indication and are waiting for a handle value confirmation. */
 
+#if NRF_MODULE_ENABLED(PM_LOCAL_DB_WRITE_BACK)
+static ble_conn_state_user_flag_id_t  m_flag_local_db_dirty;          /**< Flag ID for flag collection to keep track of which connections have CCCD changes that have not been stored yet. */
+APP_TIMER_DEF(m_write_back_timer);
+#endif
+
 
 static void service_changed_pending_flags_check(void);
+static void update_pending_flags_check(void);
 
 
 /**@brief Function for resetting the module variable(s) of the GSCM module.
@@ -204,6 +220,95 @@ static void local_db_update_in_evt(uint16_t conn_handle)
 }
 
 
+#if NRF_MODULE_ENABLED(PM_LOCAL_DB_WRITE_BACK)
+/**@brief Function for storing the CCCD changes of a connection, if it has any.
+ *
+ * @param[in]  conn_handle  The connection to store the changes of.
+ */
+static void local_db_write_back(uint16_t conn_handle)
+{
+    if (ble_conn_state_user_flag_get(conn_handle, m_flag_local_db_dirty))
+    {
+        ble_conn_state_user_flag_set(conn_handle, m_flag_local_db_dirty, false);
+        local_db_update_in_evt(conn_handle);
+    }
+}
+
+
+/**@brief Function for handling the timeout of the write-back timer.
+ *
+ * @details All CCCD changes that have not been stored yet are stored.
+ *
+ * @param[in]  p_context  Unused.
+ */
+static void write_back_timeout_handler(void * p_context)
+{
+    sdk_mapped_flags_key_list_t conn_handle_list = ble_conn_state_conn_handles();
+
+    UNUSED_PARAMETER(p_context);
+
+    for (uint32_t i = 0; i < conn_handle_list.len; i++)
+    {
+        local_db_write_back(conn_handle_list.flag_keys[i]);
+    }
+
+    update_pending_flags_check();
+}
+
+
+/**@brief Function for marking the CCCDs of a connection as changed.
+ *
+ * @details The write-back timer is restarted, so the changes are stored when no CCCD has been
+ *          written for @ref PM_LOCAL_DB_WRITE_BACK_DELAY, or when the connection is disconnected.
+ *          A peer that enables one characteristic after another then causes one write to flash.
+ *
+ * @param[in]  conn_handle  The connection on which CCCDs were written.
+ */
+static void local_db_mark_dirty(uint16_t conn_handle)
+{
+    ble_conn_state_user_flag_set(conn_handle, m_flag_local_db_dirty, true);
+
+    (void)app_timer_stop(m_write_back_timer);
+    if (app_timer_start(m_write_back_timer, PM_LOCAL_DB_WRITE_BACK_DELAY, NULL) != NRF_SUCCESS)
+    {
+        // Store the changes at once if they cannot be deferred.
+        local_db_write_back(conn_handle);
+    }
+}
+
+
+/**@brief Function for storing the CCCD changes of a connection that is being disconnected.
+ *
+ * @details The system attributes can only be read from the SoftDevice until the disconnected
+ *          event has been handled, and a store that is busy would be reattempted too late. So
+ *          they are copied to RAM, and stored from there. The copy is applied if the peer
+ *          reconnects before it is in flash.
+ *
+ * @param[in]  conn_handle  The connection that is being disconnected.
+ */
+static void local_db_write_back_on_disconnect(uint16_t conn_handle)
+{
+    if (   !ble_conn_state_user_flag_get(conn_handle, m_flag_local_db_dirty)
+        && !ble_conn_state_user_flag_get(conn_handle, m_flag_local_db_update_pending))
+    {
+        return;
+    }
+
+    if (gscm_local_db_cache_capture(conn_handle) == NRF_SUCCESS)
+    {
+        ble_conn_state_user_flag_set(conn_handle, m_flag_local_db_dirty, false);
+        ble_conn_state_user_flag_set(conn_handle, m_flag_local_db_update_pending, false);
+    }
+    else
+    {
+        // Store the changes directly from the SoftDevice.
+        ble_conn_state_user_flag_set(conn_handle, m_flag_local_db_dirty, true);
+        local_db_write_back(conn_handle);
+    }
+}
+#endif // NRF_MODULE_ENABLED(PM_LOCAL_DB_WRITE_BACK)
+
+
 /**@brief Function for sending a service changed indication in an event context, where no return
  *        code can be given.
  *
@@ -368,6 +473,22 @@ ret_code_t gcm_init()
         return NRF_ERROR_INTERNAL;
     }
 
+#if NRF_MODULE_ENABLED(PM_LOCAL_DB_WRITE_BACK)
+    m_flag_local_db_dirty = ble_conn_state_user_flag_acquire();
+
+    if (m_flag_local_db_dirty == BLE_CONN_STATE_USER_FLAG_INVALID)
+    {
+        return NRF_ERROR_INTERNAL;
+    }
+
+    if (app_timer_create(&m_write_back_timer,
+                         APP_TIMER_MODE_SINGLE_SHOT,
+                         write_back_timeout_handler) != NRF_SUCCESS)
+    {
+        return NRF_ERROR_INTERNAL;
+    }
+#endif
+
     m_module_initialized = true;
 
     return NRF_SUCCESS;
@@ -477,9 +598,20 @@ void gcm_ble_evt_handler(ble_evt_t * p_ble_evt)
         case BLE_GATTS_EVT_WRITE:
             if (cccd_written(&p_ble_evt->evt.gatts_evt.params.write))
             {
+#if NRF_MODULE_ENABLED(PM_LOCAL_DB_WRITE_BACK)
+                local_db_mark_dirty(p_ble_evt->evt.gatts_evt.conn_handle);
+#else
                 local_db_update_in_evt(p_ble_evt->evt.gatts_evt.conn_handle);
+#endif
             }
             break;
+
+#if NRF_MODULE_ENABLED(PM_LOCAL_DB_WRITE_BACK)
+        case BLE_GAP_EVT_DISCONNECTED:
+            // The system attributes of the connection can still be read from the SoftDevice.
+            local_db_write_back_on_disconnect(p_ble_evt->evt.gap_evt.conn_handle);
+            break;
+#endif
     }
 
     apply_pending_flags_check();
@@ -495,6 +627,10 @@ ret_code_t gcm_local_db_cache_update(uint16_t conn_handle)
     ret_code_t err_code = gscm_local_db_cache_update(conn_handle);
     bool set_procedure_as_pending = false;
 
+#if NRF_MODULE_ENABLED(PM_LOCAL_DB_WRITE_BACK)
+    ble_conn_state_user_flag_set(conn_handle, m_flag_local_db_dirty, false);
+#endif
+
     if (err_code == NRF_ERROR_BUSY)
     {
         set_procedure_as_pending = true;
@@ -30,6 +30,18 @@
 // The number of registered event handlers.
 #define GSCM_EVENT_HANDLERS_CNT         (sizeof(m_evt_handler) / sizeof(m_evt_handler[0]))
 
+#if NRF_MODULE_ENABLED(PM_LOCAL_DB_WRITE_BACK)
+// The number of peers whose system attributes can be held in RAM until they are stored.
+#ifndef PM_LOCAL_DB_MIRROR_COUNT
+#define PM_LOCAL_DB_MIRROR_COUNT        2
+#endif
+
+// The largest system attributes that can be held in RAM, in bytes.
+#ifndef PM_LOCAL_DB_MIRROR_SIZE
+#define PM_LOCAL_DB_MIRROR_SIZE         64
+#endif
+#endif
+
 
 // GATTS Cache Manager event handler in Peer Manager.
 extern void gcm_gscm_evt_handler(gscm_evt_t const * p_event);
@@ -44,6 +56,35 @@ static gscm_evt_handler_t m_evt_handler[] =
 static bool               m_module_initialized;
 static pm_peer_id_t       m_current_sc_store_peer_id;
 
+#if NRF_MODULE_ENABLED(PM_LOCAL_DB_WRITE_BACK)
+/**@brief States of a RAM copy of the system attributes of a peer.
+ */
+typedef enum
+{
+    MIRROR_FREE,       /**< Not in use. */
+    MIRROR_UNSENT,     /**< The store has not been started yet. */
+    MIRROR_IN_FLIGHT,  /**< The store has been started, and the data is read from the copy. */
+} mirror_state_t;
+
+/**@brief RAM copy of the system attributes of a peer, from when the connection was disconnected
+ *        until they are in flash.
+ */
+typedef struct
+{
+    pm_peer_id_t     peer_id;      /**< The peer the system attributes belong to. */
+    mirror_state_t   state;        /**< The state of the copy. */
+    bool             superseded;   /**< Newer system attributes of the peer are being stored, so this copy must not be applied. */
+    pm_store_token_t store_token;  /**< The token of the store, in @ref MIRROR_IN_FLIGHT. */
+    union
+    {
+        pm_peer_data_local_gatt_db_t local_db;
+        uint32_t                     words[BYTES_TO_WORDS(PM_LOCAL_DB_LEN_OVERHEAD_BYTES + PM_LOCAL_DB_MIRROR_SIZE)];
+    } db;                          /**< The system attributes, in the stored format. */
+} local_db_mirror_t;
+
+static local_db_mirror_t  m_mirrors[PM_LOCAL_DB_MIRROR_COUNT];
+#endif
+
 
 /**@brief Function for resetting the module variable(s) of the GSCM module.
  */
@@ -51,6 +92,10 @@ static void internal_state_reset()
 {
     m_module_initialized       = false;
     m_current_sc_store_peer_id = PM_PEER_ID_INVALID;
+
+#if NRF_MODULE_ENABLED(PM_LOCAL_DB_WRITE_BACK)
+    memset(m_mirrors, 0, sizeof(m_mirrors));
+#endif
 }
 
 
@@ -96,6 +141,101 @@ static void service_changed_pending_set(void)
 //lint -restore
 
 
+#if NRF_MODULE_ENABLED(PM_LOCAL_DB_WRITE_BACK)
+/**@brief Function for finding the RAM copy of the system attributes of a peer.
+ *
+ * @param[in]  peer_id  The peer.
+ *
+ * @return The copy, or NULL if the peer has none.
+ */
+static local_db_mirror_t * mirror_find(pm_peer_id_t peer_id)
+{
+    for (uint32_t i = 0; i < PM_LOCAL_DB_MIRROR_COUNT; i++)
+    {
+        if ((m_mirrors[i].state != MIRROR_FREE) && (m_mirrors[i].peer_id == peer_id))
+        {
+            return &m_mirrors[i];
+        }
+    }
+    return NULL;
+}
+
+
+/**@brief Function for starting the store of a RAM copy of system attributes.
+ *
+ * @details The copy stays @ref MIRROR_UNSENT if the store cannot be started now. It is then
+ *          reattempted after the next Peer Database event.
+ *
+ * @param[in]  p_mirror  The copy.
+ */
+static void mirror_store(local_db_mirror_t * p_mirror)
+{
+    ret_code_t err_code;
+
+    //lint -save -e65 -e64
+    pm_peer_data_const_t peer_data =
+    {
+        .data_id         = PM_PEER_DATA_ID_GATT_LOCAL,
+        .length_words    = BYTES_TO_WORDS(PM_LOCAL_DB_LEN_OVERHEAD_BYTES + p_mirror->db.local_db.len),
+        .p_local_gatt_db = &p_mirror->db.local_db,
+    };
+    //lint -restore
+
+    err_code = pdb_raw_store(p_mirror->peer_id, &peer_data, &p_mirror->store_token);
+    if (err_code == NRF_SUCCESS)
+    {
+        p_mirror->state = MIRROR_IN_FLIGHT;
+    }
+    else if ((err_code != NRF_ERROR_BUSY) && (err_code != NRF_ERROR_STORAGE_FULL))
+    {
+        // The peer has been deleted, or the data cannot be stored.
+        p_mirror->state = MIRROR_FREE;
+    }
+}
+
+
+/**@brief Function for handling events from the Peer Database module that concern the RAM copies
+ *        of system attributes.
+ *
+ * @param[in]  p_event  The event.
+ */
+static void mirrors_pdb_evt_handle(pdb_evt_t const * p_event)
+{
+    if (p_event->data_id == PM_PEER_DATA_ID_GATT_LOCAL)
+    {
+        pm_store_token_t store_token = PM_STORE_TOKEN_INVALID;
+
+        if (p_event->evt_id == PDB_EVT_RAW_STORED)
+        {
+            store_token = p_event->params.raw_stored_evt.store_token;
+        }
+        else if (p_event->evt_id == PDB_EVT_RAW_STORE_FAILED)
+        {
+            store_token = p_event->params.error_raw_store_evt.store_token;
+        }
+
+        for (uint32_t i = 0; i < PM_LOCAL_DB_MIRROR_COUNT; i++)
+        {
+            if ((store_token != PM_STORE_TOKEN_INVALID)      &&
+                (m_mirrors[i].state == MIRROR_IN_FLIGHT)     &&
+                (m_mirrors[i].store_token == store_token))
+            {
+                // The data is in flash, or will not be.
+                m_mirrors[i].state = MIRROR_FREE;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < PM_LOCAL_DB_MIRROR_COUNT; i++)
+    {
+        if (m_mirrors[i].state == MIRROR_UNSENT)
+        {
+            mirror_store(&m_mirrors[i]);
+        }
+    }
+}
+#endif // NRF_MODULE_ENABLED(PM_LOCAL_DB_WRITE_BACK)
+
 
 /**@brief Event handler for events from the Peer Database module.
  *        This function is extern in Peer Database.
@@ -131,6 +271,10 @@ void gscm_pdb_evt_handler(pdb_evt_t const * p_event)
     {
         service_changed_pending_set();
     }
+
+#if NRF_MODULE_ENABLED(PM_LOCAL_DB_WRITE_BACK)
+    mirrors_pdb_evt_handle(p_event);
+#endif
 }
 
 
@@ -158,6 +302,23 @@ ret_code_t gscm_local_db_cache_update(uint16_t conn_handle)
     }
     else
     {
+#if NRF_MODULE_ENABLED(PM_LOCAL_DB_WRITE_BACK)
+        local_db_mirror_t * p_mirror = mirror_find(peer_id);
+
+        // The values read from the SoftDevice are newer than the ones in RAM.
+        if (p_mirror != NULL)
+        {
+            if (p_mirror->state == MIRROR_UNSENT)
+            {
+                p_mirror->state = MIRROR_FREE;
+            }
+            else
+            {
+                p_mirror->superseded = true;
+            }
+        }
+#endif
+
         pm_peer_data_t peer_data;
         uint16_t       n_bufs = 1;
         bool           retry_with_bigger_buffer = false;
@@ -226,6 +387,18 @@ ret_code_t gscm_local_db_cache_apply(uint16_t conn_handle)
     if (peer_id != PM_PEER_ID_INVALID)
     {
         err_code = pdb_peer_data_ptr_get(peer_id, PM_PEER_DATA_ID_GATT_LOCAL, &peer_data);
+
+#if NRF_MODULE_ENABLED(PM_LOCAL_DB_WRITE_BACK)
+        local_db_mirror_t * p_mirror = mirror_find(peer_id);
+
+        // The values in RAM have not reached flash yet.
+        if ((p_mirror != NULL) && !p_mirror->superseded)
+        {
+            peer_data.p_local_gatt_db = &p_mirror->db.local_db;
+            err_code                  = NRF_SUCCESS;
+        }
+#endif
+
         if (err_code == NRF_SUCCESS)
         {
             pm_peer_data_local_gatt_db_t const * p_local_gatt_db;
@@ -281,6 +454,70 @@ ret_code_t gscm_local_db_cache_apply(uint16_t conn_handle)
 }
 
 
+#if NRF_MODULE_ENABLED(PM_LOCAL_DB_WRITE_BACK)
+ret_code_t gscm_local_db_cache_capture(uint16_t conn_handle)
+{
+    NRF_PM_DEBUG_CHECK(m_module_initialized);
+
+    pm_peer_id_t        peer_id  = im_peer_id_get_by_conn_handle(conn_handle);
+    local_db_mirror_t * p_mirror = NULL;
+    ret_code_t          err_code;
+
+    if (peer_id == PM_PEER_ID_INVALID)
+    {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+
+    p_mirror = mirror_find(peer_id);
+    if ((p_mirror != NULL) && (p_mirror->state == MIRROR_IN_FLIGHT))
+    {
+        // The copy is being written to flash, it cannot be changed.
+        return NRF_ERROR_BUSY;
+    }
+
+    for (uint32_t i = 0; (p_mirror == NULL) && (i < PM_LOCAL_DB_MIRROR_COUNT); i++)
+    {
+        if (m_mirrors[i].state == MIRROR_FREE)
+        {
+            p_mirror = &m_mirrors[i];
+        }
+    }
+
+    if (p_mirror == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    p_mirror->db.local_db.flags = SYS_ATTR_BOTH;
+    p_mirror->db.local_db.len   = PM_LOCAL_DB_MIRROR_SIZE;
+
+    err_code = sd_ble_gatts_sys_attr_get(conn_handle,
+                                         &p_mirror->db.local_db.data[0],
+                                         &p_mirror->db.local_db.len,
+                                         p_mirror->db.local_db.flags);
+    if (err_code == NRF_ERROR_NOT_FOUND)
+    {
+        // There are no sys attributes in the GATT db, so nothing needs to be stored.
+        p_mirror->state = MIRROR_FREE;
+        return NRF_SUCCESS;
+    }
+    else if (err_code != NRF_SUCCESS)
+    {
+        p_mirror->state = MIRROR_FREE;
+        return err_code;
+    }
+
+    p_mirror->peer_id    = peer_id;
+    p_mirror->state      = MIRROR_UNSENT;
+    p_mirror->superseded = false;
+
+    mirror_store(p_mirror);
+
+    return NRF_SUCCESS;
+}
+#endif // NRF_MODULE_ENABLED(PM_LOCAL_DB_WRITE_BACK)
+
+
 ret_code_t gscm_local_db_cache_set(pm_peer_id_t peer_id, pm_peer_data_local_gatt_db_t * p_local_db)
 {
     NRF_PM_DEBUG_CHECK(m_module_initialized);
@@ -120,6 +120,28 @@ ret_code_t gscm_local_db_cache_update(uint16_t conn_handle);
 ret_code_t gscm_local_db_cache_apply(uint16_t conn_handle);
 
 
+/**@brief Function for copying the local GATT database data of a connection to RAM, and storing it
+ *        persistently from there.
+ *
+ * @details The values are retrieved from the SoftDevice at once, so this can be called when the
+ *          connection is being disconnected. Until the values are stored,
+ *          @ref gscm_local_db_cache_apply uses the copy in RAM.
+ *
+ * @note Only available if PM_LOCAL_DB_WRITE_BACK_ENABLED is set.
+ *
+ * @param[in]  conn_handle  Connection handle to copy the values of.
+ *
+ * @retval NRF_SUCCESS                    The values were copied, or there were none.
+ * @retval BLE_ERROR_INVALID_CONN_HANDLE  conn_handle does not refer to a connection with a bonded
+ *                                        peer.
+ * @retval NRF_ERROR_BUSY                 Earlier values of the peer are being stored from RAM.
+ * @retval NRF_ERROR_NO_MEM               No room in RAM for the values.
+ * @retval NRF_ERROR_DATA_SIZE            The values are larger than the room in RAM for one peer.
+ * @return An unexpected return value from @ref sd_ble_gatts_sys_attr_get.
+ */
+ret_code_t gscm_local_db_cache_capture(uint16_t conn_handle);
+
+
 /**@brief Function for setting new values in the local database cache.
  *
  * @note If the peer is connected, the values will also be applied immediately to the connection.
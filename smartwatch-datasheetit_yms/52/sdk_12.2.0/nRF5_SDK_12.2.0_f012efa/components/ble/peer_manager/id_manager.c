@@ -29,6 +29,21 @@
 #define IM_ADDR_CLEARTEXT_LENGTH        (3)
 #define IM_ADDR_CIPHERTEXT_LENGTH       (3)
 
+#if NRF_MODULE_ENABLED(PM_HOT_PEERS)
+#ifndef PM_HOT_PEERS_COUNT
+#define PM_HOT_PEERS_COUNT              (2)
+#endif
+#endif
+
+#if NRF_MODULE_ENABLED(PM_IRK_TABLE)
+#ifndef PM_IRK_TABLE_SIZE
+#define PM_IRK_TABLE_SIZE               (8)
+#endif
+#ifndef PM_IRK_TABLE_RPA_CACHE_SIZE
+#define PM_IRK_TABLE_RPA_CACHE_SIZE     (4)
+#endif
+#endif
+
 // The number of registered event handlers.
 #define IM_EVENT_HANDLERS_CNT           (sizeof(m_evt_handlers) / sizeof(m_evt_handlers[0]))
 
@@ -64,6 +79,47 @@ static pm_peer_id_t                     m_wlisted_peers[BLE_GAP_WHITELIST_ADDR_M
     static ble_gap_addr_t               m_current_id_addr;
 #endif
 
+#if NRF_MODULE_ENABLED(PM_HOT_PEERS)
+/**@brief A recently used peer, whose bonding data is kept in RAM so that it can be identified
+ *        without searching flash.
+ */
+typedef struct
+{
+    pm_peer_id_t           peer_id;      /**< The peer, or PM_PEER_ID_INVALID if the entry is unused. */
+    uint32_t               last_used;    /**< The value of m_hot_peers_clock when the peer was last used. */
+    pm_peer_data_bonding_t bonding_data; /**< Copy of the bonding data of the peer. */
+} im_hot_peer_t;
+
+static im_hot_peer_t                    m_hot_peers[PM_HOT_PEERS_COUNT];
+static uint32_t                         m_hot_peers_clock;
+#endif
+
+#if NRF_MODULE_ENABLED(PM_IRK_TABLE)
+/**@brief The IRK of a bonded peer, in the byte order used by the ECB. */
+typedef struct
+{
+    pm_peer_id_t peer_id;                     /**< The peer. */
+    uint8_t      ecb_key[SOC_ECB_KEY_LENGTH]; /**< The IRK of the peer, reversed. */
+} im_irk_entry_t;
+
+/**@brief A resolvable private address that has been resolved. */
+typedef struct
+{
+    pm_peer_id_t peer_id;                     /**< The peer, or PM_PEER_ID_INVALID if the entry is unused. */
+    uint8_t      addr[BLE_GAP_ADDR_LEN];      /**< The address. */
+} im_rpa_cache_entry_t;
+
+static im_irk_entry_t                   m_irk_table[PM_IRK_TABLE_SIZE];
+static uint8_t                          m_irk_table_len;
+static bool                             m_irk_table_valid;     /**< Whether m_irk_table matches the bonding data in flash. */
+static bool                             m_irk_table_complete;  /**< Whether all valid IRKs in flash fit in m_irk_table. */
+static im_rpa_cache_entry_t             m_rpa_cache[PM_IRK_TABLE_RPA_CACHE_SIZE];
+static uint8_t                          m_rpa_cache_next;      /**< The entry of m_rpa_cache to replace next. */
+
+static pm_peer_id_t irk_table_resolve(ble_gap_addr_t const * p_addr);
+static void         irk_table_invalidate(pm_peer_id_t peer_id);
+#endif
+
 
 static void internal_state_reset()
 {
@@ -73,6 +129,23 @@ static void internal_state_reset()
     {
         m_connections[i].conn_handle = BLE_CONN_HANDLE_INVALID;
     }
+
+#if NRF_MODULE_ENABLED(PM_HOT_PEERS)
+    for (uint32_t i = 0; i < PM_HOT_PEERS_COUNT; i++)
+    {
+        m_hot_peers[i].peer_id = PM_PEER_ID_INVALID;
+    }
+    m_hot_peers_clock = 0;
+#endif
+
+#if NRF_MODULE_ENABLED(PM_IRK_TABLE)
+    for (uint32_t i = 0; i < PM_IRK_TABLE_RPA_CACHE_SIZE; i++)
+    {
+        m_rpa_cache[i].peer_id = PM_PEER_ID_INVALID;
+    }
+    m_rpa_cache_next  = 0;
+    m_irk_table_valid = false;
+#endif
 }
 
 
@@ -222,6 +295,122 @@ bool addr_compare(ble_gap_addr_t const * p_addr1, ble_gap_addr_t const * p_addr2
 }
 
 
+#if NRF_MODULE_ENABLED(PM_HOT_PEERS)
+/**@brief Function for adding a peer to the hot peers, or refreshing its bonding data.
+ *
+ * @details The least recently used peer is replaced if the table is full.
+ *
+ * @param[in]  peer_id         The peer.
+ * @param[in]  p_bonding_data  The bonding data of the peer.
+ */
+static void hot_peer_put(pm_peer_id_t peer_id, pm_peer_data_bonding_t const * p_bonding_data)
+{
+    im_hot_peer_t * p_hot_peer = &m_hot_peers[0];
+
+    for (uint32_t i = 0; i < PM_HOT_PEERS_COUNT; i++)
+    {
+        if (m_hot_peers[i].peer_id == peer_id)
+        {
+            p_hot_peer = &m_hot_peers[i];
+            break;
+        }
+        if (p_hot_peer->peer_id == PM_PEER_ID_INVALID)
+        {
+            // Keep the first unused entry, unless the peer is found.
+            continue;
+        }
+        if (   (m_hot_peers[i].peer_id == PM_PEER_ID_INVALID)
+            || (m_hot_peers[i].last_used < p_hot_peer->last_used))
+        {
+            p_hot_peer = &m_hot_peers[i];
+        }
+    }
+
+    p_hot_peer->peer_id      = peer_id;
+    p_hot_peer->last_used    = ++m_hot_peers_clock;
+    p_hot_peer->bonding_data = *p_bonding_data;
+}
+
+
+/**@brief Function for removing a peer from the hot peers.
+ *
+ * @param[in]  peer_id  The peer.
+ */
+static void hot_peer_remove(pm_peer_id_t peer_id)
+{
+    for (uint32_t i = 0; i < PM_HOT_PEERS_COUNT; i++)
+    {
+        if (m_hot_peers[i].peer_id == peer_id)
+        {
+            m_hot_peers[i].peer_id = PM_PEER_ID_INVALID;
+        }
+    }
+}
+
+
+/**@brief Function for finding a hot peer by the address it connected with.
+ *
+ * @param[in]  p_addr  The address of the peer. Resolvable addresses are resolved against the
+ *                     IRKs of the hot peers.
+ *
+ * @return The matching peer, or PM_PEER_ID_INVALID if no hot peer matched.
+ */
+static pm_peer_id_t hot_peer_find_by_addr(ble_gap_addr_t const * p_addr)
+{
+    for (uint32_t i = 0; i < PM_HOT_PEERS_COUNT; i++)
+    {
+        pm_peer_data_bonding_t const * p_bonding_data = &m_hot_peers[i].bonding_data;
+        bool                           match;
+
+        if (m_hot_peers[i].peer_id == PM_PEER_ID_INVALID)
+        {
+            continue;
+        }
+
+        if (p_addr->addr_type == BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_RESOLVABLE)
+        {
+            match = im_address_resolve(p_addr, &p_bonding_data->peer_ble_id.id_info);
+        }
+        else
+        {
+            match = addr_compare(p_addr, &p_bonding_data->peer_ble_id.id_addr_info);
+        }
+
+        if (match)
+        {
+            m_hot_peers[i].last_used = ++m_hot_peers_clock;
+            return m_hot_peers[i].peer_id;
+        }
+    }
+    return PM_PEER_ID_INVALID;
+}
+
+
+/**@brief Function for finding a hot peer by the master ID of one of its LTKs.
+ *
+ * @param[in]  p_master_id  The master ID.
+ *
+ * @return The matching peer, or PM_PEER_ID_INVALID if no hot peer matched.
+ */
+static pm_peer_id_t hot_peer_find_by_master_id(ble_gap_master_id_t const * p_master_id)
+{
+    for (uint32_t i = 0; i < PM_HOT_PEERS_COUNT; i++)
+    {
+        pm_peer_data_bonding_t const * p_bonding_data = &m_hot_peers[i].bonding_data;
+
+        if (    (m_hot_peers[i].peer_id != PM_PEER_ID_INVALID)
+            && (   im_master_ids_compare(p_master_id, &p_bonding_data->own_ltk.master_id)
+                || im_master_ids_compare(p_master_id, &p_bonding_data->peer_ltk.master_id)))
+        {
+            m_hot_peers[i].last_used = ++m_hot_peers_clock;
+            return m_hot_peers[i].peer_id;
+        }
+    }
+    return PM_PEER_ID_INVALID;
+}
+#endif // NRF_MODULE_ENABLED(PM_HOT_PEERS)
+
+
 void im_ble_evt_handler(ble_evt_t * ble_evt)
 {
     ble_gap_evt_t gap_evt;
@@ -238,8 +427,17 @@ void im_ble_evt_handler(ble_evt_t * ble_evt)
     gap_evt                 = ble_evt->evt.gap_evt;
     bonded_matching_peer_id = PM_PEER_ID_INVALID;
 
+#if NRF_MODULE_ENABLED(PM_HOT_PEERS)
     if (   gap_evt.params.connected.peer_addr.addr_type
         != BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_NON_RESOLVABLE)
+    {
+        bonded_matching_peer_id = hot_peer_find_by_addr(&gap_evt.params.connected.peer_addr);
+    }
+#endif
+
+    if (   (gap_evt.params.connected.peer_addr.addr_type
+        != BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_NON_RESOLVABLE)
+        && (bonded_matching_peer_id == PM_PEER_ID_INVALID))
     {
         /* Search the database for bonding data matching the one that triggered the event.
          * Public and static addresses can be matched on address alone, while resolvable
@@ -263,6 +461,9 @@ void im_ble_evt_handler(ble_evt_t * ble_evt)
                                      &peer_data.p_bonding_data->peer_ble_id.id_addr_info))
                     {
                         bonded_matching_peer_id = peer_id;
+#if NRF_MODULE_ENABLED(PM_HOT_PEERS)
+                        hot_peer_put(peer_id, peer_data.p_bonding_data);
+#endif
                         break;
                     }
                 }
@@ -271,12 +472,40 @@ void im_ble_evt_handler(ble_evt_t * ble_evt)
 
             case BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_RESOLVABLE:
             {
+#if NRF_MODULE_ENABLED(PM_IRK_TABLE)
+                bonded_matching_peer_id = irk_table_resolve(&gap_evt.params.connected.peer_addr);
+
+                if (bonded_matching_peer_id != PM_PEER_ID_INVALID)
+                {
+#if NRF_MODULE_ENABLED(PM_HOT_PEERS)
+                    if (pdb_peer_data_ptr_get(bonded_matching_peer_id,
+                                              PM_PEER_DATA_ID_BONDING,
+                                              &peer_data) == NRF_SUCCESS)
+                    {
+                        hot_peer_put(bonded_matching_peer_id, peer_data.p_bonding_data);
+                    }
+#endif
+                    break;
+                }
+
+                if (m_irk_table_complete)
+                {
+                    // None of the bonded peers use this address.
+                    break;
+                }
+
+                // Building the table may have used the iterator.
+                pds_peer_data_iterate_prepare();
+#endif
                 while (pds_peer_data_iterate(PM_PEER_DATA_ID_BONDING, &peer_id, &peer_data))
                 {
                     if (im_address_resolve(&gap_evt.params.connected.peer_addr,
                                            &peer_data.p_bonding_data->peer_ble_id.id_info))
                     {
                         bonded_matching_peer_id = peer_id;
+#if NRF_MODULE_ENABLED(PM_HOT_PEERS)
+                        hot_peer_put(peer_id, peer_data.p_bonding_data);
+#endif
                         break;
                     }
                 }
@@ -369,6 +598,15 @@ void im_pdb_evt_handler(pdb_evt_t const * p_event)
         return;
     }
 
+#if NRF_MODULE_ENABLED(PM_HOT_PEERS)
+    // A peer that has just bonded is likely to reconnect soon.
+    hot_peer_put(p_event->peer_id, peer_data.p_bonding_data);
+#endif
+
+#if NRF_MODULE_ENABLED(PM_IRK_TABLE)
+    irk_table_invalidate(p_event->peer_id);
+#endif
+
     pds_peer_data_iterate_prepare();
 
     while (pds_peer_data_iterate(PM_PEER_DATA_ID_BONDING, &peer_id, &peer_data_duplicate))
@@ -486,6 +724,14 @@ pm_peer_id_t im_peer_id_get_by_master_id(ble_gap_master_id_t * p_master_id)
     NRF_PM_DEBUG_CHECK(m_module_initialized);
     NRF_PM_DEBUG_CHECK(p_master_id != NULL);
 
+#if NRF_MODULE_ENABLED(PM_HOT_PEERS)
+    peer_id = hot_peer_find_by_master_id(p_master_id);
+    if (peer_id != PM_PEER_ID_INVALID)
+    {
+        return peer_id;
+    }
+#endif
+
     pds_peer_data_iterate_prepare();
 
     // For each stored peer, check if the master_id matches p_master_id
@@ -572,6 +818,20 @@ ret_code_t im_peer_free(pm_peer_id_t peer_id)
     conn_handle = im_conn_handle_get(peer_id);
     ret         = pdb_peer_free(peer_id);
 
+#if NRF_MODULE_ENABLED(PM_HOT_PEERS)
+    if (ret == NRF_SUCCESS)
+    {
+        hot_peer_remove(peer_id);
+    }
+#endif
+
+#if NRF_MODULE_ENABLED(PM_IRK_TABLE)
+    if (ret == NRF_SUCCESS)
+    {
+        irk_table_invalidate(peer_id);
+    }
+#endif
+
     if ((conn_handle != BLE_CONN_HANDLE_INVALID) && (ret == NRF_SUCCESS))
     {
         peer_id_set(conn_handle, PM_PEER_ID_INVALID);
@@ -996,6 +1256,36 @@ ret_code_t im_whitelist_set(pm_peer_id_t const * p_peers,
 }
 
 
+/**@brief Function for calculating the ah() hash function with a key that is already in the byte
+ *        order used by the ECB.
+ *
+ * @param[in]  p_ecb_key    The key, reversed. The array must have a length of 16.
+ * @param[in]  p_r          See @ref ah.
+ * @param[out] p_local_hash See @ref ah.
+ */
+static void ah_ecb(uint8_t const * p_ecb_key, uint8_t const * p_r, uint8_t * p_local_hash)
+{
+    nrf_ecb_hal_data_t ecb_hal_data;
+
+    memcpy(ecb_hal_data.key, p_ecb_key, SOC_ECB_KEY_LENGTH);
+
+    memset(ecb_hal_data.cleartext, 0, SOC_ECB_KEY_LENGTH - IM_ADDR_CLEARTEXT_LENGTH);
+
+    for (uint32_t i = 0; i < IM_ADDR_CLEARTEXT_LENGTH; i++)
+    {
+        ecb_hal_data.cleartext[SOC_ECB_KEY_LENGTH - 1 - i] = p_r[i];
+    }
+
+    // Can only return NRF_SUCCESS.
+    (void) sd_ecb_block_encrypt(&ecb_hal_data);
+
+    for (uint32_t i = 0; i < IM_ADDR_CIPHERTEXT_LENGTH; i++)
+    {
+        p_local_hash[i] = ecb_hal_data.ciphertext[SOC_ECB_KEY_LENGTH - 1 - i];
+    }
+}
+
+
 /**@brief Function for calculating the ah() hash function described in Bluetooth core specification
  *        4.2 section 3.H.2.2.2.
  *
@@ -1021,27 +1311,14 @@ ret_code_t im_whitelist_set(pm_peer_id_t const * p_peers,
  */
 void ah(uint8_t const * p_k, uint8_t const * p_r, uint8_t * p_local_hash)
 {
-    nrf_ecb_hal_data_t ecb_hal_data;
+    uint8_t ecb_key[SOC_ECB_KEY_LENGTH];
 
     for (uint32_t i = 0; i < SOC_ECB_KEY_LENGTH; i++)
     {
-        ecb_hal_data.key[i] = p_k[SOC_ECB_KEY_LENGTH - 1 - i];
-    }
-
-    memset(ecb_hal_data.cleartext, 0, SOC_ECB_KEY_LENGTH - IM_ADDR_CLEARTEXT_LENGTH);
-
-    for (uint32_t i = 0; i < IM_ADDR_CLEARTEXT_LENGTH; i++)
-    {
-        ecb_hal_data.cleartext[SOC_ECB_KEY_LENGTH - 1 - i] = p_r[i];
+        ecb_key[i] = p_k[SOC_ECB_KEY_LENGTH - 1 - i];
     }
 
-    // Can only return NRF_SUCCESS.
-    (void) sd_ecb_block_encrypt(&ecb_hal_data);
-
-    for (uint32_t i = 0; i < IM_ADDR_CIPHERTEXT_LENGTH; i++)
-    {
-        p_local_hash[i] = ecb_hal_data.ciphertext[SOC_ECB_KEY_LENGTH - 1 - i];
-    }
+    ah_ecb(ecb_key, p_r, p_local_hash);
 }
 
 
@@ -1064,4 +1341,110 @@ bool im_address_resolve(ble_gap_addr_t const * p_addr, ble_gap_irk_t const * p_i
 
     return (memcmp(hash, local_hash, IM_ADDR_CIPHERTEXT_LENGTH) == 0);
 }
+
+#if NRF_MODULE_ENABLED(PM_IRK_TABLE)
+/**@brief Function for loading the IRKs of all bonded peers into m_irk_table.
+ */
+static void irk_table_build(void)
+{
+    pm_peer_id_t         peer_id;
+    pm_peer_data_flash_t peer_data;
+
+    m_irk_table_len      = 0;
+    m_irk_table_complete = true;
+
+    pds_peer_data_iterate_prepare();
+
+    while (pds_peer_data_iterate(PM_PEER_DATA_ID_BONDING, &peer_id, &peer_data))
+    {
+        uint8_t const * p_irk = peer_data.p_bonding_data->peer_ble_id.id_info.irk;
+
+        if (!is_valid_irk(&peer_data.p_bonding_data->peer_ble_id.id_info))
+        {
+            continue;
+        }
+
+        if (m_irk_table_len == PM_IRK_TABLE_SIZE)
+        {
+            m_irk_table_complete = false;
+            break;
+        }
+
+        m_irk_table[m_irk_table_len].peer_id = peer_id;
+        for (uint32_t i = 0; i < SOC_ECB_KEY_LENGTH; i++)
+        {
+            m_irk_table[m_irk_table_len].ecb_key[i] = p_irk[SOC_ECB_KEY_LENGTH - 1 - i];
+        }
+        m_irk_table_len++;
+    }
+
+    m_irk_table_valid = true;
+}
+
+
+/**@brief Function for marking the IRK table as outdated, and forgetting the addresses that were
+ *        resolved to a peer.
+ *
+ * @param[in]  peer_id  The peer whose bonding data has changed or been deleted.
+ */
+static void irk_table_invalidate(pm_peer_id_t peer_id)
+{
+    m_irk_table_valid = false;
+
+    for (uint32_t i = 0; i < PM_IRK_TABLE_RPA_CACHE_SIZE; i++)
+    {
+        if (m_rpa_cache[i].peer_id == peer_id)
+        {
+            m_rpa_cache[i].peer_id = PM_PEER_ID_INVALID;
+        }
+    }
+}
+
+
+/**@brief Function for resolving an address against the IRKs of all bonded peers.
+ *
+ * @details Addresses that have been resolved recently are found without any encryption. Other
+ *          addresses are checked against the IRK table, which is loaded from flash first if it
+ *          is outdated.
+ *
+ * @param[in]  p_addr  The resolvable private address.
+ *
+ * @return The peer whose IRK resolves the address, or PM_PEER_ID_INVALID if no IRK in the table
+ *         resolves it. In that case, the peer can only be in flash if m_irk_table_complete is false.
+ */
+static pm_peer_id_t irk_table_resolve(ble_gap_addr_t const * p_addr)
+{
+    uint8_t local_hash[IM_ADDR_CIPHERTEXT_LENGTH];
+
+    for (uint32_t i = 0; i < PM_IRK_TABLE_RPA_CACHE_SIZE; i++)
+    {
+        if (   (m_rpa_cache[i].peer_id != PM_PEER_ID_INVALID)
+            && (memcmp(m_rpa_cache[i].addr, p_addr->addr, BLE_GAP_ADDR_LEN) == 0))
+        {
+            return m_rpa_cache[i].peer_id;
+        }
+    }
+
+    if (!m_irk_table_valid)
+    {
+        irk_table_build();
+    }
+
+    for (uint32_t i = 0; i < m_irk_table_len; i++)
+    {
+        ah_ecb(m_irk_table[i].ecb_key, &p_addr->addr[IM_ADDR_CIPHERTEXT_LENGTH], local_hash);
+
+        if (memcmp(p_addr->addr, local_hash, IM_ADDR_CIPHERTEXT_LENGTH) == 0)
+        {
+            m_rpa_cache[m_rpa_cache_next].peer_id = m_irk_table[i].peer_id;
+            memcpy(m_rpa_cache[m_rpa_cache_next].addr, p_addr->addr, BLE_GAP_ADDR_LEN);
+            m_rpa_cache_next = (m_rpa_cache_next + 1) % PM_IRK_TABLE_RPA_CACHE_SIZE;
+
+            return m_irk_table[i].peer_id;
+        }
+    }
+
+    return PM_PEER_ID_INVALID;
+}
+#endif // NRF_MODULE_ENABLED(PM_IRK_TABLE)
 #endif // NRF_MODULE_ENABLED(PEER_MANAGER)
@@ -53,6 +53,114 @@ static bool m_peer_delete_ongoing = false;
 // A token used for Flash Data Storage searches.
 static fds_find_token_t m_fds_ftok;
 
+#if NRF_MODULE_ENABLED(PM_PEER_DATA_CACHE)
+
+#ifndef PM_PEER_DATA_CACHE_SIZE
+#define PM_PEER_DATA_CACHE_SIZE             4
+#endif
+
+#ifndef PM_PEER_DATA_CACHE_ENTRY_WORDS
+#define PM_PEER_DATA_CACHE_ENTRY_WORDS      32
+#endif
+
+// A copy of a peer data record, kept in RAM so that reading it does not require a flash search.
+typedef struct
+{
+    pm_peer_id_t      peer_id;                              // The peer, or PM_PEER_ID_INVALID if the entry is unused.
+    pm_peer_data_id_t data_id;                              // The type of the data.
+    uint16_t          length_words;                         // The length of the data, in 4-byte words.
+    uint32_t          last_used;                            // The value of m_cache_clock when the entry was last used.
+    uint32_t          data[PM_PEER_DATA_CACHE_ENTRY_WORDS]; // The data.
+} pds_cache_entry_t;
+
+static pds_cache_entry_t m_cache[PM_PEER_DATA_CACHE_SIZE];
+static uint32_t          m_cache_clock;
+
+
+// Function for finding the cache entry of a peer data record.
+static pds_cache_entry_t * cache_find(pm_peer_id_t peer_id, pm_peer_data_id_t data_id)
+{
+    for (uint32_t i = 0; i < PM_PEER_DATA_CACHE_SIZE; i++)
+    {
+        if ((m_cache[i].peer_id == peer_id) && (m_cache[i].data_id == data_id))
+        {
+            m_cache[i].last_used = ++m_cache_clock;
+            return &m_cache[i];
+        }
+    }
+    return NULL;
+}
+
+
+// Function for invalidating cache entries. If data_id is PM_PEER_DATA_ID_INVALID, all entries
+// belonging to the peer are invalidated.
+static void cache_invalidate(pm_peer_id_t peer_id, pm_peer_data_id_t data_id)
+{
+    for (uint32_t i = 0; i < PM_PEER_DATA_CACHE_SIZE; i++)
+    {
+        if (    (m_cache[i].peer_id == peer_id)
+            && ((m_cache[i].data_id == data_id) || (data_id == PM_PEER_DATA_ID_INVALID)))
+        {
+            m_cache[i].peer_id = PM_PEER_ID_INVALID;
+        }
+    }
+}
+
+
+// Function for putting a copy of a peer data record in the cache. The least recently used entry
+// is replaced if the record is not already cached. Records that are too large are not cached.
+static void cache_put(pm_peer_id_t      peer_id,
+                      pm_peer_data_id_t data_id,
+                      void      const * p_data,
+                      uint16_t          length_words)
+{
+    pds_cache_entry_t * p_entry;
+
+    if (length_words > PM_PEER_DATA_CACHE_ENTRY_WORDS)
+    {
+        cache_invalidate(peer_id, data_id);
+        return;
+    }
+
+    p_entry = cache_find(peer_id, data_id);
+
+    if (p_entry == NULL)
+    {
+        p_entry = &m_cache[0];
+        for (uint32_t i = 0; i < PM_PEER_DATA_CACHE_SIZE; i++)
+        {
+            if (m_cache[i].peer_id == PM_PEER_ID_INVALID)
+            {
+                p_entry = &m_cache[i];
+                break;
+            }
+            if (m_cache[i].last_used < p_entry->last_used)
+            {
+                p_entry = &m_cache[i];
+            }
+        }
+    }
+
+    p_entry->peer_id      = peer_id;
+    p_entry->data_id      = data_id;
+    p_entry->length_words = length_words;
+    p_entry->last_used    = ++m_cache_clock;
+    memcpy(p_entry->data, p_data, length_words * sizeof(uint32_t));
+}
+
+
+// Function for emptying the cache.
+static void cache_reset(void)
+{
+    for (uint32_t i = 0; i < PM_PEER_DATA_CACHE_SIZE; i++)
+    {
+        m_cache[i].peer_id = PM_PEER_ID_INVALID;
+    }
+    m_cache_clock = 0;
+}
+
+#endif // NRF_MODULE_ENABLED(PM_PEER_DATA_CACHE)
+
 
 // Function for dispatching events to all registered event handlers.
 static void pds_evt_send(pds_evt_t * p_event)
@@ -251,6 +359,14 @@ static void fds_evt_handler(fds_evt_t const * const p_fds_evt)
                 pds_evt.result      = p_fds_evt->result;
                 pds_evt.store_token = p_fds_evt->write.record_id;
 
+#if NRF_MODULE_ENABLED(PM_PEER_DATA_CACHE)
+                if (p_fds_evt->result != FDS_SUCCESS)
+                {
+                    // The cached copy was never written to flash.
+                    cache_invalidate(pds_evt.peer_id, pds_evt.data_id);
+                }
+#endif
+
                 pds_evt_send(&pds_evt);
             }
             break;
@@ -265,6 +381,10 @@ static void fds_evt_handler(fds_evt_t const * const p_fds_evt)
                 pds_evt.evt_id = (p_fds_evt->result == FDS_SUCCESS) ? PDS_EVT_CLEARED :
                                                                       PDS_EVT_ERROR_CLEAR;
 
+#if NRF_MODULE_ENABLED(PM_PEER_DATA_CACHE)
+                cache_invalidate(pds_evt.peer_id, pds_evt.data_id);
+#endif
+
                 pds_evt.store_token = p_fds_evt->del.record_id;
 
                 pds_evt_send(&pds_evt);
@@ -280,6 +400,9 @@ static void fds_evt_handler(fds_evt_t const * const p_fds_evt)
                     pds_evt.data_id = record_key_to_peer_data_id(p_fds_evt->del.record_key);
 
                     pds_evt.data_id = PM_PEER_DATA_ID_INVALID;
+#if NRF_MODULE_ENABLED(PM_PEER_DATA_CACHE)
+                    cache_invalidate(pds_evt.peer_id, PM_PEER_DATA_ID_INVALID);
+#endif
                     if (p_fds_evt->result == FDS_SUCCESS)
                     {
                         pds_evt.evt_id = PDS_EVT_PEER_ID_CLEAR;
@@ -336,8 +459,15 @@ ret_code_t pds_init()
         return NRF_ERROR_STORAGE_FULL;
     }
 
-    peer_id_init();
-    peer_ids_load();
+    if (!peer_id_warm_boot_restore())
+    {
+        peer_id_init();
+        peer_ids_load();
+    }
+
+#if NRF_MODULE_ENABLED(PM_PEER_DATA_CACHE)
+    cache_reset();
+#endif
 
     m_module_initialized = true;
 
@@ -345,6 +475,45 @@ ret_code_t pds_init()
 }
 
 
+// Function for providing the data of a record to the caller of pds_peer_data_read().
+// If p_buf_len is NULL, a pointer to the data is provided, otherwise, the data is copied into the
+// buffer of the caller if it is large enough.
+static ret_code_t peer_data_copy(void              const * p_src,
+                                 uint16_t                  length_words,
+                                 pm_peer_data_id_t         data_id,
+                                 pm_peer_data_t    * const p_data,
+                                 uint32_t    const * const p_buf_len)
+{
+    // @note emdi: could this actually be set by the caller and used instead
+    // of an additional parameter (data_id) ?
+    p_data->data_id      = data_id;
+    p_data->length_words = length_words;
+
+    if (p_buf_len != NULL)
+    {
+        uint32_t const data_len_bytes = (length_words * sizeof(uint32_t));
+
+        if (data_len_bytes <= (*p_buf_len))
+        {
+            memcpy(p_data->p_all_data, p_src, data_len_bytes);
+        }
+        else
+        {
+            return NRF_ERROR_NO_MEM;
+        }
+    }
+    else
+    {
+        // The cast is necessary because if no buffer is provided, we just copy the pointer,
+        // but it that case it should be considered a pointer to const data by the caller,
+        // since it is a pointer to data in flash, or in the peer data cache.
+        p_data->p_all_data = (void*)p_src;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
 ret_code_t pds_peer_data_read(pm_peer_id_t                    peer_id,
                               pm_peer_data_id_t               data_id,
                               pm_peer_data_t          * const p_data,
@@ -360,6 +529,15 @@ ret_code_t pds_peer_data_read(pm_peer_id_t                    peer_id,
     VERIFY_PEER_ID_IN_RANGE(peer_id);
     VERIFY_PEER_DATA_ID_IN_RANGE(data_id);
 
+#if NRF_MODULE_ENABLED(PM_PEER_DATA_CACHE)
+    pds_cache_entry_t * p_entry = cache_find(peer_id, data_id);
+
+    if (p_entry != NULL)
+    {
+        return peer_data_copy(p_entry->data, p_entry->length_words, data_id, p_data, p_buf_len);
+    }
+#endif
+
     ret = peer_data_find(peer_id, data_id, &rec_desc);
 
     if (ret != NRF_SUCCESS)
@@ -375,38 +553,20 @@ ret_code_t pds_peer_data_read(pm_peer_id_t                    peer_id,
         return NRF_ERROR_NOT_FOUND;
     }
 
-    // @note emdi: could this actually be set by the caller and used instead
-    // of an additional parameter (data_id) ?
-    p_data->data_id      = data_id;
-    p_data->length_words = rec_flash.p_header->tl.length_words;
+#if NRF_MODULE_ENABLED(PM_PEER_DATA_CACHE)
+    cache_put(peer_id, data_id, rec_flash.p_data, rec_flash.p_header->tl.length_words);
+#endif
 
-    // If p_buf_len is NULL, provide a pointer to data in flash, otherwise,
-    // check that the buffer is large enough and copy the data in flash into the buffer.
-    if (p_buf_len != NULL)
-    {
-        uint32_t const data_len_bytes = (p_data->length_words * sizeof(uint32_t));
-
-        if ((*p_buf_len) <= data_len_bytes)
-        {
-            memcpy(p_data->p_all_data, rec_flash.p_data, data_len_bytes);
-        }
-        else
-        {
-            return NRF_ERROR_NO_MEM;
-        }
-    }
-    else
-    {
-        // The cast is necessary because if no buffer is provided, we just copy the pointer,
-        // but it that case it should be considered a pointer to const data by the caller,
-        // since it is a pointer to data in flash.
-        p_data->p_all_data = (void*)rec_flash.p_data;
-    }
+    ret = peer_data_copy(rec_flash.p_data,
+                         rec_flash.p_header->tl.length_words,
+                         data_id,
+                         p_data,
+                         p_buf_len);
 
     // Shouldn't fail unless the record was already closed, in which case it can be ignored.
     (void)fds_record_close(&rec_desc);
 
-    return NRF_SUCCESS;
+    return ret;
 }
 
 
@@ -568,6 +728,10 @@ ret_code_t pds_peer_data_store(pm_peer_id_t                 peer_id,
                 // Update the store token.
                 (void)fds_record_id_from_desc(&rec_desc, (uint32_t*)p_store_token);
             }
+#if NRF_MODULE_ENABLED(PM_PEER_DATA_CACHE)
+            // Write-through, so reads see the new data while it is being written to flash.
+            cache_put(peer_id, p_peer_data->data_id, p_peer_data->p_all_data, p_peer_data->length_words);
+#endif
             return NRF_SUCCESS;
 
         case FDS_ERR_BUSY:
@@ -630,6 +794,9 @@ ret_code_t pds_peer_id_free(pm_peer_id_t peer_id)
     VERIFY_PEER_ID_IN_RANGE(peer_id);
 
     (void)peer_id_delete(peer_id);
+#if NRF_MODULE_ENABLED(PM_PEER_DATA_CACHE)
+    cache_invalidate(peer_id, PM_PEER_DATA_ID_INVALID);
+#endif
     peer_data_delete();
 
     return NRF_SUCCESS;
@@ -662,4 +829,24 @@ uint32_t pds_peer_count_get(void)
     NRF_PM_DEBUG_CHECK(m_module_initialized);
     return peer_id_n_ids();
 }
+
+
+ret_code_t pds_compress(void)
+{
+    NRF_PM_DEBUG_CHECK(m_module_initialized);
+
+    ret_code_t ret = fds_gc();
+
+    switch (ret)
+    {
+        case FDS_SUCCESS:
+            return NRF_SUCCESS;
+
+        case FDS_ERR_NO_SPACE_IN_QUEUES:
+            return NRF_ERROR_BUSY;
+
+        default:
+            return NRF_ERROR_INTERNAL;
+    }
+}
 #endif // NRF_MODULE_ENABLED(PEER_MANAGER)
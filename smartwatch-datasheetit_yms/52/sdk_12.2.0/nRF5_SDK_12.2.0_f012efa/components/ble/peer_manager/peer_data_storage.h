@@ -268,6 +268,18 @@ pm_peer_id_t pds_next_deleted_peer_id_get(pm_peer_id_t prev_peer_id);
 uint32_t pds_peer_count_get(void);
 
 
+/**@brief Function for starting a garbage collection in flash, to reclaim the space of deleted
+ *        peer data.
+ *
+ * @details The garbage collection runs one flash page at a time. @ref PDS_EVT_COMPRESSED is sent
+ *          when it is done.
+ *
+ * @retval NRF_SUCCESS     The garbage collection was started.
+ * @retval NRF_ERROR_BUSY  The flash operation queue is full. Try again later.
+ */
+ret_code_t pds_compress(void);
+
+
 /** @}
  * @endcond
  */
@@ -19,18 +19,46 @@
 #include "sdk_errors.h"
 #include "peer_manager_types.h"
 #include "pm_mutex.h"
+#if NRF_MODULE_ENABLED(NRF_WARM_BOOT)
+#include "nrf_warm_boot.h"
+#endif
 
 
 typedef struct
 {
-    uint8_t used_peer_ids[MUTEX_STORAGE_SIZE(PM_PEER_ID_N_AVAILABLE_IDS)];  /**< Bitmap designating which peer IDs are in use. */
-    uint8_t deleted_peer_ids[MUTEX_STORAGE_SIZE(PM_PEER_ID_N_AVAILABLE_IDS)]; /**< Bitmap designating which peer IDs are marked for deletion. */
+    uint32_t used_peer_ids[MUTEX_STORAGE_WORDS(PM_PEER_ID_N_AVAILABLE_IDS)];  /**< Bitmap designating which peer IDs are in use. */
+    uint32_t deleted_peer_ids[MUTEX_STORAGE_WORDS(PM_PEER_ID_N_AVAILABLE_IDS)]; /**< Bitmap designating which peer IDs are marked for deletion. */
 } pi_t;
 
 
 static pi_t m_pi = {{0}, {0}};
 
 
+#if NRF_MODULE_ENABLED(NRF_WARM_BOOT)
+static bool warm_boot_save(void * p_blob)
+{
+    // The deletion of a peer does not continue after a reset, so its state is not saved.
+    for (uint32_t i = 0; i < ARRAY_SIZE(m_pi.deleted_peer_ids); i++)
+    {
+        if (m_pi.deleted_peer_ids[i] != 0)
+        {
+            return false;
+        }
+    }
+    memcpy(p_blob, m_pi.used_peer_ids, sizeof(m_pi.used_peer_ids));
+    return true;
+}
+
+
+static nrf_warm_boot_blob_t const m_warm_boot_blob =
+{
+    .id   = NRF_WARM_BOOT_ID_PEER_ID,
+    .size = sizeof(m_pi.used_peer_ids),
+    .save = warm_boot_save,
+};
+#endif
+
+
 static void internal_state_reset(pi_t * p_pi)
 {
     memset(p_pi, 0, sizeof(pi_t));
@@ -42,12 +70,36 @@ void peer_id_init(void)
     internal_state_reset(&m_pi);
     pm_mutex_init(m_pi.used_peer_ids, PM_PEER_ID_N_AVAILABLE_IDS);
     pm_mutex_init(m_pi.deleted_peer_ids, PM_PEER_ID_N_AVAILABLE_IDS);
+#if NRF_MODULE_ENABLED(NRF_WARM_BOOT)
+    (void)nrf_warm_boot_register(&m_warm_boot_blob);
+#endif
+}
+
+
+bool peer_id_warm_boot_restore(void)
+{
+#if NRF_MODULE_ENABLED(NRF_WARM_BOOT)
+    uint8_t const * p_used = nrf_warm_boot_get(NRF_WARM_BOOT_ID_PEER_ID, sizeof(m_pi.used_peer_ids));
+
+    peer_id_init();
+    if (p_used == NULL)
+    {
+        return false;
+    }
+    memcpy(m_pi.used_peer_ids, p_used, sizeof(m_pi.used_peer_ids));
+    return true;
+#else
+    return false;
+#endif
 }
 
 
-static pm_peer_id_t claim(pm_peer_id_t peer_id, uint8_t * mutex_group)
+static pm_peer_id_t claim(pm_peer_id_t peer_id, uint32_t * mutex_group)
 {
     pm_peer_id_t allocated_peer_id = PM_PEER_ID_INVALID;
+#if NRF_MODULE_ENABLED(NRF_WARM_BOOT)
+    nrf_warm_boot_invalidate(NRF_WARM_BOOT_ID_PEER_ID);
+#endif
     if (peer_id == PM_PEER_ID_INVALID)
     {
         allocated_peer_id = pm_mutex_lock_first_available(mutex_group, PM_PEER_ID_N_AVAILABLE_IDS);
@@ -65,10 +117,13 @@ static pm_peer_id_t claim(pm_peer_id_t peer_id, uint8_t * mutex_group)
 }
 
 
-static void release(pm_peer_id_t peer_id, uint8_t * mutex_group)
+static void release(pm_peer_id_t peer_id, uint32_t * mutex_group)
 {
     if (peer_id < PM_PEER_ID_N_AVAILABLE_IDS)
     {
+#if NRF_MODULE_ENABLED(NRF_WARM_BOOT)
+        nrf_warm_boot_invalidate(NRF_WARM_BOOT_ID_PEER_ID);
+#endif
         pm_mutex_unlock(mutex_group, peer_id);
     }
 }
@@ -122,7 +177,7 @@ bool peer_id_is_deleted(pm_peer_id_t peer_id)
 }
 
 
-pm_peer_id_t next_id_get(pm_peer_id_t prev_peer_id, uint8_t * mutex_group)
+pm_peer_id_t next_id_get(pm_peer_id_t prev_peer_id, uint32_t * mutex_group)
 {
     pm_peer_id_t i = (prev_peer_id == PM_PEER_ID_INVALID) ? 0 : (prev_peer_id + 1);
     for (; i < PM_PEER_ID_N_AVAILABLE_IDS; i++)
@@ -40,6 +40,15 @@ extern "C" {
 void peer_id_init(void);
 
 
+/**@brief Function for initializing the module with the peer IDs kept across a reset, see
+ *        @ref nrf_warm_boot.
+ *
+ * @retval  true   The peer IDs were restored. There is no need to load them from flash.
+ * @retval  false  This is a cold boot, or warm boot is not enabled. Call @ref peer_id_init instead.
+ */
+bool peer_id_warm_boot_restore(void);
+
+
 /**@brief Function for claiming an unused peer ID.
  *
  * @param peer_id  The peer ID to allocate. If this is @ref PM_PEER_ID_INVALID, the first available
@@ -42,6 +42,169 @@ static uint8_t                       m_n_registrants;                   /**< The
 static ble_conn_state_user_flag_id_t m_pairing_flag_id;                 /**< The flag ID for which connections are paired. */
 static ble_conn_state_user_flag_id_t m_bonding_flag_id;                 /**< The flag ID for which connections are bonded. */
 
+#if NRF_MODULE_ENABLED(PM_LRU_EVICTION)
+/**@brief States of the recovery from a full flash. */
+typedef enum
+{
+    EVICT_STATE_IDLE,       /**< No recovery is ongoing. */
+    EVICT_STATE_GC,         /**< A garbage collection has been started. */
+    EVICT_STATE_GC_DONE,    /**< The garbage collection is done, and the failed writes have been retried. */
+    EVICT_STATE_DELETING,   /**< The least recently used peer is being deleted. */
+} evict_state_t;
+
+static evict_state_t                 m_evict_state;                     /**< The state of the recovery from a full flash. */
+static pm_peer_id_t                  m_evicted_peer;                    /**< The peer being deleted to make room, in @ref EVICT_STATE_DELETING. */
+#endif
+
+
+#if NRF_MODULE_ENABLED(PM_LRU_EVICTION)
+/**@brief Function for finding the peer to delete to make room in flash.
+ *
+ * @details This is the peer with the lowest rank, see @ref pm_peer_rank_highest. Peers that are
+ *          connected are never chosen, this includes a peer that is bonding.
+ *
+ * @return The peer to delete, or @ref PM_PEER_ID_INVALID if all peers are connected.
+ */
+static pm_peer_id_t evict_candidate_get(void)
+{
+    pm_peer_id_t candidate      = PM_PEER_ID_INVALID;
+    uint32_t     candidate_rank = UINT32_MAX;
+    uint32_t     peer_rank;
+    //lint -save -e65 -e64
+    pm_peer_data_t peer_data = {.length_words = BYTES_TO_WORDS(sizeof(peer_rank)),
+                                .p_peer_rank  = &peer_rank};
+    //lint -restore
+
+    for (pm_peer_id_t peer_id = pdb_next_peer_id_get(PM_PEER_ID_INVALID);
+         peer_id != PM_PEER_ID_INVALID;
+         peer_id = pdb_next_peer_id_get(peer_id))
+    {
+        if (im_conn_handle_get(peer_id) != BLE_CONN_HANDLE_INVALID)
+        {
+            continue;
+        }
+
+        if (pdb_peer_data_load(peer_id, PM_PEER_DATA_ID_PEER_RANK, &peer_data) != NRF_SUCCESS)
+        {
+            // A peer that has never been ranked is older than any ranked peer.
+            peer_rank = 0;
+        }
+
+        if ((candidate == PM_PEER_ID_INVALID) || (peer_rank < candidate_rank))
+        {
+            candidate      = peer_id;
+            candidate_rank = peer_rank;
+        }
+    }
+
+    return candidate;
+}
+
+
+/**@brief Function for starting a garbage collection to make room in flash.
+ *
+ * @retval true   If the garbage collection was started.
+ * @retval false  Otherwise. The recovery has been given up.
+ */
+static bool evict_gc_start(void)
+{
+    if (pds_compress() == NRF_SUCCESS)
+    {
+        m_evict_state = EVICT_STATE_GC;
+        return true;
+    }
+
+    m_evict_state = EVICT_STATE_IDLE;
+    return false;
+}
+
+
+/**@brief Function for making room in flash after a write failed because flash was full.
+ *
+ * @details First, a garbage collection is run, after which the failed writes are retried by the
+ *          modules that made them. If a write fails again, the least recently used peer that is
+ *          not connected is deleted with its whole file, and a new garbage collection is run.
+ *          This goes on until the writes succeed, or no peer can be deleted.
+ *
+ * @retval true   If room is being made. The write will be retried.
+ * @retval false  If no room could be made. The application must be told.
+ */
+static bool evict_storage_full_handle(void)
+{
+    switch (m_evict_state)
+    {
+        case EVICT_STATE_IDLE:
+            return evict_gc_start();
+
+        case EVICT_STATE_GC_DONE:
+            m_evicted_peer = evict_candidate_get();
+            if ((m_evicted_peer != PM_PEER_ID_INVALID) && (im_peer_free(m_evicted_peer) == NRF_SUCCESS))
+            {
+                m_evict_state = EVICT_STATE_DELETING;
+                return true;
+            }
+            m_evict_state = EVICT_STATE_IDLE;
+            return false;
+
+        default:
+            // Room is being made, the write will be retried when it is done.
+            return true;
+    }
+}
+
+
+/**@brief Function for following the recovery from a full flash through Peer Database events.
+ *
+ * @param[in]  p_pdb_evt  The incoming Peer Database event.
+ *
+ * @retval true   If the recovery was given up. The application must be told that flash is full.
+ * @retval false  Otherwise.
+ */
+static bool evict_pdb_evt_handle(pdb_evt_t const * p_pdb_evt)
+{
+    switch (p_pdb_evt->evt_id)
+    {
+        case PDB_EVT_COMPRESSED:
+            if (m_evict_state == EVICT_STATE_GC)
+            {
+                // Failed writes are retried after this event. If they fail again, a peer is deleted.
+                m_evict_state = EVICT_STATE_GC_DONE;
+            }
+            break;
+
+        case PDB_EVT_WRITE_BUF_STORED:
+        case PDB_EVT_RAW_STORED:
+            if (m_evict_state == EVICT_STATE_GC_DONE)
+            {
+                m_evict_state = EVICT_STATE_IDLE;
+            }
+            break;
+
+        case PDB_EVT_PEER_FREED:
+            if ((m_evict_state == EVICT_STATE_DELETING) && (p_pdb_evt->peer_id == m_evicted_peer))
+            {
+                m_evicted_peer = PM_PEER_ID_INVALID;
+                return !evict_gc_start();
+            }
+            break;
+
+        case PDB_EVT_PEER_FREE_FAILED:
+            if ((m_evict_state == EVICT_STATE_DELETING) && (p_pdb_evt->peer_id == m_evicted_peer))
+            {
+                m_evicted_peer = PM_PEER_ID_INVALID;
+                m_evict_state  = EVICT_STATE_IDLE;
+                return true;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return false;
+}
+#endif // NRF_MODULE_ENABLED(PM_LRU_EVICTION)
+
 
 /**@brief Function for sending a Peer Manager event to all subscribers.
  *
@@ -181,6 +344,9 @@ void pm_pdb_evt_handler(pdb_evt_t const * p_pdb_evt)
 
         case PDB_EVT_ERROR_NO_MEM:
             pm_evt.evt_id = PM_EVT_STORAGE_FULL;
+#if NRF_MODULE_ENABLED(PM_LRU_EVICTION)
+            send_evt = !evict_storage_full_handle();
+#endif
             break;
 
         case PDB_EVT_ERROR_UNEXPECTED:
@@ -196,6 +362,17 @@ void pm_pdb_evt_handler(pdb_evt_t const * p_pdb_evt)
     {
         evt_send(&pm_evt);
     }
+
+#if NRF_MODULE_ENABLED(PM_LRU_EVICTION)
+    if (evict_pdb_evt_handle(p_pdb_evt))
+    {
+        memset(&pm_evt, 0, sizeof(pm_evt_t));
+        pm_evt.evt_id      = PM_EVT_STORAGE_FULL;
+        pm_evt.peer_id     = PM_PEER_ID_INVALID;
+        pm_evt.conn_handle = BLE_CONN_HANDLE_INVALID;
+        evt_send(&pm_evt);
+    }
+#endif
 }
 
 
@@ -304,6 +481,9 @@ void pm_sm_evt_handler(sm_evt_t const * p_sm_evt)
 
         case SM_EVT_ERROR_NO_MEM:
             pm_evt.evt_id = PM_EVT_STORAGE_FULL;
+#if NRF_MODULE_ENABLED(PM_LRU_EVICTION)
+            send_evt = !evict_storage_full_handle();
+#endif
             break;
 
         case SM_EVT_ERROR_SMP_TIMEOUT:
@@ -393,6 +573,9 @@ void pm_gcm_evt_handler(gcm_evt_t const * p_gcm_evt)
 
         case GCM_EVT_ERROR_STORAGE_FULL:
             pm_evt.evt_id = PM_EVT_STORAGE_FULL;
+#if NRF_MODULE_ENABLED(PM_LRU_EVICTION)
+            send_evt = !evict_storage_full_handle();
+#endif
             break;
 
         case GCM_EVT_ERROR_UNEXPECTED:
@@ -458,6 +641,10 @@ static void internal_state_reset()
     m_peer_rank_token     = PM_STORE_TOKEN_INVALID;
     m_pairing_flag_id     = BLE_CONN_STATE_USER_FLAG_INVALID;
     m_bonding_flag_id     = BLE_CONN_STATE_USER_FLAG_INVALID;
+#if NRF_MODULE_ENABLED(PM_LRU_EVICTION)
+    m_evict_state         = EVICT_STATE_IDLE;
+    m_evicted_peer        = PM_PEER_ID_INVALID;
+#endif
 }
 
 
@@ -684,6 +871,13 @@ ret_code_t pm_lesc_public_key_set(ble_gap_lesc_p256_pk_t * p_public_key)
 }
 
 
+ret_code_t pm_lesc_private_key_set(uint8_t const * p_private_key)
+{
+    VERIFY_MODULE_INITIALIZED();
+    return sm_lesc_private_key_set(p_private_key);
+}
+
+
 ret_code_t pm_conn_handle_get(pm_peer_id_t peer_id, uint16_t * p_conn_handle)
 {
     VERIFY_MODULE_INITIALIZED();
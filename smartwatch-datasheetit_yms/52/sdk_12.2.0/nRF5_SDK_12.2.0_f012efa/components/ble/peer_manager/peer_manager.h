@@ -67,7 +67,7 @@ typedef enum
     PM_EVT_CONN_SEC_SUCCEEDED,              /**< @brief A link has been encrypted, either as a result of a call to @ref pm_conn_secure or a result of an action by the peer. The event structure contains more information about the circumstances. This event might contain a peer ID with the value @ref PM_PEER_ID_INVALID, which means that the peer (central) used an address that could not be identified, but it used an encryption key (LTK) that is present in the database. */
     PM_EVT_CONN_SEC_FAILED,                 /**< @brief A pairing or encryption procedure has failed. In some cases, this means that security is not possible on this link (temporarily or permanently). How to handle this error depends on the application. */
     PM_EVT_CONN_SEC_CONFIG_REQ,             /**< @brief The peer (central) has requested pairing, but a bond already exists with that peer. Reply by calling @ref pm_conn_sec_config_reply before the event handler returns. If no reply is sent, a default is used. */
-    PM_EVT_STORAGE_FULL,                    /**< @brief There is no more room for peer data in flash storage. To solve this problem, delete data that is not needed anymore and run a garbage collection procedure in FDS. */
+    PM_EVT_STORAGE_FULL,                    /**< @brief There is no more room for peer data in flash storage. To solve this problem, delete data that is not needed anymore and run a garbage collection procedure in FDS. With PM_LRU_EVICTION_ENABLED, this is only sent when no peer that is not connected is left to delete. */
     PM_EVT_ERROR_UNEXPECTED,                /**< @brief An unrecoverable error happened inside Peer Manager. An operation failed with the provided error. */
     PM_EVT_PEER_DATA_UPDATE_SUCCEEDED,      /**< @brief A piece of peer data was stored, updated, or cleared in flash storage. This event is sent for all successful changes to peer data, also those initiated internally in Peer Manager. To identify an operation, compare the store token in the event with the store token received during the initiating function call. Events from internally initiated changes might have invalid store tokens. */
     PM_EVT_PEER_DATA_UPDATE_FAILED,         /**< @brief A piece of peer data could not be stored, updated, or cleared in flash storage. This event is sent instead of @ref PM_EVT_PEER_DATA_UPDATE_SUCCEEDED for the failed operation. */
@@ -325,6 +325,29 @@ ret_code_t pm_conn_sec_status_get(uint16_t conn_handle, pm_conn_sec_status_t * p
 ret_code_t pm_lesc_public_key_set(ble_gap_lesc_p256_pk_t * p_public_key);
 
 
+/**@brief Experimental function for letting Peer Manager compute the DHKey in LESC pairing.
+ *
+ * @details When a private key is set, Peer Manager answers @ref BLE_GAP_EVT_LESC_DHKEY_REQUEST
+ *          itself. The DHKey is computed a few bits at a time from @ref app_scheduler, so the
+ *          main loop keeps running while it is computed. The application must then neither answer
+ *          the request, nor pass the events of the SoftDevice to @ref app_scheduler with a queue
+ *          too short for one more event. If the peer public key is invalid, the link is
+ *          disconnected and @ref PM_EVT_ERROR_UNEXPECTED is sent.
+ *
+ * @note The key must continue to reside in application memory as it is not copied by Peer Manager.
+ *       It must be the private key of the key pair given to @ref pm_lesc_public_key_set.
+ *
+ * @param[in]  p_private_key  The little-endian private key, aligned to a 4-byte boundary, or NULL
+ *                            to let the application answer the DHKey requests.
+ *
+ * @retval NRF_SUCCESS              If the key was set.
+ * @retval NRF_ERROR_INVALID_ADDR   If the key is not aligned to a 4-byte boundary.
+ * @retval NRF_ERROR_NOT_SUPPORTED  If PM_LESC_DHKEY_ENABLED is not set.
+ * @retval NRF_ERROR_INVALID_STATE  If the Peer Manager is not initialized.
+ */
+ret_code_t pm_lesc_private_key_set(uint8_t const * p_private_key);
+
+
 /**@brief Function for setting or clearing the whitelist.
  *
  * When using the S13x SoftDevice v3.x, this function sets or clears the whitelist.
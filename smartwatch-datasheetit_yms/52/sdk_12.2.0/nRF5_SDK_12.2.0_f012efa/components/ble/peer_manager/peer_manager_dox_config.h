@@ -12,5 +12,134 @@
  */
 #define PEER_MANAGER_ENABLED
 
+/** @brief Keep copies of recently read peer data records in RAM
+ *
+ *  Reads of cached records do not search flash. The cache is updated when data is stored,
+ *  and entries are dropped when data is deleted or fails to be stored.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PM_PEER_DATA_CACHE_ENABLED
+
+/** @brief Number of peer data records in the cache
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PM_PEER_DATA_CACHE_SIZE
+
+/** @brief Largest peer data record that is cached, in 4-byte words
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PM_PEER_DATA_CACHE_ENTRY_WORDS
+
+/** @brief Store CCCD changes after a quiet period, or on disconnection, instead of on every write
+ *
+ *  Several CCCD writes then result in one write to flash. Uses an app_timer, which must time out
+ *  in the same interrupt priority as the BLE events are handled in. On disconnection, the system
+ *  attributes are copied to RAM and stored from there. The copy is applied if the peer reconnects
+ *  before it is in flash.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PM_LOCAL_DB_WRITE_BACK_ENABLED
+
+/** @brief Time without CCCD writes after which the CCCD changes are stored, in app_timer ticks
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PM_LOCAL_DB_WRITE_BACK_DELAY
+
+/** @brief Number of peers whose system attributes can be held in RAM after disconnection
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PM_LOCAL_DB_MIRROR_COUNT
+
+/** @brief Largest system attributes that can be held in RAM, in bytes
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PM_LOCAL_DB_MIRROR_SIZE
+
+/** @brief Keep the bonding data of recently connected peers in RAM
+ *
+ *  Hot peers are identified on connection, and their LTKs found on security requests, without
+ *  searching flash. Enable @ref PM_PEER_DATA_CACHE_ENABLED as well, with room for the bonding
+ *  data and system attributes of every hot peer, so that no flash is read on reconnection.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PM_HOT_PEERS_ENABLED
+
+/** @brief Number of hot peers
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PM_HOT_PEERS_COUNT
+
+/** @brief Resolve private addresses against IRKs kept in RAM
+ *
+ *  The IRKs of the bonded peers are loaded from flash once, and reloaded only when bonding data
+ *  changes. Addresses that have been resolved recently are recognized without encryption.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PM_IRK_TABLE_ENABLED
+
+/** @brief Number of IRKs in the table
+ *
+ *  If more peers with IRKs are bonded, addresses that no IRK in the table resolves are checked
+ *  against the bonding data in flash.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PM_IRK_TABLE_SIZE
+
+/** @brief Number of resolved addresses to remember
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PM_IRK_TABLE_RPA_CACHE_SIZE
+
+/** @brief Make room for new peer data by deleting the least recently used peer
+ *
+ *  When a write fails because flash is full, a garbage collection is run and the write retried.
+ *  If it fails again, the peer with the lowest rank (see @ref pm_peer_rank_highest) that is not
+ *  connected is deleted, and so on. @ref PM_EVT_STORAGE_FULL is only sent if no peer is left to
+ *  delete. Rank the peers on connection for this to delete the right ones.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PM_LRU_EVICTION_ENABLED
+
+/** @brief Compute the LESC DHKey in Peer Manager, in steps run from the scheduler
+ *
+ *  See @ref pm_lesc_private_key_set. Requires the ECC library and @ref app_scheduler.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PM_LESC_DHKEY_ENABLED
+
+/** @brief Bits of the private key processed in one scheduler event
+ *
+ *  A bit costs about 14 multiplications in the field, or about 0.3 ms on nRF51 with micro-ecc.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PM_LESC_DHKEY_STEP_BITS
+
 
 /** @} */
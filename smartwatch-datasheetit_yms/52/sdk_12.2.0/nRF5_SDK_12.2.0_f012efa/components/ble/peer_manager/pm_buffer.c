@@ -29,7 +29,7 @@
 ret_code_t pm_buffer_init(pm_buffer_t * p_buffer,
                           uint8_t     * p_buffer_memory,
                           uint32_t      buffer_memory_size,
-                          uint8_t     * p_mutex_memory,
+                          uint32_t    * p_mutex_memory,
                           uint32_t      mutex_memory_size,
                           uint32_t      n_blocks,
                           uint32_t      block_size)
@@ -64,32 +64,19 @@ uint8_t pm_buffer_block_acquire(pm_buffer_t * p_buffer, uint32_t n_blocks)
         return ( PM_BUFFER_INVALID_ID );
     }
 
-    uint8_t first_locked_mutex = PM_BUFFER_INVALID_ID;
+    if ((n_blocks == 0) || (n_blocks > p_buffer->n_blocks))
+    {
+        return ( PM_BUFFER_INVALID_ID );
+    }
 
-    for (uint8_t i = 0; i < p_buffer->n_blocks; i++)
+    uint16_t first_block = pm_mutex_lock_range(p_buffer->p_mutex, p_buffer->n_blocks, n_blocks);
+
+    if (first_block >= p_buffer->n_blocks)
     {
-        if (pm_mutex_lock(p_buffer->p_mutex, i))
-        {
-            if (first_locked_mutex == PM_BUFFER_INVALID_ID)
-            {
-                first_locked_mutex = i;
-            }
-            if ((i - first_locked_mutex + 1) == n_blocks)
-            {
-                return first_locked_mutex;
-            }
-        }
-        else if (first_locked_mutex != PM_BUFFER_INVALID_ID)
-        {
-            for (uint8_t j = first_locked_mutex; j < i; j++)
-            {
-                pm_buffer_release(p_buffer, j);
-            }
-            first_locked_mutex = PM_BUFFER_INVALID_ID;
-        }
+        return ( PM_BUFFER_INVALID_ID );
     }
 
-    return ( PM_BUFFER_INVALID_ID );
+    return ( (uint8_t)first_block );
 }
 
 
@@ -47,7 +47,7 @@ extern "C" {
 do                                                                        \
 {                                                                         \
     __ALIGN(4) static uint8_t buffer_memory[(n_blocks) * (block_size)];   \
-    __ALIGN(4) static uint8_t mutex_memory[MUTEX_STORAGE_SIZE(n_blocks)]; \
+    static uint32_t mutex_memory[MUTEX_STORAGE_WORDS(n_blocks)];          \
     err_code = pm_buffer_init((p_buffer),                                 \
                                buffer_memory,                             \
                               (n_blocks) * (block_size),                  \
@@ -61,7 +61,7 @@ do                                                                        \
 typedef struct
 {
     uint8_t * p_memory;   /**< The storage for all buffer entries. The size of the buffer must be n_blocks*block_size. */
-    uint8_t * p_mutex;    /**< A mutex group with one mutex for each buffer entry. */
+    uint32_t * p_mutex;   /**< A mutex group with one mutex for each buffer entry. */
     uint32_t  n_blocks;   /**< The number of allocatable blocks in the buffer. */
     uint32_t  block_size; /**< The size of each block in the buffer. */
 } pm_buffer_t;
@@ -74,7 +74,7 @@ typedef struct
  *                                 n_blocks*block_size.
  * @param[in]  p_mutex_memory      The memory for the mutexes. This must be at least
  *                                 @ref MUTEX_STORAGE_SIZE(n_blocks).
- * @param[in]  mutex_memory_size   The size of p_mutex_memory.
+ * @param[in]  mutex_memory_size   The size of p_mutex_memory, in bytes.
  * @param[in]  n_blocks            The number of blocks in the buffer.
  * @param[in]  block_size          The size of each block.
  *
@@ -84,13 +84,16 @@ typedef struct
 ret_code_t pm_buffer_init(pm_buffer_t * p_buffer,
                           uint8_t     * p_buffer_memory,
                           uint32_t      buffer_memory_size,
-                          uint8_t     * p_mutex_memory,
+                          uint32_t    * p_mutex_memory,
                           uint32_t      mutex_memory_size,
                           uint32_t      n_blocks,
                           uint32_t      block_size);
 
 
 /**@brief Function for acquiring a buffer block in a buffer.
+ *
+ * @details The blocks are found and locked without a critical region, so this function can be
+ *          called from any interrupt priority.
  *
  * @param[in]  p_buffer  The buffer instance acquire from.
  * @param[in]  n_blocks  The number of contiguous blocks to acquire.
@@ -16,29 +16,79 @@
 
 #include <stdbool.h>
 #include <string.h>
+#include "nrf.h"
 #include "nrf_error.h"
 #include "app_util_platform.h"
 
 
+#if (__CORTEX_M >= 0x03U)
+#define MUTEX_USE_EXCLUSIVE_ACCESS  1   //!< The core has LDREX/STREX.
+#else
+#define MUTEX_USE_EXCLUSIVE_ACCESS  0
+#endif
 
-/**@brief Locks the mutex defined by the mask.
+#define MUTEX_WORD(mutex_id)    ((mutex_id) >> 5)                //!< Index of the word holding a mutex.
+#define MUTEX_BIT(mutex_id)     ((mutex_id) & 0x1F)              //!< Position of a mutex in its word.
+#define MUTEX_MASK(mutex_id)    (1UL << MUTEX_BIT(mutex_id))     //!< Mask of a mutex in its word.
+
+
+
+/**@brief Returns the position of the lowest bit set in a word.
  *
- * @param p_mutex pointer to the mutex storage.
- * @param mutex_mask the mask identifying the mutex position.
+ * @param word A word that is not 0.
+ */
+__STATIC_INLINE uint32_t lowest_bit_get(uint32_t word)
+{
+    return __CLZ(__RBIT(word));
+}
+
+
+/**@brief Returns the mask of @p n_bits bits starting from bit @p first.
  *
- * @retval true if the mutex could be locked.
- * @retval false if the mutex was already locked.
+ * @param first   The position of the first bit, 0 to 31.
+ * @param n_bits  The number of bits, 1 to (32 - first).
  */
-static bool lock_by_mask(uint8_t * p_mutex, uint8_t mutex_mask)
+__STATIC_INLINE uint32_t bits_mask_get(uint32_t first, uint32_t n_bits)
 {
+    uint32_t mask = (n_bits >= 32) ? UINT32_MAX : ((1UL << n_bits) - 1);
+
+    return (mask << first);
+}
+
+
+/**@brief Locks the mutexes defined by the mask.
+ *
+ * @param p_word pointer to the word of the mutex storage.
+ * @param mutex_mask the mask identifying the mutex positions.
+ *
+ * @retval true if the mutexes could be locked.
+ * @retval false if one of the mutexes was already locked. None was locked then.
+ */
+static bool lock_by_mask(uint32_t * p_word, uint32_t mutex_mask)
+{
+#if MUTEX_USE_EXCLUSIVE_ACCESS
+    uint32_t word;
+
+    do
+    {
+        word = __LDREXW(p_word);
+        if ((word & mutex_mask) != 0)
+        {
+            __CLREX();
+            return false;
+        }
+    } while (__STREXW(word | mutex_mask, p_word) != 0);
+
+    return true;
+#else
     bool success = false;
 
-    if ( (*p_mutex & mutex_mask) == 0 )
+    if ( (*p_word & mutex_mask) == 0 )
     {
         CRITICAL_REGION_ENTER();
-        if ( (*p_mutex & mutex_mask) == 0 )
+        if ( (*p_word & mutex_mask) == 0 )
         {
-            *p_mutex |= mutex_mask;
+            *p_word |= mutex_mask;
 
             success = true;
         }
@@ -46,10 +96,118 @@ static bool lock_by_mask(uint8_t * p_mutex, uint8_t mutex_mask)
     }
 
     return ( success );
+#endif
+}
+
+
+/**@brief Unlocks the mutexes defined by the mask.
+ *
+ * @param p_word pointer to the word of the mutex storage.
+ * @param mutex_mask the mask identifying the mutex positions.
+ */
+static void unlock_by_mask(uint32_t * p_word, uint32_t mutex_mask)
+{
+#if MUTEX_USE_EXCLUSIVE_ACCESS
+    uint32_t word;
+
+    do
+    {
+        word = __LDREXW(p_word);
+    } while (__STREXW(word & ~mutex_mask, p_word) != 0);
+#else
+    CRITICAL_REGION_ENTER();
+    *p_word &= ~mutex_mask;
+    CRITICAL_REGION_EXIT();
+#endif
 }
 
 
-void pm_mutex_init(uint8_t * p_mutex, uint16_t mutex_size)
+/**@brief Finds the first mutex from @p first_id that is locked or unlocked.
+ *
+ * @param p_mutex pointer to the mutex storage.
+ * @param mutex_size the number of mutexes in the group.
+ * @param first_id the first mutex to look at.
+ * @param locked whether to look for a locked mutex, or an unlocked one.
+ *
+ * @return The id of the mutex, or @p mutex_size if there is none.
+ */
+static uint32_t mutex_find(uint32_t const * p_mutex,
+                           uint32_t         mutex_size,
+                           uint32_t         first_id,
+                           bool             locked)
+{
+    while (first_id < mutex_size)
+    {
+        uint32_t word = p_mutex[MUTEX_WORD(first_id)];
+
+        if (!locked)
+        {
+            word = ~word;
+        }
+        word &= (UINT32_MAX << MUTEX_BIT(first_id));
+
+        if (word != 0)
+        {
+            return MIN(mutex_size, (first_id & ~0x1FUL) + lowest_bit_get(word));
+        }
+        first_id = (first_id & ~0x1FUL) + 32;
+    }
+
+    return mutex_size;
+}
+
+
+/**@brief Unlocks a run of mutexes, one word at a time.
+ *
+ * @param p_mutex pointer to the mutex storage.
+ * @param first_id the first mutex of the run.
+ * @param n_mutexes the number of mutexes in the run.
+ */
+static void range_unlock(uint32_t * p_mutex, uint32_t first_id, uint32_t n_mutexes)
+{
+    while (n_mutexes > 0)
+    {
+        uint32_t n_bits = MIN(n_mutexes, 32 - MUTEX_BIT(first_id));
+
+        unlock_by_mask(&p_mutex[MUTEX_WORD(first_id)], bits_mask_get(MUTEX_BIT(first_id), n_bits));
+        first_id  += n_bits;
+        n_mutexes -= n_bits;
+    }
+}
+
+
+/**@brief Locks a run of mutexes, one word at a time.
+ *
+ * @param p_mutex pointer to the mutex storage.
+ * @param first_id the first mutex of the run.
+ * @param n_mutexes the number of mutexes in the run.
+ *
+ * @retval true if the whole run could be locked.
+ * @retval false if one of the mutexes was already locked. None was locked then.
+ */
+static bool range_lock(uint32_t * p_mutex, uint32_t first_id, uint32_t n_mutexes)
+{
+    uint32_t id        = first_id;
+    uint32_t remaining = n_mutexes;
+
+    while (remaining > 0)
+    {
+        uint32_t n_bits = MIN(remaining, 32 - MUTEX_BIT(id));
+
+        if (!lock_by_mask(&p_mutex[MUTEX_WORD(id)], bits_mask_get(MUTEX_BIT(id), n_bits)))
+        {
+            range_unlock(p_mutex, first_id, id - first_id);
+            return false;
+        }
+        id        += n_bits;
+        remaining -= n_bits;
+    }
+
+    return true;
+}
+
+
+void pm_mutex_init(uint32_t * p_mutex, uint16_t mutex_size)
 {
     if (p_mutex != NULL)
     {
@@ -58,11 +216,11 @@ void pm_mutex_init(uint8_t * p_mutex, uint16_t mutex_size)
 }
 
 
-bool pm_mutex_lock(uint8_t * p_mutex, uint16_t mutex_id)
+bool pm_mutex_lock(uint32_t * p_mutex, uint16_t mutex_id)
 {
     if (p_mutex != NULL)
     {
-        return ( lock_by_mask(&(p_mutex[mutex_id >> 3]), (1 << (mutex_id & 0x07))) );
+        return ( lock_by_mask(&(p_mutex[MUTEX_WORD(mutex_id)]), MUTEX_MASK(mutex_id)) );
     }
     else
     {
@@ -71,43 +229,61 @@ bool pm_mutex_lock(uint8_t * p_mutex, uint16_t mutex_id)
 }
 
 
-void pm_mutex_unlock(uint8_t * p_mutex, uint16_t mutex_id)
+void pm_mutex_unlock(uint32_t * p_mutex, uint16_t mutex_id)
 {
-    uint8_t mutex_base = mutex_id >> 3;
-    uint8_t mutex_mask = (1 << (mutex_id & 0x07));
-
     if   ((p_mutex != NULL)
-       && (p_mutex[mutex_base] & mutex_mask))
+       && (p_mutex[MUTEX_WORD(mutex_id)] & MUTEX_MASK(mutex_id)))
     {
-        CRITICAL_REGION_ENTER();
-        p_mutex[mutex_base] &= ~mutex_mask;
-        CRITICAL_REGION_EXIT();
+        unlock_by_mask(&(p_mutex[MUTEX_WORD(mutex_id)]), MUTEX_MASK(mutex_id));
     }
 }
 
 
-uint16_t pm_mutex_lock_first_available(uint8_t * p_mutex, uint16_t mutex_size)
+uint16_t pm_mutex_lock_first_available(uint32_t * p_mutex, uint16_t mutex_size)
 {
-    if (p_mutex != NULL)
+    return pm_mutex_lock_range(p_mutex, mutex_size, 1);
+}
+
+
+uint16_t pm_mutex_lock_range(uint32_t * p_mutex, uint16_t mutex_size, uint16_t n_mutexes)
+{
+    uint32_t first_id = 0;
+
+    if ((p_mutex == NULL) || (n_mutexes == 0))
+    {
+        return ( mutex_size );
+    }
+
+    for (;;)
     {
-        for ( uint16_t i = 0; i < mutex_size; i++ )
+        first_id = mutex_find(p_mutex, mutex_size, first_id, false);
+        if ((first_id + n_mutexes) > mutex_size)
         {
-            if ( lock_by_mask(&(p_mutex[i >> 3]), 1 << (i & 0x07)) )
-            {
-                return ( i );
-            }
+            return ( mutex_size );
         }
-    }
 
-    return ( mutex_size );
+        uint32_t end_id = mutex_find(p_mutex, mutex_size, first_id, true);
+
+        if ((end_id - first_id) < n_mutexes)
+        {
+            // The run is too short, skip it.
+            first_id = end_id;
+        }
+        else if (range_lock(p_mutex, first_id, n_mutexes))
+        {
+            return ( first_id );
+        }
+        // Else another context locked a mutex of the run first. Look again from the same place,
+        // the mutex it locked will now end the run.
+    }
 }
 
 
-bool pm_mutex_lock_status_get(uint8_t * p_mutex, uint16_t mutex_id)
+bool pm_mutex_lock_status_get(uint32_t * p_mutex, uint16_t mutex_id)
 {
     if (p_mutex != NULL)
     {
-        return ( (p_mutex[mutex_id >> 3] & (1 << (mutex_id & 0x07))) );
+        return ( (p_mutex[MUTEX_WORD(mutex_id)] & MUTEX_MASK(mutex_id)) != 0 );
     }
     else
     {
@@ -28,14 +28,26 @@ extern "C" {
  * @ingroup peer_manager
  * @{
  * @brief An internal module of @ref peer_manager. This module provides thread-safe mutexes.
+ *
+ * @details The mutexes of a group are bits in an array of 32-bit words. A mutex is locked by
+ *          setting its bit with an exclusive load/store (LDREX/STREX), so locking and unlocking
+ *          are safe from any interrupt priority without a critical region. Cores without
+ *          exclusive accesses (nRF51) use a critical region instead.
  */
 
 
-/**@brief Defines the storage size of a specified mutex group.
+/**@brief Defines the storage size of a specified mutex group, in words.
  *
  * @param number_of_mutexes the number of mutexes in the group.
  */
-#define MUTEX_STORAGE_SIZE(number_of_mutexes) ((7 + (number_of_mutexes)) >> 3)
+#define MUTEX_STORAGE_WORDS(number_of_mutexes) ((31 + (number_of_mutexes)) >> 5)
+
+
+/**@brief Defines the storage size of a specified mutex group, in bytes.
+ *
+ * @param number_of_mutexes the number of mutexes in the group.
+ */
+#define MUTEX_STORAGE_SIZE(number_of_mutexes) (MUTEX_STORAGE_WORDS(number_of_mutexes) * sizeof(uint32_t))
 
 
 /**@brief Initializes a mutex group.
@@ -43,7 +55,7 @@ extern "C" {
  * @param[in] p_mutex     Pointer to the mutex group. See @ref MUTEX_STORAGE_SIZE().
  * @param[in] mutex_size  The size of the mutex group in number of mutexes.
  */
-void pm_mutex_init(uint8_t * p_mutex, uint16_t mutex_size);
+void pm_mutex_init(uint32_t * p_mutex, uint16_t mutex_size);
 
 
 /**@brief Locks the mutex specified by the bit id.
@@ -54,7 +66,7 @@ void pm_mutex_init(uint8_t * p_mutex, uint16_t mutex_size);
  * @retval true   if it was possible to lock the mutex.
  * @retval false  otherwise.
  */
-bool pm_mutex_lock(uint8_t * p_mutex, uint16_t mutex_bit_id);
+bool pm_mutex_lock(uint32_t * p_mutex, uint16_t mutex_bit_id);
 
 
 /**@brief Locks the first unlocked mutex within the mutex group.
@@ -65,7 +77,23 @@ bool pm_mutex_lock(uint8_t * p_mutex, uint16_t mutex_bit_id);
  * @return The first unlocked mutex id in the group.
  * @retval group-size  if there was no unlocked mutex available.
  */
-uint16_t pm_mutex_lock_first_available(uint8_t * p_mutex, uint16_t mutex_size);
+uint16_t pm_mutex_lock_first_available(uint32_t * p_mutex, uint16_t mutex_size);
+
+
+/**@brief Locks the first run of contiguous unlocked mutexes within the mutex group.
+ *
+ * @details The search skips whole words of locked mutexes, and whole runs of unlocked mutexes
+ *          that are too short. The run is locked one word at a time. If another context locks a
+ *          mutex of the run first, the words already locked are unlocked and the search goes on.
+ *
+ * @param[in, out] p_mutex     Pointer to the mutex group.
+ * @param[in]      mutex_size  The size of the mutex group.
+ * @param[in]      n_mutexes   The number of contiguous mutexes to lock. Must not be 0.
+ *
+ * @return The id of the first mutex of the locked run.
+ * @retval group-size  if there was no run of unlocked mutexes long enough.
+ */
+uint16_t pm_mutex_lock_range(uint32_t * p_mutex, uint16_t mutex_size, uint16_t n_mutexes);
 
 
 /**@brief Unlocks the mutex specified by the bit id.
@@ -73,7 +101,7 @@ uint16_t pm_mutex_lock_first_available(uint8_t * p_mutex, uint16_t mutex_size);
  * @param[in, out] p_mutex       Pointer to the mutex group.
  * @param[in]      mutex_bit_id  The bit id of the mutex.
  */
-void pm_mutex_unlock(uint8_t * p_mutex, uint16_t mutex_bit_id);
+void pm_mutex_unlock(uint32_t * p_mutex, uint16_t mutex_bit_id);
 
 
 /**@brief Gets the locking status of the specified mutex.
@@ -84,7 +112,7 @@ void pm_mutex_unlock(uint8_t * p_mutex, uint16_t mutex_bit_id);
  * @retval true   if the mutex was locked.
  * @retval false  otherwise.
  */
-bool pm_mutex_lock_status_get(uint8_t * p_mutex, uint16_t mutex_bit_id);
+bool pm_mutex_lock_status_get(uint32_t * p_mutex, uint16_t mutex_bit_id);
 
 
 
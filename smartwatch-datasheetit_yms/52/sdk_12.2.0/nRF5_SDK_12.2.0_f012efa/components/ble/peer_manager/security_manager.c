@@ -19,6 +19,15 @@
 #include "peer_database.h"
 #include "ble_conn_state.h"
 #include "id_manager.h"
+#if NRF_MODULE_ENABLED(PM_LESC_DHKEY)
+#include "ecc.h"
+#include "app_scheduler.h"
+#include "sdk_mapped_flags.h"
+
+#ifndef PM_LESC_DHKEY_STEP_BITS
+#define PM_LESC_DHKEY_STEP_BITS     (16)    //!< Bits of the private key processed in one scheduler event.
+#endif
+#endif
 
 
 // The number of registered event handlers.
@@ -49,6 +58,15 @@ static ble_conn_state_user_flag_id_t   m_flag_params_reply_pending_busy       =
 static ble_conn_state_user_flag_id_t   m_flag_params_reply_pending_flash_full = BLE_CONN_STATE_USER_FLAG_INVALID;
 static ble_conn_state_user_flag_id_t   m_flag_reject_pairing                  = BLE_CONN_STATE_USER_FLAG_INVALID;
 
+#if NRF_MODULE_ENABLED(PM_LESC_DHKEY)
+static uint8_t const                 * m_p_private_key;                                         /**< The LESC private key, see @ref sm_lesc_private_key_set. */
+static ble_gap_lesc_p256_pk_t const  * m_dhkey_requests[SDK_MAPPED_FLAGS_N_KEYS];               /**< The peer public key of each connection waiting for a DHKey, by connection index. */
+static uint16_t                        m_dhkey_conn_handle = BLE_CONN_HANDLE_INVALID;          /**< The connection whose DHKey is being computed. */
+static bool                            m_dhkey_scheduled;                                       /**< Whether @ref dhkey_step is in the scheduler queue. */
+static ecc_p256_ss_ctx_t               m_dhkey_ctx;                                             /**< The DHKey computation. */
+__ALIGN(4) static ble_gap_lesc_dhkey_t m_dhkey;                                                 /**< The computed DHKey. */
+#endif
+
 
 static void evt_send(sm_evt_t * p_event)
 {
@@ -359,6 +377,184 @@ void sm_pdb_evt_handler(pdb_evt_t const * p_event)
 }
 
 
+#if NRF_MODULE_ENABLED(PM_LESC_DHKEY)
+static void dhkey_step(void * p_event_data, uint16_t event_size);
+
+
+/**@brief Function for stopping the pairing of a link whose DHKey cannot be computed.
+ *
+ * @param[in]  conn_handle  The link.
+ * @param[in]  err_code     The reason, reported in @ref SM_EVT_ERROR_UNEXPECTED.
+ */
+static void dhkey_fail(uint16_t conn_handle, ret_code_t err_code)
+{
+    sm_evt_t evt =
+    {
+        .evt_id      = SM_EVT_ERROR_UNEXPECTED,
+        .conn_handle = conn_handle,
+        .params      = {.error_unexpected = {.error = err_code}}
+    };
+
+    // The SoftDevice cannot be told that the DHKey is invalid. A DHKey replied anyway must not be
+    // predictable, so the link is disconnected instead.
+    (void)sd_ble_gap_disconnect(conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+    evt_send(&evt);
+}
+
+
+/**@brief Function for putting @ref dhkey_step in the scheduler queue, if it is not there yet. */
+static void dhkey_schedule(void)
+{
+    if (!m_dhkey_scheduled)
+    {
+        ret_code_t err_code = app_sched_event_put(NULL, 0, dhkey_step);
+        if (err_code == NRF_SUCCESS)
+        {
+            m_dhkey_scheduled = true;
+        }
+        else if (m_dhkey_conn_handle != BLE_CONN_HANDLE_INVALID)
+        {
+            uint16_t conn_handle = m_dhkey_conn_handle;
+
+            m_dhkey_conn_handle = BLE_CONN_HANDLE_INVALID;
+            dhkey_fail(conn_handle, err_code);
+        }
+    }
+}
+
+
+/**@brief Function for starting the DHKey computation of the next connection waiting for one.
+ *
+ * @retval true   If a computation was started.
+ * @retval false  If no connection is waiting.
+ */
+static bool dhkey_next_start(void)
+{
+    sdk_mapped_flags_key_list_t conn_handles = ble_conn_state_conn_handles();
+
+    for (uint32_t i = 0; i < conn_handles.len; i++)
+    {
+        uint16_t                       conn_handle = conn_handles.flag_keys[i];
+        uint16_t                       conn_idx    = ble_conn_state_conn_idx(conn_handle);
+        ble_gap_lesc_p256_pk_t const * p_peer_pk;
+
+        if (conn_idx >= SDK_MAPPED_FLAGS_N_KEYS)
+        {
+            continue;
+        }
+
+        p_peer_pk = m_dhkey_requests[conn_idx];
+        if (p_peer_pk == NULL)
+        {
+            continue;
+        }
+        m_dhkey_requests[conn_idx] = NULL;
+
+        ret_code_t err_code = ecc_p256_shared_secret_start(&m_dhkey_ctx, m_p_private_key, p_peer_pk->pk);
+        if (err_code == NRF_SUCCESS)
+        {
+            m_dhkey_conn_handle = conn_handle;
+            return true;
+        }
+
+        dhkey_fail(conn_handle, err_code);
+    }
+
+    return false;
+}
+
+
+/**@brief Function for computing a part of a DHKey, from the scheduler.
+ *
+ * @details A few bits of the private key are processed, then this function puts itself back at
+ *          the end of the scheduler queue, so that the other events are not held up. The reply
+ *          is given to the SoftDevice once the DHKey is computed.
+ */
+static void dhkey_step(void * p_event_data, uint16_t event_size)
+{
+    UNUSED_PARAMETER(p_event_data);
+    UNUSED_PARAMETER(event_size);
+
+    m_dhkey_scheduled = false;
+
+    if ((m_dhkey_conn_handle == BLE_CONN_HANDLE_INVALID) && !dhkey_next_start())
+    {
+        return;
+    }
+
+    ret_code_t err_code = ecc_p256_shared_secret_continue(&m_dhkey_ctx,
+                                                          PM_LESC_DHKEY_STEP_BITS,
+                                                          m_dhkey.key);
+    if (err_code != NRF_ERROR_BUSY)
+    {
+        uint16_t conn_handle = m_dhkey_conn_handle;
+
+        m_dhkey_conn_handle = BLE_CONN_HANDLE_INVALID;
+
+        if (err_code == NRF_SUCCESS)
+        {
+            err_code = sd_ble_gap_lesc_dhkey_reply(conn_handle, &m_dhkey);
+            if ((err_code != NRF_SUCCESS) && (err_code != BLE_ERROR_INVALID_CONN_HANDLE))
+            {
+                dhkey_fail(conn_handle, err_code);
+            }
+        }
+        else
+        {
+            dhkey_fail(conn_handle, err_code);
+        }
+
+        memset(&m_dhkey, 0, sizeof(m_dhkey));
+        if (!dhkey_next_start())
+        {
+            return;
+        }
+    }
+
+    dhkey_schedule();
+}
+
+
+/**@brief Function for handling the BLE events of the DHKey computation.
+ *
+ * @param[in]  p_ble_evt  The event.
+ */
+static void dhkey_ble_evt_handle(ble_evt_t * p_ble_evt)
+{
+    uint16_t conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+    uint16_t conn_idx;
+
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GAP_EVT_LESC_DHKEY_REQUEST:
+            conn_idx = ble_conn_state_conn_idx(conn_handle);
+            if ((m_p_private_key != NULL) && (conn_idx < SDK_MAPPED_FLAGS_N_KEYS))
+            {
+                m_dhkey_requests[conn_idx] = p_ble_evt->evt.gap_evt.params.lesc_dhkey_request.p_pk_peer;
+                dhkey_schedule();
+            }
+            break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            conn_idx = ble_conn_state_conn_idx(conn_handle);
+            if (conn_idx < SDK_MAPPED_FLAGS_N_KEYS)
+            {
+                m_dhkey_requests[conn_idx] = NULL;
+            }
+            if (m_dhkey_conn_handle == conn_handle)
+            {
+                // The next step moves on to the next connection.
+                m_dhkey_conn_handle = BLE_CONN_HANDLE_INVALID;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+#endif // NRF_MODULE_ENABLED(PM_LESC_DHKEY)
+
+
 /**@brief Funtion for initializing a BLE Connection State user flag.
  *
  * @param[out] flag_id  The flag to initialize.
@@ -401,6 +597,9 @@ void sm_ble_evt_handler(ble_evt_t * p_ble_evt)
 
     smd_ble_evt_handler(p_ble_evt);
     link_secure_pending_process(m_flag_link_secure_pending_busy);
+#if NRF_MODULE_ENABLED(PM_LESC_DHKEY)
+    dhkey_ble_evt_handle(p_ble_evt);
+#endif
 }
 
 
@@ -524,6 +723,26 @@ ret_code_t sm_lesc_public_key_set(ble_gap_lesc_p256_pk_t * p_public_key)
 }
 
 
+ret_code_t sm_lesc_private_key_set(uint8_t const * p_private_key)
+{
+    NRF_PM_DEBUG_CHECK(m_module_initialized);
+
+#if NRF_MODULE_ENABLED(PM_LESC_DHKEY)
+    if ((p_private_key != NULL) && !is_word_aligned(p_private_key))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    m_p_private_key = p_private_key;
+
+    return NRF_SUCCESS;
+#else
+    UNUSED_PARAMETER(p_private_key);
+    return NRF_ERROR_NOT_SUPPORTED;
+#endif
+}
+
+
 ret_code_t sm_sec_params_reply(uint16_t conn_handle, ble_gap_sec_params_t * p_sec_params)
 {
     NRF_PM_DEBUG_CHECK(m_module_initialized);
@@ -132,6 +132,19 @@ void sm_conn_sec_config_reply(uint16_t conn_handle, pm_conn_sec_config_t * p_con
 ret_code_t sm_lesc_public_key_set(ble_gap_lesc_p256_pk_t * p_public_key);
 
 
+/**@brief Function for specifying the private key with which the DHKey is computed in LESC pairing.
+ *
+ * @details See @ref pm_lesc_private_key_set.
+ *
+ * @param[in]  p_private_key  The private key, or NULL.
+ *
+ * @retval NRF_SUCCESS              The key was set.
+ * @retval NRF_ERROR_INVALID_ADDR   The key is not aligned to a 4-byte boundary.
+ * @retval NRF_ERROR_NOT_SUPPORTED  PM_LESC_DHKEY_ENABLED is not set.
+ */
+ret_code_t sm_lesc_private_key_set(uint8_t const * p_private_key);
+
+
 /**@brief Function for providing pairing and bonding parameters to use for the current pairing
  *        procedure on a connection.
  *
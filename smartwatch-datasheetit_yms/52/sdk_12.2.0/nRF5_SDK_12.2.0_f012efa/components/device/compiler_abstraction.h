@@ -55,6 +55,12 @@
         #define __PACKED            __packed
     #endif
 
+    /* The scatter file must place .ramfunc in a RAM execution region, for example with
+       "*(.ramfunc)" in RW_IRAM1. */
+    #ifndef __RAMFUNC
+        #define __RAMFUNC           __attribute__((section(".ramfunc")))
+    #endif
+
     #define GET_SP()                __current_sp()
 
 #elif defined ( __ICCARM__ )
@@ -79,7 +85,11 @@
     #ifndef __PACKED
         #define __PACKED            __packed
     #endif
-    
+
+    #ifndef __RAMFUNC
+        #define __RAMFUNC           __ramfunc
+    #endif
+
     #define GET_SP()                __get_SP()
 
 #elif defined   ( __GNUC__ )
@@ -104,6 +114,13 @@
         #define __PACKED           __attribute__((packed)) 
     #endif
 
+    /* Placed with the initialized data by the *(.data*) rule of the linker scripts, and copied
+       to RAM by the startup code. Calls from flash that are out of range of a BL instruction go
+       through veneers that the linker adds. */
+    #ifndef __RAMFUNC
+        #define __RAMFUNC           __attribute__((section(".data.ramfunc"), noinline))
+    #endif
+
     #define GET_SP()                gcc_current_sp()
 
     static inline unsigned int gcc_current_sp(void)
@@ -135,6 +152,11 @@
         #define __PACKED
     #endif
 
+    /* Not defined for TASKING, functions run from flash. */
+    #ifndef __RAMFUNC
+        #define __RAMFUNC
+    #endif
+
     #define GET_SP()                __get_MSP()
 
 #endif
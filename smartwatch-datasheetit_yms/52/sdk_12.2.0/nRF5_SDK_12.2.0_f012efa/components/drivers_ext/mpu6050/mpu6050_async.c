@@ -0,0 +1,413 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "mpu6050_async.h"
+#include "nrf_drv_gpiote.h"
+#include "nrf_drv_ppi.h"
+#include "app_util.h"
+#include "app_util_platform.h"
+#include "sdk_common.h"
+
+/*lint ++flb "Enter library region" */
+
+#define ADDRESS_SMPLRT_DIV   (0x19U) // !< Sample rate divider. Followed by CONFIG, GYRO_CONFIG and ACCEL_CONFIG.
+#define ADDRESS_FIFO_EN      (0x23U) // !< Selects the measurements that are stored in the FIFO.
+#define ADDRESS_INT_PIN_CFG  (0x37U) // !< Interrupt pin configuration. Followed by INT_ENABLE.
+#define ADDRESS_USER_CTRL    (0x6AU) // !< Enables and resets the FIFO.
+#define ADDRESS_PWR_MGMT_1   (0x6BU) // !< Power management and clock source.
+#define ADDRESS_FIFO_COUNTH  (0x72U) // !< Number of bytes in the FIFO, high byte first.
+#define ADDRESS_FIFO_R_W     (0x74U) // !< FIFO data.
+#define ADDRESS_WHO_AM_I     (0x75U) // !< WHO_AM_I register identifies the device. Expected value is 0x68.
+
+#define FIFO_EN_ACCEL_GYRO   (0x78U) // !< Stores the accelerometer and the three gyroscope axes in the FIFO.
+#define INT_ENABLE_DATA_RDY  (0x01U) // !< Pulses the interrupt pin (50 us, active high) for every sample.
+#define USER_CTRL_FIFO_EN    (0x40U) // !< Enables the FIFO.
+#define USER_CTRL_FIFO_RESET (0x04U) // !< Resets the FIFO while it is disabled.
+#define PWR_MGMT_1_CLK_PLL_X (0x01U) // !< Wakes the sensor, with the X gyroscope PLL as clock.
+
+#define FIFO_SIZE            1024    // !< Size of the FIFO of the sensor, in bytes.
+#define BURST_CHUNK_MAX      (255 - (255 % sizeof(mpu6050_async_sample_t))) // !< Largest read of whole samples in one EasyDMA transfer.
+#define BURST_CHUNKS_MAX     CEIL_DIV(MPU6050_ASYNC_WATERMARK_MAX * sizeof(mpu6050_async_sample_t), BURST_CHUNK_MAX)
+
+static const uint8_t expected_who_am_i = 0x68U; // !< Expected value to get from WHO_AM_I register.
+
+static mpu6050_async_config_t m_config;             // !< Copy of the driver configuration.
+static nrf_ppi_channel_t      m_ppi_channel;        // !< Connects the interrupt pin to the TIMER.
+static bool                   m_initialized;        // !< The driver is initialized.
+static bool volatile          m_running;            // !< The sensor is configured and samples are counted.
+static bool volatile          m_burst_in_progress;  // !< The burst transaction is scheduled.
+static uint8_t volatile       m_bursts_owed;        // !< Number of watermarks reached and not read yet.
+
+// All data of the transfers is in RAM, for EasyDMA.
+static uint8_t m_reg_who_am_i     = ADDRESS_WHO_AM_I;
+static uint8_t m_reg_fifo_count   = ADDRESS_FIFO_COUNTH;
+static uint8_t m_reg_fifo_r_w     = ADDRESS_FIFO_R_W;
+static uint8_t m_who_am_i;
+static uint8_t m_fifo_count[2];
+static uint8_t m_cfg_pwr[]        = {ADDRESS_PWR_MGMT_1, PWR_MGMT_1_CLK_PLL_X};
+static uint8_t m_cfg_rate[5]      = {ADDRESS_SMPLRT_DIV};
+static uint8_t m_cfg_fifo_reset[] = {ADDRESS_USER_CTRL, USER_CTRL_FIFO_RESET};
+static uint8_t m_cfg_fifo_en[]    = {ADDRESS_FIFO_EN, FIFO_EN_ACCEL_GYRO};
+static uint8_t m_cfg_int[]        = {ADDRESS_INT_PIN_CFG, 0x00U, INT_ENABLE_DATA_RDY};
+static uint8_t m_cfg_user_en[]    = {ADDRESS_USER_CTRL, USER_CTRL_FIFO_EN};
+
+static mpu6050_async_sample_t m_samples[MPU6050_ASYNC_WATERMARK_MAX]; // !< Raw FIFO data, converted in place.
+
+static app_twi_transfer_t    m_config_transfers[8];
+static app_twi_transfer_t    m_fifo_reset_transfers[2];
+static app_twi_transfer_t    m_burst_transfers[2 + 2 * BURST_CHUNKS_MAX];
+static app_twi_transaction_t m_config_transaction;
+static app_twi_transaction_t m_fifo_reset_transaction;
+static app_twi_transaction_t m_burst_transaction;
+
+
+static void evt_send(mpu6050_async_evt_type_t type, ret_code_t err_code)
+{
+    mpu6050_async_evt_t evt;
+
+    evt.type            = type;
+    evt.params.err_code = err_code;
+    m_config.evt_handler(&evt);
+}
+
+
+static void burst_schedule(void)
+{
+    ret_code_t err_code = app_twi_schedule(m_config.p_app_twi, &m_burst_transaction);
+    if (err_code != NRF_SUCCESS)
+    {
+        CRITICAL_REGION_ENTER();
+        m_bursts_owed       = 0;
+        m_burst_in_progress = false;
+        CRITICAL_REGION_EXIT();
+        evt_send(MPU6050_ASYNC_EVT_ERROR, err_code);
+    }
+}
+
+
+/**@brief Handler for the TIMER, called when the watermark is reached. */
+static void timer_handler(nrf_timer_event_t event_type, void * p_context)
+{
+    bool start;
+
+    UNUSED_PARAMETER(p_context);
+
+    if ((event_type != NRF_TIMER_EVENT_COMPARE0) || !m_running)
+    {
+        return;
+    }
+
+    // The burst transaction is static, so it is only scheduled again when it has finished.
+    CRITICAL_REGION_ENTER();
+    m_bursts_owed++;
+    start               = !m_burst_in_progress;
+    m_burst_in_progress = true;
+    CRITICAL_REGION_EXIT();
+
+    if (start)
+    {
+        burst_schedule();
+    }
+}
+
+
+static void fifo_overflow_handle(void)
+{
+    ret_code_t err_code;
+
+    // Samples in the FIFO are no longer aligned, so the FIFO is emptied and counting restarts.
+    CRITICAL_REGION_ENTER();
+    m_bursts_owed = 0;
+    nrf_drv_timer_clear(m_config.p_timer);
+    CRITICAL_REGION_EXIT();
+
+    err_code = app_twi_schedule(m_config.p_app_twi, &m_fifo_reset_transaction);
+    if (err_code != NRF_SUCCESS)
+    {
+        evt_send(MPU6050_ASYNC_EVT_ERROR, err_code);
+    }
+    evt_send(MPU6050_ASYNC_EVT_OVERFLOW, NRF_SUCCESS);
+}
+
+
+static void burst_callback(ret_code_t result, void * p_user_data)
+{
+    bool more;
+
+    UNUSED_PARAMETER(p_user_data);
+
+    if (!m_running)
+    {
+        m_burst_in_progress = false;
+        return;
+    }
+
+    if (result != NRF_SUCCESS)
+    {
+        evt_send(MPU6050_ASYNC_EVT_ERROR, result);
+    }
+    else if (uint16_big_decode(m_fifo_count) >= FIFO_SIZE)
+    {
+        fifo_overflow_handle();
+    }
+    else
+    {
+        mpu6050_async_evt_t evt;
+        uint8_t const     * p_raw = (uint8_t const *)m_samples;
+        int16_t           * p_val = (int16_t *)m_samples;
+        uint32_t            count = m_config.watermark * sizeof(mpu6050_async_sample_t) / sizeof(int16_t);
+
+        // The sensor sends every value high byte first.
+        for (uint32_t i = 0; i < count; i++)
+        {
+            p_val[i] = (int16_t)uint16_big_decode(&p_raw[2 * i]);
+        }
+
+        evt.type                     = MPU6050_ASYNC_EVT_SAMPLES;
+        evt.params.samples.p_samples = m_samples;
+        evt.params.samples.count     = m_config.watermark;
+        m_config.evt_handler(&evt);
+    }
+
+    CRITICAL_REGION_ENTER();
+    if (m_bursts_owed > 0)
+    {
+        m_bursts_owed--;
+    }
+    more                = (m_bursts_owed > 0);
+    m_burst_in_progress = more;
+    CRITICAL_REGION_EXIT();
+
+    if (more)
+    {
+        burst_schedule();
+    }
+}
+
+
+static void fifo_reset_callback(ret_code_t result, void * p_user_data)
+{
+    UNUSED_PARAMETER(p_user_data);
+
+    if (m_running && (result != NRF_SUCCESS))
+    {
+        evt_send(MPU6050_ASYNC_EVT_ERROR, result);
+    }
+}
+
+
+static void config_callback(ret_code_t result, void * p_user_data)
+{
+    UNUSED_PARAMETER(p_user_data);
+
+    if (!m_initialized)
+    {
+        return;
+    }
+
+    if (result != NRF_SUCCESS)
+    {
+        evt_send(MPU6050_ASYNC_EVT_ERROR, result);
+        return;
+    }
+    if (m_who_am_i != expected_who_am_i)
+    {
+        evt_send(MPU6050_ASYNC_EVT_ERROR, NRF_ERROR_NOT_FOUND);
+        return;
+    }
+
+    m_bursts_owed       = 0;
+    m_burst_in_progress = false;
+    m_running           = true;
+
+    nrf_drv_timer_clear(m_config.p_timer);
+    nrf_drv_timer_enable(m_config.p_timer);
+    (void)nrf_drv_ppi_channel_enable(m_ppi_channel);
+    nrf_drv_gpiote_in_event_enable(m_config.int_pin, false);
+
+    evt_send(MPU6050_ASYNC_EVT_READY, NRF_SUCCESS);
+}
+
+
+/**@brief Function for preparing the transactions, which are the same for the whole session. */
+static void transactions_prepare(void)
+{
+    uint8_t const address = m_config.device_address;
+    uint32_t      bytes   = m_config.watermark * sizeof(mpu6050_async_sample_t);
+    uint8_t     * p_data  = (uint8_t *)m_samples;
+    uint8_t       n       = 0;
+
+    m_cfg_rate[1] = m_config.sample_rate_div;
+    m_cfg_rate[2] = m_config.dlpf_cfg;
+    m_cfg_rate[3] = (uint8_t)(m_config.gyro_fs_sel << 3);
+    m_cfg_rate[4] = (uint8_t)(m_config.accel_fs_sel << 3);
+
+    // The FIFO is reset while it is disabled, and enabled last.
+    m_config_transfers[n++] = (app_twi_transfer_t)APP_TWI_WRITE(address, &m_reg_who_am_i, 1, APP_TWI_NO_STOP);
+    m_config_transfers[n++] = (app_twi_transfer_t)APP_TWI_READ(address, &m_who_am_i, 1, 0);
+    m_config_transfers[n++] = (app_twi_transfer_t)APP_TWI_WRITE(address, m_cfg_pwr, sizeof(m_cfg_pwr), 0);
+    m_config_transfers[n++] = (app_twi_transfer_t)APP_TWI_WRITE(address, m_cfg_rate, sizeof(m_cfg_rate), 0);
+    m_config_transfers[n++] = (app_twi_transfer_t)APP_TWI_WRITE(address, m_cfg_fifo_reset, sizeof(m_cfg_fifo_reset), 0);
+    m_config_transfers[n++] = (app_twi_transfer_t)APP_TWI_WRITE(address, m_cfg_fifo_en, sizeof(m_cfg_fifo_en), 0);
+    m_config_transfers[n++] = (app_twi_transfer_t)APP_TWI_WRITE(address, m_cfg_int, sizeof(m_cfg_int), 0);
+    m_config_transfers[n++] = (app_twi_transfer_t)APP_TWI_WRITE(address, m_cfg_user_en, sizeof(m_cfg_user_en), 0);
+
+    m_config_transaction.callback            = config_callback;
+    m_config_transaction.p_user_data         = NULL;
+    m_config_transaction.p_transfers         = m_config_transfers;
+    m_config_transaction.number_of_transfers = n;
+
+    m_fifo_reset_transfers[0] = (app_twi_transfer_t)APP_TWI_WRITE(address, m_cfg_fifo_reset, sizeof(m_cfg_fifo_reset), 0);
+    m_fifo_reset_transfers[1] = (app_twi_transfer_t)APP_TWI_WRITE(address, m_cfg_user_en, sizeof(m_cfg_user_en), 0);
+
+    m_fifo_reset_transaction.callback            = fifo_reset_callback;
+    m_fifo_reset_transaction.p_user_data         = NULL;
+    m_fifo_reset_transaction.p_transfers         = m_fifo_reset_transfers;
+    m_fifo_reset_transaction.number_of_transfers = ARRAY_SIZE(m_fifo_reset_transfers);
+
+    // The FIFO count is read first, to detect an overflow. The samples are then read in chunks that
+    // fit in one EasyDMA transfer, each with a repeated start.
+    n = 0;
+    m_burst_transfers[n++] = (app_twi_transfer_t)APP_TWI_WRITE(address, &m_reg_fifo_count, 1, APP_TWI_NO_STOP);
+    m_burst_transfers[n++] = (app_twi_transfer_t)APP_TWI_READ(address, m_fifo_count, sizeof(m_fifo_count), 0);
+    while (bytes > 0)
+    {
+        uint8_t length = (uint8_t)MIN(bytes, BURST_CHUNK_MAX);
+
+        m_burst_transfers[n++] = (app_twi_transfer_t)APP_TWI_WRITE(address, &m_reg_fifo_r_w, 1, APP_TWI_NO_STOP);
+        m_burst_transfers[n++] = (app_twi_transfer_t)APP_TWI_READ(address, p_data, length, 0);
+        p_data += length;
+        bytes  -= length;
+    }
+
+    m_burst_transaction.callback            = burst_callback;
+    m_burst_transaction.p_user_data         = NULL;
+    m_burst_transaction.p_transfers         = m_burst_transfers;
+    m_burst_transaction.number_of_transfers = n;
+}
+
+
+/**@brief Function for connecting the interrupt pin of the sensor to the TIMER. */
+static ret_code_t counter_setup(void)
+{
+    ret_code_t                 err_code;
+    nrf_drv_gpiote_in_config_t int_config   = GPIOTE_CONFIG_IN_SENSE_LOTOHI(true);
+    nrf_drv_timer_config_t     timer_config = NRF_DRV_TIMER_DEFAULT_CONFIG;
+
+    if (!nrf_drv_gpiote_is_init())
+    {
+        err_code = nrf_drv_gpiote_init();
+        VERIFY_SUCCESS(err_code);
+    }
+
+    err_code = nrf_drv_ppi_init();
+    if ((err_code != NRF_SUCCESS) && (err_code != NRF_ERROR_MODULE_ALREADY_INITIALIZED))
+    {
+        return NRF_ERROR_INTERNAL;
+    }
+
+#if defined(TIMER_MODE_MODE_LowPowerCounter)
+    timer_config.mode = NRF_TIMER_MODE_LOW_POWER_COUNTER;
+#else
+    timer_config.mode = NRF_TIMER_MODE_COUNTER;
+#endif
+    err_code = nrf_drv_timer_init(m_config.p_timer, &timer_config, timer_handler);
+    VERIFY_SUCCESS(err_code);
+
+    err_code = nrf_drv_gpiote_in_init(m_config.int_pin, &int_config, NULL);
+    if (err_code != NRF_SUCCESS)
+    {
+        nrf_drv_timer_uninit(m_config.p_timer);
+        return NRF_ERROR_NO_MEM;
+    }
+
+    err_code = nrf_drv_ppi_channel_alloc(&m_ppi_channel);
+    if (err_code != NRF_SUCCESS)
+    {
+        nrf_drv_gpiote_in_uninit(m_config.int_pin);
+        nrf_drv_timer_uninit(m_config.p_timer);
+        return NRF_ERROR_NO_MEM;
+    }
+
+    (void)nrf_drv_ppi_channel_assign(m_ppi_channel,
+                                     nrf_drv_gpiote_in_event_addr_get(m_config.int_pin),
+                                     nrf_drv_timer_task_address_get(m_config.p_timer,
+                                                                    NRF_TIMER_TASK_COUNT));
+
+    nrf_drv_timer_extended_compare(m_config.p_timer,
+                                   NRF_TIMER_CC_CHANNEL0,
+                                   m_config.watermark,
+                                   NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK,
+                                   true);
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t mpu6050_async_init(mpu6050_async_config_t const * p_config)
+{
+    ret_code_t err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_config);
+    VERIFY_PARAM_NOT_NULL(p_config->p_app_twi);
+    VERIFY_PARAM_NOT_NULL(p_config->p_timer);
+    VERIFY_PARAM_NOT_NULL(p_config->evt_handler);
+
+    if (m_initialized)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if ((p_config->watermark == 0) || (p_config->watermark > MPU6050_ASYNC_WATERMARK_MAX) ||
+        (p_config->dlpf_cfg > 6) || (p_config->gyro_fs_sel > 3) || (p_config->accel_fs_sel > 3))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    m_config = *p_config;
+
+    err_code = counter_setup();
+    VERIFY_SUCCESS(err_code);
+
+    transactions_prepare();
+    m_initialized = true;
+
+    err_code = app_twi_schedule(m_config.p_app_twi, &m_config_transaction);
+    if (err_code != NRF_SUCCESS)
+    {
+        mpu6050_async_uninit();
+    }
+    return err_code;
+}
+
+
+void mpu6050_async_uninit(void)
+{
+    if (!m_initialized)
+    {
+        return;
+    }
+
+    m_running     = false;
+    m_initialized = false;
+
+    nrf_drv_gpiote_in_event_disable(m_config.int_pin);
+    (void)nrf_drv_ppi_channel_disable(m_ppi_channel);
+    (void)nrf_drv_ppi_channel_free(m_ppi_channel);
+    nrf_drv_gpiote_in_uninit(m_config.int_pin);
+    nrf_drv_timer_disable(m_config.p_timer);
+    nrf_drv_timer_uninit(m_config.p_timer);
+}
+
+/*lint --flb "Leave library region" */
@@ -0,0 +1,137 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef MPU6050_ASYNC_H
+#define MPU6050_ASYNC_H
+
+#include <stdint.h>
+#include "app_twi.h"
+#include "nrf_drv_timer.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @file
+* @brief Non-blocking MPU6050 gyro/accelerometer driver.
+*
+*
+* @defgroup nrf_drivers_mpu6050_async Non-blocking MPU6050 gyro/accelerometer driver
+* @{
+* @ingroup ext_drivers
+* @brief Non-blocking MPU6050 driver that reads the sensor FIFO in bursts.
+*
+* @details The sensor stores accelerometer and gyroscope samples in its FIFO, and pulses its
+*          interrupt pin for every sample. The pulses are counted by a TIMER in counter mode
+*          through GPIOTE and PPI, so that the CPU is only woken when a configured number of
+*          samples (the watermark) is in the FIFO. The samples are then read in one transaction
+*          of the TWI transaction manager, and passed to the user in one event.
+*
+*          All transfers are done through @ref app_twi, so the TWI bus can be shared with other
+*          devices. No function of this driver waits for the bus.
+*
+* @note The MPU6050 has no FIFO watermark interrupt, so its data ready pulses are counted instead.
+*/
+
+/** @brief Maximum number of samples read in one burst.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef MPU6050_ASYNC_WATERMARK_MAX
+#define MPU6050_ASYNC_WATERMARK_MAX 40
+#endif
+
+/**@brief Sample as stored in the sensor FIFO. */
+typedef struct
+{
+    int16_t accel[3]; /**< Accelerometer X, Y and Z. */
+    int16_t gyro[3];  /**< Gyroscope X, Y and Z. */
+} mpu6050_async_sample_t;
+
+/**@brief Driver event types. */
+typedef enum
+{
+    MPU6050_ASYNC_EVT_READY,    /**< The sensor was configured and sampling has started. */
+    MPU6050_ASYNC_EVT_SAMPLES,  /**< A burst of samples was read. */
+    MPU6050_ASYNC_EVT_OVERFLOW, /**< The sensor FIFO overflowed and was reset. Samples were lost. */
+    MPU6050_ASYNC_EVT_ERROR,    /**< A transaction failed, or the sensor did not identify itself. */
+} mpu6050_async_evt_type_t;
+
+/**@brief Driver event. */
+typedef struct
+{
+    mpu6050_async_evt_type_t type; /**< Type of the event. */
+    union
+    {
+        struct
+        {
+            mpu6050_async_sample_t const * p_samples; /**< Samples, oldest first. Valid until the handler returns. */
+            uint16_t                       count;     /**< Number of samples. */
+        } samples;                                    /**< Parameters of @ref MPU6050_ASYNC_EVT_SAMPLES. */
+        ret_code_t err_code;                          /**< Error of @ref MPU6050_ASYNC_EVT_ERROR. */
+    } params;
+} mpu6050_async_evt_t;
+
+/**@brief Handler for driver events. Called from the interrupt context of the TWI driver. */
+typedef void (* mpu6050_async_evt_handler_t)(mpu6050_async_evt_t const * p_evt);
+
+/**@brief Driver configuration. */
+typedef struct
+{
+    app_twi_t                 * p_app_twi;       /**< Initialized TWI transaction manager. */
+    uint8_t                     device_address;  /**< Device TWI address in bits [6:0]. */
+    uint32_t                    int_pin;         /**< Pin connected to the interrupt output of the sensor. */
+    nrf_drv_timer_t const     * p_timer;         /**< TIMER instance that counts the samples. */
+    uint8_t                     sample_rate_div; /**< Value of the SMPLRT_DIV register. The sample rate is 1 kHz / (1 + div) when @p dlpf_cfg is not 0. */
+    uint8_t                     dlpf_cfg;        /**< Digital low pass filter setting, 0 to 6. */
+    uint8_t                     gyro_fs_sel;     /**< Gyroscope full scale, 0 to 3 (250 to 2000 deg/s). */
+    uint8_t                     accel_fs_sel;    /**< Accelerometer full scale, 0 to 3 (2 g to 16 g). */
+    uint16_t                    watermark;       /**< Number of samples read in one burst, 1 to @ref MPU6050_ASYNC_WATERMARK_MAX. */
+    mpu6050_async_evt_handler_t evt_handler;     /**< Event handler. */
+} mpu6050_async_config_t;
+
+/**
+ * @brief Function for initializing the driver and starting the configuration of the sensor.
+ *
+ * @details The configuration transaction is scheduled, and @ref MPU6050_ASYNC_EVT_READY or
+ *          @ref MPU6050_ASYNC_EVT_ERROR is reported when it is finished.
+ *
+ * @param[in] p_config Driver configuration.
+ *
+ * @retval NRF_SUCCESS             If the configuration of the sensor was scheduled.
+ * @retval NRF_ERROR_NULL          If a required pointer was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If the configuration was invalid.
+ * @retval NRF_ERROR_INVALID_STATE If the driver was already initialized.
+ * @retval NRF_ERROR_NO_MEM        If no PPI or GPIOTE channel was available.
+ * @retval NRF_ERROR_BUSY          If the transaction queue of the TWI transaction manager was full.
+ * @return Any error returned by the TIMER driver.
+ */
+ret_code_t mpu6050_async_init(mpu6050_async_config_t const * p_config);
+
+/**
+ * @brief Function for stopping sampling and uninitializing the driver.
+ *
+ * @note A burst that is in progress is finished, but its samples are not reported.
+ */
+void mpu6050_async_uninit(void);
+
+/**
+ *@}
+ **/
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MPU6050_ASYNC_H */
@@ -0,0 +1,343 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "synaptics_touchpad_async.h"
+#include "nrf_drv_gpiote.h"
+#include "nrf_gpio.h"
+#include "app_util_platform.h"
+#include "sdk_common.h"
+
+/*lint ++flb "Enter library region" */
+
+#define PRODUCT_ID_BYTES     10U     // !< Number of bytes to expect to be in product ID.
+#define CONTROL_NO_SLEEP     (0x04U) // !< Keeps the touchpad from dozing between touches.
+
+#define BLOCK_OFFSET(reg)    ((reg) - TOUCHPAD_FINGER0_REL) // !< Offset of a register in the status block.
+
+static const uint8_t expected_product_id[PRODUCT_ID_BYTES] = {'T', 'M', '1', '9', '4', '4', '-', '0', '0', '2'};  //!< Product ID expected to get from product ID query
+
+static synaptics_touchpad_async_config_t m_config;               // !< Copy of the driver configuration.
+static bool                              m_initialized;          // !< The driver is initialized.
+static bool volatile                     m_running;              // !< The touchpad is configured and reports are read.
+static bool volatile                     m_read_in_progress;     // !< The report transaction is scheduled.
+static bool volatile                     m_control_in_progress;  // !< The control transaction is scheduled.
+
+static synaptics_touchpad_async_motion_t m_motion;               // !< Motion added up since it was taken.
+
+// All data of the transfers is in RAM, for EasyDMA.
+static uint8_t m_reg_product_id  = TOUCHPAD_PRODUCT_ID;
+static uint8_t m_reg_int_status  = TOUCHPAD_INT_STATUS;
+static uint8_t m_reg_block       = TOUCHPAD_FINGER0_REL;
+static uint8_t m_cfg_page[]      = {TOUCHPAD_PAGESELECT, 0x00U};
+static uint8_t m_cfg_control[]   = {TOUCHPAD_CONTROL, SleepmodeNormal};
+static uint8_t m_product_id[PRODUCT_ID_BYTES];
+static uint8_t m_int_status;
+static uint8_t m_block[SYNAPTICS_TOUCHPAD_ASYNC_BLOCK_SIZE];
+
+static app_twi_transfer_t    m_config_transfers[6];
+static app_twi_transfer_t    m_control_transfers[1];
+static app_twi_transfer_t    m_read_transfers[4];
+static app_twi_transaction_t m_config_transaction;
+static app_twi_transaction_t m_control_transaction;
+static app_twi_transaction_t m_read_transaction;
+
+
+static void evt_send(synaptics_touchpad_async_evt_type_t type, ret_code_t err_code)
+{
+    synaptics_touchpad_async_evt_t evt;
+
+    evt.type     = type;
+    evt.err_code = err_code;
+    m_config.evt_handler(&evt);
+}
+
+
+/**@brief Function for scheduling the report transaction, unless it is already scheduled. */
+static void read_start(void)
+{
+    bool       start;
+    ret_code_t err_code;
+
+    // The report transaction is static, so it is only scheduled again when it has finished.
+    CRITICAL_REGION_ENTER();
+    start              = m_running && !m_read_in_progress;
+    m_read_in_progress = m_read_in_progress || start;
+    CRITICAL_REGION_EXIT();
+
+    if (!start)
+    {
+        return;
+    }
+
+    err_code = app_twi_schedule(m_config.p_app_twi, &m_read_transaction);
+    if (err_code != NRF_SUCCESS)
+    {
+        m_read_in_progress = false;
+        evt_send(SYNAPTICS_TOUCHPAD_ASYNC_EVT_ERROR, err_code);
+    }
+}
+
+
+static void attn_handler(nrf_drv_gpiote_pin_t pin, nrf_gpiote_polarity_t action)
+{
+    UNUSED_PARAMETER(pin);
+    UNUSED_PARAMETER(action);
+
+    read_start();
+}
+
+
+/**@brief Function for adding a report to the motion that was not taken yet.
+ *
+ * @return True if it is the first report since the motion was taken.
+ */
+static bool report_add(void)
+{
+    bool first;
+
+    CRITICAL_REGION_ENTER();
+    first = (m_motion.reports == 0);
+
+    m_motion.dx       += (int8_t)m_block[BLOCK_OFFSET(TOUCHPAD_FINGER0_REL)];
+    m_motion.dy       += (int8_t)m_block[BLOCK_OFFSET(TOUCHPAD_FINGER0_REL + 1)];
+    m_motion.scroll   += (int8_t)m_block[BLOCK_OFFSET(TOUCHPAD_SCROLL)];
+    m_motion.gestures |= m_block[BLOCK_OFFSET(TOUCHPAD_GESTURE_FLAGS)];
+    m_motion.buttons   = m_block[BLOCK_OFFSET(TOUCHPAD_BUTTON_STATUS)];
+    m_motion.reports++;
+    memcpy(m_motion.block, m_block, sizeof(m_motion.block));
+    CRITICAL_REGION_EXIT();
+
+    return first;
+}
+
+
+static void read_callback(ret_code_t result, void * p_user_data)
+{
+    UNUSED_PARAMETER(p_user_data);
+
+    if (!m_running)
+    {
+        m_read_in_progress = false;
+        return;
+    }
+
+    if (result != NRF_SUCCESS)
+    {
+        evt_send(SYNAPTICS_TOUCHPAD_ASYNC_EVT_ERROR, result);
+    }
+    else if ((m_int_status != 0) && report_add())
+    {
+        evt_send(SYNAPTICS_TOUCHPAD_ASYNC_EVT_MOTION, NRF_SUCCESS);
+    }
+
+    // The pin is only sensed on its falling edge. A report that came while the transaction was
+    // running keeps it low, so it is read now.
+    m_read_in_progress = false;
+    if (nrf_gpio_pin_read(m_config.attn_pin) == 0)
+    {
+        read_start();
+    }
+}
+
+
+static void control_callback(ret_code_t result, void * p_user_data)
+{
+    UNUSED_PARAMETER(p_user_data);
+
+    m_control_in_progress = false;
+    if (m_running && (result != NRF_SUCCESS))
+    {
+        evt_send(SYNAPTICS_TOUCHPAD_ASYNC_EVT_ERROR, result);
+    }
+}
+
+
+static void config_callback(ret_code_t result, void * p_user_data)
+{
+    UNUSED_PARAMETER(p_user_data);
+
+    if (!m_initialized)
+    {
+        return;
+    }
+
+    if (result != NRF_SUCCESS)
+    {
+        evt_send(SYNAPTICS_TOUCHPAD_ASYNC_EVT_ERROR, result);
+        return;
+    }
+    if (memcmp(m_product_id, expected_product_id, PRODUCT_ID_BYTES) != 0)
+    {
+        evt_send(SYNAPTICS_TOUCHPAD_ASYNC_EVT_ERROR, NRF_ERROR_NOT_FOUND);
+        return;
+    }
+
+    m_read_in_progress = false;
+    m_running          = true;
+    nrf_drv_gpiote_in_event_enable(m_config.attn_pin, true);
+
+    evt_send(SYNAPTICS_TOUCHPAD_ASYNC_EVT_READY, NRF_SUCCESS);
+
+    // A report that came during the configuration was not sensed.
+    if (nrf_gpio_pin_read(m_config.attn_pin) == 0)
+    {
+        read_start();
+    }
+}
+
+
+/**@brief Function for preparing the transactions, which are the same for the whole session. */
+static void transactions_prepare(void)
+{
+    uint8_t const address = m_config.device_address;
+    uint8_t       n       = 0;
+
+    m_cfg_control[1] = SleepmodeNormal | (m_config.no_doze ? CONTROL_NO_SLEEP : 0);
+
+    // Reading the interrupt status last clears what came during the configuration.
+    m_config_transfers[n++] = (app_twi_transfer_t)APP_TWI_WRITE(address, m_cfg_page, sizeof(m_cfg_page), 0);
+    m_config_transfers[n++] = (app_twi_transfer_t)APP_TWI_WRITE(address, &m_reg_product_id, 1, APP_TWI_NO_STOP);
+    m_config_transfers[n++] = (app_twi_transfer_t)APP_TWI_READ(address, m_product_id, PRODUCT_ID_BYTES, 0);
+    m_config_transfers[n++] = (app_twi_transfer_t)APP_TWI_WRITE(address, m_cfg_control, sizeof(m_cfg_control), 0);
+    m_config_transfers[n++] = (app_twi_transfer_t)APP_TWI_WRITE(address, &m_reg_int_status, 1, APP_TWI_NO_STOP);
+    m_config_transfers[n++] = (app_twi_transfer_t)APP_TWI_READ(address, &m_int_status, 1, 0);
+
+    m_config_transaction.callback            = config_callback;
+    m_config_transaction.p_user_data         = NULL;
+    m_config_transaction.p_transfers         = m_config_transfers;
+    m_config_transaction.number_of_transfers = n;
+
+    m_control_transfers[0] = (app_twi_transfer_t)APP_TWI_WRITE(address, m_cfg_control, sizeof(m_cfg_control), 0);
+
+    m_control_transaction.callback            = control_callback;
+    m_control_transaction.p_user_data         = NULL;
+    m_control_transaction.p_transfers         = m_control_transfers;
+    m_control_transaction.number_of_transfers = ARRAY_SIZE(m_control_transfers);
+
+    // The interrupt status is read first: it releases the attention pin, so that a report that
+    // comes while the block is read asserts it again instead of being cleared unread.
+    m_read_transfers[0] = (app_twi_transfer_t)APP_TWI_WRITE(address, &m_reg_int_status, 1, APP_TWI_NO_STOP);
+    m_read_transfers[1] = (app_twi_transfer_t)APP_TWI_READ(address, &m_int_status, 1, 0);
+    m_read_transfers[2] = (app_twi_transfer_t)APP_TWI_WRITE(address, &m_reg_block, 1, APP_TWI_NO_STOP);
+    m_read_transfers[3] = (app_twi_transfer_t)APP_TWI_READ(address, m_block, sizeof(m_block), 0);
+
+    m_read_transaction.callback            = read_callback;
+    m_read_transaction.p_user_data         = NULL;
+    m_read_transaction.p_transfers         = m_read_transfers;
+    m_read_transaction.number_of_transfers = ARRAY_SIZE(m_read_transfers);
+}
+
+
+/**@brief Function for sensing the attention pin, with the low power PORT event. */
+static ret_code_t attn_setup(void)
+{
+    ret_code_t                 err_code;
+    nrf_drv_gpiote_in_config_t attn_config = GPIOTE_CONFIG_IN_SENSE_HITOLO(false);
+
+    attn_config.pull = NRF_GPIO_PIN_PULLUP;
+
+    if (!nrf_drv_gpiote_is_init())
+    {
+        err_code = nrf_drv_gpiote_init();
+        VERIFY_SUCCESS(err_code);
+    }
+
+    err_code = nrf_drv_gpiote_in_init(m_config.attn_pin, &attn_config, attn_handler);
+    if (err_code != NRF_SUCCESS)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t synaptics_touchpad_async_init(synaptics_touchpad_async_config_t const * p_config)
+{
+    ret_code_t err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_config);
+    VERIFY_PARAM_NOT_NULL(p_config->p_app_twi);
+    VERIFY_PARAM_NOT_NULL(p_config->evt_handler);
+
+    if (m_initialized)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    m_config = *p_config;
+    memset(&m_motion, 0, sizeof(m_motion));
+
+    err_code = attn_setup();
+    VERIFY_SUCCESS(err_code);
+
+    transactions_prepare();
+    m_initialized = true;
+
+    err_code = app_twi_schedule(m_config.p_app_twi, &m_config_transaction);
+    if (err_code != NRF_SUCCESS)
+    {
+        synaptics_touchpad_async_uninit();
+    }
+    return err_code;
+}
+
+
+void synaptics_touchpad_async_motion_get(synaptics_touchpad_async_motion_t * p_motion)
+{
+    CRITICAL_REGION_ENTER();
+    *p_motion = m_motion;
+    memset(&m_motion, 0, sizeof(m_motion));
+    CRITICAL_REGION_EXIT();
+}
+
+
+ret_code_t synaptics_touchpad_async_sleep_set(bool sleep)
+{
+    ret_code_t err_code;
+
+    if (!m_running || m_control_in_progress)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    m_cfg_control[1] = sleep ? SleepmodeSensorSleep :
+                               (SleepmodeNormal | (m_config.no_doze ? CONTROL_NO_SLEEP : 0));
+
+    m_control_in_progress = true;
+    err_code = app_twi_schedule(m_config.p_app_twi, &m_control_transaction);
+    if (err_code != NRF_SUCCESS)
+    {
+        m_control_in_progress = false;
+    }
+    return err_code;
+}
+
+
+void synaptics_touchpad_async_uninit(void)
+{
+    if (!m_initialized)
+    {
+        return;
+    }
+
+    m_running     = false;
+    m_initialized = false;
+
+    nrf_drv_gpiote_in_event_disable(m_config.attn_pin);
+    nrf_drv_gpiote_in_uninit(m_config.attn_pin);
+}
+
+/*lint --flb "Leave library region" */
@@ -0,0 +1,147 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef SYNAPTICS_TOUCHPAD_ASYNC_H
+#define SYNAPTICS_TOUCHPAD_ASYNC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "app_twi.h"
+#include "sdk_errors.h"
+#include "synaptics_touchpad.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @file
+* @brief Interrupt-driven Synaptics Touchpad driver.
+*
+*
+* @defgroup nrf_drivers_synaptics_touchpad_async Interrupt-driven Synaptics Touchpad driver
+* @{
+* @ingroup ext_drivers
+* @brief Synaptics Touchpad driver that reads a report only when the touchpad asserts its
+*        attention pin.
+*
+* @details The attention pin is sensed through GPIOTE. When it is asserted, the interrupt status
+*          and the whole status block, from @ref TOUCHPAD_FINGER0_REL to
+*          @ref TOUCHPAD_BUTTON_STATUS, are read in one transaction of @ref app_twi. Reading the
+*          interrupt status releases the attention pin.
+*
+*          The reports are added up until the application takes them with
+*          @ref synaptics_touchpad_async_motion_get, typically once per UI frame.
+*          @ref SYNAPTICS_TOUCHPAD_ASYNC_EVT_MOTION is only sent for the first report after the
+*          motion was taken, so the application is woken at most once per frame however fast the
+*          touchpad reports.
+*
+*          Between touches, the touchpad dozes and the driver does nothing: there is no polling.
+*          All transfers are done through @ref app_twi, so the TWI bus can be shared with other
+*          devices. No function of this driver waits for the bus.
+*/
+
+/**@brief Size of the status block, from @ref TOUCHPAD_FINGER0_REL to @ref TOUCHPAD_BUTTON_STATUS. */
+#define SYNAPTICS_TOUCHPAD_ASYNC_BLOCK_SIZE (TOUCHPAD_BUTTON_STATUS - TOUCHPAD_FINGER0_REL + 1)
+
+/**@brief Motion added up since it was last taken. */
+typedef struct
+{
+    int16_t  dx;                                            /**< Relative X motion of the first finger. */
+    int16_t  dy;                                            /**< Relative Y motion of the first finger. */
+    int16_t  scroll;                                        /**< Scroll zone and multifinger scroll motion. */
+    uint8_t  gestures;                                      /**< Gesture flags of all reports, ORed. */
+    uint8_t  buttons;                                       /**< Button status of the last report. */
+    uint16_t reports;                                       /**< Number of reports added up, 0 if there was no motion. */
+    uint8_t  block[SYNAPTICS_TOUCHPAD_ASYNC_BLOCK_SIZE];    /**< Status block of the last report, for the other fingers. */
+} synaptics_touchpad_async_motion_t;
+
+/**@brief Driver event types. */
+typedef enum
+{
+    SYNAPTICS_TOUCHPAD_ASYNC_EVT_READY,  /**< The touchpad was identified and configured. */
+    SYNAPTICS_TOUCHPAD_ASYNC_EVT_MOTION, /**< There is motion to take with @ref synaptics_touchpad_async_motion_get. */
+    SYNAPTICS_TOUCHPAD_ASYNC_EVT_ERROR,  /**< A transaction failed, or the touchpad did not identify itself. */
+} synaptics_touchpad_async_evt_type_t;
+
+/**@brief Driver event. */
+typedef struct
+{
+    synaptics_touchpad_async_evt_type_t type;     /**< Type of the event. */
+    ret_code_t                          err_code; /**< Error of @ref SYNAPTICS_TOUCHPAD_ASYNC_EVT_ERROR. */
+} synaptics_touchpad_async_evt_t;
+
+/**@brief Handler for driver events. Called from the interrupt context of the TWI driver. */
+typedef void (* synaptics_touchpad_async_evt_handler_t)(synaptics_touchpad_async_evt_t const * p_evt);
+
+/**@brief Driver configuration. */
+typedef struct
+{
+    app_twi_t                            * p_app_twi;      /**< Initialized TWI transaction manager. */
+    uint8_t                                device_address; /**< Device TWI address in bits [6:0]. */
+    uint32_t                               attn_pin;       /**< Pin connected to the attention output of the touchpad, active low. */
+    bool                                   no_doze;        /**< Keep the touchpad awake between touches, for the lowest latency. */
+    synaptics_touchpad_async_evt_handler_t evt_handler;    /**< Event handler. */
+} synaptics_touchpad_async_config_t;
+
+/**
+ * @brief Function for initializing the driver and starting the configuration of the touchpad.
+ *
+ * @details The configuration transaction is scheduled, and @ref SYNAPTICS_TOUCHPAD_ASYNC_EVT_READY
+ *          or @ref SYNAPTICS_TOUCHPAD_ASYNC_EVT_ERROR is reported when it is finished.
+ *
+ * @param[in] p_config Driver configuration.
+ *
+ * @retval NRF_SUCCESS             If the configuration of the touchpad was scheduled.
+ * @retval NRF_ERROR_NULL          If a required pointer was NULL.
+ * @retval NRF_ERROR_INVALID_STATE If the driver was already initialized.
+ * @retval NRF_ERROR_NO_MEM        If no GPIOTE channel was available.
+ * @retval NRF_ERROR_BUSY          If the transaction queue of the TWI transaction manager was full.
+ */
+ret_code_t synaptics_touchpad_async_init(synaptics_touchpad_async_config_t const * p_config);
+
+/**
+ * @brief Function for taking the motion added up since the last call.
+ *
+ * @param[out] p_motion Motion. @p reports is 0 if there was none.
+ */
+void synaptics_touchpad_async_motion_get(synaptics_touchpad_async_motion_t * p_motion);
+
+/**
+ * @brief Function for putting the touchpad in sensor sleep, or waking it.
+ *
+ * @details In sensor sleep, touches are not sensed and the attention pin is not asserted.
+ *
+ * @param[in] sleep True to put the touchpad to sleep, false to wake it.
+ *
+ * @retval NRF_SUCCESS             If the mode change was scheduled.
+ * @retval NRF_ERROR_INVALID_STATE If the driver was not initialized, or a mode change is in progress.
+ * @retval NRF_ERROR_BUSY          If the transaction queue of the TWI transaction manager was full.
+ */
+ret_code_t synaptics_touchpad_async_sleep_set(bool sleep);
+
+/**
+ * @brief Function for uninitializing the driver.
+ *
+ * @note A read that is in progress is finished, but its report is dropped.
+ */
+void synaptics_touchpad_async_uninit(void);
+
+/**
+ *@}
+ **/
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYNAPTICS_TOUCHPAD_ASYNC_H */
@@ -15,6 +15,7 @@
 #include "nrf_drv_clock.h"
 #include "nrf_error.h"
 #include "app_util_platform.h"
+#include <string.h>
 #ifdef SOFTDEVICE_PRESENT
 #include "softdevice_handler.h"
 #include "nrf_sdm.h"
@@ -53,10 +54,32 @@ INTERRUPT_PRIORITY_VALIDATION(CLOCK_CONFIG_IRQ_PRIORITY);
 #else
 #define CALIBRATION_SUPPORT 0
 #endif
+
+#if CALIBRATION_SUPPORT && NRF_MODULE_ENABLED(DIE_TEMP) && (CLOCK_CONFIG_LF_CAL_TEMP_DELTA > 0)
+#include <stdlib.h>
+#include "die_temp.h"
+#define CALIBRATION_ON_TEMP 1
+#else
+#define CALIBRATION_ON_TEMP 0
+#endif
+
+#if CALIBRATION_ON_TEMP && CLOCK_CONFIG_LF_CAL_ADAPTIVE_ENABLED
+#define CALIBRATION_ADAPTIVE 1
+#define CAL_CT_MAX           127    /**< Longest timeout of the calibration timer, in 0.25 s units. */
+STATIC_ASSERT((CLOCK_CONFIG_LF_CAL_INTERVAL_MIN > 0) &&
+              (CLOCK_CONFIG_LF_CAL_INTERVAL_MIN <= CLOCK_CONFIG_LF_CAL_INTERVAL_MAX));
+#else
+#define CALIBRATION_ADAPTIVE 0
+#endif
+
 typedef enum
 {
     CAL_STATE_IDLE,
     CAL_STATE_CT,
+#if CALIBRATION_ADAPTIVE
+    CAL_STATE_WAIT,     /*< Adaptive calibration, waiting for the next temperature check. */
+    CAL_STATE_CHECK,    /*< Adaptive calibration, waiting for the temperature. */
+#endif
     CAL_STATE_HFCLK_REQ,
     CAL_STATE_CAL,
     CAL_STATE_ABORT,
@@ -77,10 +100,49 @@ typedef struct
     nrf_drv_clock_event_handler_t           cal_done_handler;
     volatile nrf_drv_clock_cal_state_t      cal_state;
 #endif // CALIBRATION_SUPPORT
+#if CALIBRATION_ADAPTIVE
+    nrf_drv_clock_event_handler_t           cal_adaptive_handler; /*< User handler of the adaptive calibration. */
+    volatile bool                           cal_adaptive;         /*< Adaptive calibration is running. */
+    uint32_t                                cal_interval;         /*< Time between two temperature checks, in 0.25 s units. */
+    uint32_t                                cal_wait_left;        /*< Time left before the next check, in 0.25 s units. */
+    uint32_t                                cal_wait_armed;       /*< Timeout of the calibration timer, in 0.25 s units. */
+    uint32_t                                cal_since;            /*< Time since the last calibration, in 0.25 s units. */
+    int32_t                                 cal_temp;             /*< Temperature at the last calibration. */
+    int32_t                                 check_temp;           /*< Temperature at the last check. */
+#endif // CALIBRATION_ADAPTIVE
 } nrf_drv_clock_cb_t;
 
 static nrf_drv_clock_cb_t m_clock_cb;
 
+#if CLOCK_CONFIG_HFCLK_ARBITER_ENABLED
+#define ARBITER_CC_CHANNEL      0                   /**< RTC compare channel of the arbiter. */
+#define ARBITER_TICKS_MAX       0x007FFFFFUL        /**< Half the range of the RTC counter. */
+#define ARBITER_CC_MIN_TICKS    2                   /**< Minimal distance of a compare value from the counter. */
+
+/**@brief HFCLK arbiter control block. */
+typedef struct
+{
+    nrf_drv_rtc_t const *               p_rtc;          /*< RTC instance timing the arbiter, NULL if not initialized. */
+    uint32_t                            rtc_freq;       /*< Frequency of the RTC in Hz. */
+    nrf_drv_clock_hfclk_reservation_t * p_head;         /*< Reservations, in the order of their start. */
+    nrf_drv_clock_handler_item_t        started_item;   /*< Handler item of the request of the arbiter. */
+    bool                                requested;      /*< True if the arbiter holds one of the HFCLK requests. */
+    volatile bool                       running;        /*< True if the request of the arbiter is served. */
+    bool                                evaluating;     /*< True while the arbiter updates its state. */
+    bool                                holding;        /*< True if the clock is kept after the release of the last request. */
+    uint32_t                            hold_until;     /*< RTC counter when holding ends. */
+    uint32_t                            warmup_ticks;   /*< Predicted start-up time of the crystal. */
+    uint32_t                            break_even_ticks; /*< Break-even time of the crystal. */
+    uint32_t                            start_ticks;    /*< RTC counter when the crystal was started. */
+    bool                                measuring;      /*< True while the start-up of the crystal is measured. */
+} nrf_drv_clock_arbiter_t;
+
+static nrf_drv_clock_arbiter_t m_arbiter;
+
+static void arbiter_evaluate(void);
+static void arbiter_startup_measure(void);
+#endif // CLOCK_CONFIG_HFCLK_ARBITER_ENABLED
+
 
 /**@brief Function for starting LFCLK. This function will return immediately without waiting for start.
  */
@@ -127,6 +189,19 @@ static void hfclk_start(void)
     nrf_clock_task_trigger(NRF_CLOCK_TASK_HFCLKSTART);
 }
 
+/**@brief Function for starting HFCLK and measuring its start-up time. */
+static void hfclk_start_measured(void)
+{
+#if CLOCK_CONFIG_HFCLK_ARBITER_ENABLED
+    if (m_arbiter.p_rtc != NULL)
+    {
+        m_arbiter.start_ticks = nrf_drv_rtc_counter_get(m_arbiter.p_rtc);
+        m_arbiter.measuring   = true;
+    }
+#endif // CLOCK_CONFIG_HFCLK_ARBITER_ENABLED
+    hfclk_start();
+}
+
 static void hfclk_stop(void)
 {
 #ifdef SOFTDEVICE_PRESENT
@@ -187,6 +262,13 @@ void nrf_drv_clock_uninit(void)
     nrf_drv_common_clock_irq_disable();
     nrf_clock_int_disable(0xFFFFFFFF);
 
+#if CLOCK_CONFIG_HFCLK_ARBITER_ENABLED
+    if (m_arbiter.p_rtc != NULL)
+    {
+        nrf_drv_rtc_uninit(m_arbiter.p_rtc);
+        memset(&m_arbiter, 0, sizeof(m_arbiter));
+    }
+#endif
     lfclk_stop();
     hfclk_stop();
     m_clock_cb.module_initialized = false;
@@ -305,7 +387,7 @@ void nrf_drv_clock_hfclk_request(nrf_drv_clock_handler_item_t * p_handler_item)
         }
         if (m_clock_cb.hfclk_requests == 0)
         {
-            hfclk_start();
+            hfclk_start_measured();
         }
         ++(m_clock_cb.hfclk_requests);
         CRITICAL_REGION_EXIT();
@@ -314,18 +396,48 @@ void nrf_drv_clock_hfclk_request(nrf_drv_clock_handler_item_t * p_handler_item)
     ASSERT(m_clock_cb.hfclk_requests > 0);
 }
 
+/**@brief Function for releasing one HFCLK request, stopping the clock after the last one. */
+static void hfclk_release(void)
+{
+    CRITICAL_REGION_ENTER();
+    --(m_clock_cb.hfclk_requests);
+    if (m_clock_cb.hfclk_requests == 0)
+    {
+        hfclk_stop();
+    }
+    CRITICAL_REGION_EXIT();
+}
+
 void nrf_drv_clock_hfclk_release(void)
 {
     ASSERT(m_clock_cb.module_initialized);
     ASSERT(m_clock_cb.hfclk_requests > 0);
 
+#if CLOCK_CONFIG_HFCLK_ARBITER_ENABLED
+    bool hold = false;
+
     CRITICAL_REGION_ENTER();
-    --(m_clock_cb.hfclk_requests);
-    if (m_clock_cb.hfclk_requests == 0)
+    if ((m_arbiter.p_rtc != NULL) && (m_clock_cb.hfclk_requests == 1) && !m_arbiter.requested)
     {
-        hfclk_stop();
+        // The last request is taken over by the arbiter, which keeps the clock running for the
+        // break-even time.
+        m_arbiter.requested  = true;
+        m_arbiter.running    = true;
+        m_arbiter.holding    = true;
+        m_arbiter.hold_until = nrf_drv_rtc_counter_get(m_arbiter.p_rtc) +
+                               m_arbiter.break_even_ticks;
+        hold = true;
     }
     CRITICAL_REGION_EXIT();
+
+    if (hold)
+    {
+        arbiter_evaluate();
+        return;
+    }
+#endif // CLOCK_CONFIG_HFCLK_ARBITER_ENABLED
+
+    hfclk_release();
 }
 
 bool nrf_drv_clock_hfclk_is_running(void)
@@ -406,6 +518,194 @@ ret_code_t nrf_drv_clock_calibration_start(uint8_t interval, nrf_drv_clock_event
 #endif // CALIBRATION_SUPPORT
 }
 
+#if CALIBRATION_ON_TEMP && !CALIBRATION_ADAPTIVE
+/**@brief Die temperature handler, which calibrates the LFRC when the temperature has changed.
+ *
+ * A change during a calibration is skipped, as the next change calibrates again.
+ */
+static void clock_calibration_temp_changed(int32_t temp)
+{
+    UNUSED_PARAMETER(temp);
+
+    if (m_clock_cb.lfclk_on && (m_clock_cb.cal_state == CAL_STATE_IDLE))
+    {
+        (void)nrf_drv_clock_calibration_start(0, NULL);
+    }
+}
+
+DIE_TEMP_CLIENT_REGISTER(clock_lf_cal, CLOCK_CONFIG_LF_CAL_TEMP_DELTA, clock_calibration_temp_changed);
+#endif // CALIBRATION_ON_TEMP && !CALIBRATION_ADAPTIVE
+
+#if CALIBRATION_ADAPTIVE
+/**@brief Function for starting the calibration timer, for the next part of the wait. */
+static void cal_wait_arm(void)
+{
+    m_clock_cb.cal_wait_armed = MIN(m_clock_cb.cal_wait_left, CAL_CT_MAX);
+    m_clock_cb.cal_state      = CAL_STATE_WAIT;
+    nrf_clock_cal_timer_timeout_set(m_clock_cb.cal_wait_armed);
+    nrf_clock_event_clear(NRF_CLOCK_EVENT_CTTO);
+    nrf_clock_int_enable(NRF_CLOCK_INT_CTTO_MASK);
+    nrf_clock_task_trigger(NRF_CLOCK_TASK_CTSTART);
+}
+
+/**@brief Function for requesting the HFCLK, which starts a calibration when it runs. */
+static void cal_hfclk_request(void)
+{
+    m_clock_cb.cal_state = CAL_STATE_HFCLK_REQ;
+    nrf_drv_clock_hfclk_request(&m_clock_cb.cal_hfclk_started_handler_item);
+}
+
+/**@brief Handler of the calibrations started by the adaptive calibration. */
+static void cal_adaptive_done(nrf_drv_clock_evt_type_t event)
+{
+    if (event == NRF_DRV_CLOCK_EVT_CAL_ABORTED)
+    {
+        m_clock_cb.cal_adaptive = false;
+    }
+    else
+    {
+        m_clock_cb.cal_since = 0;
+        (void)die_temp_get(&m_clock_cb.cal_temp);
+        m_clock_cb.check_temp = m_clock_cb.cal_temp;
+    }
+
+    if (m_clock_cb.cal_adaptive_handler)
+    {
+        m_clock_cb.cal_adaptive_handler(event);
+    }
+
+    CRITICAL_REGION_ENTER();
+    if (m_clock_cb.cal_adaptive && (m_clock_cb.cal_state == CAL_STATE_IDLE))
+    {
+        m_clock_cb.cal_wait_left = m_clock_cb.cal_interval;
+        cal_wait_arm();
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+/**@brief Function for handling the timeout of the calibration timer during the wait.
+ *
+ * The temperature is checked when the wait is over. A calibration is forced when none was done
+ * for @ref CLOCK_CONFIG_LF_CAL_INTERVAL_MAX.
+ */
+static void cal_wait_timeout(void)
+{
+    m_clock_cb.cal_wait_left -= m_clock_cb.cal_wait_armed;
+    m_clock_cb.cal_since     += m_clock_cb.cal_wait_armed;
+
+    if (m_clock_cb.cal_since >= CLOCK_CONFIG_LF_CAL_INTERVAL_MAX)
+    {
+        cal_hfclk_request();
+    }
+    else if (m_clock_cb.cal_wait_left > 0)
+    {
+        cal_wait_arm();
+    }
+    else
+    {
+        m_clock_cb.cal_state = CAL_STATE_CHECK;
+        if (die_temp_sample_request() != NRF_SUCCESS)
+        {
+            // Checked again after the same interval.
+            m_clock_cb.cal_wait_left = m_clock_cb.cal_interval;
+            cal_wait_arm();
+        }
+    }
+}
+
+/**@brief Die temperature handler of the adaptive calibration, called for every sample.
+ *
+ * A change by @ref CLOCK_CONFIG_LF_CAL_TEMP_DELTA since the last calibration calibrates at once.
+ * The interval between checks is halved when the temperature moves by half of it between two
+ * checks, and doubled when it does not, within the configured limits.
+ */
+static void clock_calibration_temp_sampled(int32_t temp)
+{
+    bool calibrate;
+    bool swing;
+
+    CRITICAL_REGION_ENTER();
+    if (m_clock_cb.cal_adaptive &&
+        ((m_clock_cb.cal_state == CAL_STATE_WAIT) || (m_clock_cb.cal_state == CAL_STATE_CHECK)))
+    {
+        calibrate = ((uint32_t)abs(temp - m_clock_cb.cal_temp) >= CLOCK_CONFIG_LF_CAL_TEMP_DELTA);
+        swing     = ((uint32_t)abs(temp - m_clock_cb.check_temp) >= (CLOCK_CONFIG_LF_CAL_TEMP_DELTA / 2));
+
+        if (swing)
+        {
+            m_clock_cb.cal_interval = MAX(m_clock_cb.cal_interval / 2, CLOCK_CONFIG_LF_CAL_INTERVAL_MIN);
+        }
+        else if (m_clock_cb.cal_state == CAL_STATE_CHECK)
+        {
+            m_clock_cb.cal_interval = MIN(m_clock_cb.cal_interval * 2, CLOCK_CONFIG_LF_CAL_INTERVAL_MAX);
+        }
+
+        if (calibrate)
+        {
+            if (m_clock_cb.cal_state == CAL_STATE_WAIT)
+            {
+                nrf_clock_int_disable(NRF_CLOCK_INT_CTTO_MASK);
+                nrf_clock_task_trigger(NRF_CLOCK_TASK_CTSTOP);
+            }
+            cal_hfclk_request();
+        }
+        else if (m_clock_cb.cal_state == CAL_STATE_CHECK)
+        {
+            m_clock_cb.check_temp    = temp;
+            m_clock_cb.cal_wait_left = m_clock_cb.cal_interval;
+            cal_wait_arm();
+        }
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+DIE_TEMP_CLIENT_REGISTER(clock_lf_cal, 0, clock_calibration_temp_sampled);
+
+ret_code_t nrf_drv_clock_calibration_adaptive_start(nrf_drv_clock_event_handler_t handler)
+{
+    ret_code_t err_code;
+
+    if (m_clock_cb.cal_adaptive)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    m_clock_cb.cal_adaptive_handler = handler;
+    m_clock_cb.cal_interval         = CLOCK_CONFIG_LF_CAL_INTERVAL_MIN;
+    m_clock_cb.cal_since            = 0;
+    m_clock_cb.cal_adaptive         = true;
+
+    err_code = nrf_drv_clock_calibration_start(0, cal_adaptive_done);
+    if (err_code != NRF_SUCCESS)
+    {
+        m_clock_cb.cal_adaptive = false;
+    }
+    return err_code;
+}
+
+void nrf_drv_clock_calibration_adaptive_stop(void)
+{
+    CRITICAL_REGION_ENTER();
+    m_clock_cb.cal_adaptive = false;
+    if (m_clock_cb.cal_state == CAL_STATE_WAIT)
+    {
+        nrf_clock_int_disable(NRF_CLOCK_INT_CTTO_MASK);
+        nrf_clock_task_trigger(NRF_CLOCK_TASK_CTSTOP);
+        m_clock_cb.cal_state = CAL_STATE_IDLE;
+    }
+    else if (m_clock_cb.cal_state == CAL_STATE_CHECK)
+    {
+        m_clock_cb.cal_state = CAL_STATE_IDLE;
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+uint32_t nrf_drv_clock_calibration_interval_get(void)
+{
+    return m_clock_cb.cal_interval;
+}
+#endif // CALIBRATION_ADAPTIVE
+
 ret_code_t nrf_drv_clock_calibration_abort(void)
 {
     ret_code_t err_code = NRF_SUCCESS;
@@ -413,6 +713,14 @@ ret_code_t nrf_drv_clock_calibration_abort(void)
     CRITICAL_REGION_ENTER();
     switch (m_clock_cb.cal_state)
     {
+#if CALIBRATION_ADAPTIVE
+    case CAL_STATE_CHECK:
+        m_clock_cb.cal_state = CAL_STATE_IDLE;
+        cal_adaptive_done(NRF_DRV_CLOCK_EVT_CAL_ABORTED);
+        break;
+    case CAL_STATE_WAIT:
+        /* fall through. */
+#endif
     case CAL_STATE_CT:
         nrf_clock_int_disable(NRF_CLOCK_INT_CTTO_MASK);
         nrf_clock_task_trigger(NRF_CLOCK_TASK_CTSTOP);
@@ -492,6 +800,9 @@ void POWER_CLOCK_IRQHandler(void)
         NRF_LOG_DEBUG("Event: %s.\r\n", (uint32_t)EVT_TO_STR(NRF_CLOCK_EVENT_HFCLKSTARTED));
         nrf_clock_int_disable(NRF_CLOCK_INT_HF_STARTED_MASK);
         m_clock_cb.hfclk_on = true;
+#if CLOCK_CONFIG_HFCLK_ARBITER_ENABLED
+        arbiter_startup_measure();
+#endif
         clock_clk_started_notify(NRF_DRV_CLOCK_EVT_HFCLK_STARTED);
     }
     if (nrf_clock_event_check(NRF_CLOCK_EVENT_LFCLKSTARTED))
@@ -508,7 +819,16 @@ void POWER_CLOCK_IRQHandler(void)
         nrf_clock_event_clear(NRF_CLOCK_EVENT_CTTO);
         NRF_LOG_DEBUG("Event: %s.\r\n", (uint32_t)EVT_TO_STR(NRF_CLOCK_EVENT_CTTO));
         nrf_clock_int_disable(NRF_CLOCK_INT_CTTO_MASK);
-        nrf_drv_clock_hfclk_request(&m_clock_cb.cal_hfclk_started_handler_item);
+#if CALIBRATION_ADAPTIVE
+        if (m_clock_cb.cal_state == CAL_STATE_WAIT)
+        {
+            cal_wait_timeout();
+        }
+        else
+#endif
+        {
+            nrf_drv_clock_hfclk_request(&m_clock_cb.cal_hfclk_started_handler_item);
+        }
     }
 
     if (nrf_clock_event_check(NRF_CLOCK_EVENT_DONE))
@@ -528,12 +848,340 @@ void POWER_CLOCK_IRQHandler(void)
 #endif // CALIBRATION_SUPPORT
 }
 
+#if CLOCK_CONFIG_HFCLK_ARBITER_ENABLED
+/**@brief Function for comparing two RTC counter values.
+ *
+ * @return Signed distance from @p b to @p a, valid for values less than half the range apart.
+ */
+__STATIC_INLINE int32_t ticks_diff(uint32_t a, uint32_t b)
+{
+    return ((int32_t)((a - b) << 8)) >> 8;
+}
+
+/**@brief Function for converting microseconds to RTC ticks, rounded up. */
+__STATIC_INLINE uint32_t us_to_ticks(uint32_t us)
+{
+    return (uint32_t)((((uint64_t)us * m_arbiter.rtc_freq) + 999999) / 1000000);
+}
+
+/**@brief Function for updating the start-up prediction with a measured start-up.
+ *
+ * @details A longer start-up replaces the prediction, so that reservations are not missed. Shorter
+ *          ones lower it slowly.
+ */
+static void arbiter_startup_measure(void)
+{
+    uint32_t ticks;
+
+    if ((m_arbiter.p_rtc == NULL) || !m_arbiter.measuring)
+    {
+        return;
+    }
+    m_arbiter.measuring = false;
+
+    ticks = (nrf_drv_rtc_counter_get(m_arbiter.p_rtc) - m_arbiter.start_ticks) &
+            RTC_COUNTER_COUNTER_Msk;
+    if (ticks >= m_arbiter.warmup_ticks)
+    {
+        m_arbiter.warmup_ticks = ticks;
+    }
+    else
+    {
+        m_arbiter.warmup_ticks = ((3 * m_arbiter.warmup_ticks) + ticks + 3) / 4;
+    }
+}
+
+/**@brief Function for notifying the reservations for which the clock is running.
+ *
+ * @details Handlers are called outside of critical regions, one reservation at a time.
+ */
+static void arbiter_notify(void)
+{
+    nrf_drv_clock_hfclk_reservation_t * p_res;
+    uint32_t                            now;
+
+    while (1)
+    {
+        CRITICAL_REGION_ENTER();
+        now = nrf_drv_rtc_counter_get(m_arbiter.p_rtc);
+        for (p_res = m_arbiter.p_head; p_res != NULL; p_res = p_res->p_next)
+        {
+            if (m_arbiter.running && !p_res->notified &&
+                (ticks_diff(now, p_res->start - m_arbiter.warmup_ticks) >= 0))
+            {
+                p_res->notified = true;
+                break;
+            }
+        }
+        CRITICAL_REGION_EXIT();
+
+        if (p_res == NULL)
+        {
+            break;
+        }
+        if (p_res->event_handler != NULL)
+        {
+            p_res->event_handler(NRF_DRV_CLOCK_EVT_HFCLK_STARTED);
+        }
+    }
+}
+
+/**@brief Handler of the HFCLK request of the arbiter. */
+static void arbiter_hfclk_started(nrf_drv_clock_evt_type_t event)
+{
+    UNUSED_PARAMETER(event);
+
+    m_arbiter.running = true;
+    if (!m_arbiter.evaluating)
+    {
+        arbiter_notify();
+    }
+}
+
+/**@brief Function for updating the request of the arbiter and setting its next wakeup.
+ *
+ * @details The clock is needed while a reservation is running or starting up, and while holding
+ *          after the release of the last request. Once it is no longer needed, it is kept running
+ *          if the next reservation starts up within the break-even time.
+ */
+static void arbiter_evaluate(void)
+{
+    nrf_drv_clock_hfclk_reservation_t ** pp_res;
+    nrf_drv_clock_hfclk_reservation_t *  p_res;
+    uint32_t                             now;
+    uint32_t                             on_at;
+    uint32_t                             next     = 0;
+    bool                                 has_next = false;
+    bool                                 needed   = false;
+    bool                                 release  = false;
+
+    CRITICAL_REGION_ENTER();
+    m_arbiter.evaluating = true;
+    now = nrf_drv_rtc_counter_get(m_arbiter.p_rtc);
+
+    // Drop the reservations that have ended.
+    pp_res = &m_arbiter.p_head;
+    while (*pp_res != NULL)
+    {
+        if (ticks_diff(now, (*pp_res)->end) >= 0)
+        {
+            *pp_res = (*pp_res)->p_next;
+        }
+        else
+        {
+            pp_res = &(*pp_res)->p_next;
+        }
+    }
+
+    if (m_arbiter.holding)
+    {
+        if (ticks_diff(m_arbiter.hold_until, now) > 0)
+        {
+            needed   = true;
+            next     = m_arbiter.hold_until;
+            has_next = true;
+        }
+        else
+        {
+            m_arbiter.holding = false;
+        }
+    }
+
+    for (p_res = m_arbiter.p_head; p_res != NULL; p_res = p_res->p_next)
+    {
+        uint32_t event;
+
+        on_at = p_res->start - m_arbiter.warmup_ticks;
+        if (ticks_diff(now, on_at) >= 0)
+        {
+            needed = true;
+            event  = p_res->end;
+        }
+        else
+        {
+            event  = on_at;
+        }
+
+        if (!has_next || (ticks_diff(event, next) < 0))
+        {
+            next     = event;
+            has_next = true;
+        }
+    }
+
+    // Bridge a gap that is shorter than the break-even time.
+    if (!needed && m_arbiter.requested && (m_arbiter.p_head != NULL) &&
+        (ticks_diff(m_arbiter.p_head->start - m_arbiter.warmup_ticks, now) <
+         (int32_t)m_arbiter.break_even_ticks))
+    {
+        needed = true;
+    }
+
+    if (needed && !m_arbiter.requested)
+    {
+        m_arbiter.requested = true;
+        m_arbiter.running   = false;
+        nrf_drv_clock_hfclk_request(&m_arbiter.started_item);
+    }
+    else if (!needed && m_arbiter.requested)
+    {
+        m_arbiter.requested = false;
+        m_arbiter.running   = false;
+        release             = true;
+    }
+
+    if (has_next)
+    {
+        if (ticks_diff(next, now) < ARBITER_CC_MIN_TICKS)
+        {
+            next = now + ARBITER_CC_MIN_TICKS;
+        }
+        UNUSED_RETURN_VALUE(nrf_drv_rtc_cc_set(m_arbiter.p_rtc,
+                                               ARBITER_CC_CHANNEL,
+                                               next & RTC_COUNTER_COUNTER_Msk,
+                                               true));
+    }
+    else
+    {
+        UNUSED_RETURN_VALUE(nrf_drv_rtc_cc_disable(m_arbiter.p_rtc, ARBITER_CC_CHANNEL));
+    }
+    m_arbiter.evaluating = false;
+    CRITICAL_REGION_EXIT();
+
+    if (release)
+    {
+        hfclk_release();
+    }
+    arbiter_notify();
+}
+
+static void arbiter_rtc_handler(nrf_drv_rtc_int_type_t int_type)
+{
+    if (int_type == (nrf_drv_rtc_int_type_t)ARBITER_CC_CHANNEL)
+    {
+        arbiter_evaluate();
+    }
+}
+
+ret_code_t nrf_drv_clock_hfclk_arbiter_init(nrf_drv_rtc_t const *        p_rtc,
+                                            nrf_drv_rtc_config_t const * p_rtc_config)
+{
+    ret_code_t err_code;
+
+    if (!m_clock_cb.module_initialized)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    err_code = nrf_drv_rtc_init(p_rtc, p_rtc_config, arbiter_rtc_handler);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    memset(&m_arbiter, 0, sizeof(m_arbiter));
+    m_arbiter.rtc_freq                   = RTC_INPUT_FREQ / ((uint32_t)p_rtc_config->prescaler + 1);
+    m_arbiter.started_item.event_handler = arbiter_hfclk_started;
+    m_arbiter.warmup_ticks               = us_to_ticks(CLOCK_CONFIG_HFCLK_STARTUP_US);
+    m_arbiter.break_even_ticks           = us_to_ticks(CLOCK_CONFIG_HFCLK_BREAK_EVEN_US);
+
+    nrf_drv_clock_lfclk_request(NULL);
+    nrf_drv_rtc_enable(p_rtc);
+    m_arbiter.p_rtc = p_rtc;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_drv_clock_hfclk_reserve(nrf_drv_clock_hfclk_reservation_t * p_reservation,
+                                       uint32_t                            delay_us,
+                                       uint32_t                            duration_us)
+{
+    nrf_drv_clock_hfclk_reservation_t ** pp_res;
+    uint32_t                             delay;
+    uint32_t                             duration;
+    uint32_t                             now;
+
+    ASSERT(p_reservation != NULL);
+
+    if (m_arbiter.p_rtc == NULL)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    delay    = us_to_ticks(delay_us);
+    duration = us_to_ticks(duration_us);
+    if ((duration == 0) || (delay > ARBITER_TICKS_MAX) || (duration > ARBITER_TICKS_MAX - delay))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    nrf_drv_clock_hfclk_reservation_cancel(p_reservation);
+
+    CRITICAL_REGION_ENTER();
+    now = nrf_drv_rtc_counter_get(m_arbiter.p_rtc);
+    p_reservation->start    = now + delay;
+    p_reservation->end      = p_reservation->start + duration;
+    p_reservation->notified = false;
+
+    pp_res = &m_arbiter.p_head;
+    while ((*pp_res != NULL) && (ticks_diff((*pp_res)->start, p_reservation->start) <= 0))
+    {
+        pp_res = &(*pp_res)->p_next;
+    }
+    p_reservation->p_next = *pp_res;
+    *pp_res               = p_reservation;
+    CRITICAL_REGION_EXIT();
+
+    arbiter_evaluate();
+
+    return NRF_SUCCESS;
+}
+
+void nrf_drv_clock_hfclk_reservation_cancel(nrf_drv_clock_hfclk_reservation_t * p_reservation)
+{
+    nrf_drv_clock_hfclk_reservation_t ** pp_res;
+    bool                                 found = false;
+
+    ASSERT(p_reservation != NULL);
+
+    if (m_arbiter.p_rtc == NULL)
+    {
+        return;
+    }
+
+    CRITICAL_REGION_ENTER();
+    for (pp_res = &m_arbiter.p_head; *pp_res != NULL; pp_res = &(*pp_res)->p_next)
+    {
+        if (*pp_res == p_reservation)
+        {
+            *pp_res = p_reservation->p_next;
+            found   = true;
+            break;
+        }
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (found)
+    {
+        arbiter_evaluate();
+    }
+}
+
+uint32_t nrf_drv_clock_hfclk_startup_ticks_get(void)
+{
+    return m_arbiter.warmup_ticks;
+}
+#endif // CLOCK_CONFIG_HFCLK_ARBITER_ENABLED
+
 #ifdef SOFTDEVICE_PRESENT
 
 void nrf_drv_clock_on_soc_event(uint32_t evt_id)
 {
     if (evt_id == NRF_EVT_HFCLKSTARTED)
     {
+#if CLOCK_CONFIG_HFCLK_ARBITER_ENABLED
+        arbiter_startup_measure();
+#endif
         clock_clk_started_notify(NRF_DRV_CLOCK_EVT_HFCLK_STARTED);
     }
 }
@@ -21,6 +21,82 @@
 #include "sdk_config.h"
 #include "nrf_drv_common.h"
 
+/** @brief Enable the HFCLK arbiter, which schedules the crystal for future needs.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef CLOCK_CONFIG_HFCLK_ARBITER_ENABLED
+#define CLOCK_CONFIG_HFCLK_ARBITER_ENABLED 0
+#endif
+
+/** @brief Initial prediction of the start-up time of the HFCLK crystal, in microseconds.
+ *
+ * The prediction is updated with the measured start-up times.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef CLOCK_CONFIG_HFCLK_STARTUP_US
+#define CLOCK_CONFIG_HFCLK_STARTUP_US 400
+#endif
+
+/** @brief Break-even time of the HFCLK crystal, in microseconds.
+ *
+ * A gap between two needs that is shorter than this is bridged by keeping the crystal running,
+ * as that costs less than stopping and starting it again.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef CLOCK_CONFIG_HFCLK_BREAK_EVEN_US
+#define CLOCK_CONFIG_HFCLK_BREAK_EVEN_US 1000
+#endif
+
+/** @brief Change of the die temperature that starts a calibration of the LFRC, in hundredths of a
+ *         degree, or 0 to disable.
+ *
+ * Used with the RC oscillator, without the SoftDevice, when @ref die_temp is enabled. The
+ * oscillator is then calibrated when the temperature has changed, instead of at a fixed
+ * interval. The accuracy of 500 ppm is kept with a calibration every 0.5 degree. With the
+ * SoftDevice, the calibration is done by the SoftDevice, which measures the temperature itself.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef CLOCK_CONFIG_LF_CAL_TEMP_DELTA
+#define CLOCK_CONFIG_LF_CAL_TEMP_DELTA 0
+#endif
+
+/** @brief Enable the adaptive calibration of the LFRC, see @ref nrf_drv_clock_calibration_adaptive_start.
+ *
+ * Requires CLOCK_CONFIG_LF_CAL_TEMP_DELTA and @ref die_temp.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef CLOCK_CONFIG_LF_CAL_ADAPTIVE_ENABLED
+#define CLOCK_CONFIG_LF_CAL_ADAPTIVE_ENABLED 0
+#endif
+
+/** @brief Shortest time between two temperature checks of the adaptive calibration, in 0.25 s units.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef CLOCK_CONFIG_LF_CAL_INTERVAL_MIN
+#define CLOCK_CONFIG_LF_CAL_INTERVAL_MIN 16
+#endif
+
+/** @brief Longest time between two calibrations of the adaptive calibration, in 0.25 s units.
+ *
+ * The oscillator is calibrated after this time even if the temperature did not change, for the
+ * drift that does not come from the temperature.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef CLOCK_CONFIG_LF_CAL_INTERVAL_MAX
+#define CLOCK_CONFIG_LF_CAL_INTERVAL_MAX 960
+#endif
+
+#if CLOCK_CONFIG_HFCLK_ARBITER_ENABLED
+#include "nrf_drv_rtc.h"
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -66,6 +142,23 @@ struct nrf_drv_clock_handler_item_s
     nrf_drv_clock_event_handler_t  event_handler; ///< Function to be called when the clock is started.
 };
 
+// Forward declaration of the nrf_drv_clock_hfclk_reservation_t type.
+typedef struct nrf_drv_clock_hfclk_reservation_s nrf_drv_clock_hfclk_reservation_t;
+
+/**
+ * @brief Reservation of the HFCLK for a future need.
+ *
+ * Only @p event_handler is set by the user. The other fields are used by the driver.
+ */
+struct nrf_drv_clock_hfclk_reservation_s
+{
+    nrf_drv_clock_hfclk_reservation_t * p_next;        ///< A pointer to the next reservation.
+    nrf_drv_clock_event_handler_t       event_handler; ///< NULL or function to be called when the clock is running for the reservation.
+    uint32_t                            start;         ///< RTC counter when the clock must be running.
+    uint32_t                            end;           ///< RTC counter when the clock is no longer needed.
+    bool                                notified;      ///< True if @p event_handler was called.
+};
+
 /**
  * @brief Function for checking if driver is already initialized
  *
@@ -169,6 +262,71 @@ void nrf_drv_clock_hfclk_release(void);
  */
 bool nrf_drv_clock_hfclk_is_running(void);
 
+#if CLOCK_CONFIG_HFCLK_ARBITER_ENABLED || defined(__SDK_DOXYGEN__)
+/**
+ * @brief Function for initializing the HFCLK arbiter.
+ *
+ * The arbiter starts the HFCLK crystal for reservations made with @ref nrf_drv_clock_hfclk_reserve,
+ * just in time for them, and merges reservations that overlap or are separated by less than
+ * CLOCK_CONFIG_HFCLK_BREAK_EVEN_US. When the last request made with @ref nrf_drv_clock_hfclk_request is
+ * released, the crystal is kept running for the break-even time, in case it is requested again.
+ *
+ * The start-up time of the crystal is predicted from its past start-ups, starting from
+ * CLOCK_CONFIG_HFCLK_STARTUP_US.
+ *
+ * The LFCLK is requested for the RTC.
+ *
+ * @param[in] p_rtc         Instance of the RTC driver that times the arbiter. It is owned by the
+ *                          arbiter and compare channel 0 is used.
+ * @param[in] p_rtc_config  Configuration of the RTC instance.
+ *
+ * @retval NRF_SUCCESS             If the arbiter was initialized.
+ * @retval NRF_ERROR_INVALID_STATE If the driver was not initialized.
+ * @return Any error returned by @ref nrf_drv_rtc_init.
+ */
+ret_code_t nrf_drv_clock_hfclk_arbiter_init(nrf_drv_rtc_t const *        p_rtc,
+                                            nrf_drv_rtc_config_t const * p_rtc_config);
+
+/**
+ * @brief Function for reserving the HFCLK for a future need.
+ *
+ * The crystal is started so that it runs @p delay_us from now, and it is kept running for
+ * @p duration_us. The event handler of the reservation is called with
+ * @ref NRF_DRV_CLOCK_EVT_HFCLK_STARTED once the clock is running, which can be a little before the
+ * requested time. An already queued reservation is moved.
+ *
+ * @note The reservation provided by the user cannot be an automatic variable.
+ *
+ * @param[in] p_reservation Reservation.
+ * @param[in] delay_us      Time from now when the clock must be running.
+ * @param[in] duration_us   Time for which the clock is needed.
+ *
+ * @retval NRF_SUCCESS             If the reservation was queued.
+ * @retval NRF_ERROR_INVALID_STATE If the arbiter was not initialized.
+ * @retval NRF_ERROR_INVALID_PARAM If @p duration_us was 0 or the reservation ends too far in the future
+ *                                 (more than half the range of the RTC counter).
+ */
+ret_code_t nrf_drv_clock_hfclk_reserve(nrf_drv_clock_hfclk_reservation_t * p_reservation,
+                                       uint32_t                            delay_us,
+                                       uint32_t                            duration_us);
+
+/**
+ * @brief Function for cancelling a reservation.
+ *
+ * Nothing is done if the reservation is not queued.
+ *
+ * @param[in] p_reservation Reservation.
+ */
+void nrf_drv_clock_hfclk_reservation_cancel(nrf_drv_clock_hfclk_reservation_t * p_reservation);
+
+/**
+ * @brief Function for getting the predicted start-up time of the HFCLK crystal.
+ *
+ * @return Predicted start-up time in RTC ticks.
+ */
+uint32_t nrf_drv_clock_hfclk_startup_ticks_get(void);
+#endif // CLOCK_CONFIG_HFCLK_ARBITER_ENABLED
+
 /**
  * @brief Function for starting a single calibration process.
  *
@@ -205,6 +363,50 @@ ret_code_t nrf_drv_clock_calibration_start(uint8_t delay, nrf_drv_clock_event_ha
  */
 ret_code_t nrf_drv_clock_calibration_abort(void);
 
+/**
+ * @brief Function for starting the adaptive calibration of the LFRC.
+ *
+ * The oscillator is calibrated at once, and then the temperature is checked through @ref die_temp
+ * at an interval that adapts to it. The interval starts at CLOCK_CONFIG_LF_CAL_INTERVAL_MIN, is
+ * doubled at every check where the temperature is stable, up to CLOCK_CONFIG_LF_CAL_INTERVAL_MAX,
+ * and is halved when it swings. The oscillator is calibrated when the temperature has changed by
+ * CLOCK_CONFIG_LF_CAL_TEMP_DELTA since the last calibration, and at least every
+ * CLOCK_CONFIG_LF_CAL_INTERVAL_MAX. Each temperature check wakes the CPU once, and no HFCLK is
+ * requested unless the oscillator is calibrated.
+ *
+ * While it runs, @ref nrf_drv_clock_calibration_start must not be called, and
+ * @ref nrf_drv_clock_is_calibrating returns true. It is stopped by
+ * @ref nrf_drv_clock_calibration_adaptive_stop, or by @ref nrf_drv_clock_calibration_abort, in which
+ * case @p handler is called with @ref NRF_DRV_CLOCK_EVT_CAL_ABORTED.
+ *
+ * @note Available only when CLOCK_CONFIG_LF_CAL_ADAPTIVE_ENABLED is set. With the SoftDevice,
+ *       the calibration is done by the SoftDevice, which skips it when the temperature is stable.
+ *
+ * @param[in] handler                             NULL or user function to be called when each
+ *                                                calibration is done.
+ *
+ * @retval     NRF_SUCCESS                        If the first calibration was started.
+ * @retval     NRF_ERROR_INVALID_STATE            If the low-frequency clock is off, or the adaptive
+ *                                                calibration is already running.
+ * @retval     NRF_ERROR_BUSY                     If a calibration is in progress.
+ */
+ret_code_t nrf_drv_clock_calibration_adaptive_start(nrf_drv_clock_event_handler_t handler);
+
+/**
+ * @brief Function for stopping the adaptive calibration.
+ *
+ * A calibration that is in progress is finished, but no other one is started.
+ */
+void nrf_drv_clock_calibration_adaptive_stop(void);
+
+/**
+ * @brief Function for getting the current interval between two temperature checks of the adaptive
+ *        calibration.
+ *
+ * @return Interval, in 0.25 s units.
+ */
+uint32_t nrf_drv_clock_calibration_interval_get(void);
+
 /**
  * @brief Function for checking if calibration is in progress.
  *
@@ -115,4 +115,62 @@
 
 
 
+/** @brief Enable the HFCLK arbiter
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define CLOCK_CONFIG_HFCLK_ARBITER_ENABLED
+
+
+/** @brief Initial prediction of the HFCLK start-up time in microseconds
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define CLOCK_CONFIG_HFCLK_STARTUP_US
+
+
+/** @brief HFCLK break-even time in microseconds
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define CLOCK_CONFIG_HFCLK_BREAK_EVEN_US
+
+
+/** @brief Die temperature change that starts an LFRC calibration, in hundredths of a degree
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define CLOCK_CONFIG_LF_CAL_TEMP_DELTA
+
+
+/** @brief Enable the adaptive LFRC calibration
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define CLOCK_CONFIG_LF_CAL_ADAPTIVE_ENABLED
+
+
+/** @brief Shortest interval of the adaptive LFRC calibration, in 0.25 s units
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define CLOCK_CONFIG_LF_CAL_INTERVAL_MIN
+
+
+/** @brief Longest interval of the adaptive LFRC calibration, in 0.25 s units
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define CLOCK_CONFIG_LF_CAL_INTERVAL_MAX
+
+
+
 /** @} */
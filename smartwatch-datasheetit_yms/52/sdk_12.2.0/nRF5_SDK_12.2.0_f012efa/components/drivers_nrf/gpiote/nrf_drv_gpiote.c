@@ -17,6 +17,7 @@
 #include "app_util_platform.h"
 #include "nrf_assert.h"
 #include "nrf_bitmask.h"
+#include "cpu_profiler_hooks.h"
 #include <string.h>
 
 #define NRF_LOG_MODULE_NAME "GPIOTE"
@@ -85,6 +86,9 @@ typedef struct
     nrf_drv_gpiote_evt_handler_t handlers[GPIOTE_CH_NUM + GPIOTE_CONFIG_NUM_OF_LOW_POWER_EVENTS];
     int8_t                       pin_assignments[NUMBER_OF_PINS];
     int8_t                       port_handlers_pins[GPIOTE_CONFIG_NUM_OF_LOW_POWER_EVENTS];
+    uint32_t                     port_sense_enabled[GPIO_COUNT]; ///< Low-accuracy pins with sensing enabled.
+    uint32_t                     port_sense_high[GPIO_COUNT];    ///< Low-accuracy pins sensing high level.
+    uint32_t                     port_toggle[GPIO_COUNT];        ///< Low-accuracy pins in toggle mode.
     nrf_drv_state_t              state;
 } gpiote_control_block_t;
 
@@ -147,6 +151,34 @@ __STATIC_INLINE void pin_in_use_clear(uint32_t pin)
 }
 
 
+/**
+ * @brief Function for setting the sense level of a low-accuracy pin.
+ *
+ * The sense level is mirrored in bitmasks, so that the pins that caused a PORT event can be found
+ * without reading the configuration of every pin.
+ */
+__STATIC_INLINE void port_sense_set(uint32_t pin, nrf_gpio_pin_sense_t sense)
+{
+    if (sense == NRF_GPIO_PIN_NOSENSE)
+    {
+        nrf_bitmask_bit_clear(pin, m_cb.port_sense_enabled);
+    }
+    else
+    {
+        if (sense == NRF_GPIO_PIN_SENSE_HIGH)
+        {
+            nrf_bitmask_bit_set(pin, m_cb.port_sense_high);
+        }
+        else
+        {
+            nrf_bitmask_bit_clear(pin, m_cb.port_sense_high);
+        }
+        nrf_bitmask_bit_set(pin, m_cb.port_sense_enabled);
+    }
+    nrf_gpio_cfg_sense_set(pin, sense);
+}
+
+
 __STATIC_INLINE int8_t channel_port_get(uint32_t pin)
 {
     return m_cb.pin_assignments[pin];
@@ -219,6 +251,10 @@ ret_code_t nrf_drv_gpiote_init(void)
         channel_free(i);
     }
 
+    memset(m_cb.port_sense_enabled, 0, sizeof(m_cb.port_sense_enabled));
+    memset(m_cb.port_sense_high, 0, sizeof(m_cb.port_sense_high));
+    memset(m_cb.port_toggle, 0, sizeof(m_cb.port_toggle));
+
     nrf_drv_common_irq_enable(GPIOTE_IRQn, GPIOTE_CONFIG_IRQ_PRIORITY);
     nrf_gpiote_event_clear(NRF_GPIOTE_EVENTS_PORT);
     nrf_gpiote_int_enable(GPIOTE_INTENSET_PORT_Msk);
@@ -503,6 +539,10 @@ ret_code_t nrf_drv_gpiote_in_init(nrf_drv_gpiote_pin_t               pin,
             {
                 m_cb.port_handlers_pins[channel -
                                         GPIOTE_CH_NUM] |= (p_config->sense) << SENSE_FIELD_POS;
+                if (p_config->sense == NRF_GPIOTE_POLARITY_TOGGLE)
+                {
+                    nrf_bitmask_bit_set(pin, m_cb.port_toggle);
+                }
             }
         }
         else
@@ -539,7 +579,7 @@ void nrf_drv_gpiote_in_event_enable(nrf_drv_gpiote_pin_t pin, bool int_enable)
             sense = (polarity == NRF_GPIOTE_POLARITY_LOTOHI) ?
                     NRF_GPIO_PIN_SENSE_HIGH : NRF_GPIO_PIN_SENSE_LOW;
         }
-        nrf_gpio_cfg_sense_set(pin, sense);
+        port_sense_set(pin, sense);
     }
     else if (pin_in_use_by_te(pin))
     {
@@ -568,7 +608,7 @@ void nrf_drv_gpiote_in_event_disable(nrf_drv_gpiote_pin_t pin)
     ASSERT(pin_in_use_by_gpiote(pin));
     if (pin_in_use_by_port(pin))
     {
-        nrf_gpio_cfg_sense_set(pin, NRF_GPIO_PIN_NOSENSE);
+        port_sense_set(pin, NRF_GPIO_PIN_NOSENSE);
     }
     else if (pin_in_use_by_te(pin))
     {
@@ -589,6 +629,7 @@ void nrf_drv_gpiote_in_uninit(nrf_drv_gpiote_pin_t pin)
         nrf_gpiote_te_default(channel_port_get(pin));
     }
     nrf_gpio_cfg_default(pin);
+    nrf_bitmask_bit_clear(pin, m_cb.port_toggle);
     channel_free((uint8_t)channel_port_get(pin));
     pin_in_use_clear(pin);
 }
@@ -616,8 +657,12 @@ uint32_t nrf_drv_gpiote_in_event_addr_get(nrf_drv_gpiote_pin_t pin)
 }
 
 
+#if GPIOTE_CONFIG_IRQ_RAMFUNC
+__RAMFUNC
+#endif
 void GPIOTE_IRQHandler(void)
 {
+    CPU_PROFILER_ISR_ENTER(CPU_PROFILER_ISR_GPIOTE);
     uint32_t status            = 0;
     uint32_t input[GPIO_COUNT] = {0};
 
@@ -675,8 +720,7 @@ void GPIOTE_IRQHandler(void)
     {
         /* Process port event. */
         uint32_t port_idx;
-        uint8_t  repeat                  = 0;
-        uint32_t toggle_mask[GPIO_COUNT] = {0};
+        uint8_t  repeat = 0;
         uint32_t pins_to_check[GPIO_COUNT];
 
         // Faster way of doing memset because in interrupt context.
@@ -689,47 +733,43 @@ void GPIOTE_IRQHandler(void)
         {
             repeat = 0;
 
-            for (i = 0; i < GPIOTE_CONFIG_NUM_OF_LOW_POWER_EVENTS; i++)
+            for (port_idx = 0; port_idx < GPIO_COUNT; port_idx++)
             {
-                uint8_t              pin_and_sense = m_cb.port_handlers_pins[i];
-                nrf_drv_gpiote_pin_t pin           = (pin_and_sense & ~SENSE_FIELD_MASK);
+                // Pins whose level equals their sense level are the ones that drive the
+                // SENSE signal.
+                uint32_t active = ~(input[port_idx] ^ m_cb.port_sense_high[port_idx]) &
+                                  m_cb.port_sense_enabled[port_idx] &
+                                  pins_to_check[port_idx];
 
-                if ((m_cb.port_handlers_pins[i] != PIN_NOT_USED)
-                    && nrf_bitmask_bit_is_set(pin, pins_to_check))
+                while (active)
                 {
-                    nrf_gpiote_polarity_t polarity =
-                        (nrf_gpiote_polarity_t)((pin_and_sense &
+                    uint32_t             bit = 31 - __CLZ(active);
+                    nrf_drv_gpiote_pin_t pin = (port_idx * 32) + bit;
+
+                    active &= ~(1UL << bit);
+
+                    // The sense of the pin might have been disabled by a handler.
+                    if (!nrf_bitmask_bit_is_set(pin, m_cb.port_sense_enabled))
+                    {
+                        continue;
+                    }
+
+                    int8_t                       channel  = channel_port_get(pin);
+                    nrf_drv_gpiote_evt_handler_t handler  = channel_handler_get(channel);
+                    nrf_gpiote_polarity_t        polarity =
+                        (nrf_gpiote_polarity_t)(((uint8_t)m_cb.port_handlers_pins[channel - GPIOTE_CH_NUM] &
                                                  SENSE_FIELD_MASK) >> SENSE_FIELD_POS);
-                    nrf_drv_gpiote_evt_handler_t handler =
-                        channel_handler_get(channel_port_get(pin));
-                    if (handler || (polarity == NRF_GPIOTE_POLARITY_TOGGLE))
+
+                    NRF_LOG_DEBUG("PORT event for pin: %d, polarity: %d.\r\n", pin, polarity);
+                    if (polarity == NRF_GPIOTE_POLARITY_TOGGLE)
                     {
-                        if (polarity == NRF_GPIOTE_POLARITY_TOGGLE)
-                        {
-                            nrf_bitmask_bit_set(pin, toggle_mask);
-                        }
-                        nrf_gpio_pin_sense_t sense     = nrf_gpio_pin_sense_get(pin);
-                        uint32_t             pin_state = nrf_bitmask_bit_is_set(pin, input);
-                        if ((pin_state && (sense == NRF_GPIO_PIN_SENSE_HIGH)) ||
-                            (!pin_state && (sense == NRF_GPIO_PIN_SENSE_LOW))  )
-                        {
-                            NRF_LOG_DEBUG("PORT event for pin: %d, polarity: %d.\r\n", pin,
-                                          polarity);
-                            if (polarity == NRF_GPIOTE_POLARITY_TOGGLE)
-                            {
-                                nrf_gpio_pin_sense_t next_sense =
-                                    (sense == NRF_GPIO_PIN_SENSE_HIGH) ?
-                                    NRF_GPIO_PIN_SENSE_LOW :
-                                    NRF_GPIO_PIN_SENSE_HIGH;
-                                nrf_gpio_cfg_sense_set(pin, next_sense);
-                                ++repeat;
-
-                            }
-                            if (handler)
-                            {
-                                handler(pin, polarity);
-                            }
-                        }
+                        port_sense_set(pin, nrf_bitmask_bit_is_set(pin, m_cb.port_sense_high) ?
+                                            NRF_GPIO_PIN_SENSE_LOW : NRF_GPIO_PIN_SENSE_HIGH);
+                        ++repeat;
+                    }
+                    if (handler)
+                    {
+                        handler(pin, polarity);
                     }
                 }
             }
@@ -767,13 +807,15 @@ void GPIOTE_IRQHandler(void)
                     for (port_idx = 0; port_idx < GPIO_COUNT; port_idx++)
                     {
                         input[port_idx]         = new_input[port_idx];
-                        pins_to_check[port_idx] = toggle_mask[port_idx];
+                        pins_to_check[port_idx] = m_cb.port_toggle[port_idx];
                     }
                 }
             }
         }
         while (repeat);
     }
+
+    CPU_PROFILER_ISR_EXIT(CPU_PROFILER_ISR_GPIOTE);
 }
 
 
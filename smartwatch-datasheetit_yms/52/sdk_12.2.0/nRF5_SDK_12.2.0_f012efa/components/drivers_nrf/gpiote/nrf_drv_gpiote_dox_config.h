@@ -39,6 +39,15 @@
 #define GPIOTE_CONFIG_IRQ_PRIORITY
 
 
+/** @brief Run the interrupt handler from RAM
+ *
+ *  Set to 1 to activate. The handler then has no flash wait states, see @ref __RAMFUNC.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define GPIOTE_CONFIG_IRQ_RAMFUNC
+
+
 /** @brief Enables logging in the module.
  *
  *  Set to 1 to activate.
@@ -82,12 +82,71 @@ void nrf_nvmc_write_word(uint32_t address, uint32_t value)
     }
 }
 
-void nrf_nvmc_write_bytes(uint32_t address, const uint8_t * src, uint32_t num_bytes)
+/**
+ * @brief Function for composing a word of flash from the bytes to write to it.
+ *
+ * @param address32  Address of the word.
+ * @param byte_shift Position in the word of the first byte to write.
+ * @param src        Bytes to write.
+ * @param count      Number of bytes to write, the other bytes of the word are kept.
+ */
+static uint32_t nvmc_word_compose(uint32_t address32, uint32_t byte_shift, const uint8_t * src, uint32_t count)
 {
+    uint32_t value32 = (count == 4) ? 0 : *(uint32_t*)address32;
     uint32_t i;
-    for (i=0;i<num_bytes;i++)
+
+    for (i = 0; i < count; i++)
+    {
+        uint32_t shift = (byte_shift + i) << 3;
+        value32 = (value32 & ~((uint32_t)0xFF << shift)) | ((uint32_t)src[i] << shift);
+    }
+
+    return value32;
+}
+
+void nrf_nvmc_write_bytes(uint32_t address, const uint8_t * src, uint32_t num_bytes)
+{
+    uint32_t byte_shift = address & (uint32_t)0x03;
+    uint32_t address32  = address & ~byte_shift;
+    uint32_t count;
+    uint32_t value32;
+
+    if (num_bytes == 0)
+    {
+        return;
+    }
+
+    // Enable write, once for the whole burst.
+    NRF_NVMC->CONFIG = NVMC_CONFIG_WEN_Wen;
+    while (NRF_NVMC->READY == NVMC_READY_READY_Busy)
+    {
+    }
+
+    // Only the first and the last word can be partial, and need to be read back.
+    while (num_bytes > 0)
+    {
+        count = (num_bytes < (4 - byte_shift)) ? num_bytes : (4 - byte_shift);
+
+        // The word is composed while the previous one is being written.
+        value32 = nvmc_word_compose(address32, byte_shift, src, count);
+        while (NRF_NVMC->READY == NVMC_READY_READY_Busy)
+        {
+        }
+        *(uint32_t*)address32 = value32;
+
+        src        += count;
+        num_bytes  -= count;
+        address32  += 4;
+        byte_shift  = 0;
+    }
+
+    while (NRF_NVMC->READY == NVMC_READY_READY_Busy)
+    {
+    }
+
+    NRF_NVMC->CONFIG = NVMC_CONFIG_WEN_Ren;
+    while (NRF_NVMC->READY == NVMC_READY_READY_Busy)
     {
-       nrf_nvmc_write_byte(address + i,src[i]);
     }
 }
 
@@ -71,6 +71,10 @@ void nrf_nvmc_write_word(uint32_t address, uint32_t value);
 /**
  * @brief Write consecutive bytes to flash.
  *
+ * Whole words are written, write is enabled once for all of them. Only the
+ * first and the last word, if they are partial, are read and rewritten.
+ * The source does not need to be word-aligned.
+ *
  * @param address   Address to write to.
  * @param src       Pointer to data to copy from.
  * @param num_bytes Number of bytes in src to write.
@@ -83,6 +83,8 @@ typedef enum
 } nrf_qdec_enable_t;
 
 
+#define NRF_QDEC_LED_NOT_CONNECTED 0xFFFFFFFF /**< Value of the LED pin for QDEC without an LED. */
+
 /**
  * @enum nrf_qdec_dbfen_t
  * @brief States of the debounce filter enable bit.
@@ -43,6 +43,16 @@ extern "C" {
 
 #define NRF_QSPI_PIN_VAL(pin) (pin) == NRF_QSPI_PIN_NOT_CONNECTED ? 0xFFFFFFFF : (pin)
 
+/**
+ * @brief Start of the memory region in which the external memory can be read directly (XIP).
+ */
+#define NRF_QSPI_XIP_START_ADDR 0x12000000UL
+
+/**
+ * @brief Size of the XIP region.
+ */
+#define NRF_QSPI_XIP_SIZE       0x08000000UL
+
 /**
  * @brief QSPI tasks.
  */
@@ -443,6 +453,25 @@ __STATIC_INLINE uint8_t nrf_qspi_sreg_get(NRF_QSPI_Type const * p_reg);
  */
 __STATIC_INLINE bool nrf_qspi_busy_check(NRF_QSPI_Type const * p_reg);
 
+/**
+ * @brief Function for setting the address of the external memory that is read at
+ *        @ref NRF_QSPI_XIP_START_ADDR.
+ *
+ * @param[in] p_reg      Pointer to the peripheral register structure.
+ * @param[in] xip_offset Address in the external memory.
+ */
+__STATIC_INLINE void nrf_qspi_xip_offset_set(NRF_QSPI_Type * p_reg, uint32_t xip_offset);
+
+/**
+ * @brief Function for getting the address of the external memory that is read at
+ *        @ref NRF_QSPI_XIP_START_ADDR.
+ *
+ * @param[in] p_reg Pointer to the peripheral register structure.
+ *
+ * @return Address in the external memory.
+ */
+__STATIC_INLINE uint32_t nrf_qspi_xip_offset_get(NRF_QSPI_Type const * p_reg);
+
 /**
  * @brief Function for setting registers sending with custom instruction transmission.
  *
@@ -623,6 +652,16 @@ __STATIC_INLINE bool nrf_qspi_busy_check(NRF_QSPI_Type const * p_reg)
             QSPI_STATUS_READY_Pos) == QSPI_STATUS_READY_BUSY;
 }
 
+__STATIC_INLINE void nrf_qspi_xip_offset_set(NRF_QSPI_Type * p_reg, uint32_t xip_offset)
+{
+    p_reg->XIPOFFSET = xip_offset;
+}
+
+__STATIC_INLINE uint32_t nrf_qspi_xip_offset_get(NRF_QSPI_Type const * p_reg)
+{
+    return p_reg->XIPOFFSET;
+}
+
 __STATIC_INLINE void nrf_qspi_cinstrdata_set(NRF_QSPI_Type *       p_reg,
                                              nrf_qspi_cinstr_len_t length,
                                              void const *          p_tx_data)
@@ -39,8 +39,9 @@
 // Control block - driver instance local data.
 typedef struct
 {
-    nrf_drv_i2s_data_handler_t handler;
-    nrf_drv_state_t            state;
+    nrf_drv_i2s_data_handler_t              handler;
+    nrf_drv_i2s_tx_buffer_request_handler_t tx_buffer_request;
+    nrf_drv_state_t                         state;
 
     bool       synchronized_mode : 1;
     bool       rx_ready          : 1;
@@ -234,14 +235,22 @@ ret_code_t nrf_drv_i2s_start(uint32_t * p_rx_buffer,
         // with this until the first portion of data is received, so here we
         // just make sure that there will be silence on the SDOUT line prior
         // to that moment.
+        uint32_t * p_tx_buffer_first = NULL;
+
         if (m_cb.synchronized_mode)
         {
             memset(m_cb.p_tx_buffer, 0, buffer_size);
         }
-        else
+        else if ((m_cb.tx_buffer_request == NULL) ||
+                 ((p_tx_buffer_first = m_cb.tx_buffer_request()) == NULL))
         {
             m_cb.handler(NULL, m_cb.p_tx_buffer, m_cb.buffer_half_size);
         }
+        else
+        {
+            ASSERT(nrf_drv_is_in_RAM(p_tx_buffer_first));
+            nrf_i2s_tx_buffer_set(NRF_I2S, p_tx_buffer_first);
+        }
     }
 
     nrf_i2s_event_clear(NRF_I2S, NRF_I2S_EVENT_RXPTRUPD);
@@ -275,6 +284,13 @@ void nrf_drv_i2s_stop(void)
 }
 
 
+void nrf_drv_i2s_tx_buffer_request_handler_set(nrf_drv_i2s_tx_buffer_request_handler_t handler)
+{
+    ASSERT(m_cb.state != NRF_DRV_STATE_POWERED_ON);
+    m_cb.tx_buffer_request = handler;
+}
+
+
 void I2S_IRQHandler(void)
 {
     uint32_t * p_data_received = NULL;
@@ -289,25 +305,38 @@ void I2S_IRQHandler(void)
         // event has been generated, just ignore it.
         if (m_cb.p_tx_buffer != NULL)
         {
-            uint32_t * p_tx_buffer_next;
-            if (nrf_i2s_tx_buffer_get(NRF_I2S) == m_cb.p_tx_buffer)
+            uint32_t * p_tx_buffer_next = NULL;
+            if ((m_cb.tx_buffer_request != NULL) && !m_cb.synchronized_mode)
             {
-                p_tx_buffer_next = m_cb.p_tx_buffer + m_cb.buffer_half_size;
+                p_tx_buffer_next = m_cb.tx_buffer_request();
+            }
+
+            if (p_tx_buffer_next != NULL)
+            {
+                // The buffer is ready to be sent, there is nothing to fill.
+                ASSERT(nrf_drv_is_in_RAM(p_tx_buffer_next));
+                nrf_i2s_tx_buffer_set(NRF_I2S, p_tx_buffer_next);
             }
             else
             {
-                p_tx_buffer_next = m_cb.p_tx_buffer;
+                if (nrf_i2s_tx_buffer_get(NRF_I2S) == m_cb.p_tx_buffer)
+                {
+                    p_tx_buffer_next = m_cb.p_tx_buffer + m_cb.buffer_half_size;
+                }
+                else
+                {
+                    p_tx_buffer_next = m_cb.p_tx_buffer;
+                }
+                nrf_i2s_tx_buffer_set(NRF_I2S, p_tx_buffer_next);
+
+                // Now the part of the buffer that we've configured as "next" should
+                // be filled by the application with proper data to be sent;
+                // the peripheral is sending data from the other part of the buffer
+                // (but it will finish soon...).
+                p_data_to_send = p_tx_buffer_next;
             }
-            nrf_i2s_tx_buffer_set(NRF_I2S, p_tx_buffer_next);
 
             m_cb.tx_ready = true;
-
-            // Now the part of the buffer that we've configured as "next" should
-            // be filled by the application with proper data to be sent;
-            // the peripheral is sending data from the other part of the buffer
-            // (but it will finish soon...).
-            p_data_to_send = p_tx_buffer_next;
-
         }
     }
 
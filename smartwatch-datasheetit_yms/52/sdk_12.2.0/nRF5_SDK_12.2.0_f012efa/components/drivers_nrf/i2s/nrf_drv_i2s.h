@@ -134,6 +134,20 @@ typedef void (* nrf_drv_i2s_data_handler_t)(uint32_t const * p_data_received,
                                             uint32_t       * p_data_to_send,
                                             uint16_t         number_of_words);
 
+/**
+ * @brief TX buffer request handler.
+ *
+ * This handler is called from the I2S interrupt when the peripheral has started sending
+ * a buffer, to get the buffer that is sent next, and once when the transfer is started.
+ * The buffer must already hold the data: it is only pointed to by the peripheral, so
+ * nothing is written in the interrupt. It must be placed in the Data RAM region and hold
+ * half the number of words given to @ref nrf_drv_i2s_start.
+ *
+ * @return Buffer to send next, or NULL if none is ready. The data handler is then called
+ *         to fill a part of the transmit buffer given to @ref nrf_drv_i2s_start.
+ */
+typedef uint32_t * (* nrf_drv_i2s_tx_buffer_request_handler_t)(void);
+
 
 /**
  * @brief Function for initializing the I2S driver.
@@ -218,6 +232,19 @@ ret_code_t nrf_drv_i2s_start(uint32_t * p_rx_buffer,
  */
 void       nrf_drv_i2s_stop(void);
 
+/**
+ * @brief Function for setting the TX buffer request handler.
+ *
+ * With the handler, buffers rendered in advance are transmitted without any copy.
+ * The handler is not used in the synchronized mode.
+ *
+ * @note This function must be called when the transfer is stopped.
+ *
+ * @param[in] handler TX buffer request handler, or NULL to fill the transmit buffer
+ *                    given to @ref nrf_drv_i2s_start in the data handler only.
+ */
+void       nrf_drv_i2s_tx_buffer_request_handler_set(nrf_drv_i2s_tx_buffer_request_handler_t handler);
+
 
 #ifdef __cplusplus
 }
@@ -165,7 +165,7 @@ void nrf_drv_lpcomp_disable(void)
     ASSERT(m_state == NRF_DRV_STATE_POWERED_ON);
     nrf_lpcomp_disable();
     nrf_lpcomp_task_trigger(NRF_LPCOMP_TASK_STOP);
-    m_state = NRF_DRV_STATE_POWERED_ON;
+    m_state = NRF_DRV_STATE_INITIALIZED;
     NRF_LOG_INFO("Disabled.\r\n");
 }
 
@@ -51,11 +51,31 @@ typedef struct
     nrf_drv_pdm_event_handler_t event_handler;    ///< Event handler function pointer.
     uint16_t                    buffer_length;    ///< Length of a single buffer in 16-bit words.
     uint32_t *                  buffers[2];       ///< Sample buffers.
+    nrf_drv_pdm_buffer_request_handler_t buffer_request; ///< Buffer request handler function pointer.
+    uint32_t *                  active_buffer;    ///< Buffer that is being filled, if buffers are requested.
+    uint32_t *                  pending_buffer;   ///< Buffer that is filled next, if buffers are requested.
 } nrf_drv_pdm_cb_t;
 
 static nrf_drv_pdm_cb_t m_cb;
 
 
+/**@brief Function for getting the buffer to fill after the one that is being filled.
+ *
+ * If the user has no buffer available, a buffer from the driver configuration is used so that the
+ * interface can keep running.
+ */
+static uint32_t * buffer_request(void)
+{
+    uint32_t * p_buffer = (uint32_t *)m_cb.buffer_request();
+
+    if (p_buffer == NULL)
+    {
+        p_buffer = (m_cb.active_buffer == m_cb.buffers[0]) ? m_cb.buffers[1] : m_cb.buffers[0];
+    }
+    return p_buffer;
+}
+
+
 void PDM_IRQHandler(void)
 {
     if (nrf_pdm_event_check(NRF_PDM_EVENT_END))
@@ -64,7 +84,13 @@ void PDM_IRQHandler(void)
         NRF_LOG_DEBUG("Event: %s.\r\n", (uint32_t)EVT_TO_STR(NRF_PDM_EVENT_END));
 
         //Buffer is ready to process.
-        if (nrf_pdm_buffer_get() == m_cb.buffers[0])
+        if (m_cb.buffer_request != NULL)
+        {
+            NRF_LOG_DEBUG("PDM data:\r\n");
+            NRF_LOG_HEXDUMP_DEBUG((uint8_t *)m_cb.active_buffer, m_cb.buffer_length * sizeof(int16_t));
+            m_cb.event_handler(m_cb.active_buffer, m_cb.buffer_length);
+        }
+        else if (nrf_pdm_buffer_get() == m_cb.buffers[0])
         {
             NRF_LOG_DEBUG("PDM data:\r\n");
             NRF_LOG_HEXDUMP_DEBUG((uint8_t *)m_cb.buffers[1], m_cb.buffer_length * sizeof(m_cb.buffers[1]));
@@ -84,7 +110,13 @@ void PDM_IRQHandler(void)
         m_cb.status = NRF_PDM_STATE_RUNNING;
 
         //Swap buffer.
-        if (nrf_pdm_buffer_get() == m_cb.buffers[0])
+        if (m_cb.buffer_request != NULL)
+        {
+            m_cb.active_buffer  = m_cb.pending_buffer;
+            m_cb.pending_buffer = buffer_request();
+            nrf_pdm_buffer_set(m_cb.pending_buffer, m_cb.buffer_length);
+        }
+        else if (nrf_pdm_buffer_get() == m_cb.buffers[0])
         {
             nrf_pdm_buffer_set(m_cb.buffers[1],m_cb.buffer_length);
         }
@@ -135,6 +167,8 @@ ret_code_t nrf_drv_pdm_init(nrf_drv_pdm_config_t const * p_config,
     m_cb.buffer_length = p_config->buffer_length;
     m_cb.event_handler = event_handler;
     m_cb.status = NRF_PDM_STATE_IDLE;
+    m_cb.active_buffer = NULL;
+    m_cb.pending_buffer = NULL;
 
     nrf_pdm_buffer_set(m_cb.buffers[0],m_cb.buffer_length);
     nrf_pdm_clock_set(p_config->clock_freq);
@@ -165,6 +199,13 @@ void nrf_drv_pdm_uninit(void)
 }
 
 
+void nrf_drv_pdm_buffer_request_handler_set(nrf_drv_pdm_buffer_request_handler_t buffer_request_handler)
+{
+    ASSERT(m_cb.status == NRF_PDM_STATE_IDLE);
+    m_cb.buffer_request = buffer_request_handler;
+}
+
+
 ret_code_t nrf_drv_pdm_start(void)
 {
     ASSERT(m_cb.drv_state != NRF_DRV_STATE_UNINITIALIZED);
@@ -184,6 +225,16 @@ ret_code_t nrf_drv_pdm_start(void)
     }
     m_cb.status = NRF_PDM_STATE_TRANSITION;
     m_cb.drv_state = NRF_DRV_STATE_POWERED_ON;
+    if (m_cb.buffer_request != NULL)
+    {
+        // A buffer that was requested before the last stop was never filled, so it is reused.
+        if (m_cb.pending_buffer == NULL)
+        {
+            m_cb.active_buffer  = NULL;
+            m_cb.pending_buffer = buffer_request();
+        }
+        nrf_pdm_buffer_set(m_cb.pending_buffer, m_cb.buffer_length);
+    }
     nrf_pdm_enable();
     nrf_pdm_event_clear(NRF_PDM_EVENT_STARTED);
     nrf_pdm_task_trigger(NRF_PDM_TASK_START);
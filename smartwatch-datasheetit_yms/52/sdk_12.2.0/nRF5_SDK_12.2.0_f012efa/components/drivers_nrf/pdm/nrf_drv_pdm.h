@@ -97,6 +97,19 @@ typedef struct
 typedef void (*nrf_drv_pdm_event_handler_t)(uint32_t * buffer, uint16_t length);
 
 
+/**
+ * @brief   Handler for PDM interface buffer requests.
+ *
+ * This handler is called from the PDM interrupt when the interface has started filling
+ * a buffer, to get the buffer that is filled next. The buffer must hold the number of 16-bit
+ * words given in the driver configuration.
+ *
+ * @return Buffer to fill next, or NULL if none is available. The samples are then
+ *         written to the buffers from the driver configuration, and are lost.
+ */
+typedef int16_t * (*nrf_drv_pdm_buffer_request_handler_t)(void);
+
+
 /**
  * @brief Function for initializing the PDM interface.
  *
@@ -119,6 +132,23 @@ ret_code_t nrf_drv_pdm_init(nrf_drv_pdm_config_t const * p_config,
 void nrf_drv_pdm_uninit(void);
 
 
+/**
+ * @brief Function for setting the handler for PDM interface buffer requests.
+ *
+ * When a buffer request handler is set, the next buffer is requested every time the interface
+ * starts filling a buffer, and every buffer is passed to the event handler once when
+ * it is full. The buffers from the driver configuration are only used when the handler
+ * returns NULL. When no handler is set, the two buffers from the driver configuration are
+ * filled alternately.
+ *
+ * @note This function must be called when sampling is stopped.
+ *
+ * @param[in] buffer_request_handler Buffer request handler, or NULL to fill the buffers from
+ *                                   the driver configuration.
+ */
+void nrf_drv_pdm_buffer_request_handler_set(nrf_drv_pdm_buffer_request_handler_t buffer_request_handler);
+
+
 /**
  * @brief Function for getting the address of a PDM interface task.
  *
@@ -113,7 +113,10 @@ ret_code_t nrf_drv_qdec_init(const nrf_drv_qdec_config_t * p_config,
     }
 
     nrf_qdec_sampleper_set(p_config->sampleper);
-    nrf_gpio_cfg_input(p_config->pselled, NRF_GPIO_PIN_NOPULL);
+    if (p_config->pselled != NRF_QDEC_LED_NOT_CONNECTED)
+    {
+        nrf_gpio_cfg_input(p_config->pselled, NRF_GPIO_PIN_NOPULL);
+    }
     nrf_gpio_cfg_input(p_config->psela, NRF_GPIO_PIN_NOPULL);
     nrf_gpio_cfg_input(p_config->pselb, NRF_GPIO_PIN_NOPULL);
     nrf_qdec_pio_assign( p_config->psela, p_config->pselb, p_config->pselled);
@@ -180,6 +183,23 @@ void nrf_drv_qdec_disable(void)
     NRF_LOG_INFO("Disabled.\r\n");
 }
 
+void nrf_drv_qdec_sampleper_set(nrf_qdec_sampleper_t sampleper)
+{
+    ASSERT(m_state != NRF_DRV_STATE_UNINITIALIZED);
+    if (m_state == NRF_DRV_STATE_POWERED_ON)
+    {
+        // SAMPLEPER is only used when sampling is started.
+        nrf_qdec_task_trigger(NRF_QDEC_TASK_STOP);
+        nrf_qdec_sampleper_set(sampleper);
+        nrf_qdec_task_trigger(NRF_QDEC_TASK_START);
+    }
+    else
+    {
+        nrf_qdec_sampleper_set(sampleper);
+    }
+    NRF_LOG_DEBUG("Sample period: %d.\r\n", sampleper);
+}
+
 void nrf_drv_qdec_accumulators_read(int16_t * p_acc, int16_t * p_accdbl)
 {
     ASSERT(m_state == NRF_DRV_STATE_POWERED_ON);
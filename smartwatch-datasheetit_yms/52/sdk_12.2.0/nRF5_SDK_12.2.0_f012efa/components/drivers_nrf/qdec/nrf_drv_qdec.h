@@ -43,7 +43,7 @@ typedef struct
     nrf_qdec_sampleper_t   sampleper;          /**< Sampling period in microseconds. */
     uint32_t               psela;              /**< Pin number for A input. */
     uint32_t               pselb;              /**< Pin number for B input. */
-    uint32_t               pselled;            /**< Pin number for LED output. */
+    uint32_t               pselled;            /**< Pin number for LED output, or @ref NRF_QDEC_LED_NOT_CONNECTED. */
     uint32_t               ledpre;             /**< Time (in microseconds) how long LED is switched on before sampling. */
     nrf_qdec_ledpol_t      ledpol;             /**< Active LED polarity. */
     bool                   dbfen;              /**< State of debouncing filter. */
@@ -122,6 +122,14 @@ void nrf_drv_qdec_enable(void);
  */
 void nrf_drv_qdec_disable(void);
 
+/**@brief Function for changing the sample period without uninitializing QDEC.
+ * @note  If QDEC is enabled, sampling is restarted, and the sample in progress is lost.
+ * @note  Function asserts if module is uninitialized.
+ *
+ * @param[in] sampleper Sample period.
+ */
+void nrf_drv_qdec_sampleper_set(nrf_qdec_sampleper_t sampleper);
+
 /**@brief Function for reading accumulated transitions QDEC.
  * @note  Function asserts if module is not enabled.
  * @note  Accumulators are cleared after reading.
@@ -15,6 +15,10 @@
 #include "nrf_assert.h"
 #include "nrf_drv_common.h"
 #include "app_util_platform.h"
+#include "cpu_profiler_hooks.h"
+#if SAADC_CONFIG_STREAM_ENABLED
+#include "nrf_drv_ppi.h"
+#endif
 
 #define NRF_LOG_MODULE_NAME "SAADC"
 
@@ -70,6 +74,12 @@ typedef struct
     uint8_t                       active_channels;               ///< Number of enabled SAADC channels.
     bool                          low_power_mode;                ///< Indicates if low power mode is active.
     bool                          conversions_end;               ///< When low power mode is active indicates end of conversions on current buffer.
+#if SAADC_CONFIG_STREAM_ENABLED
+    nrf_drv_saadc_stream_config_t stream;                        ///< Streaming mode configuration.
+    nrf_ppi_channel_t             stream_ppi[2];                 ///< PPI channels for the SAMPLE and START tasks.
+    uint8_t                       stream_active;                 ///< Streaming buffer that is being filled.
+    volatile bool                 streaming;                     ///< Indicates if streaming mode is active.
+#endif
 } nrf_drv_saadc_cb_t;
 
 static nrf_drv_saadc_cb_t m_cb;
@@ -84,8 +94,73 @@ static nrf_drv_saadc_cb_t m_cb;
                                             ? NRF_SAADC_LIMIT_LOW : NRF_SAADC_LIMIT_HIGH)
 #define HW_TIMEOUT 10000
 
+#if SAADC_CONFIG_STREAM_ENABLED
+static uint16_t stream_decimate(nrf_saadc_value_t * p_buffer)
+{
+    uint8_t const  decimation = m_cb.stream.decimation;
+    uint8_t const  channels   = m_cb.active_channels;
+    uint16_t const results    = m_cb.stream.buffer_size / decimation;
+
+    if (decimation == 1)
+    {
+        return results;
+    }
+
+    // Results are written in place, each before the samples it is computed from are overwritten.
+    for (uint16_t i = 0; i < results; i++)
+    {
+        uint16_t const first = (i / channels) * channels * decimation + (i % channels);
+        int32_t        sum   = 0;
+
+        for (uint8_t j = 0; j < decimation; j++)
+        {
+            sum += p_buffer[first + j * channels];
+        }
+        p_buffer[i] = (nrf_saadc_value_t)(sum / decimation);
+    }
+    return results;
+}
+
+static void stream_irq_handle(void)
+{
+    if (nrf_saadc_event_check(NRF_SAADC_EVENT_END))
+    {
+        nrf_saadc_event_clear(NRF_SAADC_EVENT_END);
+        NRF_LOG_DEBUG("Event: %s.\r\n", (uint32_t)EVT_TO_STR(NRF_SAADC_EVENT_END));
+
+        // The other buffer has already been started through PPI.
+        nrf_saadc_value_t * p_done = m_cb.stream.p_buffers[m_cb.stream_active];
+        m_cb.stream_active ^= 1;
+
+        nrf_drv_saadc_evt_t evt;
+        evt.type               = NRF_DRV_SAADC_EVT_DONE;
+        evt.data.done.p_buffer = p_done;
+        evt.data.done.size     = stream_decimate(p_done);
+        m_cb.event_handler(&evt);
+    }
+    if (nrf_saadc_event_check(NRF_SAADC_EVENT_STARTED))
+    {
+        nrf_saadc_event_clear(NRF_SAADC_EVENT_STARTED);
+        NRF_LOG_DEBUG("Event: %s.\r\n", (uint32_t)EVT_TO_STR(NRF_SAADC_EVENT_STARTED));
+
+        // The current buffer is latched, so the next one can be set up.
+        nrf_saadc_buffer_init(m_cb.stream.p_buffers[m_cb.stream_active ^ 1], m_cb.stream.buffer_size);
+    }
+}
+#endif // SAADC_CONFIG_STREAM_ENABLED
+
+#if SAADC_CONFIG_IRQ_RAMFUNC
+__RAMFUNC
+#endif
 void SAADC_IRQHandler(void)
 {
+    CPU_PROFILER_ISR_ENTER(CPU_PROFILER_ISR_SAADC);
+#if SAADC_CONFIG_STREAM_ENABLED
+    if (m_cb.streaming)
+    {
+        stream_irq_handle();
+    }
+#endif
     if (nrf_saadc_event_check(NRF_SAADC_EVENT_END))
     {
         nrf_saadc_event_clear(NRF_SAADC_EVENT_END);
@@ -196,6 +271,8 @@ void SAADC_IRQHandler(void)
             }
         }
     }
+
+    CPU_PROFILER_ISR_EXIT(CPU_PROFILER_ISR_SAADC);
 }
 
 
@@ -572,6 +649,167 @@ void nrf_drv_saadc_abort(void)
 }
 
 
+#if SAADC_CONFIG_STREAM_ENABLED
+static void stream_timer_handler(nrf_timer_event_t event_type, void * p_context)
+{
+    // The TIMER only triggers samples through PPI.
+    UNUSED_PARAMETER(event_type);
+    UNUSED_PARAMETER(p_context);
+}
+
+
+ret_code_t nrf_drv_saadc_stream_start(nrf_drv_saadc_stream_config_t const * p_config)
+{
+    ASSERT(m_cb.state != NRF_DRV_STATE_UNINITIALIZED);
+
+    ret_code_t             err_code;
+    nrf_drv_timer_config_t timer_config = NRF_DRV_TIMER_DEFAULT_CONFIG;
+
+    if ((p_config == NULL) || (p_config->p_timer == NULL) ||
+        (p_config->p_buffers[0] == NULL) || (p_config->p_buffers[1] == NULL) ||
+        (p_config->decimation == 0) || (p_config->buffer_size == 0))
+    {
+        err_code = NRF_ERROR_INVALID_PARAM;
+        NRF_LOG_WARNING("Function: %s, error code: %s.\r\n", (uint32_t)__func__, (uint32_t)ERR_TO_STR(err_code));
+        return err_code;
+    }
+    if (m_cb.low_power_mode || (m_cb.active_channels == 0))
+    {
+        err_code = NRF_ERROR_INVALID_STATE;
+        NRF_LOG_WARNING("Function: %s, error code: %s.\r\n", (uint32_t)__func__, (uint32_t)ERR_TO_STR(err_code));
+        return err_code;
+    }
+    if ((p_config->buffer_size % (m_cb.active_channels * p_config->decimation)) != 0)
+    {
+        err_code = NRF_ERROR_INVALID_PARAM;
+        NRF_LOG_WARNING("Function: %s, error code: %s.\r\n", (uint32_t)__func__, (uint32_t)ERR_TO_STR(err_code));
+        return err_code;
+    }
+    if (m_cb.adc_state != NRF_SAADC_STATE_IDLE)
+    {
+        err_code = NRF_ERROR_BUSY;
+        NRF_LOG_WARNING("Function: %s, error code: %s.\r\n", (uint32_t)__func__, (uint32_t)ERR_TO_STR(err_code));
+        return err_code;
+    }
+
+    err_code = nrf_drv_ppi_init();
+    if ((err_code != NRF_SUCCESS) && (err_code != NRF_ERROR_MODULE_ALREADY_INITIALIZED))
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+    if (nrf_drv_ppi_channel_alloc(&m_cb.stream_ppi[0]) != NRF_SUCCESS)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+    if (nrf_drv_ppi_channel_alloc(&m_cb.stream_ppi[1]) != NRF_SUCCESS)
+    {
+        (void)nrf_drv_ppi_channel_free(m_cb.stream_ppi[0]);
+        return NRF_ERROR_NO_MEM;
+    }
+
+    err_code = nrf_drv_timer_init(p_config->p_timer, &timer_config, stream_timer_handler);
+    if (err_code != NRF_SUCCESS)
+    {
+        (void)nrf_drv_ppi_channel_free(m_cb.stream_ppi[0]);
+        (void)nrf_drv_ppi_channel_free(m_cb.stream_ppi[1]);
+        return err_code;
+    }
+    nrf_drv_timer_extended_compare(p_config->p_timer,
+                                   NRF_TIMER_CC_CHANNEL0,
+                                   nrf_drv_timer_us_to_ticks(p_config->p_timer, p_config->period_us),
+                                   NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK,
+                                   false);
+
+    (void)nrf_drv_ppi_channel_assign(m_cb.stream_ppi[0],
+                                     nrf_drv_timer_compare_event_address_get(p_config->p_timer,
+                                                                             NRF_TIMER_CC_CHANNEL0),
+                                     nrf_saadc_task_address_get(NRF_SAADC_TASK_SAMPLE));
+    (void)nrf_drv_ppi_channel_assign(m_cb.stream_ppi[1],
+                                     nrf_saadc_event_address_get(NRF_SAADC_EVENT_END),
+                                     nrf_saadc_task_address_get(NRF_SAADC_TASK_START));
+
+    m_cb.stream        = *p_config;
+    m_cb.stream_active = 0;
+    m_cb.streaming     = true;
+    m_cb.adc_state     = NRF_SAADC_STATE_BUSY;
+
+    nrf_saadc_buffer_init(p_config->p_buffers[0], p_config->buffer_size);
+    nrf_saadc_event_clear(NRF_SAADC_EVENT_STARTED);
+    nrf_saadc_event_clear(NRF_SAADC_EVENT_END);
+    nrf_saadc_int_enable(NRF_SAADC_INT_STARTED | NRF_SAADC_INT_END);
+
+    (void)nrf_drv_ppi_channel_enable(m_cb.stream_ppi[0]);
+    (void)nrf_drv_ppi_channel_enable(m_cb.stream_ppi[1]);
+    nrf_saadc_task_trigger(NRF_SAADC_TASK_START);
+    nrf_drv_timer_enable(p_config->p_timer);
+
+    err_code = NRF_SUCCESS;
+    NRF_LOG_INFO("Function: %s, error code: %s.\r\n", (uint32_t)__func__, (uint32_t)ERR_TO_STR(err_code));
+    return err_code;
+}
+
+
+void nrf_drv_saadc_stream_period_set(uint32_t period_us)
+{
+    if (!m_cb.streaming)
+    {
+        return;
+    }
+
+    // The TIMER is restarted from zero, so that a shorter period does not let it pass the compare
+    // value.
+    nrf_drv_timer_pause(m_cb.stream.p_timer);
+    m_cb.stream.period_us = period_us;
+    nrf_drv_timer_clear(m_cb.stream.p_timer);
+    nrf_drv_timer_extended_compare(m_cb.stream.p_timer,
+                                   NRF_TIMER_CC_CHANNEL0,
+                                   nrf_drv_timer_us_to_ticks(m_cb.stream.p_timer, period_us),
+                                   NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK,
+                                   false);
+    nrf_drv_timer_resume(m_cb.stream.p_timer);
+    NRF_LOG_DEBUG("Streaming period: %d us.\r\n", period_us);
+}
+
+
+void nrf_drv_saadc_stream_stop(void)
+{
+    if (!m_cb.streaming)
+    {
+        return;
+    }
+
+    nrf_drv_timer_disable(m_cb.stream.p_timer);
+    (void)nrf_drv_ppi_channel_disable(m_cb.stream_ppi[0]);
+    (void)nrf_drv_ppi_channel_disable(m_cb.stream_ppi[1]);
+
+    // Stop without reporting the buffer that is not full.
+    nrf_saadc_int_disable(NRF_SAADC_INT_STARTED | NRF_SAADC_INT_END);
+    m_cb.streaming = false;
+    nrf_saadc_event_clear(NRF_SAADC_EVENT_STOPPED);
+    nrf_saadc_task_trigger(NRF_SAADC_TASK_STOP);
+
+    uint32_t timeout = HW_TIMEOUT;
+
+    while (nrf_saadc_event_check(NRF_SAADC_EVENT_STOPPED) == 0 && timeout > 0)
+    {
+        --timeout;
+    }
+    ASSERT(timeout > 0);
+
+    nrf_saadc_event_clear(NRF_SAADC_EVENT_STOPPED);
+    nrf_saadc_event_clear(NRF_SAADC_EVENT_STARTED);
+    nrf_saadc_event_clear(NRF_SAADC_EVENT_END);
+    nrf_saadc_int_enable(NRF_SAADC_INT_END);
+    m_cb.adc_state = NRF_SAADC_STATE_IDLE;
+
+    nrf_drv_timer_uninit(m_cb.stream.p_timer);
+    (void)nrf_drv_ppi_channel_free(m_cb.stream_ppi[0]);
+    (void)nrf_drv_ppi_channel_free(m_cb.stream_ppi[1]);
+    NRF_LOG_INFO("Streaming stopped.\r\n");
+}
+#endif // SAADC_CONFIG_STREAM_ENABLED
+
+
 void nrf_drv_saadc_limits_set(uint8_t channel, int16_t limit_low, int16_t limit_high)
 {
     ASSERT(m_cb.state != NRF_DRV_STATE_UNINITIALIZED);
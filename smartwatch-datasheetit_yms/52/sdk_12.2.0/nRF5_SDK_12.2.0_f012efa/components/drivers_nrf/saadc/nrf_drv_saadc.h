@@ -31,6 +31,9 @@
 #include "nrf_saadc.h"
 #include "sdk_errors.h"
 #include "nrf_drv_common.h"
+#if SAADC_CONFIG_STREAM_ENABLED
+#include "nrf_drv_timer.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -290,6 +293,62 @@ void nrf_drv_saadc_abort(void);
  */
 void nrf_drv_saadc_limits_set(uint8_t channel, int16_t limit_low, int16_t limit_high);
 
+#if SAADC_CONFIG_STREAM_ENABLED
+/**
+ * @brief Streaming mode configuration structure.
+ */
+typedef struct
+{
+    nrf_drv_timer_t const * p_timer;      ///< TIMER instance that triggers the samples. Must not be initialized.
+    uint32_t                period_us;    ///< Time between two samples of all enabled channels, in microseconds.
+    nrf_saadc_value_t     * p_buffers[2]; ///< Two sample buffers, which are filled in turn.
+    uint16_t                buffer_size;  ///< Size of each buffer in words. Must be a multiple of the number of enabled channels times @p decimation.
+    uint8_t                 decimation;   ///< Number of consecutive samples of each channel that are averaged into one result. 1 to disable.
+} nrf_drv_saadc_stream_config_t;
+
+/**
+ * @brief Function for starting continuous sampling into two buffers.
+ *
+ * The SAMPLE task is triggered by a TIMER through PPI, and the END event restarts the conversion
+ * through PPI, so no interrupt is needed for a sample or to change buffers. The next buffer is set
+ * up in the interrupt of the STARTED event, which SAADC generates when it has latched the current
+ * buffer. The application is notified with @ref NRF_DRV_SAADC_EVT_DONE every time a buffer is
+ * filled. If @p decimation is greater than 1, the results in the buffer are averaged before the
+ * event, and the event contains the number of averaged results at the start of the buffer.
+ *
+ * @note The buffer in the event is written again after the next buffer has been filled, so it
+ *       must be processed or copied within one buffer period.
+ * @note For one channel, the hardware oversampling with burst mode can be used instead of, or
+ *       together with, @p decimation.
+ *
+ * @param[in] p_config Streaming mode configuration.
+ *
+ * @retval NRF_SUCCESS             If sampling was started.
+ * @retval NRF_ERROR_INVALID_PARAM If the configuration was invalid.
+ * @retval NRF_ERROR_INVALID_STATE If the driver is in low power mode, or no channel is enabled.
+ * @retval NRF_ERROR_BUSY          If the ADC driver is busy.
+ * @retval NRF_ERROR_NO_MEM        If no PPI channels were available.
+ * @return Any error returned by the TIMER driver.
+ */
+ret_code_t nrf_drv_saadc_stream_start(nrf_drv_saadc_stream_config_t const * p_config);
+
+/**
+ * @brief Function for changing the sample period while streaming, without stopping the SAADC.
+ *
+ * The next sample is taken one new period after the call. Has no effect if streaming is not active.
+ *
+ * @param[in] period_us Time between two samples of all enabled channels, in microseconds.
+ */
+void nrf_drv_saadc_stream_period_set(uint32_t period_us);
+
+/**
+ * @brief Function for stopping continuous sampling and releasing the TIMER and the PPI channels.
+ *
+ * The samples of a buffer that is not full are discarded.
+ */
+void nrf_drv_saadc_stream_stop(void);
+#endif // SAADC_CONFIG_STREAM_ENABLED
+
 #ifdef __cplusplus
 }
 #endif
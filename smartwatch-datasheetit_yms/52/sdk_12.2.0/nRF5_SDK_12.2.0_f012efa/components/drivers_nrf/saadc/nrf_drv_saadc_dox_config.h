@@ -52,6 +52,18 @@
 #define SAADC_CONFIG_LP_MODE
 
 
+/** @brief Enabling streaming mode
+ *
+ *  Streaming mode uses a TIMER and two PPI channels to sample into two
+ *  buffers without CPU involvement. See @ref nrf_drv_saadc_stream_start.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define SAADC_CONFIG_STREAM_ENABLED
+
+
 /** @brief Interrupt priority
  *
  * Priorities 0,2 (nRF51) and 0,1,4,5 (nRF52) are reserved for SoftDevice
@@ -71,6 +83,15 @@
 #define SAADC_CONFIG_IRQ_PRIORITY
 
 
+/** @brief Run the interrupt handler from RAM
+ *
+ *  Set to 1 to activate. The handler then has no flash wait states, see @ref __RAMFUNC.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define SAADC_CONFIG_IRQ_RAMFUNC
+
+
 /** @brief Enables logging in the module.
  *
  *  Set to 1 to activate.
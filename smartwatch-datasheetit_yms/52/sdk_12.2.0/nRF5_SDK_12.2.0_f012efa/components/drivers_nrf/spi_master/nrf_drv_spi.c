@@ -20,6 +20,7 @@
 #include "nrf_gpio.h"
 #include "nrf_assert.h"
 #include "app_util_platform.h"
+#include "cpu_profiler_hooks.h"
 
 #define NRF_LOG_MODULE_NAME "SPI"
 
@@ -103,6 +104,15 @@ typedef struct
 
     bool tx_done : 1;
     bool rx_done : 1;
+
+#ifdef SPIM_IN_USE
+    // Transfer list in progress, see 'nrf_drv_spi_xfer_list'.
+    nrf_drv_spi_list_entry_t const * p_list;
+    uint16_t        list_count;
+    uint16_t        list_idx;
+    uint16_t        repeats_left;
+    uint8_t         list_ss_pin; // Slave select pin that is active.
+#endif
 } spi_control_block_t;
 static spi_control_block_t m_cb[ENABLED_SPI_COUNT];
 
@@ -287,9 +297,11 @@ void nrf_drv_spi_uninit(nrf_drv_spi_t const * const p_instance)
             if (p_cb->transfer_in_progress)
             {
                 // Ensure that SPI is not performing any transfer.
+                nrf_spim_shorts_disable(p_spim, NRF_SPIM_SHORT_END_START_MASK);
                 nrf_spim_task_trigger(p_spim, NRF_SPIM_TASK_STOP);
                 while (!nrf_spim_event_check(p_spim, NRF_SPIM_EVENT_STOPPED)) {}
                 p_cb->transfer_in_progress = false;
+                p_cb->p_list = NULL;
             }
         }
         nrf_spim_disable(p_spim);
@@ -521,8 +533,161 @@ static ret_code_t spim_xfer(NRF_SPIM_Type                * p_spim,
     NRF_LOG_INFO("Function: %s, error code: %s.\r\n", (uint32_t)__func__, (uint32_t)ERR_TO_STR(err_code));
     return err_code;
 }
+
+static void spim_list_ss_set(spi_control_block_t * p_cb, uint8_t ss_pin)
+{
+    if (p_cb->list_ss_pin == ss_pin)
+    {
+        return;
+    }
+    if (p_cb->list_ss_pin != NRF_DRV_SPI_PIN_NOT_USED)
+    {
+        nrf_gpio_pin_set(p_cb->list_ss_pin);
+    }
+    if (ss_pin != NRF_DRV_SPI_PIN_NOT_USED)
+    {
+        nrf_gpio_pin_clear(ss_pin);
+    }
+    p_cb->list_ss_pin = ss_pin;
+}
+
+// Starts the current entry of the transfer list. Repetitions of the entry are
+// started by the END_START shortcut, without waiting for the interrupt.
+static void spim_list_entry_start(NRF_SPIM_Type * p_spim, spi_control_block_t * p_cb)
+{
+    nrf_drv_spi_list_entry_t const * p_entry = &p_cb->p_list[p_cb->list_idx];
+    uint32_t flags = 0;
+
+    spim_list_ss_set(p_cb, (p_entry->ss_pin != NRF_DRV_SPI_PIN_NOT_USED) ?
+                            p_entry->ss_pin : p_cb->ss_pin);
+
+    if (p_entry->repeat > 1)
+    {
+        flags |= (p_entry->xfer.tx_length > 0) ? NRF_DRV_SPI_FLAG_TX_POSTINC : 0;
+        flags |= (p_entry->xfer.rx_length > 0) ? NRF_DRV_SPI_FLAG_RX_POSTINC : 0;
+        nrf_spim_shorts_enable(p_spim, NRF_SPIM_SHORT_END_START_MASK);
+    }
+    else
+    {
+        nrf_spim_shorts_disable(p_spim, NRF_SPIM_SHORT_END_START_MASK);
+    }
+    p_cb->repeats_left = p_entry->repeat;
+
+    nrf_spim_tx_buffer_set(p_spim, p_entry->xfer.p_tx_buffer, p_entry->xfer.tx_length);
+    nrf_spim_rx_buffer_set(p_spim, p_entry->xfer.p_rx_buffer, p_entry->xfer.rx_length);
+    nrf_spim_event_clear(p_spim, NRF_SPIM_EVENT_END);
+    spim_list_enable_handle(p_spim, flags);
+    nrf_spim_task_trigger(p_spim, NRF_SPIM_TASK_START);
+}
+
+// Handles the END event of a transfer of the list. Returns true when the whole
+// list is done.
+static bool spim_list_end_handle(NRF_SPIM_Type * p_spim, spi_control_block_t * p_cb)
+{
+    nrf_drv_spi_list_entry_t const * p_entry = &p_cb->p_list[p_cb->list_idx];
+
+    --p_cb->repeats_left;
+    if (p_cb->repeats_left == 1)
+    {
+        // The last repetition has already been started by the shortcut.
+        nrf_spim_shorts_disable(p_spim, NRF_SPIM_SHORT_END_START_MASK);
+        return false;
+    }
+    if (p_cb->repeats_left > 0)
+    {
+        return false;
+    }
+
+    if (!(p_entry->flags & NRF_DRV_SPI_LIST_FLAG_SS_HOLD))
+    {
+        spim_list_ss_set(p_cb, NRF_DRV_SPI_PIN_NOT_USED);
+    }
+
+    if (++p_cb->list_idx < p_cb->list_count)
+    {
+        spim_list_entry_start(p_spim, p_cb);
+        return false;
+    }
+
+    spim_list_ss_set(p_cb, NRF_DRV_SPI_PIN_NOT_USED);
+    p_cb->evt.data.done = p_entry->xfer;
+    p_cb->p_list = NULL;
+    return true;
+}
 #endif
 
+ret_code_t nrf_drv_spi_xfer_list(nrf_drv_spi_t            const * const p_instance,
+                                 nrf_drv_spi_list_entry_t const *       p_list,
+                                 uint16_t                               count)
+{
+    spi_control_block_t * p_cb  = &m_cb[p_instance->drv_inst_idx];
+    ASSERT(p_cb->state != NRF_DRV_STATE_UNINITIALIZED);
+
+    ret_code_t err_code = NRF_ERROR_NOT_SUPPORTED;
+
+    CODE_FOR_SPIM
+    (
+        if (p_cb->handler == NULL)
+        {
+            NRF_LOG_WARNING("Function: %s, error code: %s.\r\n", (uint32_t)__func__, (uint32_t)ERR_TO_STR(err_code));
+            return err_code;
+        }
+        if (p_list == NULL || count == 0)
+        {
+            err_code = NRF_ERROR_INVALID_PARAM;
+            NRF_LOG_WARNING("Function: %s, error code: %s.\r\n", (uint32_t)__func__, (uint32_t)ERR_TO_STR(err_code));
+            return err_code;
+        }
+        for (uint32_t i = 0; i < count; i++)
+        {
+            ASSERT(p_list[i].xfer.p_tx_buffer != NULL || p_list[i].xfer.tx_length == 0);
+            ASSERT(p_list[i].xfer.p_rx_buffer != NULL || p_list[i].xfer.rx_length == 0);
+            if (p_list[i].repeat == 0)
+            {
+                err_code = NRF_ERROR_INVALID_PARAM;
+                NRF_LOG_WARNING("Function: %s, error code: %s.\r\n", (uint32_t)__func__, (uint32_t)ERR_TO_STR(err_code));
+                return err_code;
+            }
+            if ((p_list[i].xfer.p_tx_buffer != NULL && !nrf_drv_is_in_RAM(p_list[i].xfer.p_tx_buffer)) ||
+                (p_list[i].xfer.p_rx_buffer != NULL && !nrf_drv_is_in_RAM(p_list[i].xfer.p_rx_buffer)))
+            {
+                err_code = NRF_ERROR_INVALID_ADDR;
+                NRF_LOG_WARNING("Function: %s, error code: %s.\r\n", (uint32_t)__func__, (uint32_t)ERR_TO_STR(err_code));
+                return err_code;
+            }
+        }
+
+        bool busy;
+        CRITICAL_REGION_ENTER();
+        busy = p_cb->transfer_in_progress;
+        p_cb->transfer_in_progress = true;
+        CRITICAL_REGION_EXIT();
+        if (busy)
+        {
+            err_code = NRF_ERROR_BUSY;
+            NRF_LOG_WARNING("Function: %s, error code: %s.\r\n", (uint32_t)__func__, (uint32_t)ERR_TO_STR(err_code));
+            return err_code;
+        }
+
+        p_cb->p_list      = p_list;
+        p_cb->list_count  = count;
+        p_cb->list_idx    = 0;
+        p_cb->list_ss_pin = NRF_DRV_SPI_PIN_NOT_USED;
+
+        NRF_SPIM_Type * p_spim = p_instance->p_registers;
+        spim_list_entry_start(p_spim, p_cb);
+        spim_int_enable(p_spim, true);
+        err_code = NRF_SUCCESS;
+    )
+    CODE_FOR_SPI
+    (
+        UNUSED_PARAMETER(p_list);
+        UNUSED_PARAMETER(count);
+    )
+    NRF_LOG_INFO("Function: %s, error code: %s.\r\n", (uint32_t)__func__, (uint32_t)ERR_TO_STR(err_code));
+    return err_code;
+}
+
 ret_code_t nrf_drv_spi_xfer(nrf_drv_spi_t     const * const p_instance,
                             nrf_drv_spi_xfer_desc_t const * p_xfer_desc,
                             uint32_t                        flags)
@@ -584,6 +749,10 @@ static void irq_handler_spim(NRF_SPIM_Type * p_spim, spi_control_block_t * p_cb)
     {
         nrf_spim_event_clear(p_spim, NRF_SPIM_EVENT_END);
         NRF_LOG_DEBUG("SPIM: Event: NRF_SPIM_EVENT_END.\r\n");
+        if (p_cb->p_list != NULL && !spim_list_end_handle(p_spim, p_cb))
+        {
+            return;
+        }
         finish_transfer(p_cb);
     }
 }
@@ -619,36 +788,42 @@ static void irq_handler_spi(NRF_SPI_Type * p_spi, spi_control_block_t * p_cb)
 #if NRF_MODULE_ENABLED(SPI0)
 IRQ_HANDLER(0)
 {
+    CPU_PROFILER_ISR_ENTER(CPU_PROFILER_ISR_SPI0);
     spi_control_block_t * p_cb  = &m_cb[SPI0_INSTANCE_INDEX];
     #if SPI0_USE_EASY_DMA
         irq_handler_spim(NRF_SPIM0, p_cb);
     #else
         irq_handler_spi(NRF_SPI0, p_cb);
     #endif
+    CPU_PROFILER_ISR_EXIT(CPU_PROFILER_ISR_SPI0);
 }
 #endif // NRF_MODULE_ENABLED(SPI0)
 
 #if NRF_MODULE_ENABLED(SPI1)
 IRQ_HANDLER(1)
 {
+    CPU_PROFILER_ISR_ENTER(CPU_PROFILER_ISR_SPI1);
     spi_control_block_t * p_cb  = &m_cb[SPI1_INSTANCE_INDEX];
     #if SPI1_USE_EASY_DMA
         irq_handler_spim(NRF_SPIM1, p_cb);
     #else
         irq_handler_spi(NRF_SPI1, p_cb);
     #endif
+    CPU_PROFILER_ISR_EXIT(CPU_PROFILER_ISR_SPI1);
 }
 #endif // NRF_MODULE_ENABLED(SPI1)
 
 #if NRF_MODULE_ENABLED(SPI2)
 IRQ_HANDLER(2)
 {
+    CPU_PROFILER_ISR_ENTER(CPU_PROFILER_ISR_SPI2);
     spi_control_block_t * p_cb  = &m_cb[SPI2_INSTANCE_INDEX];
     #if SPI2_USE_EASY_DMA
         irq_handler_spim(NRF_SPIM2, p_cb);
     #else
         irq_handler_spi(NRF_SPI2, p_cb);
     #endif
+    CPU_PROFILER_ISR_EXIT(CPU_PROFILER_ISR_SPI2);
 }
 #endif // NRF_MODULE_ENABLED(SPI2)
 #endif // ENABLED_SPI_COUNT
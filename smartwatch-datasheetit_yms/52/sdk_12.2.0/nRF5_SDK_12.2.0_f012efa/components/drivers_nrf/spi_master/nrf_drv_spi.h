@@ -216,6 +216,24 @@ typedef struct
 #define NRF_DRV_SPI_XFER_RX(p_buf, length) \
         NRF_DRV_SPI_SINGLE_XFER(NULL, 0, p_buf, length)
 
+#define NRF_DRV_SPI_LIST_FLAG_SS_HOLD        (1UL << 0) /**< Slave select stays active after the list entry, so the next entry continues the same command. */
+
+/**
+ * @brief Transfer list entry structure.
+ *
+ * An entry with @p repeat greater than 1 runs that many transfers back to back, started by the
+ * END_START shortcut of SPIM. Each buffer with a non-zero length is then used as an ArrayList,
+ * so the buffer is advanced by its length after every transfer. This allows, for example, a full
+ * display frame to be sent as one entry of rows, each shorter than the EasyDMA limit.
+ */
+typedef struct
+{
+    nrf_drv_spi_xfer_desc_t xfer;   ///< Buffers of a single transfer of the entry.
+    uint16_t                repeat; ///< Number of transfers of the entry. Must be at least 1.
+    uint8_t                 ss_pin; ///< Slave select pin of the entry, or @ref NRF_DRV_SPI_PIN_NOT_USED to use the pin of the instance.
+    uint8_t                 flags;  ///< Entry options (see @ref NRF_DRV_SPI_LIST_FLAG_SS_HOLD).
+} nrf_drv_spi_list_entry_t;
+
 /**
  * @brief SPI master driver event types, passed to the handler routine provided
  *        during initialization.
@@ -347,6 +365,36 @@ ret_code_t nrf_drv_spi_xfer(nrf_drv_spi_t     const * const p_instance,
                             nrf_drv_spi_xfer_desc_t const * p_xfer_desc,
                             uint32_t                        flags);
 
+/**
+ * @brief Function for starting a list of SPI transfers.
+ *
+ * The entries of the list are performed in order, and each entry is started from the interrupt
+ * that ends the previous one, so the user event handler is called only once, with
+ * @ref NRF_DRV_SPI_EVENT_DONE, when the whole list is done. The event data describes the last
+ * entry. Slave select is activated for every entry and deactivated after it, unless the entry has
+ * the @ref NRF_DRV_SPI_LIST_FLAG_SS_HOLD flag. Different entries can use different slave select
+ * pins, so that commands for several devices on the same bus can be put in one list.
+ *
+ * @note Supported only by SPIM in non-blocking mode. The list and its buffers must stay valid
+ *       until the transfer is done, and the buffers must be placed in the Data RAM region.
+ * @note For entries with @p repeat greater than 1, the interrupt of the instance must be handled
+ *       within the duration of one transfer of the entry, so that the repetitions are stopped
+ *       at the right count.
+ *
+ * @param p_instance Pointer to the driver instance structure.
+ * @param p_list     Pointer to the first entry of the list.
+ * @param count      Number of entries in the list.
+ *
+ * @retval NRF_SUCCESS             If the transfer list was started.
+ * @retval NRF_ERROR_BUSY          If the driver is not ready for a new transfer.
+ * @retval NRF_ERROR_INVALID_PARAM If the list is empty, or an entry has a repeat count of 0.
+ * @retval NRF_ERROR_NOT_SUPPORTED If the instance is not SPIM, or is in blocking mode.
+ * @retval NRF_ERROR_INVALID_ADDR  If buffers are not placed in the Data RAM region.
+ */
+ret_code_t nrf_drv_spi_xfer_list(nrf_drv_spi_t            const * const p_instance,
+                                 nrf_drv_spi_list_entry_t const *       p_list,
+                                 uint16_t                               count);
+
 /**
  * @brief Function for returning the address of a SPIM start task.
  *
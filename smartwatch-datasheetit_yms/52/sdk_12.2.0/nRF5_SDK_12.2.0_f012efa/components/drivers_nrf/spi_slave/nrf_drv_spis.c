@@ -96,6 +96,12 @@ typedef struct
     volatile uint8_t *            rx_buffer;       //!< SPI slave RX buffer.
     nrf_drv_state_t               state;           //!< driver initialization state.
     volatile nrf_drv_spis_state_t spi_state;       //!< SPI slave state.
+#if SPIS_CONFIG_QUEUE_SIZE
+    nrf_drv_spis_buffers_t        queue[SPIS_CONFIG_QUEUE_SIZE]; //!< Buffers of the following transactions.
+    uint8_t                       queue_head;      //!< Index of the first queued buffers.
+    volatile uint8_t              queue_count;     //!< Number of queued buffers.
+    volatile bool                 queued;          //!< Buffers are armed by the driver.
+#endif
 } spis_cb_t;
 
 static spis_cb_t m_cb[ENABLED_SPIS_COUNT];
@@ -209,6 +215,11 @@ ret_code_t nrf_drv_spis_init(nrf_drv_spis_t const * const  p_instance,
 
     m_cb[p_instance->instance_id].spi_state = SPIS_STATE_INIT;
     m_cb[p_instance->instance_id].handler = event_handler;
+#if SPIS_CONFIG_QUEUE_SIZE
+    p_cb->queue_head  = 0;
+    p_cb->queue_count = 0;
+    p_cb->queued      = false;
+#endif
 
 
     // Enable IRQ.
@@ -261,9 +272,11 @@ static void spis_state_entry_action_execute(NRF_SPIS_Type * p_spis,
             break;
 
         case SPIS_BUFFER_RESOURCE_CONFIGURED:
-            event.evt_type  = NRF_DRV_SPIS_BUFFERS_SET_DONE;
-            event.rx_amount = 0;
-            event.tx_amount = 0;
+            event.evt_type    = NRF_DRV_SPIS_BUFFERS_SET_DONE;
+            event.rx_amount   = 0;
+            event.tx_amount   = 0;
+            event.p_tx_buffer = NULL;
+            event.p_rx_buffer = NULL;
 
             APP_ERROR_CHECK_BOOL(p_cb->handler != NULL);
             p_cb->handler(event);
@@ -272,7 +285,9 @@ static void spis_state_entry_action_execute(NRF_SPIS_Type * p_spis,
         case SPIS_XFER_COMPLETED:
             event.evt_type  = NRF_DRV_SPIS_XFER_DONE;
             event.rx_amount = nrf_spis_rx_amount_get(p_spis);
-            event.tx_amount = nrf_spis_tx_amount_get(p_spis);            
+            event.tx_amount = nrf_spis_tx_amount_get(p_spis);
+            event.p_tx_buffer = (const uint8_t *)p_cb->tx_buffer;
+            event.p_rx_buffer = (uint8_t *)p_cb->rx_buffer;
             NRF_LOG_INFO("Transfer rx_len:%d.\r\n", event.rx_amount);
             NRF_LOG_DEBUG("Rx data:\r\n");
             NRF_LOG_HEXDUMP_DEBUG((uint8_t *)p_cb->rx_buffer, event.rx_amount * sizeof(p_cb->rx_buffer));
@@ -351,8 +366,141 @@ ret_code_t nrf_drv_spis_buffers_set(nrf_drv_spis_t const * const  p_instance,
     return err_code;
 }
 
+#if SPIS_CONFIG_QUEUE_SIZE
+/**@brief Function for taking the next queued buffers as the buffers of the instance. When the
+ *        queue is empty, the buffers of the last transaction are kept.
+ */
+static void spis_queue_pop(spis_cb_t * p_cb)
+{
+    if (p_cb->queue_count != 0)
+    {
+        nrf_drv_spis_buffers_t const * p_buffers = &p_cb->queue[p_cb->queue_head];
+
+        p_cb->tx_buffer      = p_buffers->p_tx_buffer;
+        p_cb->rx_buffer      = p_buffers->p_rx_buffer;
+        p_cb->tx_buffer_size = p_buffers->tx_length;
+        p_cb->rx_buffer_size = p_buffers->rx_length;
+
+        p_cb->queue_head = (p_cb->queue_head + 1) % SPIS_CONFIG_QUEUE_SIZE;
+        p_cb->queue_count--;
+    }
+}
+
+
+ret_code_t nrf_drv_spis_buffers_queue(nrf_drv_spis_t const * const  p_instance,
+                                      nrf_drv_spis_buffers_t const * p_buffers)
+{
+    spis_cb_t * p_cb = &m_cb[p_instance->instance_id];
+    ret_code_t  err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_buffers);
+    VERIFY_PARAM_NOT_NULL(p_buffers->p_tx_buffer);
+    VERIFY_PARAM_NOT_NULL(p_buffers->p_rx_buffer);
+
+    if (!nrf_drv_is_in_RAM(p_buffers->p_tx_buffer) || !nrf_drv_is_in_RAM(p_buffers->p_rx_buffer))
+    {
+        err_code = NRF_ERROR_INVALID_ADDR;
+        NRF_LOG_WARNING("Function: %s, error code: %s.\r\n", (uint32_t)__func__, (uint32_t)ERR_TO_STR(err_code));
+        return err_code;
+    }
+    if (p_cb->state == NRF_DRV_STATE_UNINITIALIZED)
+    {
+        err_code = NRF_ERROR_INVALID_STATE;
+        NRF_LOG_WARNING("Function: %s, error code: %s.\r\n", (uint32_t)__func__, (uint32_t)ERR_TO_STR(err_code));
+        return err_code;
+    }
+
+    // The queue is also emptied from the interrupt.
+    CRITICAL_REGION_ENTER();
+    if (p_cb->queue_count == SPIS_CONFIG_QUEUE_SIZE)
+    {
+        err_code = NRF_ERROR_NO_MEM;
+    }
+    else
+    {
+        p_cb->queue[(p_cb->queue_head + p_cb->queue_count) % SPIS_CONFIG_QUEUE_SIZE] = *p_buffers;
+        p_cb->queue_count++;
+        err_code = NRF_SUCCESS;
+
+        if (!p_cb->queued)
+        {
+            p_cb->queued = true;
+            // Buffers already armed, or being armed, are used first. Otherwise the semaphore is
+            // held by the CPU until buffers are armed.
+            if ((p_cb->spi_state == SPIS_STATE_INIT) || (p_cb->spi_state == SPIS_XFER_COMPLETED))
+            {
+                spis_queue_pop(p_cb);
+                p_cb->spi_state = SPIS_BUFFER_RESOURCE_REQUESTED;
+                nrf_spis_task_trigger(p_instance->p_reg, NRF_SPIS_TASK_ACQUIRE);
+            }
+        }
+    }
+    CRITICAL_REGION_EXIT();
+
+    NRF_LOG_INFO("Function: %s, error code: %s.\r\n", (uint32_t)__func__, (uint32_t)ERR_TO_STR(err_code));
+    return err_code;
+}
+
+
+/**@brief Interrupt handler of an instance in queued mode. */
+static void spis_queued_irq_handler(NRF_SPIS_Type * p_spis, spis_cb_t * p_cb)
+{
+    nrf_drv_spis_event_t event;
+    bool                 xfer_done = false;
+
+    // @note: the END event is processed first, as its END_ACQUIRE shortcut may already have given
+    // the semaphore back. The buffers of the next transaction are armed before the application is
+    // notified, to keep the time the master is not answered short.
+    if (nrf_spis_event_check(p_spis, NRF_SPIS_EVENT_END))
+    {
+        nrf_spis_event_clear(p_spis, NRF_SPIS_EVENT_END);
+
+        if (p_cb->spi_state == SPIS_BUFFER_RESOURCE_CONFIGURED)
+        {
+            event.evt_type    = NRF_DRV_SPIS_XFER_DONE;
+            event.rx_amount   = nrf_spis_rx_amount_get(p_spis);
+            event.tx_amount   = nrf_spis_tx_amount_get(p_spis);
+            event.p_tx_buffer = (const uint8_t *)p_cb->tx_buffer;
+            event.p_rx_buffer = (uint8_t *)p_cb->rx_buffer;
+            xfer_done         = true;
+
+            spis_queue_pop(p_cb);
+            p_cb->spi_state = SPIS_BUFFER_RESOURCE_REQUESTED;
+        }
+    }
+
+    if (nrf_spis_event_check(p_spis, NRF_SPIS_EVENT_ACQUIRED))
+    {
+        nrf_spis_event_clear(p_spis, NRF_SPIS_EVENT_ACQUIRED);
+
+        if (p_cb->spi_state == SPIS_BUFFER_RESOURCE_REQUESTED)
+        {
+            nrf_spis_tx_buffer_set(p_spis, (uint8_t *)p_cb->tx_buffer, p_cb->tx_buffer_size);
+            nrf_spis_rx_buffer_set(p_spis, (uint8_t *)p_cb->rx_buffer, p_cb->rx_buffer_size);
+
+            nrf_spis_task_trigger(p_spis, NRF_SPIS_TASK_RELEASE);
+            p_cb->spi_state = SPIS_BUFFER_RESOURCE_CONFIGURED;
+        }
+    }
+
+    if (xfer_done)
+    {
+        NRF_LOG_INFO("Transfer rx_len:%d.\r\n", event.rx_amount);
+        p_cb->handler(event);
+    }
+}
+#endif // SPIS_CONFIG_QUEUE_SIZE
+
 static void spis_irq_handler(NRF_SPIS_Type * p_spis, spis_cb_t * p_cb)
 {
+#if SPIS_CONFIG_QUEUE_SIZE
+    if (p_cb->queued)
+    {
+        spis_queued_irq_handler(p_spis, p_cb);
+        return;
+    }
+#endif
+
     // @note: as multiple events can be pending for processing, the correct event processing order
     // is as follows:
     // - SPI semaphore acquired event.
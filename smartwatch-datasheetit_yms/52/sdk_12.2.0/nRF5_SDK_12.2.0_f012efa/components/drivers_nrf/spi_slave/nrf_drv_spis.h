@@ -30,6 +30,15 @@
 #include "app_util_platform.h"
 #include "nrf_peripherals.h"
 
+/** @brief Number of buffer pairs that can be queued with @ref nrf_drv_spis_buffers_queue, per
+ *         instance. 0 to leave the queue out.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef SPIS_CONFIG_QUEUE_SIZE
+#define SPIS_CONFIG_QUEUE_SIZE 4
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -92,8 +101,19 @@ typedef struct
     nrf_drv_spis_event_type_t evt_type;     //!< Type of event.
     uint32_t                  rx_amount;    //!< Number of bytes received in last transaction. This parameter is only valid for @ref NRF_DRV_SPIS_XFER_DONE events.
     uint32_t                  tx_amount;    //!< Number of bytes transmitted in last transaction. This parameter is only valid for @ref NRF_DRV_SPIS_XFER_DONE events.
+    const uint8_t *           p_tx_buffer;  //!< TX buffer of the last transaction. This parameter is only valid for @ref NRF_DRV_SPIS_XFER_DONE events.
+    uint8_t *                 p_rx_buffer;  //!< RX buffer of the last transaction. This parameter is only valid for @ref NRF_DRV_SPIS_XFER_DONE events.
 } nrf_drv_spis_event_t;
 
+/** @brief Buffers of one SPI transaction. */
+typedef struct
+{
+    const uint8_t * p_tx_buffer;    //!< TX buffer.
+    uint8_t *       p_rx_buffer;    //!< RX buffer.
+    uint8_t         tx_length;      //!< Length of the TX buffer in bytes.
+    uint8_t         rx_length;      //!< Length of the RX buffer in bytes.
+} nrf_drv_spis_buffers_t;
+
 /** @brief SPI slave driver instance data structure. */
 typedef struct
 {
@@ -220,6 +240,41 @@ ret_code_t nrf_drv_spis_buffers_set(nrf_drv_spis_t const * const  p_instance,
                                     uint8_t * p_rx_buffer,
                                     uint8_t   rx_buffer_length);
 
+#if SPIS_CONFIG_QUEUE_SIZE || defined(__SDK_DOXYGEN__)
+/** @brief Function for queuing buffers for a following SPI transaction.
+ *
+ * The first call switches the SPI slave instance to queued mode, in which the driver arms the
+ * buffers of the next transaction itself, from the interrupt of the END event, without waiting
+ * for the application. The semaphore is requested by the END_ACQUIRE shortcut and is released as
+ * soon as it is acquired. When the queue is empty, the buffers of the last transaction are armed
+ * again, so that the master is always answered:
+ * - For a register window, queue one buffer pair once, and update the TX buffer in place.
+ * - For a burst-read FIFO, queue the following TX buffers ahead of the master, and reuse each of
+ *   them after its @ref NRF_DRV_SPIS_XFER_DONE event, which gives the buffers of the transaction.
+ *
+ * In queued mode, @ref NRF_DRV_SPIS_BUFFERS_SET_DONE events are not generated, and
+ * @ref nrf_drv_spis_buffers_set must not be called.
+ *
+ * @note A transaction that the master starts within the interrupt latency after the end of the
+ *       previous one is still answered with the DEF character, as the semaphore is then held by
+ *       the CPU.
+ *
+ * @note This function can be called from the callback function context.
+ *
+ * @param[in] p_instance Pointer to the driver instance structure.
+ * @param[in] p_buffers  Buffers of the transaction. They must be placed in the Data RAM region and
+ *                       stay valid until they are replaced by other buffers.
+ *
+ * @retval NRF_SUCCESS             If the buffers were queued.
+ * @retval NRF_ERROR_NULL          If a NULL pointer was supplied.
+ * @retval NRF_ERROR_INVALID_ADDR  If the provided buffers are not placed in the Data RAM region.
+ * @retval NRF_ERROR_INVALID_STATE If the driver instance is not initialized.
+ * @retval NRF_ERROR_NO_MEM        If the queue is full.
+ */
+ret_code_t nrf_drv_spis_buffers_queue(nrf_drv_spis_t const * const  p_instance,
+                                      nrf_drv_spis_buffers_t const * p_buffers);
+#endif // SPIS_CONFIG_QUEUE_SIZE
+
 
 #ifdef __cplusplus
 }
@@ -30,6 +30,12 @@
  */
 #define SPIS_DEFAULT_CONFIG_IRQ_PRIORITY
 
+/** @brief Number of buffer pairs that can be queued per instance, 0 to leave the queue out
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define SPIS_CONFIG_QUEUE_SIZE
+
 
 /** @brief Mode
  *
@@ -16,6 +16,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include "nrf_drv_swi.h"
 #include "app_util_platform.h"
 
@@ -124,6 +125,21 @@ static nrf_swi_handler_t m_swi_handlers[SWI_ARRAY_SIZE];
 static nrf_swi_flags_t   m_swi_flags[SWI_ARRAY_SIZE];
 #endif
 
+/**@brief Handler of a channel of a shared SWI. */
+typedef struct
+{
+    nrf_drv_swi_channel_handler_t handler;
+    void                        * p_context;
+} swi_channel_cb_t;
+
+static swi_channel_cb_t m_channel_cbs[SWI_CONFIG_CHANNEL_COUNT];
+
+/**@brief Index plus one of the handler of each channel in @ref m_channel_cbs, 0 if free. */
+static uint8_t          m_channel_map[SWI_ARRAY_SIZE][SWI_CHANNELS_PER_SWI];
+static uint8_t          m_swi_priorities[SWI_ARRAY_SIZE];
+
+STATIC_ASSERT(SWI_CONFIG_CHANNEL_COUNT < 0xFF);
+
 /**@brief Function for getting max channel number of given SWI.
  *
  * @param[in]  swi                 SWI number.
@@ -201,7 +217,9 @@ static void nrf_drv_swi_process(nrf_swi_t swi)
 static void nrf_drv_swi_process(nrf_swi_t swi, nrf_swi_flags_t flags)
 {
     ASSERT(m_swi_handlers[swi - SWI_START_NUMBER]);
+    CRITICAL_REGION_ENTER();
     m_swi_flags[swi - SWI_START_NUMBER] &= ~flags;
+    CRITICAL_REGION_EXIT();
     m_swi_handlers[swi - SWI_START_NUMBER](swi, flags);
 }
 
@@ -305,6 +323,8 @@ void nrf_drv_swi_uninit(void)
         nrf_egu_int_disable(NRF_EGUx, NRF_EGU_INT_ALL);
 #endif
     }
+    memset(m_channel_cbs, 0, sizeof(m_channel_cbs));
+    memset(m_channel_map, 0, sizeof(m_channel_map));
     m_drv_state = NRF_DRV_STATE_UNINITIALIZED;
     return;
 }
@@ -358,12 +378,159 @@ void nrf_drv_swi_trigger(nrf_swi_t swi, uint8_t flag_number)
     NRF_EGU_Type * NRF_EGUx = egu_instance_get(swi);
     nrf_egu_task_trigger(NRF_EGUx, nrf_egu_task_trigger_get(NRF_EGUx, flag_number));
 #else
+    CRITICAL_REGION_ENTER();
     m_swi_flags[swi - SWI_START_NUMBER] |= (1 << flag_number);
+    CRITICAL_REGION_EXIT();
     NVIC_SetPendingIRQ(nrf_drv_swi_irq_of(swi));
 #endif
 }
 
 
+/**@brief Handler of the shared SWIs, calling the handlers of the triggered channels. */
+static void swi_channel_dispatch(nrf_swi_t swi, nrf_swi_flags_t flags)
+{
+    uint8_t const * p_map = m_channel_map[swi - SWI_START_NUMBER];
+
+    for (uint32_t i = 0; flags != 0; i++, flags >>= 1)
+    {
+        if ((flags & 1) && (p_map[i] != 0))
+        {
+            swi_channel_cb_t const * p_cb = &m_channel_cbs[p_map[i] - 1];
+            p_cb->handler(p_cb->p_context);
+        }
+    }
+}
+
+
+/**@brief Function for taking a free channel of a shared SWI. Called in a critical region.
+ *
+ * @retval true  If a channel was free.
+ * @retval false If all channels of the SWI are in use.
+ */
+static bool swi_channel_take(nrf_swi_t swi, uint32_t cb_idx, nrf_drv_swi_channel_t * p_channel)
+{
+    uint8_t * p_map    = m_channel_map[swi - SWI_START_NUMBER];
+    uint32_t  channels = MIN(swi_channel_number(swi), SWI_CHANNELS_PER_SWI);
+
+    for (uint32_t i = 0; i < channels; i++)
+    {
+        if (p_map[i] == 0)
+        {
+            p_map[i]           = (uint8_t)(cb_idx + 1);
+            p_channel->swi     = swi;
+            p_channel->channel = (uint8_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**@brief Function for finding a shared SWI of a priority with a free channel and taking it.
+ *        Called in a critical region.
+ */
+static bool swi_channel_find(uint32_t priority, uint32_t cb_idx, nrf_drv_swi_channel_t * p_channel)
+{
+    for (uint32_t i = SWI_START_NUMBER; i < SWI_COUNT; i++)
+    {
+        if (swi_is_allocated(i)                                           &&
+            (m_swi_handlers[i - SWI_START_NUMBER] == swi_channel_dispatch) &&
+            (m_swi_priorities[i - SWI_START_NUMBER] == priority)          &&
+            swi_channel_take((nrf_swi_t)i, cb_idx, p_channel))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+ret_code_t nrf_drv_swi_channel_alloc(nrf_drv_swi_channel_t       * p_channel,
+                                     nrf_drv_swi_channel_handler_t handler,
+                                     void                        * p_context,
+                                     uint32_t                      priority)
+{
+    ASSERT(p_channel);
+    ASSERT(handler);
+    ret_code_t err_code = NRF_ERROR_NO_MEM;
+    uint32_t   cb_idx;
+    bool       found    = false;
+
+    CRITICAL_REGION_ENTER();
+    for (cb_idx = 0; cb_idx < SWI_CONFIG_CHANNEL_COUNT; cb_idx++)
+    {
+        if (m_channel_cbs[cb_idx].handler == NULL)
+        {
+            m_channel_cbs[cb_idx].handler   = handler;
+            m_channel_cbs[cb_idx].p_context = p_context;
+            found = swi_channel_find(priority, cb_idx, p_channel);
+            err_code = NRF_SUCCESS;
+            break;
+        }
+    }
+    CRITICAL_REGION_EXIT();
+
+    if ((err_code == NRF_SUCCESS) && !found)
+    {
+        nrf_swi_t swi;
+
+        err_code = nrf_drv_swi_alloc(&swi, swi_channel_dispatch, priority);
+        if (err_code == NRF_SUCCESS)
+        {
+            m_swi_priorities[swi - SWI_START_NUMBER] = (uint8_t)priority;
+            CRITICAL_REGION_ENTER();
+            found = swi_channel_take(swi, cb_idx, p_channel);
+            CRITICAL_REGION_EXIT();
+            ASSERT(found);
+        }
+        else
+        {
+            m_channel_cbs[cb_idx].handler = NULL;
+        }
+    }
+
+    if (err_code == NRF_SUCCESS)
+    {
+        NRF_LOG_INFO("SWI channel allocated: %d.%d.\r\n", p_channel->swi, p_channel->channel);
+    }
+    NRF_LOG_INFO("Function: %s, error code: %s.\r\n", (uint32_t)__func__, (uint32_t)ERR_TO_STR(err_code));
+    return err_code;
+}
+
+
+void nrf_drv_swi_channel_free(nrf_drv_swi_channel_t const * p_channel)
+{
+    ASSERT(p_channel);
+    ASSERT(swi_is_allocated(p_channel->swi));
+    ASSERT(m_swi_handlers[p_channel->swi - SWI_START_NUMBER] == swi_channel_dispatch);
+    uint8_t * p_map  = m_channel_map[p_channel->swi - SWI_START_NUMBER];
+    bool      in_use = false;
+
+    CRITICAL_REGION_ENTER();
+    ASSERT(p_map[p_channel->channel] != 0);
+    m_channel_cbs[p_map[p_channel->channel] - 1].handler = NULL;
+    p_map[p_channel->channel] = 0;
+    for (uint32_t i = 0; i < SWI_CHANNELS_PER_SWI; i++)
+    {
+        in_use |= (p_map[i] != 0);
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (!in_use)
+    {
+        nrf_swi_t swi = p_channel->swi;
+        nrf_drv_swi_free(&swi);
+    }
+}
+
+
+void nrf_drv_swi_channel_trigger(nrf_drv_swi_channel_t const * p_channel)
+{
+    ASSERT(p_channel);
+    nrf_drv_swi_trigger(p_channel->swi, p_channel->channel);
+}
+
+
 #if NRF_MODULE_ENABLED(EGU)
 
 uint32_t nrf_drv_swi_task_trigger_address_get(nrf_swi_t swi, uint8_t channel)
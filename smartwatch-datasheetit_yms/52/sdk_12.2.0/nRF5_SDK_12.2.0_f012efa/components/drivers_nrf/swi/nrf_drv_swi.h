@@ -18,6 +18,10 @@
  *
  * @brief    Driver for software interrupts (SWI).
  * @details  The SWI driver allows the user to allocate SWIs and pass extra flags to interrupt handler functions.
+ *
+ *           An SWI can also be shared through channels: every channel has its own handler, and the
+ *           channels of one priority are dispatched from the same interrupt line, up to
+ *           @ref SWI_CHANNELS_PER_SWI per SWI. On nRF52, each channel is an event of the EGU.
  */
 
 #ifndef NRF_DRV_SWI_H__
@@ -87,6 +91,27 @@ typedef void (* nrf_swi_handler_t)(nrf_swi_t, nrf_swi_flags_t);
 /**@brief Default SWI priority. */
 #define SWI_DEFAULT_PRIORITY APP_IRQ_PRIORITY_LOWEST
 
+/**@brief Maximum number of channels of one SWI. */
+#define SWI_CHANNELS_PER_SWI 16
+
+/** @brief Number of channels that can be allocated, over all shared SWIs.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef SWI_CONFIG_CHANNEL_COUNT
+#define SWI_CONFIG_CHANNEL_COUNT 16
+#endif
+
+/**@brief Channel handler function. */
+typedef void (* nrf_drv_swi_channel_handler_t)(void * p_context);
+
+/**@brief Channel of a shared SWI. */
+typedef struct
+{
+    nrf_swi_t swi;      ///< SWI that the channel belongs to.
+    uint8_t   channel;  ///< Number of the channel in the SWI, the EGU event on nRF52.
+} nrf_drv_swi_channel_t;
+
 
 /**@brief Function for initializing the SWI module.
  *
@@ -131,6 +156,44 @@ void nrf_drv_swi_free(nrf_swi_t * p_swi);
 void nrf_drv_swi_trigger(nrf_swi_t swi, uint8_t flag_number);
 
 
+/**@brief Function for allocating a channel of a shared SWI and setting its handler.
+ *
+ * The channel is taken from an SWI that is already shared at the same priority, or a new SWI
+ * is allocated for it. An SWI that is allocated with @ref nrf_drv_swi_alloc is never shared.
+ *
+ * @param[out] p_channel     Pointer to the channel that has been allocated.
+ * @param[in]  handler       Channel handler function (must not be NULL).
+ * @param[in]  p_context     Context passed to the handler.
+ * @param[in]  priority      Interrupt priority.
+ *
+ * @retval     NRF_SUCCESS       If the channel was successfully allocated.
+ * @retval     NRF_ERROR_NO_MEM  If all @ref SWI_CONFIG_CHANNEL_COUNT channels are in use, or no
+ *                               SWI is available.
+ */
+ret_code_t nrf_drv_swi_channel_alloc(nrf_drv_swi_channel_t       * p_channel,
+                                     nrf_drv_swi_channel_handler_t handler,
+                                     void                        * p_context,
+                                     uint32_t                      priority);
+
+
+/**@brief Function for freeing a previously allocated channel.
+ *
+ * The SWI is freed with its last channel.
+ *
+ * @param[in]  p_channel     Channel to free.
+ */
+void nrf_drv_swi_channel_free(nrf_drv_swi_channel_t const * p_channel);
+
+
+/**@brief Function for triggering a channel. Can be called from any context.
+ *
+ * A channel that is triggered several times before its handler runs is handled once.
+ *
+ * @param[in]  p_channel     Channel to trigger.
+ */
+void nrf_drv_swi_channel_trigger(nrf_drv_swi_channel_t const * p_channel);
+
+
 #if (EGU_ENABLED > 0) || defined(__SDK_DOXYGEN__)
 
 
@@ -12,6 +12,12 @@
  */
 #define EGU_ENABLED
 
+/** @brief Number of channels that can be allocated, over all shared SWIs.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define SWI_CONFIG_CHANNEL_COUNT
+
 /** @brief Enables logging in the module.
  *
  *  Set to 1 to activate.
@@ -20,6 +20,7 @@
 #include "nrf_assert.h"
 #include "app_util_platform.h"
 #include "nrf_delay.h"
+#include "cpu_profiler_hooks.h"
 
 #include <stdio.h>
 
@@ -1084,24 +1085,28 @@ static void irq_handler_twi(NRF_TWI_Type * p_twi, twi_control_block_t * p_cb)
 #if NRF_MODULE_ENABLED(TWI0)
 IRQ_HANDLER(0)
 {
+    CPU_PROFILER_ISR_ENTER(CPU_PROFILER_ISR_TWI0);
     #if (TWI0_USE_EASY_DMA == 1)
         irq_handler_twim(NRF_TWIM0,
     #else
         irq_handler_twi(NRF_TWI0,
     #endif
             &m_cb[TWI0_INSTANCE_INDEX]);
+    CPU_PROFILER_ISR_EXIT(CPU_PROFILER_ISR_TWI0);
 }
 #endif // NRF_MODULE_ENABLED(TWI0)
 
 #if NRF_MODULE_ENABLED(TWI1)
 IRQ_HANDLER(1)
 {
+    CPU_PROFILER_ISR_ENTER(CPU_PROFILER_ISR_TWI1);
     #if (TWI1_USE_EASY_DMA == 1)
         irq_handler_twim(NRF_TWIM1,
     #else
         irq_handler_twi(NRF_TWI1,
     #endif
             &m_cb[TWI1_INSTANCE_INDEX]);
+    CPU_PROFILER_ISR_EXIT(CPU_PROFILER_ISR_TWI1);
 }
 #endif // NRF_MODULE_ENABLED(TWI1)
 #endif // TWI_COUNT
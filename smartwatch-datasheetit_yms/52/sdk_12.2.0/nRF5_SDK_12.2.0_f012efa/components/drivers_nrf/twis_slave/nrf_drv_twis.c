@@ -90,6 +90,11 @@ typedef struct
                                                   *   Always use Atomic load-store when updating
                                                   *   this value in main loop.
                                                   */
+    uint8_t const * volatile         p_window;       ///< Register window, NULL if not used
+    size_t                           window_size;    ///< Size of the register window
+    uint8_t *                        p_window_rx;    ///< Buffer for the writes to the register window
+    size_t                           window_rx_size; ///< Size of the buffer for the writes
+    size_t                           window_offset;  ///< Offset of the next read in the register window
 }nrf_drv_twis_var_inst_t;
 
 
@@ -106,7 +111,8 @@ static nrf_drv_twis_var_inst_t m_var_inst[ENABLED_TWIS_COUNT] =
     #define X(n) { .state      = NRF_DRV_STATE_UNINITIALIZED, \
                    .substate   = NRF_DRV_TWIS_SUBSTATE_IDLE, \
                    .ev_handler = NULL, \
-                   .error      = 0 },
+                   .error      = 0, \
+                   .p_window   = NULL },
     #include "nrf_drv_twis_inst.def"
 };
 
@@ -336,6 +342,84 @@ static inline void nrf_drv_twis_process_error(
     nrf_drv_call_event_handler(instNr, &evdata);
 }
 
+/**
+ * @brief Prepare read from the register window
+ *
+ * The master reads from the current offset in the register window.
+ * @param instNr Instance number
+ *
+ * @retval true  The transmission buffer was prepared
+ * @retval false The register window is not used
+ */
+static bool nrf_drv_twis_window_tx_prepare(uint8_t instNr)
+{
+    nrf_drv_twis_var_inst_t * const p_var_inst = &m_var_inst[instNr];
+
+    if (NULL == p_var_inst->p_window)
+    {
+        return false;
+    }
+    nrf_twis_tx_prepare(m_const_inst[instNr].p_reg,
+                        p_var_inst->p_window + p_var_inst->window_offset,
+                        (nrf_twis_amount_t)(p_var_inst->window_size - p_var_inst->window_offset));
+    return true;
+}
+
+/**
+ * @brief Prepare write to the register window
+ *
+ * @param instNr Instance number
+ *
+ * @retval true  The receiving buffer was prepared
+ * @retval false The register window is not used
+ */
+static bool nrf_drv_twis_window_rx_prepare(uint8_t instNr)
+{
+    nrf_drv_twis_var_inst_t * const p_var_inst = &m_var_inst[instNr];
+
+    if (NULL == p_var_inst->p_window)
+    {
+        return false;
+    }
+    nrf_twis_rx_prepare(m_const_inst[instNr].p_reg,
+                        p_var_inst->p_window_rx,
+                        (nrf_twis_amount_t)p_var_inst->window_rx_size);
+    return true;
+}
+
+/**
+ * @brief Move the offset in the register window
+ *
+ * The first byte written by the master is the new offset.
+ * Reads continue from the end of the previous read.
+ * @param instNr Instance number
+ * @param write  True after a write, false after a read
+ * @param amount Number of bytes transferred
+ */
+static void nrf_drv_twis_window_offset_update(uint8_t instNr, bool write, uint32_t amount)
+{
+    nrf_drv_twis_var_inst_t * const p_var_inst = &m_var_inst[instNr];
+    size_t offset;
+
+    if (NULL == p_var_inst->p_window)
+    {
+        return;
+    }
+    if (write)
+    {
+        if (0 == amount)
+        {
+            return;
+        }
+        offset = p_var_inst->p_window_rx[0];
+    }
+    else
+    {
+        offset = p_var_inst->window_offset + amount;
+    }
+    p_var_inst->window_offset = MIN(offset, p_var_inst->window_size);
+}
+
 
 /**
  * @brief State machine main function
@@ -395,7 +479,7 @@ static void nrf_drv_twis_state_machine(uint8_t instNr)
                 else
                 {
                     substate = NRF_DRV_TWIS_SUBSTATE_READ_WAITING;
-                    evdata.data.buf_req = true;
+                    evdata.data.buf_req = !nrf_drv_twis_window_tx_prepare(instNr);
                 }
                 nrf_drv_call_event_handler(instNr, &evdata);
                 ev = nrf_drv_twis_clear_bit(ev, NRF_TWIS_EVENT_READ);
@@ -414,7 +498,7 @@ static void nrf_drv_twis_state_machine(uint8_t instNr)
                 else
                 {
                     substate = NRF_DRV_TWIS_SUBSTATE_WRITE_WAITING;
-                    evdata.data.buf_req = true;
+                    evdata.data.buf_req = !nrf_drv_twis_window_rx_prepare(instNr);
                 }
                 nrf_drv_call_event_handler(instNr, &evdata);
                 ev = nrf_drv_twis_clear_bit(ev, NRF_TWIS_EVENT_READ);
@@ -455,6 +539,7 @@ static void nrf_drv_twis_state_machine(uint8_t instNr)
                 NRF_LOG_INFO("Transfer rx_len:%d\r\n", evdata.data.tx_amount);
                 NRF_LOG_DEBUG("Tx data:\r\n");
                 NRF_LOG_HEXDUMP_DEBUG((uint8_t *)p_reg->TXD.PTR, evdata.data.tx_amount * sizeof(p_reg->TXD.PTR));
+                nrf_drv_twis_window_offset_update(instNr, false, evdata.data.tx_amount);
                 nrf_drv_call_event_handler(instNr, &evdata);
                 /* Go to idle and repeat the state machine if READ or WRITE events detected.
                  * This time READ or WRITE would be started */
@@ -492,7 +577,10 @@ static void nrf_drv_twis_state_machine(uint8_t instNr)
             {
                 evdata.type = TWIS_EVT_WRITE_DONE;
                 evdata.data.rx_amount = nrf_twis_rx_amount_get(p_reg);
+                nrf_drv_twis_window_offset_update(instNr, true, evdata.data.rx_amount);
                 nrf_drv_call_event_handler(instNr, &evdata);
+                /* The next write to the register window is received without clock stretching */
+                (void)nrf_drv_twis_window_rx_prepare(instNr);
                 /* Go to idle and repeat the state machine if READ or WRITE events detected.
                  * This time READ or WRITE would be started */
                 substate = NRF_DRV_TWIS_SUBSTATE_IDLE;
@@ -665,6 +753,7 @@ void nrf_drv_twis_uninit(nrf_drv_twis_t const * const p_instance)
 #endif
 
     /* Clear variables */
+    m_var_inst[instNr].p_window   = NULL;
     m_var_inst[instNr].ev_handler = NULL;
     m_var_inst[instNr].state      = NRF_DRV_STATE_UNINITIALIZED;
 }
@@ -872,6 +961,63 @@ ret_code_t nrf_drv_twis_rx_prepare(
 }
 
 
+ret_code_t nrf_drv_twis_window_set(
+        nrf_drv_twis_t const * const p_instance,
+        void const * const p_window,
+        size_t window_size,
+        void * const p_rx_buf,
+        size_t rx_size)
+{
+    ret_code_t err_code;
+    uint8_t instNr = p_instance->instNr;
+    nrf_drv_twis_var_inst_t * const p_var_inst = &m_var_inst[instNr];
+
+    /* Check power state*/
+    if (p_var_inst->state != NRF_DRV_STATE_POWERED_ON)
+    {
+        err_code = NRF_ERROR_INVALID_STATE;
+        NRF_LOG_WARNING("Function: %s, error code: %s.\r\n", (uint32_t)__func__, (uint32_t)ERR_TO_STR(err_code));
+        return err_code;
+    }
+    if (NULL == p_window)
+    {
+        p_var_inst->p_window = NULL;
+        return NRF_SUCCESS;
+    }
+    /* Check data address */
+    if (NULL == p_rx_buf)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (!nrf_drv_is_in_RAM(p_window) || !nrf_drv_is_in_RAM(p_rx_buf))
+    {
+        err_code = NRF_ERROR_INVALID_ADDR;
+        NRF_LOG_WARNING("Function: %s, error code: %s.\r\n", (uint32_t)__func__, (uint32_t)ERR_TO_STR(err_code));
+        return err_code;
+    }
+    /* Check data size */
+    if (((window_size & TWIS_TXD_MAXCNT_MAXCNT_Msk) != window_size) ||
+        ((rx_size & TWIS_RXD_MAXCNT_MAXCNT_Msk) != rx_size) || (0 == rx_size))
+    {
+        err_code = NRF_ERROR_INVALID_LENGTH;
+        NRF_LOG_WARNING("Function: %s, error code: %s.\r\n", (uint32_t)__func__, (uint32_t)ERR_TO_STR(err_code));
+        return err_code;
+    }
+
+    p_var_inst->window_size    = window_size;
+    p_var_inst->p_window_rx    = (uint8_t *)p_rx_buf;
+    p_var_inst->window_rx_size = rx_size;
+    p_var_inst->window_offset  = 0;
+    p_var_inst->p_window       = (uint8_t const *)p_window;
+
+    /* Writes are received without clock stretching */
+    (void)nrf_drv_twis_window_rx_prepare(instNr);
+    err_code = NRF_SUCCESS;
+    NRF_LOG_INFO("Function: %s, error code: %s.\r\n", (uint32_t)__func__, (uint32_t)ERR_TO_STR(err_code));
+    return err_code;
+}
+
+
 size_t nrf_drv_twis_rx_amount(nrf_drv_twis_t const * const p_instance)
 {
     uint8_t instNr = p_instance->instNr;
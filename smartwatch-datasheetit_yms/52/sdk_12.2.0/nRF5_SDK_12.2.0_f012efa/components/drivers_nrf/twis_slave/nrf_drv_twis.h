@@ -284,6 +284,43 @@ ret_code_t nrf_drv_twis_rx_prepare(
         void * const p_buf,
         size_t size);
 
+/**
+ * @brief Set the register window
+ *
+ * In register window mode the driver prepares the buffers itself, so that a host using the
+ * slave as a sensor-hub co-processor never has to wait for the application.
+ * The first byte of every write sets the offset of the next read in the window.
+ * Reads are sent from that offset, and following reads continue where the previous one ended,
+ * so a burst read of consecutive registers (for example a FIFO) is done in one transaction.
+ * Writes are received in @em p_rx_buf, prepared again after every @ref TWIS_EVT_WRITE_DONE event;
+ * the application applies any data after the offset byte to its registers.
+ *
+ * Events are still generated, with buf_req cleared.
+ * A write is received without clock stretching; a read is stretched by the interrupt latency
+ * only, as the offset is known only after the write before it.
+ *
+ * @param[in] p_instance  Pointer to the driver instance structure.
+ * @param[in] p_window    Register window, updated in place by the application.
+ *                        NULL to leave register window mode.
+ * @attention             Register window has to be placed in RAM.
+ * @param     window_size Size of the register window.
+ * @param[in] p_rx_buf    Buffer for the writes of the master.
+ * @attention             Receiving buffer has to be placed in RAM.
+ * @param     rx_size     Size of the buffer for the writes.
+ *
+ * @retval NRF_SUCCESS              Register window set
+ * @retval NRF_ERROR_NULL           @em p_rx_buf is NULL
+ * @retval NRF_ERROR_INVALID_ADDR   Given buffers are not placed inside the RAM
+ * @retval NRF_ERROR_INVALID_LENGTH Wrong value in @em window_size or @em rx_size parameter
+ * @retval NRF_ERROR_INVALID_STATE  Module not initialized or not enabled
+ */
+ret_code_t nrf_drv_twis_window_set(
+        nrf_drv_twis_t const * const p_instance,
+        void const * const p_window,
+        size_t window_size,
+        void * const p_rx_buf,
+        size_t rx_size);
+
 /**
  * @brief Get number of received bytes
  *
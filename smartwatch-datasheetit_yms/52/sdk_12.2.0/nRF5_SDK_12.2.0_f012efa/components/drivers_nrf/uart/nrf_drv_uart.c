@@ -16,6 +16,7 @@
 #include "nrf_drv_common.h"
 #include "nrf_gpio.h"
 #include "app_util_platform.h"
+#include "cpu_profiler_hooks.h"
 
 #define NRF_LOG_MODULE_NAME "UART"
 
@@ -747,6 +748,8 @@ void nrf_drv_uart_rx_abort(const nrf_drv_uart_t * p_instance)
 {
     CODE_FOR_UARTE
     (
+        // The secondary buffer must not be started by the shortcut after the abort.
+        nrf_uarte_shorts_disable(p_instance->reg.p_uarte, NRF_UARTE_SHORT_ENDRX_STARTRX);
         nrf_uarte_task_trigger(p_instance->reg.p_uarte, NRF_UARTE_TASK_STOPRX);
     )
     CODE_FOR_UART
@@ -896,11 +899,23 @@ __STATIC_INLINE void uarte_irq_handler(NRF_UARTE_Type * p_uarte, uart_control_bl
     if (nrf_uarte_event_check(p_uarte, NRF_UARTE_EVENT_RXTO))
     {
         nrf_uarte_event_clear(p_uarte, NRF_UARTE_EVENT_RXTO);
+        // RXTO is generated only after abort. The event is always reported, so that the user
+        // knows that reception is stopped.
+        uint8_t amount = 0;
         if (p_cb->rx_buffer_length)
         {
-            p_cb->rx_buffer_length = 0;
-            rx_done_event(p_cb, nrf_uarte_rx_amount_get(p_uarte), p_cb->p_rx_buffer);
+            amount = nrf_uarte_rx_amount_get(p_uarte);
+            // A full buffer is completed by ENDRX before RXTO. If the amount is equal to the
+            // buffer length, it belongs to the previous buffer and the current one has not
+            // been started.
+            if (amount == p_cb->rx_buffer_length)
+            {
+                amount = 0;
+            }
         }
+        p_cb->rx_buffer_length           = 0;
+        p_cb->rx_secondary_buffer_length = 0;
+        rx_done_event(p_cb, amount, p_cb->p_rx_buffer);
     }
 
     if (nrf_uarte_event_check(p_uarte, NRF_UARTE_EVENT_ENDTX))
@@ -917,6 +932,7 @@ __STATIC_INLINE void uarte_irq_handler(NRF_UARTE_Type * p_uarte, uart_control_bl
 #if UART0_ENABLED
 void UART0_IRQHandler(void)
 {
+    CPU_PROFILER_ISR_ENTER(CPU_PROFILER_ISR_UART0);
     CODE_FOR_UARTE_INT
     (
         UART0_INSTANCE_INDEX,
@@ -926,12 +942,14 @@ void UART0_IRQHandler(void)
     (
         uart_irq_handler(NRF_UART0, &m_cb[UART0_INSTANCE_INDEX]);
     )
+    CPU_PROFILER_ISR_EXIT(CPU_PROFILER_ISR_UART0);
 }
 #endif
 
 #if UART1_ENABLED
 void UARTE1_IRQHandler(void)
 {
+    CPU_PROFILER_ISR_ENTER(CPU_PROFILER_ISR_UART1);
     CODE_FOR_UARTE_INT
     (
         UART1_INSTANCE_INDEX,
@@ -941,6 +959,7 @@ void UARTE1_IRQHandler(void)
     (
         uart_irq_handler(NRF_UART1, &m_cb[UART1_INSTANCE_INDEX]);
     )
+    CPU_PROFILER_ISR_EXIT(CPU_PROFILER_ISR_UART1);
 }
 #endif
 #endif //NRF_MODULE_ENABLED(UART)
@@ -357,6 +357,8 @@ void nrf_drv_uart_rx_disable(nrf_drv_uart_t const * p_instance);
  * @note @ref NRF_DRV_UART_EVT_RX_DONE event will be generated in non-blocking mode. The event will
  *       contain the number of bytes received until abort was called. The event is called from UART interrupt
  *       context.
+ * @note In Easy DMA mode the event is generated also if no reception was ongoing (with 0 bytes), and
+ *       a secondary buffer that was not started is dropped.
  *
  * @param[in] p_instance Pointer to the driver instance structure.
  */
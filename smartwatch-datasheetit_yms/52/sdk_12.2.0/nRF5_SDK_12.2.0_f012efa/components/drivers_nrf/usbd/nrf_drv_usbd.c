@@ -56,6 +56,15 @@
 #define NRF_DRV_USBD_STARTED_EV_ENABLE    1
 #endif
 
+#ifndef NRF_DRV_USBD_DMASCHEDULER_MODE
+#define NRF_DRV_USBD_DMASCHEDULER_MODE NRF_DRV_USBD_DMASCHEDULER_PRIORITIZED
+#endif
+
+#ifndef NRF_DRV_USBD_DMA_STATS_ENABLED
+/* Measure the waits for EasyDMA */
+#define NRF_DRV_USBD_DMA_STATS_ENABLED 0
+#endif
+
 #if NRF_DRV_USBD_PROTO1_FIX
 #include "nrf_drv_systick.h"
 #endif
@@ -205,6 +214,31 @@ static uint32_t m_ep_dma_waiting;
  */
 static uint8_t m_dma_pending;
 
+#if NRF_DRV_USBD_DMASCHEDULER_MODE != NRF_DRV_USBD_DMASCHEDULER_PRIORITIZED
+/**
+ * @brief Bit position of the endpoint processed last by the round-robin scheme
+ *
+ * In @ref NRF_DRV_USBD_DMASCHEDULER_WEIGHTED scheme it is only the last bulk endpoint.
+ */
+static uint8_t m_dma_rr_last;
+#endif
+
+#if NRF_DRV_USBD_DMASCHEDULER_MODE == NRF_DRV_USBD_DMASCHEDULER_WEIGHTED
+/** @brief Bit position of the interrupt endpoint processed last */
+static uint8_t m_dma_interrupt_last;
+
+/** @brief Transfers left to the last bulk endpoint before the next one gets its turn */
+static uint8_t m_dma_credit;
+
+/** @brief Mask of endpoints set as @ref NRF_DRV_USBD_DMA_CLASS_INTERRUPT */
+static uint32_t m_ep_dma_interrupt;
+#endif
+
+#if NRF_DRV_USBD_DMA_STATS_ENABLED
+/** @brief Mask of endpoints that have the start of their wait for EasyDMA recorded */
+static uint32_t m_ep_dma_wait_stamped;
+#endif
+
 #if NRF_DRV_USBD_PROTO1_FIX
 static uint32_t m_simulated_events;
 static uint32_t m_simulated_dataepstatus;
@@ -222,8 +256,15 @@ typedef struct
     nrf_drv_usbd_transfer_handler_desc_t handler_desc;    //!< Handler for current transfer, function pointer and context
     nrf_drv_usbd_transfer_t              transfer_set;    //!< Last configured transfer
     nrf_drv_usbd_transfer_t              transfer_left;   //!< Current on-going transfer status
+    nrf_drv_usbd_transfer_t const *      p_list_next;     //!< Next buffer of the list set by @ref nrf_drv_usbd_ep_transfer_list
+    size_t                               list_left;       //!< Number of buffers left in the list
     uint16_t                             max_packet_size; //!< Configured endpoint size
     nrf_drv_usbd_ep_status_t             status;          //!< NRF_SUCCESS or error code, never NRF_ERROR_BUSY - this one is calculated
+    uint8_t                              dma_weight;      //!< Transfers in a row of a bulk endpoint, see @ref NRF_DRV_USBD_DMASCHEDULER_WEIGHTED
+#if NRF_DRV_USBD_DMA_STATS_ENABLED
+    uint32_t                             dma_wait_start;  //!< Cycle counter when the current wait for EasyDMA began
+    nrf_drv_usbd_dma_stats_t             dma_stats;       //!< Statistics of the waits for EasyDMA
+#endif
 }usbd_drv_ep_state_t;
 
 /**
@@ -499,6 +540,8 @@ static void usbd_ep_abort_all(void)
  * @brief Safely call next transfer callback
  *
  * Function safely calls next transfer callback.
+ * Buffers left in the list set by @ref nrf_drv_usbd_ep_transfer_list are taken first,
+ * without calling the callback.
  *
  * @param[in,out] p_state Endpoint state structure pointer.
  *                        The callback function pointer is located here,
@@ -509,6 +552,13 @@ static void usbd_ep_abort_all(void)
  */
 static bool usbd_next_transfer_safe_call(usbd_drv_ep_state_t * p_state)
 {
+    if(0 != p_state->list_left)
+    {
+        p_state->transfer_set  = *(p_state->p_list_next++);
+        p_state->transfer_left = p_state->transfer_set;
+        --(p_state->list_left);
+        return true;
+    }
     if(NULL == p_state->handler_desc.handler)
         return false;
     bool ret;
@@ -973,6 +1023,22 @@ static void USBD_ISR_AccessFault(void)
     // ASSERT(0);
 }
 
+#if NRF_DRV_USBD_DMASCHEDULER_MODE != NRF_DRV_USBD_DMASCHEDULER_PRIORITIZED
+/**
+ * @brief Round-robin step
+ *
+ * @param[in] req  Bit flags for channels currently requiring transfer, never 0.
+ * @param[in] last Bit number of the endpoint processed last.
+ *
+ * @return The nearest bit set in @c req above @c last, or the lowest one if none.
+ */
+static uint8_t usbd_dma_scheduler_next(uint32_t req, uint8_t last)
+{
+    uint32_t higher = (last >= 31) ? 0 : (req & ~((2UL << last) - 1));
+    return __CLZ(__RBIT((0 != higher) ? higher : req));
+}
+#endif
+
 /**
  * @brief Function to select the endpoint to start
  *
@@ -988,10 +1054,90 @@ static void USBD_ISR_AccessFault(void)
  */
 static uint8_t usbd_dma_scheduler_algorithm(uint32_t req)
 {
-    /** @todo RK This is just simple algorithm for testing and should be updated */
+#if NRF_DRV_USBD_DMASCHEDULER_MODE == NRF_DRV_USBD_DMASCHEDULER_PRIORITIZED
     return __CLZ(__RBIT(req));
+#elif NRF_DRV_USBD_DMASCHEDULER_MODE == NRF_DRV_USBD_DMASCHEDULER_ROUNDROBIN
+    m_dma_rr_last = usbd_dma_scheduler_next(req, m_dma_rr_last);
+    return m_dma_rr_last;
+#elif NRF_DRV_USBD_DMASCHEDULER_MODE == NRF_DRV_USBD_DMASCHEDULER_WEIGHTED
+    uint32_t urgent;
+
+    /* Isochronous data has to be moved before the next SOF */
+    urgent = req & ((1U << ep2bit(NRF_DRV_USBD_EPIN8)) | (1U << ep2bit(NRF_DRV_USBD_EPOUT8)));
+    if(0 == urgent)
+    {
+        urgent = req & ((1U << ep2bit(NRF_DRV_USBD_EPIN0)) | (1U << ep2bit(NRF_DRV_USBD_EPOUT0)));
+    }
+    if(0 != urgent)
+    {
+        return __CLZ(__RBIT(urgent));
+    }
+
+    urgent = req & m_ep_dma_interrupt;
+    if(0 != urgent)
+    {
+        m_dma_interrupt_last = usbd_dma_scheduler_next(urgent, m_dma_interrupt_last);
+        return m_dma_interrupt_last;
+    }
+
+    /* Bulk: the last endpoint keeps its turn while it has transfers and credit left */
+    if((0 != (req & (1U << m_dma_rr_last))) && (m_dma_credit > 0))
+    {
+        --m_dma_credit;
+        return m_dma_rr_last;
+    }
+    m_dma_rr_last = usbd_dma_scheduler_next(req, m_dma_rr_last);
+
+    uint8_t weight = ep_state_access(bit2ep(m_dma_rr_last))->dma_weight;
+    m_dma_credit = (weight > 0) ? (weight - 1) : 0;
+    return m_dma_rr_last;
+#else
+    #error "Unsupported NRF_DRV_USBD_DMASCHEDULER_MODE"
+#endif
 }
 
+#if NRF_DRV_USBD_DMA_STATS_ENABLED
+/**
+ * @brief Record the start of the wait for EasyDMA of the endpoints that began waiting
+ *
+ * @param[in] req Bit flags for endpoints currently requiring transfer.
+ */
+static void usbd_dma_stats_wait_begin(uint32_t req)
+{
+    /* Endpoints aborted since the last call stop waiting */
+    uint32_t new_req = req & ~m_ep_dma_wait_stamped;
+    uint32_t now     = DWT->CYCCNT;
+
+    m_ep_dma_wait_stamped &= req;
+    while(0 != new_req)
+    {
+        uint8_t pos = __CLZ(__RBIT(new_req));
+        ep_state_access(bit2ep(pos))->dma_wait_start = now;
+        new_req &= ~(1U << pos);
+    }
+    m_ep_dma_wait_stamped |= req;
+}
+
+/**
+ * @brief Record the end of the wait for EasyDMA of an endpoint
+ *
+ * @param[in] pos Bit position of the endpoint which transfer starts.
+ */
+static void usbd_dma_stats_wait_end(uint8_t pos)
+{
+    usbd_drv_ep_state_t * p_state = ep_state_access(bit2ep(pos));
+    uint32_t              wait    = DWT->CYCCNT - p_state->dma_wait_start;
+
+    p_state->dma_stats.count++;
+    p_state->dma_stats.total_cycles += wait;
+    if(wait > p_state->dma_stats.max_cycles)
+    {
+        p_state->dma_stats.max_cycles = wait;
+    }
+    m_ep_dma_wait_stamped &= ~(1U << pos);
+}
+#endif
+
 /**
  * @brief Get the size of isochronous endpoint
  *
@@ -1023,6 +1169,9 @@ static inline size_t usbd_ep_iso_capacity(nrf_drv_usbd_ep_t ep)
  */
 static void usbd_dmareq_process(void)
 {
+#if NRF_DRV_USBD_DMA_STATS_ENABLED
+    usbd_dma_stats_wait_begin(m_ep_dma_waiting & m_ep_ready);
+#endif
     if(0 == m_dma_pending)
     {
         uint32_t req;
@@ -1096,6 +1245,9 @@ static void usbd_dmareq_process(void)
 
             m_dma_pending = 1;
             m_ep_ready &= ~(1U << pos);
+#if NRF_DRV_USBD_DMA_STATS_ENABLED
+            usbd_dma_stats_wait_end(pos);
+#endif
 
             NRF_LOG_DEBUG("USB dma process: Starting transfer on EP: %x, size: %u\r\n", ep, size);
 
@@ -1346,6 +1498,11 @@ ret_code_t nrf_drv_usbd_init(nrf_drv_usbd_event_handler_t const event_handler)
     m_event_handler = event_handler;
     m_drv_state = NRF_DRV_STATE_INITIALIZED;
 
+#if NRF_DRV_USBD_DMA_STATS_ENABLED
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
     uint8_t n;
     for(n=0; n<NRF_USBD_EPIN_CNT; ++n)
     {
@@ -1531,16 +1688,29 @@ void nrf_drv_usbd_ep_disable(nrf_drv_usbd_ep_t ep)
     nrf_usbd_int_disable(nrf_drv_usbd_ep_to_int(ep));
 }
 
-ret_code_t nrf_drv_usbd_ep_transfer(
+/**
+ * @brief Configure the transfer on the endpoint
+ *
+ * Common part of @ref nrf_drv_usbd_ep_transfer and @ref nrf_drv_usbd_ep_transfer_list.
+ *
+ * @param[in] ep         Endpoint number.
+ * @param[in] p_transfer First buffer.
+ * @param[in] p_list     Buffers to be transfered after the first one.
+ * @param[in] list_left  Number of buffers in @c p_list.
+ * @param[in] p_handler  Description of transfer handler, can be NULL.
+ *
+ * @return Standard error code, see @ref nrf_drv_usbd_ep_transfer.
+ */
+static ret_code_t usbd_ep_transfer_set(
     nrf_drv_usbd_ep_t                                  ep,
     nrf_drv_usbd_transfer_t              const * const p_transfer,
+    nrf_drv_usbd_transfer_t              const *       p_list,
+    size_t                                             list_left,
     nrf_drv_usbd_transfer_handler_desc_t const * const p_handler)
 {
     uint8_t ep_bitpos = ep2bit(ep);
     ret_code_t ret;
-    ASSERT(NULL != p_transfer);
 
-    NRF_LOG_DEBUG("USB drv: Transfer called on endpoint %x, size: %u\r\n", ep, p_transfer->size);
     CRITICAL_REGION_ENTER();
     /* Setup data transaction can go only in one direction at a time */
     if((NRF_USBD_EP_NR_GET(ep) == 0) && (ep != m_last_setup_dir))
@@ -1571,6 +1741,8 @@ ret_code_t nrf_drv_usbd_ep_transfer(
 
         p_state->transfer_set = *p_transfer;
         p_state->transfer_left = *p_transfer;
+        p_state->p_list_next = p_list;
+        p_state->list_left = list_left;
         p_state->status = NRF_USBD_EP_OK;
         m_ep_dma_waiting |= 1U << ep_bitpos;
 
@@ -1582,6 +1754,41 @@ ret_code_t nrf_drv_usbd_ep_transfer(
     return ret;
 }
 
+ret_code_t nrf_drv_usbd_ep_transfer(
+    nrf_drv_usbd_ep_t                                  ep,
+    nrf_drv_usbd_transfer_t              const * const p_transfer,
+    nrf_drv_usbd_transfer_handler_desc_t const * const p_handler)
+{
+    ASSERT(NULL != p_transfer);
+
+    NRF_LOG_DEBUG("USB drv: Transfer called on endpoint %x, size: %u\r\n", ep, p_transfer->size);
+    return usbd_ep_transfer_set(ep, p_transfer, NULL, 0, p_handler);
+}
+
+ret_code_t nrf_drv_usbd_ep_transfer_list(
+    nrf_drv_usbd_ep_t                                  ep,
+    nrf_drv_usbd_transfer_t              const * const p_list,
+    size_t                                             count,
+    nrf_drv_usbd_transfer_handler_desc_t const * const p_handler)
+{
+    ASSERT(NULL != p_list);
+    ASSERT(count > 0);
+#ifdef DEBUG
+    for(size_t n = 0; n < count; ++n)
+    {
+        /* Buffers are given to EasyDMA directly, there is no bounce buffer for them */
+        ASSERT((0 == p_list[n].size) || nrf_drv_is_in_RAM(p_list[n].p_data.tx));
+        /* A short packet in the middle would end the transfer */
+        ASSERT(NRF_USBD_EPISO_CHECK(ep)                                    ||
+              ((n + 1) == count)                                           ||
+              (0 == (p_list[n].size % nrf_drv_usbd_ep_max_packet_size_get(ep))));
+    }
+#endif
+
+    NRF_LOG_DEBUG("USB drv: Transfer list called on endpoint %x, buffers: %u\r\n", ep, count);
+    return usbd_ep_transfer_set(ep, &p_list[0], &p_list[1], count - 1, p_handler);
+}
+
 ret_code_t nrf_drv_usbd_ep_status_get(nrf_drv_usbd_ep_t ep, nrf_drv_usbd_transfer_t * p_transfer)
 {
     ret_code_t ret;
@@ -1678,4 +1885,57 @@ void nrf_drv_usbd_transfer_out_drop(nrf_drv_usbd_ep_t ep)
     }
 }
 
+void nrf_drv_usbd_ep_dma_class_set(nrf_drv_usbd_ep_t        ep,
+                                   nrf_drv_usbd_dma_class_t dma_class,
+                                   uint8_t                  weight)
+{
+    CRITICAL_REGION_ENTER();
+    ep_state_access(ep)->dma_weight = weight;
+#if NRF_DRV_USBD_DMASCHEDULER_MODE == NRF_DRV_USBD_DMASCHEDULER_WEIGHTED
+    if(NRF_DRV_USBD_DMA_CLASS_INTERRUPT == dma_class)
+    {
+        m_ep_dma_interrupt |= 1U << ep2bit(ep);
+    }
+    else
+    {
+        m_ep_dma_interrupt &= ~(1U << ep2bit(ep));
+    }
+#else
+    UNUSED_PARAMETER(dma_class);
+#endif
+    CRITICAL_REGION_EXIT();
+}
+
+ret_code_t nrf_drv_usbd_ep_dma_stats_get(nrf_drv_usbd_ep_t ep, nrf_drv_usbd_dma_stats_t * p_stats)
+{
+#if NRF_DRV_USBD_DMA_STATS_ENABLED
+    ASSERT(NULL != p_stats);
+    CRITICAL_REGION_ENTER();
+    *p_stats = ep_state_access(ep)->dma_stats;
+    CRITICAL_REGION_EXIT();
+    return NRF_SUCCESS;
+#else
+    UNUSED_PARAMETER(ep);
+    UNUSED_PARAMETER(p_stats);
+    return NRF_ERROR_NOT_SUPPORTED;
+#endif
+}
+
+void nrf_drv_usbd_dma_stats_clear(void)
+{
+#if NRF_DRV_USBD_DMA_STATS_ENABLED
+    uint8_t n;
+    CRITICAL_REGION_ENTER();
+    for(n=0; n<NRF_USBD_EPIN_CNT; ++n)
+    {
+        memset(&m_ep_state.ep_in[n].dma_stats, 0, sizeof(nrf_drv_usbd_dma_stats_t));
+    }
+    for(n=0; n<NRF_USBD_EPOUT_CNT; ++n)
+    {
+        memset(&m_ep_state.ep_out[n].dma_stats, 0, sizeof(nrf_drv_usbd_dma_stats_t));
+    }
+    CRITICAL_REGION_EXIT();
+#endif
+}
+
 #endif // USBD_ENABLED
@@ -55,14 +55,51 @@
      *
      * All endpoints are processed in round-robin scheme.
      * It means that when one endpoint is processed next in order would be
-     * the nearest with lower number.
-     * When no endpoints with lower number requires processing - then
+     * the nearest with higher number.
+     * When no endpoints with higher number requires processing - then
      * all endpoints from 0 are tested.
      */
     #define NRF_DRV_USBD_DMASCHEDULER_ROUNDROBIN  1
 
+    /**
+     * @brief Scheme with priority classes
+     *
+     * Isochronous endpoints are processed first: their data is ready on SOF
+     * and has to be transfered before the next SOF.
+     * Then endpoint 0, then the endpoints set as
+     * @ref NRF_DRV_USBD_DMA_CLASS_INTERRUPT, in round-robin scheme, so that their
+     * latency is bounded by one transfer of every class above them.
+     * Bulk endpoints share the rest in round-robin scheme: each one gets as many
+     * transfers in a row as its weight.
+     *
+     * @sa nrf_drv_usbd_ep_dma_class_set
+     */
+    #define NRF_DRV_USBD_DMASCHEDULER_WEIGHTED    2
+
 /** @} */
 
+/**
+ * @brief Class of an endpoint for @ref NRF_DRV_USBD_DMASCHEDULER_WEIGHTED
+ */
+typedef enum
+{
+    NRF_DRV_USBD_DMA_CLASS_BULK,      /**< Round-robin with the other bulk endpoints, by weight. Default. */
+    NRF_DRV_USBD_DMA_CLASS_INTERRUPT  /**< Processed before bulk endpoints. */
+} nrf_drv_usbd_dma_class_t;
+
+/**
+ * @brief Statistics of the waits of an endpoint for EasyDMA
+ *
+ * A wait lasts from the moment the endpoint has a transfer and is ready for it,
+ * to the start of its EasyDMA transfer.
+ */
+typedef struct
+{
+    uint32_t count;        /**< Number of EasyDMA transfers started. */
+    uint32_t max_cycles;   /**< Longest wait, in CPU cycles. */
+    uint64_t total_cycles; /**< Sum of the waits, in CPU cycles. */
+} nrf_drv_usbd_dma_stats_t;
+
 /**
  * @brief Number of bytes in the endpoint
  *
@@ -479,6 +516,34 @@ ret_code_t nrf_drv_usbd_ep_transfer(
     nrf_drv_usbd_transfer_t              const * const p_transfer,
     nrf_drv_usbd_transfer_handler_desc_t const * const p_handler);
 
+/**
+ * @brief Start sending data over endpoint from a list of RAM buffers
+ *
+ * Buffers are transfered one after another, packet by packet, directly by EasyDMA:
+ * there is no copy into the internal buffer and no handler call between them.
+ * The handler, if any, is called when the last buffer is transfered.
+ *
+ * Every buffer but the last one has to be a multiple of the endpoint size,
+ * otherwise the short packet would end the transfer on the host side.
+ * For isochronous endpoints every buffer is sent in its own frame.
+ *
+ * @note The list and the buffers have to be kept active till
+ *       @ref NRF_DRV_USBD_EVT_EPTRANSFER event is generated.
+ *
+ * @param[in] ep        Endpoint number.
+ * @param[in] p_list    Buffers in RAM.
+ * @param[in] count     Number of buffers in the list, at least 1.
+ * @param[in] p_handler Description of transfer handler to be called when the list is transfered.
+ *                      Can be NULL when not required by the caller.
+ *
+ * @return The same values as @ref nrf_drv_usbd_ep_transfer.
+ */
+ret_code_t nrf_drv_usbd_ep_transfer_list(
+    nrf_drv_usbd_ep_t                                  ep,
+    nrf_drv_usbd_transfer_t              const * const p_list,
+    size_t                                             count,
+    nrf_drv_usbd_transfer_handler_desc_t const * const p_handler);
+
 /**
  * @brief Get the information about last finished transfer
  *
@@ -627,5 +692,36 @@ nrf_drv_usbd_ep_t nrf_drv_usbd_last_setup_dir_get(void);
  */
 void nrf_drv_usbd_transfer_out_drop(nrf_drv_usbd_ep_t ep);
 
+/**
+ * @brief Set the class of an endpoint for the DMA scheduler
+ *
+ * Used only by @ref NRF_DRV_USBD_DMASCHEDULER_WEIGHTED.
+ * Isochronous endpoints and endpoint 0 have their own classes, and are not affected.
+ *
+ * @param[in] ep        Endpoint number.
+ * @param[in] dma_class Class of the endpoint.
+ * @param[in] weight    Number of transfers in a row for a bulk endpoint. 0 is taken as 1.
+ */
+void nrf_drv_usbd_ep_dma_class_set(nrf_drv_usbd_ep_t        ep,
+                                   nrf_drv_usbd_dma_class_t dma_class,
+                                   uint8_t                  weight);
+
+/**
+ * @brief Get the statistics of the EasyDMA waits of an endpoint
+ *
+ * @param[in]  ep      Endpoint number.
+ * @param[out] p_stats Statistics since the initialization, or since the last
+ *                     @ref nrf_drv_usbd_dma_stats_clear.
+ *
+ * @retval NRF_SUCCESS               Statistics copied.
+ * @retval NRF_ERROR_NOT_SUPPORTED   NRF_DRV_USBD_DMA_STATS_ENABLED is not set.
+ */
+ret_code_t nrf_drv_usbd_ep_dma_stats_get(nrf_drv_usbd_ep_t ep, nrf_drv_usbd_dma_stats_t * p_stats);
+
+/**
+ * @brief Clear the statistics of the EasyDMA waits of all endpoints
+ */
+void nrf_drv_usbd_dma_stats_clear(void);
+
 /** @} */
 #endif /* NRF_DRV_USBD_H__ */
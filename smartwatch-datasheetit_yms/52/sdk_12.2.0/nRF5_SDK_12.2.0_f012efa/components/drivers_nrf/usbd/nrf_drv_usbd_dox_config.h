@@ -17,12 +17,22 @@
  *  Following options are available:
  * - 0 - Prioritized access
  * - 1 - Round Robin
+ * - 2 - Priority classes: isochronous, control, interrupt, then weighted round robin of bulk
  *
  * @note This is an NRF_CONFIG macro.
  */
 #define NRF_DRV_USBD_DMASCHEDULER_MODE
 
 
+/** @brief Measure how long every endpoint waits for EasyDMA, with the DWT cycle counter.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_DRV_USBD_DMA_STATS_ENABLED
+
+
 /** @brief Enable logging.
  *
  *  Set to 1 to activate.
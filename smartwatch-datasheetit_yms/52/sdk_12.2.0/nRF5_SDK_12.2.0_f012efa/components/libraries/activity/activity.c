@@ -0,0 +1,276 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(ACTIVITY)
+#include "activity.h"
+#include <string.h>
+#include "arm_math.h"
+
+#define WINDOW_HOP      (ACTIVITY_CONFIG_WINDOW_SAMPLES / 2)
+#define RING_MINUTES    (ACTIVITY_CONFIG_RECORD_COUNT * ACTIVITY_CONFIG_RECORD_MINUTES)
+
+STATIC_ASSERT(sizeof(activity_minute_t) == sizeof(uint32_t));
+STATIC_ASSERT((ACTIVITY_CONFIG_WINDOW_SAMPLES % 2) == 0);
+
+static struct
+{
+    activity_minute_t ring[RING_MINUTES];                       /**< Minute summaries, as records. First, to be word aligned. */
+    activity_config_t config;                                   /**< Configuration. */
+    uint16_t          min_lag;                                  /**< Shortest step period, in samples. */
+    uint16_t          max_lag;                                  /**< Longest step period, in samples. */
+    uint16_t          fill;                                     /**< Samples in the window. */
+    uint32_t          minute_samples;                           /**< Samples in the current minute. */
+    uint32_t          minute_steps_q8;                          /**< Steps in the current minute, in 1/256. */
+    uint32_t          minute_intensity;                         /**< Sum of the window intensities. */
+    uint16_t          minute_windows[ACTIVITY_TYPE_COUNT];      /**< Windows of every class. */
+    uint32_t          steps_q8;                                 /**< Steps since initialization before the current minute, in 1/256. */
+    activity_type_t   type;                                     /**< Class of the last window. */
+    uint16_t          ring_pos;                                 /**< Next minute to write in the ring. */
+    uint16_t          ring_count;                               /**< Minutes in the ring. */
+    uint32_t          record_seq;                               /**< Records completed. */
+    int16_t           window[ACTIVITY_CONFIG_WINDOW_SAMPLES];   /**< Magnitude samples. */
+    int16_t           scratch[ACTIVITY_CONFIG_WINDOW_SAMPLES];  /**< Window without its mean. */
+} m_activity;
+
+
+/**@brief Integer square root. */
+static uint32_t isqrt(uint32_t value)
+{
+    uint32_t root = 0;
+    uint32_t bit  = 1uL << 30;
+
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root   = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+
+/**@brief Vector magnitude of one sample, saturated to 16 bits.
+ *
+ * X and Y are multiplied and added as one packed word.
+ */
+static int16_t magnitude(int16_t const * p_sample)
+{
+    uint32_t xy;
+    uint32_t sum;
+
+    memcpy(&xy, p_sample, sizeof(xy));
+    sum = __SMUAD(xy, xy) + (uint32_t)((int32_t)p_sample[2] * p_sample[2]);
+
+    return (int16_t)MIN(isqrt(sum), INT16_MAX);
+}
+
+
+static void evt_send(activity_evt_t const * p_evt)
+{
+    m_activity.config.evt_handler(p_evt);
+}
+
+
+/**@brief Value in 1/256 g, saturated to 8 bits. */
+static uint8_t level_get(uint32_t value)
+{
+    return (uint8_t)MIN((value * 256) / (uint32_t)m_activity.config.one_g, UINT8_MAX);
+}
+
+
+/**@brief Function for analyzing the window and counting the steps of its second half. */
+static void window_analyze(void)
+{
+    activity_type_t type;
+    q15_t           mean;
+    q63_t           r0;
+    q63_t           best_r   = 0;
+    uint16_t        best_lag = 0;
+
+    arm_mean_q15(m_activity.window, ACTIVITY_CONFIG_WINDOW_SAMPLES, &mean);
+    arm_offset_q15(m_activity.window, -mean, m_activity.scratch, ACTIVITY_CONFIG_WINDOW_SAMPLES);
+    arm_dot_prod_q15(m_activity.scratch, m_activity.scratch, ACTIVITY_CONFIG_WINDOW_SAMPLES, &r0);
+
+    for (uint16_t lag = m_activity.min_lag; lag <= m_activity.max_lag; lag++)
+    {
+        q63_t r;
+        uint16_t len = ACTIVITY_CONFIG_WINDOW_SAMPLES - lag;
+
+        arm_dot_prod_q15(m_activity.scratch, m_activity.scratch + lag, len, &r);
+        // Normalized to the full window length, so that long lags are not penalized.
+        r = (r * ACTIVITY_CONFIG_WINDOW_SAMPLES) / len;
+        if (r > best_r)
+        {
+            best_r   = r;
+            best_lag = lag;
+        }
+    }
+
+    uint32_t std       = isqrt((uint32_t)(r0 / ACTIVITY_CONFIG_WINDOW_SAMPLES));
+    uint8_t  intensity = level_get(std);
+
+    if (intensity < ACTIVITY_CONFIG_STILL_LEVEL)
+    {
+        type = ACTIVITY_TYPE_STILL;
+    }
+    else if ((best_lag != 0) && (best_r * 100 >= r0 * ACTIVITY_CONFIG_CORRELATION_PCT))
+    {
+        type = (intensity >= ACTIVITY_CONFIG_RUN_LEVEL) ? ACTIVITY_TYPE_RUN : ACTIVITY_TYPE_WALK;
+        m_activity.minute_steps_q8 += ((uint32_t)WINDOW_HOP << 8) / best_lag;
+    }
+    else
+    {
+        type = ACTIVITY_TYPE_OTHER;
+    }
+
+    m_activity.minute_intensity += intensity;
+    m_activity.minute_windows[type]++;
+
+    if (type != m_activity.type)
+    {
+        activity_evt_t evt = {.evt_type = ACTIVITY_EVT_TYPE_CHANGED, .params.type = type};
+        m_activity.type = type;
+        evt_send(&evt);
+    }
+}
+
+
+/**@brief Function for summarizing the current minute in the ring. */
+static void minute_close(void)
+{
+    activity_minute_t minute;
+    uint16_t          windows = 0;
+    uint8_t           type    = ACTIVITY_TYPE_STILL;
+
+    for (uint8_t i = 0; i < ACTIVITY_TYPE_COUNT; i++)
+    {
+        windows += m_activity.minute_windows[i];
+        if (m_activity.minute_windows[i] > m_activity.minute_windows[type])
+        {
+            type = i;
+        }
+    }
+
+    minute.steps     = (uint16_t)MIN(m_activity.minute_steps_q8 >> 8, UINT16_MAX);
+    minute.type      = type;
+    minute.intensity = (windows == 0) ? 0 : (uint8_t)(m_activity.minute_intensity / windows);
+
+    // Fractions of steps are carried over to the next minute.
+    m_activity.steps_q8        += m_activity.minute_steps_q8 & ~0xFFuL;
+    m_activity.minute_steps_q8 &= 0xFF;
+    m_activity.minute_intensity = 0;
+    memset(m_activity.minute_windows, 0, sizeof(m_activity.minute_windows));
+
+    m_activity.ring[m_activity.ring_pos] = minute;
+    m_activity.ring_pos = (m_activity.ring_pos + 1) % RING_MINUTES;
+    if (m_activity.ring_count < RING_MINUTES)
+    {
+        m_activity.ring_count++;
+    }
+
+    activity_evt_t evt = {.evt_type = ACTIVITY_EVT_MINUTE, .params.minute = minute};
+    evt_send(&evt);
+
+    if ((m_activity.ring_pos % ACTIVITY_CONFIG_RECORD_MINUTES) == 0)
+    {
+        uint16_t first = (m_activity.ring_pos == 0) ? (RING_MINUTES - ACTIVITY_CONFIG_RECORD_MINUTES)
+                                                    : (m_activity.ring_pos - ACTIVITY_CONFIG_RECORD_MINUTES);
+
+        evt.evt_type                   = ACTIVITY_EVT_RECORD;
+        evt.params.record.p_data       = (uint32_t const *)&m_activity.ring[first];
+        evt.params.record.length_words = ACTIVITY_CONFIG_RECORD_MINUTES;
+        evt.params.record.sequence     = m_activity.record_seq++;
+        evt_send(&evt);
+    }
+}
+
+
+ret_code_t activity_init(activity_config_t const * p_config)
+{
+    VERIFY_PARAM_NOT_NULL(p_config);
+    VERIFY_PARAM_NOT_NULL(p_config->evt_handler);
+
+    uint32_t min_lag = (ACTIVITY_CONFIG_MIN_STEP_MS * p_config->sample_rate_hz) / 1000;
+    uint32_t max_lag = (ACTIVITY_CONFIG_MAX_STEP_MS * p_config->sample_rate_hz) / 1000;
+
+    if ((p_config->one_g <= 0) || (min_lag == 0) || (max_lag < min_lag) ||
+        (max_lag >= ACTIVITY_CONFIG_WINDOW_SAMPLES))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    memset(&m_activity, 0, sizeof(m_activity));
+    m_activity.config  = *p_config;
+    m_activity.min_lag = (uint16_t)min_lag;
+    m_activity.max_lag = (uint16_t)max_lag;
+    m_activity.type    = ACTIVITY_TYPE_STILL;
+
+    return NRF_SUCCESS;
+}
+
+
+void activity_process(int16_t const * p_xyz, uint16_t count)
+{
+    uint32_t minute_length = (uint32_t)m_activity.config.sample_rate_hz * 60;
+
+    for (uint16_t i = 0; i < count; i++, p_xyz += 3)
+    {
+        m_activity.window[m_activity.fill++] = magnitude(p_xyz);
+
+        if (m_activity.fill == ACTIVITY_CONFIG_WINDOW_SAMPLES)
+        {
+            window_analyze();
+            memmove(m_activity.window,
+                    m_activity.window + WINDOW_HOP,
+                    (ACTIVITY_CONFIG_WINDOW_SAMPLES - WINDOW_HOP) * sizeof(int16_t));
+            m_activity.fill -= WINDOW_HOP;
+        }
+
+        if (++m_activity.minute_samples == minute_length)
+        {
+            m_activity.minute_samples = 0;
+            minute_close();
+        }
+    }
+}
+
+
+uint32_t activity_steps_get(void)
+{
+    return (m_activity.steps_q8 + m_activity.minute_steps_q8) >> 8;
+}
+
+
+ret_code_t activity_minute_get(uint16_t age, activity_minute_t * p_minute)
+{
+    VERIFY_PARAM_NOT_NULL(p_minute);
+
+    if (age >= m_activity.ring_count)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    *p_minute = m_activity.ring[(m_activity.ring_pos + RING_MINUTES - 1 - age) % RING_MINUTES];
+    return NRF_SUCCESS;
+}
+
+#endif //NRF_MODULE_ENABLED(ACTIVITY)
@@ -0,0 +1,208 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup activity Step counter and activity classifier
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for counting steps and classifying the activity from batches of accelerometer
+ *        samples.
+ *
+ * @details The samples are passed in batches, as read from the FIFO of the sensor, so the CPU
+ *          can sleep between two bursts. The vector magnitude of every sample is kept in a
+ *          window of @ref ACTIVITY_CONFIG_WINDOW_SAMPLES. Every half window, the window is analyzed:
+ *          - its standard deviation gives the intensity,
+ *          - its autocorrelation over the lags of @ref ACTIVITY_CONFIG_MIN_STEP_MS to
+ *            @ref ACTIVITY_CONFIG_MAX_STEP_MS gives the step period, when the signal is periodic.
+ *
+ *          The dot products are computed with the CMSIS-DSP q15 kernels.
+ *
+ *          Every minute of samples is summarized in a 4-byte @ref activity_minute_t, kept in a
+ *          ring of @ref ACTIVITY_CONFIG_RECORD_COUNT records of @ref ACTIVITY_CONFIG_RECORD_MINUTES
+ *          minutes. A record is word aligned and can be written as one chunk of an FDS record
+ *          when @ref ACTIVITY_EVT_RECORD is received. It stays valid until the ring wraps.
+ *
+ * @note The module needs the CMSIS-DSP library of the core, for example libarm_cortexM4lf_math.a
+ *       with ARM_MATH_CM4 defined.
+ */
+
+#ifndef ACTIVITY_H__
+#define ACTIVITY_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of magnitude samples analyzed at once. Steps are updated every half window.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef ACTIVITY_CONFIG_WINDOW_SAMPLES
+#define ACTIVITY_CONFIG_WINDOW_SAMPLES      128
+#endif
+
+/** @brief Shortest step period, in milliseconds.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef ACTIVITY_CONFIG_MIN_STEP_MS
+#define ACTIVITY_CONFIG_MIN_STEP_MS         250
+#endif
+
+/** @brief Longest step period, in milliseconds.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef ACTIVITY_CONFIG_MAX_STEP_MS
+#define ACTIVITY_CONFIG_MAX_STEP_MS         1200
+#endif
+
+/** @brief Lowest autocorrelation at the step period, in percent, for a window to count steps.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef ACTIVITY_CONFIG_CORRELATION_PCT
+#define ACTIVITY_CONFIG_CORRELATION_PCT     50
+#endif
+
+/** @brief Standard deviation below which the wearer is still, in 1/256 g.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef ACTIVITY_CONFIG_STILL_LEVEL
+#define ACTIVITY_CONFIG_STILL_LEVEL         8
+#endif
+
+/** @brief Standard deviation above which periodic motion is running, in 1/256 g.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef ACTIVITY_CONFIG_RUN_LEVEL
+#define ACTIVITY_CONFIG_RUN_LEVEL           128
+#endif
+
+/** @brief Number of minutes in a record.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef ACTIVITY_CONFIG_RECORD_MINUTES
+#define ACTIVITY_CONFIG_RECORD_MINUTES      15
+#endif
+
+/** @brief Number of records in the ring.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef ACTIVITY_CONFIG_RECORD_COUNT
+#define ACTIVITY_CONFIG_RECORD_COUNT        4
+#endif
+
+/**@brief Activity classes. */
+typedef enum
+{
+    ACTIVITY_TYPE_STILL, /**< No significant motion. */
+    ACTIVITY_TYPE_WALK,  /**< Periodic motion at walking intensity. */
+    ACTIVITY_TYPE_RUN,   /**< Periodic motion at running intensity. */
+    ACTIVITY_TYPE_OTHER, /**< Motion without a step period. */
+    ACTIVITY_TYPE_COUNT  /**< Number of classes. */
+} activity_type_t;
+
+/**@brief Summary of one minute. */
+typedef struct
+{
+    uint16_t steps;      /**< Steps in the minute. */
+    uint8_t  type;       /**< Most frequent @ref activity_type_t of the minute. */
+    uint8_t  intensity;  /**< Average standard deviation of the magnitude, in 1/256 g, saturated. */
+} activity_minute_t;
+
+/**@brief Event types. */
+typedef enum
+{
+    ACTIVITY_EVT_TYPE_CHANGED, /**< The activity class of the last window changed. */
+    ACTIVITY_EVT_MINUTE,       /**< A minute was summarized. */
+    ACTIVITY_EVT_RECORD,       /**< A record of the ring is full. */
+} activity_evt_type_t;
+
+/**@brief Events. */
+typedef struct
+{
+    activity_evt_type_t evt_type;               /**< Event type. */
+    union
+    {
+        activity_type_t   type;                 /**< New activity class, for @ref ACTIVITY_EVT_TYPE_CHANGED. */
+        activity_minute_t minute;               /**< Summary, for @ref ACTIVITY_EVT_MINUTE. */
+        struct
+        {
+            uint32_t const * p_data;            /**< Record data, for example the chunk of an FDS record. */
+            uint16_t         length_words;      /**< Length of the record, in 4-byte words. */
+            uint32_t         sequence;          /**< Number of the record since initialization. */
+        } record;                               /**< Record, for @ref ACTIVITY_EVT_RECORD. */
+    } params;
+} activity_evt_t;
+
+/**@brief Event handler. Called from @ref activity_process. */
+typedef void (* activity_evt_handler_t)(activity_evt_t const * p_evt);
+
+/**@brief Configuration. */
+typedef struct
+{
+    uint16_t               sample_rate_hz; /**< Sample rate of the accelerometer. */
+    int16_t                one_g;          /**< Raw value of 1 g in the range of the accelerometer. */
+    activity_evt_handler_t evt_handler;    /**< Event handler. */
+} activity_config_t;
+
+
+/**@brief Function for initializing the module.
+ *
+ * @param[in] p_config Configuration.
+ *
+ * @retval NRF_SUCCESS             If the module was initialized.
+ * @retval NRF_ERROR_NULL          If the configuration or the handler was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If the step periods do not fit in the window at the sample rate.
+ */
+ret_code_t activity_init(activity_config_t const * p_config);
+
+
+/**@brief Function for processing a batch of samples.
+ *
+ * @param[in] p_xyz Samples, as X, Y and Z values one after the other, in the native byte order.
+ * @param[in] count Number of samples, each of 3 values.
+ */
+void activity_process(int16_t const * p_xyz, uint16_t count);
+
+
+/**@brief Function for getting the number of steps since initialization. */
+uint32_t activity_steps_get(void);
+
+
+/**@brief Function for getting the summary of a past minute.
+ *
+ * @param[in]  age      0 for the last summarized minute, 1 for the one before, and so on.
+ * @param[out] p_minute Summary.
+ *
+ * @retval NRF_SUCCESS         If the summary was read.
+ * @retval NRF_ERROR_NOT_FOUND If the minute is not in the ring.
+ */
+ret_code_t activity_minute_get(uint16_t age, activity_minute_t * p_minute);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ACTIVITY_H__
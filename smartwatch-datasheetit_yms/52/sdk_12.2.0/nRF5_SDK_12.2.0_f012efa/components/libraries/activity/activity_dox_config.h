@@ -0,0 +1,64 @@
+/**
+ *
+ * @defgroup activity_config activity module configuration
+ * @{
+ * @ingroup activity
+ */
+/** @brief Enabling activity module
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ACTIVITY_ENABLED
+
+/** @brief Number of magnitude samples analyzed at once.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ACTIVITY_CONFIG_WINDOW_SAMPLES
+
+/** @brief Shortest step period, in milliseconds.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ACTIVITY_CONFIG_MIN_STEP_MS
+
+/** @brief Longest step period, in milliseconds.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ACTIVITY_CONFIG_MAX_STEP_MS
+
+/** @brief Lowest autocorrelation at the step period, in percent.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ACTIVITY_CONFIG_CORRELATION_PCT
+
+/** @brief Standard deviation below which the wearer is still, in 1/256 g.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ACTIVITY_CONFIG_STILL_LEVEL
+
+/** @brief Standard deviation above which periodic motion is running, in 1/256 g.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ACTIVITY_CONFIG_RUN_LEVEL
+
+/** @brief Number of minutes in a record.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ACTIVITY_CONFIG_RECORD_MINUTES
+
+/** @brief Number of records in the ring.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ACTIVITY_CONFIG_RECORD_COUNT
+
+
+/** @} */
@@ -0,0 +1,238 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(NRF_ASYNC)
+#include "nrf_async.h"
+#include "app_scheduler.h"
+#include "app_util_platform.h"
+#include "app_error.h"
+
+static struct
+{
+    nrf_async_task_t * p_head;
+    nrf_async_task_t * p_tail;
+    uint16_t           count;          /**< Number of queued tasks. */
+    bool               sched_pending;  /**< A scheduler event is queued to run the tasks. */
+} m_cb;
+
+
+static void run_queue_handler(void * p_event_data, uint16_t event_size);
+
+
+/**@brief Function for queuing a scheduler event when the run queue becomes non-empty. Must be
+ *        called in a critical region.
+ */
+static void sched_event_put(void)
+{
+    if (!m_cb.sched_pending)
+    {
+        m_cb.sched_pending = true;
+        APP_ERROR_CHECK(app_sched_event_put(NULL, 0, run_queue_handler));
+    }
+}
+
+
+/**@brief Function for taking the first task of the run queue.
+ *
+ * @return Task, or NULL if the queue is empty.
+ */
+static nrf_async_task_t * run_queue_pop(void)
+{
+    nrf_async_task_t * p_task;
+
+    CRITICAL_REGION_ENTER();
+    p_task = m_cb.p_head;
+    if (p_task != NULL)
+    {
+        m_cb.p_head = p_task->p_next;
+        if (m_cb.p_head == NULL)
+        {
+            m_cb.p_tail = NULL;
+        }
+        m_cb.count--;
+        p_task->queued = false;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return p_task;
+}
+
+
+/**@brief Scheduler event handler that resumes the queued tasks.
+ *
+ * @details Only the tasks queued when it starts are resumed, so that a task that yields lets the
+ *          other scheduler events run.
+ */
+static void run_queue_handler(void * p_event_data, uint16_t event_size)
+{
+    UNUSED_PARAMETER(p_event_data);
+    UNUSED_PARAMETER(event_size);
+
+    uint16_t count;
+
+    CRITICAL_REGION_ENTER();
+    m_cb.sched_pending = false;
+    count              = m_cb.count;
+    CRITICAL_REGION_EXIT();
+
+    while (count-- > 0)
+    {
+        nrf_async_task_t * p_task = run_queue_pop();
+
+        if (p_task == NULL)
+        {
+            break;
+        }
+
+        if (!PT_SCHEDULE(p_task->fn(p_task)))
+        {
+            p_task->done = true;
+            if (p_task->p_waiter != NULL)
+            {
+                nrf_async_task_resume(p_task->p_waiter);
+            }
+        }
+    }
+}
+
+
+void nrf_async_task_start(nrf_async_task_t * p_task, nrf_async_fn_t fn, void * p_context)
+{
+    ASSERT(p_task != NULL);
+    ASSERT(fn != NULL);
+
+    PT_INIT(&p_task->pt);
+    p_task->fn        = fn;
+    p_task->p_context = p_context;
+    p_task->p_waiter  = NULL;
+    p_task->queued    = false;
+    p_task->done      = false;
+
+    nrf_async_task_resume(p_task);
+}
+
+
+void nrf_async_task_resume(nrf_async_task_t * p_task)
+{
+    CRITICAL_REGION_ENTER();
+    if (!p_task->queued && !p_task->done)
+    {
+        p_task->queued = true;
+        p_task->p_next = NULL;
+        if (m_cb.p_tail == NULL)
+        {
+            m_cb.p_head = p_task;
+        }
+        else
+        {
+            m_cb.p_tail->p_next = p_task;
+        }
+        m_cb.p_tail = p_task;
+        m_cb.count++;
+        sched_event_put();
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+
+void nrf_async_token_arm(nrf_async_token_t * p_token, nrf_async_task_t * p_task)
+{
+    p_token->p_task  = p_task;
+    p_token->result  = NRF_SUCCESS;
+    p_token->pending = true;
+}
+
+
+void nrf_async_complete(nrf_async_token_t * p_token, ret_code_t result)
+{
+    nrf_async_task_t * p_task = p_token->p_task;
+
+    p_token->result  = result;
+    p_token->pending = false;
+
+    // The task may be checking the token right now: it is resumed in any case.
+    if (p_task != NULL)
+    {
+        nrf_async_task_resume(p_task);
+    }
+}
+
+
+void nrf_async_token_cancel(nrf_async_token_t * p_token, ret_code_t result)
+{
+    p_token->result  = result;
+    p_token->pending = false;
+}
+
+
+#if NRF_MODULE_ENABLED(TWI)
+void nrf_async_twi_handler(nrf_drv_twi_evt_t const * p_event, void * p_context)
+{
+    ret_code_t result;
+
+    switch (p_event->type)
+    {
+        case NRF_DRV_TWI_EVT_DONE:
+            result = NRF_SUCCESS;
+            break;
+
+        case NRF_DRV_TWI_EVT_ADDRESS_NACK:
+            result = NRF_ERROR_DRV_TWI_ERR_ANACK;
+            break;
+
+        default:
+            result = NRF_ERROR_DRV_TWI_ERR_DNACK;
+            break;
+    }
+
+    nrf_async_complete((nrf_async_token_t *)p_context, result);
+}
+#endif
+
+
+#if NRF_MODULE_ENABLED(QSPI)
+void nrf_async_qspi_handler(nrf_drv_qspi_evt_t event, void * p_context)
+{
+    UNUSED_PARAMETER(event);
+    nrf_async_complete((nrf_async_token_t *)p_context, NRF_SUCCESS);
+}
+#endif
+
+
+#if NRF_ASYNC_CONFIG_BLOCK_DEV
+void nrf_async_blk_dev_handler(struct nrf_block_dev_s const * p_blk_dev,
+                               nrf_block_dev_event_t const  * p_event)
+{
+    ret_code_t result;
+
+    UNUSED_PARAMETER(p_blk_dev);
+
+    switch (p_event->result)
+    {
+        case NRF_BLOCK_DEV_RESULT_SUCCESS:
+            result = NRF_SUCCESS;
+            break;
+
+        case NRF_BLOCK_DEV_RESULT_TIMEOUT:
+            result = NRF_ERROR_TIMEOUT;
+            break;
+
+        default:
+            result = NRF_ERROR_INTERNAL;
+            break;
+    }
+
+    nrf_async_complete((nrf_async_token_t *)p_event->p_context, result);
+}
+#endif
+
+#endif // NRF_MODULE_ENABLED(NRF_ASYNC)
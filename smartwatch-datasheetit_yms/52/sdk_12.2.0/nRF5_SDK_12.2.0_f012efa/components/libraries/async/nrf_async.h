@@ -0,0 +1,281 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup nrf_async Asynchronous tasks
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for writing multi-step I/O as sequential code, on protothreads.
+ *
+ * @details A task is a protothread that waits for the completion of driver operations without
+ *          blocking. A driver operation is bound to a completion token: the task arms the token,
+ *          starts the operation and waits with @ref NRF_ASYNC_AWAIT. The driver callback completes
+ *          the token with @ref nrf_async_complete, from any context, and the task is queued to be
+ *          resumed from the application scheduler.
+ *
+ *          Several operations on different buses can be started before waiting for all of them,
+ *          with @ref NRF_ASYNC_START and @ref NRF_ASYNC_WAIT. A task can also wait for another task
+ *          with @ref NRF_ASYNC_AWAIT_TASK.
+ *
+ *          Handlers are provided for the drivers that take a context: @ref nrf_async_twi_handler,
+ *          @ref nrf_async_qspi_handler and @ref nrf_async_blk_dev_handler, with the token as
+ *          context. A handler for SPI is defined with @ref NRF_ASYNC_SPI_HANDLER_DEF.
+ *
+ *          A task function is declared with @ref NRF_ASYNC_THREAD. The other macros use its
+ *          parameter p_task. As with any protothread, local variables are not kept when the task
+ *          waits: they must be static, or in the context of the task.
+ *
+ *          Example:
+ *          @code
+ *          static nrf_async_token_t m_twi_token;  // Context of nrf_async_twi_handler.
+ *
+ *          static NRF_ASYNC_THREAD(sensor_read)
+ *          {
+ *              NRF_ASYNC_BEGIN();
+ *              NRF_ASYNC_AWAIT(&m_twi_token, nrf_drv_twi_tx(&m_twi, ADDR, &m_reg, 1, true));
+ *              NRF_ASYNC_AWAIT(&m_twi_token, nrf_drv_twi_rx(&m_twi, ADDR, m_data, 6));
+ *              if (m_twi_token.result != NRF_SUCCESS)
+ *              {
+ *                  NRF_ASYNC_EXIT();
+ *              }
+ *              ...
+ *              NRF_ASYNC_END();
+ *          }
+ *          @endcode
+ *
+ * @note The module uses the application scheduler, which must be initialized.
+ */
+
+#ifndef NRF_ASYNC_H__
+#define NRF_ASYNC_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdk_common.h"
+#include "nrf_pt.h"
+#if NRF_MODULE_ENABLED(TWI)
+#include "nrf_drv_twi.h"
+#endif
+#if NRF_MODULE_ENABLED(SPI)
+#include "nrf_drv_spi.h"
+#endif
+#if NRF_MODULE_ENABLED(QSPI)
+#include "nrf_drv_qspi.h"
+#endif
+
+/** @brief Enable the block device handler, @ref nrf_async_blk_dev_handler.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef NRF_ASYNC_CONFIG_BLOCK_DEV
+#define NRF_ASYNC_CONFIG_BLOCK_DEV 0
+#endif
+
+#if NRF_ASYNC_CONFIG_BLOCK_DEV
+#include "nrf_block_dev.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct nrf_async_task_s nrf_async_task_t;
+
+/**@brief Task function, declared with @ref NRF_ASYNC_THREAD. */
+typedef char (* nrf_async_fn_t)(nrf_async_task_t * p_task);
+
+/**@brief Task. Its content is private to this module, except p_context. */
+struct nrf_async_task_s
+{
+    pt_t               pt;        /**< State of the protothread. */
+    nrf_async_fn_t     fn;        /**< Task function. */
+    void             * p_context; /**< Context of the task. */
+    nrf_async_task_t * p_next;    /**< Next task of the run queue. */
+    nrf_async_task_t * p_waiter;  /**< Task waiting for this one to end. */
+    volatile bool      queued;    /**< The task is in the run queue. */
+    volatile bool      done;      /**< The task has ended. */
+};
+
+/**@brief Completion token of an operation. */
+typedef struct
+{
+    nrf_async_task_t * volatile p_task;  /**< Task resumed when the operation is done. */
+    volatile bool               pending; /**< The operation is not done. */
+    ret_code_t                  result;  /**< Result of the operation, once done. */
+} nrf_async_token_t;
+
+
+/**@brief Macro for declaring a task function.
+ *
+ * @param[in] name Name of the function.
+ */
+#define NRF_ASYNC_THREAD(name) PT_THREAD(name(nrf_async_task_t * p_task))
+
+/**@brief Macro for starting the body of a task function. */
+#define NRF_ASYNC_BEGIN() PT_BEGIN(&p_task->pt)
+
+/**@brief Macro for ending the body of a task function. */
+#define NRF_ASYNC_END() PT_END(&p_task->pt)
+
+/**@brief Macro for ending a task from its body. */
+#define NRF_ASYNC_EXIT() PT_EXIT(&p_task->pt)
+
+/**@brief Macro for letting the other queued tasks and scheduler events run. */
+#define NRF_ASYNC_YIELD()                                 \
+    do                                                    \
+    {                                                     \
+        nrf_async_task_resume(p_task);                    \
+        PT_YIELD(&p_task->pt);                            \
+    } while (0)
+
+/**@brief Macro for starting an operation without waiting for it.
+ *
+ * @param[in] p_token Token of the operation, completed by the driver callback.
+ * @param[in] call    Call that starts the operation and returns a @ref ret_code_t. If it fails,
+ *                    the token is completed with the error.
+ */
+#define NRF_ASYNC_START(p_token, call)                           \
+    do                                                           \
+    {                                                            \
+        nrf_async_token_arm((p_token), p_task);                  \
+        ret_code_t nrf_async_err = (call);                       \
+        if (nrf_async_err != NRF_SUCCESS)                        \
+        {                                                        \
+            nrf_async_token_cancel((p_token), nrf_async_err);    \
+        }                                                        \
+    } while (0)
+
+/**@brief Macro for waiting for an operation started with @ref NRF_ASYNC_START.
+ *
+ * @param[in] p_token Token of the operation. Its result is then in p_token->result.
+ */
+#define NRF_ASYNC_WAIT(p_token) PT_WAIT_WHILE(&p_task->pt, (p_token)->pending)
+
+/**@brief Macro for starting an operation and waiting for it to be done.
+ *
+ * @param[in] p_token Token of the operation. Its result is then in p_token->result.
+ * @param[in] call    Call that starts the operation, see @ref NRF_ASYNC_START.
+ */
+#define NRF_ASYNC_AWAIT(p_token, call)          \
+    do                                          \
+    {                                           \
+        NRF_ASYNC_START((p_token), (call));     \
+        NRF_ASYNC_WAIT(p_token);                \
+    } while (0)
+
+/**@brief Macro for starting a task and waiting for it to end.
+ *
+ * @param[in] p_child   Task to start. Must not be running.
+ * @param[in] child_fn  Task function.
+ * @param[in] p_ctx     Context of the task.
+ */
+#define NRF_ASYNC_AWAIT_TASK(p_child, child_fn, p_ctx)                   \
+    do                                                                   \
+    {                                                                    \
+        nrf_async_task_start((p_child), (child_fn), (p_ctx));            \
+        (p_child)->p_waiter = p_task;                                    \
+        PT_WAIT_UNTIL(&p_task->pt, (p_child)->done);                     \
+    } while (0)
+
+
+/**@brief Function for starting a task. It runs from the application scheduler.
+ *
+ * @param[out] p_task    Task, kept in memory until it ends.
+ * @param[in]  fn        Task function.
+ * @param[in]  p_context Context of the task.
+ */
+void nrf_async_task_start(nrf_async_task_t * p_task, nrf_async_fn_t fn, void * p_context);
+
+/**@brief Function for queuing a task to be resumed. Can be called from any context.
+ *
+ * @param[in] p_task Task. Nothing is done if it is queued already, or has ended.
+ */
+void nrf_async_task_resume(nrf_async_task_t * p_task);
+
+/**@brief Function for checking if a task has ended.
+ *
+ * @param[in] p_task Task.
+ */
+__STATIC_INLINE bool nrf_async_task_is_done(nrf_async_task_t const * p_task)
+{
+    return p_task->done;
+}
+
+/**@brief Function for arming a token before its operation is started.
+ *
+ * @param[out] p_token Token.
+ * @param[in]  p_task  Task resumed when the operation is done, or NULL to poll the token.
+ */
+void nrf_async_token_arm(nrf_async_token_t * p_token, nrf_async_task_t * p_task);
+
+/**@brief Function for completing a token, from the driver callback. Can be called from any
+ *        context.
+ *
+ * @param[in] p_token Token.
+ * @param[in] result  Result of the operation.
+ */
+void nrf_async_complete(nrf_async_token_t * p_token, ret_code_t result);
+
+/**@brief Function for completing a token whose operation could not be started, without resuming
+ *        the task.
+ *
+ * @param[in] p_token Token.
+ * @param[in] result  Error returned when starting the operation.
+ */
+void nrf_async_token_cancel(nrf_async_token_t * p_token, ret_code_t result);
+
+#if NRF_MODULE_ENABLED(TWI)
+/**@brief TWI driver handler that completes the token given as context.
+ *
+ * NACK events complete it with NRF_ERROR_DRV_TWI_ERR_ANACK or NRF_ERROR_DRV_TWI_ERR_DNACK.
+ */
+void nrf_async_twi_handler(nrf_drv_twi_evt_t const * p_event, void * p_context);
+#endif
+
+#if NRF_MODULE_ENABLED(QSPI)
+/**@brief QSPI driver handler that completes the token given as context. */
+void nrf_async_qspi_handler(nrf_drv_qspi_evt_t event, void * p_context);
+#endif
+
+#if NRF_ASYNC_CONFIG_BLOCK_DEV
+/**@brief Block device handler that completes the token given as context.
+ *
+ * A failed request completes it with NRF_ERROR_TIMEOUT or NRF_ERROR_INTERNAL.
+ */
+void nrf_async_blk_dev_handler(struct nrf_block_dev_s const * p_blk_dev,
+                               nrf_block_dev_event_t const  * p_event);
+#endif
+
+#if NRF_MODULE_ENABLED(SPI)
+/**@brief Macro for defining an SPI driver handler that completes a token. The SPI driver passes no
+ *        context, so a handler is defined for each instance.
+ *
+ * @param[in] name    Name of the handler.
+ * @param[in] p_token Token.
+ */
+#define NRF_ASYNC_SPI_HANDLER_DEF(name, p_token)                 \
+    static void name(nrf_drv_spi_evt_t const * p_event)          \
+    {                                                            \
+        UNUSED_PARAMETER(p_event);                               \
+        nrf_async_complete((p_token), NRF_SUCCESS);              \
+    }
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_ASYNC_H__
+
+/** @} */
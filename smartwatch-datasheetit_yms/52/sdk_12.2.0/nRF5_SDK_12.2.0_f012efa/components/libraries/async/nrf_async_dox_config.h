@@ -0,0 +1,24 @@
+/**
+ *
+ * @defgroup nrf_async_config nrf_async module configuration
+ * @{
+ * @ingroup nrf_async
+ */
+/** @brief Enabling nrf_async module
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_ASYNC_ENABLED
+
+/** @brief Enable the block device handler, nrf_async_blk_dev_handler.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_ASYNC_CONFIG_BLOCK_DEV
+
+
+/** @} */
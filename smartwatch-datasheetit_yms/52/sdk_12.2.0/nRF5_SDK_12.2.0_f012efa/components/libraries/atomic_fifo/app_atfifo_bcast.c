@@ -0,0 +1,222 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "app_atfifo_bcast.h"
+#include <string.h>
+#include "nrf.h"
+#include "app_util.h"
+
+/*
+ * The exclusive monitor is cleared on every exception entry and return, so a store-exclusive
+ * succeeds only if no other context ran since the matching load-exclusive. The loops below
+ * rely on it to read the positions of all readers as one consistent snapshot.
+ */
+
+/**
+ * @brief Position of the item after the one at @p pos
+ */
+static uint32_t bcast_pos_next(app_atfifo_bcast_t const * p_bcast, uint32_t pos)
+{
+    pos += p_bcast->fifo.item_size;
+    if (pos >= p_bcast->fifo.buf_size)
+    {
+        pos -= p_bcast->fifo.buf_size;
+    }
+    return pos;
+}
+
+
+/**
+ * @brief Move the head of the FIFO to the position of the slowest reader
+ *
+ * The space of the items that all readers have read is released for the writer.
+ */
+static void bcast_release(app_atfifo_bcast_t * const p_bcast)
+{
+    uint32_t head;
+
+    do
+    {
+        (void)__LDREXW(&p_bcast->fifo.head.tag);
+
+        uint32_t tail     = p_bcast->fifo.tail.pos.rd;
+        uint32_t dist_max = 0;
+
+        head = tail;
+        for (app_atfifo_bcast_reader_t const * p_reader = p_bcast->p_readers;
+             p_reader != NULL;
+             p_reader = p_reader->p_next)
+        {
+            uint32_t pos  = p_reader->pos;
+            uint32_t dist = (tail >= pos) ? (tail - pos) : (tail + p_bcast->fifo.buf_size - pos);
+            if (dist > dist_max)
+            {
+                dist_max = dist;
+                head     = pos;
+            }
+        }
+        head |= head << 16;
+    } while (__STREXW(head, &p_bcast->fifo.head.tag) != 0);
+}
+
+
+/**
+ * @brief Drop the oldest item for the readers that did not read it
+ */
+static void bcast_drop_oldest(app_atfifo_bcast_t * const p_bcast)
+{
+    uint32_t oldest = p_bcast->fifo.head.pos.wr;
+
+    for (app_atfifo_bcast_reader_t * p_reader = p_bcast->p_readers;
+         p_reader != NULL;
+         p_reader = p_reader->p_next)
+    {
+        uint32_t pos;
+        do
+        {
+            pos = __LDREXW(&p_reader->pos);
+            if (pos != oldest)
+            {
+                __CLREX();
+                break;
+            }
+        } while (__STREXW(bcast_pos_next(p_bcast, pos), &p_reader->pos) != 0);
+
+        if (pos == oldest)
+        {
+            p_reader->dropped++;
+        }
+    }
+    bcast_release(p_bcast);
+}
+
+
+ret_code_t app_atfifo_bcast_init(app_atfifo_bcast_t * const p_bcast,
+                                 void                     * p_buf,
+                                 uint16_t                   buf_size,
+                                 uint16_t                   item_size,
+                                 app_atfifo_bcast_policy_t  policy)
+{
+    p_bcast->p_readers = NULL;
+    p_bcast->policy    = policy;
+    return app_atfifo_init(&p_bcast->fifo, p_buf, buf_size, item_size);
+}
+
+
+void app_atfifo_bcast_reader_add(app_atfifo_bcast_t * const p_bcast, app_atfifo_bcast_reader_t * p_reader)
+{
+    p_reader->pos      = p_bcast->fifo.tail.pos.rd;
+    p_reader->dropped  = 0;
+    p_reader->p_next   = p_bcast->p_readers;
+    p_bcast->p_readers = p_reader;
+}
+
+
+void * app_atfifo_bcast_wopen(app_atfifo_bcast_t * const p_bcast, app_atfifo_wcontext_t * p_context)
+{
+    void * p_d = app_atfifo_wopen_internal(&p_bcast->fifo, p_context);
+
+    if ((p_d == NULL) && (p_bcast->policy == APP_ATFIFO_BCAST_DROP_OLDEST))
+    {
+        bcast_drop_oldest(p_bcast);
+        p_d = app_atfifo_wopen_internal(&p_bcast->fifo, p_context);
+    }
+    return p_d;
+}
+
+
+bool app_atfifo_bcast_wcommit(app_atfifo_bcast_t * const p_bcast, app_atfifo_wcontext_t * p_context)
+{
+    return app_atfifo_wcommit(&p_bcast->fifo, p_context);
+}
+
+
+ret_code_t app_atfifo_bcast_put(app_atfifo_bcast_t * const p_bcast,
+                                void const * const         p_var,
+                                size_t                     size,
+                                bool * const               p_visible)
+{
+    app_atfifo_wcontext_t context;
+    bool visible;
+
+    ASSERT(size <= p_bcast->fifo.item_size);
+    void * p_d = app_atfifo_bcast_wopen(p_bcast, &context);
+    if (NULL == p_d)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    memcpy(p_d, p_var, size);
+
+    visible = app_atfifo_bcast_wcommit(p_bcast, &context);
+    if (NULL != p_visible)
+    {
+        *p_visible = visible;
+    }
+    return NRF_SUCCESS;
+}
+
+
+void const * app_atfifo_bcast_ropen(app_atfifo_bcast_t * const    p_bcast,
+                                    app_atfifo_bcast_reader_t   * p_reader,
+                                    app_atfifo_bcast_rcontext_t * p_context)
+{
+    uint32_t pos = p_reader->pos;
+
+    if (pos == p_bcast->fifo.tail.pos.rd)
+    {
+        return NULL;
+    }
+    p_context->pos = pos;
+    return ((uint8_t const *)(p_bcast->fifo.p_buf)) + pos;
+}
+
+
+bool app_atfifo_bcast_rflush(app_atfifo_bcast_t * const    p_bcast,
+                             app_atfifo_bcast_reader_t   * p_reader,
+                             app_atfifo_bcast_rcontext_t * p_context)
+{
+    do
+    {
+        if (__LDREXW(&p_reader->pos) != p_context->pos)
+        {
+            // The writer dropped the item while it was open.
+            __CLREX();
+            return false;
+        }
+    } while (__STREXW(bcast_pos_next(p_bcast, p_context->pos), &p_reader->pos) != 0);
+
+    bcast_release(p_bcast);
+    return true;
+}
+
+
+ret_code_t app_atfifo_bcast_get(app_atfifo_bcast_t * const  p_bcast,
+                                app_atfifo_bcast_reader_t * p_reader,
+                                void * const                p_var,
+                                size_t                      size)
+{
+    app_atfifo_bcast_rcontext_t context;
+    void const * p_s;
+
+    ASSERT(size <= p_bcast->fifo.item_size);
+    do
+    {
+        p_s = app_atfifo_bcast_ropen(p_bcast, p_reader, &context);
+        if (NULL == p_s)
+        {
+            return NRF_ERROR_NOT_FOUND;
+        }
+        memcpy(p_var, p_s, size);
+    } while (!app_atfifo_bcast_rflush(p_bcast, p_reader, &context));
+
+    return NRF_SUCCESS;
+}
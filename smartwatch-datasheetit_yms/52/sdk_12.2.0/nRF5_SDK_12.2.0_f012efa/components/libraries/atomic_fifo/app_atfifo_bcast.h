@@ -0,0 +1,240 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#ifndef APP_ATFIFO_BCAST_H__
+#define APP_ATFIFO_BCAST_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+#include "app_atfifo.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup app_atfifo_bcast Atomic broadcast FIFO
+ * @ingroup app_atfifo
+ *
+ * @brief @tagAPI52 FIFO with one writer and several readers, each reading every item.
+ *
+ * @details The writer uses the same open/commit protocol as @ref app_atfifo.
+ * Every reader has its own read position, and the space of an item is released when
+ * the slowest reader has read it. None of the operations locks interrupts.
+ *
+ * @code
+ * APP_ATFIFO_BCAST_DEF(imu_fifo, imu_sample_t, 16);
+ * static app_atfifo_bcast_reader_t m_fusion_reader;
+ * static app_atfifo_bcast_reader_t m_ble_reader;
+ *
+ * APP_ATFIFO_BCAST_INIT(imu_fifo, APP_ATFIFO_BCAST_DROP_OLDEST);
+ * app_atfifo_bcast_reader_add(imu_fifo, &m_fusion_reader);
+ * app_atfifo_bcast_reader_add(imu_fifo, &m_ble_reader);
+ *
+ * // Writer:
+ * app_atfifo_bcast_put(imu_fifo, &sample, sizeof(sample), NULL);
+ *
+ * // Each reader:
+ * while (app_atfifo_bcast_get(imu_fifo, &m_ble_reader, &sample, sizeof(sample)) == NRF_SUCCESS)
+ * {
+ *     // Process the sample.
+ * }
+ * @endcode
+ *
+ * @note The read operations of one reader must not interrupt each other. Different readers can
+ * read from any context.
+ * @{
+ */
+
+/**
+ * @brief Behaviour when the slowest reader leaves no space for a new item.
+ */
+typedef enum
+{
+    APP_ATFIFO_BCAST_BLOCK_WRITER, //!< The write fails until the slowest reader has read an item.
+    APP_ATFIFO_BCAST_DROP_OLDEST   //!< The oldest item is dropped for the readers that did not read it.
+} app_atfifo_bcast_policy_t;
+
+/**
+ * @brief Reader of a broadcast FIFO
+ */
+typedef struct app_atfifo_bcast_reader_s
+{
+    struct app_atfifo_bcast_reader_s * p_next;  //!< Next reader of the FIFO
+    volatile uint32_t                  pos;     //!< Position of the next item to read
+    volatile uint32_t                  dropped; //!< Items that were dropped before this reader read them
+}app_atfifo_bcast_reader_t;
+
+/**
+ * @brief The broadcast FIFO instance
+ *
+ * The head of the FIFO follows the slowest reader.
+ */
+typedef struct app_atfifo_bcast_s
+{
+    app_atfifo_t                fifo;      //!< Underlying FIFO, written with its own protocol
+    app_atfifo_bcast_reader_t * p_readers; //!< List of readers
+    app_atfifo_bcast_policy_t   policy;    //!< Behaviour when full
+}app_atfifo_bcast_t;
+
+/**
+ * @brief Read operation context
+ */
+typedef struct app_atfifo_bcast_rcontext_s
+{
+    uint32_t pos; //!< Reader position when the item was opened
+}app_atfifo_bcast_rcontext_t;
+
+/**
+ * @brief Instance creation macro
+ *
+ * @param[in] fifo_id      The identifier of the FIFO object, a pointer to the instance.
+ * @param[in] storage_type The type of data stored in the FIFO.
+ * @param[in] item_cnt     The capacity of the FIFO in items.
+ */
+#define APP_ATFIFO_BCAST_DEF(fifo_id, storage_type, item_cnt)                   \
+    static storage_type APP_ATFIFO_BUF_NAME(fifo_id)[(item_cnt)+1];             \
+    static app_atfifo_bcast_t APP_ATFIFO_INST_NAME(fifo_id);                    \
+    static app_atfifo_bcast_t * const fifo_id = &APP_ATFIFO_INST_NAME(fifo_id)
+
+/**
+ * @brief Macro to initialize a FIFO declared by @ref APP_ATFIFO_BCAST_DEF
+ *
+ * @param[in] fifo_id The identifier of the FIFO object.
+ * @param[in] policy  Behaviour when full, see @ref app_atfifo_bcast_policy_t.
+ *
+ * @return The value from @ref app_atfifo_bcast_init function.
+ */
+#define APP_ATFIFO_BCAST_INIT(fifo_id, policy)  \
+    app_atfifo_bcast_init(                      \
+        fifo_id,                                \
+        &APP_ATFIFO_BUF_NAME(fifo_id),          \
+        sizeof(APP_ATFIFO_BUF_NAME(fifo_id)),   \
+        sizeof(APP_ATFIFO_BUF_NAME(fifo_id)[0]),\
+        policy                                  \
+    )
+
+/**
+ * @brief Initializing the FIFO
+ *
+ * @param[out]    p_bcast   FIFO object to initialize.
+ * @param[in,out] p_buf     FIFO buffer, with space for one item more than the capacity.
+ * @param[in]     buf_size  Total buffer size (has to be divisible by @c item_size).
+ * @param[in]     item_size Size of single item.
+ * @param[in]     policy    Behaviour when full.
+ *
+ * @return The value from @ref app_atfifo_init function.
+ */
+ret_code_t app_atfifo_bcast_init(app_atfifo_bcast_t * const p_bcast,
+                                 void                     * p_buf,
+                                 uint16_t                   buf_size,
+                                 uint16_t                   item_size,
+                                 app_atfifo_bcast_policy_t  policy);
+
+/**
+ * @brief Add a reader
+ *
+ * The reader gets the items written after this call.
+ * Must be called before the FIFO is used from other contexts.
+ *
+ * @param[in,out] p_bcast  FIFO object.
+ * @param[out]    p_reader Reader, kept in memory while the FIFO is used.
+ */
+void app_atfifo_bcast_reader_add(app_atfifo_bcast_t * const p_bcast, app_atfifo_bcast_reader_t * p_reader);
+
+/**
+ * @brief Open the FIFO for writing
+ *
+ * With @ref APP_ATFIFO_BCAST_DROP_OLDEST, the oldest item is dropped when the FIFO is full.
+ *
+ * @param[in,out] p_bcast   FIFO object.
+ * @param[out]    p_context The operation context, required by @ref app_atfifo_bcast_wcommit.
+ *
+ * @return Pointer to the space where the item may be stored.
+ *         NULL if there is no space in the buffer.
+ */
+void * app_atfifo_bcast_wopen(app_atfifo_bcast_t * const p_bcast, app_atfifo_wcontext_t * p_context);
+
+/**
+ * @brief Close the writing operation
+ *
+ * @return See @ref app_atfifo_wcommit.
+ */
+bool app_atfifo_bcast_wcommit(app_atfifo_bcast_t * const p_bcast, app_atfifo_wcontext_t * p_context);
+
+/**
+ * @brief Put data into the FIFO
+ *
+ * @param[in,out] p_bcast   FIFO object.
+ * @param[in]     p_var     Variable to copy.
+ * @param[in]     size      Size of the variable, smaller or equal to the item size.
+ * @param[out]    p_visible See value returned by @ref app_atfifo_wcommit. May be NULL.
+ *
+ * @retval NRF_SUCCESS      If the item has been added.
+ * @retval NRF_ERROR_NO_MEM If the FIFO is full and the policy is @ref APP_ATFIFO_BCAST_BLOCK_WRITER.
+ */
+ret_code_t app_atfifo_bcast_put(app_atfifo_bcast_t * const p_bcast,
+                                void const * const         p_var,
+                                size_t                     size,
+                                bool * const               p_visible);
+
+/**
+ * @brief Open the FIFO for reading
+ *
+ * @param[in,out] p_bcast   FIFO object.
+ * @param[in]     p_reader  Reader.
+ * @param[out]    p_context The operation context, required by @ref app_atfifo_bcast_rflush.
+ *
+ * @return Pointer to the item or NULL if the reader has read all items.
+ */
+void const * app_atfifo_bcast_ropen(app_atfifo_bcast_t * const  p_bcast,
+                                    app_atfifo_bcast_reader_t * p_reader,
+                                    app_atfifo_bcast_rcontext_t * p_context);
+
+/**
+ * @brief Close the reading operation
+ *
+ * @param[in,out] p_bcast   FIFO object.
+ * @param[in]     p_reader  Reader.
+ * @param[in]     p_context Context of the reading operation.
+ *
+ * @retval true  The item was read.
+ * @retval false The item was dropped while it was open and may have been overwritten.
+ *               It must be discarded.
+ */
+bool app_atfifo_bcast_rflush(app_atfifo_bcast_t * const    p_bcast,
+                             app_atfifo_bcast_reader_t   * p_reader,
+                             app_atfifo_bcast_rcontext_t * p_context);
+
+/**
+ * @brief Get the next item of a reader
+ *
+ * @param[in,out] p_bcast  FIFO object.
+ * @param[in]     p_reader Reader.
+ * @param[out]    p_var    Pointer to the variable to store data.
+ * @param[in]     size     Size of the data to copy.
+ *
+ * @retval NRF_SUCCESS         Item was copied.
+ * @retval NRF_ERROR_NOT_FOUND The reader has read all items.
+ */
+ret_code_t app_atfifo_bcast_get(app_atfifo_bcast_t * const  p_bcast,
+                                app_atfifo_bcast_reader_t * p_reader,
+                                void * const                p_var,
+                                size_t                      size);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_ATFIFO_BCAST_H__ */
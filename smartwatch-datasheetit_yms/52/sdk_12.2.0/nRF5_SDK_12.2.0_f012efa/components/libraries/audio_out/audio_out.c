@@ -0,0 +1,478 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(AUDIO_OUT)
+#include "audio_out.h"
+#include <string.h>
+#include "nrf_drv_swi.h"
+
+STATIC_ASSERT(AUDIO_OUT_CONFIG_BLOCK_COUNT >= 3);
+STATIC_ASSERT((2 * AUDIO_OUT_CONFIG_BLOCK_FRAMES) <= UINT16_MAX);
+
+#define NO_BLOCK        (-1)
+#define SINE_REFINE_Q15 7373                        /**< 0.225, weight of the second stage of the sine approximation. */
+
+/**@brief States of a source.
+ *
+ * @details Only the mixer returns a source to @ref SOURCE_IDLE: a source is never reused while
+ *          it is being mixed.
+ */
+typedef enum
+{
+    SOURCE_IDLE,
+    SOURCE_PENDING,                                 /**< Claimed, being configured. */
+    SOURCE_ACTIVE,
+    SOURCE_STOPPING,                                /**< Removed by the mixer at the next block. */
+} source_state_t;
+
+/**@brief Source being played. */
+typedef struct
+{
+    audio_out_source_t config;
+    uint8_t volatile   state;                       /**< @ref source_state_t. */
+    uint32_t           pos;                         /**< Index of the sample, or phase of the tone. */
+    uint32_t           frac;                        /**< Fraction of the position between two samples, in Q16 format. */
+    uint32_t           step;                        /**< Samples per frame in Q16 format, or phase increment of the tone. */
+    int32_t            level;                       /**< Amplitude of the tone, Q15 in the upper half-word. */
+    int32_t            level_step;                  /**< Change of the amplitude per frame. */
+    uint32_t           frames_left;                 /**< Frames left in the envelope segment, or in the tone. */
+    uint8_t            point;                       /**< Next envelope point. */
+    bool               endless;                     /**< Tone without envelope and duration. */
+} source_t;
+
+/**@brief Control block.
+ *
+ * @details Blocks are used in turn: rendered by the mixer, handed to the interface, released
+ *          when the interface has sent them, and rendered again.
+ */
+typedef struct
+{
+    audio_out_config_t const * p_config;
+    nrf_drv_swi_channel_t      swi;
+    uint8_t                    render_idx;          /**< Next block to render. Mixer only. */
+    uint8_t                    hand_idx;            /**< Next block to hand to the interface. I2S interrupt only. */
+    uint8_t volatile           ready;               /**< Blocks rendered and not handed. */
+    uint8_t volatile           free;                /**< Blocks to render. */
+    int8_t                     queued[2];           /**< Block being sent, and block set to be sent next. */
+    uint32_t volatile          underruns;
+} audio_out_cb_t;
+
+static audio_out_cb_t m_cb;
+static source_t       m_sources[AUDIO_OUT_CONFIG_SOURCE_COUNT];
+static uint32_t       m_blocks[AUDIO_OUT_CONFIG_BLOCK_COUNT][AUDIO_OUT_CONFIG_BLOCK_FRAMES];
+
+/**@brief Buffer of the I2S driver, filled with silence when no block is rendered in time. */
+static uint32_t       m_silence[2 * AUDIO_OUT_CONFIG_BLOCK_FRAMES];
+
+
+/**@brief Function for calculating the number of frames in a duration, at least one. */
+static uint32_t frames_get(uint32_t duration_ms)
+{
+    uint32_t frames = (uint32_t)(((uint64_t)duration_ms * m_cb.p_config->sample_rate) / 1000);
+    return MAX(frames, 1);
+}
+
+
+/**@brief Function for approximating a sine with two parabolas.
+ *
+ * @param[in] phase Phase, a full period over the 16-bit range.
+ *
+ * @return Sine in Q15 format, with an error below 0.1%.
+ */
+static int32_t sine_get(uint16_t phase)
+{
+    int32_t x = (int16_t)phase;
+    int32_t y;
+
+    // 4 * x * (1 - |x|), with x in [-1, 1) for [-pi, pi).
+    y = __SSAT((x * (32768 - ((x < 0) ? -x : x))) >> 13, 16);
+    // y + 0.225 * (y * |y| - y)
+    y += ((((y * ((y < 0) ? -y : y)) >> 15) - y) * SINE_REFINE_Q15) >> 15;
+    return y;
+}
+
+
+/**@brief Function for adding a mono sample to a stereo frame, with the gains of a source.
+ */
+static __INLINE uint32_t frame_mix(uint32_t frame, int32_t sample, source_t const * p_src)
+{
+    int32_t left  = (sample * p_src->config.gain_left)  >> 15;
+    int32_t right = (sample * p_src->config.gain_right) >> 15;
+
+    return __QADD16(frame, __PKHBT(left, right, 16));
+}
+
+
+/**@brief Function for mixing a block of PCM samples.
+ *
+ * @retval false If the samples have ended.
+ */
+static bool pcm_mix(source_t * p_src, uint32_t * p_block)
+{
+    int16_t const * p_samples = p_src->config.params.pcm.p_samples;
+    uint32_t        length    = p_src->config.params.pcm.length;
+    bool            loop      = p_src->config.params.pcm.loop;
+
+    for (uint32_t i = 0; i < AUDIO_OUT_CONFIG_BLOCK_FRAMES; i++)
+    {
+        uint32_t next;
+        uint32_t weight;
+        int32_t  sample;
+
+        if (p_src->pos >= length)
+        {
+            if (!loop)
+            {
+                return false;
+            }
+            p_src->pos %= length;
+        }
+
+        next = p_src->pos + 1;
+        if (next >= length)
+        {
+            next = loop ? 0 : p_src->pos;
+        }
+
+        // Linear interpolation: a * (1 - f) + b * f, both products in one instruction.
+        weight = p_src->frac >> 1;
+        sample = (int32_t)__SMLAD(__PKHBT((uint16_t)p_samples[p_src->pos], p_samples[next], 16),
+                                  __PKHBT(0x7FFF - weight, weight, 16),
+                                  0) >> 15;
+
+        p_src->frac += p_src->step;
+        p_src->pos  += p_src->frac >> 16;
+        p_src->frac &= 0xFFFF;
+
+        p_block[i] = frame_mix(p_block[i], sample, p_src);
+    }
+    return true;
+}
+
+
+/**@brief Function for starting the next segment of the envelope of a tone.
+ *
+ * @retval false If the tone has ended.
+ */
+static bool envelope_next(source_t * p_src)
+{
+    audio_out_envelope_point_t const * p_point;
+
+    if ((p_src->config.params.tone.p_envelope == NULL) ||
+        (p_src->point >= p_src->config.params.tone.envelope_points))
+    {
+        return false;
+    }
+
+    p_point = &p_src->config.params.tone.p_envelope[p_src->point++];
+    p_src->frames_left = frames_get(p_point->duration_ms);
+    p_src->level_step  = (((int32_t)p_point->level << 16) - p_src->level) / (int32_t)p_src->frames_left;
+    return true;
+}
+
+
+/**@brief Function for mixing a block of a tone.
+ *
+ * @retval false If the tone has ended.
+ */
+static bool tone_mix(source_t * p_src, uint32_t * p_block)
+{
+    for (uint32_t i = 0; i < AUDIO_OUT_CONFIG_BLOCK_FRAMES; i++)
+    {
+        int32_t sample;
+
+        if (!p_src->endless)
+        {
+            if ((p_src->frames_left == 0) && !envelope_next(p_src))
+            {
+                return false;
+            }
+            p_src->frames_left--;
+        }
+
+        sample = (sine_get(p_src->pos >> 16) * (p_src->level >> 16)) >> 15;
+        p_src->pos   += p_src->step;
+        p_src->level += p_src->level_step;
+
+        p_block[i] = frame_mix(p_block[i], sample, p_src);
+    }
+    return true;
+}
+
+
+static void block_render(uint32_t * p_block)
+{
+    memset(p_block, 0, AUDIO_OUT_CONFIG_BLOCK_FRAMES * sizeof(uint32_t));
+
+    for (uint32_t i = 0; i < AUDIO_OUT_CONFIG_SOURCE_COUNT; i++)
+    {
+        source_t * p_src = &m_sources[i];
+        bool       playing;
+
+        if (p_src->state == SOURCE_STOPPING)
+        {
+            p_src->state = SOURCE_IDLE;
+            continue;
+        }
+        if (p_src->state != SOURCE_ACTIVE)
+        {
+            continue;
+        }
+
+        if (p_src->config.type == AUDIO_OUT_SOURCE_PCM)
+        {
+            playing = pcm_mix(p_src, p_block);
+        }
+        else
+        {
+            playing = tone_mix(p_src, p_block);
+        }
+
+        if (!playing)
+        {
+            p_src->state = SOURCE_IDLE;
+            if (m_cb.p_config->done != NULL)
+            {
+                m_cb.p_config->done((audio_out_source_id_t)i);
+            }
+        }
+    }
+}
+
+
+/**@brief Mixer, in the SWI. Renders all released blocks. */
+static void render_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    while (m_cb.free > 0)
+    {
+        block_render(m_blocks[m_cb.render_idx]);
+        m_cb.render_idx = (m_cb.render_idx + 1) % AUDIO_OUT_CONFIG_BLOCK_COUNT;
+
+        CRITICAL_REGION_ENTER();
+        m_cb.free--;
+        m_cb.ready++;
+        CRITICAL_REGION_EXIT();
+    }
+}
+
+
+/**@brief Function for handing the next rendered block to the interface, in the I2S interrupt.
+ */
+static uint32_t * tx_buffer_request(void)
+{
+    uint32_t * p_next   = NULL;
+    int8_t     released = m_cb.queued[0];
+
+    m_cb.queued[0] = m_cb.queued[1];
+    m_cb.queued[1] = NO_BLOCK;
+
+    if (m_cb.ready > 0)
+    {
+        m_cb.queued[1] = m_cb.hand_idx;
+        p_next = m_blocks[m_cb.hand_idx];
+        m_cb.hand_idx = (m_cb.hand_idx + 1) % AUDIO_OUT_CONFIG_BLOCK_COUNT;
+        m_cb.ready--;
+    }
+
+    if (released != NO_BLOCK)
+    {
+        m_cb.free++;
+        nrf_drv_swi_channel_trigger(&m_cb.swi);
+    }
+    return p_next;
+}
+
+
+/**@brief I2S data handler, called only when no block was rendered in time. */
+static void data_handler(uint32_t const * p_data_received,
+                         uint32_t       * p_data_to_send,
+                         uint16_t         number_of_words)
+{
+    UNUSED_PARAMETER(p_data_received);
+
+    if (p_data_to_send != NULL)
+    {
+        memset(p_data_to_send, 0, number_of_words * sizeof(uint32_t));
+        m_cb.underruns++;
+    }
+}
+
+
+ret_code_t audio_out_init(audio_out_config_t const * p_config)
+{
+    ret_code_t err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_config);
+
+    if ((p_config->i2s.sample_width != NRF_I2S_SWIDTH_16BIT) ||
+        (p_config->i2s.channels != NRF_I2S_CHANNELS_STEREO) ||
+        (p_config->sample_rate == 0))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    memset(&m_cb, 0, sizeof(m_cb));
+    memset(m_sources, 0, sizeof(m_sources));
+    m_cb.p_config = p_config;
+
+    err_code = nrf_drv_swi_channel_alloc(&m_cb.swi, render_handler, NULL,
+                                         AUDIO_OUT_CONFIG_IRQ_PRIORITY);
+    VERIFY_SUCCESS(err_code);
+
+    err_code = nrf_drv_i2s_init(&p_config->i2s, data_handler);
+    if (err_code != NRF_SUCCESS)
+    {
+        nrf_drv_swi_channel_free(&m_cb.swi);
+        return err_code;
+    }
+
+    nrf_drv_i2s_tx_buffer_request_handler_set(tx_buffer_request);
+    return NRF_SUCCESS;
+}
+
+
+void audio_out_uninit(void)
+{
+    nrf_drv_i2s_uninit();
+    nrf_drv_i2s_tx_buffer_request_handler_set(NULL);
+    nrf_drv_swi_channel_free(&m_cb.swi);
+}
+
+
+ret_code_t audio_out_start(void)
+{
+    m_cb.render_idx = 0;
+    m_cb.hand_idx   = 0;
+    m_cb.ready      = 0;
+    m_cb.free       = AUDIO_OUT_CONFIG_BLOCK_COUNT;
+    m_cb.queued[0]  = NO_BLOCK;
+    m_cb.queued[1]  = NO_BLOCK;
+
+    // Called from the main context, the mixer renders all blocks before the transfer starts.
+    nrf_drv_swi_channel_trigger(&m_cb.swi);
+
+    return nrf_drv_i2s_start(NULL, m_silence, ARRAY_SIZE(m_silence), 0);
+}
+
+
+void audio_out_stop(void)
+{
+    nrf_drv_i2s_stop();
+}
+
+
+ret_code_t audio_out_source_play(audio_out_source_t const * p_source, audio_out_source_id_t * p_id)
+{
+    source_t * p_src = NULL;
+
+    VERIFY_PARAM_NOT_NULL(p_source);
+    VERIFY_PARAM_NOT_NULL(p_id);
+
+    if (p_source->type == AUDIO_OUT_SOURCE_PCM)
+    {
+        VERIFY_PARAM_NOT_NULL(p_source->params.pcm.p_samples);
+        if ((p_source->params.pcm.length == 0) || (p_source->params.pcm.sample_rate == 0))
+        {
+            return NRF_ERROR_INVALID_PARAM;
+        }
+    }
+    else if ((p_source->type != AUDIO_OUT_SOURCE_TONE) ||
+             ((p_source->params.tone.p_envelope != NULL) &&
+              (p_source->params.tone.envelope_points == 0)))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    CRITICAL_REGION_ENTER();
+    for (uint32_t i = 0; i < AUDIO_OUT_CONFIG_SOURCE_COUNT; i++)
+    {
+        if (m_sources[i].state == SOURCE_IDLE)
+        {
+            m_sources[i].state = SOURCE_PENDING;
+            p_src = &m_sources[i];
+            *p_id = (audio_out_source_id_t)i;
+            break;
+        }
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (p_src == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    p_src->config = *p_source;
+    p_src->pos    = 0;
+    p_src->frac   = 0;
+    p_src->point  = 0;
+    p_src->level_step = 0;
+
+    if (p_source->type == AUDIO_OUT_SOURCE_PCM)
+    {
+        p_src->step = (uint32_t)(((uint64_t)p_source->params.pcm.sample_rate << 16) /
+                                 m_cb.p_config->sample_rate);
+    }
+    else
+    {
+        p_src->step = (uint32_t)(((uint64_t)p_source->params.tone.frequency << 32) /
+                                 m_cb.p_config->sample_rate);
+        if (p_source->params.tone.p_envelope != NULL)
+        {
+            // The first segment is started by the mixer, from silence.
+            p_src->level       = 0;
+            p_src->frames_left = 0;
+            p_src->endless     = false;
+        }
+        else
+        {
+            p_src->level       = (int32_t)p_source->params.tone.amplitude << 16;
+            p_src->endless     = (p_source->params.tone.duration_ms == 0);
+            p_src->frames_left = p_src->endless ? 0 : frames_get(p_source->params.tone.duration_ms);
+        }
+    }
+
+    __DMB();
+    p_src->state = SOURCE_ACTIVE;
+    return NRF_SUCCESS;
+}
+
+
+void audio_out_source_stop(audio_out_source_id_t id)
+{
+    ASSERT(id < AUDIO_OUT_CONFIG_SOURCE_COUNT);
+
+    CRITICAL_REGION_ENTER();
+    if (m_sources[id].state == SOURCE_ACTIVE)
+    {
+        m_sources[id].state = SOURCE_STOPPING;
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+
+void audio_out_source_gain_set(audio_out_source_id_t id, int16_t gain_left, int16_t gain_right)
+{
+    ASSERT(id < AUDIO_OUT_CONFIG_SOURCE_COUNT);
+
+    m_sources[id].config.gain_left  = gain_left;
+    m_sources[id].config.gain_right = gain_right;
+}
+
+
+uint32_t audio_out_underrun_get(void)
+{
+    return m_cb.underruns;
+}
+
+#endif // NRF_MODULE_ENABLED(AUDIO_OUT)
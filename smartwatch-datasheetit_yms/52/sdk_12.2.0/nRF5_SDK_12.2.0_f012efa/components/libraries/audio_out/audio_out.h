@@ -0,0 +1,207 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup audio_out I2S audio output
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for mixing sound and haptic sources to the I2S interface.
+ *
+ * @details Sources are PCM samples, read in place from flash or from the external memory mapped
+ *          by @ref xip_asset, and synthesized tones. A tone can follow an amplitude envelope,
+ *          which makes it a haptic waveform for an LRA amplifier on one of the channels.
+ *
+ *          The sources are mixed into blocks of 16-bit stereo frames in a software interrupt of
+ *          low priority, ahead of time: @ref AUDIO_OUT_CONFIG_BLOCK_COUNT blocks are rendered
+ *          before the transfer starts, and a block is rendered again as soon as the interface
+ *          has sent it. The I2S interrupt only hands the next rendered block to the interface,
+ *          with @ref nrf_drv_i2s_tx_buffer_request_handler_set. If no block is rendered in time,
+ *          silence is sent and @ref audio_out_underrun_get is incremented.
+ *
+ * @note The SWI driver must be initialized before @ref audio_out_init is called. The I2S
+ *       interface must be configured for 16-bit stereo samples: the left sample is in the lower
+ *       half-word of a frame.
+ */
+
+#ifndef AUDIO_OUT_H__
+#define AUDIO_OUT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nrf_drv_i2s.h"
+#include "app_util_platform.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of stereo frames in a block.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef AUDIO_OUT_CONFIG_BLOCK_FRAMES
+#define AUDIO_OUT_CONFIG_BLOCK_FRAMES 128
+#endif
+
+/** @brief Number of blocks. Two are held by the I2S interface, the others are rendered ahead.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef AUDIO_OUT_CONFIG_BLOCK_COUNT
+#define AUDIO_OUT_CONFIG_BLOCK_COUNT 4
+#endif
+
+/** @brief Maximum number of sources played at the same time.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef AUDIO_OUT_CONFIG_SOURCE_COUNT
+#define AUDIO_OUT_CONFIG_SOURCE_COUNT 4
+#endif
+
+/** @brief Interrupt priority of the mixer. Lower than the priority of the I2S interrupt.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef AUDIO_OUT_CONFIG_IRQ_PRIORITY
+#define AUDIO_OUT_CONFIG_IRQ_PRIORITY APP_IRQ_PRIORITY_LOWEST
+#endif
+
+/**@brief Identifier of a playing source. */
+typedef uint8_t audio_out_source_id_t;
+
+/**@brief Source types. */
+typedef enum
+{
+    AUDIO_OUT_SOURCE_PCM,  /**< Mono 16-bit PCM samples, resampled to the output rate. */
+    AUDIO_OUT_SOURCE_TONE, /**< Sine tone, with an optional amplitude envelope. */
+} audio_out_source_type_t;
+
+/**@brief Point of an amplitude envelope. The amplitude ramps linearly to the level of the point. */
+typedef struct
+{
+    uint16_t duration_ms; /**< Duration of the ramp. */
+    int16_t  level;       /**< Amplitude at the end of the ramp, in Q15 format. */
+} audio_out_envelope_point_t;
+
+/**@brief Source configuration. */
+typedef struct
+{
+    audio_out_source_type_t type;
+    int16_t                 gain_left;  /**< Gain on the left channel, in Q15 format. */
+    int16_t                 gain_right; /**< Gain on the right channel, in Q15 format. */
+    union
+    {
+        struct
+        {
+            int16_t const * p_samples;   /**< Samples, in flash, RAM, or the XIP region of QSPI. Read while the source plays. */
+            uint32_t        length;      /**< Number of samples. */
+            uint32_t        sample_rate; /**< Sample rate of the samples, in Hz. */
+            bool            loop;        /**< Play the samples again from the start until stopped. */
+        } pcm;
+        struct
+        {
+            uint16_t                           frequency;       /**< Frequency, in Hz. For an LRA, its resonant frequency. */
+            int16_t                            amplitude;       /**< Amplitude in Q15 format, if there is no envelope. */
+            uint32_t                           duration_ms;     /**< Duration if there is no envelope, 0 to play until stopped. */
+            audio_out_envelope_point_t const * p_envelope;      /**< Envelope starting from 0, or NULL. The tone ends with the envelope. Read while the source plays. */
+            uint8_t                            envelope_points; /**< Number of points of the envelope. */
+        } tone;
+    } params;
+} audio_out_source_t;
+
+/**@brief Handler for notifying the application that a source has ended.
+ *
+ * Called from the mixer interrupt. Not called for sources stopped with @ref audio_out_source_stop.
+ *
+ * @param[in] id Identifier of the source.
+ */
+typedef void (* audio_out_done_handler_t)(audio_out_source_id_t id);
+
+/**@brief Module configuration. */
+typedef struct
+{
+    nrf_drv_i2s_config_t     i2s;         /**< I2S driver configuration, with 16-bit stereo samples. */
+    uint32_t                 sample_rate; /**< Sample rate of the I2S configuration, in Hz. */
+    audio_out_done_handler_t done;        /**< Handler called when a source has ended, or NULL. */
+} audio_out_config_t;
+
+/**@brief Function for initializing the module and the I2S driver.
+ *
+ * @param[in] p_config Module configuration. Kept by the module.
+ *
+ * @retval NRF_SUCCESS             If the module was initialized.
+ * @retval NRF_ERROR_NULL          If p_config was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If the samples are not 16-bit stereo, or the sample rate is 0.
+ * @retval NRF_ERROR_NO_MEM        If no SWI channel is available.
+ * @return Any error returned by @ref nrf_drv_i2s_init.
+ */
+ret_code_t audio_out_init(audio_out_config_t const * p_config);
+
+/**@brief Function for uninitializing the module and the I2S driver. */
+void audio_out_uninit(void);
+
+/**@brief Function for starting the output.
+ *
+ * @details All blocks are rendered before the transfer is started.
+ *
+ * @return Any error returned by @ref nrf_drv_i2s_start.
+ */
+ret_code_t audio_out_start(void);
+
+/**@brief Function for stopping the output. Playing sources are kept. */
+void audio_out_stop(void);
+
+/**@brief Function for starting to play a source.
+ *
+ * @details The source is mixed from the next block that is rendered.
+ *
+ * @param[in]  p_source Source configuration. Copied by the module.
+ * @param[out] p_id     Identifier of the source.
+ *
+ * @retval NRF_SUCCESS             If the source was added.
+ * @retval NRF_ERROR_NULL          If a pointer was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If the source is not valid.
+ * @retval NRF_ERROR_NO_MEM        If @ref AUDIO_OUT_CONFIG_SOURCE_COUNT sources are playing.
+ */
+ret_code_t audio_out_source_play(audio_out_source_t const * p_source, audio_out_source_id_t * p_id);
+
+/**@brief Function for stopping a source.
+ *
+ * @details The source is removed when the next block is rendered.
+ *
+ * @param[in] id Identifier of the source.
+ */
+void audio_out_source_stop(audio_out_source_id_t id);
+
+/**@brief Function for changing the gains of a playing source.
+ *
+ * @param[in] id         Identifier of the source.
+ * @param[in] gain_left  Gain on the left channel, in Q15 format.
+ * @param[in] gain_right Gain on the right channel, in Q15 format.
+ */
+void audio_out_source_gain_set(audio_out_source_id_t id, int16_t gain_left, int16_t gain_right);
+
+/**@brief Function for getting the number of blocks of silence sent because no block was rendered.
+ */
+uint32_t audio_out_underrun_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_OUT_H__
+
+/** @} */
@@ -0,0 +1,47 @@
+/**
+ *
+ * @defgroup audio_out_config audio_out module configuration
+ * @{
+ * @ingroup audio_out
+ */
+/** @brief Enabling audio_out module
+ *
+ *  Requires the I2S and SWI drivers.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define AUDIO_OUT_ENABLED
+
+/** @brief Number of stereo frames in a block.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define AUDIO_OUT_CONFIG_BLOCK_FRAMES
+
+/** @brief Number of blocks. At least 3.
+ *
+ *  Two blocks are held by the I2S interface. The latency of a new source is about the
+ *  duration of all blocks.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define AUDIO_OUT_CONFIG_BLOCK_COUNT
+
+/** @brief Maximum number of sources played at the same time.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define AUDIO_OUT_CONFIG_SOURCE_COUNT
+
+/** @brief Interrupt priority of the mixer.
+ *
+ *  Lower than the priority of the I2S interrupt.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define AUDIO_OUT_CONFIG_IRQ_PRIORITY
+
+
+/** @} */
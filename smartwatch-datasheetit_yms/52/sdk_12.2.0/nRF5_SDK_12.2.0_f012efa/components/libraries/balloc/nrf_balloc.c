@@ -133,7 +133,7 @@ __STATIC_INLINE void * nrf_balloc_element_wrap(nrf_balloc_t const * p_pool, void
  *
  * @return      Pointer to the beginning of the block.
  */
-static void * nrf_balloc_idx2block(nrf_balloc_t const * p_pool, uint8_t idx)
+static void * nrf_balloc_idx2block(nrf_balloc_t const * p_pool, nrf_balloc_idx_t idx)
 {
     ASSERT(p_pool != NULL);
     return (uint8_t *)(p_pool->p_memory_begin) + ((size_t)(idx) * p_pool->block_size);
@@ -146,7 +146,7 @@ static void * nrf_balloc_idx2block(nrf_balloc_t const * p_pool, uint8_t idx)
  *
  * @return      Index of the block.
  */
-static uint8_t nrf_balloc_block2idx(nrf_balloc_t const * p_pool, void const * p_block)
+static nrf_balloc_idx_t nrf_balloc_block2idx(nrf_balloc_t const * p_pool, void const * p_block)
 {
     ASSERT(p_pool != NULL);
     return ((size_t)(p_block) - (size_t)(p_pool->p_memory_begin)) / p_pool->block_size;
@@ -177,59 +177,55 @@ ret_code_t nrf_balloc_init(nrf_balloc_t const * p_pool)
 #endif
 
     p_pool->p_cb->p_stack_pointer = p_pool->p_stack_base;
-    uint8_t pool_size = p_pool->p_stack_limit - p_pool->p_stack_base;
+    nrf_balloc_idx_t pool_size = p_pool->p_stack_limit - p_pool->p_stack_base;
     while (pool_size--)
     {
         *(p_pool->p_cb->p_stack_pointer)++ = pool_size;
     }
 
     p_pool->p_cb->max_utilization = 0;
+#if NRF_BALLOC_CONFIG_DEFERRED_FREE_ENABLED
+    p_pool->p_cb->p_return_head   = NULL;
+#endif
 
     return NRF_SUCCESS;
 }
 
-void * nrf_balloc_alloc(nrf_balloc_t const * p_pool)
+/**@brief  Take a block from the allocation stack. Must be called with exclusive access to the pool.
+ *
+ * @param[in]   p_pool      Pointer to the memory pool.
+ *
+ * @return      Pointer to the beginning of the block or NULL if the pool is empty.
+ */
+static void * nrf_balloc_block_pop(nrf_balloc_t const * p_pool)
 {
-    ASSERT(p_pool != NULL);
-
     void * p_block = NULL;
 
-    CRITICAL_REGION_ENTER();
-
     if (p_pool->p_cb->p_stack_pointer > p_pool->p_stack_base)
     {
         // Allocate block.
         p_block = nrf_balloc_idx2block(p_pool, *--(p_pool->p_cb->p_stack_pointer));
 
         // Update utilization statistics.
-        uint8_t utilization = p_pool->p_stack_limit - p_pool->p_cb->p_stack_pointer;
+        nrf_balloc_idx_t utilization = p_pool->p_stack_limit - p_pool->p_cb->p_stack_pointer;
         if (p_pool->p_cb->max_utilization < utilization)
         {
             p_pool->p_cb->max_utilization = utilization;
         }
     }
 
-    CRITICAL_REGION_EXIT();
-
-#if NRF_BALLOC_CONFIG_DEBUG_ENABLED
-    if (p_block != NULL)
-    {
-        p_block = nrf_balloc_block_unwrap(p_pool, p_block);
-    }
-#endif
-
-    NRF_LOG_DEBUG("nrf_balloc_alloc(p_pool: %p, p_element: %p)\r\n",
-                  (uint32_t)p_pool, (uint32_t)p_block);
     return p_block;
 }
 
-void nrf_balloc_free(nrf_balloc_t const * p_pool, void * p_element)
+/**@brief  Validate an element that is being freed and calculate pointer to its block.
+ *
+ * @param[in]   p_pool      Pointer to the memory pool.
+ * @param[in]   p_element   Element to be freed.
+ *
+ * @return      Pointer to the beginning of the block.
+ */
+static void * nrf_balloc_element_release(nrf_balloc_t const * p_pool, void * p_element)
 {
-    ASSERT(p_pool != NULL);
-    ASSERT(p_element != NULL)
-    NRF_LOG_DEBUG("nrf_balloc_free(p_pool: %p, p_element: %p)\r\n",
-                  (uint32_t)p_pool, (uint32_t)p_element);
-
 #if NRF_BALLOC_CONFIG_DEBUG_ENABLED
     void * p_block = nrf_balloc_element_wrap(p_pool, p_element);
 
@@ -252,12 +248,21 @@ void nrf_balloc_free(nrf_balloc_t const * p_pool, void * p_element)
             APP_ERROR_CHECK_BOOL(false);
         }
     }
+
+    return p_block;
 #else
-    void * p_block = p_element;
+    return p_element;
 #endif // NRF_BALLOC_CONFIG_DEBUG_ENABLED
+}
 
-    CRITICAL_REGION_ENTER();
-
+/**@brief  Put a block back on the allocation stack. Must be called with exclusive access to the pool.
+ *
+ * @param[in]   p_pool      Pointer to the memory pool.
+ * @param[in]   p_block     Pointer to the beginning of the block.
+ * @param[in]   p_element   Element that is being freed, for logging.
+ */
+static void nrf_balloc_block_push(nrf_balloc_t const * p_pool, void * p_block, void * p_element)
+{
 #if NRF_BALLOC_CONFIG_DEBUG_ENABLED
     // These checks have to be done in critical region as they use p_pool->p_stack_pointer.
     if (NRF_BALLOC_DEBUG_BASIC_CHECKS_GET(p_pool->debug_flags))
@@ -274,7 +279,7 @@ void nrf_balloc_free(nrf_balloc_t const * p_pool, void * p_element)
     if (NRF_BALLOC_DEBUG_DOUBLE_FREE_CHECK_GET(p_pool->debug_flags))
     {
         // Check for double free.
-        for (uint8_t * p_idx = p_pool->p_stack_base; p_idx < p_pool->p_cb->p_stack_pointer; p_idx++)
+        for (nrf_balloc_idx_t * p_idx = p_pool->p_stack_base; p_idx < p_pool->p_cb->p_stack_pointer; p_idx++)
         {
             if (nrf_balloc_idx2block(p_pool, *p_idx) == p_block)
             {
@@ -284,11 +289,140 @@ void nrf_balloc_free(nrf_balloc_t const * p_pool, void * p_element)
             }
         }
     }
+#else
+    UNUSED_PARAMETER(p_element);
 #endif // NRF_BALLOC_CONFIG_DEBUG_ENABLED
 
     // Free the element.
     *(p_pool->p_cb->p_stack_pointer)++ = nrf_balloc_block2idx(p_pool, p_block);
+}
+
+#if NRF_BALLOC_CONFIG_DEFERRED_FREE_ENABLED
+/**@brief  Put an element freed outside the owner priority on the return list.
+ *
+ * @details The first word of the element holds the next element on the list. The list head is
+ *          updated with LDREX/STREX. The exclusive monitor is cleared on every exception entry and
+ *          return, so an update interrupted by another free is retried.
+ *
+ * @param[in]   p_pool      Pointer to the memory pool.
+ * @param[in]   p_element   Element to be freed.
+ */
+static void nrf_balloc_return_list_put(nrf_balloc_t const * p_pool, void * p_element)
+{
+    uint32_t volatile * p_head = (uint32_t volatile *)&p_pool->p_cb->p_return_head;
+
+#if (__CORTEX_M >= 0x03U)
+    do
+    {
+        *(uint32_t *)p_element = __LDREXW(p_head);
+    } while (__STREXW((uint32_t)p_element, p_head) != 0);
+#else
+    CRITICAL_REGION_ENTER();
+    *(uint32_t *)p_element = *p_head;
+    *p_head                = (uint32_t)p_element;
+    CRITICAL_REGION_EXIT();
+#endif
+}
 
+/**@brief  Move all elements from the return list back to the allocation stack. Must be called at
+ *         the owner priority.
+ *
+ * @param[in]   p_pool      Pointer to the memory pool.
+ */
+static void nrf_balloc_return_list_reclaim(nrf_balloc_t const * p_pool)
+{
+    uint32_t volatile * p_head = (uint32_t volatile *)&p_pool->p_cb->p_return_head;
+    uint32_t            element;
+
+    if (*p_head == 0)
+    {
+        return;
+    }
+
+#if (__CORTEX_M >= 0x03U)
+    do
+    {
+        element = __LDREXW(p_head);
+    } while (__STREXW(0, p_head) != 0);
+#else
+    CRITICAL_REGION_ENTER();
+    element = *p_head;
+    *p_head = 0;
+    CRITICAL_REGION_EXIT();
+#endif
+
+    while (element != 0)
+    {
+        void * p_element = (void *)element;
+
+        // Read the link before the debug checks fill the block.
+        element = *(uint32_t *)p_element;
+        nrf_balloc_block_push(p_pool, nrf_balloc_element_release(p_pool, p_element), p_element);
+    }
+}
+#endif // NRF_BALLOC_CONFIG_DEFERRED_FREE_ENABLED
+
+void * nrf_balloc_alloc(nrf_balloc_t const * p_pool)
+{
+    ASSERT(p_pool != NULL);
+
+    void * p_block;
+
+#if NRF_BALLOC_CONFIG_DEFERRED_FREE_ENABLED
+    if (p_pool->owner != NRF_BALLOC_OWNER_ANY)
+    {
+        ASSERT(current_int_priority_get() == p_pool->owner);
+
+        nrf_balloc_return_list_reclaim(p_pool);
+        p_block = nrf_balloc_block_pop(p_pool);
+    }
+    else
+#endif // NRF_BALLOC_CONFIG_DEFERRED_FREE_ENABLED
+    {
+        CRITICAL_REGION_ENTER();
+        p_block = nrf_balloc_block_pop(p_pool);
+        CRITICAL_REGION_EXIT();
+    }
+
+#if NRF_BALLOC_CONFIG_DEBUG_ENABLED
+    if (p_block != NULL)
+    {
+        p_block = nrf_balloc_block_unwrap(p_pool, p_block);
+    }
+#endif
+
+    NRF_LOG_DEBUG("nrf_balloc_alloc(p_pool: %p, p_element: %p)\r\n",
+                  (uint32_t)p_pool, (uint32_t)p_block);
+    return p_block;
+}
+
+void nrf_balloc_free(nrf_balloc_t const * p_pool, void * p_element)
+{
+    ASSERT(p_pool != NULL);
+    ASSERT(p_element != NULL)
+    NRF_LOG_DEBUG("nrf_balloc_free(p_pool: %p, p_element: %p)\r\n",
+                  (uint32_t)p_pool, (uint32_t)p_element);
+
+#if NRF_BALLOC_CONFIG_DEFERRED_FREE_ENABLED
+    if (p_pool->owner != NRF_BALLOC_OWNER_ANY)
+    {
+        if (current_int_priority_get() == p_pool->owner)
+        {
+            nrf_balloc_block_push(p_pool, nrf_balloc_element_release(p_pool, p_element), p_element);
+        }
+        else
+        {
+            // The debug checks are done by the owner when the element is reclaimed.
+            nrf_balloc_return_list_put(p_pool, p_element);
+        }
+        return;
+    }
+#endif // NRF_BALLOC_CONFIG_DEFERRED_FREE_ENABLED
+
+    void * p_block = nrf_balloc_element_release(p_pool, p_element);
+
+    CRITICAL_REGION_ENTER();
+    nrf_balloc_block_push(p_pool, p_block, p_element);
     CRITICAL_REGION_EXIT();
 }
 
@@ -60,34 +60,59 @@ extern "C" {
     #define NRF_BALLOC_DEFAULT_DEBUG_FLAGS   0
 #endif // NRF_BALLOC_CONFIG_DEBUG_ENABLED
 
+#ifndef NRF_BALLOC_CONFIG_LARGE_POOLS_ENABLED
+#define NRF_BALLOC_CONFIG_LARGE_POOLS_ENABLED 0
+#endif
+
+/**@brief Index of a block in the pool. Its size limits the number of blocks in one pool. */
+#if NRF_BALLOC_CONFIG_LARGE_POOLS_ENABLED
+typedef uint16_t nrf_balloc_idx_t;
+#define NRF_BALLOC_POOL_SIZE_MAX    UINT16_MAX  //!< Maximum number of blocks in one pool.
+#else
+typedef uint8_t nrf_balloc_idx_t;
+#define NRF_BALLOC_POOL_SIZE_MAX    UINT8_MAX   //!< Maximum number of blocks in one pool.
+#endif // NRF_BALLOC_CONFIG_LARGE_POOLS_ENABLED
+
+#ifndef NRF_BALLOC_CONFIG_DEFERRED_FREE_ENABLED
+#define NRF_BALLOC_CONFIG_DEFERRED_FREE_ENABLED 0
+#endif
+
+#define NRF_BALLOC_OWNER_ANY        0xFF        //!< Pool can be used from any priority. Every operation runs in a critical region.
+
 /**@brief Block memory allocator control block.*/
 typedef struct
 {
-    uint8_t * p_stack_pointer;          //!< Current allocation stack pointer.
-    uint8_t   max_utilization;          //!< Maximum utilization of the memory pool.
+    nrf_balloc_idx_t * p_stack_pointer; //!< Current allocation stack pointer.
+    nrf_balloc_idx_t   max_utilization; //!< Maximum utilization of the memory pool.
+#if NRF_BALLOC_CONFIG_DEFERRED_FREE_ENABLED
+    void * volatile    p_return_head;   //!< Elements freed from other priorities, waiting to be reclaimed by the owner.
+#endif
 } nrf_balloc_cb_t;
 
 /**@brief Block memory allocator pool instance. The pool is made of elements of the same size. */
 typedef struct
 {
-    nrf_balloc_cb_t * p_cb;             //!< Pointer to the instance control block.
-    uint8_t         * p_stack_base;     //!< Base of the allocation stack.
+    nrf_balloc_cb_t  * p_cb;            //!< Pointer to the instance control block.
+    nrf_balloc_idx_t * p_stack_base;    //!< Base of the allocation stack.
                                         /**<
                                          * Stack is used to store handlers to not allocated elements.
                                          */
-    uint8_t         * p_stack_limit;    //!< Maximum possible value of the allocation stack pointer.
-    void            * p_memory_begin;   //!< Pointer to the start of the memory pool.
+    nrf_balloc_idx_t * p_stack_limit;   //!< Maximum possible value of the allocation stack pointer.
+    void             * p_memory_begin;  //!< Pointer to the start of the memory pool.
                                         /**<
                                          * Memory is used as a heap for blocks.
                                          */
 #if NRF_BALLOC_CONFIG_DEBUG_ENABLED
-    void            * p_memory_end;     //!< Pointer to the end of the memory pool.
-    uint32_t          debug_flags;      //!< Debugging settings.
+    void             * p_memory_end;    //!< Pointer to the end of the memory pool.
+    uint32_t           debug_flags;     //!< Debugging settings.
                                         /**<
                                          * Debug flag should be created by @ref NRF_BALLOC_DEBUG.
                                          */
 #endif // NRF_BALLOC_CONFIG_DEBUG_ENABLED
-    uint16_t          block_size;       //!< Size of the allocated block (including debug overhead).
+#if NRF_BALLOC_CONFIG_DEFERRED_FREE_ENABLED
+    uint8_t            owner;           //!< Interrupt priority that allocates from the pool, or @ref NRF_BALLOC_OWNER_ANY.
+#endif
+    uint16_t           block_size;      //!< Size of the allocated block (including debug overhead).
                                         /**<
                                          * Single block contains user element with header and tail 
                                          * words.
@@ -112,7 +137,13 @@ typedef struct
                 ALIGN_NUM(sizeof(uint32_t), (_element_size))
 #endif // NRF_BALLOC_CONFIG_DEBUG_ENABLED
 
-/**@brief Create a block allocator instance with custom debug flags.
+#if NRF_BALLOC_CONFIG_DEFERRED_FREE_ENABLED
+    #define NRF_BALLOC_OWNER_INIT(_owner)   .owner = (_owner),
+#else
+    #define NRF_BALLOC_OWNER_INIT(_owner)
+#endif // NRF_BALLOC_CONFIG_DEFERRED_FREE_ENABLED
+
+/**@brief Create a block allocator instance with custom debug flags and owner.
  *
  * @note  This macro reserves memory for the given block allocator instance.
  *
@@ -120,11 +151,13 @@ typedef struct
  * @param[in]   _element_size   Size of one element.
  * @param[in]   _pool_size      Size of the pool.
  * @param[in]   _debug_flags    Debug flags (@ref NRF_BALLOC_DEBUG).
+ * @param[in]   _owner          Interrupt priority that allocates from the pool, or
+ *                              @ref NRF_BALLOC_OWNER_ANY.
  */
 #if NRF_BALLOC_CONFIG_DEBUG_ENABLED
-    #define NRF_BALLOC_DBG_DEF(_name, _element_size, _pool_size, _debug_flags)                      \
-        STATIC_ASSERT((_pool_size) <= UINT8_MAX);                                                   \
-        static uint8_t              _name##_nrf_balloc_pool_stack[(_pool_size)];                    \
+    #define NRF_BALLOC_GENERIC_DEF(_name, _element_size, _pool_size, _debug_flags, _owner)          \
+        STATIC_ASSERT((_pool_size) <= NRF_BALLOC_POOL_SIZE_MAX);                                    \
+        static nrf_balloc_idx_t     _name##_nrf_balloc_pool_stack[(_pool_size)];                    \
         static uint32_t             _name##_nrf_balloc_pool_mem                                     \
             [NRF_BALLOC_BLOCK_SIZE(_element_size, _debug_flags) * (_pool_size) / sizeof(uint32_t)]; \
         static nrf_balloc_cb_t      _name##_nrf_balloc_cb;                                          \
@@ -138,11 +171,12 @@ typedef struct
                 .p_memory_end   = (uint8_t *)_name##_nrf_balloc_pool_mem                            \
                                 + NRF_BALLOC_BLOCK_SIZE(_element_size, _debug_flags) * (_pool_size),\
                 .debug_flags    = (_debug_flags),                                                   \
+                NRF_BALLOC_OWNER_INIT(_owner)                                                       \
             }
 #else
-    #define NRF_BALLOC_DBG_DEF(_name, _element_size, _pool_size, _debug_flags)                      \
-        STATIC_ASSERT((_pool_size) <= UINT8_MAX);                                                   \
-        static uint8_t              _name##_nrf_balloc_pool_stack[(_pool_size)];                    \
+    #define NRF_BALLOC_GENERIC_DEF(_name, _element_size, _pool_size, _debug_flags, _owner)          \
+        STATIC_ASSERT((_pool_size) <= NRF_BALLOC_POOL_SIZE_MAX);                                    \
+        static nrf_balloc_idx_t     _name##_nrf_balloc_pool_stack[(_pool_size)];                    \
         static uint32_t             _name##_nrf_balloc_pool_mem                                     \
             [NRF_BALLOC_BLOCK_SIZE(_element_size, _debug_flags) * (_pool_size) / sizeof(uint32_t)]; \
         static nrf_balloc_cb_t      _name##_nrf_balloc_cb;                                          \
@@ -153,9 +187,22 @@ typedef struct
                 .p_stack_limit  = _name##_nrf_balloc_pool_stack + (_pool_size),                     \
                 .p_memory_begin = _name##_nrf_balloc_pool_mem,                                      \
                 .block_size     = NRF_BALLOC_BLOCK_SIZE(_element_size, _debug_flags),               \
+                NRF_BALLOC_OWNER_INIT(_owner)                                                       \
             }
 #endif // NRF_BALLOC_CONFIG_DEBUG_ENABLED
 
+/**@brief Create a block allocator instance with custom debug flags.
+ *
+ * @note  This macro reserves memory for the given block allocator instance.
+ *
+ * @param[in]   _name           Name of the allocator.
+ * @param[in]   _element_size   Size of one element.
+ * @param[in]   _pool_size      Size of the pool.
+ * @param[in]   _debug_flags    Debug flags (@ref NRF_BALLOC_DEBUG).
+ */
+#define NRF_BALLOC_DBG_DEF(_name, _element_size, _pool_size, _debug_flags)         \
+            NRF_BALLOC_GENERIC_DEF(_name, _element_size, _pool_size, _debug_flags, NRF_BALLOC_OWNER_ANY)
+
 /**@brief Create a block allocator instance.
  *
  * @note  This macro reserves memory for the given block allocator instance.
@@ -167,6 +214,26 @@ typedef struct
 #define NRF_BALLOC_DEF(_name, _element_size, _pool_size)           \
             NRF_BALLOC_DBG_DEF(_name, _element_size, _pool_size, NRF_BALLOC_DEFAULT_DEBUG_FLAGS)
 
+#if NRF_BALLOC_CONFIG_DEFERRED_FREE_ENABLED
+/**@brief Create a block allocator instance owned by one interrupt priority.
+ *
+ * @details Elements are allocated only at the owner priority, which then accesses the pool without
+ *          critical regions. Elements freed at any other priority are put on a return list with
+ *          LDREX/STREX, and the owner moves them back to the pool on its next allocation.
+ *
+ * @note  This macro reserves memory for the given block allocator instance.
+ *
+ * @param[in]   _name           Name of the allocator.
+ * @param[in]   _element_size   Size of one element.
+ * @param[in]   _pool_size      Size of the pool.
+ * @param[in]   _owner          Interrupt priority that allocates from the pool, for example
+ *                              @ref APP_IRQ_PRIORITY_THREAD or the priority of the UARTE interrupt.
+ */
+#define NRF_BALLOC_OWNED_DEF(_name, _element_size, _pool_size, _owner)                          \
+            NRF_BALLOC_GENERIC_DEF(_name, _element_size, _pool_size,                            \
+                                   NRF_BALLOC_DEFAULT_DEBUG_FLAGS, (_owner))
+#endif // NRF_BALLOC_CONFIG_DEFERRED_FREE_ENABLED
+
 /**@brief Create a block allocator interface.
  *
  * @param[in]   _type    Type which is allocated.
@@ -175,7 +242,7 @@ typedef struct
 #define NRF_BALLOC_INTERFACE_DEC(_type, _name)    \
     _type * _name##_alloc(void);                  \
     void    _name##_free(_type * p_element);      \
-    uint8_t _name##_max_utilization_get(void)
+    nrf_balloc_idx_t _name##_max_utilization_get(void)
 
 /**@brief Define a custom block allocator interface.
  *
@@ -201,7 +268,7 @@ typedef struct
         nrf_balloc_free((_p_pool), p_element);                                  \
     }                                                                           \
                                                                                 \
-    _attr uint8_t _name##_max_utilization_get(void)                             \
+    _attr nrf_balloc_idx_t _name##_max_utilization_get(void)                    \
     {                                                                           \
         ASSERT((_p_pool) != NULL);                                              \
         return nrf_balloc_max_utilization_get((_p_pool));                       \
@@ -236,6 +303,7 @@ ret_code_t nrf_balloc_init(nrf_balloc_t const * p_pool);
 /**@brief Function for allocating an element from the pool.
  *
  * @note    This module guarantees that the returned memory is aligned to 4.
+ * @note    Pools defined with @ref NRF_BALLOC_OWNED_DEF must be used only at the owner priority.
  *
  * @param[in]   p_pool  Pointer to the memory pool from which the element will be allocated.
  *
@@ -244,6 +312,10 @@ ret_code_t nrf_balloc_init(nrf_balloc_t const * p_pool);
 void * nrf_balloc_alloc(nrf_balloc_t const * p_pool);
 
 /**@brief Function for freeing an element back to the pool.
+ *
+ * @details For pools defined with @ref NRF_BALLOC_OWNED_DEF, this function can be called at any
+ *          priority. Elements freed outside the owner priority are checked by the debug features
+ *          when they are reclaimed, not when they are freed.
  *
  * @param[in]   p_pool      Pointer to the memory pool.
  * @param[in]   p_element   Element to be freed.
@@ -256,7 +328,7 @@ void nrf_balloc_free(nrf_balloc_t const * p_pool, void * p_element);
  *
  * @return Maximum number of elements allocated from the pool.
  */
-__STATIC_INLINE uint8_t nrf_balloc_max_utilization_get(nrf_balloc_t const * p_pool)
+__STATIC_INLINE nrf_balloc_idx_t nrf_balloc_max_utilization_get(nrf_balloc_t const * p_pool)
 {
     ASSERT(p_pool != NULL);
     return p_pool->p_cb->max_utilization;
@@ -20,6 +20,29 @@
  */
 #define NRF_BALLOC_CONFIG_LOG_ENABLED
 
+/** @brief Enables pools with more than 255 blocks.
+ *
+ *  Block indexes are stored as 16-bit values instead of 8-bit values, so a pool
+ *  can hold up to 65535 blocks. The allocation stack of every pool doubles in size.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_BALLOC_CONFIG_LARGE_POOLS_ENABLED
+
+/** @brief Enables pools owned by one interrupt priority.
+ *
+ *  Pools defined with @ref NRF_BALLOC_OWNED_DEF are allocated from only at the
+ *  owner priority and used without critical regions. Elements freed at other
+ *  priorities are returned through a lock-free list.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_BALLOC_CONFIG_DEFERRED_FREE_ENABLED
+
 /** @brief Default Severity level
  *
  *  Following options are available:
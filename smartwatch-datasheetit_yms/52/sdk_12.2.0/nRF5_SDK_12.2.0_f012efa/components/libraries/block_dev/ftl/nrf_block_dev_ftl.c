@@ -0,0 +1,925 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "nrf_serial_flash_params.h"
+#include "nrf_block_dev_ftl.h"
+#include "crc32.h"
+
+/**@file
+ *
+ * @ingroup nrf_block_dev_ftl
+ * @{
+ *
+ * @brief This module implements block device API on a log-structured QSPI memory.
+ */
+
+#define QSPI_STD_CMD_RSTEN   0x66   /**< Reset enable command*/
+#define QSPI_STD_CMD_RST     0x99   /**< Reset command*/
+#define QSPI_STD_CMD_READ_ID 0x9F   /**< Read ID command*/
+
+#define FTL_UNIT_MAGIC       0x4C54464E /**< Erase unit header magic ("NFTL")*/
+#define FTL_CKPT_MAGIC       0x504B434E /**< Checkpoint header magic ("NCKP")*/
+#define FTL_ERASE_VAL        0xFFFFFFFF /**< Erased memory value*/
+#define FTL_SLOT_INVALID     0xFFFF     /**< Logical block not written*/
+#define FTL_UNIT_INVALID     0xFFFFFFFF /**< No erase unit*/
+#define FTL_CKPT_HEADER_SIZE 32         /**< Checkpoint header size, data follows it*/
+
+/**
+ * @brief Flash address of an erase unit
+ * */
+#define FTL_UNIT_ADDR(unit)  ((unit) * NRF_BLOCK_DEV_FTL_ERASE_UNIT_SIZE)
+
+/**
+ * @brief Flash address of a slot
+ * */
+#define FTL_SLOT_ADDR(slot)  ((slot) * NRF_BLOCK_DEV_FTL_BLOCK_SIZE)
+
+/**
+ * @brief Flash address of a checkpoint area
+ * */
+#define FTL_CKPT_ADDR(area)  \
+    FTL_UNIT_ADDR(NRF_BLOCK_DEV_FTL_DATA_UNITS + (area) * NRF_BLOCK_DEV_FTL_CKPT_UNITS)
+
+/**
+ * @brief Checkpoint data size: mapping table and sequence numbers of the erase units
+ * */
+#define FTL_CKPT_DATA_SIZE   \
+    (NRF_BLOCK_DEV_FTL_BLOCKS * sizeof(uint16_t) + NRF_BLOCK_DEV_FTL_DATA_UNITS * sizeof(uint32_t))
+
+/**
+ * @brief Erase unit header, at the start of the first slot
+ *
+ * Erased words are programmed one at a time: the sequence number before the magic, and each
+ * logical block number after the data of its slot.
+ * */
+typedef struct {
+    uint32_t magic;                                     //!< @ref FTL_UNIT_MAGIC
+    uint32_t seq;                                       //!< Sequence number
+    uint32_t reserved[6];                               //!< Reserved, erased
+    uint32_t lba[NRF_BLOCK_DEV_FTL_UNIT_DATA_SLOTS];    //!< Logical block of every data slot
+} ftl_unit_header_t;
+
+/**
+ * @brief Checkpoint header, programmed after the data
+ * */
+typedef struct {
+    uint32_t magic;         //!< @ref FTL_CKPT_MAGIC
+    uint32_t ckpt_seq;      //!< Checkpoint sequence number
+    uint32_t length;        //!< Data size
+    uint32_t crc;           //!< CRC32 of the data
+    uint32_t active_unit;   //!< Erase unit written to when the checkpoint was taken
+    uint32_t seq;           //!< Last sequence number given to an erase unit
+    uint32_t reserved[2];   //!< Reserved
+} ftl_ckpt_header_t;
+
+STATIC_ASSERT(sizeof(ftl_ckpt_header_t) == FTL_CKPT_HEADER_SIZE);
+STATIC_ASSERT(sizeof(ftl_unit_header_t) <= NRF_BLOCK_DEV_FTL_BLOCK_SIZE);
+
+/**
+ * @brief Active FTL block device handle. Only one instance.
+ * */
+static nrf_block_dev_ftl_t const * m_active_ftl_dev;
+
+static uint32_t ftl_write_slot(nrf_block_dev_ftl_work_t * p_work,
+                               uint32_t                   lba,
+                               void const *               p_data);
+
+static uint32_t ftl_erase_unit(uint32_t unit)
+{
+    return nrf_drv_qspi_erase(NRF_QSPI_ERASE_LEN_4KB, FTL_UNIT_ADDR(unit));
+}
+
+static uint32_t ftl_write_word(uint32_t value, uint32_t addr)
+{
+    return nrf_drv_qspi_write(&value, sizeof(value), addr);
+}
+
+static uint32_t ftl_free_units(nrf_block_dev_ftl_work_t const * p_work)
+{
+    uint32_t count = 0;
+    for (uint32_t unit = 0; unit < NRF_BLOCK_DEV_FTL_DATA_UNITS; unit++)
+    {
+        if ((p_work->unit_valid[unit] == 0) && (unit != p_work->active_unit))
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Erases the next free erase unit after the active one and makes it active
+ * */
+static uint32_t ftl_unit_open(nrf_block_dev_ftl_work_t * p_work)
+{
+    uint32_t unit = p_work->active_unit;
+    for (uint32_t i = 0; i < NRF_BLOCK_DEV_FTL_DATA_UNITS; i++)
+    {
+        unit = (unit + 1) % NRF_BLOCK_DEV_FTL_DATA_UNITS;
+        if ((p_work->unit_valid[unit] == 0) && (unit != p_work->active_unit))
+        {
+            break;
+        }
+    }
+
+    if ((p_work->unit_valid[unit] != 0) || (unit == p_work->active_unit))
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    uint32_t ret = ftl_erase_unit(unit);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    /*Sequence number first: a unit with the magic always has its sequence number*/
+    uint32_t seq = p_work->seq + 1;
+    ret = ftl_write_word(seq, FTL_UNIT_ADDR(unit) + offsetof(ftl_unit_header_t, seq));
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    ret = ftl_write_word(FTL_UNIT_MAGIC, FTL_UNIT_ADDR(unit) + offsetof(ftl_unit_header_t, magic));
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    p_work->seq = seq;
+    p_work->unit_seq[unit] = seq;
+    p_work->active_unit = unit;
+    p_work->active_slot = 1;
+    p_work->dirty = true;
+    return NRF_SUCCESS;
+}
+
+/**
+ * @brief Selects the erase unit to collect
+ *
+ * @return Erase unit, or @ref FTL_UNIT_INVALID if no collection frees space.
+ * */
+static uint32_t ftl_gc_victim(nrf_block_dev_ftl_work_t const * p_work, bool wear_leveling)
+{
+    uint32_t victim = FTL_UNIT_INVALID;
+
+    for (uint32_t unit = 0; unit < NRF_BLOCK_DEV_FTL_DATA_UNITS; unit++)
+    {
+        if ((p_work->unit_valid[unit] == 0) || (unit == p_work->active_unit))
+        {
+            continue;
+        }
+
+        if (wear_leveling)
+        {
+            /*Oldest erase unit, it holds cold data*/
+            if ((victim == FTL_UNIT_INVALID) ||
+                (p_work->unit_seq[unit] < p_work->unit_seq[victim]))
+            {
+                victim = unit;
+            }
+        }
+        else if (p_work->unit_valid[unit] < NRF_BLOCK_DEV_FTL_UNIT_DATA_SLOTS)
+        {
+            /*Erase unit with the fewest valid slots*/
+            if ((victim == FTL_UNIT_INVALID) ||
+                (p_work->unit_valid[unit] < p_work->unit_valid[victim]))
+            {
+                victim = unit;
+            }
+        }
+    }
+
+    return victim;
+}
+
+/**
+ * @brief Moves the valid slots of one erase unit to the active one
+ *
+ * @param[out] p_done  Set if an erase unit was collected.
+ * */
+static uint32_t ftl_gc_step(nrf_block_dev_ftl_work_t * p_work, bool * p_done)
+{
+    bool wear_leveling = (p_work->gc_count % NRF_BLOCK_DEV_FTL_WL_PERIOD) ==
+                         (NRF_BLOCK_DEV_FTL_WL_PERIOD - 1);
+
+    *p_done = false;
+    uint32_t victim = ftl_gc_victim(p_work, wear_leveling);
+    if (victim == FTL_UNIT_INVALID && wear_leveling)
+    {
+        victim = ftl_gc_victim(p_work, false);
+    }
+
+    if (victim == FTL_UNIT_INVALID)
+    {
+        return NRF_SUCCESS;
+    }
+
+    ftl_unit_header_t header;
+    uint32_t ret = nrf_drv_qspi_read(&header, sizeof(header), FTL_UNIT_ADDR(victim));
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    p_work->in_gc = true;
+    for (uint32_t slot = 1; slot < NRF_BLOCK_DEV_FTL_UNIT_SLOTS; slot++)
+    {
+        uint32_t lba = header.lba[slot - 1];
+        if ((lba >= NRF_BLOCK_DEV_FTL_BLOCKS) ||
+            (p_work->l2p[lba] != victim * NRF_BLOCK_DEV_FTL_UNIT_SLOTS + slot))
+        {
+            /*Not written, or overwritten*/
+            continue;
+        }
+
+        ret = nrf_drv_qspi_read(p_work->buff,
+                                NRF_BLOCK_DEV_FTL_BLOCK_SIZE,
+                                FTL_SLOT_ADDR(p_work->l2p[lba]));
+        if (ret == NRF_SUCCESS)
+        {
+            ret = ftl_write_slot(p_work, lba, p_work->buff);
+        }
+
+        if (ret != NRF_SUCCESS)
+        {
+            break;
+        }
+    }
+    p_work->in_gc = false;
+
+    if (ret == NRF_SUCCESS)
+    {
+        ASSERT(p_work->unit_valid[victim] == 0);
+        p_work->gc_count++;
+        *p_done = true;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Appends a logical block to the log and updates the mapping table
+ * */
+static uint32_t ftl_write_slot(nrf_block_dev_ftl_work_t * p_work,
+                               uint32_t                   lba,
+                               void const *               p_data)
+{
+    uint32_t ret;
+
+    if ((p_work->active_unit == FTL_UNIT_INVALID) ||
+        (p_work->active_slot == NRF_BLOCK_DEV_FTL_UNIT_SLOTS))
+    {
+        if (!p_work->in_gc)
+        {
+            /*The remaining free erase units are a reserve for garbage collection*/
+            while (ftl_free_units(p_work) < NRF_BLOCK_DEV_FTL_GC_MIN_FREE_UNITS)
+            {
+                bool done;
+                ret = ftl_gc_step(p_work, &done);
+                if (ret != NRF_SUCCESS)
+                {
+                    return ret;
+                }
+
+                if (!done)
+                {
+                    break;
+                }
+            }
+        }
+
+        ret = ftl_unit_open(p_work);
+        if (ret != NRF_SUCCESS)
+        {
+            return ret;
+        }
+    }
+
+    uint32_t unit = p_work->active_unit;
+    uint32_t slot = p_work->active_slot;
+
+    /*The slot is used even if programming fails*/
+    p_work->active_slot++;
+    ret = nrf_drv_qspi_write(p_data,
+                             NRF_BLOCK_DEV_FTL_BLOCK_SIZE,
+                             FTL_SLOT_ADDR(unit * NRF_BLOCK_DEV_FTL_UNIT_SLOTS + slot));
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    /*Logical block number after the data: the slot is valid only when both are written*/
+    ret = ftl_write_word(lba, FTL_UNIT_ADDR(unit) + offsetof(ftl_unit_header_t, lba) +
+                              (slot - 1) * sizeof(uint32_t));
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    uint16_t old = p_work->l2p[lba];
+    if (old != FTL_SLOT_INVALID)
+    {
+        p_work->unit_valid[old / NRF_BLOCK_DEV_FTL_UNIT_SLOTS]--;
+    }
+
+    p_work->l2p[lba] = unit * NRF_BLOCK_DEV_FTL_UNIT_SLOTS + slot;
+    p_work->unit_valid[unit]++;
+    p_work->dirty = true;
+    return NRF_SUCCESS;
+}
+
+/**
+ * @brief Drops the mapping of a logical block, so that its slot is not moved by garbage collection
+ * */
+static void ftl_discard_slot(nrf_block_dev_ftl_work_t * p_work, uint32_t lba)
+{
+    uint16_t old = p_work->l2p[lba];
+    if (old == FTL_SLOT_INVALID)
+    {
+        return;
+    }
+
+    p_work->unit_valid[old / NRF_BLOCK_DEV_FTL_UNIT_SLOTS]--;
+    p_work->l2p[lba] = FTL_SLOT_INVALID;
+    p_work->dirty = true;
+}
+
+/**
+ * @brief Copies a part of the checkpoint data between the buffer and the tables
+ *
+ * The data is the mapping table followed by the sequence numbers of the erase units.
+ * */
+static void ftl_ckpt_copy(nrf_block_dev_ftl_work_t * p_work,
+                          uint32_t                   offset,
+                          uint32_t                   length,
+                          bool                       to_buff)
+{
+    uint8_t * p_buff = (uint8_t *)p_work->buff;
+    uint8_t * p_l2p = (uint8_t *)p_work->l2p;
+    uint8_t * p_seq = (uint8_t *)p_work->unit_seq;
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        uint32_t pos = offset + i;
+        uint8_t * p_byte = (pos < sizeof(p_work->l2p)) ? &p_l2p[pos]
+                                                       : &p_seq[pos - sizeof(p_work->l2p)];
+        if (to_buff)
+        {
+            p_buff[i] = *p_byte;
+        }
+        else
+        {
+            *p_byte = p_buff[i];
+        }
+    }
+}
+
+/**
+ * @brief Writes the mapping table to the checkpoint area not written last
+ * */
+static uint32_t ftl_ckpt_write(nrf_block_dev_ftl_work_t * p_work)
+{
+    uint8_t area = p_work->ckpt_area ^ 1;
+    uint32_t ret;
+    uint32_t crc = 0;
+
+    for (uint32_t unit = 0; unit < NRF_BLOCK_DEV_FTL_CKPT_UNITS; unit++)
+    {
+        ret = nrf_drv_qspi_erase(NRF_QSPI_ERASE_LEN_4KB,
+                                 FTL_CKPT_ADDR(area) + FTL_UNIT_ADDR(unit));
+        if (ret != NRF_SUCCESS)
+        {
+            return ret;
+        }
+    }
+
+    for (uint32_t offset = 0; offset < FTL_CKPT_DATA_SIZE; offset += sizeof(p_work->buff))
+    {
+        uint32_t length = MIN(sizeof(p_work->buff), FTL_CKPT_DATA_SIZE - offset);
+        ftl_ckpt_copy(p_work, offset, length, true);
+        crc = crc32_compute((uint8_t const *)p_work->buff, length, offset ? &crc : NULL);
+
+        ret = nrf_drv_qspi_write(p_work->buff,
+                                 ALIGN_NUM(sizeof(uint32_t), length),
+                                 FTL_CKPT_ADDR(area) + FTL_CKPT_HEADER_SIZE + offset);
+        if (ret != NRF_SUCCESS)
+        {
+            return ret;
+        }
+    }
+
+    /*Header last: the checkpoint is valid only when all of it is written*/
+    ftl_ckpt_header_t header = {
+        .magic = FTL_CKPT_MAGIC,
+        .ckpt_seq = p_work->ckpt_seq + 1,
+        .length = FTL_CKPT_DATA_SIZE,
+        .crc = crc,
+        .active_unit = p_work->active_unit,
+        .seq = p_work->seq,
+        .reserved = {FTL_ERASE_VAL, FTL_ERASE_VAL},
+    };
+
+    ret = nrf_drv_qspi_write(&header, sizeof(header), FTL_CKPT_ADDR(area));
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    p_work->ckpt_area = area;
+    p_work->ckpt_seq = header.ckpt_seq;
+    p_work->dirty = false;
+    return NRF_SUCCESS;
+}
+
+/**
+ * @brief Loads the tables from a checkpoint area
+ *
+ * @return True if the checkpoint was valid. The tables are overwritten in any case.
+ * */
+static bool ftl_ckpt_load(nrf_block_dev_ftl_work_t * p_work,
+                          uint8_t                    area,
+                          ftl_ckpt_header_t const *  p_header)
+{
+    uint32_t crc = 0;
+
+    for (uint32_t offset = 0; offset < FTL_CKPT_DATA_SIZE; offset += sizeof(p_work->buff))
+    {
+        uint32_t length = MIN(sizeof(p_work->buff), FTL_CKPT_DATA_SIZE - offset);
+        if (nrf_drv_qspi_read(p_work->buff,
+                              ALIGN_NUM(sizeof(uint32_t), length),
+                              FTL_CKPT_ADDR(area) + FTL_CKPT_HEADER_SIZE + offset) != NRF_SUCCESS)
+        {
+            return false;
+        }
+
+        crc = crc32_compute((uint8_t const *)p_work->buff, length, offset ? &crc : NULL);
+        ftl_ckpt_copy(p_work, offset, length, false);
+    }
+
+    return crc == p_header->crc;
+}
+
+/**
+ * @brief Loads the newest valid checkpoint
+ *
+ * @return Erase unit written to when the checkpoint was taken, or @ref FTL_UNIT_INVALID.
+ * */
+static uint32_t ftl_ckpt_mount(nrf_block_dev_ftl_work_t * p_work)
+{
+    ftl_ckpt_header_t headers[2];
+    bool valid[2];
+
+    for (uint8_t area = 0; area < 2; area++)
+    {
+        valid[area] = (nrf_drv_qspi_read(&headers[area],
+                                         sizeof(headers[area]),
+                                         FTL_CKPT_ADDR(area)) == NRF_SUCCESS) &&
+                      (headers[area].magic == FTL_CKPT_MAGIC) &&
+                      (headers[area].length == FTL_CKPT_DATA_SIZE);
+    }
+
+    uint8_t area = (valid[1] && (!valid[0] || headers[1].ckpt_seq > headers[0].ckpt_seq)) ? 1 : 0;
+    for (uint8_t i = 0; i < 2; i++, area ^= 1)
+    {
+        if (valid[area] && ftl_ckpt_load(p_work, area, &headers[area]))
+        {
+            p_work->ckpt_area = area;
+            p_work->ckpt_seq = headers[area].ckpt_seq;
+            p_work->seq = headers[area].seq;
+            return headers[area].active_unit;
+        }
+    }
+
+    /*No checkpoint: all erase units are replayed*/
+    memset(p_work->l2p, 0xFF, sizeof(p_work->l2p));
+    memset(p_work->unit_seq, 0, sizeof(p_work->unit_seq));
+    p_work->ckpt_area = 1;
+    p_work->ckpt_seq = 0;
+    p_work->seq = 0;
+    return FTL_UNIT_INVALID;
+}
+
+/**
+ * @brief Rebuilds the tables from the checkpoint and the erase unit headers
+ *
+ * Erase units whose sequence number differs from the one in the checkpoint, and the erase unit
+ * written to when the checkpoint was taken, have changed since. Mappings to them are dropped and
+ * their headers are replayed. Of two slots of a logical block, the one in the newer erase unit
+ * or, in the same erase unit, the later one wins.
+ * */
+static uint32_t ftl_mount(nrf_block_dev_ftl_work_t * p_work)
+{
+    uint32_t * p_changed = p_work->buff;
+    ftl_unit_header_t header;
+    uint32_t ret;
+
+    STATIC_ASSERT(sizeof(p_work->buff) * 8 >= NRF_BLOCK_DEV_FTL_DATA_UNITS);
+
+    uint32_t ckpt_active = ftl_ckpt_mount(p_work);
+    memset(p_changed, 0, sizeof(p_work->buff));
+
+    for (uint32_t unit = 0; unit < NRF_BLOCK_DEV_FTL_DATA_UNITS; unit++)
+    {
+        ret = nrf_drv_qspi_read(&header, 2 * sizeof(uint32_t), FTL_UNIT_ADDR(unit));
+        if (ret != NRF_SUCCESS)
+        {
+            return ret;
+        }
+
+        uint32_t seq = (header.magic == FTL_UNIT_MAGIC) ? header.seq : 0;
+        if ((seq != p_work->unit_seq[unit]) || (unit == ckpt_active))
+        {
+            p_changed[unit / 32] |= 1UL << (unit % 32);
+        }
+
+        p_work->unit_seq[unit] = seq;
+        p_work->seq = MAX(p_work->seq, seq);
+    }
+
+    for (uint32_t lba = 0; lba < NRF_BLOCK_DEV_FTL_BLOCKS; lba++)
+    {
+        uint32_t unit = p_work->l2p[lba] / NRF_BLOCK_DEV_FTL_UNIT_SLOTS;
+        if ((unit >= NRF_BLOCK_DEV_FTL_DATA_UNITS) ||
+            (p_work->l2p[lba] % NRF_BLOCK_DEV_FTL_UNIT_SLOTS == 0) ||
+            (p_changed[unit / 32] & (1UL << (unit % 32))))
+        {
+            p_work->l2p[lba] = FTL_SLOT_INVALID;
+        }
+    }
+
+    for (uint32_t unit = 0; unit < NRF_BLOCK_DEV_FTL_DATA_UNITS; unit++)
+    {
+        if (!(p_changed[unit / 32] & (1UL << (unit % 32))) || (p_work->unit_seq[unit] == 0))
+        {
+            continue;
+        }
+
+        ret = nrf_drv_qspi_read(&header, sizeof(header), FTL_UNIT_ADDR(unit));
+        if (ret != NRF_SUCCESS)
+        {
+            return ret;
+        }
+
+        for (uint32_t slot = 1; slot < NRF_BLOCK_DEV_FTL_UNIT_SLOTS; slot++)
+        {
+            uint32_t lba = header.lba[slot - 1];
+            if (lba >= NRF_BLOCK_DEV_FTL_BLOCKS)
+            {
+                continue;
+            }
+
+            uint16_t cur = p_work->l2p[lba];
+            uint32_t cur_unit = cur / NRF_BLOCK_DEV_FTL_UNIT_SLOTS;
+            if ((cur == FTL_SLOT_INVALID) ||
+                (p_work->unit_seq[unit] > p_work->unit_seq[cur_unit]) ||
+                ((unit == cur_unit) && (slot > cur % NRF_BLOCK_DEV_FTL_UNIT_SLOTS)))
+            {
+                p_work->l2p[lba] = unit * NRF_BLOCK_DEV_FTL_UNIT_SLOTS + slot;
+            }
+        }
+    }
+
+    memset(p_work->unit_valid, 0, sizeof(p_work->unit_valid));
+    for (uint32_t lba = 0; lba < NRF_BLOCK_DEV_FTL_BLOCKS; lba++)
+    {
+        if (p_work->l2p[lba] != FTL_SLOT_INVALID)
+        {
+            p_work->unit_valid[p_work->l2p[lba] / NRF_BLOCK_DEV_FTL_UNIT_SLOTS]++;
+        }
+    }
+
+    /*Free slots of the last written erase unit may be partially programmed: open a new one*/
+    p_work->active_unit = FTL_UNIT_INVALID;
+    p_work->active_slot = NRF_BLOCK_DEV_FTL_UNIT_SLOTS;
+    p_work->dirty = true;
+    return NRF_SUCCESS;
+}
+
+static void ftl_req_end(nrf_block_dev_ftl_t const * p_ftl_dev,
+                        nrf_block_dev_event_type_t  ev_type,
+                        uint32_t                    ret,
+                        nrf_block_req_t const *     p_blk)
+{
+    nrf_block_dev_ftl_work_t * p_work = p_ftl_dev->p_work;
+
+    if (p_work->ev_handler)
+    {
+        /*Asynchronous operation (simulation)*/
+        const nrf_block_dev_event_t ev = {
+                ev_type,
+                (ret == NRF_SUCCESS) ? NRF_BLOCK_DEV_RESULT_SUCCESS :
+                                       NRF_BLOCK_DEV_RESULT_IO_ERROR,
+                p_blk,
+                p_work->p_context
+        };
+
+        p_work->ev_handler(&p_ftl_dev->block_dev, &ev);
+    }
+}
+
+static ret_code_t block_dev_ftl_init(nrf_block_dev_t const * p_blk_dev,
+                                     nrf_block_dev_ev_handler ev_handler,
+                                     void const * p_context)
+{
+    ASSERT(p_blk_dev);
+    nrf_block_dev_ftl_t const *   p_ftl_dev =
+                                  CONTAINER_OF(p_blk_dev, nrf_block_dev_ftl_t, block_dev);
+    nrf_block_dev_ftl_work_t *    p_work = p_ftl_dev->p_work;
+    nrf_drv_qspi_config_t const * p_qspi_cfg = &p_ftl_dev->ftl_bdev_config.qspi_config;
+
+    ret_code_t ret = NRF_SUCCESS;
+
+    if (m_active_ftl_dev)
+    {
+        /* QSPI instance is BUSY*/
+        return NRF_ERROR_BUSY;
+    }
+
+    /*Blocking mode*/
+    ret = nrf_drv_qspi_init(p_qspi_cfg, NULL, NULL);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    nrf_qspi_cinstr_conf_t cinstr_cfg = {
+        .opcode    = QSPI_STD_CMD_RSTEN,
+        .length    = NRF_QSPI_CINSTR_LEN_1B,
+        .io2_level = true,
+        .io3_level = true,
+        .wipwait   = true,
+        .wren      = true
+    };
+
+    /* Send reset enable */
+    ret = nrf_drv_qspi_cinstr_xfer(&cinstr_cfg, NULL, NULL);
+    if (ret == NRF_SUCCESS)
+    {
+        /* Send reset command */
+        cinstr_cfg.opcode = QSPI_STD_CMD_RST;
+        ret = nrf_drv_qspi_cinstr_xfer(&cinstr_cfg, NULL, NULL);
+    }
+
+    /* Get 3 byte identification value */
+    uint8_t rdid_buf[3] = {0, 0, 0};
+    if (ret == NRF_SUCCESS)
+    {
+        cinstr_cfg.opcode = QSPI_STD_CMD_READ_ID;
+        cinstr_cfg.length = NRF_QSPI_CINSTR_LEN_4B;
+        ret = nrf_drv_qspi_cinstr_xfer(&cinstr_cfg, NULL, rdid_buf);
+    }
+
+    if (ret == NRF_SUCCESS)
+    {
+        nrf_serial_flash_params_t const * serial_flash_id = nrf_serial_flash_params_get(rdid_buf);
+
+        if (!serial_flash_id ||
+            (serial_flash_id->erase_size != NRF_BLOCK_DEV_FTL_ERASE_UNIT_SIZE) ||
+            (serial_flash_id->size < NRF_BLOCK_DEV_FTL_FLASH_SIZE))
+        {
+            ret = NRF_ERROR_NOT_SUPPORTED;
+        }
+    }
+
+    if (ret == NRF_SUCCESS)
+    {
+        ret = ftl_mount(p_work);
+    }
+
+    if (ret != NRF_SUCCESS)
+    {
+        nrf_drv_qspi_uninit();
+        memset(p_work, 0, sizeof(nrf_block_dev_ftl_work_t));
+        return ret;
+    }
+
+    p_work->geometry.blk_size = NRF_BLOCK_DEV_FTL_BLOCK_SIZE;
+    p_work->geometry.blk_count = NRF_BLOCK_DEV_FTL_BLOCKS;
+    p_work->p_context = p_context;
+    p_work->ev_handler = ev_handler;
+    m_active_ftl_dev = p_ftl_dev;
+
+    ftl_req_end(p_ftl_dev, NRF_BLOCK_DEV_EVT_INIT, NRF_SUCCESS, NULL);
+    return NRF_SUCCESS;
+}
+
+static ret_code_t block_dev_ftl_uninit(nrf_block_dev_t const * p_blk_dev)
+{
+    ASSERT(p_blk_dev);
+    nrf_block_dev_ftl_t const * p_ftl_dev =
+                                CONTAINER_OF(p_blk_dev, nrf_block_dev_ftl_t, block_dev);
+    nrf_block_dev_ftl_work_t *  p_work = p_ftl_dev->p_work;
+
+    if (m_active_ftl_dev != p_ftl_dev)
+    {
+        /* QSPI instance is BUSY*/
+        return NRF_ERROR_BUSY;
+    }
+
+    uint32_t ret = p_work->dirty ? ftl_ckpt_write(p_work) : NRF_SUCCESS;
+    bool async = (p_work->ev_handler != NULL);
+    ftl_req_end(p_ftl_dev, NRF_BLOCK_DEV_EVT_UNINIT, ret, NULL);
+
+    nrf_drv_qspi_uninit();
+    memset(p_work, 0, sizeof(nrf_block_dev_ftl_work_t));
+    m_active_ftl_dev = NULL;
+    return async ? NRF_SUCCESS : ret;
+}
+
+static ret_code_t block_dev_ftl_read_req(nrf_block_dev_t const * p_blk_dev,
+                                         nrf_block_req_t const * p_blk)
+{
+    ASSERT(p_blk_dev);
+    ASSERT(p_blk);
+    nrf_block_dev_ftl_t const * p_ftl_dev =
+                                CONTAINER_OF(p_blk_dev, nrf_block_dev_ftl_t, block_dev);
+    nrf_block_dev_ftl_work_t *  p_work = p_ftl_dev->p_work;
+
+    uint32_t ret = NRF_SUCCESS;
+
+    if (m_active_ftl_dev != p_ftl_dev)
+    {
+        /* QSPI instance is BUSY*/
+        return NRF_ERROR_BUSY;
+    }
+
+    uint8_t * p_buff = p_blk->p_buff;
+    for (uint32_t i = 0; (i < p_blk->blk_count) && (ret == NRF_SUCCESS); i++)
+    {
+        uint16_t slot = p_work->l2p[p_blk->blk_id + i];
+        if (slot == FTL_SLOT_INVALID)
+        {
+            /*Never written: reads as erased*/
+            memset(p_buff, 0xFF, NRF_BLOCK_DEV_FTL_BLOCK_SIZE);
+        }
+        else
+        {
+            ret = nrf_drv_qspi_read(p_buff, NRF_BLOCK_DEV_FTL_BLOCK_SIZE, FTL_SLOT_ADDR(slot));
+        }
+
+        p_buff += NRF_BLOCK_DEV_FTL_BLOCK_SIZE;
+    }
+
+    if (!p_work->ev_handler)
+    {
+        return ret;
+    }
+
+    ftl_req_end(p_ftl_dev, NRF_BLOCK_DEV_EVT_BLK_READ_DONE, ret, p_blk);
+    return NRF_SUCCESS;
+}
+
+static ret_code_t block_dev_ftl_write_req(nrf_block_dev_t const * p_blk_dev,
+                                          nrf_block_req_t const * p_blk)
+{
+    ASSERT(p_blk_dev);
+    ASSERT(p_blk);
+    nrf_block_dev_ftl_t const * p_ftl_dev =
+                                CONTAINER_OF(p_blk_dev, nrf_block_dev_ftl_t, block_dev);
+    nrf_block_dev_ftl_work_t *  p_work = p_ftl_dev->p_work;
+
+    uint32_t ret = NRF_SUCCESS;
+
+    if (m_active_ftl_dev != p_ftl_dev)
+    {
+        /* QSPI instance is BUSY*/
+        return NRF_ERROR_BUSY;
+    }
+
+    uint8_t const * p_buff = p_blk->p_buff;
+    for (uint32_t i = 0; (i < p_blk->blk_count) && (ret == NRF_SUCCESS); i++)
+    {
+        ret = ftl_write_slot(p_work, p_blk->blk_id + i, p_buff);
+        p_buff += NRF_BLOCK_DEV_FTL_BLOCK_SIZE;
+    }
+
+    if (!p_work->ev_handler)
+    {
+        return ret;
+    }
+
+    ftl_req_end(p_ftl_dev, NRF_BLOCK_DEV_EVT_BLK_WRITE_DONE, ret, p_blk);
+    return NRF_SUCCESS;
+}
+
+static ret_code_t block_dev_ftl_ioctl(nrf_block_dev_t const * p_blk_dev,
+                                      nrf_block_dev_ioctl_req_t req,
+                                      void * p_data)
+{
+    ASSERT(p_blk_dev);
+    nrf_block_dev_ftl_t const * p_ftl_dev =
+                                CONTAINER_OF(p_blk_dev, nrf_block_dev_ftl_t, block_dev);
+    nrf_block_dev_ftl_work_t *  p_work = p_ftl_dev->p_work;
+
+    switch (req)
+    {
+        case NRF_BLOCK_DEV_IOCTL_REQ_CACHE_FLUSH:
+        {
+            bool * p_flushing = p_data;
+            if (p_flushing)
+            {
+                *p_flushing = false;
+            }
+
+            if (m_active_ftl_dev != p_ftl_dev)
+            {
+                return NRF_ERROR_BUSY;
+            }
+
+            return p_work->dirty ? ftl_ckpt_write(p_work) : NRF_SUCCESS;
+        }
+        case NRF_BLOCK_DEV_IOCTL_REQ_DISCARD:
+        {
+            nrf_block_req_t const * p_blk = p_data;
+            if ((p_blk == NULL) ||
+                (p_blk->blk_id > NRF_BLOCK_DEV_FTL_BLOCKS) ||
+                (p_blk->blk_count > NRF_BLOCK_DEV_FTL_BLOCKS - p_blk->blk_id))
+            {
+                return NRF_ERROR_INVALID_PARAM;
+            }
+
+            if (m_active_ftl_dev != p_ftl_dev)
+            {
+                return NRF_ERROR_BUSY;
+            }
+
+            for (uint32_t i = 0; i < p_blk->blk_count; i++)
+            {
+                ftl_discard_slot(p_work, p_blk->blk_id + i);
+            }
+
+            return NRF_SUCCESS;
+        }
+        case NRF_BLOCK_DEV_IOCTL_REQ_INFO_STRINGS:
+        {
+            if (p_data == NULL)
+            {
+                return NRF_ERROR_INVALID_PARAM;
+            }
+
+            nrf_block_dev_info_strings_t const * * pp_strings = p_data;
+            *pp_strings = &p_ftl_dev->info_strings;
+            return NRF_SUCCESS;
+        }
+        default:
+            break;
+    }
+
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+static nrf_block_dev_geometry_t const * block_dev_ftl_geometry(nrf_block_dev_t const * p_blk_dev)
+{
+    ASSERT(p_blk_dev);
+    nrf_block_dev_ftl_t const * p_ftl_dev =
+                                CONTAINER_OF(p_blk_dev, nrf_block_dev_ftl_t, block_dev);
+    nrf_block_dev_ftl_work_t const * p_work = p_ftl_dev->p_work;
+
+    return &p_work->geometry;
+}
+
+bool nrf_block_dev_ftl_idle(nrf_block_dev_ftl_t const * p_blk_ftl)
+{
+    ASSERT(p_blk_ftl);
+    nrf_block_dev_ftl_work_t * p_work = p_blk_ftl->p_work;
+
+    if ((m_active_ftl_dev != p_blk_ftl) ||
+        (ftl_free_units(p_work) >= NRF_BLOCK_DEV_FTL_GC_IDLE_FREE_UNITS))
+    {
+        return false;
+    }
+
+    bool done;
+    if ((ftl_gc_step(p_work, &done) != NRF_SUCCESS) || !done)
+    {
+        return false;
+    }
+
+    return ftl_free_units(p_work) < NRF_BLOCK_DEV_FTL_GC_IDLE_FREE_UNITS;
+}
+
+const nrf_block_dev_ops_t nrf_block_device_ftl_ops = {
+        .init = block_dev_ftl_init,
+        .uninit = block_dev_ftl_uninit,
+        .read_req = block_dev_ftl_read_req,
+        .write_req = block_dev_ftl_write_req,
+        .ioctl = block_dev_ftl_ioctl,
+        .geometry = block_dev_ftl_geometry,
+};
+
+
+/** @} */
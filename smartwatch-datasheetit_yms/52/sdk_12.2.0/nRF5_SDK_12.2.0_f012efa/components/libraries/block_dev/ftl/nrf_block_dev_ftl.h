@@ -0,0 +1,261 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#ifndef NRF_BLOCK_DEV_FTL_H__
+#define NRF_BLOCK_DEV_FTL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "nrf_block_dev.h"
+#include "nrf_drv_qspi.h"
+
+/**@file
+ *
+ * @defgroup nrf_block_dev_ftl QSPI flash translation layer implementation
+ * @ingroup nrf_block_dev
+ * @{
+ *
+ * @brief Log-structured block device on a QSPI NOR memory.
+ *
+ * @details Logical blocks of @ref NRF_BLOCK_DEV_FTL_BLOCK_SIZE bytes are not written in place.
+ *          Every write is appended to the next free slot of an erased erase unit, and a table in
+ *          RAM maps logical blocks to slots. A random block write costs one page program, not
+ *          an erase and a reprogram of a whole erase unit.
+ *
+ *          The first slot of every erase unit holds its header: a sequence number that orders the
+ *          erase units by age, and the logical block number of each of the other slots, which is
+ *          programmed after the slot. The mapping table can be rebuilt from the headers.
+ *
+ *          Erase units whose slots were all overwritten are reused. Garbage collection moves the
+ *          valid slots of the erase unit with the fewest of them, so that it can be reused. It
+ *          runs before a write when fewer than @ref NRF_BLOCK_DEV_FTL_GC_MIN_FREE_UNITS erase
+ *          units are free, and in the background from @ref nrf_block_dev_ftl_idle. Erase units
+ *          are opened in a round-robin order, and every @ref NRF_BLOCK_DEV_FTL_WL_PERIOD garbage
+ *          collections the oldest erase unit is collected instead, so that cold data is moved and
+ *          all erase units wear evenly.
+ *
+ *          The mapping table is checkpointed to one of two reserved areas on
+ *          @ref NRF_BLOCK_DEV_IOCTL_REQ_CACHE_FLUSH and when uninitialized. At initialization only
+ *          the headers of the erase units changed after the last checkpoint are replayed.
+ *
+ *          On @ref NRF_BLOCK_DEV_IOCTL_REQ_DISCARD the mappings of the blocks are dropped. Their
+ *          slots are not moved by garbage collection, and they read as erased. The discard is not
+ *          logged, so after a reset a discarded block may read its old data again.
+ *
+ * @note Operations are performed in blocking mode. If an event handler is given, it is called
+ *       before the request returns.
+ */
+
+/**
+ * @brief Size of the QSPI memory used, in bytes. It must not be larger than the memory.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ * */
+#ifndef NRF_BLOCK_DEV_FTL_FLASH_SIZE
+#define NRF_BLOCK_DEV_FTL_FLASH_SIZE (8u * 1024u * 1024u)
+#endif
+
+/**
+ * @brief Number of erase units that are not used for logical blocks. More spare erase units make
+ *        garbage collection cheaper.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ * */
+#ifndef NRF_BLOCK_DEV_FTL_SPARE_UNITS
+#define NRF_BLOCK_DEV_FTL_SPARE_UNITS (64)
+#endif
+
+/**
+ * @brief Number of free erase units below which garbage collection runs before a write.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ * */
+#ifndef NRF_BLOCK_DEV_FTL_GC_MIN_FREE_UNITS
+#define NRF_BLOCK_DEV_FTL_GC_MIN_FREE_UNITS (2)
+#endif
+
+/**
+ * @brief Number of free erase units below which @ref nrf_block_dev_ftl_idle runs garbage
+ *        collection.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ * */
+#ifndef NRF_BLOCK_DEV_FTL_GC_IDLE_FREE_UNITS
+#define NRF_BLOCK_DEV_FTL_GC_IDLE_FREE_UNITS (16)
+#endif
+
+/**
+ * @brief Number of garbage collections after which the oldest erase unit is collected.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ * */
+#ifndef NRF_BLOCK_DEV_FTL_WL_PERIOD
+#define NRF_BLOCK_DEV_FTL_WL_PERIOD (32)
+#endif
+
+/**
+ * @brief Logical block size
+ * */
+#define NRF_BLOCK_DEV_FTL_BLOCK_SIZE (512)
+
+/**
+ * @brief Erase unit size
+ * */
+#define NRF_BLOCK_DEV_FTL_ERASE_UNIT_SIZE (4096)
+
+/**
+ * @brief Slots in an erase unit, the first one holds the header
+ * */
+#define NRF_BLOCK_DEV_FTL_UNIT_SLOTS \
+    (NRF_BLOCK_DEV_FTL_ERASE_UNIT_SIZE / NRF_BLOCK_DEV_FTL_BLOCK_SIZE)
+
+/**
+ * @brief Data slots in an erase unit
+ * */
+#define NRF_BLOCK_DEV_FTL_UNIT_DATA_SLOTS (NRF_BLOCK_DEV_FTL_UNIT_SLOTS - 1)
+
+/**
+ * @brief Erase units in the memory
+ * */
+#define NRF_BLOCK_DEV_FTL_UNITS (NRF_BLOCK_DEV_FTL_FLASH_SIZE / NRF_BLOCK_DEV_FTL_ERASE_UNIT_SIZE)
+
+/**
+ * @brief Erase units of one checkpoint area: a header, the mapping table and the sequence numbers
+ *        of the erase units. Computed for all erase units, so it is slightly overestimated.
+ * */
+#define NRF_BLOCK_DEV_FTL_CKPT_UNITS                                              \
+    CEIL_DIV(32 + NRF_BLOCK_DEV_FTL_UNITS * NRF_BLOCK_DEV_FTL_UNIT_DATA_SLOTS * 2 \
+             + NRF_BLOCK_DEV_FTL_UNITS * 4,                                       \
+             NRF_BLOCK_DEV_FTL_ERASE_UNIT_SIZE)
+
+/**
+ * @brief Erase units used for logical blocks. The checkpoint areas are at the end of the memory.
+ * */
+#define NRF_BLOCK_DEV_FTL_DATA_UNITS (NRF_BLOCK_DEV_FTL_UNITS - 2 * NRF_BLOCK_DEV_FTL_CKPT_UNITS)
+
+/**
+ * @brief Logical blocks
+ * */
+#define NRF_BLOCK_DEV_FTL_BLOCKS \
+    ((NRF_BLOCK_DEV_FTL_DATA_UNITS - NRF_BLOCK_DEV_FTL_SPARE_UNITS) * NRF_BLOCK_DEV_FTL_UNIT_DATA_SLOTS)
+
+#if (NRF_BLOCK_DEV_FTL_DATA_UNITS * NRF_BLOCK_DEV_FTL_UNIT_SLOTS) >= 0xFFFF
+#error "NRF_BLOCK_DEV_FTL_FLASH_SIZE too large for 16-bit slot numbers."
+#endif
+
+#if NRF_BLOCK_DEV_FTL_SPARE_UNITS <= NRF_BLOCK_DEV_FTL_GC_MIN_FREE_UNITS
+#error "NRF_BLOCK_DEV_FTL_SPARE_UNITS must be larger than NRF_BLOCK_DEV_FTL_GC_MIN_FREE_UNITS."
+#endif
+
+/**
+ * @brief FTL block device operations
+ * */
+extern const nrf_block_dev_ops_t nrf_block_device_ftl_ops;
+
+/**
+ * @brief Work structure of FTL block device
+ */
+typedef struct {
+    nrf_block_dev_geometry_t geometry;      //!< Block device geometry
+    nrf_block_dev_ev_handler ev_handler;    //!< Block device event handler
+    void const *             p_context;     //!< Context handle passed to event handler
+
+    uint32_t seq;                           //!< Last sequence number given to an erase unit
+    uint32_t ckpt_seq;                      //!< Sequence number of the last checkpoint
+    uint32_t active_unit;                   //!< Erase unit that is written to
+    uint32_t active_slot;                   //!< Next slot of the active erase unit
+    uint32_t gc_count;                      //!< Garbage collections done, for wear leveling
+    uint8_t  ckpt_area;                     //!< Checkpoint area written last
+    bool     dirty;                         //!< Mapping table changed since the last checkpoint
+    bool     in_gc;                         //!< Garbage collection is moving slots
+
+    uint16_t l2p[NRF_BLOCK_DEV_FTL_BLOCKS];             //!< Slot of every logical block
+    uint32_t unit_seq[NRF_BLOCK_DEV_FTL_DATA_UNITS];    //!< Sequence number of every erase unit, 0 if not used
+    uint8_t  unit_valid[NRF_BLOCK_DEV_FTL_DATA_UNITS];  //!< Valid slots of every erase unit
+
+    uint32_t buff[NRF_BLOCK_DEV_FTL_BLOCK_SIZE / sizeof(uint32_t)]; //!< Slot buffer for garbage collection
+} nrf_block_dev_ftl_work_t;
+
+/**
+ * @brief FTL block device config initializer (@ref nrf_block_dev_ftl_config_t)
+ *
+ * @param qspi_drv_config   QPSI driver config
+ * */
+#define NRF_BLOCK_DEV_FTL_CONFIG(qspi_drv_config)  {   \
+        .qspi_config = qspi_drv_config                 \
+}
+
+/**
+ * @brief FTL block device config
+ */
+typedef struct {
+    nrf_drv_qspi_config_t qspi_config;    //!< QSPI configuration
+} nrf_block_dev_ftl_config_t;
+
+/**
+ * @brief FTL block device
+ * */
+typedef struct {
+    nrf_block_dev_t              block_dev;         //!< Block device
+    nrf_block_dev_info_strings_t info_strings;      //!< Block device information strings
+    nrf_block_dev_ftl_config_t   ftl_bdev_config;   //!< FTL block device config
+    nrf_block_dev_ftl_work_t *   p_work;            //!< FTL block device work structure
+} nrf_block_dev_ftl_t;
+
+/**
+ * @brief Defines a FTL block device.
+ *
+ * @param name    Instance name
+ * @param config  Configuration @ref nrf_block_dev_ftl_config_t
+ * @param info    Info strings @ref NFR_BLOCK_DEV_INFO_CONFIG
+ * */
+#define NRF_BLOCK_DEV_FTL_DEFINE(name, config, info)                 \
+    static nrf_block_dev_ftl_work_t CONCAT_2(name, _work);          \
+    static const nrf_block_dev_ftl_t name = {                       \
+            .block_dev = { .p_ops = &nrf_block_device_ftl_ops },     \
+            .info_strings = BRACKET_EXTRACT(info),                   \
+            .ftl_bdev_config = config,                               \
+            .p_work = &CONCAT_2(name, _work),                        \
+    }
+
+/**
+ * @brief Returns block device API handle from FTL block device.
+ *
+ * @param[in] p_blk_ftl FTL block device
+ * @return Block device handle
+ */
+static inline nrf_block_dev_t const *
+nrf_block_dev_ftl_ops_get(nrf_block_dev_ftl_t const * p_blk_ftl)
+{
+    return &p_blk_ftl->block_dev;
+}
+
+/**
+ * @brief Runs one step of background garbage collection, if few erase units are free.
+ *
+ * Should be called when the application is idle. One step moves the valid slots of one erase
+ * unit.
+ *
+ * @param[in] p_blk_ftl FTL block device
+ *
+ * @return True if more steps are needed.
+ */
+bool nrf_block_dev_ftl_idle(nrf_block_dev_ftl_t const * p_blk_ftl);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRF_BLOCK_DEV_FTL_H__ */
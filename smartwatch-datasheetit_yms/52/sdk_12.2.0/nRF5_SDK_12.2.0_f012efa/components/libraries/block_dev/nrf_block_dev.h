@@ -138,6 +138,14 @@ typedef struct {
 typedef enum {
     NRF_BLOCK_DEV_IOCTL_REQ_CACHE_FLUSH = 0, /**< Cache flush IOCTL request*/
     NRF_BLOCK_DEV_IOCTL_REQ_INFO_STRINGS,    /**< Get info strings IOCTL request*/
+    NRF_BLOCK_DEV_IOCTL_REQ_DISCARD,         /**< Discard IOCTL request: the data of the blocks is
+                                                  no longer used. p_data points to a
+                                                  @ref nrf_block_req_t, p_buff is not used.*/
+    NRF_BLOCK_DEV_IOCTL_REQ_BLOCK_PTR,       /**< Get blocks in place IOCTL request: p_data points
+                                                  to a @ref nrf_block_req_t, its p_buff is set to
+                                                  the blocks in the memory of the device. They
+                                                  must only be read, and only until the next
+                                                  write request.*/
 } nrf_block_dev_ioctl_req_t;
 
 
@@ -290,7 +298,7 @@ static inline ret_code_t nrf_blk_dev_write_req(nrf_block_dev_t const * p_blk_dev
  * @param[in] req         Block device ioctl request
  * @param[in] p_data      Block device ioctl data
  *
- * @return Standard error code
+ * @return Standard error code, NRF_ERROR_NOT_SUPPORTED if the device does not implement the request
  * */
 static inline ret_code_t nrf_blk_dev_ioctl(nrf_block_dev_t const * p_blk_dev,
                                            nrf_block_dev_ioctl_req_t req,
@@ -12,6 +12,7 @@
 
 #include "nrf_serial_flash_params.h"
 #include "nrf_block_dev_qspi.h"
+#include "app_util_platform.h"
 
 /**@file
  *
@@ -49,80 +50,431 @@
     (NRF_BLOCK_DEV_QSPI_ERASE_UNIT_SIZE / (blk_size))
 
 
-static ret_code_t block_dev_qspi_eunit_write(nrf_block_dev_qspi_t const * p_qspi_dev,
-                                             nrf_block_req_t * p_blk_left);
+/**
+ * @brief Pages per erase unit
+ * */
+#define BD_PAGES_PER_ERASEUNIT                    \
+    (NRF_BLOCK_DEV_QSPI_ERASE_UNIT_SIZE / BD_PAGE_PROGRAM_SIZE)
 
 
-static void block_dev_qspi_read_from_eunit(nrf_block_dev_qspi_t const * p_qspi_dev)
+static ret_code_t block_dev_qspi_write_continue(nrf_block_dev_qspi_t const * p_qspi_dev);
+
+static ret_code_t block_dev_qspi_read_start(nrf_block_dev_qspi_t const * p_qspi_dev);
+
+static ret_code_t block_dev_qspi_write_start(nrf_block_dev_qspi_t const * p_qspi_dev);
+
+
+/**
+ * @brief Active QSPI block device handle. Only one instance.
+ * */
+static nrf_block_dev_qspi_t const * m_active_qspi_dev;
+
+/**
+ * @brief Ends the current request and calls the event handler.
+ *
+ * @param p_qspi_dev    QSPI block device
+ * @param ev_type       Event type
+ * @param result        Operation result
+ * */
+static void block_dev_qspi_req_end(nrf_block_dev_qspi_t const * p_qspi_dev,
+                                   nrf_block_dev_event_type_t ev_type,
+                                   nrf_block_dev_result_t result)
 {
-    nrf_block_dev_qspi_work_t const * p_work = p_qspi_dev->p_work;
+    nrf_block_dev_qspi_work_t * p_work = p_qspi_dev->p_work;
 
-    /*In write-back mode data that we read might not be the same as in erase unit buffer*/
-    uint32_t eunit_start = BD_BLOCK_TO_ERASEUNIT(p_work->req.blk_id,
-                                                 p_work->geometry.blk_size);
+    p_work->write_in_progress = false;
+    p_work->state = NRF_BLOCK_DEV_QSPI_STATE_IDLE;
+    if (p_work->ev_handler)
+    {
+        const nrf_block_dev_event_t ev = {
+                ev_type,
+                result,
+                &p_work->req,
+                p_work->p_context
+        };
 
-    uint32_t eunit_end = BD_BLOCK_TO_ERASEUNIT(p_work->req.blk_id + p_work->req.blk_count,
-                                               p_work->geometry.blk_size);
+        p_work->ev_handler(&p_qspi_dev->block_dev, &ev);
+    }
+}
 
-    if ((eunit_start > p_work->erase_unit_idx) || (eunit_end < p_work->erase_unit_idx))
+/**
+ * @brief Returns the cache entry of an erase unit, or @ref NRF_BLOCK_DEV_QSPI_CACHE_WAYS if it is
+ *        not cached.
+ * */
+static size_t block_dev_qspi_eunit_find(nrf_block_dev_qspi_work_t const * p_work, uint32_t idx)
+{
+    size_t way;
+
+    for (way = 0; way < NRF_BLOCK_DEV_QSPI_CACHE_WAYS; way++)
     {
-        /*Do nothing. Read request doesn't hit current cached erase unit*/
-        return;
+        if (p_work->eunits[way].idx == idx)
+        {
+            break;
+        }
+    }
+
+    return way;
+}
+
+/**
+ * @brief Returns the cache entry to be used for a new erase unit: a free one, or else the least
+ *        recently used one.
+ * */
+static size_t block_dev_qspi_eunit_victim(nrf_block_dev_qspi_work_t const * p_work)
+{
+    size_t victim = 0;
+
+    for (size_t way = 0; way < NRF_BLOCK_DEV_QSPI_CACHE_WAYS; way++)
+    {
+        nrf_block_dev_qspi_eunit_t const * p_eunit = &p_work->eunits[way];
+
+        if (p_eunit->idx == BD_ERASE_UNIT_INVALID_ID)
+        {
+            return way;
+        }
+
+        /*Counter difference keeps the order when the counter wraps*/
+        if ((int32_t)(p_eunit->last_use - p_work->eunits[victim].last_use) < 0)
+        {
+            victim = way;
+        }
+    }
+
+    return victim;
+}
+
+static bool block_dev_qspi_eunit_is_dirty(nrf_block_dev_qspi_eunit_t const * p_eunit)
+{
+    return (p_eunit->dirty_pages != 0) || p_eunit->erase_required;
+}
+
+/**
+ * @brief Returns the partial discard entry of an erase unit, or
+ *        @ref NRF_BLOCK_DEV_QSPI_DISCARD_PARTIAL if there is none.
+ * */
+static size_t block_dev_qspi_partial_find(nrf_block_dev_qspi_work_t const * p_work, uint32_t idx)
+{
+    size_t i;
+
+    for (i = 0; i < NRF_BLOCK_DEV_QSPI_DISCARD_PARTIAL; i++)
+    {
+        if (p_work->partial[i].idx == idx)
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
+/**
+ * @brief Checks if an erase unit is discarded and not erased yet
+ * */
+static bool block_dev_qspi_discard_pending(nrf_block_dev_qspi_work_t const * p_work, uint32_t idx)
+{
+    return (idx < NRF_BLOCK_DEV_QSPI_DISCARD_UNITS) &&
+           ((p_work->discard_map[idx / 32] & (1u << (idx % 32))) != 0);
+}
+
+/**
+ * @brief Forgets the discarded blocks of an erase unit that is written
+ * */
+static void block_dev_qspi_discard_clear(nrf_block_dev_qspi_work_t * p_work, uint32_t idx)
+{
+    size_t i = block_dev_qspi_partial_find(p_work, idx);
+
+    if (i < NRF_BLOCK_DEV_QSPI_DISCARD_PARTIAL)
+    {
+        p_work->partial[i].idx = BD_ERASE_UNIT_INVALID_ID;
+    }
+
+    if (idx < NRF_BLOCK_DEV_QSPI_DISCARD_UNITS)
+    {
+        p_work->discard_map[idx / 32] &= ~(1u << (idx % 32));
+    }
+}
+
+/**
+ * @brief Marks the blocks of a discard request
+ *
+ * Erase units whose blocks are all discarded are dropped from the cache and marked to be erased.
+ * The blocks of the other ones are added to their partial discard entries. An erase unit that is
+ * being flushed is skipped.
+ * */
+static void block_dev_qspi_discard(nrf_block_dev_qspi_t const * p_qspi_dev,
+                                   nrf_block_req_t const * p_blk)
+{
+    nrf_block_dev_qspi_work_t * p_work = p_qspi_dev->p_work;
+    uint32_t blk_size = p_work->geometry.blk_size;
+    uint32_t blk_id = p_blk->blk_id;
+    uint32_t blk_end = p_blk->blk_id + p_blk->blk_count;
+    uint32_t all_blocks = (1u << BD_BLOCKS_PER_ERASEUNIT(blk_size)) - 1;
+
+    while (blk_id < blk_end)
+    {
+        uint32_t idx = BD_BLOCK_TO_ERASEUNIT(blk_id, blk_size);
+        uint32_t blk = blk_id % BD_BLOCKS_PER_ERASEUNIT(blk_size);
+        uint32_t cnt = MIN(BD_BLOCKS_PER_ERASEUNIT(blk_size) - blk, blk_end - blk_id);
+        uint32_t blocks = ((1u << cnt) - 1) << blk;
+
+        if (idx >= NRF_BLOCK_DEV_QSPI_DISCARD_UNITS)
+        {
+            break;
+        }
+        blk_id += cnt;
+
+        CRITICAL_REGION_ENTER();
+        size_t way = block_dev_qspi_eunit_find(p_work, idx);
+        bool flushed = (way < NRF_BLOCK_DEV_QSPI_CACHE_WAYS) &&
+                       (way == p_work->flush_way) &&
+                       ((p_work->state == NRF_BLOCK_DEV_QSPI_STATE_WRITE_ERASE) ||
+                        (p_work->state == NRF_BLOCK_DEV_QSPI_STATE_WRITE_EXEC));
+
+        size_t i = block_dev_qspi_partial_find(p_work, idx);
+        if (i < NRF_BLOCK_DEV_QSPI_DISCARD_PARTIAL)
+        {
+            blocks |= p_work->partial[i].blocks;
+            p_work->partial[i].idx = BD_ERASE_UNIT_INVALID_ID;
+        }
+
+        if (flushed)
+        {
+            /*Its data is being written: the discard is dropped*/
+        }
+        else if (blocks != all_blocks)
+        {
+            /*Remembered until the rest of the erase unit is discarded*/
+            if (i == NRF_BLOCK_DEV_QSPI_DISCARD_PARTIAL)
+            {
+                i = block_dev_qspi_partial_find(p_work, BD_ERASE_UNIT_INVALID_ID);
+            }
+            if (i == NRF_BLOCK_DEV_QSPI_DISCARD_PARTIAL)
+            {
+                i = p_work->partial_next;
+                p_work->partial_next = (i + 1) % NRF_BLOCK_DEV_QSPI_DISCARD_PARTIAL;
+            }
+
+            p_work->partial[i].idx = idx;
+            p_work->partial[i].blocks = blocks;
+        }
+        else
+        {
+            if (way < NRF_BLOCK_DEV_QSPI_CACHE_WAYS)
+            {
+                p_work->eunits[way].idx = BD_ERASE_UNIT_INVALID_ID;
+                p_work->eunits[way].dirty_pages = 0;
+                p_work->eunits[way].erase_required = false;
+            }
+
+            p_work->discard_map[idx / 32] |= 1u << (idx % 32);
+        }
+        CRITICAL_REGION_EXIT();
     }
+}
 
-    /*Case 1: Copy data from start erase unit*/
-    if (eunit_start == p_work->erase_unit_idx)
+/**
+ * @brief Copies a block request overlapping the dirty cache entries in write-back mode
+ *
+ * In write-back mode data that we read from the memory might not be the same as in the cache.
+ * */
+static void block_dev_qspi_read_from_eunit(nrf_block_dev_qspi_t const * p_qspi_dev)
+{
+    nrf_block_dev_qspi_work_t const * p_work = p_qspi_dev->p_work;
+    uint32_t blk_size = p_work->geometry.blk_size;
+    uint32_t req_end = p_work->req.blk_id + p_work->req.blk_count;
+
+    for (size_t way = 0; way < NRF_BLOCK_DEV_QSPI_CACHE_WAYS; way++)
     {
-         size_t blk = p_work->req.blk_id %
-                      BD_BLOCKS_PER_ERASEUNIT(p_work->geometry.blk_size);
-         size_t cnt = BD_BLOCKS_PER_ERASEUNIT(p_work->geometry.blk_size) - blk;
-         size_t off = p_work->geometry.blk_size * blk;
+        nrf_block_dev_qspi_eunit_t const * p_eunit = &p_work->eunits[way];
+
+        if ((p_eunit->idx == BD_ERASE_UNIT_INVALID_ID) || !block_dev_qspi_eunit_is_dirty(p_eunit))
+        {
+            continue;
+        }
 
-         if (cnt > p_work->req.blk_count)
-         {
-             cnt = p_work->req.blk_count;
-         }
+        uint32_t eunit_start = p_eunit->idx * BD_BLOCKS_PER_ERASEUNIT(blk_size);
+        uint32_t eunit_end = eunit_start + BD_BLOCKS_PER_ERASEUNIT(blk_size);
+        uint32_t start = MAX(eunit_start, p_work->req.blk_id);
+        uint32_t end = MIN(eunit_end, req_end);
 
-         memcpy(p_work->req.p_buff,
-                p_work->p_erase_unit_buff + off,
-                cnt * p_work->geometry.blk_size);
+        if (start >= end)
+        {
+            /*Read request doesn't hit this erase unit*/
+            continue;
+        }
 
-         return;
+        memcpy((uint8_t *)p_work->req.p_buff + (start - p_work->req.blk_id) * blk_size,
+               p_eunit->buff + (start - eunit_start) * blk_size,
+               (end - start) * blk_size);
     }
+}
 
-    /*Case 2: Copy data from end erase unit*/
-    if (eunit_end == p_work->erase_unit_idx)
+/**
+ * @brief Copies data to a cache entry and marks the pages that change
+ *
+ * @return True if the erase unit has to be erased: a bit changes from 0 to 1.
+ * */
+static bool block_dev_qspi_update_eunit(nrf_block_dev_qspi_eunit_t * p_eunit,
+                                        size_t off,
+                                        const void * p_src,
+                                        size_t len)
+{
+    ASSERT((len % sizeof(uint32_t)) == 0)
+
+    uint32_t *       p_dst32 = (uint32_t *)(p_eunit->buff + off);
+    const uint32_t * p_src32 = p_src;
+
+    bool erase_required = false;
+    len /= sizeof(uint32_t);
+
+    do
     {
-         size_t cnt = (p_work->req.blk_id + p_work->req.blk_count) %
-                       BD_BLOCKS_PER_ERASEUNIT(p_work->geometry.blk_size);
-         size_t off = (p_work->erase_unit_idx * BD_BLOCKS_PER_ERASEUNIT(p_work->geometry.blk_size) -
-                       p_work->req.blk_id) * p_work->geometry.blk_size;
+        if (*p_dst32 != *p_src32)
+        {
+            /*Programming can only clear bits*/
+            if ((*p_dst32 & *p_src32) != *p_src32)
+            {
+                erase_required = true;
+            }
 
-         if (cnt > p_work->req.blk_count)
-         {
-             cnt = p_work->req.blk_count;
-         }
+            /*Mark page as dirty*/
+            p_eunit->dirty_pages |= 1u << (off / BD_PAGE_PROGRAM_SIZE);
+        }
 
-         memcpy((uint8_t *)p_work->req.p_buff + off,
-                p_work->p_erase_unit_buff,
-                cnt * p_work->geometry.blk_size);
+        *p_dst32++ = *p_src32++;
+        off += sizeof(uint32_t);
+    } while (--len);
 
-         return;
+    return erase_required;
+}
+
+/**
+ * @brief Returns the mask of the pages of a cache entry that are not erased
+ * */
+static uint32_t block_dev_qspi_eunit_used_pages(nrf_block_dev_qspi_eunit_t const * p_eunit)
+{
+    uint32_t const * p_data32 = (uint32_t const *)p_eunit->buff;
+    uint32_t mask = 0;
+
+    for (size_t page = 0; page < BD_PAGES_PER_ERASEUNIT; page++)
+    {
+        for (size_t i = 0; i < BD_PAGE_PROGRAM_SIZE / sizeof(uint32_t); i++)
+        {
+            if (*p_data32++ != BD_ERASE_UNIT_ERASE_VAL)
+            {
+                mask |= 1u << page;
+                p_data32 += (BD_PAGE_PROGRAM_SIZE / sizeof(uint32_t)) - i - 1;
+                break;
+            }
+        }
     }
 
-    /*Case 3: Copy data from  eunit_start < p_work->erase_unit_idx < eunit_end*/
-    size_t off = (p_work->erase_unit_idx * BD_BLOCKS_PER_ERASEUNIT(p_work->geometry.blk_size) -
-                  p_work->req.blk_id) * p_work->geometry.blk_size;
+    return mask;
+}
+
+/**
+ * @brief Programs the next run of consecutive dirty pages of the cache entry being flushed
+ * */
+static ret_code_t block_dev_qspi_program_next(nrf_block_dev_qspi_t const * p_qspi_dev)
+{
+    nrf_block_dev_qspi_work_t *  p_work = p_qspi_dev->p_work;
+    nrf_block_dev_qspi_eunit_t * p_eunit = &p_work->eunits[p_work->flush_way];
 
-    memcpy((uint8_t *)p_work->req.p_buff + off,
-           p_work->p_erase_unit_buff,
-           NRF_BLOCK_DEV_QSPI_ERASE_UNIT_SIZE);
+    /*The mask has less than 32 pages, so the run always ends with a clear bit*/
+    uint32_t first = __CLZ(__RBIT(p_eunit->dirty_pages));
+    uint32_t count = __CLZ(__RBIT(~(p_eunit->dirty_pages >> first)));
+
+    p_work->program_mask = ((1u << count) - 1) << first;
+    p_work->state = NRF_BLOCK_DEV_QSPI_STATE_WRITE_EXEC;
+
+    return nrf_drv_qspi_write(p_eunit->buff + first * BD_PAGE_PROGRAM_SIZE,
+                              count * BD_PAGE_PROGRAM_SIZE,
+                              p_eunit->idx * NRF_BLOCK_DEV_QSPI_ERASE_UNIT_SIZE +
+                              first * BD_PAGE_PROGRAM_SIZE);
 }
 
 /**
- * @brief Active QSPI block device handle. Only one instance.
+ * @brief Starts writing a dirty cache entry to the memory
  * */
-static nrf_block_dev_qspi_t const * m_active_qspi_dev;
+static ret_code_t block_dev_qspi_eunit_flush_start(nrf_block_dev_qspi_t const * p_qspi_dev,
+                                                   size_t way)
+{
+    nrf_block_dev_qspi_work_t *  p_work = p_qspi_dev->p_work;
+    nrf_block_dev_qspi_eunit_t * p_eunit = &p_work->eunits[way];
+
+    p_work->flush_way = way;
+
+    if (!p_eunit->erase_required)
+    {
+        return block_dev_qspi_program_next(p_qspi_dev);
+    }
+
+    /*Erase is required. Pages that stay erased are not programmed after that.*/
+    p_eunit->erase_required = false;
+    p_eunit->dirty_pages = block_dev_qspi_eunit_used_pages(p_eunit);
+    p_work->state = NRF_BLOCK_DEV_QSPI_STATE_WRITE_ERASE;
+
+    return nrf_drv_qspi_erase(NRF_QSPI_ERASE_LEN_4KB,
+                              p_eunit->idx * NRF_BLOCK_DEV_QSPI_ERASE_UNIT_SIZE);
+}
+
+/**
+ * @brief Continues the cache flush request with the next dirty cache entry, then with the next
+ *        discarded erase unit
+ *
+ * A request received during the flush is started instead.
+ * */
+static ret_code_t block_dev_qspi_cache_flush_continue(nrf_block_dev_qspi_t const * p_qspi_dev)
+{
+    nrf_block_dev_qspi_work_t * p_work = p_qspi_dev->p_work;
+
+    if (p_work->pending_req)
+    {
+        ret_code_t ret;
+
+        p_work->pending_req = false;
+        p_work->cache_flushing = false;
+        p_work->flush_entries = false;
+
+        ret = p_work->pending_write ? block_dev_qspi_write_start(p_qspi_dev) :
+                                      block_dev_qspi_read_start(p_qspi_dev);
+        if (ret != NRF_SUCCESS)
+        {
+            block_dev_qspi_req_end(p_qspi_dev,
+                                   p_work->pending_write ? NRF_BLOCK_DEV_EVT_BLK_WRITE_DONE :
+                                                           NRF_BLOCK_DEV_EVT_BLK_READ_DONE,
+                                   NRF_BLOCK_DEV_RESULT_IO_ERROR);
+        }
+        return NRF_SUCCESS;
+    }
+
+    for (size_t way = 0; p_work->flush_entries && (way < NRF_BLOCK_DEV_QSPI_CACHE_WAYS); way++)
+    {
+        if (block_dev_qspi_eunit_is_dirty(&p_work->eunits[way]))
+        {
+            return block_dev_qspi_eunit_flush_start(p_qspi_dev, way);
+        }
+    }
+
+    for (size_t i = 0; i < ARRAY_SIZE(p_work->discard_map); i++)
+    {
+        if (p_work->discard_map[i] != 0)
+        {
+            /*Later writes to the erase unit only program pages*/
+            uint32_t idx = i * 32 + __CLZ(__RBIT(p_work->discard_map[i]));
+
+            p_work->discard_map[i] &= ~(1u << (idx % 32));
+            p_work->state = NRF_BLOCK_DEV_QSPI_STATE_DISCARD_ERASE;
+            return nrf_drv_qspi_erase(NRF_QSPI_ERASE_LEN_4KB,
+                                      idx * NRF_BLOCK_DEV_QSPI_ERASE_UNIT_SIZE);
+        }
+    }
+
+    p_work->cache_flushing = false;
+    p_work->flush_entries = false;
+    p_work->state = NRF_BLOCK_DEV_QSPI_STATE_IDLE;
+    return NRF_SUCCESS;
+}
 
 static void qspi_handler(nrf_drv_qspi_evt_t event, void * p_context)
 {
@@ -133,7 +485,7 @@ static void qspi_handler(nrf_drv_qspi_evt_t event, void * p_context)
 
     nrf_block_dev_qspi_t const * p_qspi_dev = p_context;
     nrf_block_dev_qspi_work_t *  p_work = p_qspi_dev->p_work;
-    nrf_block_req_t * p_blk_left = &p_work->left_req;
+    ret_code_t ret = NRF_SUCCESS;
 
     switch (p_work->state)
     {
@@ -144,104 +496,80 @@ static void qspi_handler(nrf_drv_qspi_evt_t event, void * p_context)
                 block_dev_qspi_read_from_eunit(p_qspi_dev);
             }
 
-            p_work->state = NRF_BLOCK_DEV_QSPI_STATE_IDLE;
-            if (p_work->ev_handler)
-            {
-                const nrf_block_dev_event_t ev = {
-                        NRF_BLOCK_DEV_EVT_BLK_READ_DONE,
-                        NRF_BLOCK_DEV_RESULT_SUCCESS,
-                        &p_work->req,
-                        p_work->p_context
-                };
-
-                p_work->ev_handler(&p_qspi_dev->block_dev, &ev);
-            }
-
+            block_dev_qspi_req_end(p_qspi_dev,
+                                   NRF_BLOCK_DEV_EVT_BLK_READ_DONE,
+                                   NRF_BLOCK_DEV_RESULT_SUCCESS);
             break;
         }
         case NRF_BLOCK_DEV_QSPI_STATE_EUNIT_LOAD:
         {
-            ret_code_t ret;
-            uint32_t erase_unit = BD_BLOCK_TO_ERASEUNIT(p_blk_left->blk_id,
-                                                        p_work->geometry.blk_size);
-            UNUSED_VARIABLE(erase_unit);
-            ASSERT(erase_unit == p_work->erase_unit_idx);
-
-            /* Check if block is in erase unit buffer*/
-            ret = block_dev_qspi_eunit_write(p_qspi_dev, p_blk_left);
-            ASSERT(ret == NRF_SUCCESS);
-            UNUSED_VARIABLE(ret);
+            ret = block_dev_qspi_write_continue(p_qspi_dev);
             break;
         }
         case NRF_BLOCK_DEV_QSPI_STATE_WRITE_ERASE:
         case NRF_BLOCK_DEV_QSPI_STATE_WRITE_EXEC:
         {
-            /*Clear last programmed block*/
-            uint32_t block_to_program = __CLZ(__RBIT(p_work->erase_unit_dirty_blocks));
+            nrf_block_dev_qspi_eunit_t * p_eunit = &p_work->eunits[p_work->flush_way];
 
             if (p_work->state == NRF_BLOCK_DEV_QSPI_STATE_WRITE_EXEC)
             {
-                p_work->erase_unit_dirty_blocks ^= 1u << block_to_program;
+                /*Clear last programmed pages*/
+                p_eunit->dirty_pages &= ~p_work->program_mask;
             }
 
-            if (p_work->erase_unit_dirty_blocks == 0)
+            if (p_eunit->dirty_pages != 0)
             {
-                if (p_work->left_req.blk_count)
-                {
-                    /*Load next erase unit*/
-                    ret_code_t ret;
-                    uint32_t eunit = BD_BLOCK_TO_ERASEUNIT(p_blk_left->blk_id,
-                                                           p_work->geometry.blk_size);
-
-                    p_work->erase_unit_idx = eunit;
-                    p_work->state = NRF_BLOCK_DEV_QSPI_STATE_EUNIT_LOAD;
-
-                    ret = nrf_drv_qspi_read(p_work->p_erase_unit_buff,
-                                            NRF_BLOCK_DEV_QSPI_ERASE_UNIT_SIZE,
-                                            p_work->erase_unit_idx *
-                                            NRF_BLOCK_DEV_QSPI_ERASE_UNIT_SIZE);
-                    UNUSED_VARIABLE(ret);
-
-                    break;
-                }
-
-                /*All blocks are programmed. Call event handler if required.*/
-                p_work->state = NRF_BLOCK_DEV_QSPI_STATE_IDLE;
-                if (p_work->ev_handler && !p_work->cache_flushing)
-                {
-                    const nrf_block_dev_event_t ev = {
-                            NRF_BLOCK_DEV_EVT_BLK_WRITE_DONE,
-                            NRF_BLOCK_DEV_RESULT_SUCCESS,
-                            &p_work->req,
-                            p_work->p_context
-                    };
-
-                    p_work->ev_handler(&p_qspi_dev->block_dev, &ev);
-                }
-
-                p_work->cache_flushing = false;
-                break;
+                ret = block_dev_qspi_program_next(p_qspi_dev);
+            }
+            else if (p_work->write_in_progress)
+            {
+                /*Erase unit is clean. Continue the write request.*/
+                ret = block_dev_qspi_write_continue(p_qspi_dev);
+            }
+            else
+            {
+                ret = block_dev_qspi_cache_flush_continue(p_qspi_dev);
             }
-
-            /*Get next block to program from program mask*/
-            block_to_program = __CLZ(__RBIT(p_work->erase_unit_dirty_blocks));
-            uint32_t dst_address = (p_work->erase_unit_idx * NRF_BLOCK_DEV_QSPI_ERASE_UNIT_SIZE) +
-                                   (block_to_program * p_work->geometry.blk_size);
-
-            const void * p_src_address = p_work->p_erase_unit_buff +
-                                         block_to_program * p_work->geometry.blk_size;
-
-            p_work->state = NRF_BLOCK_DEV_QSPI_STATE_WRITE_EXEC;
-            ret_code_t ret = nrf_drv_qspi_write(p_src_address,
-                                                p_work->geometry.blk_size,
-                                                dst_address);
-            UNUSED_VARIABLE(ret);
+            break;
+        }
+        case NRF_BLOCK_DEV_QSPI_STATE_DISCARD_ERASE:
+        {
+            ret = block_dev_qspi_cache_flush_continue(p_qspi_dev);
             break;
         }
         default:
             ASSERT(0);
             break;
     }
+
+    if (ret == NRF_SUCCESS)
+    {
+        return;
+    }
+
+    if (p_work->write_in_progress)
+    {
+        block_dev_qspi_req_end(p_qspi_dev,
+                               NRF_BLOCK_DEV_EVT_BLK_WRITE_DONE,
+                               NRF_BLOCK_DEV_RESULT_IO_ERROR);
+    }
+    else if (p_work->pending_req)
+    {
+        /*Cache flush failed. Report the request that was waiting for it.*/
+        p_work->pending_req = false;
+        p_work->cache_flushing = false;
+        p_work->flush_entries = false;
+        block_dev_qspi_req_end(p_qspi_dev,
+                               p_work->pending_write ? NRF_BLOCK_DEV_EVT_BLK_WRITE_DONE :
+                                                       NRF_BLOCK_DEV_EVT_BLK_READ_DONE,
+                               NRF_BLOCK_DEV_RESULT_IO_ERROR);
+    }
+    else
+    {
+        p_work->cache_flushing = false;
+        p_work->flush_entries = false;
+        p_work->state = NRF_BLOCK_DEV_QSPI_STATE_IDLE;
+    }
 }
 
 static void wait_for_idle(nrf_block_dev_qspi_t const * p_qspi_dev)
@@ -350,7 +678,14 @@ static ret_code_t block_dev_qspi_init(nrf_block_dev_t const * p_blk_dev,
     p_work->ev_handler = ev_handler;
 
     p_work->state = NRF_BLOCK_DEV_QSPI_STATE_IDLE;
-    p_work->erase_unit_idx = BD_ERASE_UNIT_INVALID_ID;
+    for (size_t way = 0; way < NRF_BLOCK_DEV_QSPI_CACHE_WAYS; way++)
+    {
+        p_work->eunits[way].idx = BD_ERASE_UNIT_INVALID_ID;
+    }
+    for (size_t i = 0; i < NRF_BLOCK_DEV_QSPI_DISCARD_PARTIAL; i++)
+    {
+        p_work->partial[i].idx = BD_ERASE_UNIT_INVALID_ID;
+    }
     p_work->writeback_mode =  (p_qspi_dev->qspi_bdev_config.flags &
                                NRF_BLOCK_DEV_QSPI_FLAG_CACHE_WRITEBACK) != 0;
     m_active_qspi_dev = p_qspi_dev;
@@ -411,6 +746,47 @@ static ret_code_t block_dev_qspi_uninit(nrf_block_dev_t const * p_blk_dev)
     return NRF_SUCCESS;
 }
 
+/**
+ * @brief Starts a read request from @ref nrf_block_dev_qspi_work_t::req
+ *
+ * A request that lies in one cached erase unit is served from the cache.
+ * */
+static ret_code_t block_dev_qspi_read_start(nrf_block_dev_qspi_t const * p_qspi_dev)
+{
+    nrf_block_dev_qspi_work_t * p_work = p_qspi_dev->p_work;
+    nrf_block_req_t const *     p_blk = &p_work->req;
+    uint32_t blk_size = p_work->geometry.blk_size;
+
+    uint32_t eunit_start = BD_BLOCK_TO_ERASEUNIT(p_blk->blk_id, blk_size);
+    uint32_t eunit_end = BD_BLOCK_TO_ERASEUNIT(p_blk->blk_id + p_blk->blk_count - 1, blk_size);
+    size_t   way = block_dev_qspi_eunit_find(p_work, eunit_start);
+
+    if ((eunit_start == eunit_end) && (way < NRF_BLOCK_DEV_QSPI_CACHE_WAYS))
+    {
+        nrf_block_dev_qspi_eunit_t * p_eunit = &p_work->eunits[way];
+        size_t off = (p_blk->blk_id % BD_BLOCKS_PER_ERASEUNIT(blk_size)) * blk_size;
+
+        memcpy(p_blk->p_buff, p_eunit->buff + off, p_blk->blk_count * blk_size);
+        p_eunit->last_use = ++p_work->use_counter;
+
+        block_dev_qspi_req_end(p_qspi_dev,
+                               NRF_BLOCK_DEV_EVT_BLK_READ_DONE,
+                               NRF_BLOCK_DEV_RESULT_SUCCESS);
+        return NRF_SUCCESS;
+    }
+
+    p_work->state = NRF_BLOCK_DEV_QSPI_STATE_READ_EXEC;
+    ret_code_t ret = nrf_drv_qspi_read(p_blk->p_buff,
+                                       p_blk->blk_count * blk_size,
+                                       p_blk->blk_id * blk_size);
+    if (ret != NRF_SUCCESS)
+    {
+        p_work->state = NRF_BLOCK_DEV_QSPI_STATE_IDLE;
+    }
+
+    return ret;
+}
+
 static ret_code_t block_dev_qspi_read_req(nrf_block_dev_t const * p_blk_dev,
                                           nrf_block_req_t const * p_blk)
 {
@@ -421,6 +797,7 @@ static ret_code_t block_dev_qspi_read_req(nrf_block_dev_t const * p_blk_dev,
     nrf_block_dev_qspi_work_t *  p_work = p_qspi_dev->p_work;
 
     ret_code_t ret = NRF_SUCCESS;
+    bool deferred = false;
 
     if (m_active_qspi_dev != p_qspi_dev)
     {
@@ -428,29 +805,39 @@ static ret_code_t block_dev_qspi_read_req(nrf_block_dev_t const * p_blk_dev,
         return NRF_ERROR_BUSY;
     }
 
-    if (p_work->state != NRF_BLOCK_DEV_QSPI_STATE_IDLE)
+    CRITICAL_REGION_ENTER();
+    if (p_work->cache_flushing && !p_work->pending_req)
+    {
+        /* Started when the cache entry being flushed has been written*/
+        p_work->req = *p_blk;
+        p_work->left_req = *p_blk;
+        p_work->pending_write = false;
+        p_work->pending_req = true;
+        deferred = true;
+    }
+    else if (p_work->state != NRF_BLOCK_DEV_QSPI_STATE_IDLE)
     {
         /* Previous asynchronous operation in progress*/
-        return NRF_ERROR_BUSY;
+        ret = NRF_ERROR_BUSY;
     }
-
-    p_work->left_req = *p_blk;
-    p_work->req = *p_blk;
-    nrf_block_req_t * p_blk_left = &p_work->left_req;
-
-    p_work->state = NRF_BLOCK_DEV_QSPI_STATE_READ_EXEC;
-    ret = nrf_drv_qspi_read(p_blk_left->p_buff,
-                            p_blk_left->blk_count * p_work->geometry.blk_size,
-                            p_blk_left->blk_id * p_work->geometry.blk_size);
+    CRITICAL_REGION_EXIT();
 
     if (ret != NRF_SUCCESS)
     {
-        p_work->state = NRF_BLOCK_DEV_QSPI_STATE_IDLE;
         return ret;
     }
 
-    p_blk_left->p_buff = NULL;
-    p_blk_left->blk_count = 0;
+    if (!deferred)
+    {
+        p_work->req = *p_blk;
+        p_work->left_req = *p_blk;
+
+        ret = block_dev_qspi_read_start(p_qspi_dev);
+        if (ret != NRF_SUCCESS)
+        {
+            return ret;
+        }
+    }
 
     if (!p_work->ev_handler && (p_work->state != NRF_BLOCK_DEV_QSPI_STATE_IDLE))
     {
@@ -458,126 +845,116 @@ static ret_code_t block_dev_qspi_read_req(nrf_block_dev_t const * p_blk_dev,
         wait_for_idle(p_qspi_dev);
     }
 
-    return ret;
+    return NRF_SUCCESS;
 }
 
-static bool block_dev_qspi_update_eunit(nrf_block_dev_qspi_t const * p_qspi_dev,
-                                        size_t off,
-                                        const void * p_src,
-                                        size_t len)
+/**
+ * @brief Continues the write request in @ref nrf_block_dev_qspi_work_t::left_req
+ *
+ * Blocks are copied to the cache entries of their erase units. An erase unit that is not cached
+ * is loaded first, to the least recently used entry, which is flushed if it is dirty. In
+ * write-through mode every entry is flushed as soon as it has been written.
+ * */
+static ret_code_t block_dev_qspi_write_continue(nrf_block_dev_qspi_t const * p_qspi_dev)
 {
-    ASSERT((len % sizeof(uint32_t)) == 0)
-    nrf_block_dev_qspi_work_t *  p_work = p_qspi_dev->p_work;
-
-    uint32_t *       p_dst32 = (uint32_t *)(p_work->p_erase_unit_buff + off);
-    const uint32_t * p_src32 = p_src;
-
-    bool erase_required = false;
-    len /= sizeof(uint32_t);
+    nrf_block_dev_qspi_work_t * p_work = p_qspi_dev->p_work;
+    nrf_block_req_t *           p_blk_left = &p_work->left_req;
+    uint32_t blk_size = p_work->geometry.blk_size;
 
-    /*Do normal copying until erase unit is not required*/
-    do
+    while (p_blk_left->blk_count)
     {
-        if (*p_dst32 != *p_src32)
+        uint32_t erase_unit = BD_BLOCK_TO_ERASEUNIT(p_blk_left->blk_id, blk_size);
+        size_t   way = block_dev_qspi_eunit_find(p_work, erase_unit);
+        nrf_block_dev_qspi_eunit_t * p_eunit;
+
+        if (way == NRF_BLOCK_DEV_QSPI_CACHE_WAYS)
         {
-            if (*p_dst32 != BD_ERASE_UNIT_ERASE_VAL)
+            way = block_dev_qspi_eunit_victim(p_work);
+            p_eunit = &p_work->eunits[way];
+
+            if (block_dev_qspi_eunit_is_dirty(p_eunit))
             {
-                erase_required = true;
+                /*Evict the entry. The write continues when it has been flushed.*/
+                return block_dev_qspi_eunit_flush_start(p_qspi_dev, way);
             }
 
-            /*Mark block as dirty*/
-            p_work->erase_unit_dirty_blocks |= 1u << (off / p_work->geometry.blk_size);
-        }
+            p_eunit->idx = erase_unit;
+            p_eunit->dirty_pages = 0;
+            p_eunit->erase_required = false;
+            p_eunit->last_use = ++p_work->use_counter;
 
-        *p_dst32++ = *p_src32++;
-        off += sizeof(uint32_t);
-    } while (--len);
-
-    return erase_required;
-}
-
-static ret_code_t block_dev_qspi_write_start(nrf_block_dev_qspi_t const * p_qspi_dev)
-{
-    nrf_block_dev_qspi_work_t *  p_work = p_qspi_dev->p_work;
+            if (block_dev_qspi_discard_pending(p_work, erase_unit))
+            {
+                /*The data is discarded and not erased yet: no need to load it*/
+                memset(p_eunit->buff, 0xFF, NRF_BLOCK_DEV_QSPI_ERASE_UNIT_SIZE);
+                p_eunit->erase_required = true;
+                continue;
+            }
 
-    if (!p_work->erase_required)
-    {
-        /*Get first block to program from program mask*/
-        uint32_t block_to_program = __CLZ(__RBIT(p_work->erase_unit_dirty_blocks));
-        uint32_t dst_address = (p_work->erase_unit_idx * NRF_BLOCK_DEV_QSPI_ERASE_UNIT_SIZE) +
-                               (block_to_program * p_work->geometry.blk_size);
+            p_work->state = NRF_BLOCK_DEV_QSPI_STATE_EUNIT_LOAD;
 
-        const void * p_src_address = p_work->p_erase_unit_buff +
-                                     block_to_program * p_work->geometry.blk_size;
+            ret_code_t ret = nrf_drv_qspi_read(p_eunit->buff,
+                                               NRF_BLOCK_DEV_QSPI_ERASE_UNIT_SIZE,
+                                               erase_unit * NRF_BLOCK_DEV_QSPI_ERASE_UNIT_SIZE);
+            if (ret != NRF_SUCCESS)
+            {
+                p_eunit->idx = BD_ERASE_UNIT_INVALID_ID;
+            }
+            return ret;
+        }
 
-        p_work->state = NRF_BLOCK_DEV_QSPI_STATE_WRITE_EXEC;
-        return nrf_drv_qspi_write(p_src_address,
-                                  p_work->geometry.blk_size,
-                                  dst_address);
-    }
+        p_eunit = &p_work->eunits[way];
+        p_eunit->last_use = ++p_work->use_counter;
 
-    /*Erase is required*/
-    uint32_t address = (p_work->erase_unit_idx * NRF_BLOCK_DEV_QSPI_ERASE_UNIT_SIZE);
-    p_work->state = NRF_BLOCK_DEV_QSPI_STATE_WRITE_ERASE;
-    p_work->erase_required = false;
+        size_t blk = p_blk_left->blk_id % BD_BLOCKS_PER_ERASEUNIT(blk_size);
+        size_t cnt = BD_BLOCKS_PER_ERASEUNIT(blk_size) - blk;
 
-    return nrf_drv_qspi_erase(NRF_QSPI_ERASE_LEN_4KB, address);
-}
+        if (cnt > p_blk_left->blk_count)
+        {
+            cnt = p_blk_left->blk_count;
+        }
 
-static ret_code_t block_dev_qspi_eunit_write(nrf_block_dev_qspi_t const * p_qspi_dev,
-                                             nrf_block_req_t * p_blk_left)
-{
-    nrf_block_dev_qspi_work_t *  p_work = p_qspi_dev->p_work;
+        /*The blocks of the erase unit are used again*/
+        block_dev_qspi_discard_clear(p_work, erase_unit);
 
-    size_t blk = p_blk_left->blk_id %
-                 BD_BLOCKS_PER_ERASEUNIT(p_work->geometry.blk_size);
-    size_t cnt = BD_BLOCKS_PER_ERASEUNIT(p_work->geometry.blk_size) - blk;
-    size_t off = p_work->geometry.blk_size * blk;
+        if (block_dev_qspi_update_eunit(p_eunit, blk * blk_size, p_blk_left->p_buff, cnt * blk_size))
+        {
+            p_eunit->erase_required = true;
+        }
 
-    if (cnt > p_blk_left->blk_count)
-    {
-        cnt = p_blk_left->blk_count;
-    }
+        p_blk_left->blk_count -= cnt;
+        p_blk_left->blk_id += cnt;
+        p_blk_left->p_buff = (uint8_t *)p_blk_left->p_buff + cnt * blk_size;
 
-    bool erase_required = block_dev_qspi_update_eunit(p_qspi_dev,
-                                                      off,
-                                                      p_blk_left->p_buff,
-                                                      cnt * p_work->geometry.blk_size);
-    if (erase_required)
-    {
-        p_work->erase_required = true;
+        if (!p_work->writeback_mode && block_dev_qspi_eunit_is_dirty(p_eunit))
+        {
+            return block_dev_qspi_eunit_flush_start(p_qspi_dev, way);
+        }
     }
 
-    p_blk_left->blk_count -= cnt;
-    p_blk_left->blk_id += cnt;
-    p_blk_left->p_buff = (uint8_t *)p_blk_left->p_buff + cnt * p_work->geometry.blk_size;
+    /*All blocks are in the cache, or programmed in write-through mode*/
+    block_dev_qspi_req_end(p_qspi_dev,
+                           NRF_BLOCK_DEV_EVT_BLK_WRITE_DONE,
+                           NRF_BLOCK_DEV_RESULT_SUCCESS);
+    return NRF_SUCCESS;
+}
 
-    if (p_work->erase_required)
-    {
-        uint32_t blk_size = p_work->geometry.blk_size;
-        p_work->erase_unit_dirty_blocks |= (1u << BD_BLOCKS_PER_ERASEUNIT(blk_size)) - 1;
-    }
+/**
+ * @brief Starts a write request from @ref nrf_block_dev_qspi_work_t::left_req
+ * */
+static ret_code_t block_dev_qspi_write_start(nrf_block_dev_qspi_t const * p_qspi_dev)
+{
+    nrf_block_dev_qspi_work_t * p_work = p_qspi_dev->p_work;
 
-    if (p_work->erase_unit_dirty_blocks == 0 || p_work->writeback_mode)
+    p_work->write_in_progress = true;
+    ret_code_t ret = block_dev_qspi_write_continue(p_qspi_dev);
+    if (ret != NRF_SUCCESS)
     {
-        /*No dirty blocks detected. Write end.*/
-        if (p_work->ev_handler && p_blk_left->blk_count == 0)
-        {
-            const nrf_block_dev_event_t ev = {
-                    NRF_BLOCK_DEV_EVT_BLK_WRITE_DONE,
-                    NRF_BLOCK_DEV_RESULT_SUCCESS,
-                    &p_work->req,
-                    p_work->p_context
-            };
-
-
-            p_work->state = NRF_BLOCK_DEV_QSPI_STATE_IDLE;
-            p_work->ev_handler(&p_qspi_dev->block_dev, &ev);
-            return NRF_SUCCESS;
-        }
+        p_work->write_in_progress = false;
+        p_work->state = NRF_BLOCK_DEV_QSPI_STATE_IDLE;
     }
 
-    return block_dev_qspi_write_start(p_qspi_dev);
+    return ret;
 }
 
 static ret_code_t block_dev_qspi_write_req(nrf_block_dev_t const * p_blk_dev,
@@ -590,6 +967,7 @@ static ret_code_t block_dev_qspi_write_req(nrf_block_dev_t const * p_blk_dev,
     nrf_block_dev_qspi_work_t *  p_work = p_qspi_dev->p_work;
 
     ret_code_t ret = NRF_SUCCESS;
+    bool deferred = false;
 
     if (m_active_qspi_dev != p_qspi_dev)
     {
@@ -597,55 +975,47 @@ static ret_code_t block_dev_qspi_write_req(nrf_block_dev_t const * p_blk_dev,
         return NRF_ERROR_BUSY;
     }
 
-    if (p_work->state != NRF_BLOCK_DEV_QSPI_STATE_IDLE)
+    CRITICAL_REGION_ENTER();
+    if (p_work->cache_flushing && !p_work->pending_req)
+    {
+        /* Started when the cache entry being flushed has been written*/
+        p_work->req = *p_blk;
+        p_work->left_req = *p_blk;
+        p_work->pending_write = true;
+        p_work->pending_req = true;
+        deferred = true;
+    }
+    else if (p_work->state != NRF_BLOCK_DEV_QSPI_STATE_IDLE)
     {
         /* Previous asynchronous operation in progress*/
-        return NRF_ERROR_BUSY;
+        ret = NRF_ERROR_BUSY;
     }
+    CRITICAL_REGION_EXIT();
 
-    p_work->left_req = *p_blk;
-    p_work->req = *p_blk;
-
-    nrf_block_req_t * p_blk_left = &p_work->left_req;
-
-    uint32_t erase_unit = BD_BLOCK_TO_ERASEUNIT(p_blk_left->blk_id,
-                                                p_work->geometry.blk_size);
-
-    /* Check if block is in erase unit buffer*/
-    if (erase_unit == p_work->erase_unit_idx)
+    if (ret != NRF_SUCCESS)
     {
-        ret = block_dev_qspi_eunit_write(p_qspi_dev, p_blk_left);
+        return ret;
     }
-    else
+
+    if (!deferred)
     {
-        if (p_work->writeback_mode)
-        {
-            ret = block_dev_qspi_write_start(p_qspi_dev);
-        }
-        else
-        {
-            p_work->erase_unit_idx = erase_unit;
-            p_work->state = NRF_BLOCK_DEV_QSPI_STATE_EUNIT_LOAD;
+        p_work->req = *p_blk;
+        p_work->left_req = *p_blk;
 
-            ret = nrf_drv_qspi_read(p_work->p_erase_unit_buff,
-                    NRF_BLOCK_DEV_QSPI_ERASE_UNIT_SIZE,
-                    erase_unit * NRF_BLOCK_DEV_QSPI_ERASE_UNIT_SIZE);
+        ret = block_dev_qspi_write_start(p_qspi_dev);
+        if (ret != NRF_SUCCESS)
+        {
+            return ret;
         }
     }
 
-    if (ret != NRF_SUCCESS)
-    {
-        p_work->state = NRF_BLOCK_DEV_QSPI_STATE_IDLE;
-        return ret;
-    }
-
     if (!p_work->ev_handler && (p_work->state != NRF_BLOCK_DEV_QSPI_STATE_IDLE))
     {
         /*Synchronous operation*/
         wait_for_idle(p_qspi_dev);
     }
 
-    return ret;
+    return NRF_SUCCESS;
 }
 
 static ret_code_t block_dev_qspi_ioctl(nrf_block_dev_t const * p_blk_dev,
@@ -667,27 +1037,59 @@ static ret_code_t block_dev_qspi_ioctl(nrf_block_dev_t const * p_blk_dev,
                 return NRF_ERROR_BUSY;
             }
 
-            if (!p_work->writeback_mode || p_work->erase_unit_dirty_blocks == 0)
+            /*Flush is started from the first dirty cache entry*/
+            p_work->cache_flushing = true;
+            p_work->flush_entries = true;
+            ret_code_t ret = block_dev_qspi_cache_flush_continue(p_qspi_dev);
+            if (ret != NRF_SUCCESS)
             {
-                if (p_flushing)
-                {
-                    *p_flushing = false;
-                }
+                p_work->cache_flushing = false;
+                p_work->flush_entries = false;
+                p_work->state = NRF_BLOCK_DEV_QSPI_STATE_IDLE;
+                return ret;
+            }
 
+            if (p_flushing)
+            {
+                *p_flushing = p_work->cache_flushing;
+            }
+
+            return NRF_SUCCESS;
+        }
+        case NRF_BLOCK_DEV_IOCTL_REQ_DISCARD:
+        {
+            nrf_block_req_t const * p_blk = p_data;
+            if ((p_blk == NULL) ||
+                (p_blk->blk_id > p_work->geometry.blk_count) ||
+                (p_blk->blk_count > p_work->geometry.blk_count - p_blk->blk_id))
+            {
+                return NRF_ERROR_INVALID_PARAM;
+            }
+
+            if ((p_work->state != NRF_BLOCK_DEV_QSPI_STATE_IDLE) &&
+                (!p_work->cache_flushing || p_work->pending_req))
+            {
+                return NRF_ERROR_BUSY;
+            }
+
+            block_dev_qspi_discard(p_qspi_dev, p_blk);
+            if (p_work->state != NRF_BLOCK_DEV_QSPI_STATE_IDLE)
+            {
+                /*The flush in progress erases them*/
                 return NRF_SUCCESS;
             }
 
-            ret_code_t ret =  block_dev_qspi_write_start(p_qspi_dev);
-            if (ret == NRF_SUCCESS)
+            /*Discarded erase units are erased in the background*/
+            p_work->cache_flushing = true;
+            ret_code_t ret = block_dev_qspi_cache_flush_continue(p_qspi_dev);
+            if (ret != NRF_SUCCESS)
             {
-                if (p_flushing)
-                {
-                    *p_flushing = true;
-                }
-                p_work->cache_flushing = true;
+                p_work->cache_flushing = false;
+                p_work->state = NRF_BLOCK_DEV_QSPI_STATE_IDLE;
+                return ret;
             }
 
-            return ret;
+            return NRF_SUCCESS;
         }
         case NRF_BLOCK_DEV_IOCTL_REQ_INFO_STRINGS:
         {
@@ -38,6 +38,35 @@ extern const nrf_block_dev_ops_t nrf_block_device_qspi_ops;
  * */
 #define NRF_BLOCK_DEV_QSPI_ERASE_UNIT_SIZE (4096)
 
+/**
+ * @brief Number of erase units held in the cache. Each one takes
+ *        @ref NRF_BLOCK_DEV_QSPI_ERASE_UNIT_SIZE bytes of RAM.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ * */
+#ifndef NRF_BLOCK_DEV_QSPI_CACHE_WAYS
+#define NRF_BLOCK_DEV_QSPI_CACHE_WAYS (2)
+#endif
+
+/**
+ * @brief Number of erase units, from the start of the memory, that can be discarded. Discarded
+ *        erase units are kept in a bitmap, one bit per erase unit.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ * */
+#ifndef NRF_BLOCK_DEV_QSPI_DISCARD_UNITS
+#define NRF_BLOCK_DEV_QSPI_DISCARD_UNITS (2048)
+#endif
+
+/**
+ * @brief Number of partially discarded erase units whose discarded blocks are remembered.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ * */
+#ifndef NRF_BLOCK_DEV_QSPI_DISCARD_PARTIAL
+#define NRF_BLOCK_DEV_QSPI_DISCARD_PARTIAL (4)
+#endif
+
 /**
  * @brief Internal Block device state
  */
@@ -48,8 +77,28 @@ typedef enum {
     NRF_BLOCK_DEV_QSPI_STATE_EUNIT_LOAD,    /**< QSPI block device state EUNIT_LOAD    */
     NRF_BLOCK_DEV_QSPI_STATE_WRITE_ERASE,   /**< QSPI block device state WRITE_ERASE   */
     NRF_BLOCK_DEV_QSPI_STATE_WRITE_EXEC,    /**< QSPI block device state WRITE_EXEC    */
+    NRF_BLOCK_DEV_QSPI_STATE_DISCARD_ERASE, /**< QSPI block device state DISCARD_ERASE */
 } nrf_block_dev_qspi_state_t;
 
+/**
+ * @brief Cached erase unit of QSPI block device
+ */
+typedef struct {
+    uint32_t idx;                                           //!< Erase unit index, invalid if the entry is free
+    uint32_t dirty_pages;                                   //!< Mask of the program pages that differ from the memory
+    uint32_t last_use;                                      //!< Use counter value of the last access (LRU eviction)
+    bool     erase_required;                                //!< Some bit has to go from 0 to 1, so the unit has to be erased
+    uint8_t  buff[NRF_BLOCK_DEV_QSPI_ERASE_UNIT_SIZE];      //!< Erase unit data
+} nrf_block_dev_qspi_eunit_t;
+
+/**
+ * @brief Partially discarded erase unit of QSPI block device
+ */
+typedef struct {
+    uint32_t idx;                                           //!< Erase unit index, invalid if the entry is free
+    uint32_t blocks;                                        //!< Mask of the discarded blocks
+} nrf_block_dev_qspi_partial_t;
+
 /**
  * @brief Work structure of QSPI block device
  */
@@ -62,12 +111,21 @@ typedef struct {
     nrf_block_req_t          req;                     //!< Block READ/WRITE request: original value
     nrf_block_req_t          left_req;                //!< Block READ/WRITE request: left value
 
-    bool     cache_flushing;                                        //!< QSPI cache flush in progress flag
-    bool     writeback_mode;                                        //!< QSPI write-back mode flag
-    bool     erase_required;                                        //!< QSPI erase required flag
-    uint32_t erase_unit_idx;                                        //!< QSPI erase unit index
-    uint32_t erase_unit_dirty_blocks;                               //!< QSPI erase unit dirty blocks mask
-    uint8_t  p_erase_unit_buff[NRF_BLOCK_DEV_QSPI_ERASE_UNIT_SIZE]; //!< QSPI erase unit buffer (fixed value)
+    bool     cache_flushing;                          //!< QSPI cache flush or discard erase in progress flag
+    bool     flush_entries;                           //!< Dirty cache entries are written by the flush
+    bool     writeback_mode;                          //!< QSPI write-back mode flag
+    bool     write_in_progress;                       //!< Write request in progress flag
+    bool     pending_req;                             //!< Request received during cache flush flag
+    bool     pending_write;                           //!< Request received during cache flush is a write
+    uint8_t  flush_way;                               //!< Cache entry being written to the memory
+    uint32_t program_mask;                            //!< Mask of the pages being programmed
+    uint32_t use_counter;                             //!< Cache access counter
+    uint8_t  partial_next;                            //!< Partial discard entry replaced next
+
+    uint32_t discard_map[CEIL_DIV(NRF_BLOCK_DEV_QSPI_DISCARD_UNITS, 32)]; //!< Discarded erase units not erased yet
+    nrf_block_dev_qspi_partial_t partial[NRF_BLOCK_DEV_QSPI_DISCARD_PARTIAL]; //!< Partially discarded erase units
+
+    nrf_block_dev_qspi_eunit_t eunits[NRF_BLOCK_DEV_QSPI_CACHE_WAYS]; //!< Erase unit cache
 } nrf_block_dev_qspi_work_t;
 
 /**
@@ -76,6 +134,24 @@ typedef enum {
     NRF_BLOCK_DEV_QSPI_FLAG_CACHE_WRITEBACK = (1u << 0)  //!< Cache write-back mode enable flag
 } nrf_block_dev_qspi_flag_t;
 
+/*
+ * The erase units that were written last are held in a cache of NRF_BLOCK_DEV_QSPI_CACHE_WAYS
+ * entries, and the least recently used one is evicted. Only the program pages that changed are
+ * programmed, and the erase unit is erased only if some bit has to go from 0 to 1.
+ *
+ * In write-back mode, dirty entries are written to the memory when they are evicted, or on the
+ * NRF_BLOCK_DEV_IOCTL_REQ_CACHE_FLUSH request. The flush is asynchronous, so the application can
+ * request it when the device goes idle. A read or write request that is received during the flush
+ * is started when the current entry has been written, and the rest of the flush is left for the
+ * next flush request.
+ *
+ * On the NRF_BLOCK_DEV_IOCTL_REQ_DISCARD request, erase units whose blocks are all discarded are
+ * dropped from the cache and erased in the background, the same way as a flush, so that later
+ * writes to them only program pages. Discarded blocks of other erase units are remembered in
+ * NRF_BLOCK_DEV_QSPI_DISCARD_PARTIAL entries until the rest of the erase unit is discarded. An
+ * erase unit that is written before it has been erased is not read from the memory.
+ */
+
 /**
  * @brief QSPI block device config initializer (@ref nrf_block_dev_qspi_config_t)
  *
@@ -28,6 +28,10 @@ static ret_code_t block_dev_ram_init(nrf_block_dev_t const * p_blk_dev,
     nrf_block_dev_ram_t const * p_ram_dev = CONTAINER_OF(p_blk_dev, nrf_block_dev_ram_t, block_dev);
     nrf_block_dev_ram_work_t * p_work = p_ram_dev->p_work;
 
+    /*Blocks are read in place by EasyDMA: word aligned buffer and blocks*/
+    ASSERT(((uint32_t)p_ram_dev->ram_config.p_work_buffer & 3) == 0);
+    ASSERT((p_ram_dev->ram_config.block_size & 3) == 0);
+
     /* Calculate block device geometry.... */
     p_work->geometry.blk_size = p_ram_dev->ram_config.block_size;
     p_work->geometry.blk_count = p_ram_dev->ram_config.size /
@@ -84,7 +88,13 @@ static ret_code_t block_dev_ram_req(nrf_block_dev_t const * p_blk_dev,
     nrf_block_dev_ram_config_t const * p_ram_config = &p_ram_dev->ram_config;
     nrf_block_dev_ram_work_t const * p_work = p_ram_dev->p_work;
 
-    /*Synchronous operation*/
+    if ((p_blk->blk_id >= p_work->geometry.blk_count) ||
+        (p_blk->blk_count > p_work->geometry.blk_count - p_blk->blk_id))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    /*Synchronous operation: all the blocks are copied, a single event is sent*/
     uint8_t * p_buff = p_ram_config->p_work_buffer;
     p_buff += p_blk->blk_id * p_work->geometry.blk_size;
 
@@ -148,6 +158,25 @@ static ret_code_t block_dev_ram_ioctl(nrf_block_dev_t const * p_blk_dev,
             *pp_strings = &p_ram_dev->info_strings;
             return NRF_SUCCESS;
         }
+        case NRF_BLOCK_DEV_IOCTL_REQ_BLOCK_PTR:
+        {
+            nrf_block_req_t * p_blk = p_data;
+            nrf_block_dev_ram_work_t const * p_work = p_ram_dev->p_work;
+            if (p_blk == NULL)
+            {
+                return NRF_ERROR_INVALID_PARAM;
+            }
+
+            if ((p_blk->blk_id >= p_work->geometry.blk_count) ||
+                (p_blk->blk_count > p_work->geometry.blk_count - p_blk->blk_id))
+            {
+                return NRF_ERROR_INVALID_ADDR;
+            }
+
+            p_blk->p_buff = (uint8_t *)p_ram_dev->ram_config.p_work_buffer +
+                            p_blk->blk_id * p_work->geometry.blk_size;
+            return NRF_SUCCESS;
+        }
         default:
             break;
     }
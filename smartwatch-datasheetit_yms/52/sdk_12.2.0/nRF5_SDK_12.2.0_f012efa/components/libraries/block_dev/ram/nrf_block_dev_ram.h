@@ -27,6 +27,11 @@ extern "C" {
 
  *
  * @brief This module implements block device API. It should be used as a reference block device.
+ *
+ * @details Requests are completed before they return, with a single event for all their blocks.
+ *          @ref NRF_BLOCK_DEV_IOCTL_REQ_BLOCK_PTR gives the blocks in the work buffer, so that
+ *          they are sent by EasyDMA without a copy. The work buffer and the block size must then
+ *          be word aligned.
  */
 
 /**
@@ -62,7 +67,7 @@ typedef struct {
  */
 typedef struct {
     uint32_t block_size;        //!< Desired block size
-    void *   p_work_buffer;     //!< Ram work buffer
+    void *   p_work_buffer;     //!< Ram work buffer, word aligned
     size_t   size;              //!< Ram work buffer size
 } nrf_block_dev_ram_config_t;
 
@@ -0,0 +1,343 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(NRF_BOOT_INIT)
+#include "nrf_boot_init.h"
+#include <string.h>
+#include "app_util_platform.h"
+
+#define NRF_LOG_MODULE_NAME "BOOT"
+#include "nrf_log.h"
+
+// Create section "boot_init_steps".
+//lint -esym(526, boot_init_stepsBase) -esym(526, boot_init_stepsLimit)
+NRF_SECTION_VARS_CREATE_SECTION(boot_init_steps, nrf_boot_init_step_t const);
+
+// Helper macros for section variables.
+#define STEP_SECTION_VARS_GET(i)    NRF_SECTION_VARS_GET((i),                           \
+                                                         nrf_boot_init_step_t const,    \
+                                                         boot_init_steps)
+#define STEP_SECTION_VARS_COUNT     NRF_SECTION_VARS_COUNT(nrf_boot_init_step_t const,  \
+                                                           boot_init_steps)
+
+static struct
+{
+    nrf_boot_init_evt_handler_t    evt_handler;
+    nrf_boot_init_timestamp_func_t timestamp_func;
+    nrf_boot_init_step_t const   * p_steps[NRF_BOOT_INIT_MAX_STEPS]; /**< Steps, by identifier. */
+    uint32_t                       registered;                       /**< Identifiers of the steps. */
+    uint32_t                       started;                          /**< Steps started, or failed without starting. */
+    volatile uint32_t              done;                             /**< Steps completed. */
+    volatile uint32_t              failed;                           /**< Steps failed. */
+    uint32_t                       reported;                         /**< Steps reported with an event. */
+    ret_code_t                     results[NRF_BOOT_INIT_MAX_STEPS];
+    uint32_t                       start_ts[NRF_BOOT_INIT_MAX_STEPS];
+    uint32_t                       end_ts[NRF_BOOT_INIT_MAX_STEPS];
+    ret_code_t                     first_error;
+    bool                           running;
+    bool                           finished;
+} m_cb;
+
+
+static uint32_t timestamp_get(void)
+{
+    return (m_cb.timestamp_func != NULL) ? m_cb.timestamp_func() : 0;
+}
+
+
+/**@brief Function for ending a started step. Ignored if the step is not running. */
+static void step_end(uint8_t id, ret_code_t result)
+{
+    uint32_t mask = NRF_BOOT_INIT_DEP(id);
+
+    CRITICAL_REGION_ENTER();
+    if (((m_cb.started & mask) != 0) && (((m_cb.done | m_cb.failed) & mask) == 0))
+    {
+        m_cb.end_ts[id]  = timestamp_get();
+        m_cb.results[id] = result;
+        if (result == NRF_SUCCESS)
+        {
+            m_cb.done |= mask;
+        }
+        else
+        {
+            m_cb.failed |= mask;
+        }
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+
+/**@brief Function for failing a step that was not started. */
+static void step_skip(uint8_t id, ret_code_t result)
+{
+    m_cb.started     |= NRF_BOOT_INIT_DEP(id);
+    m_cb.start_ts[id] = timestamp_get();
+    step_end(id, result);
+}
+
+
+/**@brief Function for starting the steps that are ready, until none is.
+ *
+ * @return True if steps are still running.
+ */
+static bool steps_start(void)
+{
+    bool progress;
+
+    do
+    {
+        progress = false;
+
+        for (uint8_t id = 0; id < NRF_BOOT_INIT_MAX_STEPS; id++)
+        {
+            nrf_boot_init_step_t const * p_step = m_cb.p_steps[id];
+            uint32_t                     mask   = NRF_BOOT_INIT_DEP(id);
+            ret_code_t                   err_code;
+
+            if (((m_cb.registered & mask) == 0) || ((m_cb.started & mask) != 0))
+            {
+                continue;
+            }
+
+            if ((p_step->deps & m_cb.failed) != 0)
+            {
+                step_skip(id, NRF_ERROR_INVALID_STATE);
+                progress = true;
+            }
+            else if ((p_step->deps & ~m_cb.done) == 0)
+            {
+                m_cb.started     |= mask;
+                m_cb.start_ts[id] = timestamp_get();
+
+                err_code = p_step->start();
+                if ((err_code != NRF_SUCCESS) || !p_step->async)
+                {
+                    step_end(id, err_code);
+                }
+                progress = true;
+            }
+        }
+    } while (progress);
+
+    return ((m_cb.started & ~(m_cb.done | m_cb.failed)) != 0);
+}
+
+
+/**@brief Function for reporting the boot time, and the longest chain of steps. */
+static void boot_done(void)
+{
+    nrf_boot_init_evt_t evt;
+    uint32_t            first = 0;
+    uint32_t            last  = 0;
+    uint8_t             id    = NRF_BOOT_INIT_MAX_STEPS;
+    bool                any   = false;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.evt_type = NRF_BOOT_INIT_EVT_DONE;
+    evt.result   = m_cb.first_error;
+
+    for (uint8_t i = 0; i < NRF_BOOT_INIT_MAX_STEPS; i++)
+    {
+        if ((m_cb.registered & NRF_BOOT_INIT_DEP(i)) == 0)
+        {
+            continue;
+        }
+        evt.sum_us += m_cb.end_ts[i] - m_cb.start_ts[i];
+
+        if (!any || ((int32_t)(m_cb.start_ts[i] - first) < 0))
+        {
+            first = m_cb.start_ts[i];
+        }
+        if (!any || ((int32_t)(m_cb.end_ts[i] - last) >= 0))
+        {
+            last = m_cb.end_ts[i];
+            id   = i;
+        }
+        any = true;
+    }
+
+    if (any)
+    {
+        evt.p_step      = m_cb.p_steps[id];
+        evt.duration_us = last - first;
+    }
+
+    NRF_LOG_INFO("Boot: %d us, %d us in turn.\r\n", evt.duration_us, evt.sum_us);
+
+    // The chain ends with the last step, and goes through the dependency that ended last.
+    while (id < NRF_BOOT_INIT_MAX_STEPS)
+    {
+        uint32_t deps = m_cb.p_steps[id]->deps & m_cb.registered;
+        uint8_t  next = NRF_BOOT_INIT_MAX_STEPS;
+
+        NRF_LOG_INFO("  %s\r\n", (uint32_t)m_cb.p_steps[id]->p_name);
+
+        for (uint8_t i = 0; i < NRF_BOOT_INIT_MAX_STEPS; i++)
+        {
+            if (((deps & NRF_BOOT_INIT_DEP(i)) != 0) &&
+                ((next == NRF_BOOT_INIT_MAX_STEPS) ||
+                 ((int32_t)(m_cb.end_ts[i] - m_cb.end_ts[next]) > 0)))
+            {
+                next = i;
+            }
+        }
+        id = next;
+    }
+
+    if (m_cb.evt_handler != NULL)
+    {
+        m_cb.evt_handler(&evt);
+    }
+}
+
+
+ret_code_t nrf_boot_init_start(nrf_boot_init_evt_handler_t    evt_handler,
+                               nrf_boot_init_timestamp_func_t timestamp_func)
+{
+    if (m_cb.running || m_cb.finished)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    memset(&m_cb, 0, sizeof(m_cb));
+
+    for (uint32_t i = 0; i < STEP_SECTION_VARS_COUNT; i++)
+    {
+        nrf_boot_init_step_t const * p_step = STEP_SECTION_VARS_GET(i);
+
+        if ((p_step->id >= NRF_BOOT_INIT_MAX_STEPS) ||
+            ((m_cb.registered & NRF_BOOT_INIT_DEP(p_step->id)) != 0))
+        {
+            m_cb.registered = 0;
+            return NRF_ERROR_INVALID_PARAM;
+        }
+        m_cb.registered          |= NRF_BOOT_INIT_DEP(p_step->id);
+        m_cb.p_steps[p_step->id]  = p_step;
+    }
+
+    m_cb.evt_handler    = evt_handler;
+    m_cb.timestamp_func = timestamp_func;
+    m_cb.running        = true;
+
+    (void)nrf_boot_init_process();
+
+    return NRF_SUCCESS;
+}
+
+
+bool nrf_boot_init_process(void)
+{
+    uint32_t pending;
+
+    if (!m_cb.running)
+    {
+        return m_cb.finished;
+    }
+
+    // Once nothing runs, no step can complete any more: the second pass sees the completions that
+    // came during the first one.
+    if (!steps_start() && !steps_start())
+    {
+        // The steps left wait for an unregistered step, or for themselves.
+        for (uint8_t id = 0; id < NRF_BOOT_INIT_MAX_STEPS; id++)
+        {
+            if ((m_cb.registered & ~m_cb.started & NRF_BOOT_INIT_DEP(id)) != 0)
+            {
+                step_skip(id, NRF_ERROR_NOT_FOUND);
+            }
+        }
+    }
+
+    pending = (m_cb.done | m_cb.failed) & ~m_cb.reported;
+    for (uint8_t id = 0; (id < NRF_BOOT_INIT_MAX_STEPS) && (pending != 0); id++)
+    {
+        nrf_boot_init_evt_t evt;
+
+        if ((pending & NRF_BOOT_INIT_DEP(id)) == 0)
+        {
+            continue;
+        }
+        pending       &= ~NRF_BOOT_INIT_DEP(id);
+        m_cb.reported |= NRF_BOOT_INIT_DEP(id);
+
+        evt.evt_type    = NRF_BOOT_INIT_EVT_STEP_DONE;
+        evt.result      = m_cb.results[id];
+        evt.p_step      = m_cb.p_steps[id];
+        evt.duration_us = m_cb.end_ts[id] - m_cb.start_ts[id];
+        evt.sum_us      = 0;
+
+        if ((evt.result != NRF_SUCCESS) && (m_cb.first_error == NRF_SUCCESS))
+        {
+            m_cb.first_error = evt.result;
+        }
+
+        if (evt.result == NRF_SUCCESS)
+        {
+            NRF_LOG_INFO("%s: %d us\r\n", (uint32_t)evt.p_step->p_name, evt.duration_us);
+        }
+        else
+        {
+            NRF_LOG_WARNING("%s: error %d after %d us\r\n",
+                            (uint32_t)evt.p_step->p_name, evt.result, evt.duration_us);
+        }
+
+        if (m_cb.evt_handler != NULL)
+        {
+            m_cb.evt_handler(&evt);
+        }
+    }
+
+    if (m_cb.reported == m_cb.registered)
+    {
+        m_cb.running  = false;
+        m_cb.finished = true;
+        boot_done();
+    }
+
+    return m_cb.finished;
+}
+
+
+void nrf_boot_init_complete(uint8_t id, ret_code_t result)
+{
+    if (id < NRF_BOOT_INIT_MAX_STEPS)
+    {
+        step_end(id, result);
+    }
+}
+
+
+bool nrf_boot_init_is_complete(uint8_t id)
+{
+    return (id < NRF_BOOT_INIT_MAX_STEPS) && ((m_cb.done & NRF_BOOT_INIT_DEP(id)) != 0);
+}
+
+
+ret_code_t nrf_boot_init_step_time_get(uint8_t id, uint32_t * p_start, uint32_t * p_end)
+{
+    VERIFY_PARAM_NOT_NULL(p_start);
+    VERIFY_PARAM_NOT_NULL(p_end);
+
+    if ((id >= NRF_BOOT_INIT_MAX_STEPS) ||
+        (((m_cb.done | m_cb.failed) & NRF_BOOT_INIT_DEP(id)) == 0))
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    *p_start = m_cb.start_ts[id];
+    *p_end   = m_cb.end_ts[id];
+
+    return NRF_SUCCESS;
+}
+
+#endif // NRF_MODULE_ENABLED(NRF_BOOT_INIT)
@@ -0,0 +1,190 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup nrf_boot_init Boot initialization steps
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for running the initialization steps of the application in dependency order,
+ *        with the slow asynchronous steps running at the same time.
+ *
+ * @details Instead of a main function that initializes every module in turn, each module
+ *          registers a step with @ref NRF_BOOT_INIT_STEP_DEF. A step has an identifier, from 0 to
+ *          31, and the mask of the identifiers of the steps it depends on. The application
+ *          defines the identifiers, usually in an enumeration.
+ *
+ *          A step is started as soon as all its dependencies are complete. A synchronous step is
+ *          complete when its start function returns. An asynchronous step only starts an
+ *          operation, like the page scan of @ref fds_init, the LFCLK start or a sensor probe on a
+ *          TWI bus, and is complete when its event handler calls @ref nrf_boot_init_complete, from
+ *          any context. The other steps go on meanwhile, so the boot time is the longest chain of
+ *          dependent steps instead of the sum of all steps.
+ *
+ *          The steps are started from @ref nrf_boot_init_process, called from the main loop, in
+ *          the order of the identifiers when several are ready. The steps that depend on a failed
+ *          step are not started, and fail with NRF_ERROR_INVALID_STATE. The steps that depend on
+ *          an identifier that is not registered, or on themselves through other steps, fail with
+ *          NRF_ERROR_NOT_FOUND.
+ *
+ *          With a time stamp function, for example @ref nrf_timestamp_log_get, the start and
+ *          completion of every step is timed, and reported in the events and in the log.
+ *
+ *          Example:
+ *          @code
+ *          enum { BOOT_CLOCK, BOOT_FDS, BOOT_PEER_MANAGER };
+ *
+ *          static ret_code_t fds_start(void)
+ *          {
+ *              return fds_init(); // FDS_EVT_INIT calls nrf_boot_init_complete(BOOT_FDS, result).
+ *          }
+ *          NRF_BOOT_INIT_STEP_DEF(m_fds_step, BOOT_FDS, 0, fds_start, true);
+ *          NRF_BOOT_INIT_STEP_DEF(m_pm_step, BOOT_PEER_MANAGER,
+ *                                 NRF_BOOT_INIT_DEP(BOOT_FDS) | NRF_BOOT_INIT_DEP(BOOT_CLOCK),
+ *                                 peer_manager_start, false);
+ *          @endcode
+ *
+ *          The steps are placed in the section "boot_init_steps", which the linker script must
+ *          keep.
+ */
+
+#ifndef NRF_BOOT_INIT_H__
+#define NRF_BOOT_INIT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_common.h"
+#include "sdk_errors.h"
+#include "section_vars.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NRF_BOOT_INIT_MAX_STEPS 32 /**< Number of step identifiers. */
+
+/**@brief Macro for the dependency mask of a step identifier. */
+#define NRF_BOOT_INIT_DEP(id) (1UL << (id))
+
+/**@brief Start function of a step.
+ *
+ * @retval NRF_SUCCESS If the step was completed, or, for an asynchronous step, started.
+ * @return Any other error fails the step.
+ */
+typedef ret_code_t (* nrf_boot_init_start_t)(void);
+
+/**@brief Time stamp function, in microseconds. The type matches @ref nrf_log_timestamp_func_t. */
+typedef uint32_t (* nrf_boot_init_timestamp_func_t)(void);
+
+/**@brief Step. Use @ref NRF_BOOT_INIT_STEP_DEF to register one. */
+typedef struct
+{
+    nrf_boot_init_start_t start;  /**< Start function. */
+    char const          * p_name; /**< Name of the step, for the log. */
+    uint32_t              deps;   /**< Identifiers of the steps it depends on, see @ref NRF_BOOT_INIT_DEP. */
+    uint8_t               id;     /**< Identifier, below @ref NRF_BOOT_INIT_MAX_STEPS. */
+    bool                  async;  /**< Complete on @ref nrf_boot_init_complete instead of on return. */
+} nrf_boot_init_step_t;
+
+/**@brief Macro for registering a step.
+ *
+ * @param[in] _name   Name of the step.
+ * @param[in] _id     Identifier, below @ref NRF_BOOT_INIT_MAX_STEPS, unique.
+ * @param[in] _deps   Identifiers of the steps it depends on, see @ref NRF_BOOT_INIT_DEP.
+ * @param[in] _start  Start function, of type @ref nrf_boot_init_start_t.
+ * @param[in] _async  True if the step is complete on @ref nrf_boot_init_complete.
+ */
+#define NRF_BOOT_INIT_STEP_DEF(_name, _id, _deps, _start, _async)                                 \
+    NRF_SECTION_VARS_REGISTER_VAR(boot_init_steps, nrf_boot_init_step_t const _name) =            \
+    {                                                                                             \
+        .start  = (_start),                                                                       \
+        .p_name = #_name,                                                                         \
+        .deps   = (_deps),                                                                        \
+        .id     = (_id),                                                                          \
+        .async  = (_async),                                                                       \
+    }
+
+/**@brief Event types. */
+typedef enum
+{
+    NRF_BOOT_INIT_EVT_STEP_DONE, /**< A step was completed, or failed. */
+    NRF_BOOT_INIT_EVT_DONE       /**< All steps were completed, or failed. */
+} nrf_boot_init_evt_type_t;
+
+/**@brief Event. */
+typedef struct
+{
+    nrf_boot_init_evt_type_t     evt_type;
+    ret_code_t                   result;      /**< Result of the step, or of the first failed step. */
+    nrf_boot_init_step_t const * p_step;      /**< Step done: the step. Done: the last step of the longest chain. */
+    uint32_t                     duration_us; /**< Step done: time from start to completion. Done: boot time. */
+    uint32_t                     sum_us;      /**< Done: sum of the durations, the boot time if the steps ran in turn. */
+} nrf_boot_init_evt_t;
+
+/**@brief Event handler type. Called from @ref nrf_boot_init_process. */
+typedef void (* nrf_boot_init_evt_handler_t)(nrf_boot_init_evt_t const * p_evt);
+
+/**@brief Function for starting the boot. The steps without dependencies are started.
+ *
+ * @param[in] evt_handler    Event handler, or NULL.
+ * @param[in] timestamp_func Time stamp function, or NULL for no timing.
+ *
+ * @retval NRF_SUCCESS             If the boot was started.
+ * @retval NRF_ERROR_INVALID_PARAM If two steps have the same identifier, or an identifier is not
+ *                                 below @ref NRF_BOOT_INIT_MAX_STEPS.
+ * @retval NRF_ERROR_INVALID_STATE If the boot was already started.
+ */
+ret_code_t nrf_boot_init_start(nrf_boot_init_evt_handler_t    evt_handler,
+                               nrf_boot_init_timestamp_func_t timestamp_func);
+
+/**@brief Function for starting the steps that are ready, and reporting the completed ones.
+ *
+ * @details Call it from the main loop. The completion of an asynchronous step comes with an
+ *          interrupt, so the main loop can sleep in between.
+ *
+ * @retval true  If all steps were completed, or failed.
+ * @retval false If steps are still running.
+ */
+bool nrf_boot_init_process(void);
+
+/**@brief Function for completing an asynchronous step. Can be called from any context.
+ *
+ * @param[in] id     Identifier of the step.
+ * @param[in] result NRF_SUCCESS, or the error that fails the step.
+ */
+void nrf_boot_init_complete(uint8_t id, ret_code_t result);
+
+/**@brief Function for checking if a step is complete. Steps that failed are not.
+ *
+ * @param[in] id Identifier of the step.
+ */
+bool nrf_boot_init_is_complete(uint8_t id);
+
+/**@brief Function for getting the time stamps of a step.
+ *
+ * @param[in]  id       Identifier of the step.
+ * @param[out] p_start  Time stamp of the start.
+ * @param[out] p_end    Time stamp of the completion, or failure.
+ *
+ * @retval NRF_SUCCESS             If the step is done.
+ * @retval NRF_ERROR_INVALID_STATE If the step is not done yet.
+ */
+ret_code_t nrf_boot_init_step_time_get(uint8_t id, uint32_t * p_start, uint32_t * p_end);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_BOOT_INIT_H__
+
+/** @} */
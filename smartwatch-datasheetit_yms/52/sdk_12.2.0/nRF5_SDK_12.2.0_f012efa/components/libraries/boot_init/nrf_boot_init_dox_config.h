@@ -0,0 +1,16 @@
+/**
+ *
+ * @defgroup nrf_boot_init_config Boot initialization steps configuration
+ * @{
+ * @ingroup nrf_boot_init
+ */
+/** @brief Enabling the boot initialization steps
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_BOOT_INIT_ENABLED
+
+
+/** @} */
@@ -26,6 +26,9 @@
 #include "softdevice_handler_appsh.h"
 #include "nrf_log.h"
 #include "nrf_delay.h"
+#if (NRF_SD_BLE_API_VERSION == 3) && NRF_MODULE_ENABLED(NRF_BLE_GATT)
+#include "nrf_ble_gatt.h"
+#endif
 
 #define ADVERTISING_LED_PIN_NO               BSP_LED_0                                              /**< Is on when device is advertising. */
 #define CONNECTED_LED_PIN_NO                 BSP_LED_1                                              /**< Is on when device has connected. */
@@ -52,22 +55,31 @@
 
 #define APP_FEATURE_NOT_SUPPORTED            BLE_GATT_STATUS_ATTERR_APP_BEGIN + 2                   /**< Reply when unsupported features are requested. */
 
-#define MAX_DFU_PKT_LEN                     (20)                                                    /**< Maximum length (in bytes) of the DFU Packet characteristic. */
 #define PKT_CREATE_PARAM_LEN                (6)                                                     /**< Length (in bytes) of the parameters for Create Object request. */
 #define PKT_SET_PRN_PARAM_LEN               (3)                                                     /**< Length (in bytes) of the parameters for Set Packet Receipt Notification request. */
 #define PKT_READ_OBJECT_INFO_PARAM_LEN      (2)                                                     /**< Length (in bytes) of the parameters for Read Object Info request. */
 #define MAX_RESPONSE_LEN                    (15)                                                    /**< Maximum length (in bytes) of the response to a Control Point command. */
 
 
-#if (NRF_SD_BLE_API_VERSION == 3)
+#if (NRF_SD_BLE_API_VERSION == 3) && NRF_MODULE_ENABLED(NRF_BLE_GATT)
+#define NRF_BLE_MAX_MTU_SIZE            NRF_BLE_GATT_MAX_MTU_SIZE                                   /**< MTU size used in the softdevice enabling. Negotiated by the nrf_ble_gatt module. */
+#else
 #define NRF_BLE_MAX_MTU_SIZE            GATT_MTU_SIZE_DEFAULT                                       /**< MTU size used in the softdevice enabling and to reply to a BLE_GATTS_EVT_EXCHANGE_MTU_REQUEST event. */
 #endif
 
+#define ATT_WRITE_CMD_HEADER_LEN            (3)                                                     /**< Opcode and handle of an ATT Write Command. */
+#define MAX_DFU_PKT_LEN                     (NRF_BLE_MAX_MTU_SIZE - ATT_WRITE_CMD_HEADER_LEN)       /**< Maximum length (in bytes) of the DFU Packet characteristic. */
+
 
 static ble_dfu_t            m_dfu;                                                                   /**< Structure used to identify the Device Firmware Update service. */
 static uint16_t             m_pkt_notif_target;                                                      /**< Number of packets of firmware data to be received before transmitting the next Packet Receipt Notification to the DFU Controller. */
 static uint16_t             m_pkt_notif_target_cnt;                                                  /**< Number of packets of firmware data received after sending last Packet Receipt Notification or since the receipt of a @ref BLE_DFU_PKT_RCPT_NOTIF_ENABLED event from the DFU service, which ever occurs later.*/
 static uint16_t             m_conn_handle            = BLE_CONN_HANDLE_INVALID;                      /**< Handle of the current connection. */
+static uint16_t             m_att_mtu                = GATT_MTU_SIZE_DEFAULT;                        /**< Effective ATT MTU of the current connection. */
+
+#if (NRF_SD_BLE_API_VERSION == 3) && NRF_MODULE_ENABLED(NRF_BLE_GATT)
+static nrf_ble_gatt_t       m_gatt;                                                                  /**< Negotiates the ATT MTU of the connection. */
+#endif
 
 #define DFU_BLE_FLAG_NONE                    (0)
 #define DFU_BLE_FLAG_SERVICE_INITIALIZED     (1 << 0)           /**< Flag to check if the DFU service was initialized by the application.*/
@@ -284,6 +296,57 @@ static uint32_t response_send(ble_dfu_t          * p_dfu,
 }
 
 
+/**@brief     Function for getting the Packet Receipt Notification interval suggested to the host.
+ *
+ * @details   The host may send as many bytes as the request handler can buffer while the flash is
+ *            written. Full packets of the current ATT MTU are assumed.
+ */
+static uint16_t prn_hint_get(void)
+{
+    uint32_t prn = nrf_dfu_req_handler_rx_capacity_get() / (m_att_mtu - ATT_WRITE_CMD_HEADER_LEN);
+
+    return (uint16_t)MIN(MAX(prn, 1), UINT16_MAX);
+}
+
+
+/**@brief     Function for sending the response to a Set Packet Receipt Notification request.
+ *
+ * @details   The response carries the suggested interval after the result code. A host that does
+ *            not know of the suggestion ignores it, a host that does may set it with a new request.
+ */
+static uint32_t response_prn_cmd_send(ble_dfu_t * p_dfu, uint16_t prn_hint)
+{
+    uint16_t index = 0;
+
+    NRF_LOG_INFO("Sending PRN response, suggested PRN: %d\r\n", prn_hint);
+
+#ifndef NRF51
+    if (p_dfu == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+#endif
+
+    if ((m_conn_handle == BLE_CONN_HANDLE_INVALID) || (m_flags & DFU_BLE_FLAG_SERVICE_INITIALIZED) == 0)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    m_notif_buffer[index++] = BLE_DFU_OP_CODE_RESPONSE;
+
+    // Encode the Request Op code
+    m_notif_buffer[index++] = BLE_DFU_OP_CODE_SET_RECEIPT_NOTIF;
+
+    // Encode the Response Value.
+    m_notif_buffer[index++] = (uint8_t)NRF_DFU_RES_CODE_SUCCESS;
+
+    // Encode the suggested PRN.
+    index += uint16_encode(prn_hint, &m_notif_buffer[index]);
+
+    return send_hvx(m_conn_handle, p_dfu->dfu_ctrl_pt_handles.value_handle, index);
+}
+
+
 static uint32_t response_crc_cmd_send(ble_dfu_t         * p_dfu,
                                       uint32_t            offset,
                                       uint32_t            crc)
@@ -433,7 +496,7 @@ static uint32_t on_ctrl_pt_write(ble_dfu_t * p_dfu, ble_gatts_evt_write_t * p_bl
             //lint -restore
             m_pkt_notif_target_cnt   = m_pkt_notif_target;
 
-            return response_send(p_dfu, BLE_DFU_OP_CODE_SET_RECEIPT_NOTIF, NRF_DFU_RES_CODE_SUCCESS);
+            return response_prn_cmd_send(p_dfu, prn_hint_get());
 
         case BLE_DFU_OP_CODE_CALCULATE_CRC:
             NRF_LOG_INFO("Received calculate CRC\r\n");
@@ -592,6 +655,7 @@ static void on_ble_evt(ble_evt_t * p_ble_evt)
             nrf_gpio_pin_set(ADVERTISING_LED_PIN_NO);
 
             m_conn_handle    = p_ble_evt->evt.gap_evt.conn_handle;
+            m_att_mtu        = GATT_MTU_SIZE_DEFAULT;
             m_flags &= ~DFU_BLE_FLAG_IS_ADVERTISING;
             break;
 
@@ -663,7 +727,7 @@ static void on_ble_evt(ble_evt_t * p_ble_evt)
             on_write(&m_dfu, p_ble_evt);
             break;
 
-#if (NRF_SD_BLE_API_VERSION == 3)
+#if (NRF_SD_BLE_API_VERSION == 3) && !NRF_MODULE_ENABLED(NRF_BLE_GATT)
         case BLE_GATTS_EVT_EXCHANGE_MTU_REQUEST:
             err_code = sd_ble_gatts_exchange_mtu_reply(p_ble_evt->evt.gatts_evt.conn_handle, 
                                                        NRF_BLE_MAX_MTU_SIZE);
@@ -687,11 +751,31 @@ static void on_ble_evt(ble_evt_t * p_ble_evt)
  */
 static void ble_evt_dispatch(ble_evt_t * p_ble_evt)
 {
+#if (NRF_SD_BLE_API_VERSION == 3) && NRF_MODULE_ENABLED(NRF_BLE_GATT)
+    nrf_ble_gatt_on_ble_evt(&m_gatt, p_ble_evt);
+#endif
     ble_conn_params_on_ble_evt(p_ble_evt);
     on_ble_evt(p_ble_evt);
 }
 
 
+#if (NRF_SD_BLE_API_VERSION == 3) && NRF_MODULE_ENABLED(NRF_BLE_GATT)
+/**@brief     Function for handling events from the GATT module.
+ *
+ * @param[in] p_gatt GATT module instance.
+ * @param[in] p_evt  Event.
+ */
+static void gatt_evt_handler(nrf_ble_gatt_t * p_gatt, nrf_ble_gatt_evt_t * p_evt)
+{
+    if ((p_evt->evt_id == NRF_BLE_GATT_EVT_ATT_MTU_UPDATED) && (p_evt->conn_handle == m_conn_handle))
+    {
+        m_att_mtu = p_evt->att_mtu_effective;
+        NRF_LOG_INFO("ATT MTU: %d\r\n", m_att_mtu);
+    }
+}
+#endif
+
+
 /**@brief       Function for the LEDs initialization.
  *
  * @details     Initializes all LEDs used by this application.
@@ -797,6 +881,22 @@ static uint32_t ble_stack_init(bool init_softdevice)
     
     // Enable BLE stack.
     err_code = softdevice_enable(&ble_enable_params);
+    VERIFY_SUCCESS(err_code);
+
+#if (NRF_SD_BLE_API_VERSION == 3)
+    // Keep the connection event open while the host has more packets to send.
+    ble_opt_t opt;
+    memset(&opt, 0, sizeof(opt));
+    opt.common_opt.conn_evt_ext.enable = 1;
+    err_code = sd_ble_opt_set(BLE_COMMON_OPT_CONN_EVT_EXT, &opt);
+    VERIFY_SUCCESS(err_code);
+#endif
+
+#if (NRF_SD_BLE_API_VERSION == 3) && NRF_MODULE_ENABLED(NRF_BLE_GATT)
+    // The SoftDevice extends the link layer data length to fit the negotiated ATT MTU.
+    err_code = nrf_ble_gatt_init(&m_gatt, gatt_evt_handler);
+#endif
+
     return err_code;
 }
 
@@ -11,6 +11,7 @@
  */
 
 #include "nrf_dfu_flash.h"
+#include <string.h>
 #include "nrf_dfu_types.h"
 #include "softdevice_handler.h"
 #include "nrf_nvmc.h"
@@ -22,14 +23,25 @@
 #endif
 
 #define FLASH_FLAG_NONE                 (0)
-#define FLASH_FLAG_OPER                 (1<<0)
 #define FLASH_FLAG_FAILURE_SINCE_LAST   (1<<1)
 #define FLASH_FLAG_SD_ENABLED           (1<<2)
 
 static uint32_t m_flags;
 
+// Pages are numbered by their address divided by CODE_PAGE_SIZE.
+// Pages m_ahead_start to m_ahead_next - 1 are erased, or their erase is queued before any
+// operation that is started later. Pages m_ahead_next to m_ahead_end - 1 are erased ahead.
+static uint32_t m_ahead_start;
+static uint32_t m_ahead_next;
+static uint32_t m_ahead_end;
+
+static nrf_dfu_flash_stats_t m_stats;
+
 #ifdef BLE_STACK_SUPPORT_REQD
 
+static volatile uint32_t m_ops_pending;    // Operations queued in fstorage
+static bool              m_waiting;        // nrf_dfu_flash_wait is waiting, nothing is erased ahead
+
 // Function prototypes
 static void fs_evt_handler(fs_evt_t const * const evt, fs_ret_t result);
 
@@ -41,10 +53,43 @@ FS_REGISTER_CFG(fs_config_t fs_dfu_config) =
 };
 
 
+static void op_started(void)
+{
+    m_ops_pending++;
+    if (m_ops_pending > m_stats.max_ops_pending)
+    {
+        m_stats.max_ops_pending = m_ops_pending;
+    }
+}
+
+
+/** @brief Function for erasing the next page ahead, when no other operation is queued.
+ */
+static void erase_ahead_run(void)
+{
+    if (((m_flags & FLASH_FLAG_SD_ENABLED) == 0)             ||
+        ((m_flags & FLASH_FLAG_FAILURE_SINCE_LAST) != 0)     ||
+        (m_ops_pending != 0) || m_waiting                    ||
+        (m_ahead_next >= m_ahead_end))
+    {
+        return;
+    }
+
+    op_started();
+    if (fs_erase(&fs_dfu_config, (uint32_t *)(m_ahead_next * CODE_PAGE_SIZE), 1, NULL) != FS_SUCCESS)
+    {
+        m_ops_pending--;
+        return;
+    }
+
+    m_ahead_next++;
+    m_stats.pages_erased_ahead++;
+}
+
+
 static void fs_evt_handler(fs_evt_t const * const evt, fs_ret_t result)
 {
-    // Clear the operation flag
-    m_flags &= ~FLASH_FLAG_OPER;
+    m_ops_pending--;
 
     if (result == FS_SUCCESS)
     {
@@ -62,11 +107,45 @@ static void fs_evt_handler(fs_evt_t const * const evt, fs_ret_t result)
         //lint -e611
         ((dfu_flash_callback_t)evt->p_context)(evt, result);
     }
+
+    erase_ahead_run();
 }
 
 #endif
 
 
+/** @brief Function for updating the pages erased ahead before pages are written or erased.
+ *
+ * @param[in] first_page First page of the operation.
+ * @param[in] last_page  Last page of the operation.
+ * @param[in] erase      True if the pages are erased, false if they are written.
+ */
+static void ahead_range_update(uint32_t first_page, uint32_t last_page, bool erase)
+{
+    if ((last_page < m_ahead_start) || (first_page >= m_ahead_end))
+    {
+        return;
+    }
+
+    if (!erase)
+    {
+        // Written pages are not erased, and are not erased ahead later.
+        m_ahead_start = last_page + 1;
+        m_ahead_next  = MAX(m_ahead_next, m_ahead_start);
+    }
+    else if (first_page <= m_ahead_next)
+    {
+        m_ahead_next = MAX(m_ahead_next, last_page + 1);
+    }
+    else
+    {
+        // The pages between are not erased.
+        m_ahead_start = first_page;
+        m_ahead_next  = last_page + 1;
+    }
+}
+
+
 uint32_t nrf_dfu_flash_init(bool sd_enabled)
 {
     uint32_t err_code = NRF_SUCCESS;
@@ -102,6 +181,10 @@ uint32_t nrf_dfu_flash_init(bool sd_enabled)
         m_flags = FLASH_FLAG_NONE;
     }
 
+    m_ahead_start = 0;
+    m_ahead_next  = 0;
+    m_ahead_end   = 0;
+
     return err_code;
 }
 
@@ -110,6 +193,13 @@ fs_ret_t nrf_dfu_flash_store(uint32_t const * p_dest, uint32_t const * const p_s
 {
     fs_ret_t ret_val = FS_SUCCESS;
 
+    if (len_words != 0)
+    {
+        ahead_range_update((uint32_t)p_dest / CODE_PAGE_SIZE,
+                           ((uint32_t)p_dest + len_words * sizeof(uint32_t) - 1) / CODE_PAGE_SIZE,
+                           false);
+    }
+
 #ifdef BLE_STACK_SUPPORT_REQD
     if ((m_flags & FLASH_FLAG_SD_ENABLED) != 0)
     {
@@ -120,19 +210,17 @@ fs_ret_t nrf_dfu_flash_store(uint32_t const * p_dest, uint32_t const * const p_s
             return FS_ERR_FAILURE_SINCE_LAST;
         }
 
-        // Set the flag to indicate ongoing operation
-        m_flags |= FLASH_FLAG_OPER;
+        // Count the ongoing operation
+        op_started();
         //lint -e611
         ret_val = fs_store(&fs_dfu_config, p_dest, p_src, len_words, (void*)callback);
 
         if (ret_val != FS_SUCCESS)
         {
             NRF_LOG_INFO("Flash: failed %d\r\n", ret_val);
+            m_ops_pending--;
             return ret_val;
         }
-
-        // Set the flag to indicate ongoing operation
-        m_flags |= FLASH_FLAG_OPER;
     }
     else
 #endif
@@ -159,6 +247,7 @@ fs_ret_t nrf_dfu_flash_store(uint32_t const * p_dest, uint32_t const * const p_s
 #endif
 
         nrf_nvmc_write_words((uint32_t)p_dest, p_src, len_words);
+        ret_val = FS_SUCCESS;
 
         #if (__LINT__ != 1)
         if (callback)
@@ -178,6 +267,9 @@ fs_ret_t nrf_dfu_flash_store(uint32_t const * p_dest, uint32_t const * const p_s
         #endif
     }
 
+    m_stats.stores++;
+    m_stats.bytes_stored += len_words * sizeof(uint32_t);
+
     return ret_val;
 }
 
@@ -189,6 +281,39 @@ fs_ret_t nrf_dfu_flash_erase(uint32_t const * p_dest, uint32_t num_pages, dfu_fl
     fs_ret_t ret_val = FS_SUCCESS;
     NRF_LOG_INFO("Erasing: 0x%08x, num: %d\r\n", (uint32_t)p_dest, num_pages);
 
+    if ((num_pages != 0) && (((uint32_t)p_dest & (CODE_PAGE_SIZE-1)) == 0))
+    {
+        uint32_t first_page = (uint32_t)p_dest / CODE_PAGE_SIZE;
+        uint32_t last_page  = first_page + num_pages - 1;
+
+        if ((first_page >= m_ahead_start) && (last_page < m_ahead_next))
+        {
+            // Already erased ahead, or the erase is queued.
+            NRF_LOG_INFO("Erased ahead\r\n");
+            m_stats.erases_skipped++;
+            if (callback)
+            {
+                #if (__LINT__ != 1)
+                fs_evt_t evt =
+                {
+                    .id = FS_EVT_ERASE,
+                    .p_context = (void*)callback,
+                    .erase =
+                    {
+                        .first_page = first_page,
+                        .last_page = last_page + 1
+                    }
+                };
+                callback(&evt, FS_SUCCESS);
+                #endif
+            }
+            return FS_SUCCESS;
+        }
+
+        ahead_range_update(first_page, last_page, true);
+    }
+    m_stats.erases++;
+
 #ifdef BLE_STACK_SUPPORT_REQD
 
     if ((m_flags & FLASH_FLAG_SD_ENABLED) != 0)
@@ -200,18 +325,15 @@ fs_ret_t nrf_dfu_flash_erase(uint32_t const * p_dest, uint32_t num_pages, dfu_fl
             return FS_ERR_FAILURE_SINCE_LAST;
         }
 
-        m_flags |= FLASH_FLAG_OPER;
+        op_started();
         ret_val = fs_erase(&fs_dfu_config, p_dest, num_pages, (void*)callback);
 
         if (ret_val != FS_SUCCESS)
         {
             NRF_LOG_INFO("Erase failed: %d\r\n", ret_val);
-            m_flags &= ~FLASH_FLAG_OPER;
+            m_ops_pending--;
             return ret_val;
         }
-
-        // Set the flag to indicate ongoing operation
-        m_flags |= FLASH_FLAG_OPER;
     }
     else
 #endif
@@ -258,6 +380,57 @@ fs_ret_t nrf_dfu_flash_erase(uint32_t const * p_dest, uint32_t num_pages, dfu_fl
 }
 
 
+fs_ret_t nrf_dfu_flash_erase_ahead(uint32_t const * p_dest, uint32_t num_pages)
+{
+    if (((uint32_t)p_dest & (CODE_PAGE_SIZE-1)) != 0)
+    {
+        return FS_ERR_UNALIGNED_ADDR;
+    }
+
+    NRF_LOG_INFO("Erasing ahead: 0x%08x, num: %d\r\n", (uint32_t)p_dest, num_pages);
+
+    m_ahead_start = (uint32_t)p_dest / CODE_PAGE_SIZE;
+    m_ahead_next  = m_ahead_start;
+    m_ahead_end   = m_ahead_start + num_pages;
+
+#ifdef BLE_STACK_SUPPORT_REQD
+    erase_ahead_run();
+#endif
+
+    return FS_SUCCESS;
+}
+
+
+void nrf_dfu_flash_erase_ahead_extend(uint32_t const * p_end)
+{
+    uint32_t const end_page = ((uint32_t)p_end + CODE_PAGE_SIZE - 1) / CODE_PAGE_SIZE;
+
+    // Without a range, there is nothing to extend.
+    if (m_ahead_end == 0)
+    {
+        return;
+    }
+
+    m_ahead_end = MAX(m_ahead_end, end_page);
+
+#ifdef BLE_STACK_SUPPORT_REQD
+    erase_ahead_run();
+#endif
+}
+
+
+void nrf_dfu_flash_stats_get(nrf_dfu_flash_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
+
+
+void nrf_dfu_flash_stats_clear(void)
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+
 void nrf_dfu_flash_error_clear(void)
 {
     m_flags &= ~FLASH_FLAG_FAILURE_SINCE_LAST;
@@ -271,10 +444,15 @@ fs_ret_t nrf_dfu_flash_wait(void)
 #ifdef BLE_STACK_SUPPORT_REQD
     if ((m_flags & FLASH_FLAG_SD_ENABLED) != 0)
     {
-        while ((m_flags & FLASH_FLAG_OPER) != 0)
+        // Do not erase ahead while waiting, only for the operations already queued.
+        m_waiting = true;
+        while (m_ops_pending != 0)
         {
             (void)sd_app_evt_wait();
         }
+        m_waiting = false;
+
+        erase_ahead_run();
 
         if ((m_flags & FLASH_FLAG_FAILURE_SINCE_LAST) != 0)
         {
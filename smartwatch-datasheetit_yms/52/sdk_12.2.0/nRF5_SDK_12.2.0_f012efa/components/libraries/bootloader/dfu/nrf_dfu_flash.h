@@ -38,6 +38,18 @@ extern "C" {
  */
 typedef fs_cb_t dfu_flash_callback_t;
 
+
+/**@brief Flash operation statistics. */
+typedef struct
+{
+    uint32_t stores;             //!< Number of store operations.
+    uint32_t bytes_stored;       //!< Number of bytes stored.
+    uint32_t erases;             //!< Number of erase operations that were run.
+    uint32_t erases_skipped;     //!< Number of erase operations of pages that were already erased ahead.
+    uint32_t pages_erased_ahead; //!< Number of pages erased ahead.
+    uint32_t max_ops_pending;    //!< Largest number of operations queued at the same time.
+} nrf_dfu_flash_stats_t;
+
 /**@brief Function for initializing the flash module.
  *
  * You can use this module with or without a SoftDevice:
@@ -102,6 +114,46 @@ fs_ret_t nrf_dfu_flash_store(uint32_t const * p_dest, uint32_t const * const p_s
 fs_ret_t nrf_dfu_flash_erase(uint32_t const * p_dest, uint32_t num_pages, dfu_flash_callback_t callback);
 
 
+/**@brief Function for erasing flash pages ahead of the stores to them.
+ *
+ * With the SoftDevice enabled, the pages are erased one at a time, in order, whenever no other
+ * flash operation is queued. A call to @ref nrf_dfu_flash_erase for pages that are already erased
+ * ahead, or whose erase is queued, does not erase them again and succeeds at once. Pages that are
+ * stored to are no longer considered erased.
+ *
+ * Without the SoftDevice, no page is erased ahead.
+ *
+ * @param[in]  p_dest    The address of the first page to be erased. Replaces the previous range.
+ * @param[in]  num_pages The number of flash pages to be erased, or 0 to stop erasing ahead.
+ *
+ * @retval  FS_SUCCESS              If the operation was successful.
+ * @retval  FS_ERR_UNALIGNED_ADDR   If @p p_dest is not aligned to a page boundary.
+ */
+fs_ret_t nrf_dfu_flash_erase_ahead(uint32_t const * p_dest, uint32_t num_pages);
+
+
+/**@brief Function for extending the range of pages erased ahead.
+ *
+ * The pages already erased ahead are not erased again. Nothing is done if no range was set with
+ * @ref nrf_dfu_flash_erase_ahead.
+ *
+ * @param[in]  p_end     The address after the last page to be erased ahead.
+ */
+void nrf_dfu_flash_erase_ahead_extend(uint32_t const * p_end);
+
+
+/**@brief Function for getting the flash operation statistics.
+ *
+ * @param[out] p_stats Statistics.
+ */
+void nrf_dfu_flash_stats_get(nrf_dfu_flash_stats_t * p_stats);
+
+
+/**@brief Function for clearing the flash operation statistics.
+ */
+void nrf_dfu_flash_stats_clear(void);
+
+
 /**@brief Function for clearing an error that has occurred during fstorage operations.
  */
 void nrf_dfu_flash_error_clear(void);
@@ -111,7 +163,8 @@ void nrf_dfu_flash_error_clear(void);
  *
  * This function halts execution until an event is received from the SoftDevice.
  * You can use this function to halt execution until a flash operation has completed, to prevent
- * tampering with the source data until fstorage is done with it.
+ * tampering with the source data until fstorage is done with it. No page is erased ahead while
+ * waiting.
  *
  * @retval FS_SUCCESS                If the operation was successful.
  * @retval FS_ERR_FAILURE_SINCE_LAST If an error has occurred in another transaction and fstorage cannot continue before
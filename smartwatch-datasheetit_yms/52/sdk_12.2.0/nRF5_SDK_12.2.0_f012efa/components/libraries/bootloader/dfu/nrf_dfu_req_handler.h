@@ -167,6 +167,18 @@ uint32_t nrf_dfu_req_handler_init(void);
 nrf_dfu_res_code_t nrf_dfu_req_handler_on_req(void * p_context, nrf_dfu_req_t * p_req, nrf_dfu_res_t * p_res);
 
 
+/** @brief Function for getting the number of bytes of firmware data the host should send between
+ *         two Packet Receipt Notifications.
+ *
+ * @details The value starts at the size of the buffers for data being written to flash. It is
+ *          halved, down to one buffer, each time data was refused since the previous call because
+ *          the flash had not finished writing the buffers.
+ *
+ * @return Number of bytes.
+ */
+uint32_t nrf_dfu_req_handler_rx_capacity_get(void);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -138,8 +138,9 @@ static void wait_for_queue(void)
 
 uint32_t nrf_dfu_settings_calculate_crc(void)
 {
-    // the crc is calculated from the s_dfu_settings struct, except the crc itself and the init command
-    return crc32_compute((uint8_t*)&s_dfu_settings + 4, sizeof(nrf_dfu_settings_t) - 4 - sizeof(s_dfu_settings.init_command), NULL);
+    // the crc is calculated from the s_dfu_settings struct, except the crc itself, the init command
+    // and the fields after it
+    return crc32_compute((uint8_t*)&s_dfu_settings + 4, offsetof(nrf_dfu_settings_t, init_command) - 4, NULL);
 }
 
 
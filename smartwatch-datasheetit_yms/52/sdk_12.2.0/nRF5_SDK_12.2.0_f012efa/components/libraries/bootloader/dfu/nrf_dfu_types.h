@@ -145,6 +145,8 @@ extern "C" {
 #define NRF_DFU_BANK_VALID_BL    0xAA /**< Valid bootloader. */
 #define NRF_DFU_BANK_VALID_SD_BL 0xAC /**< Valid SoftDevice and bootloader. */
 
+#define NRF_DFU_BOOT_VALIDATED   0x56414C44 /**< The application in bank 0 was validated, see @ref nrf_dfu_boot_validation_t. */
+
 
 /** @brief Description of a single bank. */
 #pragma pack(4)
@@ -174,6 +176,21 @@ typedef struct
 } dfu_progress_t;
 
 
+/**@brief Result of the last validation of the application in bank 0.
+ *
+ * @details The result applies while the bank still describes the validated image, and the
+ *          image still starts and ends with the same words. Otherwise, the application is
+ *          validated again.
+ */
+typedef struct
+{
+    uint32_t validated;         /**< @ref NRF_DFU_BOOT_VALIDATED if the result is set. */
+    uint32_t image_size;        /**< Size of the validated image. */
+    uint32_t image_crc;         /**< CRC of the validated image. */
+    uint32_t image_marker;      /**< CRC of the first and last words of the validated image. */
+} nrf_dfu_boot_validation_t;
+
+
 /**@brief DFU settings for application and bank data.
  */
 typedef struct
@@ -196,6 +213,8 @@ typedef struct
 
     uint32_t            enter_buttonless_dfu;
     uint8_t             init_command[INIT_COMMAND_MAX_SIZE];  /**< Buffer for storing the init command. */
+
+    nrf_dfu_boot_validation_t boot_validation;  /**< Last validation of the application. Not covered by the CRC, so that settings stored by earlier versions stay valid. */
 } nrf_dfu_settings_t;
 #pragma pack() // revert pack settings
 
@@ -27,6 +27,39 @@ static uint32_t align_to_page(uint32_t val, uint32_t page_size)
 }
 
 
+#define BOOT_MARKER_LEN     16  /**< Bytes at the start and at the end of the image covered by the marker. */
+
+
+/** @brief Function for computing the CRC of the first and last words of the application.
+ *
+ * @details Programming the application region, for example with a debugger, changes the vector
+ *          table at the start of the image, or the end of the image.
+ */
+static uint32_t boot_marker_compute(uint32_t image_size)
+{
+    uint32_t len = MIN(image_size, BOOT_MARKER_LEN);
+    uint32_t crc;
+
+    crc = crc32_compute((uint8_t*)CODE_REGION_1_START, len, NULL);
+    crc = crc32_compute((uint8_t*)CODE_REGION_1_START + image_size - len, len, &crc);
+
+    return crc;
+}
+
+
+/** @brief Function for checking if the last validation of bank 0 still applies.
+ */
+static bool boot_validation_is_current(void)
+{
+    nrf_dfu_boot_validation_t const * p_valid = &s_dfu_settings.boot_validation;
+
+    return (p_valid->validated    == NRF_DFU_BOOT_VALIDATED)              &&
+           (p_valid->image_size   == s_dfu_settings.bank_0.image_size)    &&
+           (p_valid->image_crc    == s_dfu_settings.bank_0.image_crc)     &&
+           (p_valid->image_marker == boot_marker_compute(p_valid->image_size));
+}
+
+
 static void nrf_dfu_invalidate_bank(nrf_dfu_bank_t * p_bank)
 {
     // Set the bank-code to invalid, and reset size/CRC
@@ -443,6 +476,12 @@ bool nrf_dfu_app_is_valid(void)
     // If CRC == 0, this means CRC check is skipped.
     if (s_dfu_settings.bank_0.image_crc != 0)
     {
+        if (boot_validation_is_current())
+        {
+            NRF_LOG_INFO("Return true. App was validated on an earlier boot\r\n");
+            return true;
+        }
+
         uint32_t crc = crc32_compute((uint8_t*) CODE_REGION_1_START,
                                      s_dfu_settings.bank_0.image_size,
                                      NULL);
@@ -453,6 +492,16 @@ bool nrf_dfu_app_is_valid(void)
             NRF_LOG_INFO("Return false in CRC\r\n");
             return  false;
         }
+
+        // Record the result, so that the CRC is not computed on the next boots.
+        s_dfu_settings.boot_validation.validated    = NRF_DFU_BOOT_VALIDATED;
+        s_dfu_settings.boot_validation.image_size   = s_dfu_settings.bank_0.image_size;
+        s_dfu_settings.boot_validation.image_crc    = crc;
+        s_dfu_settings.boot_validation.image_marker = boot_marker_compute(s_dfu_settings.bank_0.image_size);
+        if (nrf_dfu_settings_write(NULL) != NRF_SUCCESS)
+        {
+            NRF_LOG_INFO("Could not record the validation\r\n");
+        }
     }
 
     NRF_LOG_INFO("Return true. App was valid\r\n");
@@ -469,6 +518,9 @@ uint32_t nrf_dfu_find_cache(uint32_t size_req, bool dual_bank_only, uint32_t * p
 
     NRF_LOG_INFO("Enter nrf_dfu_find_cache\r\n");
 
+    // A new image is received, it is validated on the next boot.
+    memset(&s_dfu_settings.boot_validation, 0, sizeof(nrf_dfu_boot_validation_t));
+
     // Simple check if size requirement can me met
     if(free_size < size_req)
     {
@@ -508,7 +560,7 @@ uint32_t nrf_dfu_find_cache(uint32_t size_req, bool dual_bank_only, uint32_t * p
                 return NRF_ERROR_NO_MEM;
             }
 
-            // Can only support single bank update, clearing old app.
+            // Can only support single bank update, the old app is replaced in place.
             s_dfu_settings.bank_layout = NRF_DFU_BANK_LAYOUT_SINGLE;
             s_dfu_settings.bank_current = NRF_DFU_CURRENT_BANK_0;
             p_bank = &s_dfu_settings.bank_0;
@@ -56,7 +56,9 @@ uint32_t nrf_dfu_continue(uint32_t * p_enter_dfu_mode);
 /** @brief Function for checking if the main application is valid.
  *
  * @details     This function checks if there is a valid application
- *              located at Bank 0.
+ *              located at Bank 0. The CRC of the application is computed only if it
+ *              was not validated on an earlier boot, or if the application or the bank
+ *              changed since. The result is then recorded in the DFU settings.
  *
  * @retval  true  If a valid application has been detected.
  * @retval  false If there is no valid application.
@@ -69,7 +71,10 @@ bool nrf_dfu_app_is_valid(void);
  * @details This function checks the size requirements and selects a location for
  *          placing the cache of the DFU images.
  *          The function tries to find enough space in Bank 1. If there is not enough space,
- *          the present application is erased.
+ *          the present application is replaced in place: bank 0 is selected, and its pages
+ *          are erased and written as the data objects are received. The DFU progress in the
+ *          settings records the last executed object, the update is resumed from it after a
+ *          reset.
  *
  * @param[in]   size_req        Requirements for the size of the new image.
  * @param[in]   dual_bank_only  True to enforce dual-bank updates. In this case, if there
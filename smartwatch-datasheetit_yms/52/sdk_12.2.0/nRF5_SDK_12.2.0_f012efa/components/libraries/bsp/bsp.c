@@ -25,13 +25,23 @@
 #include "app_button.h"
 #endif // BSP_SIMPLE
 
+#if LEDS_NUMBER > 0 && !(defined BSP_SIMPLE) && (defined BSP_PWM_INDICATION)
+#include "app_util_platform.h"
+#include "pwm_effects.h"
+#endif
+
 #if LEDS_NUMBER > 0 && !(defined BSP_SIMPLE)
 static bsp_indication_t m_stable_state        = BSP_INDICATE_IDLE;
-static bool             m_leds_clear          = false;
 static uint32_t         m_app_ticks_per_100ms = 0;
 static uint32_t         m_indication_type     = 0;
+#ifdef BSP_PWM_INDICATION
+static bsp_indication_t m_alert_state         = BSP_INDICATE_ALERT_OFF;
+static bool volatile    m_short_playing       = false;
+#else
+static bool             m_leds_clear          = false;
 APP_TIMER_DEF(m_leds_timer_id);
 APP_TIMER_DEF(m_alert_timer_id);
+#endif // BSP_PWM_INDICATION
 #endif // LEDS_NUMBER > 0 && !(defined BSP_SIMPLE)
 
 #if BUTTONS_NUMBER > 0
@@ -150,7 +160,252 @@ static void button_timer_handler(void * p_context)
 
 #endif // (BUTTONS_NUMBER > 0) && !(defined BSP_SIMPLE)
 
-#if LEDS_NUMBER > 0 && !(defined BSP_SIMPLE)
+#if LEDS_NUMBER > 0 && !(defined BSP_SIMPLE) && (defined BSP_PWM_INDICATION)
+#define PWM_LED_ON       PWM_EFFECTS_LEVEL_MAX
+#define PWM_LED_MASK(n)  ((uint8_t)(1UL << (n)))
+#define PWM_LEDS_ALL     ((uint8_t)((1UL << MIN(LEDS_NUMBER, NRF_PWM_CHANNEL_COUNT)) - 1))
+#define PWM_TABLE_LENGTH ((ADVERTISING_SLOW_LED_ON_INTERVAL + ADVERTISING_SLOW_LED_OFF_INTERVAL) / \
+                          BSP_PWM_INDICATION_STEP_MS)
+
+static void bsp_pwm_evt_handler(void);
+
+static nrf_drv_pwm_t const         m_pwm = NRF_DRV_PWM_INSTANCE(BSP_PWM_INDICATION_INSTANCE);
+static nrf_pwm_values_individual_t m_pwm_table[PWM_TABLE_LENGTH];
+
+/**@brief Configuration of the PWM effects. A PWM period of 100 us keeps the time it takes to stop
+ *        the playback, when the indication is switched, short.
+ */
+static pwm_effects_config_t const m_pwm_effects_config =
+{
+    .p_pwm        = &m_pwm,
+    .output_pins  =
+    {
+#if LEDS_NUMBER > 0
+        LED_1 | (LEDS_ACTIVE_STATE ? 0 : NRF_DRV_PWM_PIN_INVERTED),
+#else
+        NRF_DRV_PWM_PIN_NOT_USED,
+#endif
+#if LEDS_NUMBER > 1
+        LED_2 | (LEDS_ACTIVE_STATE ? 0 : NRF_DRV_PWM_PIN_INVERTED),
+#else
+        NRF_DRV_PWM_PIN_NOT_USED,
+#endif
+#if LEDS_NUMBER > 2
+        LED_3 | (LEDS_ACTIVE_STATE ? 0 : NRF_DRV_PWM_PIN_INVERTED),
+#else
+        NRF_DRV_PWM_PIN_NOT_USED,
+#endif
+#if LEDS_NUMBER > 3
+        LED_4 | (LEDS_ACTIVE_STATE ? 0 : NRF_DRV_PWM_PIN_INVERTED),
+#else
+        NRF_DRV_PWM_PIN_NOT_USED,
+#endif
+    },
+    .base_clock   = NRF_PWM_CLK_1MHz,
+    .top_value    = 100,
+    .step_ms      = BSP_PWM_INDICATION_STEP_MS,
+    .irq_priority = BSP_PWM_INDICATION_IRQ_PRIORITY,
+    .p_table      = m_pwm_table,
+    .table_length = PWM_TABLE_LENGTH,
+    .evt_handler  = bsp_pwm_evt_handler
+};
+
+
+/**@brief Function for blinking LEDs in a loop, or turning them on once, for @p on_ms.
+ *
+ * @param[in]   led_mask   LEDs to blink.
+ * @param[in]   on_ms      Time the LEDs are on, a multiple of @ref BSP_PWM_INDICATION_STEP_MS.
+ * @param[in]   off_ms     Time the LEDs are off, or 0 to turn them on once.
+ */
+static uint32_t pwm_blink(uint8_t led_mask, uint16_t on_ms, uint16_t off_ms)
+{
+    pwm_effects_segment_t segments[2];
+    uint16_t              count = 0;
+
+    if (off_ms != 0)
+    {
+        return pwm_effects_breathe(led_mask, 0, PWM_LED_ON, 0,
+                                   on_ms  - BSP_PWM_INDICATION_STEP_MS,
+                                   off_ms - BSP_PWM_INDICATION_STEP_MS);
+    }
+
+    // A segment without ramp jumps to its level, and holds it for one step.
+    segments[count++] = (pwm_effects_segment_t){.level = PWM_LED_ON, .time_ms = 0};
+    if (on_ms > BSP_PWM_INDICATION_STEP_MS)
+    {
+        segments[count++] = (pwm_effects_segment_t){.level   = PWM_LED_ON,
+                                                    .time_ms = on_ms - BSP_PWM_INDICATION_STEP_MS};
+    }
+    return pwm_effects_play(led_mask, segments, count, false);
+}
+
+
+/**@brief Function for showing the alert, or the stable state when no alert is on.
+ */
+static uint32_t pwm_state_show(void)
+{
+    uint32_t next_delay;
+
+    if (m_alert_state != BSP_INDICATE_ALERT_OFF)
+    {
+        next_delay = (uint32_t)BSP_INDICATE_ALERT_OFF - (uint32_t)m_alert_state;
+        if (next_delay > 1)
+        {
+            return pwm_blink(PWM_LED_MASK(BSP_LED_ALERT),
+                             next_delay * ALERT_INTERVAL,
+                             next_delay * ALERT_INTERVAL);
+        }
+        pwm_effects_level_set(PWM_LED_MASK(BSP_LED_ALERT), PWM_LED_ON);
+        return NRF_SUCCESS;
+    }
+
+    switch (m_stable_state)
+    {
+        case BSP_INDICATE_SCANNING:
+            return pwm_blink(PWM_LED_MASK(BSP_LED_INDICATE_INDICATE_ADVERTISING),
+                             ADVERTISING_SLOW_LED_ON_INTERVAL,
+                             ADVERTISING_SLOW_LED_OFF_INTERVAL);
+
+        case BSP_INDICATE_ADVERTISING:
+            return pwm_blink(PWM_LED_MASK(BSP_LED_INDICATE_INDICATE_ADVERTISING),
+                             ADVERTISING_LED_ON_INTERVAL,
+                             ADVERTISING_LED_OFF_INTERVAL);
+
+        case BSP_INDICATE_ADVERTISING_WHITELIST:
+            return pwm_blink(PWM_LED_MASK(BSP_LED_INDICATE_ADVERTISING_WHITELIST),
+                             ADVERTISING_WHITELIST_LED_ON_INTERVAL,
+                             ADVERTISING_WHITELIST_LED_OFF_INTERVAL);
+
+        case BSP_INDICATE_ADVERTISING_SLOW:
+            return pwm_blink(PWM_LED_MASK(BSP_LED_INDICATE_ADVERTISING_SLOW),
+                             ADVERTISING_SLOW_LED_ON_INTERVAL,
+                             ADVERTISING_SLOW_LED_OFF_INTERVAL);
+
+        case BSP_INDICATE_ADVERTISING_DIRECTED:
+            return pwm_blink(PWM_LED_MASK(BSP_LED_INDICATE_ADVERTISING_DIRECTED),
+                             ADVERTISING_DIRECTED_LED_ON_INTERVAL,
+                             ADVERTISING_DIRECTED_LED_OFF_INTERVAL);
+
+        case BSP_INDICATE_BONDING:
+            return pwm_blink(PWM_LED_MASK(BSP_LED_INDICATE_BONDING),
+                             BONDING_INTERVAL,
+                             BONDING_INTERVAL);
+
+        case BSP_INDICATE_CONNECTED:
+            pwm_effects_level_set(PWM_LED_MASK(BSP_LED_INDICATE_CONNECTED), PWM_LED_ON);
+            break;
+
+        case BSP_INDICATE_USER_STATE_0:
+            pwm_effects_level_set(PWM_LED_MASK(BSP_LED_INDICATE_USER_LED1), PWM_LED_ON);
+            break;
+
+        case BSP_INDICATE_USER_STATE_1:
+            pwm_effects_level_set(PWM_LED_MASK(BSP_LED_INDICATE_USER_LED2), PWM_LED_ON);
+            break;
+
+        case BSP_INDICATE_USER_STATE_2:
+            pwm_effects_level_set(PWM_LED_MASK(BSP_LED_INDICATE_USER_LED1) |
+                                  PWM_LED_MASK(BSP_LED_INDICATE_USER_LED2),
+                                  PWM_LED_ON);
+            break;
+
+        case BSP_INDICATE_FATAL_ERROR:
+        case BSP_INDICATE_USER_STATE_3:
+        case BSP_INDICATE_USER_STATE_ON:
+            pwm_effects_level_set(PWM_LEDS_ALL, PWM_LED_ON);
+            break;
+
+        default:
+            pwm_effects_stop();
+            break;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief       Configure leds to indicate required state.
+ *
+ * @details     Each state is a pattern played by the PWM peripheral, in a loop. The switch to a
+ *              new pattern is done in one critical region, so that it is not mixed with the end
+ *              of a short indication. An alert is shown instead of the stable state while it is
+ *              on, and the short indications, like @ref BSP_INDICATE_SENT_OK, are shown once
+ *              before the alert or the stable state is shown again.
+ *
+ * @param[in]   indicate   State to be indicated.
+ */
+static uint32_t bsp_led_indication(bsp_indication_t indicate)
+{
+    uint32_t err_code = NRF_SUCCESS;
+
+    CRITICAL_REGION_ENTER();
+    switch (indicate)
+    {
+        case BSP_INDICATE_SENT_OK:
+            m_short_playing = true;
+            err_code = pwm_blink(PWM_LED_MASK(BSP_LED_INDICATE_SENT_OK), SENT_OK_INTERVAL, 0);
+            break;
+
+        case BSP_INDICATE_SEND_ERROR:
+            m_short_playing = true;
+            err_code = pwm_blink(PWM_LED_MASK(BSP_LED_INDICATE_SEND_ERROR), SEND_ERROR_INTERVAL, 0);
+            break;
+
+        case BSP_INDICATE_RCV_OK:
+            m_short_playing = true;
+            err_code = pwm_blink(PWM_LED_MASK(BSP_LED_INDICATE_RCV_OK), RCV_OK_INTERVAL, 0);
+            break;
+
+        case BSP_INDICATE_RCV_ERROR:
+            m_short_playing = true;
+            err_code = pwm_blink(PWM_LED_MASK(BSP_LED_INDICATE_RCV_ERROR), RCV_ERROR_INTERVAL, 0);
+            break;
+
+        case BSP_INDICATE_ALERT_0:
+        case BSP_INDICATE_ALERT_1:
+        case BSP_INDICATE_ALERT_2:
+        case BSP_INDICATE_ALERT_3:
+        case BSP_INDICATE_ALERT_OFF:
+            m_short_playing = false;
+            m_alert_state   = indicate;
+            err_code        = pwm_state_show();
+            break;
+
+        default:
+            if (indicate <= BSP_INDICATE_LAST)
+            {
+                m_short_playing = false;
+                m_stable_state  = indicate;
+                err_code        = pwm_state_show();
+            }
+            break;
+    }
+
+    if (err_code != NRF_SUCCESS)
+    {
+        m_short_playing = false;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return err_code;
+}
+
+
+/**@brief Handle the end of a short indication, from the PWM interrupt.
+ */
+static void bsp_pwm_evt_handler(void)
+{
+    CRITICAL_REGION_ENTER();
+    if (m_short_playing)
+    {
+        m_short_playing = false;
+        UNUSED_VARIABLE(pwm_state_show());
+    }
+    CRITICAL_REGION_EXIT();
+}
+#endif // LEDS_NUMBER > 0 && !(defined BSP_SIMPLE) && (defined BSP_PWM_INDICATION)
+
+#if LEDS_NUMBER > 0 && !(defined BSP_SIMPLE) && !(defined BSP_PWM_INDICATION)
 /**@brief       Configure leds to indicate required state.
  * @param[in]   indicate   State to be indicated.
  */
@@ -397,7 +652,7 @@ static void alert_timer_handler(void * p_context)
     UNUSED_PARAMETER(p_context);
     bsp_board_led_invert(BSP_LED_ALERT);
 }
-#endif // #if LEDS_NUMBER > 0 && !(defined BSP_SIMPLE)
+#endif // #if LEDS_NUMBER > 0 && !(defined BSP_SIMPLE) && !(defined BSP_PWM_INDICATION)
 
 
 /**@brief Configure indicators to required state.
@@ -476,6 +731,12 @@ uint32_t bsp_init(uint32_t type, uint32_t ticks_per_100ms, bsp_event_callback_t
         bsp_board_leds_init();
     }
 
+#ifdef BSP_PWM_INDICATION
+    if ((err_code == NRF_SUCCESS) && (type & BSP_INIT_LED))
+    {
+        err_code = pwm_effects_init(&m_pwm_effects_config);
+    }
+#else
     // timers module must be already initialized!
     if (err_code == NRF_SUCCESS)
     {
@@ -488,6 +749,7 @@ uint32_t bsp_init(uint32_t type, uint32_t ticks_per_100ms, bsp_event_callback_t
         err_code =
             app_timer_create(&m_alert_timer_id, APP_TIMER_MODE_REPEATED, alert_timer_handler);
     }
+#endif // BSP_PWM_INDICATION
 #endif // LEDS_NUMBER > 0 && !(defined BSP_SIMPLE)
 
     return err_code;
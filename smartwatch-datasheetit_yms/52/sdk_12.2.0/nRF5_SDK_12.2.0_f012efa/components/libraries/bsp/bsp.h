@@ -23,6 +23,8 @@
  *          - BSP_SIMPLE reduces functionality of this module to enable
  *            and read state of the buttons
  *          - BSP_UART_SUPPORT enables support for UART
+ *          - BSP_PWM_INDICATION shows the indications with @ref pwm_effects instead of
+ *            app_timer, so that no CPU is needed while they are shown.
  */
 
 #ifndef BSP_H__
@@ -171,7 +173,8 @@ typedef void (* bsp_event_callback_t)(bsp_event_t);
  * @details     The function initializes the board support package to allow state indication and
  *              button reaction. Default events are assigned to buttons.
  * @note        Before calling this function, you must initiate the following required modules:
- *              - @ref app_timer for LED support
+ *              - @ref app_timer for LED support, unless BSP_PWM_INDICATION is defined. Then the
+ *                PWM instance BSP_PWM_INDICATION_INSTANCE must be enabled in the PWM driver.
  *              - @ref app_gpiote for button support
  *              - @ref app_uart for UART support
  *
@@ -220,7 +223,9 @@ uint32_t bsp_event_to_button_action_assign(uint32_t button, bsp_button_action_t
  *
  * @details     This function indicates the required state by means of LEDs (if enabled).
  *
- * @note        Alerts are indicated independently.
+ * @note        Alerts are indicated independently. With BSP_PWM_INDICATION, an alert is shown
+ *              instead of the state while it is on, and the short indications like
+ *              @ref BSP_INDICATE_SENT_OK are shown once in place of both, on one LED.
  *
  * @param[in]   indicate   State to be indicated.
  *
@@ -228,6 +233,8 @@ uint32_t bsp_event_to_button_action_assign(uint32_t button, bsp_button_action_t
  * @retval      NRF_ERROR_NO_MEM          If the internal timer operations queue was full.
  * @retval      NRF_ERROR_INVALID_STATE   If the application timer module has not been initialized,
  *                                        or internal timer has not been created.
+ * @retval      NRF_ERROR_NO_MEM          With BSP_PWM_INDICATION, if a pattern did not fit in the
+ *                                        sequence table.
  */
 uint32_t bsp_indication_set(bsp_indication_t indicate);
 
@@ -23,6 +23,8 @@
  *          - BSP_SIMPLE - reduces functionality of this module to enable
  *            and read state of the buttons.
  *          - BSP_UART_SUPPORT - enables support for UART.
+ *          - BSP_PWM_INDICATION - shows the indications with @ref pwm_effects instead of
+ *            app_timer, so that no CPU is needed while they are shown.
  */
 
 #ifndef BSP_CONFIG_H__
@@ -99,6 +101,27 @@ extern "C" {
 
 #define BSP_LED_ALERT                         BSP_BOARD_LED_2
 
+#ifdef BSP_PWM_INDICATION
+/** @brief PWM instance that shows the indications, with BSP_PWM_INDICATION.
+ *
+ * Channel n of the instance drives board LED n. @ref pwm_effects is used by the BSP only.
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BSP_PWM_INDICATION_INSTANCE
+#define BSP_PWM_INDICATION_INSTANCE 0
+#endif
+
+/** @brief Priority of the PWM interrupt, which only runs at the end of a short indication.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BSP_PWM_INDICATION_IRQ_PRIORITY
+#define BSP_PWM_INDICATION_IRQ_PRIORITY APP_IRQ_PRIORITY_LOWEST
+#endif
+
+#define BSP_PWM_INDICATION_STEP_MS             100 /**< Resolution of the indication patterns. All intervals are multiples of it. */
+#endif // BSP_PWM_INDICATION
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,343 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(NRF_BUS_MGR)
+#include "nrf_bus_mgr.h"
+#include "app_util_platform.h"
+
+/** Managers in SPI mode, by peripheral. The SPI driver passes no context to its handler. */
+static nrf_bus_mgr_t * m_spi_owners[2];
+
+static void transaction_end(nrf_bus_mgr_t * p_mgr, ret_code_t result);
+
+
+static void twi_handler(nrf_drv_twi_evt_t const * p_event, void * p_context);
+
+static void spi0_handler(nrf_drv_spi_evt_t const * p_event)
+{
+    UNUSED_PARAMETER(p_event);
+    transaction_end(m_spi_owners[0], NRF_SUCCESS);
+}
+
+static void spi1_handler(nrf_drv_spi_evt_t const * p_event)
+{
+    UNUSED_PARAMETER(p_event);
+    transaction_end(m_spi_owners[1], NRF_SUCCESS);
+}
+
+
+/**@brief Function for uninitializing the driver of the current client. */
+static void deactivate(nrf_bus_mgr_t * p_mgr)
+{
+    if (p_mgr->p_active == NULL)
+    {
+        return;
+    }
+
+    if (p_mgr->p_active->mode == NRF_BUS_MGR_MODE_TWI)
+    {
+        nrf_drv_twi_uninit(&p_mgr->twi);
+    }
+    else
+    {
+        nrf_drv_spi_uninit(&p_mgr->spi);
+        m_spi_owners[p_mgr->id] = NULL;
+    }
+    p_mgr->p_active = NULL;
+}
+
+
+/**@brief Function for initializing the driver for a client, if it is not the current one. */
+static ret_code_t activate(nrf_bus_mgr_t * p_mgr, nrf_bus_mgr_client_t const * p_client)
+{
+    ret_code_t err_code;
+
+    if (p_mgr->p_active == p_client)
+    {
+        return NRF_SUCCESS;
+    }
+
+    deactivate(p_mgr);
+
+    if (p_client->mode == NRF_BUS_MGR_MODE_TWI)
+    {
+        err_code = nrf_drv_twi_init(&p_mgr->twi, &p_client->config.twi, twi_handler, p_mgr);
+        VERIFY_SUCCESS(err_code);
+        nrf_drv_twi_enable(&p_mgr->twi);
+    }
+    else
+    {
+        m_spi_owners[p_mgr->id] = p_mgr;
+        err_code = nrf_drv_spi_init(&p_mgr->spi, &p_client->config.spi,
+                                    (p_mgr->id == 0) ? spi0_handler : spi1_handler);
+        VERIFY_SUCCESS(err_code);
+    }
+
+    p_mgr->p_active = p_client;
+    p_mgr->switches++;
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for starting the current transfer of the current transaction. */
+static ret_code_t transfer_start(nrf_bus_mgr_t * p_mgr)
+{
+    nrf_bus_mgr_transaction_t const * p_trans = p_mgr->p_current;
+
+    if (p_trans->p_client->mode == NRF_BUS_MGR_MODE_SPI)
+    {
+        return nrf_drv_spi_transfer(&p_mgr->spi,
+                                    p_trans->xfer.spi.p_tx, p_trans->xfer.spi.tx_len,
+                                    p_trans->xfer.spi.p_rx, p_trans->xfer.spi.rx_len);
+    }
+
+    app_twi_transfer_t const * p_transfer = &p_trans->xfer.twi.p_transfers[p_mgr->transfer_idx];
+    uint8_t                    address    = APP_TWI_OP_ADDRESS(p_transfer->operation);
+
+    if (APP_TWI_IS_READ_OP(p_transfer->operation))
+    {
+        return nrf_drv_twi_rx(&p_mgr->twi, address, p_transfer->p_data, p_transfer->length);
+    }
+
+    return nrf_drv_twi_tx(&p_mgr->twi, address, p_transfer->p_data, p_transfer->length,
+                          (p_transfer->flags & APP_TWI_NO_STOP) != 0);
+}
+
+
+/**@brief Function for taking the next transaction out of the queues.
+ *
+ * @details Within the highest priority with transactions, a transaction of the current client is
+ *          taken first, unless @ref NRF_BUS_MGR_CONFIG_BATCH_MAX transactions of other clients
+ *          were already passed over.
+ */
+static nrf_bus_mgr_transaction_t * next_take(nrf_bus_mgr_t * p_mgr)
+{
+    for (uint32_t prio = 0; prio < NRF_BUS_MGR_PRIO_COUNT; prio++)
+    {
+        nrf_bus_mgr_transaction_t * p_prev  = NULL;
+        nrf_bus_mgr_transaction_t * p_trans = p_mgr->p_head[prio];
+
+        if (p_trans == NULL)
+        {
+            continue;
+        }
+
+        if ((p_mgr->p_active != NULL) && (p_trans->p_client != p_mgr->p_active) &&
+            (p_mgr->batch_count < NRF_BUS_MGR_CONFIG_BATCH_MAX))
+        {
+            while ((p_trans != NULL) && (p_trans->p_client != p_mgr->p_active))
+            {
+                p_prev  = p_trans;
+                p_trans = p_trans->p_next;
+            }
+            if (p_trans == NULL)
+            {
+                p_prev  = NULL;
+                p_trans = p_mgr->p_head[prio];
+            }
+        }
+
+        // Only transactions passing over others count towards the limit.
+        p_mgr->batch_count = (p_prev != NULL) ? (p_mgr->batch_count + 1) : 0;
+
+        if (p_prev == NULL)
+        {
+            p_mgr->p_head[prio] = p_trans->p_next;
+        }
+        else
+        {
+            p_prev->p_next = p_trans->p_next;
+        }
+        if (p_mgr->p_tail[prio] == p_trans)
+        {
+            p_mgr->p_tail[prio] = p_prev;
+        }
+        return p_trans;
+    }
+
+    return NULL;
+}
+
+
+/**@brief Function for starting the next transaction. Must be called in a critical region when no
+ *        transaction is in progress.
+ */
+static void next_start(nrf_bus_mgr_t * p_mgr)
+{
+    nrf_bus_mgr_transaction_t * p_trans;
+
+    while ((p_trans = next_take(p_mgr)) != NULL)
+    {
+        ret_code_t err_code;
+
+        p_mgr->p_current    = p_trans;
+        p_mgr->transfer_idx = 0;
+
+        err_code = activate(p_mgr, p_trans->p_client);
+        if (err_code == NRF_SUCCESS)
+        {
+            if ((p_trans->p_client->mode == NRF_BUS_MGR_MODE_TWI) &&
+                (p_trans->xfer.twi.number_of_transfers == 0))
+            {
+                err_code = NRF_ERROR_INVALID_LENGTH;
+            }
+            else
+            {
+                err_code = transfer_start(p_mgr);
+            }
+        }
+        if (err_code == NRF_SUCCESS)
+        {
+            return;
+        }
+
+        p_mgr->p_current = NULL;
+        if (p_trans->callback != NULL)
+        {
+            p_trans->callback(err_code, p_trans->p_user_data);
+        }
+    }
+
+    p_mgr->p_current = NULL;
+}
+
+
+/**@brief Function for ending the current transaction. The next one is started before the callback
+ *        is called, so the bus is kept busy while the callback runs.
+ */
+static void transaction_end(nrf_bus_mgr_t * p_mgr, ret_code_t result)
+{
+    nrf_bus_mgr_transaction_t * p_trans = p_mgr->p_current;
+
+    CRITICAL_REGION_ENTER();
+    p_mgr->p_current = NULL;
+    next_start(p_mgr);
+    CRITICAL_REGION_EXIT();
+
+    if ((p_trans != NULL) && (p_trans->callback != NULL))
+    {
+        p_trans->callback(result, p_trans->p_user_data);
+    }
+}
+
+
+static void twi_handler(nrf_drv_twi_evt_t const * p_event, void * p_context)
+{
+    nrf_bus_mgr_t * p_mgr = (nrf_bus_mgr_t *)p_context;
+    ret_code_t      result;
+
+    switch (p_event->type)
+    {
+        case NRF_DRV_TWI_EVT_DONE:
+            p_mgr->transfer_idx++;
+            if (p_mgr->transfer_idx < p_mgr->p_current->xfer.twi.number_of_transfers)
+            {
+                result = transfer_start(p_mgr);
+                if (result == NRF_SUCCESS)
+                {
+                    return;
+                }
+            }
+            else
+            {
+                result = NRF_SUCCESS;
+            }
+            break;
+
+        case NRF_DRV_TWI_EVT_ADDRESS_NACK:
+            result = NRF_ERROR_DRV_TWI_ERR_ANACK;
+            break;
+
+        default:
+            result = NRF_ERROR_DRV_TWI_ERR_DNACK;
+            break;
+    }
+
+    transaction_end(p_mgr, result);
+}
+
+
+ret_code_t nrf_bus_mgr_init(nrf_bus_mgr_t * p_mgr)
+{
+    VERIFY_PARAM_NOT_NULL(p_mgr);
+
+    for (uint32_t prio = 0; prio < NRF_BUS_MGR_PRIO_COUNT; prio++)
+    {
+        p_mgr->p_head[prio] = NULL;
+        p_mgr->p_tail[prio] = NULL;
+    }
+    p_mgr->p_current   = NULL;
+    p_mgr->p_active    = NULL;
+    p_mgr->batch_count = 0;
+    p_mgr->switches    = 0;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_bus_mgr_schedule(nrf_bus_mgr_t             * p_mgr,
+                                nrf_bus_mgr_transaction_t * p_transaction,
+                                nrf_bus_mgr_prio_t          prio)
+{
+    VERIFY_PARAM_NOT_NULL(p_mgr);
+    VERIFY_PARAM_NOT_NULL(p_transaction);
+    VERIFY_PARAM_NOT_NULL(p_transaction->p_client);
+
+    if ((prio >= NRF_BUS_MGR_PRIO_COUNT) ||
+        ((p_transaction->p_client->mode != NRF_BUS_MGR_MODE_TWI) &&
+         (p_transaction->p_client->mode != NRF_BUS_MGR_MODE_SPI)))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    p_transaction->p_next = NULL;
+
+    CRITICAL_REGION_ENTER();
+    if (p_mgr->p_tail[prio] == NULL)
+    {
+        p_mgr->p_head[prio] = p_transaction;
+    }
+    else
+    {
+        p_mgr->p_tail[prio]->p_next = p_transaction;
+    }
+    p_mgr->p_tail[prio] = p_transaction;
+
+    if (p_mgr->p_current == NULL)
+    {
+        next_start(p_mgr);
+    }
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_bus_mgr_release(nrf_bus_mgr_t * p_mgr)
+{
+    ret_code_t err_code = NRF_SUCCESS;
+
+    CRITICAL_REGION_ENTER();
+    if (p_mgr->p_current != NULL)
+    {
+        err_code = NRF_ERROR_BUSY;
+    }
+    else
+    {
+        deactivate(p_mgr);
+    }
+    CRITICAL_REGION_EXIT();
+
+    return err_code;
+}
+
+#endif // NRF_MODULE_ENABLED(NRF_BUS_MGR)
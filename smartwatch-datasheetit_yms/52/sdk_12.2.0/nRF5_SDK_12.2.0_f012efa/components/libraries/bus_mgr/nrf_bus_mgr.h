@@ -0,0 +1,196 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup nrf_bus_mgr Shared bus manager
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for sharing a TWI/SPI peripheral between clients in TWI and SPI modes.
+ *
+ * @details On nRF52832, TWI0 and SPI0, and TWI1 and SPI1, are the same peripheral. A bus manager
+ *          owns one of them and performs the transactions of several clients, each a TWI or SPI
+ *          device with its own driver configuration. Transactions are queued by priority and
+ *          performed one at a time, from the interrupt of the peripheral.
+ *
+ *          The driver is initialized for a client only when one of its transactions starts, and
+ *          kept until a transaction of another client starts. Among the transactions of the
+ *          highest priority, those of the current client run first, up to
+ *          @ref NRF_BUS_MGR_CONFIG_BATCH_MAX in a row, so that switching between TWI and SPI, or
+ *          between SPI devices, is rare.
+ *
+ *          TWI transactions are made of @ref app_twi_transfer_t transfers, created with the
+ *          @ref APP_TWI_WRITE and @ref APP_TWI_READ macros.
+ *
+ * @note The TWI and SPI drivers of the instance must be enabled, with
+ *       PERIPHERAL_RESOURCE_SHARING_ENABLED, and must not be used directly.
+ */
+
+#ifndef NRF_BUS_MGR_H__
+#define NRF_BUS_MGR_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+#include "nrf_drv_twi.h"
+#include "nrf_drv_spi.h"
+#include "app_twi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Highest number of transactions of the current client in a row, while transactions of
+ *         other clients wait at the same priority.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef NRF_BUS_MGR_CONFIG_BATCH_MAX
+#define NRF_BUS_MGR_CONFIG_BATCH_MAX 8
+#endif
+
+/**@brief Transaction priorities. */
+typedef enum
+{
+    NRF_BUS_MGR_PRIO_HIGH,   /**< For example, sensors with a FIFO about to overflow. */
+    NRF_BUS_MGR_PRIO_NORMAL, /**< For example, display updates. */
+    NRF_BUS_MGR_PRIO_LOW,    /**< For example, background flash writes. */
+    NRF_BUS_MGR_PRIO_COUNT   /**< Number of priorities. */
+} nrf_bus_mgr_prio_t;
+
+/**@brief Peripheral modes. */
+typedef enum
+{
+    NRF_BUS_MGR_MODE_NONE, /**< The driver is not initialized. */
+    NRF_BUS_MGR_MODE_TWI,  /**< TWI master. */
+    NRF_BUS_MGR_MODE_SPI   /**< SPI master. */
+} nrf_bus_mgr_mode_t;
+
+/**@brief Client: a device on the bus, and the driver configuration it needs. */
+typedef struct
+{
+    nrf_bus_mgr_mode_t mode;            /**< Mode of the device. */
+    union
+    {
+        nrf_drv_twi_config_t twi;       /**< Configuration in TWI mode. */
+        nrf_drv_spi_config_t spi;       /**< Configuration in SPI mode, with the SS pin of the device. */
+    } config;
+} nrf_bus_mgr_client_t;
+
+/**@brief Transaction callback. Called from the interrupt of the peripheral, after the next
+ *        transaction was started.
+ *
+ * @param[in] result      NRF_SUCCESS, or the error of the driver.
+ * @param[in] p_user_data User data of the transaction.
+ */
+typedef void (* nrf_bus_mgr_callback_t)(ret_code_t result, void * p_user_data);
+
+/**@brief Transaction. Kept in memory until its callback is called. */
+typedef struct nrf_bus_mgr_transaction_s
+{
+    nrf_bus_mgr_client_t const * p_client;    /**< Client. */
+    nrf_bus_mgr_callback_t       callback;    /**< Callback, can be NULL. */
+    void                       * p_user_data; /**< User data passed to the callback. */
+    union
+    {
+        struct
+        {
+            app_twi_transfer_t const * p_transfers;         /**< Transfers. */
+            uint8_t                    number_of_transfers; /**< Number of transfers. */
+        } twi;                                              /**< Transaction of a TWI client. */
+        struct
+        {
+            uint8_t const * p_tx;   /**< Data to send. */
+            uint8_t         tx_len; /**< Number of bytes to send. */
+            uint8_t       * p_rx;   /**< Buffer for the received data. */
+            uint8_t         rx_len; /**< Number of bytes to receive. */
+        } spi;                      /**< Transaction of an SPI client. */
+    } xfer;
+    struct nrf_bus_mgr_transaction_s * p_next; /**< Private to this module. */
+} nrf_bus_mgr_transaction_t;
+
+/**@brief Bus manager instance. Its content is private to this module. */
+typedef struct
+{
+    nrf_drv_twi_t const                  twi;      /**< TWI driver instance. */
+    nrf_drv_spi_t const                  spi;      /**< SPI driver instance. */
+    uint8_t                              id;       /**< Index of the peripheral. */
+    nrf_bus_mgr_transaction_t * volatile p_head[NRF_BUS_MGR_PRIO_COUNT];
+    nrf_bus_mgr_transaction_t *          p_tail[NRF_BUS_MGR_PRIO_COUNT];
+    nrf_bus_mgr_transaction_t * volatile p_current;
+    nrf_bus_mgr_client_t const *         p_active; /**< Client the driver is initialized for. */
+    uint8_t                              transfer_idx;
+    uint8_t                              batch_count;
+    uint32_t                             switches; /**< Number of driver initializations. */
+} nrf_bus_mgr_t;
+
+/**@brief Macro for creating a bus manager instance.
+ *
+ * @param[in] idx Index of the shared peripheral: 0 or 1.
+ */
+#define NRF_BUS_MGR_INSTANCE(idx)              \
+{                                              \
+    .twi = NRF_DRV_TWI_INSTANCE(idx),          \
+    .spi = NRF_DRV_SPI_INSTANCE(idx),          \
+    .id  = idx                                 \
+}
+
+/**@brief Function for initializing a bus manager. The driver is not initialized yet.
+ *
+ * @param[in] p_mgr Bus manager instance.
+ *
+ * @retval NRF_SUCCESS    If the manager was initialized.
+ * @retval NRF_ERROR_NULL If p_mgr was NULL.
+ */
+ret_code_t nrf_bus_mgr_init(nrf_bus_mgr_t * p_mgr);
+
+/**@brief Function for scheduling a transaction. Can be called from any context.
+ *
+ * @param[in] p_mgr         Bus manager instance.
+ * @param[in] p_transaction Transaction.
+ * @param[in] prio          Priority.
+ *
+ * @retval NRF_SUCCESS             If the transaction was queued, or started.
+ * @retval NRF_ERROR_NULL          If a NULL pointer was passed.
+ * @retval NRF_ERROR_INVALID_PARAM If the priority or the client was invalid.
+ */
+ret_code_t nrf_bus_mgr_schedule(nrf_bus_mgr_t             * p_mgr,
+                                nrf_bus_mgr_transaction_t * p_transaction,
+                                nrf_bus_mgr_prio_t          prio);
+
+/**@brief Function for releasing the peripheral, for example before sleeping. The driver is
+ *        initialized again by the next transaction.
+ *
+ * @param[in] p_mgr Bus manager instance.
+ *
+ * @retval NRF_SUCCESS    If the driver was uninitialized.
+ * @retval NRF_ERROR_BUSY If a transaction is in progress.
+ */
+ret_code_t nrf_bus_mgr_release(nrf_bus_mgr_t * p_mgr);
+
+/**@brief Function for checking if a bus manager has no transactions.
+ *
+ * @param[in] p_mgr Bus manager instance.
+ */
+__STATIC_INLINE bool nrf_bus_mgr_is_idle(nrf_bus_mgr_t const * p_mgr)
+{
+    return (p_mgr->p_current == NULL);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_BUS_MGR_H__
+
+/** @} */
@@ -0,0 +1,22 @@
+/**
+ *
+ * @defgroup nrf_bus_mgr_config nrf_bus_mgr module configuration
+ * @{
+ * @ingroup nrf_bus_mgr
+ */
+/** @brief Enabling nrf_bus_mgr module
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_BUS_MGR_ENABLED
+
+/** @brief Highest number of transactions of the current client in a row, while transactions of other clients wait at the same priority.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_BUS_MGR_CONFIG_BATCH_MAX
+
+
+/** @} */
@@ -149,6 +149,18 @@ uint32_t app_button_init(app_button_cfg_t const *       p_buttons,
                             detection_delay_timeout_handler);
 }
 
+uint32_t app_button_detection_delay_set(uint32_t detection_delay)
+{
+    if (detection_delay < APP_TIMER_MIN_TIMEOUT_TICKS)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    // A detection in progress keeps the delay it was started with.
+    m_detection_delay = detection_delay;
+    return NRF_SUCCESS;
+}
+
 uint32_t app_button_enable(void)
 {
     ASSERT(mp_buttons);
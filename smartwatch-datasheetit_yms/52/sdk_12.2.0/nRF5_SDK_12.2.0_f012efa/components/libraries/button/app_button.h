@@ -89,6 +89,15 @@ uint32_t app_button_init(app_button_cfg_t const *       p_buttons,
                          uint8_t                        button_count,
                          uint32_t                       detection_delay);
 
+/**@brief Function for changing the detection delay, without initializing the buttons again.
+ *
+ * @param[in]  detection_delay     Delay from a GPIOTE event until a button is reported as pushed.
+ *
+ * @retval NRF_SUCCESS             If the delay was changed.
+ * @retval NRF_ERROR_INVALID_PARAM If the delay was shorter than APP_TIMER_MIN_TIMEOUT_TICKS.
+ */
+uint32_t app_button_detection_delay_set(uint32_t detection_delay);
+
 /**@brief Function for enabling button detection.
  *
  * @retval NRF_SUCCESS Module successfully enabled.
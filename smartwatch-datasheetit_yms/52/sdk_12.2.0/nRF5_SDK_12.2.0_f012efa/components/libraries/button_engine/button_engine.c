@@ -0,0 +1,329 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(BUTTON_ENGINE)
+#include "button_engine.h"
+#include <string.h>
+#include "nrf_drv_gpiote.h"
+#include "app_util_platform.h"
+
+#define SAMPLE_CC_CHANNEL 0      /**< RTC compare channel that times the samples. */
+#define MIN_SAMPLE_TICKS  2      /**< Minimum distance of a compare value from the counter. */
+#define TIMER_MAX         UINT16_MAX
+
+/**@brief State of a button. */
+typedef struct
+{
+    bool     pushed;      /**< Debounced state. */
+    bool     long_press;  /**< A long press has been reported for the current push. */
+    bool     click;       /**< A click is waiting for the double click time to pass. */
+    uint8_t  count;       /**< Consecutive samples that differ from the debounced state. */
+    uint16_t timer;       /**< Samples since the last change of state or the last event. */
+} button_state_t;
+
+/**@brief Control block. */
+typedef struct
+{
+    button_engine_config_t const * p_config;
+    uint32_t                       sample_ticks;       /**< Time between samples, in RTC ticks. */
+    uint16_t                       long_press_samples; /**< Long press time, in samples. */
+    uint16_t                       repeat_samples;     /**< Repeat interval, in samples. */
+    uint16_t                       double_click_samples; /**< Double click time, in samples. */
+    bool volatile                  sampling;           /**< The compare channel is armed. */
+    button_state_t                 state[BUTTON_ENGINE_CONFIG_MAX_BUTTONS];
+} button_engine_cb_t;
+
+static button_engine_cb_t m_cb;
+
+
+static uint16_t ms_to_samples(uint16_t ms)
+{
+    return (uint16_t)CEIL_DIV(ms, m_cb.p_config->sample_interval_ms);
+}
+
+
+static void sample_schedule(void)
+{
+    nrf_drv_rtc_t const * p_rtc = m_cb.p_config->p_rtc;
+
+    UNUSED_RETURN_VALUE(nrf_drv_rtc_cc_set(p_rtc,
+                                           SAMPLE_CC_CHANNEL,
+                                           nrf_drv_rtc_counter_get(p_rtc) + m_cb.sample_ticks,
+                                           true));
+}
+
+
+static void evt_send(uint8_t button_id, button_engine_evt_type_t evt_type)
+{
+    m_cb.p_config->evt_handler(m_cb.p_config->p_buttons[button_id].pin_no, evt_type);
+}
+
+
+/**@brief Function for handling the debounced state change of a button.
+ */
+static void button_change(uint8_t button_id, button_state_t * p_state)
+{
+    p_state->timer = 0;
+
+    if (p_state->pushed)
+    {
+        p_state->long_press = false;
+        evt_send(button_id, BUTTON_ENGINE_EVT_PUSH);
+        return;
+    }
+
+    evt_send(button_id, BUTTON_ENGINE_EVT_RELEASE);
+    if (p_state->long_press)
+    {
+        return;
+    }
+
+    if (m_cb.double_click_samples == 0)
+    {
+        evt_send(button_id, BUTTON_ENGINE_EVT_CLICK);
+    }
+    else if (p_state->click)
+    {
+        p_state->click = false;
+        evt_send(button_id, BUTTON_ENGINE_EVT_DOUBLE_CLICK);
+    }
+    else
+    {
+        p_state->click = true;
+    }
+}
+
+
+/**@brief Function for handling the timing of a button that did not change state.
+ */
+static void button_hold(uint8_t button_id, button_state_t * p_state)
+{
+    if (p_state->timer < TIMER_MAX)
+    {
+        p_state->timer++;
+    }
+
+    if (p_state->pushed)
+    {
+        if (!p_state->long_press)
+        {
+            if ((m_cb.long_press_samples != 0) && (p_state->timer >= m_cb.long_press_samples))
+            {
+                // The push that follows a click is not a double click, so the click is reported.
+                if (p_state->click)
+                {
+                    p_state->click = false;
+                    evt_send(button_id, BUTTON_ENGINE_EVT_CLICK);
+                }
+                p_state->long_press = true;
+                p_state->timer      = 0;
+                evt_send(button_id, BUTTON_ENGINE_EVT_LONG_PRESS);
+            }
+        }
+        else if ((m_cb.repeat_samples != 0) && (p_state->timer >= m_cb.repeat_samples))
+        {
+            p_state->timer = 0;
+            evt_send(button_id, BUTTON_ENGINE_EVT_REPEAT);
+        }
+    }
+    else if (p_state->click && (p_state->timer >= m_cb.double_click_samples))
+    {
+        p_state->click = false;
+        evt_send(button_id, BUTTON_ENGINE_EVT_CLICK);
+    }
+}
+
+
+/**@brief Function for checking if a button needs more samples.
+ */
+static bool button_is_busy(button_state_t const * p_state)
+{
+    if ((p_state->count != 0) || p_state->click)
+    {
+        return true;
+    }
+    if (p_state->pushed)
+    {
+        return p_state->long_press ? (m_cb.repeat_samples != 0) : (m_cb.long_press_samples != 0);
+    }
+    return false;
+}
+
+
+static bool button_sample(uint8_t button_id)
+{
+    button_engine_button_t const * p_btn   = &m_cb.p_config->p_buttons[button_id];
+    button_state_t               * p_state = &m_cb.state[button_id];
+    bool                           pushed;
+
+    pushed = !(nrf_gpio_pin_read(p_btn->pin_no) ^ (p_btn->active_state == BUTTON_ENGINE_ACTIVE_HIGH));
+
+    if (pushed != p_state->pushed)
+    {
+        if (++p_state->count >= m_cb.p_config->debounce_samples)
+        {
+            p_state->count  = 0;
+            p_state->pushed = pushed;
+            button_change(button_id, p_state);
+        }
+        else if (p_state->timer < TIMER_MAX)
+        {
+            p_state->timer++;
+        }
+    }
+    else
+    {
+        p_state->count = 0;
+        button_hold(button_id, p_state);
+    }
+
+    return button_is_busy(p_state);
+}
+
+
+static void rtc_handler(nrf_drv_rtc_int_type_t int_type)
+{
+    bool busy = false;
+
+    if (int_type != (nrf_drv_rtc_int_type_t)SAMPLE_CC_CHANNEL)
+    {
+        return;
+    }
+
+    // An edge after a pin has been read below schedules the next sample itself.
+    m_cb.sampling = false;
+
+    for (uint8_t i = 0; i < m_cb.p_config->button_count; i++)
+    {
+        busy |= button_sample(i);
+    }
+
+    CRITICAL_REGION_ENTER();
+    if (busy && !m_cb.sampling)
+    {
+        m_cb.sampling = true;
+        sample_schedule();
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+
+static void gpiote_event_handler(nrf_drv_gpiote_pin_t pin, nrf_gpiote_polarity_t action)
+{
+    UNUSED_PARAMETER(pin);
+    UNUSED_PARAMETER(action);
+
+    CRITICAL_REGION_ENTER();
+    if (!m_cb.sampling)
+    {
+        m_cb.sampling = true;
+        sample_schedule();
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+
+ret_code_t button_engine_init(button_engine_config_t const * p_config,
+                              nrf_drv_rtc_config_t const   * p_rtc_config)
+{
+    ret_code_t err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_config);
+    VERIFY_PARAM_NOT_NULL(p_rtc_config);
+    VERIFY_PARAM_NOT_NULL(p_config->p_buttons);
+    VERIFY_PARAM_NOT_NULL(p_config->p_rtc);
+    VERIFY_PARAM_NOT_NULL(p_config->evt_handler);
+
+    if ((p_config->button_count == 0) ||
+        (p_config->button_count > BUTTON_ENGINE_CONFIG_MAX_BUTTONS) ||
+        (p_config->sample_interval_ms == 0) ||
+        (p_config->debounce_samples == 0))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    memset(&m_cb, 0, sizeof(m_cb));
+    m_cb.p_config     = p_config;
+    m_cb.sample_ticks = ROUNDED_DIV((uint32_t)p_config->sample_interval_ms * RTC_INPUT_FREQ,
+                                    1000 * ((uint32_t)p_rtc_config->prescaler + 1));
+    if (m_cb.sample_ticks < MIN_SAMPLE_TICKS)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    m_cb.long_press_samples   = ms_to_samples(p_config->long_press_ms);
+    m_cb.repeat_samples       = ms_to_samples(p_config->repeat_ms);
+    m_cb.double_click_samples = ms_to_samples(p_config->double_click_ms);
+
+    if (!nrf_drv_gpiote_is_init())
+    {
+        err_code = nrf_drv_gpiote_init();
+        VERIFY_SUCCESS(err_code);
+    }
+
+    for (uint8_t i = 0; i < p_config->button_count; i++)
+    {
+        button_engine_button_t const * p_btn  = &p_config->p_buttons[i];
+        nrf_drv_gpiote_in_config_t     config = GPIOTE_CONFIG_IN_SENSE_TOGGLE(false);
+
+        config.pull = p_btn->pull_cfg;
+        err_code = nrf_drv_gpiote_in_init(p_btn->pin_no, &config, gpiote_event_handler);
+        VERIFY_SUCCESS(err_code);
+    }
+
+    err_code = nrf_drv_rtc_init(p_config->p_rtc, p_rtc_config, rtc_handler);
+    VERIFY_SUCCESS(err_code);
+    nrf_drv_rtc_enable(p_config->p_rtc);
+
+    return NRF_SUCCESS;
+}
+
+
+void button_engine_enable(void)
+{
+    ASSERT(m_cb.p_config);
+
+    for (uint8_t i = 0; i < m_cb.p_config->button_count; i++)
+    {
+        nrf_drv_gpiote_in_event_enable(m_cb.p_config->p_buttons[i].pin_no, true);
+    }
+
+    // Buttons that are already pushed are detected by the first sample.
+    gpiote_event_handler(0, NRF_GPIOTE_POLARITY_TOGGLE);
+}
+
+
+void button_engine_disable(void)
+{
+    ASSERT(m_cb.p_config);
+
+    for (uint8_t i = 0; i < m_cb.p_config->button_count; i++)
+    {
+        nrf_drv_gpiote_in_event_disable(m_cb.p_config->p_buttons[i].pin_no);
+    }
+
+    CRITICAL_REGION_ENTER();
+    UNUSED_RETURN_VALUE(nrf_drv_rtc_cc_disable(m_cb.p_config->p_rtc, SAMPLE_CC_CHANNEL));
+    m_cb.sampling = false;
+    memset(m_cb.state, 0, sizeof(m_cb.state));
+    CRITICAL_REGION_EXIT();
+}
+
+
+bool button_engine_is_pushed(uint8_t button_id)
+{
+    ASSERT(m_cb.p_config);
+    ASSERT(button_id < m_cb.p_config->button_count);
+
+    return m_cb.state[button_id].pushed;
+}
+
+#endif // NRF_MODULE_ENABLED(BUTTON_ENGINE)
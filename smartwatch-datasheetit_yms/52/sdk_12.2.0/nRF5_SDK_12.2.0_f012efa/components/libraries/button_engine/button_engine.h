@@ -0,0 +1,138 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup button_engine Button engine
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for debouncing buttons and detecting long presses, repeats and double clicks.
+ *
+ * @details An edge on any button pin, detected with a low-power PORT event of the GPIOTE driver,
+ *          starts the sampling of all buttons on a compare channel of an RTC instance. A button
+ *          changes state when a configured number of consecutive samples agree. Sampling
+ *          continues while any button is bouncing, while a long press, a repeat or a double
+ *          click can still be reported, and stops when all buttons are idle.
+ *
+ *          Unlike @ref app_button, the module does no app_timer operations, so a noisy contact
+ *          cannot fill the app_timer operation queue, and a burst of edges costs no more than
+ *          one edge.
+ *
+ * @note The RTC instance is used only by this module. Events are reported from its interrupt.
+ */
+
+#ifndef BUTTON_ENGINE_H__
+#define BUTTON_ENGINE_H__
+
+#include <stdint.h>
+#include "nrf_gpio.h"
+#include "nrf_drv_rtc.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Maximum number of buttons.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef BUTTON_ENGINE_CONFIG_MAX_BUTTONS
+#define BUTTON_ENGINE_CONFIG_MAX_BUTTONS 8
+#endif
+
+#define BUTTON_ENGINE_ACTIVE_HIGH 1 /**< Indicates that a button is active high. */
+#define BUTTON_ENGINE_ACTIVE_LOW  0 /**< Indicates that a button is active low. */
+
+/**@brief Event types. */
+typedef enum
+{
+    BUTTON_ENGINE_EVT_PUSH,         /**< The button was pushed. */
+    BUTTON_ENGINE_EVT_RELEASE,      /**< The button was released. */
+    BUTTON_ENGINE_EVT_CLICK,        /**< The button was pushed and released once, before a long press. */
+    BUTTON_ENGINE_EVT_DOUBLE_CLICK, /**< The button was clicked twice within the double click time. */
+    BUTTON_ENGINE_EVT_LONG_PRESS,   /**< The button has been held for the long press time. */
+    BUTTON_ENGINE_EVT_REPEAT,       /**< The button is still held after a long press, reported every repeat interval. */
+} button_engine_evt_type_t;
+
+/**@brief Event handler.
+ *
+ * @param[in] pin_no   Pin of the button.
+ * @param[in] evt_type Type of the event.
+ */
+typedef void (* button_engine_evt_handler_t)(uint8_t pin_no, button_engine_evt_type_t evt_type);
+
+/**@brief Button configuration. */
+typedef struct
+{
+    uint8_t             pin_no;       /**< Pin to be used as a button. */
+    uint8_t             active_state; /**< @ref BUTTON_ENGINE_ACTIVE_HIGH or @ref BUTTON_ENGINE_ACTIVE_LOW. */
+    nrf_gpio_pin_pull_t pull_cfg;     /**< Pull-up or -down configuration. */
+} button_engine_button_t;
+
+/**@brief Module configuration. */
+typedef struct
+{
+    button_engine_button_t const * p_buttons;          /**< Buttons. Must stay valid while the module is initialized. */
+    uint8_t                        button_count;       /**< Number of buttons, up to @ref BUTTON_ENGINE_CONFIG_MAX_BUTTONS. */
+    nrf_drv_rtc_t const          * p_rtc;              /**< RTC instance that times the samples. Compare channel 0 is used. */
+    uint8_t                        sample_interval_ms; /**< Time between samples, in milliseconds. */
+    uint8_t                        debounce_samples;   /**< Number of consecutive equal samples after which a button changes state. */
+    uint16_t                       long_press_ms;      /**< Time after which a held button is reported as long pressed. 0 to disable. */
+    uint16_t                       repeat_ms;          /**< Repeat interval after a long press. 0 to disable. */
+    uint16_t                       double_click_ms;    /**< Maximum time between the clicks of a double click. 0 to report clicks on release. */
+    button_engine_evt_handler_t    evt_handler;        /**< Event handler. */
+} button_engine_config_t;
+
+/**@brief Function for initializing the module.
+ *
+ * @details The button pins are configured, and the GPIOTE driver is initialized if needed.
+ *          Detection is enabled with @ref button_engine_enable.
+ *
+ * @param[in] p_config     Module configuration. Must stay valid while the module is initialized.
+ * @param[in] p_rtc_config RTC driver configuration.
+ *
+ * @retval NRF_SUCCESS             If the module was initialized.
+ * @retval NRF_ERROR_NULL          If a required pointer was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If the configuration was invalid.
+ * @return Any error returned by the GPIOTE or the RTC driver.
+ */
+ret_code_t button_engine_init(button_engine_config_t const * p_config,
+                              nrf_drv_rtc_config_t const   * p_rtc_config);
+
+/**@brief Function for enabling button detection.
+ */
+void button_engine_enable(void);
+
+/**@brief Function for disabling button detection.
+ *
+ * @details Sampling is stopped, and all buttons are considered released. No events are reported
+ *          for buttons that were pushed.
+ */
+void button_engine_disable(void);
+
+/**@brief Function for checking if a button is pushed, after debouncing.
+ *
+ * @param[in] button_id Index of the button in the configuration.
+ *
+ * @return Debounced button state.
+ */
+bool button_engine_is_pushed(uint8_t button_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BUTTON_ENGINE_H__
+
+/** @} */
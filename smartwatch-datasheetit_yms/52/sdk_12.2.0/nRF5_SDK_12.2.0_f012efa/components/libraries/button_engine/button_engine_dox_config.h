@@ -0,0 +1,22 @@
+/**
+ *
+ * @defgroup button_engine_config button_engine module configuration
+ * @{
+ * @ingroup button_engine
+ */
+/** @brief Enabling button_engine module
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BUTTON_ENGINE_ENABLED
+
+/** @brief Maximum number of buttons.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define BUTTON_ENGINE_CONFIG_MAX_BUTTONS
+
+
+/** @} */
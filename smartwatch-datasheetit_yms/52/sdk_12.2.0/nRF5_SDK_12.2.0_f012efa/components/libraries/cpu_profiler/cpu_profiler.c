@@ -0,0 +1,228 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(CPU_PROFILER)
+#include "cpu_profiler.h"
+#include <string.h>
+#include "nrf.h"
+#include "app_timer.h"
+#include "app_util_platform.h"
+
+#define NRF_LOG_MODULE_NAME "CPU_PROFILER"
+#include "nrf_log.h"
+
+#if (__CORTEX_M < 4)
+#error "The CPU profiler requires the DWT cycle counter of a Cortex-M4 CPU."
+#endif
+
+/**@brief Names of the handlers, for logging. */
+static char const * const m_isr_names[CPU_PROFILER_ISR_COUNT] =
+{
+    [CPU_PROFILER_ISR_RTC1]           = "RTC1",
+    [CPU_PROFILER_ISR_SWI]            = "SWI",
+    [CPU_PROFILER_ISR_GPIOTE]         = "GPIOTE",
+    [CPU_PROFILER_ISR_SAADC]          = "SAADC",
+    [CPU_PROFILER_ISR_UART0]          = "UART0",
+    [CPU_PROFILER_ISR_UART1]          = "UART1",
+    [CPU_PROFILER_ISR_TWI0]           = "TWI0",
+    [CPU_PROFILER_ISR_TWI1]           = "TWI1",
+    [CPU_PROFILER_ISR_SPI0]           = "SPI0",
+    [CPU_PROFILER_ISR_SPI1]           = "SPI1",
+    [CPU_PROFILER_ISR_SPI2]           = "SPI2",
+    [CPU_PROFILER_ISR_SOFTDEVICE_EVT] = "SD_EVT",
+    [CPU_PROFILER_ISR_CRITICAL_REGION] = "CRITICAL",
+};
+
+static cpu_profiler_isr_stats_t m_isr_stats[CPU_PROFILER_ISR_COUNT];
+static uint32_t                 m_ticks_per_1s;     /**< Frequency of the app_timer RTC. */
+static uint32_t                 m_last_ticks;       /**< RTC counter at the previous load measurement. */
+static uint32_t                 m_last_cycles;      /**< Cycle counter at the previous load measurement. */
+static uint32_t volatile        m_sleep_cycles;     /**< Cycles counted while sleeping since the previous load measurement. */
+#if CPU_PROFILER_CONFIG_CRITICAL_REGION_ENABLED
+static uint32_t                 m_critical_start;   /**< Cycle counter at the entry of the current outermost critical region. */
+static uint32_t volatile        m_critical_cycles;  /**< Cycles spent in critical regions since the previous load measurement. */
+static uint16_t                 m_critical_load;    /**< Share of the previous measurement period spent in critical regions, in permille. */
+#endif
+
+
+void cpu_profiler_isr_record(cpu_profiler_isr_t isr, uint32_t start)
+{
+    uint32_t                   cycles  = DWT->CYCCNT - start;
+    cpu_profiler_isr_stats_t * p_stats = &m_isr_stats[isr];
+    uint32_t                   bucket  = 0;
+
+    // A handler cannot preempt itself, and the readers lock interrupts, so no locking is needed.
+    p_stats->count++;
+    p_stats->total_cycles += cycles;
+    if (cycles > p_stats->max_cycles)
+    {
+        p_stats->max_cycles = cycles;
+    }
+
+    if ((cycles >> CPU_PROFILER_CONFIG_HISTOGRAM_MIN_SHIFT) != 0)
+    {
+        bucket = (31 - __CLZ(cycles)) - CPU_PROFILER_CONFIG_HISTOGRAM_MIN_SHIFT + 1;
+        if (bucket >= CPU_PROFILER_CONFIG_HISTOGRAM_BUCKETS)
+        {
+            bucket = CPU_PROFILER_CONFIG_HISTOGRAM_BUCKETS - 1;
+        }
+    }
+    p_stats->histogram[bucket]++;
+}
+
+
+void cpu_profiler_sleep_record(uint32_t start)
+{
+    m_sleep_cycles += DWT->CYCCNT - start;
+}
+
+
+#if CPU_PROFILER_CONFIG_CRITICAL_REGION_ENABLED
+void cpu_profiler_critical_region_enter(void)
+{
+    // Interrupts that could enter a region are masked until the exit, so one start is enough.
+    m_critical_start = DWT->CYCCNT;
+}
+
+
+void cpu_profiler_critical_region_exit(void)
+{
+    m_critical_cycles += DWT->CYCCNT - m_critical_start;
+    cpu_profiler_isr_record(CPU_PROFILER_ISR_CRITICAL_REGION, m_critical_start);
+}
+#endif // CPU_PROFILER_CONFIG_CRITICAL_REGION_ENABLED
+
+
+ret_code_t cpu_profiler_init(uint32_t ticks_per_1s)
+{
+    if (ticks_per_1s == 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+
+    m_ticks_per_1s = ticks_per_1s;
+    m_sleep_cycles = 0;
+    m_last_cycles  = DWT->CYCCNT;
+    m_last_ticks   = app_timer_cnt_get();
+    cpu_profiler_isr_stats_clear();
+
+    return NRF_SUCCESS;
+}
+
+
+uint16_t cpu_profiler_load_get(void)
+{
+    uint32_t ticks;
+    uint32_t cycles;
+    uint32_t sleep_cycles;
+    uint32_t elapsed_ticks;
+    uint32_t busy_cycles;
+    uint64_t elapsed_cycles;
+#if CPU_PROFILER_CONFIG_CRITICAL_REGION_ENABLED
+    uint32_t critical_cycles;
+#endif
+
+    CRITICAL_REGION_ENTER();
+    ticks          = app_timer_cnt_get();
+    cycles         = DWT->CYCCNT;
+    sleep_cycles   = m_sleep_cycles;
+    m_sleep_cycles = 0;
+#if CPU_PROFILER_CONFIG_CRITICAL_REGION_ENABLED
+    critical_cycles   = m_critical_cycles;
+    m_critical_cycles = 0;
+#endif
+    CRITICAL_REGION_EXIT();
+
+    UNUSED_VARIABLE(app_timer_cnt_diff_compute(ticks, m_last_ticks, &elapsed_ticks));
+    busy_cycles    = (cycles - m_last_cycles) - sleep_cycles;
+    elapsed_cycles = ((uint64_t)elapsed_ticks * SystemCoreClock) / m_ticks_per_1s;
+
+    m_last_ticks  = ticks;
+    m_last_cycles = cycles;
+
+    if (elapsed_cycles == 0)
+    {
+        return 0;
+    }
+#if CPU_PROFILER_CONFIG_CRITICAL_REGION_ENABLED
+    m_critical_load = (critical_cycles >= elapsed_cycles) ? 1000 :
+                      (uint16_t)(((uint64_t)critical_cycles * 1000) / elapsed_cycles);
+#endif
+    if (busy_cycles >= elapsed_cycles)
+    {
+        return 1000;
+    }
+    return (uint16_t)(((uint64_t)busy_cycles * 1000) / elapsed_cycles);
+}
+
+
+#if CPU_PROFILER_CONFIG_CRITICAL_REGION_ENABLED
+uint16_t cpu_profiler_critical_region_load_get(void)
+{
+    return m_critical_load;
+}
+#endif
+
+
+ret_code_t cpu_profiler_isr_stats_get(cpu_profiler_isr_t isr, cpu_profiler_isr_stats_t * p_stats)
+{
+    VERIFY_PARAM_NOT_NULL(p_stats);
+    if (isr >= CPU_PROFILER_ISR_COUNT)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    CRITICAL_REGION_ENTER();
+    *p_stats = m_isr_stats[isr];
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+
+
+void cpu_profiler_isr_stats_clear(void)
+{
+    CRITICAL_REGION_ENTER();
+    memset(m_isr_stats, 0, sizeof(m_isr_stats));
+    CRITICAL_REGION_EXIT();
+}
+
+
+void cpu_profiler_log(void)
+{
+    cpu_profiler_isr_stats_t stats;
+    uint32_t                 i;
+
+    for (i = 0; i < CPU_PROFILER_ISR_COUNT; i++)
+    {
+        UNUSED_RETURN_VALUE(cpu_profiler_isr_stats_get((cpu_profiler_isr_t)i, &stats));
+        if (stats.count == 0)
+        {
+            continue;
+        }
+
+        NRF_LOG_INFO("%s: count %u, avg %u, max %u cycles\r\n",
+                     (uint32_t)m_isr_names[i],
+                     stats.count,
+                     (uint32_t)(stats.total_cycles / stats.count),
+                     stats.max_cycles);
+    }
+
+#if CPU_PROFILER_CONFIG_CRITICAL_REGION_ENABLED
+    NRF_LOG_INFO("Critical regions: %u permille\r\n", m_critical_load);
+#endif
+}
+
+#endif // NRF_MODULE_ENABLED(CPU_PROFILER)
@@ -0,0 +1,130 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup cpu_profiler CPU load and interrupt profiler
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for measuring the CPU load and the time spent in interrupt handlers.
+ *
+ * @details The module uses the cycle counter of the Data Watchpoint and Trace unit (DWT). The
+ *          counter only runs while the CPU is clocked, so the number of cycles counted in a
+ *          period of time, less the cycles counted inside @ref nrf_pwr_mgmt_run, is the time the
+ *          CPU was busy. The length of the period is taken from the RTC of @ref app_timer.
+ *
+ *          The handlers of @ref app_timer, GPIOTE, SAADC, UART, TWI, SPI master and the
+ *          SoftDevice events contain hooks (see @ref cpu_profiler_hooks.h). When the module is
+ *          enabled, they record how often every handler runs, the total and the maximum number of
+ *          cycles spent in it, and a histogram of its durations. The durations include the time
+ *          spent in interrupts of higher priority.
+ *
+ *          With @ref CPU_PROFILER_CONFIG_CRITICAL_REGION_ENABLED, the outermost critical regions
+ *          are recorded as @ref CPU_PROFILER_ISR_CRITICAL_REGION, and the share of time spent in
+ *          them is measured with the CPU load. This compares the implementations in
+ *          @ref APP_UTIL_CRITICAL_REGION_TYPES.
+ *
+ * @note The cycle counter wraps after 2^32 cycles, about 67 seconds at 64 MHz, so
+ *       @ref cpu_profiler_load_get must be called more often than that.
+ * @note Requires a Cortex-M4 CPU.
+ */
+
+#ifndef CPU_PROFILER_H__
+#define CPU_PROFILER_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+#include "cpu_profiler_hooks.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of buckets in the histogram of every handler.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef CPU_PROFILER_CONFIG_HISTOGRAM_BUCKETS
+#define CPU_PROFILER_CONFIG_HISTOGRAM_BUCKETS   8
+#endif
+
+/** @brief Log2 of the upper bound of the first histogram bucket, in cycles.
+ *
+ * Bucket 0 counts runs shorter than 2^shift cycles, and every next bucket doubles the bound. The
+ * last bucket counts all longer runs. The default of 6 is 1 us at 64 MHz.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef CPU_PROFILER_CONFIG_HISTOGRAM_MIN_SHIFT
+#define CPU_PROFILER_CONFIG_HISTOGRAM_MIN_SHIFT 6
+#endif
+
+/**@brief Statistics of a handler. */
+typedef struct
+{
+    uint32_t count;                                         /**< Number of runs. */
+    uint32_t max_cycles;                                    /**< Longest run. */
+    uint64_t total_cycles;                                  /**< Sum of all runs. */
+    uint32_t histogram[CPU_PROFILER_CONFIG_HISTOGRAM_BUCKETS]; /**< Number of runs in each duration bucket. */
+} cpu_profiler_isr_stats_t;
+
+/**@brief Function for initializing the module and starting the cycle counter.
+ *
+ * @param[in] ticks_per_1s  Number of @ref app_timer ticks for 1 s.
+ *
+ * @retval NRF_SUCCESS             If the module was initialized.
+ * @retval NRF_ERROR_INVALID_PARAM If @p ticks_per_1s was 0.
+ */
+ret_code_t cpu_profiler_init(uint32_t ticks_per_1s);
+
+/**@brief Function for getting the CPU load since the previous call, or since initialization.
+ *
+ * @return CPU load in permille.
+ */
+uint16_t cpu_profiler_load_get(void);
+
+#if CPU_PROFILER_CONFIG_CRITICAL_REGION_ENABLED
+/**@brief Function for getting the share of time spent in critical regions.
+ *
+ * @return Time spent in critical regions in the period measured by the last call to
+ *         @ref cpu_profiler_load_get, in permille.
+ */
+uint16_t cpu_profiler_critical_region_load_get(void);
+#endif
+
+/**@brief Function for getting the statistics of a handler.
+ *
+ * @param[in]  isr      Handler.
+ * @param[out] p_stats  Statistics of the handler.
+ *
+ * @retval NRF_SUCCESS             If the statistics were copied.
+ * @retval NRF_ERROR_NULL          If @p p_stats was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If @p isr was not valid.
+ */
+ret_code_t cpu_profiler_isr_stats_get(cpu_profiler_isr_t isr, cpu_profiler_isr_stats_t * p_stats);
+
+/**@brief Function for clearing the statistics of all handlers.
+ */
+void cpu_profiler_isr_stats_clear(void);
+
+/**@brief Function for logging the statistics of all handlers that have run, through @ref nrf_log.
+ */
+void cpu_profiler_log(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CPU_PROFILER_H__
+
+/** @} */
@@ -0,0 +1,41 @@
+/**
+ *
+ * @defgroup cpu_profiler_config cpu_profiler module configuration
+ * @{
+ * @ingroup cpu_profiler
+ */
+/** @brief Enabling cpu_profiler module
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define CPU_PROFILER_ENABLED
+
+
+/** @brief Number of buckets in the histogram of every handler.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define CPU_PROFILER_CONFIG_HISTOGRAM_BUCKETS
+
+
+/** @brief Log2 of the upper bound of the first histogram bucket, in cycles.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define CPU_PROFILER_CONFIG_HISTOGRAM_MIN_SHIFT
+
+
+/** @brief Measure the time spent in critical regions.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define CPU_PROFILER_CONFIG_CRITICAL_REGION_ENABLED
+
+
+/** @} */
@@ -0,0 +1,214 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(CRASH_SNAPSHOT)
+#include "crash_snapshot.h"
+#include "nrf.h"
+#include "app_error.h"
+#include "crc32.h"
+#include "fds.h"
+#if NRF_MODULE_ENABLED(APP_SCHEDULER)
+#include "app_scheduler.h"
+#endif
+#if NRF_MODULE_ENABLED(NRF_LOG) && NRF_MODULE_ENABLED(NRF_LOG_CRASHLOG)
+#include "nrf_log_crashlog.h"
+#endif
+#include <stddef.h>
+#include <string.h>
+
+#define CRASH_SNAPSHOT_MAGIC    0x50414E53                  // "SNAP", snapshot is valid.
+#define RAM_START               0x20000000UL
+#define STACK_FRAME_WORDS       8                           // Registers stacked on exception entry.
+#define SNAPSHOT_WORDS          (sizeof(crash_snapshot_t) / sizeof(uint32_t))
+#define CRC_SIZE                offsetof(crash_snapshot_t, crc)
+
+#if defined(__CC_ARM)
+#define CRASH_SNAPSHOT_NOINIT   __attribute__((section(".bss.noinit"), zero_init))
+#elif defined(__ICCARM__)
+#define CRASH_SNAPSHOT_NOINIT   __no_init
+#else
+#define CRASH_SNAPSHOT_NOINIT   __attribute__((section(".noinit")))
+#endif
+
+STATIC_ASSERT((sizeof(crash_snapshot_t) % sizeof(uint32_t)) == 0);
+
+static CRASH_SNAPSHOT_NOINIT crash_snapshot_t m_snapshot;
+
+
+static uint32_t ram_end_get(void)
+{
+#ifdef NRF51
+    return RAM_START + NRF_FICR->NUMRAMBLOCK * NRF_FICR->SIZERAMBLOCKS;
+#else
+    return RAM_START + NRF_FICR->INFO.RAM * 1024;
+#endif
+}
+
+
+/**@brief Function for filling the parts of the snapshot common to all causes, and sealing it.
+ *
+ * @param[in] sp Stack address the excerpt starts from.
+ */
+static void snapshot_finish(uint32_t sp)
+{
+    uint32_t ram_end = ram_end_get();
+
+    m_snapshot.version = CRASH_SNAPSHOT_VERSION;
+    m_snapshot.size    = SNAPSHOT_WORDS;
+    m_snapshot.sp      = sp;
+
+#if __CORTEX_M == 0x04
+    m_snapshot.cfsr  = SCB->CFSR;
+    m_snapshot.hfsr  = SCB->HFSR;
+    m_snapshot.mmfar = SCB->MMFAR;
+    m_snapshot.bfar  = SCB->BFAR;
+#endif
+
+    // The stack pointer may have been corrupted, so it is only followed within RAM.
+    m_snapshot.stack_count = 0;
+    if (((sp & 0x03) == 0) && (sp >= RAM_START) && (sp < ram_end))
+    {
+        m_snapshot.stack_count = MIN(CRASH_SNAPSHOT_CONFIG_STACK_WORDS, (ram_end - sp) / sizeof(uint32_t));
+        memcpy(m_snapshot.stack, (uint32_t const *)sp, m_snapshot.stack_count * sizeof(uint32_t));
+    }
+
+#if NRF_MODULE_ENABLED(APP_SCHEDULER) && APP_SCHEDULER_HISTORY_SIZE
+    m_snapshot.sched_count = app_sched_history_get(m_snapshot.sched_handlers,
+                                                   CRASH_SNAPSHOT_CONFIG_SCHED_EVENTS);
+#else
+    m_snapshot.sched_count = 0;
+#endif
+
+#if NRF_MODULE_ENABLED(NRF_LOG) && NRF_MODULE_ENABLED(NRF_LOG_CRASHLOG)
+    m_snapshot.log_count = nrf_log_crashlog_tail_get(m_snapshot.log, CRASH_SNAPSHOT_CONFIG_LOG_WORDS);
+#else
+    m_snapshot.log_count = 0;
+#endif
+
+    m_snapshot.crc   = crc32_compute((uint8_t const *)&m_snapshot, CRC_SIZE, NULL);
+    m_snapshot.magic = CRASH_SNAPSHOT_MAGIC;
+}
+
+
+void crash_snapshot_fault_capture(uint32_t const * p_stack_address)
+{
+    uint32_t sp = (uint32_t)p_stack_address;
+
+    memset(&m_snapshot, 0, sizeof(m_snapshot));
+    m_snapshot.type = CRASH_SNAPSHOT_TYPE_HARDFAULT;
+
+    if (((sp & 0x03) == 0) && (sp >= RAM_START) &&
+        (sp + STACK_FRAME_WORDS * sizeof(uint32_t) <= ram_end_get()))
+    {
+        m_snapshot.r0  = p_stack_address[0];
+        m_snapshot.r1  = p_stack_address[1];
+        m_snapshot.r2  = p_stack_address[2];
+        m_snapshot.r3  = p_stack_address[3];
+        m_snapshot.r12 = p_stack_address[4];
+        m_snapshot.lr  = p_stack_address[5];
+        m_snapshot.pc  = p_stack_address[6];
+        m_snapshot.psr = p_stack_address[7];
+        sp            += STACK_FRAME_WORDS * sizeof(uint32_t);
+    }
+
+    snapshot_finish(sp);
+}
+
+
+void crash_snapshot_error_capture(uint32_t id, uint32_t pc, uint32_t info)
+{
+    memset(&m_snapshot, 0, sizeof(m_snapshot));
+    m_snapshot.type = CRASH_SNAPSHOT_TYPE_ERROR;
+    m_snapshot.id   = id;
+    m_snapshot.pc   = pc;
+    m_snapshot.info = info;
+
+    if ((id == NRF_FAULT_ID_SDK_ERROR) && (info != 0))
+    {
+        error_info_t const * p_info = (error_info_t const *)info;
+
+        m_snapshot.err_code    = p_info->err_code;
+        m_snapshot.line_num    = p_info->line_num;
+        m_snapshot.p_file_name = (uint32_t)p_info->p_file_name;
+    }
+    else if ((id == NRF_FAULT_ID_SDK_ASSERT) && (info != 0))
+    {
+        assert_info_t const * p_info = (assert_info_t const *)info;
+
+        m_snapshot.line_num    = p_info->line_num;
+        m_snapshot.p_file_name = (uint32_t)p_info->p_file_name;
+    }
+
+    snapshot_finish(__get_MSP());
+}
+
+
+crash_snapshot_t const * crash_snapshot_get(void)
+{
+    if ((m_snapshot.magic != CRASH_SNAPSHOT_MAGIC) ||
+        (m_snapshot.size != SNAPSHOT_WORDS)        ||
+        (m_snapshot.crc != crc32_compute((uint8_t const *)&m_snapshot, CRC_SIZE, NULL)))
+    {
+        return NULL;
+    }
+    return &m_snapshot;
+}
+
+
+void crash_snapshot_clear(void)
+{
+    m_snapshot.magic = 0;
+}
+
+
+static void fds_evt_handler(fds_evt_t const * const p_evt)
+{
+    if ((p_evt->id == FDS_EVT_WRITE)                                 &&
+        (p_evt->result == FDS_SUCCESS)                               &&
+        (p_evt->write.file_id == CRASH_SNAPSHOT_CONFIG_FILE_ID)      &&
+        (p_evt->write.record_key == CRASH_SNAPSHOT_CONFIG_RECORD_KEY))
+    {
+        crash_snapshot_clear();
+    }
+}
+
+
+ret_code_t crash_snapshot_init(void)
+{
+    return fds_register(fds_evt_handler);
+}
+
+
+ret_code_t crash_snapshot_store(void)
+{
+    fds_record_desc_t  desc;
+    fds_record_chunk_t chunk;
+    fds_record_t       record;
+
+    if (crash_snapshot_get() == NULL)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    // The snapshot stays in place until the write is done, so it is written from there.
+    chunk.p_data       = &m_snapshot;
+    chunk.length_words = SNAPSHOT_WORDS;
+
+    record.file_id         = CRASH_SNAPSHOT_CONFIG_FILE_ID;
+    record.key             = CRASH_SNAPSHOT_CONFIG_RECORD_KEY;
+    record.data.p_chunks   = &chunk;
+    record.data.num_chunks = 1;
+
+    return fds_record_write(&desc, &record);
+}
+
+#endif // NRF_MODULE_ENABLED(CRASH_SNAPSHOT)
@@ -0,0 +1,177 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup crash_snapshot Crash snapshot
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for keeping a compact binary report of a crash over the reset.
+ *
+ * @details The HardFault handler and the default application error handler take a snapshot when
+ *          the module is enabled. The snapshot holds the stacked registers, the fault status
+ *          registers, an excerpt of the stack, the handlers of the latest scheduler events if
+ *          @ref APP_SCHEDULER_HISTORY_SIZE is set, and the latest entries of
+ *          @ref nrf_log_crashlog if it is enabled. It is only copied to RAM that is not
+ *          initialized at startup, so that taking it does not delay the reset.
+ *
+ *          After the reset, @ref crash_snapshot_store writes the snapshot to a record of
+ *          @ref fds, once the application is running. The record can then be read, uploaded over
+ *          BLE, and deleted by the application.
+ */
+
+#ifndef CRASH_SNAPSHOT_H__
+#define CRASH_SNAPSHOT_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of stack words in a snapshot, from above the stacked registers.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef CRASH_SNAPSHOT_CONFIG_STACK_WORDS
+#define CRASH_SNAPSHOT_CONFIG_STACK_WORDS 32
+#endif
+
+/** @brief Number of scheduler event handlers in a snapshot.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef CRASH_SNAPSHOT_CONFIG_SCHED_EVENTS
+#define CRASH_SNAPSHOT_CONFIG_SCHED_EVENTS 8
+#endif
+
+/** @brief Number of words of log records in a snapshot.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef CRASH_SNAPSHOT_CONFIG_LOG_WORDS
+#define CRASH_SNAPSHOT_CONFIG_LOG_WORDS 64
+#endif
+
+/** @brief File ID of the record the snapshot is stored in.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef CRASH_SNAPSHOT_CONFIG_FILE_ID
+#define CRASH_SNAPSHOT_CONFIG_FILE_ID 0x4352
+#endif
+
+/** @brief Key of the record the snapshot is stored in.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef CRASH_SNAPSHOT_CONFIG_RECORD_KEY
+#define CRASH_SNAPSHOT_CONFIG_RECORD_KEY 0x0001
+#endif
+
+#define CRASH_SNAPSHOT_VERSION 1 /**< Version of the layout of @ref crash_snapshot_t. */
+
+/**@brief Cause of a crash. */
+typedef enum
+{
+    CRASH_SNAPSHOT_TYPE_HARDFAULT = 1, /**< HardFault. */
+    CRASH_SNAPSHOT_TYPE_ERROR     = 2, /**< Call of @ref app_error_fault_handler. */
+} crash_snapshot_type_t;
+
+/**@brief Crash snapshot, stored as it is in the record. All fields are words. */
+typedef struct
+{
+    uint32_t magic;                                          /**< Marks a valid snapshot. */
+    uint32_t version;                                        /**< @ref CRASH_SNAPSHOT_VERSION. */
+    uint32_t size;                                           /**< Size of the snapshot, in words. */
+    uint32_t type;                                           /**< Cause of the crash, see @ref crash_snapshot_type_t. */
+    uint32_t r0;                                             /**< Stacked R0, for a HardFault. */
+    uint32_t r1;                                             /**< Stacked R1, for a HardFault. */
+    uint32_t r2;                                             /**< Stacked R2, for a HardFault. */
+    uint32_t r3;                                             /**< Stacked R3, for a HardFault. */
+    uint32_t r12;                                            /**< Stacked R12, for a HardFault. */
+    uint32_t lr;                                             /**< Stacked link register, for a HardFault. */
+    uint32_t pc;                                             /**< Stacked program counter, or the pc passed to the error handler. */
+    uint32_t psr;                                            /**< Stacked program status register, for a HardFault. */
+    uint32_t cfsr;                                           /**< Configurable Fault Status Register. 0 on nRF51. */
+    uint32_t hfsr;                                           /**< HardFault Status Register. 0 on nRF51. */
+    uint32_t mmfar;                                          /**< MemManage Fault Address Register. 0 on nRF51. */
+    uint32_t bfar;                                           /**< BusFault Address Register. 0 on nRF51. */
+    uint32_t sp;                                             /**< Stack pointer the excerpt starts from. */
+    uint32_t id;                                             /**< Fault ID passed to the error handler. */
+    uint32_t info;                                           /**< Info passed to the error handler. */
+    uint32_t err_code;                                       /**< Error code of an SDK error. */
+    uint32_t line_num;                                       /**< Line number of an SDK error or assert. */
+    uint32_t p_file_name;                                    /**< Address of the file name of an SDK error or assert. */
+    uint32_t sched_count;                                    /**< Number of valid entries in sched_handlers. */
+    uint32_t sched_handlers[CRASH_SNAPSHOT_CONFIG_SCHED_EVENTS]; /**< Handlers of the latest scheduler events, the latest first. */
+    uint32_t stack_count;                                    /**< Number of valid words in stack. */
+    uint32_t stack[CRASH_SNAPSHOT_CONFIG_STACK_WORDS];       /**< Stack excerpt. */
+    uint32_t log_count;                                      /**< Number of valid words in log. */
+    uint32_t log[CRASH_SNAPSHOT_CONFIG_LOG_WORDS];           /**< Log records in the format of @ref nrf_log_crashlog, oldest first. */
+    uint32_t crc;                                            /**< CRC-32 of the preceding words. */
+} crash_snapshot_t;
+
+/**@brief Function for taking a snapshot in the HardFault handler.
+ *
+ * @param[in] p_stack_address Address of the registers stacked on exception entry.
+ */
+void crash_snapshot_fault_capture(uint32_t const * p_stack_address);
+
+/**@brief Function for taking a snapshot in the application error handler.
+ *
+ * @param[in] id   Fault ID.
+ * @param[in] pc   Program counter of the error.
+ * @param[in] info Fault information, see @ref app_error_fault_handler.
+ */
+void crash_snapshot_error_capture(uint32_t id, uint32_t pc, uint32_t info);
+
+/**@brief Function for getting the snapshot kept over the reset.
+ *
+ * @return Snapshot, or NULL if there is no valid snapshot.
+ */
+crash_snapshot_t const * crash_snapshot_get(void);
+
+/**@brief Function for removing the snapshot kept over the reset.
+ */
+void crash_snapshot_clear(void);
+
+/**@brief Function for initializing the module.
+ *
+ * @details Registers the module with @ref fds. Must be called before @ref fds_init.
+ *
+ * @return Any error returned by @ref fds_register.
+ */
+ret_code_t crash_snapshot_init(void);
+
+/**@brief Function for writing the snapshot kept over the reset to flash.
+ *
+ * @details The snapshot is written to a new record with @ref CRASH_SNAPSHOT_CONFIG_FILE_ID and
+ *          @ref CRASH_SNAPSHOT_CONFIG_RECORD_KEY, and removed from RAM when the write is done.
+ *          It can then be found with @ref fds_record_find. The function can be called when
+ *          the application is idle after startup, to keep the write off the startup time.
+ *
+ * @retval NRF_SUCCESS          If the write was queued.
+ * @retval NRF_ERROR_NOT_FOUND  If there is no valid snapshot.
+ * @return Any error returned by @ref fds_record_write.
+ */
+ret_code_t crash_snapshot_store(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRASH_SNAPSHOT_H__
+
+/** @} */
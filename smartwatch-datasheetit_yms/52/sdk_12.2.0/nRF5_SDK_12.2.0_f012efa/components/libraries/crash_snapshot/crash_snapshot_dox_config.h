@@ -0,0 +1,50 @@
+/**
+ *
+ * @defgroup crash_snapshot_config Crash snapshot configuration
+ * @{
+ * @ingroup crash_snapshot
+ */
+/** @brief Enabling the crash snapshot module
+ *
+ *  Requires the crc32 and fds modules.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define CRASH_SNAPSHOT_ENABLED
+
+/** @brief Number of stack words in a snapshot
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define CRASH_SNAPSHOT_CONFIG_STACK_WORDS
+
+/** @brief Number of scheduler event handlers in a snapshot
+ *
+ *  Limited by @ref APP_SCHEDULER_HISTORY_SIZE.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define CRASH_SNAPSHOT_CONFIG_SCHED_EVENTS
+
+/** @brief Number of words of log records in a snapshot
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define CRASH_SNAPSHOT_CONFIG_LOG_WORDS
+
+/** @brief File ID of the record the snapshot is stored in
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define CRASH_SNAPSHOT_CONFIG_FILE_ID
+
+/** @brief Key of the record the snapshot is stored in
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define CRASH_SNAPSHOT_CONFIG_RECORD_KEY
+
+
+/** @} */
@@ -24,11 +24,34 @@
 #define CRC16_H__
 
 #include <stdint.h>
+#include "sdk_config.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**@defgroup CRC16_ENGINES CRC-16 calculation engines
+ * @{
+ */
+#define CRC16_ENGINE_SHIFT      0   /**< Shift and XOR calculation. No lookup table. */
+#define CRC16_ENGINE_NIBBLE     1   /**< 16-entry (32-byte) nibble lookup table. */
+#define CRC16_ENGINE_BYTE       2   /**< 256-entry (512-byte) byte lookup table. */
+/** @} */
+
+#ifndef CRC16_CONFIG_ENGINE
+#ifdef NRF51
+#define CRC16_CONFIG_ENGINE CRC16_ENGINE_NIBBLE
+#else
+#define CRC16_CONFIG_ENGINE CRC16_ENGINE_BYTE
+#endif
+#endif
+
+/**@brief CRC-16 calculation context, used by the streaming API. */
+typedef struct
+{
+    uint16_t crc;   /**< Current value of the CRC register. */
+} crc16_ctx_t;
+
 /**@brief Function for calculating CRC-16 in blocks.
  *
  * Feed each consecutive data block into this function, along with the current value of p_crc as
@@ -44,6 +67,31 @@ extern "C" {
 uint16_t crc16_compute(uint8_t const * p_data, uint32_t size, uint16_t const * p_crc);
 
 
+/**@brief Function for initializing a CRC-16 calculation context.
+ *
+ * @param[out] p_ctx The context to initialize.
+ */
+void crc16_init(crc16_ctx_t * p_ctx);
+
+
+/**@brief Function for feeding a block of data into a CRC-16 calculation.
+ *
+ * @param[in,out] p_ctx  The calculation context, initialized with @ref crc16_init.
+ * @param[in]     p_data The input data block for computation.
+ * @param[in]     size   The size of the input data block in bytes.
+ */
+void crc16_update(crc16_ctx_t * p_ctx, uint8_t const * p_data, uint32_t size);
+
+
+/**@brief Function for retrieving the result of a CRC-16 calculation.
+ *
+ * @param[in] p_ctx The calculation context.
+ *
+ * @return The CRC-16 value of all data fed into the context.
+ */
+uint16_t crc16_final(crc16_ctx_t const * p_ctx);
+
+
 #ifdef __cplusplus
 }
 #endif
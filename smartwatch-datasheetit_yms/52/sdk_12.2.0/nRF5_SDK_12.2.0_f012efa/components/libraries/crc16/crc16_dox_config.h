@@ -12,5 +12,16 @@
  */
 #define CRC16_ENABLED
 
+/** @brief Engine used for calculating the CRC.
+ *
+ *  Following options are available:
+ * - 0 - Shift and XOR (no lookup table)
+ * - 1 - Nibble table (32 bytes of flash)
+ * - 2 - Byte table (512 bytes of flash)
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define CRC16_CONFIG_ENGINE
+
 
 /** @} */
@@ -23,11 +23,24 @@
 #define CRC32_H__
 
 #include <stdint.h>
+#include "sdk_config.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**@defgroup CRC32_ENGINES CRC-32 calculation engines
+ * @{
+ */
+#define CRC32_ENGINE_BITWISE        0   /**< Bit-by-bit calculation. No lookup table. */
+#define CRC32_ENGINE_NIBBLE         1   /**< 16-entry (64-byte) nibble lookup table. Suited for flash-constrained nRF51 builds. */
+#define CRC32_ENGINE_SLICE_BY_4     2   /**< Four 256-entry (4-kB) lookup tables, processing one 32-bit word per iteration. */
+/** @} */
+
+#ifndef CRC32_CONFIG_ENGINE
+#define CRC32_CONFIG_ENGINE CRC32_ENGINE_NIBBLE   /**< Engine used by @ref crc32_compute. */
+#endif
+
 /**@brief Function for calculating CRC-32 in blocks.
  *
  * Feed each consecutive data block into this function, along with the current value of p_crc as
@@ -43,6 +56,47 @@ extern "C" {
 uint32_t crc32_compute(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc);
 
 
+/**@brief Function for calculating CRC-32 in blocks, one bit at a time.
+ *
+ * @details Reference implementation. Has the same semantics as @ref crc32_compute.
+ *
+ * @param[in] p_data The input data block for computation.
+ * @param[in] size   The size of the input data block in bytes.
+ * @param[in] p_crc  The previous calculated CRC-32 value or NULL if first call.
+ *
+ * @return The updated CRC-32 value, based on the input supplied.
+ */
+uint32_t crc32_compute_bitwise(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc);
+
+
+/**@brief Function for calculating CRC-32 in blocks, using a 16-entry nibble lookup table.
+ *
+ * @details Has the same semantics as @ref crc32_compute. Word-aligned parts of the input are
+ *          loaded one 32-bit word at a time.
+ *
+ * @param[in] p_data The input data block for computation.
+ * @param[in] size   The size of the input data block in bytes.
+ * @param[in] p_crc  The previous calculated CRC-32 value or NULL if first call.
+ *
+ * @return The updated CRC-32 value, based on the input supplied.
+ */
+uint32_t crc32_compute_nibble(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc);
+
+
+/**@brief Function for calculating CRC-32 in blocks, using the slice-by-4 algorithm.
+ *
+ * @details Has the same semantics as @ref crc32_compute. Unaligned leading and trailing bytes
+ *          are processed one at a time, the word-aligned part one 32-bit word at a time.
+ *
+ * @param[in] p_data The input data block for computation.
+ * @param[in] size   The size of the input data block in bytes.
+ * @param[in] p_crc  The previous calculated CRC-32 value or NULL if first call.
+ *
+ * @return The updated CRC-32 value, based on the input supplied.
+ */
+uint32_t crc32_compute_slice_by_4(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -12,5 +12,16 @@
  */
 #define CRC32_ENABLED
 
+/** @brief Engine used by crc32_compute.
+ *
+ *  Following options are available:
+ * - 0 - Bitwise (no lookup table)
+ * - 1 - Nibble table (64 bytes of flash)
+ * - 2 - Slice-by-4 tables (4 kB of flash)
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define CRC32_CONFIG_ENGINE
+
 
 /** @} */
@@ -0,0 +1,387 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(CROWN_INPUT)
+#include "crown_input.h"
+#include <string.h>
+#include "nrf_drv_qdec.h"
+#include "nrf_drv_gpiote.h"
+#include "app_timer.h"
+#include "app_error.h"
+#include "app_util_platform.h"
+
+#define LEDPRE_US       1   /**< Time the LED is switched on before a sample. There is no LED, so the shortest. */
+#define PAUSE_PERIODS   2   /**< Report periods without movement after which the crown is considered still. */
+
+/**@brief State of the module. */
+typedef enum
+{
+    CROWN_STATE_DISABLED, /**< Nothing is read. */
+    CROWN_STATE_ACTIVE,   /**< QDEC is running. */
+    CROWN_STATE_IDLE,     /**< QDEC is stopped, the pins are watched. */
+} crown_state_t;
+
+/**@brief Control block. */
+typedef struct
+{
+    crown_input_config_t const * p_config;
+    crown_state_t volatile       state;
+    nrf_qdec_reportper_t         reportper;  /**< Current report period. */
+    uint32_t                     sample_us;  /**< Sampling period, in microseconds. */
+    uint32_t                     idle_ticks; /**< Idle time, in app_timer ticks. */
+    uint32_t                     last_ticks; /**< app_timer counter at the last report, or at the start. */
+    int16_t                      remainder;  /**< Transitions not counted as a detent yet. */
+    int16_t                      velocity;   /**< Filtered velocity, in detents per second. */
+} crown_input_cb_t;
+
+APP_TIMER_DEF(m_idle_timer);
+static crown_input_cb_t m_cb;
+
+
+static uint32_t ticks_to_us(uint32_t ticks)
+{
+    return (uint32_t)(((uint64_t)ticks * 1000000 * ((uint32_t)m_cb.p_config->timer_prescaler + 1))
+                      / APP_TIMER_CLOCK_FREQ);
+}
+
+
+static uint32_t report_period_us(void)
+{
+    return nrf_qdec_reportper_to_value(m_cb.reportper) * m_cb.sample_us;
+}
+
+
+static void reportper_set(nrf_qdec_reportper_t reportper)
+{
+    if (reportper != m_cb.reportper)
+    {
+        m_cb.reportper = reportper;
+        nrf_qdec_reportper_set(reportper);
+    }
+}
+
+
+/**@brief Function for adapting the report period to the movement in the last report.
+ *
+ * @details The period is shortened while a report holds more than a detent, and lengthened
+ *          while it holds less. QDEC sends no report for a period without movement.
+ */
+static void reportper_adapt(int32_t transitions)
+{
+    uint32_t abs_transitions = (uint32_t)((transitions < 0) ? -transitions : transitions);
+    uint32_t per_detent      = m_cb.p_config->transitions_per_detent;
+
+    if ((abs_transitions > per_detent) && (m_cb.reportper > NRF_QDEC_REPORTPER_10))
+    {
+        reportper_set((nrf_qdec_reportper_t)(m_cb.reportper - 1));
+    }
+    else if ((abs_transitions < per_detent) && (m_cb.reportper < m_cb.p_config->reportper_max))
+    {
+        reportper_set((nrf_qdec_reportper_t)(m_cb.reportper + 1));
+    }
+}
+
+
+/**@brief Function for updating the filtered velocity.
+ *
+ * @param[in] transitions Transitions of the last report.
+ * @param[in] window_us   Time in which the transitions were made.
+ */
+static void velocity_update(int32_t transitions, uint32_t window_us)
+{
+    int64_t velocity = ((int64_t)transitions * 1000000)
+                     / ((int64_t)window_us * m_cb.p_config->transitions_per_detent);
+
+    velocity = MIN(MAX(velocity, INT16_MIN), INT16_MAX);
+
+    // A change of direction is not filtered, so that a list stops at once.
+    if ((velocity < 0) != (m_cb.velocity < 0))
+    {
+        m_cb.velocity = (int16_t)velocity;
+    }
+    else
+    {
+        m_cb.velocity = (int16_t)((m_cb.velocity + velocity) / 2);
+    }
+}
+
+
+static int16_t steps_get(int16_t detents)
+{
+    crown_input_config_t const * p_config = m_cb.p_config;
+    int32_t                      factor   = 1;
+
+    if (p_config->accel_velocity != 0)
+    {
+        int32_t speed = (m_cb.velocity < 0) ? -m_cb.velocity : m_cb.velocity;
+
+        factor = MAX(1, MIN(speed / p_config->accel_velocity, p_config->accel_max));
+    }
+
+    return (int16_t)MIN(MAX(detents * factor, INT16_MIN), INT16_MAX);
+}
+
+
+static void transitions_handle(int32_t transitions)
+{
+    uint32_t          now = app_timer_cnt_get();
+    uint32_t          ticks;
+    uint32_t          elapsed_us;
+    uint32_t          period_us = report_period_us();
+    int16_t           detents;
+    crown_input_evt_t evt;
+
+    UNUSED_RETURN_VALUE(app_timer_cnt_diff_compute(now, m_cb.last_ticks, &ticks));
+    m_cb.last_ticks = now;
+    elapsed_us      = ticks_to_us(ticks);
+
+    velocity_update(transitions, MAX(elapsed_us, period_us));
+
+    // After a pause, the crown is turned slowly again first.
+    if (elapsed_us > PAUSE_PERIODS * period_us)
+    {
+        reportper_set(m_cb.p_config->reportper_max);
+    }
+    reportper_adapt(transitions);
+
+    transitions     += m_cb.remainder;
+    detents          = (int16_t)(transitions / m_cb.p_config->transitions_per_detent);
+    m_cb.remainder   = (int16_t)(transitions - (detents * m_cb.p_config->transitions_per_detent));
+
+    if (detents != 0)
+    {
+        evt.type     = CROWN_INPUT_EVT_ROTATION;
+        evt.detents  = detents;
+        evt.steps    = steps_get(detents);
+        evt.velocity = m_cb.velocity;
+        m_cb.p_config->evt_handler(&evt);
+    }
+}
+
+
+static void qdec_event_handler(nrf_drv_qdec_event_t event)
+{
+    // On an overflow of the accumulator, the report still comes with the saturated count.
+    if ((event.type == NRF_QDEC_EVENT_REPORTRDY) && (m_cb.state == CROWN_STATE_ACTIVE))
+    {
+        transitions_handle(event.data.report.acc);
+    }
+}
+
+
+static void pins_watch(bool watch)
+{
+    if (watch)
+    {
+        nrf_drv_gpiote_in_event_enable(m_cb.p_config->pin_a, true);
+        nrf_drv_gpiote_in_event_enable(m_cb.p_config->pin_b, true);
+    }
+    else
+    {
+        nrf_drv_gpiote_in_event_disable(m_cb.p_config->pin_a);
+        nrf_drv_gpiote_in_event_disable(m_cb.p_config->pin_b);
+    }
+}
+
+
+/**@brief Function for starting QDEC, with the longest report period. */
+static ret_code_t qdec_start(void)
+{
+    m_cb.remainder  = 0;
+    m_cb.velocity   = 0;
+    m_cb.last_ticks = app_timer_cnt_get();
+    reportper_set(m_cb.p_config->reportper_max);
+    nrf_drv_qdec_enable();
+
+    if (m_cb.idle_ticks == 0)
+    {
+        return NRF_SUCCESS;
+    }
+    return app_timer_start(m_idle_timer, m_cb.idle_ticks, NULL);
+}
+
+
+static void idle_timer_handler(void * p_context)
+{
+    uint32_t          ticks   = 0;
+    bool              idle    = false;
+    bool              restart = false;
+    crown_input_evt_t evt     = {.type = CROWN_INPUT_EVT_IDLE};
+
+    UNUSED_PARAMETER(p_context);
+
+    CRITICAL_REGION_ENTER();
+    if (m_cb.state == CROWN_STATE_ACTIVE)
+    {
+        UNUSED_RETURN_VALUE(app_timer_cnt_diff_compute(app_timer_cnt_get(), m_cb.last_ticks, &ticks));
+        if (ticks >= m_cb.idle_ticks)
+        {
+            nrf_drv_qdec_disable();
+            m_cb.state = CROWN_STATE_IDLE;
+            idle       = true;
+        }
+        else
+        {
+            restart = true;
+        }
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (idle)
+    {
+        pins_watch(true);
+        m_cb.p_config->evt_handler(&evt);
+    }
+    else if (restart)
+    {
+        // The crown moved since the timer was started: wait for the rest of the idle time.
+        ret_code_t err_code = app_timer_start(m_idle_timer,
+                                              MAX(m_cb.idle_ticks - ticks, APP_TIMER_MIN_TIMEOUT_TICKS),
+                                              NULL);
+        APP_ERROR_CHECK(err_code);
+    }
+}
+
+
+static void gpiote_event_handler(nrf_drv_gpiote_pin_t pin, nrf_gpiote_polarity_t action)
+{
+    bool wake = false;
+
+    UNUSED_PARAMETER(pin);
+    UNUSED_PARAMETER(action);
+
+    CRITICAL_REGION_ENTER();
+    if (m_cb.state == CROWN_STATE_IDLE)
+    {
+        m_cb.state = CROWN_STATE_ACTIVE;
+        wake       = true;
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (wake)
+    {
+        pins_watch(false);
+        ret_code_t err_code = qdec_start();
+        APP_ERROR_CHECK(err_code);
+    }
+}
+
+
+ret_code_t crown_input_init(crown_input_config_t const * p_config)
+{
+    ret_code_t                 err_code;
+    nrf_drv_gpiote_in_config_t pin_config = GPIOTE_CONFIG_IN_SENSE_TOGGLE(false);
+    nrf_drv_qdec_config_t      qdec_config;
+
+    VERIFY_PARAM_NOT_NULL(p_config);
+    VERIFY_PARAM_NOT_NULL(p_config->evt_handler);
+
+    if ((p_config->transitions_per_detent == 0) ||
+        (p_config->reportper_max >= NRF_QDEC_REPORTPER_DISABLED) ||
+        ((p_config->accel_velocity != 0) && (p_config->accel_max == 0)))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    memset(&m_cb, 0, sizeof(m_cb));
+    m_cb.p_config   = p_config;
+    m_cb.state      = CROWN_STATE_DISABLED;
+    m_cb.reportper  = p_config->reportper_max;
+    m_cb.sample_us  = nrf_qdec_sampleper_to_value(p_config->sampleper);
+    m_cb.idle_ticks = APP_TIMER_TICKS(p_config->idle_ms, p_config->timer_prescaler);
+    if ((p_config->idle_ms != 0) && (m_cb.idle_ticks < APP_TIMER_MIN_TIMEOUT_TICKS))
+    {
+        m_cb.idle_ticks = APP_TIMER_MIN_TIMEOUT_TICKS;
+    }
+
+    // No sample interrupt: the transitions are counted by the accumulator until a report.
+    qdec_config.reportper          = p_config->reportper_max;
+    qdec_config.sampleper          = p_config->sampleper;
+    qdec_config.psela              = p_config->pin_a;
+    qdec_config.pselb              = p_config->pin_b;
+    qdec_config.pselled            = NRF_QDEC_LED_NOT_CONNECTED;
+    qdec_config.ledpre             = LEDPRE_US;
+    qdec_config.ledpol             = NRF_QDEC_LEPOL_ACTIVE_HIGH;
+    qdec_config.dbfen              = p_config->dbfen;
+    qdec_config.sample_inten       = false;
+    qdec_config.interrupt_priority = p_config->interrupt_priority;
+
+    err_code = nrf_drv_qdec_init(&qdec_config, qdec_event_handler);
+    VERIFY_SUCCESS(err_code);
+
+    err_code = app_timer_create(&m_idle_timer, APP_TIMER_MODE_SINGLE_SHOT, idle_timer_handler);
+    VERIFY_SUCCESS(err_code);
+
+    if (!nrf_drv_gpiote_is_init())
+    {
+        err_code = nrf_drv_gpiote_init();
+        VERIFY_SUCCESS(err_code);
+    }
+
+    // The pins are configured with the pull here, the QDEC driver leaves them floating.
+    pin_config.pull = p_config->pull_cfg;
+    err_code = nrf_drv_gpiote_in_init(p_config->pin_a, &pin_config, gpiote_event_handler);
+    VERIFY_SUCCESS(err_code);
+    err_code = nrf_drv_gpiote_in_init(p_config->pin_b, &pin_config, gpiote_event_handler);
+    VERIFY_SUCCESS(err_code);
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t crown_input_enable(void)
+{
+    bool start = false;
+
+    ASSERT(m_cb.p_config);
+
+    CRITICAL_REGION_ENTER();
+    if (m_cb.state == CROWN_STATE_DISABLED)
+    {
+        m_cb.state = CROWN_STATE_ACTIVE;
+        start      = true;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return start ? qdec_start() : NRF_SUCCESS;
+}
+
+
+void crown_input_disable(void)
+{
+    crown_state_t state;
+
+    ASSERT(m_cb.p_config);
+
+    CRITICAL_REGION_ENTER();
+    state      = m_cb.state;
+    m_cb.state = CROWN_STATE_DISABLED;
+    if (state == CROWN_STATE_ACTIVE)
+    {
+        nrf_drv_qdec_disable();
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (state == CROWN_STATE_IDLE)
+    {
+        pins_watch(false);
+    }
+    UNUSED_RETURN_VALUE(app_timer_stop(m_idle_timer));
+}
+
+
+bool crown_input_is_active(void)
+{
+    return (m_cb.state == CROWN_STATE_ACTIVE);
+}
+
+#endif // NRF_MODULE_ENABLED(CROWN_INPUT)
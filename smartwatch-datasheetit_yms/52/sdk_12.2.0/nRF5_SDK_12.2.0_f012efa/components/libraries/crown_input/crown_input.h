@@ -0,0 +1,134 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup crown_input Crown input
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for reading a rotating crown or a scroll wheel with the QDEC peripheral.
+ *
+ * @details The transitions of the encoder are counted by the QDEC accumulator, without a
+ *          sample interrupt. A report interrupt comes only at the end of a report period in
+ *          which the crown moved. The report period is adapted to the speed of the crown: it is
+ *          shortened while the crown spins, so that about one detent is reported per interrupt,
+ *          and lengthened while it turns slowly, so that slow movements cost few interrupts.
+ *
+ *          Each report carries the number of detents, their velocity and the number of steps
+ *          after acceleration, which a list can scroll by.
+ *
+ *          When the crown has not moved for the idle time, QDEC is stopped and the pins are
+ *          watched with a low-power PORT event of the GPIOTE driver. The next edge starts QDEC
+ *          again. The edge that wakes QDEC is not counted, which loses less than a detent.
+ *
+ * @note The module uses the QDEC driver, the GPIOTE driver and one app_timer timer. The LED
+ *       output of QDEC is not used: the encoder must be a mechanical, or an always-on, one.
+ */
+
+#ifndef CROWN_INPUT_H__
+#define CROWN_INPUT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nrf_gpio.h"
+#include "nrf_qdec.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**@brief Event types. */
+typedef enum
+{
+    CROWN_INPUT_EVT_ROTATION, /**< The crown was turned by at least one detent. */
+    CROWN_INPUT_EVT_IDLE,     /**< The crown has not moved for the idle time, QDEC was stopped. */
+} crown_input_evt_type_t;
+
+/**@brief Event. */
+typedef struct
+{
+    crown_input_evt_type_t type;     /**< Type of the event. */
+    int16_t                detents;  /**< Detents turned since the previous event, positive clockwise. */
+    int16_t                steps;    /**< Detents after acceleration. */
+    int16_t                velocity; /**< Filtered velocity, in detents per second. */
+} crown_input_evt_t;
+
+/**@brief Event handler.
+ *
+ * @param[in] p_evt Event. Called from the QDEC interrupt for the rotation events, and from the
+ *                  app_timer interrupt for the idle event.
+ */
+typedef void (* crown_input_evt_handler_t)(crown_input_evt_t const * p_evt);
+
+/**@brief Module configuration. */
+typedef struct
+{
+    uint32_t                  pin_a;                  /**< Pin of the A output of the encoder. */
+    uint32_t                  pin_b;                  /**< Pin of the B output of the encoder. */
+    nrf_gpio_pin_pull_t       pull_cfg;               /**< Pull-up or -down configuration of both pins. */
+    nrf_qdec_sampleper_t      sampleper;              /**< Sampling period. Must be shorter than the time between two transitions at the highest speed. */
+    nrf_qdec_reportper_t      reportper_max;          /**< Longest report period, used while the crown turns slowly. */
+    bool                      dbfen;                  /**< Enable the debounce filter of QDEC. */
+    uint8_t                   transitions_per_detent; /**< Transitions counted by QDEC for one detent, usually 2 or 4. */
+    uint16_t                  idle_ms;                /**< Time without movement after which QDEC is stopped. 0 to keep it running. */
+    uint16_t                  accel_velocity;         /**< Velocity, in detents per second, from which a detent counts as several steps. 0 to disable acceleration. */
+    uint8_t                   accel_max;              /**< Largest number of steps per detent. */
+    uint8_t                   timer_prescaler;        /**< Value of the RTC1 PRESCALER register used by app_timer. */
+    uint8_t                   interrupt_priority;     /**< QDEC interrupt priority. */
+    crown_input_evt_handler_t evt_handler;            /**< Event handler. */
+} crown_input_config_t;
+
+/**@brief Function for initializing the module.
+ *
+ * @details QDEC and the pins are configured, and the GPIOTE driver is initialized if needed.
+ *          app_timer must be initialized. Reading is started with @ref crown_input_enable.
+ *
+ * @param[in] p_config Module configuration. Must stay valid while the module is initialized.
+ *
+ * @retval NRF_SUCCESS             If the module was initialized.
+ * @retval NRF_ERROR_NULL          If a required pointer was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If the configuration was invalid.
+ * @return Any error returned by the QDEC or the GPIOTE driver, or by app_timer.
+ */
+ret_code_t crown_input_init(crown_input_config_t const * p_config);
+
+/**@brief Function for starting to read the crown.
+ *
+ * @details QDEC is started, with the longest report period.
+ *
+ * @retval NRF_SUCCESS If reading was started, or was started already.
+ * @return Any error returned by app_timer.
+ */
+ret_code_t crown_input_enable(void);
+
+/**@brief Function for stopping to read the crown.
+ *
+ * @details QDEC is stopped and the pins are not watched. Transitions that were not reported yet
+ *          are discarded.
+ */
+void crown_input_disable(void);
+
+/**@brief Function for checking if QDEC is running.
+ *
+ * @return False if reading is disabled, or if QDEC is stopped because the crown is idle.
+ */
+bool crown_input_is_active(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CROWN_INPUT_H__
+
+/** @} */
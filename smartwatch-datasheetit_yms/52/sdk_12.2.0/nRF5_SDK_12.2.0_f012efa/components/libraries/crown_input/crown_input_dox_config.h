@@ -0,0 +1,18 @@
+/**
+ *
+ * @defgroup crown_input_config crown_input module configuration
+ * @{
+ * @ingroup crown_input
+ */
+/** @brief Enabling crown_input module
+ *
+ *  Requires the QDEC and GPIOTE drivers, and app_timer.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define CROWN_INPUT_ENABLED
+
+
+/** @} */
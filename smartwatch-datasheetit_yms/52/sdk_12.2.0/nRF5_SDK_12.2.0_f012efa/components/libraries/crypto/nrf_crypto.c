@@ -15,6 +15,11 @@
 #include "ecc.h"
 #include "sha256.h"
 #include "nrf_crypto.h"
+#ifdef SOFTDEVICE_PRESENT
+#include "nrf_soc.h"
+#else
+#include "nrf_ecb.h"
+#endif
 
 uint32_t nrf_crypto_init(void)
 {
@@ -129,3 +134,41 @@ uint32_t nrf_crypto_hash_compute(uint32_t hash_alg,
 }
 
 
+uint32_t nrf_crypto_aes128_encrypt(uint8_t const * p_key, uint8_t const * p_in, uint8_t * p_out)
+{
+    if (p_key == NULL || p_in == NULL || p_out == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+#ifdef SOFTDEVICE_PRESENT
+    // The ECB peripheral is shared with the SoftDevice.
+    uint32_t           err_code;
+    nrf_ecb_hal_data_t ecb_data;
+
+    memcpy(ecb_data.key, p_key, SOC_ECB_KEY_LENGTH);
+    memcpy(ecb_data.cleartext, p_in, SOC_ECB_CLEARTEXT_LENGTH);
+
+    err_code = sd_ecb_block_encrypt(&ecb_data);
+    VERIFY_SUCCESS(err_code);
+
+    memcpy(p_out, ecb_data.ciphertext, SOC_ECB_CIPHERTEXT_LENGTH);
+#else
+    static bool m_ecb_initialized;
+
+    if (!m_ecb_initialized)
+    {
+        m_ecb_initialized = nrf_ecb_init();
+    }
+
+    nrf_ecb_set_key(p_key);
+    if (!nrf_ecb_crypt(p_out, p_in))
+    {
+        return NRF_ERROR_TIMEOUT;
+    }
+#endif
+
+    return NRF_SUCCESS;
+}
+
+
@@ -30,6 +30,10 @@ extern "C" {
  *
  * @details The cryptography library provides functions to compute keys, shared secrets, and hashes,
  *          and to sign and verify data using digital signatures.
+ *
+ *          The elliptic curve functions use the backend of the @ref ecc module that is built in:
+ *          micro-ecc (ecc.c) or the CryptoCell of nRF52840 (ecc_cc310.c). AES uses the ECB
+ *          peripheral.
  */
 
 #define NRF_CRYPTO_SVCI_BASE 0                               //!< Base SVCI number for the nrf_crypto module.
@@ -216,6 +220,21 @@ SVCI(NRF_CRYPTO_SVCI_HASH_COMPUTE, uint32_t, \
                                 nrf_crypto_key_t *, p_hash);
 #endif
 
+/**@brief Function for encrypting one block with AES-128, using the ECB peripheral.
+ *
+ * @details If a SoftDevice is present, the peripheral is used through the SoftDevice. This
+ *          function is not available as an SVCI.
+ *
+ * @param[in]   p_key        Key, 16 bytes.
+ * @param[in]   p_in         Cleartext, 16 bytes.
+ * @param[out]  p_out        Ciphertext, 16 bytes.
+ *
+ * @retval  NRF_SUCCESS If the block was encrypted successfully.
+ * @retval  NRF_ERROR_NULL If any of the provided pointers is NULL.
+ * @retval  NRF_ERROR_TIMEOUT If the peripheral did not complete the encryption.
+ */
+uint32_t nrf_crypto_aes128_encrypt(uint8_t const * p_key, uint8_t const * p_in, uint8_t * p_out);
+
 /** @} */
 #ifdef __cplusplus
 }
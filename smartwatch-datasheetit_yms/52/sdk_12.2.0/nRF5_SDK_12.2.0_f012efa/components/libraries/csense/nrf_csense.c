@@ -34,6 +34,14 @@ typedef struct
     uint32_t                      ticks;                                //!< Timeout ticks of app_timer instance controlling csense module.
     uint16_t                      raw_analog_values[MAX_ANALOG_INPUTS]; //!< Raw values of measurements.
     uint8_t                       enabled_analog_channels_mask;         //!< Mask of enabled channels.
+    uint32_t                      baselines[MAX_ANALOG_INPUTS];         //!< Untouched values of channels, scaled by 2^NRF_CSENSE_BASELINE_IIR_SHIFT.
+    uint8_t                       baselines_valid_mask;                 //!< Mask of channels with a baseline.
+    uint8_t                       scan_channels_mask;                   //!< Mask of channels measured in the current scan mode.
+    uint8_t                       idle_channels_mask;                   //!< Mask of channels measured while idle, 0 if the idle scan is disabled.
+    uint32_t                      idle_ticks;                           //!< Timeout ticks of app_timer instance while idle.
+    uint16_t                      active_scans;                         //!< Number of scans without a touch before going idle.
+    uint16_t                      scans_left;                           //!< Scans without a touch left before going idle.
+    bool                          idle;                                 //!< Flag to indicate if only the idle channels are measured.
 }nrf_csense_t;
 
 /* Module instance. */
@@ -65,6 +73,114 @@ static void csense_timer_handler(void * p_context)
 }
 
 
+/**
+ * @brief Function for getting the baseline of a channel.
+ *
+ * @param [in] channel                              Analog channel.
+ *
+ * @return Untouched value of the channel.
+ */
+__STATIC_INLINE uint16_t baseline_get(uint8_t channel)
+{
+    return (uint16_t)(m_nrf_csense.baselines[channel] >> NRF_CSENSE_BASELINE_IIR_SHIFT);
+}
+
+
+/**
+ * @brief Function for updating baselines with the values of the last scan.
+ *
+ * Values that rise more than @ref NRF_CSENSE_WAKE_THRESHOLD above the baseline are touches and
+ * are skipped, so the baseline only follows slow changes of the untouched channel.
+ */
+static void baselines_update(void)
+{
+    uint8_t  mask = m_nrf_csense.scan_channels_mask;
+    uint8_t  channel;
+    uint16_t val;
+
+    while (mask != 0)
+    {
+        channel = 31 - __CLZ(mask);
+        mask   &= ~(1UL << channel);
+        val     = m_nrf_csense.raw_analog_values[channel];
+
+        if ((m_nrf_csense.baselines_valid_mask & (1UL << channel)) == 0)
+        {
+            m_nrf_csense.baselines[channel]      = (uint32_t)val << NRF_CSENSE_BASELINE_IIR_SHIFT;
+            m_nrf_csense.baselines_valid_mask   |= (1UL << channel);
+        }
+        else if (val <= baseline_get(channel) + NRF_CSENSE_WAKE_THRESHOLD)
+        {
+            m_nrf_csense.baselines[channel] += val;
+            m_nrf_csense.baselines[channel] -= baseline_get(channel);
+        }
+    }
+}
+
+
+/**
+ * @brief Function for checking if any of the idle channels was touched.
+ *
+ * @return True if a channel rose more than @ref NRF_CSENSE_WAKE_THRESHOLD above its baseline.
+ */
+static bool idle_touch_check(void)
+{
+    uint8_t mask = m_nrf_csense.scan_channels_mask;
+    uint8_t channel;
+
+    while (mask != 0)
+    {
+        channel = 31 - __CLZ(mask);
+        mask   &= ~(1UL << channel);
+
+        if (m_nrf_csense.raw_analog_values[channel] >
+            baseline_get(channel) + NRF_CSENSE_WAKE_THRESHOLD)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/**
+ * @brief Function for switching between measuring all pads and measuring the idle channels.
+ *
+ * @param [in] idle                                 True to measure only the idle channels.
+ *
+ * @return Result of restarting app_timer.
+ */
+static ret_code_t scan_mode_set(bool idle)
+{
+    ret_code_t err_code;
+    uint8_t    channels_mask = m_nrf_csense.enabled_analog_channels_mask;
+    uint32_t   ticks         = m_nrf_csense.ticks;
+
+    if (idle)
+    {
+        channels_mask &= m_nrf_csense.idle_channels_mask;
+        ticks          = m_nrf_csense.idle_ticks;
+    }
+
+    m_nrf_csense.idle       = idle;
+    m_nrf_csense.scans_left = m_nrf_csense.active_scans;
+
+    // Enable the new channels first, so that the lower module stays powered on.
+    nrf_drv_csense_channels_enable(channels_mask);
+    nrf_drv_csense_channels_disable(m_nrf_csense.scan_channels_mask & ~channels_mask);
+    m_nrf_csense.scan_channels_mask = channels_mask;
+
+    err_code = app_timer_stop(nrf_csense_timer);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    return app_timer_start(nrf_csense_timer, ticks, NULL);
+}
+
+
 /**
  * @brief Function for updating maximum or minimum value.
  *
@@ -75,11 +191,14 @@ __STATIC_INLINE void min_or_max_update(nrf_csense_instance_t const * p_instance,
                                          nrf_csense_pad_t            * p_pad)
 {
     uint16_t val = m_nrf_csense.raw_analog_values[p_pad->analog_input_number];
+    uint16_t min = baseline_get(p_pad->analog_input_number);
 
-    if (p_instance->min_max[p_pad->pad_index].min_value > val)
+    // The baseline follows drifts in both directions, but must not be above the value.
+    if (min > val)
     {
-        p_instance->min_max[p_pad->pad_index].min_value = val;
+        min = val;
     }
+    p_instance->min_max[p_pad->pad_index].min_value = min;
 
     if (p_instance->min_max[p_pad->pad_index].max_value < val)
     {
@@ -308,6 +427,19 @@ static void csense_event_handler(nrf_drv_csense_evt_t * p_event_struct)
         return;
     }
 
+    baselines_update();
+
+    if (m_nrf_csense.idle)
+    {
+        // The other channels were not measured, so the instances are not checked until all pads
+        // are measured again.
+        if (idle_touch_check())
+        {
+            UNUSED_RETURN_VALUE(scan_mode_set(false));
+        }
+        return;
+    }
+
     for (instance = mp_nrf_csense_instance_head; instance != NULL;
          instance = instance->p_next_instance) // run through all instances
     {
@@ -404,6 +536,26 @@ static void csense_event_handler(nrf_drv_csense_evt_t * p_event_struct)
     memset(m_values_buffer, 0, sizeof(m_values_buffer));
     memcpy(prev_analog_values, m_nrf_csense.raw_analog_values,
            sizeof(m_nrf_csense.raw_analog_values));
+
+    if ((m_nrf_csense.enabled_analog_channels_mask & m_nrf_csense.idle_channels_mask) == 0)
+    {
+        return;
+    }
+
+    for (instance = mp_nrf_csense_instance_head; instance != NULL;
+         instance = instance->p_next_instance)
+    {
+        if (instance->is_active && instance->is_touched)
+        {
+            m_nrf_csense.scans_left = m_nrf_csense.active_scans;
+            return;
+        }
+    }
+
+    if (--m_nrf_csense.scans_left == 0)
+    {
+        UNUSED_RETURN_VALUE(scan_mode_set(true));
+    }
 }
 
 
@@ -518,6 +670,15 @@ ret_code_t nrf_csense_enable(nrf_csense_instance_t * const p_instance)
             return err_code;
         }
     }
+    else if (m_nrf_csense.idle)
+    {
+        err_code = scan_mode_set(false);
+        if (err_code != NRF_SUCCESS)
+        {
+            return err_code;
+        }
+    }
+    m_nrf_csense.scans_left = m_nrf_csense.active_scans;
 
     p_instance->is_active = true;
 
@@ -534,6 +695,7 @@ ret_code_t nrf_csense_enable(nrf_csense_instance_t * const p_instance)
 
     m_nrf_csense.state = NRF_DRV_STATE_POWERED_ON;
     nrf_drv_csense_channels_enable(analog_channels_mask);
+    m_nrf_csense.scan_channels_mask |= analog_channels_mask;
 
     return NRF_SUCCESS;
 }
@@ -549,6 +711,15 @@ ret_code_t nrf_csense_disable(nrf_csense_instance_t * const p_instance)
     uint8_t                     channels_mask = 0;
     uint8_t                     instance_channels_mask = 0;
 
+    if (m_nrf_csense.idle)
+    {
+        err_code = scan_mode_set(false);
+        if (err_code != NRF_SUCCESS)
+        {
+            return err_code;
+        }
+    }
+
     for (p_instance_temp = mp_nrf_csense_instance_head; p_instance_temp != NULL;
          p_instance_temp = p_instance_temp->p_next_instance)
     {
@@ -568,7 +739,9 @@ ret_code_t nrf_csense_disable(nrf_csense_instance_t * const p_instance)
 
     nrf_drv_csense_channels_disable((~channels_mask) & instance_channels_mask);
 
-    m_nrf_csense.enabled_analog_channels_mask = channels_mask;
+    m_nrf_csense.enabled_analog_channels_mask  = channels_mask;
+    m_nrf_csense.scan_channels_mask            = channels_mask;
+    m_nrf_csense.baselines_valid_mask         &= channels_mask;
 
     if (m_nrf_csense.enabled_analog_channels_mask == 0)
     {
@@ -597,7 +770,7 @@ ret_code_t nrf_csense_ticks_set(uint32_t ticks)
 
     m_nrf_csense.ticks = ticks;
 
-    if (m_nrf_csense.state == NRF_DRV_STATE_POWERED_ON)
+    if ((m_nrf_csense.state == NRF_DRV_STATE_POWERED_ON) && !m_nrf_csense.idle)
     {
         err_code = app_timer_stop(nrf_csense_timer);
         if (err_code != NRF_SUCCESS)
@@ -616,6 +789,34 @@ ret_code_t nrf_csense_ticks_set(uint32_t ticks)
 }
 
 
+ret_code_t nrf_csense_idle_scan_set(uint8_t idle_channels_mask, uint32_t idle_ticks, uint16_t active_scans)
+{
+    ASSERT(m_nrf_csense.state != NRF_DRV_STATE_UNINITIALIZED);
+
+    if ((idle_channels_mask != 0) && ((idle_ticks == 0) || (active_scans == 0)))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if (nrf_drv_csense_is_busy())
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    m_nrf_csense.idle_channels_mask = idle_channels_mask;
+    m_nrf_csense.idle_ticks         = idle_ticks;
+    m_nrf_csense.active_scans       = active_scans;
+    m_nrf_csense.scans_left         = active_scans;
+
+    if (m_nrf_csense.idle)
+    {
+        return scan_mode_set(false);
+    }
+
+    return NRF_SUCCESS;
+}
+
+
 ret_code_t nrf_csense_steps_set(nrf_csense_instance_t * const p_instance, uint16_t steps)
 {
     if (p_instance->is_active)
@@ -28,8 +28,39 @@
  * @ingroup app_common
  *
  * @brief Module for using the capacitive sensor library with support for many instances of sliders, wheels, and buttons.
+ *
+ * @details All enabled pads are measured at the interval set by @ref nrf_csense_ticks_set. To save
+ *          power while nothing is touched, an idle scan can be configured with
+ *          @ref nrf_csense_idle_scan_set. The library then measures only the idle channels (for
+ *          example, one pad that covers the whole slider) at a longer interval, and returns to
+ *          measuring all pads at the normal interval as soon as one of them is touched.
+ *
+ *          The library keeps a baseline for each analog channel. The baseline is the untouched
+ *          value of the channel and follows slow drifts through a first order IIR filter. It is
+ *          used to detect touches on the idle channels, and as the minimum when sliders are
+ *          calibrated.
  */
 
+/** @brief Number of right shifts used as the weight of a new measurement in the baseline filter.
+ *
+ * A value of 4 makes every measurement contribute 1/16 to the baseline.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef NRF_CSENSE_BASELINE_IIR_SHIFT
+#define NRF_CSENSE_BASELINE_IIR_SHIFT 4
+#endif
+
+/** @brief Minimal rise above the baseline to decide that an idle channel was touched.
+ *
+ * Values that rise less than this above the baseline are also used to update it.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef NRF_CSENSE_WAKE_THRESHOLD
+#define NRF_CSENSE_WAKE_THRESHOLD (2 * NRF_CSENSE_PAD_HYSTERESIS)
+#endif
+
 /**
  * @brief Macro for returning the address of a variable.
  */
@@ -298,6 +329,25 @@ ret_code_t nrf_csense_disable(nrf_csense_instance_t * const p_instance);
  */
 ret_code_t nrf_csense_ticks_set(uint32_t ticks);
 
+/**
+ * @brief Function for configuring the idle scan.
+ *
+ * After @p active_scans measurements of all pads without any instance being touched, only the
+ * analog channels in @p idle_channels_mask are measured, every @p idle_ticks. When one of them
+ * rises more than @ref NRF_CSENSE_WAKE_THRESHOLD above its baseline, all pads are measured again
+ * at the interval set by @ref nrf_csense_ticks_set.
+ *
+ * @param [in] idle_channels_mask                   Mask of analog channels measured while idle. 0 disables the idle scan.
+ * @param [in] idle_ticks                           Time between conversions while idle, in app_timer ticks.
+ * @param [in] active_scans                         Number of measurements of all pads without a touch before going idle.
+ *
+ * @retval NRF_ERROR_BUSY                           If the capacitive sensor was busy.
+ * @retval NRF_ERROR_INVALID_PARAM                  If @p idle_ticks or @p active_scans was 0 while the idle scan was enabled.
+ * @retval NRF_ERROR_INVALID_STATE                  If app_timer was in invalid state.
+ * @retval NRF_SUCCESS                              If the idle scan was configured successfully.
+ */
+ret_code_t nrf_csense_idle_scan_set(uint8_t idle_channels_mask, uint32_t idle_ticks, uint16_t active_scans);
+
 /**
  * @brief Function for setting steps of an instance.
  *
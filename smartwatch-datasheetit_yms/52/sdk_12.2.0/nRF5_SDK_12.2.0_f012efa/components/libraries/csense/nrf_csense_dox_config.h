@@ -52,6 +52,22 @@
 #define NRF_CSENSE_MAX_VALUE
 
 
+/** @brief Number of right shifts used as the weight of a new measurement in the baseline filter.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_CSENSE_BASELINE_IIR_SHIFT
+
+
+/** @brief Minimal rise above the baseline to decide that an idle channel was touched.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_CSENSE_WAKE_THRESHOLD
+
+
 /** @brief Output pin used by lower module.
  *
  * This is only used when running on NRF51.
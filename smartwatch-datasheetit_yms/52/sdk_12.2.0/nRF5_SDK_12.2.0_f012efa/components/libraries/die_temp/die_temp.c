@@ -0,0 +1,221 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(DIE_TEMP)
+#include "die_temp.h"
+#include <stdlib.h>
+#include <string.h>
+#include "nrf.h"
+#include "nrf_temp.h"
+#include "app_scheduler.h"
+#ifdef SOFTDEVICE_PRESENT
+#include "softdevice_handler.h"
+#include "nrf_soc.h"
+#endif
+
+// Create section "die_temp_clients".
+//lint -esym(526, die_temp_clientsBase) -esym(526, die_temp_clientsLimit)
+NRF_SECTION_VARS_CREATE_SECTION(die_temp_clients, die_temp_client_t const);
+
+// Helper macros for section variables.
+#define CLIENT_SECTION_VARS_GET(i)  NRF_SECTION_VARS_GET((i),                           \
+                                                         die_temp_client_t const,       \
+                                                         die_temp_clients)
+#define CLIENT_SECTION_VARS_COUNT   NRF_SECTION_VARS_COUNT(die_temp_client_t const,     \
+                                                           die_temp_clients)
+
+#define FILTER_FRACTION_BITS    8   /**< Fraction bits of the smoothed value, in quarters of a degree. */
+
+static struct
+{
+    die_temp_timestamp_func_t timestamp_func;
+    int32_t                   filtered;     /**< Smoothed value, in quarters of a degree with FILTER_FRACTION_BITS fraction bits. */
+    uint32_t                  sample_time;  /**< Time stamp of the last sample. */
+    bool                      valid;        /**< True if a sample was taken. */
+    volatile bool             pending;      /**< True from the request of a sample until its result. */
+    volatile int32_t          raw;          /**< Result of the TEMP peripheral, in quarters of a degree. */
+} m_cb;
+
+
+/**@brief Function for converting the smoothed value to hundredths of a degree. */
+static int32_t filtered_to_temp(int32_t filtered)
+{
+    return (filtered * 25) / (1 << FILTER_FRACTION_BITS);
+}
+
+
+/**@brief Function for adding a sample to the smoothed value and calling the clients. */
+static void sample_process(int32_t raw)
+{
+    int32_t sample = raw * (1 << FILTER_FRACTION_BITS);
+    int32_t temp;
+
+    if (m_cb.valid)
+    {
+        m_cb.filtered += (sample - m_cb.filtered) / (1 << DIE_TEMP_CONFIG_FILTER_SHIFT);
+    }
+    else
+    {
+        m_cb.filtered = sample;
+        m_cb.valid    = true;
+    }
+    if (m_cb.timestamp_func != NULL)
+    {
+        m_cb.sample_time = m_cb.timestamp_func();
+    }
+    m_cb.pending = false;
+
+    temp = filtered_to_temp(m_cb.filtered);
+
+    for (uint32_t i = 0; i < CLIENT_SECTION_VARS_COUNT; i++)
+    {
+        die_temp_client_t const * p_client = CLIENT_SECTION_VARS_GET(i);
+
+        if ((*p_client->p_temp == DIE_TEMP_INVALID) ||
+            ((uint32_t)abs(temp - *p_client->p_temp) >= p_client->threshold))
+        {
+            *p_client->p_temp = temp;
+            p_client->handler(temp);
+        }
+    }
+}
+
+
+/**@brief Scheduler handler for the result of the TEMP peripheral. */
+static void sample_done_handler(void * p_event_data, uint16_t event_size)
+{
+    UNUSED_PARAMETER(p_event_data);
+    UNUSED_PARAMETER(event_size);
+
+    sample_process(m_cb.raw);
+}
+
+
+void TEMP_IRQHandler(void)
+{
+    NRF_TEMP->EVENTS_DATARDY = 0;
+    NRF_TEMP->INTENCLR       = TEMP_INTENCLR_DATARDY_Msk;
+    m_cb.raw                 = nrf_temp_read();
+    NRF_TEMP->TASKS_STOP     = 1;
+
+    if (app_sched_event_put(NULL, 0, sample_done_handler) != NRF_SUCCESS)
+    {
+        // The next request samples again.
+        m_cb.pending = false;
+    }
+}
+
+
+/**@brief Scheduler handler that takes a sample, in the main loop. */
+static void sample_start_handler(void * p_event_data, uint16_t event_size)
+{
+    UNUSED_PARAMETER(p_event_data);
+    UNUSED_PARAMETER(event_size);
+
+#ifdef SOFTDEVICE_PRESENT
+    if (softdevice_handler_is_enabled())
+    {
+        int32_t raw;
+
+        // The TEMP peripheral belongs to the SoftDevice, which measures and waits.
+        if (sd_temp_get(&raw) == NRF_SUCCESS)
+        {
+            sample_process(raw);
+        }
+        else
+        {
+            m_cb.pending = false;
+        }
+        return;
+    }
+#endif
+
+    nrf_temp_init();
+    NRF_TEMP->EVENTS_DATARDY = 0;
+    NRF_TEMP->INTENSET       = TEMP_INTENSET_DATARDY_Msk;
+    NVIC_ClearPendingIRQ(TEMP_IRQn);
+    NVIC_SetPriority(TEMP_IRQn, DIE_TEMP_CONFIG_IRQ_PRIORITY);
+    NVIC_EnableIRQ(TEMP_IRQn);
+    NRF_TEMP->TASKS_START    = 1;
+}
+
+
+ret_code_t die_temp_sample_request(void)
+{
+    ret_code_t err_code;
+    bool       start;
+
+    CRITICAL_REGION_ENTER();
+    start        = !m_cb.pending;
+    m_cb.pending = true;
+    CRITICAL_REGION_EXIT();
+
+    if (!start)
+    {
+        return NRF_SUCCESS;
+    }
+
+    err_code = app_sched_event_put(NULL, 0, sample_start_handler);
+    if (err_code != NRF_SUCCESS)
+    {
+        m_cb.pending = false;
+    }
+    return err_code;
+}
+
+
+void die_temp_refresh(void)
+{
+    if (m_cb.pending || (m_cb.timestamp_func == NULL))
+    {
+        return;
+    }
+
+    if (!m_cb.valid || ((m_cb.timestamp_func() - m_cb.sample_time) >= DIE_TEMP_CONFIG_MAX_AGE_MS))
+    {
+        (void)die_temp_sample_request();
+    }
+}
+
+
+ret_code_t die_temp_get(int32_t * p_temp)
+{
+    VERIFY_PARAM_NOT_NULL(p_temp);
+
+    die_temp_refresh();
+
+    if (!m_cb.valid)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    *p_temp = filtered_to_temp(m_cb.filtered);
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t die_temp_init(die_temp_timestamp_func_t timestamp_func)
+{
+    memset(&m_cb, 0, sizeof(m_cb));
+    m_cb.timestamp_func = timestamp_func;
+
+    for (uint32_t i = 0; i < CLIENT_SECTION_VARS_COUNT; i++)
+    {
+        die_temp_client_t const * p_client = CLIENT_SECTION_VARS_GET(i);
+
+        *p_client->p_temp = DIE_TEMP_INVALID;
+    }
+
+    return die_temp_sample_request();
+}
+
+#endif // NRF_MODULE_ENABLED(DIE_TEMP)
@@ -0,0 +1,165 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup die_temp Die temperature
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for keeping a smoothed die temperature, sampled when the CPU is awake anyway.
+ *
+ * @details A measurement of the TEMP peripheral takes about 36 us, and much longer through
+ *          @ref sd_temp_get when the radio is busy. Instead of measuring when a value is needed,
+ *          this module keeps the last value, smoothed with a fixed-point first order filter, and
+ *          returns it at once with @ref die_temp_get.
+ *
+ *          A sample is taken through @ref app_scheduler, so it runs in the main loop when the
+ *          CPU is awake for other work. It is requested when the value is older than
+ *          @ref DIE_TEMP_CONFIG_MAX_AGE_MS, by @ref die_temp_get or by @ref die_temp_refresh in
+ *          the main loop. Without the SoftDevice, the TEMP peripheral is started and its
+ *          interrupt gives the result, so no code waits for it. With the SoftDevice,
+ *          @ref sd_temp_get is called from the scheduler.
+ *
+ *          Clients that depend on the temperature register with @ref DIE_TEMP_CLIENT_REGISTER,
+ *          and are called when the temperature has changed by their threshold since they were
+ *          last called. The LFRC calibration of @ref nrf_drv_clock is such a client: the clock
+ *          is calibrated when the temperature changes instead of at a fixed interval.
+ *
+ *          Temperatures are in hundredths of a degree Celsius. The resolution of the sensor is
+ *          0.25 degrees.
+ *
+ * @note The application must have initialized @ref app_scheduler, and must call
+ *       @ref app_sched_execute in its main loop.
+ */
+
+#ifndef DIE_TEMP_H__
+#define DIE_TEMP_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+#include "sdk_config.h"
+#include "section_vars.h"
+#include "app_util_platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Age after which the temperature is sampled again, in milliseconds.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef DIE_TEMP_CONFIG_MAX_AGE_MS
+#define DIE_TEMP_CONFIG_MAX_AGE_MS 10000
+#endif
+
+/** @brief Weight of a new sample in the smoothed value, as a shift: 1/2^shift.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef DIE_TEMP_CONFIG_FILTER_SHIFT
+#define DIE_TEMP_CONFIG_FILTER_SHIFT 2
+#endif
+
+/** @brief Priority of the TEMP interrupt, when the SoftDevice is not enabled.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef DIE_TEMP_CONFIG_IRQ_PRIORITY
+#define DIE_TEMP_CONFIG_IRQ_PRIORITY APP_IRQ_PRIORITY_LOWEST
+#endif
+
+#define DIE_TEMP_INVALID INT32_MIN /**< Temperature of a client that was never called. */
+
+/**@brief Time stamp function, in milliseconds. */
+typedef uint32_t (* die_temp_timestamp_func_t)(void);
+
+/**@brief Client handler, called from the main loop.
+ *
+ * @param[in] temp Smoothed temperature, in hundredths of a degree.
+ */
+typedef void (* die_temp_handler_t)(int32_t temp);
+
+/**@brief Client. Use @ref DIE_TEMP_CLIENT_REGISTER to define one. */
+typedef struct
+{
+    die_temp_handler_t handler;   /**< Handler. */
+    int32_t          * p_temp;    /**< Temperature at the last call of the handler. */
+    uint32_t           threshold; /**< Change of temperature that calls the handler, in hundredths of a degree. */
+} die_temp_client_t;
+
+/**@brief Macro for registering a client.
+ *
+ * @details The handler is called with the first sample, and then every time the temperature
+ *          has changed by @p _threshold since the previous call.
+ *
+ * @param[in] _name      Name of the client.
+ * @param[in] _threshold Change of temperature, in hundredths of a degree.
+ * @param[in] _handler   Handler, of type @ref die_temp_handler_t.
+ */
+#define DIE_TEMP_CLIENT_REGISTER(_name, _threshold, _handler)                                     \
+    static int32_t _name##_temp = DIE_TEMP_INVALID;                                               \
+    NRF_SECTION_VARS_REGISTER_VAR(die_temp_clients, die_temp_client_t const _name) =              \
+    {                                                                                             \
+        .handler   = (_handler),                                                                  \
+        .p_temp    = &_name##_temp,                                                               \
+        .threshold = (_threshold),                                                                \
+    }
+
+/**@brief Function for initializing the module and requesting the first sample.
+ *
+ * @param[in] timestamp_func Time stamp function, or NULL. Without it, samples are only taken
+ *                           on @ref die_temp_sample_request.
+ *
+ * @retval NRF_SUCCESS    If the first sample was requested.
+ * @return Any error returned by @ref app_sched_event_put.
+ */
+ret_code_t die_temp_init(die_temp_timestamp_func_t timestamp_func);
+
+/**@brief Function for getting the smoothed temperature, without waiting.
+ *
+ * @details A new sample is requested if the value is older than @ref DIE_TEMP_CONFIG_MAX_AGE_MS.
+ *
+ * @param[out] p_temp Temperature, in hundredths of a degree.
+ *
+ * @retval NRF_SUCCESS             If the temperature was returned.
+ * @retval NRF_ERROR_NULL          If p_temp was NULL.
+ * @retval NRF_ERROR_INVALID_STATE If no sample was taken yet.
+ */
+ret_code_t die_temp_get(int32_t * p_temp);
+
+/**@brief Function for requesting a sample if the value is older than
+ *        @ref DIE_TEMP_CONFIG_MAX_AGE_MS.
+ *
+ * @details Call it in the main loop, before sleeping. It costs a time stamp when the value is
+ *          recent.
+ */
+void die_temp_refresh(void);
+
+/**@brief Function for requesting a sample, whatever the age of the value.
+ *
+ * @details The sample is taken, and the clients called, from the scheduler. A request while
+ *          one is in progress is merged with it.
+ *
+ * @retval NRF_SUCCESS If the sample was requested.
+ * @return Any error returned by @ref app_sched_event_put.
+ */
+ret_code_t die_temp_sample_request(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DIE_TEMP_H__
+
+/** @} */
@@ -0,0 +1,40 @@
+/**
+ *
+ * @defgroup die_temp_config Die temperature configuration
+ * @{
+ * @ingroup die_temp
+ */
+/** @brief Enabling the die temperature module
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define DIE_TEMP_ENABLED
+
+
+/** @brief Age after which the temperature is sampled again, in milliseconds
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define DIE_TEMP_CONFIG_MAX_AGE_MS
+
+
+/** @brief Weight of a new sample in the smoothed value, as a shift
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define DIE_TEMP_CONFIG_FILTER_SHIFT
+
+
+/** @brief Priority of the TEMP interrupt, without the SoftDevice
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define DIE_TEMP_CONFIG_IRQ_PRIORITY
+
+
+/** @} */
@@ -0,0 +1,302 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(DSP_PIPELINE)
+#include "dsp_pipeline.h"
+#include <string.h>
+#include "nrf_assert.h"
+
+#define NO_PEAK UINT32_MAX  /**< Value of last_peak before the first peak. */
+
+
+static ret_code_t stage_init(dsp_pipeline_stage_t * p_stage, uint16_t block_size)
+{
+    switch (p_stage->type)
+    {
+        case DSP_PIPELINE_STAGE_DC_REMOVE:
+        {
+            dsp_pipeline_dc_remove_t * p_dc = &p_stage->params.dc_remove;
+            if ((p_dc->input_shift > 15) || (p_dc->smoothing > 15))
+            {
+                return NRF_ERROR_INVALID_PARAM;
+            }
+            p_dc->dc = 0;
+            break;
+        }
+
+        case DSP_PIPELINE_STAGE_BIQUAD:
+        {
+            dsp_pipeline_biquad_t * p_iir = &p_stage->params.biquad;
+            VERIFY_PARAM_NOT_NULL(p_iir->p_coeffs);
+            VERIFY_PARAM_NOT_NULL(p_iir->p_state);
+            if (p_iir->num_stages == 0)
+            {
+                return NRF_ERROR_INVALID_PARAM;
+            }
+            arm_biquad_cascade_df1_init_q15(&p_iir->instance,
+                                            p_iir->num_stages,
+                                            (q15_t *)p_iir->p_coeffs,
+                                            p_iir->p_state,
+                                            p_iir->post_shift);
+            break;
+        }
+
+        case DSP_PIPELINE_STAGE_FIR_DECIMATE:
+        {
+            dsp_pipeline_fir_decimate_t * p_fir = &p_stage->params.fir_decimate;
+            VERIFY_PARAM_NOT_NULL(p_fir->p_coeffs);
+            VERIFY_PARAM_NOT_NULL(p_fir->p_state);
+            if ((p_fir->factor == 0) ||
+                (arm_fir_decimate_init_q15(&p_fir->instance,
+                                           p_fir->num_taps,
+                                           p_fir->factor,
+                                           (q15_t *)p_fir->p_coeffs,
+                                           p_fir->p_state,
+                                           block_size) != ARM_MATH_SUCCESS))
+            {
+                return NRF_ERROR_INVALID_PARAM;
+            }
+            break;
+        }
+
+        case DSP_PIPELINE_STAGE_SPECTRUM:
+        {
+            dsp_pipeline_spectrum_t * p_spec = &p_stage->params.spectrum;
+            VERIFY_PARAM_NOT_NULL(p_spec->p_frame);
+            VERIFY_PARAM_NOT_NULL(p_spec->p_work);
+            VERIFY_PARAM_NOT_NULL(p_spec->handler);
+            if ((p_spec->hop == 0) || (p_spec->hop > p_spec->fft_len) ||
+                (arm_rfft_init_q15(&p_spec->instance, p_spec->fft_len, 0, 1) != ARM_MATH_SUCCESS))
+            {
+                return NRF_ERROR_INVALID_PARAM;
+            }
+            memset(p_spec->p_frame, 0, p_spec->fft_len * sizeof(q15_t));
+            p_spec->fill = 0;
+            break;
+        }
+
+        case DSP_PIPELINE_STAGE_PEAK:
+        {
+            dsp_pipeline_peak_t * p_peak = &p_stage->params.peak;
+            VERIFY_PARAM_NOT_NULL(p_peak->handler);
+            p_peak->prev[0]   = INT16_MIN;
+            p_peak->prev[1]   = INT16_MIN;
+            p_peak->index     = 0;
+            p_peak->last_peak = NO_PEAK;
+            break;
+        }
+
+        default:
+            return NRF_ERROR_INVALID_PARAM;
+    }
+    return NRF_SUCCESS;
+}
+
+
+static void dc_remove_process(dsp_pipeline_dc_remove_t * p_dc,
+                              q15_t const              * p_src,
+                              q15_t                    * p_dst,
+                              uint16_t                   count)
+{
+    q15_t mean;
+
+    arm_shift_q15((q15_t *)p_src, p_dc->input_shift, p_dst, count);
+    arm_mean_q15(p_dst, count, &mean);
+
+    if (p_dc->smoothing == 0)
+    {
+        p_dc->dc = (q31_t)mean << 16;
+    }
+    else
+    {
+        p_dc->dc += (((q31_t)mean << 16) - p_dc->dc) >> p_dc->smoothing;
+    }
+
+    arm_offset_q15(p_dst, (q15_t)__SSAT(-(p_dc->dc >> 16), 16), p_dst, count);
+}
+
+
+static void spectrum_process(dsp_pipeline_spectrum_t * p_spec, q15_t const * p_src, uint16_t count)
+{
+    while (count > 0)
+    {
+        uint16_t take = MIN(count, p_spec->hop - p_spec->fill);
+
+        memmove(p_spec->p_frame,
+                p_spec->p_frame + take,
+                (p_spec->fft_len - take) * sizeof(q15_t));
+        memcpy(p_spec->p_frame + p_spec->fft_len - take, p_src, take * sizeof(q15_t));
+
+        p_src          += take;
+        count          -= take;
+        p_spec->fill   += take;
+
+        if (p_spec->fill == p_spec->hop)
+        {
+            q15_t * p_in  = p_spec->p_work;
+            q15_t * p_out = p_spec->p_work + p_spec->fft_len;
+
+            // arm_rfft_q15 modifies its input, so the frame is windowed into the work buffer.
+            if (p_spec->p_window != NULL)
+            {
+                arm_mult_q15(p_spec->p_frame, (q15_t *)p_spec->p_window, p_in, p_spec->fft_len);
+            }
+            else
+            {
+                arm_copy_q15(p_spec->p_frame, p_in, p_spec->fft_len);
+            }
+            arm_rfft_q15(&p_spec->instance, p_in, p_out);
+            arm_cmplx_mag_q15(p_out, p_in, p_spec->fft_len / 2);
+
+            p_spec->handler(p_in, p_spec->fft_len / 2, p_spec->p_context);
+            p_spec->fill = 0;
+        }
+    }
+}
+
+
+static void peak_process(dsp_pipeline_peak_t * p_peak, q15_t const * p_src, uint16_t count)
+{
+    for (uint16_t i = 0; i < count; i++)
+    {
+        // The previous sample is a peak if it is higher than its neighbours.
+        q15_t    candidate = p_peak->prev[1];
+        uint32_t index     = p_peak->index - 1;
+
+        if ((candidate >= p_peak->threshold) &&
+            (candidate >  p_peak->prev[0])   &&
+            (candidate >= p_src[i])          &&
+            ((p_peak->last_peak == NO_PEAK) || (index - p_peak->last_peak >= p_peak->min_distance)))
+        {
+            p_peak->last_peak = index;
+            p_peak->handler(index, candidate, p_peak->p_context);
+        }
+
+        p_peak->prev[0] = p_peak->prev[1];
+        p_peak->prev[1] = p_src[i];
+        p_peak->index++;
+    }
+}
+
+
+ret_code_t dsp_pipeline_init(dsp_pipeline_t * p_pipeline)
+{
+    ret_code_t err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_pipeline);
+    VERIFY_PARAM_NOT_NULL(p_pipeline->p_stages);
+    VERIFY_PARAM_NOT_NULL(p_pipeline->p_scratch);
+
+    uint16_t block_size = p_pipeline->block_size;
+
+    for (uint8_t i = 0; i < p_pipeline->stage_count; i++)
+    {
+        dsp_pipeline_stage_t * p_stage = &p_pipeline->p_stages[i];
+
+        err_code = stage_init(p_stage, block_size);
+        VERIFY_SUCCESS(err_code);
+
+        if (p_stage->type == DSP_PIPELINE_STAGE_FIR_DECIMATE)
+        {
+            block_size /= p_stage->params.fir_decimate.factor;
+        }
+    }
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t dsp_pipeline_process(dsp_pipeline_t * p_pipeline, q15_t const * p_samples, uint16_t count)
+{
+    q15_t const * p_cur = p_samples;
+    uint16_t      n     = count;
+
+    if (count > p_pipeline->block_size)
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+    for (uint8_t i = 0; i < p_pipeline->stage_count; i++)
+    {
+        if (p_pipeline->p_stages[i].type == DSP_PIPELINE_STAGE_FIR_DECIMATE)
+        {
+            uint8_t factor = p_pipeline->p_stages[i].params.fir_decimate.factor;
+            if ((n % factor) != 0)
+            {
+                return NRF_ERROR_INVALID_LENGTH;
+            }
+            n /= factor;
+        }
+    }
+
+    n = count;
+    for (uint8_t i = 0; i < p_pipeline->stage_count; i++)
+    {
+        dsp_pipeline_stage_t * p_stage = &p_pipeline->p_stages[i];
+        // Stages that change the samples write to the half of the scratch buffer not being read.
+        q15_t * p_out = (p_cur == p_pipeline->p_scratch) ?
+                        (p_pipeline->p_scratch + p_pipeline->block_size) : p_pipeline->p_scratch;
+
+        switch (p_stage->type)
+        {
+            case DSP_PIPELINE_STAGE_DC_REMOVE:
+                dc_remove_process(&p_stage->params.dc_remove, p_cur, p_out, n);
+                p_cur = p_out;
+                break;
+
+            case DSP_PIPELINE_STAGE_BIQUAD:
+                arm_biquad_cascade_df1_q15(&p_stage->params.biquad.instance, (q15_t *)p_cur, p_out, n);
+                p_cur = p_out;
+                break;
+
+            case DSP_PIPELINE_STAGE_FIR_DECIMATE:
+                arm_fir_decimate_q15(&p_stage->params.fir_decimate.instance, (q15_t *)p_cur, p_out, n);
+                p_cur = p_out;
+                n    /= p_stage->params.fir_decimate.factor;
+                break;
+
+            case DSP_PIPELINE_STAGE_SPECTRUM:
+                spectrum_process(&p_stage->params.spectrum, p_cur, n);
+                break;
+
+            case DSP_PIPELINE_STAGE_PEAK:
+                peak_process(&p_stage->params.peak, p_cur, n);
+                break;
+
+            default:
+                ASSERT(false);
+                break;
+        }
+    }
+
+    if (p_pipeline->handler != NULL)
+    {
+        p_pipeline->handler(p_cur, n, p_pipeline->p_context);
+    }
+    return NRF_SUCCESS;
+}
+
+
+uint16_t dsp_pipeline_spectrum_peak(q15_t const * p_mag, uint16_t first, uint16_t count, q15_t * p_value)
+{
+    q15_t    value;
+    uint32_t index;
+
+    ASSERT(count > 0);
+    arm_max_q15((q15_t *)(p_mag + first), count, &value, &index);
+
+    if (p_value != NULL)
+    {
+        *p_value = value;
+    }
+    return (uint16_t)(first + index);
+}
+
+#endif //NRF_MODULE_ENABLED(DSP_PIPELINE)
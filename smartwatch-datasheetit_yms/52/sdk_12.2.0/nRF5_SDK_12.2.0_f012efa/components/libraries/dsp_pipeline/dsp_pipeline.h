@@ -0,0 +1,214 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup dsp_pipeline DSP pipeline
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for processing blocks of q15 samples through a chain of CMSIS-DSP stages.
+ *
+ * @details A pipeline is an array of stages that every block passes through in order:
+ *          - DC removal: the block mean, smoothed over blocks, is subtracted.
+ *          - Biquad IIR: a cascade of second order sections (arm_biquad_cascade_df1_q15).
+ *          - FIR decimation: a lowpass FIR followed by downsampling (arm_fir_decimate_q15).
+ *          - Spectrum: overlapping frames of the signal are windowed and transformed
+ *            (arm_rfft_q15), and the magnitude of the bins is passed to a handler.
+ *          - Peak detection: local maxima over a threshold, at a minimum distance, are passed to a
+ *            handler with their sample index.
+ *
+ *          Spectrum and peak stages do not change the samples, so they can be followed by more
+ *          stages. The state of all stages is kept between blocks, so a signal can be processed in
+ *          blocks of any size up to the block size of the pipeline.
+ *
+ *          The blocks of @ref hw_sampler with 16-bit little-endian samples, and the buffers of the
+ *          SAADC driver, can be passed directly. SAADC results can be scaled to the q15 range with
+ *          the input shift of a DC removal stage.
+ *
+ * @note The module needs the CMSIS-DSP library of the core, for example libarm_cortexM4lf_math.a
+ *       with ARM_MATH_CM4 defined.
+ */
+
+#ifndef DSP_PIPELINE_H__
+#define DSP_PIPELINE_H__
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**@brief Stage types. */
+typedef enum
+{
+    DSP_PIPELINE_STAGE_DC_REMOVE,    /**< DC removal. */
+    DSP_PIPELINE_STAGE_BIQUAD,       /**< Biquad IIR filter. */
+    DSP_PIPELINE_STAGE_FIR_DECIMATE, /**< FIR decimation. */
+    DSP_PIPELINE_STAGE_SPECTRUM,     /**< Magnitude spectrum of overlapping frames. */
+    DSP_PIPELINE_STAGE_PEAK,         /**< Peak detection. */
+} dsp_pipeline_stage_type_t;
+
+/**@brief Handler for the magnitude spectrum of a frame.
+ *
+ * @param[in] p_mag     Magnitude of the bins 0 to fft_len / 2 - 1, in the format of arm_cmplx_mag_q15
+ *                      applied to the scaled output of arm_rfft_q15.
+ * @param[in] bins      Number of bins.
+ * @param[in] p_context User context.
+ */
+typedef void (* dsp_pipeline_spectrum_handler_t)(q15_t const * p_mag, uint16_t bins, void * p_context);
+
+/**@brief Handler for a detected peak.
+ *
+ * @param[in] index     Index of the peak sample, counted at the input of the stage since the
+ *                      pipeline was initialized.
+ * @param[in] value     Value of the peak sample.
+ * @param[in] p_context User context.
+ */
+typedef void (* dsp_pipeline_peak_handler_t)(uint32_t index, q15_t value, void * p_context);
+
+/**@brief Handler for the output of the last stage.
+ *
+ * @param[in] p_samples Output samples.
+ * @param[in] count     Number of output samples.
+ * @param[in] p_context User context.
+ */
+typedef void (* dsp_pipeline_output_handler_t)(q15_t const * p_samples, uint16_t count, void * p_context);
+
+/**@brief DC removal stage. */
+typedef struct
+{
+    uint8_t  input_shift;    /**< Left shift applied to the input first, with saturation. */
+    uint8_t  smoothing;      /**< The DC estimate moves by 1 / 2^smoothing of the difference to the block mean. 0 uses the block mean. */
+    q31_t    dc;             /**< Private: DC estimate, in q15 scaled by 2^16. */
+} dsp_pipeline_dc_remove_t;
+
+/**@brief Biquad IIR stage. */
+typedef struct
+{
+    uint8_t                      num_stages; /**< Number of second order sections. */
+    q15_t const                * p_coeffs;   /**< 6 coefficients per section: b0, 0, b1, b2, a1, a2, see arm_biquad_cascade_df1_init_q15. */
+    q15_t                      * p_state;    /**< State buffer of 4 * num_stages samples. */
+    int8_t                       post_shift; /**< Shift of the coefficient format, see arm_biquad_cascade_df1_init_q15. */
+    arm_biquad_casd_df1_inst_q15 instance;   /**< Private: CMSIS instance. */
+} dsp_pipeline_biquad_t;
+
+/**@brief FIR decimation stage. */
+typedef struct
+{
+    uint16_t                        num_taps; /**< Number of FIR taps. */
+    uint8_t                         factor;   /**< Decimation factor. The block lengths must be multiples of it. */
+    q15_t const                   * p_coeffs; /**< FIR coefficients, in reversed time order. */
+    q15_t                         * p_state;  /**< State buffer of num_taps + block_size - 1 samples. */
+    arm_fir_decimate_instance_q15   instance; /**< Private: CMSIS instance. */
+} dsp_pipeline_fir_decimate_t;
+
+/**@brief Spectrum stage. */
+typedef struct
+{
+    uint16_t                        fft_len;   /**< Frame length, a power of two from 32 to 4096. */
+    uint16_t                        hop;       /**< New samples between two frames, at most fft_len. */
+    q15_t const                   * p_window;  /**< Window of fft_len samples, or NULL for no window. */
+    q15_t                         * p_frame;   /**< Buffer of fft_len samples with the last frame. */
+    q15_t                         * p_work;    /**< Buffer of 3 * fft_len samples used by the FFT. */
+    dsp_pipeline_spectrum_handler_t handler;   /**< Handler for the spectrum of each frame. */
+    void                          * p_context; /**< Context passed to the handler. */
+    uint16_t                        fill;      /**< Private: new samples in the frame. */
+    arm_rfft_instance_q15           instance;  /**< Private: CMSIS instance. */
+} dsp_pipeline_spectrum_t;
+
+/**@brief Peak detection stage. */
+typedef struct
+{
+    q15_t                       threshold;    /**< Lowest value of a peak. */
+    uint16_t                    min_distance; /**< Lowest number of samples between two peaks. */
+    dsp_pipeline_peak_handler_t handler;      /**< Handler for each peak. */
+    void                      * p_context;    /**< Context passed to the handler. */
+    q15_t                       prev[2];      /**< Private: last two samples of the previous block. */
+    uint32_t                    index;        /**< Private: index of the next sample. */
+    uint32_t                    last_peak;    /**< Private: index of the last peak. */
+} dsp_pipeline_peak_t;
+
+/**@brief Stage of a pipeline. The public fields of the stage type are set by the user. */
+typedef struct
+{
+    dsp_pipeline_stage_type_t type;           /**< Stage type. */
+    union
+    {
+        dsp_pipeline_dc_remove_t    dc_remove;
+        dsp_pipeline_biquad_t       biquad;
+        dsp_pipeline_fir_decimate_t fir_decimate;
+        dsp_pipeline_spectrum_t     spectrum;
+        dsp_pipeline_peak_t         peak;
+    } params;                                 /**< Parameters and state of the stage. */
+} dsp_pipeline_stage_t;
+
+/**@brief Pipeline. */
+typedef struct
+{
+    dsp_pipeline_stage_t        * p_stages;    /**< Stages, in processing order. */
+    uint8_t                       stage_count; /**< Number of stages. */
+    uint16_t                      block_size;  /**< Largest number of input samples in a block. */
+    q15_t                       * p_scratch;   /**< Buffer of 2 * block_size samples. */
+    dsp_pipeline_output_handler_t handler;     /**< Handler for the output of the last stage, or NULL. */
+    void                        * p_context;   /**< Context passed to the output handler. */
+} dsp_pipeline_t;
+
+
+/**@brief Function for initializing a pipeline and the state of its stages.
+ *
+ * @param[in,out] p_pipeline Pipeline, with its stages filled in. It must be kept in memory.
+ *
+ * @retval NRF_SUCCESS             If the pipeline was initialized.
+ * @retval NRF_ERROR_NULL          If a required buffer or handler was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If a parameter of a stage was invalid.
+ */
+ret_code_t dsp_pipeline_init(dsp_pipeline_t * p_pipeline);
+
+
+/**@brief Function for processing a block of samples.
+ *
+ * The handlers of the stages and the output handler are called from this function.
+ *
+ * @param[in,out] p_pipeline Pipeline.
+ * @param[in]     p_samples  Input samples. They are not modified.
+ * @param[in]     count      Number of samples, at most the block size.
+ *
+ * @retval NRF_SUCCESS              If the block was processed.
+ * @retval NRF_ERROR_INVALID_LENGTH If the length was larger than the block size, or was not a
+ *                                  multiple of the decimation factors.
+ */
+ret_code_t dsp_pipeline_process(dsp_pipeline_t * p_pipeline, q15_t const * p_samples, uint16_t count);
+
+
+/**@brief Function for finding the largest bin of a spectrum in a range.
+ *
+ * For example the heart rate in a PPG spectrum, between the bins of 0.5 Hz and 4 Hz.
+ *
+ * @param[in]  p_mag    Magnitude spectrum, as passed to @ref dsp_pipeline_spectrum_handler_t.
+ * @param[in]  first    First bin of the range.
+ * @param[in]  count    Number of bins in the range.
+ * @param[out] p_value  Magnitude of the largest bin. Can be NULL.
+ *
+ * @return Index of the largest bin.
+ */
+uint16_t dsp_pipeline_spectrum_peak(q15_t const * p_mag, uint16_t first, uint16_t count, q15_t * p_value);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DSP_PIPELINE_H__
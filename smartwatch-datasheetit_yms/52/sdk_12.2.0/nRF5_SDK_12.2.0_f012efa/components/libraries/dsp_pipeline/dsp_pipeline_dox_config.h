@@ -0,0 +1,16 @@
+/**
+ *
+ * @defgroup dsp_pipeline_config dsp_pipeline module configuration
+ * @{
+ * @ingroup dsp_pipeline
+ */
+/** @brief Enabling dsp_pipeline module
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define DSP_PIPELINE_ENABLED
+
+
+/** @} */
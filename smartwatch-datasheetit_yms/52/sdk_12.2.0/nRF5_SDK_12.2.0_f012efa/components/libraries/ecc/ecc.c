@@ -21,12 +21,30 @@
 #include "nrf_log.h"
 #include "nrf_drv_rng.h"
 #include "ecc.h"
+#if NRF_MODULE_ENABLED(ENTROPY_POOL)
+#include "entropy_pool.h"
+#endif
 
 #include "uECC.h"
+#include "uECC_vli.h"
+
+STATIC_ASSERT(sizeof(uECC_word_t) == sizeof(uint32_t));
+
+#define SS_BIT_FIRST    (255)   /**< First bit of the scalar processed by the ladder. The bit above it is always 1, see @ref scalar_regularize. */
+#define SS_BIT_LAST     (0)     /**< Last bit of the scalar, processed together with the final inversion. */
+#define SS_BIT_IDLE     (-1)    /**< No computation is ongoing. */
 
 
 static int ecc_rng(uint8_t *dest, unsigned size)
 {
+#if NRF_MODULE_ENABLED(ENTROPY_POOL)
+    // The RNG is waited for only if the pool and the generator have nothing.
+    if ((entropy_pool_get(dest, (uint16_t)size) == NRF_SUCCESS) ||
+        (entropy_pool_drbg_get(dest, (uint32_t)size) == NRF_SUCCESS))
+    {
+        return 1;
+    }
+#endif
     nrf_drv_rng_block_rand(dest, (uint32_t) size);
     return 1;
 }
@@ -118,6 +136,262 @@ ret_code_t ecc_p256_shared_secret_compute(uint8_t const *p_le_sk, uint8_t const
     return NRF_SUCCESS;
 }
 
+/* The functions below are the co-Z Montgomery ladder of micro-ecc (EccPoint_mult() in uECC.c),
+ * written with the VLI API of the library so that it can be stopped between two bits. */
+
+/**@brief Multiply a point by Z in Jacobian coordinates: X = X * Z^2, Y = Y * Z^3. */
+static void apply_z(uECC_word_t * p_x, uECC_word_t * p_y, uECC_word_t const * p_z, uECC_Curve curve)
+{
+    uECC_word_t t1[ECC_P256_WORDS];
+
+    uECC_vli_modSquare_fast(t1, p_z, curve);
+    uECC_vli_modMult_fast(p_x, p_x, t1, curve);
+    uECC_vli_modMult_fast(t1, t1, p_z, curve);
+    uECC_vli_modMult_fast(p_y, p_y, t1, curve);
+}
+
+
+/**@brief Double a point in Jacobian coordinates, for a curve where a = -3. */
+static void double_jacobian(uECC_word_t * p_x, uECC_word_t * p_y, uECC_word_t * p_z, uECC_Curve curve)
+{
+    uECC_word_t         t4[ECC_P256_WORDS];
+    uECC_word_t         t5[ECC_P256_WORDS];
+    uECC_word_t const * p_p = uECC_curve_p(curve);
+
+    if (uECC_vli_isZero(p_z, ECC_P256_WORDS))
+    {
+        return;
+    }
+
+    uECC_vli_modSquare_fast(t4, p_y, curve);                 // t4 = y1^2
+    uECC_vli_modMult_fast(t5, p_x, t4, curve);               // t5 = x1*y1^2 = A
+    uECC_vli_modSquare_fast(t4, t4, curve);                  // t4 = y1^4
+    uECC_vli_modMult_fast(p_y, p_y, p_z, curve);             // y1 = y1*z1 = z3
+    uECC_vli_modSquare_fast(p_z, p_z, curve);                // z1 = z1^2
+
+    uECC_vli_modAdd(p_x, p_x, p_z, p_p, ECC_P256_WORDS);     // x1 = x1 + z1^2
+    uECC_vli_modAdd(p_z, p_z, p_z, p_p, ECC_P256_WORDS);     // z1 = 2*z1^2
+    uECC_vli_modSub(p_z, p_x, p_z, p_p, ECC_P256_WORDS);     // z1 = x1 - z1^2
+    uECC_vli_modMult_fast(p_x, p_x, p_z, curve);             // x1 = x1^2 - z1^4
+
+    uECC_vli_modAdd(p_z, p_x, p_x, p_p, ECC_P256_WORDS);     // z1 = 2*(x1^2 - z1^4)
+    uECC_vli_modAdd(p_x, p_x, p_z, p_p, ECC_P256_WORDS);     // x1 = 3*(x1^2 - z1^4)
+    if (uECC_vli_testBit(p_x, 0))
+    {
+        uECC_word_t carry = uECC_vli_add(p_x, p_x, p_p, ECC_P256_WORDS);
+        uECC_vli_rshift1(p_x, ECC_P256_WORDS);
+        p_x[ECC_P256_WORDS - 1] |= carry << 31;
+    }
+    else
+    {
+        uECC_vli_rshift1(p_x, ECC_P256_WORDS);
+    }                                                        // x1 = 3/2*(x1^2 - z1^4) = B
+
+    uECC_vli_modSquare_fast(p_z, p_x, curve);                // z1 = B^2
+    uECC_vli_modSub(p_z, p_z, t5, p_p, ECC_P256_WORDS);      // z1 = B^2 - A
+    uECC_vli_modSub(p_z, p_z, t5, p_p, ECC_P256_WORDS);      // z1 = B^2 - 2A = x3
+    uECC_vli_modSub(t5, t5, p_z, p_p, ECC_P256_WORDS);       // t5 = A - x3
+    uECC_vli_modMult_fast(p_x, p_x, t5, curve);              // x1 = B*(A - x3)
+    uECC_vli_modSub(t4, p_x, t4, p_p, ECC_P256_WORDS);       // t4 = B*(A - x3) - y1^4 = y3
+
+    uECC_vli_set(p_x, p_z, ECC_P256_WORDS);
+    uECC_vli_set(p_z, p_y, ECC_P256_WORDS);
+    uECC_vli_set(p_y, t4, ECC_P256_WORDS);
+}
+
+
+/**@brief Co-Z addition: (x2, y2) = P1 + P2, and P1 is given the same Z as the result. */
+static void xycz_add(uECC_word_t * p_x1, uECC_word_t * p_y1,
+                     uECC_word_t * p_x2, uECC_word_t * p_y2,
+                     uECC_Curve    curve)
+{
+    uECC_word_t         t5[ECC_P256_WORDS];
+    uECC_word_t const * p_p = uECC_curve_p(curve);
+
+    uECC_vli_modSub(t5, p_x2, p_x1, p_p, ECC_P256_WORDS);    // t5 = x2 - x1
+    uECC_vli_modSquare_fast(t5, t5, curve);                  // t5 = (x2 - x1)^2 = A
+    uECC_vli_modMult_fast(p_x1, p_x1, t5, curve);            // x1 = x1*A = B
+    uECC_vli_modMult_fast(p_x2, p_x2, t5, curve);            // x2 = x2*A = C
+    uECC_vli_modSub(p_y2, p_y2, p_y1, p_p, ECC_P256_WORDS);  // y2 = y2 - y1
+    uECC_vli_modSquare_fast(t5, p_y2, curve);                // t5 = (y2 - y1)^2 = D
+
+    uECC_vli_modSub(t5, t5, p_x1, p_p, ECC_P256_WORDS);      // t5 = D - B
+    uECC_vli_modSub(t5, t5, p_x2, p_p, ECC_P256_WORDS);      // t5 = D - B - C = x3
+    uECC_vli_modSub(p_x2, p_x2, p_x1, p_p, ECC_P256_WORDS);  // x2 = C - B
+    uECC_vli_modMult_fast(p_y1, p_y1, p_x2, curve);          // y1 = y1*(C - B)
+    uECC_vli_modSub(p_x2, p_x1, t5, p_p, ECC_P256_WORDS);    // x2 = B - x3
+    uECC_vli_modMult_fast(p_y2, p_y2, p_x2, curve);          // y2 = (y2 - y1)*(B - x3)
+    uECC_vli_modSub(p_y2, p_y2, p_y1, p_p, ECC_P256_WORDS);  // y2 = y3
+
+    uECC_vli_set(p_x2, t5, ECC_P256_WORDS);
+}
+
+
+/**@brief Conjugate co-Z addition: (x2, y2) = P1 + P2 and (x1, y1) = P1 - P2, with the same Z. */
+static void xycz_add_c(uECC_word_t * p_x1, uECC_word_t * p_y1,
+                       uECC_word_t * p_x2, uECC_word_t * p_y2,
+                       uECC_Curve    curve)
+{
+    uECC_word_t         t5[ECC_P256_WORDS];
+    uECC_word_t         t6[ECC_P256_WORDS];
+    uECC_word_t         t7[ECC_P256_WORDS];
+    uECC_word_t const * p_p = uECC_curve_p(curve);
+
+    uECC_vli_modSub(t5, p_x2, p_x1, p_p, ECC_P256_WORDS);    // t5 = x2 - x1
+    uECC_vli_modSquare_fast(t5, t5, curve);                  // t5 = (x2 - x1)^2 = A
+    uECC_vli_modMult_fast(p_x1, p_x1, t5, curve);            // x1 = x1*A = B
+    uECC_vli_modMult_fast(p_x2, p_x2, t5, curve);            // x2 = x2*A = C
+    uECC_vli_modAdd(t5, p_y2, p_y1, p_p, ECC_P256_WORDS);    // t5 = y2 + y1
+    uECC_vli_modSub(p_y2, p_y2, p_y1, p_p, ECC_P256_WORDS);  // y2 = y2 - y1
+
+    uECC_vli_modSub(t6, p_x2, p_x1, p_p, ECC_P256_WORDS);    // t6 = C - B
+    uECC_vli_modMult_fast(p_y1, p_y1, t6, curve);            // y1 = y1*(C - B) = E
+    uECC_vli_modAdd(t6, p_x1, p_x2, p_p, ECC_P256_WORDS);    // t6 = B + C
+    uECC_vli_modSquare_fast(p_x2, p_y2, curve);              // x2 = (y2 - y1)^2 = D
+    uECC_vli_modSub(p_x2, p_x2, t6, p_p, ECC_P256_WORDS);    // x2 = D - (B + C) = x3
+
+    uECC_vli_modSub(t7, p_x1, p_x2, p_p, ECC_P256_WORDS);    // t7 = B - x3
+    uECC_vli_modMult_fast(p_y2, p_y2, t7, curve);            // y2 = (y2 - y1)*(B - x3)
+    uECC_vli_modSub(p_y2, p_y2, p_y1, p_p, ECC_P256_WORDS);  // y2 = (y2 - y1)*(B - x3) - E = y3
+
+    uECC_vli_modSquare_fast(t7, t5, curve);                  // t7 = (y2 + y1)^2 = F
+    uECC_vli_modSub(t7, t7, t6, p_p, ECC_P256_WORDS);        // t7 = F - (B + C) = x3'
+    uECC_vli_modSub(t6, t7, p_x1, p_p, ECC_P256_WORDS);      // t6 = x3' - B
+    uECC_vli_modMult_fast(t6, t6, t5, curve);                // t6 = (y2 + y1)*(x3' - B)
+    uECC_vli_modSub(p_y1, t6, p_y1, p_p, ECC_P256_WORDS);    // y1 = (y2 + y1)*(x3' - B) - E = y3'
+
+    uECC_vli_set(p_x1, t7, ECC_P256_WORDS);
+}
+
+
+/**@brief Give the private key a fixed length of 257 bits, by adding the curve order once or twice.
+ *
+ * @details The ladder then takes the same number of steps for every key. Bit 256 of the result is
+ *          1, the ladder starts from it.
+ */
+static void scalar_regularize(uECC_word_t * p_scalar, uECC_word_t const * p_sk, uECC_Curve curve)
+{
+    uECC_word_t         k1[ECC_P256_WORDS];
+    uECC_word_t const * p_n = uECC_curve_n(curve);
+
+    if (uECC_vli_add(p_scalar, p_sk, p_n, ECC_P256_WORDS) == 0)
+    {
+        (void)uECC_vli_add(k1, p_scalar, p_n, ECC_P256_WORDS);
+        uECC_vli_set(p_scalar, k1, ECC_P256_WORDS);
+    }
+}
+
+
+ret_code_t ecc_p256_shared_secret_start(ecc_p256_ss_ctx_t * p_ctx, uint8_t const * p_le_sk, uint8_t const * p_le_pk)
+{
+    uECC_Curve  curve = uECC_secp256r1();
+    uECC_word_t z[ECC_P256_WORDS];
+
+    if (!p_ctx || !p_le_sk || !p_le_pk)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if (!is_word_aligned(p_le_sk) || !is_word_aligned(p_le_pk))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    p_ctx->bit = SS_BIT_IDLE;
+
+    // The keys are little endian, which is the native format of the library.
+    memcpy(p_ctx->point, p_le_pk, ECC_P256_PK_LEN);
+    if (!uECC_valid_point(p_ctx->point, curve))
+    {
+        return NRF_ERROR_INVALID_DATA;
+    }
+
+    scalar_regularize(p_ctx->scalar, (uECC_word_t const *)p_le_sk, curve);
+
+    // A random Z hides the key from side channels, as in uECC_shared_secret().
+    uECC_vli_clear(z, ECC_P256_WORDS);
+    z[0] = 1;
+    if (uECC_get_rng() != NULL)
+    {
+        (void)uECC_generate_random_int(z, uECC_curve_p(curve), ECC_P256_WORDS);
+    }
+
+    // R1 = P and R0 = 2P, with the same Z.
+    uECC_vli_set(p_ctx->rx[1], p_ctx->point, ECC_P256_WORDS);
+    uECC_vli_set(p_ctx->ry[1], p_ctx->point + ECC_P256_WORDS, ECC_P256_WORDS);
+    uECC_vli_set(p_ctx->rx[0], p_ctx->rx[1], ECC_P256_WORDS);
+    uECC_vli_set(p_ctx->ry[0], p_ctx->ry[1], ECC_P256_WORDS);
+
+    apply_z(p_ctx->rx[1], p_ctx->ry[1], z, curve);
+    double_jacobian(p_ctx->rx[1], p_ctx->ry[1], z, curve);
+    apply_z(p_ctx->rx[0], p_ctx->ry[0], z, curve);
+
+    p_ctx->bit = SS_BIT_FIRST;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ecc_p256_shared_secret_continue(ecc_p256_ss_ctx_t * p_ctx, uint32_t n_bits, uint8_t *p_le_ss)
+{
+    uECC_Curve  curve = uECC_secp256r1();
+    uECC_word_t z[ECC_P256_WORDS];
+    uint32_t    nb;
+
+    if (!p_ctx || !p_le_ss)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if (!is_word_aligned(p_le_ss))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    if (p_ctx->bit < SS_BIT_LAST)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    for (; (n_bits > 0) && (p_ctx->bit > SS_BIT_LAST); n_bits--, p_ctx->bit--)
+    {
+        nb = !uECC_vli_testBit(p_ctx->scalar, p_ctx->bit);
+        xycz_add_c(p_ctx->rx[1 - nb], p_ctx->ry[1 - nb], p_ctx->rx[nb], p_ctx->ry[nb], curve);
+        xycz_add(p_ctx->rx[nb], p_ctx->ry[nb], p_ctx->rx[1 - nb], p_ctx->ry[1 - nb], curve);
+    }
+
+    if (n_bits == 0)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    // Last bit, then back to affine coordinates.
+    nb = !uECC_vli_testBit(p_ctx->scalar, 0);
+    xycz_add_c(p_ctx->rx[1 - nb], p_ctx->ry[1 - nb], p_ctx->rx[nb], p_ctx->ry[nb], curve);
+
+    uECC_vli_modSub(z, p_ctx->rx[1], p_ctx->rx[0], uECC_curve_p(curve), ECC_P256_WORDS); // X1 - X0
+    uECC_vli_modMult_fast(z, z, p_ctx->ry[1 - nb], curve);                                // Yb * (X1 - X0)
+    uECC_vli_modMult_fast(z, z, p_ctx->point, curve);                                     // xP * Yb * (X1 - X0)
+    uECC_vli_modInv(z, z, uECC_curve_p(curve), ECC_P256_WORDS);                           // 1 / (xP * Yb * (X1 - X0))
+    uECC_vli_modMult_fast(z, z, p_ctx->point + ECC_P256_WORDS, curve);                    // yP / (xP * Yb * (X1 - X0))
+    uECC_vli_modMult_fast(z, z, p_ctx->rx[1 - nb], curve);                                // Xb * yP / (xP * Yb * (X1 - X0))
+
+    xycz_add(p_ctx->rx[nb], p_ctx->ry[nb], p_ctx->rx[1 - nb], p_ctx->ry[1 - nb], curve);
+    apply_z(p_ctx->rx[0], p_ctx->ry[0], z, curve);
+
+    p_ctx->bit = SS_BIT_IDLE;
+    memset(p_ctx->scalar, 0, sizeof(p_ctx->scalar));
+
+    if (uECC_vli_isZero(p_ctx->rx[0], ECC_P256_WORDS) && uECC_vli_isZero(p_ctx->ry[0], ECC_P256_WORDS))
+    {
+        return NRF_ERROR_INTERNAL;
+    }
+
+    memcpy(p_le_ss, p_ctx->rx[0], ECC_P256_SK_LEN);
+    return NRF_SUCCESS;
+}
+
+
 ret_code_t ecc_p256_sign(uint8_t const *p_le_sk, uint8_t const * p_le_hash, uint32_t hlen, uint8_t *p_le_sig)
 {
     const struct uECC_Curve_t * p_curve;
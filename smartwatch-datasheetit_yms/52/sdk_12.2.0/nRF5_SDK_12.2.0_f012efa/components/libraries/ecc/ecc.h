@@ -12,6 +12,16 @@
  * @{
  * @ingroup app_common
  * @brief Elliptic Curve Cryptography interface
+ *
+ * @details Two backends implement this interface, and one of them is built in:
+ *          - ecc.c uses micro-ecc. The library is built for nRF52 with the Thumb-2 assembly
+ *            of micro-ecc.
+ *          - ecc_cc310.c uses the CryptoCell CC310 of nRF52840.
+ *
+ *          Keys, secrets, hashes and signatures are little endian with both backends.
+ *
+ *          A shared secret can also be computed a few bits of the private key at a time, see
+ *          @ref ecc_p256_shared_secret_start, so that a slow core is not blocked by it.
  */
 
 #ifndef ECC_H__
@@ -28,9 +38,25 @@ extern "C" {
 #define ECC_P256_SK_LEN 32
 #define ECC_P256_PK_LEN 64
 
+#define ECC_P256_WORDS  (ECC_P256_SK_LEN / sizeof(uint32_t)) /**< Length of one coordinate in words. */
+
+/**@brief State of a shared secret computed in steps.
+ *
+ * @details The content is private to the backend.
+ */
+typedef struct
+{
+    uint32_t rx[2][ECC_P256_WORDS];     /**< X coordinates of the two points of the ladder. */
+    uint32_t ry[2][ECC_P256_WORDS];     /**< Y coordinates of the two points of the ladder. */
+    uint32_t point[2 * ECC_P256_WORDS]; /**< The public key. */
+    uint32_t scalar[ECC_P256_WORDS];    /**< The private key, as used by the ladder. */
+    int16_t  bit;                       /**< The next bit of the scalar, negative when done. */
+} ecc_p256_ss_ctx_t;
+
 /**@brief Initialize the ECC module.
  *
- * @param[in]   rng   Use a random number generator.
+ * @param[in]   rng   Use a random number generator. The CC310 backend always uses the random
+ *                    number generator of the CryptoCell.
  *
  * */
 void ecc_init(bool rng);
@@ -56,6 +82,8 @@ ret_code_t ecc_p256_keypair_gen(uint8_t *p_le_sk, uint8_t* p_le_pk);
  * @retval     NRF_ERROR_NULL           NULL pointer provided.
  * @retval     NRF_ERROR_INVALID_ADDR   Unaligned pointer provided.
  * @retval     NRF_ERROR_INTERNAL       Internal error during key generation.
+ * @retval     NRF_ERROR_NOT_SUPPORTED  The CC310 backend only creates key pairs, see
+ *                                      @ref ecc_p256_keypair_gen.
  */
 ret_code_t ecc_p256_public_key_compute(uint8_t const *p_le_sk, uint8_t* p_le_pk);
 
@@ -72,17 +100,54 @@ ret_code_t ecc_p256_public_key_compute(uint8_t const *p_le_sk, uint8_t* p_le_pk)
  */
 ret_code_t ecc_p256_shared_secret_compute(uint8_t const *p_le_sk, uint8_t const * p_le_pk, uint8_t *p_le_ss);
 
+/**@brief Start computing a shared secret in steps.
+ *
+ * @details The public key is checked to be on the curve. Its point is then multiplied by the
+ *          private key one bit at a time by @ref ecc_p256_shared_secret_continue. The keys are
+ *          copied to the context, they do not need to be kept.
+ *
+ * @param[out]  p_ctx     State of the computation.
+ * @param[in]   p_le_sk   Private key. Pointer must be aligned to a 4-byte boundary.
+ * @param[in]   p_le_pk   Public key. Pointer must be aligned to a 4-byte boundary.
+ *
+ * @retval     NRF_SUCCESS              Computation started.
+ * @retval     NRF_ERROR_NULL           NULL pointer provided.
+ * @retval     NRF_ERROR_INVALID_ADDR   Unaligned pointer provided.
+ * @retval     NRF_ERROR_INVALID_DATA   The public key is not a point of the curve.
+ */
+ret_code_t ecc_p256_shared_secret_start(ecc_p256_ss_ctx_t * p_ctx, uint8_t const * p_le_sk, uint8_t const * p_le_pk);
+
+/**@brief Continue computing a shared secret.
+ *
+ * @details A bit of the private key costs about 14 multiplications in the field. The last step
+ *          also inverts a field element, which costs as much as several bits. The CC310 backend
+ *          computes the whole secret in one call.
+ *
+ * @param[in,out] p_ctx    State of the computation, from @ref ecc_p256_shared_secret_start.
+ * @param[in]     n_bits   Largest number of bits of the private key to process, at least 1.
+ * @param[out]    p_le_ss  Shared secret, once done. Pointer must be aligned to a 4-byte boundary.
+ *
+ * @retval     NRF_SUCCESS              Shared secret created.
+ * @retval     NRF_ERROR_BUSY           Not done yet. Call again.
+ * @retval     NRF_ERROR_NULL           NULL pointer provided.
+ * @retval     NRF_ERROR_INVALID_ADDR   Unaligned pointer provided.
+ * @retval     NRF_ERROR_INVALID_STATE  No computation is ongoing.
+ * @retval     NRF_ERROR_INTERNAL       Internal error during computation.
+ */
+ret_code_t ecc_p256_shared_secret_continue(ecc_p256_ss_ctx_t * p_ctx, uint32_t n_bits, uint8_t *p_le_ss);
+
 /**@brief Sign a hash or digest using a private key.
  *
  * @param[in]   p_le_sk   Private key. Pointer must be aligned to a 4-byte boundary.
  * @param[in]   p_le_hash Hash. Pointer must be aligned to a 4-byte boundary.
- * @param[in]   hlen      Hash length in bytes.
+ * @param[in]   hlen      Hash length in bytes. The CC310 backend only supports 32 bytes.
  * @param[out]  p_le_sig  Signature. Pointer must be aligned to a 4-byte boundary.
  *
  * @retval     NRF_SUCCESS              Signature successfuly created.
  * @retval     NRF_ERROR_NULL           NULL pointer provided.
  * @retval     NRF_ERROR_INVALID_ADDR   Unaligned pointer provided.
  * @retval     NRF_ERROR_INTERNAL       Internal error during signature generation.
+ * @retval     NRF_ERROR_INVALID_LENGTH Hash length not supported by the backend.
  */
 ret_code_t ecc_p256_sign(uint8_t const *p_le_sk, uint8_t const * p_le_hash, uint32_t hlen, uint8_t *p_le_sig);
 
@@ -90,7 +155,7 @@ ret_code_t ecc_p256_sign(uint8_t const *p_le_sk, uint8_t const * p_le_hash, uint
  *
  * @param[in]   p_le_pk   Public key. Pointer must be aligned to a 4-byte boundary.
  * @param[in]   p_le_hash Hash. Pointer must be aligned to a 4-byte boundary.
- * @param[in]   hlen      Hash length in bytes.
+ * @param[in]   hlen      Hash length in bytes. The CC310 backend only supports 32 bytes.
  * @param[in]   p_le_sig  Signature. Pointer must be aligned to a 4-byte boundary.
  *
  * @retval     NRF_SUCCESS              Signature verified.
@@ -98,6 +163,7 @@ ret_code_t ecc_p256_sign(uint8_t const *p_le_sk, uint8_t const * p_le_hash, uint
  * @retval     NRF_ERROR_NULL           NULL pointer provided.
  * @retval     NRF_ERROR_INVALID_ADDR   Unaligned pointer provided.
  * @retval     NRF_ERROR_INTERNAL       Internal error during signature verification.
+ * @retval     NRF_ERROR_INVALID_LENGTH Hash length not supported by the backend.
  */
 ret_code_t ecc_p256_verify(uint8_t const *p_le_pk, uint8_t const * p_le_hash, uint32_t hlen, uint8_t const *p_le_sig);
 
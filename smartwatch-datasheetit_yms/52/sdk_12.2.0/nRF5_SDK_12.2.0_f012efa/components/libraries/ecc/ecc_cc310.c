@@ -0,0 +1,336 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/* ECC backend on the CryptoCell CC310 of nRF52840. It implements the same interface as ecc.c,
+ * which uses micro-ecc: compile one of the two files.
+ *
+ * The keys, the secret, the hash and the signature are little endian, as with micro-ecc. The
+ * CC310 library takes and gives big-endian byte arrays, so every coordinate is reversed here.
+ * The private key is kept by the library in little-endian words.
+ *
+ * The work buffers of the library are static and shared: the functions are not reentrant.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "sdk_common.h"
+#include "nrf.h"
+#include "ecc.h"
+
+#include "sns_silib.h"
+#include "crys_rnd.h"
+#include "crys_ecpki_kg.h"
+#include "crys_ecpki_build.h"
+#include "crys_ecpki_dh.h"
+#include "crys_ecpki_ecdsa.h"
+#include "crys_ecpki_domain.h"
+
+#define ECC_P256_COORD_LEN  32                              /**< Length of one coordinate in bytes. */
+
+static CRYS_RND_Context_t   m_rnd_context;
+static CRYS_RND_WorkBuff_t  m_rnd_work_buff;
+static bool                 m_initialized;
+
+static CRYS_ECPKI_UserPrivKey_t m_priv_key;
+static CRYS_ECPKI_UserPublKey_t m_publ_key;
+
+/**@brief Work buffers, only one of them is used by an operation. */
+static union
+{
+    CRYS_ECPKI_KG_TempData_t        kg;
+    CRYS_ECPKI_BUILD_TempData_t     build;
+    CRYS_ECDH_TempData_t            dh;
+    CRYS_ECDSA_SignUserContext_t    sign;
+    CRYS_ECDSA_VerifyUserContext_t  verify;
+} m_temp;
+
+/**@brief Public key, signature or hash, in the big-endian form of the library. */
+static uint8_t m_be_buf[1 + ECC_P256_PK_LEN];
+
+
+/**@brief Copy bytes in reverse order. */
+static void reverse_copy(uint8_t * p_dst, uint8_t const * p_src, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        p_dst[i] = p_src[len - 1 - i];
+    }
+}
+
+
+/**@brief Convert two little-endian coordinates to big endian, or back. */
+static void coords_reverse_copy(uint8_t * p_dst, uint8_t const * p_src)
+{
+    reverse_copy(p_dst, p_src, ECC_P256_COORD_LEN);
+    reverse_copy(p_dst + ECC_P256_COORD_LEN, p_src + ECC_P256_COORD_LEN, ECC_P256_COORD_LEN);
+}
+
+
+static const CRYS_ECPKI_Domain_t * p256_domain(void)
+{
+    return CRYS_ECPKI_GetEcDomain(CRYS_ECPKI_DomainID_secp256r1);
+}
+
+
+static ret_code_t priv_key_build(uint8_t const * p_le_sk)
+{
+    reverse_copy(m_be_buf, p_le_sk, ECC_P256_SK_LEN);
+
+    if (CRYS_ECPKI_BuildPrivKey(p256_domain(), m_be_buf, ECC_P256_SK_LEN, &m_priv_key) != CRYS_OK)
+    {
+        return NRF_ERROR_INTERNAL;
+    }
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t publ_key_build(uint8_t const * p_le_pk)
+{
+    m_be_buf[0] = CRYS_EC_PointUncompressed;
+    coords_reverse_copy(&m_be_buf[1], p_le_pk);
+
+    if (CRYS_ECPKI_BuildPublKeyPartlyCheck(p256_domain(), m_be_buf, sizeof(m_be_buf),
+                                           &m_publ_key, &m_temp.build) != CRYS_OK)
+    {
+        return NRF_ERROR_INTERNAL;
+    }
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t publ_key_export(uint8_t * p_le_pk)
+{
+    uint32_t size = sizeof(m_be_buf);
+
+    if (CRYS_ECPKI_ExportPublKey(&m_publ_key, CRYS_EC_PointUncompressed, m_be_buf, &size) != CRYS_OK ||
+        size != sizeof(m_be_buf))
+    {
+        return NRF_ERROR_INTERNAL;
+    }
+
+    coords_reverse_copy(p_le_pk, &m_be_buf[1]);
+    return NRF_SUCCESS;
+}
+
+
+void ecc_init(bool rng)
+{
+    // The CryptoCell has its own random number generator.
+    UNUSED_PARAMETER(rng);
+
+    if (m_initialized)
+    {
+        return;
+    }
+
+    NRF_CRYPTOCELL->ENABLE = 1;
+    if (SaSi_LibInit(&m_rnd_context, &m_rnd_work_buff) == SA_SILIB_RET_OK)
+    {
+        m_initialized = true;
+    }
+}
+
+ret_code_t ecc_p256_keypair_gen(uint8_t *p_le_sk, uint8_t *p_le_pk)
+{
+    CRYS_ECPKI_KG_FipsContext_t fips_ctx;
+
+    if (!p_le_sk || !p_le_pk)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if (!is_word_aligned(p_le_sk) || !is_word_aligned(p_le_pk))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    if (CRYS_ECPKI_GenKeyPair(&m_rnd_context, p256_domain(), &m_priv_key, &m_publ_key,
+                              &m_temp.kg, &fips_ctx) != CRYS_OK)
+    {
+        return NRF_ERROR_INTERNAL;
+    }
+
+    // The library keeps the private key in little-endian words.
+    memcpy(p_le_sk, ((CRYS_ECPKI_PrivKey_t *)m_priv_key.PrivKeyDbBuff)->PrivKey, ECC_P256_SK_LEN);
+
+    return publ_key_export(p_le_pk);
+}
+
+ret_code_t ecc_p256_public_key_compute(uint8_t const *p_le_sk, uint8_t *p_le_pk)
+{
+    if (!p_le_sk || !p_le_pk)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if (!is_word_aligned(p_le_sk) || !is_word_aligned(p_le_pk))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    // The library only computes the public key together with a new private key.
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+ret_code_t ecc_p256_shared_secret_compute(uint8_t const *p_le_sk, uint8_t const *p_le_pk, uint8_t *p_le_ss)
+{
+    ret_code_t err_code;
+    uint32_t   size = ECC_P256_COORD_LEN;
+
+    if (!p_le_sk || !p_le_pk || !p_le_ss)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if (!is_word_aligned(p_le_sk) || !is_word_aligned(p_le_pk) || !is_word_aligned(p_le_ss))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    err_code = publ_key_build(p_le_pk);
+    VERIFY_SUCCESS(err_code);
+
+    err_code = priv_key_build(p_le_sk);
+    VERIFY_SUCCESS(err_code);
+
+    if (CRYS_ECDH_SVDP_DH(&m_publ_key, &m_priv_key, m_be_buf, &size, &m_temp.dh) != CRYS_OK ||
+        size != ECC_P256_COORD_LEN)
+    {
+        return NRF_ERROR_INTERNAL;
+    }
+
+    reverse_copy(p_le_ss, m_be_buf, ECC_P256_COORD_LEN);
+    return NRF_SUCCESS;
+}
+
+ret_code_t ecc_p256_shared_secret_start(ecc_p256_ss_ctx_t * p_ctx, uint8_t const * p_le_sk, uint8_t const * p_le_pk)
+{
+    if (!p_ctx || !p_le_sk || !p_le_pk)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if (!is_word_aligned(p_le_sk) || !is_word_aligned(p_le_pk))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    p_ctx->bit = -1;
+
+    if (publ_key_build(p_le_pk) != NRF_SUCCESS)
+    {
+        return NRF_ERROR_INVALID_DATA;
+    }
+
+    // The CryptoCell is fast enough to do the whole computation in the first step.
+    memcpy(p_ctx->point, p_le_pk, ECC_P256_PK_LEN);
+    memcpy(p_ctx->scalar, p_le_sk, ECC_P256_SK_LEN);
+    p_ctx->bit = 0;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t ecc_p256_shared_secret_continue(ecc_p256_ss_ctx_t * p_ctx, uint32_t n_bits, uint8_t *p_le_ss)
+{
+    ret_code_t err_code;
+
+    if (!p_ctx || !p_le_ss)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if (p_ctx->bit < 0)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    err_code = ecc_p256_shared_secret_compute((uint8_t const *)p_ctx->scalar,
+                                              (uint8_t const *)p_ctx->point,
+                                              p_le_ss);
+
+    p_ctx->bit = -1;
+    memset(p_ctx->scalar, 0, sizeof(p_ctx->scalar));
+
+    return err_code;
+}
+
+ret_code_t ecc_p256_sign(uint8_t const *p_le_sk, uint8_t const * p_le_hash, uint32_t hlen, uint8_t *p_le_sig)
+{
+    ret_code_t err_code;
+    uint8_t    be_hash[ECC_P256_COORD_LEN];
+    uint32_t   size = 2 * ECC_P256_COORD_LEN;
+
+    if (!p_le_sk || !p_le_hash || !p_le_sig)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if (!is_word_aligned(p_le_sk) || !is_word_aligned(p_le_hash) || !is_word_aligned(p_le_sig))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    if (hlen != sizeof(be_hash))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    err_code = priv_key_build(p_le_sk);
+    VERIFY_SUCCESS(err_code);
+
+    reverse_copy(be_hash, p_le_hash, hlen);
+
+    if (CRYS_ECDSA_Sign(&m_rnd_context, &m_temp.sign, &m_priv_key, CRYS_ECPKI_AFTER_HASH_SHA256_mode,
+                        be_hash, hlen, m_be_buf, &size) != CRYS_OK ||
+        size != 2 * ECC_P256_COORD_LEN)
+    {
+        return NRF_ERROR_INTERNAL;
+    }
+
+    coords_reverse_copy(p_le_sig, m_be_buf);
+    return NRF_SUCCESS;
+}
+
+ret_code_t ecc_p256_verify(uint8_t const *p_le_pk, uint8_t const * p_le_hash, uint32_t hlen, uint8_t const *p_le_sig)
+{
+    ret_code_t err_code;
+    uint8_t    be_hash[ECC_P256_COORD_LEN];
+
+    if (!p_le_pk || !p_le_hash || !p_le_sig)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if (!is_word_aligned(p_le_pk) || !is_word_aligned(p_le_hash) || !is_word_aligned(p_le_sig))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    if (hlen != sizeof(be_hash))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    err_code = publ_key_build(p_le_pk);
+    VERIFY_SUCCESS(err_code);
+
+    reverse_copy(be_hash, p_le_hash, hlen);
+    coords_reverse_copy(m_be_buf, p_le_sig);
+
+    if (CRYS_ECDSA_Verify(&m_temp.verify, &m_publ_key, CRYS_ECPKI_AFTER_HASH_SHA256_mode,
+                          m_be_buf, 2 * ECC_P256_COORD_LEN, be_hash, hlen) != CRYS_OK)
+    {
+        return NRF_ERROR_INVALID_DATA;
+    }
+
+    return NRF_SUCCESS;
+}
@@ -0,0 +1,208 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(ENTROPY_POOL)
+#include "entropy_pool.h"
+#include <string.h>
+#include "nrf_drv_rng.h"
+#include "nrf_queue.h"
+#include "nrf_crypto.h"
+#include "app_util_platform.h"
+
+#define REFILL_CHUNK    32                  /**< Bytes moved from the RNG driver at a time. */
+#define AES_BLOCK_LEN   16                  /**< Bytes in an AES block. */
+#define DRBG_SEED_LEN   (2 * AES_BLOCK_LEN) /**< Bytes of the seed: the length of the key and of the counter. */
+
+/**@brief State of the deterministic random bit generator. */
+typedef struct
+{
+    uint8_t  key[AES_BLOCK_LEN];     /**< AES key. */
+    uint8_t  v[AES_BLOCK_LEN];       /**< Counter, big-endian. */
+    uint32_t reseed_counter;         /**< Requests since the last seed. 0 if the generator was never seeded. */
+    bool     busy;                   /**< The generator is in use. */
+} drbg_t;
+
+NRF_QUEUE_DEF(uint8_t, m_pool, ENTROPY_POOL_CONFIG_SIZE, NRF_QUEUE_MODE_OVERFLOW);
+static drbg_t m_drbg;
+
+
+void entropy_pool_refill(void)
+{
+    uint8_t buff[REFILL_CHUNK];
+    uint8_t available;
+    size_t  length;
+
+    for (;;)
+    {
+        nrf_drv_rng_bytes_available(&available);
+        length = MIN(MIN((size_t)available, nrf_queue_available_get(&m_pool)), sizeof(buff));
+        if ((length == 0) || (nrf_drv_rng_rand(buff, (uint8_t)length) != NRF_SUCCESS))
+        {
+            break;
+        }
+        UNUSED_RETURN_VALUE(nrf_queue_in(&m_pool, buff, length));
+    }
+
+    memset(buff, 0, sizeof(buff));
+}
+
+
+uint16_t entropy_pool_available(void)
+{
+    return (uint16_t)nrf_queue_utilization_get(&m_pool);
+}
+
+
+ret_code_t entropy_pool_get(uint8_t * p_buff, uint16_t length)
+{
+    VERIFY_PARAM_NOT_NULL(p_buff);
+
+    if (nrf_queue_utilization_get(&m_pool) < length)
+    {
+        entropy_pool_refill();
+    }
+
+    return nrf_queue_read(&m_pool, p_buff, length);
+}
+
+
+/**@brief Function for incrementing the counter of the generator. */
+static void drbg_v_increment(void)
+{
+    for (int i = AES_BLOCK_LEN - 1; i >= 0; i--)
+    {
+        if (++m_drbg.v[i] != 0)
+        {
+            break;
+        }
+    }
+}
+
+
+/**@brief Function for updating the key and the counter, CTR_DRBG_Update in SP 800-90A.
+ *
+ * @param[in] p_data DRBG_SEED_LEN bytes mixed into the new state, or NULL.
+ */
+static ret_code_t drbg_update(uint8_t const * p_data)
+{
+    uint8_t    temp[DRBG_SEED_LEN];
+    ret_code_t err_code = NRF_SUCCESS;
+
+    for (uint32_t i = 0; (i < DRBG_SEED_LEN) && (err_code == NRF_SUCCESS); i += AES_BLOCK_LEN)
+    {
+        drbg_v_increment();
+        err_code = nrf_crypto_aes128_encrypt(m_drbg.key, m_drbg.v, &temp[i]);
+    }
+
+    if (err_code == NRF_SUCCESS)
+    {
+        if (p_data != NULL)
+        {
+            for (uint32_t i = 0; i < DRBG_SEED_LEN; i++)
+            {
+                temp[i] ^= p_data[i];
+            }
+        }
+        memcpy(m_drbg.key, &temp[0], AES_BLOCK_LEN);
+        memcpy(m_drbg.v, &temp[AES_BLOCK_LEN], AES_BLOCK_LEN);
+    }
+
+    memset(temp, 0, sizeof(temp));
+    return err_code;
+}
+
+
+/**@brief Function for seeding the generator from the pool. */
+static ret_code_t drbg_reseed(void)
+{
+    uint8_t    seed[DRBG_SEED_LEN];
+    ret_code_t err_code;
+
+    err_code = entropy_pool_get(seed, sizeof(seed));
+    if (err_code == NRF_SUCCESS)
+    {
+        err_code = drbg_update(seed);
+    }
+    if (err_code == NRF_SUCCESS)
+    {
+        m_drbg.reseed_counter = 1;
+    }
+
+    memset(seed, 0, sizeof(seed));
+    return err_code;
+}
+
+
+static ret_code_t drbg_generate(uint8_t * p_buff, uint32_t length)
+{
+    uint8_t    block[AES_BLOCK_LEN];
+    ret_code_t err_code = NRF_SUCCESS;
+
+    if ((m_drbg.reseed_counter == 0) ||
+        (m_drbg.reseed_counter > ENTROPY_POOL_CONFIG_DRBG_RESEED_INTERVAL))
+    {
+        err_code = drbg_reseed();
+        VERIFY_SUCCESS(err_code);
+    }
+
+    while ((length > 0) && (err_code == NRF_SUCCESS))
+    {
+        uint32_t len = MIN(length, AES_BLOCK_LEN);
+
+        drbg_v_increment();
+        err_code = nrf_crypto_aes128_encrypt(m_drbg.key, m_drbg.v, block);
+        memcpy(p_buff, block, len);
+        p_buff += len;
+        length -= len;
+    }
+
+    // The state is renewed after every request, so that the output cannot be recovered from it.
+    if (err_code == NRF_SUCCESS)
+    {
+        err_code = drbg_update(NULL);
+        m_drbg.reseed_counter++;
+    }
+
+    memset(block, 0, sizeof(block));
+    return err_code;
+}
+
+
+ret_code_t entropy_pool_drbg_get(uint8_t * p_buff, uint32_t length)
+{
+    ret_code_t err_code;
+    bool       busy;
+
+    VERIFY_PARAM_NOT_NULL(p_buff);
+
+    CRITICAL_REGION_ENTER();
+    busy = m_drbg.busy;
+    m_drbg.busy = true;
+    CRITICAL_REGION_EXIT();
+
+    if (busy)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    err_code = drbg_generate(p_buff, length);
+    if (err_code != NRF_SUCCESS)
+    {
+        // A failed request leaves the state unknown, the generator is seeded again.
+        m_drbg.reseed_counter = 0;
+    }
+
+    m_drbg.busy = false;
+    return err_code;
+}
+
+#endif // NRF_MODULE_ENABLED(ENTROPY_POOL)
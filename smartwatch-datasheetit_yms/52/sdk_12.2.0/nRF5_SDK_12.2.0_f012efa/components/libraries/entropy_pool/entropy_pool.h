@@ -0,0 +1,108 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup entropy_pool Entropy pool
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for getting random numbers without waiting for the RNG.
+ *
+ * @details The pool holds random bytes from the RNG driver, which takes them from the RNG
+ *          peripheral, or from the SoftDevice when it is enabled. It is refilled by
+ *          @ref entropy_pool_refill, which @ref nrf_pwr_mgmt calls before the CPU goes to sleep,
+ *          so the RNG peripheral or the SoftDevice keeps producing bytes while the application
+ *          is idle. @ref entropy_pool_get returns at once: it succeeds if the pool holds enough
+ *          bytes, and fails otherwise.
+ *
+ *          For more random data than the pool can hold, @ref entropy_pool_drbg_get expands the
+ *          pool with a deterministic random bit generator: AES-128 in counter mode on the ECB
+ *          peripheral, as the CTR_DRBG of NIST SP 800-90A without a derivation function. The
+ *          generator is seeded from the pool, and reseeded from it every
+ *          @ref ENTROPY_POOL_CONFIG_DRBG_RESEED_INTERVAL requests.
+ *
+ * @note The RNG driver must be initialized before the module is used.
+ */
+
+#ifndef ENTROPY_POOL_H__
+#define ENTROPY_POOL_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of bytes the pool holds.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef ENTROPY_POOL_CONFIG_SIZE
+#define ENTROPY_POOL_CONFIG_SIZE 64
+#endif
+
+/** @brief Number of requests to @ref entropy_pool_drbg_get after which the generator is reseeded.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef ENTROPY_POOL_CONFIG_DRBG_RESEED_INTERVAL
+#define ENTROPY_POOL_CONFIG_DRBG_RESEED_INTERVAL 256
+#endif
+
+/**@brief Function for moving the random bytes produced since the last call into the pool.
+ *
+ * @details Does not wait for new bytes. Called by @ref nrf_pwr_mgmt_run before sleeping.
+ */
+void entropy_pool_refill(void);
+
+/**@brief Function for getting the number of bytes in the pool.
+ *
+ * @return Bytes in the pool, not counting the ones the RNG driver holds.
+ */
+uint16_t entropy_pool_available(void);
+
+/**@brief Function for taking random bytes from the pool.
+ *
+ * @details If the pool does not hold enough bytes, it is refilled first.
+ *
+ * @param[out] p_buff Buffer for the bytes.
+ * @param[in]  length Number of bytes.
+ *
+ * @retval NRF_SUCCESS         If the bytes were written to p_buff.
+ * @retval NRF_ERROR_NULL      If p_buff was NULL.
+ * @retval NRF_ERROR_NOT_FOUND If there were not enough bytes. Nothing was taken from the pool.
+ */
+ret_code_t entropy_pool_get(uint8_t * p_buff, uint16_t length);
+
+/**@brief Function for getting random bytes from the deterministic random bit generator.
+ *
+ * @param[out] p_buff Buffer for the bytes.
+ * @param[in]  length Number of bytes.
+ *
+ * @retval NRF_SUCCESS         If the bytes were written to p_buff.
+ * @retval NRF_ERROR_NULL      If p_buff was NULL.
+ * @retval NRF_ERROR_NOT_FOUND If the generator must be seeded, and the pool does not hold enough
+ *                             bytes for the seed.
+ * @retval NRF_ERROR_BUSY      If the generator is in use by an interrupted context.
+ * @return Any error returned by @ref nrf_crypto_aes128_encrypt.
+ */
+ret_code_t entropy_pool_drbg_get(uint8_t * p_buff, uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ENTROPY_POOL_H__
+
+/** @} */
@@ -0,0 +1,30 @@
+/**
+ *
+ * @defgroup entropy_pool_config entropy_pool module configuration
+ * @{
+ * @ingroup entropy_pool
+ */
+/** @brief Enabling entropy_pool module
+ *
+ *  Requires the RNG driver, and nrf_crypto for the generator.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ENTROPY_POOL_ENABLED
+
+/** @brief Number of bytes the pool holds.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ENTROPY_POOL_CONFIG_SIZE
+
+/** @brief Number of requests to the generator after which it is reseeded.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ENTROPY_POOL_CONFIG_DRBG_RESEED_INTERVAL
+
+
+/** @} */
@@ -163,6 +163,9 @@ static void adv_timing_callback(const es_adv_timing_evt_t * p_evt)
 
     get_adv_params(&non_connectable_adv_params, true, m_remain_connectable);
     adv_start(&non_connectable_adv_params);
+
+    // Prepare the frame of this slot for the next rotation, while the advertisement is running.
+    es_adv_frame_prepare(p_evt->slot_no, p_evt->evt_id == ES_ADV_TIMING_EVT_ADV_ETLM);
 }
 
 
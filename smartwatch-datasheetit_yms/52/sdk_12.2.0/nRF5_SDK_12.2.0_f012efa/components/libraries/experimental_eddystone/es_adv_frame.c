@@ -10,11 +10,59 @@
  *
  */
 
+#include <string.h>
 #include "es_adv_frame.h"
 #include "es_app_config.h"
 #include "es_tlm.h"
 #include "es_slot.h"
 
+/**@brief Encoded advertising data of a frame.
+ *
+ * The frame is kept encoded, so that advertising it is only a copy to the SoftDevice. When the
+ * frame keeps its length, the changed bytes are written in place in the encoded data.
+ */
+typedef struct
+{
+    uint8_t         data[BLE_GAP_ADV_MAX_SIZE]; //!< Encoded advertising data.
+    uint16_t        length;                     //!< Length of the encoded advertising data.
+    uint16_t        frame_offset;               //!< Offset of the Eddystone frame in the encoded data.
+    uint8_t         frame_length;               //!< Length of the Eddystone frame.
+    es_frame_type_t frame_type;                 //!< Type of the Eddystone frame.
+    bool            valid;                      //!< The encoded data was built.
+} adv_data_cache_t;
+
+static adv_data_cache_t m_slot_cache[APP_MAX_ADV_SLOTS]; //!< Frames of the slots.
+static adv_data_cache_t m_etlm_cache[APP_MAX_ADV_SLOTS]; //!< eTLM frames, by EID slot.
+
+/**@brief Function for filling the advertisement data structure.
+ *
+ * @param[out] p_adv_data       Advertisement data.
+ * @param[out] p_service_data   Service data, referenced by @p p_adv_data.
+ * @param[in]  p_uuid           UUID list, referenced by @p p_adv_data.
+ * @param[in]  p_es_data_array  Eddystone service data array, or NULL.
+ */
+static void adv_data_init(ble_advdata_t              * p_adv_data,
+                          ble_advdata_service_data_t * p_service_data,
+                          ble_uuid_t                 * p_uuid,
+                          uint8_array_t              * p_es_data_array)
+{
+    uint8_array_t es_data_array = {0};
+
+    p_service_data->service_uuid = APP_ES_UUID; // Eddystone UUID to allow discoverability on iOS devices.
+
+    p_service_data->data = (p_es_data_array != NULL) ? *p_es_data_array : es_data_array;
+
+    memset(p_adv_data, 0, sizeof(ble_advdata_t));
+
+    p_adv_data->name_type               = BLE_ADVDATA_NO_NAME;
+    p_adv_data->flags                   = BLE_GAP_ADV_FLAGS_LE_ONLY_GENERAL_DISC_MODE;
+    p_adv_data->uuids_complete.uuid_cnt = 1;
+    p_adv_data->uuids_complete.p_uuids  = p_uuid;
+    p_adv_data->p_service_data_array    = p_service_data;
+    p_adv_data->service_data_count      = (p_es_data_array != NULL) ? 1 : 0;
+}
+
+
 /**@brief Function for setting advertisement data, using 'ble_advdata_set'.
  *
  * @param[in] p_scrsp_data      Scan response data. 
@@ -22,59 +70,130 @@
  */
 static void fill_adv_data(ble_advdata_t * p_scrsp_data, uint8_array_t * p_es_data_array)
 {
-    ble_advdata_t adv_data;
-    uint32_t      err_code;
-    ble_uuid_t    adv_uuids[]   = {{ES_UUID, BLE_UUID_TYPE_BLE}};
-    uint8_array_t es_data_array = {0};
+    ble_advdata_t              adv_data;
+    uint32_t                   err_code;
+    ble_uuid_t                 adv_uuid = {ES_UUID, BLE_UUID_TYPE_BLE};
+    ble_advdata_service_data_t service_data; // Structure to hold Service Data.
 
-    ble_advdata_service_data_t service_data;        // Structure to hold Service Data.
+    adv_data_init(&adv_data, &service_data, &adv_uuid, p_es_data_array);
 
-    service_data.service_uuid = APP_ES_UUID; // Eddystone UUID to allow discoverability on iOS devices.
+    err_code = ble_advdata_set(&adv_data, p_scrsp_data);
+    APP_ERROR_CHECK(err_code);
+}
 
-    service_data.data = (p_es_data_array != NULL) ? *p_es_data_array : es_data_array;
 
-    // Build and set advertising data.
-    memset(&adv_data, 0, sizeof(ble_advdata_t));
+/**@brief Function for encoding the advertisement data of a frame.
+ *
+ * @param[out] p_cache      Encoded data.
+ * @param[in]  p_frame      Eddystone frame.
+ * @param[in]  frame_length Length of the frame.
+ */
+static void frame_encode(adv_data_cache_t * p_cache, uint8_t const * p_frame, uint8_t frame_length)
+{
+    ble_advdata_t              adv_data;
+    uint32_t                   err_code;
+    ble_uuid_t                 adv_uuid      = {ES_UUID, BLE_UUID_TYPE_BLE};
+    ble_advdata_service_data_t service_data;
+    uint8_array_t              es_data_array = {.p_data = (uint8_t *)p_frame, .size = frame_length};
+    uint16_t                   offset        = 0;
 
-    adv_data.name_type               = BLE_ADVDATA_NO_NAME;
-    adv_data.flags                   = BLE_GAP_ADV_FLAGS_LE_ONLY_GENERAL_DISC_MODE;
-    adv_data.uuids_complete.uuid_cnt = sizeof(adv_uuids) / sizeof(adv_uuids[0]);
-    adv_data.uuids_complete.p_uuids  = adv_uuids;
-    adv_data.p_service_data_array    = &service_data;
-    adv_data.service_data_count      = (p_es_data_array != NULL) ? 1 : 0;
+    adv_data_init(&adv_data, &service_data, &adv_uuid, &es_data_array);
 
-    err_code = ble_advdata_set(&adv_data, p_scrsp_data);
+    p_cache->length = sizeof(p_cache->data);
+    err_code = adv_data_encode(&adv_data, p_cache->data, &p_cache->length);
     APP_ERROR_CHECK(err_code);
+
+    // The frame follows the service UUID in the service data.
+    (void)ble_advdata_search(p_cache->data, p_cache->length, &offset, BLE_GAP_AD_TYPE_SERVICE_DATA);
+
+    p_cache->frame_offset = offset + sizeof(uint16_t);
+    p_cache->frame_length = frame_length;
+    p_cache->valid        = true;
 }
 
 
-void es_adv_frame_fill_connectable_adv_data(ble_advdata_t * p_scrsp_data)
+/**@brief Function for storing a frame in its encoded data, if it changed.
+ *
+ * @param[in,out] p_cache Encoded data.
+ * @param[in]     p_frame Eddystone frame, from the slot registry.
+ */
+static void frame_store(adv_data_cache_t * p_cache, es_adv_frame_t const * p_frame)
 {
-    fill_adv_data(p_scrsp_data, NULL);
+    uint8_t const * p_data = (uint8_t const *)&p_frame->frame;
+
+    p_cache->frame_type = p_frame->type;
+
+    if (!p_cache->valid || p_cache->frame_length != p_frame->length)
+    {
+        frame_encode(p_cache, p_data, p_frame->length);
+    }
+    else if (memcmp(&p_cache->data[p_cache->frame_offset], p_data, p_frame->length) != 0)
+    {
+        memcpy(&p_cache->data[p_cache->frame_offset], p_data, p_frame->length);
+    }
 }
 
 
-void es_adv_frame_fill_non_connectable_adv_data(uint8_t slot_no, bool etlm)
+/**@brief Function for generating the frame of a slot.
+ *
+ * @param[in] slot_no Slot number.
+ * @param[in] etlm    Generate the eTLM frame that follows the EID slot @p slot_no.
+ */
+static void frame_generate(uint8_t slot_no, bool etlm)
 {
-    uint8_array_t         es_data_array = {0};
-    const es_slot_reg_t * p_reg         = es_slot_get_registry();
+    const es_slot_reg_t * p_reg = es_slot_get_registry();
 
     if (etlm)
     {
         es_slot_etlm_update(slot_no);
-
-        // If eTLM, the incoming slot_no points to the corresponding EID slot, update to point to TLM slot.
-        slot_no = p_reg->tlm_slot;
+        frame_store(&m_etlm_cache[slot_no], &p_reg->slots[p_reg->tlm_slot].adv_frame);
+    }
+    else
+    {
+        if (p_reg->slots[slot_no].adv_frame.type == ES_FRAME_TYPE_TLM)
+        {
+            es_slot_tlm_update();
+        }
+        frame_store(&m_slot_cache[slot_no], &p_reg->slots[slot_no].adv_frame);
     }
+}
 
-    // If TLM, update the TLM data.
-    else if(p_reg->slots[slot_no].adv_frame.type == ES_FRAME_TYPE_TLM)
+
+void es_adv_frame_fill_connectable_adv_data(ble_advdata_t * p_scrsp_data)
+{
+    fill_adv_data(p_scrsp_data, NULL);
+}
+
+
+void es_adv_frame_fill_non_connectable_adv_data(uint8_t slot_no, bool etlm)
+{
+    uint32_t              err_code;
+    const es_slot_reg_t * p_reg   = es_slot_get_registry();
+    adv_data_cache_t    * p_cache = etlm ? &m_etlm_cache[slot_no] : &m_slot_cache[slot_no];
+
+    if (!p_cache->valid)
     {
-        es_slot_tlm_update();
+        // First advertisement of the frame.
+        frame_generate(slot_no, etlm);
+    }
+    else if (!etlm)
+    {
+        es_adv_frame_t const * p_frame = &p_reg->slots[slot_no].adv_frame;
+
+        // A TLM frame was prepared after its last advertisement, the other frames are only
+        // changed by the slot configuration and the EID rotation.
+        if (p_frame->type != ES_FRAME_TYPE_TLM || p_cache->frame_type != ES_FRAME_TYPE_TLM)
+        {
+            frame_store(p_cache, p_frame);
+        }
     }
-    
-    es_data_array.p_data = (uint8_t *) &p_reg->slots[slot_no].adv_frame.frame;
-    es_data_array.size   = p_reg->slots[slot_no].adv_frame.length;
 
-    fill_adv_data(NULL, &es_data_array);
+    err_code = sd_ble_gap_adv_data_set(p_cache->data, p_cache->length, NULL, 0);
+    APP_ERROR_CHECK(err_code);
+}
+
+
+void es_adv_frame_prepare(uint8_t slot_no, bool etlm)
+{
+    frame_generate(slot_no, etlm);
 }
@@ -28,13 +28,26 @@
  */
 void es_adv_frame_fill_connectable_adv_data(ble_advdata_t * p_scrsp_data);
 
-/**@brief Function for setting up non-connectable advertisement data using @ref ble_advdata_set.
+/**@brief Function for setting up non-connectable advertisement data from the encoded frame of a slot.
+ *
+ * @details The frame is generated here only before its first advertisement, see
+ *          @ref es_adv_frame_prepare.
  *
  * @param[in]   slot_no Slot to fill in data for.
  * @param[in]   etlm    Flag that specifies if Eddystone-TLM is required.
  */
 void es_adv_frame_fill_non_connectable_adv_data(uint8_t slot_no, bool etlm);
 
+/**@brief Function for generating the next frame of a slot after it was advertised.
+ *
+ * @details The TLM data is read, and an eTLM frame is encrypted, one rotation before the frame is
+ *          advertised. Frames that did not change are not encoded again.
+ *
+ * @param[in]   slot_no Slot that was advertised.
+ * @param[in]   etlm    Flag that specifies if the eTLM frame of the slot was advertised.
+ */
+void es_adv_frame_prepare(uint8_t slot_no, bool etlm);
+
 /**
  * @}
  */
@@ -29,8 +29,12 @@
 #define RECORD_KEY_PUB_KEY               0x3                    //!< File record for public key.
 #define RECORD_KEY_LOCK_KEY              0x4                    //!< File record for lock key.
 #define RECORD_KEY_BEACON_CONFIG         0x5                    //!< File record for lock key.
+#define RECORD_KEY_BATCH                 0xb                    //!< File record for flags, beacon config and all slots.
 
-static uint16_t RECORD_KEY_SLOTS[5] = {0x6, 0x7, 0x8, 0x9, 0xa};//!< File record for slots.   
+#define BATCH_VALID_FLAGS                0x1                    //!< The flags of the batch record hold data.
+#define BATCH_VALID_BEACON_CONFIG        0x2                    //!< The beacon configuration of the batch record holds data.
+
+static uint16_t RECORD_KEY_SLOTS[5] = {0x6, 0x7, 0x8, 0x9, 0xa};//!< File record for slots. Only read, to convert the records of earlier firmware.   
 
 /**@brief Structure used for invoking flash access function. */
 typedef struct
@@ -43,22 +47,32 @@ typedef struct
     es_flash_access_t access_type;
 } flash_access_params_t;
 
+/**@brief Flags, beacon configuration and slots, stored together in one record.
+ * @details Written with one FDS operation, so a configuration is never stored half-way.
+ */
+typedef struct
+{
+    uint32_t                 valid;                     //!< Parts holding data, see BATCH_VALID_*.
+    es_flash_flags_t         flags;                     //!< Flags. Also kept up to date when a slot is written or cleared.
+    es_flash_beacon_config_t beacon_config;             //!< Beacon configuration.
+    es_slot_t                slots[APP_MAX_ADV_SLOTS];  //!< Slots. Only those that are not empty hold data.
+} flash_batch_t;
+
 static volatile uint32_t m_num_pending_ops;                         //!< Current number of outstanding FDS operations.
 static volatile bool     m_factory_reset;                           //!< Should factory reset be performed.
 static uint16_t          m_conn_handle = BLE_CONN_HANDLE_INVALID;   //!< Current connection handle.
 
+static flash_batch_t     m_batch;                                   //!< Staged batch record.
+static bool              m_batch_loaded;                            //!< The batch record has been read from flash.
+static bool              m_batch_dirty;                             //!< The staged batch record differs from flash.
+static bool              m_batch_legacy;                            //!< Records of earlier firmware must be deleted on commit.
+static uint8_t           m_lock_key[SIZE_OF_LOCK_KEY];              //!< Staged lock key.
+static bool              m_lock_key_dirty;                          //!< The staged lock key differs from flash.
+
 static __ALIGN(4) uint8_t priv_key_buf[SIZE_OF_PRIV_KEY];   //!< Buffer for private key flash access.
 static __ALIGN(4) uint8_t pub_key_buf[SIZE_OF_PUB_KEY];     //!< Buffer for public key flash access.
-static __ALIGN(4) uint8_t slot0_buf[sizeof(es_slot_t)];     //!< Buffer for slot 0 flash access.
-static __ALIGN(4) uint8_t slot1_buf[sizeof(es_slot_t)];     //!< Buffer for slot 1 flash access.
-static __ALIGN(4) uint8_t slot2_buf[sizeof(es_slot_t)];     //!< Buffer for slot 2 flash access.
-static __ALIGN(4) uint8_t slot3_buf[sizeof(es_slot_t)];     //!< Buffer for slot 3 flash access.
-static __ALIGN(4) uint8_t slot4_buf[sizeof(es_slot_t)];     //!< Buffer for slot 4 flash access. 
 static __ALIGN(4) uint8_t lock_key_buf[SIZE_OF_LOCK_KEY];   //!< Buffer for lock key flash access.
-static uint8_t * slots_buf_p[APP_MAX_ADV_SLOTS] =
-{slot0_buf, slot1_buf, slot2_buf, slot3_buf, slot4_buf};    //!< List of all slot buffers.
-static __ALIGN(4) uint8_t flash_flags_buf[sizeof(es_flash_flags_t)];            //!< Buffer for flash flags flash access.
-static __ALIGN(4) uint8_t beacon_config_buf[sizeof(es_flash_beacon_config_t)];  //!< Buffer for beacon config flash access.
+static __ALIGN(4) uint8_t batch_buf[ALIGN_NUM(WORD_SIZE, sizeof(flash_batch_t))];  //!< Buffer for batch record flash access.
 
 /**@brief Function handling scheduled FDS garbage collection. */
 static void fds_gc_event(void * p_event_data, uint16_t event_size)
@@ -194,6 +208,171 @@ static ret_code_t access_flash_data(const flash_access_params_t * p_params)
 }
 
 
+/**@brief Function for reading the batch record, on the first access.
+ *
+ * @details If it is not found, the flags, beacon configuration and slot records of earlier
+ *          firmware are read instead. They are converted to a batch record on the next commit.
+ */
+static void batch_load(void)
+{
+    ret_code_t err_code;
+
+    if (m_batch_loaded)
+    {
+        return;
+    }
+    m_batch_loaded = true;
+
+    memset(&m_batch, 0, sizeof(m_batch));
+    for (uint32_t i = 0; i < APP_MAX_ADV_SLOTS; i++)
+    {
+        m_batch.flags.slot_is_empty[i] = true;
+    }
+
+    flash_access_params_t params = {
+        .record_key  = RECORD_KEY_BATCH,
+        .file_id     = FILE_ID_ES_FLASH,
+        .p_chunk_buf = batch_buf,
+        .p_data      = (uint8_t *) &m_batch,
+        .size_bytes  = sizeof(flash_batch_t),
+        .access_type = ES_FLASH_ACCESS_READ
+    };
+
+    if (access_flash_data(&params) == NRF_SUCCESS)
+    {
+        return;
+    }
+
+    params.record_key = RECORD_KEY_BEACON_CONFIG;
+    params.p_data     = (uint8_t *) &m_batch.beacon_config;
+    params.size_bytes = sizeof(es_flash_beacon_config_t);
+    if (access_flash_data(&params) == NRF_SUCCESS)
+    {
+        m_batch.valid |= BATCH_VALID_BEACON_CONFIG;
+        m_batch_legacy = true;
+    }
+
+    params.record_key = RECORD_KEY_FLAGS;
+    params.p_data     = (uint8_t *) &m_batch.flags;
+    params.size_bytes = sizeof(es_flash_flags_t);
+    if (access_flash_data(&params) != NRF_SUCCESS)
+    {
+        m_batch_dirty = m_batch_legacy;
+        return;
+    }
+    m_batch.valid |= BATCH_VALID_FLAGS;
+    m_batch_legacy = true;
+
+    for (uint32_t i = 0; i < APP_MAX_ADV_SLOTS; i++)
+    {
+        if (!m_batch.flags.slot_is_empty[i])
+        {
+            params.record_key = RECORD_KEY_SLOTS[i];
+            params.p_data     = (uint8_t *) &m_batch.slots[i];
+            params.size_bytes = sizeof(es_slot_t);
+
+            err_code = access_flash_data(&params);
+            if (err_code != NRF_SUCCESS)
+            {
+                m_batch.flags.slot_is_empty[i] = true;
+            }
+        }
+    }
+    m_batch_dirty = true;
+}
+
+
+/**@brief Function for staging or reading a part of the batch record.
+ *
+ * @param[in]       p_part           Part of @ref m_batch.
+ * @param[in,out]   p_data           Data to stage, or buffer to read to.
+ * @param[in]       size_bytes       Size of the part.
+ * @param[in,out]   p_valid          Whether the part holds data.
+ * @param[in]       access_type      Access type (see @ref es_flash_access_t).
+ */
+static ret_code_t batch_access(void            * p_part,
+                               void            * p_data,
+                               uint16_t          size_bytes,
+                               bool            * p_valid,
+                               es_flash_access_t access_type)
+{
+    switch (access_type)
+    {
+        case ES_FLASH_ACCESS_READ:
+            if (!*p_valid)
+            {
+                return FDS_ERR_NOT_FOUND;
+            }
+            memcpy(p_data, p_part, size_bytes);
+            break;
+
+        case ES_FLASH_ACCESS_WRITE:
+            memcpy(p_part, p_data, size_bytes);
+            *p_valid      = true;
+            m_batch_dirty = true;
+            break;
+
+        case ES_FLASH_ACCESS_CLEAR:
+            if (*p_valid)
+            {
+                memset(p_part, 0, size_bytes);
+                *p_valid      = false;
+                m_batch_dirty = true;
+            }
+            break;
+
+        default:
+            break;
+    }
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for staging or reading a part of the batch record that has a BATCH_VALID_* bit. */
+static ret_code_t batch_access_part(void            * p_part,
+                                    void            * p_data,
+                                    uint16_t          size_bytes,
+                                    uint32_t          valid_bit,
+                                    es_flash_access_t access_type)
+{
+    ret_code_t err_code;
+    bool       valid = ((m_batch.valid & valid_bit) != 0);
+
+    err_code = batch_access(p_part, p_data, size_bytes, &valid, access_type);
+
+    m_batch.valid = valid ? (m_batch.valid | valid_bit) : (m_batch.valid & ~valid_bit);
+
+    return err_code;
+}
+
+
+/**@brief Function for queuing the write of the staged lock key, if it was changed. */
+static ret_code_t lock_key_commit(void)
+{
+    ret_code_t err_code;
+
+    if (!m_lock_key_dirty)
+    {
+        return NRF_SUCCESS;
+    }
+
+    flash_access_params_t params = {
+        .record_key  = RECORD_KEY_LOCK_KEY,
+        .file_id     = FILE_ID_ES_FLASH_LOCK_KEY,
+        .p_chunk_buf = lock_key_buf,
+        .p_data      = m_lock_key,
+        .size_bytes  = SIZE_OF_LOCK_KEY,
+        .access_type = ES_FLASH_ACCESS_WRITE
+    };
+
+    err_code = access_flash_data(&params);
+    RETURN_IF_ERROR(err_code);
+    m_lock_key_dirty = false;
+
+    return NRF_SUCCESS;
+}
+
+
 ret_code_t es_flash_access_lock_key(uint8_t * p_lock_key, es_flash_access_t access_type)
 {
     flash_access_params_t params = {
@@ -205,6 +384,27 @@ ret_code_t es_flash_access_lock_key(uint8_t * p_lock_key, es_flash_access_t acce
         .access_type = access_type
     };
 
+    switch (access_type)
+    {
+        case ES_FLASH_ACCESS_READ:
+            if (m_lock_key_dirty)
+            {
+                memcpy(p_lock_key, m_lock_key, SIZE_OF_LOCK_KEY);
+                return NRF_SUCCESS;
+            }
+            break;
+
+        case ES_FLASH_ACCESS_WRITE:
+            // Written on the next commit.
+            memcpy(m_lock_key, p_lock_key, SIZE_OF_LOCK_KEY);
+            m_lock_key_dirty = true;
+            return NRF_SUCCESS;
+
+        default:
+            m_lock_key_dirty = false;
+            break;
+    }
+
     return access_flash_data(&params);
 }
 
@@ -212,20 +412,13 @@ ret_code_t es_flash_access_lock_key(uint8_t * p_lock_key, es_flash_access_t acce
 ret_code_t es_flash_access_beacon_config(es_flash_beacon_config_t * p_config,
                                          es_flash_access_t          access_type)
 {
-    uint32_t err_code;
-
-    flash_access_params_t params = {
-        .record_key  = RECORD_KEY_BEACON_CONFIG,
-        .file_id     = FILE_ID_ES_FLASH,
-        .p_chunk_buf = beacon_config_buf,
-        .p_data      = (uint8_t *) p_config,
-        .size_bytes  = sizeof(es_flash_beacon_config_t),
-        .access_type = access_type
-    };
+    batch_load();
 
-    err_code = access_flash_data(&params);
-
-    return err_code;
+    return batch_access_part(&m_batch.beacon_config,
+                             p_config,
+                             sizeof(es_flash_beacon_config_t),
+                             BATCH_VALID_BEACON_CONFIG,
+                             access_type);
 }
 
 
@@ -265,43 +458,98 @@ ret_code_t es_flash_access_slot_configs(uint8_t           slot_no,
                                         es_slot_t       * p_slot,
                                         es_flash_access_t access_type)
 {
+    ret_code_t err_code;
+    bool       valid;
+
     if (slot_no >= APP_MAX_ADV_SLOTS)
     {
         return NRF_ERROR_INVALID_PARAM;
     }
 
-    flash_access_params_t params = {
-        .record_key  = RECORD_KEY_SLOTS[slot_no],
-        .file_id     = FILE_ID_ES_FLASH,
-        .p_chunk_buf = slots_buf_p[slot_no],
-        .p_data      = (uint8_t *) p_slot,
-        .size_bytes  = sizeof(es_slot_t),
-        .access_type = access_type
-    };
+    batch_load();
 
-    return access_flash_data(&params);
+    valid    = !m_batch.flags.slot_is_empty[slot_no];
+    err_code = batch_access(&m_batch.slots[slot_no], p_slot, sizeof(es_slot_t), &valid, access_type);
+    m_batch.flags.slot_is_empty[slot_no] = !valid;
+
+    return err_code;
 }
 
 
 ret_code_t es_flash_access_flags(es_flash_flags_t * p_flags, es_flash_access_t access_type)
 {
+    batch_load();
+
+    return batch_access_part(&m_batch.flags,
+                             p_flags,
+                             sizeof(es_flash_flags_t),
+                             BATCH_VALID_FLAGS,
+                             access_type);
+}
+
+
+ret_code_t es_flash_commit(void)
+{
+    ret_code_t err_code;
+
+    err_code = lock_key_commit();
+    RETURN_IF_ERROR(err_code);
+
+    // After a factory reset, the file stays deleted until the reset on disconnection.
+    if (!m_batch_dirty || m_factory_reset)
+    {
+        return NRF_SUCCESS;
+    }
+
     flash_access_params_t params = {
-        .record_key  = RECORD_KEY_FLAGS,
+        .record_key  = RECORD_KEY_BATCH,
         .file_id     = FILE_ID_ES_FLASH,
-        .p_chunk_buf = flash_flags_buf,
-        .p_data      = (uint8_t *) p_flags,
-        .size_bytes  = sizeof(es_flash_flags_t),
-        .access_type = access_type
+        .p_chunk_buf = batch_buf,
+        .p_data      = (uint8_t *) &m_batch,
+        .size_bytes  = sizeof(flash_batch_t),
+        .access_type = ES_FLASH_ACCESS_WRITE
     };
 
-    return access_flash_data(&params);
+    err_code = access_flash_data(&params);
+    RETURN_IF_ERROR(err_code);
+    m_batch_dirty = false;
+
+    if (m_batch_legacy)
+    {
+        // The batch record is queued first, so the configuration is never lost.
+        params.access_type = ES_FLASH_ACCESS_CLEAR;
+
+        params.record_key = RECORD_KEY_FLAGS;
+        err_code = access_flash_data(&params);
+        RETURN_IF_ERROR(err_code);
+
+        params.record_key = RECORD_KEY_BEACON_CONFIG;
+        err_code = access_flash_data(&params);
+        RETURN_IF_ERROR(err_code);
+
+        for (uint32_t i = 0; i < APP_MAX_ADV_SLOTS; i++)
+        {
+            params.record_key = RECORD_KEY_SLOTS[i];
+            err_code = access_flash_data(&params);
+            RETURN_IF_ERROR(err_code);
+        }
+        m_batch_legacy = false;
+    }
+
+    return NRF_SUCCESS;
 }
 
 
 ret_code_t es_flash_factory_reset(void)
 {
+    ret_code_t ret_code;
+
+    // A staged lock key is kept: queue it before the reset that follows the disconnection.
+    ret_code = lock_key_commit();
+    RETURN_IF_ERROR(ret_code);
+
     // Delete everything except the lock key:
-    ret_code_t ret_code = fds_file_delete(FILE_ID_ES_FLASH);
+    ret_code = fds_file_delete(FILE_ID_ES_FLASH);
 
     if (ret_code == FDS_SUCCESS)
         m_factory_reset = true;
@@ -344,6 +592,11 @@ ret_code_t es_flash_init(void)
 
     m_factory_reset = false;
 
+    m_batch_loaded   = false;
+    m_batch_dirty    = false;
+    m_batch_legacy   = false;
+    m_lock_key_dirty = false;
+
     err_code = fds_register(fds_cb);
     RETURN_IF_ERROR(err_code);
 
@@ -24,6 +24,9 @@
  * @file
  * @defgroup eddystone_flash Flash access
  * @brief Types and functions to access the flash of the Eddystone beacon.
+ * @details The flags, the beacon configuration and the slots are kept in RAM and stored together
+ *          in one record by @ref es_flash_commit, so a configuration session costs one flash
+ *          write, and boot one read. Changes of the lock key are also kept until the commit.
  * @ingroup eddystone
  * @{
  */
@@ -34,6 +37,11 @@
     if (err_code != (FDS_ERR_NOT_FOUND)) APP_ERROR_CHECK(err_code);
 
 
+/**@brief Time without configuration writes after which the changes are committed while connected, in milliseconds. */
+#ifndef APP_CONFIG_FLASH_COMMIT_QUIET_MS
+#define APP_CONFIG_FLASH_COMMIT_QUIET_MS 10000
+#endif
+
 #define FLASH_OP_WAIT() uint32_t pending_ops = es_flash_num_pending_ops(); \
     while (pending_ops != 0)                                               \
     {                                                                      \
@@ -71,13 +79,9 @@ typedef enum
  *
  * @param[out,in]   p_config Pointer to the beacon configuration buffer.
  * @param[in]       access_type    Access type (see @ref es_flash_access_t).
- * @return          For possible return values, see:
- *                  - @ref fds_record_find_by_key
- *                  - @ref fds_record_open
- *                  - @ref fds_record_close
- *                  - @ref fds_record_write
- *                  - @ref fds_record_update
- *                  - @ref fds_record_delete
+ * @note            Writes and clears are staged in RAM, see @ref es_flash_commit.
+ * @retval          NRF_SUCCESS        If the access succeeded.
+ * @retval          FDS_ERR_NOT_FOUND  If there was no data to read.
  */
 ret_code_t es_flash_access_beacon_config(es_flash_beacon_config_t * p_config,
                                          es_flash_access_t          access_type);
@@ -105,13 +109,9 @@ ret_code_t es_flash_access_ecdh_key_pair(uint8_t         * p_priv_key,
  * @param[in]       slot_no        Slot index.
  * @param[out,in]   p_slot         Pointer to the slot configuration buffer.
  * @param[in]       access_type    Access type (see @ref es_flash_access_t).
- * @return          For possible return values, see:
- *                  - @ref fds_record_find_by_key
- *                  - @ref fds_record_open
- *                  - @ref fds_record_close
- *                  - @ref fds_record_write
- *                  - @ref fds_record_update
- *                  - @ref fds_record_delete
+ * @note            Writes and clears are staged in RAM, see @ref es_flash_commit.
+ * @retval          NRF_SUCCESS        If the access succeeded.
+ * @retval          FDS_ERR_NOT_FOUND  If there was no data to read.
  */
 ret_code_t es_flash_access_slot_configs(uint8_t           slot_no,
                                         es_slot_t   * p_slot,
@@ -122,6 +122,7 @@ ret_code_t es_flash_access_slot_configs(uint8_t           slot_no,
  *
  * @param[out,in]   p_lock_key     Pointer to the lock key buffer.
  * @param[in]       access_type    Access type (see @ref es_flash_access_t).
+ * @note            Writes are staged in RAM, see @ref es_flash_commit.
  * @return          For possible return values, see:
  *                  - @ref fds_record_find_by_key
  *                  - @ref fds_record_open
@@ -137,16 +138,25 @@ ret_code_t es_flash_access_lock_key(uint8_t * p_lock_key, es_flash_access_t acce
  *
  * @param[out,in]   p_flags        Pointer to the flag buffer.
  * @param[in]       access_type    Access type (see @ref es_flash_access_t).
+ * @note            Writes and clears are staged in RAM, see @ref es_flash_commit.
+ * @retval          NRF_SUCCESS        If the access succeeded.
+ * @retval          FDS_ERR_NOT_FOUND  If there was no data to read.
+ */
+ret_code_t es_flash_access_flags(es_flash_flags_t * p_flags, es_flash_access_t access_type);
+
+
+/**@brief Function for storing the changes of the flags, beacon configuration, slots and lock key.
+ *
+ * @details The flags, beacon configuration and slots are written as one record. Nothing is
+ *          written if there are no changes, or after @ref es_flash_factory_reset.
+ *
  * @return          For possible return values, see:
  *                  - @ref fds_record_find_by_key
- *                  - @ref fds_record_open
- *                  - @ref fds_record_close
  *                  - @ref fds_record_write
  *                  - @ref fds_record_update
  *                  - @ref fds_record_delete
-  */
-ret_code_t es_flash_access_flags(es_flash_flags_t * p_flags, es_flash_access_t access_type);
-
+ */
+ret_code_t es_flash_commit(void);
 
 /**@brief Function for retrieving the number of queued operations.
  * @return The number of operations that are queued.
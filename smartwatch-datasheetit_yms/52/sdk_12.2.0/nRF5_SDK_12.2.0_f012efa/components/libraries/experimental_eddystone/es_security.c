@@ -25,7 +25,7 @@
 #include "aes.h"
 #include "fds.h"
 #include "modes.h"
-#include "cifra_eax_aes.h"
+#include "cifra_eax_ecb.h"
 
 #define  TK_ROLLOVER            0x10000
 
@@ -428,8 +428,6 @@ void es_security_plain_eid_id_key_get(uint8_t slot_no, uint8_t * p_key_buffer)
 
 void es_security_tlm_to_etlm(uint8_t ik_slot_no, es_tlm_frame_t * p_tlm, es_etlm_frame_t * p_etlm)
 {
-    cf_prp prp;                                   // Describe the block cipher to use.
-
     uint8_t plain[TLM_DATA_SIZE] = {0};           // Plaintext tlm, without the frame byte and version.
     size_t  nplain               = TLM_DATA_SIZE; // Length of message plaintext.
 
@@ -471,14 +469,11 @@ void es_security_tlm_to_etlm(uint8_t ik_slot_no, es_tlm_frame_t * p_tlm, es_etlm
 
     // Encryption
     // --------------------------------------------------------------------------
-    cf_aes_context ctx;
-    cf_aes_init(&ctx, key, nkey);
-
-    prp.encrypt = (cf_prp_block)cf_aes_encrypt; // Encryption context
-    prp.decrypt = (cf_prp_block)cf_aes_decrypt; // Decryption context
-    prp.blocksz = ESCS_AES_KEY_SIZE;
+    // The block cipher is the ECB peripheral, used through the SoftDevice.
+    cf_ecb_context ctx;
+    cf_ecb_init(&ctx, key, nkey);
 
-    cf_eax_encrypt(&prp,
+    cf_eax_encrypt(&cf_ecb,
                    &ctx,
                    plain,   // Plaintext input, aka TLM
                    nplain,  // Length of TLM
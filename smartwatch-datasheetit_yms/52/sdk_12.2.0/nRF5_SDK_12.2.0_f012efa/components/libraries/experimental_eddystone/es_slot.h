@@ -124,6 +124,8 @@ void es_slot_on_write(uint8_t slot_no, uint8_t length, uint8_t * p_frame_data);
 
 
 /**@brief Function for writing the slot's configuration to flash.
+ *
+ * @details The configuration is staged, and stored by @ref es_flash_commit.
  *
  * @param[in] slot_no The index of the slot.
  */
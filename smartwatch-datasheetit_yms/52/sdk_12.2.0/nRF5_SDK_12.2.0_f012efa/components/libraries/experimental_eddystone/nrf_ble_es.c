@@ -8,6 +8,8 @@
 #include "es_adv.h"
 #include "es_security.h"
 #include "es_gatts.h"
+#include "app_timer.h"
+#include "app_scheduler.h"
 
 #define NRF_LOG_MODULE_NAME "NRF_BLE_ES"
 #include "nrf_log.h"
@@ -17,6 +19,8 @@ static uint16_t                       m_conn_handle = BLE_CONN_HANDLE_INVALID;
 static nrf_ble_escs_t                 m_ble_ecs;                                //!< Struct identifying the Eddystone Config Service.
 static nrf_ble_es_evt_handler_t       m_evt_handler;                            //!< Event handler.
 
+APP_TIMER_DEF(m_flash_commit_timer);                                            //!< Timer for committing the configuration when the client goes quiet.
+
 
 /**@brief Function for invoking registered callback.  
  *
@@ -108,6 +112,61 @@ static void lock_beacon(void)
 
 
 
+/**@brief Function for staging the configuration of all slots and the beacon, and committing it to flash. */
+static void flash_store(void)
+{
+    uint32_t                  err_code;
+    es_flash_flags_t          flash_flag = {{0}};
+    es_flash_beacon_config_t  beacon_config;
+    const es_slot_reg_t     * p_reg      = es_slot_get_registry();
+
+    for (uint8_t i = 0; i < APP_MAX_ADV_SLOTS; i++)
+    {
+        err_code = es_slot_write_to_flash(i);
+        APP_ERROR_CHECK(err_code);
+
+        flash_flag.slot_is_empty[i] = !p_reg->slots[i].configured;
+    }
+
+    err_code = es_flash_access_flags(&flash_flag, ES_FLASH_ACCESS_WRITE);
+    APP_ERROR_CHECK(err_code);
+
+    beacon_config.adv_interval       = es_adv_interval_get();
+    beacon_config.remain_connectable = es_adv_remain_connectable_get();
+
+    err_code = es_flash_access_beacon_config(&beacon_config, ES_FLASH_ACCESS_WRITE);
+    APP_ERROR_CHECK(err_code);
+
+    err_code = es_flash_commit();
+    APP_ERROR_CHECK(err_code);
+}
+
+
+/**@brief Function for committing the configuration from the main context, once the client went quiet. */
+static void flash_commit_evt(void * p_event_data, uint16_t event_size)
+{
+    UNUSED_PARAMETER(p_event_data);
+    UNUSED_PARAMETER(event_size);
+
+    if (m_conn_handle != BLE_CONN_HANDLE_INVALID)
+    {
+        flash_store();
+    }
+}
+
+
+/**@brief Timeout handler for the configuration commit timer. */
+static void flash_commit_timeout(void * p_context)
+{
+    uint32_t err_code;
+
+    UNUSED_PARAMETER(p_context);
+
+    err_code = app_sched_event_put(NULL, 0, flash_commit_evt);
+    APP_ERROR_CHECK(err_code);
+}
+
+
 /**@brief Function for handling BLE event from the SoftDevice.
  *
  * @param[in] p_ble_evt Pointer to BLE event.
@@ -116,8 +175,6 @@ static void on_ble_evt(ble_evt_t * p_ble_evt)
 {
     uint32_t                        err_code;
     nrf_ble_escs_lock_state_read_t  lock_state;
-    es_flash_flags_t                flash_flag    = {{0}};
-    const es_slot_reg_t           * p_reg         = es_slot_get_registry();
 
     switch (p_ble_evt->header.evt_id)
     {
@@ -128,23 +185,10 @@ static void on_ble_evt(ble_evt_t * p_ble_evt)
         case BLE_GAP_EVT_DISCONNECTED:
             m_conn_handle = BLE_CONN_HANDLE_INVALID;
 
-            for (uint8_t i = 0; i < APP_MAX_ADV_SLOTS; i++)
-            {
-                err_code = es_slot_write_to_flash(i);
-                APP_ERROR_CHECK(err_code);
-
-                flash_flag.slot_is_empty[i] = !p_reg->slots[i].configured;
-            }
-
-            err_code = es_flash_access_flags(&flash_flag, ES_FLASH_ACCESS_WRITE);
+            err_code = app_timer_stop(m_flash_commit_timer);
             APP_ERROR_CHECK(err_code);
 
-            es_flash_beacon_config_t beacon_config;
-            beacon_config.adv_interval       = es_adv_interval_get();
-            beacon_config.remain_connectable = es_adv_remain_connectable_get();
-
-            err_code = es_flash_access_beacon_config(&beacon_config, ES_FLASH_ACCESS_WRITE);
-            APP_ERROR_CHECK(err_code);
+            flash_store();
 
             // Check if the beacon should be locked on disconnection.
             err_code = nrf_ble_escs_get_lock_state(&m_ble_ecs, &lock_state);
@@ -159,6 +203,18 @@ static void on_ble_evt(ble_evt_t * p_ble_evt)
 
             break;
 
+        case BLE_GATTS_EVT_WRITE:
+        case BLE_GATTS_EVT_RW_AUTHORIZE_REQUEST:
+            // Restarted on every write, so the configuration is committed once the client goes quiet.
+            err_code = app_timer_stop(m_flash_commit_timer);
+            APP_ERROR_CHECK(err_code);
+
+            err_code = app_timer_start(m_flash_commit_timer,
+                                       APP_TIMER_TICKS(APP_CONFIG_FLASH_COMMIT_QUIET_MS, APP_TIMER_PRESCALER),
+                                       NULL);
+            APP_ERROR_CHECK(err_code);
+            break;
+
         default:
             // No implementation needed.
             break;
@@ -242,6 +298,9 @@ static void nrf_ble_escs_security_cb(uint8_t           slot_no,
             err_code = es_slot_write_to_flash(slot_no);
             APP_ERROR_CHECK(err_code);
 
+            err_code = es_flash_commit();
+            APP_ERROR_CHECK(err_code);
+
             break;
 
         default:
@@ -390,6 +449,11 @@ void nrf_ble_es_init(nrf_ble_es_evt_handler_t evt_handler)
         ; // Busy wait while initialization of FDS module completes
     }
 
+    err_code = app_timer_create(&m_flash_commit_timer,
+                                APP_TIMER_MODE_SINGLE_SHOT,
+                                flash_commit_timeout);
+    APP_ERROR_CHECK(err_code);
+
     err_code = es_security_init(nrf_ble_escs_security_cb);
     APP_ERROR_CHECK(err_code);
 
@@ -24,6 +24,10 @@
     #include "crc16.h"
 #endif
 
+#if NRF_MODULE_ENABLED(NRF_WARM_BOOT)
+    #include "nrf_warm_boot.h"
+#endif
+
 
 static void fs_event_handler(fs_evt_t const * const evt, fs_ret_t result);
 
@@ -65,6 +69,34 @@ static fds_swap_page_t      m_swap_page;
 // Garbage collection data.
 static fds_gc_data_t        m_gc;
 
+#if (FDS_INDEX_SIZE > 0)
+// RAM index of records.
+static fds_index_t          m_index;
+#endif
+
+#if NRF_MODULE_ENABLED(NRF_WARM_BOOT)
+// The state which is kept across a reset, instead of scanning the pages again.
+typedef struct
+{
+    uint32_t const * p_start_addr;          // The start of FDS flash, which may move after an update.
+    uint32_t         latest_rec_id;
+    fds_page_t       pages[FDS_MAX_PAGES];
+    fds_swap_page_t  swap_page;
+#if (FDS_INDEX_SIZE > 0)
+    fds_index_t      index;
+#endif
+} fds_warm_boot_t;
+
+static bool warm_boot_save(void * p_blob);
+
+static nrf_warm_boot_blob_t const m_warm_boot_blob =
+{
+    .id   = NRF_WARM_BOOT_ID_FDS,
+    .size = sizeof(fds_warm_boot_t),
+    .save = warm_boot_save,
+};
+#endif
+
 
 static void flag_set(fds_flags_t flag)
 {
@@ -123,6 +155,12 @@ static void event_prepare(fds_op_t const * const p_op, fds_evt_t * const p_evt)
             p_evt->write.is_record_updated = (p_op->write.step == FDS_OP_WRITE_DONE);
             break;
 
+        case FDS_OP_WRITE_BATCH:
+            p_evt->id                    = FDS_EVT_BATCH;
+            p_evt->batch.num_records     = p_op->batch.num_records;
+            p_evt->batch.records_written = p_op->batch.records_written;
+            break;
+
         case FDS_OP_DEL_RECORD:
             p_evt->id             = FDS_EVT_DEL_RECORD;
             p_evt->del.file_id    = p_op->del.file_id;
@@ -406,6 +444,264 @@ static bool record_find_next(uint16_t page, uint32_t const ** p_record)
 }
 
 
+#if (FDS_INDEX_SIZE > 0)
+
+static uint16_t index_offset(uint32_t const * const p_addr)
+{
+    return (uint16_t)(p_addr - fs_config.p_start_addr);
+}
+
+
+// Returns true if entry a should be sorted before entry b.
+static bool index_entry_less(fds_index_entry_t const * const p_a,
+                             fds_index_entry_t const * const p_b)
+{
+    if (p_a->record_key != p_b->record_key)
+    {
+        return (p_a->record_key < p_b->record_key);
+    }
+    return (p_a->offset < p_b->offset);
+}
+
+
+// Returns the position of the first entry which is not sorted before (record_key, offset).
+static uint16_t index_lower_bound(uint16_t record_key, uint32_t offset)
+{
+    uint16_t lo = 0;
+    uint16_t hi = m_index.count;
+
+    while (lo < hi)
+    {
+        uint16_t                  const mid     = lo + ((hi - lo) / 2);
+        fds_index_entry_t const * const p_entry = &m_index.entry[mid];
+
+        if ((p_entry->record_key < record_key) ||
+            ((p_entry->record_key == record_key) && (p_entry->offset < offset)))
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+
+static void index_sift_down(uint16_t root, uint16_t count)
+{
+    fds_index_entry_t tmp;
+
+    while ((2 * root + 1) < count)
+    {
+        uint16_t child = 2 * root + 1;
+
+        if ((child + 1 < count) &&
+            index_entry_less(&m_index.entry[child], &m_index.entry[child + 1]))
+        {
+            child++;
+        }
+
+        if (!index_entry_less(&m_index.entry[root], &m_index.entry[child]))
+        {
+            return;
+        }
+
+        tmp                  = m_index.entry[root];
+        m_index.entry[root]  = m_index.entry[child];
+        m_index.entry[child] = tmp;
+        root                 = child;
+    }
+}
+
+
+// Sort the index in place. Heapsort is used since it requires no additional memory.
+static void index_sort(void)
+{
+    fds_index_entry_t tmp;
+
+    if (m_index.count < 2)
+    {
+        return;
+    }
+
+    for (int32_t i = (m_index.count / 2) - 1; i >= 0; i--)
+    {
+        index_sift_down((uint16_t)i, m_index.count);
+    }
+
+    for (uint16_t end = m_index.count - 1; end > 0; end--)
+    {
+        tmp                = m_index.entry[0];
+        m_index.entry[0]   = m_index.entry[end];
+        m_index.entry[end] = tmp;
+        index_sift_down(0, end);
+    }
+}
+
+
+// Scan all data pages and rebuild the index from scratch.
+static void index_build(void)
+{
+    m_index.count    = 0;
+    m_index.overflow = false;
+    m_index.stale    = false;
+
+    for (uint16_t page = 0; (page < FDS_MAX_PAGES) && !m_index.overflow; page++)
+    {
+        uint32_t const * p_record = NULL;
+
+        if (m_pages[page].page_type != FDS_PAGE_DATA)
+        {
+            continue;
+        }
+
+        while (record_find_next(page, &p_record))
+        {
+            fds_header_t const * const p_header = (fds_header_t*)p_record;
+
+            if (m_index.count == FDS_INDEX_SIZE)
+            {
+                m_index.overflow = true;
+                break;
+            }
+
+            m_index.entry[m_index.count].record_key = p_header->tl.record_key;
+            m_index.entry[m_index.count].file_id    = p_header->ic.file_id;
+            m_index.entry[m_index.count].offset     = index_offset(p_record);
+            m_index.count++;
+        }
+    }
+
+    index_sort();
+}
+
+
+// Flag the index as out of sync with flash. It will be rebuilt the next time it is used.
+static void index_invalidate(void)
+{
+    CRITICAL_SECTION_ENTER();
+    m_index.stale = true;
+    CRITICAL_SECTION_EXIT();
+}
+
+
+// Add a record which has just been written to the index.
+static void index_add(uint32_t const * const p_record)
+{
+    fds_header_t const * const p_header = (fds_header_t*)p_record;
+    fds_index_entry_t    const entry    =
+    {
+        .record_key = p_header->tl.record_key,
+        .file_id    = p_header->ic.file_id,
+        .offset     = index_offset(p_record)
+    };
+
+    CRITICAL_SECTION_ENTER();
+    if (!m_index.stale && !m_index.overflow)
+    {
+        if (m_index.count == FDS_INDEX_SIZE)
+        {
+            m_index.overflow = true;
+        }
+        else
+        {
+            uint16_t const pos = index_lower_bound(entry.record_key, entry.offset);
+
+            memmove(&m_index.entry[pos + 1], &m_index.entry[pos],
+                    (m_index.count - pos) * sizeof(fds_index_entry_t));
+
+            m_index.entry[pos] = entry;
+            m_index.count++;
+        }
+    }
+    CRITICAL_SECTION_EXIT();
+}
+
+
+// Remove a record which is about to be flagged as dirty from the index.
+static void index_remove(uint32_t const * const p_record)
+{
+    fds_header_t const * const p_header = (fds_header_t*)p_record;
+    uint16_t             const offset   = index_offset(p_record);
+
+    CRITICAL_SECTION_ENTER();
+    if (m_index.overflow)
+    {
+        // Once this record is deleted, all records might fit in the index.
+        m_index.stale = true;
+    }
+    else if (!m_index.stale)
+    {
+        uint16_t const pos = index_lower_bound(p_header->tl.record_key, offset);
+
+        if ((pos < m_index.count) && (m_index.entry[pos].offset == offset))
+        {
+            memmove(&m_index.entry[pos], &m_index.entry[pos + 1],
+                    (m_index.count - pos - 1) * sizeof(fds_index_entry_t));
+            m_index.count--;
+        }
+    }
+    CRITICAL_SECTION_EXIT();
+}
+
+
+// Search the index for a record with the given key, and optionally the given file ID.
+// The search resumes after the record pointed to by the token, if any.
+// Returns FDS_ERR_NO_SPACE_IN_FLASH if the index cannot be used.
+static ret_code_t index_find(uint16_t          const * const p_file_id,
+                             uint16_t                        record_key,
+                             fds_record_desc_t       * const p_desc,
+                             fds_find_token_t        * const p_token)
+{
+    ret_code_t ret = FDS_ERR_NOT_FOUND;
+    uint32_t   offset;
+
+    CRITICAL_SECTION_ENTER();
+    if (m_index.stale)
+    {
+        index_build();
+    }
+
+    if (m_index.overflow)
+    {
+        ret = FDS_ERR_NO_SPACE_IN_FLASH;
+    }
+    else
+    {
+        offset = (p_token->p_addr == NULL) ? 0 : index_offset(p_token->p_addr) + 1;
+
+        for (uint16_t i = index_lower_bound(record_key, offset);
+             (i < m_index.count) && (m_index.entry[i].record_key == record_key);
+             i++)
+        {
+            if ((p_file_id != NULL) && (m_index.entry[i].file_id != *p_file_id))
+            {
+                continue;
+            }
+
+            p_token->p_addr = fs_config.p_start_addr + m_index.entry[i].offset;
+            (void)page_from_record(&p_token->page, p_token->p_addr);
+
+            // Record found; update the descriptor.
+            p_desc->record_id    = ((fds_header_t*)p_token->p_addr)->record_id;
+            p_desc->p_record     = p_token->p_addr;
+            p_desc->gc_run_count = m_gc.run_count;
+
+            ret = FDS_SUCCESS;
+            break;
+        }
+    }
+    CRITICAL_SECTION_EXIT();
+
+    return ret;
+}
+
+#endif // FDS_INDEX_SIZE > 0
+
+
 // Find a record given its descriptor and retrive the page in which the record is stored.
 // NOTE: Do not pass NULL as an argument for p_page.
 static bool record_find_by_desc(fds_record_desc_t * const p_desc, uint16_t * const p_page)
@@ -462,6 +758,19 @@ static ret_code_t record_find(uint16_t          const * const p_file_id,
         return FDS_ERR_NULL_ARG;
     }
 
+#if (FDS_INDEX_SIZE > 0)
+    if (p_record_key != NULL)
+    {
+        ret_code_t const ret = index_find(p_file_id, *p_record_key, p_desc, p_token);
+
+        if (ret != FDS_ERR_NO_SPACE_IN_FLASH)
+        {
+            return ret;
+        }
+        // The index is full; scan flash instead.
+    }
+#endif
+
     // Begin (or resume) searching for a record.
     for (; p_token->page < FDS_MAX_PAGES; p_token->page++)
     {
@@ -549,6 +858,54 @@ static bool queue_advance(void)
 }
 
 
+#if (FDS_GC_RECORDS_PER_STEP > 0)
+
+// Returns the number of write operations queued directly behind the operation being executed.
+// Only plain and batched writes are counted, since they cannot delete records which GC might
+// have copied.
+static uint32_t queue_writes_pending(void)
+{
+    uint32_t count = 0;
+
+    CRITICAL_SECTION_ENTER();
+    for (uint32_t i = 1; i < m_op_queue.count; i++)
+    {
+        uint32_t const idx = (m_op_queue.rp + i) % FDS_OP_QUEUE_SIZE;
+
+        if ((m_op_queue.op[idx].op_code != FDS_OP_WRITE) &&
+            (m_op_queue.op[idx].op_code != FDS_OP_WRITE_BATCH))
+        {
+            break;
+        }
+        count++;
+    }
+    CRITICAL_SECTION_EXIT();
+
+    return count;
+}
+
+
+// Move the operation being executed behind the write operations queued directly after it.
+// The order of writes is unchanged, so their chunks remain in order in the chunk queue.
+static void queue_yield(void)
+{
+    CRITICAL_SECTION_ENTER();
+    uint32_t const writes  = queue_writes_pending();
+    fds_op_t const current = m_op_queue.op[m_op_queue.rp];
+
+    for (uint32_t i = 0; i < writes; i++)
+    {
+        m_op_queue.op[(m_op_queue.rp + i) % FDS_OP_QUEUE_SIZE] =
+            m_op_queue.op[(m_op_queue.rp + i + 1) % FDS_OP_QUEUE_SIZE];
+    }
+
+    m_op_queue.op[(m_op_queue.rp + writes) % FDS_OP_QUEUE_SIZE] = current;
+    CRITICAL_SECTION_EXIT();
+}
+
+#endif
+
+
 // Given a pointer to an element in the chunk queue, computes the pointer to
 // the next element in the queue. Handles wrap around.
 void chunk_queue_next(fds_record_chunk_t ** pp_chunk)
@@ -605,6 +962,11 @@ static bool op_enqueue(fds_op_t           const * const p_op,
         m_op_queue.op[idx] = *p_op;
         m_op_queue.count++;
 
+#if NRF_MODULE_ENABLED(NRF_WARM_BOOT)
+        // The operation will change the pages.
+        nrf_warm_boot_invalidate(NRF_WARM_BOOT_ID_FDS);
+#endif
+
         if (num_chunks != 0)
         {
             idx = (m_chunk_queue.count + m_chunk_queue.rp) % FDS_CHUNK_QUEUE_SIZE;
@@ -629,6 +991,74 @@ static bool op_enqueue(fds_op_t           const * const p_op,
 }
 
 
+#if NRF_MODULE_ENABLED(NRF_WARM_BOOT)
+
+// Save the page structure, if no operation is in progress.
+static bool warm_boot_save(void * p_blob)
+{
+    fds_warm_boot_t * const p_state = (fds_warm_boot_t*)p_blob;
+
+    if (!flag_is_set(FDS_FLAG_INITIALIZED) || flag_is_set(FDS_FLAG_PROCESSING) ||
+        (m_op_queue.count != 0) || (m_gc.state != GC_BEGIN))
+    {
+        return false;
+    }
+
+    p_state->p_start_addr  = fs_config.p_start_addr;
+    p_state->latest_rec_id = m_latest_rec_id;
+    p_state->swap_page     = m_swap_page;
+    memcpy(p_state->pages, m_pages, sizeof(m_pages));
+#if (FDS_INDEX_SIZE > 0)
+    p_state->index = m_index;
+#endif
+
+    return true;
+}
+
+
+// Restore the page structure saved before a reset, instead of calling pages_init().
+// The page tags are checked, in case the pages were changed by someone else, for example
+// by the bootloader.
+static bool warm_boot_restore(void)
+{
+    fds_warm_boot_t const * const p_state =
+        nrf_warm_boot_get(NRF_WARM_BOOT_ID_FDS, sizeof(fds_warm_boot_t));
+
+    if ((p_state == NULL) || (p_state->p_start_addr != fs_config.p_start_addr) ||
+        (page_identify(p_state->swap_page.p_addr) != FDS_PAGE_SWAP))
+    {
+        return false;
+    }
+
+    for (uint16_t i = 0; i < FDS_MAX_PAGES; i++)
+    {
+        if ((p_state->pages[i].page_type == FDS_PAGE_DATA) &&
+            (page_identify(p_state->pages[i].p_addr) != FDS_PAGE_DATA))
+        {
+            return false;
+        }
+    }
+
+    m_latest_rec_id = p_state->latest_rec_id;
+    m_swap_page     = p_state->swap_page;
+    memcpy(m_pages, p_state->pages, sizeof(m_pages));
+#if (FDS_INDEX_SIZE > 0)
+    m_index = p_state->index;
+#endif
+
+    // Reservations and open records do not survive a reset.
+    for (uint16_t i = 0; i < FDS_MAX_PAGES; i++)
+    {
+        m_pages[i].words_reserved = 0;
+        m_pages[i].records_open   = 0;
+    }
+
+    return true;
+}
+
+#endif // NRF_MODULE_ENABLED(NRF_WARM_BOOT)
+
+
 // This function is called during initialization to setup the page structure (m_pages) and
 // provide additional information regarding eventual further initialization steps.
 static fds_init_opts_t pages_init()
@@ -715,6 +1145,23 @@ static fds_init_opts_t pages_init()
         }
     }
 
+#if (FDS_INDEX_SIZE > 0)
+    index_build();
+#endif
+
+#if (FDS_GC_AUTO_THRESHOLD_WORDS > 0)
+    for (uint16_t i = 0; i < page; i++)
+    {
+        uint16_t dirty_records = 0;
+
+        m_pages[i].dirty_words = 0;
+        if (m_pages[i].page_type == FDS_PAGE_DATA)
+        {
+            dirty_records_stat(i, &dirty_records, &m_pages[i].dirty_words);
+        }
+    }
+#endif
+
     return (fds_init_opts_t)ret;
 }
 
@@ -765,10 +1212,38 @@ static ret_code_t record_header_write_finalize(fds_op_t * const p_op, uint32_t *
 
 static ret_code_t record_header_flag_dirty(uint32_t * const p_record)
 {
+#if (FDS_INDEX_SIZE > 0)
+    // Remove the record from the index before its key is overwritten in flash.
+    index_remove(p_record);
+#endif
+
+#if (FDS_GC_AUTO_THRESHOLD_WORDS > 0)
+    uint16_t const record_len_words = FDS_HEADER_SIZE +
+                                      ((fds_header_t*)p_record)->tl.length_words;
+#endif
+
     // Flag the record as dirty.
     fs_ret_t ret = fs_store(&fs_config, p_record,
                             (uint32_t*)&m_fds_tl_dirty, FDS_HEADER_SIZE_TL, NULL);
 
+#if (FDS_GC_AUTO_THRESHOLD_WORDS > 0)
+    uint16_t page;
+    if ((ret == FS_SUCCESS) && (page_from_record(&page, p_record) == FDS_SUCCESS))
+    {
+        CRITICAL_SECTION_ENTER();
+        m_pages[page].dirty_words += record_len_words;
+        CRITICAL_SECTION_EXIT();
+    }
+#endif
+
+#if (FDS_INDEX_SIZE > 0)
+    if (ret != FS_SUCCESS)
+    {
+        // The record is still valid in flash.
+        index_invalidate();
+    }
+#endif
+
     return (ret == FS_SUCCESS) ? FDS_SUCCESS : FDS_ERR_BUSY;
 }
 
@@ -875,18 +1350,18 @@ static ret_code_t record_write_chunk(fds_op_t * const p_op, uint32_t * const p_a
 
 static bool crc_verify_success(uint16_t crc, uint16_t len_words, uint32_t const * const p_data)
 {
-    uint16_t computed_crc;
+    crc16_ctx_t ctx;
 
     // The CRC is computed on the entire record, except the CRC field itself.
     // The record header is 12 bytes, out of these we have to skip bytes 6 to 8 where the
     // CRC itself is stored. Then we compute the CRC for the rest of the record, from byte 8 of
     // the header (where the record ID begins) to the end of the record data.
-    computed_crc = crc16_compute((uint8_t const *)p_data,  6, NULL);
-    computed_crc = crc16_compute((uint8_t const *)p_data + 8,
-                                 (FDS_HEADER_SIZE_ID + len_words) * sizeof(uint32_t),
-                                 &computed_crc);
+    crc16_init(&ctx);
+    crc16_update(&ctx, (uint8_t const *)p_data, 6);
+    crc16_update(&ctx, (uint8_t const *)p_data + 8,
+                 (FDS_HEADER_SIZE_ID + len_words) * sizeof(uint32_t));
 
-    return (computed_crc == crc);
+    return (crc16_final(&ctx) == crc);
 }
 
 #endif
@@ -897,6 +1372,9 @@ static void gc_init(void)
     m_gc.run_count++;
     m_gc.cur_page = 0;
     m_gc.resume   = false;
+#if (FDS_GC_RECORDS_PER_STEP > 0)
+    m_gc.records_copied = 0;
+#endif
 
     // Setup which pages to GC. Defer checking for open records and the can_gc flag,
     // as other operations might change those while GC is running.
@@ -1055,6 +1533,16 @@ static void gc_swap_pages(void)
     // Keep the offset for this page, but reset it for the swap.
     m_pages[m_gc.cur_page].write_offset = m_swap_page.write_offset;
     m_swap_page.write_offset            = FDS_PAGE_TAG_SIZE;
+
+#if (FDS_GC_AUTO_THRESHOLD_WORDS > 0)
+    // Only valid records were copied.
+    m_pages[m_gc.cur_page].dirty_words = 0;
+#endif
+
+#if (FDS_INDEX_SIZE > 0)
+    // Records on this page have been moved.
+    index_invalidate();
+#endif
 }
 
 
@@ -1071,6 +1559,9 @@ static void gc_state_advance(void)
         case GC_COPY_RECORD:
             gc_update_swap_offset();
             m_gc.state = GC_FIND_NEXT_RECORD;
+#if (FDS_GC_RECORDS_PER_STEP > 0)
+            m_gc.records_copied++;
+#endif
             break;
 
         // A page was successfully erased. Prepare to promote the swap.
@@ -1166,6 +1657,13 @@ static ret_code_t init_execute(uint32_t prev_ret, fds_op_t * const p_op)
 
             m_pages[gc].page_type = FDS_PAGE_DATA;
             p_op->init.step       = FDS_OP_INIT_TAG_SWAP;
+#if (FDS_GC_AUTO_THRESHOLD_WORDS > 0)
+            m_pages[gc].dirty_words = 0;
+#endif
+
+#if (FDS_INDEX_SIZE > 0)
+            index_invalidate();
+#endif
         }
         break;
 
@@ -1199,6 +1697,10 @@ static ret_code_t write_execute(uint32_t prev_ret, fds_op_t * const p_op)
     {
         // The previous operation has timed out, update offsets.
         page_offsets_update(p_page, p_op->write.header.tl.length_words);
+#if (FDS_INDEX_SIZE > 0)
+        // The record might or might not be valid in flash.
+        index_invalidate();
+#endif
         return FDS_ERR_OPERATION_TIMEOUT;
     }
 
@@ -1250,6 +1752,10 @@ static ret_code_t write_execute(uint32_t prev_ret, fds_op_t * const p_op)
         case FDS_OP_WRITE_DONE:
             ret = FDS_OP_COMPLETED;
 
+#if (FDS_INDEX_SIZE > 0)
+            index_add(p_write_addr);
+#endif
+
 #if defined(FDS_CRC_ENABLED)
             if (flag_is_set(FDS_FLAG_VERIFY_CRC))
             {
@@ -1280,12 +1786,148 @@ static ret_code_t write_execute(uint32_t prev_ret, fds_op_t * const p_op)
 }
 
 
+// Writes the file ID and CRC of the record being finalized. These are stored at the end of the
+// batch buffer, in reverse order, so that the record header can be left erased until then.
+static ret_code_t batch_record_finalize(fds_op_t * const p_op, uint32_t * const p_addr)
+{
+    ret_code_t       ret;
+    uint32_t const * p_ic;
+
+    p_ic = p_op->batch.p_buffer + p_op->batch.buffer_words - 1 - p_op->batch.records_written;
+
+    ret = fs_store(&fs_config, p_addr + p_op->batch.record_offset + FDS_OFFSET_IC,
+                   p_ic, FDS_HEADER_SIZE_IC, NULL);
+
+    p_op->batch.step = FDS_OP_BATCH_NEXT_RECORD;
+
+    return (ret == FS_SUCCESS) ? FDS_SUCCESS : FDS_ERR_BUSY;
+}
+
+
+// Accounts for the record that has just been finalized, and moves on to the next one.
+static void batch_record_next(fds_op_t * const p_op, uint32_t * const p_addr)
+{
+    fds_header_t const * const p_header =
+        (fds_header_t const *)(p_op->batch.p_buffer + p_op->batch.record_offset);
+
+#if (FDS_INDEX_SIZE > 0)
+    index_add(p_addr + p_op->batch.record_offset);
+#endif
+
+    p_op->batch.record_offset += (FDS_HEADER_SIZE + p_header->tl.length_words);
+    p_op->batch.records_written++;
+}
+
+
+#if defined(FDS_CRC_ENABLED)
+
+static bool batch_crc_verify_success(fds_op_t const * const p_op, uint32_t const * const p_addr)
+{
+    uint16_t offset = 0;
+
+    for (uint16_t i = 0; i < p_op->batch.num_records; i++)
+    {
+        fds_header_t const * const p_header = (fds_header_t const *)(p_addr + offset);
+
+        if (!crc_verify_success(p_header->ic.crc16, p_header->tl.length_words, p_addr + offset))
+        {
+            return false;
+        }
+
+        offset += (FDS_HEADER_SIZE + p_header->tl.length_words);
+    }
+
+    return true;
+}
+
+#endif
+
+
+// Executes batch write operations.
+static ret_code_t batch_execute(uint32_t prev_ret, fds_op_t * const p_op)
+{
+    ret_code_t         ret;
+    uint32_t   *       p_write_addr;
+    fds_page_t * const p_page = &m_pages[p_op->batch.page];
+
+    // The space reserved for the batch accounts for one record header only.
+    uint16_t const length_words = p_op->batch.length_words - FDS_HEADER_SIZE;
+
+    if (prev_ret != FS_SUCCESS)
+    {
+        // The previous operation has timed out, update offsets.
+        page_offsets_update(p_page, length_words);
+#if (FDS_INDEX_SIZE > 0)
+        // The record being finalized might or might not be valid in flash.
+        index_invalidate();
+#endif
+        return FDS_ERR_OPERATION_TIMEOUT;
+    }
+
+    // Compute the address where the batch is written.
+    p_write_addr = (uint32_t*)(p_page->p_addr + p_page->write_offset);
+
+    switch (p_op->batch.step)
+    {
+        case FDS_OP_BATCH_WRITE_RECORDS:
+            // Write all record headers and data at once. The file ID and CRC of each record
+            // are left erased, so that records are not valid until they are finalized.
+            ret = fs_store(&fs_config, p_write_addr,
+                           p_op->batch.p_buffer, p_op->batch.length_words, NULL);
+            ret = (ret == FS_SUCCESS) ? FDS_SUCCESS : FDS_ERR_BUSY;
+
+            p_op->batch.step = FDS_OP_BATCH_FINALIZE;
+            break;
+
+        case FDS_OP_BATCH_NEXT_RECORD:
+            batch_record_next(p_op, p_write_addr);
+
+            if (p_op->batch.records_written == p_op->batch.num_records)
+            {
+                ret = FDS_OP_COMPLETED;
+
+#if defined(FDS_CRC_ENABLED)
+                if (flag_is_set(FDS_FLAG_VERIFY_CRC))
+                {
+                    if (!batch_crc_verify_success(p_op, p_write_addr))
+                    {
+                        ret = FDS_ERR_CRC_CHECK_FAILED;
+                    }
+                }
+#endif
+                break;
+            }
+            // Fallthrough to FDS_OP_BATCH_FINALIZE.
+
+        case FDS_OP_BATCH_FINALIZE:
+            ret = batch_record_finalize(p_op, p_write_addr);
+            break;
+
+        default:
+            ret = FDS_ERR_INTERNAL;
+            break;
+    }
+
+    if (ret != FDS_OP_EXECUTING)
+    {
+        // There won't be another callback for this operation, so update the page offset now.
+        page_offsets_update(p_page, length_words);
+    }
+
+    return ret;
+}
+
+
 static ret_code_t delete_execute(uint32_t prev_ret, fds_op_t * const p_op)
 {
     ret_code_t ret;
 
     if (prev_ret != FS_SUCCESS)
     {
+#if (FDS_INDEX_SIZE > 0)
+        // The record might still be valid in flash.
+        index_invalidate();
+#endif
         return FDS_ERR_OPERATION_TIMEOUT;
     }
 
@@ -1337,6 +1979,18 @@ static ret_code_t gc_execute(uint32_t prev_ret)
         gc_state_advance();
     }
 
+#if (FDS_GC_RECORDS_PER_STEP > 0)
+    if ((m_gc.state          == GC_FIND_NEXT_RECORD)     &&
+        (m_gc.records_copied >= FDS_GC_RECORDS_PER_STEP) &&
+        (queue_writes_pending() != 0))
+    {
+        // Let queued writes run, then resume by finding the next record to copy.
+        m_gc.records_copied = 0;
+        m_gc.resume         = true;
+        return FDS_OP_YIELD;
+    }
+#endif
+
     switch (m_gc.state)
     {
         case GC_NEXT_PAGE:
@@ -1374,6 +2028,38 @@ static ret_code_t gc_execute(uint32_t prev_ret)
 }
 
 
+#if (FDS_GC_AUTO_THRESHOLD_WORDS > 0)
+
+// Queue garbage collection if deleted records occupy enough flash, and it is not queued already.
+static void gc_auto_trigger(void)
+{
+    uint32_t dirty_words = 0;
+
+    if (m_gc.ops_queued != 0)
+    {
+        return;
+    }
+
+    for (uint16_t i = 0; i < FDS_MAX_PAGES; i++)
+    {
+        dirty_words += m_pages[i].dirty_words;
+    }
+
+    if (dirty_words >= FDS_GC_AUTO_THRESHOLD_WORDS)
+    {
+        fds_op_t op;
+        op.op_code = FDS_OP_GC;
+
+        if (op_enqueue(&op, 0, NULL))
+        {
+            m_gc.ops_queued++;
+        }
+    }
+}
+
+#endif
+
+
 static void queue_process(fs_ret_t result)
 {
     ret_code_t         ret;
@@ -1390,6 +2076,10 @@ static void queue_process(fs_ret_t result)
             ret = write_execute(result, p_op);
             break;
 
+        case FDS_OP_WRITE_BATCH:
+            ret = batch_execute(result, p_op);
+            break;
+
         case FDS_OP_DEL_RECORD:
         case FDS_OP_DEL_FILE:
             ret = delete_execute(result, p_op);
@@ -1404,6 +2094,16 @@ static void queue_process(fs_ret_t result)
             break;
     }
 
+#if (FDS_GC_RECORDS_PER_STEP > 0)
+    if (ret == FDS_OP_YIELD)
+    {
+        // Move the operation behind the queued writes, and process the first of them.
+        queue_yield();
+        queue_process(FS_SUCCESS);
+        return;
+    }
+#endif
+
     if (ret != FDS_OP_EXECUTING)
     {
         fds_evt_t evt;
@@ -1422,9 +2122,24 @@ static void queue_process(fs_ret_t result)
             chunk_queue_skip(p_op);
         }
 
+        if (p_op->op_code == FDS_OP_GC)
+        {
+            m_gc.ops_queued--;
+        }
+
         event_prepare(p_op, &evt);
         event_send(&evt);
 
+#if (FDS_GC_AUTO_THRESHOLD_WORDS > 0)
+        if ((ret == FDS_OP_COMPLETED) &&
+            ((p_op->op_code == FDS_OP_DEL_RECORD) ||
+             (p_op->op_code == FDS_OP_DEL_FILE)   ||
+             (p_op->op_code == FDS_OP_UPDATE)))
+        {
+            gc_auto_trigger();
+        }
+#endif
+
         // Advance the queue, and if there are any queued operations, process them.
         if (queue_advance())
         {
@@ -1467,6 +2182,9 @@ static ret_code_t write_enqueue(fds_record_desc_t         * const p_desc,
     uint16_t   page;
     uint16_t   crc          = 0;
     uint16_t   length_words = 0;
+#if defined(FDS_CRC_ENABLED)
+    crc16_ctx_t crc_ctx;
+#endif
 
     if (!flag_is_set(FDS_FLAG_INITIALIZED))
     {
@@ -1536,15 +2254,18 @@ static ret_code_t write_enqueue(fds_record_desc_t         * const p_desc,
 #if defined (FDS_CRC_ENABLED)
     // First, compute the CRC for the first 6 bytes of the header which contain the
     // record key, length and file ID, then, compute the CRC of the record ID (4 bytes).
-    crc = crc16_compute((uint8_t*)&op.write.header,           6, NULL);
-    crc = crc16_compute((uint8_t*)&op.write.header.record_id, 4, &crc);
+    crc16_init(&crc_ctx);
+    crc16_update(&crc_ctx, (uint8_t*)&op.write.header,           6);
+    crc16_update(&crc_ctx, (uint8_t*)&op.write.header.record_id, 4);
 
     for (uint32_t i = 0; i < p_record->data.num_chunks; i++)
     {
         // Compute the CRC for the record data.
-        crc = crc16_compute((uint8_t*)p_record->data.p_chunks[i].p_data,
-                            p_record->data.p_chunks[i].length_words * sizeof(uint32_t), &crc);
+        crc16_update(&crc_ctx, (uint8_t*)p_record->data.p_chunks[i].p_data,
+                     p_record->data.p_chunks[i].length_words * sizeof(uint32_t));
     }
+
+    crc = crc16_final(&crc_ctx);
 #endif
 
     op.write.header.ic.crc16 = crc;
@@ -1619,6 +2340,20 @@ ret_code_t fds_init(void)
 
     (void)fs_init();
 
+#if NRF_MODULE_ENABLED(NRF_WARM_BOOT)
+    // The blob may not fit, then the pages are always scanned.
+    (void)nrf_warm_boot_register(&m_warm_boot_blob);
+
+    if (warm_boot_restore())
+    {
+        flag_set(FDS_FLAG_INITIALIZED);
+        flag_clear(FDS_FLAG_INITIALIZING);
+
+        event_send(&evt_success);
+        return FDS_SUCCESS;
+    }
+#endif
+
     // Initialize the page structure (m_pages), and determine which
     // initialization steps are required given the current state of the filesystem.
     fds_init_opts_t init_opts = pages_init();
@@ -1849,6 +2584,183 @@ ret_code_t fds_record_write_reserved(fds_record_desc_t         * const p_desc,
 }
 
 
+ret_code_t fds_batch_begin(fds_batch_t * const p_batch,
+                           uint32_t    * const p_buffer,
+                           uint16_t            buffer_words)
+{
+    if ((p_batch == NULL) || (p_buffer == NULL))
+    {
+        return FDS_ERR_NULL_ARG;
+    }
+
+    if (!is_word_aligned(p_buffer))
+    {
+        return FDS_ERR_UNALIGNED_ADDR;
+    }
+
+    p_batch->p_buffer     = p_buffer;
+    p_batch->buffer_words = buffer_words;
+    p_batch->length_words = 0;
+    p_batch->num_records  = 0;
+
+    return FDS_SUCCESS;
+}
+
+
+ret_code_t fds_batch_add(fds_batch_t             * const p_batch,
+                         fds_record_t      const * const p_record,
+                         fds_record_desc_t       * const p_desc)
+{
+    fds_header_t   header;
+    uint32_t     * p_dst;
+    uint16_t       length_words = 0;
+#if defined(FDS_CRC_ENABLED)
+    crc16_ctx_t    crc_ctx;
+#endif
+
+    if (!flag_is_set(FDS_FLAG_INITIALIZED))
+    {
+        return FDS_ERR_NOT_INITIALIZED;
+    }
+
+    if ((p_batch == NULL) || (p_record == NULL))
+    {
+        return FDS_ERR_NULL_ARG;
+    }
+
+    if ((p_record->file_id == FDS_FILE_ID_INVALID) ||
+        (p_record->key     == FDS_RECORD_KEY_DIRTY))
+    {
+        return FDS_ERR_INVALID_ARG;
+    }
+
+    // Compute the total length of the record.
+    for (uint32_t i = 0; i < p_record->data.num_chunks; i++)
+    {
+        length_words += p_record->data.p_chunks[i].length_words;
+    }
+
+    if (p_batch->length_words + FDS_HEADER_SIZE + length_words >=
+        FDS_PAGE_SIZE - FDS_PAGE_TAG_SIZE)
+    {
+        return FDS_ERR_RECORD_TOO_LARGE;
+    }
+
+    // One more word is needed at the end of the buffer to hold the file ID and CRC.
+    if (p_batch->length_words + FDS_HEADER_SIZE + length_words + p_batch->num_records + 1 >
+        p_batch->buffer_words)
+    {
+        return FDS_ERR_NO_SPACE_IN_QUEUES;
+    }
+
+    header.record_id       = record_id_new();
+    header.ic.file_id      = p_record->file_id;
+    header.ic.crc16        = 0;
+    header.tl.record_key   = p_record->key;
+    header.tl.length_words = length_words;
+
+    // Copy the header, with the file ID and CRC left erased, followed by the record data.
+    p_dst = p_batch->p_buffer + p_batch->length_words;
+
+    memcpy(p_dst, &header, sizeof(fds_header_t));
+    p_dst[FDS_OFFSET_IC] = FDS_ERASED_WORD;
+    p_dst += FDS_HEADER_SIZE;
+
+    for (uint32_t i = 0; i < p_record->data.num_chunks; i++)
+    {
+        memcpy(p_dst, p_record->data.p_chunks[i].p_data,
+               p_record->data.p_chunks[i].length_words * sizeof(uint32_t));
+        p_dst += p_record->data.p_chunks[i].length_words;
+    }
+
+#if defined(FDS_CRC_ENABLED)
+    // Compute the CRC for the first 6 bytes of the header which contain the record key, length
+    // and file ID, then for the record ID and data, which follow the header in the buffer.
+    crc16_init(&crc_ctx);
+    crc16_update(&crc_ctx, (uint8_t*)&header, 6);
+    crc16_update(&crc_ctx, (uint8_t*)(p_batch->p_buffer + p_batch->length_words + FDS_OFFSET_ID),
+                 (FDS_HEADER_SIZE_ID + length_words) * sizeof(uint32_t));
+
+    header.ic.crc16 = crc16_final(&crc_ctx);
+#endif
+
+    // Store the file ID and CRC at the end of the buffer, until the record is finalized.
+    memcpy(p_batch->p_buffer + p_batch->buffer_words - 1 - p_batch->num_records,
+           &header.ic, sizeof(fds_ic_t));
+
+    p_batch->length_words += (FDS_HEADER_SIZE + length_words);
+    p_batch->num_records++;
+
+    // Initialize the record descriptor, if provided.
+    if (p_desc != NULL)
+    {
+        p_desc->p_record       = NULL;
+        p_desc->record_id      = header.record_id;
+        p_desc->record_is_open = false;
+        p_desc->gc_run_count   = m_gc.run_count;
+    }
+
+    return FDS_SUCCESS;
+}
+
+
+ret_code_t fds_batch_commit(fds_batch_t const * const p_batch)
+{
+    ret_code_t ret;
+    fds_op_t   op;
+    uint16_t   page;
+
+    if (!flag_is_set(FDS_FLAG_INITIALIZED))
+    {
+        return FDS_ERR_NOT_INITIALIZED;
+    }
+
+    if (p_batch == NULL)
+    {
+        return FDS_ERR_NULL_ARG;
+    }
+
+    if (p_batch->num_records == 0)
+    {
+        return FDS_ERR_INVALID_ARG;
+    }
+
+    // Reserve space for the whole batch on a single page. The reservation
+    // accounts for one record header, which is already part of the batch length.
+    ret = write_space_reserve(p_batch->length_words - FDS_HEADER_SIZE, &page);
+
+    if (ret != FDS_SUCCESS)
+    {
+        return ret;
+    }
+
+    op.op_code               = FDS_OP_WRITE_BATCH;
+    op.batch.step            = FDS_OP_BATCH_WRITE_RECORDS;
+    op.batch.page            = page;
+    op.batch.p_buffer        = p_batch->p_buffer;
+    op.batch.buffer_words    = p_batch->buffer_words;
+    op.batch.length_words    = p_batch->length_words;
+    op.batch.num_records     = p_batch->num_records;
+    op.batch.records_written = 0;
+    op.batch.record_offset   = 0;
+
+    if (!op_enqueue(&op, 0, NULL))
+    {
+        // No space availble in the queues. Cancel the reservation of flash space.
+        CRITICAL_SECTION_ENTER();
+        write_space_free(p_batch->length_words - FDS_HEADER_SIZE, page);
+        CRITICAL_SECTION_EXIT();
+
+        return FDS_ERR_NO_SPACE_IN_QUEUES;
+    }
+
+    // Start processing the queue, if necessary.
+    queue_start();
+
+    return FDS_SUCCESS;
+}
+
+
 ret_code_t fds_record_update(fds_record_desc_t       * const p_desc,
                              fds_record_t      const * const p_record)
 {
@@ -1931,12 +2843,14 @@ ret_code_t fds_gc(void)
 
     if (op_enqueue(&op, 0, NULL))
     {
-        if (m_gc.state != GC_BEGIN)
+        if ((m_gc.state != GC_BEGIN) && (m_gc.ops_queued == 0))
         {
             // Resume GC by retrying the last step.
             m_gc.resume = true;
         }
 
+        m_gc.ops_queued++;
+
         queue_start();
         return FDS_SUCCESS;
     }
@@ -178,6 +178,32 @@ typedef struct
 } fds_reserve_token_t;
 
 
+/**@brief   Macro for computing the size of the buffer needed by a batch of records.
+ *
+ * Each record in a batch takes the size of its data, plus three words for its header and one
+ * word to hold its file ID and CRC until they are written to flash.
+ *
+ * @param[in]   num_records     The number of records in the batch.
+ * @param[in]   data_words      The total length of the data of all records (in 4-byte words).
+ */
+#define FDS_BATCH_BUFFER_WORDS(num_records, data_words)  ((data_words) + (4 * (num_records)))
+
+
+/**@brief   A batch of records to be written to flash in one operation, created by
+ *          @ref fds_batch_begin.
+ *
+ * Records are copied into the buffer by @ref fds_batch_add and written to flash by
+ * @ref fds_batch_commit. You should never modify any of the fields of this structure.
+ */
+typedef struct
+{
+    uint32_t * p_buffer;        //!< The buffer where records are staged.
+    uint16_t   buffer_words;    //!< The size of the buffer (in 4-byte words).
+    uint16_t   length_words;    //!< The size of the records in the buffer, including headers.
+    uint16_t   num_records;     //!< The number of records in the batch.
+} fds_batch_t;
+
+
 /**@brief   A token to keep information about the progress of @ref fds_record_find,
  *          @ref fds_record_find_by_key, and @ref fds_record_find_in_file.
  *
@@ -200,7 +226,8 @@ typedef enum
     FDS_EVT_UPDATE,     //!< Event for @ref fds_record_update.
     FDS_EVT_DEL_RECORD, //!< Event for @ref fds_record_delete.
     FDS_EVT_DEL_FILE,   //!< Event for @ref fds_file_delete.
-    FDS_EVT_GC          //!< Event for @ref fds_gc.
+    FDS_EVT_GC,         //!< Event for @ref fds_gc.
+    FDS_EVT_BATCH       //!< Event for @ref fds_batch_commit.
 } fds_evt_id_t;
 
 
@@ -239,6 +266,11 @@ typedef struct
             uint16_t pages_skipped;
             uint16_t space_reclaimed;
         } gc;
+        struct
+        {
+            uint16_t num_records;
+            uint16_t records_written;
+        } batch; //!< Information for @ref FDS_EVT_BATCH events.
     };
 } fds_evt_t;
 
@@ -422,6 +454,80 @@ ret_code_t fds_record_write_reserved(fds_record_desc_t         * const p_desc,
                                      fds_reserve_token_t const * const p_token);
 
 
+/**@brief   Function for starting a batch of records.
+ *
+ * A batch allows writing several records with a single operation. The records are copied into
+ * @p p_buffer as they are added using @ref fds_batch_add, and are written to flash contiguously,
+ * on the same virtual page, when the batch is committed using @ref fds_batch_commit. This
+ * requires fewer flash operations than writing each record using @ref fds_record_write, and only
+ * one event is sent when the whole batch has been written.
+ *
+ * Use @ref FDS_BATCH_BUFFER_WORDS to compute the size of the buffer.
+ *
+ * @param[out]  p_batch         The batch to initialize.
+ * @param[in]   p_buffer        The buffer where records are staged. Must be word-aligned.
+ * @param[in]   buffer_words    The size of @p p_buffer (in 4-byte words).
+ *
+ * @retval  FDS_SUCCESS             If the batch was initialized successfully.
+ * @retval  FDS_ERR_NULL_ARG        If @p p_batch or @p p_buffer is NULL.
+ * @retval  FDS_ERR_UNALIGNED_ADDR  If @p p_buffer is not aligned to a 4 byte boundary.
+ */
+ret_code_t fds_batch_begin(fds_batch_t * const p_batch,
+                           uint32_t    * const p_buffer,
+                           uint16_t            buffer_words);
+
+
+/**@brief   Function for adding a record to a batch.
+ *
+ * The same restrictions as in @ref fds_record_write apply to the file ID and the record key.
+ * The record data is copied into the batch buffer, so it does not need to be kept in memory after
+ * this function returns. The whole batch, including record headers, must fit on one virtual page.
+ *
+ * A record ID is assigned to the record when it is added to the batch. The record cannot be
+ * found or opened until the batch has been written to flash.
+ *
+ * @param[in,out]   p_batch     The batch to add the record to.
+ * @param[in]       p_record    The record to be added.
+ * @param[out]      p_desc      The descriptor of the record. Pass NULL if you do not need the
+ *                              descriptor.
+ *
+ * @retval  FDS_SUCCESS                 If the record was added successfully.
+ * @retval  FDS_ERR_NOT_INITIALIZED     If the module is not initialized.
+ * @retval  FDS_ERR_NULL_ARG            If @p p_batch or @p p_record is NULL.
+ * @retval  FDS_ERR_INVALID_ARG         If the file ID or the record key is invalid.
+ * @retval  FDS_ERR_RECORD_TOO_LARGE    If the batch would not fit on a virtual page.
+ * @retval  FDS_ERR_NO_SPACE_IN_QUEUES  If there is not enough space left in the batch buffer.
+ */
+ret_code_t fds_batch_add(fds_batch_t             * const p_batch,
+                         fds_record_t      const * const p_record,
+                         fds_record_desc_t       * const p_desc);
+
+
+/**@brief   Function for writing a batch of records to flash.
+ *
+ * The buffer of the batch must be kept in memory until the @ref FDS_EVT_BATCH event has been
+ * received. The records are written to flash with a single operation: first, the headers and
+ * data of all records are written in one go, then each record is made valid by writing its file
+ * ID and CRC. If the operation fails, @c records_written in the event tells how many of the
+ * records in the batch have been stored.
+ *
+ * This function is asynchronous. Completion is reported through an event that is sent to the
+ * registered event handler function.
+ *
+ * @param[in]   p_batch     The batch to be written.
+ *
+ * @retval  FDS_SUCCESS                 If the operation was queued successfully.
+ * @retval  FDS_ERR_NOT_INITIALIZED     If the module is not initialized.
+ * @retval  FDS_ERR_NULL_ARG            If @p p_batch is NULL.
+ * @retval  FDS_ERR_INVALID_ARG         If the batch contains no records.
+ * @retval  FDS_ERR_RECORD_TOO_LARGE    If the batch exceeds the size of a virtual page.
+ * @retval  FDS_ERR_NO_SPACE_IN_QUEUES  If the operation queue is full.
+ * @retval  FDS_ERR_NO_SPACE_IN_FLASH   If there is not enough free space in flash to store the
+ *                                      batch.
+ */
+ret_code_t fds_batch_commit(fds_batch_t const * const p_batch);
+
+
 /**@brief   Function for deleting a record.
  *
  * Deleted records cannot be located using @ref fds_record_find, @ref fds_record_find_by_key, or
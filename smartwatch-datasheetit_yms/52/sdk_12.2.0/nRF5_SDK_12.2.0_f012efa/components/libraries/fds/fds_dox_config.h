@@ -67,5 +67,42 @@
 #define FDS_VIRTUAL_PAGE_SIZE
 
 
+/** @brief Number of records that can be tracked by the RAM index.
+ *
+ * When set to a value other than zero, FDS keeps a sorted index of (record key, file ID)
+ * pairs in RAM, and uses it to serve @ref fds_record_find and @ref fds_record_find_by_key
+ * without scanning flash. Each entry costs six bytes of RAM. If flash holds more records
+ * than the index can track, FDS falls back to scanning flash.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define FDS_INDEX_SIZE
+
+
+/** @brief Number of records garbage collection copies before it yields to queued writes.
+ *
+ * When set to a value other than zero, garbage collection is split into steps. After copying
+ * this many records, it lets any record writes queued behind it run before it continues.
+ * Set to zero to run garbage collection to completion as one operation.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define FDS_GC_RECORDS_PER_STEP
+
+
+/** @brief Amount of flash occupied by deleted records, in 4-byte words, that triggers garbage collection.
+ *
+ * When set to a value other than zero, FDS queues garbage collection by itself when a delete
+ * or update operation makes the amount of freeable flash reach this threshold.
+ * The @ref FDS_EVT_GC event is sent when it completes. Set to zero to disable.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define FDS_GC_AUTO_THRESHOLD_WORDS
+
+
 
 /** @} */
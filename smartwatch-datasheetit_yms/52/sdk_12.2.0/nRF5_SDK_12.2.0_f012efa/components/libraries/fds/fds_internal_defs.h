@@ -48,6 +48,7 @@ extern "C" {
 
 #define FDS_OP_EXECUTING        (FS_SUCCESS)
 #define FDS_OP_COMPLETED        (0x1D1D)
+#define FDS_OP_YIELD            (0x1D1E) // The operation is suspended to let other queued operations run.
 
 // The size of a physical page, in 4-byte words.
 #if     defined(NRF51)
@@ -77,6 +78,22 @@ extern "C" {
     #error "FDS requires at least two virtual pages."
 #endif
 
+#ifndef FDS_INDEX_SIZE
+    #define FDS_INDEX_SIZE      (0)
+#endif
+
+#ifndef FDS_GC_RECORDS_PER_STEP
+    #define FDS_GC_RECORDS_PER_STEP     (0)
+#endif
+
+#ifndef FDS_GC_AUTO_THRESHOLD_WORDS
+    #define FDS_GC_AUTO_THRESHOLD_WORDS (0)
+#endif
+
+#if ((FDS_INDEX_SIZE > 0) && (FDS_VIRTUAL_PAGES * FDS_VIRTUAL_PAGE_SIZE > 0x10000))
+    #error "The FDS record index can only address up to 65536 words of flash."
+#endif
+
 
 // FDS internal status flags.
 typedef enum
@@ -106,6 +123,9 @@ typedef struct
     uint16_t                words_reserved; // The amount of words reserved by fds_write_reserve().
     uint16_t                records_open;   // The number of records opened using fds_open().
     bool                    can_gc;         // Indicates that there are some records that have been deleted.
+#if (FDS_GC_AUTO_THRESHOLD_WORDS > 0)
+    uint16_t                dirty_words;    // The amount of words occupied by dirty records.
+#endif
 } fds_page_t;
 
 
@@ -123,6 +143,7 @@ typedef enum
     FDS_OP_INIT,        // Initialize the module.
     FDS_OP_WRITE,       // Write a record to flash.
     FDS_OP_UPDATE,      // Update a record.
+    FDS_OP_WRITE_BATCH, // Write a batch of records to flash.
     FDS_OP_DEL_RECORD,  // Delete a record.
     FDS_OP_DEL_FILE,    // Delete a file.
     FDS_OP_GC           // Run garbage collection.
@@ -150,6 +171,14 @@ typedef enum
 } fds_write_step_t;
 
 
+typedef enum
+{
+    FDS_OP_BATCH_WRITE_RECORDS,     // Write the headers and data of all records in the batch.
+    FDS_OP_BATCH_FINALIZE,          // Write the file ID and CRC of a record.
+    FDS_OP_BATCH_NEXT_RECORD,       // Move on to the next record to finalize.
+} fds_batch_step_t;
+
+
 typedef enum
 {
     FDS_OP_DEL_RECORD_FLAG_DIRTY,   // Flag a record as dirty.
@@ -186,6 +215,17 @@ typedef struct
             uint32_t         record_to_delete;  // The record to delete in case this is an update.
         } write;
         struct
+        {
+            uint32_t const * p_buffer;          // The buffer holding the batch, see fds_batch_t.
+            uint16_t         buffer_words;      // The size of the buffer, in 4-byte words.
+            fds_batch_step_t step;              // The current step the operation is at.
+            uint16_t         page;              // The page the flash space for the batch was reserved.
+            uint16_t         length_words;      // The size of the batch in flash, in 4-byte words.
+            uint16_t         num_records;       // Number of records in the batch.
+            uint16_t         records_written;   // Number of records which have been finalized.
+            uint16_t         record_offset;     // Offset of the record being finalized, in 4-byte words.
+        } batch;
+        struct
         {
             fds_delete_step_t step;
             uint16_t          file_id;
@@ -288,9 +328,36 @@ typedef struct
     uint16_t         run_count;                 // Total number of times GC was run.
     bool             do_gc_page[FDS_MAX_PAGES]; // Controls which pages to garbage collect.
     bool             resume;                    // Whether or not GC should be resumed.
+    uint8_t          ops_queued;                // Number of GC operations in the queue.
+#if (FDS_GC_RECORDS_PER_STEP > 0)
+    uint16_t         records_copied;            // Number of records copied since GC last yielded.
+#endif
 } fds_gc_data_t;
 
 
+#if (FDS_INDEX_SIZE > 0)
+
+// An entry in the RAM index of records. Entries are sorted by record key, then by address.
+typedef struct
+{
+    uint16_t record_key;    // The record key.
+    uint16_t file_id;       // The file ID.
+    uint16_t offset;        // The address of the record, in 4-byte words from the start of FDS flash.
+} fds_index_entry_t;
+
+
+// RAM index of records, used to speed up searching by record key.
+typedef struct
+{
+    fds_index_entry_t entry[FDS_INDEX_SIZE];
+    uint16_t          count;    // Number of entries in the index.
+    bool              stale;    // The index is out of sync with flash and must be rebuilt before use.
+    bool              overflow; // There are more records in flash than entries in the index.
+} fds_index_t;
+
+#endif // FDS_INDEX_SIZE > 0
+
+
 // Macros to enable and disable application interrupts.
 #if defined (FDS_THREADS)
 
@@ -12,6 +12,7 @@
 #include "sdk_common.h"
 #if NRF_MODULE_ENABLED(APP_FIFO)
 #include "app_fifo.h"
+#include <string.h>
 
 static __INLINE uint32_t fifo_length(app_fifo_t * p_fifo)
 {
@@ -46,6 +47,30 @@ static __INLINE void fifo_get(app_fifo_t * p_fifo, uint8_t * p_byte)
 }
 
 
+/**@brief Copy bytes out of the FIFO memory, starting at the read position. The copy is split
+ *        at the end of the buffer. The read position is not changed. */
+static void fifo_copy_out(app_fifo_t * p_fifo, uint8_t * p_dst, uint32_t size)
+{
+    uint32_t offset = p_fifo->read_pos & p_fifo->buf_size_mask;
+    uint32_t first  = MIN(size, (uint32_t)p_fifo->buf_size_mask + 1 - offset);
+
+    memcpy(p_dst, &p_fifo->p_buf[offset], first);
+    memcpy(&p_dst[first], p_fifo->p_buf, size - first);
+}
+
+
+/**@brief Copy bytes into the FIFO memory, starting at the write position. The copy is split
+ *        at the end of the buffer. The write position is not changed. */
+static void fifo_copy_in(app_fifo_t * p_fifo, uint8_t const * p_src, uint32_t size)
+{
+    uint32_t offset = p_fifo->write_pos & p_fifo->buf_size_mask;
+    uint32_t first  = MIN(size, (uint32_t)p_fifo->buf_size_mask + 1 - offset);
+
+    memcpy(&p_fifo->p_buf[offset], p_src, first);
+    memcpy(p_fifo->p_buf, &p_src[first], size - first);
+}
+
+
 uint32_t app_fifo_init(app_fifo_t * p_fifo, uint8_t * p_buf, uint16_t buf_size)
 {
     // Check buffer for null pointer.
@@ -120,7 +145,6 @@ uint32_t app_fifo_read(app_fifo_t * p_fifo, uint8_t * p_byte_array, uint32_t * p
 
     const uint32_t byte_count    = fifo_length(p_fifo);
     const uint32_t requested_len = (*p_size);
-    uint32_t       index         = 0;
     uint32_t       read_size     = MIN(requested_len, byte_count);
 
     (*p_size) = byte_count;
@@ -138,10 +162,8 @@ uint32_t app_fifo_read(app_fifo_t * p_fifo, uint8_t * p_byte_array, uint32_t * p
     }
 
     // Fetch bytes from the FIFO.
-    while (index < read_size)
-    {
-        fifo_get(p_fifo, &p_byte_array[index++]);
-    }
+    fifo_copy_out(p_fifo, p_byte_array, read_size);
+    p_fifo->read_pos += read_size;
 
     (*p_size) = read_size;
 
@@ -156,7 +178,6 @@ uint32_t app_fifo_write(app_fifo_t * p_fifo, uint8_t const * p_byte_array, uint3
 
     const uint32_t available_count = p_fifo->buf_size_mask - fifo_length(p_fifo) + 1;
     const uint32_t requested_len   = (*p_size);
-    uint32_t       index           = 0;
     uint32_t       write_size      = MIN(requested_len, available_count);
 
     (*p_size) = available_count;
@@ -173,13 +194,87 @@ uint32_t app_fifo_write(app_fifo_t * p_fifo, uint8_t const * p_byte_array, uint3
         return NRF_SUCCESS;
     }
 
-    //Fetch bytes from the FIFO.
-    while (index < write_size)
+    // Put bytes to the FIFO.
+    fifo_copy_in(p_fifo, p_byte_array, write_size);
+    p_fifo->write_pos += write_size;
+
+    (*p_size) = write_size;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_fifo_read_span(app_fifo_t * p_fifo, uint8_t ** pp_data, uint32_t * p_size)
+{
+    VERIFY_PARAM_NOT_NULL(p_fifo);
+    VERIFY_PARAM_NOT_NULL(pp_data);
+    VERIFY_PARAM_NOT_NULL(p_size);
+
+    const uint32_t byte_count = fifo_length(p_fifo);
+    const uint32_t offset     = p_fifo->read_pos & p_fifo->buf_size_mask;
+
+    (*p_size) = MIN(byte_count, (uint32_t)p_fifo->buf_size_mask + 1 - offset);
+
+    // Check if the FIFO is empty.
+    if (byte_count == 0)
     {
-        fifo_put(p_fifo, p_byte_array[index++]);
+        return NRF_ERROR_NOT_FOUND;
     }
 
-    (*p_size) = write_size;
+    (*pp_data) = &p_fifo->p_buf[offset];
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_fifo_read_span_commit(app_fifo_t * p_fifo, uint32_t size)
+{
+    VERIFY_PARAM_NOT_NULL(p_fifo);
+
+    if (size > fifo_length(p_fifo))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    p_fifo->read_pos += size;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_fifo_write_span(app_fifo_t * p_fifo, uint8_t ** pp_data, uint32_t * p_size)
+{
+    VERIFY_PARAM_NOT_NULL(p_fifo);
+    VERIFY_PARAM_NOT_NULL(pp_data);
+    VERIFY_PARAM_NOT_NULL(p_size);
+
+    const uint32_t available_count = p_fifo->buf_size_mask - fifo_length(p_fifo) + 1;
+    const uint32_t offset          = p_fifo->write_pos & p_fifo->buf_size_mask;
+
+    (*p_size) = MIN(available_count, (uint32_t)p_fifo->buf_size_mask + 1 - offset);
+
+    // Check if the FIFO is FULL.
+    if (available_count == 0)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    (*pp_data) = &p_fifo->p_buf[offset];
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_fifo_write_span_commit(app_fifo_t * p_fifo, uint32_t size)
+{
+    VERIFY_PARAM_NOT_NULL(p_fifo);
+
+    if (size > (p_fifo->buf_size_mask - fifo_length(p_fifo) + 1))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    p_fifo->write_pos += size;
 
     return NRF_SUCCESS;
 }
@@ -144,6 +144,59 @@ uint32_t app_fifo_read(app_fifo_t * p_fifo, uint8_t * p_byte_array, uint32_t * p
  */
 uint32_t app_fifo_write(app_fifo_t * p_fifo, uint8_t const * p_byte_array, uint32_t * p_size);
 
+/**@brief Function for getting the contiguous block of data at the start of the FIFO.
+ *
+ * The data can be used in place, for example as the source of a DMA transfer. The block
+ * ends at the end of the FIFO data or at the end of the buffer, whichever comes first. The
+ * data stay in the FIFO until @ref app_fifo_read_span_commit is called.
+ *
+ * @param[in]  p_fifo   Pointer to the FIFO. Must not be NULL.
+ * @param[out] pp_data  Address of the block.
+ * @param[out] p_size   Number of bytes in the block.
+ *
+ * @retval     NRF_SUCCESS          If the procedure is successful.
+ * @retval     NRF_ERROR_NULL       If a NULL parameter was passed.
+ * @retval     NRF_ERROR_NOT_FOUND  If the FIFO is empty.
+ */
+uint32_t app_fifo_read_span(app_fifo_t * p_fifo, uint8_t ** pp_data, uint32_t * p_size);
+
+/**@brief Function for removing bytes that were used in place from the FIFO.
+ *
+ * @param[in]  p_fifo   Pointer to the FIFO. Must not be NULL.
+ * @param[in]  size     Number of bytes to remove.
+ *
+ * @retval     NRF_SUCCESS              If the procedure is successful.
+ * @retval     NRF_ERROR_NULL           If a NULL parameter was passed.
+ * @retval     NRF_ERROR_INVALID_LENGTH If the FIFO contains less than @p size bytes.
+ */
+uint32_t app_fifo_read_span_commit(app_fifo_t * p_fifo, uint32_t size);
+
+/**@brief Function for getting the contiguous block of free space at the end of the FIFO.
+ *
+ * The block can be filled in place, for example as the destination of a DMA transfer. The
+ * data are added to the FIFO when @ref app_fifo_write_span_commit is called.
+ *
+ * @param[in]  p_fifo   Pointer to the FIFO. Must not be NULL.
+ * @param[out] pp_data  Address of the block.
+ * @param[out] p_size   Number of bytes in the block.
+ *
+ * @retval     NRF_SUCCESS          If the procedure is successful.
+ * @retval     NRF_ERROR_NULL       If a NULL parameter was passed.
+ * @retval     NRF_ERROR_NO_MEM     If the FIFO is full.
+ */
+uint32_t app_fifo_write_span(app_fifo_t * p_fifo, uint8_t ** pp_data, uint32_t * p_size);
+
+/**@brief Function for adding bytes that were written in place to the FIFO.
+ *
+ * @param[in]  p_fifo   Pointer to the FIFO. Must not be NULL.
+ * @param[in]  size     Number of bytes to add.
+ *
+ * @retval     NRF_SUCCESS              If the procedure is successful.
+ * @retval     NRF_ERROR_NULL           If a NULL parameter was passed.
+ * @retval     NRF_ERROR_INVALID_LENGTH If the FIFO has less than @p size bytes of free space.
+ */
+uint32_t app_fifo_write_span_commit(app_fifo_t * p_fifo, uint32_t size);
+
 
 #ifdef __cplusplus
 }
@@ -19,11 +19,35 @@
 #include <stdbool.h>
 #include "nrf_error.h"
 #include "nrf_soc.h"
+#if (FS_BLE_HINTS_ENABLED)
+#include "ble_conn_state.h"
+#endif
+#if (FS_STATS_ENABLED)
+#include "app_timer.h"
+#endif
 
 
 static uint8_t       m_flags;       // fstorage status flags.
 static fs_op_queue_t m_queue;       // Queue of requested operations.
 static uint8_t       m_retry_count; // Number of times the last flash operation was retried.
+static uint16_t      m_combined;    // Number of queued operations merged into the one executing.
+static uint16_t      m_chunk_len;   // Length of the chunk being written by the executing store.
+
+// Maximum number of words to write at once, depending on the connection interval.
+static uint16_t      m_max_write_words = FS_MAX_WRITE_SIZE_WORDS;
+
+#if (FS_BLE_HINTS_ENABLED)
+static uint16_t      m_conn_interval;   // Shortest interval of the active links, 1.25 ms units.
+#endif
+
+#if (FS_STATS_ENABLED)
+static fs_stats_t    m_stats;           // Operation statistics.
+#endif
+
+#if (FS_WRITE_COMBINE_BUFFER_WORDS > 0)
+// Holds the data of merged store operations whose sources are not contiguous.
+static uint32_t      m_combine_buf[FS_WRITE_COMBINE_BUFFER_WORDS];
+#endif
 
 // Sends events to the application.
 static void send_event(fs_op_t const * const p_op, fs_ret_t result)
@@ -51,6 +75,26 @@ static void send_event(fs_op_t const * const p_op, fs_ret_t result)
     }
     evt.p_context = p_op->p_context;
 
+#if (FS_STATS_ENABLED)
+    uint32_t latency;
+    (void)app_timer_cnt_diff_compute(app_timer_cnt_get(), p_op->ticks_queued, &latency);
+
+    if (result == FS_SUCCESS)
+    {
+        m_stats.ops_completed++;
+    }
+    else
+    {
+        m_stats.ops_failed++;
+    }
+
+    m_stats.latency_total += latency;
+    if (latency > m_stats.latency_max)
+    {
+        m_stats.latency_max = latency;
+    }
+#endif
+
     p_op->p_config->callback(&evt, result);
 }
 
@@ -73,22 +117,120 @@ static bool check_config(fs_config_t const * const config)
 }
 
 
-// Executes a store operation.
-static uint32_t store_execute(fs_op_t const * const p_op)
+// Retrieves the element in the queue which is i positions after the one being processed.
+static fs_op_t * queue_op_get(uint32_t i)
 {
-    uint16_t chunk_len;
+    uint32_t const idx = ((m_queue.rp + i) < FS_QUEUE_SIZE) ?
+                          (m_queue.rp + i) : ((m_queue.rp + i) - FS_QUEUE_SIZE);
+
+    return &m_queue.op[idx];
+}
 
-    if ((p_op->store.length_words - p_op->store.offset) < FS_MAX_WRITE_SIZE_WORDS)
+
+// Computes the length of the next chunk of data to write for a store operation.
+static uint16_t store_chunk_len(fs_op_t const * const p_op)
+{
+    if ((p_op->store.length_words - p_op->store.offset) < m_max_write_words)
     {
-        chunk_len = p_op->store.length_words - p_op->store.offset;
+        return p_op->store.length_words - p_op->store.offset;
     }
-    else
+
+    return m_max_write_words;
+}
+
+
+// Merges the store operations queued right after p_op which continue where it ends in flash,
+// as long as they fit in a single write. On return, pp_src and p_len describe the data to write.
+// Returns the number of operations merged.
+static uint16_t store_combine(fs_op_t  const *  const p_op,
+                              uint32_t const ** const pp_src,
+                              uint16_t        * const p_len)
+{
+    uint16_t         combined   = 0;
+    uint16_t         len        = *p_len;
+    bool             contiguous = true;
+    uint32_t const * p_dest_end = p_op->store.p_dest + p_op->store.offset + len;
+    uint32_t const * p_src_end  = *pp_src + len;
+
+    // Only the last chunk of an operation can be merged with the following operations.
+    if (p_op->store.offset + len != p_op->store.length_words)
+    {
+        return 0;
+    }
+
+    for (uint32_t i = 1; i < m_queue.count; i++)
+    {
+        fs_op_t const * const p_next = queue_op_get(i);
+
+        if ((p_next->op_code      != FS_OP_STORE) ||
+            (p_next->store.p_dest != p_dest_end)  ||
+            (len + p_next->store.length_words > m_max_write_words))
+        {
+            break;
+        }
+
+        if (p_next->store.p_src != p_src_end)
+        {
+#if (FS_WRITE_COMBINE_BUFFER_WORDS > 0)
+            // The data must be copied into the buffer, check that it fits.
+            if (len + p_next->store.length_words > FS_WRITE_COMBINE_BUFFER_WORDS)
+            {
+                break;
+            }
+            contiguous = false;
+#else
+            break;
+#endif
+        }
+
+        len        += p_next->store.length_words;
+        p_dest_end += p_next->store.length_words;
+        p_src_end   = p_next->store.p_src + p_next->store.length_words;
+        combined++;
+    }
+
+#if (FS_WRITE_COMBINE_BUFFER_WORDS > 0)
+    if (!contiguous)
     {
-        chunk_len = FS_MAX_WRITE_SIZE_WORDS;
+        // Gather the data of all merged operations into the buffer.
+        uint16_t offset = *p_len;
+
+        memcpy(m_combine_buf, *pp_src, offset * sizeof(uint32_t));
+
+        for (uint32_t i = 1; i <= combined; i++)
+        {
+            fs_op_t const * const p_next = queue_op_get(i);
+
+            memcpy(&m_combine_buf[offset], p_next->store.p_src,
+                   p_next->store.length_words * sizeof(uint32_t));
+
+            offset += p_next->store.length_words;
+        }
+
+        *pp_src = m_combine_buf;
     }
+#else
+    UNUSED_VARIABLE(contiguous);
+#endif
+
+    *p_len = len;
+
+    return combined;
+}
+
+
+// Executes a store operation.
+static uint32_t store_execute(fs_op_t const * const p_op)
+{
+    uint16_t         chunk_len = store_chunk_len(p_op);
+    uint32_t const * p_src     = p_op->store.p_src + p_op->store.offset;
+
+    // Keep track of the chunk length, since the maximum might change before the write completes.
+    m_chunk_len = chunk_len;
+    m_combined  = store_combine(p_op, &p_src, &chunk_len);
 
     return sd_flash_write((uint32_t*)p_op->store.p_dest + p_op->store.offset,
-                          (uint32_t*)p_op->store.p_src  + p_op->store.offset,
+                          (uint32_t*)p_src,
                           chunk_len);
 }
 
@@ -154,6 +296,9 @@ static void queue_process(void)
         else
         {
             // Operation is executing.
+#if (FS_STATS_ENABLED)
+            m_stats.flash_calls++;
+#endif
         }
     }
 }
@@ -172,6 +317,44 @@ static void queue_start(void)
 }
 
 
+// Completes the operations which were merged into the one that has just finished, with the
+// given result.
+static void queue_complete_combined(fs_ret_t result)
+{
+    while (m_combined > 0)
+    {
+        m_combined--;
+
+        send_event(&m_queue.op[m_queue.rp], result);
+        queue_advance();
+    }
+}
+
+
+// Completes the erase operations queued right after one that has just erased the same pages.
+static void queue_collapse_erase(uint16_t first_page, uint16_t num_pages)
+{
+    while (m_queue.count > 0)
+    {
+        fs_op_t * const p_next = &m_queue.op[m_queue.rp];
+
+        if ((p_next->op_code != FS_OP_ERASE) ||
+            (p_next->erase.page < first_page) ||
+            (p_next->erase.page + p_next->erase.pages_to_erase > first_page + num_pages))
+        {
+            break;
+        }
+
+        // These pages have just been erased and nothing has been written to them since.
+        p_next->erase.page        += p_next->erase.pages_to_erase;
+        p_next->erase.pages_erased = p_next->erase.pages_to_erase;
+
+        send_event(p_next, FS_SUCCESS);
+        queue_advance();
+    }
+}
+
+
 // Flash operation success callback handler. Keeps track of the progress of an operation.
 // If it has finished, advances the queue and notifies the application.
 static void on_operation_success(fs_op_t * const p_op)
@@ -182,24 +365,16 @@ static void on_operation_success(fs_op_t * const p_op)
     {
         case FS_OP_STORE:
         {
-            uint16_t chunk_len;
-
-            if ((p_op->store.length_words - p_op->store.offset) < FS_MAX_WRITE_SIZE_WORDS)
-            {
-                chunk_len = p_op->store.length_words - p_op->store.offset;
-            }
-            else
-            {
-                chunk_len = FS_MAX_WRITE_SIZE_WORDS;
-            }
-
-            p_op->store.offset += chunk_len;
+            p_op->store.offset += m_chunk_len;
 
             if (p_op->store.offset == p_op->store.length_words)
             {
                 // The operation has finished.
                 send_event(p_op, FS_SUCCESS);
                 queue_advance();
+
+                // So have any operations which were merged into it.
+                queue_complete_combined(FS_SUCCESS);
             }
         }
         break;
@@ -211,8 +386,14 @@ static void on_operation_success(fs_op_t * const p_op)
 
             if (p_op->erase.pages_erased == p_op->erase.pages_to_erase)
             {
+                // Copy the erased range, the element might be reused once the queue advances.
+                uint16_t const first_page = p_op->erase.page - p_op->erase.pages_erased;
+                uint16_t const num_pages  = p_op->erase.pages_erased;
+
                 send_event(p_op, FS_SUCCESS);
                 queue_advance();
+
+                queue_collapse_erase(first_page, num_pages);
             }
         }
         break;
@@ -228,12 +409,19 @@ static void on_operation_success(fs_op_t * const p_op)
 // been reached, notifies the application and advances the queue.
 static void on_operation_failure(fs_op_t const * const p_op)
 {
+#if (FS_STATS_ENABLED)
+    m_stats.retries++;
+#endif
+
     if (++m_retry_count > FS_OP_MAX_RETRIES)
     {
         m_retry_count = 0;
 
         send_event(p_op, FS_ERR_OPERATION_TIMEOUT);
         queue_advance();
+
+        // Operations merged into this one have failed as well.
+        queue_complete_combined(FS_ERR_OPERATION_TIMEOUT);
     }
 }
 
@@ -257,6 +445,10 @@ static bool queue_get_next_free(fs_op_t ** p_op)
     // Zero the element so that unassigned fields will be zero.
     memset(&m_queue.op[idx], 0x00, sizeof(fs_op_t));
 
+#if (FS_STATS_ENABLED)
+    m_queue.op[idx].ticks_queued = app_timer_cnt_get();
+#endif
+
     *p_op = &m_queue.op[idx];
 
     return true;
@@ -353,24 +545,12 @@ fs_ret_t fs_fake_init(void)
 }
 
 
-fs_ret_t fs_store(fs_config_t const * const p_config,
-                  uint32_t    const * const p_dest,
-                  uint32_t    const * const p_src,
-                  uint16_t    const         length_words,
-                  void *                    p_context)
+// Checks the parameters of a store operation.
+static fs_ret_t store_check(fs_config_t const * const p_config,
+                            uint32_t    const * const p_dest,
+                            uint32_t    const * const p_src,
+                            uint16_t    const         length_words)
 {
-    fs_op_t * p_op;
-
-    if (!(m_flags & FS_FLAG_INITIALIZED))
-    {
-        return FS_ERR_NOT_INITIALIZED;
-    }
-
-    if (!check_config(p_config))
-    {
-        return FS_ERR_INVALID_CFG;
-    }
-
     if ((p_src == NULL) || (p_dest == NULL))
     {
         return FS_ERR_NULL_ARG;
@@ -395,6 +575,35 @@ fs_ret_t fs_store(fs_config_t const * const p_config,
         return FS_ERR_INVALID_ARG;
     }
 
+    return FS_SUCCESS;
+}
+
+
+fs_ret_t fs_store(fs_config_t const * const p_config,
+                  uint32_t    const * const p_dest,
+                  uint32_t    const * const p_src,
+                  uint16_t    const         length_words,
+                  void *                    p_context)
+{
+    fs_ret_t  ret;
+    fs_op_t * p_op;
+
+    if (!(m_flags & FS_FLAG_INITIALIZED))
+    {
+        return FS_ERR_NOT_INITIALIZED;
+    }
+
+    if (!check_config(p_config))
+    {
+        return FS_ERR_INVALID_CFG;
+    }
+
+    ret = store_check(p_config, p_dest, p_src, length_words);
+    if (ret != FS_SUCCESS)
+    {
+        return ret;
+    }
+
     if (!queue_get_next_free(&p_op))
     {
         return FS_ERR_QUEUE_FULL;
@@ -414,6 +623,68 @@ fs_ret_t fs_store(fs_config_t const * const p_config,
 }
 
 
+fs_ret_t fs_store_list(fs_config_t    const * const p_config,
+                       fs_store_req_t const * const p_reqs,
+                       uint16_t                     num_reqs,
+                       void *                       p_context)
+{
+    fs_ret_t  ret;
+    fs_op_t * p_op;
+
+    if (!(m_flags & FS_FLAG_INITIALIZED))
+    {
+        return FS_ERR_NOT_INITIALIZED;
+    }
+
+    if (!check_config(p_config))
+    {
+        return FS_ERR_INVALID_CFG;
+    }
+
+    if (p_reqs == NULL)
+    {
+        return FS_ERR_NULL_ARG;
+    }
+
+    if (num_reqs == 0)
+    {
+        return FS_ERR_INVALID_ARG;
+    }
+
+    for (uint32_t i = 0; i < num_reqs; i++)
+    {
+        ret = store_check(p_config, p_reqs[i].p_dest, p_reqs[i].p_src, p_reqs[i].length_words);
+        if (ret != FS_SUCCESS)
+        {
+            return ret;
+        }
+    }
+
+    if (num_reqs > FS_QUEUE_SIZE - m_queue.count)
+    {
+        return FS_ERR_QUEUE_FULL;
+    }
+
+    for (uint32_t i = 0; i < num_reqs; i++)
+    {
+        // There is enough space in the queue, this can't fail.
+        (void)queue_get_next_free(&p_op);
+
+        p_op->p_context          = p_context;
+        p_op->p_config           = p_config;
+        p_op->op_code            = FS_OP_STORE;
+        p_op->store.p_src        = p_reqs[i].p_src;
+        p_op->store.p_dest       = p_reqs[i].p_dest;
+        p_op->store.length_words = p_reqs[i].length_words;
+    }
+
+    // Start processing once all operations are queued, so that they can be merged.
+    queue_start();
+
+    return FS_SUCCESS;
+}
+
+
 fs_ret_t fs_erase(fs_config_t const * const p_config,
                   uint32_t    const * const p_page_addr,
                   uint16_t    const         num_pages,
@@ -485,6 +756,103 @@ fs_ret_t fs_queued_op_count_get(uint32_t * const p_op_count)
 }
 
 
+void fs_conn_interval_hint_set(uint16_t conn_interval)
+{
+    uint32_t max_write_words = FS_MAX_WRITE_SIZE_WORDS;
+
+    if (conn_interval != 0)
+    {
+        // The time flash writes may take in each connection interval, in microseconds.
+        uint32_t const flash_time_us = ((uint32_t)conn_interval * FS_CONN_INTERVAL_UNIT_US *
+                                        FS_CONN_FLASH_TIME_PERCENT) / 100;
+
+        max_write_words = flash_time_us / FS_WORD_WRITE_TIME_US;
+
+        if (max_write_words == 0)
+        {
+            max_write_words = 1;
+        }
+        else if (max_write_words > FS_MAX_WRITE_SIZE_WORDS)
+        {
+            max_write_words = FS_MAX_WRITE_SIZE_WORDS;
+        }
+    }
+
+    m_max_write_words = max_write_words;
+}
+
+
+#if (FS_BLE_HINTS_ENABLED)
+
+void fs_on_ble_evt(ble_evt_t * p_ble_evt)
+{
+    uint16_t interval;
+
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GAP_EVT_CONNECTED:
+            interval = p_ble_evt->evt.gap_evt.params.connected.conn_params.max_conn_interval;
+
+            // Fit flash operations in the shortest interval among active links.
+            if ((m_conn_interval == 0) || (interval < m_conn_interval))
+            {
+                m_conn_interval = interval;
+            }
+            break;
+
+        case BLE_GAP_EVT_CONN_PARAM_UPDATE:
+            interval = p_ble_evt->evt.gap_evt.params.conn_param_update.conn_params.max_conn_interval;
+
+            // The interval of other links is not known, so only allow it to grow if this
+            // is the only active link.
+            if ((ble_conn_state_n_connections() <= 1) || (interval < m_conn_interval))
+            {
+                m_conn_interval = interval;
+            }
+            break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            if (ble_conn_state_n_connections() == 0)
+            {
+                m_conn_interval = 0;
+            }
+            break;
+
+        default:
+            return;
+    }
+
+    fs_conn_interval_hint_set(m_conn_interval);
+}
+
+#endif
+
+
+fs_ret_t fs_stats_get(fs_stats_t * const p_stats)
+{
+    if (p_stats == NULL)
+    {
+        return FS_ERR_NULL_ARG;
+    }
+
+#if (FS_STATS_ENABLED)
+    *p_stats = m_stats;
+#else
+    memset(p_stats, 0x00, sizeof(fs_stats_t));
+#endif
+
+    return FS_SUCCESS;
+}
+
+
+void fs_stats_clear(void)
+{
+#if (FS_STATS_ENABLED)
+    memset(&m_stats, 0x00, sizeof(fs_stats_t));
+#endif
+}
+
+
 void fs_sys_event_handler(uint32_t sys_evt)
 {
     fs_op_t * const p_op = &m_queue.op[m_queue.rp];
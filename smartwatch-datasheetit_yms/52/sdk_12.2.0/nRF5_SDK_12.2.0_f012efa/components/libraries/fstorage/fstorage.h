@@ -23,7 +23,11 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "sdk_config.h"
 #include "section_vars.h"
+#if defined(FS_BLE_HINTS_ENABLED) && (FS_BLE_HINTS_ENABLED)
+#include "ble.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -136,6 +140,31 @@ typedef struct
 } fs_config_t;
 
 
+/**@brief   A store operation, as queued by @ref fs_store_list. */
+typedef struct
+{
+    uint32_t const * p_dest;        //!< The address in flash memory where to store the data.
+    uint32_t const * p_src;         //!< Pointer to the data to store in flash.
+    uint16_t         length_words;  //!< Length of the data to store, in words.
+} fs_store_req_t;
+
+
+/**@brief   fstorage operation statistics, see @ref fs_stats_get.
+ *
+ * Latencies are measured from the moment an operation is queued until its event is sent,
+ * in RTC1 ticks (see @ref app_timer_cnt_get).
+ */
+typedef struct
+{
+    uint32_t ops_completed;     //!< Number of operations which completed successfully.
+    uint32_t ops_failed;        //!< Number of operations which failed.
+    uint32_t flash_calls;       //!< Number of flash writes and page erases started.
+    uint32_t retries;           //!< Number of flash writes or page erases which had to be retried.
+    uint32_t latency_max;       //!< Largest latency of an operation.
+    uint32_t latency_total;     //!< Sum of the latencies of all operations.
+} fs_stats_t;
+
+
 /**@brief   Macro for registering an fstorage configuration variable.
  *          Applications which use fstorage must register with the module using this macro.
  *          Registering involves defining a variable which holds the configuration of fstorage
@@ -196,6 +225,37 @@ fs_ret_t fs_store(fs_config_t const * const p_config,
                   void *                    p_context);
 
 
+/**@brief   Function for storing several blocks of data in flash.
+ *
+ * @details Queues one store operation for each element of @p p_reqs, as if @ref fs_store was
+ *          called for each of them, except that either all operations are queued or none is.
+ *          Operations which are queued together can be merged into fewer flash writes, see
+ *          @ref FS_WRITE_COMBINE_BUFFER_WORDS. One event is sent for each operation.
+ *
+ * @warning The data to be written to flash has to be kept in memory until the operations have
+ *          terminated, i.e., an event is received for each of them.
+ *
+ * @param[in]   p_config        fstorage configuration registered by the application.
+ * @param[in]   p_reqs          The store operations to queue.
+ * @param[in]   num_reqs        Number of elements in @p p_reqs.
+ * @param[in]   p_context       User-defined context passed to the interrupt handler.
+ *
+ * @retval  FS_SUCCESS              If the operations were queued successfully.
+ * @retval  FS_ERR_NOT_INITIALIZED  If the module is not initialized.
+ * @retval  FS_ERR_INVALID_CFG      If @p p_config is NULL or contains invalid data.
+ * @retval  FS_ERR_NULL_ARG         If @p p_reqs is NULL or any source or destination is NULL.
+ * @retval  FS_ERR_INVALID_ARG      If @p num_reqs is zero or any length is zero.
+ * @retval  FS_ERR_INVALID_ADDR     If any destination is outside of the flash memory
+ *                                  boundaries specified in @p p_config.
+ * @retval  FS_ERR_UNALIGNED_ADDR   If any source or destination is not word aligned.
+ * @retval  FS_ERR_QUEUE_FULL       If there is not enough space in the internal operation queue.
+ */
+fs_ret_t fs_store_list(fs_config_t    const * const p_config,
+                       fs_store_req_t const * const p_reqs,
+                       uint16_t                     num_reqs,
+                       void *                       p_context);
+
+
 /**@brief   Function for erasing flash pages.
  *
  * @details Starting from the page at @p p_page_addr, erases @p num_pages flash pages.
@@ -203,6 +263,9 @@ fs_ret_t fs_store(fs_config_t const * const p_config,
  *          within the bounds specified in the supplied fstorage configuration.
  *          This function is asynchronous. Completion is reported via an event.
  *
+ * @note    If the same pages are already being erased when this operation reaches the front of
+ *          the queue, they are not erased again and the event is sent right away.
+ *
  * @param[in]   p_config        fstorage configuration registered by the application.
  * @param[in]   p_page_addr     Address of the page to erase. Must be aligned to a page boundary.
  * @param[in]   num_pages       Number of pages to erase. May not be zero.
@@ -250,6 +313,53 @@ bool fs_queue_is_full(void);
 bool fs_queue_is_empty(void);
 
 
+/**@brief   Function for setting the connection interval flash operations should fit in.
+ *
+ * @details While a connection is active, the SoftDevice can only write to flash in between
+ *          connection events. Stores are split into fragments which can be written in
+ *          @ref FS_CONN_FLASH_TIME_PERCENT percent of @p conn_interval, so that each fragment
+ *          is likely to be scheduled at the first attempt instead of timing out.
+ *
+ * @param[in]   conn_interval   The shortest connection interval of the active links, in units
+ *                              of 1.25 ms. Zero if there are no active links, in which case
+ *                              stores are written in chunks of @ref FS_MAX_WRITE_SIZE_WORDS.
+ */
+void fs_conn_interval_hint_set(uint16_t conn_interval);
+
+
+#if defined(FS_BLE_HINTS_ENABLED) && (FS_BLE_HINTS_ENABLED)
+
+/**@brief   Function for handling BLE events.
+ *
+ * @details Follows the connection interval of active links, see @ref fs_conn_interval_hint_set.
+ *          Call @ref ble_conn_state_on_ble_evt before calling this function.
+ *
+ * @param[in]   p_ble_evt   BLE event from the SoftDevice.
+ */
+void fs_on_ble_evt(ble_evt_t * p_ble_evt);
+
+#endif
+
+
+/**@brief   Function for retrieving operation statistics.
+ *
+ * @note    @ref FS_STATS_ENABLED must be enabled to use this functionality.
+ *
+ * @param[out]  p_stats     Operation statistics.
+ *
+ * @retval  FS_SUCCESS          If the statistics were retrieved successfully.
+ * @retval  FS_ERR_NULL_ARG     If @p p_stats is NULL.
+ */
+fs_ret_t fs_stats_get(fs_stats_t * const p_stats);
+
+
+/**@brief   Function for clearing operation statistics.
+ *
+ * @note    @ref FS_STATS_ENABLED must be enabled to use this functionality.
+ */
+void fs_stats_clear(void);
+
+
 /**@brief   Function for handling system events from the SoftDevice.
  *
  * @details If any of the modules used by the application rely on fstorage, the application should
@@ -49,5 +49,64 @@
 #define FS_MAX_WRITE_SIZE_WORDS
 
 
+/** @brief Size of the buffer used to combine store operations, in words.
+ *
+ * Queued store operations to contiguous flash addresses are merged into a single
+ * call to @ref sd_flash_write, up to @ref FS_MAX_WRITE_SIZE_WORDS words. Operations
+ * whose source data is also contiguous in RAM are always merged. Set this to a non-zero
+ * value to also merge operations whose source data is not contiguous, by copying it
+ * into a buffer of this size. Setting it to 0 disables the buffer.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define FS_WRITE_COMBINE_BUFFER_WORDS
+
+
+/** @brief Share of each connection interval that flash writes may use, in percent.
+ *
+ * While a connection is active, stores are split into fragments which can be written
+ * in this share of the connection interval, see @ref fs_conn_interval_hint_set. Lower
+ * this value if flash writes reduce the throughput of the connection.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define FS_CONN_FLASH_TIME_PERCENT
+
+
+/** @brief Worst case time to write one word to flash, in microseconds.
+ *
+ * Used to compute the size of store fragments during connections. Defaults to
+ * the value from the product specification of the IC.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define FS_WORD_WRITE_TIME_US
+
+
+/** @brief Enable connection interval hints from BLE events.
+ *
+ * Set to 1 to compile @ref fs_on_ble_evt, which follows the connection interval of
+ * active links using the @ref ble_conn_state module.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define FS_BLE_HINTS_ENABLED
+
+
+/** @brief Enable operation statistics.
+ *
+ * Set to 1 to keep track of operation latencies and retries, see @ref fs_stats_get.
+ * Latencies are measured using @ref app_timer_cnt_get.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define FS_STATS_ENABLED
+
+
 
 /** @} */
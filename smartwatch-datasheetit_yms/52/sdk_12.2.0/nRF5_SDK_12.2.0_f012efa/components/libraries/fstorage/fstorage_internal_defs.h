@@ -27,6 +27,38 @@ extern "C" {
 
 #define FS_ERASED_WORD              (0xFFFFFFFF)
 
+#ifndef FS_WRITE_COMBINE_BUFFER_WORDS
+    #define FS_WRITE_COMBINE_BUFFER_WORDS   (0)
+#endif
+
+#ifndef FS_BLE_HINTS_ENABLED
+    #define FS_BLE_HINTS_ENABLED            (0)
+#endif
+
+#ifndef FS_STATS_ENABLED
+    #define FS_STATS_ENABLED                (0)
+#endif
+
+#ifndef FS_CONN_FLASH_TIME_PERCENT
+    #define FS_CONN_FLASH_TIME_PERCENT      (50)
+#endif
+
+// Worst case time to write one word to flash, in microseconds.
+#ifndef FS_WORD_WRITE_TIME_US
+    #if defined(NRF51)
+        #define FS_WORD_WRITE_TIME_US       (47)
+    #else
+        #define FS_WORD_WRITE_TIME_US       (68)
+    #endif
+#endif
+
+// Unit of the connection interval, in microseconds.
+#define FS_CONN_INTERVAL_UNIT_US            (1250)
+
+#if (FS_WRITE_COMBINE_BUFFER_WORDS > FS_MAX_WRITE_SIZE_WORDS)
+    #error "FS_WRITE_COMBINE_BUFFER_WORDS must not exceed FS_MAX_WRITE_SIZE_WORDS."
+#endif
+
 // Helper macros for section variables.
 #define FS_SECTION_VARS_GET(i)          NRF_SECTION_VARS_GET((i), fs_config_t, fs_data)
 #define FS_SECTION_VARS_COUNT           NRF_SECTION_VARS_COUNT(fs_config_t, fs_data)
@@ -63,6 +95,9 @@ typedef struct
     fs_config_t  const * p_config;          // Application-specific fstorage configuration.
     void *               p_context;         // User-defined context passed to the interrupt handler.
     fs_op_code_t         op_code;           // ID of the operation.
+#if (FS_STATS_ENABLED)
+    uint32_t             ticks_queued;      // RTC1 counter value when the operation was queued.
+#endif
     union
     {
         struct
@@ -21,6 +21,9 @@
 #define NRF_LOG_MODULE_NAME "HARDFAULT"
 #include "nrf_log.h"
 #include "nrf_log_ctrl.h"
+#if NRF_MODULE_ENABLED(CRASH_SNAPSHOT)
+#include "crash_snapshot.h"
+#endif
 #if defined(DEBUG_NRF)
 /**
  * @brief Pointer to the last received stack pointer.
@@ -41,6 +44,10 @@ __WEAK void HardFault_process(HardFault_stack_t * p_stack)
 
 void HardFault_c_handler(uint32_t * p_stack_address)
 {
+#if NRF_MODULE_ENABLED(CRASH_SNAPSHOT)
+    // Taken first, before the log flush changes the state.
+    crash_snapshot_fault_capture(p_stack_address);
+#endif
     NRF_LOG_ERROR("Hardfault PC:%x\r\n", ((HardFault_stack_t *)p_stack_address)->pc);
     NRF_LOG_FINAL_FLUSH();
 #if defined(DEBUG_NRF)
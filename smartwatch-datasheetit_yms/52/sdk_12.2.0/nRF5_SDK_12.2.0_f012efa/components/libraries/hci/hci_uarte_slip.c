@@ -0,0 +1,745 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(HCI_UARTE_SLIP)
+#include "hci_uarte_slip.h"
+#include <stddef.h>
+#include <string.h>
+#include "nrf_balloc.h"
+#include "nrf_drv_ppi.h"
+#include "app_util.h"
+#include "app_util_platform.h"
+
+#define SLIP_END            0xC0    /**< Frame delimiter. */
+#define SLIP_ESC            0xDB    /**< Escape code. */
+#define SLIP_ESC_END        0xDC    /**< Escaped frame delimiter. */
+#define SLIP_ESC_ESC        0xDD    /**< Escaped escape code. */
+
+#define RX_CHUNK_CNT        2       /**< Number of RX transfers queued in the driver. */
+
+STATIC_ASSERT((HCI_UARTE_SLIP_RX_CHUNK_SIZE > 0) && (HCI_UARTE_SLIP_RX_CHUNK_SIZE <= UINT8_MAX));
+STATIC_ASSERT(HCI_UARTE_SLIP_RX_BUFFER_SIZE >= (RX_CHUNK_CNT * HCI_UARTE_SLIP_RX_CHUNK_SIZE));
+STATIC_ASSERT((HCI_UARTE_SLIP_TX_CHUNK_SIZE >= 2) && (HCI_UARTE_SLIP_TX_CHUNK_SIZE <= UINT8_MAX));
+STATIC_ASSERT(HCI_UARTE_SLIP_FRAME_SIZE <= UINT16_MAX);
+
+/**@brief Word with every byte set to @p byte. */
+#define WORD_OF(byte)           (0x01010101UL * (uint8_t)(byte))
+
+/**@brief Non-zero if a byte of word @p w is zero. */
+#define WORD_HAS_ZERO(w)        (((w) - 0x01010101UL) & ~(w) & 0x80808080UL)
+
+/**@brief Non-zero if a byte of word @p w is equal to @p byte. */
+#define WORD_HAS_BYTE(w, byte)  WORD_HAS_ZERO((w) ^ WORD_OF(byte))
+
+/**@brief Frame, as allocated from the pools. */
+typedef struct slip_frame_s
+{
+    struct slip_frame_s * p_next;                           /**< Next frame in a list. */
+    uint16_t              length;                           /**< Length of the frame. */
+    uint8_t               data[HCI_UARTE_SLIP_FRAME_SIZE];  /**< Frame data. */
+} slip_frame_t;
+
+/**@brief List of frames. */
+typedef struct
+{
+    slip_frame_t * p_head;
+    slip_frame_t * p_tail;
+} frame_list_t;
+
+/**@brief RX control block. */
+typedef struct
+{
+    uint16_t       head;                    /**< Start of the oldest queued transfer in the ring. */
+    uint8_t        lengths[RX_CHUNK_CNT];   /**< Lengths of the queued transfers, oldest first. */
+    uint8_t        queued;                  /**< Number of queued transfers. */
+    bool           aborting;                /**< Reception was stopped because the line was idle. */
+    bool           synced;                  /**< A frame delimiter has been received. */
+    bool           escaped;                 /**< The last byte was an escape code. */
+    bool           dropping;                /**< The frame being received is dropped. */
+    slip_frame_t * p_frame;                 /**< Frame being received, or NULL. */
+} slip_rx_t;
+
+/**@brief TX control block. */
+typedef struct
+{
+    frame_list_t   queue;                   /**< Frames waiting to be encoded. */
+    frame_list_t   done[2];                 /**< Frames that end in each buffer. */
+    slip_frame_t * p_frame;                 /**< Frame being encoded, or NULL. */
+    uint16_t       pos;                     /**< Next byte of the frame to encode. */
+    bool           started;                 /**< The opening delimiter of the frame was encoded. */
+    uint8_t        lengths[2];              /**< Number of bytes in each buffer. */
+    uint8_t        sending;                 /**< Buffer being sent. */
+    bool           busy;                    /**< A buffer is being sent. */
+} slip_tx_t;
+
+NRF_BALLOC_DEF(m_tx_pool, sizeof(slip_frame_t), HCI_UARTE_SLIP_TX_FRAME_COUNT);
+NRF_BALLOC_DEF(m_rx_pool, sizeof(slip_frame_t), HCI_UARTE_SLIP_RX_FRAME_COUNT);
+
+static hci_uarte_slip_config_t const * mp_config;
+static nrf_ppi_channel_t               m_ppi_channel;
+static slip_rx_t                       m_rx;
+static slip_tx_t                       m_tx;
+
+static uint8_t m_rx_ring[HCI_UARTE_SLIP_RX_BUFFER_SIZE];
+static uint8_t m_tx_buffers[2][HCI_UARTE_SLIP_TX_CHUNK_SIZE];
+
+
+/**@brief Function for finding the first SLIP code in a buffer.
+ *
+ * @details Whole words are compared against both codes at once, after the buffer has been
+ *          aligned.
+ *
+ * @return Offset of the first @ref SLIP_END or @ref SLIP_ESC byte, or @p length if there is none.
+ */
+static uint32_t slip_code_find(uint8_t const * p_data, uint32_t length)
+{
+    uint32_t i = 0;
+
+    while ((i < length) && ((((uint32_t)&p_data[i]) & 0x3) != 0))
+    {
+        if ((p_data[i] == SLIP_END) || (p_data[i] == SLIP_ESC))
+        {
+            return i;
+        }
+        i++;
+    }
+
+    for (; (i + sizeof(uint32_t)) <= length; i += sizeof(uint32_t))
+    {
+        uint32_t word = *(uint32_t const *)&p_data[i];
+
+        if (WORD_HAS_BYTE(word, SLIP_END) | WORD_HAS_BYTE(word, SLIP_ESC))
+        {
+            break;
+        }
+    }
+
+    for (; i < length; i++)
+    {
+        if ((p_data[i] == SLIP_END) || (p_data[i] == SLIP_ESC))
+        {
+            return i;
+        }
+    }
+    return length;
+}
+
+
+static void frame_list_push(frame_list_t * p_list, slip_frame_t * p_frame)
+{
+    p_frame->p_next = NULL;
+    if (p_list->p_tail == NULL)
+    {
+        p_list->p_head = p_frame;
+    }
+    else
+    {
+        p_list->p_tail->p_next = p_frame;
+    }
+    p_list->p_tail = p_frame;
+}
+
+
+static slip_frame_t * frame_list_pop(frame_list_t * p_list)
+{
+    slip_frame_t * p_frame = p_list->p_head;
+
+    if (p_frame != NULL)
+    {
+        p_list->p_head = p_frame->p_next;
+        if (p_list->p_head == NULL)
+        {
+            p_list->p_tail = NULL;
+        }
+    }
+    return p_frame;
+}
+
+
+static void evt_send(hci_uarte_slip_evt_type_t type, slip_frame_t * p_frame)
+{
+    hci_uarte_slip_evt_t evt;
+
+    evt.type = type;
+    if (p_frame != NULL)
+    {
+        evt.params.frame.p_data = p_frame->data;
+        evt.params.frame.length = p_frame->length;
+    }
+    mp_config->evt_handler(&evt);
+}
+
+
+/**@brief Function for dropping the frame being received.
+ *
+ * @param[in] resync True if data is ignored until the next frame delimiter.
+ */
+static void rx_frame_drop(bool resync)
+{
+    if (m_rx.p_frame != NULL)
+    {
+        nrf_balloc_free(&m_rx_pool, m_rx.p_frame);
+        m_rx.p_frame = NULL;
+    }
+    m_rx.dropping = !resync;
+    m_rx.escaped  = false;
+    if (resync)
+    {
+        m_rx.synced = false;
+    }
+}
+
+
+/**@brief Function for adding decoded bytes to the frame being received.
+ */
+static void rx_frame_append(uint8_t const * p_data, uint32_t length)
+{
+    if (!m_rx.synced || m_rx.dropping)
+    {
+        return;
+    }
+
+    if (m_rx.p_frame == NULL)
+    {
+        m_rx.p_frame = nrf_balloc_alloc(&m_rx_pool);
+        if (m_rx.p_frame == NULL)
+        {
+            m_rx.dropping = true;
+            return;
+        }
+        m_rx.p_frame->length = 0;
+    }
+
+    if (length > (HCI_UARTE_SLIP_FRAME_SIZE - m_rx.p_frame->length))
+    {
+        rx_frame_drop(false);
+        return;
+    }
+
+    memcpy(&m_rx.p_frame->data[m_rx.p_frame->length], p_data, length);
+    m_rx.p_frame->length += length;
+}
+
+
+/**@brief Function for handling a frame delimiter.
+ */
+static void rx_frame_end(void)
+{
+    slip_frame_t * p_frame = m_rx.p_frame;
+
+    if (m_rx.dropping)
+    {
+        rx_frame_drop(false);
+        m_rx.dropping = false;
+        evt_send(HCI_UARTE_SLIP_EVT_RX_OVERFLOW, NULL);
+    }
+    else if (p_frame != NULL)
+    {
+        m_rx.p_frame = NULL;
+        evt_send(HCI_UARTE_SLIP_EVT_RX_FRAME, p_frame);
+    }
+    m_rx.synced = true;
+}
+
+
+/**@brief Function for decoding received data.
+ *
+ * @details Runs of bytes without SLIP codes are copied to the frame at once.
+ */
+static void rx_decode(uint8_t const * p_data, uint32_t length)
+{
+    while (length > 0)
+    {
+        uint32_t run;
+        uint8_t  byte;
+
+        if (m_rx.escaped)
+        {
+            m_rx.escaped = false;
+            byte         = *p_data++;
+            length--;
+
+            if (byte == SLIP_ESC_END)
+            {
+                byte = SLIP_END;
+            }
+            else if (byte == SLIP_ESC_ESC)
+            {
+                byte = SLIP_ESC;
+            }
+            else
+            {
+                // Invalid escape sequence.
+                rx_frame_drop(true);
+                continue;
+            }
+            rx_frame_append(&byte, 1);
+            continue;
+        }
+
+        run = slip_code_find(p_data, length);
+        if (run > 0)
+        {
+            rx_frame_append(p_data, run);
+            p_data += run;
+            length -= run;
+            continue;
+        }
+
+        byte = *p_data++;
+        length--;
+        if (byte == SLIP_END)
+        {
+            rx_frame_end();
+        }
+        else
+        {
+            m_rx.escaped = true;
+        }
+    }
+}
+
+
+/**@brief Function for queuing an RX transfer after the ones that are queued.
+ */
+static void rx_queue(void)
+{
+    uint32_t tail = m_rx.head;
+    uint32_t length;
+    uint8_t  i;
+
+    for (i = 0; i < m_rx.queued; i++)
+    {
+        tail += m_rx.lengths[i];
+    }
+    if (tail >= HCI_UARTE_SLIP_RX_BUFFER_SIZE)
+    {
+        tail -= HCI_UARTE_SLIP_RX_BUFFER_SIZE;
+    }
+    if (m_rx.queued == 0)
+    {
+        m_rx.head = tail;
+    }
+
+    // Transfers do not wrap, and the ring holds two full ones, so the new transfer does not
+    // overlap the one in progress.
+    length = MIN(HCI_UARTE_SLIP_RX_CHUNK_SIZE, HCI_UARTE_SLIP_RX_BUFFER_SIZE - tail);
+    if (nrf_drv_uart_rx(mp_config->p_uart, &m_rx_ring[tail], (uint8_t)length) == NRF_SUCCESS)
+    {
+        m_rx.lengths[m_rx.queued++] = (uint8_t)length;
+    }
+}
+
+
+/**@brief Function for handling the end of an RX transfer.
+ *
+ * @details A full transfer is ended by ENDRX, and the next queued transfer continues without a
+ *          gap. Any other transfer was ended by the abort of an idle line, which also drops the
+ *          next queued transfer.
+ */
+static void rx_done(uint32_t bytes)
+{
+    if ((m_rx.queued > 0) && (bytes == m_rx.lengths[0]))
+    {
+        rx_decode(&m_rx_ring[m_rx.head], bytes);
+
+        m_rx.head += bytes;
+        if (m_rx.head >= HCI_UARTE_SLIP_RX_BUFFER_SIZE)
+        {
+            m_rx.head = 0;
+        }
+        m_rx.lengths[0] = m_rx.lengths[1];
+        m_rx.queued--;
+
+        if (!m_rx.aborting)
+        {
+            rx_queue();
+        }
+        return;
+    }
+
+    if (m_rx.queued > 0)
+    {
+        rx_decode(&m_rx_ring[m_rx.head], bytes);
+        m_rx.head += bytes;
+        if (m_rx.head >= HCI_UARTE_SLIP_RX_BUFFER_SIZE)
+        {
+            m_rx.head = 0;
+        }
+    }
+    m_rx.queued   = 0;
+    m_rx.aborting = false;
+    while (m_rx.queued < RX_CHUNK_CNT)
+    {
+        rx_queue();
+    }
+}
+
+
+/**@brief Function for encoding queued frames into a TX buffer.
+ *
+ * @details Frames that end in the buffer are moved to its list of done frames.
+ *
+ * @return Number of bytes in the buffer.
+ */
+static uint8_t tx_encode(uint8_t buffer)
+{
+    uint8_t * p_out = m_tx_buffers[buffer];
+    uint32_t  space = HCI_UARTE_SLIP_TX_CHUNK_SIZE;
+
+    while (space > 0)
+    {
+        slip_frame_t * p_frame = m_tx.p_frame;
+        uint32_t       run;
+        uint8_t        byte;
+
+        if (p_frame == NULL)
+        {
+            CRITICAL_REGION_ENTER();
+            p_frame = frame_list_pop(&m_tx.queue);
+            CRITICAL_REGION_EXIT();
+            if (p_frame == NULL)
+            {
+                break;
+            }
+            m_tx.p_frame = p_frame;
+            m_tx.pos     = 0;
+            m_tx.started = false;
+        }
+
+        if (!m_tx.started)
+        {
+            *p_out++     = SLIP_END;
+            space--;
+            m_tx.started = true;
+            continue;
+        }
+
+        if (m_tx.pos == p_frame->length)
+        {
+            *p_out++     = SLIP_END;
+            space--;
+            m_tx.p_frame = NULL;
+            frame_list_push(&m_tx.done[buffer], p_frame);
+            continue;
+        }
+
+        run = slip_code_find(&p_frame->data[m_tx.pos], MIN(p_frame->length - m_tx.pos, space));
+        if (run > 0)
+        {
+            memcpy(p_out, &p_frame->data[m_tx.pos], run);
+            p_out    += run;
+            space    -= run;
+            m_tx.pos += run;
+            continue;
+        }
+
+        if (space < 2)
+        {
+            break;
+        }
+        byte     = p_frame->data[m_tx.pos++];
+        *p_out++ = SLIP_ESC;
+        *p_out++ = (byte == SLIP_END) ? SLIP_ESC_END : SLIP_ESC_ESC;
+        space   -= 2;
+    }
+
+    return (uint8_t)(HCI_UARTE_SLIP_TX_CHUNK_SIZE - space);
+}
+
+
+/**@brief Function for reporting and freeing the frames that end in a buffer.
+ */
+static void tx_done_notify(uint8_t buffer)
+{
+    slip_frame_t * p_frame;
+
+    while ((p_frame = frame_list_pop(&m_tx.done[buffer])) != NULL)
+    {
+        evt_send(HCI_UARTE_SLIP_EVT_TX_DONE, p_frame);
+        nrf_balloc_free(&m_tx_pool, p_frame);
+    }
+}
+
+
+/**@brief Function for sending a TX buffer.
+ */
+static void tx_buffer_send(uint8_t buffer)
+{
+    m_tx.sending = buffer;
+    UNUSED_RETURN_VALUE(nrf_drv_uart_tx(mp_config->p_uart,
+                                        m_tx_buffers[buffer],
+                                        m_tx.lengths[buffer]));
+}
+
+
+/**@brief Function for handling the end of a TX transfer.
+ *
+ * @details The other buffer, filled while this one was sent, is started first. This one is
+ *          then filled with the next data.
+ */
+static void tx_done(void)
+{
+    uint8_t done = m_tx.sending;
+    uint8_t next = done ^ 1;
+    bool    idle;
+
+    m_tx.lengths[done] = 0;
+    if (m_tx.lengths[next] == 0)
+    {
+        m_tx.lengths[next] = tx_encode(next);
+    }
+    if (m_tx.lengths[next] != 0)
+    {
+        tx_buffer_send(next);
+        tx_done_notify(done);
+        m_tx.lengths[done] = tx_encode(done);
+        return;
+    }
+
+    tx_done_notify(done);
+
+    // Checked with the queue locked, so that a frame queued after this starts a new transfer.
+    CRITICAL_REGION_ENTER();
+    idle = (m_tx.queue.p_head == NULL);
+    if (idle)
+    {
+        m_tx.busy = false;
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (!idle)
+    {
+        m_tx.lengths[next] = tx_encode(next);
+        tx_buffer_send(next);
+        m_tx.lengths[done] = tx_encode(done);
+    }
+}
+
+
+static void uart_event_handler(nrf_drv_uart_event_t * p_event, void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    switch (p_event->type)
+    {
+        case NRF_DRV_UART_EVT_RX_DONE:
+            rx_done(p_event->data.rxtx.bytes);
+            break;
+
+        case NRF_DRV_UART_EVT_TX_DONE:
+            tx_done();
+            break;
+
+        case NRF_DRV_UART_EVT_ERROR:
+        {
+            hci_uarte_slip_evt_t evt;
+
+            // The driver has dropped the queued transfers. If reception is being aborted, it is
+            // restarted on RX_DONE.
+            rx_frame_drop(true);
+            m_rx.queued = 0;
+            if (!m_rx.aborting)
+            {
+                while (m_rx.queued < RX_CHUNK_CNT)
+                {
+                    rx_queue();
+                }
+            }
+
+            evt.type              = HCI_UARTE_SLIP_EVT_ERROR;
+            evt.params.error_mask = p_event->data.error.error_mask;
+            mp_config->evt_handler(&evt);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+
+/**@brief Handler of the TIMER, which expires when the line has been idle.
+ *
+ * @details Called at the priority of the UART, so it does not preempt the UART handler.
+ */
+static void timer_handler(nrf_timer_event_t event_type, void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    if ((event_type == NRF_TIMER_EVENT_COMPARE0) && !m_rx.aborting && (m_rx.queued > 0))
+    {
+        m_rx.aborting = true;
+        nrf_drv_uart_rx_abort(mp_config->p_uart);
+    }
+}
+
+
+ret_code_t hci_uarte_slip_init(hci_uarte_slip_config_t const * p_config,
+                               nrf_drv_uart_config_t const *   p_uart_config)
+{
+    nrf_drv_timer_config_t timer_config = NRF_DRV_TIMER_DEFAULT_CONFIG;
+    ret_code_t             err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_config);
+    VERIFY_PARAM_NOT_NULL(p_uart_config);
+    VERIFY_PARAM_NOT_NULL(p_config->p_uart);
+    VERIFY_PARAM_NOT_NULL(p_config->p_timer);
+    VERIFY_PARAM_NOT_NULL(p_config->evt_handler);
+
+#ifdef UARTE_PRESENT
+    if (!p_uart_config->use_easy_dma)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+#else
+    return NRF_ERROR_INVALID_PARAM;
+#endif
+
+    memset(&m_rx, 0, sizeof(m_rx));
+    memset(&m_tx, 0, sizeof(m_tx));
+    mp_config = p_config;
+
+    err_code = nrf_balloc_init(&m_tx_pool);
+    VERIFY_SUCCESS(err_code);
+    err_code = nrf_balloc_init(&m_rx_pool);
+    VERIFY_SUCCESS(err_code);
+
+    err_code = nrf_drv_ppi_init();
+    if ((err_code != NRF_SUCCESS) && (err_code != NRF_ERROR_MODULE_ALREADY_INITIALIZED))
+    {
+        return err_code;
+    }
+
+    timer_config.frequency          = NRF_TIMER_FREQ_1MHz;
+    timer_config.bit_width          = NRF_TIMER_BIT_WIDTH_32;
+    timer_config.interrupt_priority = p_uart_config->interrupt_priority;
+    err_code = nrf_drv_timer_init(p_config->p_timer, &timer_config, timer_handler);
+    VERIFY_SUCCESS(err_code);
+
+    err_code = nrf_drv_ppi_channel_alloc(&m_ppi_channel);
+    if (err_code != NRF_SUCCESS)
+    {
+        nrf_drv_timer_uninit(p_config->p_timer);
+        return err_code;
+    }
+
+    err_code = nrf_drv_uart_init(p_config->p_uart, p_uart_config, uart_event_handler);
+    if (err_code != NRF_SUCCESS)
+    {
+        UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_free(m_ppi_channel));
+        nrf_drv_timer_uninit(p_config->p_timer);
+        return err_code;
+    }
+
+    // Every received byte restarts the TIMER, which stops itself when it expires.
+    nrf_drv_timer_extended_compare(p_config->p_timer,
+                                   NRF_TIMER_CC_CHANNEL0,
+                                   nrf_drv_timer_us_to_ticks(p_config->p_timer,
+                                                             HCI_UARTE_SLIP_RX_IDLE_US),
+                                   (nrf_timer_short_mask_t)(NRF_TIMER_SHORT_COMPARE0_STOP_MASK |
+                                                            NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK),
+                                   true);
+    nrf_drv_timer_enable(p_config->p_timer);
+    nrf_drv_timer_pause(p_config->p_timer);
+    nrf_drv_timer_clear(p_config->p_timer);
+
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_assign(m_ppi_channel,
+        nrf_drv_uart_event_address_get(p_config->p_uart, NRF_UART_EVENT_RXDRDY),
+        nrf_drv_timer_task_address_get(p_config->p_timer, NRF_TIMER_TASK_CLEAR)));
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_fork_assign(m_ppi_channel,
+        nrf_drv_timer_task_address_get(p_config->p_timer, NRF_TIMER_TASK_START)));
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_enable(m_ppi_channel));
+
+    m_rx.synced = false;
+    while (m_rx.queued < RX_CHUNK_CNT)
+    {
+        rx_queue();
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+void hci_uarte_slip_uninit(void)
+{
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_disable(m_ppi_channel));
+    UNUSED_RETURN_VALUE(nrf_drv_ppi_channel_free(m_ppi_channel));
+    nrf_drv_timer_disable(mp_config->p_timer);
+    nrf_drv_timer_uninit(mp_config->p_timer);
+    nrf_drv_uart_uninit(mp_config->p_uart);
+
+    memset(&m_rx, 0, sizeof(m_rx));
+    memset(&m_tx, 0, sizeof(m_tx));
+}
+
+
+uint8_t * hci_uarte_slip_tx_alloc(void)
+{
+    slip_frame_t * p_frame = nrf_balloc_alloc(&m_tx_pool);
+
+    return (p_frame != NULL) ? p_frame->data : NULL;
+}
+
+
+void hci_uarte_slip_tx_free(uint8_t * p_data)
+{
+    ASSERT(p_data != NULL);
+
+    nrf_balloc_free(&m_tx_pool, CONTAINER_OF(p_data, slip_frame_t, data));
+}
+
+
+ret_code_t hci_uarte_slip_tx_send(uint8_t * p_data, uint16_t length)
+{
+    slip_frame_t * p_frame;
+    bool           start = false;
+
+    ASSERT(p_data != NULL);
+
+    if ((length == 0) || (length > HCI_UARTE_SLIP_FRAME_SIZE))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    p_frame         = CONTAINER_OF(p_data, slip_frame_t, data);
+    p_frame->length = length;
+
+    CRITICAL_REGION_ENTER();
+    frame_list_push(&m_tx.queue, p_frame);
+    if (!m_tx.busy)
+    {
+        m_tx.busy = true;
+        start     = true;
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (start)
+    {
+        // Nothing is being sent, so both buffers are filled before the first one is started.
+        m_tx.lengths[0] = tx_encode(0);
+        m_tx.lengths[1] = tx_encode(1);
+        tx_buffer_send(0);
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+void hci_uarte_slip_rx_free(uint8_t * p_data)
+{
+    ASSERT(p_data != NULL);
+
+    nrf_balloc_free(&m_rx_pool, CONTAINER_OF(p_data, slip_frame_t, data));
+}
+
+#endif // NRF_MODULE_ENABLED(HCI_UARTE_SLIP)
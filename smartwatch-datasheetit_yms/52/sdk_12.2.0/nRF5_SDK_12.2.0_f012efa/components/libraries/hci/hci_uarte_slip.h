@@ -0,0 +1,197 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup hci_uarte_slip SLIP transport over UARTE
+ * @{
+ * @ingroup app_common
+ *
+ * @brief SLIP packet framing on a UARTE with EasyDMA.
+ *
+ * @details The module frames packets in the same way as @ref hci_slip, but it does not handle
+ *          the UART byte by byte:
+ *          - Data is received by EasyDMA into a ring buffer, in transfers of up to
+ *            @ref HCI_UARTE_SLIP_RX_CHUNK_SIZE bytes, two of which are always queued. A TIMER,
+ *            restarted through PPI by every received byte, ends a transfer that is not full
+ *            when the line has been idle for @ref HCI_UARTE_SLIP_RX_IDLE_US.
+ *          - Received data is scanned for SLIP codes a word at a time, and is copied to frame
+ *            buffers in runs.
+ *          - Frames to send are allocated from a pool, and any number of them can be queued.
+ *            They are encoded into two buffers, so that one is sent while the other is filled.
+ *
+ *          The CPU is woken once per transfer, not once per byte.
+ *
+ * @note The line is not received for a short time after it has been idle. Hardware flow control
+ *       is recommended, so that no byte is lost if the peer resumes sending at that time.
+ */
+
+#ifndef HCI_UARTE_SLIP_H__
+#define HCI_UARTE_SLIP_H__
+
+#include <stdint.h>
+#include "nrf_drv_uart.h"
+#include "nrf_drv_timer.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Maximum size of a frame, before encoding.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef HCI_UARTE_SLIP_FRAME_SIZE
+#define HCI_UARTE_SLIP_FRAME_SIZE 512
+#endif
+
+/** @brief Number of frames that can be queued for sending.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef HCI_UARTE_SLIP_TX_FRAME_COUNT
+#define HCI_UARTE_SLIP_TX_FRAME_COUNT 4
+#endif
+
+/** @brief Number of received frames that can be held by the user.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef HCI_UARTE_SLIP_RX_FRAME_COUNT
+#define HCI_UARTE_SLIP_RX_FRAME_COUNT 4
+#endif
+
+/** @brief Size of one RX transfer, 1 to 255.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef HCI_UARTE_SLIP_RX_CHUNK_SIZE
+#define HCI_UARTE_SLIP_RX_CHUNK_SIZE 255
+#endif
+
+/** @brief Size of the RX ring buffer. Must be at least twice @ref HCI_UARTE_SLIP_RX_CHUNK_SIZE.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef HCI_UARTE_SLIP_RX_BUFFER_SIZE
+#define HCI_UARTE_SLIP_RX_BUFFER_SIZE 512
+#endif
+
+/** @brief Size of each of the two TX buffers, 2 to 255.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef HCI_UARTE_SLIP_TX_CHUNK_SIZE
+#define HCI_UARTE_SLIP_TX_CHUNK_SIZE 255
+#endif
+
+/** @brief Idle time of the line after which received data is processed, in microseconds.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef HCI_UARTE_SLIP_RX_IDLE_US
+#define HCI_UARTE_SLIP_RX_IDLE_US 200
+#endif
+
+/**@brief Event types. */
+typedef enum
+{
+    HCI_UARTE_SLIP_EVT_RX_FRAME,    /**< A frame was received. It must be freed with @ref hci_uarte_slip_rx_free. */
+    HCI_UARTE_SLIP_EVT_TX_DONE,     /**< A frame was sent. It is freed when the handler returns. */
+    HCI_UARTE_SLIP_EVT_RX_OVERFLOW, /**< A frame was dropped, because it was too long or no frame buffer was free. */
+    HCI_UARTE_SLIP_EVT_ERROR,       /**< A UART error was detected. The frame being received was dropped. */
+} hci_uarte_slip_evt_type_t;
+
+/**@brief Event. */
+typedef struct
+{
+    hci_uarte_slip_evt_type_t type; /**< Type of the event. */
+    union
+    {
+        struct
+        {
+            uint8_t * p_data;       /**< Frame data. */
+            uint16_t  length;       /**< Frame length. */
+        } frame;                    /**< Parameters of @ref HCI_UARTE_SLIP_EVT_RX_FRAME and @ref HCI_UARTE_SLIP_EVT_TX_DONE. */
+        uint32_t error_mask;        /**< Error source of @ref HCI_UARTE_SLIP_EVT_ERROR. */
+    } params;
+} hci_uarte_slip_evt_t;
+
+/**@brief Event handler. Called from the interrupt context of the UART driver. */
+typedef void (* hci_uarte_slip_evt_handler_t)(hci_uarte_slip_evt_t const * p_evt);
+
+/**@brief Module configuration. */
+typedef struct
+{
+    nrf_drv_uart_t const *       p_uart;      /**< UART driver instance. Must use EasyDMA. */
+    nrf_drv_timer_t const *      p_timer;     /**< TIMER instance that detects the idle line. */
+    hci_uarte_slip_evt_handler_t evt_handler; /**< Event handler. */
+} hci_uarte_slip_config_t;
+
+/**@brief Function for initializing the module and starting reception.
+ *
+ * @details The TIMER uses the interrupt priority of the UART.
+ *
+ * @param[in] p_config      Module configuration. Must stay valid while the module is initialized.
+ * @param[in] p_uart_config UART driver configuration.
+ *
+ * @retval NRF_SUCCESS             If the module was initialized.
+ * @retval NRF_ERROR_NULL          If a required pointer was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If the UART configuration does not use EasyDMA.
+ * @retval NRF_ERROR_NO_MEM        If no PPI channel was available.
+ * @return Any error returned by the UART, TIMER or PPI driver.
+ */
+ret_code_t hci_uarte_slip_init(hci_uarte_slip_config_t const * p_config,
+                               nrf_drv_uart_config_t const *   p_uart_config);
+
+/**@brief Function for uninitializing the module. Queued frames are dropped.
+ */
+void hci_uarte_slip_uninit(void);
+
+/**@brief Function for allocating a frame to send.
+ *
+ * @return Buffer of @ref HCI_UARTE_SLIP_FRAME_SIZE bytes, or NULL if none is free.
+ */
+uint8_t * hci_uarte_slip_tx_alloc(void);
+
+/**@brief Function for freeing a frame that was allocated and not sent.
+ *
+ * @param[in] p_data Frame returned by @ref hci_uarte_slip_tx_alloc.
+ */
+void hci_uarte_slip_tx_free(uint8_t * p_data);
+
+/**@brief Function for queuing a frame for sending.
+ *
+ * @details The frame is owned by the module until @ref HCI_UARTE_SLIP_EVT_TX_DONE is reported.
+ *
+ * @param[in] p_data Frame returned by @ref hci_uarte_slip_tx_alloc.
+ * @param[in] length Length of the frame.
+ *
+ * @retval NRF_SUCCESS              If the frame was queued.
+ * @retval NRF_ERROR_INVALID_LENGTH If the frame was empty or too long.
+ */
+ret_code_t hci_uarte_slip_tx_send(uint8_t * p_data, uint16_t length);
+
+/**@brief Function for freeing a received frame.
+ *
+ * @param[in] p_data Frame reported by @ref HCI_UARTE_SLIP_EVT_RX_FRAME.
+ */
+void hci_uarte_slip_rx_free(uint8_t * p_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HCI_UARTE_SLIP_H__
+
+/** @} */
@@ -0,0 +1,79 @@
+/**
+ *
+ * @defgroup hci_uarte_slip_config SLIP transport over UARTE configuration
+ * @{
+ * @ingroup hci_uarte_slip
+ */
+/** @brief Enabling hci_uarte_slip module
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define HCI_UARTE_SLIP_ENABLED
+
+
+/** @brief Maximum size of a frame, before encoding
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define HCI_UARTE_SLIP_FRAME_SIZE
+
+
+/** @brief Number of frames that can be queued for sending
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define HCI_UARTE_SLIP_TX_FRAME_COUNT
+
+
+/** @brief Number of received frames that can be held by the user
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define HCI_UARTE_SLIP_RX_FRAME_COUNT
+
+
+/** @brief Size of one RX transfer
+ *
+ * Must be between 1 and 255.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define HCI_UARTE_SLIP_RX_CHUNK_SIZE
+
+
+/** @brief Size of the RX ring buffer
+ *
+ * Must be at least twice the size of one RX transfer.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define HCI_UARTE_SLIP_RX_BUFFER_SIZE
+
+
+/** @brief Size of each of the two TX buffers
+ *
+ * Must be between 2 and 255.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define HCI_UARTE_SLIP_TX_CHUNK_SIZE
+
+
+/** @brief Idle time of the line after which received data is processed, in microseconds
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define HCI_UARTE_SLIP_RX_IDLE_US
+
+
+
+/** @} */
@@ -0,0 +1,434 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(HW_SAMPLER)
+#include "hw_sampler.h"
+#include "nrf_drv_ppi.h"
+#include "nrf_drv_gpiote.h"
+#include "nrf_drv_common.h"
+#include "app_util_platform.h"
+
+/**@brief PPI channels used by the sampler. */
+typedef enum
+{
+    SAMPLER_PPI_TRIGGER, /**< RTC compare to transfer start, forked to RTC clear. */
+    SAMPLER_PPI_COUNT,   /**< Transfer end to TIMER count, forked to chip select release with SPIM. */
+    SAMPLER_PPI_CS,      /**< RTC compare to chip select assert, only with SPIM. */
+    SAMPLER_PPI_CHANNELS
+} sampler_ppi_idx_t;
+
+/**@brief Sampler control block. */
+typedef struct
+{
+    hw_sampler_config_t const * p_config;                           /**< Configuration. */
+    nrf_ppi_channel_t           ppi_channels[SAMPLER_PPI_CHANNELS]; /**< Allocated PPI channels. */
+    uint8_t                     ppi_channel_count;                  /**< Number of allocated PPI channels. */
+    uint8_t                     active_block;                       /**< Index of the block that is being filled. */
+    nrf_drv_state_t             state;                              /**< State of the sampler. */
+} hw_sampler_cb_t;
+
+static hw_sampler_cb_t m_cb;
+
+
+/**@brief Function for setting up the repeated transfer that fills a block.
+ *
+ * @details The transfer is not started. Each start task triggered by PPI performs one transfer,
+ *          and the receive pointer is advanced by one sample after the transfer.
+ *
+ * @param[in] p_block Block buffer to fill.
+ */
+static ret_code_t block_xfer_setup(uint8_t * p_block)
+{
+    hw_sampler_config_t const * p_config = m_cb.p_config;
+
+    if (p_config->bus == HW_SAMPLER_BUS_TWIM)
+    {
+#if NRF_MODULE_ENABLED(TWI)
+        nrf_drv_twi_xfer_desc_t xfer_desc =
+        {
+            .address          = p_config->bus_config.twim.address,
+            .primary_length   = (p_config->tx_length > 0) ? p_config->tx_length : p_config->sample_size,
+            .secondary_length = (p_config->tx_length > 0) ? p_config->sample_size : 0,
+            .p_primary_buf    = (p_config->tx_length > 0) ? (uint8_t *)p_config->p_tx_data : p_block,
+            .p_secondary_buf  = (p_config->tx_length > 0) ? p_block : NULL,
+            .type             = (p_config->tx_length > 0) ? NRF_DRV_TWI_XFER_TXRX : NRF_DRV_TWI_XFER_RX,
+        };
+
+        return nrf_drv_twi_xfer(p_config->bus_config.twim.p_instance,
+                                &xfer_desc,
+                                NRF_DRV_TWI_FLAG_HOLD_XFER           |
+                                NRF_DRV_TWI_FLAG_REPEATED_XFER       |
+                                NRF_DRV_TWI_FLAG_RX_POSTINC          |
+                                NRF_DRV_TWI_FLAG_NO_XFER_EVT_HANDLER);
+#endif
+    }
+    else
+    {
+#if NRF_MODULE_ENABLED(SPI)
+        nrf_drv_spi_xfer_desc_t xfer_desc =
+        {
+            .p_tx_buffer = p_config->p_tx_data,
+            .tx_length   = p_config->tx_length,
+            .p_rx_buffer = p_block,
+            .rx_length   = p_config->sample_size,
+        };
+
+        return nrf_drv_spi_xfer(p_config->bus_config.spim.p_instance,
+                                &xfer_desc,
+                                NRF_DRV_SPI_FLAG_HOLD_XFER           |
+                                NRF_DRV_SPI_FLAG_REPEATED_XFER       |
+                                NRF_DRV_SPI_FLAG_RX_POSTINC          |
+                                NRF_DRV_SPI_FLAG_NO_XFER_EVT_HANDLER);
+#endif
+    }
+
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+
+/**@brief Function for getting the addresses of the start task and the end event of the bus.
+ */
+static ret_code_t bus_addresses_get(uint32_t * p_start_task, uint32_t * p_end_event)
+{
+    hw_sampler_config_t const * p_config = m_cb.p_config;
+
+    if (p_config->bus == HW_SAMPLER_BUS_TWIM)
+    {
+#if NRF_MODULE_ENABLED(TWI)
+        *p_start_task = nrf_drv_twi_start_task_get(p_config->bus_config.twim.p_instance,
+                                                   (p_config->tx_length > 0) ?
+                                                   NRF_DRV_TWI_XFER_TXRX : NRF_DRV_TWI_XFER_RX);
+        *p_end_event  = nrf_drv_twi_stopped_event_get(p_config->bus_config.twim.p_instance);
+        return NRF_SUCCESS;
+#endif
+    }
+    else
+    {
+#if NRF_MODULE_ENABLED(SPI)
+        *p_start_task = nrf_drv_spi_start_task_get(p_config->bus_config.spim.p_instance);
+        *p_end_event  = nrf_drv_spi_end_event_get(p_config->bus_config.spim.p_instance);
+        return NRF_SUCCESS;
+#endif
+    }
+
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+
+/**@brief Function for allocating and assigning the PPI channels.
+ */
+static ret_code_t ppi_setup(void)
+{
+    hw_sampler_config_t const * p_config = m_cb.p_config;
+    ret_code_t                  err_code;
+    uint32_t                    start_task;
+    uint32_t                    end_event;
+    uint32_t const              rtc_compare_event =
+        nrf_drv_rtc_event_address_get(p_config->p_rtc, NRF_RTC_EVENT_COMPARE_0);
+
+    err_code = bus_addresses_get(&start_task, &end_event);
+    VERIFY_SUCCESS(err_code);
+
+    err_code = nrf_drv_ppi_init();
+    if ((err_code != NRF_SUCCESS) && (err_code != NRF_ERROR_MODULE_ALREADY_INITIALIZED))
+    {
+        return NRF_ERROR_INTERNAL;
+    }
+
+    m_cb.ppi_channel_count = (p_config->bus == HW_SAMPLER_BUS_SPIM) ? SAMPLER_PPI_CHANNELS : SAMPLER_PPI_CS;
+    for (uint32_t i = 0; i < m_cb.ppi_channel_count; i++)
+    {
+        if (nrf_drv_ppi_channel_alloc(&m_cb.ppi_channels[i]) != NRF_SUCCESS)
+        {
+            m_cb.ppi_channel_count = i;
+            return NRF_ERROR_NO_MEM;
+        }
+    }
+
+    (void)nrf_drv_ppi_channel_assign(m_cb.ppi_channels[SAMPLER_PPI_TRIGGER],
+                                     rtc_compare_event,
+                                     start_task);
+    (void)nrf_drv_ppi_channel_fork_assign(m_cb.ppi_channels[SAMPLER_PPI_TRIGGER],
+                                          nrf_drv_rtc_task_address_get(p_config->p_rtc,
+                                                                       NRF_RTC_TASK_CLEAR));
+
+    (void)nrf_drv_ppi_channel_assign(m_cb.ppi_channels[SAMPLER_PPI_COUNT],
+                                     end_event,
+                                     nrf_drv_timer_task_address_get(p_config->p_timer,
+                                                                    NRF_TIMER_TASK_COUNT));
+
+    if (p_config->bus == HW_SAMPLER_BUS_SPIM)
+    {
+#if defined(GPIOTE_FEATURE_SET_PRESENT) && defined(GPIOTE_FEATURE_CLR_PRESENT)
+        uint32_t const cs_pin = p_config->bus_config.spim.cs_pin;
+
+        (void)nrf_drv_ppi_channel_fork_assign(m_cb.ppi_channels[SAMPLER_PPI_COUNT],
+                                              nrf_drv_gpiote_set_task_addr_get(cs_pin));
+        (void)nrf_drv_ppi_channel_assign(m_cb.ppi_channels[SAMPLER_PPI_CS],
+                                         rtc_compare_event,
+                                         nrf_drv_gpiote_clr_task_addr_get(cs_pin));
+#else
+        return NRF_ERROR_NOT_SUPPORTED;
+#endif
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for freeing the PPI channels.
+ */
+static void ppi_free(void)
+{
+    for (uint32_t i = 0; i < m_cb.ppi_channel_count; i++)
+    {
+        (void)nrf_drv_ppi_channel_disable(m_cb.ppi_channels[i]);
+        (void)nrf_drv_ppi_channel_free(m_cb.ppi_channels[i]);
+    }
+    m_cb.ppi_channel_count = 0;
+}
+
+
+/**@brief Function for setting up the chip select pin, which is driven by GPIOTE tasks.
+ */
+static ret_code_t cs_pin_setup(void)
+{
+    ret_code_t                  err_code;
+    nrf_drv_gpiote_out_config_t cs_config = GPIOTE_CONFIG_OUT_TASK_TOGGLE(true);
+
+    if (!nrf_drv_gpiote_is_init())
+    {
+        err_code = nrf_drv_gpiote_init();
+        VERIFY_SUCCESS(err_code);
+    }
+
+    err_code = nrf_drv_gpiote_out_init(m_cb.p_config->bus_config.spim.cs_pin, &cs_config);
+    VERIFY_SUCCESS(err_code);
+
+    nrf_drv_gpiote_out_task_enable(m_cb.p_config->bus_config.spim.cs_pin);
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Handler for the RTC. The RTC runs without interrupts. */
+static void rtc_handler(nrf_drv_rtc_int_type_t int_type)
+{
+    UNUSED_PARAMETER(int_type);
+}
+
+
+/**@brief Handler for the TIMER, called when a block is full.
+ */
+static void timer_handler(nrf_timer_event_t event_type, void * p_context)
+{
+    hw_sampler_config_t const * p_config = m_cb.p_config;
+    uint8_t                     full_block;
+
+    UNUSED_PARAMETER(p_context);
+
+    if ((event_type != NRF_TIMER_EVENT_COMPARE0) || (m_cb.state != NRF_DRV_STATE_POWERED_ON))
+    {
+        return;
+    }
+
+    // Point EasyDMA to the other block before the next sample is started.
+    full_block        = m_cb.active_block;
+    m_cb.active_block = full_block ^ 1;
+    (void)block_xfer_setup(p_config->p_blocks[m_cb.active_block]);
+
+    p_config->handler(p_config->p_blocks[full_block], p_config->block_samples);
+}
+
+
+ret_code_t hw_sampler_init(hw_sampler_config_t const * p_config)
+{
+    ret_code_t             err_code;
+    nrf_drv_timer_config_t timer_config = NRF_DRV_TIMER_DEFAULT_CONFIG;
+
+    VERIFY_PARAM_NOT_NULL(p_config);
+    VERIFY_PARAM_NOT_NULL(p_config->p_rtc);
+    VERIFY_PARAM_NOT_NULL(p_config->p_timer);
+    VERIFY_PARAM_NOT_NULL(p_config->handler);
+    VERIFY_PARAM_NOT_NULL(p_config->p_blocks[0]);
+    VERIFY_PARAM_NOT_NULL(p_config->p_blocks[1]);
+
+    if (m_cb.state != NRF_DRV_STATE_UNINITIALIZED)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if ((p_config->sample_size == 0) || (p_config->block_samples == 0) ||
+        (p_config->period_ticks == 0) ||
+        ((p_config->tx_length > 0) && (p_config->p_tx_data == NULL)) ||
+        ((p_config->bus == HW_SAMPLER_BUS_SPIM) && (p_config->tx_length > p_config->sample_size)))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    m_cb.p_config = p_config;
+
+    err_code = ppi_setup();
+    if (err_code != NRF_SUCCESS)
+    {
+        ppi_free();
+        return err_code;
+    }
+
+    if (p_config->bus == HW_SAMPLER_BUS_SPIM)
+    {
+        err_code = cs_pin_setup();
+        if (err_code != NRF_SUCCESS)
+        {
+            ppi_free();
+            return NRF_ERROR_NO_MEM;
+        }
+    }
+
+    err_code = nrf_drv_rtc_init(p_config->p_rtc, NULL, rtc_handler);
+    if (err_code == NRF_SUCCESS)
+    {
+#if defined(TIMER_MODE_MODE_LowPowerCounter)
+        timer_config.mode = NRF_TIMER_MODE_LOW_POWER_COUNTER;
+#else
+        timer_config.mode = NRF_TIMER_MODE_COUNTER;
+#endif
+        err_code = nrf_drv_timer_init(p_config->p_timer, &timer_config, timer_handler);
+        if (err_code != NRF_SUCCESS)
+        {
+            nrf_drv_rtc_uninit(p_config->p_rtc);
+        }
+    }
+
+    if (err_code != NRF_SUCCESS)
+    {
+        if (p_config->bus == HW_SAMPLER_BUS_SPIM)
+        {
+            nrf_drv_gpiote_out_uninit(p_config->bus_config.spim.cs_pin);
+        }
+        ppi_free();
+        return err_code;
+    }
+
+    // The compare event, not its interrupt, is used to start the transfers.
+    (void)nrf_drv_rtc_cc_set(p_config->p_rtc, 0, p_config->period_ticks, false);
+    nrf_drv_timer_extended_compare(p_config->p_timer,
+                                   NRF_TIMER_CC_CHANNEL0,
+                                   p_config->block_samples,
+                                   NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK,
+                                   true);
+
+    m_cb.state = NRF_DRV_STATE_INITIALIZED;
+
+    return NRF_SUCCESS;
+}
+
+
+void hw_sampler_uninit(void)
+{
+    if (m_cb.state == NRF_DRV_STATE_UNINITIALIZED)
+    {
+        return;
+    }
+
+    hw_sampler_stop();
+
+    nrf_drv_timer_uninit(m_cb.p_config->p_timer);
+    nrf_drv_rtc_uninit(m_cb.p_config->p_rtc);
+    if (m_cb.p_config->bus == HW_SAMPLER_BUS_SPIM)
+    {
+        nrf_drv_gpiote_out_uninit(m_cb.p_config->bus_config.spim.cs_pin);
+    }
+    ppi_free();
+
+    m_cb.state = NRF_DRV_STATE_UNINITIALIZED;
+}
+
+
+ret_code_t hw_sampler_start(void)
+{
+    ret_code_t err_code;
+
+    if (m_cb.state != NRF_DRV_STATE_INITIALIZED)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    m_cb.active_block = 0;
+    err_code = block_xfer_setup(m_cb.p_config->p_blocks[0]);
+    VERIFY_SUCCESS(err_code);
+
+    nrf_drv_timer_clear(m_cb.p_config->p_timer);
+    nrf_drv_timer_enable(m_cb.p_config->p_timer);
+
+    for (uint32_t i = 0; i < m_cb.ppi_channel_count; i++)
+    {
+        (void)nrf_drv_ppi_channel_enable(m_cb.ppi_channels[i]);
+    }
+
+    m_cb.state = NRF_DRV_STATE_POWERED_ON;
+
+    nrf_drv_rtc_counter_clear(m_cb.p_config->p_rtc);
+    nrf_drv_rtc_enable(m_cb.p_config->p_rtc);
+
+    return NRF_SUCCESS;
+}
+
+
+void hw_sampler_stop(void)
+{
+    if (m_cb.state != NRF_DRV_STATE_POWERED_ON)
+    {
+        return;
+    }
+
+    nrf_drv_rtc_disable(m_cb.p_config->p_rtc);
+
+    // The channel that counts transfer ends, and releases chip select, is left enabled until the
+    // TIMER is stopped, so that a transfer in progress completes cleanly.
+    (void)nrf_drv_ppi_channel_disable(m_cb.ppi_channels[SAMPLER_PPI_TRIGGER]);
+    if (m_cb.p_config->bus == HW_SAMPLER_BUS_SPIM)
+    {
+        (void)nrf_drv_ppi_channel_disable(m_cb.ppi_channels[SAMPLER_PPI_CS]);
+    }
+
+    m_cb.state = NRF_DRV_STATE_INITIALIZED;
+
+    nrf_drv_timer_disable(m_cb.p_config->p_timer);
+    (void)nrf_drv_ppi_channel_disable(m_cb.ppi_channels[SAMPLER_PPI_COUNT]);
+}
+
+
+ret_code_t hw_sampler_period_set(uint32_t period_ticks)
+{
+    if (m_cb.state == NRF_DRV_STATE_UNINITIALIZED)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    if (period_ticks == 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    CRITICAL_REGION_ENTER();
+    (void)nrf_drv_rtc_cc_set(m_cb.p_config->p_rtc, 0, period_ticks, false);
+    // A counter already at or past the new compare value would only wrap around: the period is
+    // restarted instead. A compare value closer than 2 ticks may not generate the event either.
+    if (nrf_drv_rtc_counter_get(m_cb.p_config->p_rtc) + 2 >= period_ticks)
+    {
+        nrf_drv_rtc_counter_clear(m_cb.p_config->p_rtc);
+    }
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+
+#endif // NRF_MODULE_ENABLED(HW_SAMPLER)
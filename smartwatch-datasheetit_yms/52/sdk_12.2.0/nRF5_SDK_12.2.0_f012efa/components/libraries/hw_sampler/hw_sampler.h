@@ -0,0 +1,147 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup hw_sampler Hardware sampler
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for reading a sensor at a fixed rate without CPU involvement.
+ *
+ * @details An RTC compare event starts a prepared TWIM or SPIM transfer through PPI, and clears
+ *          the RTC for the next period. Every transfer writes the same bytes to the sensor, for
+ *          example a register address, and reads one sample. EasyDMA stores the samples one after
+ *          the other in a block buffer (ArrayList). A TIMER in low-power counter mode counts the
+ *          finished transfers, and its interrupt is the only CPU wakeup: when a block of samples
+ *          is full, the next block buffer is set up and the full block is passed to the user.
+ *
+ *          One instance uses an RTC, a TIMER, two PPI channels, and for SPIM a third PPI channel
+ *          and a GPIOTE channel for the chip select pin.
+ *
+ * @note The next block must be set up before the next sample is started, so the interrupt
+ *       priority of the TIMER must allow its interrupt to be handled within one sample period.
+ * @note The TWIM or SPIM driver instance must be initialized by the user in non-blocking mode, and
+ *       must not be used for other transfers while the sampler is running.
+ */
+
+#ifndef HW_SAMPLER_H__
+#define HW_SAMPLER_H__
+
+#include <stdint.h>
+#include "nrf_drv_rtc.h"
+#include "nrf_drv_timer.h"
+#include "nrf_drv_twi.h"
+#include "nrf_drv_spi.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**@brief Buses that can be sampled. */
+typedef enum
+{
+    HW_SAMPLER_BUS_TWIM, /**< TWI master with EasyDMA. */
+    HW_SAMPLER_BUS_SPIM, /**< SPI master with EasyDMA. */
+} hw_sampler_bus_t;
+
+/**@brief Handler for full blocks of samples.
+ *
+ * @param[in] p_block      Block buffer with the samples. It is not written again until it is
+ *                         returned to the sampler, which happens when the other block is full.
+ * @param[in] sample_count Number of samples in the block.
+ */
+typedef void (* hw_sampler_handler_t)(uint8_t * p_block, uint16_t sample_count);
+
+/**@brief Sampler configuration. */
+typedef struct
+{
+    hw_sampler_bus_t         bus;            /**< Bus of the sensor. */
+    union
+    {
+        struct
+        {
+            nrf_drv_twi_t const * p_instance; /**< Initialized TWIM driver instance. */
+            uint8_t               address;    /**< Address of the sensor. */
+        } twim;                               /**< Used with @ref HW_SAMPLER_BUS_TWIM. */
+        struct
+        {
+            nrf_drv_spi_t const * p_instance; /**< Initialized SPIM driver instance, without a slave select pin. */
+            uint32_t              cs_pin;     /**< Active low chip select pin of the sensor. */
+        } spim;                               /**< Used with @ref HW_SAMPLER_BUS_SPIM. */
+    } bus_config;                             /**< Bus specific configuration. */
+    uint8_t const *          p_tx_data;      /**< Bytes written before every sample, for example the register address. Must be in RAM. */
+    uint8_t                  tx_length;      /**< Number of bytes in @p p_tx_data. Can be 0 with TWIM. */
+    uint8_t                  sample_size;    /**< Number of bytes read for every sample. With SPIM, this includes the bytes clocked in while @p p_tx_data is written. */
+    uint16_t                 block_samples;  /**< Number of samples in a block. */
+    uint8_t                * p_blocks[2];    /**< Two block buffers of @p block_samples * @p sample_size bytes, in RAM. */
+    nrf_drv_rtc_t const *    p_rtc;          /**< RTC instance that times the samples. */
+    uint32_t                 period_ticks;   /**< Sample period, in ticks of the RTC with its default configuration. */
+    nrf_drv_timer_t const *  p_timer;        /**< TIMER instance that counts the samples. */
+    hw_sampler_handler_t     handler;        /**< Handler for full blocks. */
+} hw_sampler_config_t;
+
+/**@brief Function for initializing the sampler.
+ *
+ * @details The RTC and TIMER instances are initialized, and the PPI channels are allocated.
+ *
+ * @param[in] p_config Sampler configuration. The configuration must stay valid while the sampler
+ *                     is initialized.
+ *
+ * @retval NRF_SUCCESS             If the sampler was initialized.
+ * @retval NRF_ERROR_NULL          If a required pointer was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If the configuration was invalid.
+ * @retval NRF_ERROR_INVALID_STATE If the sampler was already initialized.
+ * @retval NRF_ERROR_NO_MEM        If no PPI or GPIOTE channel was available.
+ * @return Any error returned by the RTC or TIMER driver.
+ */
+ret_code_t hw_sampler_init(hw_sampler_config_t const * p_config);
+
+/**@brief Function for uninitializing the sampler and freeing its resources.
+ */
+void hw_sampler_uninit(void);
+
+/**@brief Function for starting sampling into the first block.
+ *
+ * @retval NRF_SUCCESS             If sampling was started.
+ * @retval NRF_ERROR_INVALID_STATE If the sampler was not initialized, or is already running.
+ * @return Any error returned by the TWIM or SPIM driver when the transfer is set up.
+ */
+ret_code_t hw_sampler_start(void);
+
+/**@brief Function for stopping sampling.
+ *
+ * @details The samples of a block that is not full are discarded.
+ */
+void hw_sampler_stop(void);
+
+/**@brief Function for changing the sample period, while sampling or not.
+ *
+ * @details The transfer and block setup are not changed, so the change takes effect at the next
+ *          sample.
+ *
+ * @param[in] period_ticks Sample period, in ticks of the RTC with its default configuration.
+ *
+ * @retval NRF_SUCCESS             If the period was changed.
+ * @retval NRF_ERROR_INVALID_PARAM If the period was 0.
+ * @retval NRF_ERROR_INVALID_STATE If the sampler was not initialized.
+ */
+ret_code_t hw_sampler_period_set(uint32_t period_ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HW_SAMPLER_H__
+
+/** @} */
@@ -0,0 +1,16 @@
+/**
+ *
+ * @defgroup hw_sampler_config hw_sampler module configuration
+ * @{
+ * @ingroup hw_sampler
+ */
+/** @brief Enabling hw_sampler module
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define HW_SAMPLER_ENABLED
+
+
+/** @} */
@@ -0,0 +1,56 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(ICACHE_PROFILER)
+#include "icache_profiler.h"
+#include "nrf.h"
+#include "app_util_platform.h"
+
+#ifndef NVMC_ICACHECNF_CACHEPROFEN_Msk
+#error "The instruction cache profiler requires the instruction cache of nRF52."
+#endif
+
+
+void icache_profiler_start(void)
+{
+    NRF_NVMC->ICACHECNF = NVMC_ICACHECNF_CACHEEN_Msk | NVMC_ICACHECNF_CACHEPROFEN_Msk;
+    NRF_NVMC->IHIT      = 0;
+    NRF_NVMC->IMISS     = 0;
+}
+
+
+void icache_profiler_stop(void)
+{
+    NRF_NVMC->ICACHECNF = NVMC_ICACHECNF_CACHEEN_Msk;
+}
+
+
+void icache_profiler_stats_get(icache_profiler_stats_t * p_stats, bool reset)
+{
+    uint64_t total;
+
+    // The counters run while they are read, so they are read and cleared together.
+    CRITICAL_REGION_ENTER();
+    p_stats->hits   = NRF_NVMC->IHIT;
+    p_stats->misses = NRF_NVMC->IMISS;
+    if (reset)
+    {
+        NRF_NVMC->IHIT  = 0;
+        NRF_NVMC->IMISS = 0;
+    }
+    CRITICAL_REGION_EXIT();
+
+    total              = (uint64_t)p_stats->hits + p_stats->misses;
+    p_stats->hit_ratio = (total == 0) ? 0 : (uint16_t)(((uint64_t)p_stats->hits * 1000) / total);
+}
+
+#endif // NRF_MODULE_ENABLED(ICACHE_PROFILER)
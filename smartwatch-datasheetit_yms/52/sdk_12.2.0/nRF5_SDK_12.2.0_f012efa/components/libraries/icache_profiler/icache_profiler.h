@@ -0,0 +1,70 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup icache_profiler Instruction cache profiler
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for measuring the hit ratio of the flash instruction cache of the NVMC.
+ *
+ * @details The cache is enabled with its hit and miss counters. Every miss costs flash wait
+ *          states, so a low hit ratio while a handler runs shows that it is worth running it
+ *          from RAM with @ref __RAMFUNC. GPIOTE_CONFIG_IRQ_RAMFUNC, SAADC_CONFIG_IRQ_RAMFUNC and
+ *          @ref NRF_ESB_IRQ_RAMFUNC do this for the interrupt handlers of these modules.
+ *
+ * @note The counters cost some current while profiling is enabled, so it is meant for
+ *       development. The cache itself stays enabled when profiling is stopped.
+ * @note Requires the instruction cache of nRF52.
+ */
+
+#ifndef ICACHE_PROFILER_H__
+#define ICACHE_PROFILER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**@brief Counters of the instruction cache. */
+typedef struct
+{
+    uint32_t hits;            /**< Fetches served by the cache. */
+    uint32_t misses;          /**< Fetches from flash. */
+    uint16_t hit_ratio;       /**< Hits per mille of all fetches, or 0 if there was none. */
+} icache_profiler_stats_t;
+
+/**@brief Function for enabling the cache and starting the profiling from cleared counters.
+ */
+void icache_profiler_start(void);
+
+/**@brief Function for stopping the profiling. The counters keep their values.
+ */
+void icache_profiler_stop(void);
+
+/**@brief Function for getting the counters since the start or the last reset.
+ *
+ * @param[out] p_stats Counters.
+ * @param[in]  reset   Clear the counters after reading them, to measure the next period.
+ */
+void icache_profiler_stats_get(icache_profiler_stats_t * p_stats, bool reset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ICACHE_PROFILER_H__
+
+/** @} */
@@ -0,0 +1,18 @@
+/**
+ *
+ * @defgroup icache_profiler_config Instruction cache profiler configuration
+ * @{
+ * @ingroup icache_profiler
+ */
+/** @brief Enabling the instruction cache profiler
+ *
+ *  Requires nRF52.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define ICACHE_PROFILER_ENABLED
+
+
+/** @} */
@@ -0,0 +1,174 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(LATENCY_PROBE)
+#include "latency_probe.h"
+#include "nrf_drv_ppi.h"
+#include "app_util_platform.h"
+
+/**@brief Probe. */
+typedef struct
+{
+    nrf_ppi_channel_t       channel;
+    nrf_ppi_channel_group_t group;    /**< Group of the channel, for a one-shot probe. */
+    bool                    one_shot;
+    bool                    armed;    /**< The probe has been armed at least once. */
+} probe_t;
+
+static struct
+{
+    nrf_drv_timer_t const * p_timer;
+    probe_t                 probes[LATENCY_PROBE_MAX];
+    uint8_t                 probe_count;
+    nrf_timer_cc_channel_t  mark_channel; /**< Capture/compare channel of the software marks. */
+} m_cb;
+
+
+/**@brief Handler for the TIMER. It runs without interrupts. */
+static void timer_handler(nrf_timer_event_t event_type, void * p_context)
+{
+    UNUSED_PARAMETER(event_type);
+    UNUSED_PARAMETER(p_context);
+}
+
+
+ret_code_t latency_probe_init(nrf_drv_timer_t const * p_timer)
+{
+    nrf_drv_timer_config_t timer_config = NRF_DRV_TIMER_DEFAULT_CONFIG;
+    ret_code_t             err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_timer);
+
+    memset(&m_cb, 0, sizeof(m_cb));
+    m_cb.p_timer      = p_timer;
+    m_cb.mark_channel = (nrf_timer_cc_channel_t)(p_timer->cc_channel_count - 1);
+
+    err_code = nrf_drv_ppi_init();
+    if ((err_code != NRF_SUCCESS) && (err_code != NRF_ERROR_MODULE_ALREADY_INITIALIZED))
+    {
+        return NRF_ERROR_INTERNAL;
+    }
+
+    timer_config.frequency = (nrf_timer_frequency_t)LATENCY_PROBE_CONFIG_FREQUENCY;
+    timer_config.mode      = NRF_TIMER_MODE_TIMER;
+    timer_config.bit_width = NRF_TIMER_BIT_WIDTH_32;
+
+    return nrf_drv_timer_init(p_timer, &timer_config, timer_handler);
+}
+
+
+ret_code_t latency_probe_add(uint32_t event_address, bool one_shot, latency_probe_t * p_probe)
+{
+    VERIFY_PARAM_NOT_NULL(p_probe);
+
+    if ((m_cb.probe_count == LATENCY_PROBE_MAX) || (m_cb.probe_count == m_cb.mark_channel))
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    probe_t * p = &m_cb.probes[m_cb.probe_count];
+    uint32_t  capture_task = nrf_drv_timer_capture_task_address_get(
+                                 m_cb.p_timer, (nrf_timer_cc_channel_t)m_cb.probe_count);
+
+    if (nrf_drv_ppi_channel_alloc(&p->channel) != NRF_SUCCESS)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+    (void)nrf_drv_ppi_channel_assign(p->channel, event_address, capture_task);
+
+    p->one_shot = one_shot;
+    p->armed    = false;
+    if (one_shot)
+    {
+        if (nrf_drv_ppi_group_alloc(&p->group) != NRF_SUCCESS)
+        {
+            (void)nrf_drv_ppi_channel_free(p->channel);
+            return NRF_ERROR_NO_MEM;
+        }
+        // The event disables the channel that captured it.
+        (void)nrf_drv_ppi_channel_include_in_group(p->channel, p->group);
+        (void)nrf_drv_ppi_channel_fork_assign(p->channel,
+                                              nrf_drv_ppi_task_addr_group_disable_get(p->group));
+    }
+    else
+    {
+        (void)nrf_drv_ppi_channel_enable(p->channel);
+    }
+
+    *p_probe = m_cb.probe_count++;
+    return NRF_SUCCESS;
+}
+
+
+void latency_probe_start(void)
+{
+    nrf_drv_timer_clear(m_cb.p_timer);
+    nrf_drv_timer_enable(m_cb.p_timer);
+}
+
+
+void latency_probe_stop(void)
+{
+    nrf_drv_timer_disable(m_cb.p_timer);
+}
+
+
+void latency_probe_arm(latency_probe_t probe)
+{
+    ASSERT(probe < m_cb.probe_count);
+    probe_t * p = &m_cb.probes[probe];
+
+    if (p->one_shot)
+    {
+        p->armed = true;
+        (void)nrf_drv_ppi_group_enable(p->group);
+    }
+}
+
+
+uint32_t latency_probe_mark(void)
+{
+    uint32_t timestamp;
+
+    // The capture register is shared by all callers.
+    CRITICAL_REGION_ENTER();
+    timestamp = nrf_drv_timer_capture(m_cb.p_timer, m_cb.mark_channel);
+    CRITICAL_REGION_EXIT();
+
+    return timestamp;
+}
+
+
+bool latency_probe_get(latency_probe_t probe, uint32_t * p_timestamp)
+{
+    ASSERT(probe < m_cb.probe_count);
+    ASSERT(p_timestamp != NULL);
+    probe_t const * p = &m_cb.probes[probe];
+
+    if (p->one_shot &&
+        (!p->armed || (nrf_ppi_channel_enable_get(p->channel) == NRF_PPI_CHANNEL_ENABLED)))
+    {
+        return false;
+    }
+
+    *p_timestamp = nrf_drv_timer_capture_get(m_cb.p_timer, (nrf_timer_cc_channel_t)probe);
+    return true;
+}
+
+
+uint32_t latency_probe_us(uint32_t from, uint32_t to)
+{
+    // A tick lasts 2^frequency / 16 us.
+    return (uint32_t)(((uint64_t)(to - from) << LATENCY_PROBE_CONFIG_FREQUENCY) >> 4);
+}
+
+#endif // NRF_MODULE_ENABLED(LATENCY_PROBE)
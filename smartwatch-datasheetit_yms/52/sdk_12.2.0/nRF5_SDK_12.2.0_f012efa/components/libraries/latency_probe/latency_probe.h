@@ -0,0 +1,133 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup latency_probe Latency probes
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for time stamping hardware events with a TIMER through PPI, to measure latencies.
+ *
+ * @details A free running TIMER is the time base. Every probe is a PPI channel from a hardware
+ *          event, like a GPIOTE edge, RADIO END, SAADC END or TWIM STOPPED, to a CAPTURE task of
+ *          the TIMER. The time stamp is taken by the hardware, with no CPU involvement and no
+ *          jitter, and read later. The last capture/compare channel is kept for software marks,
+ *          taken with @ref latency_probe_mark.
+ *
+ *          A one-shot probe captures only the first event after it was armed: its channel is in a
+ *          PPI group that the event itself disables, through the fork of the channel. A latency,
+ *          like button to display, is then the time from a mark, or from a first probe, to the
+ *          first event of a second probe armed at the same time.
+ *
+ *          The event address of a probe is taken from the driver of the peripheral, for example
+ *          @ref nrf_drv_gpiote_in_event_addr_get, or directly, for example
+ *          (uint32_t)&NRF_RADIO->EVENTS_END.
+ *
+ * @note The TIMER keeps HFCLK running while the module is started. The time stamps are only as
+ *       accurate as the HFINT oscillator, unless the crystal oscillator is started.
+ */
+
+#ifndef LATENCY_PROBE_H__
+#define LATENCY_PROBE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nrf_drv_timer.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Frequency of the TIMER (@ref nrf_timer_frequency_t).
+ *
+ * The 32-bit TIMER wraps after about 71 minutes at 1 MHz, and after about 4 minutes at 16 MHz.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef LATENCY_PROBE_CONFIG_FREQUENCY
+#define LATENCY_PROBE_CONFIG_FREQUENCY NRF_TIMER_FREQ_1MHz
+#endif
+
+/** @brief Highest number of probes. Also limited by the capture/compare channels of the TIMER,
+ *         less one, and by the PPI groups for one-shot probes.
+ */
+#define LATENCY_PROBE_MAX 5
+
+/**@brief Identifier of a probe. */
+typedef uint8_t latency_probe_t;
+
+/**@brief Function for initializing the module.
+ *
+ * @param[in] p_timer TIMER instance. Must not be initialized.
+ *
+ * @retval NRF_ERROR_INTERNAL If the PPI driver could not be initialized.
+ * @return Any error returned by the TIMER driver.
+ */
+ret_code_t latency_probe_init(nrf_drv_timer_t const * p_timer);
+
+/**@brief Function for adding a probe.
+ *
+ * @param[in]  event_address Address of the hardware event.
+ * @param[in]  one_shot      True to capture only the first event after @ref latency_probe_arm.
+ *                           False to capture every event, the last one being kept.
+ * @param[out] p_probe       Identifier of the probe.
+ *
+ * @retval NRF_SUCCESS    If the probe was added. A probe that is not one-shot is capturing.
+ * @retval NRF_ERROR_NULL If p_probe was NULL.
+ * @retval NRF_ERROR_NO_MEM If no capture/compare channel, PPI channel or PPI group was free.
+ */
+ret_code_t latency_probe_add(uint32_t event_address, bool one_shot, latency_probe_t * p_probe);
+
+/**@brief Function for starting the TIMER from zero. */
+void latency_probe_start(void);
+
+/**@brief Function for stopping the TIMER. The captured time stamps are kept. */
+void latency_probe_stop(void);
+
+/**@brief Function for arming a one-shot probe, which then captures the next event.
+ *
+ * @param[in] probe Probe.
+ */
+void latency_probe_arm(latency_probe_t probe);
+
+/**@brief Function for taking a software time stamp.
+ *
+ * @return Time stamp, in TIMER ticks.
+ */
+uint32_t latency_probe_mark(void);
+
+/**@brief Function for reading the time stamp of a probe.
+ *
+ * @param[in]  probe       Probe.
+ * @param[out] p_timestamp Time stamp of the last event captured, in TIMER ticks.
+ *
+ * @retval true  If an event was captured.
+ * @retval false If the probe is one-shot, and still armed.
+ */
+bool latency_probe_get(latency_probe_t probe, uint32_t * p_timestamp);
+
+/**@brief Function for converting the time between two time stamps to microseconds.
+ *
+ * @param[in] from Earlier time stamp.
+ * @param[in] to   Later time stamp.
+ */
+uint32_t latency_probe_us(uint32_t from, uint32_t to);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LATENCY_PROBE_H__
+
+/** @} */
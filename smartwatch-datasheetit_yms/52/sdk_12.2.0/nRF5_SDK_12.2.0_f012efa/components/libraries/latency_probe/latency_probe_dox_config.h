@@ -0,0 +1,35 @@
+/**
+ *
+ * @defgroup latency_probe_config Latency probes configuration
+ * @{
+ * @ingroup latency_probe
+ */
+/** @brief Enabling the latency probes
+ *
+ *  Requires the TIMER and PPI drivers.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define LATENCY_PROBE_ENABLED
+
+/** @brief Frequency of the TIMER.
+ *
+ *  <0=> 16 MHz
+ *  <1=> 8 MHz
+ *  <2=> 4 MHz
+ *  <3=> 2 MHz
+ *  <4=> 1 MHz
+ *  <5=> 500 kHz
+ *  <6=> 250 kHz
+ *  <7=> 125 kHz
+ *  <8=> 62.5 kHz
+ *  <9=> 31.25 kHz
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define LATENCY_PROBE_CONFIG_FREQUENCY
+
+
+/** @} */
@@ -23,6 +23,9 @@
  * LED softblink needs one timer. It can use any number of output channels that are available.
  *
  * Only one instance of LED softblink can run at a time.
+ *
+ * @note Every step of the blink wakes the CPU. On nRF52, @ref pwm_effects_breathe plays the same
+ *       blink with the PWM peripheral instead.
  */
 
 #ifndef LED_SOFTBLINK_H__
@@ -59,5 +59,16 @@ nrf_log_hexdump_handler_t nrf_log_backend_hexdump_handler_get(void);
  * @return Byte.
  */
 uint8_t nrf_log_backend_getchar(void);
+
+/**
+ * @brief Function for getting the number of entries dropped by the RTT backend.
+ *
+ * The RTT backend (@ref NRF_LOG_BACKEND_RTT_ENABLED) does not wait for the host. An entry
+ * that does not fit in the RTT up-buffer is dropped and counted. Every line of a hexdump
+ * counts as a separate entry.
+ *
+ * @return Number of dropped entries since startup.
+ */
+uint32_t nrf_log_backend_rtt_dropped_get(void);
 #endif // NRF_LOG_BACKEND_H__
 /** @} */
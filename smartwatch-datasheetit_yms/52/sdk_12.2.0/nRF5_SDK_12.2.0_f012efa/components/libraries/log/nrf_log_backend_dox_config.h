@@ -24,6 +24,19 @@
 #define NRF_LOG_TIMESTAMP_DIGITS
 
 
+/** @brief If enabled logs are sent as binary frames instead of formatted strings
+ *
+ * Each frame carries the address of the format string, the timestamp and the raw
+ * arguments. The host tool components/libraries/log/tools/nrf_log_dict_decode.py
+ * restores the text using the ELF file of the application.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_LOG_BACKEND_DICTIONARY_ENABLED
+
+
 /** @brief If enabled data is printed over UART
  *
  *  Set to 1 to activate.
@@ -120,6 +133,20 @@
  */
 #define NRF_LOG_BACKEND_SERIAL_USES_RTT
 
+/** @brief If enabled the RTT backend is used instead of the serial backend
+ *
+ * Log entries are written straight into the RTT up-buffer in skip mode. An entry
+ * that does not fit is dropped and counted, see @ref nrf_log_backend_rtt_dropped_get.
+ * The backend never blocks, so it can be used without a debugger connected.
+ * @ref NRF_LOG_BACKEND_SERIAL_USES_UART and @ref NRF_LOG_BACKEND_SERIAL_USES_RTT are
+ * ignored when this option is set.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_LOG_BACKEND_RTT_ENABLED
+
 /** @brief RTT output buffer size.
  *
  * Should be equal or bigger than \ref NRF_LOG_BACKEND_MAX_STRING_LENGTH.
@@ -0,0 +1,92 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @defgroup nrf_log_crashlog Crash log ring of nrf_log
+ * @{
+ * @ingroup  nrf_log
+ * @brief    Binary ring of the latest log entries that survives a soft reset.
+ *
+ * @details The crash log is an additional handler of the logger (see @ref nrf_log_handlers_add).
+ *          Every processed entry is stored in binary form: the address of the format string,
+ *          the timestamp and the arguments. The ring is placed in RAM that is not initialized
+ *          at startup, so after a fault and a soft reset the last entries before the fault can
+ *          be printed with @ref nrf_log_crashlog_dump.
+ *
+ *          The fault handlers (@ref app_error_fault_handler and the HardFault handler) call
+ *          @ref NRF_LOG_FINAL_FLUSH, so all pending entries reach the ring before the reset.
+ *
+ * @note The variable of the ring is placed in section ".noinit" (GCC), ".bss.noinit" (Keil) or
+ *       declared with __no_init (IAR). The linker configuration must place this section in RAM
+ *       that is not cleared by the startup code.
+ * @note Strings that are passed as arguments for "%s" must be in flash to be printed correctly
+ *       after a reset. Strings from @ref nrf_log_push are not valid any more.
+ */
+
+#ifndef NRF_LOG_CRASHLOG_H__
+#define NRF_LOG_CRASHLOG_H__
+
+#include "sdk_errors.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Function for initializing the crash log.
+ *
+ * The function checks the retained ring. If it is not valid, for example after power-on, the ring
+ * is cleared. Entries from before the reset are kept. Then the crash log is added as a handler
+ * to the logger. The logger must be initialized first.
+ *
+ * @retval NRF_SUCCESS      If the crash log was initialized.
+ * @retval NRF_ERROR_NO_MEM If the logger cannot take more handlers. See
+ *                          @ref NRF_LOG_EXTRA_HANDLERS_MAX.
+ */
+ret_code_t nrf_log_crashlog_init(void);
+
+/**
+ * @brief Function for getting the number of entries in the crash log.
+ *
+ * @return Number of entries.
+ */
+uint32_t nrf_log_crashlog_count_get(void);
+
+/**
+ * @brief Function for printing the crash log through the default backend.
+ *
+ * The entries are passed to the handlers of the backend, oldest first, and removed from
+ * the ring. The function blocks until all of them are processed.
+ */
+void nrf_log_crashlog_dump(void);
+
+/**
+ * @brief Function for copying the latest entries of the crash log, for example into a crash report.
+ *
+ * The newest complete records that fit are copied in their binary format, oldest first, and kept
+ * in the ring. Nothing is copied if the ring is not valid. The records reference the format
+ * strings by address, so they can be decoded with the map file of the application.
+ *
+ * @param[out] p_buf     Buffer for the records.
+ * @param[in]  max_words Size of the buffer, in words.
+ *
+ * @return Number of words copied.
+ */
+uint32_t nrf_log_crashlog_tail_get(uint32_t * p_buf, uint32_t max_words);
+
+/**
+ * @brief Function for removing all entries from the crash log.
+ */
+void nrf_log_crashlog_clear(void);
+
+#endif // NRF_LOG_CRASHLOG_H__
+
+/** @} */
@@ -182,6 +182,23 @@ void nrf_log_frontend_init(nrf_log_std_handler_t     std_handler,
 void nrf_log_handlers_set(nrf_log_std_handler_t     std_handler,
                           nrf_log_hexdump_handler_t hexdump_handler);
 
+/**
+ * @brief Function for adding handlers that receive a copy of every log entry.
+ *
+ * Up to @ref NRF_LOG_EXTRA_HANDLERS_MAX handler pairs can be added in addition to the
+ * handlers of the backend. An entry is passed to them once, after the main handler has
+ * processed it. A hex dump is passed as a whole with offset 0. The additional handlers must
+ * not block, and their return values are ignored.
+ *
+ * @param std_handler      Function for handling standard log entries.
+ * @param hexdump_handler  Function for handling hexdump log entries.
+ *
+ * @retval NRF_SUCCESS      If the handlers were added.
+ * @retval NRF_ERROR_NO_MEM If the maximum number of handlers has been reached.
+ */
+ret_code_t nrf_log_handlers_add(nrf_log_std_handler_t     std_handler,
+                                nrf_log_hexdump_handler_t hexdump_handler);
+
 /**
  * @brief Function for handling a single log entry.
  *
@@ -193,6 +210,78 @@ void nrf_log_handlers_set(nrf_log_std_handler_t     std_handler,
  */
 bool nrf_log_frontend_dequeue(void);
 
+/**
+ * @brief Logger statistics.
+ */
+typedef struct
+{
+    uint32_t dropped;       //!< Number of entries that were lost because the buffer was full or the backend failed.
+    uint32_t max_usage;     //!< Peak usage of the deferred buffer, in 32-bit words.
+    uint32_t buffer_size;   //!< Size of the deferred buffer, in 32-bit words. 0 if logs are not deferred.
+} nrf_log_stats_t;
+
+/**
+ * @brief Function for getting the logger statistics.
+ *
+ * @param[out] p_stats Statistics.
+ */
+void nrf_log_stats_get(nrf_log_stats_t * p_stats);
+
+/**
+ * @brief Function for clearing the dropped entry counter and the peak buffer usage.
+ */
+void nrf_log_stats_reset(void);
+
+#if NRF_LOG_FILTERS_ENABLED || defined(__SDK_DOXYGEN__)
+/**
+ * @brief Function for setting the runtime severity level of a module.
+ *
+ * Entries with a severity above the level are discarded before their arguments are evaluated.
+ * Levels above the compile-time level of the module (@ref NRF_LOG_LEVEL) have no effect,
+ * because such entries are not compiled in.
+ *
+ * A module is known to the logger after its first log call. All files that use the same
+ * @ref NRF_LOG_MODULE_NAME are updated.
+ *
+ * @param p_name Module name. NULL to set the level of all modules.
+ * @param level  Severity level. 0 turns off the module, @ref NRF_LOG_LEVEL_DEBUG enables all entries.
+ *
+ * @retval NRF_SUCCESS             If the level was set.
+ * @retval NRF_ERROR_INVALID_PARAM If the level is out of range.
+ * @retval NRF_ERROR_NOT_FOUND     If no module with the given name has logged yet.
+ */
+ret_code_t nrf_log_module_filter_set(const char * p_name, uint8_t level);
+
+/**
+ * @brief Function for getting the runtime severity level of a module.
+ *
+ * @param[in]  p_name  Module name.
+ * @param[out] p_level Severity level.
+ *
+ * @retval NRF_SUCCESS         If the level was read.
+ * @retval NRF_ERROR_NOT_FOUND If no module with the given name has logged yet.
+ */
+ret_code_t nrf_log_module_filter_get(const char * p_name, uint8_t * p_level);
+
+/**
+ * @brief Function for getting the number of modules known to the logger.
+ *
+ * @return Number of modules.
+ */
+uint32_t nrf_log_module_cnt_get(void);
+
+/**
+ * @brief Function for getting the name of a module.
+ *
+ * Together with @ref nrf_log_module_cnt_get, it can be used to list modules.
+ *
+ * @param idx Module index.
+ *
+ * @return Module name, or NULL if the index is out of range.
+ */
+const char * nrf_log_module_name_get(uint32_t idx);
+#endif // NRF_LOG_FILTERS_ENABLED || defined(__SDK_DOXYGEN__)
+
 
 #endif // NRF_LOG_CTRL_H
 
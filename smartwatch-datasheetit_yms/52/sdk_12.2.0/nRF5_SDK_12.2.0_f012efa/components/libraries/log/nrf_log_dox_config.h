@@ -89,6 +89,51 @@
 #define NRF_LOG_DEFAULT_LEVEL
 
 
+/** @brief Enable runtime filtering of modules
+ *
+ * Every module gets a runtime severity level, initialized to its compile-time level.
+ * The level is checked before the arguments of a log call are evaluated. See
+ * @ref nrf_log_module_filter_set.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_LOG_FILTERS_ENABLED
+
+
+/** @brief Maximum number of additional handlers
+ *
+ * Handlers added with @ref nrf_log_handlers_add receive a copy of every entry
+ * that is processed by the backend. Set to 1 or more to use the crash log.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_LOG_EXTRA_HANDLERS_MAX
+
+
+/** @brief Enable the crash log
+ *
+ * Keeps the latest entries in a binary ring in RAM that survives a soft reset.
+ * See @ref nrf_log_crashlog.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_LOG_CRASHLOG_ENABLED
+
+
+/** @brief Size of the crash log ring in 32-bit words
+ *
+ * Must be a power of 2 and at least 16. Every entry takes 2 words, plus 1 for
+ * the timestamp, plus its arguments.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_LOG_CRASHLOG_SIZE
+
+
 /** @brief Enable deffered logger.
  *
  * Log data is buffered and can be processed in idle.
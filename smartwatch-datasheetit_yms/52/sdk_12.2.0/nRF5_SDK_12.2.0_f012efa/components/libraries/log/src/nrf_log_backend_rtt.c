@@ -0,0 +1,251 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(NRF_LOG) && NRF_MODULE_ENABLED(NRF_LOG_BACKEND_RTT)
+#include "nrf_log_backend.h"
+#include "nrf_error.h"
+#include <string.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <SEGGER_RTT_Conf.h>
+#include <SEGGER_RTT.h>
+
+/* The backend writes complete log entries straight into the RTT up-buffer. The buffer is
+ * configured in skip mode: an entry that does not fit is dropped as a whole and counted, and
+ * the handler returns at once. The backend never waits for the host, so it does not depend on
+ * a debugger being connected and does not disturb the timing of the application.
+ */
+
+#define RTT_UP_BUFFER_INDEX         0
+#define RTT_MAX_ARGS                6   // Number of arguments of nrf_log_frontend_std_6().
+
+#define HEXDUMP_BYTES_PER_LINE      16
+#define HEXDUMP_HEXBYTE_AREA        3   // Two bytes for hexbyte and space to separate
+#define HEXDUMP_LINE_LEN            (HEXDUMP_BYTES_PER_LINE * HEXDUMP_HEXBYTE_AREA + 1 + \
+                                     HEXDUMP_BYTES_PER_LINE + 2)
+#define TIMESTAMP_STR(val)          "[%0" NUM_TO_STR(val) "d]"
+#define TIMESTAMP_LEN               (NRF_LOG_TIMESTAMP_DIGITS + 2) // +2 for the brackets.
+
+STATIC_ASSERT(NRF_LOG_BACKEND_MAX_STRING_LENGTH >= (TIMESTAMP_LEN + HEXDUMP_LINE_LEN + 4));
+
+static bool              m_initialized = false;
+static volatile uint32_t m_dropped     = 0;
+static const char        m_default_color[] = "\x1B[0m";
+
+
+ret_code_t nrf_log_backend_init(bool blocking)
+{
+    // The backend never blocks, so the mode is ignored.
+    UNUSED_PARAMETER(blocking);
+
+    if (m_initialized)
+    {
+        return NRF_SUCCESS;
+    }
+
+    SEGGER_RTT_Init();
+    // Only the flags are changed for buffer 0. Its memory is set up by SEGGER_RTT_Init().
+    (void)SEGGER_RTT_ConfigUpBuffer(RTT_UP_BUFFER_INDEX, NULL, NULL, 0,
+                                    SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+
+    m_initialized = true;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_log_backend_rtt_dropped_get(void)
+{
+    return m_dropped;
+}
+
+
+/**@brief Function for writing one complete entry to the up-buffer.
+ *
+ * @details The entry is either written as a whole or dropped and counted.
+ */
+static void rtt_entry_write(char * p_str, uint32_t len)
+{
+    if (NRF_LOG_USES_COLORS)
+    {
+        memcpy(&p_str[len], m_default_color, sizeof(m_default_color) - 1);
+        len += sizeof(m_default_color) - 1;
+    }
+
+    if (SEGGER_RTT_Write(RTT_UP_BUFFER_INDEX, p_str, len) == 0)
+    {
+        m_dropped++;
+    }
+}
+
+
+static uint32_t timestamp_process(const uint32_t * const p_timestamp, char * p_str)
+{
+    uint32_t len = 0;
+
+    if (p_timestamp)
+    {
+#if NRF_LOG_USES_COLORS
+        len = sizeof(m_default_color) - 1;
+        memcpy(p_str, m_default_color, len);
+#endif //NRF_LOG_USES_COLORS
+        // A timestamp with more digits than configured is truncated.
+        (void)snprintf(&p_str[len], TIMESTAMP_LEN + 1,
+                       TIMESTAMP_STR(NRF_LOG_TIMESTAMP_DIGITS), (int)*p_timestamp);
+        len += TIMESTAMP_LEN;
+    }
+    return len;
+}
+
+
+static bool nrf_log_backend_rtt_std_handler(
+    uint8_t                severity_level,
+    const uint32_t * const p_timestamp,
+    const char * const     p_str,
+    uint32_t             * p_args,
+    uint32_t               nargs)
+{
+    // Space for the trailing color code is kept free.
+    char     str[NRF_LOG_BACKEND_MAX_STRING_LENGTH];
+    uint32_t max_len = NRF_LOG_USES_COLORS ? sizeof(str) - (sizeof(m_default_color) - 1) :
+                                             sizeof(str);
+    uint32_t args[RTT_MAX_ARGS] = {0};
+    uint32_t len;
+    int32_t  str_len;
+
+    len = timestamp_process(p_timestamp, str);
+
+    if (nargs == 0)
+    {
+        // Printed as is, so that a '%' in a string without arguments is not interpreted.
+        str_len = MIN(strlen(p_str), max_len - len);
+        memcpy(&str[len], p_str, str_len);
+    }
+    else
+    {
+        // Unused arguments are passed as zeros and ignored by the format string.
+        memcpy(args, p_args, MIN(nargs, RTT_MAX_ARGS) * sizeof(uint32_t));
+        str_len = snprintf(&str[len], max_len - len, p_str,
+                           args[0], args[1], args[2], args[3], args[4], args[5]);
+        if (str_len < 0)
+        {
+            m_dropped++;
+            return true;
+        }
+        // The output is truncated if it does not fit the buffer.
+        str_len = MIN((uint32_t)str_len, max_len - len - 1);
+    }
+
+    rtt_entry_write(str, len + str_len);
+
+    // The entry is always consumed. A dropped entry is only counted.
+    return true;
+}
+
+
+static void byte2hex(const uint8_t c, char * p_out)
+{
+    uint8_t  nibble;
+    uint32_t i = 2;
+
+    while (i-- != 0)
+    {
+        nibble       = (c >> (4 * i)) & 0x0F;
+        p_out[1 - i] = (nibble > 9) ? ('A' + nibble - 10) : ('0' + nibble);
+    }
+}
+
+
+static uint32_t nrf_log_backend_rtt_hexdump_handler(
+    uint8_t                severity_level,
+    const uint32_t * const p_timestamp,
+    const char * const     p_str,
+    uint32_t               offset,
+    const uint8_t * const  p_buf0,
+    uint32_t               buf0_length,
+    const uint8_t * const  p_buf1,
+    uint32_t               buf1_length)
+{
+    char     str[NRF_LOG_BACKEND_MAX_STRING_LENGTH];
+    uint32_t length        = buf0_length + buf1_length;
+    uint32_t byte_cnt      = offset;
+    uint32_t timestamp_len = p_timestamp ? TIMESTAMP_LEN : 0;
+
+    // If it is the first part of hexdump print the header
+    if (offset == 0)
+    {
+        uint32_t max_len = sizeof(str) - (sizeof(m_default_color) - 1);
+        uint32_t len;
+        uint32_t slen;
+
+        len  = timestamp_process(p_timestamp, str);
+        // Saturate string if it's too long.
+        slen = MIN(strlen(p_str), max_len - len);
+        memcpy(&str[len], p_str, slen);
+        rtt_entry_write(str, len + slen);
+    }
+
+    while (byte_cnt < length)
+    {
+        char * p_hex_part  = &str[timestamp_len];
+        char * p_char_part = &str[timestamp_len + HEXDUMP_BYTES_PER_LINE * HEXDUMP_HEXBYTE_AREA + 1];
+
+        // Fill the blanks to align to timestamp print
+        memset(str, ' ', timestamp_len);
+
+        for (uint32_t byte_in_line = 0; byte_in_line < HEXDUMP_BYTES_PER_LINE; byte_in_line++)
+        {
+            if (byte_cnt >= length)
+            {
+                memset(p_hex_part, ' ', HEXDUMP_HEXBYTE_AREA);
+                p_hex_part    += HEXDUMP_HEXBYTE_AREA;
+                *p_char_part++ = ' ';
+            }
+            else
+            {
+                uint8_t c = (byte_cnt < buf0_length) ? p_buf0[byte_cnt] :
+                                                       p_buf1[byte_cnt - buf0_length];
+                byte2hex(c, p_hex_part);
+                p_hex_part    += 2;
+                *p_hex_part++  = ' ';
+                *p_char_part++ = isprint(c) ? c : '.';
+                byte_cnt++;
+            }
+        }
+        *p_hex_part    = ' ';
+        *p_char_part++ = '\r';
+        *p_char_part++ = '\n';
+
+        rtt_entry_write(str, timestamp_len + HEXDUMP_LINE_LEN);
+    }
+
+    return byte_cnt;
+}
+
+
+nrf_log_std_handler_t nrf_log_backend_std_handler_get(void)
+{
+    return nrf_log_backend_rtt_std_handler;
+}
+
+
+nrf_log_hexdump_handler_t nrf_log_backend_hexdump_handler_get(void)
+{
+    return nrf_log_backend_rtt_hexdump_handler;
+}
+
+
+uint8_t nrf_log_backend_getchar(void)
+{
+    return (uint8_t)SEGGER_RTT_WaitKey();
+}
+
+#endif // NRF_MODULE_ENABLED(NRF_LOG) && NRF_MODULE_ENABLED(NRF_LOG_BACKEND_RTT)
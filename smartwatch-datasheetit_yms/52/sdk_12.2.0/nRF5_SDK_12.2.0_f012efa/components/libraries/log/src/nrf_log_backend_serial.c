@@ -10,7 +10,7 @@
  *
  */
 #include "sdk_common.h"
-#if NRF_MODULE_ENABLED(NRF_LOG)
+#if NRF_MODULE_ENABLED(NRF_LOG) && !NRF_MODULE_ENABLED(NRF_LOG_BACKEND_RTT)
 #include "nrf_log_backend.h"
 #include "nrf_error.h"
 #include <stdarg.h>
@@ -49,6 +49,37 @@ static nrf_drv_uart_t m_uart = NRF_DRV_UART_INSTANCE(NRF_LOG_BACKEND_UART_INSTAN
                              4 +/* Color ANSI Escape Code */              \
                              2)) /* Separators */
 
+#ifndef NRF_LOG_BACKEND_DICTIONARY_ENABLED
+#define NRF_LOG_BACKEND_DICTIONARY_ENABLED 0
+#endif
+
+#if NRF_LOG_BACKEND_DICTIONARY_ENABLED
+/* Dictionary frame layout. All fields are little-endian.
+ *
+ * | sync | type | flags | count | string address | [timestamp] | [hexdump offset] | payload |
+ * |  1   |  1   |   1   |   1   |       4        |     [4]     |       [2]        |         |
+ *
+ * The format string is not sent. The host tool looks up the string address in the ELF file of
+ * the application. A standard entry carries count 32-bit arguments. A hexdump entry carries
+ * count data bytes, starting at the hexdump offset.
+ */
+#define DICT_FRAME_SYNC             0xA5    // First byte of every frame.
+#define DICT_FLAG_TIMESTAMP         0x01    // Frame contains a timestamp.
+#define DICT_FLAG_HEXDUMP           0x02    // Frame contains hexdump data.
+#define DICT_HEADER_LEN             8       // Sync, type, flags, count and string address.
+#define DICT_TIMESTAMP_LEN          4
+#define DICT_HEXDUMP_OFFSET_LEN     2
+#define DICT_MAX_ARGS               6       // Number of arguments of nrf_log_frontend_std_6().
+#define DICT_STD_FRAME_MAX_LEN      (DICT_HEADER_LEN + DICT_TIMESTAMP_LEN + \
+                                     DICT_MAX_ARGS * sizeof(uint32_t))
+#define DICT_HEXDUMP_HEADER_LEN     (DICT_HEADER_LEN + DICT_TIMESTAMP_LEN + DICT_HEXDUMP_OFFSET_LEN)
+#define DICT_HEXDUMP_CHUNK_MAX      MIN(UINT8_MAX, (NRF_LOG_BACKEND_MAX_STRING_LENGTH - \
+                                                    DICT_HEXDUMP_HEADER_LEN))
+
+STATIC_ASSERT(NRF_LOG_BACKEND_MAX_STRING_LENGTH >= DICT_STD_FRAME_MAX_LEN);
+STATIC_ASSERT(NRF_LOG_BACKEND_MAX_STRING_LENGTH > DICT_HEXDUMP_HEADER_LEN);
+#endif // NRF_LOG_BACKEND_DICTIONARY_ENABLED
+
 static bool m_initialized   = false;
 static bool m_blocking_mode = false;
 static const char m_default_color[] = "\x1B[0m";
@@ -181,6 +212,7 @@ static uint8_t serial_get_byte(void)
 }
 
 
+#if (NRF_LOG_BACKEND_DICTIONARY_ENABLED == 0)
 static bool buf_len_update(uint32_t * p_buf_len, int32_t new_len)
 {
     bool ret;
@@ -446,17 +478,119 @@ static uint32_t nrf_log_backend_serial_hexdump_handler(
     while (byte_cnt < length);
     return byte_cnt;
 }
+#endif // (NRF_LOG_BACKEND_DICTIONARY_ENABLED == 0)
+
+
+#if NRF_LOG_BACKEND_DICTIONARY_ENABLED
+static uint32_t dict_header_encode(uint8_t                type,
+                                   uint8_t                flags,
+                                   uint8_t                count,
+                                   const uint32_t * const p_timestamp,
+                                   const char * const     p_str,
+                                   uint8_t              * p_frame)
+{
+    uint32_t len = 0;
+
+    p_frame[len++] = DICT_FRAME_SYNC;
+    p_frame[len++] = type;
+    p_frame[len++] = flags | (p_timestamp ? DICT_FLAG_TIMESTAMP : 0);
+    p_frame[len++] = count;
+    len += uint32_encode((uint32_t)p_str, &p_frame[len]);
+
+    if (p_timestamp)
+    {
+        len += uint32_encode(*p_timestamp, &p_frame[len]);
+    }
+
+    return len;
+}
+
+
+static bool nrf_log_backend_dict_std_handler(
+    uint8_t                severity_level,
+    const uint32_t * const p_timestamp,
+    const char * const     p_str,
+    uint32_t             * p_args,
+    uint32_t               nargs)
+{
+    uint8_t  frame[DICT_STD_FRAME_MAX_LEN];
+    uint32_t len;
+
+    if (serial_is_busy())
+    {
+        return false;
+    }
+
+    len = dict_header_encode(severity_level, 0, nargs, p_timestamp, p_str, frame);
+    for (uint32_t i = 0; i < nargs; i++)
+    {
+        len += uint32_encode(p_args[i], &frame[len]);
+    }
+
+    return serial_tx(frame, len);
+}
+
+
+static uint32_t nrf_log_backend_dict_hexdump_handler(
+    uint8_t                severity_level,
+    const uint32_t * const p_timestamp,
+    const char * const     p_str,
+    uint32_t               offset,
+    const uint8_t * const  p_buf0,
+    uint32_t               buf0_length,
+    const uint8_t * const  p_buf1,
+    uint32_t               buf1_length)
+{
+    uint8_t  frame[DICT_HEXDUMP_HEADER_LEN + DICT_HEXDUMP_CHUNK_MAX];
+    uint32_t length = buf0_length + buf1_length;
+
+    while (offset < length)
+    {
+        uint32_t chunk = MIN(length - offset, DICT_HEXDUMP_CHUNK_MAX);
+        uint32_t len;
+
+        if (serial_is_busy())
+        {
+            return offset;
+        }
+
+        len  = dict_header_encode(severity_level, DICT_FLAG_HEXDUMP, chunk, p_timestamp, p_str,
+                                  frame);
+        len += uint16_encode(offset, &frame[len]);
+
+        for (uint32_t i = 0; i < chunk; i++, offset++)
+        {
+            frame[len++] = (offset < buf0_length) ? p_buf0[offset] : p_buf1[offset - buf0_length];
+        }
+
+        if (!serial_tx(frame, len))
+        {
+            return offset - chunk;
+        }
+    }
+
+    return offset;
+}
+#endif // NRF_LOG_BACKEND_DICTIONARY_ENABLED
 
 
 nrf_log_std_handler_t nrf_log_backend_std_handler_get(void)
 {
+#if NRF_LOG_BACKEND_DICTIONARY_ENABLED
+    return nrf_log_backend_dict_std_handler;
+#else
     return nrf_log_backend_serial_std_handler;
+#endif
 }
 
 
 nrf_log_hexdump_handler_t nrf_log_backend_hexdump_handler_get(void)
 {
+#if NRF_LOG_BACKEND_DICTIONARY_ENABLED
+    return nrf_log_backend_dict_hexdump_handler;
+#else
     return nrf_log_backend_serial_hexdump_handler;
+#endif
 }
 
 
@@ -465,4 +599,4 @@ uint8_t nrf_log_backend_getchar(void)
     return serial_get_byte();
 }
 
-#endif // NRF_MODULE_ENABLED(NRF_LOG)
+#endif // NRF_MODULE_ENABLED(NRF_LOG) && !NRF_MODULE_ENABLED(NRF_LOG_BACKEND_RTT)
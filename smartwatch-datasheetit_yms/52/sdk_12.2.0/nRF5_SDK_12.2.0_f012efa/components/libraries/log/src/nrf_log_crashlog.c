@@ -0,0 +1,322 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(NRF_LOG) && NRF_MODULE_ENABLED(NRF_LOG_CRASHLOG)
+#include "nrf_log_crashlog.h"
+#include "nrf_log_ctrl.h"
+#include "nrf_log_backend.h"
+#include "app_util_platform.h"
+#include <string.h>
+
+#ifndef NRF_LOG_CRASHLOG_SIZE
+#define NRF_LOG_CRASHLOG_SIZE 256
+#endif
+
+#if (NRF_LOG_EXTRA_HANDLERS_MAX == 0)
+#error "NRF_LOG_EXTRA_HANDLERS_MAX must be at least 1 to use the crash log."
+#endif
+
+STATIC_ASSERT(IS_POWER_OF_TWO(NRF_LOG_CRASHLOG_SIZE));
+STATIC_ASSERT(NRF_LOG_CRASHLOG_SIZE >= 16);
+
+/**
+ * Every record starts with a header word, followed by the address of the string, an optional
+ * timestamp and the payload. The payload of a standard entry is its arguments. The payload of
+ * a hex dump is its first CRASHLOG_HEXDUMP_MAX bytes.
+ *
+ *    --------------------------------------------
+ *    |MARKER|  unused  |TS|HEX|SEVERITY| COUNT  |
+ *    | 31:24|  23:13   |12|11 |  10:8  |  7:0   |
+ *    --------------------------------------------
+ */
+#define CRASHLOG_MAGIC          0x474F4C43                  // "CLOG", ring is valid.
+#define CRASHLOG_MASK           (NRF_LOG_CRASHLOG_SIZE - 1)
+#define CRASHLOG_MAX_ARGS       6
+#define CRASHLOG_HEXDUMP_MAX    32
+
+#define HDR_MARKER              0xA5UL
+#define HDR_MARKER_POS          24
+#define HDR_TIMESTAMP           (1UL << 12)
+#define HDR_HEXDUMP             (1UL << 11)
+#define HDR_SEVERITY_POS        8
+#define HDR_SEVERITY_MASK       0x07UL
+#define HDR_COUNT_MASK          0xFFUL
+
+#define RECORD_MAX_LEN          (3 + MAX(CRASHLOG_MAX_ARGS, CEIL_DIV(CRASHLOG_HEXDUMP_MAX, 4)))
+
+#if defined(__CC_ARM)
+#define CRASHLOG_NOINIT         __attribute__((section(".bss.noinit"), zero_init))
+#elif defined(__ICCARM__)
+#define CRASHLOG_NOINIT         __no_init
+#else
+#define CRASHLOG_NOINIT         __attribute__((section(".noinit")))
+#endif
+
+typedef struct
+{
+    uint32_t magic;                             // CRASHLOG_MAGIC if the ring has been initialized.
+    uint32_t wr_idx;                            // Write index (never reset).
+    uint32_t rd_idx;                            // Index of the oldest record (never reset).
+    uint32_t buffer[NRF_LOG_CRASHLOG_SIZE];
+} crashlog_t;
+
+static CRASHLOG_NOINIT crashlog_t m_crashlog;
+
+
+/**@brief Function for getting the length of a record in words, or 0 if the header is not valid.
+ */
+static uint32_t record_len(uint32_t header)
+{
+    uint32_t count = header & HDR_COUNT_MASK;
+    uint32_t len   = 2;
+
+    if ((header >> HDR_MARKER_POS) != HDR_MARKER)
+    {
+        return 0;
+    }
+    if (header & HDR_TIMESTAMP)
+    {
+        len++;
+    }
+    if (header & HDR_HEXDUMP)
+    {
+        return (count <= CRASHLOG_HEXDUMP_MAX) ? len + CEIL_DIV(count, 4) : 0;
+    }
+    return (count <= CRASHLOG_MAX_ARGS) ? len + count : 0;
+}
+
+
+/**@brief Function for checking that the ring consists of complete records only.
+ */
+static bool crashlog_is_valid(void)
+{
+    uint32_t idx;
+
+    if ((m_crashlog.magic != CRASHLOG_MAGIC) ||
+        ((m_crashlog.wr_idx - m_crashlog.rd_idx) > NRF_LOG_CRASHLOG_SIZE))
+    {
+        return false;
+    }
+
+    for (idx = m_crashlog.rd_idx; idx != m_crashlog.wr_idx; )
+    {
+        uint32_t len = record_len(m_crashlog.buffer[idx & CRASHLOG_MASK]);
+
+        if ((len == 0) || (len > (m_crashlog.wr_idx - idx)))
+        {
+            return false;
+        }
+        idx += len;
+    }
+    return true;
+}
+
+
+/**@brief Function for writing a record. The oldest records are removed to make room.
+ */
+static void record_write(uint32_t const * p_record, uint32_t len)
+{
+    CRITICAL_REGION_ENTER();
+    while ((NRF_LOG_CRASHLOG_SIZE - (m_crashlog.wr_idx - m_crashlog.rd_idx)) < len)
+    {
+        m_crashlog.rd_idx += record_len(m_crashlog.buffer[m_crashlog.rd_idx & CRASHLOG_MASK]);
+    }
+    for (uint32_t i = 0; i < len; i++)
+    {
+        m_crashlog.buffer[m_crashlog.wr_idx++ & CRASHLOG_MASK] = p_record[i];
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+
+static uint32_t record_header_encode(uint32_t               flags,
+                                     uint8_t                severity,
+                                     uint32_t               count,
+                                     const uint32_t * const p_timestamp,
+                                     const char * const     p_str,
+                                     uint32_t             * p_record)
+{
+    uint32_t len = 0;
+
+    p_record[len++] = (HDR_MARKER << HDR_MARKER_POS)                              |
+                      (p_timestamp ? HDR_TIMESTAMP : 0)                           |
+                      flags                                                       |
+                      ((severity & HDR_SEVERITY_MASK) << HDR_SEVERITY_POS)        |
+                      count;
+    p_record[len++] = (uint32_t)p_str;
+    if (p_timestamp)
+    {
+        p_record[len++] = *p_timestamp;
+    }
+    return len;
+}
+
+
+static bool crashlog_std_handler(uint8_t                severity_level,
+                                 const uint32_t * const p_timestamp,
+                                 const char * const     p_str,
+                                 uint32_t             * p_args,
+                                 uint32_t               nargs)
+{
+    uint32_t record[RECORD_MAX_LEN];
+    uint32_t len;
+
+    nargs = MIN(nargs, CRASHLOG_MAX_ARGS);
+    len   = record_header_encode(0, severity_level, nargs, p_timestamp, p_str, record);
+    memcpy(&record[len], p_args, nargs * sizeof(uint32_t));
+
+    record_write(record, len + nargs);
+    return true;
+}
+
+
+static uint32_t crashlog_hexdump_handler(uint8_t                severity_level,
+                                         const uint32_t * const p_timestamp,
+                                         const char * const     p_str,
+                                         uint32_t               offset,
+                                         const uint8_t * const  p_buf0,
+                                         uint32_t               buf0_length,
+                                         const uint8_t * const  p_buf1,
+                                         uint32_t               buf1_length)
+{
+    uint32_t record[RECORD_MAX_LEN];
+    uint32_t count = MIN(buf0_length + buf1_length, CRASHLOG_HEXDUMP_MAX);
+    uint32_t len0  = MIN(buf0_length, count);
+    uint32_t len;
+
+    len = record_header_encode(HDR_HEXDUMP, severity_level, count, p_timestamp, p_str, record);
+    memcpy(&record[len], p_buf0, len0);
+    if (count > len0)
+    {
+        memcpy((uint8_t *)&record[len] + len0, p_buf1, count - len0);
+    }
+
+    record_write(record, len + CEIL_DIV(count, 4));
+    return buf0_length + buf1_length;
+}
+
+
+ret_code_t nrf_log_crashlog_init(void)
+{
+    if (!crashlog_is_valid())
+    {
+        nrf_log_crashlog_clear();
+    }
+
+    return nrf_log_handlers_add(crashlog_std_handler, crashlog_hexdump_handler);
+}
+
+
+uint32_t nrf_log_crashlog_count_get(void)
+{
+    uint32_t cnt = 0;
+
+    CRITICAL_REGION_ENTER();
+    for (uint32_t idx = m_crashlog.rd_idx; idx != m_crashlog.wr_idx; cnt++)
+    {
+        idx += record_len(m_crashlog.buffer[idx & CRASHLOG_MASK]);
+    }
+    CRITICAL_REGION_EXIT();
+
+    return cnt;
+}
+
+
+void nrf_log_crashlog_dump(void)
+{
+    nrf_log_std_handler_t     std_handler     = nrf_log_backend_std_handler_get();
+    nrf_log_hexdump_handler_t hexdump_handler = nrf_log_backend_hexdump_handler_get();
+    uint32_t                  record[RECORD_MAX_LEN];
+
+    for (;;)
+    {
+        uint32_t len = 0;
+
+        // Take the oldest record. New entries may be added while the dump is in progress.
+        CRITICAL_REGION_ENTER();
+        if (m_crashlog.rd_idx != m_crashlog.wr_idx)
+        {
+            len = record_len(m_crashlog.buffer[m_crashlog.rd_idx & CRASHLOG_MASK]);
+            for (uint32_t i = 0; i < len; i++)
+            {
+                record[i] = m_crashlog.buffer[m_crashlog.rd_idx++ & CRASHLOG_MASK];
+            }
+        }
+        CRITICAL_REGION_EXIT();
+
+        if (len == 0)
+        {
+            break;
+        }
+
+        uint32_t         header      = record[0];
+        const char     * p_str       = (const char *)record[1];
+        const uint32_t * p_timestamp = (header & HDR_TIMESTAMP) ? &record[2] : NULL;
+        uint32_t       * p_payload   = &record[(header & HDR_TIMESTAMP) ? 3 : 2];
+        uint32_t         count       = header & HDR_COUNT_MASK;
+        uint8_t          severity    = (header >> HDR_SEVERITY_POS) & HDR_SEVERITY_MASK;
+
+        if (header & HDR_HEXDUMP)
+        {
+            uint32_t offset = 0;
+            do
+            {
+                offset = hexdump_handler(severity, p_timestamp, p_str, offset,
+                                         (uint8_t *)p_payload, count, NULL, 0);
+            } while (offset < count);
+        }
+        else
+        {
+            while (!std_handler(severity, p_timestamp, p_str, p_payload, count))
+            {
+                // Wait until the backend is ready.
+            }
+        }
+    }
+}
+
+
+uint32_t nrf_log_crashlog_tail_get(uint32_t * p_buf, uint32_t max_words)
+{
+    uint32_t len = 0;
+
+    CRITICAL_REGION_ENTER();
+    // Called after a fault, so the ring may have been left in the middle of a write.
+    if (crashlog_is_valid())
+    {
+        uint32_t start = m_crashlog.rd_idx;
+
+        while ((m_crashlog.wr_idx - start) > max_words)
+        {
+            start += record_len(m_crashlog.buffer[start & CRASHLOG_MASK]);
+        }
+        for (uint32_t idx = start; idx != m_crashlog.wr_idx; idx++)
+        {
+            p_buf[len++] = m_crashlog.buffer[idx & CRASHLOG_MASK];
+        }
+    }
+    CRITICAL_REGION_EXIT();
+
+    return len;
+}
+
+
+void nrf_log_crashlog_clear(void)
+{
+    CRITICAL_REGION_ENTER();
+    m_crashlog.magic  = CRASHLOG_MAGIC;
+    m_crashlog.wr_idx = 0;
+    m_crashlog.rd_idx = 0;
+    CRITICAL_REGION_EXIT();
+}
+
+#endif // NRF_MODULE_ENABLED(NRF_LOG) && NRF_MODULE_ENABLED(NRF_LOG_CRASHLOG)
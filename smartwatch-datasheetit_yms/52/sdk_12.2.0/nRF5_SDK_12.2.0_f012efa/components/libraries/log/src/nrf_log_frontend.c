@@ -19,6 +19,10 @@
 #include "nrf_log_ctrl.h"
 #include <string.h>
 
+#ifndef NRF_LOG_EXTRA_HANDLERS_MAX
+#define NRF_LOG_EXTRA_HANDLERS_MAX 0
+#endif
+
 #if NRF_LOG_DEFERRED
 STATIC_ASSERT((NRF_LOG_DEFERRED_BUFSIZE == 0) || IS_POWER_OF_TWO(NRF_LOG_DEFERRED_BUFSIZE));
 #else
@@ -42,9 +46,19 @@ typedef struct
     nrf_log_timestamp_func_t  timestamp_func;  // A pointer to function that returns timestamp
     nrf_log_std_handler_t     std_handler;     // A handler used for processing standard log calls
     nrf_log_hexdump_handler_t hexdump_handler; // A handler for processing hex dumps
+#if NRF_LOG_EXTRA_HANDLERS_MAX
+    nrf_log_std_handler_t     extra_std_handlers[NRF_LOG_EXTRA_HANDLERS_MAX];     // Additional handlers fed with every processed entry
+    nrf_log_hexdump_handler_t extra_hexdump_handlers[NRF_LOG_EXTRA_HANDLERS_MAX]; // Additional handlers fed with every processed hex dump
+    uint32_t                  extra_cnt;       // Number of additional handlers
+#endif
 } log_data_t;
 
 static log_data_t   m_log_data;
+static volatile uint32_t m_dropped_cnt;  // Number of entries lost since startup or last reset.
+static uint32_t          m_max_usage;    // Peak usage of the buffer in words.
+#if NRF_LOG_FILTERS_ENABLED
+static nrf_log_module_t * mp_modules_head; // List of modules that have logged.
+#endif //NRF_LOG_FILTERS_ENABLED
 #if (NRF_LOG_DEFERRED == 1)
 static const char * m_overflow_info = NRF_LOG_ERROR_COLOR_CODE "Overflow\r\n";
 #endif //(NRF_LOG_DEFERRED == 1)
@@ -279,6 +293,70 @@ void nrf_log_handlers_set(nrf_log_std_handler_t     std_handler,
     m_log_data.hexdump_handler = hexdump_handler;
 }
 
+ret_code_t nrf_log_handlers_add(nrf_log_std_handler_t     std_handler,
+                                nrf_log_hexdump_handler_t hexdump_handler)
+{
+#if NRF_LOG_EXTRA_HANDLERS_MAX
+    ret_code_t ret_code = NRF_ERROR_NO_MEM;
+
+    CRITICAL_REGION_ENTER();
+    if (m_log_data.extra_cnt < NRF_LOG_EXTRA_HANDLERS_MAX)
+    {
+        m_log_data.extra_std_handlers[m_log_data.extra_cnt]     = std_handler;
+        m_log_data.extra_hexdump_handlers[m_log_data.extra_cnt] = hexdump_handler;
+        m_log_data.extra_cnt++;
+        ret_code = NRF_SUCCESS;
+    }
+    CRITICAL_REGION_EXIT();
+    return ret_code;
+#else
+    UNUSED_PARAMETER(std_handler);
+    UNUSED_PARAMETER(hexdump_handler);
+    return NRF_ERROR_NO_MEM;
+#endif // NRF_LOG_EXTRA_HANDLERS_MAX
+}
+
+
+/**
+ * @brief Function for passing a standard entry to the additional handlers.
+ *
+ * It is called once for every entry that the main handler has processed.
+ */
+static inline void extra_std_feed(uint8_t                severity,
+                                  const uint32_t * const p_timestamp,
+                                  const char * const     p_str,
+                                  uint32_t             * p_args,
+                                  uint32_t               nargs)
+{
+#if NRF_LOG_EXTRA_HANDLERS_MAX
+    for (uint32_t i = 0; i < m_log_data.extra_cnt; i++)
+    {
+        (void)m_log_data.extra_std_handlers[i](severity, p_timestamp, p_str, p_args, nargs);
+    }
+#endif // NRF_LOG_EXTRA_HANDLERS_MAX
+}
+
+
+/**
+ * @brief Function for passing a complete hex dump to the additional handlers.
+ */
+static inline void extra_hexdump_feed(uint8_t                severity,
+                                      const uint32_t * const p_timestamp,
+                                      const char * const     p_str,
+                                      const uint8_t * const  p_buf0,
+                                      uint32_t               buf0_length,
+                                      const uint8_t * const  p_buf1,
+                                      uint32_t               buf1_length)
+{
+#if NRF_LOG_EXTRA_HANDLERS_MAX
+    for (uint32_t i = 0; i < m_log_data.extra_cnt; i++)
+    {
+        (void)m_log_data.extra_hexdump_handlers[i](severity, p_timestamp, p_str, 0,
+                                                   p_buf0, buf0_length, p_buf1, buf1_length);
+    }
+#endif // NRF_LOG_EXTRA_HANDLERS_MAX
+}
+
 #if (NRF_LOG_DEFERRED == 1)
 /**
  * @brief Allocates chunk in a buffer for one entry and injects overflow if
@@ -314,11 +392,14 @@ static inline bool buf_prealloc(uint32_t nargs, uint32_t * p_wr_idx)
 #endif //NRF_LOG_USES_TIMESTAMP
         }
         // overflow case
+        m_dropped_cnt++;
         ret = false;
     }
     else
     {
         m_log_data.wr_idx += nargs;
+        uint32_t usage = m_log_data.wr_idx - m_log_data.rd_idx;
+        m_max_usage    = MAX(m_max_usage, usage);
     }
     CRITICAL_REGION_EXIT();
     return ret;
@@ -371,6 +452,14 @@ static inline uint32_t * cont_buf_prealloc(uint32_t len32,
     {
         p_buf = NULL;
     }
+    if (p_buf == NULL)
+    {
+        m_dropped_cnt++;
+    }
+    else
+    {
+        m_max_usage = MAX(m_max_usage, (m_log_data.mask + 1) - available_words);
+    }
     CRITICAL_REGION_EXIT();
 
     return p_buf;
@@ -393,8 +482,11 @@ static inline void nrf_log_direct_feed(uint8_t            type,
     UNUSED_VARIABLE(timestamp);
 #endif //NRF_LOG_USES_TIMESTAMP
 
-    UNUSED_VARIABLE
-      (m_log_data.std_handler(type, p_timestamp, (char *)p_str, p_args, nargs));
+    if (!m_log_data.std_handler(type, p_timestamp, (char *)p_str, p_args, nargs))
+    {
+        m_dropped_cnt++;
+    }
+    extra_std_feed(type, p_timestamp, p_str, p_args, nargs);
 
 }
 #endif //(NRF_LOG_DEFERRED == 0)
@@ -650,6 +742,9 @@ void nrf_log_frontend_hexdump(uint8_t            severity,
                                                  0);
     }
     while (curr_offset < length);
+
+    extra_hexdump_feed(severity, NRF_LOG_USES_TIMESTAMP ? &timestamp : NULL, p_str,
+                       p_data, length, NULL, 0);
 #else //(NRF_LOG_DEFERRED == 0)
     uint32_t mask   = m_log_data.mask;
 
@@ -722,36 +817,28 @@ bool nrf_log_frontend_dequeue(void)
         uint32_t length = header.hexdump.len;
         uint32_t offset = header.hexdump.offset;
         uint32_t space0 = sizeof(uint32_t) * (mask + 1 - (rd_idx & mask));
+        uint8_t * ptr0   = (uint8_t *)&m_log_data.buffer[rd_idx & mask];
+        uint32_t  len0   = length;
+        uint8_t * ptr1   = NULL;
+        uint32_t  len1   = 0;
         if (length > space0)
         {
-            uint8_t * ptr0 = space0 ?
-                             (uint8_t *)&m_log_data.buffer[rd_idx & mask] :
-                             (uint8_t *)&m_log_data.buffer[0];
-            uint8_t   len0 = space0 ? space0 : length;
-            uint8_t * ptr1 = space0 ?
-                             (uint8_t *)&m_log_data.buffer[0] : NULL;
-            uint8_t len1 = space0 ? length - space0 : 0;
-
-            offset = m_log_data.hexdump_handler(header.hexdump.severity,
-                                                p_timestamp, p_str,
-                                                offset,
-                                                ptr0, len0,
-                                                ptr1, len1);
-        }
-        else
-        {
-            offset = m_log_data.hexdump_handler(
-                header.hexdump.severity,
-                p_timestamp,
-                p_str,
-                offset,
-                (uint8_t *)&m_log_data.buffer[rd_idx & mask],
-                length,
-                NULL, 0);
+            ptr0 = space0 ? ptr0 : (uint8_t *)&m_log_data.buffer[0];
+            len0 = space0 ? space0 : length;
+            ptr1 = space0 ? (uint8_t *)&m_log_data.buffer[0] : NULL;
+            len1 = space0 ? length - space0 : 0;
         }
 
+        offset = m_log_data.hexdump_handler(header.hexdump.severity,
+                                            p_timestamp, p_str,
+                                            offset,
+                                            ptr0, len0,
+                                            ptr1, len1);
+
         if (offset == length)
         {
+            extra_hexdump_feed(header.hexdump.severity, p_timestamp, p_str,
+                               ptr0, len0, ptr1, len1);
             rd_idx += CEIL_DIV(length, 4);
             ret     = true;
         }
@@ -781,6 +868,10 @@ bool nrf_log_frontend_dequeue(void)
         ret = m_log_data.std_handler(header.std.severity,
                                      p_timestamp,
                                      p_str, args, nargs);
+        if (ret)
+        {
+            extra_std_feed(header.std.severity, p_timestamp, p_str, args, nargs);
+        }
     }
     if (ret)
     {
@@ -795,4 +886,99 @@ uint8_t nrf_log_getchar(void)
     return nrf_log_backend_getchar();
 }
 
+
+void nrf_log_stats_get(nrf_log_stats_t * p_stats)
+{
+    p_stats->dropped     = m_dropped_cnt;
+    p_stats->max_usage   = m_max_usage;
+    p_stats->buffer_size = NRF_LOG_DEFERRED ? NRF_LOG_DEFERRED_BUFSIZE : 0;
+}
+
+
+void nrf_log_stats_reset(void)
+{
+    CRITICAL_REGION_ENTER();
+    m_dropped_cnt = 0;
+    m_max_usage   = 0;
+    CRITICAL_REGION_EXIT();
+}
+
+#if NRF_LOG_FILTERS_ENABLED
+void nrf_log_module_register(nrf_log_module_t * p_module)
+{
+    CRITICAL_REGION_ENTER();
+    // Check again, the module may have been added by an interrupt.
+    if (!p_module->registered)
+    {
+        p_module->p_next     = mp_modules_head;
+        mp_modules_head      = p_module;
+        p_module->registered = true;
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+
+ret_code_t nrf_log_module_filter_set(const char * p_name, uint8_t level)
+{
+    ret_code_t         ret_code = NRF_ERROR_NOT_FOUND;
+    nrf_log_module_t * p_module;
+
+    if (level > NRF_LOG_LEVEL_DEBUG)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    for (p_module = mp_modules_head; p_module != NULL; p_module = p_module->p_next)
+    {
+        if ((p_name == NULL) || (strcmp(p_module->p_name, p_name) == 0))
+        {
+            p_module->level = level;
+            ret_code        = NRF_SUCCESS;
+        }
+    }
+    return ret_code;
+}
+
+
+ret_code_t nrf_log_module_filter_get(const char * p_name, uint8_t * p_level)
+{
+    nrf_log_module_t * p_module;
+
+    for (p_module = mp_modules_head; p_module != NULL; p_module = p_module->p_next)
+    {
+        if (strcmp(p_module->p_name, p_name) == 0)
+        {
+            *p_level = p_module->level;
+            return NRF_SUCCESS;
+        }
+    }
+    return NRF_ERROR_NOT_FOUND;
+}
+
+
+uint32_t nrf_log_module_cnt_get(void)
+{
+    uint32_t           cnt = 0;
+    nrf_log_module_t * p_module;
+
+    for (p_module = mp_modules_head; p_module != NULL; p_module = p_module->p_next)
+    {
+        cnt++;
+    }
+    return cnt;
+}
+
+
+const char * nrf_log_module_name_get(uint32_t idx)
+{
+    nrf_log_module_t * p_module = mp_modules_head;
+
+    while ((p_module != NULL) && (idx-- > 0))
+    {
+        p_module = p_module->p_next;
+    }
+    return (p_module != NULL) ? p_module->p_name : NULL;
+}
+#endif //NRF_LOG_FILTERS_ENABLED
+
 #endif // NRF_MODULE_ENABLED(NRF_LOG)
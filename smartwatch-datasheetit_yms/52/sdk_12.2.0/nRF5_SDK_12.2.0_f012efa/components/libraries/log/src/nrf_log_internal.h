@@ -26,6 +26,10 @@
 #define NRF_LOG_USES_COLORS        0
 #endif
 
+#ifndef NRF_LOG_FILTERS_ENABLED
+#define NRF_LOG_FILTERS_ENABLED    0
+#endif
+
 #define NRF_LOG_LEVEL_ERROR        1U
 #define NRF_LOG_LEVEL_WARNING      2U
 #define NRF_LOG_LEVEL_INFO         3U
@@ -89,6 +93,67 @@
 #define LOG_INTERNAL(type, prefix, ...) LOG_INTERNAL_X(NUM_VA_ARGS_LESS_1( \
                                                            __VA_ARGS__), type, prefix, __VA_ARGS__)
 
+#if NRF_MODULE_ENABLED(NRF_LOG) && NRF_LOG_FILTERS_ENABLED
+/**
+ * @brief Runtime filter of a module.
+ *
+ * Every file that logs has its own instance. It is added to the list of modules on the first
+ * log call of the file.
+ */
+typedef struct nrf_log_module_s
+{
+    const char              * p_name;     // Module name (@ref NRF_LOG_MODULE_NAME).
+    struct nrf_log_module_s * p_next;     // Next module on the list.
+    volatile uint8_t          level;      // Highest severity level that is logged.
+    volatile bool             registered; // True if the module is on the list.
+} nrf_log_module_t;
+
+/**
+ * @brief A function for adding a module to the list of modules.
+ *
+ * @param p_module Pointer to the module filter.
+ */
+void nrf_log_module_register(nrf_log_module_t * p_module);
+
+/**
+ * @brief A function for getting the filter of the module that includes this header.
+ *
+ * @return Pointer to the module filter.
+ */
+__STATIC_INLINE nrf_log_module_t * nrf_log_module_get(void)
+{
+    static nrf_log_module_t m_module = {
+        .p_name = NRF_LOG_MODULE_NAME,
+        .level  = NRF_LOG_LEVEL,
+    };
+    return &m_module;
+}
+
+/**
+ * @brief A function for checking if an entry passes the runtime filter of the module.
+ *
+ * The check is done before any arguments are evaluated.
+ *
+ * @param level Severity level of the entry.
+ *
+ * @return True if the entry is to be logged.
+ */
+__STATIC_INLINE bool nrf_log_module_filter_check(uint8_t level)
+{
+    nrf_log_module_t * p_module = nrf_log_module_get();
+
+    if (!p_module->registered)
+    {
+        nrf_log_module_register(p_module);
+    }
+    return (level <= p_module->level);
+}
+
+#define NRF_LOG_FILTER_CHECK(level) nrf_log_module_filter_check(level)
+#else
+#define NRF_LOG_FILTER_CHECK(level) true
+#endif // NRF_MODULE_ENABLED(NRF_LOG) && NRF_LOG_FILTERS_ENABLED
+
 #define NRF_LOG_BREAK      ":"
 
 #define LOG_ERROR_PREFIX   NRF_LOG_ERROR_COLOR_CODE NRF_LOG_MODULE_NAME NRF_LOG_BREAK "ERROR:"
@@ -98,67 +163,77 @@
 
 #define NRF_LOG_INTERNAL_ERROR(...)                                       \
     if ((NRF_LOG_LEVEL >= NRF_LOG_LEVEL_ERROR) &&                         \
-        (NRF_LOG_LEVEL_ERROR <= NRF_LOG_DEFAULT_LEVEL))                   \
+        (NRF_LOG_LEVEL_ERROR <= NRF_LOG_DEFAULT_LEVEL) &&                 \
+        NRF_LOG_FILTER_CHECK(NRF_LOG_LEVEL_ERROR))                        \
     {                                                                     \
         LOG_INTERNAL(NRF_LOG_LEVEL_ERROR, LOG_ERROR_PREFIX, __VA_ARGS__); \
     }
 #define NRF_LOG_INTERNAL_HEXDUMP_ERROR(p_data, len)                                              \
     if ((NRF_LOG_LEVEL >= NRF_LOG_LEVEL_ERROR) &&                                                \
-        (NRF_LOG_LEVEL_ERROR <= NRF_LOG_DEFAULT_LEVEL))                                          \
+        (NRF_LOG_LEVEL_ERROR <= NRF_LOG_DEFAULT_LEVEL) &&                                        \
+        NRF_LOG_FILTER_CHECK(NRF_LOG_LEVEL_ERROR))                                               \
     {                                                                                            \
         nrf_log_frontend_hexdump(NRF_LOG_LEVEL_ERROR, LOG_ERROR_PREFIX "\r\n", (p_data), (len)); \
     }
 
 #define NRF_LOG_INTERNAL_WARNING(...)                                         \
     if ((NRF_LOG_LEVEL >= NRF_LOG_LEVEL_WARNING) &&                           \
-        (NRF_LOG_LEVEL_WARNING <= NRF_LOG_DEFAULT_LEVEL))                     \
+        (NRF_LOG_LEVEL_WARNING <= NRF_LOG_DEFAULT_LEVEL) &&                   \
+        NRF_LOG_FILTER_CHECK(NRF_LOG_LEVEL_WARNING))                          \
     {                                                                         \
         LOG_INTERNAL(NRF_LOG_LEVEL_WARNING, LOG_WARNING_PREFIX, __VA_ARGS__); \
     }
 #define NRF_LOG_INTERNAL_HEXDUMP_WARNING(p_data, len)                                                \
     if ((NRF_LOG_LEVEL >= NRF_LOG_LEVEL_WARNING) &&                                                  \
-        (NRF_LOG_LEVEL_WARNING <= NRF_LOG_DEFAULT_LEVEL))                                            \
+        (NRF_LOG_LEVEL_WARNING <= NRF_LOG_DEFAULT_LEVEL) &&                                          \
+        NRF_LOG_FILTER_CHECK(NRF_LOG_LEVEL_WARNING))                                                 \
     {                                                                                                \
         nrf_log_frontend_hexdump(NRF_LOG_LEVEL_WARNING, LOG_WARNING_PREFIX "\r\n", (p_data), (len)); \
     }
 
 #define NRF_LOG_INTERNAL_INFO(...)                                      \
     if ((NRF_LOG_LEVEL >= NRF_LOG_LEVEL_INFO) &&                        \
-        (NRF_LOG_LEVEL_INFO <= NRF_LOG_DEFAULT_LEVEL))                  \
+        (NRF_LOG_LEVEL_INFO <= NRF_LOG_DEFAULT_LEVEL) &&                \
+        NRF_LOG_FILTER_CHECK(NRF_LOG_LEVEL_INFO))                       \
     {                                                                   \
         LOG_INTERNAL(NRF_LOG_LEVEL_INFO, LOG_INFO_PREFIX, __VA_ARGS__); \
     }
 
 #define NRF_LOG_INTERNAL_RAW_INFO(...)                                  \
     if ((NRF_LOG_LEVEL >= NRF_LOG_LEVEL_INFO) &&                        \
-        (NRF_LOG_LEVEL_INFO <= NRF_LOG_DEFAULT_LEVEL))                  \
+        (NRF_LOG_LEVEL_INFO <= NRF_LOG_DEFAULT_LEVEL) &&                \
+        NRF_LOG_FILTER_CHECK(NRF_LOG_LEVEL_INFO))                       \
     {                                                                   \
         LOG_INTERNAL(NRF_LOG_LEVEL_INFO | NRF_LOG_RAW, "", __VA_ARGS__);          \
     }
 
 #define NRF_LOG_INTERNAL_HEXDUMP_INFO(p_data, len)                                             \
     if ((NRF_LOG_LEVEL >= NRF_LOG_LEVEL_INFO) &&                                               \
-        (NRF_LOG_LEVEL_INFO <= NRF_LOG_DEFAULT_LEVEL))                                         \
+        (NRF_LOG_LEVEL_INFO <= NRF_LOG_DEFAULT_LEVEL) &&                                       \
+        NRF_LOG_FILTER_CHECK(NRF_LOG_LEVEL_INFO))                                              \
     {                                                                                          \
         nrf_log_frontend_hexdump(NRF_LOG_LEVEL_INFO, LOG_INFO_PREFIX "\r\n", (p_data), (len)); \
     }
 
 #define NRF_LOG_INTERNAL_RAW_HEXDUMP_INFO(p_data, len)                                             \
     if ((NRF_LOG_LEVEL >= NRF_LOG_LEVEL_INFO) &&                                               \
-        (NRF_LOG_LEVEL_INFO <= NRF_LOG_DEFAULT_LEVEL))                                         \
+        (NRF_LOG_LEVEL_INFO <= NRF_LOG_DEFAULT_LEVEL) &&                                       \
+        NRF_LOG_FILTER_CHECK(NRF_LOG_LEVEL_INFO))                                              \
     {                                                                                          \
         nrf_log_frontend_hexdump(NRF_LOG_LEVEL_INFO | NRF_LOG_RAW, "", (p_data), (len)); \
     }
 
 #define NRF_LOG_INTERNAL_DEBUG(...)                                       \
     if ((NRF_LOG_LEVEL >= NRF_LOG_LEVEL_DEBUG) &&                         \
-        (NRF_LOG_LEVEL_DEBUG <= NRF_LOG_DEFAULT_LEVEL))                   \
+        (NRF_LOG_LEVEL_DEBUG <= NRF_LOG_DEFAULT_LEVEL) &&                 \
+        NRF_LOG_FILTER_CHECK(NRF_LOG_LEVEL_DEBUG))                        \
     {                                                                     \
         LOG_INTERNAL(NRF_LOG_LEVEL_DEBUG, LOG_DEBUG_PREFIX, __VA_ARGS__); \
     }
 #define NRF_LOG_INTERNAL_HEXDUMP_DEBUG(p_data, len)                                              \
     if ((NRF_LOG_LEVEL >= NRF_LOG_LEVEL_DEBUG) &&                                                \
-        (NRF_LOG_LEVEL_DEBUG <= NRF_LOG_DEFAULT_LEVEL))                                          \
+        (NRF_LOG_LEVEL_DEBUG <= NRF_LOG_DEFAULT_LEVEL) &&                                        \
+        NRF_LOG_FILTER_CHECK(NRF_LOG_LEVEL_DEBUG))                                               \
     {                                                                                            \
         nrf_log_frontend_hexdump(NRF_LOG_LEVEL_DEBUG, LOG_DEBUG_PREFIX "\r\n", (p_data), (len)); \
     }
@@ -0,0 +1,237 @@
+#!/usr/bin/env python
+# Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+#
+# The information contained herein is property of Nordic Semiconductor ASA.
+# Terms and conditions of usage are described in detail in NORDIC
+# SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+#
+# Licensees are granted free, non-transferable use of the information. NO
+# WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+# the file.
+
+"""Decoder for the nrf_log dictionary backend.
+
+The device sends the address of each format string instead of the string itself
+(NRF_LOG_BACKEND_DICTIONARY_ENABLED). This tool reads the strings from the ELF file
+of the application and prints the log as the text backend would.
+
+Usage:
+    nrf_log_dict_decode.py app.elf capture.bin
+    nrf_log_dict_decode.py app.elf /dev/ttyACM0 --baudrate 115200
+    JLinkRTTLogger ... | nrf_log_dict_decode.py app.elf -
+"""
+
+from __future__ import print_function
+
+import argparse
+import re
+import struct
+import sys
+
+FRAME_SYNC          = 0xA5
+FLAG_TIMESTAMP      = 0x01
+FLAG_HEXDUMP        = 0x02
+HEADER_LEN          = 8
+MAX_ARGS            = 6
+HEXDUMP_BYTES_PER_LINE = 16
+
+SHT_PROGBITS        = 1
+SHF_ALLOC           = 0x2
+
+
+class ElfStrings(object):
+    """Reads NUL-terminated strings from the allocated sections of an ELF32 file."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            data = f.read()
+
+        if data[:4] != b'\x7fELF' or data[4:5] != b'\x01':
+            raise ValueError('{} is not an ELF32 file'.format(path))
+
+        endian = '<' if data[5:6] == b'\x01' else '>'
+        (shoff,) = struct.unpack_from(endian + 'I', data, 0x20)
+        shentsize, shnum = struct.unpack_from(endian + 'HH', data, 0x2E)
+
+        self._sections = []
+        for i in range(shnum):
+            (_, sh_type, sh_flags, sh_addr, sh_offset, sh_size) = \
+                struct.unpack_from(endian + 'IIIIII', data, shoff + i * shentsize)
+            if sh_type == SHT_PROGBITS and (sh_flags & SHF_ALLOC) and sh_size:
+                self._sections.append((sh_addr, sh_size, data[sh_offset:sh_offset + sh_size]))
+
+    def get(self, address):
+        """Return the string at address, or None if it is not in the image."""
+        for (start, size, content) in self._sections:
+            if start <= address < start + size:
+                offset = address - start
+                end = content.find(b'\0', offset)
+                if end < 0:
+                    end = size
+                return content[offset:end].decode('ascii', 'replace')
+        return None
+
+
+# Conversion specification of printf: flags, width, precision, length and conversion.
+_SPEC = re.compile(r'%([-+ #0]*)(\d*|\*)(?:\.(\d*|\*))?(hh|h|ll|l|j|z|t|L)?([diouxXcspeEfgG%])')
+
+
+def c_format(fmt, args, strings):
+    """Format args (32-bit unsigned values) with a C printf format string."""
+    args = list(args)
+    out  = []
+    pos  = 0
+
+    for m in _SPEC.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        flags, width, precision, _, conv = m.groups()
+
+        if conv == '%':
+            out.append('%')
+            continue
+
+        if width == '*':
+            width = str(args.pop(0)) if args else ''
+        if precision == '*':
+            precision = str(args.pop(0)) if args else ''
+        value = args.pop(0) if args else 0
+
+        spec = '%' + flags + width + ('.' + precision if precision is not None else '')
+        if conv in 'di':
+            value = value - (1 << 32) if value & 0x80000000 else value
+            out.append((spec + 'd') % value)
+        elif conv in 'ouxX':
+            out.append((spec + conv) % value)
+        elif conv == 'c':
+            out.append((spec + 'c') % chr(value & 0xFF))
+        elif conv == 's':
+            text = strings.get(value)
+            out.append((spec + 's') % (text if text is not None else '<0x{:08X}>'.format(value)))
+        elif conv == 'p':
+            out.append((spec + 's') % '0x{:08x}'.format(value))
+        else:
+            # Floating point values are not passed through nrf_log as 32-bit words.
+            out.append((spec + 's') % '<0x{:08X}>'.format(value))
+
+    out.append(fmt[pos:])
+    return ''.join(out)
+
+
+def hexdump_lines(data, indent):
+    lines = []
+    for i in range(0, len(data), HEXDUMP_BYTES_PER_LINE):
+        chunk = bytearray(data[i:i + HEXDUMP_BYTES_PER_LINE])
+        hex_part  = ''.join('{:02X} '.format(c) for c in chunk)
+        char_part = ''.join(chr(c) if 32 <= c < 127 else '.' for c in chunk)
+        lines.append(' ' * indent + hex_part.ljust(HEXDUMP_BYTES_PER_LINE * 3) + ' ' + char_part)
+    return lines
+
+
+class Decoder(object):
+    """Splits the byte stream into frames and prints them."""
+
+    def __init__(self, strings, timestamp_digits, output):
+        self._strings   = strings
+        self._digits    = timestamp_digits
+        self._output    = output
+        self._buf       = bytearray()
+
+    def feed(self, data):
+        self._buf.extend(data)
+        while True:
+            length = self._frame_length()
+            if length is None:
+                return
+            if length == 0:
+                # Not a frame. Skip one byte and look for the next sync byte.
+                del self._buf[0]
+                continue
+            frame = bytes(self._buf[:length])
+            del self._buf[:length]
+            self._process(frame)
+
+    def _frame_length(self):
+        while self._buf and self._buf[0] != FRAME_SYNC:
+            del self._buf[0]
+        if len(self._buf) < HEADER_LEN:
+            return None
+
+        flags, count = self._buf[2], self._buf[3]
+        (address,)   = struct.unpack_from('<I', bytes(self._buf[4:8]))
+        if self._strings.get(address) is None:
+            return 0
+
+        length = HEADER_LEN + (4 if flags & FLAG_TIMESTAMP else 0)
+        if flags & FLAG_HEXDUMP:
+            length += 2 + count
+        elif count <= MAX_ARGS:
+            length += 4 * count
+        else:
+            return 0
+
+        return length if len(self._buf) >= length else None
+
+    def _timestamp(self, frame, flags):
+        if not flags & FLAG_TIMESTAMP:
+            return '', HEADER_LEN
+        (value,) = struct.unpack_from('<I', frame, HEADER_LEN)
+        return '[{:0{}d}]'.format(value, self._digits), HEADER_LEN + 4
+
+    def _process(self, frame):
+        flags, count  = bytearray(frame[2:4])
+        (address,)    = struct.unpack_from('<I', frame, 4)
+        fmt           = self._strings.get(address)
+        stamp, offset = self._timestamp(frame, flags)
+
+        if flags & FLAG_HEXDUMP:
+            (dump_offset,) = struct.unpack_from('<H', frame, offset)
+            data = frame[offset + 2:offset + 2 + count]
+            if dump_offset == 0:
+                self._write(stamp + fmt)
+            indent = len(stamp)
+            for line in hexdump_lines(data, indent):
+                self._write(line + '\r\n')
+        else:
+            args = struct.unpack_from('<' + 'I' * count, frame, offset)
+            self._write(stamp + c_format(fmt, args, self._strings))
+
+    def _write(self, text):
+        self._output.write(text)
+        self._output.flush()
+
+
+def open_input(name, baudrate):
+    if name == '-':
+        return getattr(sys.stdin, 'buffer', sys.stdin)
+    if name.startswith('/dev/') or name.upper().startswith('COM'):
+        import serial
+        return serial.Serial(name, baudrate, timeout=0.1)
+    return open(name, 'rb')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode nrf_log dictionary frames.')
+    parser.add_argument('elf', help='ELF file of the application that produced the log')
+    parser.add_argument('input', help='capture file, serial port, or - for stdin')
+    parser.add_argument('--baudrate', type=int, default=115200, help='serial port baud rate')
+    parser.add_argument('--timestamp-digits', type=int, default=8,
+                        help='value of NRF_LOG_TIMESTAMP_DIGITS')
+    args = parser.parse_args()
+
+    decoder = Decoder(ElfStrings(args.elf), args.timestamp_digits, sys.stdout)
+    stream  = open_input(args.input, args.baudrate)
+    is_file = not hasattr(stream, 'in_waiting')
+
+    try:
+        while True:
+            data = stream.read(256)
+            if not data and is_file:
+                break
+            decoder.feed(data)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == '__main__':
+    main()
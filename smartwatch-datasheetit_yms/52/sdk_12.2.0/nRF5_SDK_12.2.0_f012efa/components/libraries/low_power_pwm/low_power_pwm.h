@@ -23,6 +23,9 @@
  * Each low-power PWM instance utilizes one app_timer. This means it runs on RTC
  * and does not require HFCLK to be running. There can be any number of output
  * channels per instance.
+ *
+ * @note Every edge of the signal wakes the CPU. On nRF52, @ref pwm_effects generates the
+ *       signal with the PWM peripheral instead.
  */
 
 #ifndef LOW_POWER_PWM_H__
@@ -13,6 +13,7 @@
 #if NRF_MODULE_ENABLED(MEM_MANAGER)
 #include "mem_manager.h"
 #include "nrf_assert.h"
+#include "app_util_platform.h"
 #define NRF_LOG_MODULE_NAME "MEM_MNGR"
 #include "nrf_log.h"
 
@@ -394,6 +395,40 @@
 #define BLOCK_BITMAP_ARRAY_SIZE        CEIL_DIV(TOTAL_BLOCK_COUNT, BITMAP_SIZE)                     /**< Determines number of blocks needed for book keeping availability status of all blocks. */
 
 
+#ifndef MEM_MANAGER_ENABLE_SLAB_ALLOCATOR
+#define MEM_MANAGER_ENABLE_SLAB_ALLOCATOR 0
+#endif
+
+#if MEM_MANAGER_ENABLE_SLAB_ALLOCATOR
+
+#if (__CORTEX_M >= 0x03U)
+#define SLAB_EXCLUSIVE_ACCESS_SUPPORTED 1                                                           /**< LDREX/STREX are used for the free lists. */
+#else
+#define SLAB_EXCLUSIVE_ACCESS_SUPPORTED 0                                                           /**< Free lists are protected by critical regions. */
+#endif
+
+#define SLAB_LIST_END                  0xFFFF                                                       /**< Block index that terminates a free list. */
+#define SLAB_ROUTE_COUNT               33                                                           /**< Number of entries in the size routing table, one per base-2 logarithm of a 32-bit size. */
+
+/**@brief Macro for checking that a block category can be managed by the slab allocator.
+ *
+ * @details Blocks must be powers of two, large enough to hold the free list link, and have
+ *          indexes that fit in the free list link.
+ */
+#define SLAB_BLOCK_CAT_VALID(COUNT, SIZE)                                                           \
+    (((COUNT) == 0) ||                                                                              \
+     (IS_POWER_OF_TWO(SIZE) && ((SIZE) >= sizeof(uint32_t)) && ((COUNT) < SLAB_LIST_END)))
+
+STATIC_ASSERT(SLAB_BLOCK_CAT_VALID(MEMORY_MANAGER_XXSMALL_BLOCK_COUNT, MEMORY_MANAGER_XXSMALL_BLOCK_SIZE));
+STATIC_ASSERT(SLAB_BLOCK_CAT_VALID(MEMORY_MANAGER_XSMALL_BLOCK_COUNT,  MEMORY_MANAGER_XSMALL_BLOCK_SIZE));
+STATIC_ASSERT(SLAB_BLOCK_CAT_VALID(MEMORY_MANAGER_SMALL_BLOCK_COUNT,   MEMORY_MANAGER_SMALL_BLOCK_SIZE));
+STATIC_ASSERT(SLAB_BLOCK_CAT_VALID(MEMORY_MANAGER_MEDIUM_BLOCK_COUNT,  MEMORY_MANAGER_MEDIUM_BLOCK_SIZE));
+STATIC_ASSERT(SLAB_BLOCK_CAT_VALID(MEMORY_MANAGER_LARGE_BLOCK_COUNT,   MEMORY_MANAGER_LARGE_BLOCK_SIZE));
+STATIC_ASSERT(SLAB_BLOCK_CAT_VALID(MEMORY_MANAGER_XLARGE_BLOCK_COUNT,  MEMORY_MANAGER_XLARGE_BLOCK_SIZE));
+STATIC_ASSERT(SLAB_BLOCK_CAT_VALID(MEMORY_MANAGER_XXLARGE_BLOCK_COUNT, MEMORY_MANAGER_XXLARGE_BLOCK_SIZE));
+
+#endif // MEM_MANAGER_ENABLE_SLAB_ALLOCATOR
+
 /**@brief Lookup table for maximum memory size per block category. */
 static const uint32_t m_block_size[BLOCK_CAT_COUNT] =
 {
@@ -442,8 +477,14 @@ static const uint32_t m_block_mem_start[BLOCK_CAT_COUNT] =
     XXLARGE_MEMORY_START
 };
 
-static uint8_t  m_memory[TOTAL_MEMORY_SIZE];                                                        /**< Memory managed by the module. */
-static uint32_t m_mem_pool[BLOCK_BITMAP_ARRAY_SIZE];                                                /**< Bitmap used for book-keeping availability of all blocks managed by the module.  */
+static __ALIGN(4) uint8_t m_memory[TOTAL_MEMORY_SIZE];                                              /**< Memory managed by the module. */
+#if MEM_MANAGER_ENABLE_SLAB_ALLOCATOR
+static uint32_t volatile  m_slab_head[BLOCK_CAT_COUNT];                                             /**< Index of the first free block in each block category. */
+static uint8_t            m_slab_shift[BLOCK_CAT_COUNT];                                            /**< Base-2 logarithm of the block size in each block category. */
+static uint8_t            m_slab_route[SLAB_ROUTE_COUNT];                                           /**< First block category for each power-of-two request size. */
+#else
+static uint32_t           m_mem_pool[BLOCK_BITMAP_ARRAY_SIZE];                                      /**< Bitmap used for book-keeping availability of all blocks managed by the module.  */
+#endif // MEM_MANAGER_ENABLE_SLAB_ALLOCATOR
 
 #ifdef MEM_MANAGER_ENABLE_DIAGNOSTICS
 
@@ -474,6 +515,14 @@ static uint32_t m_min_size[BLOCK_CAT_COUNT]  =
 /**@brief Table for book keeping largest size allocated in each block range. */
 static uint32_t m_max_size[BLOCK_CAT_COUNT];
 
+#if MEM_MANAGER_ENABLE_SLAB_ALLOCATOR
+static uint32_t m_slab_in_use[BLOCK_CAT_COUNT];                                                     /**< Number of blocks in use in each block category. */
+static uint32_t m_slab_peak[BLOCK_CAT_COUNT];                                                       /**< Highest number of blocks in use at the same time in each block category. */
+static uint32_t m_slab_spill[BLOCK_CAT_COUNT];                                                      /**< Number of allocations served by each block category because smaller categories were exhausted. */
+static uint32_t m_slab_requested;                                                                   /**< Total number of bytes requested by all allocations. */
+static uint32_t m_slab_granted;                                                                     /**< Total number of bytes in the blocks returned by all allocations. */
+#endif // MEM_MANAGER_ENABLE_SLAB_ALLOCATOR
+
 /**@brief Global pointing to minimum size holder for block type being allocated. */
 static uint32_t * p_min_size;
 
@@ -500,6 +549,267 @@ static bool     m_module_initialized = false;
 #endif // MEM_MANAGER_DISABLE_API_PARAM_CHECK
 
 
+#if MEM_MANAGER_ENABLE_SLAB_ALLOCATOR
+
+/**@brief Function to get the base-2 logarithm of a size, rounded up. */
+static __INLINE uint32_t slab_log2_ceil(uint32_t size)
+{
+    if (size <= 1)
+    {
+        return 0;
+    }
+#if (__CORTEX_M >= 0x03U)
+    return 32 - __CLZ(size - 1);
+#else
+    uint32_t log2 = 0;
+    for (size--; size != 0; size >>= 1)
+    {
+        log2++;
+    }
+    return log2;
+#endif
+}
+
+
+/**@brief Function to get the number of blocks in the category 'block_cat'. */
+static __INLINE uint32_t slab_block_count(uint32_t block_cat)
+{
+    return m_block_end[block_cat] - m_block_start[block_cat];
+}
+
+
+/**@brief Function to get the address of the block 'block_index' in the category 'block_cat'. */
+static __INLINE uint32_t * slab_block_get(uint32_t block_cat, uint32_t block_index)
+{
+    return (uint32_t *)&m_memory[m_block_mem_start[block_cat] +
+                                 (block_index << m_slab_shift[block_cat])];
+}
+
+
+/**@brief Function to take the first block from the free list of the category 'block_cat'.
+ *
+ * @details The next free block index is stored in the first word of each free block. If the list
+ *          changes between LDREX and STREX, the exclusive monitor is cleared by the exception that
+ *          changed it, and the operation is retried.
+ *
+ * @retval Pointer to the block, or NULL if there are no free blocks in the category.
+ */
+static void * slab_block_pop(uint32_t block_cat)
+{
+    uint32_t   block_index;
+    uint32_t * p_block;
+
+#if SLAB_EXCLUSIVE_ACCESS_SUPPORTED
+    do
+    {
+        block_index = __LDREXW(&m_slab_head[block_cat]);
+        if (block_index == SLAB_LIST_END)
+        {
+            __CLREX();
+            return NULL;
+        }
+        p_block = slab_block_get(block_cat, block_index);
+    } while (__STREXW(*p_block, &m_slab_head[block_cat]) != 0);
+#else
+    p_block = NULL;
+
+    CRITICAL_REGION_ENTER();
+    block_index = m_slab_head[block_cat];
+    if (block_index != SLAB_LIST_END)
+    {
+        p_block                = slab_block_get(block_cat, block_index);
+        m_slab_head[block_cat] = *p_block;
+    }
+    CRITICAL_REGION_EXIT();
+#endif // SLAB_EXCLUSIVE_ACCESS_SUPPORTED
+
+    return p_block;
+}
+
+
+/**@brief Function to put the block 'block_index' at the front of the free list of the category
+ *        'block_cat'.
+ */
+static void slab_block_push(uint32_t block_cat, uint32_t block_index)
+{
+    uint32_t * p_block = slab_block_get(block_cat, block_index);
+
+#if SLAB_EXCLUSIVE_ACCESS_SUPPORTED
+    do
+    {
+        *p_block = __LDREXW(&m_slab_head[block_cat]);
+    } while (__STREXW(block_index, &m_slab_head[block_cat]) != 0);
+#else
+    CRITICAL_REGION_ENTER();
+    *p_block               = m_slab_head[block_cat];
+    m_slab_head[block_cat] = block_index;
+    CRITICAL_REGION_EXIT();
+#endif // SLAB_EXCLUSIVE_ACCESS_SUPPORTED
+}
+
+
+#ifdef MEM_MANAGER_ENABLE_DIAGNOSTICS
+/**@brief Function to update the statistics of the category 'block_cat' for an allocation.
+ *
+ * @param[in] block_cat      Category of the allocated block.
+ * @param[in] requested_size Size that was requested.
+ * @param[in] spilled        True if a smaller category was exhausted.
+ */
+static void slab_stats_alloc(uint32_t block_cat, uint32_t requested_size, bool spilled)
+{
+    CRITICAL_REGION_ENTER();
+
+    m_slab_in_use[block_cat]++;
+    m_slab_peak[block_cat]  = MAX(m_slab_peak[block_cat], m_slab_in_use[block_cat]);
+    m_slab_spill[block_cat] += spilled ? 1 : 0;
+    m_slab_requested        += requested_size;
+    m_slab_granted          += m_block_size[block_cat];
+    m_min_size[block_cat]    = MIN(m_min_size[block_cat], requested_size);
+    m_max_size[block_cat]    = MAX(m_max_size[block_cat], requested_size);
+
+    CRITICAL_REGION_EXIT();
+}
+#endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
+
+
+uint32_t nrf_mem_init(void)
+{
+    NRF_LOG_DEBUG("[MM]: >> nrf_mem_init.\r\n");
+
+    uint32_t block_cat;
+    uint32_t route = 0;
+
+    for (block_cat = 0; block_cat < BLOCK_CAT_COUNT; block_cat++)
+    {
+        const uint32_t block_count = slab_block_count(block_cat);
+
+        m_slab_shift[block_cat] = slab_log2_ceil(m_block_size[block_cat]);
+        m_slab_head[block_cat]  = SLAB_LIST_END;
+
+        // Lower indexes end up at the front of the list.
+        for (uint32_t block_index = block_count; block_index > 0; block_index--)
+        {
+            slab_block_push(block_cat, block_index - 1);
+        }
+
+        // Requests up to this block size start the search in this category.
+        for (; (block_count != 0) && (route <= m_slab_shift[block_cat]); route++)
+        {
+            m_slab_route[route] = block_cat;
+        }
+    }
+
+    for (; route < SLAB_ROUTE_COUNT; route++)
+    {
+        m_slab_route[route] = BLOCK_CAT_COUNT;
+    }
+
+#if (MEM_MANAGER_DISABLE_API_PARAM_CHECK == 0)
+    m_module_initialized = true;
+#endif // MEM_MANAGER_DISABLE_API_PARAM_CHECK
+
+#ifdef MEM_MANAGER_ENABLE_DIAGNOSTICS
+        nrf_mem_diagnose();
+#endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
+
+    NRF_LOG_DEBUG("[MM]: << nrf_mem_init.\r\n");
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_mem_reserve(uint8_t ** pp_buffer, uint32_t * p_size)
+{
+    VERIFY_MODULE_INITIALIZED();
+    NULL_PARAM_CHECK(pp_buffer);
+    NULL_PARAM_CHECK(p_size);
+
+    const uint32_t requested_size = (*p_size);
+
+    VERIFY_REQUESTED_SIZE(requested_size);
+
+    NRF_LOG_DEBUG("[MM]: >> nrf_mem_reserve, size 0x%04lX.\r\n", requested_size);
+
+    const uint32_t first_cat = m_slab_route[slab_log2_ceil(requested_size)];
+    uint32_t       err_code  = (NRF_ERROR_NO_MEM | NRF_ERROR_MEMORY_MANAGER_ERR_BASE);
+
+    // If the category is exhausted, continue with the larger ones.
+    for (uint32_t block_cat = first_cat; block_cat < BLOCK_CAT_COUNT; block_cat++)
+    {
+        uint8_t * p_block = slab_block_pop(block_cat);
+
+        if (p_block != NULL)
+        {
+            err_code     = NRF_SUCCESS;
+            (*pp_buffer) = p_block;
+            (*p_size)    = m_block_size[block_cat];
+
+            #ifdef MEM_MANAGER_ENABLE_DIAGNOSTICS
+                slab_stats_alloc(block_cat, requested_size, (block_cat != first_cat));
+            #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
+
+            break;
+        }
+    }
+
+    if (err_code != NRF_SUCCESS)
+    {
+        NRF_LOG_DEBUG ("[MM]: Memory reservation result %d, memory %p, size %d!",
+                err_code,
+                (uint32_t)(*pp_buffer),
+                (*p_size));
+
+        #ifdef MEM_MANAGER_ENABLE_DIAGNOSTICS
+        nrf_mem_diagnose();
+        #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
+    }
+
+    NRF_LOG_DEBUG("[MM]: << nrf_mem_reserve %p, result 0x%08lX.\r\n",
+                 (uint32_t)(*pp_buffer), err_code);
+
+    return err_code;
+}
+
+
+void nrf_free(void * p_mem)
+{
+    VERIFY_MODULE_INITIALIZED_VOID();
+    NULL_PARAM_CHECK_VOID(p_mem);
+
+    NRF_LOG_DEBUG("[MM]: >> nrf_free %p.\r\n", (uint32_t)p_mem);
+
+    const uint32_t memory_index = (uint32_t)((uint8_t *)p_mem - &m_memory[0]);
+
+    for (uint32_t block_cat = 0; block_cat < BLOCK_CAT_COUNT; block_cat++)
+    {
+        const uint32_t offset = memory_index - m_block_mem_start[block_cat];
+
+        // Blocks of a category are contiguous, and the categories follow each other.
+        if ((memory_index >= m_block_mem_start[block_cat]) &&
+            (offset < (slab_block_count(block_cat) << m_slab_shift[block_cat])))
+        {
+            if ((offset & (m_block_size[block_cat] - 1)) == 0)
+            {
+                NRF_LOG_DEBUG("[MM]: << Freeing block %d.\r\n",
+                              m_block_start[block_cat] + (offset >> m_slab_shift[block_cat]));
+                slab_block_push(block_cat, offset >> m_slab_shift[block_cat]);
+
+                #ifdef MEM_MANAGER_ENABLE_DIAGNOSTICS
+                    CRITICAL_REGION_ENTER();
+                    m_slab_in_use[block_cat]--;
+                    CRITICAL_REGION_EXIT();
+                #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
+            }
+            break;
+        }
+    }
+
+    NRF_LOG_DEBUG("[MM]: << nrf_free.\r\n");
+    return;
+}
+
+#else
+
 /**@brief Function to get X and Y coordinates.
  *
  * @details Function to get X and Y co-ordinates for the block identified by index.
@@ -695,6 +1005,8 @@ uint32_t nrf_mem_reserve(uint8_t ** pp_buffer, uint32_t * p_size)
     return err_code;
 }
 
+#endif // MEM_MANAGER_ENABLE_SLAB_ALLOCATOR
+
 
 void * nrf_malloc(uint32_t size)
 {
@@ -734,6 +1046,7 @@ void * nrf_calloc(uint32_t count, uint32_t size)
     return buffer;
 }
 
+#if (MEM_MANAGER_ENABLE_SLAB_ALLOCATOR == 0)
 
 void nrf_free(void * p_mem)
 {
@@ -765,6 +1078,8 @@ void nrf_free(void * p_mem)
     return;
 }
 
+#endif // (MEM_MANAGER_ENABLE_SLAB_ALLOCATOR == 0)
+
 
 void * nrf_realloc(void * p_mem, uint32_t size)
 {
@@ -801,6 +1116,12 @@ void print_block_info(uint32_t block_cat, uint32_t * p_mem_in_use)
     {
         memset(print_buffer, ASCII_VALUE_FOR_SPACE, PRINT_BUFFER_SIZE);
 
+#if MEM_MANAGER_ENABLE_SLAB_ALLOCATOR
+        UNUSED_VARIABLE(total_count);
+        UNUSED_VARIABLE(index);
+        num_of_blocks = m_slab_in_use[block_cat];
+        in_use        = num_of_blocks * m_block_size[block_cat];
+#else
         for (; index < total_count; index++)
         {
             if (is_block_free(index) == false)
@@ -809,6 +1130,7 @@ void print_block_info(uint32_t block_cat, uint32_t * p_mem_in_use)
                 in_use += m_block_size[block_cat];
             }
         }
+#endif // MEM_MANAGER_ENABLE_SLAB_ALLOCATOR
 
         column_number = 0;
         snprintf(&print_buffer[column_number * PRINT_COLUMN_WIDTH],
@@ -886,6 +1208,29 @@ void nrf_mem_diagnose(void)
     NRF_LOG_DEBUG ("| Total      | %d      | %d        | %d\r\n",
             TOTAL_MEMORY_SIZE, TOTAL_BLOCK_COUNT,in_use);
     NRF_LOG_DEBUG ("+------------+------------+------------+------------+------------+------------+\r\n");
+
+#if MEM_MANAGER_ENABLE_SLAB_ALLOCATOR
+    // Peak use shows how many blocks each category needs. Spilled allocations show categories
+    // that are too small. Internal fragmentation is the share of granted bytes that were not
+    // requested.
+    for (uint32_t block_cat = 0; block_cat < BLOCK_CAT_COUNT; block_cat++)
+    {
+        if (m_block_count[block_cat] != 0)
+        {
+            NRF_LOG_DEBUG ("| %s peak %d, spilled %d\r\n",
+                    (uint32_t)m_block_desc_str[block_cat],
+                    m_slab_peak[block_cat],
+                    m_slab_spill[block_cat]);
+        }
+    }
+
+    NRF_LOG_DEBUG ("| Requested %d, granted %d, fragmentation %d%%\r\n",
+            m_slab_requested,
+            m_slab_granted,
+            (m_slab_granted == 0) ? 0 :
+            (uint32_t)(((uint64_t)(m_slab_granted - m_slab_requested) * 100) / m_slab_granted));
+    NRF_LOG_DEBUG ("+------------+------------+------------+------------+------------+------------+\r\n");
+#endif // MEM_MANAGER_ENABLE_SLAB_ALLOCATOR
 }
 
 #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
@@ -90,5 +90,19 @@
 #define MEM_MANAGER_DISABLE_API_PARAM_CHECK
 
 
+/** @brief Use per-category free lists instead of the block bitmap.
+ *
+ *  Allocation starts in the smallest category that fits the request and frees find the
+ *  category from the address, so neither searches the blocks. On Cortex-M4 the free lists
+ *  are updated with LDREX/STREX instead of critical regions. All block sizes must be powers
+ *  of two of at least 4 bytes.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define MEM_MANAGER_ENABLE_SLAB_ALLOCATOR
+
+
 
 /** @} */
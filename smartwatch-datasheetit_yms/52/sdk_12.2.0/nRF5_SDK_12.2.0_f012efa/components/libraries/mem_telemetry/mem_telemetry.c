@@ -0,0 +1,229 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(MEM_TELEMETRY)
+#include "mem_telemetry.h"
+#include <string.h>
+#include "nrf.h"
+#include "app_util.h"
+#include "nrf_balloc.h"
+#include "nrf_queue.h"
+
+#define NRF_LOG_MODULE_NAME "MEM"
+#include "nrf_log.h"
+
+// Create section "mem_telemetry".
+//lint -esym(526, mem_telemetryBase) -esym(526, mem_telemetryLimit)
+NRF_SECTION_VARS_CREATE_SECTION(mem_telemetry, mem_telemetry_entry_t const);
+
+// Helper macros for section variables.
+#define ENTRY_SECTION_VARS_GET(i)   NRF_SECTION_VARS_GET((i),                           \
+                                                         mem_telemetry_entry_t const,   \
+                                                         mem_telemetry)
+#define ENTRY_SECTION_VARS_COUNT    NRF_SECTION_VARS_COUNT(mem_telemetry_entry_t const, \
+                                                           mem_telemetry)
+
+#define MAIN_STACK_PAINT_MARGIN 64  /**< Bytes below the stack pointer that are not painted, for the frame of the painting loop. */
+#define RECORD_HEADER_SIZE      10  /**< Encoded record, without the name. */
+
+#if defined ( __GNUC__ ) && !defined ( __CC_ARM ) && !defined ( __ICCARM__ )
+extern uint32_t __StackLimit;
+extern uint32_t __StackTop;
+#define MAIN_STACK_COUNT 1          /**< The linker script gives the main stack. */
+#else
+#define MAIN_STACK_COUNT 0
+#endif
+
+
+/**@brief Function for painting a stack. */
+static void stack_paint(uint32_t * p_begin, uint32_t * p_end)
+{
+    while (p_begin < p_end)
+    {
+        *p_begin++ = MEM_TELEMETRY_STACK_PATTERN;
+    }
+}
+
+
+/**@brief Function for getting the peak use of a stack, from the lowest word that was overwritten.
+ */
+static uint32_t stack_peak_get(uint32_t const * p_base, uint32_t size)
+{
+    uint32_t const * p_word = p_base;
+    uint32_t const * p_end  = p_base + (size / sizeof(uint32_t));
+
+    while ((p_word < p_end) && (*p_word == MEM_TELEMETRY_STACK_PATTERN))
+    {
+        p_word++;
+    }
+
+    return size - ((uint32_t)p_word - (uint32_t)p_base);
+}
+
+
+static void entry_usage_get(mem_telemetry_entry_t const * p_entry, mem_telemetry_usage_t * p_usage)
+{
+    switch (p_entry->type)
+    {
+        case MEM_TELEMETRY_TYPE_STACK:
+            p_usage->capacity = p_entry->size;
+            p_usage->peak     = stack_peak_get(p_entry->p_context, p_entry->size);
+            break;
+
+        case MEM_TELEMETRY_TYPE_BALLOC:
+        {
+            nrf_balloc_t const * p_pool = p_entry->p_context;
+
+            p_usage->capacity = p_pool->p_stack_limit - p_pool->p_stack_base;
+            p_usage->peak     = nrf_balloc_max_utilization_get(p_pool);
+            break;
+        }
+
+        case MEM_TELEMETRY_TYPE_QUEUE:
+        {
+            nrf_queue_t const * p_queue = p_entry->p_context;
+
+            p_usage->capacity = p_queue->size;
+            p_usage->peak     = nrf_queue_max_utilization_get(p_queue);
+            break;
+        }
+
+        default:
+            memset(p_usage, 0, sizeof(mem_telemetry_usage_t));
+            if (p_entry->usage_get != NULL)
+            {
+                p_entry->usage_get(p_usage);
+            }
+            break;
+    }
+}
+
+
+void mem_telemetry_init(void)
+{
+#if MAIN_STACK_COUNT
+    // Only the part of the main stack below the frame of this function and of the painting loop
+    // is free. An interrupt taken while painting uses it, but its frame is gone when it returns.
+    stack_paint(&__StackLimit, (uint32_t *)((__get_MSP() - MAIN_STACK_PAINT_MARGIN) & ~3UL));
+#endif
+
+    for (uint32_t i = 0; i < ENTRY_SECTION_VARS_COUNT; i++)
+    {
+        mem_telemetry_entry_t const * p_entry = ENTRY_SECTION_VARS_GET(i);
+
+        if (p_entry->type == MEM_TELEMETRY_TYPE_STACK)
+        {
+            uint32_t * p_base = (uint32_t *)p_entry->p_context;
+
+            stack_paint(p_base, p_base + (p_entry->size / sizeof(uint32_t)));
+        }
+    }
+}
+
+
+uint32_t mem_telemetry_count(void)
+{
+    return MAIN_STACK_COUNT + ENTRY_SECTION_VARS_COUNT;
+}
+
+
+ret_code_t mem_telemetry_record_get(uint32_t idx, mem_telemetry_record_t * p_record)
+{
+    mem_telemetry_usage_t         usage;
+    mem_telemetry_entry_t const * p_entry;
+
+    VERIFY_PARAM_NOT_NULL(p_record);
+
+    if (idx >= mem_telemetry_count())
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+#if MAIN_STACK_COUNT
+    if (idx == 0)
+    {
+        uint32_t size = (uint32_t)&__StackTop - (uint32_t)&__StackLimit;
+
+        p_record->p_name   = "main_stack";
+        p_record->type     = MEM_TELEMETRY_TYPE_STACK;
+        p_record->capacity = size;
+        p_record->peak     = stack_peak_get(&__StackLimit, size);
+        return NRF_SUCCESS;
+    }
+#endif
+
+    p_entry = ENTRY_SECTION_VARS_GET(idx - MAIN_STACK_COUNT);
+    entry_usage_get(p_entry, &usage);
+
+    p_record->p_name   = p_entry->p_name;
+    p_record->type     = p_entry->type;
+    p_record->capacity = usage.capacity;
+    p_record->peak     = usage.peak;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t mem_telemetry_encode(uint8_t * p_buf, uint32_t size)
+{
+    mem_telemetry_record_t record;
+    uint32_t               len = 0;
+
+    for (uint32_t i = 0; i < mem_telemetry_count(); i++)
+    {
+        uint32_t name_len;
+
+        (void)mem_telemetry_record_get(i, &record);
+
+        name_len = MIN(strlen(record.p_name), UINT8_MAX);
+        if (len + RECORD_HEADER_SIZE + name_len > size)
+        {
+            break;
+        }
+
+        p_buf[len++] = (uint8_t)record.type;
+        len         += uint32_encode(record.peak, &p_buf[len]);
+        len         += uint32_encode(record.capacity, &p_buf[len]);
+        p_buf[len++] = (uint8_t)name_len;
+        memcpy(&p_buf[len], record.p_name, name_len);
+        len         += name_len;
+    }
+
+    return len;
+}
+
+
+void mem_telemetry_log(void)
+{
+    static char const * const units[] =
+    {
+        [MEM_TELEMETRY_TYPE_STACK]  = "bytes",
+        [MEM_TELEMETRY_TYPE_BALLOC] = "blocks",
+        [MEM_TELEMETRY_TYPE_QUEUE]  = "elements",
+        [MEM_TELEMETRY_TYPE_CUSTOM] = "units",
+    };
+    mem_telemetry_record_t record;
+
+    for (uint32_t i = 0; i < mem_telemetry_count(); i++)
+    {
+        (void)mem_telemetry_record_get(i, &record);
+
+        NRF_LOG_INFO("%s: peak %d of %d %s.\r\n", (uint32_t)record.p_name,
+                     record.peak, record.capacity, (uint32_t)units[record.type]);
+        if ((record.capacity != 0) && (record.peak >= record.capacity))
+        {
+            NRF_LOG_WARNING("%s was full.\r\n", (uint32_t)record.p_name);
+        }
+    }
+}
+
+#endif // NRF_MODULE_ENABLED(MEM_TELEMETRY)
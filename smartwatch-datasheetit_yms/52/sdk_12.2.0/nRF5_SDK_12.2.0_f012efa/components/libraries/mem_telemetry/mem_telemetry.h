@@ -0,0 +1,192 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup mem_telemetry Memory telemetry
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for collecting the high-water marks of the stacks, pools and queues.
+ *
+ * @details Pools, queues and stacks register themselves with the macros of this module, in the
+ *          file that defines them. @ref mem_telemetry_record_get and @ref mem_telemetry_encode
+ *          then give the peak use and the capacity of all of them in one place, and the Memory
+ *          Telemetry Service (@ref ble_mts) reads them over BLE. Buffers can be sized from the
+ *          peaks seen in the field instead of worst case guesses.
+ *
+ *          - Block allocators (@ref nrf_balloc), in blocks.
+ *          - Queues (@ref nrf_queue), in elements.
+ *          - Stacks, in bytes. @ref mem_telemetry_init paints them with a pattern, and the peak is
+ *            found by scanning for the deepest word that was overwritten. The main stack is
+ *            always the first record (GCC only, from the symbols of the linker script).
+ *          - Other pools, from a function. The queues of @ref app_scheduler and @ref app_timer
+ *            register themselves this way when their profiler is enabled.
+ *
+ *          Example:
+ *          @code
+ *          NRF_BALLOC_DEF(m_msg_pool, MSG_SIZE, MSG_COUNT);
+ *          MEM_TELEMETRY_BALLOC_REGISTER(m_msg_pool_telemetry, &m_msg_pool);
+ *
+ *          static uint32_t m_task_stack[256];
+ *          MEM_TELEMETRY_STACK_REGISTER(m_task_stack_telemetry, m_task_stack, sizeof(m_task_stack));
+ *          @endcode
+ *
+ *          The entries are placed in the section "mem_telemetry", which the linker script must
+ *          keep.
+ *
+ * @note The stacks of FreeRTOS tasks created with xTaskCreate are painted by the kernel with
+ *       the same pattern when stack overflow checking is enabled. Register them with a function
+ *       that calls uxTaskGetStackHighWaterMark.
+ */
+
+#ifndef MEM_TELEMETRY_H__
+#define MEM_TELEMETRY_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sdk_errors.h"
+#include "section_vars.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MEM_TELEMETRY_STACK_PATTERN 0xA5A5A5A5UL /**< Paint of the free part of the stacks, the fill byte of FreeRTOS. */
+
+/**@brief Types of entries. */
+typedef enum
+{
+    MEM_TELEMETRY_TYPE_STACK,  /**< Stack, in bytes. */
+    MEM_TELEMETRY_TYPE_BALLOC, /**< Block allocator, in blocks. */
+    MEM_TELEMETRY_TYPE_QUEUE,  /**< Queue, in elements. */
+    MEM_TELEMETRY_TYPE_CUSTOM  /**< Other pool, in its own unit. */
+} mem_telemetry_type_t;
+
+/**@brief Peak use and capacity of an entry. */
+typedef struct
+{
+    uint32_t peak;     /**< Highest use seen. */
+    uint32_t capacity; /**< Capacity. */
+} mem_telemetry_usage_t;
+
+/**@brief Function for getting the use of a pool of type @ref MEM_TELEMETRY_TYPE_CUSTOM. */
+typedef void (* mem_telemetry_usage_get_t)(mem_telemetry_usage_t * p_usage);
+
+/**@brief Entry. Use the registration macros to define one. */
+typedef struct
+{
+    char const              * p_name;    /**< Name, for the log and the peer. */
+    void const              * p_context; /**< Pool, queue, or lowest address of the stack. */
+    uint32_t                  size;      /**< Size of the stack, in bytes. */
+    mem_telemetry_usage_get_t usage_get; /**< Function of a custom entry. */
+    mem_telemetry_type_t      type;      /**< Type. */
+} mem_telemetry_entry_t;
+
+/**@brief Record of an entry. */
+typedef struct
+{
+    char const         * p_name;   /**< Name. */
+    mem_telemetry_type_t type;     /**< Type, which gives the unit. */
+    uint32_t             peak;     /**< Highest use seen. */
+    uint32_t             capacity; /**< Capacity. */
+} mem_telemetry_record_t;
+
+/**@brief Macro for registering an entry. Use the macros of each type instead. */
+#define MEM_TELEMETRY_REGISTER(_name, _type, _p_context, _size, _usage_get)                      \
+    NRF_SECTION_VARS_REGISTER_VAR(mem_telemetry, mem_telemetry_entry_t const _name) =            \
+    {                                                                                            \
+        .p_name    = #_name,                                                                     \
+        .p_context = (_p_context),                                                               \
+        .size      = (_size),                                                                    \
+        .usage_get = (_usage_get),                                                               \
+        .type      = (_type),                                                                    \
+    }
+
+/**@brief Macro for registering a block allocator.
+ *
+ * @param[in] _name   Name of the entry.
+ * @param[in] _p_pool Pool, defined with @ref NRF_BALLOC_DEF.
+ */
+#define MEM_TELEMETRY_BALLOC_REGISTER(_name, _p_pool) \
+    MEM_TELEMETRY_REGISTER(_name, MEM_TELEMETRY_TYPE_BALLOC, (_p_pool), 0, NULL)
+
+/**@brief Macro for registering a queue.
+ *
+ * @param[in] _name    Name of the entry.
+ * @param[in] _p_queue Queue, defined with @ref NRF_QUEUE_DEF.
+ */
+#define MEM_TELEMETRY_QUEUE_REGISTER(_name, _p_queue) \
+    MEM_TELEMETRY_REGISTER(_name, MEM_TELEMETRY_TYPE_QUEUE, (_p_queue), 0, NULL)
+
+/**@brief Macro for registering a stack that grows down, like the stack of an RTOS task.
+ *
+ * @param[in] _name    Name of the entry.
+ * @param[in] _p_stack Lowest address of the stack, word aligned.
+ * @param[in] _size    Size of the stack, in bytes.
+ */
+#define MEM_TELEMETRY_STACK_REGISTER(_name, _p_stack, _size) \
+    MEM_TELEMETRY_REGISTER(_name, MEM_TELEMETRY_TYPE_STACK, (_p_stack), (_size), NULL)
+
+/**@brief Macro for registering another pool.
+ *
+ * @param[in] _name      Name of the entry.
+ * @param[in] _usage_get Function of type @ref mem_telemetry_usage_get_t.
+ */
+#define MEM_TELEMETRY_CUSTOM_REGISTER(_name, _usage_get) \
+    MEM_TELEMETRY_REGISTER(_name, MEM_TELEMETRY_TYPE_CUSTOM, NULL, 0, (_usage_get))
+
+/**@brief Function for painting the main stack, below the current stack pointer, and the
+ *        registered stacks.
+ *
+ * @details Call it first in main, before the registered stacks are used.
+ */
+void mem_telemetry_init(void);
+
+/**@brief Function for getting the number of records, the main stack included.
+ */
+uint32_t mem_telemetry_count(void);
+
+/**@brief Function for getting a record.
+ *
+ * @param[in]  idx      Index of the record, below @ref mem_telemetry_count.
+ * @param[out] p_record Record.
+ *
+ * @retval NRF_SUCCESS             If the record was found.
+ * @retval NRF_ERROR_NULL          If p_record was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If the index was out of range.
+ */
+ret_code_t mem_telemetry_record_get(uint32_t idx, mem_telemetry_record_t * p_record);
+
+/**@brief Function for encoding all records, for a peer.
+ *
+ * @details Each record is: type (1), peak (4), capacity (4), length of the name (1), name,
+ *          little endian. The records that do not fit entirely are left out.
+ *
+ * @param[out] p_buf Buffer.
+ * @param[in]  size  Size of the buffer.
+ *
+ * @return Length of the encoded records.
+ */
+uint32_t mem_telemetry_encode(uint8_t * p_buf, uint32_t size);
+
+/**@brief Function for logging all records.
+ */
+void mem_telemetry_log(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MEM_TELEMETRY_H__
+
+/** @} */
@@ -0,0 +1,16 @@
+/**
+ *
+ * @defgroup mem_telemetry_config Memory telemetry configuration
+ * @{
+ * @ingroup mem_telemetry
+ */
+/** @brief Enabling the memory telemetry module
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define MEM_TELEMETRY_ENABLED
+
+
+/** @} */
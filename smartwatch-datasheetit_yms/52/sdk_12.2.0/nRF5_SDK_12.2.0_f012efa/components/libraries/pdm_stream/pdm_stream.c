@@ -0,0 +1,206 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(PDM_STREAM)
+#include "pdm_stream.h"
+#include "nrf_balloc.h"
+#include "nrf_queue.h"
+#if PDM_STREAM_CONFIG_FIR_ENABLED
+#include "arm_math.h"
+#endif
+
+/**@brief Control block. */
+typedef struct
+{
+    pdm_stream_config_t const * p_config;
+    uint16_t                    hangover_left; /**< Blocks that are passed before the gate closes. */
+    uint32_t volatile           dropped;       /**< Blocks dropped because the pool was empty. */
+#if PDM_STREAM_CONFIG_FIR_ENABLED
+    arm_fir_decimate_instance_q15 fir;
+    q15_t                         fir_state[PDM_STREAM_CONFIG_FIR_MAX_TAPS +
+                                            PDM_STREAM_CONFIG_BLOCK_LENGTH - 1];
+#endif
+} pdm_stream_cb_t;
+
+static pdm_stream_cb_t m_cb;
+
+NRF_BALLOC_DEF(m_pool, PDM_STREAM_CONFIG_BLOCK_LENGTH * sizeof(int16_t), PDM_STREAM_CONFIG_BLOCK_COUNT);
+
+// Filled blocks are pushed from the PDM interrupt and popped by the application only.
+NRF_QUEUE_SPSC_DEF(int16_t *, m_queue, PDM_STREAM_CONFIG_BLOCK_COUNT);
+
+
+static int16_t * buffer_request_handler(void)
+{
+    return (int16_t *)nrf_balloc_alloc(&m_pool);
+}
+
+
+static void pdm_event_handler(uint32_t * p_buffer, uint16_t length)
+{
+    int16_t * p_block = (int16_t *)p_buffer;
+
+    UNUSED_PARAMETER(length);
+
+    if ((p_block == m_cb.p_config->pdm.buffer_a) || (p_block == m_cb.p_config->pdm.buffer_b))
+    {
+        m_cb.dropped++;
+        return;
+    }
+
+    // The queue holds every block of the pool, so it cannot be full.
+    UNUSED_RETURN_VALUE(nrf_queue_push(&m_queue, &p_block));
+
+    if (m_cb.p_config->notify != NULL)
+    {
+        m_cb.p_config->notify();
+    }
+}
+
+
+/**@brief Function for calculating the mean square energy of samples.
+ */
+static uint32_t energy_get(int16_t const * p_samples, uint16_t length)
+{
+    uint64_t sum = 0;
+
+    for (uint16_t i = 0; i < length; i++)
+    {
+        sum += (int32_t)p_samples[i] * p_samples[i];
+    }
+    return (uint32_t)(sum / length);
+}
+
+
+ret_code_t pdm_stream_init(pdm_stream_config_t const * p_config)
+{
+    ret_code_t err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_config);
+    VERIFY_PARAM_NOT_NULL(p_config->pdm.buffer_a);
+    VERIFY_PARAM_NOT_NULL(p_config->pdm.buffer_b);
+
+    if (p_config->pdm.buffer_length != PDM_STREAM_CONFIG_BLOCK_LENGTH)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    memset(&m_cb, 0, sizeof(m_cb));
+    m_cb.p_config = p_config;
+
+#if PDM_STREAM_CONFIG_FIR_ENABLED
+    if (p_config->p_fir_coeffs != NULL)
+    {
+        if ((p_config->pdm.mode != NRF_PDM_MODE_MONO) ||
+            (p_config->fir_taps > PDM_STREAM_CONFIG_FIR_MAX_TAPS))
+        {
+            return NRF_ERROR_INVALID_PARAM;
+        }
+        if (arm_fir_decimate_init_q15(&m_cb.fir,
+                                      p_config->fir_taps,
+                                      p_config->decimation,
+                                      (q15_t *)p_config->p_fir_coeffs,
+                                      m_cb.fir_state,
+                                      PDM_STREAM_CONFIG_BLOCK_LENGTH) != ARM_MATH_SUCCESS)
+        {
+            return NRF_ERROR_INVALID_PARAM;
+        }
+    }
+#endif
+
+    err_code = nrf_balloc_init(&m_pool);
+    VERIFY_SUCCESS(err_code);
+    nrf_queue_reset(&m_queue);
+
+    err_code = nrf_drv_pdm_init(&p_config->pdm, pdm_event_handler);
+    VERIFY_SUCCESS(err_code);
+
+    nrf_drv_pdm_buffer_request_handler_set(buffer_request_handler);
+    return NRF_SUCCESS;
+}
+
+
+void pdm_stream_uninit(void)
+{
+    nrf_drv_pdm_uninit();
+    nrf_drv_pdm_buffer_request_handler_set(NULL);
+}
+
+
+ret_code_t pdm_stream_start(void)
+{
+    return nrf_drv_pdm_start();
+}
+
+
+ret_code_t pdm_stream_stop(void)
+{
+    return nrf_drv_pdm_stop();
+}
+
+
+ret_code_t pdm_stream_block_get(pdm_stream_block_t * p_block)
+{
+    int16_t * p_samples;
+
+    while (nrf_queue_pop(&m_queue, &p_samples) == NRF_SUCCESS)
+    {
+        uint16_t length = PDM_STREAM_CONFIG_BLOCK_LENGTH;
+        uint32_t energy;
+
+#if PDM_STREAM_CONFIG_FIR_ENABLED
+        if (m_cb.p_config->p_fir_coeffs != NULL)
+        {
+            // Each output sample is written after the input samples it replaces have been
+            // copied to the filter state, so the block is filtered in place.
+            arm_fir_decimate_q15(&m_cb.fir, p_samples, p_samples, length);
+            length /= m_cb.p_config->decimation;
+        }
+#endif
+
+        energy = energy_get(p_samples, length);
+        if (energy >= m_cb.p_config->gate_threshold)
+        {
+            m_cb.hangover_left = m_cb.p_config->gate_hangover;
+        }
+        else if (m_cb.hangover_left > 0)
+        {
+            m_cb.hangover_left--;
+        }
+        else
+        {
+            nrf_balloc_free(&m_pool, p_samples);
+            continue;
+        }
+
+        p_block->p_samples = p_samples;
+        p_block->length    = length;
+        p_block->energy    = energy;
+        return NRF_SUCCESS;
+    }
+
+    return NRF_ERROR_NOT_FOUND;
+}
+
+
+void pdm_stream_block_release(pdm_stream_block_t const * p_block)
+{
+    nrf_balloc_free(&m_pool, p_block->p_samples);
+}
+
+
+uint32_t pdm_stream_dropped_get(void)
+{
+    return m_cb.dropped;
+}
+
+#endif // NRF_MODULE_ENABLED(PDM_STREAM)
@@ -0,0 +1,166 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup pdm_stream PDM microphone streaming
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for streaming samples of a PDM microphone without gaps.
+ *
+ * @details The PDM interface is fed with blocks from a pool of the block allocator. The next
+ *          block is handed to the interface from its interrupt as soon as it starts filling a
+ *          block, so the interface never waits for the application. Filled blocks are put in a
+ *          queue and read by the application with @ref pdm_stream_block_get, in its own
+ *          context. There, each block is optionally decimated by a FIR filter of the CMSIS-DSP
+ *          library, and passed through an energy gate that drops blocks without voice. The
+ *          application returns every block to the pool with @ref pdm_stream_block_release.
+ *
+ *          If the pool is empty because the application is too slow, the samples of one block
+ *          are written to the buffers from the PDM driver configuration and dropped, and
+ *          @ref pdm_stream_dropped_get is incremented.
+ *
+ * @note Only mono mode is supported when the FIR filter is enabled.
+ */
+
+#ifndef PDM_STREAM_H__
+#define PDM_STREAM_H__
+
+#include <stdint.h>
+#include "nrf_drv_pdm.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Length of a block, in 16-bit words.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef PDM_STREAM_CONFIG_BLOCK_LENGTH
+#define PDM_STREAM_CONFIG_BLOCK_LENGTH 320
+#endif
+
+/** @brief Number of blocks in the buffer pool.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef PDM_STREAM_CONFIG_BLOCK_COUNT
+#define PDM_STREAM_CONFIG_BLOCK_COUNT 6
+#endif
+
+/** @brief Enables the decimating FIR filter.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef PDM_STREAM_CONFIG_FIR_ENABLED
+#define PDM_STREAM_CONFIG_FIR_ENABLED 0
+#endif
+
+/** @brief Maximum number of taps of the decimating FIR filter.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef PDM_STREAM_CONFIG_FIR_MAX_TAPS
+#define PDM_STREAM_CONFIG_FIR_MAX_TAPS 32
+#endif
+
+/**@brief Handler for notifying the application that a block was queued.
+ *
+ * Called from the PDM interrupt, for example to wake the main loop or to schedule
+ * a task that calls @ref pdm_stream_block_get.
+ */
+typedef void (* pdm_stream_notify_t)(void);
+
+/**@brief Module configuration. */
+typedef struct
+{
+    nrf_drv_pdm_config_t pdm;              /**< PDM driver configuration. The buffer length must be @ref PDM_STREAM_CONFIG_BLOCK_LENGTH. Buffers A and B are only written when the pool is empty. */
+    uint32_t             gate_threshold;   /**< Mean square energy of a block, after filtering, below which the block is dropped. 0 to pass all blocks. */
+    uint16_t             gate_hangover;    /**< Number of blocks that are passed after the last block above the threshold. */
+#if PDM_STREAM_CONFIG_FIR_ENABLED
+    int16_t const *      p_fir_coeffs;     /**< FIR filter coefficients in Q15 format, in time reversed order. NULL to disable the filter. */
+    uint16_t             fir_taps;         /**< Number of FIR filter coefficients, up to @ref PDM_STREAM_CONFIG_FIR_MAX_TAPS. */
+    uint8_t              decimation;       /**< Decimation factor. @ref PDM_STREAM_CONFIG_BLOCK_LENGTH must be a multiple of it. */
+#endif
+    pdm_stream_notify_t  notify;           /**< Handler called when a block was queued, or NULL. */
+} pdm_stream_config_t;
+
+/**@brief Block of samples. */
+typedef struct
+{
+    int16_t * p_samples; /**< Samples, oldest first. */
+    uint16_t  length;    /**< Number of samples, after decimation. */
+    uint32_t  energy;    /**< Mean square energy of the samples. */
+} pdm_stream_block_t;
+
+/**@brief Function for initializing the module and the PDM driver.
+ *
+ * @param[in] p_config Module configuration.
+ *
+ * @retval NRF_SUCCESS             If the module was initialized.
+ * @retval NRF_ERROR_NULL          If a required pointer was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If the configuration was invalid.
+ * @return Any error returned by @ref nrf_drv_pdm_init.
+ */
+ret_code_t pdm_stream_init(pdm_stream_config_t const * p_config);
+
+/**@brief Function for uninitializing the module and the PDM driver.
+ *
+ * @note Blocks that were not released are not valid after this call.
+ */
+void pdm_stream_uninit(void);
+
+/**@brief Function for starting sampling.
+ *
+ * @return Any error returned by @ref nrf_drv_pdm_start.
+ */
+ret_code_t pdm_stream_start(void);
+
+/**@brief Function for stopping sampling. The last block is queued when it has been filled.
+ *
+ * @return Any error returned by @ref nrf_drv_pdm_stop.
+ */
+ret_code_t pdm_stream_stop(void);
+
+/**@brief Function for getting the next block that passed the energy gate.
+ *
+ * @details Blocks are filtered and tested in this function, so it must not be called from an
+ *          interrupt of higher priority than the PDM interrupt. Blocks that do not pass the
+ *          gate are returned to the pool.
+ *
+ * @param[out] p_block Block. Must be released with @ref pdm_stream_block_release.
+ *
+ * @retval NRF_SUCCESS         If a block was returned.
+ * @retval NRF_ERROR_NOT_FOUND If no block is available.
+ */
+ret_code_t pdm_stream_block_get(pdm_stream_block_t * p_block);
+
+/**@brief Function for returning a block to the pool.
+ *
+ * @param[in] p_block Block returned by @ref pdm_stream_block_get.
+ */
+void pdm_stream_block_release(pdm_stream_block_t const * p_block);
+
+/**@brief Function for getting the number of blocks that were dropped because the pool was empty.
+ */
+uint32_t pdm_stream_dropped_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PDM_STREAM_H__
+
+/** @} */
@@ -0,0 +1,46 @@
+/**
+ *
+ * @defgroup pdm_stream_config pdm_stream module configuration
+ * @{
+ * @ingroup pdm_stream
+ */
+/** @brief Enabling pdm_stream module
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PDM_STREAM_ENABLED
+
+/** @brief Length of a block, in 16-bit words.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PDM_STREAM_CONFIG_BLOCK_LENGTH
+
+/** @brief Number of blocks in the buffer pool.
+ *
+ *  Two blocks are held by the PDM interface while it is running.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PDM_STREAM_CONFIG_BLOCK_COUNT
+
+/** @brief Enables the decimating FIR filter.
+ *
+ *  The CMSIS-DSP library must be linked with the application.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PDM_STREAM_CONFIG_FIR_ENABLED
+
+/** @brief Maximum number of taps of the decimating FIR filter.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PDM_STREAM_CONFIG_FIR_MAX_TAPS
+
+
+/** @} */
@@ -27,6 +27,16 @@
 #define APP_PWM_CHANNEL_ENABLED                    1
 #define APP_PWM_CHANNEL_DISABLED                   0
 
+#define UNALLOCATED                                0xFFFFFFFFUL
+
+// Macros for getting the polarity of given instance/channel.
+#define POLARITY_ACTIVE(INST,CH)   (( ((INST)->p_cb)->channels_cb[(CH)].polarity == \
+                 APP_PWM_POLARITY_ACTIVE_LOW)?(0):(1))
+#define POLARITY_INACTIVE(INST,CH) (( ((INST)->p_cb)->channels_cb[(CH)].polarity == \
+                 APP_PWM_POLARITY_ACTIVE_LOW)?(1):(0))
+
+#if !APP_PWM_CONFIG_PWM_PERIPHERAL
+
 #define TIMER_PRESCALER_MAX                        9
 #define TIMER_MAX_PULSEWIDTH_US_ON_16M             4095
 
@@ -35,7 +45,6 @@
 #endif
 #define APP_PWM_REQUIRED_PPI_CHANNELS_PER_CHANNEL  2
 
-#define UNALLOCATED                                0xFFFFFFFFUL
 #define BUSY_STATE_CHANGING                        0xFE
 #define BUSY_STATE_IDLE                            0xFF
 
@@ -81,12 +90,6 @@ volatile uint8_t m_pwm_ready_counter[TIMER_COUNT][APP_PWM_CHANNELS_PER_INSTANCE]
  */
 static const app_pwm_t * m_instances[TIMER_COUNT];
 
-// Macros for getting the polarity of given instance/channel.
-#define POLARITY_ACTIVE(INST,CH)   (( ((INST)->p_cb)->channels_cb[(CH)].polarity == \
-                 APP_PWM_POLARITY_ACTIVE_LOW)?(0):(1))
-#define POLARITY_INACTIVE(INST,CH) (( ((INST)->p_cb)->channels_cb[(CH)].polarity == \
-                 APP_PWM_POLARITY_ACTIVE_LOW)?(1):(0))
-
 //lint -save -e534
 
 
@@ -608,35 +611,24 @@ ret_code_t app_pwm_channel_duty_ticks_set(app_pwm_t const * const p_instance,
     return NRF_SUCCESS;
 }
 
-uint16_t app_pwm_channel_duty_ticks_get(app_pwm_t const * const p_instance, uint8_t channel)
-{
-    app_pwm_cb_t         * p_cb      = p_instance->p_cb;
-    app_pwm_channel_cb_t * p_ch_cb   = &p_cb->channels_cb[channel];
-
-    return p_ch_cb->pulsewidth;
-}
-
-uint16_t app_pwm_cycle_ticks_get(app_pwm_t const * const p_instance)
+ret_code_t app_pwm_channels_duty_ticks_set(app_pwm_t const * const p_instance,
+                                           uint16_t const *  p_ticks)
 {
     app_pwm_cb_t * p_cb = p_instance->p_cb;
+    ret_code_t     err_code;
 
-    return (uint16_t)p_cb->period;
-}
-
-ret_code_t app_pwm_channel_duty_set(app_pwm_t const * const p_instance,
-                                  uint8_t channel, app_pwm_duty_t duty)
-{
-    uint32_t ticks = ((uint32_t)app_pwm_cycle_ticks_get(p_instance) * (uint32_t)duty) / 100UL;
-    return app_pwm_channel_duty_ticks_set(p_instance, channel, ticks);
-}
-
+    ASSERT(p_ticks != NULL);
 
-app_pwm_duty_t app_pwm_channel_duty_get(app_pwm_t const * const p_instance, uint8_t channel)
-{
-    uint32_t value = ((uint32_t)app_pwm_channel_duty_ticks_get(p_instance, channel) * 100UL) \
-                     / (uint32_t)app_pwm_cycle_ticks_get(p_instance);
-
-    return (app_pwm_duty_t)value;
+    // Every channel change has its own transition, which uses the synchronization resources.
+    for (uint8_t channel = 0; channel < APP_PWM_CHANNELS_PER_INSTANCE; ++channel)
+    {
+        if (p_cb->channels_cb[channel].initialized == APP_PWM_CHANNEL_INITIALIZED)
+        {
+            err_code = app_pwm_channel_duty_ticks_set(p_instance, channel, p_ticks[channel]);
+            VERIFY_SUCCESS(err_code);
+        }
+    }
+    return NRF_SUCCESS;
 }
 
 
@@ -977,6 +969,318 @@ ret_code_t app_pwm_uninit(app_pwm_t const * const p_instance)
     return NRF_SUCCESS;
 }
 
+#else // APP_PWM_CONFIG_PWM_PERIPHERAL
+
+#define PWM_TOP_VALUE_MAX                          0x7FFF
+#define PWM_VALUE_FALLING_EDGE                     0x8000
+
+
+/**
+ * @brief Function for calculating the base clock of the PWM peripheral, which will allow to set given period length.
+ *
+ * @param[in]  period_us       Desired period in microseconds.
+ * @param[out] p_ticks         Period in ticks of the base clock.
+ *
+ * @retval    Base clock.
+ */
+__STATIC_INLINE nrf_pwm_clk_t pwm_calculate_base_clock(uint32_t period_us, uint32_t * p_ticks)
+{
+    uint32_t clk   = (uint32_t) NRF_PWM_CLK_16MHz;
+    uint32_t ticks = period_us * 16;
+
+    while ((ticks > PWM_TOP_VALUE_MAX) && (clk < (uint32_t) NRF_PWM_CLK_125kHz))
+    {
+        ticks >>= 1;
+        ++clk;
+    }
+
+    *p_ticks = ticks;
+    return (nrf_pwm_clk_t) clk;
+}
+
+
+/**
+ * @brief Function for getting the value read by the PWM peripheral for a duty cycle.
+ *
+ * The output is active during the first ticks of the period, as with a timer.
+ *
+ * @param[in] p_ch_cb          PWM channel.
+ * @param[in] ticks            Number of clock ticks.
+ */
+__STATIC_INLINE uint16_t pwm_value(app_pwm_channel_cb_t const * p_ch_cb, uint16_t ticks)
+{
+    return (p_ch_cb->polarity == APP_PWM_POLARITY_ACTIVE_HIGH) ? (ticks | PWM_VALUE_FALLING_EDGE)
+                                                                : ticks;
+}
+
+
+bool app_pwm_busy_check(app_pwm_t const * const p_instance)
+{
+    // The PWM peripheral takes new duty cycles at any time.
+    UNUSED_PARAMETER(p_instance);
+    return false;
+}
+
+
+ret_code_t app_pwm_channels_duty_ticks_set(app_pwm_t const * const p_instance,
+                                           uint16_t const *  p_ticks)
+{
+    app_pwm_cb_t * p_cb   = p_instance->p_cb;
+    uint8_t        idx    = p_cb->values_idx ^ 1;
+    uint16_t     * values = (uint16_t *)&p_cb->values[idx];
+
+    ASSERT(p_ticks != NULL);
+
+    if (p_cb->state == NRF_DRV_STATE_UNINITIALIZED)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    // The duty cycles of all channels are written to the buffer that is not played, which is then
+    // given to the peripheral at once. It is read at the start of the next period.
+    for (uint8_t channel = 0; channel < APP_PWM_CHANNELS_PER_INSTANCE; ++channel)
+    {
+        app_pwm_channel_cb_t * p_ch_cb = &p_cb->channels_cb[channel];
+        uint16_t               ticks   = MIN(p_ticks[channel], p_cb->period);
+
+        if (p_ch_cb->initialized == APP_PWM_CHANNEL_INITIALIZED)
+        {
+            p_ch_cb->pulsewidth = ticks;
+        }
+        values[channel] = pwm_value(p_ch_cb, p_ch_cb->pulsewidth);
+    }
+    nrf_pwm_seq_ptr_set(p_instance->p_pwm->p_registers, 0, values);
+    nrf_pwm_seq_ptr_set(p_instance->p_pwm->p_registers, 1, values);
+    p_cb->values_idx = idx;
+
+    if (p_cb->p_ready_callback)
+    {
+        p_cb->p_ready_callback(p_instance->p_pwm->drv_inst_idx);
+    }
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t app_pwm_channel_duty_ticks_set(app_pwm_t const * const p_instance,
+                                          uint8_t           channel,
+                                          uint16_t          ticks)
+{
+    app_pwm_cb_t * p_cb = p_instance->p_cb;
+    uint16_t       channels_ticks[APP_PWM_CHANNELS_PER_INSTANCE];
+
+    ASSERT(channel < APP_PWM_CHANNELS_PER_INSTANCE);
+    ASSERT(p_cb->channels_cb[channel].initialized == APP_PWM_CHANNEL_INITIALIZED);
+
+    for (uint8_t i = 0; i < APP_PWM_CHANNELS_PER_INSTANCE; ++i)
+    {
+        channels_ticks[i] = (uint16_t)p_cb->channels_cb[i].pulsewidth;
+    }
+    channels_ticks[channel] = ticks;
+
+    return app_pwm_channels_duty_ticks_set(p_instance, channels_ticks);
+}
+
+
+ret_code_t app_pwm_init(app_pwm_t const * const p_instance, app_pwm_config_t const * const p_config,
+                        app_pwm_callback_t p_ready_callback)
+{
+    ASSERT(p_instance);
+
+    if (!p_config)
+    {
+        return NRF_ERROR_INVALID_DATA;
+    }
+
+    app_pwm_cb_t * p_cb = p_instance->p_cb;
+
+    if (p_cb->state != NRF_DRV_STATE_UNINITIALIZED)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    uint32_t             ticks;
+    nrf_drv_pwm_config_t pwm_cfg = {
+        .irq_priority = APP_IRQ_PRIORITY_LOWEST,
+        .count_mode   = NRF_PWM_MODE_UP,
+        .load_mode    = NRF_PWM_LOAD_INDIVIDUAL,
+        .step_mode    = NRF_PWM_STEP_AUTO
+    };
+
+    pwm_cfg.base_clock = pwm_calculate_base_clock(p_config->period_us, &ticks);
+    if ((ticks == 0) || (ticks > PWM_TOP_VALUE_MAX))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    pwm_cfg.top_value = (uint16_t)ticks;
+
+    for (uint8_t i = 0; i < APP_PWM_CHANNELS_PER_INSTANCE; ++i)
+    {
+        app_pwm_channel_cb_t * p_ch_cb = &p_cb->channels_cb[i];
+
+        p_ch_cb->pulsewidth = 0;
+        p_ch_cb->polarity   = p_config->pin_polarity[i];
+        if (p_config->pins[i] != APP_PWM_NOPIN)
+        {
+            // The pin is left in the inactive state when the peripheral does not play.
+            pwm_cfg.output_pins[i] = (uint8_t)p_config->pins[i] |
+                ((p_ch_cb->polarity == APP_PWM_POLARITY_ACTIVE_LOW) ? NRF_DRV_PWM_PIN_INVERTED : 0);
+            p_ch_cb->gpio_pin      = p_config->pins[i];
+            p_ch_cb->initialized   = APP_PWM_CHANNEL_INITIALIZED;
+        }
+        else
+        {
+            pwm_cfg.output_pins[i] = NRF_DRV_PWM_PIN_NOT_USED;
+            p_ch_cb->gpio_pin      = UNALLOCATED;
+            p_ch_cb->initialized   = APP_PWM_CHANNEL_UNINITIALIZED;
+        }
+    }
+
+    // No interrupts are used.
+    if (nrf_drv_pwm_init(p_instance->p_pwm, &pwm_cfg, NULL) != NRF_SUCCESS)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    memset(p_cb->values, 0, sizeof(p_cb->values));
+    p_cb->values_idx       = 0;
+    p_cb->period           = ticks;
+    p_cb->p_ready_callback = p_ready_callback;
+    p_cb->state            = NRF_DRV_STATE_INITIALIZED;
+
+    return NRF_SUCCESS;
+}
+
+
+void app_pwm_enable(app_pwm_t const * const p_instance)
+{
+    app_pwm_cb_t * p_cb   = p_instance->p_cb;
+    uint16_t     * values = (uint16_t *)&p_cb->values[p_cb->values_idx];
+
+    ASSERT(p_cb->state != NRF_DRV_STATE_UNINITIALIZED);
+
+    for (uint8_t channel = 0; channel < APP_PWM_CHANNELS_PER_INSTANCE; ++channel)
+    {
+        p_cb->channels_cb[channel].pulsewidth = 0;
+        values[channel] = pwm_value(&p_cb->channels_cb[channel], 0);
+    }
+
+    nrf_pwm_sequence_t const seq =
+    {
+        .values.p_individual = &p_cb->values[p_cb->values_idx],
+        .length              = NRF_PWM_VALUES_LENGTH(p_cb->values[0]),
+        .repeats             = 0,
+        .end_delay           = 0
+    };
+    nrf_drv_pwm_simple_playback(p_instance->p_pwm, &seq, 1, NRF_DRV_PWM_FLAG_LOOP);
+
+    p_cb->state = NRF_DRV_STATE_POWERED_ON;
+    return;
+}
+
+
+void app_pwm_disable(app_pwm_t const * const p_instance)
+{
+    app_pwm_cb_t * p_cb = p_instance->p_cb;
+
+    ASSERT(p_cb->state != NRF_DRV_STATE_UNINITIALIZED);
+
+    (void)nrf_drv_pwm_stop(p_instance->p_pwm, true);
+
+    // Pins are driven by the GPIO when the peripheral does not play.
+    for (uint8_t channel = 0; channel < APP_PWM_CHANNELS_PER_INSTANCE; ++channel)
+    {
+        app_pwm_channel_cb_t * p_ch_cb = &p_cb->channels_cb[channel];
+        if (p_ch_cb->initialized)
+        {
+            if (POLARITY_INACTIVE(p_instance, channel))
+            {
+                nrf_gpio_pin_set(p_ch_cb->gpio_pin);
+            }
+            else
+            {
+                nrf_gpio_pin_clear(p_ch_cb->gpio_pin);
+            }
+        }
+    }
+
+    p_cb->state = NRF_DRV_STATE_INITIALIZED;
+    return;
+}
+
+
+ret_code_t app_pwm_uninit(app_pwm_t const * const p_instance)
+{
+    app_pwm_cb_t * p_cb = p_instance->p_cb;
+
+    if (p_cb->state == NRF_DRV_STATE_POWERED_ON)
+    {
+        app_pwm_disable(p_instance);
+    }
+    else if (p_cb->state == NRF_DRV_STATE_UNINITIALIZED)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    nrf_drv_pwm_uninit(p_instance->p_pwm);
+
+    for (uint8_t channel = 0; channel < APP_PWM_CHANNELS_PER_INSTANCE; ++channel)
+    {
+        p_cb->channels_cb[channel].initialized = APP_PWM_CHANNEL_UNINITIALIZED;
+    }
+
+    p_cb->state = NRF_DRV_STATE_UNINITIALIZED;
+    return NRF_SUCCESS;
+}
+
+#endif // APP_PWM_CONFIG_PWM_PERIPHERAL
+
+
+uint16_t app_pwm_channel_duty_ticks_get(app_pwm_t const * const p_instance, uint8_t channel)
+{
+    app_pwm_cb_t         * p_cb      = p_instance->p_cb;
+    app_pwm_channel_cb_t * p_ch_cb   = &p_cb->channels_cb[channel];
+
+    return p_ch_cb->pulsewidth;
+}
+
+uint16_t app_pwm_cycle_ticks_get(app_pwm_t const * const p_instance)
+{
+    app_pwm_cb_t * p_cb = p_instance->p_cb;
+
+    return (uint16_t)p_cb->period;
+}
+
+ret_code_t app_pwm_channel_duty_set(app_pwm_t const * const p_instance,
+                                  uint8_t channel, app_pwm_duty_t duty)
+{
+    uint32_t ticks = ((uint32_t)app_pwm_cycle_ticks_get(p_instance) * (uint32_t)duty) / 100UL;
+    return app_pwm_channel_duty_ticks_set(p_instance, channel, ticks);
+}
+
+
+app_pwm_duty_t app_pwm_channel_duty_get(app_pwm_t const * const p_instance, uint8_t channel)
+{
+    uint32_t value = ((uint32_t)app_pwm_channel_duty_ticks_get(p_instance, channel) * 100UL) \
+                     / (uint32_t)app_pwm_cycle_ticks_get(p_instance);
+
+    return (app_pwm_duty_t)value;
+}
+
+
+ret_code_t app_pwm_channels_duty_set(app_pwm_t const * const p_instance,
+                                     app_pwm_duty_t const * p_duty)
+{
+    uint16_t ticks[APP_PWM_CHANNELS_PER_INSTANCE];
+    uint32_t cycle = app_pwm_cycle_ticks_get(p_instance);
+
+    ASSERT(p_duty != NULL);
+
+    for (uint8_t channel = 0; channel < APP_PWM_CHANNELS_PER_INSTANCE; ++channel)
+    {
+        ticks[channel] = (uint16_t)((cycle * (uint32_t)p_duty[channel]) / 100UL);
+    }
+    return app_pwm_channels_duty_ticks_set(p_instance, ticks);
+}
+
 
 //lint -restore
 #endif //NRF_MODULE_ENABLED(APP_PWM)
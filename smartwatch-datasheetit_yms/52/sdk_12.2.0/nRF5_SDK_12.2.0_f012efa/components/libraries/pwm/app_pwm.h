@@ -28,6 +28,11 @@
  * For example, a PWM instance with two channels will consume 2 + 4 PPI channels, 1 PPI group, and 2 GPIOTE channels.
  *
  * The maximum number of PWM channels per instance is 2.
+ *
+ * On nRF52, the PWM peripheral can be used instead, with the same API (see
+ * @ref APP_PWM_CONFIG_PWM_PERIPHERAL). An instance then uses one PWM peripheral and no TIMER,
+ * PPI, or GPIOTE resources, has up to 4 channels, and duty cycle changes are never busy:
+ * the new duty cycles of all channels are taken by the peripheral at the next period boundary.
  */
 
 #ifndef APP_PWM_H__
@@ -40,6 +45,20 @@
 #include "nrf_drv_ppi.h"
 #include "nrf_peripherals.h"
 
+/** @brief Use the PWM peripheral instead of a TIMER, PPI, and GPIOTE (nRF52 only).
+ *
+ * The number in @ref APP_PWM_INSTANCE is then the number of the PWM peripheral.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef APP_PWM_CONFIG_PWM_PERIPHERAL
+#define APP_PWM_CONFIG_PWM_PERIPHERAL 0
+#endif
+
+#if APP_PWM_CONFIG_PWM_PERIPHERAL
+#include "nrf_drv_pwm.h"
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -50,6 +69,24 @@ extern "C" {
 
 #define APP_PWM_NOPIN                 0xFFFFFFFF
 
+#if APP_PWM_CONFIG_PWM_PERIPHERAL
+/** @brief Number of channels for one PWM peripheral instance. */
+#define APP_PWM_CHANNELS_PER_INSTANCE NRF_PWM_CHANNEL_COUNT
+
+/**@brief Macro for creating a PWM instance. */
+#define APP_PWM_INSTANCE(name, num)                                     \
+    const nrf_drv_pwm_t m_pwm_##name##_pwm = NRF_DRV_PWM_INSTANCE(num); \
+    app_pwm_cb_t m_pwm_##name##_cb;                                     \
+    /*lint -e{545}*/                                                    \
+    const app_pwm_t name = {                                            \
+        .p_cb  = &m_pwm_##name##_cb,                                    \
+        .p_pwm = &m_pwm_##name##_pwm,                                   \
+    }
+
+/** @brief Pins and polarities of the channels that are not used by the default configurations. */
+#define APP_PWM_UNUSED_PINS       APP_PWM_NOPIN, APP_PWM_NOPIN
+#define APP_PWM_UNUSED_POLARITIES APP_PWM_POLARITY_ACTIVE_LOW, APP_PWM_POLARITY_ACTIVE_LOW
+#else
 /** @brief Number of channels for one timer instance (fixed to 2 due to timer properties).*/
 #define APP_PWM_CHANNELS_PER_INSTANCE 2
 
@@ -63,12 +100,17 @@ extern "C" {
         .p_timer = &m_pwm_##name##_timer,                                     \
     }
 
+#define APP_PWM_UNUSED_PINS
+#define APP_PWM_UNUSED_POLARITIES
+#endif // APP_PWM_CONFIG_PWM_PERIPHERAL
+
 
 /**@brief PWM instance default configuration (1 channel). */
 #define APP_PWM_DEFAULT_CONFIG_1CH(period_in_us, pin)                                  \
     {                                                                                  \
-        .pins            = {pin, APP_PWM_NOPIN},                                       \
-        .pin_polarity    = {APP_PWM_POLARITY_ACTIVE_LOW, APP_PWM_POLARITY_ACTIVE_LOW}, \
+        .pins            = {pin, APP_PWM_NOPIN, APP_PWM_UNUSED_PINS},                  \
+        .pin_polarity    = {APP_PWM_POLARITY_ACTIVE_LOW, APP_PWM_POLARITY_ACTIVE_LOW,  \
+                            APP_PWM_UNUSED_POLARITIES},                                \
         .num_of_channels = 1,                                                          \
         .period_us       = period_in_us                                                \
     }
@@ -76,12 +118,25 @@ extern "C" {
 /**@brief PWM instance default configuration (2 channels). */
 #define APP_PWM_DEFAULT_CONFIG_2CH(period_in_us, pin0, pin1)                           \
     {                                                                                  \
-        .pins            = {pin0, pin1},                                               \
-        .pin_polarity    = {APP_PWM_POLARITY_ACTIVE_LOW, APP_PWM_POLARITY_ACTIVE_LOW}, \
+        .pins            = {pin0, pin1, APP_PWM_UNUSED_PINS},                          \
+        .pin_polarity    = {APP_PWM_POLARITY_ACTIVE_LOW, APP_PWM_POLARITY_ACTIVE_LOW,  \
+                            APP_PWM_UNUSED_POLARITIES},                                \
         .num_of_channels = 2,                                                          \
         .period_us       = period_in_us                                                \
     }
 
+#if APP_PWM_CONFIG_PWM_PERIPHERAL
+/**@brief PWM instance default configuration (4 channels). */
+#define APP_PWM_DEFAULT_CONFIG_4CH(period_in_us, pin0, pin1, pin2, pin3)               \
+    {                                                                                  \
+        .pins            = {pin0, pin1, pin2, pin3},                                   \
+        .pin_polarity    = {APP_PWM_POLARITY_ACTIVE_LOW, APP_PWM_POLARITY_ACTIVE_LOW,  \
+                            APP_PWM_POLARITY_ACTIVE_LOW, APP_PWM_POLARITY_ACTIVE_LOW}, \
+        .num_of_channels = 4,                                                          \
+        .period_us       = period_in_us                                                \
+    }
+#endif
+
 typedef uint16_t app_pwm_duty_t;
 
 /**
@@ -133,7 +188,9 @@ typedef struct
     {
         uint32_t           gpio_pin;        //!< Pin that is used by this PWM channel.
         uint32_t           pulsewidth;      //!< The copy of duty currently set (in ticks).
+#if !APP_PWM_CONFIG_PWM_PERIPHERAL
         nrf_ppi_channel_t  ppi_channels[2]; //!< PPI channels used by the PWM channel to clear and set the output.
+#endif
         app_pwm_polarity_t polarity;        //!< The active state of the pin.
         uint8_t            initialized;     //!< The internal information if the selected channel was initialized.
     } app_pwm_channel_cb_t;
@@ -148,7 +205,10 @@ typedef struct
         app_pwm_channel_cb_t    channels_cb[APP_PWM_CHANNELS_PER_INSTANCE]; //!< Channels data
         uint32_t                period;                                     //!< Selected period in ticks
         app_pwm_callback_t      p_ready_callback;                           //!< Callback function called on PWM readiness
-#ifdef GPIOTE_SET_CLEAR_TASKS
+#if APP_PWM_CONFIG_PWM_PERIPHERAL
+        nrf_pwm_values_individual_t values[2];                              //!< Duty cycles read by the PWM peripheral, double-buffered
+        uint8_t                 values_idx;                                 //!< Buffer of duty cycles being played
+#elif defined(GPIOTE_SET_CLEAR_TASKS)
         nrf_ppi_channel_t       ppi_channel;                               //!< PPI channel used temporary while changing duty
 #else
         nrf_ppi_channel_t       ppi_channels[2];                            //!< PPI channels used temporary while changing duty
@@ -165,7 +225,11 @@ typedef struct
 typedef struct
 {
     app_pwm_cb_t *p_cb;                    //!< Pointer to control block internals.
+#if APP_PWM_CONFIG_PWM_PERIPHERAL
+    nrf_drv_pwm_t const * const p_pwm;     //!< PWM peripheral used by this PWM instance.
+#else
     nrf_drv_timer_t const * const p_timer; //!< Timer used by this PWM instance.
+#endif
 } app_pwm_t;
 
 /**
@@ -238,6 +302,24 @@ void app_pwm_disable(app_pwm_t const * const p_instance);
 ret_code_t app_pwm_channel_duty_set(app_pwm_t const * const p_instance,
                                   uint8_t channel, app_pwm_duty_t duty);
 
+/**
+ * @brief Function for setting the duty cycles of all channels of a PWM instance in percents.
+ *
+ * With the PWM peripheral, all channels change at the same period boundary, without glitches.
+ * With a TIMER, the channels are changed one after the other, and NRF_ERROR_BUSY is returned
+ * if a change is still in progress when the next channel is changed.
+ *
+ * @param[in] p_instance  PWM instance.
+ * @param[in] p_duty      Duty cycles (0 - 100), one per channel. Values of the channels that
+ *                        are not used are ignored.
+ *
+ * @retval    NRF_SUCCESS If the operation was successful.
+ * @retval    NRF_ERROR_BUSY If the PWM is not ready yet.
+ * @retval    NRF_ERROR_INVALID_STATE If the given instance was not initialized.
+ */
+ret_code_t app_pwm_channels_duty_set(app_pwm_t const * const p_instance,
+                                     app_pwm_duty_t const * p_duty);
+
 /**
  * @brief Function for retrieving the PWM channel duty cycle in percents.
  *
@@ -276,6 +358,22 @@ app_pwm_duty_t app_pwm_channel_duty_get(app_pwm_t const * const p_instance, uint
                                               uint16_t          ticks);
 
 
+    /**
+     * @brief Function for setting the duty cycles of all channels of a PWM instance in clock ticks.
+     *
+     * @sa app_pwm_channels_duty_set
+     *
+     * @param[in] p_instance  PWM instance.
+     * @param[in] p_ticks     Numbers of PWM clock ticks, one per channel.
+     *
+     * @retval    NRF_SUCCESS If the operation was successful.
+     * @retval    NRF_ERROR_BUSY If PWM is not ready yet.
+     * @retval    NRF_ERROR_INVALID_STATE If the given instance was not initialized.
+     */
+    ret_code_t app_pwm_channels_duty_ticks_set(app_pwm_t const * const p_instance,
+                                               uint16_t const *  p_ticks);
+
+
     /**
      * @brief Function for retrieving the PWM channel duty cycle in ticks.
      *
@@ -12,5 +12,11 @@
  */
 #define APP_PWM_ENABLED
 
+/** @brief Use the PWM peripheral instead of a TIMER, PPI, and GPIOTE (nRF52 only)
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define APP_PWM_CONFIG_PWM_PERIPHERAL
+
 
 /** @} */
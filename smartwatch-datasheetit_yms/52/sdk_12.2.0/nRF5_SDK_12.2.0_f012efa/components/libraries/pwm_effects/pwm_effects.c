@@ -0,0 +1,277 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(PWM_EFFECTS)
+#include "pwm_effects.h"
+#include "nrf_assert.h"
+
+#define POLARITY_ACTIVE_HIGH 0x8000 /**< Duty cycle value flag for outputs that are high for the duty cycle. */
+#define CLOCK_UNITS_PER_MS   16000  /**< Cycles of the 16 MHz clock in one millisecond. */
+
+/**@brief Control block. */
+typedef struct
+{
+    pwm_effects_config_t const * p_config;
+    uint32_t                     repeats;      /**< Repeats of each step, in PWM periods. */
+    uint8_t                      end_level;    /**< Level at the end of the effect that is playing. */
+    bool volatile                playing_once; /**< An effect that is not looped is playing. */
+} pwm_effects_cb_t;
+
+static pwm_effects_cb_t m_cb;
+
+
+/**@brief Function for getting the duty cycle value of a channel for a level.
+ */
+static uint16_t duty_get(uint8_t channel, uint8_t level)
+{
+    pwm_effects_config_t const * p_config = m_cb.p_config;
+    uint16_t                     value;
+
+    value = (uint16_t)(((uint32_t)level * p_config->top_value) / PWM_EFFECTS_LEVEL_MAX);
+    if ((p_config->output_pins[channel] & NRF_DRV_PWM_PIN_INVERTED) == 0)
+    {
+        value |= POLARITY_ACTIVE_HIGH;
+    }
+    return value;
+}
+
+
+static void step_set(uint16_t step, uint8_t channel_mask, uint8_t level)
+{
+    nrf_pwm_values_individual_t * p_step = &m_cb.p_config->p_table[step];
+
+    p_step->channel_0 = duty_get(0, (channel_mask & (1 << 0)) ? level : 0);
+    p_step->channel_1 = duty_get(1, (channel_mask & (1 << 1)) ? level : 0);
+    p_step->channel_2 = duty_get(2, (channel_mask & (1 << 2)) ? level : 0);
+    p_step->channel_3 = duty_get(3, (channel_mask & (1 << 3)) ? level : 0);
+}
+
+
+static uint16_t segment_steps(pwm_effects_segment_t const * p_segment)
+{
+    uint16_t steps = p_segment->time_ms / m_cb.p_config->step_ms;
+
+    return (steps == 0) ? 1 : steps;
+}
+
+
+/**@brief Function for stopping the playback, so that the sequence table can be written.
+ */
+static void playback_stop(void)
+{
+    m_cb.playing_once = false;
+    UNUSED_RETURN_VALUE(nrf_drv_pwm_stop(m_cb.p_config->p_pwm, true));
+}
+
+
+static void playback_start(uint16_t steps, bool loop)
+{
+    nrf_pwm_sequence_t const seq =
+    {
+        .values.p_individual = m_cb.p_config->p_table,
+        .length              = steps * (sizeof(nrf_pwm_values_individual_t) / sizeof(uint16_t)),
+        .repeats             = m_cb.repeats,
+        .end_delay           = 0
+    };
+
+    if (loop)
+    {
+        nrf_drv_pwm_simple_playback(m_cb.p_config->p_pwm, &seq, 1,
+                                    NRF_DRV_PWM_FLAG_LOOP | NRF_DRV_PWM_FLAG_NO_EVT_FINISHED);
+    }
+    else
+    {
+        m_cb.playing_once = true;
+        nrf_drv_pwm_simple_playback(m_cb.p_config->p_pwm, &seq, 1, 0);
+    }
+}
+
+
+static void pwm_handler(nrf_drv_pwm_evt_type_t event_type)
+{
+    if (!m_cb.playing_once)
+    {
+        return;
+    }
+
+    if (event_type == NRF_DRV_PWM_EVT_FINISHED)
+    {
+        // The peripheral holds the last step. It is stopped if the channels are off.
+        if (m_cb.end_level == 0)
+        {
+            UNUSED_RETURN_VALUE(nrf_drv_pwm_stop(m_cb.p_config->p_pwm, false));
+            return;
+        }
+    }
+    else if (event_type != NRF_DRV_PWM_EVT_STOPPED)
+    {
+        return;
+    }
+
+    m_cb.playing_once = false;
+    if (m_cb.p_config->evt_handler != NULL)
+    {
+        m_cb.p_config->evt_handler();
+    }
+}
+
+
+ret_code_t pwm_effects_init(pwm_effects_config_t const * p_config)
+{
+    uint32_t period;
+    uint32_t step;
+
+    VERIFY_PARAM_NOT_NULL(p_config);
+    VERIFY_PARAM_NOT_NULL(p_config->p_pwm);
+    VERIFY_PARAM_NOT_NULL(p_config->p_table);
+
+    period = (uint32_t)p_config->top_value << p_config->base_clock;
+    step   = (uint32_t)p_config->step_ms * CLOCK_UNITS_PER_MS;
+    if ((p_config->top_value == 0) || (p_config->table_length == 0) ||
+        (step == 0) || ((step % period) != 0))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    nrf_drv_pwm_config_t const pwm_config =
+    {
+        .output_pins  = {p_config->output_pins[0],
+                         p_config->output_pins[1],
+                         p_config->output_pins[2],
+                         p_config->output_pins[3]},
+        .irq_priority = p_config->irq_priority,
+        .base_clock   = p_config->base_clock,
+        .count_mode   = NRF_PWM_MODE_UP,
+        .top_value    = p_config->top_value,
+        .load_mode    = NRF_PWM_LOAD_INDIVIDUAL,
+        .step_mode    = NRF_PWM_STEP_AUTO
+    };
+
+    m_cb.p_config     = p_config;
+    m_cb.repeats      = (step / period) - 1;
+    m_cb.end_level    = 0;
+    m_cb.playing_once = false;
+
+    return nrf_drv_pwm_init(p_config->p_pwm, &pwm_config, pwm_handler);
+}
+
+
+void pwm_effects_uninit(void)
+{
+    playback_stop();
+    nrf_drv_pwm_uninit(m_cb.p_config->p_pwm);
+}
+
+
+ret_code_t pwm_effects_play(uint8_t                       channel_mask,
+                            pwm_effects_segment_t const * p_segments,
+                            uint16_t                      count,
+                            bool                          loop)
+{
+    uint32_t total = 0;
+    uint16_t step  = 0;
+    uint8_t  level;
+
+    ASSERT(m_cb.p_config);
+
+    if ((p_segments == NULL) || (count == 0))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        total += segment_steps(&p_segments[i]);
+    }
+    if (total > m_cb.p_config->table_length)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    playback_stop();
+
+    level = p_segments[count - 1].level;
+    for (uint16_t i = 0; i < count; i++)
+    {
+        uint16_t steps  = segment_steps(&p_segments[i]);
+        int32_t  delta  = (int32_t)p_segments[i].level - level;
+
+        for (uint16_t s = 1; s <= steps; s++)
+        {
+            step_set(step++, channel_mask, (uint8_t)(level + ((delta * s) / steps)));
+        }
+        level = p_segments[i].level;
+    }
+
+    m_cb.end_level = (channel_mask != 0) ? level : 0;
+    playback_start(step, loop);
+    return NRF_SUCCESS;
+}
+
+
+void pwm_effects_level_set(uint8_t channel_mask, uint8_t level)
+{
+    ASSERT(m_cb.p_config);
+
+    playback_stop();
+    step_set(0, channel_mask, level);
+    m_cb.end_level = level;
+    playback_start(1, true);
+}
+
+
+ret_code_t pwm_effects_fade(uint8_t channel_mask, uint8_t from, uint8_t to, uint16_t time_ms)
+{
+    pwm_effects_segment_t const segments[] =
+    {
+        {.level = from, .time_ms = 0},
+        {.level = to,   .time_ms = time_ms},
+    };
+
+    return pwm_effects_play(channel_mask, segments, ARRAY_SIZE(segments), false);
+}
+
+
+ret_code_t pwm_effects_breathe(uint8_t  channel_mask,
+                               uint8_t  level_min,
+                               uint8_t  level_max,
+                               uint16_t ramp_ms,
+                               uint16_t on_ms,
+                               uint16_t off_ms)
+{
+    pwm_effects_segment_t segments[4];
+    uint16_t              count = 0;
+
+    segments[count++] = (pwm_effects_segment_t){.level = level_max, .time_ms = ramp_ms};
+    if (on_ms != 0)
+    {
+        segments[count++] = (pwm_effects_segment_t){.level = level_max, .time_ms = on_ms};
+    }
+    segments[count++] = (pwm_effects_segment_t){.level = level_min, .time_ms = ramp_ms};
+    if (off_ms != 0)
+    {
+        segments[count++] = (pwm_effects_segment_t){.level = level_min, .time_ms = off_ms};
+    }
+
+    return pwm_effects_play(channel_mask, segments, count, true);
+}
+
+
+void pwm_effects_stop(void)
+{
+    ASSERT(m_cb.p_config);
+
+    playback_stop();
+    m_cb.end_level = 0;
+}
+
+#endif // NRF_MODULE_ENABLED(PWM_EFFECTS)
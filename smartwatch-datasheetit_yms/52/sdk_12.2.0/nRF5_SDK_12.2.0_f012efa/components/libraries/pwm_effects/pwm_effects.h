@@ -0,0 +1,154 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup pwm_effects PWM effects
+ * @{
+ * @ingroup app_common
+ *
+ * @brief @tagAPI52 Module for playing LED and haptic effects with the PWM peripheral.
+ *
+ * @details An effect is a list of segments, each of which ramps the level of a set of channels
+ *          linearly to a target level. The effect is computed into a sequence table when it is
+ *          started, and the table is played by the PWM peripheral through EasyDMA, optionally in
+ *          a loop. No CPU is needed while an effect plays, except for one interrupt at the end of
+ *          an effect that is not looped.
+ *
+ *          Fades, blink patterns, the breathing of @ref led_softblink and the envelopes of
+ *          vibration motors can all be described as segments.
+ *
+ * @note The nRF51 Series has no PWM peripheral. There, use @ref low_power_pwm and
+ *       @ref led_softblink, which generate the signals from app_timer time-outs.
+ */
+
+#ifndef PWM_EFFECTS_H__
+#define PWM_EFFECTS_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nrf_drv_pwm.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PWM_EFFECTS_LEVEL_MAX UINT8_MAX /**< Level of a channel that is fully on. */
+
+/**@brief Segment of an effect. */
+typedef struct
+{
+    uint8_t  level;   /**< Level at the end of the segment, 0 to @ref PWM_EFFECTS_LEVEL_MAX. */
+    uint16_t time_ms; /**< Time of the linear ramp from the previous level to @p level. A ramp
+                           shorter than one step jumps to the level and holds it for one step. */
+} pwm_effects_segment_t;
+
+/**@brief Event handler. Called from the PWM interrupt when an effect that is not looped ends. */
+typedef void (* pwm_effects_evt_handler_t)(void);
+
+/**@brief Module configuration. */
+typedef struct
+{
+    nrf_drv_pwm_t const         * p_pwm;                                /**< PWM driver instance. */
+    uint8_t                       output_pins[NRF_PWM_CHANNEL_COUNT];   /**< Pins of the channels, or @ref NRF_DRV_PWM_PIN_NOT_USED. Add @ref NRF_DRV_PWM_PIN_INVERTED for active low outputs. */
+    nrf_pwm_clk_t                 base_clock;                           /**< Base clock of the PWM counter. */
+    uint16_t                      top_value;                            /**< PWM period, in base clock cycles. */
+    uint16_t                      step_ms;                              /**< Time of one step of the sequence table. Must be a multiple of the PWM period. */
+    uint8_t                       irq_priority;                         /**< Interrupt priority. */
+    nrf_pwm_values_individual_t * p_table;                              /**< Sequence table, in RAM. */
+    uint16_t                      table_length;                         /**< Number of steps in the sequence table. */
+    pwm_effects_evt_handler_t     evt_handler;                          /**< Event handler, or NULL. */
+} pwm_effects_config_t;
+
+/**@brief Function for initializing the module and the PWM driver instance.
+ *
+ * @param[in] p_config Module configuration. Must stay valid while the module is initialized.
+ *
+ * @retval NRF_SUCCESS             If the module was initialized.
+ * @retval NRF_ERROR_NULL          If a required pointer was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If the step time is not a multiple of the PWM period.
+ * @return Any error returned by @ref nrf_drv_pwm_init.
+ */
+ret_code_t pwm_effects_init(pwm_effects_config_t const * p_config);
+
+/**@brief Function for stopping the effect and uninitializing the PWM driver instance.
+ */
+void pwm_effects_uninit(void);
+
+/**@brief Function for starting an effect.
+ *
+ * @details The effect that is playing is replaced. The ramp of the first segment starts from
+ *          the level of the last segment, so that a looped effect has no jump.
+ *
+ * @param[in] channel_mask Channels that play the effect. Bit n selects channel n. The other
+ *                         channels are off.
+ * @param[in] p_segments   Segments of the effect.
+ * @param[in] count        Number of segments.
+ * @param[in] loop         True to play the effect until it is stopped or replaced.
+ *
+ * @retval NRF_SUCCESS             If the effect was started.
+ * @retval NRF_ERROR_INVALID_PARAM If there were no segments.
+ * @retval NRF_ERROR_NO_MEM        If the effect does not fit in the sequence table.
+ */
+ret_code_t pwm_effects_play(uint8_t                       channel_mask,
+                            pwm_effects_segment_t const * p_segments,
+                            uint16_t                      count,
+                            bool                          loop);
+
+/**@brief Function for setting channels to a constant level.
+ *
+ * @param[in] channel_mask Channels to set. The other channels are off.
+ * @param[in] level        Level, 0 to @ref PWM_EFFECTS_LEVEL_MAX.
+ */
+void pwm_effects_level_set(uint8_t channel_mask, uint8_t level);
+
+/**@brief Function for fading channels from one level to another.
+ *
+ * @param[in] channel_mask Channels to fade. The other channels are off.
+ * @param[in] from         Level at the start.
+ * @param[in] to           Level at the end, which is held when the fade is finished.
+ * @param[in] time_ms      Time of the fade.
+ *
+ * @return Values returned by @ref pwm_effects_play.
+ */
+ret_code_t pwm_effects_fade(uint8_t channel_mask, uint8_t from, uint8_t to, uint16_t time_ms);
+
+/**@brief Function for breathing channels, like @ref led_softblink, in a loop.
+ *
+ * @param[in] channel_mask Channels to breathe. The other channels are off.
+ * @param[in] level_min    Lowest level.
+ * @param[in] level_max    Highest level.
+ * @param[in] ramp_ms      Time of each of the ramps up and down.
+ * @param[in] on_ms        Time the highest level is held.
+ * @param[in] off_ms       Time the lowest level is held.
+ *
+ * @return Values returned by @ref pwm_effects_play.
+ */
+ret_code_t pwm_effects_breathe(uint8_t  channel_mask,
+                               uint8_t  level_min,
+                               uint8_t  level_max,
+                               uint16_t ramp_ms,
+                               uint16_t on_ms,
+                               uint16_t off_ms);
+
+/**@brief Function for stopping the effect. The channels are turned off.
+ */
+void pwm_effects_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PWM_EFFECTS_H__
+
+/** @} */
@@ -0,0 +1,16 @@
+/**
+ *
+ * @defgroup pwm_effects_config pwm_effects module configuration
+ * @{
+ * @ingroup pwm_effects
+ */
+/** @brief Enabling pwm_effects module
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define PWM_EFFECTS_ENABLED
+
+
+/** @} */
@@ -19,6 +19,8 @@
 #include "nrf_assert.h"
 #include "nrf_log_ctrl.h"
 #include "app_util_platform.h"
+#include "cpu_profiler_hooks.h"
+#include <string.h>
 
 #define NRF_LOG_MODULE_NAME "NRF_PWR_MGMT"
 #if NRF_PWR_MGMT_CONFIG_LOG_ENABLED
@@ -34,6 +36,10 @@
     #include "nrf_soc.h"
 #endif // SOFTDEVICE_PRESENT
 
+#if NRF_MODULE_ENABLED(ENTROPY_POOL)
+    #include "entropy_pool.h"
+#endif // NRF_MODULE_ENABLED(ENTROPY_POOL)
+
 #if NRF_PWR_MGMT_CONFIG_USE_SCHEDULER
     #if (APP_SCHEDULER_ENABLED != 1)
         #error "APP_SCHEDULER is required."
@@ -43,11 +49,18 @@
 
 #if ((NRF_PWR_MGMT_CONFIG_CPU_USAGE_MONITOR_ENABLED == 1)   \
   || (NRF_PWR_MGMT_CONFIG_STANDBY_TIMEOUT_ENABLED   == 1)   \
-  || (NRF_PWR_MGMT_CONFIG_AUTO_SHUTDOWN_RETRY       == 1))
+  || (NRF_PWR_MGMT_CONFIG_AUTO_SHUTDOWN_RETRY       == 1)   \
+  || (NRF_PWR_MGMT_CONFIG_WAKEUP_STATS_ENABLED      == 1))
     #if (APP_TIMER_ENABLED != 1)
         #error "APP_TIMER is required."
     #endif
     #include "app_timer.h"
+#endif
+
+// The standby timeout uses its own single shot timer, so the periodic timer is only needed for
+// CPU usage measurements and shutdown retries.
+#if ((NRF_PWR_MGMT_CONFIG_CPU_USAGE_MONITOR_ENABLED == 1)   \
+  || (NRF_PWR_MGMT_CONFIG_AUTO_SHUTDOWN_RETRY       == 1))
     #define APP_TIMER_REQUIRED  1
 #else
     #define APP_TIMER_REQUIRED  0
@@ -75,7 +88,8 @@
 #endif
 
 #if (NRF_PWR_MGMT_CONFIG_CPU_USAGE_MONITOR_ENABLED == 1)    \
- || (NRF_PWR_MGMT_CONFIG_DEBUG_PIN_ENABLED == 1)
+ || (NRF_PWR_MGMT_CONFIG_DEBUG_PIN_ENABLED == 1)            \
+ || (NRF_PWR_MGMT_CONFIG_WAKEUP_STATS_ENABLED == 1)
 
 __STATIC_INLINE void nrf_pwr_mgmt_sleep_init(void)
 {
@@ -113,10 +127,33 @@ NRF_SECTION_VARS_CREATE_SECTION(pwr_mgmt_data, nrf_pwr_mgmt_shutdown_handler_t);
 
 
 #if NRF_PWR_MGMT_CONFIG_STANDBY_TIMEOUT_ENABLED
-    static uint16_t m_standby_counter;     /**< Number of seconds from the last activity
-                                                (@ref pwr_mgmt_feed). */
+    #define STANDBY_ARM_MAX_TICKS   APP_TIMER_MAX_SLACK_TICKS   /**< Longest single arming of the standby timer. */
+
+    APP_TIMER_DEF(m_standby_timer);                 /**< Single shot timer for the standby timeout. */
+    static uint32_t          m_standby_ticks;       /**< Standby timeout in RTC ticks. */
+    static uint32_t          m_standby_slack;       /**< Allowed delay of the standby timer in RTC ticks. */
+    static uint32_t          m_standby_elapsed;     /**< Ticks from the last activity to the arming of the timer. */
+    static uint32_t          m_standby_armed_at;    /**< RTC counter when the timer was armed. */
+    static uint32_t          m_feed_ticks;          /**< RTC counter at the last activity
+                                                         (@ref nrf_pwr_mgmt_feed). */
+    static bool volatile     m_fed;                 /**< True if there was activity since the timer was armed. */
 #endif // NRF_PWR_MGMT_CONFIG_STANDBY_TIMEOUT_ENABLED
 
+#if NRF_PWR_MGMT_CONFIG_WAKEUP_STATS_ENABLED
+    #if defined(NRF51)
+        #define WAKEUP_IRQ_WORDS    1
+    #else
+        #define WAKEUP_IRQ_WORDS    2
+    #endif
+    #define WAKEUP_SOURCES          ((WAKEUP_IRQ_WORDS * 32) + 1)   /**< Interrupts and "other". */
+    #define WAKEUP_OTHER_IDX        (WAKEUP_SOURCES - 1)
+
+    static nrf_pwr_mgmt_wakeup_stats_t m_wakeup_stats[WAKEUP_SOURCES];  /**< Statistics of every source. */
+    static uint32_t m_wakeup_pending[WAKEUP_IRQ_WORDS];   /**< Interrupts pending at the last wakeup. */
+    static bool     m_wakeup_other;                       /**< True if no interrupt was pending at the last wakeup. */
+    static uint32_t m_wakeup_ticks;                       /**< RTC counter at the last wakeup. */
+#endif // NRF_PWR_MGMT_CONFIG_WAKEUP_STATS_ENABLED
+
 static nrf_pwr_mgmt_evt_t   m_pwr_mgmt_evt;     /**< Event type which will be passed to the shutdown
                                                      handlers.*/
 static bool                 m_sysoff_guard;     /**< True if application started the shutdown
@@ -125,8 +162,13 @@ static uint8_t              m_next_handler;     /**< Index of the next executed
 
 #if APP_TIMER_REQUIRED
     APP_TIMER_DEF(m_pwr_mgmt_timer);            /**< Timer used by this module. */
+    static uint32_t         m_ticks_per_1s;     /**< Period of m_pwr_mgmt_timer. */
 #endif // APP_TIMER_REQUIRED
 
+#if NRF_PWR_MGMT_CONFIG_AUTO_SHUTDOWN_RETRY && !NRF_PWR_MGMT_CONFIG_CPU_USAGE_MONITOR_ENABLED
+    static bool             m_retry_started;    /**< True if m_pwr_mgmt_timer was started for retries. */
+#endif
+
 #if APP_TIMER_REQUIRED
 /**@brief Handle events from m_pwr_mgmt_timer.
  */
@@ -159,19 +201,148 @@ static void nrf_pwr_mgmt_timeout_handler(void * p_context)
         return;
     }
 #endif // NRF_PWR_MGMT_CONFIG_AUTO_SHUTDOWN_RETRY
+}
+#endif // APP_TIMER_REQUIRED
+
 
 #if NRF_PWR_MGMT_CONFIG_STANDBY_TIMEOUT_ENABLED
-    if (m_standby_counter < NRF_PWR_MGMT_CONFIG_STANDBY_TIMEOUT_S)
+/**@brief Arm the standby timer for the rest of the standby timeout.
+ *
+ * @param[in] now       Current RTC counter.
+ * @param[in] elapsed   Ticks from the last activity.
+ */
+static ret_code_t standby_timer_arm(uint32_t now, uint32_t elapsed)
+{
+    uint32_t timeout = m_standby_ticks - elapsed;
+
+    if (timeout > STANDBY_ARM_MAX_TICKS)
+    {
+        timeout = STANDBY_ARM_MAX_TICKS;
+    }
+    if (timeout < APP_TIMER_MIN_TIMEOUT_TICKS)
+    {
+        timeout = APP_TIMER_MIN_TIMEOUT_TICKS;
+    }
+
+    m_standby_elapsed  = elapsed;
+    m_standby_armed_at = now;
+
+    return app_timer_start_with_slack(m_standby_timer, timeout, m_standby_slack, NULL);
+}
+
+
+/**@brief Handle the expiry of m_standby_timer.
+ *
+ * @details Activity only records a time stamp, so the timer is not restarted on every
+ *          @ref nrf_pwr_mgmt_feed. Instead, when the timer expires, it is armed again for the time
+ *          that is left from the last activity.
+ */
+static void nrf_pwr_mgmt_standby_handler(void * p_context)
+{
+    uint32_t now;
+    uint32_t elapsed;
+    uint32_t feed_ticks;
+    bool     fed;
+
+    UNUSED_PARAMETER(p_context);
+
+    CRITICAL_REGION_ENTER();
+    fed        = m_fed;
+    feed_ticks = m_feed_ticks;
+    m_fed      = false;
+    CRITICAL_REGION_EXIT();
+
+    now = app_timer_cnt_get();
+    if (fed)
     {
-        m_standby_counter++;
+        // The last activity was after the arming, so it is less than one arming ago.
+        UNUSED_VARIABLE(app_timer_cnt_diff_compute(now, feed_ticks, &elapsed));
     }
     else
+    {
+        UNUSED_VARIABLE(app_timer_cnt_diff_compute(now, m_standby_armed_at, &elapsed));
+        elapsed += m_standby_elapsed;
+    }
+
+    if (elapsed >= m_standby_ticks)
     {
         nrf_pwr_mgmt_shutdown(NRF_PWR_MGMT_SHUTDOWN_GOTO_SYSOFF);
+        return;
     }
+
+    APP_ERROR_CHECK(standby_timer_arm(now, elapsed));
+}
 #endif // NRF_PWR_MGMT_CONFIG_STANDBY_TIMEOUT_ENABLED
+
+
+#if NRF_PWR_MGMT_CONFIG_WAKEUP_STATS_ENABLED
+/**@brief Record the sources of a wakeup.
+ *
+ * @details Interrupts are locked while sleeping, so the interrupts that woke the CPU are still
+ *          pending when this function is called.
+ *
+ * @param[in] now   RTC counter at the wakeup.
+ */
+static void wakeup_sources_record(uint32_t now)
+{
+    uint32_t pending;
+    uint32_t irq;
+    uint32_t i;
+
+    m_wakeup_other = true;
+    for (i = 0; i < WAKEUP_IRQ_WORDS; i++)
+    {
+        pending               = NVIC->ISPR[i];
+        m_wakeup_pending[i]   = pending;
+        while (pending != 0)
+        {
+            irq             = 31 - __CLZ(pending);
+            pending        &= ~(1UL << irq);
+            m_wakeup_stats[(i * 32) + irq].count++;
+            m_wakeup_other  = false;
+        }
+    }
+
+    if (m_wakeup_other)
+    {
+        m_wakeup_stats[WAKEUP_OTHER_IDX].count++;
+    }
+    m_wakeup_ticks = now;
 }
-#endif // APP_TIMER_REQUIRED
+
+
+/**@brief Add the time spent awake since the last wakeup to its sources.
+ *
+ * @param[in] now   RTC counter before going to sleep.
+ */
+static void wakeup_awake_account(uint32_t now)
+{
+    uint32_t awake;
+    uint32_t pending;
+    uint32_t irq;
+    uint32_t i;
+
+    UNUSED_VARIABLE(app_timer_cnt_diff_compute(now, m_wakeup_ticks, &awake));
+
+    for (i = 0; i < WAKEUP_IRQ_WORDS; i++)
+    {
+        pending             = m_wakeup_pending[i];
+        m_wakeup_pending[i] = 0;
+        while (pending != 0)
+        {
+            irq      = 31 - __CLZ(pending);
+            pending &= ~(1UL << irq);
+            m_wakeup_stats[(i * 32) + irq].awake_ticks += awake;
+        }
+    }
+
+    if (m_wakeup_other)
+    {
+        m_wakeup_stats[WAKEUP_OTHER_IDX].awake_ticks += awake;
+        m_wakeup_other = false;
+    }
+}
+#endif // NRF_PWR_MGMT_CONFIG_WAKEUP_STATS_ENABLED
 
 
 ret_code_t nrf_pwr_mgmt_init(uint32_t ticks_per_1s)
@@ -186,22 +357,47 @@ ret_code_t nrf_pwr_mgmt_init(uint32_t ticks_per_1s)
     m_ticks_last        = 0;
 #endif // NRF_PWR_MGMT_CONFIG_CPU_USAGE_MONITOR_ENABLED
 
-#if NRF_PWR_MGMT_CONFIG_STANDBY_TIMEOUT_ENABLED
-    m_standby_counter   = 0;
-#endif // NRF_PWR_MGMT_CONFIG_STANDBY_TIMEOUT_ENABLED
+#if NRF_PWR_MGMT_CONFIG_WAKEUP_STATS_ENABLED
+    nrf_pwr_mgmt_wakeup_stats_clear();
+#endif // NRF_PWR_MGMT_CONFIG_WAKEUP_STATS_ENABLED
     m_sysoff_guard      = false;
     m_next_handler      = 0;
 
+#if (APP_TIMER_REQUIRED || NRF_PWR_MGMT_CONFIG_STANDBY_TIMEOUT_ENABLED)
+    ret_code_t ret_code;
+#endif
+
+#if NRF_PWR_MGMT_CONFIG_STANDBY_TIMEOUT_ENABLED
+    m_standby_ticks     = ticks_per_1s * NRF_PWR_MGMT_CONFIG_STANDBY_TIMEOUT_S;
+    m_standby_slack     = MIN(ticks_per_1s, APP_TIMER_MAX_SLACK_TICKS);
+    m_fed               = false;
+
+    ret_code = app_timer_create(&m_standby_timer,
+                                APP_TIMER_MODE_SINGLE_SHOT,
+                                nrf_pwr_mgmt_standby_handler);
+    VERIFY_SUCCESS(ret_code);
+
+    ret_code = standby_timer_arm(app_timer_cnt_get(), 0);
+    VERIFY_SUCCESS(ret_code);
+#endif // NRF_PWR_MGMT_CONFIG_STANDBY_TIMEOUT_ENABLED
+
 #if APP_TIMER_REQUIRED
-    ret_code_t ret_code = app_timer_create(&m_pwr_mgmt_timer,
-                                           APP_TIMER_MODE_REPEATED,
-                                           nrf_pwr_mgmt_timeout_handler);
+    m_ticks_per_1s = ticks_per_1s;
+
+    ret_code = app_timer_create(&m_pwr_mgmt_timer,
+                                APP_TIMER_MODE_REPEATED,
+                                nrf_pwr_mgmt_timeout_handler);
     VERIFY_SUCCESS(ret_code);
 
+#if NRF_PWR_MGMT_CONFIG_CPU_USAGE_MONITOR_ENABLED
     return app_timer_start(m_pwr_mgmt_timer, ticks_per_1s, NULL);
 #else
-    return NRF_SUCCESS;
+    // Only needed for retries, started when the shutdown is blocked.
+    m_retry_started = false;
+#endif // NRF_PWR_MGMT_CONFIG_CPU_USAGE_MONITOR_ENABLED
 #endif // APP_TIMER_REQUIRED
+
+    return NRF_SUCCESS;
 }
 
 
@@ -222,17 +418,26 @@ void nrf_pwr_mgmt_run(void)
     ASSERT((fpscr & 0x03) == 0);
 #endif // NRF_PWR_MGMT_CONFIG_FPU_SUPPORT_ENABLED
 
+#if NRF_MODULE_ENABLED(ENTROPY_POOL)
+    // The RNG keeps producing bytes while the CPU sleeps, as long as they are taken.
+    entropy_pool_refill();
+#endif // NRF_MODULE_ENABLED(ENTROPY_POOL)
+
     SLEEP_LOCK();
 
-#if NRF_PWR_MGMT_CONFIG_CPU_USAGE_MONITOR_ENABLED
+#if (NRF_PWR_MGMT_CONFIG_CPU_USAGE_MONITOR_ENABLED || NRF_PWR_MGMT_CONFIG_WAKEUP_STATS_ENABLED)
     uint32_t sleep_start;
     uint32_t sleep_end;
-    uint32_t sleep_duration;
 
     sleep_start = app_timer_cnt_get();
-#endif // NRF_PWR_MGMT_CONFIG_CPU_USAGE_MONITOR_ENABLED
+#endif
+
+#if NRF_PWR_MGMT_CONFIG_WAKEUP_STATS_ENABLED
+    wakeup_awake_account(sleep_start);
+#endif // NRF_PWR_MGMT_CONFIG_WAKEUP_STATS_ENABLED
 
     DEBUG_PIN_SET();
+    CPU_PROFILER_SLEEP_ENTER();
 
     // Wait for an event.
 #ifdef SOFTDEVICE_PRESENT
@@ -253,16 +458,26 @@ void nrf_pwr_mgmt_run(void)
     __WFE();
 #endif // SOFTDEVICE_PRESENT
 
+    CPU_PROFILER_SLEEP_EXIT();
     DEBUG_PIN_CLEAR();
 
-#if NRF_PWR_MGMT_CONFIG_CPU_USAGE_MONITOR_ENABLED
+#if (NRF_PWR_MGMT_CONFIG_CPU_USAGE_MONITOR_ENABLED || NRF_PWR_MGMT_CONFIG_WAKEUP_STATS_ENABLED)
     sleep_end = app_timer_cnt_get();
+#endif
+
+#if NRF_PWR_MGMT_CONFIG_CPU_USAGE_MONITOR_ENABLED
+    uint32_t sleep_duration;
+
     UNUSED_VARIABLE(app_timer_cnt_diff_compute(sleep_end,
                                                sleep_start,
                                                &sleep_duration));
     m_ticks_sleeping += sleep_duration;
 #endif // NRF_PWR_MGMT_CONFIG_CPU_USAGE_MONITOR_ENABLED
 
+#if NRF_PWR_MGMT_CONFIG_WAKEUP_STATS_ENABLED
+    wakeup_sources_record(sleep_end);
+#endif // NRF_PWR_MGMT_CONFIG_WAKEUP_STATS_ENABLED
+
     SLEEP_RELEASE();
 }
 
@@ -272,11 +487,40 @@ void nrf_pwr_mgmt_feed(void)
 {
     NRF_LOG_DEBUG("Feed\r\n");
     // Once triggered, shutdown is inevitable.
-    m_standby_counter = 0;
+    m_feed_ticks = app_timer_cnt_get();
+    m_fed        = true;
 }
 #endif // NRF_PWR_MGMT_CONFIG_STANDBY_TIMEOUT_ENABLED
 
 
+#if NRF_PWR_MGMT_CONFIG_WAKEUP_STATS_ENABLED
+ret_code_t nrf_pwr_mgmt_wakeup_stats_get(uint8_t source, nrf_pwr_mgmt_wakeup_stats_t * p_stats)
+{
+    uint32_t idx = (source == NRF_PWR_MGMT_WAKEUP_SOURCE_OTHER) ? WAKEUP_OTHER_IDX : source;
+
+    VERIFY_PARAM_NOT_NULL(p_stats);
+    if (idx >= WAKEUP_SOURCES)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    CRITICAL_REGION_ENTER();
+    *p_stats = m_wakeup_stats[idx];
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+
+
+void nrf_pwr_mgmt_wakeup_stats_clear(void)
+{
+    CRITICAL_REGION_ENTER();
+    memset(m_wakeup_stats, 0, sizeof(m_wakeup_stats));
+    CRITICAL_REGION_EXIT();
+}
+#endif // NRF_PWR_MGMT_CONFIG_WAKEUP_STATS_ENABLED
+
+
 /**@brief Function runs the shutdown procedure.
  */
 static void shutdown_process(void)
@@ -295,6 +539,13 @@ static void shutdown_process(void)
             // One of the modules is not ready.
             NRF_LOG_INFO("SysOff handler 0x%08X => blocking\r\n",
                         (unsigned int)*PWR_MGMT_SECTION_VARS_GET(m_next_handler));
+#if NRF_PWR_MGMT_CONFIG_AUTO_SHUTDOWN_RETRY && !NRF_PWR_MGMT_CONFIG_CPU_USAGE_MONITOR_ENABLED
+            if (!m_retry_started)
+            {
+                m_retry_started = true;
+                APP_ERROR_CHECK(app_timer_start(m_pwr_mgmt_timer, m_ticks_per_1s, NULL));
+            }
+#endif
             return;
         }
 
@@ -62,6 +62,24 @@ typedef enum
 } nrf_pwr_mgmt_evt_t;
 
 
+/**@brief Wakeup source for wakeups without a pending interrupt.
+ *
+ * For example, wakeups by events of the SoftDevice that are handled before
+ * the application is woken, or by @c SEV instructions.
+ */
+#define NRF_PWR_MGMT_WAKEUP_SOURCE_OTHER    0xFF
+
+/**@brief Statistics of a wakeup source. */
+typedef struct
+{
+    uint32_t count;         //!< Number of wakeups by the source.
+    uint32_t awake_ticks;   //!< RTC ticks spent awake after these wakeups.
+                            /**<
+                             * When several interrupts woke the CPU together, the time is
+                             * added to each of them.
+                             */
+} nrf_pwr_mgmt_wakeup_stats_t;
+
 /**@brief Shutdown callback.
  * @param[in] event   Type of shutdown process.
  *
@@ -103,9 +121,31 @@ void nrf_pwr_mgmt_run(void);
  * @details Call this function whenever doing something that constitutes "activity".
  *          For example, whenever sending data, call this function to indicate that the application
  *          is active and should not disconnect any ongoing communication links.
+ *
+ *          The function only records the time of the activity. The standby timeout is checked by
+ *          a single shot timer, which does not wake the CPU before the timeout could expire.
  */
 void nrf_pwr_mgmt_feed(void);
 
+/**@brief Function for getting the statistics of a wakeup source.
+ *
+ * @details The sources are the interrupts that were pending when the CPU woke up from
+ *          @ref nrf_pwr_mgmt_run, and @ref NRF_PWR_MGMT_WAKEUP_SOURCE_OTHER. Requires
+ *          NRF_PWR_MGMT_CONFIG_WAKEUP_STATS_ENABLED.
+ *
+ * @param[in]  source   Interrupt number (@c IRQn_Type) or @ref NRF_PWR_MGMT_WAKEUP_SOURCE_OTHER.
+ * @param[out] p_stats  Statistics of the source.
+ *
+ * @retval NRF_SUCCESS              If the statistics were copied.
+ * @retval NRF_ERROR_NULL           If @p p_stats was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM  If @p source was not a valid source.
+ */
+ret_code_t nrf_pwr_mgmt_wakeup_stats_get(uint8_t source, nrf_pwr_mgmt_wakeup_stats_t * p_stats);
+
+/**@brief Function for clearing the statistics of all wakeup sources.
+ */
+void nrf_pwr_mgmt_wakeup_stats_clear(void);
+
 /**@brief Function for shutting down the system.	
  *
  * @param[in] shutdown_type     Type of operation.
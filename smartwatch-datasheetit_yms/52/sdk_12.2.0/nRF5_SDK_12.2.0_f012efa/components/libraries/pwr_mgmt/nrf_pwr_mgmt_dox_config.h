@@ -103,6 +103,17 @@
 #define NRF_PWR_MGMT_CONFIG_CPU_USAGE_MONITOR_ENABLED
 
 
+/** @brief Enables wakeup statistics.
+ *
+ * Module will count the wakeups by every interrupt and the time spent awake after them.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_PWR_MGMT_CONFIG_WAKEUP_STATS_ENABLED
+
+
 /** @brief Enable standby timeout.
  *
  *  Set to 1 to activate.
@@ -28,6 +28,22 @@ __STATIC_INLINE size_t nrf_queue_next_idx(nrf_queue_t const * p_queue, size_t id
     return (idx < p_queue->size) ? (idx + 1) : 0;
 }
 
+/**@brief Move an index forward by a number of slots.
+ *
+ * @param[in]   p_queue         Pointer to the queue instance.
+ * @param[in]   idx             Current index.
+ * @param[in]   element_count   Number of slots.
+ *
+ * @return      New index.
+ */
+__STATIC_INLINE size_t queue_idx_advance(nrf_queue_t const * p_queue,
+                                         size_t              idx,
+                                         size_t              element_count)
+{
+    idx += element_count;
+    return (idx <= p_queue->size) ? idx : (idx - p_queue->size - 1);
+}
+
 /**@brief Get current queue utilization. This function assumes that this process will not be interrupted.
  *
  * @param[in]   p_queue     Pointer to the queue instance.
@@ -47,6 +63,313 @@ bool nrf_queue_is_full(nrf_queue_t const * p_queue)
     return (nrf_queue_next_idx(p_queue, p_queue->p_cb->back) == p_queue->p_cb->front);
 }
 
+#if (__CORTEX_M >= 0x03U)
+#define QUEUE_EXCLUSIVE_ACCESS_SUPPORTED 1  //!< LDREX/STREX are available for multi-producer queues.
+#else
+#define QUEUE_EXCLUSIVE_ACCESS_SUPPORTED 0
+#endif
+
+/**@brief Macro for reading an index that may be updated by another context. */
+#define QUEUE_INDEX_LOAD(_p_index)          (*(volatile size_t const *)(_p_index))
+
+/**@brief Macro for publishing an index. All earlier memory accesses complete before it changes. */
+#define QUEUE_INDEX_STORE(_p_index, _value)                 \
+    do                                                      \
+    {                                                       \
+        __DMB();                                            \
+        *(volatile size_t *)(_p_index) = (_value);          \
+    } while (0)
+
+/**@brief Check if a queue is accessed without critical regions.
+ *
+ * @param[in]   p_queue     Pointer to the queue instance.
+ *
+ * @return      True if the queue uses the lock-free implementation.
+ */
+__STATIC_INLINE bool queue_is_lock_free(nrf_queue_t const * p_queue)
+{
+    return (p_queue->concurrency == NRF_QUEUE_CONCURRENCY_SPSC)
+#if QUEUE_EXCLUSIVE_ACCESS_SUPPORTED
+        || (p_queue->concurrency == NRF_QUEUE_CONCURRENCY_MPSC)
+#endif
+        ;
+}
+
+/**@brief Get queue utilization from a given pair of indexes.
+ *
+ * @param[in]   p_queue     Pointer to the queue instance.
+ * @param[in]   front       Front index.
+ * @param[in]   back        Back index.
+ *
+ * @return      Number of elements between the indexes.
+ */
+__STATIC_INLINE size_t lock_free_utilization_get(nrf_queue_t const * p_queue,
+                                                 size_t              front,
+                                                 size_t              back)
+{
+    return (back >= front) ? (back - front) : (p_queue->size + 1 - front + back);
+}
+
+/**@brief Copy elements into the queue buffer, starting at a given index.
+ *
+ * @param[in]   p_queue         Pointer to the queue instance.
+ * @param[in]   idx             Index of the first element to write.
+ * @param[in]   p_data          Pointer to the elements.
+ * @param[in]   element_count   Number of elements.
+ *
+ * @return      Index following the last element written.
+ */
+static size_t lock_free_copy_in(nrf_queue_t const * p_queue,
+                                size_t              idx,
+                                void const        * p_data,
+                                size_t              element_count)
+{
+    size_t continuous = MIN(element_count, p_queue->size + 1 - idx);
+
+    memcpy((void *)((size_t)p_queue->p_buffer + idx * p_queue->element_size),
+           p_data,
+           continuous * p_queue->element_size);
+
+    if (continuous < element_count)
+    {
+        memcpy(p_queue->p_buffer,
+               (void const *)((size_t)p_data + continuous * p_queue->element_size),
+               (element_count - continuous) * p_queue->element_size);
+    }
+
+    return queue_idx_advance(p_queue, idx, element_count);
+}
+
+/**@brief Copy elements out of the queue buffer, starting at a given index.
+ *
+ * @param[in]   p_queue         Pointer to the queue instance.
+ * @param[in]   idx             Index of the first element to read.
+ * @param[out]  p_data          Pointer to the buffer where elements will be copied.
+ * @param[in]   element_count   Number of elements.
+ *
+ * @return      Index following the last element read.
+ */
+static size_t lock_free_copy_out(nrf_queue_t const * p_queue,
+                                 size_t              idx,
+                                 void              * p_data,
+                                 size_t              element_count)
+{
+    size_t continuous = MIN(element_count, p_queue->size + 1 - idx);
+
+    memcpy(p_data,
+           (void const *)((size_t)p_queue->p_buffer + idx * p_queue->element_size),
+           continuous * p_queue->element_size);
+
+    if (continuous < element_count)
+    {
+        memcpy((void *)((size_t)p_data + continuous * p_queue->element_size),
+               p_queue->p_buffer,
+               (element_count - continuous) * p_queue->element_size);
+    }
+
+    return queue_idx_advance(p_queue, idx, element_count);
+}
+
+/**@brief Copy elements to the queue buffer, starting at a given index.
+ *
+ * @details Single elements, usually pushed from interrupts, are copied by type.
+ *
+ * @param[in]   p_queue         Pointer to the queue instance.
+ * @param[in]   idx             Index of the first element to write.
+ * @param[in]   p_data          Pointer to the elements.
+ * @param[in]   element_count   Number of elements.
+ *
+ * @return      Index following the last element written.
+ */
+static size_t lock_free_store(nrf_queue_t const * p_queue,
+                              size_t              idx,
+                              void const        * p_data,
+                              size_t              element_count)
+{
+    if (element_count != 1)
+    {
+        return lock_free_copy_in(p_queue, idx, p_data, element_count);
+    }
+
+    void * p_slot = (void *)((size_t)p_queue->p_buffer + idx * p_queue->element_size);
+
+    switch (p_queue->element_size)
+    {
+        case sizeof(uint8_t):
+            *((uint8_t *)p_slot) = *((uint8_t const *)p_data);
+            break;
+
+        case sizeof(uint16_t):
+            *((uint16_t *)p_slot) = *((uint16_t const *)p_data);
+            break;
+
+        case sizeof(uint32_t):
+            *((uint32_t *)p_slot) = *((uint32_t const *)p_data);
+            break;
+
+        default:
+            memcpy(p_slot, p_data, p_queue->element_size);
+            break;
+    }
+
+    return nrf_queue_next_idx(p_queue, idx);
+}
+
+#if QUEUE_EXCLUSIVE_ACCESS_SUPPORTED
+/**@brief Add elements to a multi-producer queue.
+ *
+ * @details The space for the elements is claimed first, by moving the reserved index with
+ *          LDREX/STREX. The elements are then copied, and the back index is moved by the producer
+ *          whose claim starts at the back index. Claims of producers that preempted it were made
+ *          and filled while it was suspended, so it publishes up to the reserved index. Producers
+ *          that preempt a pending claim only copy their elements, and leave the publishing to the
+ *          preempted producer.
+ *
+ * @param[in]   p_queue         Pointer to the queue instance.
+ * @param[in]   p_data          Pointer to the elements.
+ * @param[in]   element_count   Number of elements.
+ * @param[in]   all_or_none     If true, no element is added unless all of them fit.
+ *
+ * @return      Number of added elements.
+ */
+static size_t lock_free_multi_write(nrf_queue_t const * p_queue,
+                                    void const        * p_data,
+                                    size_t              element_count,
+                                    bool                all_or_none)
+{
+    nrf_queue_cb_t * p_cb = p_queue->p_cb;
+    size_t           front;
+    size_t           start;
+    size_t           end;
+    size_t           count;
+
+    do
+    {
+        start = __LDREXW((uint32_t volatile *)&p_cb->reserved);
+        front = QUEUE_INDEX_LOAD(&p_cb->front);
+        count = MIN(element_count,
+                    p_queue->size - lock_free_utilization_get(p_queue, front, start));
+
+        if ((count == 0) || (all_or_none && (count < element_count)))
+        {
+            __CLREX();
+            return 0;
+        }
+
+        end = start + count;
+        if (end > p_queue->size)
+        {
+            end -= p_queue->size + 1;
+        }
+    } while (__STREXW(end, (uint32_t volatile *)&p_cb->reserved) != 0);
+
+    (void)lock_free_store(p_queue, start, p_data, count);
+
+    if (QUEUE_INDEX_LOAD(&p_cb->back) == start)
+    {
+        do
+        {
+            end = QUEUE_INDEX_LOAD(&p_cb->reserved);
+            QUEUE_INDEX_STORE(&p_cb->back, end);
+        } while (QUEUE_INDEX_LOAD(&p_cb->reserved) != end);
+    }
+
+    // Utilization statistics are not protected. A preempted update can lower the value.
+    size_t utilization = lock_free_utilization_get(p_queue, front, end);
+    if (p_cb->max_utilization < utilization)
+    {
+        p_cb->max_utilization = utilization;
+    }
+
+    return count;
+}
+#endif // QUEUE_EXCLUSIVE_ACCESS_SUPPORTED
+
+/**@brief Add elements to a lock-free queue.
+ *
+ * @param[in]   p_queue         Pointer to the queue instance.
+ * @param[in]   p_data          Pointer to the elements.
+ * @param[in]   element_count   Number of elements.
+ * @param[in]   all_or_none     If true, no element is added unless all of them fit.
+ *
+ * @return      Number of added elements.
+ */
+static size_t lock_free_write(nrf_queue_t const * p_queue,
+                              void const        * p_data,
+                              size_t              element_count,
+                              bool                all_or_none)
+{
+    ASSERT(p_queue->mode == NRF_QUEUE_MODE_NO_OVERFLOW);
+
+#if QUEUE_EXCLUSIVE_ACCESS_SUPPORTED
+    if (p_queue->concurrency == NRF_QUEUE_CONCURRENCY_MPSC)
+    {
+        return lock_free_multi_write(p_queue, p_data, element_count, all_or_none);
+    }
+#endif
+
+    nrf_queue_cb_t * p_cb  = p_queue->p_cb;
+    size_t           back  = p_cb->back;
+    size_t           front = QUEUE_INDEX_LOAD(&p_cb->front);
+    size_t           count = MIN(element_count,
+                                 p_queue->size - lock_free_utilization_get(p_queue, front, back));
+
+    if ((count == 0) || (all_or_none && (count < element_count)))
+    {
+        return 0;
+    }
+
+    back = lock_free_store(p_queue, back, p_data, count);
+    QUEUE_INDEX_STORE(&p_cb->back, back);
+
+    size_t utilization = lock_free_utilization_get(p_queue, front, back);
+    if (p_cb->max_utilization < utilization)
+    {
+        p_cb->max_utilization = utilization;
+    }
+
+    return count;
+}
+
+/**@brief Remove elements from a lock-free queue.
+ *
+ * @param[in]   p_queue         Pointer to the queue instance.
+ * @param[out]  p_data          Pointer to the buffer where elements will be copied.
+ * @param[in]   element_count   Number of elements.
+ * @param[in]   all_or_none     If true, no element is removed unless all of them are available.
+ * @param[in]   just_peek       If true, the elements are not removed from the queue.
+ *
+ * @return      Number of elements copied.
+ */
+static size_t lock_free_read(nrf_queue_t const * p_queue,
+                             void              * p_data,
+                             size_t              element_count,
+                             bool                all_or_none,
+                             bool                just_peek)
+{
+    nrf_queue_cb_t * p_cb  = p_queue->p_cb;
+    size_t           front = p_cb->front;
+    size_t           back  = QUEUE_INDEX_LOAD(&p_cb->back);
+    size_t           count = MIN(element_count, lock_free_utilization_get(p_queue, front, back));
+
+    if ((count == 0) || (all_or_none && (count < element_count)))
+    {
+        return 0;
+    }
+
+    // Do not read the elements before the back index that covers them.
+    __DMB();
+
+    size_t new_front = lock_free_copy_out(p_queue, front, p_data, count);
+
+    if (!just_peek)
+    {
+        QUEUE_INDEX_STORE(&p_cb->front, new_front);
+    }
+
+    return count;
+}
+
 ret_code_t nrf_queue_push(nrf_queue_t const * p_queue, void const * p_element)
 {
     ret_code_t status = NRF_SUCCESS;
@@ -54,6 +377,11 @@ ret_code_t nrf_queue_push(nrf_queue_t const * p_queue, void const * p_element)
     ASSERT(p_queue != NULL);
     ASSERT(p_element != NULL);
 
+    if (queue_is_lock_free(p_queue))
+    {
+        return (lock_free_write(p_queue, p_element, 1, true) != 0) ? NRF_SUCCESS : NRF_ERROR_NO_MEM;
+    }
+
     CRITICAL_REGION_ENTER();
     bool is_full = nrf_queue_is_full(p_queue);
 
@@ -120,6 +448,12 @@ ret_code_t nrf_queue_generic_pop(nrf_queue_t const * p_queue,
     ASSERT(p_queue != NULL);
     ASSERT(p_element != NULL);
 
+    if (queue_is_lock_free(p_queue))
+    {
+        return (lock_free_read(p_queue, p_element, 1, true, just_peek) != 0) ? NRF_SUCCESS :
+                                                                              NRF_ERROR_NOT_FOUND;
+    }
+
     CRITICAL_REGION_ENTER();
 
     if (!nrf_queue_is_empty(p_queue))
@@ -235,6 +569,12 @@ ret_code_t nrf_queue_write(nrf_queue_t const * p_queue,
         return NRF_SUCCESS;
     }
 
+    if (queue_is_lock_free(p_queue))
+    {
+        return (lock_free_write(p_queue, p_data, element_count, true) != 0) ? NRF_SUCCESS :
+                                                                             NRF_ERROR_NO_MEM;
+    }
+
     CRITICAL_REGION_ENTER();
 
     if ((nrf_queue_available_get(p_queue) >= element_count)
@@ -265,6 +605,11 @@ size_t nrf_queue_in(nrf_queue_t const * p_queue,
         return 0;
     }
 
+    if (queue_is_lock_free(p_queue))
+    {
+        return lock_free_write(p_queue, p_data, element_count, false);
+    }
+
     CRITICAL_REGION_ENTER();
 
     if (p_queue->mode == NRF_QUEUE_MODE_OVERFLOW)
@@ -339,6 +684,12 @@ ret_code_t nrf_queue_read(nrf_queue_t const * p_queue,
         return NRF_SUCCESS;
     }
 
+    if (queue_is_lock_free(p_queue))
+    {
+        return (lock_free_read(p_queue, p_data, element_count, true, false) != 0) ?
+               NRF_SUCCESS : NRF_ERROR_NOT_FOUND;
+    }
+
     CRITICAL_REGION_ENTER();
 
     if (element_count <= queue_utilization_get(p_queue))
@@ -367,6 +718,11 @@ size_t nrf_queue_out(nrf_queue_t const * p_queue,
         return 0;
     }
 
+    if (queue_is_lock_free(p_queue))
+    {
+        return lock_free_read(p_queue, p_data, element_count, false, false);
+    }
+
     CRITICAL_REGION_ENTER();
 
     size_t utilization = queue_utilization_get(p_queue);
@@ -379,6 +735,200 @@ size_t nrf_queue_out(nrf_queue_t const * p_queue,
     return element_count;
 }
 
+/**@brief Describe a range of buffer slots as up to two contiguous spans.
+ *
+ * @param[in]   p_queue         Pointer to the queue instance.
+ * @param[in]   idx             Index of the first slot.
+ * @param[in]   element_count   Number of slots.
+ * @param[out]  p_spans         Array of two spans to fill.
+ */
+static void queue_spans_get(nrf_queue_t const * p_queue,
+                            size_t              idx,
+                            size_t              element_count,
+                            nrf_queue_span_t  * p_spans)
+{
+    size_t continuous = MIN(element_count, p_queue->size + 1 - idx);
+
+    p_spans[0].p_data = (void *)((size_t)p_queue->p_buffer + idx * p_queue->element_size);
+    p_spans[0].count  = continuous;
+    p_spans[1].p_data = p_queue->p_buffer;
+    p_spans[1].count  = element_count - continuous;
+}
+
+ret_code_t nrf_queue_write_reserve(nrf_queue_t const * p_queue,
+                                   size_t              element_count,
+                                   nrf_queue_span_t  * p_spans)
+{
+    ret_code_t status = NRF_SUCCESS;
+
+    ASSERT(p_queue != NULL);
+    ASSERT(p_spans != NULL);
+
+    if (p_queue->concurrency == NRF_QUEUE_CONCURRENCY_MPSC)
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+
+    if (queue_is_lock_free(p_queue))
+    {
+        size_t back  = p_queue->p_cb->back;
+        size_t front = QUEUE_INDEX_LOAD(&p_queue->p_cb->front);
+
+        if (element_count > p_queue->size - lock_free_utilization_get(p_queue, front, back))
+        {
+            return NRF_ERROR_NO_MEM;
+        }
+
+        queue_spans_get(p_queue, back, element_count, p_spans);
+        return NRF_SUCCESS;
+    }
+
+    CRITICAL_REGION_ENTER();
+
+    if (element_count <= p_queue->size - queue_utilization_get(p_queue))
+    {
+        queue_spans_get(p_queue, p_queue->p_cb->back, element_count, p_spans);
+    }
+    else
+    {
+        status = NRF_ERROR_NO_MEM;
+    }
+
+    CRITICAL_REGION_EXIT();
+
+    return status;
+}
+
+ret_code_t nrf_queue_write_commit(nrf_queue_t const * p_queue, size_t element_count)
+{
+    ret_code_t status = NRF_SUCCESS;
+
+    ASSERT(p_queue != NULL);
+
+    if (p_queue->concurrency == NRF_QUEUE_CONCURRENCY_MPSC)
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+
+    if (element_count == 0)
+    {
+        return NRF_SUCCESS;
+    }
+
+    if (queue_is_lock_free(p_queue))
+    {
+        size_t back  = p_queue->p_cb->back;
+        size_t front = QUEUE_INDEX_LOAD(&p_queue->p_cb->front);
+
+        if (element_count > p_queue->size - lock_free_utilization_get(p_queue, front, back))
+        {
+            return NRF_ERROR_INVALID_LENGTH;
+        }
+
+        back = queue_idx_advance(p_queue, back, element_count);
+        QUEUE_INDEX_STORE(&p_queue->p_cb->back, back);
+
+        size_t utilization = lock_free_utilization_get(p_queue, front, back);
+        if (p_queue->p_cb->max_utilization < utilization)
+        {
+            p_queue->p_cb->max_utilization = utilization;
+        }
+        return NRF_SUCCESS;
+    }
+
+    CRITICAL_REGION_ENTER();
+
+    if (element_count <= p_queue->size - queue_utilization_get(p_queue))
+    {
+        p_queue->p_cb->back = queue_idx_advance(p_queue, p_queue->p_cb->back, element_count);
+
+        size_t utilization = queue_utilization_get(p_queue);
+        if (p_queue->p_cb->max_utilization < utilization)
+        {
+            p_queue->p_cb->max_utilization = utilization;
+        }
+    }
+    else
+    {
+        status = NRF_ERROR_INVALID_LENGTH;
+    }
+
+    CRITICAL_REGION_EXIT();
+
+    return status;
+}
+
+size_t nrf_queue_read_peek_contiguous(nrf_queue_t const * p_queue, nrf_queue_span_t * p_spans)
+{
+    size_t utilization;
+
+    ASSERT(p_queue != NULL);
+    ASSERT(p_spans != NULL);
+
+    if (queue_is_lock_free(p_queue))
+    {
+        size_t front = p_queue->p_cb->front;
+        size_t back  = QUEUE_INDEX_LOAD(&p_queue->p_cb->back);
+
+        utilization = lock_free_utilization_get(p_queue, front, back);
+
+        // Do not let the caller read the elements before the back index that covers them.
+        __DMB();
+        queue_spans_get(p_queue, front, utilization, p_spans);
+        return utilization;
+    }
+
+    CRITICAL_REGION_ENTER();
+
+    utilization = queue_utilization_get(p_queue);
+    queue_spans_get(p_queue, p_queue->p_cb->front, utilization, p_spans);
+
+    CRITICAL_REGION_EXIT();
+
+    return utilization;
+}
+
+ret_code_t nrf_queue_read_release(nrf_queue_t const * p_queue, size_t element_count)
+{
+    ret_code_t status = NRF_SUCCESS;
+
+    ASSERT(p_queue != NULL);
+
+    if (element_count == 0)
+    {
+        return NRF_SUCCESS;
+    }
+
+    if (queue_is_lock_free(p_queue))
+    {
+        size_t front = p_queue->p_cb->front;
+        size_t back  = QUEUE_INDEX_LOAD(&p_queue->p_cb->back);
+
+        if (element_count > lock_free_utilization_get(p_queue, front, back))
+        {
+            return NRF_ERROR_INVALID_LENGTH;
+        }
+
+        QUEUE_INDEX_STORE(&p_queue->p_cb->front, queue_idx_advance(p_queue, front, element_count));
+        return NRF_SUCCESS;
+    }
+
+    CRITICAL_REGION_ENTER();
+
+    if (element_count <= queue_utilization_get(p_queue))
+    {
+        p_queue->p_cb->front = queue_idx_advance(p_queue, p_queue->p_cb->front, element_count);
+    }
+    else
+    {
+        status = NRF_ERROR_INVALID_LENGTH;
+    }
+
+    CRITICAL_REGION_EXIT();
+
+    return status;
+}
+
 void nrf_queue_reset(nrf_queue_t const * p_queue)
 {
     ASSERT(p_queue != NULL);
@@ -395,6 +945,14 @@ size_t nrf_queue_utilization_get(nrf_queue_t const * p_queue)
     size_t utilization;
     ASSERT(p_queue != NULL);
 
+    if (queue_is_lock_free(p_queue))
+    {
+        size_t front = QUEUE_INDEX_LOAD(&p_queue->p_cb->front);
+        size_t back  = QUEUE_INDEX_LOAD(&p_queue->p_cb->back);
+
+        return lock_free_utilization_get(p_queue, front, back);
+    }
+
     CRITICAL_REGION_ENTER();
 
     utilization = queue_utilization_get(p_queue);
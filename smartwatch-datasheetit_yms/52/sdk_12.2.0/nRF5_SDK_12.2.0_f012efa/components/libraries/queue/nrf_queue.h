@@ -38,6 +38,7 @@ typedef struct
     size_t front;                   //!< Queue front index.
     size_t back;                    //!< Queue back index.
     size_t max_utilization;         //!< Maximum utilization of the queue.
+    size_t reserved;                //!< End of the space claimed by producers. Used only by multi-producer queues.
 } nrf_queue_cb_t;
 
 /**@brief Supported queue modes. */
@@ -47,26 +48,43 @@ typedef enum
     NRF_QUEUE_MODE_NO_OVERFLOW,     //!< If the queue is full, new element will overwrite the oldest.
 } nrf_queue_mode_t;
 
+/**@brief Supported ways of protecting the queue against concurrent access. */
+typedef enum
+{
+    NRF_QUEUE_CONCURRENCY_LOCKED,   //!< Every operation runs in a critical region. Any context may push and pop.
+    NRF_QUEUE_CONCURRENCY_SPSC,     //!< No critical regions. Only one context pushes, and only one context pops.
+    NRF_QUEUE_CONCURRENCY_MPSC,     //!< No critical regions. Any context may push, only one context pops. Uses LDREX/STREX on Cortex-M3 and M4, and critical regions on Cortex-M0.
+} nrf_queue_concurrency_t;
+
+/**@brief Contiguous part of the queue storage. */
+typedef struct
+{
+    void * p_data;                  //!< Pointer to the first element of the span.
+    size_t count;                   //!< Number of elements in the span.
+} nrf_queue_span_t;
+
 /**@brief Instance of the queue. */
 typedef struct
 {
-    nrf_queue_cb_t * p_cb;          //!< Pointer to the instance control block.
-    void           * p_buffer;      //!< Pointer to the memory that is used as storage.
-    size_t           size;          //!< Size of the queue.
-    size_t           element_size;  //!< Size of one element.
-    nrf_queue_mode_t mode;          //!< Mode of the queue.
+    nrf_queue_cb_t        * p_cb;          //!< Pointer to the instance control block.
+    void                  * p_buffer;      //!< Pointer to the memory that is used as storage.
+    size_t                  size;          //!< Size of the queue.
+    size_t                  element_size;  //!< Size of one element.
+    nrf_queue_mode_t        mode;          //!< Mode of the queue.
+    nrf_queue_concurrency_t concurrency;   //!< Protection against concurrent access.
 } nrf_queue_t;
 
-/**@brief Create a queue instance.
+/**@brief Create a queue instance with a given protection against concurrent access.
  *
  * @note  This macro reserves memory for the given queue instance.
  *
- * @param[in]   _type       Type which is stored.
- * @param[in]   _name       Name of the queue.
- * @param[in]   _size       Size of the queue.
- * @param[in]   _mode       Mode of the queue.
+ * @param[in]   _type           Type which is stored.
+ * @param[in]   _name           Name of the queue.
+ * @param[in]   _size           Size of the queue.
+ * @param[in]   _mode           Mode of the queue.
+ * @param[in]   _concurrency    Protection against concurrent access. See @ref nrf_queue_concurrency_t.
  */
-#define NRF_QUEUE_DEF(_type, _name, _size, _mode)                   \
+#define NRF_QUEUE_GENERIC_DEF(_type, _name, _size, _mode, _concurrency) \
     static _type             _name##_nrf_queue_buffer[(_size) + 1]; \
     static nrf_queue_cb_t    _name##_nrf_queue_cb;                  \
     static const nrf_queue_t _name =                                \
@@ -76,8 +94,47 @@ typedef struct
             .size           = (_size),                              \
             .element_size   = sizeof(_type),                        \
             .mode           = _mode,                                \
+            .concurrency    = _concurrency,                         \
         }
 
+/**@brief Create a queue instance.
+ *
+ * @note  This macro reserves memory for the given queue instance.
+ *
+ * @param[in]   _type       Type which is stored.
+ * @param[in]   _name       Name of the queue.
+ * @param[in]   _size       Size of the queue.
+ * @param[in]   _mode       Mode of the queue.
+ */
+#define NRF_QUEUE_DEF(_type, _name, _size, _mode)                   \
+    NRF_QUEUE_GENERIC_DEF(_type, _name, _size, _mode, NRF_QUEUE_CONCURRENCY_LOCKED)
+
+/**@brief Create a single-producer, single-consumer queue instance.
+ *
+ * @details The queue is accessed without critical regions. All push and write operations must
+ *          be done from one context (for example one interrupt handler), and all pop and read
+ *          operations from one other context (for example the main loop). New elements are not
+ *          accepted while the queue is full.
+ *
+ * @param[in]   _type       Type which is stored.
+ * @param[in]   _name       Name of the queue.
+ * @param[in]   _size       Size of the queue.
+ */
+#define NRF_QUEUE_SPSC_DEF(_type, _name, _size)                     \
+    NRF_QUEUE_GENERIC_DEF(_type, _name, _size, NRF_QUEUE_MODE_NO_OVERFLOW, NRF_QUEUE_CONCURRENCY_SPSC)
+
+/**@brief Create a multi-producer, single-consumer queue instance.
+ *
+ * @details Like @ref NRF_QUEUE_SPSC_DEF, but push and write operations may be done from any
+ *          context, including interrupt handlers that preempt each other.
+ *
+ * @param[in]   _type       Type which is stored.
+ * @param[in]   _name       Name of the queue.
+ * @param[in]   _size       Size of the queue.
+ */
+#define NRF_QUEUE_MPSC_DEF(_type, _name, _size)                     \
+    NRF_QUEUE_GENERIC_DEF(_type, _name, _size, NRF_QUEUE_MODE_NO_OVERFLOW, NRF_QUEUE_CONCURRENCY_MPSC)
+
 /**@brief Declare a queue interface.
  *
  * @param[in]   _type    Type which is stored.
@@ -298,6 +355,63 @@ size_t nrf_queue_out(nrf_queue_t const * p_queue,
                     void               * p_data,
                     size_t               element_count);
 
+/**@brief Function for reserving space in the queue for elements that will be written in place.
+ *
+ * @details The reserved slots are described as two spans, because the space can wrap around the
+ *          end of the queue storage. The second span is empty if it does not. The caller (or a
+ *          peripheral using EasyDMA) fills the spans, and then adds the elements to the queue with
+ *          @ref nrf_queue_write_commit. Only one context may write to the queue while a
+ *          reservation is pending.
+ *
+ * @param[in]   p_queue             Pointer to the nrf_queue_t instance.
+ * @param[in]   element_count       Number of elements to reserve.
+ * @param[out]  p_spans             Array of two spans that receive the reserved slots.
+ *
+ * @return      NRF_SUCCESS             If the space was reserved.
+ * @return      NRF_ERROR_NO_MEM        There is not enough space in the queue.
+ * @return      NRF_ERROR_NOT_SUPPORTED If the queue was defined with @ref NRF_QUEUE_MPSC_DEF.
+ */
+ret_code_t nrf_queue_write_reserve(nrf_queue_t const * p_queue,
+                                   size_t              element_count,
+                                   nrf_queue_span_t  * p_spans);
+
+/**@brief Function for adding elements that were written in place to the queue.
+ *
+ * @param[in]   p_queue             Pointer to the nrf_queue_t instance.
+ * @param[in]   element_count       Number of elements written since @ref nrf_queue_write_reserve.
+ *                                  It may be lower than the number of reserved elements.
+ *
+ * @return      NRF_SUCCESS                 If the elements were added.
+ * @return      NRF_ERROR_INVALID_LENGTH    There is not enough space in the queue for the elements.
+ * @return      NRF_ERROR_NOT_SUPPORTED     If the queue was defined with @ref NRF_QUEUE_MPSC_DEF.
+ */
+ret_code_t nrf_queue_write_commit(nrf_queue_t const * p_queue, size_t element_count);
+
+/**@brief Function for getting the elements in the queue without copying them.
+ *
+ * @details The elements are described as two spans, because they can wrap around the end of the
+ *          queue storage. The second span is empty if they do not. The elements stay in the queue
+ *          until they are removed with @ref nrf_queue_read_release. In
+ *          @ref NRF_QUEUE_MODE_OVERFLOW, writes to a full queue overwrite the oldest elements,
+ *          including the ones that are being read.
+ *
+ * @param[in]   p_queue             Pointer to the nrf_queue_t instance.
+ * @param[out]  p_spans             Array of two spans that receive the elements.
+ *
+ * @return      The number of elements in both spans.
+ */
+size_t nrf_queue_read_peek_contiguous(nrf_queue_t const * p_queue, nrf_queue_span_t * p_spans);
+
+/**@brief Function for removing elements that were read in place from the queue.
+ *
+ * @param[in]   p_queue             Pointer to the nrf_queue_t instance.
+ * @param[in]   element_count       Number of elements to remove from the front of the queue.
+ *
+ * @return      NRF_SUCCESS                 If the elements were removed.
+ * @return      NRF_ERROR_INVALID_LENGTH    There are not enough elements in the queue.
+ */
+ret_code_t nrf_queue_read_release(nrf_queue_t const * p_queue, size_t element_count);
+
 /**@brief Function for checking if the queue is full. 
  *
  * @param[in]   p_queue     Pointer to the queue instance.
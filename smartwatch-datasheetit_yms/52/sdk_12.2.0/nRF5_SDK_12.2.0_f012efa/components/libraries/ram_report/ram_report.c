@@ -0,0 +1,166 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(RAM_REPORT)
+#include "ram_report.h"
+#include <string.h>
+#include "nrf.h"
+
+#define NRF_LOG_MODULE_NAME "RAM"
+#include "nrf_log.h"
+
+#define RAM_START_ADDRESS 0x20000000
+
+#if defined ( __CC_ARM )
+extern uint32_t Image$$RW_IRAM1$$Base;
+#define APP_RAM_BASE ((uint32_t)&Image$$RW_IRAM1$$Base)
+#elif defined ( __ICCARM__ )
+extern uint32_t __ICFEDIT_region_RAM_start__;
+#define APP_RAM_BASE ((uint32_t)&__ICFEDIT_region_RAM_start__)
+#elif defined ( __GNUC__ )
+extern uint32_t __data_start__;
+extern uint32_t __bss_end__;
+extern uint32_t __HeapBase;
+extern uint32_t __HeapLimit;
+extern uint32_t __StackLimit;
+extern uint32_t __StackTop;
+#define APP_RAM_BASE ((uint32_t)&__data_start__)
+#define RAM_SPLIT_KNOWN   /**< The linker script gives the split of the application RAM. */
+#endif
+
+static uint32_t m_sd_ram_base;   /**< Requirement of the SoftDevice, or 0. */
+static uint32_t m_attr_tab_cost; /**< RAM of the Attribute Table above the minimum. */
+
+
+static uint32_t ram_end_address_get(void)
+{
+#ifdef NRF51
+    return RAM_START_ADDRESS + (NRF_FICR->SIZERAMBLOCKS * NRF_FICR->NUMRAMBLOCK);
+#else
+    return RAM_START_ADDRESS + (NRF_FICR->INFO.RAM * 1024);
+#endif
+}
+
+
+#if (defined(S130) || defined(S132) || defined(S332))
+/**@brief Function for getting the requirement of a configuration, without enabling the stack.
+ *
+ * @details The SoftDevice rejects an application RAM base of 0 with NRF_ERROR_NO_MEM, and
+ *          returns the lowest base it accepts.
+ */
+static ret_code_t sd_requirement_get(ble_enable_params_t * p_ble_enable_params, uint32_t * p_base)
+{
+    ret_code_t err_code;
+
+    *p_base  = 0;
+    err_code = sd_ble_enable(p_ble_enable_params, p_base);
+
+    return (err_code == NRF_ERROR_NO_MEM) ? NRF_SUCCESS : err_code;
+}
+#endif
+
+
+ret_code_t ram_report_sd_probe(ble_enable_params_t * p_ble_enable_params)
+{
+#if (defined(S130) || defined(S132) || defined(S332))
+    ble_enable_params_t min_params;
+    uint32_t            min_base;
+    ret_code_t          err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_ble_enable_params);
+
+    err_code = sd_requirement_get(p_ble_enable_params, &m_sd_ram_base);
+    if (err_code != NRF_SUCCESS)
+    {
+        m_sd_ram_base = 0;
+        return err_code;
+    }
+
+    // The same configuration with the smallest Attribute Table gives the cost of the table. It is
+    // rejected if the device name does not fit.
+    min_params                                   = *p_ble_enable_params;
+    min_params.gatts_enable_params.attr_tab_size = BLE_GATTS_ATTR_TAB_SIZE_MIN;
+
+    m_attr_tab_cost = 0;
+    if ((sd_requirement_get(&min_params, &min_base) == NRF_SUCCESS) && (min_base < m_sd_ram_base))
+    {
+        m_attr_tab_cost = m_sd_ram_base - min_base;
+    }
+
+    return NRF_SUCCESS;
+#else
+    UNUSED_PARAMETER(p_ble_enable_params);
+    return NRF_ERROR_NOT_SUPPORTED;
+#endif
+}
+
+
+void ram_report_get(ram_report_t * p_report)
+{
+    memset(p_report, 0, sizeof(ram_report_t));
+
+    p_report->ram_end       = ram_end_address_get();
+    p_report->app_ram_base  = APP_RAM_BASE;
+    p_report->sd_ram_base   = m_sd_ram_base;
+    p_report->attr_tab_cost = m_attr_tab_cost;
+
+#ifdef RAM_SPLIT_KNOWN
+    p_report->static_size = (uint32_t)&__bss_end__  - (uint32_t)&__data_start__;
+    p_report->heap_size   = (uint32_t)&__HeapLimit  - (uint32_t)&__HeapBase;
+    p_report->stack_size  = (uint32_t)&__StackTop   - (uint32_t)&__StackLimit;
+    if ((uint32_t)&__StackLimit > (uint32_t)&__HeapLimit)
+    {
+        p_report->unused_size = (uint32_t)&__StackLimit - (uint32_t)&__HeapLimit;
+    }
+#endif
+}
+
+
+void ram_report_log(void)
+{
+    ram_report_t report;
+
+    ram_report_get(&report);
+
+    NRF_LOG_INFO("%d bytes, application from 0x%x.\r\n",
+                 report.ram_end - RAM_START_ADDRESS, report.app_ram_base);
+    NRF_LOG_INFO("  SoftDevice: %d bytes.\r\n", report.app_ram_base - RAM_START_ADDRESS);
+    if (report.sd_ram_base != 0)
+    {
+        NRF_LOG_INFO("  SoftDevice needs %d bytes, %d of them for the Attribute Table.\r\n",
+                     report.sd_ram_base - RAM_START_ADDRESS, report.attr_tab_cost);
+    }
+    if (report.static_size != 0)
+    {
+        NRF_LOG_INFO("  Static: %d bytes, heap: %d bytes, stack: %d bytes, unused: %d bytes.\r\n",
+                     report.static_size, report.heap_size, report.stack_size, report.unused_size);
+    }
+
+    if (report.sd_ram_base > report.app_ram_base)
+    {
+        NRF_LOG_ERROR("The SoftDevice needs %d bytes more. In the linker script:\r\n",
+                      report.sd_ram_base - report.app_ram_base);
+    }
+    else if ((report.sd_ram_base != 0) && (report.sd_ram_base < report.app_ram_base))
+    {
+        NRF_LOG_WARNING("%d bytes are never used by the SoftDevice. In the linker script:\r\n",
+                        report.app_ram_base - report.sd_ram_base);
+    }
+    else
+    {
+        return;
+    }
+    NRF_LOG_INFO("  RAM (rwx) : ORIGIN = 0x%x, LENGTH = 0x%x\r\n",
+                 report.sd_ram_base, report.ram_end - report.sd_ram_base);
+}
+
+#endif // NRF_MODULE_ENABLED(RAM_REPORT)
@@ -0,0 +1,104 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ram_report RAM report
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for sizing the RAM of the SoftDevice exactly, and reporting how the RAM is split.
+ *
+ * @details The RAM needed by the SoftDevice depends on the whole BLE configuration: the number of
+ *          links, the ATT MTU, the size of the Attribute Table, the number of vendor specific
+ *          UUIDs and the TX and RX buffer counts. Instead of a RAM start in the linker script
+ *          that is checked after the fact by @ref softdevice_enable, @ref ram_report_sd_probe asks
+ *          the SoftDevice for the exact requirement of the configuration before it is enabled.
+ *          @ref ram_report_log then logs how the RAM is split between the SoftDevice, the
+ *          static variables, the heap and the stack, what is unused, and the RAM region to put
+ *          in the linker script.
+ *
+ *          Run it once on the first boot of a new configuration:
+ *          @code
+ *          SOFTDEVICE_HANDLER_INIT(&clock_lf_cfg, NULL);
+ *          err_code = softdevice_enable_get_default_config(CENTRAL_LINK_COUNT, PERIPHERAL_LINK_COUNT,
+ *                                                          &ble_enable_params);
+ *          APP_ERROR_CHECK(err_code);
+ *          err_code = ram_report_sd_probe(&ble_enable_params);
+ *          APP_ERROR_CHECK(err_code);
+ *          ram_report_log();
+ *          err_code = softdevice_enable(&ble_enable_params);
+ *          @endcode
+ *
+ *          The static pools of the libraries are not known to the firmware. At build time,
+ *          tools/ram_report.py reads the map file of the GCC build, lists the RAM of each object
+ *          file, and writes the linker script region for the requirement found by the probe.
+ *
+ * @note The split of the application RAM is only available with GCC, from the symbols of the
+ *       linker scripts of the SDK.
+ */
+
+#ifndef RAM_REPORT_H__
+#define RAM_REPORT_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+#include "ble.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**@brief RAM split. The sizes are in bytes. */
+typedef struct
+{
+    uint32_t ram_end;         /**< End of the RAM. */
+    uint32_t app_ram_base;    /**< Start of the application RAM, from the linker script. */
+    uint32_t sd_ram_base;     /**< Lowest start of the application RAM the SoftDevice accepts, or 0 if not probed. */
+    uint32_t attr_tab_cost;   /**< RAM taken by the Attribute Table above @ref BLE_GATTS_ATTR_TAB_SIZE_MIN. */
+    uint32_t static_size;     /**< Initialized and zeroed static variables. */
+    uint32_t heap_size;       /**< Heap. */
+    uint32_t stack_size;      /**< Stack. */
+    uint32_t unused_size;     /**< RAM between the heap and the stack. */
+} ram_report_t;
+
+/**@brief Function for asking the SoftDevice the exact RAM requirement of a configuration.
+ *
+ * @details Call it after the SoftDevice is enabled, and before @ref softdevice_enable. The BLE
+ *          stack is not enabled.
+ *
+ * @param[in] p_ble_enable_params Configuration, as it is passed to @ref softdevice_enable.
+ *
+ * @retval NRF_SUCCESS             If the requirement was found.
+ * @retval NRF_ERROR_NULL          If p_ble_enable_params was NULL.
+ * @retval NRF_ERROR_NOT_SUPPORTED If the SoftDevice does not report its requirement.
+ * @return Other errors from @ref sd_ble_enable, for an invalid configuration.
+ */
+ret_code_t ram_report_sd_probe(ble_enable_params_t * p_ble_enable_params);
+
+/**@brief Function for getting the RAM split.
+ *
+ * @param[out] p_report RAM split. The sizes that are not known are 0.
+ */
+void ram_report_get(ram_report_t * p_report);
+
+/**@brief Function for logging the RAM split, and the RAM region for the linker script.
+ */
+void ram_report_log(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RAM_REPORT_H__
+
+/** @} */
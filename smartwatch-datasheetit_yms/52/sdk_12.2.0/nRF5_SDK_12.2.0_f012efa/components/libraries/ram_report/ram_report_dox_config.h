@@ -0,0 +1,16 @@
+/**
+ *
+ * @defgroup ram_report_config RAM report configuration
+ * @{
+ * @ingroup ram_report
+ */
+/** @brief Enabling the RAM report
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define RAM_REPORT_ENABLED
+
+
+/** @} */
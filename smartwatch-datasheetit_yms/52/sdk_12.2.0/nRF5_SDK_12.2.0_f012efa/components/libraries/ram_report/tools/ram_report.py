@@ -0,0 +1,174 @@
+#!/usr/bin/env python
+# Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+#
+# The information contained herein is property of Nordic Semiconductor ASA.
+# Terms and conditions of usage are described in detail in NORDIC
+# SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+#
+# Licensees are granted free, non-transferable use of the information. NO
+# WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+# the file.
+
+"""RAM report of a GCC build.
+
+Reads the map file of the application (-Wl,-Map=app.map) and prints how the RAM is
+split between the SoftDevice, the static variables of each object file, the heap and
+the stack. With the requirement of the SoftDevice, as logged by ram_report_log() on the
+first boot of the configuration, it also prints the RAM region for the linker script.
+
+Usage:
+    ram_report.py app.map
+    ram_report.py app.map --sd-ram-base 0x20001fe8
+    ram_report.py app.map --sd-ram-base 0x20001fe8 --ld app_gcc_nrf52.ld
+"""
+
+from __future__ import print_function
+
+import argparse
+import os
+import re
+import sys
+
+RAM_START   = 0x20000000
+REGION_RAM  = 'RAM'
+
+RE_REGION   = re.compile(r'^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)')
+RE_INPUT    = re.compile(r'^ (\S+)?\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$')
+RE_NAME     = re.compile(r'^ (\S+)$')
+RE_LD_RAM   = re.compile(r'^(\s*RAM\s*\([^)]*\)\s*:\s*ORIGIN\s*=\s*)0x[0-9a-fA-F]+'
+                         r'(\s*,\s*LENGTH\s*=\s*)0x[0-9a-fA-F]+', re.MULTILINE)
+
+
+def object_name(path):
+    """Short name of an input file: the member of an archive, or the base name."""
+    path = path.strip()
+    member = re.match(r'.*\((.*)\)$', path)
+    if member:
+        return member.group(1)
+    return os.path.basename(path)
+
+
+def parse_map(lines):
+    """Returns the RAM region and the RAM of each input section, by kind and object."""
+    ram       = None
+    objects   = {}
+    heap      = 0
+    stack     = 0
+    fill      = 0
+    in_memory = False
+    in_layout = False
+    pending   = None
+
+    for line in lines:
+        line = line.rstrip('\r\n')
+
+        if line.startswith('Memory Configuration'):
+            in_memory = True
+            continue
+        if line.startswith('Linker script and memory map'):
+            in_memory = False
+            in_layout = True
+            continue
+
+        if in_memory:
+            match = RE_REGION.match(line)
+            if match and match.group(1) == REGION_RAM:
+                ram = (int(match.group(2), 16), int(match.group(3), 16))
+            continue
+
+        if not in_layout or ram is None:
+            continue
+
+        # Long section names are on a line of their own.
+        match = RE_NAME.match(line)
+        if match:
+            pending = match.group(1)
+            continue
+
+        match = RE_INPUT.match(line)
+        if not match:
+            pending = None
+            continue
+
+        name    = match.group(1) or pending
+        address = int(match.group(2), 16)
+        size    = int(match.group(3), 16)
+        pending = None
+
+        if name is None or size == 0 or not (ram[0] <= address < ram[0] + ram[1]):
+            continue
+
+        if name == '*fill*':
+            fill += size
+        elif name.startswith('.heap'):
+            heap += size
+        elif name.startswith('.stack'):
+            stack += size
+        else:
+            obj = object_name(match.group(4))
+            objects[obj] = objects.get(obj, 0) + size
+
+    return ram, objects, heap, stack, fill
+
+
+def print_report(ram, objects, heap, stack, fill, top):
+    static = sum(objects.values())
+    unused = ram[1] - static - heap - stack - fill
+
+    print('RAM: %d bytes, application from 0x%08x' % (ram[0] + ram[1] - RAM_START, ram[0]))
+    print('  SoftDevice: %7d' % (ram[0] - RAM_START))
+    print('  Static:     %7d' % static)
+    print('  Heap:       %7d' % heap)
+    print('  Stack:      %7d' % stack)
+    print('  Padding:    %7d' % fill)
+    print('  Unused:     %7d' % unused)
+    print()
+    print('Static RAM by object file:')
+    for obj, size in sorted(objects.items(), key=lambda item: -item[1])[:top]:
+        print('  %7d  %s' % (size, obj))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('map', help='map file of the application')
+    parser.add_argument('--sd-ram-base', type=lambda value: int(value, 0),
+                        help='requirement of the SoftDevice, as logged by ram_report_log()')
+    parser.add_argument('--ld', help='linker script of which to update the RAM region')
+    parser.add_argument('--top', type=int, default=20, help='number of object files to list')
+    args = parser.parse_args()
+
+    with open(args.map) as map_file:
+        ram, objects, heap, stack, fill = parse_map(map_file)
+
+    if ram is None:
+        sys.exit('%s: no %s region in the memory configuration' % (args.map, REGION_RAM))
+
+    print_report(ram, objects, heap, stack, fill, args.top)
+
+    if args.sd_ram_base is None:
+        return
+
+    ram_end = ram[0] + ram[1]
+    origin  = args.sd_ram_base
+    length  = ram_end - origin
+
+    print()
+    if origin < ram[0]:
+        print('%d bytes are never used by the SoftDevice.' % (ram[0] - origin))
+    elif origin > ram[0]:
+        print('The SoftDevice needs %d bytes more.' % (origin - ram[0]))
+    print('  RAM (rwx) : ORIGIN = 0x%x, LENGTH = 0x%x' % (origin, length))
+
+    if args.ld:
+        with open(args.ld) as ld_file:
+            script = ld_file.read()
+        script, count = RE_LD_RAM.subn(r'\g<1>0x%x\g<2>0x%x' % (origin, length), script)
+        if count != 1:
+            sys.exit('%s: no single RAM region to update' % args.ld)
+        with open(args.ld, 'w') as ld_file:
+            ld_file.write(script)
+        print('Updated %s.' % args.ld)
+
+
+if __name__ == '__main__':
+    main()
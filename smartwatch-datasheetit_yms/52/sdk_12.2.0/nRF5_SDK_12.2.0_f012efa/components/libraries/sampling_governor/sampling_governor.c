@@ -0,0 +1,263 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(SAMPLING_GOVERNOR)
+#include "sampling_governor.h"
+#include "app_timer.h"
+#include "app_util_platform.h"
+
+static struct
+{
+    sampling_governor_client_t * p_clients;     /**< Registered clients. */
+    sampling_governor_ui_t       ui;
+    volatile bool                motion;
+    uint32_t                     motion_ticks;  /**< Time of the last motion report, in app_timer ticks. */
+    uint32_t                     hold_ticks;
+    uint32_t                     budget_ua;
+    uint32_t                     current_ua;    /**< Current of the chosen modes. */
+    bool                         updating;      /**< The modes are being chosen and applied. */
+    bool                         update_pending;
+} m_cb;
+
+APP_TIMER_DEF(m_motion_timer);
+
+
+/**@brief Function for choosing the mode of every client, in its target. */
+static void modes_choose(void)
+{
+    sampling_governor_state_t    state = sampling_governor_state_get();
+    sampling_governor_client_t * p_client;
+    uint32_t                     total = 0;
+
+    for (p_client = m_cb.p_clients; p_client != NULL; p_client = p_client->p_next)
+    {
+        p_client->target = p_client->burst ? SAMPLING_GOVERNOR_MODE_BURST :
+                                             p_client->p_config->modes[state];
+        total += p_client->p_config->current_ua[p_client->target];
+    }
+
+    while (total > m_cb.budget_ua)
+    {
+        sampling_governor_client_t * p_lowest = NULL;
+
+        for (p_client = m_cb.p_clients; p_client != NULL; p_client = p_client->p_next)
+        {
+            if ((p_client->target > p_client->p_config->min_mode) &&
+                ((p_lowest == NULL) || (p_client->p_config->priority < p_lowest->p_config->priority)))
+            {
+                p_lowest = p_client;
+            }
+        }
+        if (p_lowest == NULL)
+        {
+            // All clients are at their lowest mode.
+            break;
+        }
+
+        total -= p_lowest->p_config->current_ua[p_lowest->target];
+        p_lowest->target--;
+        total += p_lowest->p_config->current_ua[p_lowest->target];
+    }
+
+    m_cb.current_ua = total;
+}
+
+
+/**@brief Function for choosing the modes and calling the handlers of the clients whose mode
+ *        changed.
+ *
+ * @details A change made while a handler runs, from an interrupt or from the handler, is applied
+ *          before the function returns, by the call that was running.
+ */
+static void update(void)
+{
+    bool run;
+
+    CRITICAL_REGION_ENTER();
+    m_cb.update_pending = true;
+    run                 = !m_cb.updating;
+    m_cb.updating       = true;
+    CRITICAL_REGION_EXIT();
+
+    while (run)
+    {
+        CRITICAL_REGION_ENTER();
+        run                 = m_cb.update_pending;
+        m_cb.update_pending = false;
+        m_cb.updating       = run;
+        if (run)
+        {
+            modes_choose();
+        }
+        CRITICAL_REGION_EXIT();
+
+        for (sampling_governor_client_t * p_client = m_cb.p_clients;
+             run && (p_client != NULL);
+             p_client = p_client->p_next)
+        {
+            if (p_client->mode != p_client->target)
+            {
+                p_client->mode = p_client->target;
+                p_client->p_config->handler(p_client->mode, p_client->p_config->p_context);
+            }
+        }
+    }
+}
+
+
+static void motion_timeout_handler(void * p_context)
+{
+    uint32_t elapsed;
+
+    UNUSED_PARAMETER(p_context);
+
+    CRITICAL_REGION_ENTER();
+    (void)app_timer_cnt_diff_compute(app_timer_cnt_get(), m_cb.motion_ticks, &elapsed);
+    CRITICAL_REGION_EXIT();
+
+    // Reports do not restart the timer: it is started again for the rest of the time.
+    if (elapsed + APP_TIMER_MIN_TIMEOUT_TICKS < m_cb.hold_ticks)
+    {
+        APP_ERROR_CHECK(app_timer_start(m_motion_timer, m_cb.hold_ticks - elapsed, NULL));
+        return;
+    }
+
+    m_cb.motion = false;
+    update();
+}
+
+
+ret_code_t sampling_governor_init(uint32_t prescaler)
+{
+    memset(&m_cb, 0, sizeof(m_cb));
+    m_cb.ui         = SAMPLING_GOVERNOR_UI_OFF;
+    m_cb.budget_ua  = UINT32_MAX;
+    m_cb.hold_ticks = APP_TIMER_TICKS(SAMPLING_GOVERNOR_CONFIG_MOTION_HOLD_MS, prescaler);
+    m_cb.hold_ticks = MAX(m_cb.hold_ticks, APP_TIMER_MIN_TIMEOUT_TICKS);
+
+    return app_timer_create(&m_motion_timer, APP_TIMER_MODE_SINGLE_SHOT, motion_timeout_handler);
+}
+
+
+ret_code_t sampling_governor_client_register(sampling_governor_client_t              * p_client,
+                                             sampling_governor_client_config_t const * p_config)
+{
+    VERIFY_PARAM_NOT_NULL(p_client);
+    VERIFY_PARAM_NOT_NULL(p_config);
+    VERIFY_PARAM_NOT_NULL(p_config->handler);
+
+    if (p_config->min_mode >= SAMPLING_GOVERNOR_MODE_COUNT)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    for (uint32_t i = 0; i < SAMPLING_GOVERNOR_STATE_COUNT; i++)
+    {
+        if (p_config->modes[i] >= SAMPLING_GOVERNOR_MODE_COUNT)
+        {
+            return NRF_ERROR_INVALID_PARAM;
+        }
+    }
+
+    p_client->p_config = p_config;
+    // No mode yet, so that the handler is called with the first one.
+    p_client->mode     = SAMPLING_GOVERNOR_MODE_COUNT;
+    p_client->target   = SAMPLING_GOVERNOR_MODE_COUNT;
+    p_client->burst    = false;
+
+    CRITICAL_REGION_ENTER();
+    p_client->p_next = m_cb.p_clients;
+    m_cb.p_clients   = p_client;
+    CRITICAL_REGION_EXIT();
+
+    update();
+    return NRF_SUCCESS;
+}
+
+
+void sampling_governor_ui_set(sampling_governor_ui_t ui)
+{
+    if (m_cb.ui != ui)
+    {
+        m_cb.ui = ui;
+        update();
+    }
+}
+
+
+void sampling_governor_motion_report(void)
+{
+    bool started;
+
+    CRITICAL_REGION_ENTER();
+    m_cb.motion_ticks = app_timer_cnt_get();
+    started           = !m_cb.motion;
+    m_cb.motion       = true;
+    CRITICAL_REGION_EXIT();
+
+    if (started)
+    {
+        APP_ERROR_CHECK(app_timer_start(m_motion_timer, m_cb.hold_ticks, NULL));
+        update();
+    }
+}
+
+
+void sampling_governor_burst_set(sampling_governor_client_t * p_client, bool burst)
+{
+    ASSERT(p_client != NULL);
+
+    if (p_client->burst != burst)
+    {
+        p_client->burst = burst;
+        update();
+    }
+}
+
+
+void sampling_governor_budget_set(uint32_t budget_ua)
+{
+    if (m_cb.budget_ua != budget_ua)
+    {
+        m_cb.budget_ua = budget_ua;
+        update();
+    }
+}
+
+
+sampling_governor_state_t sampling_governor_state_get(void)
+{
+    if (m_cb.ui == SAMPLING_GOVERNOR_UI_INTERACTIVE)
+    {
+        return SAMPLING_GOVERNOR_STATE_INTERACTION;
+    }
+    if (m_cb.ui == SAMPLING_GOVERNOR_UI_ON)
+    {
+        return SAMPLING_GOVERNOR_STATE_DISPLAY;
+    }
+    return m_cb.motion ? SAMPLING_GOVERNOR_STATE_MOTION : SAMPLING_GOVERNOR_STATE_REST;
+}
+
+
+sampling_governor_mode_t sampling_governor_mode_get(sampling_governor_client_t const * p_client)
+{
+    ASSERT(p_client != NULL);
+
+    return p_client->mode;
+}
+
+
+uint32_t sampling_governor_current_get(void)
+{
+    return m_cb.current_ua;
+}
+
+#endif // NRF_MODULE_ENABLED(SAMPLING_GOVERNOR)
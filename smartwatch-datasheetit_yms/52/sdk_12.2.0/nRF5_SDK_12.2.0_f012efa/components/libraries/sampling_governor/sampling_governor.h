@@ -0,0 +1,186 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup sampling_governor Sampling governor
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for choosing the sampling modes of sensor drivers within a current budget.
+ *
+ * @details Every sampling module, like an SAADC stream, a touch sensor, the crown, a TWI sensor
+ *          read by @ref hw_sampler or the buttons, is registered as a client. A client has four
+ *          modes (off, idle, active and burst), the average current it draws in each of them, and
+ *          the mode it should be in for each state of the system. Its mode handler changes the
+ *          rate of the driver, for example with @ref nrf_drv_saadc_stream_period_set,
+ *          @ref nrf_csense_ticks_set, @ref nrf_drv_qdec_sampleper_set, @ref hw_sampler_period_set
+ *          or @ref app_button_detection_delay_set, without initializing it again.
+ *
+ *          The state of the system comes from the UI state, set with @ref sampling_governor_ui_set,
+ *          and from motion, reported with @ref sampling_governor_motion_report. Motion is kept for
+ *          @ref SAMPLING_GOVERNOR_CONFIG_MOTION_HOLD_MS after the last report. A client can also
+ *          ask for its burst mode for a while, for example for a measurement on demand.
+ *
+ *          If the modes asked for draw more than the budget set with
+ *          @ref sampling_governor_budget_set, for example from the battery level, clients are moved
+ *          down one mode at a time, from the lowest priority on, until the budget is met or all
+ *          clients are at their lowest allowed mode.
+ *
+ * @note The module uses the app_timer module. Mode handlers are called from the function that
+ *       changed the state, or from the app_timer interrupt when motion ends.
+ */
+
+#ifndef SAMPLING_GOVERNOR_H__
+#define SAMPLING_GOVERNOR_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Time motion is kept after it was last reported, in milliseconds.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef SAMPLING_GOVERNOR_CONFIG_MOTION_HOLD_MS
+#define SAMPLING_GOVERNOR_CONFIG_MOTION_HOLD_MS 5000
+#endif
+
+/**@brief Sampling modes of a client, from the lowest current to the highest. */
+typedef enum
+{
+    SAMPLING_GOVERNOR_MODE_OFF,    /**< Not sampling. */
+    SAMPLING_GOVERNOR_MODE_IDLE,   /**< Slow sampling, enough to detect activity. */
+    SAMPLING_GOVERNOR_MODE_ACTIVE, /**< Normal sampling. */
+    SAMPLING_GOVERNOR_MODE_BURST,  /**< Fastest sampling, for short times. */
+    SAMPLING_GOVERNOR_MODE_COUNT
+} sampling_governor_mode_t;
+
+/**@brief UI states. */
+typedef enum
+{
+    SAMPLING_GOVERNOR_UI_OFF,         /**< The display is off. */
+    SAMPLING_GOVERNOR_UI_ON,          /**< The display is on. */
+    SAMPLING_GOVERNOR_UI_INTERACTIVE, /**< The user is interacting with the device. */
+} sampling_governor_ui_t;
+
+/**@brief States of the system, from the UI state and from motion. */
+typedef enum
+{
+    SAMPLING_GOVERNOR_STATE_REST,        /**< The display is off, and no motion. */
+    SAMPLING_GOVERNOR_STATE_MOTION,      /**< The display is off, with motion. */
+    SAMPLING_GOVERNOR_STATE_DISPLAY,     /**< The display is on. */
+    SAMPLING_GOVERNOR_STATE_INTERACTION, /**< The user is interacting with the device. */
+    SAMPLING_GOVERNOR_STATE_COUNT
+} sampling_governor_state_t;
+
+/**@brief Mode handler type. The handler changes the sampling of the client to the new mode.
+ *
+ * @param[in] mode      New mode.
+ * @param[in] p_context Context of the client.
+ */
+typedef void (* sampling_governor_mode_handler_t)(sampling_governor_mode_t mode, void * p_context);
+
+/**@brief Configuration of a client. */
+typedef struct
+{
+    sampling_governor_mode_handler_t handler;                                  /**< Mode handler. */
+    void                           * p_context;                                /**< Context passed to the mode handler. */
+    uint32_t                         current_ua[SAMPLING_GOVERNOR_MODE_COUNT]; /**< Average current in each mode, in microamperes. */
+    sampling_governor_mode_t         modes[SAMPLING_GOVERNOR_STATE_COUNT];     /**< Mode asked for in each state of the system. */
+    sampling_governor_mode_t         min_mode;                                 /**< Lowest mode the budget can move the client to. */
+    uint8_t                          priority;                                 /**< Clients with a lower priority are moved down first. */
+} sampling_governor_client_config_t;
+
+/**@brief Client. Its content must not be accessed by the application. */
+typedef struct sampling_governor_client_s
+{
+    sampling_governor_client_config_t const * p_config; /**< Configuration. */
+    sampling_governor_mode_t                  mode;     /**< Current mode. */
+    sampling_governor_mode_t                  target;   /**< Mode being chosen. */
+    bool                                      burst;    /**< Burst mode is asked for. */
+    struct sampling_governor_client_s       * p_next;   /**< Next registered client. */
+} sampling_governor_client_t;
+
+/**@brief Function for initializing the module.
+ *
+ * @details The UI is off, there is no motion, and the budget is not limited.
+ *
+ * @param[in] prescaler Prescaler of the app_timer module.
+ *
+ * @return Any error returned by app_timer.
+ */
+ret_code_t sampling_governor_init(uint32_t prescaler);
+
+/**@brief Function for registering a client. Its mode handler is called with its first mode.
+ *
+ * @param[out] p_client Client to register. Must stay valid while the module is running.
+ * @param[in]  p_config Configuration of the client. Must stay valid while the module is running.
+ *
+ * @retval NRF_SUCCESS             If the client was registered.
+ * @retval NRF_ERROR_NULL          If a NULL pointer was passed.
+ * @retval NRF_ERROR_INVALID_PARAM If a mode of the configuration was invalid.
+ */
+ret_code_t sampling_governor_client_register(sampling_governor_client_t              * p_client,
+                                             sampling_governor_client_config_t const * p_config);
+
+/**@brief Function for setting the UI state.
+ *
+ * @param[in] ui UI state.
+ */
+void sampling_governor_ui_set(sampling_governor_ui_t ui);
+
+/**@brief Function for reporting motion, for example from the interrupt of a motion detector.
+ *
+ * @details Motion is kept for @ref SAMPLING_GOVERNOR_CONFIG_MOTION_HOLD_MS after the last report.
+ */
+void sampling_governor_motion_report(void);
+
+/**@brief Function for asking for the burst mode of a client, or for ending it.
+ *
+ * @param[in] p_client Registered client.
+ * @param[in] burst    True to ask for the burst mode, false to go back to the mode of the state.
+ */
+void sampling_governor_burst_set(sampling_governor_client_t * p_client, bool burst);
+
+/**@brief Function for setting the current budget of all clients.
+ *
+ * @param[in] budget_ua Budget, in microamperes. UINT32_MAX to not limit the modes.
+ */
+void sampling_governor_budget_set(uint32_t budget_ua);
+
+/**@brief Function for getting the state of the system. */
+sampling_governor_state_t sampling_governor_state_get(void);
+
+/**@brief Function for getting the current mode of a client.
+ *
+ * @param[in] p_client Registered client.
+ */
+sampling_governor_mode_t sampling_governor_mode_get(sampling_governor_client_t const * p_client);
+
+/**@brief Function for getting the current drawn by all clients in their current modes.
+ *
+ * @return Current, in microamperes.
+ */
+uint32_t sampling_governor_current_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SAMPLING_GOVERNOR_H__
+
+/** @} */
@@ -0,0 +1,24 @@
+/**
+ *
+ * @defgroup sampling_governor_config Sampling governor configuration
+ * @{
+ * @ingroup sampling_governor
+ */
+/** @brief Enabling the sampling governor
+ *
+ *  Requires app_timer.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define SAMPLING_GOVERNOR_ENABLED
+
+/** @brief Time motion is kept after it was last reported, in milliseconds.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define SAMPLING_GOVERNOR_CONFIG_MOTION_HOLD_MS
+
+
+/** @} */
@@ -18,25 +18,53 @@
 #include "nrf_soc.h"
 #include "nrf_assert.h"
 #include "app_util_platform.h"
+#if NRF_MODULE_ENABLED(MEM_TELEMETRY)
+#include "mem_telemetry.h"
+#endif
+
+#ifndef APP_SCHEDULER_LANE_COUNT
+#define APP_SCHEDULER_LANE_COUNT 1
+#endif
+
+#ifndef APP_SCHEDULER_EXECUTE_BUDGET
+#define APP_SCHEDULER_EXECUTE_BUDGET 0
+#endif
+
+#ifndef APP_SCHEDULER_HISTORY_SIZE
+#define APP_SCHEDULER_HISTORY_SIZE 0
+#endif
+
+STATIC_ASSERT(APP_SCHEDULER_LANE_COUNT >= 1);
 
 /**@brief Structure for holding a scheduled event header. */
 typedef struct
 {
     app_sched_event_handler_t handler;          /**< Pointer to event handler to receive the event. */
     uint16_t                  event_data_size;  /**< Size of event data. */
+    volatile bool             is_ready;         /**< True when the event data has been filled in and the event can be executed. */
 } event_header_t;
 
 STATIC_ASSERT(sizeof(event_header_t) <= APP_SCHED_EVENT_HEADER_SIZE);
 
-static event_header_t * m_queue_event_headers;  /**< Array for holding the queue event headers. */
-static uint8_t        * m_queue_event_data;     /**< Array for holding the queue event data. */
-static volatile uint8_t m_queue_start_index;    /**< Index of queue entry at the start of the queue. */
-static volatile uint8_t m_queue_end_index;      /**< Index of queue entry at the end of the queue. */
-static uint16_t         m_queue_event_size;     /**< Maximum event size in queue. */
-static uint16_t         m_queue_size;           /**< Number of queue entries. */
-
+/**@brief Structure for holding the queue of one priority lane. */
+typedef struct
+{
+    event_header_t * p_event_headers;           /**< Array for holding the queue event headers. */
+    uint8_t        * p_event_data;              /**< Array for holding the queue event data. */
+    volatile uint8_t start_index;               /**< Index of queue entry at the start of the queue. */
+    volatile uint8_t end_index;                 /**< Index of queue entry at the end of the queue. */
+    uint16_t         event_size;                /**< Maximum event size in queue. */
+    uint16_t         queue_size;                /**< Number of queue entries. */
 #if APP_SCHEDULER_WITH_PROFILER
-static uint16_t m_max_queue_utilization;    /**< Maximum observed queue utilization. */
+    uint16_t         max_utilization;           /**< Maximum observed queue utilization. */
+#endif
+} sched_lane_t;
+
+static sched_lane_t m_lanes[APP_SCHEDULER_LANE_COUNT];  /**< Queues, in order of decreasing priority. */
+
+#if APP_SCHEDULER_HISTORY_SIZE
+static uint32_t m_history[APP_SCHEDULER_HISTORY_SIZE]; /**< Handlers of the latest executed events. */
+static uint32_t m_history_count;                       /**< Number of executed events, never reset. */
 #endif
 
 #if APP_SCHEDULER_WITH_PAUSE
@@ -46,57 +74,93 @@ static uint32_t m_scheduler_paused_counter = 0; /**< Counter storing the differe
 
 /**@brief Function for incrementing a queue index, and handle wrap-around.
  *
+ * @param[in]   p_lane  Queue the index belongs to.
  * @param[in]   index   Old index.
  *
  * @return      New (incremented) index.
  */
-static __INLINE uint8_t next_index(uint8_t index)
+static __INLINE uint8_t next_index(sched_lane_t const * p_lane, uint8_t index)
 {
-    return (index < m_queue_size) ? (index + 1) : 0;
+    return (index < p_lane->queue_size) ? (index + 1) : 0;
 }
 
 
-static __INLINE uint8_t app_sched_queue_full()
+static __INLINE uint8_t app_sched_queue_full(sched_lane_t const * p_lane)
 {
-  uint8_t tmp = m_queue_start_index;
-  return next_index(m_queue_end_index) == tmp;
+  uint8_t tmp = p_lane->start_index;
+  return next_index(p_lane, p_lane->end_index) == tmp;
 }
 
 /**@brief Macro for checking if a queue is full. */
-#define APP_SCHED_QUEUE_FULL() app_sched_queue_full()
+#define APP_SCHED_QUEUE_FULL(p_lane) app_sched_queue_full(p_lane)
 
 
-static __INLINE uint8_t app_sched_queue_empty()
+static __INLINE uint8_t app_sched_queue_empty(sched_lane_t const * p_lane)
 {
-  uint8_t tmp = m_queue_start_index;
-  return m_queue_end_index == tmp;
+  uint8_t tmp = p_lane->start_index;
+  return p_lane->end_index == tmp;
 }
 
 /**@brief Macro for checking if a queue is empty. */
-#define APP_SCHED_QUEUE_EMPTY() app_sched_queue_empty()
+#define APP_SCHED_QUEUE_EMPTY(p_lane) app_sched_queue_empty(p_lane)
 
 
-uint32_t app_sched_init(uint16_t event_size, uint16_t queue_size, void * p_event_buffer)
+/**@brief Function for setting up the queue of a lane in a buffer dimensioned using
+ *        APP_SCHED_BUF_SIZE().
+ */
+static void lane_init(sched_lane_t * p_lane,
+                      uint16_t       event_size,
+                      uint16_t       queue_size,
+                      void         * p_event_buffer)
 {
     uint16_t data_start_index = (queue_size + 1) * sizeof(event_header_t);
 
+    p_lane->p_event_headers = p_event_buffer;
+    p_lane->p_event_data    = &((uint8_t *)p_event_buffer)[data_start_index];
+    p_lane->end_index       = 0;
+    p_lane->start_index     = 0;
+    p_lane->event_size      = event_size;
+    p_lane->queue_size      = queue_size;
+
+#if APP_SCHEDULER_WITH_PROFILER
+    p_lane->max_utilization = 0;
+#endif
+}
+
+
+uint32_t app_sched_init(uint16_t event_size, uint16_t queue_size, void * p_event_buffer)
+{
     // Check that buffer is correctly aligned
     if (!is_word_aligned(p_event_buffer))
     {
         return NRF_ERROR_INVALID_PARAM;
     }
 
-    // Initialize event scheduler
-    m_queue_event_headers = p_event_buffer;
-    m_queue_event_data    = &((uint8_t *)p_event_buffer)[data_start_index];
-    m_queue_end_index     = 0;
-    m_queue_start_index   = 0;
-    m_queue_event_size    = event_size;
-    m_queue_size          = queue_size;
+    // Initialize event scheduler. Additional lanes must be initialized again.
+    memset(m_lanes, 0, sizeof(m_lanes));
+    lane_init(&m_lanes[0], event_size, queue_size, p_event_buffer);
 
-#if APP_SCHEDULER_WITH_PROFILER
-    m_max_queue_utilization = 0;
-#endif
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_sched_lane_init(uint8_t  lane,
+                             uint16_t event_size,
+                             uint16_t queue_size,
+                             void   * p_event_buffer)
+{
+    if ((lane == 0) || (lane >= APP_SCHEDULER_LANE_COUNT))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    // Check that buffer is correctly aligned
+    if (!is_word_aligned(p_event_buffer))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    lane_init(&m_lanes[lane], event_size, queue_size, p_event_buffer);
 
     return NRF_SUCCESS;
 }
@@ -104,77 +168,119 @@ uint32_t app_sched_init(uint16_t event_size, uint16_t queue_size, void * p_event
 
 uint16_t app_sched_queue_space_get()
 {
-    uint16_t start = m_queue_start_index;
-    uint16_t end   = m_queue_end_index;
-    uint16_t free_space = m_queue_size - ((end >= start) ?
-                           (end - start) : (m_queue_size + 1 - start + end));
+    uint16_t start = m_lanes[0].start_index;
+    uint16_t end   = m_lanes[0].end_index;
+    uint16_t free_space = m_lanes[0].queue_size - ((end >= start) ?
+                           (end - start) : (m_lanes[0].queue_size + 1 - start + end));
     return free_space;
 }
 
 
 #if APP_SCHEDULER_WITH_PROFILER
-static void queue_utilization_check(void)
+static void queue_utilization_check(sched_lane_t * p_lane)
 {
-    uint16_t start = m_queue_start_index;
-    uint16_t end   = m_queue_end_index;
+    uint16_t start = p_lane->start_index;
+    uint16_t end   = p_lane->end_index;
     uint16_t queue_utilization = (end >= start) ? (end - start) :
-        (m_queue_size + 1 - start + end);
+        (p_lane->queue_size + 1 - start + end);
 
-    if (queue_utilization > m_max_queue_utilization)
+    if (queue_utilization > p_lane->max_utilization)
     {
-        m_max_queue_utilization = queue_utilization;
+        p_lane->max_utilization = queue_utilization;
     }
 }
 
 uint16_t app_sched_queue_utilization_get(void)
 {
-    return m_max_queue_utilization;
+    return m_lanes[0].max_utilization;
 }
+
+#if NRF_MODULE_ENABLED(MEM_TELEMETRY)
+static void queue_telemetry_get(mem_telemetry_usage_t * p_usage)
+{
+    p_usage->peak     = m_lanes[0].max_utilization;
+    p_usage->capacity = m_lanes[0].queue_size;
+}
+
+MEM_TELEMETRY_CUSTOM_REGISTER(app_sched_queue, queue_telemetry_get);
+#endif
 #endif // APP_SCHEDULER_WITH_PROFILER
 
 
-uint32_t app_sched_event_put(void                    * p_event_data,
-                             uint16_t                  event_data_size,
-                             app_sched_event_handler_t handler)
+/**@brief Function for taking the entry at the end of a queue.
+ *
+ * @param[in]   p_lane   Queue to take the entry from.
+ *
+ * @return      Index of the entry, or 0xFFFF if the queue is full.
+ */
+static uint16_t event_index_alloc(sched_lane_t * p_lane)
 {
-    uint32_t err_code;
+    uint16_t event_index = 0xFFFF;
+
+    CRITICAL_REGION_ENTER();
 
-    if (event_data_size <= m_queue_event_size)
+    if (!APP_SCHED_QUEUE_FULL(p_lane))
     {
-        uint16_t event_index = 0xFFFF;
+        event_index       = p_lane->end_index;
+        p_lane->end_index = next_index(p_lane, p_lane->end_index);
 
-        CRITICAL_REGION_ENTER();
+        // The entry must not be executed before it has been filled in.
+        p_lane->p_event_headers[event_index].is_ready = false;
 
-        if (!APP_SCHED_QUEUE_FULL())
-        {
-            event_index       = m_queue_end_index;
-            m_queue_end_index = next_index(m_queue_end_index);
-
-        #if APP_SCHEDULER_WITH_PROFILER
-            // This function call must be protected with critical region because
-            // it modifies 'm_max_queue_utilization'.
-            queue_utilization_check();
-        #endif
-        }
+    #if APP_SCHEDULER_WITH_PROFILER
+        // This function call must be protected with critical region because
+        // it modifies 'max_utilization'.
+        queue_utilization_check(p_lane);
+    #endif
+    }
+
+    CRITICAL_REGION_EXIT();
+
+    return event_index;
+}
+
+
+uint32_t app_sched_lane_event_put(uint8_t                   lane,
+                                  void                    * p_event_data,
+                                  uint16_t                  event_data_size,
+                                  app_sched_event_handler_t handler)
+{
+    uint32_t       err_code;
+    sched_lane_t * p_lane;
+
+    if (lane >= APP_SCHEDULER_LANE_COUNT)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
 
-        CRITICAL_REGION_EXIT();
+    p_lane = &m_lanes[lane];
+
+    if (p_lane->p_event_headers == NULL)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if (event_data_size <= p_lane->event_size)
+    {
+        uint16_t event_index = event_index_alloc(p_lane);
 
         if (event_index != 0xFFFF)
         {
             // NOTE: This can be done outside the critical region since the event consumer will
-            //       always be called from the main loop, and will thus never interrupt this code.
-            m_queue_event_headers[event_index].handler = handler;
+            //       not execute the entry before it is marked as ready.
+            p_lane->p_event_headers[event_index].handler = handler;
             if ((p_event_data != NULL) && (event_data_size > 0))
             {
-                memcpy(&m_queue_event_data[event_index * m_queue_event_size],
+                memcpy(&p_lane->p_event_data[event_index * p_lane->event_size],
                        p_event_data,
                        event_data_size);
-                m_queue_event_headers[event_index].event_data_size = event_data_size;
+                p_lane->p_event_headers[event_index].event_data_size = event_data_size;
             }
             else
             {
-                m_queue_event_headers[event_index].event_data_size = 0;
+                p_lane->p_event_headers[event_index].event_data_size = 0;
             }
+            p_lane->p_event_headers[event_index].is_ready = true;
 
             err_code = NRF_SUCCESS;
         }
@@ -192,6 +298,83 @@ uint32_t app_sched_event_put(void                    * p_event_data,
 }
 
 
+uint32_t app_sched_event_put(void                    * p_event_data,
+                             uint16_t                  event_data_size,
+                             app_sched_event_handler_t handler)
+{
+    return app_sched_lane_event_put(0, p_event_data, event_data_size, handler);
+}
+
+
+uint32_t app_sched_event_reserve(uint8_t                   lane,
+                                 uint16_t                  event_data_size,
+                                 app_sched_event_handler_t handler,
+                                 void                   ** pp_event_data)
+{
+    sched_lane_t * p_lane;
+    uint16_t       event_index;
+
+    if ((lane >= APP_SCHEDULER_LANE_COUNT) || (pp_event_data == NULL))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    p_lane = &m_lanes[lane];
+
+    if (p_lane->p_event_headers == NULL)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if ((event_data_size == 0) || (event_data_size > p_lane->event_size))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    event_index = event_index_alloc(p_lane);
+    if (event_index == 0xFFFF)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    p_lane->p_event_headers[event_index].handler         = handler;
+    p_lane->p_event_headers[event_index].event_data_size = event_data_size;
+
+    *pp_event_data = &p_lane->p_event_data[event_index * p_lane->event_size];
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_sched_event_commit(void * p_event_data)
+{
+    for (uint32_t i = 0; i < APP_SCHEDULER_LANE_COUNT; i++)
+    {
+        sched_lane_t * p_lane   = &m_lanes[i];
+        uint8_t      * p_data   = p_event_data;
+        uint32_t       data_len = (uint32_t)(p_lane->queue_size + 1) * p_lane->event_size;
+
+        if ((p_lane->p_event_headers != NULL) &&
+            (p_data >= p_lane->p_event_data) &&
+            (p_data <  p_lane->p_event_data + data_len))
+        {
+            uint32_t offset = p_data - p_lane->p_event_data;
+
+            if ((offset % p_lane->event_size) != 0)
+            {
+                break;
+            }
+
+            p_lane->p_event_headers[offset / p_lane->event_size].is_ready = true;
+
+            return NRF_SUCCESS;
+        }
+    }
+
+    return NRF_ERROR_INVALID_ADDR;
+}
+
+
 #if APP_SCHEDULER_WITH_PAUSE
 void app_sched_pause(void)
 {
@@ -232,29 +415,86 @@ static __INLINE bool is_app_sched_paused(void)
 }
 
 
+/**@brief Function for finding the highest priority lane that has an event ready for execution.
+ *
+ * @details A lane whose first event is reserved but not yet committed is skipped, since its
+ *          events must be executed in order.
+ *
+ * @return    Pointer to the lane, or NULL if no event is ready.
+ */
+static sched_lane_t * ready_lane_get(void)
+{
+    for (uint32_t i = 0; i < APP_SCHEDULER_LANE_COUNT; i++)
+    {
+        sched_lane_t * p_lane = &m_lanes[i];
+
+        if (!APP_SCHED_QUEUE_EMPTY(p_lane) && p_lane->p_event_headers[p_lane->start_index].is_ready)
+        {
+            return p_lane;
+        }
+    }
+
+    return NULL;
+}
+
+
 void app_sched_execute(void)
 {
-    while (!is_app_sched_paused() && !APP_SCHED_QUEUE_EMPTY())
+    sched_lane_t * p_lane;
+#if APP_SCHEDULER_EXECUTE_BUDGET
+    uint32_t       budget = APP_SCHEDULER_EXECUTE_BUDGET;
+#endif
+
+    while (!is_app_sched_paused() && ((p_lane = ready_lane_get()) != NULL))
     {
+#if APP_SCHEDULER_EXECUTE_BUDGET
+        if (budget == 0)
+        {
+            // Leave the remaining events for the next call. Set the event register so that the
+            // main loop does not go to sleep before it calls this function again.
+            __SEV();
+            break;
+        }
+        budget--;
+#endif
+
         // Since this function is only called from the main loop, there is no
         // need for a critical region here, however a special care must be taken
         // regarding update of the queue start index (see the end of the loop).
-        uint16_t event_index = m_queue_start_index;
+        uint16_t event_index = p_lane->start_index;
 
         void * p_event_data;
         uint16_t event_data_size;
         app_sched_event_handler_t event_handler;
 
-        p_event_data = &m_queue_event_data[event_index * m_queue_event_size];
-        event_data_size = m_queue_event_headers[event_index].event_data_size;
-        event_handler   = m_queue_event_headers[event_index].handler;
+        p_event_data = &p_lane->p_event_data[event_index * p_lane->event_size];
+        event_data_size = p_lane->p_event_headers[event_index].event_data_size;
+        event_handler   = p_lane->p_event_headers[event_index].handler;
 
+#if APP_SCHEDULER_HISTORY_SIZE
+        // Recorded before the call, so that a handler that does not return is the latest.
+        m_history[m_history_count++ % APP_SCHEDULER_HISTORY_SIZE] = (uint32_t)event_handler;
+#endif
         event_handler(p_event_data, event_data_size);
 
         // Event processed, now it is safe to move the queue start index,
         // so the queue entry occupied by this event can be used to store
         // a next one.
-        m_queue_start_index = next_index(m_queue_start_index);
+        p_lane->start_index = next_index(p_lane, p_lane->start_index);
+    }
+}
+
+#if APP_SCHEDULER_HISTORY_SIZE
+uint32_t app_sched_history_get(uint32_t * p_handlers, uint32_t count)
+{
+    uint32_t total = m_history_count;
+
+    count = MIN(count, MIN(total, APP_SCHEDULER_HISTORY_SIZE));
+    for (uint32_t i = 0; i < count; i++)
+    {
+        p_handlers[i] = m_history[(total - 1 - i) % APP_SCHEDULER_HISTORY_SIZE];
     }
+    return count;
 }
+#endif // APP_SCHEDULER_HISTORY_SIZE
 #endif //NRF_MODULE_ENABLED(APP_SCHEDULER)
@@ -39,6 +39,14 @@
  *     scheduler's queue. The app_sched_execute() function will pull this event and call its
  *     handler in the main context.
  *
+ * @subsection app_scheduler_lanes Priority lanes:
+ *
+ *   If @ref APP_SCHEDULER_LANE_COUNT is greater than 1, each lane has its own queue. Lane 0 is
+ *   the queue set up by APP_SCHED_INIT() and used by app_sched_event_put(). Higher lanes have
+ *   lower priority, and are set up using APP_SCHED_LANE_INIT(). app_sched_execute() always
+ *   executes the next event of the highest priority lane that has one, so a burst of events in
+ *   a low priority lane does not delay events in a higher one.
+ *
  * @if (PERIPHERAL)
  * For an example usage of the scheduler, see the implementations of
  * @ref ble_sdk_app_hids_mouse and @ref ble_sdk_app_hids_keyboard.
@@ -96,6 +104,24 @@ typedef void (*app_sched_event_handler_t)(void * p_event_data, uint16_t event_si
         APP_ERROR_CHECK(ERR_CODE);                                                                 \
     } while (0)
 
+/**@brief Macro for initializing an additional priority lane of the event scheduler.
+ *
+ * @details Allocates and aligns the memory buffer for the lane like APP_SCHED_INIT() does. It
+ *          must be used after APP_SCHED_INIT().
+ *
+ * @param[in] LANE         Lane to initialize, from 1 to @ref APP_SCHEDULER_LANE_COUNT - 1.
+ * @param[in] EVENT_SIZE   Maximum size of events to be passed through this lane.
+ * @param[in] QUEUE_SIZE   Number of entries in the queue of the lane.
+ */
+#define APP_SCHED_LANE_INIT(LANE, EVENT_SIZE, QUEUE_SIZE)                                          \
+    do                                                                                             \
+    {                                                                                              \
+        static uint32_t APP_SCHED_BUF[CEIL_DIV(APP_SCHED_BUF_SIZE((EVENT_SIZE), (QUEUE_SIZE)),     \
+                                               sizeof(uint32_t))];                                 \
+        uint32_t ERR_CODE = app_sched_lane_init((LANE), (EVENT_SIZE), (QUEUE_SIZE), APP_SCHED_BUF);\
+        APP_ERROR_CHECK(ERR_CODE);                                                                 \
+    } while (0)
+
 /**@brief Function for initializing the Scheduler.
  *
  * @details It must be called before entering the main loop.
@@ -116,10 +142,35 @@ typedef void (*app_sched_event_handler_t)(void * p_event_data, uint16_t event_si
  */
 uint32_t app_sched_init(uint16_t max_event_size, uint16_t queue_size, void * p_evt_buffer);
 
+/**@brief Function for initializing an additional priority lane of the Scheduler.
+ *
+ * @details Lane 0 is initialized by @ref app_sched_init, which also resets all other lanes. This
+ *          function must therefore be called after it.
+ *
+ * @param[in]   lane             Lane to initialize, from 1 to @ref APP_SCHEDULER_LANE_COUNT - 1.
+ * @param[in]   max_event_size   Maximum size of events to be passed through this lane.
+ * @param[in]   queue_size       Number of entries in the queue of the lane.
+ * @param[in]   p_evt_buffer     Pointer to memory buffer for holding the queue. It must be
+ *                               dimensioned using the APP_SCHED_BUF_SIZE() macro. The buffer
+ *                               must be aligned to a 4 byte boundary.
+ *
+ * @retval      NRF_SUCCESS               Successful initialization.
+ * @retval      NRF_ERROR_INVALID_PARAM   Invalid lane, or buffer not aligned to a 4 byte boundary.
+ */
+uint32_t app_sched_lane_init(uint8_t  lane,
+                             uint16_t max_event_size,
+                             uint16_t queue_size,
+                             void   * p_evt_buffer);
+
 /**@brief Function for executing all scheduled events.
  *
  * @details This function must be called from within the main loop. It will execute all events
- *          scheduled since the last time it was called.
+ *          scheduled since the last time it was called, highest priority lane first.
+ *
+ * @note If @ref APP_SCHEDULER_EXECUTE_BUDGET is not 0, at most that many events are executed per
+ *       call. If events are left, the CPU event register is set so that the next
+ *       sd_app_evt_wait() or __WFE() returns immediately and the main loop calls this function
+ *       again.
  */
 void app_sched_execute(void);
 
@@ -137,6 +188,56 @@ uint32_t app_sched_event_put(void *                    p_event_data,
                              uint16_t                  event_size,
                              app_sched_event_handler_t handler);
 
+/**@brief Function for scheduling an event in a given priority lane.
+ *
+ * @param[in]   lane           Lane to put the event in. 0 is the highest priority.
+ * @param[in]   p_event_data   Pointer to event data to be scheduled.
+ * @param[in]   event_size     Size of event data to be scheduled.
+ * @param[in]   handler        Event handler to receive the event.
+ *
+ * @retval      NRF_SUCCESS                If the event was scheduled.
+ * @retval      NRF_ERROR_INVALID_PARAM    If the lane does not exist.
+ * @retval      NRF_ERROR_INVALID_STATE    If the lane has not been initialized.
+ * @retval      NRF_ERROR_INVALID_LENGTH   If the event is larger than the lane allows.
+ * @retval      NRF_ERROR_NO_MEM           If the queue of the lane is full.
+ */
+uint32_t app_sched_lane_event_put(uint8_t                   lane,
+                                  void *                    p_event_data,
+                                  uint16_t                  event_size,
+                                  app_sched_event_handler_t handler);
+
+/**@brief Function for reserving an entry in the event queue, to be filled in place.
+ *
+ * @details Unlike @ref app_sched_lane_event_put, the event data is not copied. The caller writes
+ *          it directly into the queue through the returned pointer, and then calls
+ *          @ref app_sched_event_commit. Until then, neither this event nor any later event in the
+ *          same lane is executed.
+ *
+ * @param[in]   lane            Lane to put the event in. 0 is the highest priority.
+ * @param[in]   event_size      Size of event data to be scheduled. Must not be 0.
+ * @param[in]   handler         Event handler to receive the event.
+ * @param[out]  pp_event_data   Pointer to the reserved event data.
+ *
+ * @retval      NRF_SUCCESS                If the entry was reserved.
+ * @retval      NRF_ERROR_INVALID_PARAM    If the lane does not exist, or pp_event_data is NULL.
+ * @retval      NRF_ERROR_INVALID_STATE    If the lane has not been initialized.
+ * @retval      NRF_ERROR_INVALID_LENGTH   If the event size is 0 or larger than the lane allows.
+ * @retval      NRF_ERROR_NO_MEM           If the queue of the lane is full.
+ */
+uint32_t app_sched_event_reserve(uint8_t                   lane,
+                                 uint16_t                  event_size,
+                                 app_sched_event_handler_t handler,
+                                 void **                   pp_event_data);
+
+/**@brief Function for marking a reserved event as ready for execution.
+ *
+ * @param[in]   p_event_data   Pointer returned by @ref app_sched_event_reserve.
+ *
+ * @retval      NRF_SUCCESS               If the event was committed.
+ * @retval      NRF_ERROR_INVALID_ADDR    If p_event_data does not point to an event entry.
+ */
+uint32_t app_sched_event_commit(void * p_event_data);
+
 /**@brief Function for getting the maximum observed queue utilization.
  *
  * Function for tuning the module and determining QUEUE_SIZE value and thus module RAM usage.
@@ -156,6 +257,19 @@ uint16_t app_sched_queue_utilization_get(void);
  */
 uint16_t app_sched_queue_space_get(void);
 
+/**@brief Function for getting the handlers of the latest executed events.
+ *
+ * @details Can be called from a fault handler, to find the event that was being executed.
+ *
+ * @note @ref APP_SCHEDULER_HISTORY_SIZE must not be 0 to use this functionality.
+ *
+ * @param[out] p_handlers Addresses of the event handlers, the latest first.
+ * @param[in]  count      Size of p_handlers.
+ *
+ * @return Number of handlers written, at most @ref APP_SCHEDULER_HISTORY_SIZE.
+ */
+uint32_t app_sched_history_get(uint32_t * p_handlers, uint32_t count);
+
 /**@brief A function to pause the scheduler.
  *
  * @details When the scheduler is paused events are not pulled from the scheduler queue for
@@ -29,6 +29,30 @@
  */
 #define APP_SCHEDULER_WITH_PROFILER
 
+/** @brief Number of priority lanes
+ *
+ *  Each lane has its own queue. Lane 0 has the highest priority.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define APP_SCHEDULER_LANE_COUNT
+
+/** @brief Maximum number of events executed per app_sched_execute() call
+ *
+ *  Set to 0 for no limit.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define APP_SCHEDULER_EXECUTE_BUDGET
+
+/** @brief Number of executed events whose handlers are kept for app_sched_history_get()
+ *
+ *  Set to 0 to disable.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define APP_SCHEDULER_HISTORY_SIZE
+
 
 
 /** @} */
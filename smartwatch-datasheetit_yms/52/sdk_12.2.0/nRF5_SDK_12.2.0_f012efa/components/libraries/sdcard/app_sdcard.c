@@ -20,6 +20,7 @@
 #include "nrf_assert.h"
 
 #include "nrf_pt.h"
+#include <string.h>
 
 #define CMD_MASK  0x40
 #define ACMD_MASK 0x80
@@ -88,6 +89,24 @@
 #define SDC_CMD_BUF_LEN         16      /**< Size of a buffer for storing SDC commands. */
 #define SDC_WORK_BUF_LEN        16      /**< Size of a working buffer. */
 #define SDC_DATA_WAIT_TX_SIZE   16      /**< Number of bytes sent during data / busy wait. */
+#define SDC_CRC_LEN             2       /**< Length of a data block CRC. */
+#define SDC_PADDING_LEN         2       /**< Number of padding bytes after the last data block read. */
+#define SDC_DMA_CHUNK_LEN       128     /**< Length of one EasyDMA transfer of a data block in a transfer list. */
+#define SDC_LIST_LEN            4       /**< Maximum number of entries in a data block transfer list. */
+#define SDC_POLL_BUF_LEN        (SDC_CRC_LEN + SDC_R1_LEN + SDC_DATA_WAIT_TX_SIZE) /**< Size of a buffer for the CRC, response and wait bytes that follow a data block. */
+
+/**
+ * @brief Data blocks are sent with transfer lists if the SPI instance uses EasyDMA.
+ *
+ * A data block with its CRC and, in multiple block operations, the first bytes polled for the
+ * next data token or for the end of busy state, is then one transfer list, and the SPI event
+ * handler is called once per block instead of once per @ref SDC_SPI_MTU bytes.
+ */
+#if defined(NRF52) && CONCAT_3(SPI, APP_SDCARD_SPI_INSTANCE, _USE_EASY_DMA)
+#define SDC_USE_XFER_LIST       1
+#else
+#define SDC_USE_XFER_LIST       0
+#endif
 
 #define SDC_CS_ASSERT()   do { nrf_gpio_pin_clear(m_cb.cs_pin); } while (0) /**< Set CS pin to active state. */
 #define SDC_CS_DEASSERT() do { nrf_gpio_pin_set(m_cb.cs_pin);   } while (0) /**< Set CS pin to inactive state. */
@@ -188,6 +207,11 @@ typedef struct {
     uint8_t             rsp_buf[SDC_CMD_BUF_LEN];   ///< Card response buffer.
     uint8_t             work_buf[SDC_WORK_BUF_LEN]; ///< Working buffer
     uint8_t             cs_pin;                     ///< Chip select pin number.
+    app_sdc_stats_t     stats;                      ///< Operation counters.
+#if SDC_USE_XFER_LIST
+    nrf_drv_spi_list_entry_t list[SDC_LIST_LEN];    ///< Data block transfer list.
+    uint8_t             poll_buf[SDC_POLL_BUF_LEN]; ///< Bytes received after a data block.
+#endif
 } sdc_cb_t;
 
 static sdc_cb_t m_cb;   ///< SDC control block.
@@ -214,6 +238,89 @@ __STATIC_INLINE void sdc_spi_transfer(uint8_t const * const p_txb,
 }
 
 
+#if SDC_USE_XFER_LIST
+/**
+ * @brief Function for adding the transfers of a part of a data block to a transfer list.
+ *
+ * The part is split in an entry of repeated @ref SDC_DMA_CHUNK_LEN byte transfers and an entry
+ * for the rest.
+ *
+ * @param[out] p_list   Pointer to the first free list entry.
+ * @param[in]  p_txb    Pointer to the data to send, or NULL when receiving.
+ * @param[out] p_rxb    Pointer to the buffer for the received data, or NULL when sending.
+ * @param[in]  len      Length of the part.
+ *
+ * @return Number of entries added.
+ */
+static uint8_t sdc_list_add_data(nrf_drv_spi_list_entry_t * p_list,
+                                 uint8_t const * p_txb,
+                                 uint8_t * p_rxb,
+                                 uint16_t len)
+{
+    uint8_t count = 0;
+    uint16_t chunks = len / SDC_DMA_CHUNK_LEN;
+    uint8_t rest = len % SDC_DMA_CHUNK_LEN;
+
+    if (chunks)
+    {
+        p_list[count].xfer = (nrf_drv_spi_xfer_desc_t)NRF_DRV_SPI_XFER_TRX(
+                                 p_txb, p_txb ? SDC_DMA_CHUNK_LEN : 0,
+                                 p_rxb, p_rxb ? SDC_DMA_CHUNK_LEN : 0);
+        p_list[count].repeat = chunks;
+        p_list[count].ss_pin = NRF_DRV_SPI_PIN_NOT_USED;
+        p_list[count].flags  = 0;
+        ++count;
+    }
+
+    if (rest)
+    {
+        uint16_t offset = chunks * SDC_DMA_CHUNK_LEN;
+        p_list[count].xfer = (nrf_drv_spi_xfer_desc_t)NRF_DRV_SPI_XFER_TRX(
+                                 p_txb ? &p_txb[offset] : NULL, p_txb ? rest : 0,
+                                 p_rxb ? &p_rxb[offset] : NULL, p_rxb ? rest : 0);
+        p_list[count].repeat = 1;
+        p_list[count].ss_pin = NRF_DRV_SPI_PIN_NOT_USED;
+        p_list[count].flags  = 0;
+        ++count;
+    }
+
+    return count;
+}
+
+
+/**
+ * @brief Function for adding a transfer to a transfer list.
+ */
+static void sdc_list_add(nrf_drv_spi_list_entry_t * p_entry,
+                         uint8_t const * p_txb,
+                         uint8_t tx_len,
+                         uint8_t * p_rxb,
+                         uint8_t rx_len)
+{
+    p_entry->xfer   = (nrf_drv_spi_xfer_desc_t)NRF_DRV_SPI_XFER_TRX(p_txb, tx_len, p_rxb, rx_len);
+    p_entry->repeat = 1;
+    p_entry->ss_pin = NRF_DRV_SPI_PIN_NOT_USED;
+    p_entry->flags  = 0;
+}
+
+
+/**
+ * @brief Function for starting the data block transfer list.
+ *
+ * The SPI event handler is called once, with the buffers of the last entry.
+ *
+ * @param[in] count     Number of entries in the list.
+ */
+static void sdc_spi_list_transfer(uint8_t count)
+{
+    ASSERT(count <= SDC_LIST_LEN);
+    SDC_CS_ASSERT();
+    ret_code_t err_code = nrf_drv_spi_xfer_list(&m_spi, m_cb.list, count);
+    APP_ERROR_CHECK(err_code);
+}
+#endif
+
+
 /**
  * @brief Function for switching the SPI clock to high speed mode.
  */
@@ -419,11 +526,34 @@ static PT_THREAD(sdc_pt_sub_data_read(uint8_t * p_rx_data,
                 else
                 {
                     // Continue transfer until token is received.
+                    ++m_cb.stats.wait_polls;
                     sdc_spi_transfer(m_cb.cmd_buf, 1, m_cb.rsp_buf, SDC_DATA_WAIT_TX_SIZE);
                     PT_YIELD(SDC_PT_SUB);
                 }
             }
 
+#if SDC_USE_XFER_LIST
+            // Rest of the block and the CRC in one transfer list. The next data token is
+            // polled for in the same list, and the padding bytes follow the last block.
+            --m_cb.state.rw_op.blocks_left;
+            {
+                uint8_t count = sdc_list_add_data(m_cb.list, NULL, m_cb.state.rw_op.buffer,
+                                                  block_len - m_cb.state.rw_op.position);
+                sdc_list_add(&m_cb.list[count++], NULL, 0, m_cb.poll_buf,
+                             SDC_CRC_LEN + (m_cb.state.rw_op.blocks_left ? SDC_DATA_WAIT_TX_SIZE
+                                                                         : SDC_PADDING_LEN));
+                m_cb.cmd_buf[0] = SDC_EMPTY_BYTE;
+                m_cb.state.rw_op.buffer  += block_len - m_cb.state.rw_op.position;
+                m_cb.state.rw_op.position = block_len;
+                sdc_spi_list_transfer(count);
+            }
+            PT_YIELD(SDC_PT_SUB);
+
+            // Skip the CRC. The next data token is searched for in the rest.
+            p_rx_data += SDC_CRC_LEN;
+            rx_length -= SDC_CRC_LEN;
+        }
+#else
             while (m_cb.state.rw_op.position < block_len)
             {
                 {
@@ -458,6 +588,7 @@ static PT_THREAD(sdc_pt_sub_data_read(uint8_t * p_rx_data,
         sdc_spi_transfer(m_cb.cmd_buf, 1,
                          m_cb.rsp_buf, 2);
         PT_YIELD(SDC_PT_SUB);
+#endif
 
         m_cb.state.bus_state = SDC_BUS_IDLE;
         SDC_BREAK(SDC_PT_SUB, SDC_SUCCESS);
@@ -687,6 +818,21 @@ static PT_THREAD(sdc_pt_write(uint8_t * rx_data,
             m_cb.cmd_buf[0] = SDC_EMPTY_BYTE;
             m_cb.cmd_buf[1] = (m_cb.state.rw_op.block_count > 1) ? SDC_TOKEN_START_BLOCK_MULT
                                                            : SDC_TOKEN_START_BLOCK;
+#if SDC_USE_XFER_LIST
+            // Token, data block, dummy CRC, data response token and the first busy bytes
+            // in one transfer list.
+            {
+                uint8_t count = 0;
+                sdc_list_add(&m_cb.list[count++], m_cb.cmd_buf, 2, NULL, 0);
+                count += sdc_list_add_data(&m_cb.list[count], m_cb.state.rw_op.buffer, NULL,
+                                           SDC_SECTOR_SIZE);
+                sdc_list_add(&m_cb.list[count++], m_cb.cmd_buf, 1,
+                             m_cb.poll_buf, SDC_POLL_BUF_LEN);
+                m_cb.state.bus_state = SDC_BUS_DATA_WAIT;
+                sdc_spi_list_transfer(count);
+            }
+            PT_YIELD(SDC_PT);
+#else
             sdc_spi_transfer(m_cb.cmd_buf, 2, m_cb.rsp_buf, 2);
             PT_YIELD(SDC_PT);
 
@@ -707,16 +853,17 @@ static PT_THREAD(sdc_pt_write(uint8_t * rx_data,
                 }
                 PT_YIELD(SDC_PT);
             }
-            m_cb.state.rw_op.buffer += SDC_SECTOR_SIZE;
 
             // Send the dummy CRC (2 bytes) and receive data response token (1 byte).
             m_cb.state.bus_state = SDC_BUS_DATA_WAIT;
             sdc_spi_transfer(m_cb.cmd_buf, 1,
                              m_cb.rsp_buf, 3);
             PT_YIELD(SDC_PT);
+#endif
+            m_cb.state.rw_op.buffer += SDC_SECTOR_SIZE;
 
             {
-                uint8_t token = m_cb.rsp_buf[2] & SDC_TOKEN_DATA_RESP_MASK;
+                uint8_t token = rx_data[SDC_CRC_LEN] & SDC_TOKEN_DATA_RESP_MASK;
                 if (token != SDC_TOKEN_DATA_RESP_ACCEPTED)
                 {
                     if (token == SDC_TOKEN_DATA_RESP_CRC_ERR
@@ -731,6 +878,18 @@ static PT_THREAD(sdc_pt_write(uint8_t * rx_data,
                 }
             }
 
+#if SDC_USE_XFER_LIST
+            // Check the busy bytes received after the data response token.
+            for (uint32_t i = SDC_CRC_LEN + SDC_R1_LEN; i < rx_length; ++i)
+            {
+                if (rx_data[i] != 0x00)
+                {
+                    m_cb.state.bus_state = SDC_BUS_IDLE;
+                    break;
+                }
+            }
+#endif
+
             // Wait for the card to complete the write process.
             m_cb.state.retry_count = 0;
             while (m_cb.state.bus_state == SDC_BUS_DATA_WAIT)
@@ -741,6 +900,7 @@ static PT_THREAD(sdc_pt_write(uint8_t * rx_data,
                     SDC_BREAK(SDC_PT, SDC_ERROR_TIMEOUT);
                 }
 
+                ++m_cb.stats.wait_polls;
                 sdc_spi_transfer(m_cb.cmd_buf, 1,
                                  m_cb.rsp_buf, SDC_DATA_WAIT_TX_SIZE);
                 PT_YIELD(SDC_PT);
@@ -779,6 +939,7 @@ static PT_THREAD(sdc_pt_write(uint8_t * rx_data,
                     SDC_BREAK(SDC_PT, SDC_ERROR_TIMEOUT);
                 }
 
+                ++m_cb.stats.wait_polls;
                 sdc_spi_transfer(m_cb.cmd_buf, 1,
                                  m_cb.rsp_buf, SDC_DATA_WAIT_TX_SIZE);
                 PT_YIELD(SDC_PT);
@@ -810,6 +971,11 @@ static void spi_handler(nrf_drv_spi_evt_t const * p_event)
     uint8_t * rx_data = p_event->data.done.p_rx_buffer;
     uint8_t rx_length = p_event->data.done.rx_length;
 
+    if (m_cb.state.op == SDC_OP_READ || m_cb.state.op == SDC_OP_WRITE)
+    {
+        ++m_cb.stats.spi_events;
+    }
+
     if (!m_cb.state.rw_op.blocks_left)
     {
         // Deassert CS pin if not in active data transfer.
@@ -986,6 +1152,8 @@ ret_code_t app_sdc_block_read(uint8_t * p_buf, uint32_t block_address, uint16_t
     m_cb.state.rw_op.buffer = p_buf;
     m_cb.state.rw_op.block_count = block_count;
     m_cb.state.rw_op.blocks_left = block_count;
+    ++m_cb.stats.read_ops;
+    m_cb.stats.read_blocks += block_count;
 
     PT_INIT(&m_cb.state.pt);
     uint8_t command = (block_count > 1) ? CMD18 : CMD17;
@@ -1025,6 +1193,8 @@ ret_code_t app_sdc_block_write(uint8_t const * p_buf, uint32_t block_address, ui
     m_cb.state.rw_op.buffer = (uint8_t *) p_buf;
     m_cb.state.rw_op.block_count = block_count;
     m_cb.state.rw_op.blocks_left = block_count;
+    ++m_cb.stats.write_ops;
+    m_cb.stats.write_blocks += block_count;
 
     PT_INIT(&m_cb.state.pt);
     
@@ -1144,4 +1314,22 @@ app_sdc_info_t const * app_sdc_info_get(void)
     return NULL;
 }
 
+
+void app_sdc_stats_get(app_sdc_stats_t * p_stats)
+{
+    ASSERT(p_stats);
+
+    CRITICAL_REGION_ENTER();
+    *p_stats = m_cb.stats;
+    CRITICAL_REGION_EXIT();
+}
+
+
+void app_sdc_stats_clear(void)
+{
+    CRITICAL_REGION_ENTER();
+    memset(&m_cb.stats, 0, sizeof(m_cb.stats));
+    CRITICAL_REGION_EXIT();
+}
+
 #endif //APP_SDCARD_ENABLED
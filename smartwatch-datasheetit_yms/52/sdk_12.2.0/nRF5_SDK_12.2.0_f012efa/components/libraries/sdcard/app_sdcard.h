@@ -103,6 +103,20 @@ typedef struct {
     sdc_type_t  type;           ///< Card type information structure.
 } app_sdc_info_t;
 
+/**
+ * @brief SDC operation counters.
+ *
+ * The number of SPI events per data block shows how much CPU time is spent per block.
+ */
+typedef struct {
+    uint32_t    read_ops;       ///< Number of read operations started.
+    uint32_t    read_blocks;    ///< Number of data blocks requested by read operations.
+    uint32_t    write_ops;      ///< Number of write operations started.
+    uint32_t    write_blocks;   ///< Number of data blocks requested by write operations.
+    uint32_t    spi_events;     ///< Number of SPI events handled during read and write operations.
+    uint32_t    wait_polls;     ///< Number of SPI transfers polling for a data token or for the end of busy state.
+} app_sdc_stats_t;
+
 /**
  * @brief SDC event handler type.
  */
@@ -179,5 +193,19 @@ ret_code_t app_sdc_block_write(uint8_t const * p_buf, uint32_t block_address, ui
 app_sdc_info_t const * app_sdc_info_get(void);
 
 
+/**
+ * @brief Function for retrieving the operation counters.
+ *
+ * @param[out] p_stats          Pointer to the structure for the counters.
+ */
+void app_sdc_stats_get(app_sdc_stats_t * p_stats);
+
+
+/**
+ * @brief Function for clearing the operation counters.
+ */
+void app_sdc_stats_clear(void);
+
+
 #endif //APP_SDC_H_
 /** @} */
@@ -0,0 +1,204 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(SENSORSIM_REPLAY)
+#include "sensorsim_replay.h"
+#include <string.h>
+#include "SEGGER_RTT.h"
+
+
+/**@brief Function for reading the next value of the trace.
+ *
+ * @retval true  If a value was read.
+ * @retval false If the trace ended, or the RTT channel had no complete word.
+ */
+static bool value_read(sensorsim_replay_state_t * p_state, uint32_t * p_value)
+{
+    sensorsim_replay_cfg_t const * p_cfg = p_state->p_cfg;
+
+    if (p_cfg->source == SENSORSIM_REPLAY_SOURCE_FLASH)
+    {
+        if (p_state->pos >= p_cfg->trace_len)
+        {
+            if (!p_cfg->loop)
+            {
+                return false;
+            }
+            p_state->pos = 0;
+        }
+        *p_value = p_cfg->p_trace[p_state->pos++];
+        return true;
+    }
+
+    p_state->rtt_fill += SEGGER_RTT_Read(p_cfg->rtt_channel,
+                                         &p_state->rtt_word[p_state->rtt_fill],
+                                         sizeof(p_state->rtt_word) - p_state->rtt_fill);
+    if (p_state->rtt_fill < sizeof(p_state->rtt_word))
+    {
+        return false;
+    }
+    p_state->rtt_fill = 0;
+    *p_value = uint32_decode(p_state->rtt_word);
+    return true;
+}
+
+
+/**@brief Function for producing the next value, with its sequence number and time stamp. */
+static bool value_produce(sensorsim_replay_state_t * p_state, uint32_t * p_value)
+{
+    if (!value_read(p_state, p_value))
+    {
+        if (p_state->p_cfg->source == SENSORSIM_REPLAY_SOURCE_RTT)
+        {
+            p_state->stats.underruns++;
+        }
+        return false;
+    }
+
+    p_state->stamps[p_state->seq % SENSORSIM_REPLAY_CONFIG_PENDING] = app_timer_cnt_get();
+    p_state->seq++;
+    p_state->last = *p_value;
+    p_state->stats.produced++;
+    return true;
+}
+
+
+static void burst_timeout_handler(void * p_context)
+{
+    sensorsim_replay_state_t * p_state = (sensorsim_replay_state_t *)p_context;
+    uint32_t                   values[SENSORSIM_REPLAY_CONFIG_MAX_BURST];
+    uint16_t                   first_seq = p_state->seq;
+    uint8_t                    count;
+
+    for (count = 0; count < p_state->p_cfg->burst_size; count++)
+    {
+        if (!value_produce(p_state, &values[count]))
+        {
+            break;
+        }
+    }
+
+    if (count > 0)
+    {
+        p_state->p_cfg->handler(values, count, first_seq);
+    }
+}
+
+
+ret_code_t sensorsim_replay_init(sensorsim_replay_state_t * p_state, sensorsim_replay_cfg_t const * p_cfg)
+{
+    VERIFY_PARAM_NOT_NULL(p_state);
+    VERIFY_PARAM_NOT_NULL(p_cfg);
+    if (p_cfg->source == SENSORSIM_REPLAY_SOURCE_FLASH)
+    {
+        VERIFY_PARAM_NOT_NULL(p_cfg->p_trace);
+    }
+    if ((p_cfg->burst_size == 0) || (p_cfg->burst_size > SENSORSIM_REPLAY_CONFIG_MAX_BURST))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    memset(p_state, 0, sizeof(*p_state));
+    p_state->p_cfg = p_cfg;
+    sensorsim_replay_stats_reset(p_state);
+
+    if (p_cfg->handler == NULL)
+    {
+        return NRF_SUCCESS;
+    }
+    p_state->timer_id = &p_state->timer_data;
+    return app_timer_create(&p_state->timer_id,
+                            APP_TIMER_MODE_REPEATED,
+                            burst_timeout_handler);
+}
+
+
+ret_code_t sensorsim_replay_start(sensorsim_replay_state_t * p_state)
+{
+    sensorsim_replay_cfg_t const * p_cfg = p_state->p_cfg;
+
+    if (p_cfg->handler == NULL)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    return app_timer_start(p_state->timer_id,
+                           APP_TIMER_TICKS(p_cfg->interval_ms, p_cfg->timer_prescaler),
+                           p_state);
+}
+
+
+void sensorsim_replay_stop(sensorsim_replay_state_t * p_state)
+{
+    (void)app_timer_stop(p_state->timer_id);
+}
+
+
+uint32_t sensorsim_replay_measure(sensorsim_replay_state_t * p_state, uint16_t * p_seq)
+{
+    uint32_t value;
+    uint16_t seq = p_state->seq;
+
+    if (!value_produce(p_state, &value))
+    {
+        value = p_state->last;
+        seq--;
+    }
+    if (p_seq != NULL)
+    {
+        *p_seq = seq;
+    }
+    return value;
+}
+
+
+void sensorsim_replay_delivered(sensorsim_replay_state_t * p_state, uint16_t seq)
+{
+    uint16_t age = (uint16_t)(p_state->seq - seq);
+    uint32_t latency;
+
+    if ((age == 0) || (age > SENSORSIM_REPLAY_CONFIG_PENDING))
+    {
+        return;
+    }
+
+    (void)app_timer_cnt_diff_compute(app_timer_cnt_get(),
+                                     p_state->stamps[seq % SENSORSIM_REPLAY_CONFIG_PENDING],
+                                     &latency);
+
+    p_state->stats.delivered++;
+    p_state->latency_sum += latency;
+    p_state->stats.min    = MIN(p_state->stats.min, latency);
+    p_state->stats.max    = MAX(p_state->stats.max, latency);
+}
+
+
+void sensorsim_replay_stats_get(sensorsim_replay_state_t const * p_state, sensorsim_replay_stats_t * p_stats)
+{
+    *p_stats     = p_state->stats;
+    p_stats->avg = (p_state->stats.delivered == 0) ? 0
+                 : (uint32_t)(p_state->latency_sum / p_state->stats.delivered);
+    if (p_state->stats.delivered == 0)
+    {
+        p_stats->min = 0;
+    }
+}
+
+
+void sensorsim_replay_stats_reset(sensorsim_replay_state_t * p_state)
+{
+    memset(&p_state->stats, 0, sizeof(p_state->stats));
+    p_state->stats.min   = UINT32_MAX;
+    p_state->latency_sum = 0;
+}
+
+#endif // NRF_MODULE_ENABLED(SENSORSIM_REPLAY)
@@ -0,0 +1,183 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ble_sdk_lib_sensorsim_replay Recorded Sensor Data Replay
+ * @{
+ * @ingroup ble_sdk_lib_sensorsim
+ * @brief Functions for replaying recorded sensor data and measuring its latency.
+ *
+ * @details A trace of 32-bit values is replayed from flash, or received from the host on an RTT
+ *          down channel as little-endian words. Every interval, a burst of values is passed to
+ *          the handler, and each value is stamped with the RTC1 counter of @ref app_timer.
+ *
+ *          When a value has been delivered, for example when the notification that carried it is
+ *          reported by BLE_EVT_TX_COMPLETE, the application calls
+ *          @ref sensorsim_replay_delivered with its sequence number. The time since it was
+ *          produced is added to the latency statistics. The same trace and burst pattern can be
+ *          replayed to compare configurations.
+ *
+ *          The values can also be pulled one at a time with @ref sensorsim_replay_measure, in
+ *          place of @ref sensorsim_measure from the timer handler of an example.
+ */
+
+#ifndef SENSORSIM_REPLAY_H__
+#define SENSORSIM_REPLAY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "app_timer.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of values whose production time is kept for the latency measurement.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef SENSORSIM_REPLAY_CONFIG_PENDING
+#define SENSORSIM_REPLAY_CONFIG_PENDING 32
+#endif
+
+/** @brief Largest burst, in values.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef SENSORSIM_REPLAY_CONFIG_MAX_BURST
+#define SENSORSIM_REPLAY_CONFIG_MAX_BURST 16
+#endif
+
+/**@brief Trace sources. */
+typedef enum
+{
+    SENSORSIM_REPLAY_SOURCE_FLASH, /**< Array of values in flash. */
+    SENSORSIM_REPLAY_SOURCE_RTT,   /**< Little-endian words from an RTT down channel. */
+} sensorsim_replay_source_t;
+
+/**@brief Handler for a burst of values.
+ *
+ * @param[in] p_values  Values.
+ * @param[in] count     Number of values.
+ * @param[in] first_seq Sequence number of the first value. The others follow.
+ */
+typedef void (* sensorsim_replay_handler_t)(uint32_t const * p_values, uint8_t count, uint16_t first_seq);
+
+/**@brief Replay configuration. */
+typedef struct
+{
+    sensorsim_replay_source_t  source;           /**< Trace source. */
+    uint32_t const           * p_trace;          /**< Values, for @ref SENSORSIM_REPLAY_SOURCE_FLASH. */
+    uint32_t                   trace_len;        /**< Number of values, for @ref SENSORSIM_REPLAY_SOURCE_FLASH. */
+    bool                       loop;             /**< Restart at the first value after the last one. */
+    uint8_t                    rtt_channel;      /**< Down channel, for @ref SENSORSIM_REPLAY_SOURCE_RTT. It must be configured. */
+    uint32_t                   interval_ms;      /**< Time between two bursts. */
+    uint8_t                    burst_size;       /**< Values in a burst. */
+    uint32_t                   timer_prescaler;  /**< Prescaler of @ref app_timer. */
+    sensorsim_replay_handler_t handler;          /**< Handler for the bursts, or NULL to pull the values. */
+} sensorsim_replay_cfg_t;
+
+/**@brief Latency statistics, in RTC1 ticks of @ref app_timer. */
+typedef struct
+{
+    uint32_t produced;   /**< Values produced. */
+    uint32_t delivered;  /**< Values reported as delivered, with a latency. */
+    uint32_t underruns;  /**< Values missing from the RTT channel when a burst was due. */
+    uint32_t min;        /**< Lowest latency. */
+    uint32_t max;        /**< Highest latency. */
+    uint32_t avg;        /**< Average latency. */
+} sensorsim_replay_stats_t;
+
+/**@brief Replay state. */
+typedef struct
+{
+    sensorsim_replay_cfg_t const * p_cfg;                                /**< Configuration. */
+    app_timer_t                    timer_data;                           /**< Timer of the bursts. */
+    app_timer_id_t                 timer_id;                             /**< Identifier of @p timer_data. */
+    uint32_t                       pos;                                  /**< Next value of the flash trace. */
+    uint16_t                       seq;                                  /**< Sequence number of the next value. */
+    uint32_t                       last;                                 /**< Last value. */
+    uint8_t                        rtt_word[4];                          /**< Bytes of a word partly received over RTT. */
+    uint8_t                        rtt_fill;                             /**< Number of bytes in @p rtt_word. */
+    uint32_t                       stamps[SENSORSIM_REPLAY_CONFIG_PENDING]; /**< Production time of the last values. */
+    uint64_t                       latency_sum;                          /**< Sum of the latencies. */
+    sensorsim_replay_stats_t       stats;                                /**< Statistics. */
+} sensorsim_replay_state_t;
+
+
+/**@brief Function for initializing a replay.
+ *
+ * @param[out] p_state Replay state. It must be kept in memory.
+ * @param[in]  p_cfg   Configuration. It must be kept in memory.
+ *
+ * @retval NRF_SUCCESS             If the replay was initialized.
+ * @retval NRF_ERROR_NULL          If a parameter or the flash trace was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If the burst size was 0 or above @ref SENSORSIM_REPLAY_CONFIG_MAX_BURST.
+ * @return Other errors from app_timer_create.
+ */
+ret_code_t sensorsim_replay_init(sensorsim_replay_state_t * p_state, sensorsim_replay_cfg_t const * p_cfg);
+
+
+/**@brief Function for starting the bursts. Needs a handler in the configuration.
+ *
+ * @return Errors from app_timer_start.
+ */
+ret_code_t sensorsim_replay_start(sensorsim_replay_state_t * p_state);
+
+
+/**@brief Function for stopping the bursts. */
+void sensorsim_replay_stop(sensorsim_replay_state_t * p_state);
+
+
+/**@brief Function for getting the next value.
+ *
+ * @param[in,out] p_state Replay state.
+ * @param[out]    p_seq   Sequence number of the value. Can be NULL.
+ *
+ * @return The value. At the end of a trace that does not loop, or without RTT data, the last value
+ *         is repeated and no sequence number is used.
+ */
+uint32_t sensorsim_replay_measure(sensorsim_replay_state_t * p_state, uint16_t * p_seq);
+
+
+/**@brief Function for reporting that a value has reached its consumer.
+ *
+ * Values delivered after @ref SENSORSIM_REPLAY_CONFIG_PENDING newer values were produced are not
+ * accounted.
+ *
+ * @param[in,out] p_state Replay state.
+ * @param[in]     seq     Sequence number of the value.
+ */
+void sensorsim_replay_delivered(sensorsim_replay_state_t * p_state, uint16_t seq);
+
+
+/**@brief Function for getting the statistics.
+ *
+ * @param[in]  p_state Replay state.
+ * @param[out] p_stats Statistics.
+ */
+void sensorsim_replay_stats_get(sensorsim_replay_state_t const * p_state, sensorsim_replay_stats_t * p_stats);
+
+
+/**@brief Function for resetting the statistics. */
+void sensorsim_replay_stats_reset(sensorsim_replay_state_t * p_state);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SENSORSIM_REPLAY_H__
+
+/** @} */
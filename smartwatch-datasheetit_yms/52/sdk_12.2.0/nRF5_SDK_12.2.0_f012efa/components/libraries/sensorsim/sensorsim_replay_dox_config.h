@@ -0,0 +1,28 @@
+/**
+ *
+ * @defgroup sensorsim_replay_config sensorsim_replay module configuration
+ * @{
+ * @ingroup ble_sdk_lib_sensorsim_replay
+ */
+/** @brief Enabling sensorsim_replay module
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define SENSORSIM_REPLAY_ENABLED
+
+/** @brief Number of values whose production time is kept for the latency measurement.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define SENSORSIM_REPLAY_CONFIG_PENDING
+
+/** @brief Largest burst, in values.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define SENSORSIM_REPLAY_CONFIG_MAX_BURST
+
+
+/** @} */
@@ -41,19 +41,50 @@ static const uint32_t k[64] = {
 };
 
 
+/**@brief Load a big-endian word of the message. */
+#define LOAD_BE(p) (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | \
+                    ((uint32_t)(p)[2] << 8)  | ((uint32_t)(p)[3]))
+
+/**@brief Message schedule word i (16 or more), updated in place in a window of 16 words. */
+#define SCHED(m,i) ((m)[(i) & 15] += SIG1((m)[((i) - 2) & 15]) + (m)[((i) - 7) & 15] + \
+                                     SIG0((m)[((i) - 15) & 15]))
+
+/**@brief One round. The working variables are renamed by the caller instead of being moved. */
+#define ROUND(a,b,c,d,e,f,g,h,ki,wi)                            \
+    do {                                                        \
+        uint32_t t1 = (h) + EP1(e) + CH(e,f,g) + (ki) + (wi);   \
+        (d) += t1;                                              \
+        (h)  = t1 + EP0(a) + MAJ(a,b,c);                        \
+    } while (0)
+
+/**@brief Eight rounds, after which the working variables are back in place. */
+#define ROUNDS_8(i, W)                                              \
+    do {                                                            \
+        ROUND(a,b,c,d,e,f,g,h,k[(i) + 0],W((i) + 0));              \
+        ROUND(h,a,b,c,d,e,f,g,k[(i) + 1],W((i) + 1));              \
+        ROUND(g,h,a,b,c,d,e,f,k[(i) + 2],W((i) + 2));              \
+        ROUND(f,g,h,a,b,c,d,e,k[(i) + 3],W((i) + 3));              \
+        ROUND(e,f,g,h,a,b,c,d,k[(i) + 4],W((i) + 4));              \
+        ROUND(d,e,f,g,h,a,b,c,k[(i) + 5],W((i) + 5));              \
+        ROUND(c,d,e,f,g,h,a,b,k[(i) + 6],W((i) + 6));              \
+        ROUND(b,c,d,e,f,g,h,a,k[(i) + 7],W((i) + 7));              \
+    } while (0)
+
+#define W_LOAD(i)  (m[(i)] = LOAD_BE(&data[(i) * 4]))
+#define W_SCHED(i) SCHED(m, (i))
+
+
 /**@brief Function for calculating the hash of a 64-byte section of data.
+ *
+ * @details The rounds are unrolled by eight, and the message schedule is computed along the
+ *          rounds in a window of 16 words, so that it is not stored for all 64 rounds.
  *
  * @param[in,out] ctx   Hash instance.
  * @param[in]     data  Aray with data to be hashed. Assumed to be 64 bytes long.
  */
 void sha256_transform(sha256_context_t *ctx, const uint8_t * data)
 {
-    uint32_t a, b, c, d, e, f, g, h, i, j, t1, t2, m[64];
-
-    for (i = 0, j = 0; i < 16; ++i, j += 4)
-        m[i] = (data[j] << 24) | (data[j + 1] << 16) | (data[j + 2] << 8) | (data[j + 3]);
-    for ( ; i < 64; ++i)
-        m[i] = SIG1(m[i - 2]) + m[i - 7] + SIG0(m[i - 15]) + m[i - 16];
+    uint32_t a, b, c, d, e, f, g, h, i, m[16];
 
     a = ctx->state[0];
     b = ctx->state[1];
@@ -64,17 +95,11 @@ void sha256_transform(sha256_context_t *ctx, const uint8_t * data)
     g = ctx->state[6];
     h = ctx->state[7];
 
-    for (i = 0; i < 64; ++i) {
-        t1 = h + EP1(e) + CH(e,f,g) + k[i] + m[i];
-        t2 = EP0(a) + MAJ(a,b,c);
-        h = g;
-        g = f;
-        f = e;
-        e = d + t1;
-        d = c;
-        c = b;
-        b = a;
-        a = t1 + t2;
+    ROUNDS_8(0, W_LOAD);
+    ROUNDS_8(8, W_LOAD);
+
+    for (i = 16; i < 64; i += 8) {
+        ROUNDS_8(i, W_SCHED);
     }
 
     ctx->state[0] += a;
@@ -115,18 +140,34 @@ ret_code_t sha256_update(sha256_context_t *ctx, const uint8_t * data, size_t len
         return NRF_ERROR_NULL;
     }
 
-    uint32_t i;
+    // Complete the buffered block first.
+    if (ctx->datalen > 0) {
+        size_t n = MIN(len, 64 - ctx->datalen);
 
-    for (i = 0; i < len; ++i) {
-        ctx->data[ctx->datalen] = data[i];
-        ctx->datalen++;
-        if (ctx->datalen == 64) {
-            sha256_transform(ctx, ctx->data);
-            ctx->bitlen += 512;
-            ctx->datalen = 0;
+        memcpy(&ctx->data[ctx->datalen], data, n);
+        ctx->datalen += n;
+        data         += n;
+        len          -= n;
+
+        if (ctx->datalen < 64) {
+            return NRF_SUCCESS;
         }
+        sha256_transform(ctx, ctx->data);
+        ctx->bitlen += 512;
+        ctx->datalen = 0;
     }
 
+    // Whole blocks are hashed directly from the input.
+    while (len >= 64) {
+        sha256_transform(ctx, data);
+        ctx->bitlen += 512;
+        data        += 64;
+        len         -= 64;
+    }
+
+    memcpy(ctx->data, data, len);
+    ctx->datalen = len;
+
     return NRF_SUCCESS;
 }
 
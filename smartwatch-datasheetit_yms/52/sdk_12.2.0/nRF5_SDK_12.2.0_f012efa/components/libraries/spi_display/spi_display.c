@@ -0,0 +1,305 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(SPI_DISPLAY)
+#include "spi_display.h"
+#include <string.h>
+#include "nrf_gpio.h"
+#include "app_util.h"
+
+#define DCS_CASET        0x2A  /**< Column address set. */
+#define DCS_RASET        0x2B  /**< Row address set. */
+#define DCS_RAMWR        0x2C  /**< Memory write. */
+
+#define HEADER_STEPS     5     /**< Transfers that select the rectangle and start the memory write. */
+#define XFER_MAX_LEN     255   /**< Maximum length of one EasyDMA transfer. */
+
+/**@brief Transfer of the header of an update. */
+typedef struct
+{
+    uint8_t * p_data; /**< Bytes to send. */
+    uint8_t   length; /**< Number of bytes. */
+    bool      data;   /**< The bytes are command parameters, not a command. */
+} header_step_t;
+
+/**@brief Control block. */
+typedef struct
+{
+    spi_display_config_t const * p_config;
+    bool volatile                busy;          /**< An update is in progress. */
+    uint16_t                     x;             /**< First column of the rectangle. */
+    uint16_t                     width;         /**< Width of the rectangle. */
+    uint16_t                     end_line;      /**< Line after the rectangle. */
+    uint16_t                     block_lines;   /**< Number of lines in a full buffer. */
+    uint16_t                     render_line;   /**< Next line to render. */
+    uint8_t                      header_step;   /**< Current step of the header, or @ref HEADER_STEPS when sending pixels. */
+    uint8_t                      sending;       /**< Buffer that is being sent. */
+    uint16_t                     lines[2];      /**< Number of lines rendered in each buffer, 0 if it is free. */
+    nrf_drv_spi_list_entry_t     lists[2][2];   /**< Transfer list of each buffer. */
+    uint8_t                      list_count[2]; /**< Number of entries in each transfer list. */
+} spi_display_cb_t;
+
+static spi_display_cb_t m_cb;
+
+// Commands and parameters are sent by EasyDMA, so they are kept in RAM.
+static uint8_t m_cmds[3] = {DCS_CASET, DCS_RASET, DCS_RAMWR};
+static uint8_t m_caset[4];
+static uint8_t m_raset[4];
+
+static header_step_t const m_header[HEADER_STEPS] =
+{
+    {&m_cmds[0], 1,               false},
+    {m_caset,    sizeof(m_caset), true},
+    {&m_cmds[1], 1,               false},
+    {m_raset,    sizeof(m_raset), true},
+    {&m_cmds[2], 1,               false},
+};
+
+
+/**@brief Function for ending an update and notifying the user.
+ */
+static void update_end(spi_display_evt_type_t type, ret_code_t err_code)
+{
+    spi_display_evt_t evt;
+
+    nrf_gpio_pin_set(m_cb.p_config->cs_pin);
+    m_cb.busy = false;
+
+    evt.type     = type;
+    evt.err_code = err_code;
+    m_cb.p_config->evt_handler(&evt);
+}
+
+
+/**@brief Function for preparing the transfer list of a buffer.
+ *
+ * @details The pixels are split into transfers of equal length that fit in one EasyDMA transfer
+ *          and hold whole pixels. They are sent as one list entry that is repeated, and one more
+ *          entry for the pixels that remain.
+ */
+static void list_prepare(uint8_t buffer, uint16_t lines)
+{
+    spi_display_config_t const * p_config  = m_cb.p_config;
+    uint8_t const                bpp       = p_config->bytes_per_pixel;
+    uint32_t const               pixels    = (uint32_t)lines * m_cb.width;
+    uint32_t const               chunks    = CEIL_DIV(pixels, XFER_MAX_LEN / bpp);
+    uint32_t const               chunk_px  = CEIL_DIV(pixels, chunks);
+    uint32_t const               full      = pixels / chunk_px;
+    uint32_t const               tail_px   = pixels - (full * chunk_px);
+    nrf_drv_spi_list_entry_t   * p_entries = m_cb.lists[buffer];
+
+    p_entries[0].xfer   = (nrf_drv_spi_xfer_desc_t)NRF_DRV_SPI_XFER_TX(p_config->p_buffers[buffer],
+                                                                       chunk_px * bpp);
+    p_entries[0].repeat = (uint16_t)full;
+    p_entries[0].ss_pin = NRF_DRV_SPI_PIN_NOT_USED;
+    p_entries[0].flags  = 0;
+    m_cb.list_count[buffer] = 1;
+
+    if (tail_px > 0)
+    {
+        p_entries[1].xfer   = (nrf_drv_spi_xfer_desc_t)NRF_DRV_SPI_XFER_TX(
+                                  p_config->p_buffers[buffer] + (full * chunk_px * bpp),
+                                  tail_px * bpp);
+        p_entries[1].repeat = 1;
+        p_entries[1].ss_pin = NRF_DRV_SPI_PIN_NOT_USED;
+        p_entries[1].flags  = 0;
+        m_cb.list_count[buffer] = 2;
+    }
+}
+
+
+/**@brief Function for rendering the next block of lines into a free buffer.
+ */
+static void block_render(uint8_t buffer)
+{
+    uint16_t lines;
+
+    if (m_cb.render_line >= m_cb.end_line)
+    {
+        m_cb.lines[buffer] = 0;
+        return;
+    }
+
+    lines = MIN(m_cb.block_lines, m_cb.end_line - m_cb.render_line);
+    m_cb.p_config->render(m_cb.x, m_cb.render_line, m_cb.width, lines,
+                          m_cb.p_config->p_buffers[buffer]);
+    list_prepare(buffer, lines);
+
+    m_cb.render_line  += lines;
+    m_cb.lines[buffer] = lines;
+}
+
+
+/**@brief Function for sending a rendered buffer, and rendering the next block into the other one.
+ */
+static void block_send(uint8_t buffer)
+{
+    ret_code_t err_code;
+
+    m_cb.sending = buffer;
+    err_code = nrf_drv_spi_xfer_list(m_cb.p_config->p_spi,
+                                     m_cb.lists[buffer],
+                                     m_cb.list_count[buffer]);
+    if (err_code != NRF_SUCCESS)
+    {
+        update_end(SPI_DISPLAY_EVT_ERROR, err_code);
+        return;
+    }
+
+    block_render(buffer ^ 1);
+}
+
+
+static ret_code_t header_step_send(void)
+{
+    header_step_t const *   p_step    = &m_header[m_cb.header_step];
+    nrf_drv_spi_xfer_desc_t xfer_desc = NRF_DRV_SPI_XFER_TX(p_step->p_data, p_step->length);
+
+    nrf_gpio_pin_write(m_cb.p_config->dc_pin, p_step->data ? 1 : 0);
+    return nrf_drv_spi_xfer(m_cb.p_config->p_spi, &xfer_desc, 0);
+}
+
+
+static void spi_handler(nrf_drv_spi_evt_t const * p_event)
+{
+    ret_code_t err_code;
+
+    UNUSED_PARAMETER(p_event);
+
+    if (!m_cb.busy)
+    {
+        return;
+    }
+
+    if (m_cb.header_step < HEADER_STEPS - 1)
+    {
+        m_cb.header_step++;
+        err_code = header_step_send();
+        if (err_code != NRF_SUCCESS)
+        {
+            update_end(SPI_DISPLAY_EVT_ERROR, err_code);
+        }
+        return;
+    }
+
+    if (m_cb.header_step == HEADER_STEPS - 1)
+    {
+        // The memory write has started, everything that follows is pixel data.
+        m_cb.header_step = HEADER_STEPS;
+        nrf_gpio_pin_set(m_cb.p_config->dc_pin);
+        block_send(0);
+        return;
+    }
+
+    // A block has been sent.
+    m_cb.lines[m_cb.sending] = 0;
+    if (m_cb.lines[m_cb.sending ^ 1] == 0)
+    {
+        update_end(SPI_DISPLAY_EVT_DONE, NRF_SUCCESS);
+        return;
+    }
+    block_send(m_cb.sending ^ 1);
+}
+
+
+ret_code_t spi_display_init(spi_display_config_t const * p_config,
+                            nrf_drv_spi_config_t const * p_spi_config)
+{
+    VERIFY_PARAM_NOT_NULL(p_config);
+    VERIFY_PARAM_NOT_NULL(p_spi_config);
+    VERIFY_PARAM_NOT_NULL(p_config->p_spi);
+    VERIFY_PARAM_NOT_NULL(p_config->p_buffers[0]);
+    VERIFY_PARAM_NOT_NULL(p_config->p_buffers[1]);
+    VERIFY_PARAM_NOT_NULL(p_config->render);
+    VERIFY_PARAM_NOT_NULL(p_config->evt_handler);
+
+    if ((p_config->bytes_per_pixel == 0) || (p_config->bytes_per_pixel > XFER_MAX_LEN) ||
+        (p_spi_config->ss_pin != NRF_DRV_SPI_PIN_NOT_USED))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    memset(&m_cb, 0, sizeof(m_cb));
+    m_cb.p_config = p_config;
+
+    nrf_gpio_pin_set(p_config->cs_pin);
+    nrf_gpio_cfg_output(p_config->cs_pin);
+    nrf_gpio_pin_set(p_config->dc_pin);
+    nrf_gpio_cfg_output(p_config->dc_pin);
+
+    return nrf_drv_spi_init(p_config->p_spi, p_spi_config, spi_handler);
+}
+
+
+void spi_display_uninit(void)
+{
+    nrf_drv_spi_uninit(m_cb.p_config->p_spi);
+    nrf_gpio_pin_set(m_cb.p_config->cs_pin);
+    m_cb.busy = false;
+}
+
+
+ret_code_t spi_display_update(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+    ret_code_t err_code;
+    uint32_t   line_size;
+    uint16_t   x_end;
+    uint16_t   y_end;
+
+    if (m_cb.busy)
+    {
+        return NRF_ERROR_BUSY;
+    }
+    if ((width == 0) || (height == 0))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    line_size = (uint32_t)width * m_cb.p_config->bytes_per_pixel;
+    if (line_size > m_cb.p_config->buffer_size)
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    x_end = x + width - 1;
+    y_end = y + height - 1;
+    m_caset[0] = MSB_16(x);
+    m_caset[1] = LSB_16(x);
+    m_caset[2] = MSB_16(x_end);
+    m_caset[3] = LSB_16(x_end);
+    m_raset[0] = MSB_16(y);
+    m_raset[1] = LSB_16(y);
+    m_raset[2] = MSB_16(y_end);
+    m_raset[3] = LSB_16(y_end);
+
+    m_cb.x           = x;
+    m_cb.width       = width;
+    m_cb.end_line    = y + height;
+    m_cb.render_line = y;
+    m_cb.block_lines = MIN(m_cb.p_config->buffer_size / line_size, height);
+    m_cb.header_step = 0;
+    m_cb.busy        = true;
+
+    // The first block is ready when the header has been sent.
+    block_render(0);
+
+    nrf_gpio_pin_clear(m_cb.p_config->cs_pin);
+    err_code = header_step_send();
+    if (err_code != NRF_SUCCESS)
+    {
+        nrf_gpio_pin_set(m_cb.p_config->cs_pin);
+        m_cb.busy = false;
+    }
+    return err_code;
+}
+
+#endif // NRF_MODULE_ENABLED(SPI_DISPLAY)
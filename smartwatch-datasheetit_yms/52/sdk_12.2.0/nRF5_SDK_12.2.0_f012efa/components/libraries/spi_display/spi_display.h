@@ -0,0 +1,132 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup spi_display SPI display streaming
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for streaming rectangles of pixels to an SPI display.
+ *
+ * @details The module writes a rectangle of the display memory with the MIPI DCS commands
+ *          CASET, RASET and RAMWR, which are used by common display controllers such as the
+ *          ST7789 and the ILI9341. The pixels are rendered by the user, a block of lines at a
+ *          time, into one of two buffers. While one buffer is sent, the next block is rendered
+ *          into the other one. Every block is sent as one transfer list of the SPI master driver,
+ *          split into transfers that fit in one EasyDMA transfer, so the CPU is only woken once
+ *          per block. The user is notified once, when the whole rectangle has been sent.
+ *
+ * @note Rendering is done in the interrupt context of the SPI master driver. If rendering a
+ *       block takes longer than sending one, the bus waits for it.
+ */
+
+#ifndef SPI_DISPLAY_H__
+#define SPI_DISPLAY_H__
+
+#include <stdint.h>
+#include "nrf_drv_spi.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**@brief Handler for rendering a block of lines.
+ *
+ * @param[in]  x        Column of the first pixel of every line.
+ * @param[in]  y        Line of the block.
+ * @param[in]  width    Number of pixels in every line.
+ * @param[in]  lines    Number of lines in the block.
+ * @param[out] p_buffer Buffer for @p lines * @p width pixels, line after line, in the pixel format
+ *                      of the display.
+ */
+typedef void (* spi_display_render_t)(uint16_t  x,
+                                      uint16_t  y,
+                                      uint16_t  width,
+                                      uint16_t  lines,
+                                      uint8_t * p_buffer);
+
+/**@brief Event types. */
+typedef enum
+{
+    SPI_DISPLAY_EVT_DONE,  /**< The rectangle has been sent. */
+    SPI_DISPLAY_EVT_ERROR, /**< A transfer could not be started. The update was aborted. */
+} spi_display_evt_type_t;
+
+/**@brief Event. */
+typedef struct
+{
+    spi_display_evt_type_t type;     /**< Type of the event. */
+    ret_code_t             err_code; /**< Error of @ref SPI_DISPLAY_EVT_ERROR. */
+} spi_display_evt_t;
+
+/**@brief Event handler. Called from the interrupt context of the SPI master driver. */
+typedef void (* spi_display_evt_handler_t)(spi_display_evt_t const * p_evt);
+
+/**@brief Module configuration. */
+typedef struct
+{
+    nrf_drv_spi_t const     * p_spi;           /**< SPI master driver instance. Must use EasyDMA. */
+    uint32_t                  cs_pin;          /**< Chip select pin of the display, active low. */
+    uint32_t                  dc_pin;          /**< Data/command pin of the display, low for commands. */
+    uint8_t                   bytes_per_pixel; /**< Size of a pixel on the bus, for example 2 for RGB565. */
+    uint8_t                 * p_buffers[2];    /**< Two line buffers, in RAM. */
+    uint16_t                  buffer_size;     /**< Size of each line buffer, in bytes. Must hold at least one line. */
+    spi_display_render_t      render;          /**< Handler for rendering blocks of lines. */
+    spi_display_evt_handler_t evt_handler;     /**< Event handler. */
+} spi_display_config_t;
+
+/**@brief Function for initializing the module and the SPI master driver instance.
+ *
+ * @param[in] p_config     Module configuration. Must stay valid while the module is initialized.
+ * @param[in] p_spi_config SPI master driver configuration. The slave select pin must not be used,
+ *                         as the chip select pin is held for the whole update.
+ *
+ * @retval NRF_SUCCESS             If the module was initialized.
+ * @retval NRF_ERROR_NULL          If a required pointer was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If the configuration was invalid.
+ * @return Any error returned by @ref nrf_drv_spi_init.
+ */
+ret_code_t spi_display_init(spi_display_config_t const * p_config,
+                            nrf_drv_spi_config_t const * p_spi_config);
+
+/**@brief Function for uninitializing the module and the SPI master driver instance.
+ */
+void spi_display_uninit(void);
+
+/**@brief Function for starting the update of a rectangle of the display.
+ *
+ * @details The first block is rendered before this function returns. The rest of the rectangle is
+ *          rendered and sent from interrupts, and @ref SPI_DISPLAY_EVT_DONE is reported when it
+ *          has been sent.
+ *
+ * @param[in] x      First column of the rectangle.
+ * @param[in] y      First line of the rectangle.
+ * @param[in] width  Width of the rectangle, in pixels.
+ * @param[in] height Height of the rectangle, in lines.
+ *
+ * @retval NRF_SUCCESS              If the update was started.
+ * @retval NRF_ERROR_BUSY           If an update is in progress.
+ * @retval NRF_ERROR_INVALID_PARAM  If the rectangle is empty.
+ * @retval NRF_ERROR_INVALID_LENGTH If a line of the rectangle does not fit in a line buffer.
+ * @return Any error returned by @ref nrf_drv_spi_xfer.
+ */
+ret_code_t spi_display_update(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SPI_DISPLAY_H__
+
+/** @} */
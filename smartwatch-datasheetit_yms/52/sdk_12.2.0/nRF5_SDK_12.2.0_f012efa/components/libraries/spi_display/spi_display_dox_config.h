@@ -0,0 +1,16 @@
+/**
+ *
+ * @defgroup spi_display_config spi_display module configuration
+ * @{
+ * @ingroup spi_display
+ */
+/** @brief Enabling spi_display module
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define SPI_DISPLAY_ENABLED
+
+
+/** @} */
@@ -18,6 +18,10 @@
 #include "app_error.h"
 #include "nrf_delay.h"
 #include "app_util_platform.h"
+#include "cpu_profiler_hooks.h"
+#if NRF_MODULE_ENABLED(MEM_TELEMETRY)
+#include "mem_telemetry.h"
+#endif
 
 #define RTC1_IRQ_PRI            APP_IRQ_PRIORITY_LOWEST                        /**< Priority of the RTC1 interrupt (used for checking for timeouts and executing timeout handlers). */
 #define SWI_IRQ_PRI             APP_IRQ_PRIORITY_LOWEST                        /**< Priority of the SWI  interrupt (used for updating the timer list). */
@@ -38,15 +42,21 @@ STATIC_ASSERT(RTC1_IRQ_PRI == SWI_IRQ_PRI);
 
 #define MODULE_INITIALIZED (m_op_queue.p_user_op_queue != NULL) /**< Macro designating whether the module has been initialized properly. */
 
-/**@brief Timer node type. The nodes will be used form a linked list of running timers. */
+/**@brief Timer node type. The nodes will be used form a linked list of running timers.
+ *
+ * @details With @ref APP_TIMER_BACKEND_HEAP, ticks_to_expire holds the RTC1 counter value at which
+ *          the timer expires instead of a delta to the previous timer.
+ */
 typedef struct
 {
     uint32_t                    ticks_to_expire;                            /**< Number of ticks from previous timer interrupt to timer expiry. */
     uint32_t                    ticks_at_start;                             /**< Current RTC counter value when the timer was started. */
     uint32_t                    ticks_first_interval;                       /**< Number of ticks in the first timer interval. */
     uint32_t                    ticks_periodic_interval;                    /**< Timer period (for repeating timers). */
+    uint32_t                    ticks_slack;                                /**< Number of ticks the timer may expire late, so that it can be handled together with other timers. */
     bool                        is_running;                                 /**< True if timer is running, False otherwise. */
     app_timer_mode_t            mode;                                       /**< Timer mode. */
+    uint8_t                     heap_index;                                 /**< Position of the timer in the heap of running timers (heap backend only). */
     app_timer_timeout_handler_t p_timeout_handler;                          /**< Pointer to function to be executed when the timer expires. */
     void *                      p_context;                                  /**< General purpose pointer. Will be passed to the timeout handler when the timer expires. */
     void *                      next;                                       /**< Pointer to the next node. */
@@ -69,6 +79,7 @@ typedef struct
     uint32_t ticks_at_start;                                                /**< Current RTC counter value when the timer was started. */
     uint32_t ticks_first_interval;                                          /**< Number of ticks in the first timer interval. */
     uint32_t ticks_periodic_interval;                                       /**< Timer period (for repeating timers). */
+    uint32_t ticks_slack;                                                   /**< Number of ticks the timer may expire late. */
     void *   p_context;                                                     /**< General purpose pointer. Will be passed to the timeout handler when the timer expires. */
 } timer_user_op_start_t;
 
@@ -104,7 +115,6 @@ STATIC_ASSERT(sizeof(timer_op_queue_t) % 4 == 0);
 #define CONTEXT_QUEUE_SIZE_MAX      (2)
 
 static timer_op_queue_t              m_op_queue;                                /**< Timer operations queue. */
-static timer_node_t *                mp_timer_id_head;                          /**< First timer in list of running timers. */
 static uint32_t                      m_ticks_latest;                            /**< Last known RTC counter value. */
 static uint32_t                      m_ticks_elapsed[CONTEXT_QUEUE_SIZE_MAX];   /**< Timer internal elapsed ticks queue. */
 static uint8_t                       m_ticks_elapsed_q_read_ind;                /**< Timer internal elapsed ticks queue read index. */
@@ -117,6 +127,21 @@ static bool                          m_rtc1_reset;
 static uint8_t                       m_max_user_op_queue_utilization;           /**< Maximum observed timer user operations queue utilization. */
 #endif
 
+#if (APP_TIMER_CONFIG_BACKEND == APP_TIMER_BACKEND_LIST)
+static timer_node_t *                mp_timer_id_head;                          /**< First timer in list of running timers. */
+#elif (APP_TIMER_CONFIG_BACKEND == APP_TIMER_BACKEND_HEAP)
+#define HEAP_INDEX_INVALID          (0xFF)
+
+STATIC_ASSERT(APP_TIMER_CONFIG_HEAP_SIZE < HEAP_INDEX_INVALID);
+
+static timer_node_t *                m_heap[APP_TIMER_CONFIG_HEAP_SIZE];        /**< Running timers, ordered as a binary min-heap on expiry time. */
+static uint8_t                       m_heap_count;                              /**< Number of timers in the heap. */
+static timer_node_t *                mp_expired_head;                           /**< First timer removed from the heap by the RTC1 interrupt, not yet processed by the SWI. */
+static timer_node_t *                mp_expired_tail;                           /**< Last timer removed from the heap by the RTC1 interrupt. */
+#else
+#error "Unsupported APP_TIMER_CONFIG_BACKEND."
+#endif
+
 /**@brief Function for initializing the RTC1 counter.
  *
  * @param[in] prescaler   Value of the RTC1 PRESCALER register. Set to 0 for no prescaling.
@@ -196,6 +221,8 @@ static __INLINE void rtc1_compare0_set(uint32_t value)
 }
 
 
+#if (APP_TIMER_CONFIG_BACKEND == APP_TIMER_BACKEND_LIST)
+
 /**@brief Function for inserting a timer in the timer list.
  *
  * @param[in]  timer_id   Id of timer to insert.
@@ -304,6 +331,325 @@ static void timer_list_remove(timer_node_t * p_timer)
 }
 
 
+/**@brief Function for removing all timers from the timer list, and marking them as not running.
+ */
+static void timer_list_clear(void)
+{
+    while (mp_timer_id_head != NULL)
+    {
+        timer_node_t * p_head = mp_timer_id_head;
+
+        p_head->is_running = false;
+        mp_timer_id_head    = p_head->next;
+    }
+}
+
+
+/**@brief Function for getting the running timer that expires first.
+ *
+ * @return     Pointer to the timer, or NULL if no timer is running.
+ */
+static __INLINE timer_node_t * timer_list_first(void)
+{
+    return mp_timer_id_head;
+}
+
+
+/**@brief Function for getting the number of ticks from the last known RTC1 counter value to the
+ *        latest time at which the RTC1 interrupt must occur. Must only be called if a timer is
+ *        running.
+ *
+ * @details This is the earliest end of the slack windows of the running timers. All timers that
+ *          expire before it are handled in the same interrupt.
+ */
+static uint32_t timer_list_wakeup_ticks_get(void)
+{
+    timer_node_t * p_timer = mp_timer_id_head;
+    uint32_t       ticks   = p_timer->ticks_to_expire;
+    uint32_t       wakeup  = ticks + p_timer->ticks_slack;
+
+    // The list is ordered on expiry, so no timer after the wakeup time can lower it.
+    for (p_timer = p_timer->next; p_timer != NULL; p_timer = p_timer->next)
+    {
+        ticks += p_timer->ticks_to_expire;
+        if (ticks >= wakeup)
+        {
+            break;
+        }
+
+        if ((ticks + p_timer->ticks_slack) < wakeup)
+        {
+            wakeup = ticks + p_timer->ticks_slack;
+        }
+    }
+
+    return wakeup;
+}
+
+#else // APP_TIMER_BACKEND_HEAP
+
+/**@brief Function for computing the number of ticks from the last known RTC1 counter value to the
+ *        expiry of a timer in the heap.
+ */
+static __INLINE uint32_t heap_ticks_to_expire(timer_node_t const * p_timer)
+{
+    return ticks_diff_get(p_timer->ticks_to_expire, m_ticks_latest);
+}
+
+
+/**@brief Function for placing a timer at a given position in the heap.
+ */
+static __INLINE void heap_set(uint8_t index, timer_node_t * p_timer)
+{
+    m_heap[index]       = p_timer;
+    p_timer->heap_index = index;
+}
+
+
+/**@brief Function for moving a timer towards the root of the heap until its parent expires first.
+ */
+static void heap_sift_up(uint8_t index)
+{
+    timer_node_t * p_timer = m_heap[index];
+    uint32_t       ticks   = heap_ticks_to_expire(p_timer);
+
+    while (index > 0)
+    {
+        uint8_t parent = (index - 1) / 2;
+
+        if (heap_ticks_to_expire(m_heap[parent]) <= ticks)
+        {
+            break;
+        }
+
+        heap_set(index, m_heap[parent]);
+        index = parent;
+    }
+
+    heap_set(index, p_timer);
+}
+
+
+/**@brief Function for moving a timer towards the leaves of the heap until both children expire
+ *        after it.
+ */
+static void heap_sift_down(uint8_t index)
+{
+    timer_node_t * p_timer = m_heap[index];
+    uint32_t       ticks   = heap_ticks_to_expire(p_timer);
+
+    for (;;)
+    {
+        uint32_t child = 2 * (uint32_t)index + 1;
+
+        if (child >= m_heap_count)
+        {
+            break;
+        }
+
+        if (((child + 1) < m_heap_count) &&
+            (heap_ticks_to_expire(m_heap[child + 1]) < heap_ticks_to_expire(m_heap[child])))
+        {
+            child++;
+        }
+
+        if (ticks <= heap_ticks_to_expire(m_heap[child]))
+        {
+            break;
+        }
+
+        heap_set(index, m_heap[child]);
+        index = (uint8_t)child;
+    }
+
+    heap_set(index, p_timer);
+}
+
+
+/**@brief Function for removing the timer at a given position from the heap.
+ */
+static void heap_delete(uint8_t index)
+{
+    timer_node_t * p_last;
+
+    m_heap[index]->heap_index = HEAP_INDEX_INVALID;
+    m_heap_count--;
+
+    if (index == m_heap_count)
+    {
+        return;
+    }
+
+    // Fill the hole with the last timer and restore the heap order around it.
+    p_last = m_heap[m_heap_count];
+    heap_set(index, p_last);
+
+    if ((index > 0) &&
+        (heap_ticks_to_expire(p_last) < heap_ticks_to_expire(m_heap[(index - 1) / 2])))
+    {
+        heap_sift_up(index);
+    }
+    else
+    {
+        heap_sift_down(index);
+    }
+}
+
+
+/**@brief Function for inserting a timer in the timer heap.
+ *
+ * @param[in]  timer_id   Id of timer to insert.
+ */
+static void timer_list_insert(timer_node_t * p_timer)
+{
+    if (m_heap_count == APP_TIMER_CONFIG_HEAP_SIZE)
+    {
+        // More timers are running than APP_TIMER_CONFIG_HEAP_SIZE allows.
+        p_timer->is_running = false;
+        APP_ERROR_CHECK(NRF_ERROR_NO_MEM);
+        return;
+    }
+
+    // Store the expiry as an absolute RTC1 counter value.
+    p_timer->ticks_to_expire = (m_ticks_latest + p_timer->ticks_to_expire) & MAX_RTC_COUNTER_VAL;
+
+    heap_set(m_heap_count, p_timer);
+    m_heap_count++;
+    heap_sift_up(p_timer->heap_index);
+}
+
+
+/**@brief Function for removing a timer from the timer heap, or from the list of expired timers.
+ *
+ * @param[in]  timer_id   Id of timer to remove.
+ */
+static void timer_list_remove(timer_node_t * p_timer)
+{
+    uint8_t index = p_timer->heap_index;
+
+    if ((index < m_heap_count) && (m_heap[index] == p_timer))
+    {
+        heap_delete(index);
+    }
+    else
+    {
+        timer_node_t * p_previous = NULL;
+        timer_node_t * p_current  = mp_expired_head;
+
+        while ((p_current != NULL) && (p_current != p_timer))
+        {
+            p_previous = p_current;
+            p_current  = p_current->next;
+        }
+
+        // Timer not in active list.
+        if (p_current == NULL)
+        {
+            return;
+        }
+
+        if (p_previous == NULL)
+        {
+            mp_expired_head = p_current->next;
+        }
+        else
+        {
+            p_previous->next = p_current->next;
+        }
+
+        if (mp_expired_tail == p_current)
+        {
+            mp_expired_tail = p_previous;
+        }
+    }
+
+    // No more timers running. Reset RTC1 in case Start timer operations are present in the queue.
+    if ((m_heap_count == 0) && (mp_expired_head == NULL))
+    {
+        NRF_RTC1->TASKS_CLEAR = 1;
+        m_ticks_latest        = 0;
+        m_rtc1_reset          = true;
+    }
+}
+
+
+/**@brief Function for removing all timers from the timer heap and the list of expired timers, and
+ *        marking them as not running.
+ */
+static void timer_list_clear(void)
+{
+    while (m_heap_count != 0)
+    {
+        m_heap_count--;
+        m_heap[m_heap_count]->is_running = false;
+        m_heap[m_heap_count]->heap_index = HEAP_INDEX_INVALID;
+    }
+
+    while (mp_expired_head != NULL)
+    {
+        mp_expired_head->is_running = false;
+        mp_expired_head             = mp_expired_head->next;
+    }
+    mp_expired_tail = NULL;
+}
+
+
+/**@brief Function for getting the running timer that expires first.
+ *
+ * @return     Pointer to the timer, or NULL if no timer is running.
+ */
+static __INLINE timer_node_t * timer_list_first(void)
+{
+    return (m_heap_count != 0) ? m_heap[0] : NULL;
+}
+
+
+/**@brief Function for finding the earliest end of the slack windows of the timers in a subtree of
+ *        the heap.
+ *
+ * @param[in]  index    Root of the subtree.
+ * @param[in]  wakeup   Earliest end found so far, in ticks from the last known RTC1 counter value.
+ *
+ * @return     Earliest end of the slack windows, in ticks from the last known RTC1 counter value.
+ */
+static uint32_t heap_wakeup_ticks_get(uint32_t index, uint32_t wakeup)
+{
+    if (index < m_heap_count)
+    {
+        uint32_t ticks = heap_ticks_to_expire(m_heap[index]);
+
+        // Every timer in the subtree expires after its root, so stop when the root is too late.
+        if (ticks < wakeup)
+        {
+            if ((ticks + m_heap[index]->ticks_slack) < wakeup)
+            {
+                wakeup = ticks + m_heap[index]->ticks_slack;
+            }
+
+            wakeup = heap_wakeup_ticks_get(2 * index + 1, wakeup);
+            wakeup = heap_wakeup_ticks_get(2 * index + 2, wakeup);
+        }
+    }
+
+    return wakeup;
+}
+
+
+/**@brief Function for getting the number of ticks from the last known RTC1 counter value to the
+ *        latest time at which the RTC1 interrupt must occur. Must only be called if a timer is
+ *        running.
+ *
+ * @details This is the earliest end of the slack windows of the running timers. All timers that
+ *          expire before it are handled in the same interrupt.
+ */
+static __INLINE uint32_t timer_list_wakeup_ticks_get(void)
+{
+    return heap_wakeup_ticks_get(0, UINT32_MAX);
+}
+
+#endif // APP_TIMER_CONFIG_BACKEND
+
+
 /**@brief Function for scheduling a check for timeouts by generating a RTC1 interrupt.
  */
 static void timer_timeouts_check_sched(void)
@@ -339,6 +685,38 @@ static void timeout_handler_exec(timer_node_t * p_timer)
 }
 
 
+/**@brief Function for passing the number of ticks consumed by expired timers to the SWI.
+ *
+ * @param[in]  ticks_expired   Number of ticks from the last known RTC1 counter value to the expiry
+ *                             of the last expired timer.
+ */
+static void elapsed_ticks_queue(uint32_t ticks_expired)
+{
+    // Prepare to queue the ticks expired in the m_ticks_elapsed queue.
+    if (m_ticks_elapsed_q_read_ind == m_ticks_elapsed_q_write_ind)
+    {
+        // The read index of the queue is equal to the write index. This means the new
+        // value of ticks_expired should be stored at a new location in the m_ticks_elapsed
+        // queue (which is implemented as a double buffer).
+
+        // Check if there will be a queue overflow.
+        if (++m_ticks_elapsed_q_write_ind == CONTEXT_QUEUE_SIZE_MAX)
+        {
+            // There will be a queue overflow. Hence the write index should point to the start
+            // of the queue.
+            m_ticks_elapsed_q_write_ind = 0;
+        }
+    }
+
+    // Queue the ticks expired.
+    m_ticks_elapsed[m_ticks_elapsed_q_write_ind] = ticks_expired;
+
+    timer_list_handler_sched();
+}
+
+
+#if (APP_TIMER_CONFIG_BACKEND == APP_TIMER_BACKEND_LIST)
+
 /**@brief Function for checking for expired timers.
  */
 static void timer_timeouts_check(void)
@@ -385,29 +763,59 @@ static void timer_timeouts_check(void)
             }
         }
 
-        // Prepare to queue the ticks expired in the m_ticks_elapsed queue.
-        if (m_ticks_elapsed_q_read_ind == m_ticks_elapsed_q_write_ind)
+        elapsed_ticks_queue(ticks_expired);
+    }
+}
+
+#else // APP_TIMER_BACKEND_HEAP
+
+/**@brief Function for checking for expired timers.
+ *
+ * @details Expired timers are moved from the heap to the list of expired timers, in order of
+ *          expiry. The SWI handler, which runs at the same priority, restarts the periodic ones.
+ */
+static void timer_timeouts_check(void)
+{
+    if ((m_heap_count != 0) || (mp_expired_head != NULL))
+    {
+        timer_node_t * p_timer;
+        uint32_t       ticks_elapsed;
+
+        ticks_elapsed = ticks_diff_get(rtc1_counter_get(), m_ticks_latest);
+
+        while ((m_heap_count != 0) && (heap_ticks_to_expire(m_heap[0]) <= ticks_elapsed))
         {
-            // The read index of the queue is equal to the write index. This means the new
-            // value of ticks_expired should be stored at a new location in the m_ticks_elapsed
-            // queue (which is implemented as a double buffer).
+            p_timer = m_heap[0];
+            heap_delete(0);
 
-            // Check if there will be a queue overflow.
-            if (++m_ticks_elapsed_q_write_ind == CONTEXT_QUEUE_SIZE_MAX)
+            p_timer->next = NULL;
+            if (mp_expired_tail == NULL)
+            {
+                mp_expired_head = p_timer;
+            }
+            else
             {
-                // There will be a queue overflow. Hence the write index should point to the start
-                // of the queue.
-                m_ticks_elapsed_q_write_ind = 0;
+                mp_expired_tail->next = p_timer;
             }
+            mp_expired_tail = p_timer;
         }
 
-        // Queue the ticks expired.
-        m_ticks_elapsed[m_ticks_elapsed_q_write_ind] = ticks_expired;
+        // Execute Task. Timers already handled by a previous interrupt are no longer running.
+        for (p_timer = mp_expired_head; p_timer != NULL; p_timer = p_timer->next)
+        {
+            if (p_timer->is_running)
+            {
+                p_timer->is_running = false;
+                timeout_handler_exec(p_timer);
+            }
+        }
 
-        timer_list_handler_sched();
+        elapsed_ticks_queue((mp_expired_tail != NULL) ? heap_ticks_to_expire(mp_expired_tail) : 0);
     }
 }
 
+#endif // APP_TIMER_CONFIG_BACKEND
+
 
 /**@brief Function for acquiring the number of ticks elapsed.
  *
@@ -453,7 +861,7 @@ static bool list_deletions_handler(void)
     uint8_t        user_ops_first = m_op_queue.first;
 
     // Remember the old head, so as to decide if new compare needs to be set.
-    p_timer_old_head = mp_timer_id_head;
+    p_timer_old_head = timer_list_first();
 
     while (user_ops_first != m_op_queue.last)
     {
@@ -475,13 +883,7 @@ static bool list_deletions_handler(void)
 
             case TIMER_USER_OP_TYPE_STOP_ALL:
                 // Delete list of running timers, and mark all timers as not running.
-                while (mp_timer_id_head != NULL)
-                {
-                    timer_node_t * p_head = mp_timer_id_head;
-
-                    p_head->is_running = false;
-                    mp_timer_id_head    = p_head->next;
-                }
+                timer_list_clear();
                 break;
 
             default:
@@ -491,10 +893,12 @@ static bool list_deletions_handler(void)
     }
 
     // Detect change in head of the list.
-    return (mp_timer_id_head != p_timer_old_head);
+    return (timer_list_first() != p_timer_old_head);
 }
 
 
+#if (APP_TIMER_CONFIG_BACKEND == APP_TIMER_BACKEND_LIST)
+
 /**@brief Function for updating the timer list for expired timers.
  *
  * @param[in]  ticks_elapsed         Number of elapsed ticks.
@@ -544,6 +948,43 @@ static void expired_timers_handler(uint32_t         ticks_elapsed,
     }
 }
 
+#else // APP_TIMER_BACKEND_HEAP
+
+/**@brief Function for updating the timer list for expired timers.
+ *
+ * @details The expired timers have already been taken out of the heap by the RTC1 interrupt.
+ *
+ * @param[in]  ticks_elapsed         Number of elapsed ticks.
+ * @param[in]  ticks_previous        Previous known value of the RTC counter.
+ * @param[out] p_restart_list_head   List of repeating timers to be restarted.
+ */
+static void expired_timers_handler(uint32_t         ticks_elapsed,
+                                   uint32_t         ticks_previous,
+                                   timer_node_t **  p_restart_list_head)
+{
+    UNUSED_PARAMETER(ticks_elapsed);
+    UNUSED_PARAMETER(ticks_previous);
+
+    while (mp_expired_head != NULL)
+    {
+        timer_node_t * p_timer = mp_expired_head;
+
+        mp_expired_head = p_timer->next;
+
+        // Timer will be restarted if periodic, counting from its expiry time.
+        if (p_timer->ticks_periodic_interval != 0)
+        {
+            p_timer->ticks_at_start       = p_timer->ticks_to_expire;
+            p_timer->ticks_first_interval = p_timer->ticks_periodic_interval;
+            p_timer->next                 = *p_restart_list_head;
+            *p_restart_list_head          = p_timer;
+        }
+    }
+    mp_expired_tail = NULL;
+}
+
+#endif // APP_TIMER_CONFIG_BACKEND
+
 
 /**@brief Function for handling timer list insertions.
  *
@@ -553,10 +994,14 @@ static void expired_timers_handler(uint32_t         ticks_elapsed,
  */
 static bool list_insertions_handler(timer_node_t * p_restart_list_head)
 {
-    timer_node_t * p_timer_id_old_head;
+    uint32_t ticks_wakeup_old = UINT32_MAX;
+    bool     wakeup_moved     = false;
 
-    // Remember the old head, so as to decide if new compare needs to be set.
-    p_timer_id_old_head = mp_timer_id_head;
+    // Remember the old wakeup time, so as to decide if new compare needs to be set.
+    if (timer_list_first() != NULL)
+    {
+        ticks_wakeup_old = timer_list_wakeup_ticks_get();
+    }
 
     // Handle insertions of timers.
     while ((p_restart_list_head != NULL) || (m_op_queue.first != m_op_queue.last))
@@ -588,6 +1033,7 @@ static bool list_insertions_handler(timer_node_t * p_restart_list_head)
             p_timer->ticks_at_start          = p_user_op->params.start.ticks_at_start;
             p_timer->ticks_first_interval    = p_user_op->params.start.ticks_first_interval;
             p_timer->ticks_periodic_interval = p_user_op->params.start.ticks_periodic_interval;
+            p_timer->ticks_slack             = p_user_op->params.start.ticks_slack;
             p_timer->p_context               = p_user_op->params.start.p_context;
 
             if (m_rtc1_reset)
@@ -626,11 +1072,17 @@ static bool list_insertions_handler(timer_node_t * p_restart_list_head)
         p_timer->is_running           = true;
         p_timer->next                 = NULL;
 
+        // A timer expiring before the old wakeup time moves it, even if it is not the new head.
+        if (p_timer->ticks_to_expire < ticks_wakeup_old)
+        {
+            wakeup_moved = true;
+        }
+
         // Insert into list
         timer_list_insert(p_timer);
     }
 
-    return (mp_timer_id_head != p_timer_id_old_head);
+    return wakeup_moved;
 }
 
 
@@ -639,9 +1091,9 @@ static bool list_insertions_handler(timer_node_t * p_restart_list_head)
 static void compare_reg_update(timer_node_t * p_timer_id_head_old)
 {
     // Setup the timeout for timers on the head of the list
-    if (mp_timer_id_head != NULL)
+    if (timer_list_first() != NULL)
     {
-        uint32_t ticks_to_expire = mp_timer_id_head->ticks_to_expire;
+        uint32_t ticks_to_expire = timer_list_wakeup_ticks_get();
         uint32_t pre_counter_val = rtc1_counter_get();
         uint32_t cc              = m_ticks_latest;
         uint32_t ticks_elapsed   = ticks_diff_get(pre_counter_val, cc) + RTC_COMPARE_OFFSET_MIN;
@@ -713,7 +1165,7 @@ static void timer_list_handler(void)
 
     // Back up the previous known tick and previous list head
     ticks_previous    = m_ticks_latest;
-    p_timer_id_head_old = mp_timer_id_head;
+    p_timer_id_head_old = timer_list_first();
 
     // Get number of elapsed ticks
     ticks_have_elapsed = elapsed_ticks_acquire(&ticks_elapsed);
@@ -788,6 +1240,7 @@ static timer_user_op_t * user_op_alloc( uint8_t * p_last_index)
  * @param[in]  timer_id          Id of timer to start.
  * @param[in]  timeout_initial   Time (in ticks) to first timer expiry.
  * @param[in]  timeout_periodic  Time (in ticks) between periodic expiries.
+ * @param[in]  timeout_slack     Time (in ticks) each expiry may be delayed.
  * @param[in]  p_context         General purpose pointer. Will be passed to the timeout handler when
  *                               the timer expires.
  * @return     NRF_SUCCESS on success, otherwise an error code.
@@ -796,6 +1249,7 @@ static timer_user_op_t * user_op_alloc( uint8_t * p_last_index)
 static uint32_t timer_start_op_schedule(timer_node_t * p_node,
                                         uint32_t        timeout_initial,
                                         uint32_t        timeout_periodic,
+                                        uint32_t        timeout_slack,
                                         void *          p_context)
 {
     uint8_t last_index;
@@ -815,6 +1269,7 @@ static uint32_t timer_start_op_schedule(timer_node_t * p_node,
         p_user_op->params.start.ticks_at_start          = rtc1_counter_get();
         p_user_op->params.start.ticks_first_interval    = timeout_initial;
         p_user_op->params.start.ticks_periodic_interval = timeout_periodic;
+        p_user_op->params.start.ticks_slack             = timeout_slack;
         p_user_op->params.start.p_context               = p_context;
 
         user_op_enque(last_index);
@@ -873,6 +1328,8 @@ static uint32_t timer_stop_op_schedule(timer_node_t * p_node,
  */
 void RTC1_IRQHandler(void)
 {
+    CPU_PROFILER_ISR_ENTER(CPU_PROFILER_ISR_RTC1);
+
     // Clear all events (also unexpected ones)
     NRF_RTC1->EVENTS_COMPARE[0] = 0;
     NRF_RTC1->EVENTS_COMPARE[1] = 0;
@@ -883,6 +1340,8 @@ void RTC1_IRQHandler(void)
 
     // Check for expired timers
     timer_timeouts_check();
+
+    CPU_PROFILER_ISR_EXIT(CPU_PROFILER_ISR_RTC1);
 }
 
 
@@ -892,7 +1351,9 @@ void RTC1_IRQHandler(void)
  */
 void SWI_IRQHandler(void)
 {
+    CPU_PROFILER_ISR_ENTER(CPU_PROFILER_ISR_SWI);
     timer_list_handler();
+    CPU_PROFILER_ISR_EXIT(CPU_PROFILER_ISR_SWI);
 }
 
 
@@ -923,7 +1384,13 @@ uint32_t app_timer_init(uint32_t                      prescaler,
     m_op_queue.size            = op_queue_size;
     m_op_queue.p_user_op_queue = p_buffer;
 
+#if (APP_TIMER_CONFIG_BACKEND == APP_TIMER_BACKEND_LIST)
     mp_timer_id_head            = NULL;
+#else
+    m_heap_count                = 0;
+    mp_expired_head             = NULL;
+    mp_expired_tail             = NULL;
+#endif
     m_ticks_elapsed_q_read_ind  = 0;
     m_ticks_elapsed_q_write_ind = 0;
 
@@ -971,6 +1438,15 @@ uint32_t app_timer_create(app_timer_id_t const *      p_timer_id,
 }
 
 uint32_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void * p_context)
+{
+    return app_timer_start_with_slack(timer_id, timeout_ticks, 0, p_context);
+}
+
+
+uint32_t app_timer_start_with_slack(app_timer_id_t timer_id,
+                                    uint32_t       timeout_ticks,
+                                    uint32_t       slack_ticks,
+                                    void *         p_context)
 {
     uint32_t timeout_periodic;
     timer_node_t * p_node = (timer_node_t*)timer_id;
@@ -986,6 +1462,10 @@ uint32_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *
     {
         return NRF_ERROR_INVALID_PARAM;
     }
+    if (slack_ticks > APP_TIMER_MAX_SLACK_TICKS)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
     if (p_node->p_timeout_handler == NULL)
     {
         return NRF_ERROR_INVALID_STATE;
@@ -997,6 +1477,7 @@ uint32_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *
     return timer_start_op_schedule(p_node,
                                    timeout_ticks,
                                    timeout_periodic,
+                                   slack_ticks,
                                    p_context);
 }
 
@@ -1046,5 +1527,15 @@ uint8_t app_timer_op_queue_utilization_get(void)
 {
     return m_max_user_op_queue_utilization;
 }
+
+#if NRF_MODULE_ENABLED(MEM_TELEMETRY)
+static void op_queue_telemetry_get(mem_telemetry_usage_t * p_usage)
+{
+    p_usage->peak     = m_max_user_op_queue_utilization;
+    p_usage->capacity = m_op_queue.size;
+}
+
+MEM_TELEMETRY_CUSTOM_REGISTER(app_timer_op_queue, op_queue_telemetry_get);
+#endif
 #endif
 #endif //NRF_MODULE_ENABLED(APP_TIMER)
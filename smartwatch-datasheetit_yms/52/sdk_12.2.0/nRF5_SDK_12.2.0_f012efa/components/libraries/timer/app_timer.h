@@ -53,13 +53,25 @@ extern "C" {
 
 #define APP_TIMER_CLOCK_FREQ         32768                      /**< Clock frequency of the RTC timer used to implement the app timer module. */
 #define APP_TIMER_MIN_TIMEOUT_TICKS  5                          /**< Minimum value of the timeout_ticks parameter of app_timer_start(). */
+#define APP_TIMER_MAX_SLACK_TICKS    0x007FFFFF                 /**< Maximum value of the slack_ticks parameter of app_timer_start_with_slack(). */
 
 #ifdef RTX
 #define APP_TIMER_NODE_SIZE          40                         /**< Size of app_timer.timer_node_t (used to allocate data). */
 #else
-#define APP_TIMER_NODE_SIZE          32                         /**< Size of app_timer.timer_node_t (used to allocate data). */
+#define APP_TIMER_NODE_SIZE          36                         /**< Size of app_timer.timer_node_t (used to allocate data). */
 #endif // RTX
-#define APP_TIMER_USER_OP_SIZE       24                         /**< Size of app_timer.timer_user_op_t (only for use inside APP_TIMER_BUF_SIZE()). */
+#define APP_TIMER_USER_OP_SIZE       28                         /**< Size of app_timer.timer_user_op_t (only for use inside APP_TIMER_BUF_SIZE()). */
+
+#define APP_TIMER_BACKEND_LIST       0                          /**< Running timers are kept in a delta-encoded linked list. Insertion is O(n). */
+#define APP_TIMER_BACKEND_HEAP       1                          /**< Running timers are kept in a binary min-heap. Insertion and removal are O(log n). */
+
+#ifndef APP_TIMER_CONFIG_BACKEND
+#define APP_TIMER_CONFIG_BACKEND     APP_TIMER_BACKEND_LIST     /**< Data structure used to order the running timers. */
+#endif
+
+#ifndef APP_TIMER_CONFIG_HEAP_SIZE
+#define APP_TIMER_CONFIG_HEAP_SIZE   32                         /**< Maximum number of simultaneously running timers when @ref APP_TIMER_BACKEND_HEAP is used. */
+#endif
 
 /**@brief Compute number of bytes required to hold the application timer data structures.
  *
@@ -236,6 +248,38 @@ uint32_t app_timer_create(app_timer_id_t const *      p_timer_id,
  */
 uint32_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void * p_context);
 
+/**@brief Function for starting a timer that may expire late by up to a given number of ticks.
+ *
+ * @details The time-out handler is called between timeout_ticks and timeout_ticks + slack_ticks
+ *          after the timer was started. The RTC1 interrupt is set up for the earliest end of the
+ *          slack windows of all running timers, and every timer that has expired by then is
+ *          handled in the same interrupt. Giving timers that do not need exact expiry times some
+ *          slack therefore reduces the number of CPU wakeups. A repeated timer keeps its period:
+ *          each expiry is counted from the nominal time of the previous one, not from when it
+ *          was handled.
+ *
+ * @param[in]       timer_id      Timer identifier.
+ * @param[in]       timeout_ticks Number of ticks (of RTC1, including prescaling) to time-out event
+ *                                (minimum 5 ticks).
+ * @param[in]       slack_ticks   Number of ticks each time-out event may be delayed (maximum
+ *                                @ref APP_TIMER_MAX_SLACK_TICKS).
+ * @param[in]       p_context     General purpose pointer. Will be passed to the time-out handler when
+ *                                the timer expires.
+ *
+ * @retval     NRF_SUCCESS               If the timer was successfully started.
+ * @retval     NRF_ERROR_INVALID_PARAM   If a parameter was invalid.
+ * @retval     NRF_ERROR_INVALID_STATE   If the application timer module has not been initialized or the timer
+ *                                       has not been created.
+ * @retval     NRF_ERROR_NO_MEM          If the timer operations queue was full.
+ *
+ * @note Calling app_timer_start() is the same as calling this function with slack_ticks set to 0.
+ * @note The FreeRTOS, RTX and Gazell variants of this module ignore slack_ticks.
+ */
+uint32_t app_timer_start_with_slack(app_timer_id_t timer_id,
+                                    uint32_t       timeout_ticks,
+                                    uint32_t       slack_ticks,
+                                    void *         p_context);
+
 /**@brief Function for stopping the specified timer.
  *
  * @param[in]  timer_id                  Timer identifier.
@@ -52,7 +52,7 @@ typedef struct
     void *                      next;                                       /**< Pointer to the next node. */
 } timer_node_t;
 
-STATIC_ASSERT(sizeof(timer_node_t) == APP_TIMER_NODE_SIZE);
+STATIC_ASSERT(sizeof(timer_node_t) <= APP_TIMER_NODE_SIZE);
 
 /**@brief Set of available timer operation types. */
 typedef enum
@@ -1001,6 +1001,17 @@ uint32_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *
 }
 
 
+uint32_t app_timer_start_with_slack(app_timer_id_t timer_id,
+                                    uint32_t       timeout_ticks,
+                                    uint32_t       slack_ticks,
+                                    void *         p_context)
+{
+    // Slack is not supported by this implementation. The timer expires at timeout_ticks.
+    UNUSED_PARAMETER(slack_ticks);
+    return app_timer_start(timer_id, timeout_ticks, p_context);
+}
+
+
 uint32_t app_timer_stop(app_timer_id_t timer_id)
 {
     timer_node_t * p_node = (timer_node_t*)timer_id;
@@ -32,6 +32,25 @@
  */
 #define APP_TIMER_KEEPS_RTC_ACTIVE
 
+/** @brief Data structure used to order the running timers
+ *
+ *  Following options are available:
+ * - 0 - Delta-encoded linked list. Starting a timer walks the list, which costs O(n).
+ * - 1 - Binary min-heap. Starting and stopping a timer costs O(log n). Requires
+ *       @ref APP_TIMER_CONFIG_HEAP_SIZE pointers of RAM.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define APP_TIMER_CONFIG_BACKEND
+
+/** @brief Maximum number of simultaneously running timers when the heap backend is used
+ *
+ *  Starting more timers than this is a fatal error. Maximum value is 254.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define APP_TIMER_CONFIG_HEAP_SIZE
+
 
 
 /** @} */
@@ -20,6 +20,7 @@
 #include <string.h>
 #include "nrf.h"
 #include "app_error.h"
+#include "app_util_platform.h"
 
 /* Check if RTC FreeRTOS version is used */
 #if configTICK_SOURCE != FREERTOS_USE_RTC
@@ -37,6 +38,25 @@
  */
 #define APP_TIMER_WAIT_FOR_QUEUE 2
 
+/**
+ * @brief Command batching
+ *
+ * When set to 1, a start or stop only records the requested state of the timer, and at most one
+ * command per timer is queued to the timer task with xTimerPendFunctionCall(). The timer task
+ * applies the last requested state: a stop followed by a start, or repeated starts, become one
+ * command. Starts from interrupts use the same single queue entry. The command queue then never
+ * holds more than one command per timer, see @ref app_timer_op_queue_utilization_get.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef APP_TIMER_CONFIG_FREERTOS_BATCHING
+#define APP_TIMER_CONFIG_FREERTOS_BATCHING 0
+#endif
+
+#if APP_TIMER_CONFIG_FREERTOS_BATCHING && (INCLUDE_xTimerPendFunctionCall != 1)
+#error app_timer command batching requires INCLUDE_xTimerPendFunctionCall option to be activated.
+#endif
+
 /**@brief This structure keeps information about osTimer.*/
 typedef struct
 {
@@ -48,6 +68,10 @@ typedef struct
      * FreeRTOS may have timer running even after stop function is called,
      * because it processes commands in Timer task and stopping function only puts command into the queue. */
     bool                        active;
+#if APP_TIMER_CONFIG_FREERTOS_BATCHING
+    bool                        pending;    /**< A command for this timer is queued. */
+    TickType_t                  period;     /**< Requested period, applied with the queued command. */
+#endif
 }app_timer_info_t;
 
 /**
@@ -68,6 +92,11 @@ static uint32_t m_prescaler;
 /* Check if app_timer_t variable type can held our app_timer_info_t structure */
 STATIC_ASSERT(sizeof(app_timer_info_t) <= sizeof(app_timer_t));
 
+#if APP_TIMER_CONFIG_FREERTOS_BATCHING
+static uint8_t m_commands_queued;     /**< Commands of this module in the timer queue. */
+static uint8_t m_commands_queued_max; /**< Highest number of commands of this module in the timer queue. */
+#endif
+
 
 /**
  * @brief Internal callback function for the system timer
@@ -87,6 +116,97 @@ static void app_timer_callback(TimerHandle_t xTimer)
 }
 
 
+#if APP_TIMER_CONFIG_FREERTOS_BATCHING
+/**
+ * @brief Apply the last requested state of a timer
+ *
+ * Called in the timer task, for the command queued by @ref app_timer_command_queue.
+ * @param[in] p_param Timer information.
+ * @param[in] param   Not used.
+ */
+static void app_timer_command_apply(void * p_param, uint32_t param)
+{
+    app_timer_info_t * pinfo = (app_timer_info_t *)p_param;
+    bool               active;
+    TickType_t         period;
+
+    UNUSED_PARAMETER(param);
+
+    CRITICAL_REGION_ENTER();
+    pinfo->pending = false;
+    active         = pinfo->active;
+    period         = pinfo->period;
+    m_commands_queued--;
+    CRITICAL_REGION_EXIT();
+
+    /* Changing the period of a dormant timer also starts it. */
+    if (active)
+    {
+        (void)xTimerChangePeriod(pinfo->osHandle, period, 0);
+    }
+    else
+    {
+        (void)xTimerStop(pinfo->osHandle, 0);
+    }
+}
+
+
+/**
+ * @brief Queue a command for a timer, unless one is already queued
+ *
+ * @param[in] pinfo Timer information, with the requested state.
+ * @retval NRF_SUCCESS       If the command is queued.
+ * @retval NRF_ERROR_NO_MEM  If the timer queue was full.
+ */
+static uint32_t app_timer_command_queue(app_timer_info_t * pinfo)
+{
+    BaseType_t result;
+    bool       queue;
+
+    CRITICAL_REGION_ENTER();
+    queue = !pinfo->pending;
+    if (queue)
+    {
+        pinfo->pending = true;
+        m_commands_queued++;
+        if (m_commands_queued > m_commands_queued_max)
+        {
+            m_commands_queued_max = m_commands_queued;
+        }
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (!queue)
+    {
+        /* The queued command applies the new state. */
+        return NRF_SUCCESS;
+    }
+
+    if (__get_IPSR() != 0)
+    {
+        BaseType_t yieldReq = pdFALSE;
+        result = xTimerPendFunctionCallFromISR(app_timer_command_apply, pinfo, 0, &yieldReq);
+        portYIELD_FROM_ISR(yieldReq);
+    }
+    else
+    {
+        result = xTimerPendFunctionCall(app_timer_command_apply, pinfo, 0, APP_TIMER_WAIT_FOR_QUEUE);
+    }
+
+    if (result != pdPASS)
+    {
+        CRITICAL_REGION_ENTER();
+        pinfo->pending = false;
+        m_commands_queued--;
+        CRITICAL_REGION_EXIT();
+        return NRF_ERROR_NO_MEM;
+    }
+
+    return NRF_SUCCESS;
+}
+#endif // APP_TIMER_CONFIG_FREERTOS_BATCHING
+
+
 uint32_t app_timer_init(uint32_t                      prescaler,
                         uint8_t                       op_queues_size,
                         void                        * p_buffer,
@@ -149,14 +269,42 @@ uint32_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *
 {
     app_timer_info_t * pinfo = (app_timer_info_t*)(timer_id);
     TimerHandle_t hTimer = pinfo->osHandle;
-    uint32_t rtc_prescaler = portNRF_RTC_REG->PRESCALER  + 1;
-    /* Get back the microseconds to wait */
-    uint32_t timeout_corrected = ROUNDED_DIV(timeout_ticks * m_prescaler, rtc_prescaler);
+    /* Convert the app_timer ticks to RTOS ticks */
+    uint32_t timeout_corrected = (uint32_t)ROUNDED_DIV((uint64_t)timeout_ticks * m_prescaler * configTICK_RATE_HZ,
+                                                       APP_TIMER_CLOCK_FREQ);
 
     if (hTimer == NULL)
     {
         return NRF_ERROR_INVALID_STATE;
     }
+    if (timeout_corrected == 0)
+    {
+        /* The timer task does not accept a period of 0 ticks */
+        timeout_corrected = 1;
+    }
+
+#if APP_TIMER_CONFIG_FREERTOS_BATCHING
+    uint32_t err_code;
+
+    if (pinfo->active && (pinfo->pending || (xTimerIsTimerActive(hTimer) != pdFALSE)))
+    {
+        // Timer already running or starting - exit silently
+        return NRF_SUCCESS;
+    }
+
+    CRITICAL_REGION_ENTER();
+    pinfo->argument = p_context;
+    pinfo->period   = timeout_corrected;
+    pinfo->active   = true;
+    CRITICAL_REGION_EXIT();
+
+    err_code = app_timer_command_queue(pinfo);
+    if (err_code != NRF_SUCCESS)
+    {
+        pinfo->active = false;
+    }
+    return err_code;
+#else
     if (pinfo->active && (xTimerIsTimerActive(hTimer) != pdFALSE))
     {
         // Timer already running - exit silently
@@ -165,6 +313,7 @@ uint32_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *
 
     pinfo->argument = p_context;
 
+    /* Changing the period of a dormant timer also starts it, so one command is enough */
     if (__get_IPSR() != 0)
     {
         BaseType_t yieldReq = pdFALSE;
@@ -173,11 +322,6 @@ uint32_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *
             return NRF_ERROR_NO_MEM;
         }
 
-        if ( xTimerStartFromISR(hTimer, &yieldReq) != pdPASS )
-        {
-            return NRF_ERROR_NO_MEM;
-        }
-
         portYIELD_FROM_ISR(yieldReq);
     }
     else
@@ -186,15 +330,22 @@ uint32_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *
         {
             return NRF_ERROR_NO_MEM;
         }
-
-        if (xTimerStart(hTimer, APP_TIMER_WAIT_FOR_QUEUE) != pdPASS)
-        {
-            return NRF_ERROR_NO_MEM;
-        }
     }
 
     pinfo->active = true;
     return NRF_SUCCESS;
+#endif // APP_TIMER_CONFIG_FREERTOS_BATCHING
+}
+
+
+uint32_t app_timer_start_with_slack(app_timer_id_t timer_id,
+                                    uint32_t       timeout_ticks,
+                                    uint32_t       slack_ticks,
+                                    void *         p_context)
+{
+    // Slack is not supported by this implementation. The timer expires at timeout_ticks.
+    UNUSED_PARAMETER(slack_ticks);
+    return app_timer_start(timer_id, timeout_ticks, p_context);
 }
 
 
@@ -207,10 +358,19 @@ uint32_t app_timer_stop(app_timer_id_t timer_id)
         return NRF_ERROR_INVALID_STATE;
     }
 
+#if APP_TIMER_CONFIG_FREERTOS_BATCHING
+    pinfo->active = false;
+    if (!pinfo->pending && (xTimerIsTimerActive(hTimer) == pdFALSE))
+    {
+        // Timer already stopped
+        return NRF_SUCCESS;
+    }
+    return app_timer_command_queue(pinfo);
+#else
     if (__get_IPSR() != 0)
     {
         BaseType_t yieldReq = pdFALSE;
-        if (xTimerStopFromISR(timer_id, &yieldReq) != pdPASS)
+        if (xTimerStopFromISR(hTimer, &yieldReq) != pdPASS)
         {
             return NRF_ERROR_NO_MEM;
         }
@@ -218,7 +378,7 @@ uint32_t app_timer_stop(app_timer_id_t timer_id)
     }
     else
     {
-        if (xTimerStop(timer_id, APP_TIMER_WAIT_FOR_QUEUE) != pdPASS)
+        if (xTimerStop(hTimer, APP_TIMER_WAIT_FOR_QUEUE) != pdPASS)
         {
             return NRF_ERROR_NO_MEM;
         }
@@ -226,5 +386,17 @@ uint32_t app_timer_stop(app_timer_id_t timer_id)
 
     pinfo->active = false;
     return NRF_SUCCESS;
+#endif // APP_TIMER_CONFIG_FREERTOS_BATCHING
+}
+
+
+uint8_t app_timer_op_queue_utilization_get(void)
+{
+#if APP_TIMER_CONFIG_FREERTOS_BATCHING
+    return m_commands_queued_max;
+#else
+    /* The commands go straight to the timer queue, which is not visible here */
+    return 0;
+#endif
 }
 #endif //NRF_MODULE_ENABLED(APP_TIMER)
@@ -184,6 +184,17 @@ uint32_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *
     }
 }
 
+uint32_t app_timer_start_with_slack(app_timer_id_t timer_id,
+                                    uint32_t       timeout_ticks,
+                                    uint32_t       slack_ticks,
+                                    void *         p_context)
+{
+    // Slack is not supported by this implementation. The timer expires at timeout_ticks.
+    UNUSED_PARAMETER(slack_ticks);
+    return app_timer_start(timer_id, timeout_ticks, p_context);
+}
+
+
 uint32_t app_timer_stop(app_timer_id_t timer_id)
 {
     app_timer_info_t * p_timer_info = (app_timer_info_t *)timer_id;
@@ -0,0 +1,513 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(TIMESLOT_MUX)
+#include "timeslot_mux.h"
+#include <string.h>
+#include "nrf.h"
+#include "app_timer.h"
+#include "app_util_platform.h"
+
+/* The module keeps its own time line in microseconds, which only advances with the slots. The
+ * start of a slot that was requested as early as possible is not known: it is taken as the end
+ * of the previous slot, and the periodic clients are scheduled again from there.
+ */
+
+/**@brief State of the session. */
+typedef enum
+{
+    MUX_STATE_IDLE,      /**< No slot is requested. */
+    MUX_STATE_REQUESTED, /**< A slot is requested. */
+    MUX_STATE_ACTIVE,    /**< A slot is running. */
+} mux_state_t;
+
+/**@brief Client control block. */
+typedef struct
+{
+    timeslot_mux_client_t const * p_client; /**< Configuration. */
+    volatile bool                 enabled;  /**< Set by the user. */
+    bool                          active;   /**< Taken into account by the scheduler. */
+    uint32_t                      next_due; /**< Start of the next slot of a periodic client. */
+    timeslot_mux_stats_t          stats;    /**< Statistics, without the duty cycle. */
+} client_cb_t;
+
+static client_cb_t              m_clients[TIMESLOT_MUX_CONFIG_MAX_CLIENTS];
+static uint8_t                  m_client_count;
+static bool                     m_initialized;
+static volatile mux_state_t     m_state;
+
+static nrf_radio_request_t                      m_request;
+static nrf_radio_signal_callback_return_param_t m_return;
+
+static uint8_t                  m_current;          /**< Client of the requested or running slot. */
+static uint32_t                 m_next_start;       /**< Start of the requested slot. */
+static uint32_t                 m_slot_start;       /**< Start of the running or last slot. */
+static uint32_t                 m_slot_length;      /**< Length of the running or last slot, with its extensions. */
+static uint8_t                  m_best_effort_next; /**< First client to test for the next best-effort slot. */
+static volatile bool            m_end_requested;
+static uint32_t                 m_reset_ticks;
+
+
+/**@brief Take the changes of the enabled clients, and skip the passed periods. */
+static void clients_update(uint32_t now)
+{
+    for (uint32_t i = 0; i < m_client_count; i++)
+    {
+        client_cb_t * p_cb = &m_clients[i];
+
+        if (!p_cb->enabled)
+        {
+            p_cb->active = false;
+            continue;
+        }
+
+        if (!p_cb->active)
+        {
+            p_cb->active   = true;
+            p_cb->next_due = now;
+        }
+        else if (p_cb->p_client->type == TIMESLOT_MUX_TYPE_PERIODIC &&
+                 (int32_t)(p_cb->next_due - now) < 0)
+        {
+            uint32_t missed = (now - p_cb->next_due) / p_cb->p_client->period_us + 1;
+
+            p_cb->next_due     += missed * p_cb->p_client->period_us;
+            p_cb->stats.missed += missed;
+        }
+    }
+}
+
+
+/**@brief Choose the next slot, and prepare its request.
+ *
+ * @param[in] now      Time of the end of the last slot.
+ * @param[in] earliest Request the slot as early as possible.
+ *
+ * @retval true  If a slot is needed.
+ * @retval false If no client is enabled.
+ */
+static bool request_prepare(uint32_t now, bool earliest)
+{
+    client_cb_t * p_periodic    = NULL;
+    int32_t       best_effort   = -1;
+    uint32_t      start         = now + TIMESLOT_MUX_CONFIG_GAP_US;
+    uint32_t      length;
+    uint8_t       id;
+
+    clients_update(now);
+
+    for (uint32_t i = 0; i < m_client_count; i++)
+    {
+        client_cb_t * p_cb = &m_clients[i];
+
+        if (p_cb->active && p_cb->p_client->type == TIMESLOT_MUX_TYPE_PERIODIC &&
+            (p_periodic == NULL || (int32_t)(p_cb->next_due - p_periodic->next_due) < 0))
+        {
+            p_periodic = p_cb;
+        }
+    }
+
+    for (uint32_t i = 0; i < m_client_count && best_effort < 0; i++)
+    {
+        uint32_t idx = (m_best_effort_next + i) % m_client_count;
+
+        if (m_clients[idx].active && m_clients[idx].p_client->type == TIMESLOT_MUX_TYPE_BEST_EFFORT)
+        {
+            best_effort = idx;
+        }
+    }
+
+    if (best_effort >= 0 && (p_periodic == NULL || !earliest))
+    {
+        length = m_clients[best_effort].p_client->length_us;
+
+        if (p_periodic != NULL)
+        {
+            // Only the time before the next periodic slot can be used
+            uint32_t free = p_periodic->next_due - now;
+
+            if (free < length + 2 * TIMESLOT_MUX_CONFIG_GAP_US)
+            {
+                length = (free > 2 * TIMESLOT_MUX_CONFIG_GAP_US) ? free - 2 * TIMESLOT_MUX_CONFIG_GAP_US : 0;
+            }
+            if (length < NRF_RADIO_LENGTH_MIN_US + TIMESLOT_MUX_CONFIG_END_MARGIN_US)
+            {
+                best_effort = -1;
+            }
+        }
+    }
+    else
+    {
+        best_effort = -1;
+    }
+
+    if (best_effort >= 0)
+    {
+        id                 = best_effort;
+        m_best_effort_next = (best_effort + 1) % m_client_count;
+    }
+    else if (p_periodic != NULL)
+    {
+        id     = p_periodic - m_clients;
+        length = p_periodic->p_client->length_us;
+        if ((int32_t)(p_periodic->next_due - start) > 0)
+        {
+            start = p_periodic->next_due;
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    m_current = id;
+
+    if (earliest)
+    {
+        m_next_start                           = now;
+        m_request.request_type                 = NRF_RADIO_REQ_TYPE_EARLIEST;
+        m_request.params.earliest.hfclk        = NRF_RADIO_HFCLK_CFG_XTAL_GUARANTEED;
+        m_request.params.earliest.priority     = m_clients[id].p_client->priority;
+        m_request.params.earliest.length_us    = length;
+        m_request.params.earliest.timeout_us   = TIMESLOT_MUX_CONFIG_EARLIEST_TIMEOUT_US;
+    }
+    else
+    {
+        m_next_start                           = start;
+        m_request.request_type                 = NRF_RADIO_REQ_TYPE_NORMAL;
+        m_request.params.normal.hfclk          = NRF_RADIO_HFCLK_CFG_XTAL_GUARANTEED;
+        m_request.params.normal.priority       = m_clients[id].p_client->priority;
+        m_request.params.normal.distance_us    = start - m_slot_start;
+        m_request.params.normal.length_us      = length;
+    }
+
+    return true;
+}
+
+
+/**@brief Request a slot as early as possible, from thread or interrupt context. */
+static ret_code_t request_start(void)
+{
+    ret_code_t err_code = NRF_SUCCESS;
+
+    CRITICAL_REGION_ENTER();
+    if (m_state == MUX_STATE_IDLE && request_prepare(m_slot_start + m_slot_length, true))
+    {
+        m_state  = MUX_STATE_REQUESTED;
+        err_code = sd_radio_request(&m_request);
+        if (err_code != NRF_SUCCESS)
+        {
+            m_state = MUX_STATE_IDLE;
+        }
+    }
+    CRITICAL_REGION_EXIT();
+
+    return err_code;
+}
+
+
+static uint32_t request_length_get(void)
+{
+    return (m_request.request_type == NRF_RADIO_REQ_TYPE_EARLIEST) ?
+           m_request.params.earliest.length_us : m_request.params.normal.length_us;
+}
+
+
+static void slot_start(client_cb_t * p_cb)
+{
+    m_state         = MUX_STATE_ACTIVE;
+    m_end_requested = false;
+    m_slot_start    = m_next_start;
+    m_slot_length   = request_length_get();
+
+    p_cb->stats.slots++;
+    p_cb->stats.time_us += m_slot_length;
+    if (p_cb->p_client->type == TIMESLOT_MUX_TYPE_PERIODIC)
+    {
+        p_cb->next_due = m_slot_start + p_cb->p_client->period_us;
+    }
+
+    NRF_TIMER0->CC[0]    = m_slot_length - TIMESLOT_MUX_CONFIG_END_MARGIN_US;
+    NRF_TIMER0->INTENSET = TIMER_INTENSET_COMPARE0_Msk;
+
+    p_cb->p_client->handlers.start(m_slot_length);
+}
+
+
+/**@brief End the current slot, and request the next one if needed. */
+static nrf_radio_signal_callback_return_param_t * slot_finish(client_cb_t * p_cb, bool notify)
+{
+    if (notify)
+    {
+        p_cb->p_client->handlers.end();
+    }
+
+    NRF_TIMER0->INTENCLR = TIMER_INTENCLR_COMPARE0_Msk;
+
+    if (request_prepare(m_slot_start + m_slot_length, false))
+    {
+        m_state                                 = MUX_STATE_REQUESTED;
+        m_return.callback_action                = NRF_RADIO_SIGNAL_CALLBACK_ACTION_REQUEST_AND_END;
+        m_return.params.request.p_next          = &m_request;
+    }
+    else
+    {
+        m_state                                 = MUX_STATE_IDLE;
+        m_return.callback_action                = NRF_RADIO_SIGNAL_CALLBACK_ACTION_END;
+    }
+
+    return &m_return;
+}
+
+
+/**@brief Check that a best-effort slot can be extended without delaying the other clients. */
+static bool extension_allowed(client_cb_t const * p_cb)
+{
+    uint32_t end = m_slot_start + m_slot_length + TIMESLOT_MUX_CONFIG_EXTEND_US + TIMESLOT_MUX_CONFIG_GAP_US;
+
+    if (p_cb->p_client->type != TIMESLOT_MUX_TYPE_BEST_EFFORT || !p_cb->p_client->extend || !p_cb->enabled)
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < m_client_count; i++)
+    {
+        client_cb_t const * p_other = &m_clients[i];
+
+        if (p_other == p_cb || !p_other->enabled)
+        {
+            continue;
+        }
+
+        // Another best-effort client gets the next slot
+        if (p_other->p_client->type == TIMESLOT_MUX_TYPE_BEST_EFFORT)
+        {
+            return false;
+        }
+
+        if (p_other->active && (int32_t)(p_other->next_due - end) < 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static nrf_radio_signal_callback_return_param_t * signal_callback(uint8_t signal_type)
+{
+    client_cb_t                   * p_cb       = &m_clients[m_current];
+    timeslot_mux_handlers_t const * p_handlers = &p_cb->p_client->handlers;
+
+    m_return.callback_action = NRF_RADIO_SIGNAL_CALLBACK_ACTION_NONE;
+
+    switch (signal_type)
+    {
+        case NRF_RADIO_CALLBACK_SIGNAL_TYPE_START:
+            slot_start(p_cb);
+            break;
+
+        case NRF_RADIO_CALLBACK_SIGNAL_TYPE_TIMER0:
+            if (NRF_TIMER0->EVENTS_COMPARE[0] != 0)
+            {
+                NRF_TIMER0->EVENTS_COMPARE[0] = 0;
+                if (!extension_allowed(p_cb))
+                {
+                    return slot_finish(p_cb, true);
+                }
+                m_return.callback_action         = NRF_RADIO_SIGNAL_CALLBACK_ACTION_EXTEND;
+                m_return.params.extend.length_us = TIMESLOT_MUX_CONFIG_EXTEND_US;
+            }
+            else if (p_handlers->timer_irq != NULL)
+            {
+                p_handlers->timer_irq();
+            }
+            break;
+
+        case NRF_RADIO_CALLBACK_SIGNAL_TYPE_RADIO:
+            if (p_handlers->radio_irq != NULL)
+            {
+                p_handlers->radio_irq();
+            }
+            break;
+
+        case NRF_RADIO_CALLBACK_SIGNAL_TYPE_EXTEND_SUCCEEDED:
+            m_slot_length        += TIMESLOT_MUX_CONFIG_EXTEND_US;
+            p_cb->stats.time_us  += TIMESLOT_MUX_CONFIG_EXTEND_US;
+            p_cb->stats.extensions++;
+            NRF_TIMER0->CC[0]    += TIMESLOT_MUX_CONFIG_EXTEND_US;
+            if (p_handlers->extended != NULL)
+            {
+                p_handlers->extended(m_slot_length);
+            }
+            break;
+
+        case NRF_RADIO_CALLBACK_SIGNAL_TYPE_EXTEND_FAILED:
+            return slot_finish(p_cb, true);
+
+        default:
+            break;
+    }
+
+    if (m_end_requested && m_return.callback_action == NRF_RADIO_SIGNAL_CALLBACK_ACTION_NONE)
+    {
+        return slot_finish(p_cb, false);
+    }
+
+    return &m_return;
+}
+
+
+ret_code_t timeslot_mux_init(void)
+{
+    ret_code_t err_code;
+
+    if (m_initialized)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    err_code = sd_radio_session_open(signal_callback);
+    VERIFY_SUCCESS(err_code);
+
+    m_state        = MUX_STATE_IDLE;
+    m_slot_start   = 0;
+    m_slot_length  = 0;
+    m_reset_ticks  = app_timer_cnt_get();
+    m_initialized  = true;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t timeslot_mux_client_add(timeslot_mux_client_t const * p_client,
+                                   timeslot_mux_client_id_t    * p_id)
+{
+    VERIFY_PARAM_NOT_NULL(p_client);
+    VERIFY_PARAM_NOT_NULL(p_id);
+    VERIFY_PARAM_NOT_NULL(p_client->handlers.start);
+    VERIFY_PARAM_NOT_NULL(p_client->handlers.end);
+
+    if (p_client->length_us < NRF_RADIO_LENGTH_MIN_US + TIMESLOT_MUX_CONFIG_END_MARGIN_US ||
+        p_client->length_us > NRF_RADIO_LENGTH_MAX_US)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if (p_client->type == TIMESLOT_MUX_TYPE_PERIODIC &&
+        (p_client->period_us < p_client->length_us + TIMESLOT_MUX_CONFIG_GAP_US ||
+         p_client->period_us > NRF_RADIO_DISTANCE_MAX_US))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if (m_client_count >= TIMESLOT_MUX_CONFIG_MAX_CLIENTS)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    memset(&m_clients[m_client_count], 0, sizeof(m_clients[0]));
+    m_clients[m_client_count].p_client = p_client;
+
+    *p_id = m_client_count++;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t timeslot_mux_client_enable(timeslot_mux_client_id_t id, bool enable)
+{
+    if (id >= m_client_count)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    m_clients[id].enabled = enable;
+
+    // A slot that ends now takes the client into account, otherwise the session is idle
+    return enable ? request_start() : NRF_SUCCESS;
+}
+
+
+void timeslot_mux_slot_end(void)
+{
+    m_end_requested = true;
+}
+
+
+void timeslot_mux_sys_evt_handler(uint32_t sys_evt)
+{
+    client_cb_t * p_cb = &m_clients[m_current];
+
+    switch (sys_evt)
+    {
+        case NRF_EVT_RADIO_BLOCKED:
+        case NRF_EVT_RADIO_CANCELED:
+            // The slot is lost, a periodic client waits for its next period
+            p_cb->stats.blocked++;
+            if (p_cb->p_client->type == TIMESLOT_MUX_TYPE_PERIODIC)
+            {
+                p_cb->next_due = m_next_start + p_cb->p_client->period_us;
+            }
+            m_state = MUX_STATE_IDLE;
+            (void)request_start();
+            break;
+
+        case NRF_EVT_RADIO_SIGNAL_CALLBACK_INVALID_RETURN:
+            m_state = MUX_STATE_IDLE;
+            (void)request_start();
+            break;
+
+        case NRF_EVT_RADIO_SESSION_CLOSED:
+            m_initialized = false;
+            m_state       = MUX_STATE_IDLE;
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+ret_code_t timeslot_mux_stats_get(timeslot_mux_client_id_t id, timeslot_mux_stats_t * p_stats)
+{
+    uint32_t ticks;
+    uint64_t elapsed_us;
+
+    if (id >= m_client_count)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    (void)app_timer_cnt_diff_compute(app_timer_cnt_get(), m_reset_ticks, &ticks);
+    elapsed_us = ((uint64_t)ticks * 1000000 * (TIMESLOT_MUX_CONFIG_APP_TIMER_PRESCALER + 1)) /
+                 APP_TIMER_CLOCK_FREQ;
+
+    *p_stats = m_clients[id].stats;
+    p_stats->duty_cycle = (elapsed_us == 0) ? 0 :
+                          (uint16_t)MIN(((uint64_t)p_stats->time_us * 1000) / elapsed_us, 1000);
+
+    return NRF_SUCCESS;
+}
+
+
+void timeslot_mux_stats_reset(void)
+{
+    for (uint32_t i = 0; i < m_client_count; i++)
+    {
+        memset(&m_clients[i].stats, 0, sizeof(m_clients[i].stats));
+    }
+    m_reset_ticks = app_timer_cnt_get();
+}
+
+#endif //NRF_MODULE_ENABLED(TIMESLOT_MUX)
@@ -0,0 +1,220 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup timeslot_mux Radio timeslot multiplexer
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for sharing the radio timeslots of the SoftDevice between several proprietary
+ *        protocols.
+ *
+ * @details The module opens one timeslot session and chains the requests for its clients. A
+ *          periodic client gets a slot of its length every period, a best-effort client gets the
+ *          time between the periodic slots. Best-effort slots can be extended while the SoftDevice
+ *          does not need the radio, up to the start of the next periodic slot.
+ *
+ *          The handlers of a client are called from the timeslot signal callback, at interrupt
+ *          priority 0, where no SoftDevice function can be called. During a slot, the client owns
+ *          the RADIO peripheral and the compare registers 1 to 3 of TIMER0, which counts in
+ *          microseconds from the start of the slot. TIMER0 compare register 0 is used by this
+ *          module to end the slot on time.
+ *
+ *          A client that uses @ref nrf_esb calls RADIO_IRQHandler of the ESB library from its
+ *          radio handler, and stops ESB in its end handler.
+ *
+ * @note The SoftDevice system events must be passed to @ref timeslot_mux_sys_evt_handler.
+ * @note The duty cycle is measured with the RTC1 counter of @ref app_timer, which must be running.
+ */
+
+#ifndef TIMESLOT_MUX_H__
+#define TIMESLOT_MUX_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nrf_soc.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Maximum number of clients.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef TIMESLOT_MUX_CONFIG_MAX_CLIENTS
+#define TIMESLOT_MUX_CONFIG_MAX_CLIENTS         4
+#endif
+
+/** @brief Time in microseconds before the end of a slot at which it is extended or ended.
+ *
+ * The end handler of the client must return within this time.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef TIMESLOT_MUX_CONFIG_END_MARGIN_US
+#define TIMESLOT_MUX_CONFIG_END_MARGIN_US       200
+#endif
+
+/** @brief Length in microseconds of one extension of a best-effort slot.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef TIMESLOT_MUX_CONFIG_EXTEND_US
+#define TIMESLOT_MUX_CONFIG_EXTEND_US           5000
+#endif
+
+/** @brief Time in microseconds kept free between two slots of this module.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef TIMESLOT_MUX_CONFIG_GAP_US
+#define TIMESLOT_MUX_CONFIG_GAP_US              200
+#endif
+
+/** @brief Longest wait in microseconds for a slot requested as early as possible.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef TIMESLOT_MUX_CONFIG_EARLIEST_TIMEOUT_US
+#define TIMESLOT_MUX_CONFIG_EARLIEST_TIMEOUT_US 100000
+#endif
+
+/** @brief Prescaler of @ref app_timer, to convert the RTC1 ticks to microseconds.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef TIMESLOT_MUX_CONFIG_APP_TIMER_PRESCALER
+#define TIMESLOT_MUX_CONFIG_APP_TIMER_PRESCALER 0
+#endif
+
+/**@brief Slot needs of a client. */
+typedef enum
+{
+    TIMESLOT_MUX_TYPE_PERIODIC,    /**< A slot of a fixed length every period. */
+    TIMESLOT_MUX_TYPE_BEST_EFFORT, /**< As much time as possible, between the periodic slots. */
+} timeslot_mux_type_t;
+
+/**@brief Handlers of a client, called at interrupt priority 0.
+ *
+ * Only the start and end handlers are mandatory.
+ */
+typedef struct
+{
+    void (* start)(uint32_t length_us);  /**< Slot start. The radio can be used for @p length_us, minus the end margin. */
+    void (* extended)(uint32_t length_us); /**< The slot was extended, its length is now @p length_us. */
+    void (* radio_irq)(void);            /**< RADIO interrupt. */
+    void (* timer_irq)(void);            /**< TIMER0 interrupt, for compare registers 1 to 3. */
+    void (* end)(void);                  /**< Slot end. The radio must be disabled before return. */
+} timeslot_mux_handlers_t;
+
+/**@brief Client configuration. */
+typedef struct
+{
+    timeslot_mux_type_t     type;        /**< Slot needs. */
+    uint32_t                length_us;   /**< Length of a slot, or of the first part of a best-effort slot. */
+    uint32_t                period_us;   /**< Distance between the starts of two slots, for a periodic client. */
+    uint8_t                 priority;    /**< Priority of the requests, see @ref NRF_RADIO_PRIORITY. */
+    bool                    extend;      /**< Extend best-effort slots while the SoftDevice is idle. */
+    timeslot_mux_handlers_t handlers;    /**< Handlers. */
+} timeslot_mux_client_t;
+
+/**@brief Statistics of a client. */
+typedef struct
+{
+    uint32_t slots;                      /**< Slots started. */
+    uint32_t blocked;                    /**< Requests that were blocked or canceled by the SoftDevice. */
+    uint32_t missed;                     /**< Periods without a slot, for a periodic client. */
+    uint32_t extensions;                 /**< Successful extensions. */
+    uint32_t time_us;                    /**< Total length of the slots, with their extensions. */
+    uint16_t duty_cycle;                 /**< Part of the time in slots since the last reset, in 1/1000. */
+} timeslot_mux_stats_t;
+
+/**@brief Client identifier. */
+typedef uint8_t timeslot_mux_client_id_t;
+
+
+/**@brief Function for initializing the module and opening the timeslot session.
+ *
+ * @retval NRF_SUCCESS             If the session was opened.
+ * @retval NRF_ERROR_INVALID_STATE If the module was already initialized.
+ * @return Other errors from sd_radio_session_open.
+ */
+ret_code_t timeslot_mux_init(void);
+
+
+/**@brief Function for adding a client. The client is disabled.
+ *
+ * @param[in]  p_client Client configuration. It must be kept in memory.
+ * @param[out] p_id     Identifier of the client.
+ *
+ * @retval NRF_SUCCESS             If the client was added.
+ * @retval NRF_ERROR_NULL          If a parameter or a mandatory handler was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If the length or the period was out of range.
+ * @retval NRF_ERROR_NO_MEM        If there were already @ref TIMESLOT_MUX_CONFIG_MAX_CLIENTS clients.
+ */
+ret_code_t timeslot_mux_client_add(timeslot_mux_client_t const * p_client,
+                                   timeslot_mux_client_id_t    * p_id);
+
+
+/**@brief Function for enabling or disabling the slots of a client.
+ *
+ * A disabled client gets no new slots. The current slot is not ended. Must not be called from the
+ * handlers of a client.
+ *
+ * @retval NRF_SUCCESS             If the client was enabled or disabled.
+ * @retval NRF_ERROR_INVALID_PARAM If the identifier was invalid.
+ * @return Other errors from sd_radio_request.
+ */
+ret_code_t timeslot_mux_client_enable(timeslot_mux_client_id_t id, bool enable);
+
+
+/**@brief Function for ending the current slot before its end.
+ *
+ * To be called from the handlers of the client that owns the slot. The end handler is not called.
+ */
+void timeslot_mux_slot_end(void);
+
+
+/**@brief Function for handling the SoftDevice system events.
+ *
+ * @param[in] sys_evt System event from the SoftDevice.
+ */
+void timeslot_mux_sys_evt_handler(uint32_t sys_evt);
+
+
+/**@brief Function for getting the statistics of a client.
+ *
+ * @param[in]  id      Identifier of the client.
+ * @param[out] p_stats Statistics.
+ *
+ * @retval NRF_SUCCESS             If the statistics were read.
+ * @retval NRF_ERROR_INVALID_PARAM If the identifier was invalid.
+ */
+ret_code_t timeslot_mux_stats_get(timeslot_mux_client_id_t id, timeslot_mux_stats_t * p_stats);
+
+
+/**@brief Function for resetting the statistics of all clients.
+ *
+ * The duty cycle is measured from this call, which must be repeated before the RTC1 counter wraps.
+ */
+void timeslot_mux_stats_reset(void);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TIMESLOT_MUX_H__
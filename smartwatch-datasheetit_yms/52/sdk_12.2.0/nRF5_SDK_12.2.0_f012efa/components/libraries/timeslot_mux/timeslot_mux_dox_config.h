@@ -0,0 +1,64 @@
+/**
+ *
+ * @defgroup timeslot_mux_config timeslot_mux module configuration
+ * @{
+ * @ingroup timeslot_mux
+ */
+/** @brief Enabling timeslot_mux module
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define TIMESLOT_MUX_ENABLED
+
+
+/** @brief Maximum number of clients.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define TIMESLOT_MUX_CONFIG_MAX_CLIENTS
+
+
+/** @brief Time in microseconds before the end of a slot at which it is extended or ended.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define TIMESLOT_MUX_CONFIG_END_MARGIN_US
+
+
+/** @brief Length in microseconds of one extension of a best-effort slot.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define TIMESLOT_MUX_CONFIG_EXTEND_US
+
+
+/** @brief Time in microseconds kept free between two slots of this module.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define TIMESLOT_MUX_CONFIG_GAP_US
+
+
+/** @brief Longest wait in microseconds for a slot requested as early as possible.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define TIMESLOT_MUX_CONFIG_EARLIEST_TIMEOUT_US
+
+
+/** @brief Prescaler of app_timer, to convert the RTC1 ticks to microseconds.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define TIMESLOT_MUX_CONFIG_APP_TIMER_PRESCALER
+
+
+/** @} */
@@ -0,0 +1,227 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(NRF_TIMESTAMP)
+#include "nrf_timestamp.h"
+#include "nrf_rtc.h"
+#include "nrf_drv_ppi.h"
+#include "app_util_platform.h"
+
+#define TS_RTC          CONCAT_2(NRF_RTC, NRF_TIMESTAMP_CONFIG_RTC_INSTANCE)
+#define TS_RTC_IRQn     CONCAT_3(RTC, NRF_TIMESTAMP_CONFIG_RTC_INSTANCE, _IRQn)
+#define TS_RTC_HANDLER  CONCAT_3(RTC, NRF_TIMESTAMP_CONFIG_RTC_INSTANCE, _IRQHandler)
+
+#define COUNTER_BITS    24                          /**< Width of the RTC counter. */
+#define COUNTER_HALF    (1UL << (COUNTER_BITS - 1)) /**< Counter values below this one are after a recent overflow. */
+#define EPOCH_BUSY      1UL                         /**< Bit of m_epoch set by the interrupt while the overflow event is not yet cleared. */
+
+/**@brief Number of overflows shifted by one, and @ref EPOCH_BUSY. Only written by the interrupt. */
+static volatile uint32_t m_epoch;
+
+static struct
+{
+    nrf_drv_timer_t const * p_timer;     /**< TIMER of the refinement, or NULL. */
+    nrf_ppi_channel_t       ppi_channel; /**< RTC TICK to TIMER CLEAR. */
+    uint32_t                hires_count; /**< Calls to nrf_timestamp_hires_start not yet matched. */
+    volatile bool           hires;       /**< The refinement is running. */
+    bool                    initialized;
+} m_cb;
+
+
+/**@brief Handler for the TIMER. It runs without interrupts. */
+static void timer_handler(nrf_timer_event_t event_type, void * p_context)
+{
+    UNUSED_PARAMETER(event_type);
+    UNUSED_PARAMETER(p_context);
+}
+
+
+/**@brief Handler for the overflow of the RTC.
+ *
+ * @details m_epoch already holds the new overflow count while the event is still set. A time stamp
+ *          taken from a higher priority in between sees @ref EPOCH_BUSY, and ignores the event.
+ */
+void TS_RTC_HANDLER(void)
+{
+    uint32_t epoch = (m_epoch >> 1) + 1;
+
+    if (nrf_rtc_event_pending(TS_RTC, NRF_RTC_EVENT_OVERFLOW))
+    {
+        m_epoch = (epoch << 1) | EPOCH_BUSY;
+        __DMB();
+        nrf_rtc_event_clear(TS_RTC, NRF_RTC_EVENT_OVERFLOW);
+        // Read back, so the event is cleared before the interrupt returns.
+        (void)nrf_rtc_event_pending(TS_RTC, NRF_RTC_EVENT_OVERFLOW);
+        m_epoch = (epoch << 1);
+    }
+}
+
+
+ret_code_t nrf_timestamp_init(nrf_drv_timer_t const * p_timer)
+{
+    ret_code_t err_code;
+
+    if (m_cb.initialized)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    m_cb.p_timer     = p_timer;
+    m_cb.hires_count = 0;
+    m_cb.hires       = false;
+
+    if (p_timer != NULL)
+    {
+        nrf_drv_timer_config_t timer_config = NRF_DRV_TIMER_DEFAULT_CONFIG;
+
+        err_code = nrf_drv_ppi_init();
+        if ((err_code != NRF_SUCCESS) && (err_code != NRF_ERROR_MODULE_ALREADY_INITIALIZED))
+        {
+            return NRF_ERROR_INTERNAL;
+        }
+
+        timer_config.frequency = NRF_TIMER_FREQ_1MHz;
+        timer_config.mode      = NRF_TIMER_MODE_TIMER;
+        timer_config.bit_width = NRF_TIMER_BIT_WIDTH_32;
+
+        err_code = nrf_drv_timer_init(p_timer, &timer_config, timer_handler);
+        VERIFY_SUCCESS(err_code);
+
+        if (nrf_drv_ppi_channel_alloc(&m_cb.ppi_channel) != NRF_SUCCESS)
+        {
+            nrf_drv_timer_uninit(p_timer);
+            return NRF_ERROR_NO_MEM;
+        }
+        (void)nrf_drv_ppi_channel_assign(m_cb.ppi_channel,
+                                         nrf_rtc_event_address_get(TS_RTC, NRF_RTC_EVENT_TICK),
+                                         nrf_drv_timer_task_address_get(p_timer,
+                                                                        NRF_TIMER_TASK_CLEAR));
+    }
+
+    // The prescaler can only be written while the RTC is stopped.
+    nrf_rtc_task_trigger(TS_RTC, NRF_RTC_TASK_STOP);
+    nrf_rtc_prescaler_set(TS_RTC, 0);
+    nrf_rtc_task_trigger(TS_RTC, NRF_RTC_TASK_CLEAR);
+    nrf_rtc_event_clear(TS_RTC, NRF_RTC_EVENT_OVERFLOW);
+    m_epoch = 0;
+
+    nrf_rtc_int_enable(TS_RTC, NRF_RTC_INT_OVERFLOW_MASK);
+    NVIC_ClearPendingIRQ(TS_RTC_IRQn);
+    NVIC_SetPriority(TS_RTC_IRQn, NRF_TIMESTAMP_CONFIG_IRQ_PRIORITY);
+    NVIC_EnableIRQ(TS_RTC_IRQn);
+
+    nrf_rtc_task_trigger(TS_RTC, NRF_RTC_TASK_START);
+
+    m_cb.initialized = true;
+    return NRF_SUCCESS;
+}
+
+
+uint64_t nrf_timestamp_ticks_get(void)
+{
+    uint32_t epoch;
+    uint32_t epoch_check;
+    uint32_t counter;
+    bool     overflow;
+
+    // Repeated if the overflow interrupt ran in between.
+    do
+    {
+        epoch       = m_epoch;
+        counter     = nrf_rtc_counter_get(TS_RTC);
+        overflow    = (nrf_rtc_event_pending(TS_RTC, NRF_RTC_EVENT_OVERFLOW) != 0);
+        epoch_check = m_epoch;
+    } while (epoch != epoch_check);
+
+    // An overflow not yet counted by the interrupt. A high counter was read before the overflow.
+    if (overflow && ((epoch & EPOCH_BUSY) == 0) && (counter < COUNTER_HALF))
+    {
+        epoch += 2;
+    }
+
+    return ((uint64_t)(epoch >> 1) << COUNTER_BITS) | counter;
+}
+
+
+uint64_t nrf_timestamp_us_get(void)
+{
+    uint64_t ticks;
+    uint64_t ticks_check;
+    uint64_t start;
+    uint32_t length;
+    uint32_t sub;
+
+    if (!m_cb.hires)
+    {
+        return NRF_TIMESTAMP_TICKS_TO_US(nrf_timestamp_ticks_get());
+    }
+
+    // Repeated if the TIMER was cleared by a tick in between.
+    do
+    {
+        ticks       = nrf_timestamp_ticks_get();
+        sub         = nrf_drv_timer_capture(m_cb.p_timer, NRF_TIMER_CC_CHANNEL0);
+        ticks_check = nrf_timestamp_ticks_get();
+    } while (ticks != ticks_check);
+
+    start  = NRF_TIMESTAMP_TICKS_TO_US(ticks);
+    length = (uint32_t)(NRF_TIMESTAMP_TICKS_TO_US(ticks + 1) - start);
+
+    return start + MIN(sub, length - 1);
+}
+
+
+uint32_t nrf_timestamp_log_get(void)
+{
+    return (uint32_t)nrf_timestamp_us_get();
+}
+
+
+void nrf_timestamp_hires_start(void)
+{
+    if (m_cb.p_timer == NULL)
+    {
+        return;
+    }
+
+    CRITICAL_REGION_ENTER();
+    if (m_cb.hires_count++ == 0)
+    {
+        nrf_drv_timer_clear(m_cb.p_timer);
+        nrf_drv_timer_enable(m_cb.p_timer);
+        nrf_rtc_event_enable(TS_RTC, NRF_RTC_INT_TICK_MASK);
+        (void)nrf_drv_ppi_channel_enable(m_cb.ppi_channel);
+        m_cb.hires = true;
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+
+void nrf_timestamp_hires_stop(void)
+{
+    if (m_cb.p_timer == NULL)
+    {
+        return;
+    }
+
+    CRITICAL_REGION_ENTER();
+    if ((m_cb.hires_count > 0) && (--m_cb.hires_count == 0))
+    {
+        m_cb.hires = false;
+        (void)nrf_drv_ppi_channel_disable(m_cb.ppi_channel);
+        nrf_rtc_event_disable(TS_RTC, NRF_RTC_INT_TICK_MASK);
+        nrf_drv_timer_disable(m_cb.p_timer);
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+#endif // NRF_MODULE_ENABLED(NRF_TIMESTAMP)
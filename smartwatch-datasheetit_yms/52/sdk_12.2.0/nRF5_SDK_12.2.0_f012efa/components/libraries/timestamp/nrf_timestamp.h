@@ -0,0 +1,132 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup nrf_timestamp Monotonic time stamps
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for 64-bit monotonic time stamps, shared by logging, profiling and time keeping.
+ *
+ * @details A free running RTC, which is never stopped or cleared, is the time base. Its 24-bit
+ *          counter is extended to 64 bits by counting the overflows, the only interrupt of the
+ *          module: once every 512 seconds. A time stamp taken before the overflow interrupt has
+ *          run, or from a higher priority that preempted it, still accounts for the overflow, so
+ *          the time stamps never go back. They can be taken from any priority, and from
+ *          interrupt handlers, without a critical region.
+ *
+ *          The RTC has a resolution of about 30.5 microseconds. While HFCLK is running anyway, for
+ *          example during a radio or a USB activity, the time stamps can be refined to one
+ *          microsecond with a TIMER: the TICK event of the RTC clears the TIMER through PPI, so
+ *          the TIMER counts the microseconds since the last RTC tick. See
+ *          @ref nrf_timestamp_hires_start.
+ *
+ *          @ref app_timer does not fit as a time base: it stops and clears RTC1 when no timer is
+ *          running. The RTC instance of the module must not be enabled in the RTC driver.
+ *
+ * @note LFCLK must be running, for example started by the SoftDevice or by @ref nrf_drv_clock.
+ */
+
+#ifndef NRF_TIMESTAMP_H__
+#define NRF_TIMESTAMP_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nrf_drv_timer.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief RTC instance of the time base.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef NRF_TIMESTAMP_CONFIG_RTC_INSTANCE
+#define NRF_TIMESTAMP_CONFIG_RTC_INSTANCE 2
+#endif
+
+/** @brief Priority of the overflow interrupt. Any priority gives correct time stamps.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef NRF_TIMESTAMP_CONFIG_IRQ_PRIORITY
+#define NRF_TIMESTAMP_CONFIG_IRQ_PRIORITY APP_IRQ_PRIORITY_LOWEST
+#endif
+
+#define NRF_TIMESTAMP_TICKS_PER_SECOND 32768 /**< Frequency of the RTC. */
+
+/**@brief Macro for converting RTC ticks to microseconds, rounding down. */
+#define NRF_TIMESTAMP_TICKS_TO_US(ticks) (((uint64_t)(ticks) * 15625) >> 9)
+
+/**@brief Macro for converting microseconds to RTC ticks, rounding down. */
+#define NRF_TIMESTAMP_US_TO_TICKS(us)    (((uint64_t)(us) << 9) / 15625)
+
+/**@brief Function for initializing the module, and starting the RTC.
+ *
+ * @param[in] p_timer TIMER instance for @ref nrf_timestamp_hires_start, or NULL to use the RTC
+ *                    only. Must not be initialized.
+ *
+ * @retval NRF_SUCCESS             If the module was initialized.
+ * @retval NRF_ERROR_INVALID_STATE If the module was already initialized.
+ * @retval NRF_ERROR_NO_MEM        If no PPI channel was free.
+ * @retval NRF_ERROR_INTERNAL      If the PPI driver could not be initialized.
+ * @return Any error returned by the TIMER driver.
+ */
+ret_code_t nrf_timestamp_init(nrf_drv_timer_t const * p_timer);
+
+/**@brief Function for getting the time since initialization, in RTC ticks.
+ *
+ * @return Time stamp, in units of 1 / @ref NRF_TIMESTAMP_TICKS_PER_SECOND s.
+ */
+uint64_t nrf_timestamp_ticks_get(void);
+
+/**@brief Function for getting the time since initialization, in microseconds.
+ *
+ * @details Refined by the TIMER between two RTC ticks while @ref nrf_timestamp_hires_start is in
+ *          effect, and rounded down to a tick otherwise. The refinement is clamped to the tick, so
+ *          time stamps with and without it can be compared.
+ *
+ * @return Time stamp, in microseconds.
+ */
+uint64_t nrf_timestamp_us_get(void);
+
+/**@brief Function for getting a 32-bit time stamp, in microseconds, for @ref NRF_LOG_INIT.
+ *
+ * @return Lower 32 bits of @ref nrf_timestamp_us_get. They wrap after about 71 minutes.
+ */
+uint32_t nrf_timestamp_log_get(void);
+
+/**@brief Function for refining the time stamps with the TIMER.
+ *
+ * @details The TIMER requests HFCLK. Call this function when HFCLK is started for another reason,
+ *          and @ref nrf_timestamp_hires_stop before it is released. Calls are counted: the
+ *          refinement stops with the last @ref nrf_timestamp_hires_stop.
+ *
+ *          Refined time stamps are only valid from the next RTC tick, about 30.5 microseconds.
+ */
+void nrf_timestamp_hires_start(void);
+
+/**@brief Function for stopping the refinement, once every @ref nrf_timestamp_hires_start has
+ *        been matched.
+ */
+void nrf_timestamp_hires_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_TIMESTAMP_H__
+
+/** @} */
@@ -0,0 +1,34 @@
+/**
+ *
+ * @defgroup nrf_timestamp_config Monotonic time stamps configuration
+ * @{
+ * @ingroup nrf_timestamp
+ */
+/** @brief Enabling the monotonic time stamps
+ *
+ *  Requires the TIMER and PPI drivers for the refinement. The RTC instance must not be enabled
+ *  in the RTC driver.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_TIMESTAMP_ENABLED
+
+/** @brief RTC instance of the time base.
+ *
+ *  <1=> 1
+ *  <2=> 2
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_TIMESTAMP_CONFIG_RTC_INSTANCE
+
+/** @brief Priority of the overflow interrupt.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_TIMESTAMP_CONFIG_IRQ_PRIORITY
+
+
+/** @} */
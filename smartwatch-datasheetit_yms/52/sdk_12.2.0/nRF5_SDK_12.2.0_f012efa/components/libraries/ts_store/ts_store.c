@@ -0,0 +1,583 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(TS_STORE)
+#include "ts_store.h"
+#include <string.h>
+#include "fds.h"
+
+// Block layout: first sequence number, number of records, then the records, each as its time
+// followed by its data padded to a word.
+#define BLOCK_SEQ       0
+#define BLOCK_COUNT     1
+#define BLOCK_SLOTS     2
+
+/**@brief Block of the store, in flash or in RAM. */
+typedef struct
+{
+    uint32_t const  * p_block; //!< Block.
+    fds_record_desc_t desc;    //!< Descriptor, if the block was opened in flash.
+    bool              opened;  //!< The block was opened in flash.
+} block_view_t;
+
+static ts_store_t * m_stores[TS_STORE_CONFIG_STORE_COUNT]; //!< Initialized stores.
+static uint8_t      m_store_count;                         //!< Number of initialized stores.
+
+
+static uint32_t slot_words(ts_store_t const * p_store)
+{
+    return TS_STORE_SLOT_WORDS(p_store->record_size);
+}
+
+
+static uint32_t * buffer_get(ts_store_t const * p_store, uint8_t buf)
+{
+    return &p_store->p_buffers[buf * TS_STORE_BLOCK_WORDS(p_store->record_size, p_store->block_records)];
+}
+
+
+/**@brief Number of blocks, including the block being filled. */
+static uint16_t blocks_total(ts_store_t const * p_store)
+{
+    return p_store->block_count + ((p_store->open_count > 0) ? 1 : 0);
+}
+
+
+static uint32_t block_first_seq(ts_store_t const * p_store, uint16_t block)
+{
+    if (block < p_store->block_count)
+    {
+        return p_store->p_index[block].seq;
+    }
+    return p_store->next_seq - p_store->open_count;
+}
+
+
+static uint32_t block_first_time(ts_store_t const * p_store, uint16_t block)
+{
+    if (block < p_store->block_count)
+    {
+        return p_store->p_index[block].time;
+    }
+    return buffer_get(p_store, p_store->open_buf)[BLOCK_SLOTS];
+}
+
+
+/**@brief Function for finding the block of a sequence number, by binary search.
+ *
+ * @return The last block whose first record is not newer than @p seq.
+ */
+static uint16_t block_find_seq(ts_store_t const * p_store, uint32_t seq)
+{
+    uint16_t lo = 0;
+    uint16_t hi = blocks_total(p_store);
+
+    while (hi - lo > 1)
+    {
+        uint16_t mid = (lo + hi) / 2;
+
+        if (block_first_seq(p_store, mid) <= seq)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+
+static ret_code_t block_view_open(ts_store_t * p_store, uint16_t block, block_view_t * p_view)
+{
+    ret_code_t         err_code;
+    fds_flash_record_t flash_record;
+
+    p_view->opened = false;
+
+    if (block == p_store->block_count)
+    {
+        p_view->p_block = buffer_get(p_store, p_store->open_buf);
+        return NRF_SUCCESS;
+    }
+
+    ts_store_block_t const * p_entry = &p_store->p_index[block];
+
+    if (p_store->write_pending && (p_entry->record_id == p_store->pending_id))
+    {
+        // Not in flash yet.
+        p_view->p_block = buffer_get(p_store, p_store->open_buf ^ 1);
+        return NRF_SUCCESS;
+    }
+
+    err_code = fds_descriptor_from_rec_id(&p_view->desc, p_entry->record_id);
+    VERIFY_SUCCESS(err_code);
+
+    err_code = fds_record_open(&p_view->desc, &flash_record);
+    VERIFY_SUCCESS(err_code);
+
+    p_view->p_block = (uint32_t const *)flash_record.p_data;
+    p_view->opened  = true;
+    return NRF_SUCCESS;
+}
+
+
+static void block_view_close(block_view_t * p_view)
+{
+    if (p_view->opened)
+    {
+        (void)fds_record_close(&p_view->desc);
+    }
+}
+
+
+static ret_code_t block_delete_oldest(ts_store_t * p_store)
+{
+    ret_code_t        err_code;
+    fds_record_desc_t desc;
+
+    err_code = fds_descriptor_from_rec_id(&desc, p_store->p_index[0].record_id);
+    VERIFY_SUCCESS(err_code);
+
+    err_code = fds_record_delete(&desc);
+    VERIFY_SUCCESS(err_code);
+
+    p_store->block_count--;
+    memmove(&p_store->p_index[0],
+            &p_store->p_index[1],
+            p_store->block_count * sizeof(ts_store_block_t));
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for queuing the block being filled for writing. */
+static ret_code_t block_flush(ts_store_t * p_store)
+{
+    ret_code_t         err_code;
+    fds_record_desc_t  desc;
+    uint32_t         * p_block = buffer_get(p_store, p_store->open_buf);
+
+    if (p_store->open_count == 0)
+    {
+        return NRF_SUCCESS;
+    }
+    if (p_store->write_pending)
+    {
+        return NRF_ERROR_BUSY;
+    }
+    if (p_store->block_count == p_store->max_blocks)
+    {
+        err_code = block_delete_oldest(p_store);
+        VERIFY_SUCCESS(err_code);
+    }
+
+    fds_record_chunk_t const chunk =
+    {
+        .p_data       = p_block,
+        .length_words = BLOCK_SLOTS + p_store->open_count * slot_words(p_store),
+    };
+    fds_record_t const record =
+    {
+        .file_id         = p_store->file_id,
+        .key             = p_store->record_key,
+        .data.p_chunks   = &chunk,
+        .data.num_chunks = 1,
+    };
+
+    err_code = fds_record_write(&desc, &record);
+    VERIFY_SUCCESS(err_code);
+
+    p_store->p_index[p_store->block_count].seq       = p_block[BLOCK_SEQ];
+    p_store->p_index[p_store->block_count].time      = p_block[BLOCK_SLOTS];
+    p_store->p_index[p_store->block_count].record_id = desc.record_id;
+    p_store->block_count++;
+
+    p_store->pending_id    = desc.record_id;
+    p_store->write_pending = true;
+    p_store->open_buf     ^= 1;
+    p_store->open_count    = 0;
+    return NRF_SUCCESS;
+}
+
+
+static void fds_evt_handler(fds_evt_t const * const p_evt)
+{
+    if (p_evt->id != FDS_EVT_WRITE)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < m_store_count; i++)
+    {
+        ts_store_t * p_store = m_stores[i];
+
+        if (!p_store->write_pending
+            || (p_evt->write.file_id != p_store->file_id)
+            || (p_evt->write.record_id != p_store->pending_id))
+        {
+            continue;
+        }
+
+        ts_store_evt_t evt =
+        {
+            .evt_type = TS_STORE_EVT_BLOCK_STORED,
+            .seq      = buffer_get(p_store, p_store->open_buf ^ 1)[BLOCK_SEQ],
+            .result   = p_evt->result,
+        };
+
+        p_store->write_pending = false;
+
+        if (p_evt->result != FDS_SUCCESS)
+        {
+            evt.evt_type = TS_STORE_EVT_WRITE_FAILED;
+            if ((p_store->block_count > 0)
+                && (p_store->p_index[p_store->block_count - 1].record_id == p_evt->write.record_id))
+            {
+                p_store->block_count--;
+            }
+        }
+
+        if (p_store->evt_handler != NULL)
+        {
+            p_store->evt_handler(&evt);
+        }
+
+        // The block being filled may have become full while this one was written.
+        if (p_store->open_count == p_store->block_records)
+        {
+            (void)block_flush(p_store);
+        }
+        return;
+    }
+}
+
+
+/**@brief Function for adding a block found in flash to the index, in sequence order. */
+static ret_code_t index_insert(ts_store_t * p_store, ts_store_block_t const * p_entry)
+{
+    uint16_t pos = p_store->block_count;
+
+    if (p_store->block_count == p_store->max_blocks)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    // The blocks are usually found in the order they were written.
+    while ((pos > 0) && (p_store->p_index[pos - 1].seq > p_entry->seq))
+    {
+        p_store->p_index[pos] = p_store->p_index[pos - 1];
+        pos--;
+    }
+    p_store->p_index[pos] = *p_entry;
+    p_store->block_count++;
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ts_store_init(ts_store_t * p_store)
+{
+    ret_code_t         err_code;
+    fds_find_token_t   token = {0};
+    fds_record_desc_t  desc;
+    fds_flash_record_t flash_record;
+    bool               registered = false;
+
+    VERIFY_PARAM_NOT_NULL(p_store);
+
+    for (uint32_t i = 0; i < m_store_count; i++)
+    {
+        registered |= (m_stores[i] == p_store);
+    }
+    if (!registered)
+    {
+        if (m_store_count == TS_STORE_CONFIG_STORE_COUNT)
+        {
+            return NRF_ERROR_NO_MEM;
+        }
+        if (m_store_count == 0)
+        {
+            err_code = fds_register(fds_evt_handler);
+            VERIFY_SUCCESS(err_code);
+        }
+        m_stores[m_store_count++] = p_store;
+    }
+
+    p_store->block_count   = 0;
+    p_store->open_count    = 0;
+    p_store->next_seq      = 0;
+    p_store->open_buf      = 0;
+    p_store->write_pending = false;
+
+    while (fds_record_find(p_store->file_id, p_store->record_key, &desc, &token) == FDS_SUCCESS)
+    {
+        ts_store_block_t entry;
+        uint32_t         count;
+        uint32_t         length_words;
+
+        err_code = fds_record_open(&desc, &flash_record);
+        VERIFY_SUCCESS(err_code);
+
+        uint32_t const * p_block = (uint32_t const *)flash_record.p_data;
+
+        count        = p_block[BLOCK_COUNT];
+        length_words = flash_record.p_header->tl.length_words;
+        entry.seq       = p_block[BLOCK_SEQ];
+        entry.time      = p_block[BLOCK_SLOTS];
+        entry.record_id = desc.record_id;
+
+        (void)fds_record_close(&desc);
+
+        if ((count == 0) || (count > p_store->block_records)
+            || (length_words != BLOCK_SLOTS + count * slot_words(p_store)))
+        {
+            return NRF_ERROR_INVALID_DATA;
+        }
+
+        err_code = index_insert(p_store, &entry);
+        VERIFY_SUCCESS(err_code);
+
+        p_store->next_seq = MAX(p_store->next_seq, entry.seq + count);
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ts_store_append(ts_store_t * p_store, uint32_t time, void const * p_data, uint32_t * p_seq)
+{
+    ret_code_t err_code;
+
+    if (p_store->open_count == p_store->block_records)
+    {
+        err_code = block_flush(p_store);
+        VERIFY_SUCCESS(err_code);
+    }
+
+    uint32_t * p_block = buffer_get(p_store, p_store->open_buf);
+    uint32_t * p_slot  = &p_block[BLOCK_SLOTS + p_store->open_count * slot_words(p_store)];
+
+    if (p_store->open_count == 0)
+    {
+        p_block[BLOCK_SEQ] = p_store->next_seq;
+    }
+    p_slot[0] = time;
+    memcpy(&p_slot[1], p_data, p_store->record_size);
+
+    p_block[BLOCK_COUNT] = ++p_store->open_count;
+
+    if (p_seq != NULL)
+    {
+        *p_seq = p_store->next_seq;
+    }
+    p_store->next_seq++;
+
+    if (p_store->open_count == p_store->block_records)
+    {
+        // Retried on the next append, or when the previous block has been written.
+        (void)block_flush(p_store);
+    }
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ts_store_flush(ts_store_t * p_store)
+{
+    return block_flush(p_store);
+}
+
+
+uint32_t ts_store_first_seq(ts_store_t const * p_store)
+{
+    return (blocks_total(p_store) == 0) ? p_store->next_seq : block_first_seq(p_store, 0);
+}
+
+
+uint32_t ts_store_next_seq(ts_store_t const * p_store)
+{
+    return p_store->next_seq;
+}
+
+
+uint32_t ts_store_count(ts_store_t const * p_store)
+{
+    return p_store->next_seq - ts_store_first_seq(p_store);
+}
+
+
+ret_code_t ts_store_seq_find_time(ts_store_t * p_store, uint32_t time, uint32_t * p_seq)
+{
+    ret_code_t   err_code;
+    block_view_t view;
+    uint16_t     total = blocks_total(p_store);
+    uint16_t     lo    = 0;
+    uint16_t     hi    = total;
+
+    // First block that starts after the time.
+    while (lo < hi)
+    {
+        uint16_t mid = (lo + hi) / 2;
+
+        if (block_first_time(p_store, mid) > time)
+        {
+            hi = mid;
+        }
+        else
+        {
+            lo = mid + 1;
+        }
+    }
+
+    if (lo > 0)
+    {
+        // The record can be in the previous block.
+        err_code = block_view_open(p_store, lo - 1, &view);
+        VERIFY_SUCCESS(err_code);
+
+        for (uint32_t i = 0; i < view.p_block[BLOCK_COUNT]; i++)
+        {
+            if (view.p_block[BLOCK_SLOTS + i * slot_words(p_store)] >= time)
+            {
+                *p_seq = view.p_block[BLOCK_SEQ] + i;
+                block_view_close(&view);
+                return NRF_SUCCESS;
+            }
+        }
+        block_view_close(&view);
+    }
+
+    if (lo == total)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    *p_seq = block_first_seq(p_store, lo);
+    return NRF_SUCCESS;
+}
+
+
+void ts_store_cursor_init(ts_store_t const  * p_store,
+                          ts_store_cursor_t * p_cursor,
+                          uint32_t            first_seq,
+                          uint32_t            last_seq)
+{
+    p_cursor->next_seq = MAX(first_seq, ts_store_first_seq(p_store));
+    p_cursor->end_seq  = (last_seq < p_store->next_seq) ? (last_seq + 1) : p_store->next_seq;
+}
+
+
+uint32_t ts_store_cursor_remaining(ts_store_cursor_t const * p_cursor)
+{
+    return (p_cursor->end_seq > p_cursor->next_seq) ? (p_cursor->end_seq - p_cursor->next_seq) : 0;
+}
+
+
+ret_code_t ts_store_cursor_read(ts_store_t        * p_store,
+                                ts_store_cursor_t * p_cursor,
+                                uint32_t          * p_times,
+                                void              * p_data,
+                                uint16_t            max_count,
+                                uint16_t          * p_count)
+{
+    ret_code_t   err_code;
+    block_view_t view;
+    uint8_t    * p_out = (uint8_t *)p_data;
+    uint16_t     count = 0;
+
+    *p_count = 0;
+    p_cursor->next_seq = MAX(p_cursor->next_seq, ts_store_first_seq(p_store));
+
+    while ((count < max_count) && (p_cursor->next_seq < p_cursor->end_seq))
+    {
+        uint16_t block = block_find_seq(p_store, p_cursor->next_seq);
+
+        err_code = block_view_open(p_store, block, &view);
+        VERIFY_SUCCESS(err_code);
+
+        uint32_t first = view.p_block[BLOCK_SEQ];
+        uint32_t last  = first + view.p_block[BLOCK_COUNT];
+
+        if (p_cursor->next_seq >= last)
+        {
+            // Records lost by a failed write: continue with the next block.
+            block_view_close(&view);
+            p_cursor->next_seq = (block + 1 < blocks_total(p_store)) ? block_first_seq(p_store, block + 1)
+                                                                      : p_cursor->end_seq;
+            continue;
+        }
+
+        while ((count < max_count) && (p_cursor->next_seq < MIN(last, p_cursor->end_seq)))
+        {
+            uint32_t const * p_slot = &view.p_block[BLOCK_SLOTS + (p_cursor->next_seq - first) * slot_words(p_store)];
+
+            if (p_times != NULL)
+            {
+                p_times[count] = p_slot[0];
+            }
+            memcpy(p_out, &p_slot[1], p_store->record_size);
+            p_out += p_store->record_size;
+            count++;
+            p_cursor->next_seq++;
+        }
+        block_view_close(&view);
+    }
+
+    *p_count = count;
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ts_store_read(ts_store_t * p_store, uint32_t seq, uint32_t * p_time, void * p_data)
+{
+    ret_code_t        err_code;
+    ts_store_cursor_t cursor;
+    uint16_t          count;
+
+    if ((seq < ts_store_first_seq(p_store)) || (seq >= p_store->next_seq))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    ts_store_cursor_init(p_store, &cursor, seq, seq);
+    err_code = ts_store_cursor_read(p_store, &cursor, p_time, p_data, 1, &count);
+    VERIFY_SUCCESS(err_code);
+
+    return (count == 1) ? NRF_SUCCESS : NRF_ERROR_NOT_FOUND;
+}
+
+
+ret_code_t ts_store_delete_before(ts_store_t * p_store, uint32_t seq)
+{
+    ret_code_t err_code;
+
+    // A block can be deleted if the next one starts at or before the sequence number.
+    while ((p_store->block_count > 0)
+           && (((blocks_total(p_store) > 1) ? block_first_seq(p_store, 1) : p_store->next_seq) <= seq))
+    {
+        err_code = block_delete_oldest(p_store);
+        VERIFY_SUCCESS(err_code);
+    }
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ts_store_clear(ts_store_t * p_store)
+{
+    ret_code_t err_code = fds_file_delete(p_store->file_id);
+    VERIFY_SUCCESS(err_code);
+
+    p_store->block_count = 0;
+    p_store->open_count  = 0;
+    return NRF_SUCCESS;
+}
+
+#endif // NRF_MODULE_ENABLED(TS_STORE)
@@ -0,0 +1,293 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ts_store Time-series record store
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for storing numbered, time-stamped records in flash, for example the
+ *        measurements of the Glucose and CGM services.
+ *
+ * @details Records are appended to a log in an FDS file. Each record gets the next sequence
+ *          number, so the numbers of the stored records are always consecutive. Records are
+ *          collected in blocks of up to @p block_records records in RAM, and each full block is
+ *          written as one FDS record. The flash overhead is then one FDS header per block.
+ *
+ *          A sparse index with the first sequence number and time of each block is kept in RAM
+ *          and rebuilt from flash by @ref ts_store_init. The Record Access Control Point
+ *          operations map to it as follows:
+ *          - number of records, first and last record: constant time,
+ *          - greater or equal to, within range of a sequence number or a time: binary search
+ *            over the blocks, then search within one block,
+ *          - report: a cursor that reads consecutive records, opening each block once, so that
+ *            the records can be passed to the notifications in batches.
+ *
+ *          Only the oldest blocks can be deleted. When the index is full, the oldest block is
+ *          deleted to make room. The time search expects a time that does not decrease from one
+ *          record to the next.
+ *
+ * @note Records still in RAM are lost on reset. @ref ts_store_flush writes them.
+ * @note FDS must be initialized before @ref ts_store_init, and garbage collection must be run
+ *       by the application as usual.
+ * @note The functions of a store must be called in the context of the FDS events, for example
+ *       from the main loop with the SoftDevice events passed through the scheduler.
+ */
+
+#ifndef TS_STORE_H__
+#define TS_STORE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Maximum number of stores.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef TS_STORE_CONFIG_STORE_COUNT
+#define TS_STORE_CONFIG_STORE_COUNT 2
+#endif
+
+/**@brief Macro for computing the size of a record in a block, in words. */
+#define TS_STORE_SLOT_WORDS(RECORD_SIZE)                    (1 + (((RECORD_SIZE) + 3) / 4))
+
+/**@brief Macro for computing the size of a block, in words. */
+#define TS_STORE_BLOCK_WORDS(RECORD_SIZE, BLOCK_RECORDS)    (2 + ((BLOCK_RECORDS) * TS_STORE_SLOT_WORDS(RECORD_SIZE)))
+
+/**@brief Index entry of a block. */
+typedef struct
+{
+    uint32_t seq;       //!< Sequence number of the first record.
+    uint32_t time;      //!< Time of the first record.
+    uint32_t record_id; //!< FDS record ID of the block.
+} ts_store_block_t;
+
+/**@brief Event types. */
+typedef enum
+{
+    TS_STORE_EVT_BLOCK_STORED, //!< A block was written to flash.
+    TS_STORE_EVT_WRITE_FAILED, //!< A block could not be written to flash. Its records are lost.
+} ts_store_evt_type_t;
+
+/**@brief Event. */
+typedef struct
+{
+    ts_store_evt_type_t evt_type; //!< Event type.
+    uint32_t            seq;      //!< Sequence number of the first record of the block.
+    ret_code_t          result;   //!< Result of the FDS operation.
+} ts_store_evt_t;
+
+/**@brief Event handler. Called from the FDS event handler. */
+typedef void (* ts_store_evt_handler_t)(ts_store_evt_t const * p_evt);
+
+/**@brief Store. Use @ref TS_STORE_DEF to define it. */
+typedef struct
+{
+    uint16_t               file_id;       //!< FDS file of the store.
+    uint16_t               record_key;    //!< FDS record key of the blocks.
+    uint16_t               record_size;   //!< Size of a record, in bytes.
+    uint16_t               block_records; //!< Number of records in a block.
+    uint16_t               max_blocks;    //!< Number of blocks in the index.
+    ts_store_block_t     * p_index;       //!< Index of @p max_blocks entries.
+    uint32_t             * p_buffers;     //!< Two block buffers, for the block being filled and the one being written.
+    ts_store_evt_handler_t evt_handler;   //!< Event handler, or NULL.
+    uint16_t               block_count;   //!< Private: blocks in the index.
+    uint16_t               open_count;    //!< Private: records in the block being filled.
+    uint32_t               next_seq;      //!< Private: sequence number of the next record.
+    uint32_t               pending_id;    //!< Private: FDS record ID of the block being written.
+    uint8_t                open_buf;      //!< Private: buffer of the block being filled.
+    bool                   write_pending; //!< Private: a block is being written.
+} ts_store_t;
+
+/**@brief Cursor for reading consecutive records. */
+typedef struct
+{
+    uint32_t next_seq; //!< Sequence number of the next record to read.
+    uint32_t end_seq;  //!< Sequence number after the last record to read.
+} ts_store_cursor_t;
+
+/**@brief Macro for defining a store.
+ *
+ * @param[in] NAME          Name of the store.
+ * @param[in] FILE_ID       FDS file of the store. It must not be used for other records.
+ * @param[in] RECORD_KEY    FDS record key of the blocks.
+ * @param[in] RECORD_SIZE   Size of a record, in bytes.
+ * @param[in] BLOCK_RECORDS Number of records in a block.
+ * @param[in] MAX_BLOCKS    Number of blocks in the index. The store holds up to
+ *                          MAX_BLOCKS * BLOCK_RECORDS records.
+ * @param[in] EVT_HANDLER   Event handler, or NULL.
+ */
+#define TS_STORE_DEF(NAME, FILE_ID, RECORD_KEY, RECORD_SIZE, BLOCK_RECORDS, MAX_BLOCKS, EVT_HANDLER)  \
+    static ts_store_block_t NAME##_index[MAX_BLOCKS];                                               \
+    static uint32_t         NAME##_buffers[2 * TS_STORE_BLOCK_WORDS(RECORD_SIZE, BLOCK_RECORDS)];   \
+    static ts_store_t       NAME =                                                                  \
+    {                                                                                               \
+        .file_id       = (FILE_ID),                                                                 \
+        .record_key    = (RECORD_KEY),                                                              \
+        .record_size   = (RECORD_SIZE),                                                             \
+        .block_records = (BLOCK_RECORDS),                                                           \
+        .max_blocks    = (MAX_BLOCKS),                                                              \
+        .p_index       = NAME##_index,                                                              \
+        .p_buffers     = NAME##_buffers,                                                            \
+        .evt_handler   = (EVT_HANDLER),                                                             \
+    }
+
+
+/**@brief Function for initializing a store and rebuilding its index from flash.
+ *
+ * @param[in,out] p_store Store.
+ *
+ * @retval NRF_SUCCESS             If the store was initialized.
+ * @retval NRF_ERROR_NO_MEM        If the index is too small for the blocks in flash, or too many
+ *                                 stores were initialized.
+ * @retval NRF_ERROR_INVALID_DATA  If a block in flash does not match the record size.
+ * @return Other errors from FDS.
+ */
+ret_code_t ts_store_init(ts_store_t * p_store);
+
+
+/**@brief Function for appending a record.
+ *
+ * @param[in,out] p_store Store.
+ * @param[in]     time    Time of the record, in any unit.
+ * @param[in]     p_data  Record of @p record_size bytes.
+ * @param[out]    p_seq   Sequence number of the record. Can be NULL.
+ *
+ * @retval NRF_SUCCESS      If the record was added.
+ * @retval NRF_ERROR_BUSY   If the block is full and the previous block is still being written.
+ * @return Other errors from FDS, if the block could not be queued for writing.
+ */
+ret_code_t ts_store_append(ts_store_t * p_store, uint32_t time, void const * p_data, uint32_t * p_seq);
+
+
+/**@brief Function for writing the records in RAM to flash, as a partial block.
+ *
+ * @retval NRF_SUCCESS      If the block was queued for writing, or there was no record in RAM.
+ * @retval NRF_ERROR_BUSY   If the previous block is still being written.
+ * @return Other errors from FDS.
+ */
+ret_code_t ts_store_flush(ts_store_t * p_store);
+
+
+/**@brief Function for getting the number of records. */
+uint32_t ts_store_count(ts_store_t const * p_store);
+
+
+/**@brief Function for getting the sequence number of the oldest record.
+ *
+ * If the store is empty, it is the sequence number of the next record.
+ */
+uint32_t ts_store_first_seq(ts_store_t const * p_store);
+
+
+/**@brief Function for getting the sequence number of the next record. */
+uint32_t ts_store_next_seq(ts_store_t const * p_store);
+
+
+/**@brief Function for finding the first record at or after a time.
+ *
+ * @param[in]  p_store Store.
+ * @param[in]  time    Time.
+ * @param[out] p_seq   Sequence number of the record.
+ *
+ * @retval NRF_SUCCESS         If the record was found.
+ * @retval NRF_ERROR_NOT_FOUND If all records are older.
+ * @return Other errors from FDS.
+ */
+ret_code_t ts_store_seq_find_time(ts_store_t * p_store, uint32_t time, uint32_t * p_seq);
+
+
+/**@brief Function for reading one record.
+ *
+ * @param[in]  p_store Store.
+ * @param[in]  seq     Sequence number.
+ * @param[out] p_time  Time of the record. Can be NULL.
+ * @param[out] p_data  Buffer of @p record_size bytes.
+ *
+ * @retval NRF_SUCCESS         If the record was read.
+ * @retval NRF_ERROR_NOT_FOUND If the record is not in the store.
+ * @return Other errors from FDS.
+ */
+ret_code_t ts_store_read(ts_store_t * p_store, uint32_t seq, uint32_t * p_time, void * p_data);
+
+
+/**@brief Function for initializing a cursor over a range of records.
+ *
+ * The range is limited to the stored records.
+ *
+ * @param[in]  p_store   Store.
+ * @param[out] p_cursor  Cursor.
+ * @param[in]  first_seq First sequence number.
+ * @param[in]  last_seq  Last sequence number, included. UINT32_MAX for the last record.
+ */
+void ts_store_cursor_init(ts_store_t const  * p_store,
+                          ts_store_cursor_t * p_cursor,
+                          uint32_t            first_seq,
+                          uint32_t            last_seq);
+
+
+/**@brief Function for getting the number of records left in the range of a cursor. */
+uint32_t ts_store_cursor_remaining(ts_store_cursor_t const * p_cursor);
+
+
+/**@brief Function for reading the next records of a cursor.
+ *
+ * @param[in]     p_store  Store.
+ * @param[in,out] p_cursor Cursor.
+ * @param[out]    p_times  Times of the records. Can be NULL.
+ * @param[out]    p_data   Buffer for @p max_count records of @p record_size bytes, one after the other.
+ * @param[in]     max_count Largest number of records to read.
+ * @param[out]    p_count  Number of records read. 0 at the end of the range.
+ *
+ * @retval NRF_SUCCESS If the records were read. Records deleted since the cursor was initialized
+ *                     are skipped.
+ * @return Other errors from FDS.
+ */
+ret_code_t ts_store_cursor_read(ts_store_t        * p_store,
+                                ts_store_cursor_t * p_cursor,
+                                uint32_t          * p_times,
+                                void              * p_data,
+                                uint16_t            max_count,
+                                uint16_t          * p_count);
+
+
+/**@brief Function for deleting the blocks whose records are all older than a sequence number.
+ *
+ * @param[in,out] p_store Store.
+ * @param[in]     seq     Sequence number. Records older than it can be kept if they share a block
+ *                        with newer ones.
+ *
+ * @return Errors from FDS.
+ */
+ret_code_t ts_store_delete_before(ts_store_t * p_store, uint32_t seq);
+
+
+/**@brief Function for deleting all records. The sequence numbers are not reused.
+ *
+ * @return Errors from FDS.
+ */
+ret_code_t ts_store_clear(ts_store_t * p_store);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TS_STORE_H__
+
+/** @} */
@@ -0,0 +1,23 @@
+/**
+ *
+ * @defgroup ts_store_config Time-series record store configuration
+ * @{
+ * @ingroup ts_store
+ */
+/** @brief Enable the time-series record store.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define TS_STORE_ENABLED
+
+/** @brief Maximum number of stores.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define TS_STORE_CONFIG_STORE_COUNT
+
+
+
+/** @} */
@@ -124,17 +124,14 @@ static ret_code_t start_transfer(app_twi_t * p_app_twi)
 }
 
 
-static void signal_end_of_transaction(app_twi_t const * p_app_twi,
-                                      ret_code_t        result)
+static void signal_end_of_transaction(app_twi_transaction_t const * p_transaction,
+                                      ret_code_t                    result)
 {
-    ASSERT(p_app_twi != NULL);
+    ASSERT(p_transaction != NULL);
 
-    if (p_app_twi->p_current_transaction->callback)
+    if (p_transaction->callback)
     {
-        // [use a local variable to avoid using two volatile variables in one
-        //  expression]
-        void * p_user_data = p_app_twi->p_current_transaction->p_user_data;
-        p_app_twi->p_current_transaction->callback(result, p_user_data);
+        p_transaction->callback(result, p_transaction->p_user_data);
     }
 }
 
@@ -185,7 +182,7 @@ static void start_pending_transaction(app_twi_t * p_app_twi,
             // Transfer failed to start - notify user that this transaction
             // cannot be started and try with next one (in next iteration of
             // the loop).
-            signal_end_of_transaction(p_app_twi, result);
+            signal_end_of_transaction(p_app_twi->p_current_transaction, result);
 
             switch_transaction = true;
         }
@@ -238,12 +235,15 @@ static void twi_event_handler(nrf_drv_twi_evt_t const * p_event,
     }
 
     // The current transaction has been completed or interrupted by some error.
-    // Notify the user and start next one (if there is any).
-    signal_end_of_transaction(p_app_twi, result);
+    // Start next one (if there is any) and notify the user. The next
+    // transaction is started first, so that the bus is not idle while the
+    // callback is executed.
     // [we switch transactions here ('p_app_twi->p_current_transaction' is set
     //  to NULL only if there is nothing more to do) in order to not generate
     //  spurious idle status (even for a moment)]
+    app_twi_transaction_t const * p_finished_transaction = p_app_twi->p_current_transaction;
     start_pending_transaction(p_app_twi, true);
+    signal_end_of_transaction(p_finished_transaction, result);
 }
 
 
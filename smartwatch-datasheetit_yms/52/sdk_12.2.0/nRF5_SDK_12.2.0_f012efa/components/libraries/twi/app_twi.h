@@ -64,6 +64,38 @@ extern "C" {
 #define APP_TWI_READ(address, p_data, length, flags) \
     APP_TWI_TRANSFER(APP_TWI_READ_OP(address), p_data, length, flags)
 
+/**
+ * @brief Macro for creating the transfers that read a burst of registers.
+ *
+ * The macro expands to two transfers: a write of the register address without
+ * a stop condition, and a read. The transaction manager performs them as one
+ * TX-RX transfer with a repeated start, so the burst costs one interrupt.
+ *
+ * @param     address    Slave address.
+ * @param[in] p_reg_addr Pointer to the address of the first register.
+ * @param[in] p_data     Pointer to the buffer where received data should be placed.
+ * @param     length     Number of bytes to read.
+ */
+#define APP_TWI_REG_READ(address, p_reg_addr, p_data, length)     \
+    APP_TWI_WRITE(address, p_reg_addr, 1, APP_TWI_NO_STOP),       \
+    APP_TWI_READ(address, p_data, length, 0)
+
+/**
+ * @brief Macro for creating the transfers that write a burst of registers.
+ *
+ * The macro expands to two transfers: a write of the register address without
+ * a stop condition, and a write of the data. The transaction manager performs
+ * them as one TX-TX transfer.
+ *
+ * @param     address    Slave address.
+ * @param[in] p_reg_addr Pointer to the address of the first register.
+ * @param[in] p_data     Pointer to the data to be written.
+ * @param     length     Number of bytes to write.
+ */
+#define APP_TWI_REG_WRITE(address, p_reg_addr, p_data, length)    \
+    APP_TWI_WRITE(address, p_reg_addr, 1, APP_TWI_NO_STOP),       \
+    APP_TWI_WRITE(address, p_data, length, 0)
+
 /**
  * @brief Helper macro, should not be used directly.
  */
@@ -238,6 +270,14 @@ void       app_twi_uninit(app_twi_t * p_app_twi);
  * available, thus when all previously scheduled transactions have been
  * finished (possibly immediately).
  *
+ * When a transaction finishes, the next scheduled transaction is started
+ * before the callback of the finished one is called, so the bus is kept busy
+ * while the callback runs.
+ *
+ * @note To poll several devices with one callback, put the transfers for all of
+ *       them in one transaction, for example with @ref APP_TWI_REG_READ. Each
+ *       device then costs one interrupt.
+ *
  * @param[in] p_app_twi     Pointer to the TWI transaction manager instance.
  * @param[in] p_transaction Pointer to the descriptor of the transaction to be
  *                          scheduled.
@@ -22,5 +22,29 @@
 #define APP_UART_DRIVER_INSTANCE
 
 
+/** @brief Transfer FIFO data in chunks instead of byte by byte
+ *
+ * Used by the FIFO version of the module. TX sends the largest contiguous part of
+ * the TX FIFO in one transfer. In Easy DMA mode RX uses two buffers of
+ * @ref APP_UART_FIFO_RX_CHUNK_SIZE bytes. A buffer that is not full is passed to
+ * the RX FIFO when @ref app_uart_get finds the FIFO empty.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define APP_UART_FIFO_CHUNKED_ENABLED
+
+
+/** @brief Size of an RX chunk
+ *
+ * Must be between 1 and 255. The RX FIFO must be at least this size.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define APP_UART_FIFO_RX_CHUNK_SIZE
+
+
 
 /** @} */
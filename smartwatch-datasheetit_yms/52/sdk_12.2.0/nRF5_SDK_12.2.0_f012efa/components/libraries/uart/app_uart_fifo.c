@@ -26,15 +26,121 @@ static __INLINE uint32_t fifo_length(app_fifo_t * const fifo)
 
 #define FIFO_LENGTH(F) fifo_length(&F)              /**< Macro to calculate length of a FIFO. */
 
+#if NRF_MODULE_ENABLED(APP_UART_FIFO_CHUNKED)
+#ifndef APP_UART_FIFO_RX_CHUNK_SIZE
+#define APP_UART_FIFO_RX_CHUNK_SIZE 32
+#endif
+
+STATIC_ASSERT((APP_UART_FIFO_RX_CHUNK_SIZE > 0) && (APP_UART_FIFO_RX_CHUNK_SIZE <= UINT8_MAX));
+
+#define FIFO_FREE(F)   ((F).buf_size_mask + 1 - FIFO_LENGTH(F)) /**< Macro to calculate free space of a FIFO. */
+#define RX_CHUNK_CNT   2                            /**< Number of RX buffers given to the driver. */
+#endif
+
 
 static app_uart_event_handler_t   m_event_handler;            /**< Event handler function. */
 static uint8_t tx_buffer[1];
 static uint8_t rx_buffer[1];
 static bool m_rx_ovf;
 
+#if NRF_MODULE_ENABLED(APP_UART_FIFO_CHUNKED)
+static uint8_t       m_rx_chunks[RX_CHUNK_CNT][APP_UART_FIFO_RX_CHUNK_SIZE]; /**< RX buffers filled by EasyDMA. */
+static uint8_t       m_rx_next;                     /**< Index of the next RX buffer to give to the driver. */
+static uint8_t       m_rx_pending;                  /**< Number of RX buffers given to the driver. */
+static bool          m_rx_chunked;                  /**< True if RX uses chunks, false if RX is done byte by byte. */
+static volatile bool m_rx_flush;                    /**< RX was aborted to flush a partial chunk. */
+#endif
+
 static app_fifo_t                  m_rx_fifo;                               /**< RX FIFO buffer for storing data received on the UART until the application fetches them using app_uart_get(). */
 static app_fifo_t                  m_tx_fifo;                               /**< TX FIFO buffer for storing data to be transmitted on the UART when TXD is ready. Data is put to the buffer on using app_uart_put(). */
 
+#if NRF_MODULE_ENABLED(APP_UART_FIFO_CHUNKED)
+/**@brief Function for starting the transfer of the largest contiguous part of the TX FIFO.
+ *
+ * @details The data are sent straight from the FIFO memory. The read position is advanced when
+ *          the transfer is done.
+ */
+static void tx_chunk_start(void)
+{
+    uint8_t * p_data;
+    uint32_t  len;
+
+    if (app_fifo_read_span(&m_tx_fifo, &p_data, &len) == NRF_SUCCESS)
+    {
+        (void)nrf_drv_uart_tx(&app_uart_inst, p_data, (uint8_t)MIN(len, UINT8_MAX));
+    }
+}
+
+
+/**@brief Function for giving RX buffers to the driver.
+ *
+ * @details A buffer is given only if the RX FIFO can take its content in addition to the buffers
+ *          that are already pending. If no buffer is pending when the function returns,
+ *          reception is resumed by @ref app_uart_get.
+ */
+static void rx_chunks_refill(void)
+{
+    while ((m_rx_pending < RX_CHUNK_CNT) &&
+           (FIFO_FREE(m_rx_fifo) >= ((m_rx_pending + 1) * APP_UART_FIFO_RX_CHUNK_SIZE)))
+    {
+        if (nrf_drv_uart_rx(&app_uart_inst,
+                            m_rx_chunks[m_rx_next],
+                            APP_UART_FIFO_RX_CHUNK_SIZE) != NRF_SUCCESS)
+        {
+            break;
+        }
+        m_rx_next = (m_rx_next + 1) % RX_CHUNK_CNT;
+        m_rx_pending++;
+    }
+    m_rx_ovf = (m_rx_pending == 0);
+}
+
+
+/**@brief Function for handling a completed RX buffer.
+ *
+ * @details A full buffer is completed by the ENDRX event. A buffer with less data is completed by
+ *          the RXTO event after @ref nrf_drv_uart_rx_abort, which stops all pending buffers.
+ */
+static void rx_chunk_done(uint8_t const * p_data, uint32_t bytes)
+{
+    app_uart_evt_t app_uart_event;
+    uint32_t       len = bytes;
+
+    if (bytes == APP_UART_FIFO_RX_CHUNK_SIZE)
+    {
+        m_rx_pending--;
+    }
+    else
+    {
+        m_rx_pending = 0;
+        m_rx_flush   = false;
+    }
+
+    if (len != 0)
+    {
+        (void)app_fifo_write(&m_rx_fifo, p_data, &len);
+        if (len != bytes)
+        {
+            app_uart_event.evt_type        = APP_UART_FIFO_ERROR;
+            app_uart_event.data.error_code = NRF_ERROR_NO_MEM;
+            m_event_handler(&app_uart_event);
+        }
+        else
+        {
+            app_uart_event.evt_type = APP_UART_DATA_READY;
+            m_event_handler(&app_uart_event);
+        }
+    }
+
+    // Buffers are given again when the flush is completed.
+    if (!m_rx_flush)
+    {
+        rx_chunks_refill();
+    }
+}
+#endif // NRF_MODULE_ENABLED(APP_UART_FIFO_CHUNKED)
+
+
 static void uart_event_handler(nrf_drv_uart_event_t * p_event, void* p_context)
 {
     app_uart_evt_t app_uart_event;
@@ -43,6 +149,13 @@ static void uart_event_handler(nrf_drv_uart_event_t * p_event, void* p_context)
     switch (p_event->type)
     {
         case NRF_DRV_UART_EVT_RX_DONE:
+#if NRF_MODULE_ENABLED(APP_UART_FIFO_CHUNKED)
+            if (m_rx_chunked)
+            {
+                rx_chunk_done(p_event->data.rxtx.p_data, p_event->data.rxtx.bytes);
+                break;
+            }
+#endif
             // Write received byte to FIFO.
             err_code = app_fifo_put(&m_rx_fifo, p_event->data.rxtx.p_data[0]);
             if (err_code != NRF_SUCCESS)
@@ -74,16 +187,36 @@ static void uart_event_handler(nrf_drv_uart_event_t * p_event, void* p_context)
         case NRF_DRV_UART_EVT_ERROR:
             app_uart_event.evt_type                 = APP_UART_COMMUNICATION_ERROR;
             app_uart_event.data.error_communication = p_event->data.error.error_mask;
+#if NRF_MODULE_ENABLED(APP_UART_FIFO_CHUNKED)
+            if (m_rx_chunked)
+            {
+                // The driver has dropped all pending buffers.
+                m_rx_pending = 0;
+                rx_chunks_refill();
+                m_event_handler(&app_uart_event);
+                break;
+            }
+#endif
             (void)nrf_drv_uart_rx(&app_uart_inst, rx_buffer, 1);
             m_event_handler(&app_uart_event);
             break;
 
         case NRF_DRV_UART_EVT_TX_DONE:
+#if NRF_MODULE_ENABLED(APP_UART_FIFO_CHUNKED)
+            // The FIFO may have been flushed during the transfer.
+            (void)app_fifo_read_span_commit(&m_tx_fifo,
+                                            MIN(p_event->data.rxtx.bytes, FIFO_LENGTH(m_tx_fifo)));
+            if (FIFO_LENGTH(m_tx_fifo) != 0)
+            {
+                tx_chunk_start();
+            }
+#else
             // Get next byte from FIFO.
             if (app_fifo_get(&m_tx_fifo, tx_buffer) == NRF_SUCCESS)
             {
                 (void)nrf_drv_uart_tx(&app_uart_inst, tx_buffer, 1);
             }
+#endif
             else
             {
                 // Last byte from FIFO transmitted, notify the application.
@@ -144,6 +277,17 @@ uint32_t app_uart_init(const app_uart_comm_params_t * p_comm_params,
         {
             nrf_drv_uart_rx_enable(&app_uart_inst);
         }
+#if NRF_MODULE_ENABLED(APP_UART_FIFO_CHUNKED) && defined(UARTE_PRESENT)
+        // Without EasyDMA the UART interrupts for every byte anyway, so chunks are not used.
+        else
+        {
+            m_rx_chunked = true;
+            m_rx_pending = 0;
+            m_rx_flush   = false;
+            rx_chunks_refill();
+            return m_rx_ovf ? NRF_ERROR_NO_MEM : NRF_SUCCESS;
+        }
+#endif
 
         return nrf_drv_uart_rx(&app_uart_inst, rx_buffer,1);
     }
@@ -175,6 +319,26 @@ uint32_t app_uart_get(uint8_t * p_byte)
 
     ret_code_t err_code =  app_fifo_get(&m_rx_fifo, p_byte);
 
+#if NRF_MODULE_ENABLED(APP_UART_FIFO_CHUNKED)
+    if (m_rx_chunked)
+    {
+        CRITICAL_REGION_ENTER();
+        if (m_rx_ovf)
+        {
+            rx_chunks_refill();
+        }
+        else if ((err_code != NRF_SUCCESS) && !m_rx_flush && (m_rx_pending != 0))
+        {
+            // The FIFO is empty, but a partial chunk may be in the RX buffer. It is passed to
+            // the FIFO by the RXTO event.
+            m_rx_flush = true;
+            nrf_drv_uart_rx_abort(&app_uart_inst);
+        }
+        CRITICAL_REGION_EXIT();
+        return err_code;
+    }
+#endif
+
     // If FIFO was full new request to receive one byte was not scheduled. Must be done here.
     if(rx_ovf)
     {
@@ -199,6 +363,15 @@ uint32_t app_uart_put(uint8_t byte)
         // (in 'uart_event_handler') when all preceding bytes are transmitted.
         // But if UART is not transmitting anything at the moment, we must start
         // a new transmission here.
+#if NRF_MODULE_ENABLED(APP_UART_FIFO_CHUNKED)
+        // The transfer is started from the UART interrupt too, so the check must be atomic.
+        CRITICAL_REGION_ENTER();
+        if (!nrf_drv_uart_tx_in_progress(&app_uart_inst))
+        {
+            tx_chunk_start();
+        }
+        CRITICAL_REGION_EXIT();
+#else
         if (!nrf_drv_uart_tx_in_progress(&app_uart_inst))
         {
             // This operation should be almost always successful, since we've
@@ -210,6 +383,7 @@ uint32_t app_uart_put(uint8_t byte)
                 err_code = nrf_drv_uart_tx(&app_uart_inst, tx_buffer, 1);
             }
         }
+#endif
     }
     return err_code;
 }
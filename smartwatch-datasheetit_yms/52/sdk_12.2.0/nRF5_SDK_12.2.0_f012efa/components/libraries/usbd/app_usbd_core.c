@@ -1079,6 +1079,19 @@ ret_code_t app_usbd_core_ep_transfer(
     return nrf_drv_usbd_ep_transfer(ep, p_transfer, p_handler);
 }
 
+ret_code_t app_usbd_core_ep_transfer_list(
+    nrf_drv_usbd_ep_t                                  ep,
+    nrf_drv_usbd_transfer_t              const * const p_list,
+    size_t                                             count,
+    nrf_drv_usbd_transfer_handler_desc_t const * const p_handler)
+{
+    if (APP_USB_STATE_BASE(app_usbd_state) != APP_USBD_STATE_Configured)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    return nrf_drv_usbd_ep_transfer_list(ep, p_list, count, p_handler);
+}
+
 ret_code_t app_usbd_core_setup_data_transfer(
     nrf_drv_usbd_ep_t                                  ep,
     nrf_drv_usbd_transfer_t              const * const p_transfer,
@@ -178,6 +178,24 @@ ret_code_t app_usbd_core_ep_transfer(
     nrf_drv_usbd_transfer_t              const * const p_transfer,
     nrf_drv_usbd_transfer_handler_desc_t const * const p_handler);
 
+/**
+ * @brief Endpoint transfer of a list of RAM buffers
+ *
+ * Function similar to @ref app_usbd_core_ep_transfer, see @ref nrf_drv_usbd_ep_transfer_list.
+ *
+ * @param ep        See @ref nrf_drv_usbd_ep_transfer_list.
+ * @param p_list    See @ref nrf_drv_usbd_ep_transfer_list.
+ * @param count     See @ref nrf_drv_usbd_ep_transfer_list.
+ * @param p_handler See @ref nrf_drv_usbd_ep_transfer_list.
+ *
+ * @return The same values like @ref app_usbd_core_ep_transfer
+ */
+ret_code_t app_usbd_core_ep_transfer_list(
+    nrf_drv_usbd_ep_t                                  ep,
+    nrf_drv_usbd_transfer_t              const * const p_list,
+    size_t                                             count,
+    nrf_drv_usbd_transfer_handler_desc_t const * const p_handler);
+
 /**
  * @brief Setup data transfer
  *
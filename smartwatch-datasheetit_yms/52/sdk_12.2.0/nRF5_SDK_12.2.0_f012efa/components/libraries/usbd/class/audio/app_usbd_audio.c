@@ -449,8 +449,8 @@ static ret_code_t sof_event_handler(app_usbd_class_inst_t const * p_inst)
         uint32_t isoout = nrf_usbd_epout_size_get(ep_addr);
         if (isoout)
         {
-            ASSERT(isoout == p_audio_ctx->rx_size);
-            NRF_DRV_USBD_TRANSFER_OUT(transfer, p_audio_ctx->p_rx_buff, p_audio_ctx->rx_size);
+            ASSERT(isoout <= p_audio_ctx->rx_size);
+            NRF_DRV_USBD_TRANSFER_OUT(transfer, p_audio_ctx->p_rx_buff, isoout);
             return app_usbd_core_ep_transfer(ep_addr, &transfer, NULL);
         }
     }
@@ -581,4 +581,20 @@ void app_usbd_audio_class_rx_buf_set(app_usbd_class_inst_t const * p_inst,
     CRITICAL_REGION_EXIT();
 }
 
+size_t app_usbd_audio_class_rx_size_get(app_usbd_class_inst_t const * p_inst)
+{
+    ASSERT(p_inst != NULL);
+
+    nrf_drv_usbd_ep_t ep = ep_iso_addr_get(p_inst);
+
+    nrf_drv_usbd_transfer_t transfer;
+    ret_code_t ret = nrf_drv_usbd_ep_status_get(ep, &transfer);
+    if (ret != NRF_SUCCESS)
+    {
+        return 0;
+    }
+
+    return transfer.size;
+}
+
 #endif //APP_USBD_CLASS_AUDIO_ENABLED
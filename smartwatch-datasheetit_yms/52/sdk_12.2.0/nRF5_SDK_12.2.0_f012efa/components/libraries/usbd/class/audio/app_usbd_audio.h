@@ -163,14 +163,27 @@ void app_usbd_audio_class_tx_buf_set(app_usbd_class_inst_t const * p_inst,
 /**
  * @brief Set receive buffer
  *
+ * The packet of every frame is received into the buffer. Packets may be shorter than the buffer.
+ *
  * @param[in] p_inst    Base class instance
  * @param[in] p_buff    Receive buffer
- * @param[in] size      Receive buffer size
+ * @param[in] size      Receive buffer size, at least the largest packet
  * */
 void app_usbd_audio_class_rx_buf_set(app_usbd_class_inst_t const * p_inst,
                                      void * p_buff,
                                      size_t size);
 
+/**
+ * @brief Get the size of the last received packet
+ *
+ * Should be called on @ref APP_USBD_AUDIO_USER_EVT_RX_DONE.
+ *
+ * @param[in] p_inst    Base class instance
+ *
+ * @return Number of bytes received
+ * */
+size_t app_usbd_audio_class_rx_size_get(app_usbd_class_inst_t const * p_inst);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -0,0 +1,627 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_config.h"
+#if APP_USBD_CLASS_AUDIO_ENABLED
+#include <string.h>
+#include "app_usbd_audio_stream.h"
+#include "app_util_platform.h"
+#include "nrf_assert.h"
+
+/**
+ * @defgroup app_usbd_audio_stream_internals USB Audio streaming internals
+ * @{
+ * @ingroup app_usbd_audio_stream
+ * @internal
+ */
+
+/**
+ * @brief Stream context
+ *
+ * The committed frames are rd to rd + count - 1. The producer fills the next pending frames.
+ */
+typedef struct
+{
+    app_usbd_audio_stream_config_t config;                         //!< Stream configuration
+    uint16_t sizes[APP_USBD_AUDIO_STREAM_MAX_FRAMES];              //!< Bytes in every committed frame
+    uint32_t level;             //!< Committed bytes that are not consumed
+    uint32_t level_avg;         //!< Filtered level, scaled by 2^APP_USBD_AUDIO_STREAM_FILTER_SHIFT
+    uint16_t rd_offset;         //!< Bytes of frame rd that are consumed
+    uint16_t in_flight;         //!< Bytes of the IN packet being sent
+    uint16_t since_correction;  //!< Transfers since the last correction
+    uint8_t  rd;                //!< First committed frame
+    uint8_t  wr;                //!< First frame that is not committed
+    uint8_t  count;             //!< Committed frames
+    uint8_t  pending;           //!< Frames given to the producer
+    bool     initialized;       //!< Stream initialized
+    bool     primed;            //!< Consumer started, the target level was reached
+    bool     armed;             //!< USB transfer buffer set
+    app_usbd_audio_stream_stats_t stats;                           //!< Statistics
+} audio_stream_t;
+
+static audio_stream_t m_playback;   //!< Playback stream, OUT endpoint to I2S
+static audio_stream_t m_capture;    //!< Capture stream, PDM to IN endpoint
+
+static inline uint8_t * frame_get(audio_stream_t const * p_stream, uint8_t idx)
+{
+    return (uint8_t *)p_stream->config.p_frames + (size_t)idx * p_stream->config.frame_size;
+}
+
+static inline uint8_t frame_next(audio_stream_t const * p_stream, uint8_t idx)
+{
+    return (idx + 1 == p_stream->config.frame_count) ? 0 : (uint8_t)(idx + 1);
+}
+
+static ret_code_t stream_config_check(app_usbd_audio_stream_config_t const * p_config)
+{
+    if ((p_config == NULL) || (p_config->p_inst == NULL) || (p_config->p_frames == NULL))
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if ((p_config->frame_count < 3)                                  ||
+        (p_config->frame_count > APP_USBD_AUDIO_STREAM_MAX_FRAMES)   ||
+        (p_config->sample_size == 0)                                 ||
+        ((p_config->packet_size % p_config->sample_size) != 0)       ||
+        (p_config->packet_size <= p_config->sample_size)             ||
+        (p_config->target_level <  p_config->packet_size)            ||
+        (p_config->target_level >= (uint32_t)p_config->frame_count * p_config->frame_size))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if (((uint32_t)p_config->p_frames & 0x3) || (p_config->frame_size & 0x3))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    return NRF_SUCCESS;
+}
+
+static void stream_reset(audio_stream_t * p_stream)
+{
+    CRITICAL_REGION_ENTER();
+    p_stream->level            = 0;
+    p_stream->level_avg        = 0;
+    p_stream->rd_offset        = 0;
+    p_stream->in_flight        = 0;
+    p_stream->since_correction = 0;
+    p_stream->rd               = 0;
+    p_stream->wr               = 0;
+    p_stream->count            = 0;
+    p_stream->pending          = 0;
+    p_stream->primed           = false;
+    p_stream->armed            = false;
+    CRITICAL_REGION_EXIT();
+}
+
+/**
+ * @brief Commit the first pending frame
+ *
+ * @param[in] p_stream  Stream
+ * @param[in] size      Bytes written to the frame
+ */
+static void stream_commit(audio_stream_t * p_stream, uint16_t size)
+{
+    CRITICAL_REGION_ENTER();
+    ASSERT(p_stream->pending > 0);
+    p_stream->sizes[p_stream->wr] = size;
+    p_stream->wr = frame_next(p_stream, p_stream->wr);
+    p_stream->pending--;
+    p_stream->count++;
+    p_stream->level += size;
+    CRITICAL_REGION_EXIT();
+}
+
+/**
+ * @brief Consume committed bytes
+ *
+ * @param[in]  p_stream Stream
+ * @param[out] p_dst    Buffer for the bytes, or NULL to drop them
+ * @param[in]  size     Number of bytes
+ *
+ * @return Number of bytes consumed, less than size if the frames ran empty
+ */
+static size_t stream_read(audio_stream_t * p_stream, uint8_t * p_dst, size_t size)
+{
+    size_t   done   = 0;
+    uint8_t  frames = 0;
+    uint8_t  rd     = p_stream->rd;
+    uint16_t offset = p_stream->rd_offset;
+
+    /* The frames committed until now stay valid while they are copied */
+    size = MIN(size, p_stream->level);
+    while (done < size)
+    {
+        size_t chunk = MIN(size - done, (size_t)(p_stream->sizes[rd] - offset));
+        if (p_dst != NULL)
+        {
+            memcpy(p_dst + done, frame_get(p_stream, rd) + offset, chunk);
+        }
+        done   += chunk;
+        offset += chunk;
+        if (offset == p_stream->sizes[rd])
+        {
+            offset = 0;
+            rd = frame_next(p_stream, rd);
+            frames++;
+        }
+    }
+
+    CRITICAL_REGION_ENTER();
+    p_stream->rd        = rd;
+    p_stream->rd_offset = offset;
+    p_stream->count    -= frames;
+    p_stream->level    -= done;
+    CRITICAL_REGION_EXIT();
+
+    return done;
+}
+
+/**
+ * @brief Sample the level, once per USB frame
+ */
+static inline void stream_level_sample(audio_stream_t * p_stream)
+{
+    p_stream->level_avg += p_stream->level;
+    p_stream->level_avg -= p_stream->level_avg >> APP_USBD_AUDIO_STREAM_FILTER_SHIFT;
+}
+
+/**
+ * @brief Start the consumer if the target level is reached
+ *
+ * @return True if the consumer is started.
+ */
+static bool stream_prime(audio_stream_t * p_stream)
+{
+    if (!p_stream->primed && (p_stream->level >= p_stream->config.target_level))
+    {
+        p_stream->level_avg        = p_stream->level << APP_USBD_AUDIO_STREAM_FILTER_SHIFT;
+        p_stream->since_correction = 0;
+        p_stream->primed           = true;
+    }
+
+    return p_stream->primed;
+}
+
+/**
+ * @brief Compare the filtered level to the target level
+ *
+ * @retval 1  One sample more should be consumed
+ * @retval -1 One sample less should be consumed
+ * @retval 0  No correction
+ */
+static int stream_correction_get(audio_stream_t * p_stream)
+{
+    uint32_t level  = p_stream->level_avg >> APP_USBD_AUDIO_STREAM_FILTER_SHIFT;
+    uint32_t target = p_stream->config.target_level;
+    uint32_t hyst   = APP_USBD_AUDIO_STREAM_HYSTERESIS * p_stream->config.sample_size;
+
+    if (p_stream->since_correction < APP_USBD_AUDIO_STREAM_CORRECTION_PERIOD)
+    {
+        p_stream->since_correction++;
+        return 0;
+    }
+
+    if (level > target + hyst)
+    {
+        p_stream->since_correction = 0;
+        p_stream->stats.level_high++;
+        return 1;
+    }
+
+    if (level + hyst < target)
+    {
+        p_stream->since_correction = 0;
+        p_stream->stats.level_low++;
+        return -1;
+    }
+
+    return 0;
+}
+
+static void stream_stats_get(audio_stream_t const * p_stream,
+                             app_usbd_audio_stream_stats_t * p_stats)
+{
+    ASSERT(p_stats != NULL);
+
+    CRITICAL_REGION_ENTER();
+    *p_stats = p_stream->stats;
+    p_stats->level = p_stream->level_avg >> APP_USBD_AUDIO_STREAM_FILTER_SHIFT;
+    CRITICAL_REGION_EXIT();
+}
+
+#if I2S_ENABLED
+
+static uint32_t * mp_i2s_buffer;    //!< I2S transmit buffer
+static uint16_t   m_i2s_size;       //!< I2S transmit buffer size in words
+
+/**
+ * @brief Receive the next OUT packet into the next free frame
+ *
+ * Reception is stopped when no frame is free, and restarted by the I2S data handler.
+ */
+static void playback_rx_arm(void)
+{
+    audio_stream_t * p_stream = &m_playback;
+    void *           p_buff   = NULL;
+    size_t           size     = 0;
+
+    CRITICAL_REGION_ENTER();
+    if (p_stream->count < p_stream->config.frame_count)
+    {
+        p_stream->pending = 1;
+        p_stream->armed   = true;
+        p_buff = frame_get(p_stream, p_stream->wr);
+        size   = p_stream->config.frame_size;
+    }
+    else
+    {
+        if (p_stream->armed)
+        {
+            p_stream->stats.overruns++;
+        }
+        p_stream->pending = 0;
+        p_stream->armed   = false;
+    }
+    CRITICAL_REGION_EXIT();
+
+    app_usbd_audio_class_rx_buf_set(p_stream->config.p_inst, p_buff, size);
+}
+
+static void playback_rx_done(void)
+{
+    audio_stream_t * p_stream = &m_playback;
+    size_t size = app_usbd_audio_class_rx_size_get(p_stream->config.p_inst);
+
+    if (!p_stream->armed)
+    {
+        return;
+    }
+
+    if (size > 0)
+    {
+        stream_commit(p_stream, (uint16_t)size);
+        playback_rx_arm();
+    }
+    stream_level_sample(p_stream);
+}
+
+/**
+ * @brief I2S data handler
+ *
+ * Drift correction drops one sample, or repeats the first sample of the block.
+ */
+static void playback_i2s_data_handler(uint32_t const * p_data_received,
+                                      uint32_t       * p_data_to_send,
+                                      uint16_t         number_of_words)
+{
+    audio_stream_t * p_stream    = &m_playback;
+    uint8_t *        p_dst       = (uint8_t *)p_data_to_send;
+    size_t           size        = number_of_words * sizeof(uint32_t);
+    size_t           sample_size = p_stream->config.sample_size;
+    size_t           done        = 0;
+
+    UNUSED_PARAMETER(p_data_received);
+    if (p_data_to_send == NULL)
+    {
+        return;
+    }
+
+    if (stream_prime(p_stream))
+    {
+        switch (stream_correction_get(p_stream))
+        {
+            case 1:
+                UNUSED_RETURN_VALUE(stream_read(p_stream, NULL, sample_size));
+                break;
+            case -1:
+                if (stream_read(p_stream, p_dst, sample_size) == sample_size)
+                {
+                    memcpy(p_dst + sample_size, p_dst, sample_size);
+                    done = 2 * sample_size;
+                }
+                break;
+            default:
+                break;
+        }
+
+        done += stream_read(p_stream, p_dst + done, size - done);
+        if (done < size)
+        {
+            p_stream->stats.underruns++;
+            p_stream->primed = false;
+        }
+    }
+    memset(p_dst + done, 0, size - done);
+
+    if (!p_stream->armed)
+    {
+        playback_rx_arm();
+    }
+}
+
+static void playback_start(void)
+{
+    stream_reset(&m_playback);
+    playback_rx_arm();
+    UNUSED_RETURN_VALUE(nrf_drv_i2s_start(NULL, mp_i2s_buffer, m_i2s_size, 0));
+}
+
+static void playback_stop(void)
+{
+    nrf_drv_i2s_stop();
+    app_usbd_audio_class_rx_buf_set(m_playback.config.p_inst, NULL, 0);
+    stream_reset(&m_playback);
+}
+
+ret_code_t app_usbd_audio_stream_playback_init(app_usbd_audio_stream_config_t const * p_config,
+                                               nrf_drv_i2s_config_t const *           p_i2s_config,
+                                               uint32_t *                             p_i2s_buffer,
+                                               uint16_t                               i2s_size)
+{
+    ret_code_t ret = stream_config_check(p_config);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    if (p_i2s_buffer == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if ((p_config->frame_size < p_config->packet_size + p_config->sample_size) ||
+        (i2s_size == 0) || (i2s_size & 1)                                      ||
+        (((i2s_size / 2) * sizeof(uint32_t)) % p_config->sample_size != 0)     ||
+        (((i2s_size / 2) * sizeof(uint32_t)) < 2 * p_config->sample_size))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    ret = nrf_drv_i2s_init(p_i2s_config, playback_i2s_data_handler);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    memset(&m_playback, 0, sizeof(m_playback));
+    m_playback.config      = *p_config;
+    m_playback.initialized = true;
+    mp_i2s_buffer          = p_i2s_buffer;
+    m_i2s_size             = i2s_size;
+
+    return NRF_SUCCESS;
+}
+
+#endif // I2S_ENABLED
+
+#if PDM_ENABLED
+
+/**
+ * @brief Send the next IN packet from the committed frames
+ *
+ * Sending is stopped on an underrun, and restarted by the PDM event handler when the target level
+ * is reached. A packet does not continue past the last frame, so it may be short once after the
+ * size was corrected.
+ */
+static void capture_tx_arm(void)
+{
+    audio_stream_t * p_stream = &m_capture;
+    void const *     p_buff   = NULL;
+    size_t           size     = 0;
+    bool             was_armed;
+
+    CRITICAL_REGION_ENTER();
+    was_armed = p_stream->armed;
+    if (stream_prime(p_stream))
+    {
+        size = p_stream->config.packet_size;
+        switch (stream_correction_get(p_stream))
+        {
+            case 1:
+                size += p_stream->config.sample_size;
+                break;
+            case -1:
+                size -= p_stream->config.sample_size;
+                break;
+            default:
+                break;
+        }
+        if (p_stream->level < size)
+        {
+            p_stream->stats.underruns++;
+            p_stream->primed = false;
+            size = 0;
+        }
+        else
+        {
+            size_t contiguous =
+                (size_t)(p_stream->config.frame_count - p_stream->rd) * p_stream->config.frame_size
+                - p_stream->rd_offset;
+            size   = MIN(size, contiguous);
+            p_buff = frame_get(p_stream, p_stream->rd) + p_stream->rd_offset;
+        }
+    }
+    p_stream->in_flight = (uint16_t)size;
+    p_stream->armed     = (size != 0);
+    CRITICAL_REGION_EXIT();
+
+    if (was_armed || (size != 0))
+    {
+        app_usbd_audio_class_tx_buf_set(p_stream->config.p_inst, p_buff, size);
+    }
+}
+
+static void capture_tx_done(void)
+{
+    audio_stream_t * p_stream = &m_capture;
+
+    if (!p_stream->armed)
+    {
+        return;
+    }
+
+    UNUSED_RETURN_VALUE(stream_read(p_stream, NULL, p_stream->in_flight));
+    stream_level_sample(p_stream);
+    capture_tx_arm();
+}
+
+static int16_t * capture_pdm_buffer_request(void)
+{
+    audio_stream_t * p_stream = &m_capture;
+    int16_t *        p_buff   = NULL;
+
+    CRITICAL_REGION_ENTER();
+    if (p_stream->count + p_stream->pending < p_stream->config.frame_count)
+    {
+        uint8_t idx = (p_stream->wr + p_stream->pending) % p_stream->config.frame_count;
+        p_stream->pending++;
+        p_buff = (int16_t *)frame_get(p_stream, idx);
+    }
+    else
+    {
+        p_stream->stats.overruns++;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return p_buff;
+}
+
+static void capture_pdm_event_handler(uint32_t * buffer, uint16_t length)
+{
+    audio_stream_t * p_stream = &m_capture;
+
+    if ((p_stream->pending == 0) || ((uint8_t *)buffer != frame_get(p_stream, p_stream->wr)))
+    {
+        /* Buffer of the driver configuration, filled when no frame was free */
+        return;
+    }
+
+    ASSERT(length * sizeof(int16_t) == p_stream->config.frame_size);
+    stream_commit(p_stream, p_stream->config.frame_size);
+
+    if (!p_stream->armed)
+    {
+        capture_tx_arm();
+    }
+}
+
+static void capture_start(void)
+{
+    stream_reset(&m_capture);
+    UNUSED_RETURN_VALUE(nrf_drv_pdm_start());
+}
+
+static void capture_stop(void)
+{
+    UNUSED_RETURN_VALUE(nrf_drv_pdm_stop());
+    app_usbd_audio_class_tx_buf_set(m_capture.config.p_inst, NULL, 0);
+    stream_reset(&m_capture);
+}
+
+ret_code_t app_usbd_audio_stream_capture_init(app_usbd_audio_stream_config_t const * p_config,
+                                              nrf_drv_pdm_config_t const *           p_pdm_config)
+{
+    ret_code_t ret = stream_config_check(p_config);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    if (p_pdm_config == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if ((p_pdm_config->buffer_length * sizeof(int16_t) != p_config->frame_size) ||
+        (p_config->frame_size < p_config->packet_size))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    ret = nrf_drv_pdm_init(p_pdm_config, capture_pdm_event_handler);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+    nrf_drv_pdm_buffer_request_handler_set(capture_pdm_buffer_request);
+
+    memset(&m_capture, 0, sizeof(m_capture));
+    m_capture.config      = *p_config;
+    m_capture.initialized = true;
+
+    return NRF_SUCCESS;
+}
+
+#endif // PDM_ENABLED
+
+void app_usbd_audio_stream_event_handler(app_usbd_class_inst_t const * p_inst,
+                                         app_usbd_audio_user_event_t   event)
+{
+#if I2S_ENABLED
+    if (m_playback.initialized && (p_inst == m_playback.config.p_inst))
+    {
+        switch (event)
+        {
+            case APP_USBD_AUDIO_USER_EVT_START:
+                playback_start();
+                break;
+            case APP_USBD_AUDIO_USER_EVT_STOP:
+                playback_stop();
+                break;
+            case APP_USBD_AUDIO_USER_EVT_RX_DONE:
+                playback_rx_done();
+                break;
+            default:
+                break;
+        }
+        return;
+    }
+#endif
+
+#if PDM_ENABLED
+    if (m_capture.initialized && (p_inst == m_capture.config.p_inst))
+    {
+        switch (event)
+        {
+            case APP_USBD_AUDIO_USER_EVT_START:
+                capture_start();
+                break;
+            case APP_USBD_AUDIO_USER_EVT_STOP:
+                capture_stop();
+                break;
+            case APP_USBD_AUDIO_USER_EVT_TX_DONE:
+                capture_tx_done();
+                break;
+            default:
+                break;
+        }
+        return;
+    }
+#endif
+
+    UNUSED_PARAMETER(p_inst);
+    UNUSED_PARAMETER(event);
+}
+
+void app_usbd_audio_stream_playback_stats_get(app_usbd_audio_stream_stats_t * p_stats)
+{
+    stream_stats_get(&m_playback, p_stats);
+}
+
+void app_usbd_audio_stream_capture_stats_get(app_usbd_audio_stream_stats_t * p_stats)
+{
+    stream_stats_get(&m_capture, p_stats);
+}
+
+/** @} */
+#endif // APP_USBD_CLASS_AUDIO_ENABLED
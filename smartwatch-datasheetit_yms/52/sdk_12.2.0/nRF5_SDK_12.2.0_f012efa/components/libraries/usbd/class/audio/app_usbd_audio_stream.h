@@ -0,0 +1,187 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#ifndef APP_USBD_AUDIO_STREAM_H__
+#define APP_USBD_AUDIO_STREAM_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+#include "app_usbd_audio.h"
+#include "nrf_drv_i2s.h"
+#include "nrf_drv_pdm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup app_usbd_audio_stream USB Audio streaming
+ * @ingroup app_usbd_audio
+ *
+ * @brief Streaming between the isochronous endpoints of the audio class and the I2S and PDM
+ *        drivers.
+ *
+ * @details Both directions use a jitter buffer of frames:
+ *          - Playback: every packet of the headphone OUT endpoint is received directly into the
+ *            next free frame. The I2S data handler copies the buffered samples into the half
+ *            of the I2S buffer that the driver gives, in a few blocks.
+ *          - Capture: the PDM interface fills the free frames directly, through its buffer
+ *            request handler. The packets of the microphone IN endpoint are sent directly from
+ *            the frames.
+ *
+ *          A transfer is started by the audio class on every SOF, so the buffer level is sampled
+ *          once per USB frame, when the transfer is done, and filtered. The I2S and PDM clocks
+ *          are not locked to the USB clock. When the filtered level leaves the target level
+ *          by more than @ref APP_USBD_AUDIO_STREAM_HYSTERESIS samples, one sample is dropped
+ *          or repeated: in the I2S data for playback, in the size of the IN packet for capture.
+ *
+ *          Playback and capture are started only when the target level is reached, and again
+ *          after an underrun.
+ *
+ *          @ref app_usbd_audio_stream_event_handler must be called from the user event handler
+ *          of the audio class instances.
+ * @{
+ */
+
+/**
+ * @brief Maximum number of frames of a stream.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ * */
+#ifndef APP_USBD_AUDIO_STREAM_MAX_FRAMES
+#define APP_USBD_AUDIO_STREAM_MAX_FRAMES 16
+#endif
+
+/**
+ * @brief Distance of the filtered level from the target level that is corrected, in samples.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ * */
+#ifndef APP_USBD_AUDIO_STREAM_HYSTERESIS
+#define APP_USBD_AUDIO_STREAM_HYSTERESIS 8
+#endif
+
+/**
+ * @brief Minimum number of transfers between two corrections of one sample.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ * */
+#ifndef APP_USBD_AUDIO_STREAM_CORRECTION_PERIOD
+#define APP_USBD_AUDIO_STREAM_CORRECTION_PERIOD 16
+#endif
+
+/**
+ * @brief Level filter: every sample of the level has a weight of 1 / 2^shift.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ * */
+#ifndef APP_USBD_AUDIO_STREAM_FILTER_SHIFT
+#define APP_USBD_AUDIO_STREAM_FILTER_SHIFT 5
+#endif
+
+/**
+ * @brief Stream configuration
+ */
+typedef struct
+{
+    app_usbd_class_inst_t const * p_inst;   //!< Audio class instance of the stream
+    void *                        p_frames; //!< Frames, word aligned and in Data RAM
+    uint16_t frame_size;   //!< Size of a frame in bytes. Playback: the largest packet. Capture: the PDM buffer
+    uint16_t packet_size;  //!< Size of the packet of one millisecond of samples, in bytes
+    uint16_t target_level; //!< Number of bytes kept in the frames
+    uint8_t  frame_count;  //!< Number of frames, 3 to @ref APP_USBD_AUDIO_STREAM_MAX_FRAMES
+    uint8_t  sample_size;  //!< Size of one sample of all channels, in bytes
+} app_usbd_audio_stream_config_t;
+
+/**
+ * @brief Stream statistics
+ */
+typedef struct
+{
+    uint32_t underruns;        //!< Times the consumer found the frames empty
+    uint32_t overruns;         //!< Times the producer found no free frame and data was lost
+    uint32_t level_high;       //!< Corrections of a high level: a sample dropped for playback, a longer packet for capture
+    uint32_t level_low;        //!< Corrections of a low level: a sample repeated for playback, a shorter packet for capture
+    uint32_t level;            //!< Filtered level, in bytes
+} app_usbd_audio_stream_stats_t;
+
+/**
+ * @brief Initialize the playback stream, from the OUT endpoint to I2S.
+ *
+ * The I2S driver is initialized. Transfers are started on @ref APP_USBD_AUDIO_USER_EVT_START.
+ *
+ * @param[in] p_config      Stream configuration. frame_size must hold the largest packet and
+ *                          one sample more than packet_size.
+ * @param[in] p_i2s_config  I2S driver configuration
+ * @param[in] p_i2s_buffer  I2S transmit buffer, in Data RAM
+ * @param[in] i2s_size      Size of the I2S buffer in 32-bit words, of which each half is
+ *                          a whole number of samples
+ *
+ * @retval NRF_SUCCESS             Stream initialized
+ * @retval NRF_ERROR_NULL          A pointer is NULL
+ * @retval NRF_ERROR_INVALID_PARAM Configuration is not valid
+ * @return Any error returned by @ref nrf_drv_i2s_init
+ */
+ret_code_t app_usbd_audio_stream_playback_init(app_usbd_audio_stream_config_t const * p_config,
+                                               nrf_drv_i2s_config_t const *           p_i2s_config,
+                                               uint32_t *                             p_i2s_buffer,
+                                               uint16_t                               i2s_size);
+
+/**
+ * @brief Initialize the capture stream, from PDM to the IN endpoint.
+ *
+ * The PDM driver is initialized. Its buffers are only filled when no frame is free.
+ * Sampling is started on @ref APP_USBD_AUDIO_USER_EVT_START.
+ *
+ * @param[in] p_config      Stream configuration. frame_size must be the size of the PDM buffers.
+ *                          The IN endpoint must accept packet_size plus one sample.
+ * @param[in] p_pdm_config  PDM driver configuration
+ *
+ * @retval NRF_SUCCESS             Stream initialized
+ * @retval NRF_ERROR_NULL          A pointer is NULL
+ * @retval NRF_ERROR_INVALID_PARAM Configuration is not valid
+ * @return Any error returned by @ref nrf_drv_pdm_init
+ */
+ret_code_t app_usbd_audio_stream_capture_init(app_usbd_audio_stream_config_t const * p_config,
+                                              nrf_drv_pdm_config_t const *           p_pdm_config);
+
+/**
+ * @brief Handle a user event of an audio class instance.
+ *
+ * Events of instances that are not streamed are ignored.
+ *
+ * @param[in] p_inst    Audio class instance
+ * @param[in] event     User event
+ */
+void app_usbd_audio_stream_event_handler(app_usbd_class_inst_t const * p_inst,
+                                         app_usbd_audio_user_event_t   event);
+
+/**
+ * @brief Get the statistics of the playback stream.
+ *
+ * @param[out] p_stats  Statistics
+ */
+void app_usbd_audio_stream_playback_stats_get(app_usbd_audio_stream_stats_t * p_stats);
+
+/**
+ * @brief Get the statistics of the capture stream.
+ *
+ * @param[out] p_stats  Statistics
+ */
+void app_usbd_audio_stream_capture_stats_get(app_usbd_audio_stream_stats_t * p_stats);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_USBD_AUDIO_STREAM_H__ */
@@ -428,6 +428,97 @@ static ret_code_t setup_event_handler(app_usbd_class_inst_t const * p_inst,
     return NRF_ERROR_NOT_SUPPORTED;
 }
 
+/**
+ * @brief Stream next transfer handler
+ *
+ * Called when the current transfer has been moved to the endpoint buffer. Releases it from the
+ * queue and gives the queued data that follows, cut to full packets if the data does not end
+ * with the queue storage.
+ *
+ * @param[out] p_next       Next transfer
+ * @param[in]  p_context    CDC ACM class context data
+ *
+ * @retval true  Next transfer given (it can be a ZLP)
+ * @retval false Queue emptied
+ */
+static bool cdc_acm_stream_feeder(nrf_drv_usbd_transfer_t * p_next, void * p_context)
+{
+    app_usbd_cdc_acm_ctx_t * p_cdc_acm_ctx = p_context;
+
+    size_t last = p_cdc_acm_ctx->tx_span;
+    UNUSED_RETURN_VALUE(nrf_queue_read_release(p_cdc_acm_ctx->p_tx_queue, last));
+    p_cdc_acm_ctx->tx_span = 0;
+
+    nrf_queue_span_t spans[2];
+    if (nrf_queue_read_peek_contiguous(p_cdc_acm_ctx->p_tx_queue, spans) != 0)
+    {
+        size_t size = spans[0].count;
+        if ((spans[1].count == 0) && (size > NRF_DRV_USBD_EPSIZE))
+        {
+            /*Rest is sent with the data queued in the meantime*/
+            size -= size % NRF_DRV_USBD_EPSIZE;
+        }
+
+        p_next->p_data.tx = spans[0].p_data;
+        p_next->size      = size;
+        p_cdc_acm_ctx->tx_span = size;
+        return true;
+    }
+
+    if ((last != 0) && ((last % NRF_DRV_USBD_EPSIZE) == 0))
+    {
+        /*Host needs a short packet to end its read*/
+        p_next->p_data.tx = NULL;
+        p_next->size      = 0;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Start stream transfer if idle and data is queued
+ *
+ * @param[in] p_inst        Generic class instance
+ *
+ * @return Standard error code
+ */
+static ret_code_t cdc_acm_stream_start(app_usbd_class_inst_t const * p_inst)
+{
+    app_usbd_cdc_acm_t const * p_cdc_acm = cdc_acm_get(p_inst);
+    app_usbd_cdc_acm_ctx_t *   p_cdc_acm_ctx = cdc_acm_ctx_get(p_cdc_acm);
+
+    ret_code_t ret = NRF_SUCCESS;
+    CRITICAL_REGION_ENTER();
+    if (!p_cdc_acm_ctx->tx_busy)
+    {
+        nrf_drv_usbd_transfer_t transfer;
+
+        /*Feeder gives the first part of the queue*/
+        p_cdc_acm_ctx->tx_span = 0;
+        if (cdc_acm_stream_feeder(&transfer, p_cdc_acm_ctx))
+        {
+            nrf_drv_usbd_transfer_handler_desc_t const handler = {
+                .handler   = cdc_acm_stream_feeder,
+                .p_context = p_cdc_acm_ctx
+            };
+
+            ret = app_usbd_core_ep_transfer(data_ep_in_addr_get(p_inst), &transfer, &handler);
+            if (ret == NRF_SUCCESS)
+            {
+                p_cdc_acm_ctx->tx_busy = true;
+            }
+            else
+            {
+                p_cdc_acm_ctx->tx_span = 0;
+            }
+        }
+    }
+    CRITICAL_REGION_EXIT();
+
+    return ret;
+}
+
 static ret_code_t cdc_acm_endpoint_ev(app_usbd_class_inst_t const *  p_inst,
                                       app_usbd_complex_evt_t const * p_event)
 {
@@ -439,13 +530,28 @@ static ret_code_t cdc_acm_endpoint_ev(app_usbd_class_inst_t const *  p_inst,
 
     if (NRF_USBD_EPIN_CHECK(p_event->drv_evt.data.eptransfer.ep))
     {
+        app_usbd_cdc_acm_ctx_t * p_cdc_acm_ctx = cdc_acm_ctx_get(cdc_acm_get(p_inst));
+
         switch (p_event->drv_evt.data.eptransfer.status)
         {
             case NRF_USBD_EP_OK:
                 NRF_LOG_INFO("EPIN_DATA: %02x done\r\n", p_event->drv_evt.data.eptransfer.ep);
+                if (p_cdc_acm_ctx->p_tx_queue != NULL)
+                {
+                    p_cdc_acm_ctx->tx_busy = false;
+                    if (!nrf_queue_is_empty(p_cdc_acm_ctx->p_tx_queue))
+                    {
+                        /*Data queued after the feeder found the queue empty*/
+                        return cdc_acm_stream_start(p_inst);
+                    }
+                }
+
                 user_event_handler(p_inst, APP_USBD_CDC_ACM_USER_EVT_TX_DONE);
                 return NRF_SUCCESS;
             case NRF_USBD_EP_ABORTED:
+                /*Unsent data stays in the queue*/
+                p_cdc_acm_ctx->tx_busy = false;
+                p_cdc_acm_ctx->tx_span = 0;
                 return NRF_SUCCESS;
             default:
                 return NRF_ERROR_INTERNAL;
@@ -556,9 +662,9 @@ ret_code_t app_usbd_cdc_acm_write(app_usbd_cdc_acm_t const * p_cdc_acm,
 
     bool dtr_state = (p_cdc_acm_ctx->line_state & APP_USBD_CDC_ACM_LINE_STATE_DTR) ?
                       true : false;
-    if (!dtr_state)
+    if (!dtr_state || (p_cdc_acm_ctx->p_tx_queue != NULL))
     {
-        /*Port is not opened*/
+        /*Port is not opened or DATA IN endpoint is streamed*/
         return NRF_ERROR_INVALID_STATE;
     }
 
@@ -567,6 +673,48 @@ ret_code_t app_usbd_cdc_acm_write(app_usbd_cdc_acm_t const * p_cdc_acm,
     return app_usbd_core_ep_transfer(ep, &transfer, NULL);
 }
 
+ret_code_t app_usbd_cdc_acm_stream_set(app_usbd_cdc_acm_t const * p_cdc_acm,
+                                       nrf_queue_t const *        p_queue)
+{
+    app_usbd_cdc_acm_ctx_t * p_cdc_acm_ctx = cdc_acm_ctx_get(p_cdc_acm);
+
+    if ((p_queue != NULL) && (p_queue->element_size != sizeof(uint8_t)))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    ret_code_t ret = NRF_SUCCESS;
+    CRITICAL_REGION_ENTER();
+    if (p_cdc_acm_ctx->tx_busy)
+    {
+        ret = NRF_ERROR_BUSY;
+    }
+    else
+    {
+        p_cdc_acm_ctx->p_tx_queue = p_queue;
+        p_cdc_acm_ctx->tx_span = 0;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return ret;
+}
+
+ret_code_t app_usbd_cdc_acm_stream_flush(app_usbd_cdc_acm_t const * p_cdc_acm)
+{
+    app_usbd_class_inst_t const * p_inst = app_usbd_cdc_acm_class_inst_get(p_cdc_acm);
+    app_usbd_cdc_acm_ctx_t * p_cdc_acm_ctx = cdc_acm_ctx_get(p_cdc_acm);
+
+    bool dtr_state = (p_cdc_acm_ctx->line_state & APP_USBD_CDC_ACM_LINE_STATE_DTR) ?
+                      true : false;
+    if (!dtr_state || (p_cdc_acm_ctx->p_tx_queue == NULL))
+    {
+        /*Port is not opened or no queue attached*/
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    return cdc_acm_stream_start(p_inst);
+}
+
 size_t app_usbd_cdc_acm_rx_size(app_usbd_cdc_acm_t const * p_cdc_acm)
 {
     app_usbd_class_inst_t const * p_inst = app_usbd_cdc_acm_class_inst_get(p_cdc_acm);
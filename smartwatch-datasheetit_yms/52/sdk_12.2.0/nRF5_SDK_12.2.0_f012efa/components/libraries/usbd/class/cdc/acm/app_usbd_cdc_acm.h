@@ -192,6 +192,45 @@ ret_code_t app_usbd_cdc_acm_write(app_usbd_cdc_acm_t const * p_cdc_acm,
                                   const void *               p_buf,
                                   size_t                     length);
 
+/**
+ * @brief Attaches a byte queue to be streamed to CDC ACM serial port.
+ *
+ * Data written to the queue is sent straight from the queue storage. The USB driver asks for the
+ * next part of the queue each time the previous one has been moved to the endpoint buffer, so the
+ * endpoint does not wait for the application between transfers. Packets are filled to
+ * @ref NRF_DRV_USBD_EPSIZE bytes while more data is queued, and a zero length packet ends the
+ * stream when the last packet was full. Bytes are removed from the queue once they are sent.
+ *
+ * @ref APP_USBD_CDC_ACM_USER_EVT_TX_DONE is reported when the queue has been emptied.
+ * @ref app_usbd_cdc_acm_write can not be used while a queue is attached.
+ *
+ * @note The queue storage size should be a multiple of @ref NRF_DRV_USBD_EPSIZE, so that the
+ *       wrap of the queue does not end a packet early.
+ *
+ * @param[in] p_cdc_acm CDC ACM class instance (defined by @ref APP_USBD_CDC_ACM_GLOBAL_DEF)
+ * @param[in] p_queue   Queue of bytes (element size 1), NULL to detach the current one
+ *
+ * @retval NRF_SUCCESS             Queue attached or detached.
+ * @retval NRF_ERROR_INVALID_PARAM Queue elements are not bytes.
+ * @retval NRF_ERROR_BUSY          Stream transfer in progress.
+ */
+ret_code_t app_usbd_cdc_acm_stream_set(app_usbd_cdc_acm_t const * p_cdc_acm,
+                                       nrf_queue_t const *        p_queue);
+
+/**
+ * @brief Starts sending data written to the attached queue.
+ *
+ * Should be called after data is written to the queue. Does nothing if the stream transfer is
+ * already in progress: it picks the new data up by itself.
+ *
+ * @param[in] p_cdc_acm CDC ACM class instance (defined by @ref APP_USBD_CDC_ACM_GLOBAL_DEF)
+ *
+ * @retval NRF_SUCCESS             Transfer started, in progress or nothing to send.
+ * @retval NRF_ERROR_INVALID_STATE Port is not opened or no queue attached.
+ * @return Other values returned by @ref app_usbd_core_ep_transfer
+ */
+ret_code_t app_usbd_cdc_acm_stream_flush(app_usbd_cdc_acm_t const * p_cdc_acm);
+
 /**
  * @brief Returns the amount of data to be read.
  *
@@ -19,6 +19,7 @@ extern "C" {
 
 
 #include "app_util.h"
+#include "nrf_queue.h"
 
 /**
  * @defgroup app_usbd_cdc_acm_internal USB CDC ACM internals
@@ -94,6 +95,10 @@ typedef struct {
 
     uint16_t line_state;                    //!< CDC ACM line state bitmap, DTE side
     uint16_t serial_state;                  //!< CDC ACM serial state bitmap, DCE side
+
+    nrf_queue_t const * p_tx_queue;         //!< Byte queue streamed to DATA IN endpoint (NULL if none)
+    size_t              tx_span;            //!< Queued bytes sent by the current DATA IN transfer
+    bool                tx_busy;            //!< DATA IN transfer of the stream in progress
 } app_usbd_cdc_acm_ctx_t;
 
 
@@ -14,6 +14,7 @@
 #include "app_usbd.h"
 #include "app_usbd_core.h"
 #include "app_usbd_hid.h"
+#include "app_util_platform.h"
 
 /**
  * @ingroup app_usbd_hid_internals USBD HID internals
@@ -65,6 +66,47 @@ static bool hid_sof_required(app_usbd_hid_ctx_t * p_hid_ctx, uint16_t framecnt)
     return false;
 }
 
+/**
+ * @brief Builds the IN report on SOF and sets up its transfer
+ *
+ * The transfer waits for the host poll in this frame: the report sent is no older than
+ * the SOF.
+ *
+ * @param[in] p_inst        Generic class instance
+ * @param[in/out] p_hid_ctx Internal HID context
+ * @param framecnt          SOF event frame counter
+ *
+ * @return Standard error code
+ * */
+static ret_code_t hid_sof_report_transfer(app_usbd_class_inst_t const * p_inst,
+                                          app_usbd_hid_ctx_t * p_hid_ctx,
+                                          uint16_t framecnt)
+{
+    if (!app_usbd_hid_state_valid(p_hid_ctx)       ||
+        app_usbd_hid_access_lock_test(p_hid_ctx)   ||
+        !app_usbd_hid_trans_required(p_hid_ctx))
+    {
+        /* Previous report not read by the host yet */
+        return NRF_SUCCESS;
+    }
+
+    size_t size = p_hid_ctx->sof_report_size;
+    if (!p_hid_ctx->sof_report_handler(p_inst, framecnt, p_hid_ctx->p_sof_report_buff, &size))
+    {
+        return NRF_SUCCESS;
+    }
+    ASSERT(size <= p_hid_ctx->sof_report_size);
+
+    NRF_DRV_USBD_TRANSFER_IN(transfer, p_hid_ctx->p_sof_report_buff, size);
+    ret_code_t ret = app_usbd_core_ep_transfer(app_usbd_hid_epin_addr_get(p_inst), &transfer, NULL);
+    if (ret == NRF_SUCCESS)
+    {
+        app_usbd_hid_state_flag_set(p_hid_ctx, APP_USBD_HID_STATE_FLAG_TRANS_IN_PROGRESS);
+    }
+
+    return ret;
+}
+
 /**
  * @brief User event handler
  *
@@ -394,6 +436,11 @@ ret_code_t app_usbd_hid_event_handler(app_usbd_class_inst_t const * p_inst,
     switch (p_event->app_evt.type)
     {
         case APP_USBD_EVT_DRV_SOF:
+            if (p_hid_ctx->sof_report_handler != NULL)
+            {
+                ret = hid_sof_report_transfer(p_inst, p_hid_ctx, p_event->drv_evt.data.sof.framecnt);
+                break;
+            }
             if (!hid_sof_required(p_hid_ctx, p_event->drv_evt.data.sof.framecnt))
             {
                 break;
@@ -464,6 +511,21 @@ ret_code_t app_usbd_hid_event_handler(app_usbd_class_inst_t const * p_inst,
     return ret;
 }
 
+void app_usbd_hid_sof_report_set(app_usbd_hid_ctx_t * p_hid_ctx,
+                                 app_usbd_hid_sof_report_handler_t handler,
+                                 uint8_t * p_buff,
+                                 size_t size)
+{
+    ASSERT(p_hid_ctx);
+    ASSERT((handler == NULL) || (p_buff != NULL));
+
+    CRITICAL_REGION_ENTER();
+    p_hid_ctx->p_sof_report_buff  = p_buff;
+    p_hid_ctx->sof_report_size    = size;
+    p_hid_ctx->sof_report_handler = handler;
+    CRITICAL_REGION_EXIT();
+}
+
 app_usbd_hid_report_buffer_t * app_usbd_hid_rep_buff_in_get(app_usbd_hid_inst_t const * p_hinst,
                                                             size_t report_id)
 {
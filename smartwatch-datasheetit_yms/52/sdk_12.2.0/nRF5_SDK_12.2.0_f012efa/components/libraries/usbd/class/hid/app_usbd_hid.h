@@ -77,6 +77,26 @@ typedef enum {
 typedef void (*app_usbd_hid_user_ev_handler_t)(app_usbd_class_inst_t const * p_inst,
                                                app_usbd_hid_user_event_t event);
 
+/**
+ * @brief Handler building an IN report on SOF
+ *
+ * Called from USBD interrupt on every SOF, when the IN endpoint is free. The report
+ * is built in place, in the endpoint buffer, and sent to the host on its next poll.
+ * This way the report is at most one frame old when it is read by the host.
+ *
+ * @param[in]     p_inst   Class instance
+ * @param[in]     framecnt SOF frame counter
+ * @param[out]    p_buff   Buffer to fill with the report, including the report ID if used
+ * @param[in,out] p_size   Size of the buffer on input, size of the report on output
+ *
+ * @retval true  Report built, it is to be sent
+ * @retval false Nothing to send in this frame
+ * */
+typedef bool (*app_usbd_hid_sof_report_handler_t)(app_usbd_class_inst_t const * p_inst,
+                                                  uint16_t framecnt,
+                                                  uint8_t * p_buff,
+                                                  size_t * p_size);
+
 /**@brief HID unified interface*/
 typedef struct {
 
@@ -203,6 +223,10 @@ typedef struct {
     nrf_atomic_flag_t access_lock;  //!< Lock flag to internal data
     uint8_t           idle_rate;    //!< HID idle rate (4ms units)
     uint8_t           protocol;     //!< HID protocol type
+
+    app_usbd_hid_sof_report_handler_t sof_report_handler; //!< Report built on SOF, NULL if not used
+    uint8_t *                         p_sof_report_buff;  //!< Endpoint buffer for the report built on SOF
+    size_t                            sof_report_size;    //!< Size of the endpoint buffer
 } app_usbd_hid_ctx_t;
 
 
@@ -344,6 +368,22 @@ ret_code_t app_usbd_hid_event_handler(app_usbd_class_inst_t const * p_inst,
                                       app_usbd_complex_evt_t const * p_event);
 
 
+/**
+ * @brief Sets the handler building IN reports on SOF
+ *
+ * While the handler is set, IN reports are built just in time by the handler,
+ * idle reports are not sent.
+ *
+ * @param[in,out] p_hid_ctx HID context
+ * @param[in]     handler   Handler, NULL to stop building reports on SOF
+ * @param[in]     p_buff    Endpoint buffer, in RAM
+ * @param[in]     size      Size of the buffer
+ * */
+void app_usbd_hid_sof_report_set(app_usbd_hid_ctx_t * p_hid_ctx,
+                                 app_usbd_hid_sof_report_handler_t handler,
+                                 uint8_t * p_buff,
+                                 size_t size);
+
 /**
  * @brief Returns IN report buffer
  *
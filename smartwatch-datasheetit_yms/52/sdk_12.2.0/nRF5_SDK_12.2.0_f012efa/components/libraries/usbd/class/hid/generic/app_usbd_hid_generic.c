@@ -16,6 +16,7 @@
 #include "sdk_common.h"
 #include "app_usbd_hid_generic.h"
 #include "app_util_platform.h"
+#include "nrf_drv_common.h"
 
 
 
@@ -158,6 +159,26 @@ ret_code_t app_usbd_hid_generic_report_in_set(app_usbd_hid_generic_t const * p_g
     return NRF_SUCCESS;
 }
 
+ret_code_t app_usbd_hid_generic_sof_report_handler_set(app_usbd_hid_generic_t const * p_generic,
+                                                       app_usbd_hid_sof_report_handler_t handler,
+                                                       void * p_buff,
+                                                       size_t size)
+{
+    app_usbd_hid_generic_ctx_t * p_generic_ctx = hid_generic_ctx_get(p_generic);
+
+    if (handler != NULL)
+    {
+        VERIFY_PARAM_NOT_NULL(p_buff);
+        if (!nrf_drv_is_in_RAM(p_buff))
+        {
+            return NRF_ERROR_INVALID_ADDR;
+        }
+    }
+
+    app_usbd_hid_sof_report_set(&p_generic_ctx->hid_ctx, handler, p_buff, size);
+    return NRF_SUCCESS;
+}
+
 bool app_usbd_hid_generic_report_in_done(app_usbd_hid_generic_t const * p_generic, uint8_t rep_id)
 {
     app_usbd_hid_generic_ctx_t * p_generic_ctx = hid_generic_ctx_get(p_generic);
@@ -158,6 +158,27 @@ ret_code_t app_usbd_hid_generic_report_in_set(app_usbd_hid_generic_t const * p_g
                                               size_t size);
 
 
+/**
+ * @brief Builds IN reports on SOF
+ *
+ * The handler is called on every SOF while the IN endpoint is free, and builds the report
+ * in @c p_buff just before the host polls for it. Input-to-host latency is about one frame.
+ * Use it instead of @ref app_usbd_hid_generic_report_in_set: the two are not to be mixed.
+ *
+ * @param[in] p_generic HID generic class instance (defined by @ref APP_USBD_HID_GENERIC_GLOBAL_DEF)
+ * @param[in] handler   Handler building the report, NULL to stop
+ * @param[in] p_buff    Endpoint buffer, in RAM. Kept until the handler is cleared.
+ * @param[in] size      Size of the buffer, the largest IN report
+ *
+ * @retval NRF_SUCCESS             Handler set.
+ * @retval NRF_ERROR_NULL          Handler given without a buffer.
+ * @retval NRF_ERROR_INVALID_ADDR  Buffer not in RAM.
+ */
+ret_code_t app_usbd_hid_generic_sof_report_handler_set(app_usbd_hid_generic_t const * p_generic,
+                                                       app_usbd_hid_sof_report_handler_t handler,
+                                                       void * p_buff,
+                                                       size_t size);
+
 /**
  * @brief Checks whether last IN report transfer has been done
  *
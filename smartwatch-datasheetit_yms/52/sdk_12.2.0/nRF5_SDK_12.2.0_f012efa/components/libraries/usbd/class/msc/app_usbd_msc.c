@@ -55,24 +55,6 @@ STATIC_ASSERT(sizeof(app_usbd_msc_csw_t) == 13);
 #define APP_USBD_MSC_EPIN_IDX  0    /**< Mass storage class endpoint IN index */
 #define APP_USBD_MSC_EPOUT_IDX 1    /**< Mass storage class endpoint OUT index */
 
-/**
- * @brief Set request buffer busy flag
- *
- * @param[in] val   Bitmask to set
- * @param[in] id    Buffer id
- * */
-#define APP_USBD_MSC_REQ_BUSY_SET(val, id) SET_BIT(val, id)
-
-/**
- * @brief Clear request buffer busy flag
- *
- * @param[in] val   Bitmask to set
- * @param[in] id    Buffer id
- * */
-#define APP_USBD_MSC_REQ_BUSY_CLR(val, id) CLR_BIT(val, id)
-
-#define APP_USBD_MSC_REQ_BUSY_FULL_MASK (0x03)  /**< Request busy mask */
-
 static void msc_blockdev_ev_handler(nrf_block_dev_t const * p_blk_dev,
                                     nrf_block_dev_event_t const * p_event);
 
@@ -102,6 +84,33 @@ static inline app_usbd_msc_ctx_t * msc_ctx_get(app_usbd_msc_t const * p_msc)
     return &p_msc->specific.p_data->ctx;
 }
 
+/**
+ * @brief Auxiliary function to access MSC work buffer
+ *
+ * @param[in] p_msc    MSC instance data
+ * @param[in] idx      Work buffer index
+ *
+ * @return Work buffer
+ */
+static inline uint8_t * workbuff_get(app_usbd_msc_t const * p_msc, size_t idx)
+{
+    ASSERT(idx < APP_USBD_MSC_WORKBUFF_COUNT);
+    return (uint8_t *)p_msc->specific.inst.p_block_buff + idx * p_msc->specific.inst.block_buff_size;
+}
+
+/**
+ * @brief Auxiliary function to get the first free MSC work buffer
+ *
+ * @param[in] p_msc_ctx    MSC context data
+ *
+ * @return Index of the work buffer that follows the ready ones
+ */
+static inline uint8_t workbuff_free_idx_get(app_usbd_msc_ctx_t const * p_msc_ctx)
+{
+    return (p_msc_ctx->current.buff_first + p_msc_ctx->current.buff_ready) %
+           APP_USBD_MSC_WORKBUFF_COUNT;
+}
+
 /**
  * @brief Auxiliary function to access MSC IN endpoint address
  *
@@ -520,85 +529,268 @@ static ret_code_t setup_event_handler(app_usbd_class_inst_t const * p_inst,
 }
 
 /**
- * @brief Handle read6/read10 command data stage
+ * @brief Helper function to calculate next block transfer block count
+ *
+ * @param[in] p_msc         MSC instance
+ * @param[in] p_msc_ctx     MSC context
+ *
+ * @return Blocks to transfer
+ * */
+static uint32_t next_transfer_blkcnt_calc(app_usbd_msc_t const * p_msc,
+                                          app_usbd_msc_ctx_t *   p_msc_ctx)
+{
+    uint32_t blkcnt = p_msc->specific.inst.block_buff_size / p_msc_ctx->current.blk_size;
+    if (blkcnt > (p_msc_ctx->current.blk_datasize / p_msc_ctx->current.blk_size))
+    {
+        blkcnt = p_msc_ctx->current.blk_datasize / p_msc_ctx->current.blk_size;
+    }
+
+    return blkcnt;
+}
+
+/**
+ * @brief Reset read6/read10/write6/write10 data stage work buffers
+ *
+ * @param[in] p_msc_ctx     MSC context
+ * */
+static void data_stage_reset(app_usbd_msc_ctx_t * p_msc_ctx)
+{
+    p_msc_ctx->current.trans_in_progress = false;
+    p_msc_ctx->current.block_req_in_progress = false;
+    p_msc_ctx->current.buff_first = 0;
+    p_msc_ctx->current.buff_ready = 0;
+}
+
+/**
+ * @brief Start everything that read6/read10 data stage can start
+ *
+ * The oldest filled work buffer is sent to the host, and the next blocks are read into the first
+ * free work buffer. The block device reads ahead while the host is served.
+ *
+ * @note Block device may finish request before this function returns. Context is updated before
+ *       a request is triggered.
  *
  * @param[in] p_inst        Generic class instance
  *
  * @return Standard error code
- * @retval NRF_SUCCESS if request handled correctly
- * @retval NRF_ERROR_NOT_SUPPORTED if request is not supported
  */
-static ret_code_t state_data_in_handle(app_usbd_class_inst_t const * p_inst)
+static ret_code_t data_in_run(app_usbd_class_inst_t const * p_inst)
 {
     app_usbd_msc_t const * p_msc = msc_get(p_inst);
     app_usbd_msc_ctx_t *   p_msc_ctx = msc_ctx_get(p_msc);
 
     ret_code_t ret = NRF_SUCCESS;
 
-    p_msc_ctx->current.trans_in_progress = false;
-    APP_USBD_MSC_REQ_BUSY_CLR(p_msc_ctx->current.req_busy_mask, p_msc_ctx->current.trans_req_id);
+    if (!p_msc_ctx->current.trans_in_progress && (p_msc_ctx->current.buff_ready != 0))
+    {
+        uint8_t idx = p_msc_ctx->current.buff_first;
+        ret = transfer_in_start(p_inst,
+                                workbuff_get(p_msc, idx),
+                                p_msc_ctx->current.buff_size[idx],
+                                APP_USBD_MSC_STATE_DATA_IN);
+        if (ret != NRF_SUCCESS)
+        {
+            return ret;
+        }
 
-    if (p_msc_ctx->current.blk_datasize == 0 && p_msc_ctx->current.req_busy_mask == 0)
+        p_msc_ctx->current.trans_in_progress = true;
+    }
+
+    if (p_msc_ctx->current.block_req_in_progress ||
+        (p_msc_ctx->current.blk_count == 0) ||
+        (p_msc_ctx->current.buff_ready == APP_USBD_MSC_WORKBUFF_COUNT))
     {
-        p_msc_ctx->current.blk_idx = p_msc_ctx->current.blk_size = 0;
-        ret = csw_wait_start(p_inst, p_msc_ctx->current.csw_status);
-        return ret;
+        /* Nothing left to read, or USB transfers need to catch-up block device readings */
+        return NRF_SUCCESS;
     }
 
-    ASSERT(p_msc_ctx->current.blk_size != 0);
+    nrf_block_dev_t const * p_blkd = p_msc->specific.inst.pp_block_devs[p_msc_ctx->current.lun];
+
+    uint8_t idx = workbuff_free_idx_get(p_msc_ctx);
+    uint32_t size = p_msc_ctx->current.blk_count * p_msc_ctx->current.blk_size;
+    NRF_BLOCK_DEV_REQUEST(req,
+                          p_msc_ctx->current.blk_idx,
+                          p_msc_ctx->current.blk_count,
+                          workbuff_get(p_msc, idx));
+
+    p_msc_ctx->current.buff_size[idx] = size;
+    p_msc_ctx->current.blk_idx += p_msc_ctx->current.blk_count;
+    p_msc_ctx->current.blk_datasize -= size;
+    p_msc_ctx->current.blk_count = next_transfer_blkcnt_calc(p_msc, p_msc_ctx);
+    p_msc_ctx->current.block_req_in_progress = true;
+
+    NRF_LOG_DEBUG("nrf_blk_dev_read_req: id: %u, count: %u, left: %u, ptr: %p\r\n",
+                  req.blk_id,
+                  req.blk_count,
+                  p_msc_ctx->current.blk_datasize,
+                  (uint32_t)req.p_buff);
 
-    if (p_msc_ctx->current.req_busy_mask == 0)
+    ret = nrf_blk_dev_read_req(p_blkd, &req);
+    NRF_LOG_DEBUG("nrf_blk_dev_read_req: ret: %u\r\n", ret);
+    if (ret != NRF_SUCCESS)
     {
-        nrf_block_dev_t const * p_blkd =
-                                p_msc->specific.inst.pp_block_devs[p_msc_ctx->current.lun];
+        p_msc_ctx->current.block_req_in_progress = false;
+    }
 
-        /*Trigger new block read request*/
-        p_msc_ctx->current.workbuff_pos ^= p_msc->specific.inst.block_buff_size;
-        uint32_t req_pos = p_msc_ctx->current.workbuff_pos != 0 ? 1 : 0;
-        APP_USBD_MSC_REQ_BUSY_SET(p_msc_ctx->current.req_busy_mask, req_pos);
+    return ret;
+}
 
-        NRF_BLOCK_DEV_REQUEST(req,
-                              p_msc_ctx->current.blk_idx,
-                              p_msc_ctx->current.blk_count,
-                              ((uint8_t *)p_msc->specific.inst.p_block_buff +
-                              p_msc_ctx->current.workbuff_pos));
+/**
+ * @brief Start read6/read10 data stage straight from the memory of the block device
+ *
+ * All the blocks are sent to the host in a single transfer, from the pointer given by
+ * @ref NRF_BLOCK_DEV_IOCTL_REQ_BLOCK_PTR. No work buffer is used.
+ *
+ * @param[in] p_inst        Generic class instance
+ *
+ * @return Standard error code
+ * @retval NRF_ERROR_NOT_SUPPORTED if the block device has no blocks in memory
+ */
+static ret_code_t data_in_direct_start(app_usbd_class_inst_t const * p_inst)
+{
+    app_usbd_msc_t const * p_msc = msc_get(p_inst);
+    app_usbd_msc_ctx_t *   p_msc_ctx = msc_ctx_get(p_msc);
+
+    nrf_block_dev_t const * p_blkd = p_msc->specific.inst.pp_block_devs[p_msc_ctx->current.lun];
+
+    uint32_t blk_count = p_msc_ctx->current.blk_datasize / p_msc_ctx->current.blk_size;
+    NRF_BLOCK_DEV_REQUEST(req, p_msc_ctx->current.blk_idx, blk_count, NULL);
+
+    ret_code_t ret = nrf_blk_dev_ioctl(p_blkd, NRF_BLOCK_DEV_IOCTL_REQ_BLOCK_PTR, &req);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
 
-        NRF_LOG_DEBUG("nrf_blk_dev_read_req 3: id: %u, count: %u, left: %u, ptr: %p\r\n",
-                      req.blk_id,
-                      req.blk_count,
-                      p_msc_ctx->current.blk_datasize,
-                      (uint32_t)req.p_buff);
+    uint32_t size = blk_count * p_msc_ctx->current.blk_size;
+    NRF_LOG_DEBUG("data_in_direct_start: id: %u, count: %u, ptr: %p\r\n",
+                  req.blk_id,
+                  req.blk_count,
+                  (uint32_t)req.p_buff);
 
-        ret = nrf_blk_dev_read_req(p_blkd, &req);
-        NRF_LOG_DEBUG("nrf_blk_dev_read_req 3: ret: %u\r\n", ret);
+    ret = transfer_in_start(p_inst, req.p_buff, size, APP_USBD_MSC_STATE_DATA_IN);
+    if (ret != NRF_SUCCESS)
+    {
         return ret;
     }
 
-    uint32_t blk_size = p_msc_ctx->current.blk_size;
-    p_msc_ctx->current.trans_req_id ^= 1;
+    /*The transfer is seen as one work buffer sent to the host*/
+    p_msc_ctx->current.blk_idx += blk_count;
+    p_msc_ctx->current.blk_datasize -= size;
+    p_msc_ctx->current.blk_count = 0;
+    p_msc_ctx->current.buff_ready = 1;
+    p_msc_ctx->current.trans_in_progress = true;
+
+    return NRF_SUCCESS;
+}
+
+/**
+ * @brief Start everything that write6/write10 data stage can start
+ *
+ * Next data is received from the host into the first free work buffer, and the oldest received
+ * work buffer is written to the block device. The host sends while the block device writes.
+ *
+ * @note Block device may finish request before this function returns. Context is updated before
+ *       a request is triggered.
+ *
+ * @param[in] p_inst        Generic class instance
+ *
+ * @return Standard error code
+ */
+static ret_code_t data_out_run(app_usbd_class_inst_t const * p_inst)
+{
+    app_usbd_msc_t const * p_msc = msc_get(p_inst);
+    app_usbd_msc_ctx_t *   p_msc_ctx = msc_ctx_get(p_msc);
+
+    ret_code_t ret = NRF_SUCCESS;
+    uint32_t   blk_size = p_msc_ctx->current.blk_size;
+
+    if (!p_msc_ctx->current.trans_in_progress &&
+        (p_msc_ctx->current.blk_count != 0) &&
+        (p_msc_ctx->current.buff_ready < APP_USBD_MSC_WORKBUFF_COUNT))
+    {
+        uint8_t idx = workbuff_free_idx_get(p_msc_ctx);
+        uint32_t size = p_msc_ctx->current.blk_count * blk_size;
+        ret = transfer_out_start(p_inst,
+                                 workbuff_get(p_msc, idx),
+                                 size,
+                                 APP_USBD_MSC_STATE_DATA_OUT);
+        if (ret != NRF_SUCCESS)
+        {
+            return ret;
+        }
 
-    nrf_block_req_t * p_req = &p_msc_ctx->current.req;
-    if (p_req->p_buff == NULL)
+        p_msc_ctx->current.buff_size[idx] = size;
+        p_msc_ctx->current.blk_datasize -= size;
+        p_msc_ctx->current.blk_count = next_transfer_blkcnt_calc(p_msc, p_msc_ctx);
+        p_msc_ctx->current.trans_in_progress = true;
+    }
+
+    if (p_msc_ctx->current.block_req_in_progress || (p_msc_ctx->current.buff_ready == 0))
     {
-        p_msc_ctx->current.trans_req_id ^= 1;
         return NRF_SUCCESS;
     }
 
-    ret = transfer_in_start(p_inst,
-                            p_req->p_buff,
-                            p_req->blk_count * blk_size,
-                            APP_USBD_MSC_STATE_DATA_IN);
+    nrf_block_dev_t const * p_blkd = p_msc->specific.inst.pp_block_devs[p_msc_ctx->current.lun];
 
-    if (ret == NRF_SUCCESS)
+    uint8_t idx = p_msc_ctx->current.buff_first;
+    NRF_BLOCK_DEV_REQUEST(req,
+                          p_msc_ctx->current.blk_idx,
+                          p_msc_ctx->current.buff_size[idx] / blk_size,
+                          workbuff_get(p_msc, idx));
+
+    p_msc_ctx->current.blk_idx += req.blk_count;
+    p_msc_ctx->current.block_req_in_progress = true;
+
+    NRF_LOG_DEBUG("nrf_blk_dev_write_req: id: %u, count: %u, left: %u, ptr: %p\r\n",
+                  req.blk_id,
+                  req.blk_count,
+                  p_msc_ctx->current.blk_datasize,
+                  (uint32_t)req.p_buff);
+
+    ret = nrf_blk_dev_write_req(p_blkd, &req);
+    NRF_LOG_DEBUG("nrf_blk_dev_write_req: ret: %u\r\n", ret);
+    if (ret != NRF_SUCCESS)
     {
-        /*Clear processed block request.*/
-        memset(p_req, 0, sizeof(nrf_block_req_t));
-        p_msc_ctx->current.trans_in_progress = true;
+        p_msc_ctx->current.block_req_in_progress = false;
     }
 
     return ret;
 }
 
+/**
+ * @brief Handle read6/read10 command data stage
+ *
+ * @param[in] p_inst        Generic class instance
+ *
+ * @return Standard error code
+ * @retval NRF_SUCCESS if request handled correctly
+ * @retval NRF_ERROR_NOT_SUPPORTED if request is not supported
+ */
+static ret_code_t state_data_in_handle(app_usbd_class_inst_t const * p_inst)
+{
+    app_usbd_msc_t const * p_msc = msc_get(p_inst);
+    app_usbd_msc_ctx_t *   p_msc_ctx = msc_ctx_get(p_msc);
+
+    ASSERT(p_msc_ctx->current.buff_ready != 0);
+
+    /*Work buffer sent to the host can be read into again*/
+    p_msc_ctx->current.trans_in_progress = false;
+    p_msc_ctx->current.buff_ready--;
+    p_msc_ctx->current.buff_first =
+            (p_msc_ctx->current.buff_first + 1) % APP_USBD_MSC_WORKBUFF_COUNT;
+
+    if ((p_msc_ctx->current.buff_ready == 0) &&
+        !p_msc_ctx->current.block_req_in_progress &&
+        (p_msc_ctx->current.blk_count == 0))
+    {
+        p_msc_ctx->current.blk_idx = p_msc_ctx->current.blk_size = 0;
+        return csw_wait_start(p_inst, p_msc_ctx->current.csw_status);
+    }
+
+    return data_in_run(p_inst);
+}
+
 /**
  * @brief Endpoint IN event handler
  *
@@ -663,42 +855,6 @@ static ret_code_t endpoint_in_event_handler(app_usbd_class_inst_t const *  p_ins
 }
 
 
-/**
- * @brief Helper function to calculate next block transfer block count
- *
- * @param[in] p_msc         MSC instance
- * @param[in] p_msc_ctx     MSC context
- *
- * @return Blocks to transfer
- * */
-static uint32_t next_transfer_blkcnt_calc(app_usbd_msc_t const * p_msc,
-                                          app_usbd_msc_ctx_t *   p_msc_ctx)
-{
-    uint32_t blkcnt = p_msc->specific.inst.block_buff_size / p_msc_ctx->current.blk_size;
-    if (blkcnt > (p_msc_ctx->current.blk_datasize / p_msc_ctx->current.blk_size))
-    {
-        blkcnt = p_msc_ctx->current.blk_datasize / p_msc_ctx->current.blk_size;
-    }
-
-    return blkcnt;
-}
-
-/**
- * @brief Helper function to calculate next transfer size
- *
- * @param[in] p_msc_ctx     MSC context
- *
- * @return Blocks to transfer
- * */
-static uint32_t next_transfer_size_calc(app_usbd_msc_ctx_t * p_msc_ctx)
-{
-    uint32_t blk_cnt = p_msc_ctx->current.blk_count;
-    uint32_t blk_size = p_msc_ctx->current.blk_size;
-
-    return p_msc_ctx->current.blk_datasize > blk_size * blk_cnt ?
-           blk_size * blk_cnt : p_msc_ctx->current.blk_datasize;
-}
-
 /**
  * @brief SCSI Command: @ref APP_USBD_SCSI_CMD_TESTUNITREADY handle
  *
@@ -799,28 +955,23 @@ static ret_code_t cmd_read_start(app_usbd_class_inst_t const * p_inst,
                                  app_usbd_msc_t const *        p_msc,
                                  app_usbd_msc_ctx_t *          p_msc_ctx)
 {
-    nrf_block_dev_t const * p_blkd = p_msc->specific.inst.pp_block_devs[p_msc_ctx->cbw.lun];
-
-    p_msc_ctx->current.trans_in_progress = false;
-    p_msc_ctx->current.req_busy_mask = 0;
-    p_msc_ctx->current.workbuff_pos = 0;
-
-    APP_USBD_MSC_REQ_BUSY_SET(p_msc_ctx->current.req_busy_mask, 0);
-    NRF_BLOCK_DEV_REQUEST(req,
-                          p_msc_ctx->current.blk_idx,
-                          p_msc_ctx->current.blk_count,
-                          ((uint8_t *)p_msc->specific.inst.p_block_buff +
-                          p_msc_ctx->current.workbuff_pos));
-
     NRF_LOG_DEBUG("cmd_read_start\r\n");
-    NRF_LOG_DEBUG("nrf_blk_dev_read_req 1: id: %u, count: %u, left: %u, ptr: %p\r\n",
-                  req.blk_id,
-                  req.blk_count,
-                  p_msc_ctx->current.blk_datasize,
-                  (uint32_t)req.p_buff);
+    data_stage_reset(p_msc_ctx);
 
-    ret_code_t ret = nrf_blk_dev_read_req(p_blkd, &req);
-    NRF_LOG_DEBUG("nrf_blk_dev_read_req 1: ret: %u\r\n", ret);
+    if (p_msc_ctx->current.blk_count == 0)
+    {
+        return csw_wait_start(p_inst, p_msc_ctx->current.csw_status);
+    }
+
+    ret_code_t ret;
+    CRITICAL_REGION_ENTER();
+    ret = data_in_direct_start(p_inst);
+    if (ret == NRF_ERROR_NOT_SUPPORTED)
+    {
+        /*Blocks are read into the work buffers*/
+        ret = data_in_run(p_inst);
+    }
+    CRITICAL_REGION_EXIT();
 
     return ret;
 }
@@ -872,21 +1023,18 @@ static ret_code_t cmd_write_start(app_usbd_class_inst_t const * p_inst,
                                   app_usbd_msc_ctx_t *          p_msc_ctx)
 {
     NRF_LOG_DEBUG("cmd_write_start\r\n");
-    ret_code_t ret = transfer_out_start(p_inst,
-                                        ((uint8_t *)p_msc->specific.inst.p_block_buff +
-                                        p_msc_ctx->current.workbuff_pos),
-                                        next_transfer_size_calc(p_msc_ctx),
-                                        APP_USBD_MSC_STATE_DATA_OUT);
+    data_stage_reset(p_msc_ctx);
 
-    if (ret == NRF_SUCCESS)
+    if (p_msc_ctx->current.blk_count == 0)
     {
-        p_msc_ctx->current.trans_req_id = 0;
-        APP_USBD_MSC_REQ_BUSY_SET(p_msc_ctx->current.req_busy_mask,
-                                  p_msc_ctx->current.trans_req_id);
-        p_msc_ctx->current.workbuff_pos ^= p_msc->specific.inst.block_buff_size;
-        p_msc_ctx->current.trans_in_progress = true;
+        return csw_wait_start(p_inst, p_msc_ctx->current.csw_status);
     }
 
+    ret_code_t ret;
+    CRITICAL_REGION_ENTER();
+    ret = data_out_run(p_inst);
+    CRITICAL_REGION_EXIT();
+
     return ret;
 }
 
@@ -1448,67 +1596,13 @@ static ret_code_t state_data_out_handle(app_usbd_class_inst_t const * p_inst)
     app_usbd_msc_t const * p_msc = msc_get(p_inst);
     app_usbd_msc_ctx_t *   p_msc_ctx = msc_ctx_get(p_msc);
 
-    ret_code_t ret = NRF_SUCCESS;
-    uint32_t   blk_size = p_msc_ctx->current.blk_size;
-
     NRF_LOG_DEBUG("APP_USBD_MSC_STATE_DATA_OUT\r\n");
 
+    /*Work buffer received from the host can be written*/
     p_msc_ctx->current.trans_in_progress = false;
-    if ((p_msc_ctx->current.req_busy_mask != APP_USBD_MSC_REQ_BUSY_FULL_MASK) &&
-        (p_msc_ctx->current.blk_datasize > p_msc_ctx->current.blk_count * blk_size))
-    {
-        size_t size = p_msc_ctx->current.blk_datasize - p_msc_ctx->current.blk_count * blk_size;
-        if (size > p_msc_ctx->current.blk_count * blk_size)
-        {
-            size = p_msc_ctx->current.blk_count * blk_size;
-        }
+    p_msc_ctx->current.buff_ready++;
 
-        if (size)
-        {
-            ret = transfer_out_start(p_inst,
-                                     ((uint8_t *)p_msc->specific.inst.p_block_buff +
-                                     p_msc_ctx->current.workbuff_pos),
-                                     size,
-                                     APP_USBD_MSC_STATE_DATA_OUT);
-            if (ret == NRF_SUCCESS)
-            {
-                p_msc_ctx->current.trans_req_id ^= 1;
-                APP_USBD_MSC_REQ_BUSY_SET(p_msc_ctx->current.req_busy_mask,
-                                          p_msc_ctx->current.trans_req_id);
-                p_msc_ctx->current.workbuff_pos ^= p_msc->specific.inst.block_buff_size;
-                p_msc_ctx->current.trans_in_progress = true;
-            }
-        }
-    }
-
-    if (!p_msc_ctx->current.block_req_in_progress)
-    {
-        nrf_block_dev_t const * p_blkd =
-                                p_msc->specific.inst.pp_block_devs[p_msc_ctx->current.lun];
-
-        size_t pos = p_msc_ctx->current.workbuff_pos;;
-        if (p_msc_ctx->current.req_busy_mask != APP_USBD_MSC_REQ_BUSY_FULL_MASK)
-        {
-            pos ^= p_msc->specific.inst.block_buff_size;
-        }
-
-        NRF_BLOCK_DEV_REQUEST(req,
-                              p_msc_ctx->current.blk_idx,
-                              p_msc_ctx->current.blk_count,
-                              ((uint8_t *)p_msc->specific.inst.p_block_buff + pos));
-
-        NRF_LOG_DEBUG("nrf_blk_dev_write_req 1: id: %u, count: %u, left: %u, ptr: %p\r\n",
-                      req.blk_id,
-                      req.blk_count,
-                      p_msc_ctx->current.blk_datasize,
-                      (uint32_t)req.p_buff);
-
-        p_msc_ctx->current.block_req_in_progress = true;
-        ret = nrf_blk_dev_write_req(p_blkd, &req);
-        NRF_LOG_DEBUG("nrf_blk_dev_write_req 1: ret: %u\r\n", ret);
-    }
-
-    return ret;
+    return data_out_run(p_inst);
 }
 
 /**
@@ -1778,100 +1872,19 @@ const app_usbd_class_methods_t app_usbd_msc_class_methods = {
 static void msc_blockdev_read_done_handler(nrf_block_dev_t const * p_blk_dev,
                                            nrf_block_dev_event_t const * p_event)
 {
-    ret_code_t ret;
-
     app_usbd_class_inst_t const * p_inst = p_event->p_context;
     app_usbd_msc_t const *        p_msc = msc_get(p_inst);
     app_usbd_msc_ctx_t *          p_msc_ctx = msc_ctx_get(p_msc);
 
-    uint32_t blk_cnt = p_msc_ctx->current.blk_count;
-    uint32_t blk_size = p_msc_ctx->current.blk_size;
-
-    /*Save actual request*/
-    size_t req_pos = (p_msc_ctx->current.workbuff_pos != 0) ? 1 : 0;
-    p_msc_ctx->current.req = *p_event->p_blk_req;
-
-    p_msc_ctx->current.block_req_in_progress = false;
-
-    /*Decrement transfer counter*/
-    p_msc_ctx->current.blk_idx += blk_cnt;
-    if (p_msc_ctx->current.blk_datasize > blk_size * blk_cnt)
-    {
-        p_msc_ctx->current.blk_datasize -= blk_size * blk_cnt;
-    }
-    else
-    {
-        p_msc_ctx->current.blk_datasize = 0;
-    }
-
-    NRF_LOG_DEBUG("read_done_handler: p_buff: %p, size: %u data size: %u req_pos: %u\r\n",
+    NRF_LOG_DEBUG("read_done_handler: p_buff: %p, size: %u data size: %u\r\n",
                   (uint32_t)p_event->p_blk_req->p_buff,
                   p_event->p_blk_req->blk_count,
-                  p_msc_ctx->current.blk_datasize,
-                  req_pos);
-
-    /*Calculate next block request size*/
-    p_msc_ctx->current.blk_count = next_transfer_blkcnt_calc(p_msc, p_msc_ctx);
-
-    if (!p_msc_ctx->current.trans_in_progress)
-    {
-        /*Trigger new transfer.*/
-        p_msc_ctx->current.trans_req_id = req_pos;
-        nrf_block_req_t * p_req = &p_msc_ctx->current.req;
-
-        ret = transfer_in_start(p_inst,
-                                p_req->p_buff,
-                                p_req->blk_count * blk_size,
-                                APP_USBD_MSC_STATE_DATA_IN);
-        if (ret != NRF_SUCCESS)
-        {
-            UNUSED_RETURN_VALUE(unsupported_start(p_inst));
-        }
-        else
-        {
-            /*Clear processed block request.*/
-            memset(p_req, 0, sizeof(nrf_block_req_t));
-            p_msc_ctx->current.trans_in_progress = true;
-        }
-
-    }
-
-    if (p_msc_ctx->current.req_busy_mask == APP_USBD_MSC_REQ_BUSY_FULL_MASK)
-    {
-        /* No need to perform next block read request. USB transfers need to catch-up
-         * block device readings */
-        return;
-    }
-
-    if (p_msc_ctx->current.blk_count == 0)
-    {
-        /*All data has been read. No need to trigger new block request.*/
-        return;
-    }
-
-    /*Trigger new block read request*/
-    p_msc_ctx->current.workbuff_pos ^= p_msc->specific.inst.block_buff_size;
-    req_pos = p_msc_ctx->current.workbuff_pos != 0 ? 1 : 0;
-
-    APP_USBD_MSC_REQ_BUSY_SET(p_msc_ctx->current.req_busy_mask, req_pos);
-
-    NRF_BLOCK_DEV_REQUEST(req,
-                          p_msc_ctx->current.blk_idx,
-                          p_msc_ctx->current.blk_count,
-                          ((uint8_t *)p_msc->specific.inst.p_block_buff +
-                          p_msc_ctx->current.workbuff_pos));
-
-
-    NRF_LOG_DEBUG("nrf_blk_dev_read_req 2: id: %u, count: %u, left: %u, ptr: %p\r\n",
-                  req.blk_id,
-                  req.blk_count,
-                  p_msc_ctx->current.blk_datasize,
-                  (uint32_t)req.p_buff);
+                  p_msc_ctx->current.blk_datasize);
 
-    ret = nrf_blk_dev_read_req(p_blk_dev, &req);
-    NRF_LOG_DEBUG("nrf_blk_dev_read_req 2: ret: %u\r\n", ret);
+    p_msc_ctx->current.block_req_in_progress = false;
+    p_msc_ctx->current.buff_ready++;
 
-    if (ret != NRF_SUCCESS)
+    if (data_in_run(p_inst) != NRF_SUCCESS)
     {
         UNUSED_RETURN_VALUE(unsupported_start(p_inst));
     }
@@ -1893,102 +1906,29 @@ static void msc_blockdev_write_done_handler(nrf_block_dev_t const * p_blk_dev,
     app_usbd_msc_t const *        p_msc = msc_get(p_inst);
     app_usbd_msc_ctx_t *          p_msc_ctx = msc_ctx_get(p_msc);
 
-    uint32_t blk_cnt = p_msc_ctx->current.blk_count;
-    uint32_t blk_size = p_msc_ctx->current.blk_size;
-
-    /*Save actual request*/
-    size_t req_pos = (p_event->p_blk_req->p_buff == p_msc->specific.inst.p_block_buff) ? 0 : 1;
-    p_msc_ctx->current.req = *p_event->p_blk_req;
-
-    APP_USBD_MSC_REQ_BUSY_CLR(p_msc_ctx->current.req_busy_mask, req_pos);
-    p_msc_ctx->current.block_req_in_progress = false;
-
-    p_msc_ctx->current.blk_idx += blk_cnt;
-
-    if (p_msc_ctx->current.blk_datasize > blk_size * blk_cnt)
-    {
-        p_msc_ctx->current.blk_datasize -= blk_size * blk_cnt;
-    }
-    else
-    {
-        p_msc_ctx->current.blk_datasize = 0;
-    }
-
-    NRF_LOG_DEBUG("write_done_handler: p_buff: %p, size: %u data size: %u req_pos: %u\r\n",
+    NRF_LOG_DEBUG("write_done_handler: p_buff: %p, size: %u data size: %u\r\n",
                   (uint32_t)p_event->p_blk_req->p_buff,
                   p_event->p_blk_req->blk_count,
-                  p_msc_ctx->current.blk_datasize,
-                  req_pos);
+                  p_msc_ctx->current.blk_datasize);
 
-    if (p_msc_ctx->current.blk_datasize == 0)
+    /*Written work buffer can be received into again*/
+    p_msc_ctx->current.block_req_in_progress = false;
+    p_msc_ctx->current.buff_ready--;
+    p_msc_ctx->current.buff_first =
+            (p_msc_ctx->current.buff_first + 1) % APP_USBD_MSC_WORKBUFF_COUNT;
+
+    if ((p_msc_ctx->current.buff_ready == 0) &&
+        !p_msc_ctx->current.trans_in_progress &&
+        (p_msc_ctx->current.blk_count == 0))
     {
         p_msc_ctx ->current.blk_idx = p_msc_ctx ->current.blk_size = 0;
         UNUSED_RETURN_VALUE(csw_wait_start(p_inst, p_msc_ctx->current.csw_status));
         return;
     }
 
-    if (p_msc_ctx->current.blk_datasize <= p_msc_ctx->current.blk_count * blk_size)
+    if (data_out_run(p_inst) != NRF_SUCCESS)
     {
-        size_t pos = p_msc_ctx->current.workbuff_pos;;
-        if (p_msc_ctx->current.req_busy_mask != APP_USBD_MSC_REQ_BUSY_FULL_MASK)
-        {
-            pos ^= p_msc->specific.inst.block_buff_size;
-        }
-
-        NRF_BLOCK_DEV_REQUEST(req,
-                              p_msc_ctx->current.blk_idx,
-                              p_msc_ctx->current.blk_count,
-                              ((uint8_t *)p_msc->specific.inst.p_block_buff + pos));
-
-        NRF_LOG_DEBUG("nrf_blk_dev_write_req 2: id: %u, count: %u, left: %u, ptr: %p\r\n",
-                      req.blk_id,
-                      req.blk_count,
-                      p_msc_ctx->current.blk_datasize,
-                      (uint32_t)req.p_buff);
-
-        p_msc_ctx->current.block_req_in_progress = true;
-        ret_code_t ret = nrf_blk_dev_write_req(p_blk_dev, &req);
-        NRF_LOG_DEBUG("nrf_blk_dev_write_req 2: ret: %u\r\n", ret);
-
-        if (ret != NRF_SUCCESS)
-        {
-            UNUSED_RETURN_VALUE(unsupported_start(p_inst));
-        }
-
-        return;
-    }
-
-    if (!p_msc_ctx->current.trans_in_progress &&
-        (p_msc_ctx->current.blk_datasize  > p_msc_ctx->current.blk_count * blk_size))
-    {
-        size_t size = p_msc_ctx->current.blk_datasize - p_msc_ctx->current.blk_count * blk_size;
-        if (size > p_msc_ctx->current.blk_count * blk_size)
-        {
-            size = p_msc_ctx->current.blk_count * blk_size;
-        }
-
-        if (size > 0)
-        {
-            /*Trigger new transfer.*/
-            p_msc_ctx->current.blk_count = next_transfer_blkcnt_calc(p_msc, p_msc_ctx);
-            ret_code_t ret = transfer_out_start(p_inst,
-                                                ((uint8_t *)p_msc->specific.inst.p_block_buff +
-                                                p_msc_ctx->current.workbuff_pos),
-                                                size,
-                                                APP_USBD_MSC_STATE_DATA_OUT);
-            if (ret == NRF_SUCCESS)
-            {
-                p_msc_ctx->current.trans_req_id ^= 1;
-                APP_USBD_MSC_REQ_BUSY_SET(p_msc_ctx->current.req_busy_mask,
-                                          p_msc_ctx->current.trans_req_id);
-                p_msc_ctx->current.workbuff_pos ^= p_msc->specific.inst.block_buff_size;
-                p_msc_ctx->current.trans_in_progress = true;
-            }
-            else
-            {
-                UNUSED_RETURN_VALUE(unsupported_start(p_inst));
-            }
-        }
+        UNUSED_RETURN_VALUE(unsupported_start(p_inst));
     }
 }
 
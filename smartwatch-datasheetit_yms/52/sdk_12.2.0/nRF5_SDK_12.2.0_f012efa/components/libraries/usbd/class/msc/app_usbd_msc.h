@@ -110,6 +110,8 @@ typedef enum app_usbd_msc_user_event_e {
  *
  * @note This macro is just simplified version of @ref APP_USBD_MSC_GLOBAL_DEF_INTERNAL
  *
+ * @note @ref APP_USBD_MSC_WORKBUFF_COUNT work buffers of workbuffer_size bytes are allocated.
+ *
  */
 #define APP_USBD_MSC_GLOBAL_DEF(instance_name,              \
                                 interface_number,           \
@@ -30,6 +30,24 @@ extern "C" {
  * */
 #define APP_USBD_MSC_MINIMAL_SERIAL_STRING_SIZE (12 + 1)
 
+/**
+ * @brief Number of work buffers of READ/WRITE data stage
+ *
+ * Block device requests and USB transfers of consecutive work buffers overlap. With two buffers
+ * the block device reads the next chunk while the current one is sent to the host, and writes the
+ * last chunk while the next one is received. More buffers absorb block devices with uneven access
+ * times, like one that has to erase flash from time to time.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ * */
+#ifndef APP_USBD_MSC_WORKBUFF_COUNT
+#define APP_USBD_MSC_WORKBUFF_COUNT 2
+#endif
+
+#if (APP_USBD_MSC_WORKBUFF_COUNT < 1) || (APP_USBD_MSC_WORKBUFF_COUNT > 255)
+#error "APP_USBD_MSC_WORKBUFF_COUNT must be between 1 and 255."
+#endif
+
 /**
  * @brief Forward declaration of Mass Storage Class type
  *
@@ -61,8 +79,8 @@ typedef void (*app_usbd_msc_user_ev_handler_t)(app_usbd_class_inst_t const *  p_
 typedef struct {
     uint8_t const * p_raw_desc;         //!< MSC descriptors
     size_t          raw_desc_size;      //!< MSC descriptors size
-    void *          p_block_buff;       //!< Block buffer
-    size_t          block_buff_size;    //!< Block buffer size (typically 512 bytes)
+    void *          p_block_buff;       //!< Block buffer (@ref APP_USBD_MSC_WORKBUFF_COUNT work buffers)
+    size_t          block_buff_size;    //!< Size of one work buffer (typically 512 bytes)
 
     nrf_block_dev_t const **   pp_block_devs;      //!< Block devices list
     size_t                     block_devs_count;   //!< Block device list size
@@ -107,11 +125,11 @@ typedef struct {
 
         bool    trans_in_progress;      //!< Transfer in progress flag
         bool    block_req_in_progress;  //!< Block request in progress flag
-        size_t  workbuff_pos;           //!< Current buffer offset (double buffering mode)
-        uint8_t req_busy_mask;          //!< Request bust mask (double buffering mode)
-        uint8_t trans_req_id;           //!< Current transfered request (double buffering mode)
-
-        nrf_block_req_t req;            //!< Last processed block req (double buffering mode)
+        uint8_t buff_first;             //!< Oldest used work buffer: sent to the host (IN) or
+                                        //!< written to the block device (OUT)
+        uint8_t buff_ready;             //!< Work buffers, from buff_first on, that hold data read
+                                        //!< from the block device (IN) or received from the host (OUT)
+        uint32_t buff_size[APP_USBD_MSC_WORKBUFF_COUNT]; //!< Data size of every work buffer
     } current;
 
     size_t resp_len;            //!< Response length
@@ -163,7 +181,7 @@ typedef struct {
          .pp_block_devs = block_devs,                                                       \
          .block_devs_count = ARRAY_SIZE(block_devs),                                        \
          .p_block_buff = block_buff,                                                        \
-         .block_buff_size = sizeof(block_buff) / 2,                                         \
+         .block_buff_size = sizeof(block_buff) / APP_USBD_MSC_WORKBUFF_COUNT,               \
          .user_ev_handler = user_event_handler,                                             \
     }
 
@@ -209,7 +227,8 @@ extern const app_usbd_class_methods_t app_usbd_msc_class_methods;
                  APP_USBD_MSC_DSC_CONFIG(interface_number, BRACKET_EXTRACT(endpoint_list));     \
     static const nrf_block_dev_t * CONCAT_2(instance_name, _blkdevs)[] =                        \
                                    { BRACKET_EXTRACT(blockdev_list) };                          \
-    static uint32_t CONCAT_2(instance_name, _block)[2 *(workbuffer_size) / sizeof(uint32_t)];   \
+    static uint32_t CONCAT_2(instance_name, _block)                                             \
+                    [APP_USBD_MSC_WORKBUFF_COUNT * (workbuffer_size) / sizeof(uint32_t)];       \
     APP_USBD_CLASS_INST_GLOBAL_DEF(                                                             \
         instance_name,                                                                          \
         app_usbd_msc,                                                                           \
@@ -10,7 +10,11 @@
  *
  */
 
+#include "sdk_common.h"
 #include "app_error.h"
+#if NRF_MODULE_ENABLED(CRASH_SNAPSHOT)
+#include "crash_snapshot.h"
+#endif
 
 #define NRF_LOG_MODULE_NAME "APP_ERROR"
 #include "nrf_log.h"
@@ -23,6 +27,9 @@
  */
 __WEAK void app_error_fault_handler(uint32_t id, uint32_t pc, uint32_t info)
 {
+#if NRF_MODULE_ENABLED(CRASH_SNAPSHOT)
+    crash_snapshot_error_capture(id, pc, info);
+#endif
     NRF_LOG_ERROR("Fatal\r\n");
     NRF_LOG_FINAL_FLUSH();
     // On assert, the system can only recover with a reset.
@@ -34,6 +34,8 @@ void app_util_enable_irq(void)
     }
 }
 
+#if (APP_UTIL_PLATFORM_CONFIG_CRITICAL_REGION == APP_UTIL_CRITICAL_REGION_NVIC)
+
 void app_util_critical_region_enter(uint8_t *p_nested)
 {
 #if __CORTEX_M == (0x04U)
@@ -43,9 +45,14 @@ void app_util_critical_region_enter(uint8_t *p_nested)
 #if defined(SOFTDEVICE_PRESENT)
     /* return value can be safely ignored */
     (void) sd_nvic_critical_region_enter(p_nested);
+    if (*p_nested == 0)
 #else
     app_util_disable_irq();
+    if (m_in_critical_region == 1)
 #endif
+    {
+        CPU_PROFILER_CRITICAL_REGION_ENTER();
+    }
 }
 
 void app_util_critical_region_exit(uint8_t nested)
@@ -54,6 +61,15 @@ void app_util_critical_region_exit(uint8_t nested)
     ASSERT(APP_LEVEL_PRIVILEGED == privilege_level_get())
 #endif
 
+#if defined(SOFTDEVICE_PRESENT)
+    if (nested == 0)
+#else
+    if (m_in_critical_region == 1)
+#endif
+    {
+        CPU_PROFILER_CRITICAL_REGION_EXIT();
+    }
+
 #if defined(SOFTDEVICE_PRESENT)
     /* return value can be safely ignored */
     (void) sd_nvic_critical_region_exit(nested);
@@ -62,4 +78,18 @@ void app_util_critical_region_exit(uint8_t nested)
 #endif
 }
 
+#else
+
+void app_util_critical_region_enter(uint8_t *p_nested)
+{
+    *p_nested = app_util_critical_region_raise();
+}
+
+void app_util_critical_region_exit(uint8_t nested)
+{
+    app_util_critical_region_restore(nested);
+}
+
+#endif // (APP_UTIL_PLATFORM_CONFIG_CRITICAL_REGION == APP_UTIL_CRITICAL_REGION_NVIC)
+
 
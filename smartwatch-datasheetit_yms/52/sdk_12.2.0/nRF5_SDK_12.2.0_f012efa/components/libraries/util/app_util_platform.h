@@ -31,6 +31,7 @@
 #endif
 #include "nrf_assert.h"
 #include "app_error.h"
+#include "cpu_profiler_hooks.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -126,6 +127,38 @@ typedef enum
 #define PACKED_STRUCT struct PACKED 
 #endif
 
+/**@defgroup APP_UTIL_CRITICAL_REGION_TYPES Implementations of critical regions
+ * @{
+ */
+#define APP_UTIL_CRITICAL_REGION_NVIC       0   /**< @ref sd_nvic_critical_region_enter with the SoftDevice, a nesting counter and PRIMASK without. Function call. */
+#define APP_UTIL_CRITICAL_REGION_PRIMASK    1   /**< PRIMASK, the previous value is kept in the region. Inline. Without the SoftDevice only. */
+#define APP_UTIL_CRITICAL_REGION_BASEPRI    2   /**< BASEPRI masks the application priorities, the previous value is kept in the region. Inline. Cortex-M4 with the SoftDevice only. */
+/** @} */
+
+/**@brief Implementation of @ref CRITICAL_REGION_ENTER, one of @ref APP_UTIL_CRITICAL_REGION_TYPES.
+ *
+ * @details With @ref APP_UTIL_CRITICAL_REGION_BASEPRI, the SoftDevice priorities 0 and 1 are not
+ *          masked, as with @ref sd_nvic_critical_region_enter. The low SoftDevice priorities are
+ *          masked too, however, and SVC has one of them: SoftDevice functions must not be called
+ *          in a critical region, or the call escalates to a HardFault.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef APP_UTIL_PLATFORM_CONFIG_CRITICAL_REGION
+#define APP_UTIL_PLATFORM_CONFIG_CRITICAL_REGION APP_UTIL_CRITICAL_REGION_NVIC
+#endif
+
+#if (APP_UTIL_PLATFORM_CONFIG_CRITICAL_REGION == APP_UTIL_CRITICAL_REGION_PRIMASK) && defined(SOFTDEVICE_PRESENT)
+#error "PRIMASK critical regions would block the SoftDevice interrupts."
+#endif
+#if (APP_UTIL_PLATFORM_CONFIG_CRITICAL_REGION == APP_UTIL_CRITICAL_REGION_BASEPRI) && \
+    ((__CORTEX_M != (0x04U)) || !defined(SOFTDEVICE_PRESENT))
+#error "BASEPRI critical regions need a Cortex-M4, and the SoftDevice to leave priorities 0 and 1 unused by the application."
+#endif
+
+/**@brief BASEPRI value that masks the application priorities. */
+#define APP_UTIL_CRITICAL_REGION_BASEPRI_LEVEL  (_PRIO_APP_HIGH << (8U - __NVIC_PRIO_BITS))
+
 void app_util_critical_region_enter (uint8_t *p_nested);
 void app_util_critical_region_exit (uint8_t nested);
 
@@ -135,7 +168,11 @@ void app_util_critical_region_exit (uint8_t nested);
  *       CRITICAL_REGION_EXIT() for each call to CRITICAL_REGION_ENTER(), and they must be located
  *       in the same scope.
  */
-#ifdef SOFTDEVICE_PRESENT
+#if (APP_UTIL_PLATFORM_CONFIG_CRITICAL_REGION != APP_UTIL_CRITICAL_REGION_NVIC)
+#define CRITICAL_REGION_ENTER()                                                             \
+    {                                                                                       \
+        uint8_t __CR_NESTED = app_util_critical_region_raise();
+#elif defined(SOFTDEVICE_PRESENT)
 #define CRITICAL_REGION_ENTER()                                                             \
     {                                                                                       \
         uint8_t __CR_NESTED = 0;                                                            \
@@ -150,7 +187,11 @@ void app_util_critical_region_exit (uint8_t nested);
  *       CRITICAL_REGION_EXIT() for each call to CRITICAL_REGION_ENTER(), and they must be located
  *       in the same scope.
  */
-#ifdef SOFTDEVICE_PRESENT
+#if (APP_UTIL_PLATFORM_CONFIG_CRITICAL_REGION != APP_UTIL_CRITICAL_REGION_NVIC)
+#define CRITICAL_REGION_EXIT()                                                              \
+        app_util_critical_region_restore(__CR_NESTED);                                      \
+    }
+#elif defined(SOFTDEVICE_PRESENT)
 #define CRITICAL_REGION_EXIT()                                                              \
         app_util_critical_region_exit(__CR_NESTED);                                         \
     }
@@ -246,6 +287,59 @@ static __INLINE uint8_t privilege_level_get(void)
 }
 
 
+#if (APP_UTIL_PLATFORM_CONFIG_CRITICAL_REGION != APP_UTIL_CRITICAL_REGION_NVIC)
+/**@brief Function for entering a critical region inline. Used by @ref CRITICAL_REGION_ENTER.
+ *
+ * @return The mask before the region, to pass to @ref app_util_critical_region_restore.
+ */
+static __INLINE uint8_t app_util_critical_region_raise(void)
+{
+    uint8_t previous;
+
+    // Unprivileged writes to the mask registers are ignored.
+    ASSERT(APP_LEVEL_PRIVILEGED == privilege_level_get());
+
+#if (APP_UTIL_PLATFORM_CONFIG_CRITICAL_REGION == APP_UTIL_CRITICAL_REGION_BASEPRI)
+    previous = (uint8_t)__get_BASEPRI();
+    // Never lowers the mask, so an enclosing region, or a handler that masks more, is kept.
+    __set_BASEPRI_MAX(APP_UTIL_CRITICAL_REGION_BASEPRI_LEVEL);
+    __ISB();
+#else
+    previous = (uint8_t)__get_PRIMASK();
+    __disable_irq();
+#endif
+
+    if (previous == 0)
+    {
+        CPU_PROFILER_CRITICAL_REGION_ENTER();
+    }
+    return previous;
+}
+
+
+/**@brief Function for leaving a critical region inline. Used by @ref CRITICAL_REGION_EXIT.
+ *
+ * @param[in] previous The mask returned by @ref app_util_critical_region_raise.
+ */
+static __INLINE void app_util_critical_region_restore(uint8_t previous)
+{
+    if (previous == 0)
+    {
+        CPU_PROFILER_CRITICAL_REGION_EXIT();
+    }
+
+#if (APP_UTIL_PLATFORM_CONFIG_CRITICAL_REGION == APP_UTIL_CRITICAL_REGION_BASEPRI)
+    __set_BASEPRI(previous);
+#else
+    if (previous == 0)
+    {
+        __enable_irq();
+    }
+#endif
+}
+#endif // (APP_UTIL_PLATFORM_CONFIG_CRITICAL_REGION != APP_UTIL_CRITICAL_REGION_NVIC)
+
+
 #ifdef __cplusplus
 }
 #endif
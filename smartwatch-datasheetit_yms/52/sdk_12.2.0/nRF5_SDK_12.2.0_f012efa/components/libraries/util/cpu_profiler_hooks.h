@@ -0,0 +1,121 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ * @brief Hooks of the @ref cpu_profiler module.
+ *
+ * @details Drivers and libraries place these macros at the beginning and at the end of their
+ *          interrupt handlers. They expand to nothing unless the CPU profiler is enabled.
+ */
+
+#ifndef CPU_PROFILER_HOOKS_H__
+#define CPU_PROFILER_HOOKS_H__
+
+#include <stdint.h>
+#include "sdk_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**@brief Profiled handlers. */
+typedef enum
+{
+    CPU_PROFILER_ISR_RTC1,              /**< RTC1 interrupt of @ref app_timer. */
+    CPU_PROFILER_ISR_SWI,               /**< Timer list updates of @ref app_timer. */
+    CPU_PROFILER_ISR_GPIOTE,            /**< GPIOTE driver. */
+    CPU_PROFILER_ISR_SAADC,             /**< SAADC driver. */
+    CPU_PROFILER_ISR_UART0,             /**< UART driver, instance 0. */
+    CPU_PROFILER_ISR_UART1,             /**< UART driver, instance 1. */
+    CPU_PROFILER_ISR_TWI0,              /**< TWI driver, instance 0. */
+    CPU_PROFILER_ISR_TWI1,              /**< TWI driver, instance 1. */
+    CPU_PROFILER_ISR_SPI0,              /**< SPI master driver, instance 0. */
+    CPU_PROFILER_ISR_SPI1,              /**< SPI master driver, instance 1. */
+    CPU_PROFILER_ISR_SPI2,              /**< SPI master driver, instance 2. */
+    CPU_PROFILER_ISR_SOFTDEVICE_EVT,    /**< Dispatch of SoftDevice events. */
+    CPU_PROFILER_ISR_CRITICAL_REGION,   /**< Outermost critical regions. Not a handler, see @ref CPU_PROFILER_CONFIG_CRITICAL_REGION_ENABLED. */
+    CPU_PROFILER_ISR_COUNT
+} cpu_profiler_isr_t;
+
+/** @brief Measure the time spent in critical regions, see @ref CRITICAL_REGION_ENTER.
+ *
+ * Adds a call to every outermost critical region, so it is off by default.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef CPU_PROFILER_CONFIG_CRITICAL_REGION_ENABLED
+#define CPU_PROFILER_CONFIG_CRITICAL_REGION_ENABLED 0
+#endif
+
+#if NRF_MODULE_ENABLED(CPU_PROFILER)
+
+/**@brief Function for recording one run of a handler. Used by @ref CPU_PROFILER_ISR_EXIT.
+ *
+ * @param[in] isr    Handler.
+ * @param[in] start  Cycle counter at the entry of the handler.
+ */
+void cpu_profiler_isr_record(cpu_profiler_isr_t isr, uint32_t start);
+
+/**@brief Function for recording one sleep. Used by @ref CPU_PROFILER_SLEEP_EXIT.
+ *
+ * @param[in] start  Cycle counter before going to sleep.
+ */
+void cpu_profiler_sleep_record(uint32_t start);
+
+/**@brief Macro for marking the entry of a handler. Must be placed before the first statement. */
+#define CPU_PROFILER_ISR_ENTER(isr)     uint32_t const cpu_profiler_start = DWT->CYCCNT
+
+/**@brief Macro for marking the exit of a handler. */
+#define CPU_PROFILER_ISR_EXIT(isr)      cpu_profiler_isr_record((isr), cpu_profiler_start)
+
+/**@brief Macro for marking the start of a sleep. */
+#define CPU_PROFILER_SLEEP_ENTER()      uint32_t const cpu_profiler_sleep_start = DWT->CYCCNT
+
+/**@brief Macro for marking the end of a sleep. */
+#define CPU_PROFILER_SLEEP_EXIT()       cpu_profiler_sleep_record(cpu_profiler_sleep_start)
+
+#else
+
+#define CPU_PROFILER_ISR_ENTER(isr)
+#define CPU_PROFILER_ISR_EXIT(isr)
+#define CPU_PROFILER_SLEEP_ENTER()
+#define CPU_PROFILER_SLEEP_EXIT()
+
+#endif // NRF_MODULE_ENABLED(CPU_PROFILER)
+
+#if NRF_MODULE_ENABLED(CPU_PROFILER) && CPU_PROFILER_CONFIG_CRITICAL_REGION_ENABLED
+
+/**@brief Function for marking the entry of an outermost critical region. */
+void cpu_profiler_critical_region_enter(void);
+
+/**@brief Function for marking the exit of an outermost critical region, before interrupts are
+ *        unmasked. */
+void cpu_profiler_critical_region_exit(void);
+
+/**@brief Macro for marking the entry of an outermost critical region. */
+#define CPU_PROFILER_CRITICAL_REGION_ENTER()    cpu_profiler_critical_region_enter()
+
+/**@brief Macro for marking the exit of an outermost critical region. */
+#define CPU_PROFILER_CRITICAL_REGION_EXIT()     cpu_profiler_critical_region_exit()
+
+#else
+
+#define CPU_PROFILER_CRITICAL_REGION_ENTER()
+#define CPU_PROFILER_CRITICAL_REGION_EXIT()
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CPU_PROFILER_HOOKS_H__
@@ -15,6 +15,10 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include "compiler_abstraction.h"
+#include "nrf.h"
+
+
+#define SDK_MAPPED_FLAGS_ALL_MASK   (0xFFFFFFFFUL >> (32 - SDK_MAPPED_FLAGS_N_KEYS))  /**< Mask of the bits of a flag collection that hold flags. */
 
 
 /**@brief Function for setting the state of a flag to true.
@@ -56,17 +60,55 @@ static __INLINE bool sdk_mapped_flags_get_by_index(sdk_mapped_flags_t flags, uin
 }
 
 
+/**@brief Function for getting the position of the lowest bit set in a word.
+ *
+ * @param[in]  word  A word that is not 0.
+ */
+static __INLINE uint16_t lowest_bit_get(uint32_t word)
+{
+#if (__CORTEX_M >= 0x03U)
+    return __CLZ(__RBIT(word));
+#else
+    uint16_t position = 0;
+
+    // Binary search, the Cortex-M0 has no CLZ instruction.
+    if ((word & 0xFFFF) == 0) { word >>= 16; position += 16; }
+    if ((word & 0xFF)   == 0) { word >>= 8;  position += 8;  }
+    if ((word & 0xF)    == 0) { word >>= 4;  position += 4;  }
+    if ((word & 0x3)    == 0) { word >>= 2;  position += 2;  }
+    if ((word & 0x1)    == 0) {              position += 1;  }
+
+    return position;
+#endif
+}
+
+
 
 uint16_t sdk_mapped_flags_first_key_index_get(sdk_mapped_flags_t flags)
 {
-    for (uint16_t i = 0; i < SDK_MAPPED_FLAGS_N_KEYS; i++)
+    uint32_t word = flags & SDK_MAPPED_FLAGS_ALL_MASK;
+
+    if (word == 0)
     {
-        if (sdk_mapped_flags_get_by_index(flags, i))
+        return SDK_MAPPED_FLAGS_INVALID_INDEX;
+    }
+    return lowest_bit_get(word);
+}
+
+
+uint16_t sdk_mapped_flags_next_index_get(sdk_mapped_flags_t * p_flags)
+{
+    uint16_t index = SDK_MAPPED_FLAGS_INVALID_INDEX;
+
+    if (p_flags != NULL)
+    {
+        index = sdk_mapped_flags_first_key_index_get(*p_flags);
+        if (index != SDK_MAPPED_FLAGS_INVALID_INDEX)
         {
-            return i;
+            sdk_mapped_flags_clear_by_index(p_flags, index);
         }
     }
-    return SDK_MAPPED_FLAGS_INVALID_INDEX;
+    return index;
 }
 
 
@@ -133,12 +175,13 @@ sdk_mapped_flags_key_list_t sdk_mapped_flags_key_list_get(uint16_t           * p
 
     if (p_keys != NULL)
     {
-        for (uint32_t i = 0; i < SDK_MAPPED_FLAGS_N_KEYS; i++)
+        uint32_t word = flags & SDK_MAPPED_FLAGS_ALL_MASK;
+
+        // Only the set flags are visited.
+        while (word != 0)
         {
-            if (sdk_mapped_flags_get_by_index(flags, i))
-            {
-                key_list.flag_keys[key_list.len++] = p_keys[i];
-            }
+            key_list.flag_keys[key_list.len++] = p_keys[lowest_bit_get(word)];
+            word &= (word - 1);
         }
     }
 
@@ -148,14 +191,12 @@ sdk_mapped_flags_key_list_t sdk_mapped_flags_key_list_get(uint16_t           * p
 
 uint32_t sdk_mapped_flags_n_flags_set(sdk_mapped_flags_t flags)
 {
-    uint32_t n_flags_set = 0;
+    uint32_t word = flags & SDK_MAPPED_FLAGS_ALL_MASK;
 
-    for (uint32_t i = 0; i < SDK_MAPPED_FLAGS_N_KEYS; i++)
-    {
-        if (sdk_mapped_flags_get_by_index(flags, i))
-        {
-            n_flags_set += 1;
-        }
-    }
-    return n_flags_set;
+    // Population count: sums of 2, 4 and 8 bits, then the sum of the bytes.
+    word = word - ((word >> 1) & 0x55555555);
+    word = (word & 0x33333333) + ((word >> 2) & 0x33333333);
+    word = (word + (word >> 4)) & 0x0F0F0F0F;
+
+    return (word * 0x01010101) >> 24;
 }
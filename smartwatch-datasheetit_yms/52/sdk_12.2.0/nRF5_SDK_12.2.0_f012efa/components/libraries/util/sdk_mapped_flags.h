@@ -74,6 +74,30 @@ typedef struct
 uint16_t sdk_mapped_flags_first_key_index_get(sdk_mapped_flags_t flags);
 
 
+/**@brief Function for taking the first index at which the flag is true out of a collection.
+ *
+ * @details The flag at the returned index is cleared in @p p_flags. Calling the function until it
+ *          returns @ref SDK_MAPPED_FLAGS_INVALID_INDEX visits the set flags of a copy of a
+ *          collection, without building a key list:
+ *
+ * @code
+ * sdk_mapped_flags_t remaining = flags;
+ * uint16_t           index;
+ *
+ * while ((index = sdk_mapped_flags_next_index_get(&remaining)) != SDK_MAPPED_FLAGS_INVALID_INDEX)
+ * {
+ *     // Use p_keys[index].
+ * }
+ * @endcode
+ *
+ * @param[inout]  p_flags  The flags not visited yet.
+ *
+ * @return  The first index that had its flag set to true. If none were found, or p_flags was NULL,
+ *          the function returns @ref SDK_MAPPED_FLAGS_INVALID_INDEX.
+ */
+uint16_t sdk_mapped_flags_next_index_get(sdk_mapped_flags_t * p_flags);
+
+
 /**@brief Function for updating the state of a flag.
  *
  * @param[in]  p_keys   The list of associated keys (assumed to have a length of
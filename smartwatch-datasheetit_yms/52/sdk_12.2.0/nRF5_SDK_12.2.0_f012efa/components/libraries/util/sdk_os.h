@@ -29,6 +29,20 @@
 extern "C" {
 #endif
 
+#define SDK_OS_NONE     0 /**< Bare metal. */
+#define SDK_OS_FREERTOS 1 /**< FreeRTOS, selected with the FREERTOS define of the build. */
+#define SDK_OS_RTX      2 /**< RTX, selected with the RTX define of the build. */
+
+#ifndef SDK_OS
+#if defined(FREERTOS)
+#define SDK_OS SDK_OS_FREERTOS
+#elif defined(RTX)
+#define SDK_OS SDK_OS_RTX
+#else
+#define SDK_OS SDK_OS_NONE
+#endif
+#endif
+
 #define SDK_MUTEX_DEFINE(X)
 #define SDK_MUTEX_INIT(X)
 #define SDK_MUTEX_LOCK(X)
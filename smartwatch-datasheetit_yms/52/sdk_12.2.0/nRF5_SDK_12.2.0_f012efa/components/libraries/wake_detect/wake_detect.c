@@ -0,0 +1,286 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(WAKE_DETECT)
+#include "wake_detect.h"
+#include "nrf_drv_lpcomp.h"
+#include "nrf_drv_ppi.h"
+#include "nrf_power.h"
+#include "app_timer.h"
+
+#define HOLD_CHANNEL    0
+#define MIN_HOLD_TICKS  2       /**< A compare value closer than 2 ticks to the cleared counter may not generate the event. */
+#define TIMESTAMP_MASK  0x00FFFFFF
+
+/**@brief References of the threshold levels, in steps of 1/16 of VDD. */
+static const nrf_lpcomp_ref_t m_levels[WAKE_DETECT_LEVELS] =
+{
+    NRF_LPCOMP_REF_SUPPLY_1_16, NRF_LPCOMP_REF_SUPPLY_1_8,  NRF_LPCOMP_REF_SUPPLY_3_16,
+    NRF_LPCOMP_REF_SUPPLY_2_8,  NRF_LPCOMP_REF_SUPPLY_5_16, NRF_LPCOMP_REF_SUPPLY_3_8,
+    NRF_LPCOMP_REF_SUPPLY_7_16, NRF_LPCOMP_REF_SUPPLY_4_8,  NRF_LPCOMP_REF_SUPPLY_9_16,
+    NRF_LPCOMP_REF_SUPPLY_5_8,  NRF_LPCOMP_REF_SUPPLY_11_16, NRF_LPCOMP_REF_SUPPLY_6_8,
+    NRF_LPCOMP_REF_SUPPLY_13_16, NRF_LPCOMP_REF_SUPPLY_7_8, NRF_LPCOMP_REF_SUPPLY_15_16,
+};
+
+static struct
+{
+    wake_detect_config_t const * p_config;
+    nrf_ppi_channel_t            ppi_up;        /**< Upward crossing to RTC clear, forked to RTC start. */
+    nrf_ppi_channel_t            ppi_down;      /**< Downward crossing to RTC stop. */
+    bool                         running;
+    uint8_t                      level;
+    uint8_t                      results;       /**< Results reported since the last calibration. */
+    uint8_t                      false_results; /**< False wakes among them. */
+    wake_detect_stats_t          stats;
+} m_cb;
+
+
+/**@brief LPCOMP handler. LPCOMP interrupts are not used. */
+static void lpcomp_handler(nrf_lpcomp_event_t event)
+{
+    UNUSED_PARAMETER(event);
+}
+
+
+/**@brief RTC handler, called when the line has stayed above the threshold for the hold time. */
+static void rtc_handler(nrf_drv_rtc_int_type_t int_type)
+{
+    nrf_drv_rtc_t const * p_rtc = m_cb.p_config->p_rtc;
+
+    if (int_type != (nrf_drv_rtc_int_type_t)HOLD_CHANNEL)
+    {
+        return;
+    }
+
+    // The counter has run since the crossing. It is stopped here if the line is still high, and
+    // cleared by the next upward crossing.
+    nrf_rtc_task_trigger(p_rtc->p_reg, NRF_RTC_TASK_STOP);
+    uint32_t elapsed   = nrf_drv_rtc_counter_get(p_rtc);
+    uint32_t timestamp = (app_timer_cnt_get() - elapsed) & TIMESTAMP_MASK;
+
+    // The driver disables the compare event after a match.
+    (void)nrf_drv_rtc_cc_set(p_rtc, HOLD_CHANNEL, m_cb.p_config->hold_ticks, true);
+
+    m_cb.stats.wakes++;
+    m_cb.p_config->handler(timestamp);
+}
+
+
+/**@brief Function for configuring LPCOMP with the current level. LPCOMP is left disabled. */
+static void lpcomp_configure(void)
+{
+    nrf_lpcomp_config_t hal =
+    {
+        .reference = m_levels[m_cb.level],
+        .detection = NRF_LPCOMP_DETECT_UP,
+        .hyst      = m_cb.p_config->hyst,
+    };
+
+    nrf_lpcomp_configure(&hal);
+    nrf_lpcomp_input_select(m_cb.p_config->input);
+}
+
+
+/**@brief Function for changing the threshold level. REFSEL can only be written while LPCOMP is
+ *        disabled, so LPCOMP is restarted if it runs.
+ */
+static void level_set(uint8_t level)
+{
+    m_cb.level       = level;
+    m_cb.stats.level = level;
+    m_cb.stats.calibrations++;
+
+    if (m_cb.running)
+    {
+        nrf_drv_lpcomp_disable();
+        lpcomp_configure();
+        nrf_drv_lpcomp_enable();
+    }
+    else
+    {
+        lpcomp_configure();
+    }
+}
+
+
+ret_code_t wake_detect_init(wake_detect_config_t const * p_config)
+{
+    ret_code_t              err_code;
+    nrf_drv_rtc_config_t    rtc_config = NRF_DRV_RTC_DEFAULT_CONFIG;
+    nrf_drv_lpcomp_config_t lpcomp_config;
+
+    VERIFY_PARAM_NOT_NULL(p_config);
+    VERIFY_PARAM_NOT_NULL(p_config->p_rtc);
+    VERIFY_PARAM_NOT_NULL(p_config->handler);
+
+    if ((p_config->level_min > p_config->level_max) || (p_config->level_max >= WAKE_DETECT_LEVELS) ||
+        (p_config->level < p_config->level_min) || (p_config->level > p_config->level_max) ||
+        (p_config->hold_ticks < MIN_HOLD_TICKS))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    memset(&m_cb, 0, sizeof(m_cb));
+    m_cb.p_config    = p_config;
+    m_cb.level       = p_config->level;
+    m_cb.stats.level = p_config->level;
+
+    err_code = nrf_drv_ppi_init();
+    if ((err_code != NRF_SUCCESS) && (err_code != NRF_ERROR_MODULE_ALREADY_INITIALIZED))
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+    if (nrf_drv_ppi_channel_alloc(&m_cb.ppi_up) != NRF_SUCCESS)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+    if (nrf_drv_ppi_channel_alloc(&m_cb.ppi_down) != NRF_SUCCESS)
+    {
+        (void)nrf_drv_ppi_channel_free(m_cb.ppi_up);
+        return NRF_ERROR_NO_MEM;
+    }
+
+    lpcomp_config.hal.reference      = m_levels[m_cb.level];
+    lpcomp_config.hal.detection      = NRF_LPCOMP_DETECT_UP;
+    lpcomp_config.hal.hyst           = p_config->hyst;
+    lpcomp_config.input              = p_config->input;
+    lpcomp_config.interrupt_priority = p_config->irq_priority;
+
+    err_code = nrf_drv_lpcomp_init(&lpcomp_config, lpcomp_handler);
+    if (err_code == NRF_SUCCESS)
+    {
+        // Crossings only reach the RTC, through PPI.
+        nrf_lpcomp_int_disable(LPCOMP_INTENSET_UP_Msk);
+
+        rtc_config.prescaler          = 0;
+        rtc_config.reliable           = false;
+        rtc_config.interrupt_priority = p_config->irq_priority;
+        err_code = nrf_drv_rtc_init(p_config->p_rtc, &rtc_config, rtc_handler);
+        if (err_code != NRF_SUCCESS)
+        {
+            nrf_drv_lpcomp_uninit();
+        }
+    }
+    if (err_code != NRF_SUCCESS)
+    {
+        (void)nrf_drv_ppi_channel_free(m_cb.ppi_up);
+        (void)nrf_drv_ppi_channel_free(m_cb.ppi_down);
+        return err_code;
+    }
+
+    (void)nrf_drv_rtc_cc_set(p_config->p_rtc, HOLD_CHANNEL, p_config->hold_ticks, true);
+
+    (void)nrf_drv_ppi_channel_assign(m_cb.ppi_up,
+                                     (uint32_t)nrf_lpcomp_event_address_get(NRF_LPCOMP_EVENT_UP),
+                                     nrf_drv_rtc_task_address_get(p_config->p_rtc,
+                                                                  NRF_RTC_TASK_CLEAR));
+    (void)nrf_drv_ppi_channel_fork_assign(m_cb.ppi_up,
+                                          nrf_drv_rtc_task_address_get(p_config->p_rtc,
+                                                                       NRF_RTC_TASK_START));
+    (void)nrf_drv_ppi_channel_assign(m_cb.ppi_down,
+                                     (uint32_t)nrf_lpcomp_event_address_get(NRF_LPCOMP_EVENT_DOWN),
+                                     nrf_drv_rtc_task_address_get(p_config->p_rtc,
+                                                                  NRF_RTC_TASK_STOP));
+
+    return NRF_SUCCESS;
+}
+
+
+void wake_detect_start(void)
+{
+    if (m_cb.running)
+    {
+        return;
+    }
+
+    nrf_drv_rtc_counter_clear(m_cb.p_config->p_rtc);
+    (void)nrf_drv_ppi_channel_enable(m_cb.ppi_up);
+    (void)nrf_drv_ppi_channel_enable(m_cb.ppi_down);
+    nrf_drv_lpcomp_enable();
+    m_cb.running = true;
+}
+
+
+void wake_detect_stop(void)
+{
+    if (!m_cb.running)
+    {
+        return;
+    }
+
+    m_cb.running = false;
+    nrf_drv_lpcomp_disable();
+    (void)nrf_drv_ppi_channel_disable(m_cb.ppi_up);
+    (void)nrf_drv_ppi_channel_disable(m_cb.ppi_down);
+    nrf_rtc_task_trigger(m_cb.p_config->p_rtc->p_reg, NRF_RTC_TASK_STOP);
+    nrf_drv_rtc_counter_clear(m_cb.p_config->p_rtc);
+}
+
+
+void wake_detect_result_report(bool real)
+{
+    if (!real)
+    {
+        m_cb.false_results++;
+        m_cb.stats.false_wakes++;
+    }
+    if (++m_cb.results < WAKE_DETECT_CONFIG_CALIB_WAKES)
+    {
+        return;
+    }
+
+    uint32_t false_pct = (uint32_t)m_cb.false_results * 100 / m_cb.results;
+
+    if ((false_pct > WAKE_DETECT_CONFIG_FALSE_HIGH_PCT) && (m_cb.level < m_cb.p_config->level_max))
+    {
+        level_set(m_cb.level + 1);
+    }
+    else if ((false_pct < WAKE_DETECT_CONFIG_FALSE_LOW_PCT) && (m_cb.level > m_cb.p_config->level_min))
+    {
+        level_set(m_cb.level - 1);
+    }
+
+    m_cb.results       = 0;
+    m_cb.false_results = 0;
+}
+
+
+void wake_detect_stats_get(wake_detect_stats_t * p_stats)
+{
+    ASSERT(p_stats != NULL);
+
+    *p_stats = m_cb.stats;
+}
+
+
+void wake_detect_system_off_prepare(void)
+{
+    wake_detect_stop();
+
+    // ANADETECT is set for upward crossings, which wake the chip from System OFF.
+    nrf_lpcomp_event_clear(NRF_LPCOMP_EVENT_UP);
+    nrf_drv_lpcomp_enable();
+}
+
+
+bool wake_detect_reset_check(void)
+{
+    bool wake = ((nrf_power_resetreas_get() & NRF_POWER_RESETREAS_LPCOMP_MASK) != 0);
+
+    if (wake)
+    {
+        nrf_power_resetreas_clear(NRF_POWER_RESETREAS_LPCOMP_MASK);
+    }
+    return wake;
+}
+
+#endif // NRF_MODULE_ENABLED(WAKE_DETECT)
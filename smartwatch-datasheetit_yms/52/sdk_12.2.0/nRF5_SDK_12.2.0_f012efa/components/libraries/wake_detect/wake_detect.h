@@ -0,0 +1,159 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup wake_detect Wake detection
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for detecting a wrist raise on an analog line with LPCOMP, without polling.
+ *
+ * @details The analog output of a motion or PPG sensor, or its interrupt line, is compared by
+ *          LPCOMP with a fraction of VDD. An upward crossing clears and starts a dedicated RTC
+ *          through PPI, and a downward crossing stops it. The compare interrupt of the RTC is the
+ *          only interrupt used: the CPU wakes only when the line has stayed above the threshold
+ *          for the hold time. The RTC counter then gives the time of the crossing, independent of
+ *          the interrupt latency.
+ *
+ *          After a wake, the application tells with @ref wake_detect_result_report whether it was
+ *          a real wrist raise. Every @ref WAKE_DETECT_CONFIG_CALIB_WAKES results, the threshold is
+ *          raised by one step if too many wakes were false, and lowered by one step if almost none
+ *          were, to recover sensitivity.
+ *
+ *          In System OFF, the upward crossing of LPCOMP wakes the chip instead, see
+ *          @ref wake_detect_system_off_prepare.
+ *
+ * @note The module uses the app_timer counter for the time stamps.
+ */
+
+#ifndef WAKE_DETECT_H__
+#define WAKE_DETECT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nrf_drv_rtc.h"
+#include "nrf_lpcomp.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of reported wakes the threshold is recalibrated over.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef WAKE_DETECT_CONFIG_CALIB_WAKES
+#define WAKE_DETECT_CONFIG_CALIB_WAKES 16
+#endif
+
+/** @brief Share of false wakes above which the threshold is raised, in percent.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef WAKE_DETECT_CONFIG_FALSE_HIGH_PCT
+#define WAKE_DETECT_CONFIG_FALSE_HIGH_PCT 25
+#endif
+
+/** @brief Share of false wakes below which the threshold is lowered, in percent.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef WAKE_DETECT_CONFIG_FALSE_LOW_PCT
+#define WAKE_DETECT_CONFIG_FALSE_LOW_PCT 5
+#endif
+
+/** @brief Number of threshold levels, from 1/16 to 15/16 of VDD. */
+#define WAKE_DETECT_LEVELS 15
+
+/**@brief Wake handler type. Called from the RTC interrupt.
+ *
+ * @param[in] timestamp Time of the upward crossing, in app_timer ticks.
+ */
+typedef void (* wake_detect_handler_t)(uint32_t timestamp);
+
+/**@brief Configuration of the module. */
+typedef struct
+{
+    nrf_drv_rtc_t const *   p_rtc;         /**< RTC instance that times the crossings. Must not be initialized. */
+    nrf_lpcomp_input_t      input;         /**< Analog input of the line. */
+    nrf_lpcomp_hysteresis_t hyst;          /**< LPCOMP hysteresis. */
+    uint8_t                 level;         /**< First threshold level: (level + 1)/16 of VDD. */
+    uint8_t                 level_min;     /**< Lowest level the calibration can set. */
+    uint8_t                 level_max;     /**< Highest level the calibration can set. */
+    uint16_t                hold_ticks;    /**< Time the line must stay above the threshold, in 1/32768 s. At least 2. */
+    uint8_t                 irq_priority;  /**< Interrupt priority of the RTC and LPCOMP. */
+    wake_detect_handler_t   handler;       /**< Wake handler. */
+} wake_detect_config_t;
+
+/**@brief Statistics of the module. */
+typedef struct
+{
+    uint32_t wakes;        /**< Qualified wakes. */
+    uint32_t false_wakes;  /**< Wakes reported as false. */
+    uint32_t calibrations; /**< Changes of the threshold made by the calibration. */
+    uint8_t  level;        /**< Current threshold level. */
+} wake_detect_stats_t;
+
+/**@brief Function for initializing the module. Detection is not started.
+ *
+ * @param[in] p_config Configuration. Must stay valid while the module is initialized.
+ *
+ * @retval NRF_SUCCESS             If the module was initialized.
+ * @retval NRF_ERROR_NULL          If a NULL pointer was passed.
+ * @retval NRF_ERROR_INVALID_PARAM If a level or the hold time was invalid.
+ * @retval NRF_ERROR_NO_MEM        If no PPI channels were available.
+ * @return Any error returned by the LPCOMP or RTC driver.
+ */
+ret_code_t wake_detect_init(wake_detect_config_t const * p_config);
+
+/**@brief Function for starting detection. */
+void wake_detect_start(void);
+
+/**@brief Function for stopping detection. */
+void wake_detect_stop(void);
+
+/**@brief Function for reporting whether the last wake was a real wrist raise.
+ *
+ * @details The threshold is recalibrated every @ref WAKE_DETECT_CONFIG_CALIB_WAKES results.
+ *
+ * @param[in] real True if the wake was a wrist raise.
+ */
+void wake_detect_result_report(bool real);
+
+/**@brief Function for getting the statistics of the module.
+ *
+ * @param[out] p_stats Statistics.
+ */
+void wake_detect_stats_get(wake_detect_stats_t * p_stats);
+
+/**@brief Function for preparing the wake from System OFF on an upward crossing.
+ *
+ * @details Detection is stopped, and LPCOMP is left running with the current threshold. There is
+ *          no hold time in System OFF. The application then enters System OFF.
+ */
+void wake_detect_system_off_prepare(void);
+
+/**@brief Function for checking if the last reset was a wake from System OFF by LPCOMP.
+ *
+ * @details The reset reason is cleared. Must be called before the SoftDevice is enabled.
+ */
+bool wake_detect_reset_check(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WAKE_DETECT_H__
+
+/** @} */
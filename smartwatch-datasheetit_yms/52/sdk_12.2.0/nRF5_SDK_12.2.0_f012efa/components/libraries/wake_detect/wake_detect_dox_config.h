@@ -0,0 +1,36 @@
+/**
+ *
+ * @defgroup wake_detect_config Wake detection configuration
+ * @{
+ * @ingroup wake_detect
+ */
+/** @brief Enabling the wake detection
+ *
+ *  Requires the LPCOMP, RTC and PPI drivers, and app_timer.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define WAKE_DETECT_ENABLED
+
+/** @brief Number of reported wakes the threshold is recalibrated over.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define WAKE_DETECT_CONFIG_CALIB_WAKES
+
+/** @brief Share of false wakes above which the threshold is raised, in percent.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define WAKE_DETECT_CONFIG_FALSE_HIGH_PCT
+
+/** @brief Share of false wakes below which the threshold is lowered, in percent.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define WAKE_DETECT_CONFIG_FALSE_LOW_PCT
+
+
+/** @} */
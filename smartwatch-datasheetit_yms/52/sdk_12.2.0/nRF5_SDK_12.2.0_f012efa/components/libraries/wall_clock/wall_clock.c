@@ -0,0 +1,313 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(WALL_CLOCK)
+#include "wall_clock.h"
+#include "nrf_drv_rtc.h"
+#include "nrf_rtc.h"
+
+#define TICKS_PER_SECOND   32768
+#define TICKS_PER_MINUTE   (60 * TICKS_PER_SECOND)
+#define TICKS_PER_FRACTION (TICKS_PER_SECOND / 256)
+#define COUNTER_BITS       24
+#define MINUTE_CHANNEL     0
+#define CORRECTION_SHIFT   32                        /**< The rate correction is in Q32 format. */
+#define MAX_CORRECTION     (((int64_t)WALL_CLOCK_CONFIG_MAX_DRIFT_PPM << CORRECTION_SHIFT) / 1000000)
+#define SECONDS_PER_DAY    86400
+
+static const nrf_drv_rtc_t m_rtc = NRF_DRV_RTC_INSTANCE(WALL_CLOCK_CONFIG_RTC_INSTANCE);
+
+static struct
+{
+    wall_clock_minute_handler_t minute_handler;
+    uint32_t                    overflows;
+    uint64_t                    last_raw;        /**< Last counter value read, to detect an overflow that is being handled. */
+    uint64_t                    base_raw;        /**< Counter value when the time was last set. */
+    uint64_t                    base_time;       /**< Time when it was last set, in ticks. */
+    int64_t                     correction;      /**< Rate correction of the counter, in Q32 format. */
+    bool                        set;
+    bool                        drift_estimated;
+    bool                        ref_valid;
+    uint64_t                    ref_raw;         /**< Counter value at the reference the drift is measured from. */
+    int64_t                     ref_steps;       /**< Sum of the time steps made since that reference, in ticks. */
+    uint64_t                    next_minute;     /**< Time of the minute boundary the compare channel is set for, in ticks. */
+} m_cb;
+
+
+/**@brief Function for reading the counter, extended with the overflows. */
+static uint64_t raw_ticks_get(void)
+{
+    uint64_t raw;
+
+    CRITICAL_REGION_ENTER();
+    uint32_t overflows = m_cb.overflows;
+    uint32_t counter   = nrf_drv_rtc_counter_get(&m_rtc);
+
+    if (nrf_rtc_event_pending(m_rtc.p_reg, NRF_RTC_EVENT_OVERFLOW))
+    {
+        // The overflow has not been counted yet. The counter is read again, since the first read
+        // may have been before the overflow.
+        counter = nrf_drv_rtc_counter_get(&m_rtc);
+        overflows++;
+    }
+
+    raw = ((uint64_t)overflows << COUNTER_BITS) | counter;
+    if (raw < m_cb.last_raw)
+    {
+        // The overflow event has been cleared, but not counted yet.
+        raw += (1UL << COUNTER_BITS);
+    }
+    m_cb.last_raw = raw;
+    CRITICAL_REGION_EXIT();
+
+    return raw;
+}
+
+
+/**@brief Function for getting the corrected time in ticks at a counter value. */
+static uint64_t time_ticks_at(uint64_t raw)
+{
+    uint64_t elapsed = raw - m_cb.base_raw;
+
+    return m_cb.base_time + elapsed + ((int64_t)elapsed * m_cb.correction >> CORRECTION_SHIFT);
+}
+
+
+/**@brief Function for setting the compare channel to a minute boundary.
+ *
+ * @return False if the boundary was reached before the channel was set.
+ */
+static bool minute_arm(uint64_t minute)
+{
+    uint64_t raw   = raw_ticks_get();
+    uint64_t now   = time_ticks_at(raw);
+    int64_t  delta = (int64_t)(minute - now);
+
+    if (delta <= 0)
+    {
+        return false;
+    }
+
+    // Counter ticks to the boundary: the inverse of the correction, to first order.
+    delta -= delta * m_cb.correction >> CORRECTION_SHIFT;
+    // A compare value closer than 2 ticks to the counter may not generate the event.
+    delta  = MAX(delta, 3);
+
+    m_cb.next_minute = minute;
+    return (nrf_drv_rtc_cc_set(&m_rtc, MINUTE_CHANNEL, (uint32_t)(raw + delta), true) == NRF_SUCCESS);
+}
+
+
+/**@brief Function for setting the compare channel to the next minute, or calling the handler for
+ *        the minutes that were reached before it could be set.
+ */
+static void minute_schedule(uint64_t minute)
+{
+    while (!minute_arm(minute))
+    {
+        if (m_cb.minute_handler != NULL)
+        {
+            m_cb.minute_handler((uint32_t)(minute / TICKS_PER_SECOND));
+        }
+        minute += TICKS_PER_MINUTE;
+    }
+}
+
+
+static void rtc_handler(nrf_drv_rtc_int_type_t int_type)
+{
+    if (int_type == NRF_DRV_RTC_INT_OVERFLOW)
+    {
+        m_cb.overflows++;
+    }
+    else if ((int_type == (nrf_drv_rtc_int_type_t)MINUTE_CHANNEL) && m_cb.set)
+    {
+        uint64_t minute = m_cb.next_minute;
+
+        if (time_ticks_at(raw_ticks_get()) + TICKS_PER_FRACTION < minute)
+        {
+            // Woken too early by the rounding of the counter ticks.
+            minute_schedule(minute);
+            return;
+        }
+
+        minute_schedule(minute + TICKS_PER_MINUTE);
+        if (m_cb.minute_handler != NULL)
+        {
+            m_cb.minute_handler((uint32_t)(minute / TICKS_PER_SECOND));
+        }
+    }
+}
+
+
+/**@brief Function for updating the drift estimate with a new reference time. */
+static void drift_update(uint64_t raw, int64_t error)
+{
+    uint64_t interval = raw - m_cb.ref_raw;
+    int64_t  total    = m_cb.ref_steps + error;
+
+    if (interval < (uint64_t)WALL_CLOCK_CONFIG_DRIFT_INTERVAL_S * TICKS_PER_SECOND)
+    {
+        m_cb.ref_steps = total;
+        return;
+    }
+
+    // An error larger than the largest drift means that the reference or the clock has stepped.
+    int64_t max_error = (int64_t)(interval * WALL_CLOCK_CONFIG_MAX_DRIFT_PPM / 1000000);
+    if ((total <= max_error) && (total >= -max_error))
+    {
+        int64_t residual = total * ((int64_t)1 << CORRECTION_SHIFT) / (int64_t)interval;
+
+        if (m_cb.drift_estimated)
+        {
+            residual /= (1 << WALL_CLOCK_CONFIG_DRIFT_SHIFT);
+        }
+        m_cb.correction     += residual;
+        m_cb.correction      = MIN(m_cb.correction, MAX_CORRECTION);
+        m_cb.correction      = MAX(m_cb.correction, -MAX_CORRECTION);
+        m_cb.drift_estimated = true;
+    }
+
+    m_cb.ref_raw   = raw;
+    m_cb.ref_steps = 0;
+}
+
+
+ret_code_t wall_clock_init(wall_clock_minute_handler_t minute_handler)
+{
+    ret_code_t           err_code;
+    nrf_drv_rtc_config_t config = NRF_DRV_RTC_DEFAULT_CONFIG;
+
+    memset(&m_cb, 0, sizeof(m_cb));
+    m_cb.minute_handler = minute_handler;
+
+    config.prescaler          = 0;
+    config.interrupt_priority = WALL_CLOCK_CONFIG_IRQ_PRIORITY;
+    // The driver reports a compare value that was passed while it was set.
+    config.reliable           = true;
+    config.tick_latency       = RTC_US_TO_TICKS(NRF_MAXIMUM_LATENCY_US, TICKS_PER_SECOND);
+
+    err_code = nrf_drv_rtc_init(&m_rtc, &config, rtc_handler);
+    VERIFY_SUCCESS(err_code);
+
+    nrf_drv_rtc_overflow_enable(&m_rtc, true);
+    nrf_drv_rtc_enable(&m_rtc);
+
+    return NRF_SUCCESS;
+}
+
+
+void wall_clock_sync(uint32_t time, uint8_t fractions256, bool reference)
+{
+    uint64_t synced = (uint64_t)time * TICKS_PER_SECOND + fractions256 * TICKS_PER_FRACTION;
+    uint64_t minute;
+
+    CRITICAL_REGION_ENTER();
+    uint64_t raw = raw_ticks_get();
+
+    if (reference && m_cb.set && m_cb.ref_valid)
+    {
+        drift_update(raw, (int64_t)(synced - time_ticks_at(raw)));
+    }
+    else if (reference)
+    {
+        m_cb.ref_valid = true;
+        m_cb.ref_raw   = raw;
+        m_cb.ref_steps = 0;
+    }
+    else
+    {
+        m_cb.ref_valid = false;
+    }
+
+    m_cb.base_raw  = raw;
+    m_cb.base_time = synced;
+    m_cb.set       = true;
+    CRITICAL_REGION_EXIT();
+
+    minute = (synced / TICKS_PER_MINUTE + 1) * TICKS_PER_MINUTE;
+    minute_schedule(minute);
+}
+
+
+bool wall_clock_is_set(void)
+{
+    return m_cb.set;
+}
+
+
+uint32_t wall_clock_time_get(uint8_t * p_fractions256)
+{
+    uint64_t now;
+
+    CRITICAL_REGION_ENTER();
+    now = time_ticks_at(raw_ticks_get());
+    CRITICAL_REGION_EXIT();
+
+    if (p_fractions256 != NULL)
+    {
+        *p_fractions256 = (uint8_t)((now % TICKS_PER_SECOND) / TICKS_PER_FRACTION);
+    }
+    return (uint32_t)(now / TICKS_PER_SECOND);
+}
+
+
+int32_t wall_clock_drift_get(void)
+{
+    return (int32_t)(m_cb.correction * 1000000000 >> CORRECTION_SHIFT);
+}
+
+
+void wall_clock_to_date_time(uint32_t time, ble_date_time_t * p_date_time, uint8_t * p_day_of_week)
+{
+    uint32_t days    = time / SECONDS_PER_DAY;
+    uint32_t seconds = time % SECONDS_PER_DAY;
+
+    p_date_time->hours   = seconds / 3600;
+    p_date_time->minutes = (seconds / 60) % 60;
+    p_date_time->seconds = seconds % 60;
+
+    if (p_day_of_week != NULL)
+    {
+        // 1970-01-01 was a Thursday.
+        *p_day_of_week = ((days + 3) % 7) + 1;
+    }
+
+    // Civil date from the day number, with years starting in March so that the leap day is last.
+    uint32_t z   = days + 719468;
+    uint32_t era = z / 146097;
+    uint32_t doe = z - era * 146097;
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    uint32_t mp  = (5 * doy + 2) / 153;
+
+    p_date_time->day   = doy - (153 * mp + 2) / 5 + 1;
+    p_date_time->month = (mp < 10) ? (mp + 3) : (mp - 9);
+    p_date_time->year  = yoe + era * 400 + ((p_date_time->month <= 2) ? 1 : 0);
+}
+
+
+uint32_t wall_clock_from_date_time(ble_date_time_t const * p_date_time)
+{
+    uint32_t year  = p_date_time->year - ((p_date_time->month <= 2) ? 1 : 0);
+    uint32_t month = p_date_time->month;
+    uint32_t era   = year / 400;
+    uint32_t yoe   = year - era * 400;
+    uint32_t doy   = (153 * ((month > 2) ? (month - 3) : (month + 9)) + 2) / 5 + p_date_time->day - 1;
+    uint32_t doe   = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    uint32_t days  = era * 146097 + doe - 719468;
+
+    return days * SECONDS_PER_DAY +
+           p_date_time->hours * 3600 + p_date_time->minutes * 60 + p_date_time->seconds;
+}
+
+#endif // NRF_MODULE_ENABLED(WALL_CLOCK)
@@ -0,0 +1,158 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup wall_clock Wall clock
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for keeping the time of day with an RTC, corrected for the drift of the LFCLK.
+ *
+ * @details The time is counted by an RTC instance without prescaler, extended to 64 bits with
+ *          its overflow interrupt. It is set with @ref wall_clock_sync, for example from the
+ *          Current Time read by @ref ble_cts_c. The difference between successive reference
+ *          times and the counted time, over at least @ref WALL_CLOCK_CONFIG_DRIFT_INTERVAL_S,
+ *          gives the drift of the clock source. The counted time is then corrected with a
+ *          fixed-point rate, applied when the time is read, so no wakeup is needed for it.
+ *
+ *          A compare channel of the RTC is set to the next minute boundary of the corrected time,
+ *          and the minute handler is called from its interrupt. A display of the time is then
+ *          updated once a minute, when the minute changes.
+ *
+ *          Times are in seconds since 1970-01-01 00:00:00, in the time zone of the reference.
+ */
+
+#ifndef WALL_CLOCK_H__
+#define WALL_CLOCK_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_date_time.h"
+#include "app_util_platform.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief RTC instance used by the module.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef WALL_CLOCK_CONFIG_RTC_INSTANCE
+#define WALL_CLOCK_CONFIG_RTC_INSTANCE 2
+#endif
+
+/** @brief Interrupt priority of the RTC.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef WALL_CLOCK_CONFIG_IRQ_PRIORITY
+#define WALL_CLOCK_CONFIG_IRQ_PRIORITY APP_IRQ_PRIORITY_LOW
+#endif
+
+/** @brief Shortest time between two reference times used to estimate the drift, in seconds.
+ *
+ * The reference from @ref ble_cts_c has a resolution of 1/256 s, so one hour gives about 1 ppm.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef WALL_CLOCK_CONFIG_DRIFT_INTERVAL_S
+#define WALL_CLOCK_CONFIG_DRIFT_INTERVAL_S 3600
+#endif
+
+/** @brief Largest drift that is corrected, in ppm. A larger difference is taken as a time step.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef WALL_CLOCK_CONFIG_MAX_DRIFT_PPM
+#define WALL_CLOCK_CONFIG_MAX_DRIFT_PPM 500
+#endif
+
+/** @brief Weight of a new drift estimate after the first one, as a shift: 1/2^shift.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef WALL_CLOCK_CONFIG_DRIFT_SHIFT
+#define WALL_CLOCK_CONFIG_DRIFT_SHIFT 1
+#endif
+
+/**@brief Minute handler type.
+ *
+ * @param[in] time Time of the minute that has started.
+ */
+typedef void (* wall_clock_minute_handler_t)(uint32_t time);
+
+/**@brief Function for initializing the module and starting the RTC.
+ *
+ * @param[in] minute_handler Handler called at every minute once the time is set, or NULL. Called
+ *                           from the RTC interrupt, or from @ref wall_clock_sync if the time is
+ *                           set right at the end of a minute.
+ *
+ * @return Any error returned by @ref nrf_drv_rtc_init.
+ */
+ret_code_t wall_clock_init(wall_clock_minute_handler_t minute_handler);
+
+/**@brief Function for setting the time.
+ *
+ * @param[in] time         Time, in seconds.
+ * @param[in] fractions256 Fraction of the second, in 1/256 s.
+ * @param[in] reference    True if the time comes from an accurate reference and is used to
+ *                         estimate the drift. False if it might not be accurate, for example if it
+ *                         was set by the user or changed for the time zone. The drift estimation
+ *                         then starts again from the next reference.
+ */
+void wall_clock_sync(uint32_t time, uint8_t fractions256, bool reference);
+
+/**@brief Function for checking if the time has been set.
+ */
+bool wall_clock_is_set(void);
+
+/**@brief Function for getting the time.
+ *
+ * @param[out] p_fractions256 Fraction of the second, in 1/256 s, or NULL.
+ *
+ * @return Time, in seconds. Counted from 0 if the time has not been set.
+ */
+uint32_t wall_clock_time_get(uint8_t * p_fractions256);
+
+/**@brief Function for getting the correction of the drift of the clock source.
+ *
+ * @return Correction in parts per billion: positive if the clock source is slow.
+ */
+int32_t wall_clock_drift_get(void);
+
+/**@brief Function for converting a time to a date.
+ *
+ * @param[in]  time          Time, in seconds.
+ * @param[out] p_date_time   Date and time.
+ * @param[out] p_day_of_week Day of the week, 1 for Monday to 7 for Sunday as in the Current Time
+ *                           Service, or NULL.
+ */
+void wall_clock_to_date_time(uint32_t time, ble_date_time_t * p_date_time, uint8_t * p_day_of_week);
+
+/**@brief Function for converting a date to a time.
+ *
+ * @param[in] p_date_time Date and time, from 1970 on.
+ *
+ * @return Time, in seconds.
+ */
+uint32_t wall_clock_from_date_time(ble_date_time_t const * p_date_time);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WALL_CLOCK_H__
+
+/** @} */
@@ -0,0 +1,48 @@
+/**
+ *
+ * @defgroup wall_clock_config Wall clock configuration
+ * @{
+ * @ingroup wall_clock
+ */
+/** @brief Enabling the wall clock module
+ *
+ *  Requires the RTC driver, with the instance set by WALL_CLOCK_CONFIG_RTC_INSTANCE enabled.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define WALL_CLOCK_ENABLED
+
+/** @brief RTC instance used by the module.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define WALL_CLOCK_CONFIG_RTC_INSTANCE
+
+/** @brief Interrupt priority of the RTC.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define WALL_CLOCK_CONFIG_IRQ_PRIORITY
+
+/** @brief Shortest time between two reference times used to estimate the drift, in seconds.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define WALL_CLOCK_CONFIG_DRIFT_INTERVAL_S
+
+/** @brief Largest drift that is corrected, in ppm.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define WALL_CLOCK_CONFIG_MAX_DRIFT_PPM
+
+/** @brief Weight of a new drift estimate after the first one, as a shift.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define WALL_CLOCK_CONFIG_DRIFT_SHIFT
+
+
+/** @} */
@@ -0,0 +1,212 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(NRF_WARM_BOOT)
+#include "nrf_warm_boot.h"
+#include "crc32.h"
+#include "app_util_platform.h"
+#include <string.h>
+
+/**
+ * The area holds a header and a list of entries. Every entry is a header word with the identifier
+ * and the size, the CRC32 of the data, and the data, padded to a word:
+ *
+ *    ----------------------------------------
+ *    |   ID  |  SIZE |  CRC  | DATA ...     |
+ *    | 31:16 |  15:0 |       | CEIL(SIZE/4) |
+ *    ----------------------------------------
+ */
+#define WARM_BOOT_MAGIC         0x4D524157                  // "WARM", the area was saved.
+#define WARM_BOOT_AREA_WORDS    (NRF_WARM_BOOT_AREA_SIZE / sizeof(uint32_t))
+#define WARM_BOOT_ENTRY_WORDS   2                           // Words of an entry before the data.
+#define WARM_BOOT_ID_INVALID    0xFFFF
+
+#if defined(__CC_ARM)
+#define WARM_BOOT_NOINIT        __attribute__((section(".bss.noinit"), zero_init))
+#elif defined(__ICCARM__)
+#define WARM_BOOT_NOINIT        __no_init
+#else
+#define WARM_BOOT_NOINIT        __attribute__((section(".noinit")))
+#endif
+
+STATIC_ASSERT((NRF_WARM_BOOT_AREA_SIZE % sizeof(uint32_t)) == 0);
+
+typedef struct
+{
+    uint32_t magic;                         // WARM_BOOT_MAGIC if the area was saved.
+    uint32_t words;                         // Words used by the entries.
+    uint32_t buffer[WARM_BOOT_AREA_WORDS];
+} warm_boot_area_t;
+
+static WARM_BOOT_NOINIT warm_boot_area_t m_area;
+
+static nrf_warm_boot_blob_t const * m_blobs[NRF_WARM_BOOT_MAX_BLOBS]; // Registered blobs.
+static uint32_t                     m_blob_count;
+static bool                         m_warm;                           // The area holds the blobs of the previous boot.
+
+
+/**@brief Function for finding the entry of a blob in the area.
+ *
+ * @return Index of the entry in the buffer, or WARM_BOOT_AREA_WORDS if not found.
+ */
+static uint32_t entry_find(uint16_t id)
+{
+    uint32_t idx = 0;
+
+    while (idx + WARM_BOOT_ENTRY_WORDS <= m_area.words)
+    {
+        uint32_t header = m_area.buffer[idx];
+
+        if ((header >> 16) == id)
+        {
+            return idx;
+        }
+        idx += WARM_BOOT_ENTRY_WORDS + CEIL_DIV(header & 0xFFFF, sizeof(uint32_t));
+    }
+    return WARM_BOOT_AREA_WORDS;
+}
+
+
+bool nrf_warm_boot_init(void)
+{
+    // The area is of one boot only. It is saved again by nrf_warm_boot_save().
+    m_warm = ((NRF_POWER->RESETREAS & NRF_WARM_BOOT_RESET_REASONS) != 0) &&
+             (m_area.magic == WARM_BOOT_MAGIC) &&
+             (m_area.words <= WARM_BOOT_AREA_WORDS);
+
+    m_area.magic = 0;
+    if (!m_warm)
+    {
+        m_area.words = 0;
+    }
+    return m_warm;
+}
+
+
+bool nrf_warm_boot_is_warm(void)
+{
+    return m_warm;
+}
+
+
+ret_code_t nrf_warm_boot_register(nrf_warm_boot_blob_t const * p_blob)
+{
+    uint32_t words = 0;
+
+    for (uint32_t i = 0; i < m_blob_count; i++)
+    {
+        if (m_blobs[i]->id == p_blob->id)
+        {
+            return NRF_SUCCESS;
+        }
+        words += WARM_BOOT_ENTRY_WORDS + CEIL_DIV(m_blobs[i]->size, sizeof(uint32_t));
+    }
+
+    if (m_blob_count == NRF_WARM_BOOT_MAX_BLOBS)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    words += WARM_BOOT_ENTRY_WORDS + CEIL_DIV(p_blob->size, sizeof(uint32_t));
+    if ((words > WARM_BOOT_AREA_WORDS) || (p_blob->id == WARM_BOOT_ID_INVALID))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    m_blobs[m_blob_count++] = p_blob;
+    return NRF_SUCCESS;
+}
+
+
+void const * nrf_warm_boot_get(uint16_t id, uint16_t size)
+{
+    uint32_t idx;
+    uint32_t crc;
+
+    if (!m_warm)
+    {
+        return NULL;
+    }
+
+    idx = entry_find(id);
+    if ((idx == WARM_BOOT_AREA_WORDS) || ((m_area.buffer[idx] & 0xFFFF) != size) ||
+        (idx + WARM_BOOT_ENTRY_WORDS + CEIL_DIV(size, sizeof(uint32_t)) > m_area.words))
+    {
+        return NULL;
+    }
+
+    crc = crc32_compute((uint8_t const *)&m_area.buffer[idx + WARM_BOOT_ENTRY_WORDS], size, NULL);
+    if (crc != m_area.buffer[idx + 1])
+    {
+        return NULL;
+    }
+    return &m_area.buffer[idx + WARM_BOOT_ENTRY_WORDS];
+}
+
+
+void nrf_warm_boot_invalidate(uint16_t id)
+{
+    uint32_t idx;
+
+    CRITICAL_REGION_ENTER();
+    idx = entry_find(id);
+    if (idx != WARM_BOOT_AREA_WORDS)
+    {
+        // Keep the size, so that the entries after this one can still be found.
+        m_area.buffer[idx] |= (uint32_t)WARM_BOOT_ID_INVALID << 16;
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+
+ret_code_t nrf_warm_boot_save(void)
+{
+    m_warm       = false;
+    m_area.magic = 0;
+    m_area.words = 0;
+
+    for (uint32_t i = 0; i < m_blob_count; i++)
+    {
+        nrf_warm_boot_blob_t const * p_blob = m_blobs[i];
+        uint32_t             const   idx    = m_area.words;
+        void                       * p_data = &m_area.buffer[idx + WARM_BOOT_ENTRY_WORDS];
+
+        // The blob is saved and made visible to nrf_warm_boot_invalidate() atomically.
+        CRITICAL_REGION_ENTER();
+        bool saved = p_blob->save(p_data);
+        if (saved)
+        {
+            m_area.buffer[idx + 1] = crc32_compute(p_data, p_blob->size, NULL);
+            m_area.buffer[idx]     = ((uint32_t)p_blob->id << 16) | p_blob->size;
+            m_area.words          += WARM_BOOT_ENTRY_WORDS + CEIL_DIV(p_blob->size, sizeof(uint32_t));
+        }
+        CRITICAL_REGION_EXIT();
+
+        if (!saved)
+        {
+            m_area.words = 0;
+            return NRF_ERROR_BUSY;
+        }
+    }
+
+    m_area.magic = WARM_BOOT_MAGIC;
+    return NRF_SUCCESS;
+}
+
+
+void nrf_warm_boot_reset(void)
+{
+    (void)nrf_warm_boot_save();
+    NVIC_SystemReset();
+}
+
+#endif // NRF_MODULE_ENABLED(NRF_WARM_BOOT)
@@ -0,0 +1,183 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**@file
+ *
+ * @defgroup nrf_warm_boot Warm boot
+ * @{
+ * @ingroup  app_common
+ * @brief    Module for keeping the state of other modules in RAM across a reset.
+ *
+ * @details A module that rebuilds state at startup, for example by scanning flash, can register
+ *          a blob with @ref nrf_warm_boot_register. When the application calls
+ *          @ref nrf_warm_boot_save, the save function of every blob copies the state into an area
+ *          of RAM that is not initialized at startup, and the blob is protected with a CRC32.
+ *          After a soft reset, a watchdog reset or a lockup, the module gets its blob back with
+ *          @ref nrf_warm_boot_get and can skip the rebuild. After any other reset, or if a blob
+ *          is not valid, @ref nrf_warm_boot_get fails and the module initializes as before.
+ *
+ *          The saved blobs are used by one boot only. A module must call
+ *          @ref nrf_warm_boot_invalidate before it changes the state of its blob, so that a reset
+ *          before the next save does not restore old state. The save function can refuse to save,
+ *          for example while an operation is in progress. The blobs are saved together: if one
+ *          refuses, none is saved, so that modules which depend on each other (for example the
+ *          peer IDs and the records in flash) restore state of the same moment.
+ *
+ *          To also skip the rebuild after a watchdog reset, call @ref nrf_warm_boot_save when the
+ *          state has changed and the system is idle, for example from the main loop.
+ *
+ * @note The area is placed in section ".noinit" (GCC), ".bss.noinit" (Keil) or declared with
+ *       __no_init (IAR). The linker configuration must place this section in RAM that is not
+ *       cleared by the startup code.
+ * @note This module uses @ref crc32, which must be enabled.
+ */
+
+#ifndef NRF_WARM_BOOT_H__
+#define NRF_WARM_BOOT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+#include "nrf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**@brief Size of the retained area, in bytes. Every blob takes 8 bytes in addition to its size,
+ *        rounded up to a multiple of 4.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef NRF_WARM_BOOT_AREA_SIZE
+#define NRF_WARM_BOOT_AREA_SIZE     1024
+#endif
+
+/**@brief Maximum number of registered blobs.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef NRF_WARM_BOOT_MAX_BLOBS
+#define NRF_WARM_BOOT_MAX_BLOBS     4
+#endif
+
+/**@brief Reset reasons (bits of RESETREAS) after which the saved blobs are used.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef NRF_WARM_BOOT_RESET_REASONS
+#define NRF_WARM_BOOT_RESET_REASONS (POWER_RESETREAS_SREQ_Msk | POWER_RESETREAS_DOG_Msk | \
+                                     POWER_RESETREAS_LOCKUP_Msk)
+#endif
+
+/**@brief Identifiers of the blobs of the SDK modules.
+ * @{ */
+#define NRF_WARM_BOOT_ID_FDS        0x0001  /**< Page information and index of @ref fds. */
+#define NRF_WARM_BOOT_ID_PEER_ID    0x0002  /**< Used peer IDs of @ref peer_manager. */
+#define NRF_WARM_BOOT_ID_APP_BASE   0x8000  /**< First identifier for the application. */
+/** @} */
+
+/**@brief Function for copying the state of a module into its blob.
+ *
+ * @details Called with interrupts disabled.
+ *
+ * @param[out] p_blob   Blob, with the size given at registration.
+ *
+ * @retval true  If the blob was written.
+ * @retval false If the state cannot be saved now. No blob is stored.
+ */
+typedef bool (*nrf_warm_boot_save_t)(void * p_blob);
+
+/**@brief A blob. */
+typedef struct
+{
+    uint16_t             id;   /**< Identifier. */
+    uint16_t             size; /**< Size, in bytes. */
+    nrf_warm_boot_save_t save; /**< Save function. */
+} nrf_warm_boot_blob_t;
+
+
+/**@brief Function for initializing the module.
+ *
+ * @details Decides whether this is a warm boot: the reset reason is one of
+ *          @ref NRF_WARM_BOOT_RESET_REASONS and the area was saved. Must be called before the
+ *          modules that use the blobs are initialized, and before RESETREAS is cleared.
+ *
+ * @retval true  If this is a warm boot.
+ * @retval false If this is a cold boot.
+ */
+bool nrf_warm_boot_init(void);
+
+
+/**@brief Function for checking whether this is a warm boot.
+ *
+ * @retval true  If the saved blobs can be used.
+ * @retval false If this is a cold boot, or the blobs have been overwritten by a save.
+ */
+bool nrf_warm_boot_is_warm(void);
+
+
+/**@brief Function for registering a blob.
+ *
+ * @param[in] p_blob   Blob. Must stay valid.
+ *
+ * @retval NRF_SUCCESS             If the blob was registered, or was already registered.
+ * @retval NRF_ERROR_NO_MEM        If @ref NRF_WARM_BOOT_MAX_BLOBS blobs are registered.
+ * @retval NRF_ERROR_INVALID_PARAM If the blob does not fit in the area.
+ */
+ret_code_t nrf_warm_boot_register(nrf_warm_boot_blob_t const * p_blob);
+
+
+/**@brief Function for getting a blob saved before the reset.
+ *
+ * @param[in] id     Identifier.
+ * @param[in] size   Expected size, in bytes.
+ *
+ * @return Pointer to the blob in the area, or NULL if this is a cold boot, or the blob was not
+ *         saved, has a different size or a wrong CRC.
+ */
+void const * nrf_warm_boot_get(uint16_t id, uint16_t size);
+
+
+/**@brief Function for marking a saved blob as not valid.
+ *
+ * @details Cheap and safe to call from any context, also when nothing was saved.
+ *
+ * @param[in] id   Identifier.
+ */
+void nrf_warm_boot_invalidate(uint16_t id);
+
+
+/**@brief Function for saving all registered blobs.
+ *
+ * @details The blobs saved before the reset cannot be used after this.
+ *
+ * @retval NRF_SUCCESS    If all blobs were saved.
+ * @retval NRF_ERROR_BUSY If a blob cannot be saved now. Nothing is saved, the next boot is cold.
+ */
+ret_code_t nrf_warm_boot_save(void);
+
+
+/**@brief Function for saving all registered blobs and resetting.
+ *
+ * @details The reset is done also if the blobs cannot be saved.
+ */
+void nrf_warm_boot_reset(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_WARM_BOOT_H__
+
+/** @} */
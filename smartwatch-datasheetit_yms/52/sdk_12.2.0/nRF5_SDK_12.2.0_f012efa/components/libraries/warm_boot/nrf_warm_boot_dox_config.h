@@ -0,0 +1,41 @@
+/**
+ *
+ * @defgroup nrf_warm_boot_config Warm boot module configuration
+ * @{
+ * @ingroup nrf_warm_boot
+ */
+/** @brief Enabling the warm boot module
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_WARM_BOOT_ENABLED
+
+
+/** @brief Size of the retained area, in bytes
+ *
+ * Every blob takes 8 bytes in addition to its size, rounded up to a multiple of 4.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_WARM_BOOT_AREA_SIZE
+
+
+/** @brief Maximum number of registered blobs
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_WARM_BOOT_MAX_BLOBS
+
+
+/** @brief Reset reasons after which the saved blobs are used
+ *
+ * Bits of the RESETREAS register. The default is a soft reset, a watchdog reset or a lockup.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_WARM_BOOT_RESET_REASONS
+
+
+/** @} */
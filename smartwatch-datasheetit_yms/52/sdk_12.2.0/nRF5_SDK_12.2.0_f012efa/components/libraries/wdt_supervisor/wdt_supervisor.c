@@ -0,0 +1,152 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(WDT_SUPERVISOR)
+#include "wdt_supervisor.h"
+#include "nrf_atomic.h"
+#include "app_timer.h"
+#include "app_util_platform.h"
+
+static struct
+{
+    uint32_t               registered; /**< Mask of the registered tasks. */
+    nrf_atomic_u32_t       alive;      /**< Mask of the tasks that have checked in since the last feed. */
+    volatile bool          overdue;    /**< The feed timer has expired before all tasks checked in. */
+    nrf_drv_wdt_channel_id channel;
+    uint32_t               timeout_ticks;
+    uint32_t               slack_ticks;
+} m_cb;
+
+APP_TIMER_DEF(m_feed_timer);
+
+
+static ret_code_t feed_timer_start(void)
+{
+    return app_timer_start_with_slack(m_feed_timer, m_cb.timeout_ticks, m_cb.slack_ticks, NULL);
+}
+
+
+/**@brief Function for feeding the watchdog if all tasks have checked in.
+ *
+ * @return True if the watchdog was fed.
+ */
+static bool feed_try(void)
+{
+    bool feed = false;
+
+    CRITICAL_REGION_ENTER();
+    if (m_cb.alive == m_cb.registered)
+    {
+        m_cb.alive   = 0;
+        m_cb.overdue = false;
+        feed         = true;
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (feed)
+    {
+        nrf_drv_wdt_channel_feed(m_cb.channel);
+        APP_ERROR_CHECK(feed_timer_start());
+    }
+    return feed;
+}
+
+
+static void feed_timeout_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    if (!feed_try())
+    {
+        // The last task to check in makes the feed.
+        m_cb.overdue = true;
+        if (m_cb.alive == m_cb.registered)
+        {
+            // It has checked in since the test.
+            (void)feed_try();
+        }
+    }
+}
+
+
+ret_code_t wdt_supervisor_init(nrf_drv_wdt_config_t const * p_config,
+                               nrf_wdt_event_handler_t      event_handler,
+                               uint32_t                     prescaler)
+{
+    ret_code_t err_code;
+    uint32_t   reload_ms = (p_config != NULL) ? p_config->reload_value : WDT_CONFIG_RELOAD_VALUE;
+
+    if (reload_ms <= 2 * WDT_SUPERVISOR_CONFIG_MARGIN_MS)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    memset(&m_cb, 0, sizeof(m_cb));
+    // The feed is made between half of the reload time and the reload time minus the margin.
+    m_cb.timeout_ticks = APP_TIMER_TICKS(reload_ms / 2, prescaler);
+    m_cb.slack_ticks   = MIN(APP_TIMER_TICKS(reload_ms - reload_ms / 2 - WDT_SUPERVISOR_CONFIG_MARGIN_MS,
+                                             prescaler),
+                             APP_TIMER_MAX_SLACK_TICKS);
+
+    err_code = nrf_drv_wdt_init(p_config, event_handler);
+    VERIFY_SUCCESS(err_code);
+
+    err_code = nrf_drv_wdt_channel_alloc(&m_cb.channel);
+    VERIFY_SUCCESS(err_code);
+
+    return app_timer_create(&m_feed_timer, APP_TIMER_MODE_SINGLE_SHOT, feed_timeout_handler);
+}
+
+
+ret_code_t wdt_supervisor_task_register(wdt_supervisor_task_t * p_task)
+{
+    VERIFY_PARAM_NOT_NULL(p_task);
+
+    if (m_cb.registered == UINT32_MAX)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    *p_task          = (wdt_supervisor_task_t)__CLZ(__RBIT(~m_cb.registered));
+    m_cb.registered |= (1UL << *p_task);
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t wdt_supervisor_start(void)
+{
+    m_cb.alive   = 0;
+    m_cb.overdue = false;
+
+    nrf_drv_wdt_enable();
+    return feed_timer_start();
+}
+
+
+void wdt_supervisor_checkin(wdt_supervisor_task_t task)
+{
+    uint32_t alive = nrf_atomic_u32_or(&m_cb.alive, 1UL << task);
+
+    if (m_cb.overdue && (alive == m_cb.registered))
+    {
+        (void)feed_try();
+    }
+}
+
+
+uint32_t wdt_supervisor_missing_get(void)
+{
+    return m_cb.registered & ~m_cb.alive;
+}
+
+#endif // NRF_MODULE_ENABLED(WDT_SUPERVISOR)
@@ -0,0 +1,104 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup wdt_supervisor Watchdog supervisor
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for feeding the watchdog only while all registered tasks are alive.
+ *
+ * @details Every task, or module, that must not hang is registered and calls
+ *          @ref wdt_supervisor_checkin regularly, which only sets a bit. The watchdog is fed when
+ *          all tasks have checked in since the last feed, and the check-ins are cleared.
+ *
+ *          The feed is made from an app_timer with slack: the timer expires between half of the
+ *          reload time and the reload time minus @ref WDT_SUPERVISOR_CONFIG_MARGIN_MS, so it
+ *          usually shares its wakeup with other timers. If a task has not checked in by then, the
+ *          feed is made by its check-in instead. If it does not check in before the reload time,
+ *          the watchdog resets the chip. The tasks that had not checked in can be read with
+ *          @ref wdt_supervisor_missing_get in the watchdog event handler, before the reset.
+ */
+
+#ifndef WDT_SUPERVISOR_H__
+#define WDT_SUPERVISOR_H__
+
+#include <stdint.h>
+#include "nrf_drv_wdt.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Time kept between the latest feed and the watchdog reload time, in milliseconds.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef WDT_SUPERVISOR_CONFIG_MARGIN_MS
+#define WDT_SUPERVISOR_CONFIG_MARGIN_MS 100
+#endif
+
+/**@brief Identifier of a supervised task. */
+typedef uint8_t wdt_supervisor_task_t;
+
+/**@brief Function for initializing the module and the watchdog driver.
+ *
+ * @param[in] p_config      Watchdog configuration, or NULL for the default one. The reload time
+ *                          must be longer than twice @ref WDT_SUPERVISOR_CONFIG_MARGIN_MS.
+ * @param[in] event_handler Watchdog event handler, called shortly before the reset.
+ * @param[in] prescaler     Prescaler of the app_timer module.
+ *
+ * @retval NRF_SUCCESS             If the module was initialized.
+ * @retval NRF_ERROR_INVALID_PARAM If the reload time is too short.
+ * @return Any error returned by the watchdog driver or app_timer.
+ */
+ret_code_t wdt_supervisor_init(nrf_drv_wdt_config_t const * p_config,
+                               nrf_wdt_event_handler_t      event_handler,
+                               uint32_t                     prescaler);
+
+/**@brief Function for registering a task. Can only be called before @ref wdt_supervisor_start.
+ *
+ * @param[out] p_task Identifier of the task.
+ *
+ * @retval NRF_SUCCESS    If the task was registered.
+ * @retval NRF_ERROR_NULL If p_task was NULL.
+ * @retval NRF_ERROR_NO_MEM If 32 tasks are registered.
+ */
+ret_code_t wdt_supervisor_task_register(wdt_supervisor_task_t * p_task);
+
+/**@brief Function for starting the watchdog.
+ *
+ * @return Any error returned by app_timer.
+ */
+ret_code_t wdt_supervisor_start(void);
+
+/**@brief Function for reporting that a task is alive. Can be called from any context.
+ *
+ * @param[in] task Identifier of the task.
+ */
+void wdt_supervisor_checkin(wdt_supervisor_task_t task);
+
+/**@brief Function for getting the tasks that have not checked in since the last feed.
+ *
+ * @return Bit mask of the task identifiers.
+ */
+uint32_t wdt_supervisor_missing_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WDT_SUPERVISOR_H__
+
+/** @} */
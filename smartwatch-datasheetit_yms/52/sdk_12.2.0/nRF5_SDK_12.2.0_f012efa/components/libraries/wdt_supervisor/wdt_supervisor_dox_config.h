@@ -0,0 +1,24 @@
+/**
+ *
+ * @defgroup wdt_supervisor_config Watchdog supervisor configuration
+ * @{
+ * @ingroup wdt_supervisor
+ */
+/** @brief Enabling the watchdog supervisor
+ *
+ *  Requires the WDT driver and app_timer.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define WDT_SUPERVISOR_ENABLED
+
+/** @brief Time kept between the latest feed and the watchdog reload time, in milliseconds.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define WDT_SUPERVISOR_CONFIG_MARGIN_MS
+
+
+/** @} */
@@ -0,0 +1,354 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(NRF_WORK)
+#include "nrf_work.h"
+#include "app_util_platform.h"
+
+#if SDK_OS == SDK_OS_FREERTOS
+#include "FreeRTOS.h"
+#include "task.h"
+#elif SDK_OS == SDK_OS_RTX
+#include "cmsis_os.h"
+#else
+#include "nrf_drv_swi.h"
+#endif
+
+#define NRF_WORK_SIGNAL     0x01    /**< RTX signal that wakes a level thread. */
+
+/**@brief Queue of a level. */
+typedef struct
+{
+    nrf_work_t     * p_head;
+    nrf_work_t     * p_tail;
+    uint16_t         depth;
+    nrf_work_stats_t stats;
+} work_queue_t;
+
+static work_queue_t m_queues[NRF_WORK_PRIO_COUNT];
+
+#if SDK_OS == SDK_OS_FREERTOS
+static TaskHandle_t m_tasks[NRF_WORK_PRIO_COUNT];
+#elif SDK_OS == SDK_OS_RTX
+static osThreadId   m_threads[NRF_WORK_PRIO_COUNT];
+#else
+static nrf_swi_t    m_swis[NRF_WORK_PRIO_COUNT];
+#endif
+
+
+/**@brief Function for appending an item to a queue. Called in a critical region. */
+static void queue_put(nrf_work_prio_t prio, nrf_work_t * p_work)
+{
+    work_queue_t * p_queue = &m_queues[prio];
+
+    p_work->p_next = NULL;
+    p_work->level  = (uint8_t)prio;
+    if (p_queue->p_tail == NULL)
+    {
+        p_queue->p_head = p_work;
+    }
+    else
+    {
+        p_queue->p_tail->p_next = p_work;
+    }
+    p_queue->p_tail = p_work;
+
+    p_queue->depth++;
+    p_queue->stats.submitted++;
+    if (p_queue->depth > p_queue->stats.depth_max)
+    {
+        p_queue->stats.depth_max = p_queue->depth;
+    }
+}
+
+
+/**@brief Function for unlinking a queued item. Called in a critical region. */
+static void queue_remove(nrf_work_t * p_work)
+{
+    work_queue_t * p_queue = &m_queues[p_work->level];
+    nrf_work_t   * p_prev  = NULL;
+    nrf_work_t   * p_item  = p_queue->p_head;
+
+    while ((p_item != NULL) && (p_item != p_work))
+    {
+        p_prev = p_item;
+        p_item = p_item->p_next;
+    }
+    ASSERT(p_item != NULL);
+
+    if (p_prev == NULL)
+    {
+        p_queue->p_head = p_work->p_next;
+    }
+    else
+    {
+        p_prev->p_next = p_work->p_next;
+    }
+    if (p_queue->p_tail == p_work)
+    {
+        p_queue->p_tail = p_prev;
+    }
+
+    p_queue->depth--;
+    p_work->p_next = NULL;
+    p_work->level  = NRF_WORK_PRIO_COUNT;
+}
+
+
+/**@brief Function for taking the first item of a queue. */
+static nrf_work_t * queue_get(nrf_work_prio_t prio)
+{
+    nrf_work_t * p_work;
+
+    CRITICAL_REGION_ENTER();
+    p_work = m_queues[prio].p_head;
+    if (p_work != NULL)
+    {
+        queue_remove(p_work);
+    }
+    CRITICAL_REGION_EXIT();
+
+    return p_work;
+}
+
+
+/**@brief Function for running the items of a level until its queue is empty.
+ *
+ * Items submitted to the level by the handlers run in the same pass.
+ */
+static void level_run(nrf_work_prio_t prio)
+{
+    nrf_work_t * p_work;
+
+    while ((p_work = queue_get(prio)) != NULL)
+    {
+        p_work->handler(p_work->p_context);
+    }
+}
+
+
+#if SDK_OS == SDK_OS_FREERTOS
+
+static void level_task(void * p_arg)
+{
+    nrf_work_prio_t prio = (nrf_work_prio_t)(uint32_t)p_arg;
+
+    for (;;)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        level_run(prio);
+    }
+}
+
+static void level_wake(nrf_work_prio_t prio)
+{
+    if (__get_IPSR() != 0)
+    {
+        BaseType_t yield_req = pdFALSE;
+        vTaskNotifyGiveFromISR(m_tasks[prio], &yield_req);
+        portYIELD_FROM_ISR(yield_req);
+    }
+    else
+    {
+        (void)xTaskNotifyGive(m_tasks[prio]);
+    }
+}
+
+static ret_code_t level_init(nrf_work_prio_t prio)
+{
+    static const UBaseType_t priorities[NRF_WORK_PRIO_COUNT] =
+    {
+        NRF_WORK_CONFIG_HIGH_TASK_PRIORITY,
+        NRF_WORK_CONFIG_LOW_TASK_PRIORITY
+    };
+
+    if (xTaskCreate(level_task,
+                    "WORK",
+                    NRF_WORK_CONFIG_TASK_STACK_SIZE / sizeof(StackType_t),
+                    (void *)(uint32_t)prio,
+                    priorities[prio],
+                    &m_tasks[prio]) != pdPASS)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+    return NRF_SUCCESS;
+}
+
+#elif SDK_OS == SDK_OS_RTX
+
+static void level_thread(void const * p_arg)
+{
+    nrf_work_prio_t prio = (nrf_work_prio_t)(uint32_t)p_arg;
+
+    for (;;)
+    {
+        (void)osSignalWait(NRF_WORK_SIGNAL, osWaitForever);
+        level_run(prio);
+    }
+}
+
+osThreadDef(level_thread, osPriorityNormal, NRF_WORK_PRIO_COUNT, NRF_WORK_CONFIG_TASK_STACK_SIZE);
+
+static void level_wake(nrf_work_prio_t prio)
+{
+    (void)osSignalSet(m_threads[prio], NRF_WORK_SIGNAL);
+}
+
+static ret_code_t level_init(nrf_work_prio_t prio)
+{
+    static const osPriority priorities[NRF_WORK_PRIO_COUNT] =
+    {
+        NRF_WORK_CONFIG_HIGH_TASK_PRIORITY,
+        NRF_WORK_CONFIG_LOW_TASK_PRIORITY
+    };
+
+    m_threads[prio] = osThreadCreate(osThread(level_thread), (void *)(uint32_t)prio);
+    if (m_threads[prio] == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+    (void)osThreadSetPriority(m_threads[prio], priorities[prio]);
+    return NRF_SUCCESS;
+}
+
+#else
+
+static void level_swi_handler(nrf_swi_t swi, nrf_swi_flags_t flags)
+{
+    UNUSED_PARAMETER(flags);
+
+    for (uint32_t i = 0; i < NRF_WORK_PRIO_COUNT; i++)
+    {
+        if (m_swis[i] == swi)
+        {
+            level_run((nrf_work_prio_t)i);
+        }
+    }
+}
+
+static void level_wake(nrf_work_prio_t prio)
+{
+    nrf_drv_swi_trigger(m_swis[prio], 0);
+}
+
+static ret_code_t level_init(nrf_work_prio_t prio)
+{
+    static const uint8_t priorities[NRF_WORK_PRIO_COUNT] =
+    {
+        NRF_WORK_CONFIG_HIGH_IRQ_PRIORITY,
+        NRF_WORK_CONFIG_LOW_IRQ_PRIORITY
+    };
+
+    if (nrf_drv_swi_alloc(&m_swis[prio], level_swi_handler, priorities[prio]) != NRF_SUCCESS)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+    return NRF_SUCCESS;
+}
+
+#endif // SDK_OS
+
+
+ret_code_t nrf_work_init(void)
+{
+    ret_code_t err_code;
+
+    memset(m_queues, 0, sizeof(m_queues));
+
+    for (uint32_t i = 0; i < NRF_WORK_PRIO_COUNT; i++)
+    {
+        err_code = level_init((nrf_work_prio_t)i);
+        VERIFY_SUCCESS(err_code);
+    }
+    return NRF_SUCCESS;
+}
+
+
+void nrf_work_item_init(nrf_work_t * p_work, nrf_work_handler_t handler, void * p_context)
+{
+    ASSERT(p_work != NULL);
+    ASSERT(handler != NULL);
+
+    p_work->p_next    = NULL;
+    p_work->handler   = handler;
+    p_work->p_context = p_context;
+    p_work->level     = NRF_WORK_PRIO_COUNT;
+}
+
+
+ret_code_t nrf_work_submit(nrf_work_t * p_work, nrf_work_prio_t prio)
+{
+    bool wake = false;
+
+    ASSERT(p_work != NULL);
+    if (prio >= NRF_WORK_PRIO_COUNT)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    CRITICAL_REGION_ENTER();
+    if (p_work->level == NRF_WORK_PRIO_COUNT)
+    {
+        queue_put(prio, p_work);
+        wake = true;
+    }
+    else if (p_work->level > (uint8_t)prio)
+    {
+        // Queued at a lower level: the item runs at the higher one, once.
+        m_queues[p_work->level].stats.merged++;
+        queue_remove(p_work);
+        queue_put(prio, p_work);
+        wake = true;
+    }
+    else
+    {
+        m_queues[p_work->level].stats.merged++;
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (wake)
+    {
+        level_wake(prio);
+    }
+    return NRF_SUCCESS;
+}
+
+
+bool nrf_work_cancel(nrf_work_t * p_work)
+{
+    bool removed = false;
+
+    ASSERT(p_work != NULL);
+
+    CRITICAL_REGION_ENTER();
+    if (p_work->level != NRF_WORK_PRIO_COUNT)
+    {
+        queue_remove(p_work);
+        removed = true;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return removed;
+}
+
+
+void nrf_work_stats_get(nrf_work_prio_t prio, nrf_work_stats_t * p_stats)
+{
+    ASSERT(prio < NRF_WORK_PRIO_COUNT);
+    ASSERT(p_stats != NULL);
+
+    CRITICAL_REGION_ENTER();
+    *p_stats = m_queues[prio].stats;
+    CRITICAL_REGION_EXIT();
+}
+
+#endif //NRF_MODULE_ENABLED(NRF_WORK)
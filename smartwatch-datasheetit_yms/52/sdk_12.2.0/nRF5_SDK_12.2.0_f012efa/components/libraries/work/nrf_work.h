@@ -0,0 +1,178 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup nrf_work Deferred work
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for running work items out of interrupt context, at a chosen priority.
+ *
+ * @details Work items are submitted from interrupts or from thread context, and run in the order
+ *          of submission within each priority level. Every level has its own execution context,
+ *          selected with @ref SDK_OS:
+ *          - Bare metal: a software interrupt at the priority set in the configuration.
+ *          - FreeRTOS: a task, woken by a task notification.
+ *          - RTX: a thread, woken by a signal.
+ *
+ *          A level only runs its own items. An item that is already queued is not queued twice:
+ *          when it is submitted again at a higher level, it moves to that level.
+ *
+ * @note On bare metal, one SWI is allocated per level through @ref nrf_drv_swi, which must be
+ *       initialized before @ref nrf_work_init.
+ */
+
+#ifndef NRF_WORK_H__
+#define NRF_WORK_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+#include "sdk_os.h"
+#include "app_util_platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Interrupt priority of the high level, on bare metal.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef NRF_WORK_CONFIG_HIGH_IRQ_PRIORITY
+#define NRF_WORK_CONFIG_HIGH_IRQ_PRIORITY   APP_IRQ_PRIORITY_MID
+#endif
+
+/** @brief Interrupt priority of the low level, on bare metal.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef NRF_WORK_CONFIG_LOW_IRQ_PRIORITY
+#define NRF_WORK_CONFIG_LOW_IRQ_PRIORITY    APP_IRQ_PRIORITY_LOWEST
+#endif
+
+/** @brief Task or thread priority of the high level, with an RTOS.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef NRF_WORK_CONFIG_HIGH_TASK_PRIORITY
+#if SDK_OS == SDK_OS_RTX
+#define NRF_WORK_CONFIG_HIGH_TASK_PRIORITY  osPriorityHigh
+#else
+#define NRF_WORK_CONFIG_HIGH_TASK_PRIORITY  (configMAX_PRIORITIES - 1)
+#endif
+#endif
+
+/** @brief Task or thread priority of the low level, with an RTOS.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef NRF_WORK_CONFIG_LOW_TASK_PRIORITY
+#if SDK_OS == SDK_OS_RTX
+#define NRF_WORK_CONFIG_LOW_TASK_PRIORITY   osPriorityBelowNormal
+#else
+#define NRF_WORK_CONFIG_LOW_TASK_PRIORITY   1
+#endif
+#endif
+
+/** @brief Stack size of the tasks or threads, with an RTOS, in bytes.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef NRF_WORK_CONFIG_TASK_STACK_SIZE
+#define NRF_WORK_CONFIG_TASK_STACK_SIZE     512
+#endif
+
+/**@brief Priority levels. */
+typedef enum
+{
+    NRF_WORK_PRIO_HIGH,  /**< For bottom halves of interrupts with timing constraints. */
+    NRF_WORK_PRIO_LOW,   /**< For other deferred processing. */
+    NRF_WORK_PRIO_COUNT  /**< Number of levels. */
+} nrf_work_prio_t;
+
+/**@brief Work handler. */
+typedef void (* nrf_work_handler_t)(void * p_context);
+
+/**@brief Work item. Its content is private to this module. */
+typedef struct nrf_work_s
+{
+    struct nrf_work_s * p_next;    /**< Next item of the same level. */
+    nrf_work_handler_t  handler;   /**< Handler. */
+    void              * p_context; /**< Context passed to the handler. */
+    volatile uint8_t    level;     /**< Level of the queued item, @ref NRF_WORK_PRIO_COUNT if not queued. */
+} nrf_work_t;
+
+/**@brief Statistics of a level. */
+typedef struct
+{
+    uint32_t submitted;     /**< Items queued. */
+    uint32_t merged;        /**< Submissions of items that were already queued. */
+    uint16_t depth_max;     /**< Highest number of queued items. */
+} nrf_work_stats_t;
+
+
+/**@brief Function for initializing the module and the execution contexts of the levels.
+ *
+ * @retval NRF_SUCCESS      If the module was initialized.
+ * @retval NRF_ERROR_NO_MEM If a software interrupt, task or thread could not be allocated.
+ */
+ret_code_t nrf_work_init(void);
+
+
+/**@brief Function for initializing a work item.
+ *
+ * @param[out] p_work    Work item, kept in memory while it is queued.
+ * @param[in]  handler   Handler.
+ * @param[in]  p_context Context passed to the handler.
+ */
+void nrf_work_item_init(nrf_work_t * p_work, nrf_work_handler_t handler, void * p_context);
+
+
+/**@brief Function for submitting a work item. Can be called from any context.
+ *
+ * An item can be submitted again from its handler.
+ *
+ * @param[in] p_work Work item.
+ * @param[in] prio   Level to run the item at.
+ *
+ * @retval NRF_SUCCESS             If the item is queued.
+ * @retval NRF_ERROR_INVALID_PARAM If the level was invalid.
+ */
+ret_code_t nrf_work_submit(nrf_work_t * p_work, nrf_work_prio_t prio);
+
+
+/**@brief Function for removing a queued work item.
+ *
+ * @param[in] p_work Work item.
+ *
+ * @retval true  If the item was removed before it ran.
+ * @retval false If the item was not queued.
+ */
+bool nrf_work_cancel(nrf_work_t * p_work);
+
+
+/**@brief Function for getting the statistics of a level.
+ *
+ * @param[in]  prio    Level.
+ * @param[out] p_stats Statistics.
+ */
+void nrf_work_stats_get(nrf_work_prio_t prio, nrf_work_stats_t * p_stats);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_WORK_H__
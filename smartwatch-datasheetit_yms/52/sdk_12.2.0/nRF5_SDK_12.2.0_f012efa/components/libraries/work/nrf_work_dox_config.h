@@ -0,0 +1,46 @@
+/**
+ *
+ * @defgroup nrf_work_config nrf_work module configuration
+ * @{
+ * @ingroup nrf_work
+ */
+/** @brief Enabling nrf_work module
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_WORK_ENABLED
+
+/** @brief Interrupt priority of the high level, on bare metal.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_WORK_CONFIG_HIGH_IRQ_PRIORITY
+
+/** @brief Interrupt priority of the low level, on bare metal.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_WORK_CONFIG_LOW_IRQ_PRIORITY
+
+/** @brief Task or thread priority of the high level, with an RTOS.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_WORK_CONFIG_HIGH_TASK_PRIORITY
+
+/** @brief Task or thread priority of the low level, with an RTOS.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_WORK_CONFIG_LOW_TASK_PRIORITY
+
+/** @brief Stack size of the tasks or threads, with an RTOS, in bytes.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NRF_WORK_CONFIG_TASK_STACK_SIZE
+
+
+/** @} */
@@ -0,0 +1,257 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(XIP_ASSET)
+#include "xip_asset.h"
+#include <string.h>
+#include "nrf_qspi.h"
+#include "nrf_drv_qspi.h"
+#include "app_util_platform.h"
+
+STATIC_ASSERT(IS_POWER_OF_TWO(XIP_ASSET_CONFIG_CACHE_LINE_SIZE));
+STATIC_ASSERT(XIP_ASSET_CONFIG_CACHE_LINES > 0);
+
+#define LINE_MASK       (XIP_ASSET_CONFIG_CACHE_LINE_SIZE - 1)
+#define LINE_INVALID    0xFFFFFFFF                  /**< Tag of a line that holds no data. */
+
+/**@brief Line of the cache. */
+typedef struct
+{
+    uint32_t tag;                                   /**< Offset of the line in the region. */
+    uint32_t used;                                  /**< Value of the clock the line was last read at. */
+    __ALIGN(4) uint8_t data[XIP_ASSET_CONFIG_CACHE_LINE_SIZE];
+} cache_line_t;
+
+/**@brief Control block of the module. */
+typedef struct
+{
+    uint8_t const * p_region;                       /**< Start of the region in the XIP region. */
+    uint32_t        region_size;                    /**< Size of the region. */
+    uint32_t        map_count;                      /**< Assets mapped, and reads ongoing. */
+    bool            writing;                        /**< A write is ongoing. */
+    uint32_t        clock;                          /**< Incremented on every access to the cache. */
+    cache_line_t    lines[XIP_ASSET_CONFIG_CACHE_LINES];
+} xip_asset_cb_t;
+
+static xip_asset_cb_t m_cb;
+
+
+static void cache_invalidate(void)
+{
+    for (uint32_t i = 0; i < XIP_ASSET_CONFIG_CACHE_LINES; i++)
+    {
+        m_cb.lines[i].tag = LINE_INVALID;
+    }
+}
+
+
+/**@brief Function for checking that a range is inside the region, without overflowing. */
+static bool range_valid(uint32_t offset, uint32_t size)
+{
+    return (offset <= m_cb.region_size) && (size <= (m_cb.region_size - offset));
+}
+
+
+/**@brief Function for taking a reference to the region.
+ *
+ * @retval NRF_SUCCESS    If the region can be read until @ref region_release is called.
+ * @retval NRF_ERROR_BUSY If a write is ongoing.
+ */
+static ret_code_t region_acquire(void)
+{
+    ret_code_t err_code = NRF_ERROR_BUSY;
+
+    CRITICAL_REGION_ENTER();
+    if (!m_cb.writing)
+    {
+        m_cb.map_count++;
+        err_code = NRF_SUCCESS;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return err_code;
+}
+
+
+static void region_release(void)
+{
+    CRITICAL_REGION_ENTER();
+    ASSERT(m_cb.map_count > 0);
+    m_cb.map_count--;
+    CRITICAL_REGION_EXIT();
+}
+
+
+/**@brief Function for getting the line that holds the given offset, filling it on a miss.
+ *
+ * @param[in] tag Offset of the line, aligned to the size of a line.
+ */
+static cache_line_t const * cache_line_get(uint32_t tag)
+{
+    cache_line_t * p_victim = &m_cb.lines[0];
+    uint32_t       length;
+
+    m_cb.clock++;
+
+    for (uint32_t i = 0; i < XIP_ASSET_CONFIG_CACHE_LINES; i++)
+    {
+        cache_line_t * p_line = &m_cb.lines[i];
+
+        if (p_line->tag == tag)
+        {
+            p_line->used = m_cb.clock;
+            return p_line;
+        }
+        // Invalid lines are taken first, then the least recently used one.
+        if ((p_victim->tag != LINE_INVALID) &&
+            ((p_line->tag == LINE_INVALID) ||
+             ((uint32_t)(m_cb.clock - p_line->used) > (uint32_t)(m_cb.clock - p_victim->used))))
+        {
+            p_victim = p_line;
+        }
+    }
+
+    // The last line of the region may be shorter.
+    length = MIN(XIP_ASSET_CONFIG_CACHE_LINE_SIZE, m_cb.region_size - tag);
+    memcpy(p_victim->data, &m_cb.p_region[tag], length);
+    p_victim->tag  = tag;
+    p_victim->used = m_cb.clock;
+
+    return p_victim;
+}
+
+
+ret_code_t xip_asset_init(uint32_t region_addr, uint32_t region_size)
+{
+    if ((region_size == 0) ||
+        (region_addr >= NRF_QSPI_XIP_SIZE) ||
+        (region_size > (NRF_QSPI_XIP_SIZE - region_addr)))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    // The whole XIP region is shifted, so that the asset region starts at the XIP start address.
+    nrf_qspi_xip_offset_set(NRF_QSPI, region_addr);
+
+    memset(&m_cb, 0, sizeof(m_cb));
+    m_cb.p_region    = (uint8_t const *)NRF_QSPI_XIP_START_ADDR;
+    m_cb.region_size = region_size;
+    cache_invalidate();
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t xip_asset_map(uint32_t offset, uint32_t size, void const ** pp_data)
+{
+    ret_code_t err_code;
+
+    VERIFY_PARAM_NOT_NULL(pp_data);
+
+    if (!range_valid(offset, size))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    err_code = region_acquire();
+    VERIFY_SUCCESS(err_code);
+
+    *pp_data = &m_cb.p_region[offset];
+    return NRF_SUCCESS;
+}
+
+
+void xip_asset_unmap(void)
+{
+    region_release();
+}
+
+
+ret_code_t xip_asset_read(uint32_t offset, void * p_dst, uint32_t size)
+{
+    ret_code_t err_code;
+    uint8_t  * p_out = p_dst;
+
+    VERIFY_PARAM_NOT_NULL(p_dst);
+
+    if (!range_valid(offset, size))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    err_code = region_acquire();
+    VERIFY_SUCCESS(err_code);
+
+    if (size > XIP_ASSET_CONFIG_CACHE_LINE_SIZE)
+    {
+        memcpy(p_out, &m_cb.p_region[offset], size);
+    }
+    else
+    {
+        // At most two lines are read.
+        while (size > 0)
+        {
+            uint32_t             in_line = offset & LINE_MASK;
+            uint32_t             length  = MIN(size, XIP_ASSET_CONFIG_CACHE_LINE_SIZE - in_line);
+            cache_line_t const * p_line  = cache_line_get(offset - in_line);
+
+            memcpy(p_out, &p_line->data[in_line], length);
+            p_out  += length;
+            offset += length;
+            size   -= length;
+        }
+    }
+
+    region_release();
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t xip_asset_write_begin(void)
+{
+    ret_code_t err_code = NRF_ERROR_BUSY;
+
+    CRITICAL_REGION_ENTER();
+    if (!m_cb.writing && (m_cb.map_count == 0))
+    {
+        m_cb.writing = true;
+        err_code = NRF_SUCCESS;
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (err_code == NRF_SUCCESS)
+    {
+        cache_invalidate();
+    }
+
+    return err_code;
+}
+
+
+ret_code_t xip_asset_write_end(void)
+{
+    ret_code_t err_code;
+
+    if (!m_cb.writing)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    // A read of the XIP region while the memory is programming would return wrong data.
+    err_code = nrf_drv_qspi_mem_busy_check();
+    VERIFY_SUCCESS(err_code);
+
+    m_cb.writing = false;
+    return NRF_SUCCESS;
+}
+
+#endif // NRF_MODULE_ENABLED(XIP_ASSET)
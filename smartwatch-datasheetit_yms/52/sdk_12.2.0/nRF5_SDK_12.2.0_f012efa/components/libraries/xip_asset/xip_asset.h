@@ -0,0 +1,138 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup xip_asset XIP asset region
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for reading read-only assets in place from the external memory on QSPI.
+ *
+ * @details A region of the external memory, for example bitmaps and fonts, is mapped at
+ *          @ref NRF_QSPI_XIP_START_ADDR with the XIPOFFSET register of QSPI. The CPU reads it
+ *          directly, with no EasyDMA transfer into a RAM buffer: @ref xip_asset_map returns a
+ *          pointer to an asset. Small assets that are read again and again, such as glyphs,
+ *          can be read through a cache in RAM with @ref xip_asset_read.
+ *
+ *          While the external memory is programmed or erased, it cannot be read. Writes to the
+ *          memory, for example through @ref nrf_block_dev_qspi, must be done between
+ *          @ref xip_asset_write_begin and @ref xip_asset_write_end. A write cannot begin while
+ *          an asset is mapped, and assets cannot be mapped while a write is ongoing.
+ *
+ * @note The QSPI driver must be initialized, for example by the QSPI block device, before the
+ *       module is used. EasyDMA cannot read the XIP region: data for a peripheral, for example
+ *       SPIM, must be copied to RAM with @ref xip_asset_read.
+ */
+
+#ifndef XIP_ASSET_H__
+#define XIP_ASSET_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of lines of the cache.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef XIP_ASSET_CONFIG_CACHE_LINES
+#define XIP_ASSET_CONFIG_CACHE_LINES 8
+#endif
+
+/** @brief Size of a line of the cache, in bytes. A power of two.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef XIP_ASSET_CONFIG_CACHE_LINE_SIZE
+#define XIP_ASSET_CONFIG_CACHE_LINE_SIZE 128
+#endif
+
+/**@brief Function for mapping the asset region.
+ *
+ * @param[in] region_addr Address of the region in the external memory.
+ * @param[in] region_size Size of the region, in bytes.
+ *
+ * @retval NRF_SUCCESS             If the region was mapped.
+ * @retval NRF_ERROR_INVALID_PARAM If the region does not fit the XIP region.
+ */
+ret_code_t xip_asset_init(uint32_t region_addr, uint32_t region_size);
+
+/**@brief Function for getting a pointer to an asset, through which it is read in place.
+ *
+ * @details Every successful call must be followed by @ref xip_asset_unmap when the asset is no
+ *          longer read.
+ *
+ * @param[in]  offset  Offset of the asset in the region.
+ * @param[in]  size    Size of the asset.
+ * @param[out] pp_data Pointer to the asset.
+ *
+ * @retval NRF_SUCCESS             If the asset was mapped.
+ * @retval NRF_ERROR_NULL          If pp_data was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If the asset is not inside the region.
+ * @retval NRF_ERROR_BUSY          If a write is ongoing.
+ */
+ret_code_t xip_asset_map(uint32_t offset, uint32_t size, void const ** pp_data);
+
+/**@brief Function for releasing an asset mapped with @ref xip_asset_map.
+ */
+void xip_asset_unmap(void);
+
+/**@brief Function for copying a part of the region to RAM.
+ *
+ * @details Reads up to @ref XIP_ASSET_CONFIG_CACHE_LINE_SIZE bytes go through the cache, the
+ *          least recently used line is replaced on a miss. Longer reads are copied directly, so
+ *          that they do not evict the hot assets.
+ *
+ * @note The cache is not shared safely between interrupt levels: call the function from one
+ *       context, for example the renderer.
+ *
+ * @param[in]  offset Offset in the region.
+ * @param[out] p_dst  Buffer.
+ * @param[in]  size   Number of bytes.
+ *
+ * @retval NRF_SUCCESS             If the data was copied.
+ * @retval NRF_ERROR_NULL          If p_dst was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If the data is not inside the region.
+ * @retval NRF_ERROR_BUSY          If a write is ongoing.
+ */
+ret_code_t xip_asset_read(uint32_t offset, void * p_dst, uint32_t size);
+
+/**@brief Function for preparing a write to the external memory.
+ *
+ * @details The cache is invalidated.
+ *
+ * @retval NRF_SUCCESS    If the memory can be written.
+ * @retval NRF_ERROR_BUSY If an asset is mapped, or a write is ongoing already.
+ */
+ret_code_t xip_asset_write_begin(void);
+
+/**@brief Function for ending a write to the external memory.
+ *
+ * @details The write is ended once the memory has finished programming or erasing.
+ *
+ * @retval NRF_SUCCESS             If assets can be mapped again.
+ * @retval NRF_ERROR_BUSY          If the memory, or QSPI, is still busy. Call the function again.
+ * @retval NRF_ERROR_INVALID_STATE If no write was begun.
+ */
+ret_code_t xip_asset_write_end(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // XIP_ASSET_H__
+
+/** @} */
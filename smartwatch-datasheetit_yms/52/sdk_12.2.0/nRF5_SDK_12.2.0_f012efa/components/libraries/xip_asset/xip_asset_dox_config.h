@@ -0,0 +1,30 @@
+/**
+ *
+ * @defgroup xip_asset_config xip_asset module configuration
+ * @{
+ * @ingroup xip_asset
+ */
+/** @brief Enabling xip_asset module
+ *
+ *  Requires the QSPI driver. nRF52840 only.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define XIP_ASSET_ENABLED
+
+/** @brief Number of lines of the cache.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define XIP_ASSET_CONFIG_CACHE_LINES
+
+/** @brief Size of a line of the cache, in bytes. A power of two.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define XIP_ASSET_CONFIG_CACHE_LINE_SIZE
+
+
+/** @} */
@@ -17,6 +17,7 @@
 #include "nfc_ep_oob_rec.h"
 #include "nfc_ndef_msg.h"
 #include "sdk_macros.h"
+#include "nordic_common.h"
 
 /**
  * @brief Descriptor of TK value locations in Connection Handover NDEF message.
@@ -527,3 +528,89 @@ ret_code_t nfc_lesc_data_update(ble_gap_lesc_oob_data_t * ble_lesc_oob_data)
         return NRF_ERROR_NULL;
     }      
 }
+
+ret_code_t nfc_ble_pair_msg_image_encode(nfc_ble_pair_type_t             nfc_ble_pair_type,
+                                         ble_advdata_tk_value_t  * const p_tk_value,
+                                         ble_gap_lesc_oob_data_t * const p_lesc_data,
+                                         nfc_ndef_msg_image_t    *       p_image)
+{
+    uint8_t  * tk_group[NFC_BLE_PAIR_MSG_IMAGE_FIELD_CNT - 2];
+    uint8_t    tk_num;
+    uint32_t   len;
+    ret_code_t err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_image);
+
+    p_image->field_count = 0;
+    p_image->len         = 0;
+    m_lesc_pos.confirm   = NULL;
+    m_lesc_pos.random    = NULL;
+
+    // The encoders record the locations of the values while they write them.
+    len      = p_image->buf_size;
+    err_code = nfc_ble_pair_msg_updatable_tk_encode(nfc_ble_pair_type,
+                                                    p_tk_value,
+                                                    p_lesc_data,
+                                                    p_image->p_buf,
+                                                    &len,
+                                                    tk_group,
+                                                    ARRAY_SIZE(tk_group));
+    tk_num = m_tk_group.tk_num;
+
+    // The TK group must not keep pointers to this stack frame.
+    nfc_tk_group_modifier_config(NULL, 0);
+    VERIFY_SUCCESS(err_code);
+
+    for (uint8_t i = 0; i < tk_num; i++)
+    {
+        err_code = nfc_ndef_msg_image_field_add(p_image, NFC_BLE_PAIR_MSG_FIELD_TK,
+                                                tk_group[i], AD_TYPE_TK_VALUE_DATA_SIZE);
+        VERIFY_SUCCESS(err_code);
+    }
+
+    if ((p_lesc_data != NULL) && (m_lesc_pos.confirm != NULL))
+    {
+        err_code = nfc_ndef_msg_image_field_add(p_image, NFC_BLE_PAIR_MSG_FIELD_LESC_CONFIRM,
+                                                m_lesc_pos.confirm, AD_TYPE_CONFIRM_VALUE_DATA_SIZE);
+        VERIFY_SUCCESS(err_code);
+
+        err_code = nfc_ndef_msg_image_field_add(p_image, NFC_BLE_PAIR_MSG_FIELD_LESC_RANDOM,
+                                                m_lesc_pos.random, AD_TYPE_RANDOM_VALUE_DATA_SIZE);
+        VERIFY_SUCCESS(err_code);
+    }
+
+    p_image->len = len;
+    return NRF_SUCCESS;
+}
+
+ret_code_t nfc_ble_pair_msg_image_update(nfc_ndef_msg_image_t    * p_image,
+                                         ble_advdata_tk_value_t  * p_tk_value,
+                                         ble_gap_lesc_oob_data_t * p_lesc_data)
+{
+    ret_code_t err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_image);
+
+    if (p_tk_value != NULL)
+    {
+        uint8_t tk_payload[AD_TYPE_TK_VALUE_DATA_SIZE];
+
+        nfc_tk_value_payload_encode(p_tk_value, tk_payload);
+        err_code = nfc_ndef_msg_image_field_update(p_image, NFC_BLE_PAIR_MSG_FIELD_TK,
+                                                   tk_payload, sizeof(tk_payload));
+        VERIFY_SUCCESS(err_code);
+    }
+
+    if (p_lesc_data != NULL)
+    {
+        err_code = nfc_ndef_msg_image_field_update(p_image, NFC_BLE_PAIR_MSG_FIELD_LESC_CONFIRM,
+                                                   p_lesc_data->c, AD_TYPE_CONFIRM_VALUE_DATA_SIZE);
+        VERIFY_SUCCESS(err_code);
+
+        err_code = nfc_ndef_msg_image_field_update(p_image, NFC_BLE_PAIR_MSG_FIELD_LESC_RANDOM,
+                                                   p_lesc_data->r, AD_TYPE_RANDOM_VALUE_DATA_SIZE);
+        VERIFY_SUCCESS(err_code);
+    }
+
+    return NRF_SUCCESS;
+}
@@ -33,6 +33,7 @@
 
 #include <stdint.h>
 #include "ble_advdata.h"
+#include "nfc_ndef_msg_image.h"
 #include "sdk_errors.h"
 
 #ifdef __cplusplus
@@ -51,6 +52,20 @@ typedef enum
     NFC_BLE_PAIR_MSG_FULL                ///< BLE Handover Select Message.
 } nfc_ble_pair_type_t;
 
+/**
+ * @brief Identifiers of the mutable fields in an image of a BLE pairing message.
+ */
+typedef enum
+{
+    NFC_BLE_PAIR_MSG_FIELD_TK,           ///< Security Manager TK value, in each OOB record.
+    NFC_BLE_PAIR_MSG_FIELD_LESC_CONFIRM, ///< LESC Confirmation Value.
+    NFC_BLE_PAIR_MSG_FIELD_LESC_RANDOM   ///< LESC Random Value.
+} nfc_ble_pair_msg_field_t;
+
+/** @brief Number of mutable fields in an image of a BLE pairing message: a TK value in
+ *         both OOB records of a full message, and the LESC values. */
+#define NFC_BLE_PAIR_MSG_IMAGE_FIELD_CNT 4
+
 /** @brief Function for encoding simplified LE OOB messages.
  *
  * This function encodes a simplified LE OOB message into a buffer. The payload of the LE OOB record
@@ -243,6 +258,50 @@ ret_code_t nfc_lesc_data_update(ble_gap_lesc_oob_data_t * ble_lesc_oob_data);
  */
 ret_code_t nfc_lesc_pos_set(uint8_t * p_confirm, uint8_t * p_random);
 
+/**@brief Function for encoding a BLE pairing message into an NDEF message image.
+ *
+ * @details The message is encoded as with @ref nfc_ble_pair_default_msg_encode, into the buffer
+ *          of the image. The locations of the TK value and of the LESC OOB values are recorded
+ *          in the image, so @ref nfc_ble_pair_msg_image_update can change them in place while
+ *          the tag emulation is running. Use the buffer of the image as the tag payload.
+ *
+ * @note To be able to encode the message, a SoftDevice must be enabled and configured.
+ *
+ * @param[in]       nfc_ble_pair_type   Type of BLE pairing message.
+ * @param[in]       p_tk_value          Pointer to the authentication Temporary Key (TK). If NULL,
+ *                                      TK value field is not encoded in the NDEF message.
+ * @param[in]       p_lesc_data         Pointer to the LESC OOB data. If NULL, LESC OOB fields are
+ *                                      not encoded in the NDEF message.
+ * @param[in,out]   p_image             Pointer to the image, with room for
+ *                                      @ref NFC_BLE_PAIR_MSG_IMAGE_FIELD_CNT fields.
+ *
+ * @retval NRF_SUCCESS                  If the function completed successfully.
+ * @retval NRF_ERROR_NULL               If p_image is NULL.
+ * @retval NRF_ERROR_xxx                If an error occurred.
+ */
+ret_code_t nfc_ble_pair_msg_image_encode(nfc_ble_pair_type_t             nfc_ble_pair_type,
+                                         ble_advdata_tk_value_t  * const p_tk_value,
+                                         ble_gap_lesc_oob_data_t * const p_lesc_data,
+                                         nfc_ndef_msg_image_t    *       p_image);
+
+/**@brief Function for updating the TK value and the LESC OOB values in an image of a BLE
+ *        pairing message.
+ *
+ * @details Only the bytes of the values are written. The image must have been encoded by
+ *          @ref nfc_ble_pair_msg_image_encode with the values that are updated.
+ *
+ * @param[in,out] p_image           Pointer to the image.
+ * @param[in]     p_tk_value        Pointer to the new TK value, or NULL to keep it.
+ * @param[in]     p_lesc_data       Pointer to the new LESC OOB data, or NULL to keep it.
+ *
+ * @retval NRF_SUCCESS              If the operation was successful.
+ * @retval NRF_ERROR_NULL           If p_image is NULL.
+ * @retval NRF_ERROR_NOT_FOUND      If a value to update was not encoded in the image.
+ */
+ret_code_t nfc_ble_pair_msg_image_update(nfc_ndef_msg_image_t    * p_image,
+                                         ble_advdata_tk_value_t  * p_tk_value,
+                                         ble_gap_lesc_oob_data_t * p_lesc_data);
+
 /** @} */
 
 #ifdef __cplusplus
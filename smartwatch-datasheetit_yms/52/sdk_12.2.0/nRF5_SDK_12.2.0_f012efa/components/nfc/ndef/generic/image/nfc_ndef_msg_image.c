@@ -0,0 +1,110 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include <string.h>
+#include "nfc_ndef_msg_image.h"
+#include "app_util_platform.h"
+#include "sdk_macros.h"
+
+
+ret_code_t nfc_ndef_msg_image_encode(nfc_ndef_msg_image_t      * p_image,
+                                     nfc_ndef_msg_desc_t const * p_ndef_msg_desc)
+{
+    ret_code_t err_code;
+    uint32_t   len;
+
+    VERIFY_PARAM_NOT_NULL(p_image);
+    VERIFY_PARAM_NOT_NULL(p_image->p_buf);
+
+    p_image->field_count = 0;
+    p_image->len         = 0;
+
+    len      = p_image->buf_size;
+    err_code = nfc_ndef_msg_encode(p_ndef_msg_desc, p_image->p_buf, &len);
+    VERIFY_SUCCESS(err_code);
+
+    p_image->len = len;
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nfc_ndef_msg_image_field_add(nfc_ndef_msg_image_t * p_image,
+                                        uint8_t                field_id,
+                                        uint8_t const        * p_field,
+                                        uint8_t                length)
+{
+    nfc_ndef_msg_image_field_t * p_new;
+
+    VERIFY_PARAM_NOT_NULL(p_image);
+    VERIFY_PARAM_NOT_NULL(p_field);
+
+    if ((p_field < p_image->p_buf) ||
+        (p_field + length > p_image->p_buf + p_image->buf_size) ||
+        (p_field - p_image->p_buf > UINT16_MAX))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if (p_image->field_count >= p_image->max_field_count)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    p_new           = &p_image->p_fields[p_image->field_count++];
+    p_new->offset   = (uint16_t)(p_field - p_image->p_buf);
+    p_new->length   = length;
+    p_new->field_id = field_id;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nfc_ndef_msg_image_field_update(nfc_ndef_msg_image_t * p_image,
+                                           uint8_t                field_id,
+                                           uint8_t const        * p_data,
+                                           uint8_t                length)
+{
+    bool found = false;
+
+    VERIFY_PARAM_NOT_NULL(p_image);
+    VERIFY_PARAM_NOT_NULL(p_data);
+
+    for (uint8_t i = 0; i < p_image->field_count; i++)
+    {
+        if (p_image->p_fields[i].field_id == field_id)
+        {
+            if (p_image->p_fields[i].length != length)
+            {
+                return NRF_ERROR_INVALID_LENGTH;
+            }
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    for (uint8_t i = 0; i < p_image->field_count; i++)
+    {
+        if (p_image->p_fields[i].field_id == field_id)
+        {
+            // The tag library reads the buffer in interrupt context.
+            CRITICAL_REGION_ENTER();
+            memcpy(p_image->p_buf + p_image->p_fields[i].offset, p_data, length);
+            CRITICAL_REGION_EXIT();
+        }
+    }
+
+    return NRF_SUCCESS;
+}
@@ -0,0 +1,157 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef NFC_NDEF_MSG_IMAGE_H__
+#define NFC_NDEF_MSG_IMAGE_H__
+
+#include <stdint.h>
+#include "nfc_ndef_msg.h"
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**@file
+ *
+ * @defgroup nfc_ndef_msg_image Compiled NDEF message images
+ * @{
+ * @ingroup  nfc_modules
+ *
+ * @brief    NDEF messages that are encoded once, and of which single fields are updated in place.
+ *
+ * @details  The message is encoded into the buffer of the image, which is also the payload
+ *           buffer of the tag: the buffer given to @ref nfc_t2t_payload_set, or to
+ *           @ref nfc_t4t_ndef_rwpayload_set or @ref nfc_t4t_ndef_staticpayload_set. The
+ *           offsets of the fields that change are recorded in the image. An update only
+ *           writes the bytes of these fields, so the tag emulation can keep running.
+ *
+ *           The field bytes are written in a critical region, so a reader never gets a field
+ *           that is partly updated. The length of a field cannot change.
+ */
+
+/**
+ * @brief Mutable field of an NDEF message image.
+ */
+typedef struct
+{
+    uint16_t offset;   ///< Offset of the field from the start of the image buffer.
+    uint8_t  length;   ///< Length of the field in bytes.
+    uint8_t  field_id; ///< Identifier of the field, given by the encoder. Several fields can share it.
+} nfc_ndef_msg_image_field_t;
+
+/**
+ * @brief NDEF message image.
+ */
+typedef struct
+{
+    uint8_t                    * p_buf;           ///< Buffer of the encoded message.
+    uint32_t                     buf_size;        ///< Size of the buffer.
+    uint32_t                     len;             ///< Length of the encoded message.
+    nfc_ndef_msg_image_field_t * p_fields;        ///< Array of the mutable fields.
+    uint8_t                      field_count;     ///< Number of recorded fields.
+    uint8_t                      max_field_count; ///< Number of elements of p_fields.
+} nfc_ndef_msg_image_t;
+
+/**@brief Macro for creating and initializing an NDEF message image.
+ *
+ * This macro creates a static buffer, a static array of fields and a static instance of
+ * type @ref nfc_ndef_msg_image_t that uses them.
+ * Use the macro @ref NFC_NDEF_MSG_IMAGE to access the instance.
+ *
+ * @param[in]  NAME             Name of the image.
+ * @param[in]  BUF_SIZE         Size of the buffer of the message.
+ * @param[in]  MAX_FIELD_CNT    Maximal number of mutable fields.
+ */
+#define NFC_NDEF_MSG_IMAGE_DEF(NAME, BUF_SIZE, MAX_FIELD_CNT)                     \
+    static uint8_t                    NAME##_nfc_ndef_image_buf[BUF_SIZE];        \
+    static nfc_ndef_msg_image_field_t NAME##_nfc_ndef_image_fields[MAX_FIELD_CNT]; \
+    static nfc_ndef_msg_image_t NAME##_nfc_ndef_image =                           \
+        {                                                                         \
+            .p_buf           = NAME##_nfc_ndef_image_buf,                         \
+            .buf_size        = BUF_SIZE,                                          \
+            .len             = 0,                                                 \
+            .p_fields        = NAME##_nfc_ndef_image_fields,                      \
+            .field_count     = 0,                                                 \
+            .max_field_count = MAX_FIELD_CNT                                      \
+        }
+
+/** @brief Macro for accessing the NDEF message image that you created with
+ *         @ref NFC_NDEF_MSG_IMAGE_DEF.
+ */
+#define NFC_NDEF_MSG_IMAGE(NAME) (NAME##_nfc_ndef_image)
+
+/**
+ * @brief Function for encoding an NDEF message into an image.
+ *
+ * The recorded fields are cleared. Payload constructors that write mutable fields can
+ * record them with @ref nfc_ndef_msg_image_field_add while the message is encoded, or the
+ * application can record them afterwards.
+ *
+ * @param[in,out] p_image          Pointer to the image.
+ * @param[in]     p_ndef_msg_desc  Pointer to the message descriptor.
+ *
+ * @retval NRF_SUCCESS     If the message was encoded.
+ * @retval NRF_ERROR_NULL  If a pointer is NULL.
+ * @return Any error returned by @ref nfc_ndef_msg_encode.
+ */
+ret_code_t nfc_ndef_msg_image_encode(nfc_ndef_msg_image_t      * p_image,
+                                     nfc_ndef_msg_desc_t const * p_ndef_msg_desc);
+
+/**
+ * @brief Function for recording a mutable field of an image.
+ *
+ * @param[in,out] p_image   Pointer to the image.
+ * @param[in]     field_id  Identifier of the field.
+ * @param[in]     p_field   Pointer to the field in the buffer of the image.
+ * @param[in]     length    Length of the field in bytes.
+ *
+ * @retval NRF_SUCCESS              If the field was recorded.
+ * @retval NRF_ERROR_NULL           If a pointer is NULL.
+ * @retval NRF_ERROR_INVALID_PARAM  If the field is not inside the buffer of the image.
+ * @retval NRF_ERROR_NO_MEM         If the maximal number of fields is already recorded.
+ */
+ret_code_t nfc_ndef_msg_image_field_add(nfc_ndef_msg_image_t * p_image,
+                                        uint8_t                field_id,
+                                        uint8_t const        * p_field,
+                                        uint8_t                length);
+
+/**
+ * @brief Function for updating the fields of an image in place.
+ *
+ * All fields with the identifier are written with the new data.
+ *
+ * @param[in,out] p_image   Pointer to the image.
+ * @param[in]     field_id  Identifier of the fields.
+ * @param[in]     p_data    New data of the fields.
+ * @param[in]     length    Length of the data, which must be the length of the fields.
+ *
+ * @retval NRF_SUCCESS               If the fields were updated.
+ * @retval NRF_ERROR_NULL            If a pointer is NULL.
+ * @retval NRF_ERROR_NOT_FOUND       If the image has no field with the identifier.
+ * @retval NRF_ERROR_INVALID_LENGTH  If the length differs from the length of a field.
+ *                                   No field is updated then.
+ */
+ret_code_t nfc_ndef_msg_image_field_update(nfc_ndef_msg_image_t * p_image,
+                                           uint8_t                field_id,
+                                           uint8_t const        * p_data,
+                                           uint8_t                length);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NFC_NDEF_MSG_IMAGE_H__
@@ -51,6 +51,82 @@ ret_code_t ndef_msg_parser(uint8_t  * const p_result_buf,
 }
 
 
+void ndef_msg_iter_init(nfc_ndef_msg_iter_t * p_iter,
+                        uint8_t const       * p_nfc_data,
+                        uint32_t              nfc_data_len)
+{
+    p_iter->p_nfc_data    = p_nfc_data;
+    p_iter->nfc_data_left = nfc_data_len;
+    p_iter->record_count  = 0;
+    p_iter->last          = false;
+}
+
+
+ret_code_t ndef_msg_iter_next(nfc_ndef_msg_iter_t    * p_iter,
+                              nfc_ndef_record_view_t * p_view)
+{
+    nfc_ndef_record_location_t record_location;
+    uint32_t                   record_len;
+    ret_code_t                 ret_code;
+
+    if (p_iter->last)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    if (p_iter->nfc_data_left == 0)
+    {
+        // The data ended before the last record.
+        return NRF_ERROR_INVALID_DATA;
+    }
+
+    record_len = p_iter->nfc_data_left;
+    ret_code   = ndef_record_view_parser(p_view, &record_location, p_iter->p_nfc_data, &record_len);
+    VERIFY_SUCCESS(ret_code);
+
+    // verify the records location flags
+    if (p_iter->record_count == 0)
+    {
+        if ((record_location != NDEF_FIRST_RECORD) && (record_location != NDEF_LONE_RECORD))
+        {
+            return NRF_ERROR_INVALID_DATA;
+        }
+    }
+    else
+    {
+        if ((record_location != NDEF_MIDDLE_RECORD) && (record_location != NDEF_LAST_RECORD))
+        {
+            return NRF_ERROR_INVALID_DATA;
+        }
+    }
+
+    p_iter->p_nfc_data    += record_len;
+    p_iter->nfc_data_left -= record_len;
+    p_iter->record_count++;
+    p_iter->last = (record_location == NDEF_LAST_RECORD) || (record_location == NDEF_LONE_RECORD);
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ndef_msg_iter_find(nfc_ndef_msg_iter_t    * p_iter,
+                              nfc_ndef_record_tnf_t    tnf,
+                              uint8_t const          * p_type,
+                              uint8_t                  type_len,
+                              nfc_ndef_record_view_t * p_view)
+{
+    ret_code_t ret_code;
+
+    do
+    {
+        ret_code = ndef_msg_iter_next(p_iter, p_view);
+        VERIFY_SUCCESS(ret_code);
+    } while (!ndef_record_view_type_match(p_view, tnf, p_type, type_len));
+
+    return NRF_SUCCESS;
+}
+
+
 void ndef_msg_printout(nfc_ndef_msg_desc_t * const p_msg_desc)
 {
     uint32_t i;
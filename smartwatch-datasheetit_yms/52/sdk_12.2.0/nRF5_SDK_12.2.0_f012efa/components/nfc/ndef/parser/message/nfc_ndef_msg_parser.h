@@ -30,6 +30,7 @@
  */
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "nfc_ndef_msg_parser_local.h"
 
 #ifdef __cplusplus
@@ -74,6 +75,66 @@ ret_code_t ndef_msg_parser(uint8_t  * const p_result_buf,
                            uint8_t  * const p_nfc_data,
                            uint32_t * const p_nfc_data_len);
 
+/**
+ * @brief Iterator over the records of an NDEF message.
+ *
+ * The iterator parses the message in a single pass, one record at a time, and gives views
+ * of the records (@ref nfc_ndef_record_view_t) that point into the parsed data. It needs no
+ * memory for record descriptors, so the parsing can stop at the first record of interest.
+ */
+typedef struct
+{
+    uint8_t const * p_nfc_data;    ///< Pointer to the next record.
+    uint32_t        nfc_data_left; ///< Size of the data that is left.
+    uint32_t        record_count;  ///< Number of records given by the iterator.
+    bool            last;          ///< True when the last record of the message was given.
+} nfc_ndef_msg_iter_t;
+
+/**
+ * @brief Function for initializing an iterator over the records of an NDEF message.
+ *
+ * @param[out] p_iter         Pointer to the iterator.
+ * @param[in]  p_nfc_data     Pointer to the data to be parsed. It must stay valid while the
+ *                            iterator and the record views are used.
+ * @param[in]  nfc_data_len   Size of the NFC data in the @p p_nfc_data buffer.
+ */
+void ndef_msg_iter_init(nfc_ndef_msg_iter_t * p_iter,
+                        uint8_t const       * p_nfc_data,
+                        uint32_t              nfc_data_len);
+
+/**
+ * @brief Function for getting the next record of an NDEF message.
+ *
+ * @param[in,out] p_iter   Pointer to the iterator.
+ * @param[out]    p_view   Pointer to the view of the record.
+ *
+ * @retval NRF_SUCCESS               If the record was parsed.
+ * @retval NRF_ERROR_NOT_FOUND       If the last record of the message was already given.
+ * @retval NRF_ERROR_INVALID_LENGTH  If the expected record length is bigger than the amount of the provided input data.
+ * @retval NRF_ERROR_INVALID_DATA    If the message is not a valid NDEF message.
+ */
+ret_code_t ndef_msg_iter_next(nfc_ndef_msg_iter_t    * p_iter,
+                              nfc_ndef_record_view_t * p_view);
+
+/**
+ * @brief Function for finding the next record of an NDEF message with a given TNF and type.
+ *
+ * @param[in,out] p_iter     Pointer to the iterator.
+ * @param[in]     tnf        TNF of the record.
+ * @param[in]     p_type     Type of the record.
+ * @param[in]     type_len   Length of the type.
+ * @param[out]    p_view     Pointer to the view of the record.
+ *
+ * @retval NRF_SUCCESS          If a record was found.
+ * @retval NRF_ERROR_NOT_FOUND  If the message has no more records of this type.
+ * @return Any other error returned by @ref ndef_msg_iter_next.
+ */
+ret_code_t ndef_msg_iter_find(nfc_ndef_msg_iter_t    * p_iter,
+                              nfc_ndef_record_tnf_t    tnf,
+                              uint8_t const          * p_type,
+                              uint8_t                  type_len,
+                              nfc_ndef_record_view_t * p_view);
+
 /**
  * @brief Function for printing the parsed contents of an NDEF message.
  *
@@ -15,6 +15,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include "nfc_ndef_record_parser.h"
 #include "app_util.h"
 #include "nordic_common.h"
@@ -32,116 +33,203 @@
 /* Sum of sizes of fields: TNF-flags, Type Length, Payload Length in short NDEF record. */
 #define NDEF_RECORD_BASE_LONG_SHORT (2 + NDEF_RECORD_PAYLOAD_LEN_SHORT_SIZE)
 
-
-ret_code_t ndef_record_parser(nfc_ndef_bin_payload_desc_t * p_bin_pay_desc,
-                              nfc_ndef_record_desc_t      * p_rec_desc,
-                              nfc_ndef_record_location_t  * p_record_location,
-                              uint8_t const               * p_nfc_data,
-                              uint32_t                    * p_nfc_data_len)
+/**
+ * @brief Lengths of the parts of an NDEF record, decoded from its header.
+ */
+typedef struct
 {
+    uint32_t header_length;  ///< Length of the header: flags, lengths and the ID length field.
+    uint32_t payload_length;
+    uint8_t  type_length;
+    uint8_t  id_length;
+} record_header_t;
+
+/**
+ * @brief Decode the header of an NDEF record.
+ *
+ * @retval NRF_SUCCESS               If the whole record is in the data.
+ * @retval NRF_ERROR_INVALID_LENGTH  If the record is longer than the data.
+ */
+static ret_code_t record_header_decode(uint8_t const   * p_nfc_data,
+                                       uint32_t          nfc_data_len,
+                                       record_header_t * p_header)
+{
+    uint8_t  flags;
     uint32_t expected_rec_size = NDEF_RECORD_BASE_LONG_SHORT;
 
-    if (expected_rec_size > *p_nfc_data_len)
+    if (expected_rec_size > nfc_data_len)
     {
         return NRF_ERROR_INVALID_LENGTH;
     }
 
-    p_rec_desc->tnf = (nfc_ndef_record_tnf_t) ((*p_nfc_data) & NDEF_RECORD_TNF_MASK);
-
-    /* An NDEF parser that receives an NDEF record with an unknown or unsupported TNF field value
-       SHOULD treat it as Unknown. See NFCForum-TS-NDEF_1.0 */
-    if (p_rec_desc->tnf == TNF_RESERVED)
-    {
-        p_rec_desc->tnf = TNF_UNKNOWN_TYPE;
-    }
-
-    *p_record_location = (nfc_ndef_record_location_t) ((*p_nfc_data) & NDEF_RECORD_LOCATION_MASK);
-
-    uint8_t flags = *(p_nfc_data++);
-
-    p_rec_desc->type_length = *(p_nfc_data++);
-
-    uint32_t payload_lenght;
+    flags                 = p_nfc_data[0];
+    p_header->type_length = p_nfc_data[1];
 
     if (flags & NDEF_RECORD_SR_MASK)
     {
-        payload_lenght = *(p_nfc_data++);
+        p_header->payload_length = p_nfc_data[2];
     }
     else
     {
         expected_rec_size +=
             NDEF_RECORD_PAYLOAD_LEN_LONG_SIZE - NDEF_RECORD_PAYLOAD_LEN_SHORT_SIZE;
 
-        if (expected_rec_size > *p_nfc_data_len)
+        if (expected_rec_size > nfc_data_len)
         {
             return NRF_ERROR_INVALID_LENGTH;
         }
 
-        payload_lenght = uint32_big_decode(p_nfc_data);
-        p_nfc_data    += NDEF_RECORD_PAYLOAD_LEN_LONG_SIZE;
+        p_header->payload_length = uint32_big_decode(&p_nfc_data[2]);
     }
 
     if (flags & NDEF_RECORD_IL_MASK)
     {
         expected_rec_size += NDEF_RECORD_ID_LEN_SIZE;
 
-        if (expected_rec_size > *p_nfc_data_len)
+        if (expected_rec_size > nfc_data_len)
         {
             return NRF_ERROR_INVALID_LENGTH;
         }
 
-        p_rec_desc->id_length = *(p_nfc_data++);
+        p_header->id_length = p_nfc_data[expected_rec_size - NDEF_RECORD_ID_LEN_SIZE];
     }
     else
     {
-        p_rec_desc->id_length = 0;
-        p_rec_desc->p_id      = NULL;
+        p_header->id_length = 0;
     }
 
-    expected_rec_size += p_rec_desc->type_length + p_rec_desc->id_length + payload_lenght;
+    p_header->header_length = expected_rec_size;
 
-    if (expected_rec_size > *p_nfc_data_len)
+    // Compare without adding, so that a huge payload length cannot wrap around.
+    if ((uint32_t)p_header->type_length + p_header->id_length > nfc_data_len - expected_rec_size ||
+        p_header->payload_length >
+        nfc_data_len - expected_rec_size - p_header->type_length - p_header->id_length)
     {
         return NRF_ERROR_INVALID_LENGTH;
     }
 
-    if (p_rec_desc->type_length > 0)
-    {
-        p_rec_desc->p_type = p_nfc_data;
+    return NRF_SUCCESS;
+}
 
-        p_nfc_data += p_rec_desc->type_length;
-    }
-    else
-    {
-        p_rec_desc->p_type = NULL;
-    }
 
-    if (p_rec_desc->id_length > 0)
-    {
-        p_rec_desc->p_id = p_nfc_data;
+ret_code_t ndef_record_parser(nfc_ndef_bin_payload_desc_t * p_bin_pay_desc,
+                              nfc_ndef_record_desc_t      * p_rec_desc,
+                              nfc_ndef_record_location_t  * p_record_location,
+                              uint8_t const               * p_nfc_data,
+                              uint32_t                    * p_nfc_data_len)
+{
+    nfc_ndef_record_view_t view;
+    ret_code_t             err_code;
 
-        p_nfc_data += p_rec_desc->id_length;
-    }
+    err_code = ndef_record_view_parser(&view, p_record_location, p_nfc_data, p_nfc_data_len);
+    VERIFY_SUCCESS(err_code);
 
-    if (payload_lenght == 0)
-    {
-        p_bin_pay_desc->p_payload = NULL;
-    }
-    else
-    {
-        p_bin_pay_desc->p_payload = p_nfc_data;
-    }
+    /* An NDEF parser that receives an NDEF record with an unknown or unsupported TNF field value
+       SHOULD treat it as Unknown. See NFCForum-TS-NDEF_1.0 */
+    p_rec_desc->tnf    = ndef_record_view_tnf_get(&view);
+    p_rec_desc->p_type = ndef_record_view_type_get(&view, &p_rec_desc->type_length);
+    p_rec_desc->p_id   = ndef_record_view_id_get(&view, &p_rec_desc->id_length);
 
-    p_bin_pay_desc->payload_length = payload_lenght;
+    p_bin_pay_desc->p_payload = ndef_record_view_payload_get(&view, &p_bin_pay_desc->payload_length);
 
     p_rec_desc->p_payload_descriptor = p_bin_pay_desc;
     p_rec_desc->payload_constructor  = (p_payload_constructor_t) nfc_ndef_bin_payload_memcopy;
 
-    *p_nfc_data_len = expected_rec_size;
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ndef_record_view_parser(nfc_ndef_record_view_t     * p_view,
+                                   nfc_ndef_record_location_t * p_record_location,
+                                   uint8_t const              * p_nfc_data,
+                                   uint32_t                   * p_nfc_data_len)
+{
+    record_header_t header;
+    ret_code_t      err_code;
+
+    err_code = record_header_decode(p_nfc_data, *p_nfc_data_len, &header);
+    VERIFY_SUCCESS(err_code);
+
+    *p_record_location = (nfc_ndef_record_location_t) ((*p_nfc_data) & NDEF_RECORD_LOCATION_MASK);
+
+    p_view->p_record = p_nfc_data;
+    p_view->length   = header.header_length + header.type_length + header.id_length +
+                       header.payload_length;
+
+    *p_nfc_data_len = p_view->length;
 
     return NRF_SUCCESS;
 }
 
+
+nfc_ndef_record_tnf_t ndef_record_view_tnf_get(nfc_ndef_record_view_t const * p_view)
+{
+    nfc_ndef_record_tnf_t tnf = (nfc_ndef_record_tnf_t) (p_view->p_record[0] & NDEF_RECORD_TNF_MASK);
+
+    return (tnf == TNF_RESERVED) ? TNF_UNKNOWN_TYPE : tnf;
+}
+
+
+uint8_t const * ndef_record_view_type_get(nfc_ndef_record_view_t const * p_view,
+                                          uint8_t                      * p_type_len)
+{
+    record_header_t header;
+
+    // The view was checked when it was parsed.
+    UNUSED_RETURN_VALUE(record_header_decode(p_view->p_record, p_view->length, &header));
+
+    *p_type_len = header.type_length;
+    return (header.type_length > 0) ? (p_view->p_record + header.header_length) : NULL;
+}
+
+
+uint8_t const * ndef_record_view_id_get(nfc_ndef_record_view_t const * p_view,
+                                        uint8_t                      * p_id_len)
+{
+    record_header_t header;
+
+    UNUSED_RETURN_VALUE(record_header_decode(p_view->p_record, p_view->length, &header));
+
+    *p_id_len = header.id_length;
+    return (header.id_length > 0) ?
+           (p_view->p_record + header.header_length + header.type_length) : NULL;
+}
+
+
+uint8_t const * ndef_record_view_payload_get(nfc_ndef_record_view_t const * p_view,
+                                             uint32_t                     * p_payload_len)
+{
+    record_header_t header;
+
+    UNUSED_RETURN_VALUE(record_header_decode(p_view->p_record, p_view->length, &header));
+
+    *p_payload_len = header.payload_length;
+    return (header.payload_length > 0) ?
+           (p_view->p_record + header.header_length + header.type_length + header.id_length) :
+           NULL;
+}
+
+
+bool ndef_record_view_type_match(nfc_ndef_record_view_t const * p_view,
+                                 nfc_ndef_record_tnf_t          tnf,
+                                 uint8_t const                * p_type,
+                                 uint8_t                        type_len)
+{
+    uint8_t         rec_type_len;
+    uint8_t const * p_rec_type;
+
+    if (ndef_record_view_tnf_get(p_view) != tnf)
+    {
+        return false;
+    }
+
+    p_rec_type = ndef_record_view_type_get(p_view, &rec_type_len);
+
+    return (rec_type_len == type_len) &&
+           ((type_len == 0) || (memcmp(p_rec_type, p_type, type_len) == 0));
+}
+
+
 char const * const tnf_strings[] =
 {
     "Empty\r\n",
@@ -14,6 +14,7 @@
 #define NFC_NDEF_RECORD_PARSER_H__
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "sdk_errors.h"
 #include "nfc_ndef_record.h"
 
@@ -52,6 +53,94 @@ ret_code_t ndef_record_parser(nfc_ndef_bin_payload_desc_t * p_bin_pay_desc,
                               uint8_t const               * p_nfc_data,
                               uint32_t                    * p_nfc_data_len);
 
+/**
+ * @brief View of an NDEF record in the parsed data.
+ *
+ * Only the location and the length of the record are kept. The type, the ID and the payload
+ * are found in the record by the view functions when they are needed.
+ */
+typedef struct
+{
+    uint8_t const * p_record; ///< Pointer to the first byte of the record in the parsed data.
+    uint32_t        length;   ///< Length of the whole record.
+} nfc_ndef_record_view_t;
+
+/**
+ * @brief Function for parsing an NDEF record into a view.
+ *
+ * Only the header of the record is read, to check and to skip the record. Nothing is copied.
+ *
+ * @param[out]    p_view             Pointer to the view of the record.
+ * @param[out]    p_record_location  Pointer to the record location.
+ * @param[in]     p_nfc_data         Pointer to the raw data to be parsed. It must stay valid while the view is used.
+ * @param[in,out] p_nfc_data_len     As input: size of the NFC data in the @p p_nfc_data buffer. As output: size of the parsed record.
+ *
+ * @retval NRF_SUCCESS               If the function completed successfully.
+ * @retval NRF_ERROR_INVALID_LENGTH  If the expected record length is bigger than the provided input data amount.
+ */
+ret_code_t ndef_record_view_parser(nfc_ndef_record_view_t     * p_view,
+                                   nfc_ndef_record_location_t * p_record_location,
+                                   uint8_t const              * p_nfc_data,
+                                   uint32_t                   * p_nfc_data_len);
+
+/**
+ * @brief Function for getting the TNF of a record view.
+ *
+ * @param[in] p_view  Pointer to the view of the record.
+ *
+ * @return TNF of the record. A reserved TNF is reported as @ref TNF_UNKNOWN_TYPE.
+ */
+nfc_ndef_record_tnf_t ndef_record_view_tnf_get(nfc_ndef_record_view_t const * p_view);
+
+/**
+ * @brief Function for getting the type of a record view.
+ *
+ * @param[in]  p_view       Pointer to the view of the record.
+ * @param[out] p_type_len   Length of the type.
+ *
+ * @return Pointer to the type in the parsed data, or NULL if the record has no type.
+ */
+uint8_t const * ndef_record_view_type_get(nfc_ndef_record_view_t const * p_view,
+                                          uint8_t                      * p_type_len);
+
+/**
+ * @brief Function for getting the ID of a record view.
+ *
+ * @param[in]  p_view      Pointer to the view of the record.
+ * @param[out] p_id_len    Length of the ID.
+ *
+ * @return Pointer to the ID in the parsed data, or NULL if the record has no ID.
+ */
+uint8_t const * ndef_record_view_id_get(nfc_ndef_record_view_t const * p_view,
+                                        uint8_t                      * p_id_len);
+
+/**
+ * @brief Function for getting the payload of a record view.
+ *
+ * @param[in]  p_view          Pointer to the view of the record.
+ * @param[out] p_payload_len   Length of the payload.
+ *
+ * @return Pointer to the payload in the parsed data, or NULL if the record has no payload.
+ */
+uint8_t const * ndef_record_view_payload_get(nfc_ndef_record_view_t const * p_view,
+                                             uint32_t                     * p_payload_len);
+
+/**
+ * @brief Function for checking the TNF and the type of a record view.
+ *
+ * @param[in] p_view     Pointer to the view of the record.
+ * @param[in] tnf        Expected TNF.
+ * @param[in] p_type     Expected type.
+ * @param[in] type_len   Length of the expected type.
+ *
+ * @retval true   If the record has the TNF and the type.
+ * @retval false  Otherwise.
+ */
+bool ndef_record_view_type_match(nfc_ndef_record_view_t const * p_view,
+                                 nfc_ndef_record_tnf_t          tnf,
+                                 uint8_t const                * p_type,
+                                 uint8_t                        type_len);
+
 /**
  * @brief Function for printing the parsed contents of the NDEF record.
  *
@@ -0,0 +1,442 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "sdk_config.h"
+#if NFC_T4T_RESP_CACHE_ENABLED
+
+#include <string.h>
+#include "nfc_t4t_resp_cache.h"
+#include "sdk_macros.h"
+#include "nordic_common.h"
+#include "app_util.h"
+#include "app_util_platform.h"
+
+/**
+ * @brief Fields of a C-APDU.
+ */
+#define CAPDU_CLA             0U
+#define CAPDU_INS             1U
+#define CAPDU_P1              2U
+#define CAPDU_P2              3U
+#define CAPDU_LC              4U
+#define CAPDU_DATA            5U
+#define CAPDU_HEADER_SIZE     4U
+
+#define CLA_NO_SECURE_MSG     0x00
+#define INS_SELECT            0xA4
+#define INS_READ_BINARY       0xB0
+#define INS_UPDATE_BINARY     0xD6
+#define SELECT_BY_NAME        0x0400
+#define SELECT_BY_FILE_ID     0x000C
+#define READ_OFFSET_SFI_FLAG  0x8000 ///< P1 bit 8: P1 holds a short file identifier, not supported.
+
+#define STATUS_SIZE           2U
+
+/**
+ * @brief Fields of the CC file.
+ */
+#define CC_MAPPING_VERSION    0x20   ///< Type 4 Tag version 2.0.
+#define CC_NDEF_TLV_TAG       0x04   ///< NDEF File Control TLV.
+#define CC_NDEF_TLV_LEN       0x06
+#define CC_READ_ACCESS        0x00   ///< Read access granted without any security.
+#define CC_WRITE_ACCESS_NONE  0xFF   ///< No write access.
+#define CC_MLC                0x0001 ///< UPDATE BINARY is refused, so no data is accepted.
+
+#define NLEN_SIZE             2U
+
+#if (NFC_T4T_RESP_CACHE_MLE < NFC_T4T_RESP_CACHE_CC_LEN) || (NFC_T4T_RESP_CACHE_MLE > 0xFF)
+#error NFC_T4T_RESP_CACHE_MLE must be between NFC_T4T_RESP_CACHE_CC_LEN and 255.
+#endif
+
+typedef enum
+{
+    FILE_NONE,
+    FILE_CC,
+    FILE_NDEF
+} file_t;
+
+/**
+ * @brief Read of a file slice.
+ */
+typedef struct
+{
+    file_t   file;
+    uint16_t offset;
+    uint16_t len;
+} slice_t;
+
+static const uint8_t m_ndef_aid[]       = {0xD2, 0x76, 0x00, 0x00, 0x85, 0x01, 0x01};
+static const uint8_t m_sw_ok[]          = {0x90, 0x00};
+static const uint8_t m_sw_wrong_len[]   = {0x67, 0x00};
+static const uint8_t m_sw_denied[]      = {0x69, 0x82}; ///< Security status not satisfied.
+static const uint8_t m_sw_no_ef[]       = {0x69, 0x86}; ///< Command not allowed, no current EF.
+static const uint8_t m_sw_wrong_p1p2[]  = {0x6A, 0x86};
+static const uint8_t m_sw_not_found[]   = {0x6A, 0x82};
+static const uint8_t m_sw_wrong_off[]   = {0x6B, 0x00};
+static const uint8_t m_sw_bad_ins[]     = {0x6D, 0x00};
+static const uint8_t m_sw_bad_cla[]     = {0x6E, 0x00};
+
+static uint8_t const * mp_ndef_file;
+static uint16_t        m_ndef_file_len;
+static uint8_t         m_cc_resp[NFC_T4T_RESP_CACHE_CC_LEN + STATUS_SIZE];   ///< CC file and status.
+static uint8_t         m_nlen_resp[NLEN_SIZE + STATUS_SIZE];                 ///< NLEN and status.
+static uint8_t         m_resp[2][NFC_T4T_RESP_CACHE_MLE + STATUS_SIZE];      ///< Slice responses.
+static uint8_t         m_resp_sent;        ///< Index of the slice response buffer used last.
+static slice_t         m_prefetch;         ///< Slice in the other buffer, if valid.
+static bool            m_prefetch_valid;
+static slice_t         m_next;             ///< Slice to prefetch when the response is sent.
+static bool            m_next_pending;
+static file_t          m_file;             ///< Selected file.
+static bool            m_app_selected;
+static uint8_t         m_capdu[NFC_T4T_RESP_CACHE_CAPDU_MAX];
+static uint16_t        m_capdu_len;
+static bool            m_capdu_overflow;
+
+static nfc_t4t_resp_cache_stats_t m_stats;
+
+
+static void file_get(file_t file, uint8_t const ** pp_data, uint16_t * p_len)
+{
+    if (file == FILE_CC)
+    {
+        *pp_data = m_cc_resp;
+        *p_len   = NFC_T4T_RESP_CACHE_CC_LEN;
+    }
+    else
+    {
+        *pp_data = mp_ndef_file;
+        *p_len   = m_ndef_file_len;
+    }
+}
+
+
+/**
+ * @brief Function for copying a slice of a file into a response buffer, followed by the status.
+ */
+static uint16_t slice_build(uint8_t * p_resp, slice_t const * p_slice)
+{
+    uint8_t const * p_data;
+    uint16_t        len;
+
+    file_get(p_slice->file, &p_data, &len);
+    memcpy(p_resp, &p_data[p_slice->offset], p_slice->len);
+    memcpy(&p_resp[p_slice->len], m_sw_ok, STATUS_SIZE);
+
+    return p_slice->len + STATUS_SIZE;
+}
+
+
+static void state_reset(void)
+{
+    m_app_selected   = false;
+    m_file           = FILE_NONE;
+    m_capdu_len      = 0;
+    m_capdu_overflow = false;
+    m_next_pending   = false;
+}
+
+
+static void resp_send(uint8_t const * p_resp, uint16_t len)
+{
+    m_stats.apdus++;
+    if ((len == STATUS_SIZE) && (p_resp != m_sw_ok))
+    {
+        m_stats.errors++;
+    }
+    UNUSED_RETURN_VALUE(nfc_t4t_response_pdu_send(p_resp, len));
+}
+
+
+static void select_process(uint8_t const * p_capdu, uint16_t len)
+{
+    uint16_t p1p2 = uint16_big_decode(&p_capdu[CAPDU_P1]);
+    uint8_t  lc;
+
+    if ((len <= CAPDU_LC) || (len < CAPDU_DATA + p_capdu[CAPDU_LC]))
+    {
+        resp_send(m_sw_wrong_len, STATUS_SIZE);
+        return;
+    }
+    lc = p_capdu[CAPDU_LC];
+
+    if (p1p2 == SELECT_BY_NAME)
+    {
+        m_file         = FILE_NONE;
+        m_app_selected = (lc == sizeof(m_ndef_aid)) &&
+                         (memcmp(&p_capdu[CAPDU_DATA], m_ndef_aid, sizeof(m_ndef_aid)) == 0);
+        resp_send(m_app_selected ? m_sw_ok : m_sw_not_found, STATUS_SIZE);
+    }
+    else if (p1p2 == SELECT_BY_FILE_ID)
+    {
+        uint16_t file_id = (lc == 2) ? uint16_big_decode(&p_capdu[CAPDU_DATA]) : 0;
+
+        if (m_app_selected && (file_id == NFC_T4T_RESP_CACHE_CC_ID))
+        {
+            m_file = FILE_CC;
+        }
+        else if (m_app_selected && (file_id == NFC_T4T_RESP_CACHE_NDEF_ID))
+        {
+            m_file = FILE_NDEF;
+        }
+        else
+        {
+            resp_send(m_sw_not_found, STATUS_SIZE);
+            return;
+        }
+        resp_send(m_sw_ok, STATUS_SIZE);
+    }
+    else
+    {
+        resp_send(m_sw_wrong_p1p2, STATUS_SIZE);
+    }
+}
+
+
+static void read_process(uint8_t const * p_capdu, uint16_t len)
+{
+    uint8_t const * p_data;
+    uint16_t        file_len;
+    slice_t         slice;
+    uint16_t        le;
+
+    if ((len != CAPDU_HEADER_SIZE) && (len != CAPDU_HEADER_SIZE + 1))
+    {
+        resp_send(m_sw_wrong_len, STATUS_SIZE);
+        return;
+    }
+    if (m_file == FILE_NONE)
+    {
+        resp_send(m_sw_no_ef, STATUS_SIZE);
+        return;
+    }
+
+    slice.file   = m_file;
+    slice.offset = uint16_big_decode(&p_capdu[CAPDU_P1]);
+    file_get(slice.file, &p_data, &file_len);
+    if ((slice.offset & READ_OFFSET_SFI_FLAG) || (slice.offset > file_len))
+    {
+        resp_send(m_sw_wrong_off, STATUS_SIZE);
+        return;
+    }
+
+    // Le of 0, or absent, asks for 256 bytes.
+    le        = ((len == CAPDU_HEADER_SIZE) || (p_capdu[CAPDU_HEADER_SIZE] == 0)) ?
+                256 : p_capdu[CAPDU_HEADER_SIZE];
+    slice.len = MIN(MIN(le, NFC_T4T_RESP_CACHE_MLE), file_len - slice.offset);
+
+    if (slice.len == 0)
+    {
+        resp_send(m_sw_ok, STATUS_SIZE);
+        return;
+    }
+
+    // The reader usually goes on with the next slice of the same size.
+    m_next.file    = slice.file;
+    m_next.offset  = slice.offset + slice.len;
+    m_next.len     = slice.len;
+    m_next_pending = (m_next.offset < file_len);
+
+    if ((slice.file == FILE_CC) && (slice.offset == 0) && (slice.len == NFC_T4T_RESP_CACHE_CC_LEN))
+    {
+        m_stats.cache_hits++;
+        resp_send(m_cc_resp, sizeof(m_cc_resp));
+    }
+    else if ((slice.file == FILE_NDEF) && (slice.offset == 0) && (slice.len == NLEN_SIZE))
+    {
+        m_stats.cache_hits++;
+        resp_send(m_nlen_resp, sizeof(m_nlen_resp));
+    }
+    else if (m_prefetch_valid && (m_prefetch.file == slice.file) &&
+             (m_prefetch.offset == slice.offset) && (m_prefetch.len == slice.len))
+    {
+        m_stats.cache_hits++;
+        m_prefetch_valid = false;
+        m_resp_sent      = m_resp_sent ^ 1;
+        resp_send(m_resp[m_resp_sent], slice.len + STATUS_SIZE);
+    }
+    else
+    {
+        m_stats.cache_miss++;
+        m_prefetch_valid = false;
+        m_resp_sent      = m_resp_sent ^ 1;
+        resp_send(m_resp[m_resp_sent], slice_build(m_resp[m_resp_sent], &slice));
+    }
+}
+
+
+static void capdu_process(uint8_t const * p_capdu, uint16_t len)
+{
+    if (len < CAPDU_HEADER_SIZE)
+    {
+        resp_send(m_sw_wrong_len, STATUS_SIZE);
+        return;
+    }
+    if (p_capdu[CAPDU_CLA] != CLA_NO_SECURE_MSG)
+    {
+        resp_send(m_sw_bad_cla, STATUS_SIZE);
+        return;
+    }
+
+    switch (p_capdu[CAPDU_INS])
+    {
+        case INS_SELECT:
+            select_process(p_capdu, len);
+            break;
+
+        case INS_READ_BINARY:
+            read_process(p_capdu, len);
+            break;
+
+        case INS_UPDATE_BINARY:
+            resp_send(m_sw_denied, STATUS_SIZE);
+            break;
+
+        default:
+            resp_send(m_sw_bad_ins, STATUS_SIZE);
+            break;
+    }
+}
+
+
+/**
+ * @brief Function for building the response to the expected next read, in the buffer that is
+ *        not in use.
+ */
+static void prefetch(void)
+{
+    uint8_t const * p_data;
+    uint16_t        file_len;
+
+    if (!m_next_pending)
+    {
+        return;
+    }
+    m_next_pending = false;
+
+    file_get(m_next.file, &p_data, &file_len);
+    m_next.len = MIN(m_next.len, file_len - m_next.offset);
+
+    (void)slice_build(m_resp[m_resp_sent ^ 1], &m_next);
+    m_prefetch       = m_next;
+    m_prefetch_valid = true;
+}
+
+
+static void nlen_resp_build(void)
+{
+    memcpy(m_nlen_resp, mp_ndef_file, NLEN_SIZE);
+    memcpy(&m_nlen_resp[NLEN_SIZE], m_sw_ok, STATUS_SIZE);
+}
+
+
+ret_code_t nfc_t4t_resp_cache_init(uint8_t const * p_ndef_file,
+                                   uint16_t        ndef_file_len,
+                                   uint16_t        max_file_size)
+{
+    uint8_t * p_cc = m_cc_resp;
+
+    VERIFY_PARAM_NOT_NULL(p_ndef_file);
+
+    if ((ndef_file_len < NLEN_SIZE) || (ndef_file_len > max_file_size))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    mp_ndef_file    = p_ndef_file;
+    m_ndef_file_len = ndef_file_len;
+
+    p_cc   += uint16_big_encode(NFC_T4T_RESP_CACHE_CC_LEN, p_cc);
+    *p_cc++ = CC_MAPPING_VERSION;
+    p_cc   += uint16_big_encode(NFC_T4T_RESP_CACHE_MLE, p_cc);
+    p_cc   += uint16_big_encode(CC_MLC, p_cc);
+    *p_cc++ = CC_NDEF_TLV_TAG;
+    *p_cc++ = CC_NDEF_TLV_LEN;
+    p_cc   += uint16_big_encode(NFC_T4T_RESP_CACHE_NDEF_ID, p_cc);
+    p_cc   += uint16_big_encode(max_file_size, p_cc);
+    *p_cc++ = CC_READ_ACCESS;
+    *p_cc++ = CC_WRITE_ACCESS_NONE;
+    memcpy(p_cc, m_sw_ok, STATUS_SIZE);
+
+    nlen_resp_build();
+    m_prefetch_valid = false;
+    m_resp_sent      = 0;
+    state_reset();
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    return NRF_SUCCESS;
+}
+
+
+void nfc_t4t_resp_cache_on_event(nfc_t4t_event_t event,
+                                 uint8_t const * p_data,
+                                 size_t          data_length,
+                                 uint32_t        flags)
+{
+    switch (event)
+    {
+        case NFC_T4T_EVENT_FIELD_ON:
+        case NFC_T4T_EVENT_FIELD_OFF:
+            state_reset();
+            break;
+
+        case NFC_T4T_EVENT_DATA_IND:
+            if (m_capdu_len + data_length > sizeof(m_capdu))
+            {
+                m_capdu_overflow = true;
+            }
+            else
+            {
+                memcpy(&m_capdu[m_capdu_len], p_data, data_length);
+                m_capdu_len += data_length;
+            }
+
+            if ((flags & NFC_T4T_DI_FLAG_MORE) == 0)
+            {
+                if (m_capdu_overflow)
+                {
+                    resp_send(m_sw_wrong_len, STATUS_SIZE);
+                }
+                else
+                {
+                    capdu_process(m_capdu, m_capdu_len);
+                }
+                m_capdu_len      = 0;
+                m_capdu_overflow = false;
+            }
+            break;
+
+        case NFC_T4T_EVENT_DATA_TRANSMITTED:
+            prefetch();
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+void nfc_t4t_resp_cache_invalidate(void)
+{
+    CRITICAL_REGION_ENTER();
+    m_prefetch_valid = false;
+    m_next_pending   = false;
+    nlen_resp_build();
+    CRITICAL_REGION_EXIT();
+}
+
+
+void nfc_t4t_resp_cache_stats_get(nfc_t4t_resp_cache_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
+
+#endif // NFC_T4T_RESP_CACHE_ENABLED
@@ -0,0 +1,131 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef NFC_T4T_RESP_CACHE_H__
+#define NFC_T4T_RESP_CACHE_H__
+
+/**@file
+ *
+ * @defgroup nfc_t4t_resp_cache Type 4 Tag NDEF response cache
+ * @{
+ * @ingroup  nfc_t4t
+ *
+ * @brief    NDEF Type 4 Tag emulation in raw mode, with precomputed responses.
+ *
+ * @details  The module answers the APDUs of the NDEF Tag Application: SELECT of the application,
+ *           of the Capability Container (CC) file and of the NDEF file, and READ BINARY. The CC
+ *           file is built once, when the module is initialized. The NDEF file is the buffer of
+ *           a message encoded for Type 4 Tag, with its NLEN field, for example the buffer of an
+ *           @ref nfc_ndef_msg_image.
+ *
+ *           The responses to SELECT and to the reads of the whole CC file and of NLEN are
+ *           precomputed. Other reads copy a slice of the file. When a response is sent, the
+ *           response to the read of the next slice of the same size is built, so the usual
+ *           sequential read of the NDEF file is answered without any copy in the callback.
+ *
+ *           The tag is read-only: UPDATE BINARY is refused.
+ *
+ *           Set up the library in raw mode, with @ref nfc_t4t_setup and without an NDEF payload,
+ *           and call @ref nfc_t4t_resp_cache_on_event from the callback of the library.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sdk_errors.h"
+#include "nfc_t4t_lib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Maximum data size of a READ BINARY response (MLe in the CC file).
+ *
+ * Two response buffers of this size, plus the status, are allocated.
+ */
+#ifndef NFC_T4T_RESP_CACHE_MLE
+#define NFC_T4T_RESP_CACHE_MLE      128
+#endif
+
+/** @brief Maximum size of a C-APDU. Longer APDUs are answered with an error. */
+#ifndef NFC_T4T_RESP_CACHE_CAPDU_MAX
+#define NFC_T4T_RESP_CACHE_CAPDU_MAX 32
+#endif
+
+#define NFC_T4T_RESP_CACHE_CC_LEN   15U    ///< Size of the CC file.
+#define NFC_T4T_RESP_CACHE_CC_ID    0xE103 ///< File identifier of the CC file.
+#define NFC_T4T_RESP_CACHE_NDEF_ID  0xE104 ///< File identifier of the NDEF file.
+
+/**
+ * @brief Statistics.
+ */
+typedef struct
+{
+    uint32_t apdus;       ///< APDUs answered.
+    uint32_t cache_hits;  ///< READ BINARY answered with a precomputed or prefetched response.
+    uint32_t cache_miss;  ///< READ BINARY answered with a copy in the callback.
+    uint32_t errors;      ///< APDUs answered with an error status.
+} nfc_t4t_resp_cache_stats_t;
+
+/**
+ * @brief Function for initializing the module.
+ *
+ * @param[in] p_ndef_file    Buffer of the NDEF file: NLEN and the message. Must stay valid.
+ * @param[in] ndef_file_len  Length of the NDEF file, NLEN included.
+ * @param[in] max_file_size  Size of the NDEF file given in the CC file, at least ndef_file_len.
+ *
+ * @retval NRF_SUCCESS              If the module was initialized.
+ * @retval NRF_ERROR_NULL           If p_ndef_file was NULL.
+ * @retval NRF_ERROR_INVALID_LENGTH If the NDEF file was shorter than NLEN, or larger than
+ *                                  max_file_size.
+ */
+ret_code_t nfc_t4t_resp_cache_init(uint8_t const * p_ndef_file,
+                                   uint16_t        ndef_file_len,
+                                   uint16_t        max_file_size);
+
+/**
+ * @brief Function for handling the events of the Type 4 Tag library.
+ *
+ * @param[in] event        Event.
+ * @param[in] p_data       Data of the event.
+ * @param[in] data_length  Length of the data.
+ * @param[in] flags        Flags of the event.
+ */
+void nfc_t4t_resp_cache_on_event(nfc_t4t_event_t event,
+                                 uint8_t const * p_data,
+                                 size_t          data_length,
+                                 uint32_t        flags);
+
+/**
+ * @brief Function for dropping the precomputed responses built from the NDEF file.
+ *
+ * Must be called after the content of the NDEF file has changed, for example after
+ * @ref nfc_ndef_msg_image_field_update.
+ */
+void nfc_t4t_resp_cache_invalidate(void);
+
+/**
+ * @brief Function for getting the statistics.
+ *
+ * @param[out] p_stats  Statistics.
+ */
+void nfc_t4t_resp_cache_stats_get(nfc_t4t_resp_cache_stats_t * p_stats);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NFC_T4T_RESP_CACHE_H__
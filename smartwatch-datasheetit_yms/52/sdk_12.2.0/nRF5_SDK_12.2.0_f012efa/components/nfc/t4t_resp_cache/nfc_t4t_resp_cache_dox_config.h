@@ -0,0 +1,28 @@
+/**
+ *
+ * @defgroup nfc_t4t_resp_cache_config Type 4 Tag NDEF response cache configuration
+ * @{
+ * @ingroup nfc_t4t_resp_cache
+ */
+/** @brief Enabling nfc_t4t_resp_cache module
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NFC_T4T_RESP_CACHE_ENABLED
+
+/** @brief Maximum data size of a READ BINARY response (MLe in the CC file), from 15 to 255.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NFC_T4T_RESP_CACHE_MLE
+
+/** @brief Maximum size of a C-APDU.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define NFC_T4T_RESP_CACHE_CAPDU_MAX
+
+
+/** @} */
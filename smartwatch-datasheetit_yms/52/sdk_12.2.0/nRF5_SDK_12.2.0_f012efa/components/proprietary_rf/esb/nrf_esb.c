@@ -120,6 +120,7 @@ typedef struct
 static bool                         m_esb_initialized           = false;
 static nrf_esb_mainstate_t          m_nrf_esb_mainstate         = NRF_ESB_STATE_IDLE;
 static nrf_esb_payload_t          * mp_current_payload;
+static nrf_esb_payload_t          * mp_rx_payload;          /**< Payload in which the next packet is received, NULL if none is free. */
 
 static nrf_esb_event_handler_t      m_event_handler;
 
@@ -137,12 +138,19 @@ static nrf_esb_payload_tx_fifo_t    m_tx_fifo;
 static nrf_esb_payload_t            m_rx_fifo_payload[NRF_ESB_RX_FIFO_SIZE];
 static nrf_esb_payload_rx_fifo_t    m_rx_fifo;
 
-// Payload buffers
-static  uint8_t                     m_tx_payload_buffer[NRF_ESB_MAX_PAYLOAD_LENGTH + 2];
+// Packet buffers. Payloads are sent and received in place, these are only used for
+// acknowledgments without payload and for packets that are dropped.
+static  uint8_t                     m_tx_ack_buffer[2];
 static  uint8_t                     m_rx_payload_buffer[NRF_ESB_MAX_PAYLOAD_LENGTH + 2];
 
+// The radio header and the data of a payload are one packet in RAM.
+STATIC_ASSERT(offsetof(nrf_esb_payload_t, data) == offsetof(nrf_esb_payload_t, radio_header) + 2);
+
 // Run time variables
 static volatile uint32_t            m_interrupt_flags = 0;
+static volatile uint32_t            m_tx_success_count;
+static volatile uint32_t            m_rx_received_count;
+static bool                         m_tx_burst_chained;     /**< The next packet of the burst is prepared and the radio is shorted to TXEN. */
 static uint8_t                      m_pids[NRF_ESB_PIPE_COUNT];
 static pipe_info_t                  m_rx_pipe_info[NRF_ESB_PIPE_COUNT];
 static volatile uint32_t            m_retransmits_remaining;
@@ -326,8 +334,98 @@ static void update_radio_parameters()
 }
 
 
+/**@brief Function for checking if a TX payload is one of the internal payloads of the TX FIFO. */
+static bool tx_payload_is_internal(nrf_esb_payload_t const * p_payload)
+{
+    return (p_payload >= &m_tx_fifo_payload[0]) &&
+           (p_payload <  &m_tx_fifo_payload[NRF_ESB_TX_FIFO_SIZE]);
+}
+
+
+/**@brief Function for releasing a payload removed from the TX FIFO to its pool. */
+static void tx_payload_free(nrf_esb_payload_t * p_payload)
+{
+#if NRF_MODULE_ENABLED(NRF_BALLOC)
+    if (!tx_payload_is_internal(p_payload))
+    {
+        nrf_balloc_free(m_config_local.p_tx_pool, p_payload);
+    }
+#endif
+}
+
+
+/**@brief Function for releasing a payload removed from the RX FIFO to its pool. */
+static void rx_payload_free(nrf_esb_payload_t * p_payload)
+{
+#if NRF_MODULE_ENABLED(NRF_BALLOC)
+    if (m_config_local.p_rx_pool != NULL)
+    {
+        nrf_balloc_free(m_config_local.p_rx_pool, p_payload);
+    }
+#endif
+}
+
+
+/**@brief Function for selecting the payload in which the next packet is received.
+ *
+ * The payload is the internal payload of the next entry of the RX FIFO, or a payload allocated
+ * from the RX pool. When there is none, the packet is received in m_rx_payload_buffer and dropped.
+ */
+static void rx_payload_prepare(void)
+{
+    if (mp_rx_payload != NULL || m_rx_fifo.count >= NRF_ESB_RX_FIFO_SIZE)
+    {
+        return;
+    }
+
+    if (m_config_local.p_rx_pool == NULL)
+    {
+        mp_rx_payload = &m_rx_fifo_payload[m_rx_fifo.entry_point];
+    }
+#if NRF_MODULE_ENABLED(NRF_BALLOC)
+    else
+    {
+        mp_rx_payload = nrf_balloc_alloc(m_config_local.p_rx_pool);
+    }
+#endif
+}
+
+
+/**@brief Function for getting the buffer in which the radio receives the next packet. */
+static uint8_t * rx_buffer_get(void)
+{
+    return (mp_rx_payload != NULL) ? mp_rx_payload->radio_header : m_rx_payload_buffer;
+}
+
+
 static void reset_fifos()
 {
+    while (m_tx_fifo.count > 0)
+    {
+        tx_payload_free(m_tx_fifo.p_payload[m_tx_fifo.exit_point]);
+        if (++m_tx_fifo.exit_point >= NRF_ESB_TX_FIFO_SIZE)
+        {
+            m_tx_fifo.exit_point = 0;
+        }
+        m_tx_fifo.count--;
+    }
+
+    while (m_rx_fifo.count > 0)
+    {
+        rx_payload_free(m_rx_fifo.p_payload[m_rx_fifo.exit_point]);
+        if (++m_rx_fifo.exit_point >= NRF_ESB_RX_FIFO_SIZE)
+        {
+            m_rx_fifo.exit_point = 0;
+        }
+        m_rx_fifo.count--;
+    }
+
+    if (mp_rx_payload != NULL)
+    {
+        rx_payload_free(mp_rx_payload);
+        mp_rx_payload = NULL;
+    }
+
     m_tx_fifo.entry_point = 0;
     m_tx_fifo.exit_point  = 0;
     m_tx_fifo.count       = 0;
@@ -342,6 +440,7 @@ static void initialize_fifos()
 {
     reset_fifos();
 
+    // Entries point to their internal payloads until a payload without copy is queued
     for (int i = 0; i < NRF_ESB_TX_FIFO_SIZE; i++)
     {
         m_tx_fifo.p_payload[i] = &m_tx_fifo_payload[i];
@@ -360,6 +459,7 @@ static void tx_fifo_remove_last()
     {
         DISABLE_RF_IRQ();
 
+        tx_payload_free(m_tx_fifo.p_payload[m_tx_fifo.exit_point]);
         m_tx_fifo.count--;
         if (++m_tx_fifo.exit_point >= NRF_ESB_TX_FIFO_SIZE)
         {
@@ -370,11 +470,11 @@ static void tx_fifo_remove_last()
     }
 }
 
-/** @brief  Function to push the content of the rx_buffer to the RX FIFO.
+/** @brief  Function to push the received payload to the RX FIFO.
  *
- *  The module will point the register NRF_RADIO->PACKETPTR to a buffer for receiving packets.
- *  After receiving a packet the module will call this function to copy the received data to
- *  the RX FIFO.
+ *  The module will point the register NRF_RADIO->PACKETPTR to the payload of @ref
+ *  rx_payload_prepare for receiving packets. After receiving a packet the module will call this
+ *  function to add that payload to the RX FIFO, and to select the payload of the next packet.
  *
  *  @param  pipe Pipe number to set for the packet.
  *  @param  pid  Packet ID.
@@ -384,43 +484,49 @@ static void tx_fifo_remove_last()
  */
 static bool rx_fifo_push_rfbuf(uint8_t pipe, uint8_t pid)
 {
-    if (m_rx_fifo.count < NRF_ESB_RX_FIFO_SIZE)
+    nrf_esb_payload_t * p_payload = mp_rx_payload;
+
+    // Without a payload, the packet was received in m_rx_payload_buffer
+    if (p_payload == NULL)
     {
-        if (m_config_local.protocol == NRF_ESB_PROTOCOL_ESB_DPL)
-        {
-            if (m_rx_payload_buffer[0] > NRF_ESB_MAX_PAYLOAD_LENGTH)
-            {
-                return false;
-            }
+        return false;
+    }
 
-            m_rx_fifo.p_payload[m_rx_fifo.entry_point]->length = m_rx_payload_buffer[0];
-        }
-        else if (m_config_local.mode == NRF_ESB_MODE_PTX)
-        {
-            // Received packet is an acknowledgment
-            m_rx_fifo.p_payload[m_rx_fifo.entry_point]->length = 0;
-        }
-        else
+    if (m_config_local.protocol == NRF_ESB_PROTOCOL_ESB_DPL)
+    {
+        if (p_payload->radio_header[0] > NRF_ESB_MAX_PAYLOAD_LENGTH)
         {
-            m_rx_fifo.p_payload[m_rx_fifo.entry_point]->length = m_config_local.payload_length;
+            return false;
         }
 
-        memcpy(m_rx_fifo.p_payload[m_rx_fifo.entry_point]->data, &m_rx_payload_buffer[2],
-               m_rx_fifo.p_payload[m_rx_fifo.entry_point]->length);
+        p_payload->length = p_payload->radio_header[0];
+    }
+    else if (m_config_local.mode == NRF_ESB_MODE_PTX)
+    {
+        // Received packet is an acknowledgment
+        p_payload->length = 0;
+    }
+    else
+    {
+        p_payload->length = m_config_local.payload_length;
+    }
 
-        m_rx_fifo.p_payload[m_rx_fifo.entry_point]->pipe = pipe;
-        m_rx_fifo.p_payload[m_rx_fifo.entry_point]->rssi = NRF_RADIO->RSSISAMPLE;
-        m_rx_fifo.p_payload[m_rx_fifo.entry_point]->pid = pid;
-        if (++m_rx_fifo.entry_point >= NRF_ESB_RX_FIFO_SIZE)
-        {
-            m_rx_fifo.entry_point = 0;
-        }
-        m_rx_fifo.count++;
+    p_payload->pipe = pipe;
+    p_payload->rssi = NRF_RADIO->RSSISAMPLE;
+    p_payload->pid  = pid;
 
-        return true;
+    m_rx_fifo.p_payload[m_rx_fifo.entry_point] = p_payload;
+    if (++m_rx_fifo.entry_point >= NRF_ESB_RX_FIFO_SIZE)
+    {
+        m_rx_fifo.entry_point = 0;
     }
+    m_rx_fifo.count++;
+    m_rx_received_count++;
+
+    mp_rx_payload = NULL;
+    rx_payload_prepare();
 
-    return false;
+    return true;
 }
 
 
@@ -430,6 +536,68 @@ static void sys_timer_init()
     NRF_ESB_SYS_TIMER->PRESCALER = 4;
     NRF_ESB_SYS_TIMER->BITMODE   = TIMER_BITMODE_BITMODE_16Bit;
     NRF_ESB_SYS_TIMER->SHORTS    = TIMER_SHORTS_COMPARE1_CLEAR_Msk | TIMER_SHORTS_COMPARE1_STOP_Msk;
+
+    // In PRX mode, the timer is only used for the time-out of RX batches
+    if (m_config_local.mode == NRF_ESB_MODE_PRX && m_config_local.rx_batch_timeout_us != 0)
+    {
+        NRF_ESB_SYS_TIMER->TASKS_STOP         = 1;
+        NRF_ESB_SYS_TIMER->SHORTS             = TIMER_SHORTS_COMPARE2_STOP_Msk;
+        NRF_ESB_SYS_TIMER->CC[2]              = m_config_local.rx_batch_timeout_us;
+        NRF_ESB_SYS_TIMER->EVENTS_COMPARE[2]  = 0;
+        NRF_ESB_SYS_TIMER->INTENSET           = TIMER_INTENSET_COMPARE2_Msk;
+
+        NVIC_ClearPendingIRQ(NRF_ESB_SYS_TIMER_IRQn);
+        NVIC_SetPriority(NRF_ESB_SYS_TIMER_IRQn, m_config_local.radio_irq_priority & 0x03);
+        NVIC_EnableIRQ(NRF_ESB_SYS_TIMER_IRQn);
+    }
+    else
+    {
+        NRF_ESB_SYS_TIMER->INTENCLR = TIMER_INTENCLR_COMPARE2_Msk;
+        NVIC_DisableIRQ(NRF_ESB_SYS_TIMER_IRQn);
+    }
+}
+
+
+/**@brief Function for reporting the events of a sent packet, unless they are reported once per burst. */
+static void tx_event_pend(void)
+{
+    if (m_config_local.tx_mode != NRF_ESB_TXMODE_BURST)
+    {
+        NVIC_SetPendingIRQ(ESB_EVT_IRQ);
+    }
+}
+
+
+/**@brief Function for reporting a received packet, when the RX batch is complete.
+ *
+ * In PRX mode, a smaller batch is reported by the system timer after @ref
+ * nrf_esb_config_t::rx_batch_timeout_us without packets.
+ */
+static void rx_event_pend(void)
+{
+    if (m_rx_fifo.count >= m_config_local.rx_batch_size || m_rx_fifo.count >= NRF_ESB_RX_FIFO_SIZE)
+    {
+        NVIC_SetPendingIRQ(ESB_EVT_IRQ);
+        if (m_config_local.mode == NRF_ESB_MODE_PRX && m_config_local.rx_batch_timeout_us != 0)
+        {
+            NRF_ESB_SYS_TIMER->TASKS_STOP = 1;
+        }
+    }
+    else if (m_config_local.mode == NRF_ESB_MODE_PRX && m_config_local.rx_batch_timeout_us != 0)
+    {
+        NRF_ESB_SYS_TIMER->TASKS_CLEAR = 1;
+        NRF_ESB_SYS_TIMER->TASKS_START = 1;
+    }
+}
+
+
+void NRF_ESB_SYS_TIMER_IRQ_Handler(void)
+{
+    if (NRF_ESB_SYS_TIMER->EVENTS_COMPARE[2])
+    {
+        NRF_ESB_SYS_TIMER->EVENTS_COMPARE[2] = 0;
+        NVIC_SetPendingIRQ(ESB_EVT_IRQ);
+    }
 }
 
 
@@ -456,15 +624,16 @@ static void start_tx_transaction()
     m_last_tx_attempts = 1;
     // Prepare the payload
     mp_current_payload = m_tx_fifo.p_payload[m_tx_fifo.exit_point];
+    m_tx_burst_chained = false;
+    NRF_RADIO->INTENCLR = RADIO_INTENCLR_ADDRESS_Msk;
 
 
     switch (m_config_local.protocol)
     {
         case NRF_ESB_PROTOCOL_ESB:
             update_rf_payload_format(mp_current_payload->length);
-            m_tx_payload_buffer[0] = mp_current_payload->pid;
-            m_tx_payload_buffer[1] = 0;
-            memcpy(&m_tx_payload_buffer[2], mp_current_payload->data, mp_current_payload->length);
+            mp_current_payload->radio_header[0] = mp_current_payload->pid;
+            mp_current_payload->radio_header[1] = 0;
 
             NRF_RADIO->SHORTS   = RADIO_SHORTS_COMMON | RADIO_SHORTS_DISABLED_RXEN_Msk;
             NRF_RADIO->INTENSET = RADIO_INTENSET_DISABLED_Msk | RADIO_INTENSET_READY_Msk;
@@ -477,10 +646,9 @@ static void start_tx_transaction()
 
         case NRF_ESB_PROTOCOL_ESB_DPL:
             ack = !mp_current_payload->noack || !m_config_local.selective_auto_ack;
-            m_tx_payload_buffer[0] = mp_current_payload->length;
-            m_tx_payload_buffer[1] = mp_current_payload->pid << 1;
-            m_tx_payload_buffer[1] |= ack ? 0x00 : 0x01;
-            memcpy(&m_tx_payload_buffer[2], mp_current_payload->data, mp_current_payload->length);
+            mp_current_payload->radio_header[0] = mp_current_payload->length;
+            mp_current_payload->radio_header[1] = mp_current_payload->pid << 1;
+            mp_current_payload->radio_header[1] |= ack ? 0x00 : 0x01;
 
             // Handling ack if noack is set to false or if selective auto ack is turned off
             if (ack)
@@ -497,6 +665,11 @@ static void start_tx_transaction()
             {
                 NRF_RADIO->SHORTS   = RADIO_SHORTS_COMMON;
                 NRF_RADIO->INTENSET = RADIO_INTENSET_DISABLED_Msk;
+                if (m_config_local.tx_mode == NRF_ESB_TXMODE_BURST)
+                {
+                    // The next packet is chained on the ADDRESS event
+                    NRF_RADIO->INTENSET = RADIO_INTENSET_ADDRESS_Msk;
+                }
                 on_radio_disabled   = on_radio_disabled_tx_noack;
                 m_nrf_esb_mainstate = NRF_ESB_STATE_PTX_TX;
             }
@@ -511,7 +684,7 @@ static void start_tx_transaction()
     NRF_RADIO->RXADDRESSES  = 1 << mp_current_payload->pipe;
 
     NRF_RADIO->FREQUENCY    = m_esb_addr.rf_channel;
-    NRF_RADIO->PACKETPTR    = (uint32_t)m_tx_payload_buffer;
+    NRF_RADIO->PACKETPTR    = (uint32_t)mp_current_payload->radio_header;
 
     NVIC_ClearPendingIRQ(RADIO_IRQn);
     NVIC_EnableIRQ(RADIO_IRQn);
@@ -525,19 +698,71 @@ static void start_tx_transaction()
 }
 
 
+/**@brief Function for preparing the next packet of a burst while the current packet is sent.
+ *
+ * Called on the ADDRESS event, when the radio has taken the current PACKETPTR. If the next packet
+ * in the TX FIFO is also sent without acknowledgment and to the same pipe, its header is written
+ * and the DISABLED to TXEN shortcut starts it without waiting for the interrupt.
+ */
+static void tx_burst_chain_next(void)
+{
+    nrf_esb_payload_t * p_next;
+    uint32_t            next_point = m_tx_fifo.exit_point + 1;
+
+    if (m_tx_burst_chained || m_tx_fifo.count < 2)
+    {
+        return;
+    }
+
+    if (next_point >= NRF_ESB_TX_FIFO_SIZE)
+    {
+        next_point = 0;
+    }
+
+    p_next = m_tx_fifo.p_payload[next_point];
+    if (!p_next->noack || p_next->pipe != mp_current_payload->pipe)
+    {
+        return;
+    }
+
+    p_next->radio_header[0] = p_next->length;
+    p_next->radio_header[1] = (p_next->pid << 1) | 0x01;
+
+    // PACKETPTR is double buffered, the packet on air is not affected
+    NRF_RADIO->PACKETPTR = (uint32_t)p_next->radio_header;
+    NRF_RADIO->SHORTS    = RADIO_SHORTS_COMMON | RADIO_SHORTS_DISABLED_TXEN_Msk;
+    m_tx_burst_chained   = true;
+
+    // If the packet ended before the shortcut was set, the interrupt starts the next packet
+    if (NRF_RADIO->EVENTS_DISABLED && NRF_RADIO->STATE == RADIO_STATE_STATE_Disabled)
+    {
+        NRF_RADIO->SHORTS  = RADIO_SHORTS_COMMON;
+        m_tx_burst_chained = false;
+    }
+}
+
+
 static void on_radio_disabled_tx_noack()
 {
     m_interrupt_flags |= NRF_ESB_INT_TX_SUCCESS_MSK;
+    m_tx_success_count++;
     tx_fifo_remove_last();
 
-    if (m_tx_fifo.count == 0)
+    if (m_tx_burst_chained)
+    {
+        // The radio is already ramping up for the next packet of the burst
+        NRF_RADIO->SHORTS   = RADIO_SHORTS_COMMON;
+        m_tx_burst_chained  = false;
+        mp_current_payload  = m_tx_fifo.p_payload[m_tx_fifo.exit_point];
+    }
+    else if (m_tx_fifo.count == 0)
     {
         m_nrf_esb_mainstate = NRF_ESB_STATE_IDLE;
         NVIC_SetPendingIRQ(ESB_EVT_IRQ);
     }
     else
     {
-        NVIC_SetPendingIRQ(ESB_EVT_IRQ);
+        tx_event_pend();
         start_tx_transaction();
     }
 }
@@ -569,7 +794,8 @@ static void on_radio_disabled_tx()
         update_rf_payload_format(0);
     }
 
-    NRF_RADIO->PACKETPTR        = (uint32_t)m_rx_payload_buffer;
+    rx_payload_prepare();
+    NRF_RADIO->PACKETPTR        = (uint32_t)rx_buffer_get();
     on_radio_disabled           = on_radio_disabled_tx_wait_for_ack;
     m_nrf_esb_mainstate         = NRF_ESB_STATE_PTX_RX_ACK;
 }
@@ -590,15 +816,17 @@ static void on_radio_disabled_tx_wait_for_ack()
         NRF_ESB_SYS_TIMER->TASKS_STOP = 1;
         NRF_PPI->CHENCLR = (1 << NRF_ESB_PPI_TX_START);
         m_interrupt_flags |= NRF_ESB_INT_TX_SUCCESS_MSK;
+        m_tx_success_count++;
         m_last_tx_attempts = m_config_local.retransmit_count - m_retransmits_remaining + 1;
 
         tx_fifo_remove_last();
 
-        if (m_config_local.protocol != NRF_ESB_PROTOCOL_ESB && m_rx_payload_buffer[0] > 0)
+        if (m_config_local.protocol != NRF_ESB_PROTOCOL_ESB && rx_buffer_get()[0] > 0)
         {
             if (rx_fifo_push_rfbuf((uint8_t)NRF_RADIO->TXADDRESS, 0))
             {
                 m_interrupt_flags |= NRF_ESB_INT_RX_DATA_RECEIVED_MSK;
+                rx_event_pend();
             }
         }
 
@@ -609,7 +837,7 @@ static void on_radio_disabled_tx_wait_for_ack()
         }
         else
         {
-            NVIC_SetPendingIRQ(ESB_EVT_IRQ);
+            tx_event_pend();
             start_tx_transaction();
         }
     }
@@ -632,7 +860,7 @@ static void on_radio_disabled_tx_wait_for_ack()
             // entered again as soon as the system timer reaches CC[1].
             NRF_RADIO->SHORTS = RADIO_SHORTS_COMMON | RADIO_SHORTS_DISABLED_RXEN_Msk;
             update_rf_payload_format(mp_current_payload->length);
-            NRF_RADIO->PACKETPTR = (uint32_t)m_tx_payload_buffer;
+            NRF_RADIO->PACKETPTR = (uint32_t)mp_current_payload->radio_header;
             on_radio_disabled = on_radio_disabled_tx;
             m_nrf_esb_mainstate = NRF_ESB_STATE_PTX_TX_ACK;
             NRF_ESB_SYS_TIMER->TASKS_START = 1;
@@ -649,7 +877,7 @@ static void clear_events_restart_rx(void)
 {
     NRF_RADIO->SHORTS = RADIO_SHORTS_COMMON;
     update_rf_payload_format(m_config_local.payload_length);
-    NRF_RADIO->PACKETPTR = (uint32_t)m_rx_payload_buffer;
+    NRF_RADIO->PACKETPTR = (uint32_t)rx_buffer_get();
     NRF_RADIO->EVENTS_DISABLED = 0;
     NRF_RADIO->TASKS_DISABLE = 1;
 
@@ -665,6 +893,8 @@ static void on_radio_disabled_rx(void)
     bool            ack                = false;
     bool            retransmit_payload = false;
     bool            send_rx_event      = true;
+    uint8_t         rx_header[2];
+    uint8_t       * p_ack_buffer;
     pipe_info_t *   p_pipe_info;
 
     if (NRF_RADIO->CRCSTATUS == 0)
@@ -673,29 +903,40 @@ static void on_radio_disabled_rx(void)
         return;
     }
 
-    if (m_rx_fifo.count >= NRF_ESB_RX_FIFO_SIZE)
+    // No free payload: the packet is not acknowledged, so that it is sent again
+    if (mp_rx_payload == NULL)
     {
+        rx_payload_prepare();
         clear_events_restart_rx();
         return;
     }
 
+    memcpy(rx_header, mp_rx_payload->radio_header, sizeof(rx_header));
+
     p_pipe_info = &m_rx_pipe_info[NRF_RADIO->RXMATCH];
     if (NRF_RADIO->RXCRC             == p_pipe_info->crc &&
-        (m_rx_payload_buffer[1] >> 1) == p_pipe_info->pid
+        (rx_header[1] >> 1)          == p_pipe_info->pid
        )
     {
         retransmit_payload = true;
         send_rx_event = false;
     }
 
-    p_pipe_info->pid = m_rx_payload_buffer[1] >> 1;
+    p_pipe_info->pid = rx_header[1] >> 1;
     p_pipe_info->crc = NRF_RADIO->RXCRC;
 
-    if (m_config_local.selective_auto_ack == false || ((m_rx_payload_buffer[1] & 0x01) == 0))
+    if (m_config_local.selective_auto_ack == false || ((rx_header[1] & 0x01) == 0))
     {
         ack = true;
     }
 
+    // Push the new packet to the RX FIFO before the radio is restarted, so that the next
+    // packet is received in another payload.
+    if (send_rx_event)
+    {
+        send_rx_event = rx_fifo_push_rfbuf(NRF_RADIO->RXMATCH, p_pipe_info->pid);
+    }
+
     if (ack)
     {
         NRF_RADIO->SHORTS = RADIO_SHORTS_COMMON | RADIO_SHORTS_DISABLED_RXEN_Msk;
@@ -712,51 +953,53 @@ static void on_radio_disabled_rx(void)
                         // Do not report TX success on first ack payload or retransmit
                         if (p_pipe_info->ack_payload == true && !retransmit_payload)
                         {
-                            if (++m_tx_fifo.exit_point >= NRF_ESB_TX_FIFO_SIZE)
-                            {
-                                m_tx_fifo.exit_point = 0;
-                            }
-
-                            m_tx_fifo.count--;
+                            tx_fifo_remove_last();
 
                             // ACK payloads also require TX_DS
                             // (page 40 of the 'nRF24LE1_Product_Specification_rev1_6.pdf').
                             m_interrupt_flags |= NRF_ESB_INT_TX_SUCCESS_MSK;
+                            m_tx_success_count++;
                         }
+                    }
 
+                    if (m_tx_fifo.count > 0 &&
+                        (m_tx_fifo.p_payload[m_tx_fifo.exit_point]->pipe == NRF_RADIO->RXMATCH)
+                       )
+                    {
                         p_pipe_info->ack_payload = true;
 
                         mp_current_payload = m_tx_fifo.p_payload[m_tx_fifo.exit_point];
 
                         update_rf_payload_format(mp_current_payload->length);
-                        m_tx_payload_buffer[0] = mp_current_payload->length;
-                        memcpy(&m_tx_payload_buffer[2],
-                               mp_current_payload->data,
-                               mp_current_payload->length);
+                        p_ack_buffer = mp_current_payload->radio_header;
+                        p_ack_buffer[0] = mp_current_payload->length;
                     }
                     else
                     {
                         p_pipe_info->ack_payload = false;
                         update_rf_payload_format(0);
-                        m_tx_payload_buffer[0] = 0;
+                        p_ack_buffer = m_tx_ack_buffer;
+                        p_ack_buffer[0] = 0;
                     }
 
-                    m_tx_payload_buffer[1] = m_rx_payload_buffer[1];
+                    p_ack_buffer[1] = rx_header[1];
                 }
                 break;
 
             case NRF_ESB_PROTOCOL_ESB:
+            default:
                 {
                     update_rf_payload_format(0);
-                    m_tx_payload_buffer[0] = m_rx_payload_buffer[0];
-                    m_tx_payload_buffer[1] = 0;
+                    p_ack_buffer = m_tx_ack_buffer;
+                    p_ack_buffer[0] = rx_header[0];
+                    p_ack_buffer[1] = 0;
                 }
                 break;
         }
 
         m_nrf_esb_mainstate = NRF_ESB_STATE_PRX_SEND_ACK;
         NRF_RADIO->TXADDRESS = NRF_RADIO->RXMATCH;
-        NRF_RADIO->PACKETPTR = (uint32_t)m_tx_payload_buffer;
+        NRF_RADIO->PACKETPTR = (uint32_t)p_ack_buffer;
         on_radio_disabled = on_radio_disabled_rx_ack;
     }
     else
@@ -766,13 +1009,9 @@ static void on_radio_disabled_rx(void)
 
     if (send_rx_event)
     {
-        // Push the new packet to the RX buffer and trigger a received event if the operation was
-        // successful.
-        if (rx_fifo_push_rfbuf(NRF_RADIO->RXMATCH, p_pipe_info->pid))
-        {
-            m_interrupt_flags |= NRF_ESB_INT_RX_DATA_RECEIVED_MSK;
-            NVIC_SetPendingIRQ(ESB_EVT_IRQ);
-        }
+        // Trigger a received event if the packet was pushed to the RX FIFO
+        m_interrupt_flags |= NRF_ESB_INT_RX_DATA_RECEIVED_MSK;
+        rx_event_pend();
     }
 }
 
@@ -782,7 +1021,7 @@ static void on_radio_disabled_rx_ack(void)
     NRF_RADIO->SHORTS = RADIO_SHORTS_COMMON | RADIO_SHORTS_DISABLED_TXEN_Msk;
     update_rf_payload_format(m_config_local.payload_length);
 
-    NRF_RADIO->PACKETPTR = (uint32_t)m_rx_payload_buffer;
+    NRF_RADIO->PACKETPTR = (uint32_t)rx_buffer_get();
     on_radio_disabled = on_radio_disabled_rx;
 
     m_nrf_esb_mainstate = NRF_ESB_STATE_PRX;
@@ -792,12 +1031,16 @@ static void on_radio_disabled_rx_ack(void)
 /**@brief Function for clearing pending interrupts.
  *
  * @param[in,out]   p_interrupts        Pointer to the value that holds the current interrupts.
+ * @param[out]      p_tx_count          Number of packets sent since the last call.
+ * @param[out]      p_rx_count          Number of packets received since the last call.
  *
  * @retval  NRF_SUCCESS                     If the interrupts were cleared successfully.
  * @retval  NRF_ERROR_NULL                  If the required parameter was NULL.
  * @retval  NRF_INVALID_STATE               If the module is not initialized.
  */
-static uint32_t nrf_esb_get_clear_interrupts(uint32_t * p_interrupts)
+static uint32_t nrf_esb_get_clear_interrupts(uint32_t * p_interrupts,
+                                             uint32_t * p_tx_count,
+                                             uint32_t * p_rx_count)
 {
     VERIFY_TRUE(m_esb_initialized, NRF_ERROR_INVALID_STATE);
     VERIFY_PARAM_NOT_NULL(p_interrupts);
@@ -806,6 +1049,10 @@ static uint32_t nrf_esb_get_clear_interrupts(uint32_t * p_interrupts)
 
     *p_interrupts = m_interrupt_flags;
     m_interrupt_flags = 0;
+    *p_tx_count = m_tx_success_count;
+    m_tx_success_count = 0;
+    *p_rx_count = m_rx_received_count;
+    m_rx_received_count = 0;
 
     ENABLE_RF_IRQ();
 
@@ -813,6 +1060,9 @@ static uint32_t nrf_esb_get_clear_interrupts(uint32_t * p_interrupts)
 }
 
 
+#if NRF_ESB_IRQ_RAMFUNC
+__RAMFUNC
+#endif
 void RADIO_IRQHandler()
 {
     if (NRF_RADIO->EVENTS_READY && (NRF_RADIO->INTENSET & RADIO_INTENSET_READY_Msk))
@@ -845,6 +1095,13 @@ void RADIO_IRQHandler()
         }
     }
 
+    // Handled after DISABLED, so that a late interrupt chains the packet after the packet on air
+    if (NRF_RADIO->EVENTS_ADDRESS && (NRF_RADIO->INTENSET & RADIO_INTENSET_ADDRESS_Msk))
+    {
+        NRF_RADIO->EVENTS_ADDRESS = 0;
+        tx_burst_chain_next();
+    }
+
     DEBUG_PIN_CLR(DEBUGPIN1);
     DEBUG_PIN_CLR(DEBUGPIN2);
     DEBUG_PIN_CLR(DEBUGPIN3);
@@ -857,6 +1114,9 @@ uint32_t nrf_esb_init(nrf_esb_config_t const * p_config)
     uint32_t err_code;
 
     VERIFY_PARAM_NOT_NULL(p_config);
+#if !NRF_MODULE_ENABLED(NRF_BALLOC)
+    VERIFY_TRUE(p_config->p_tx_pool == NULL && p_config->p_rx_pool == NULL, NRF_ERROR_NOT_SUPPORTED);
+#endif
 
     if (m_esb_initialized)
     {
@@ -872,6 +1132,8 @@ uint32_t nrf_esb_init(nrf_esb_config_t const * p_config)
     memcpy(&m_config_local, p_config, sizeof(nrf_esb_config_t));
 
     m_interrupt_flags    = 0;
+    m_tx_success_count   = 0;
+    m_rx_received_count  = 0;
 
     memset(m_rx_pipe_info, 0, sizeof(m_rx_pipe_info));
     memset(m_pids, 0, sizeof(m_pids));
@@ -921,6 +1183,11 @@ uint32_t nrf_esb_disable(void)
 
     m_nrf_esb_mainstate = NRF_ESB_STATE_IDLE;
 
+    // Stop the RX batch time-out
+    NRF_ESB_SYS_TIMER->TASKS_STOP = 1;
+    NRF_ESB_SYS_TIMER->INTENCLR   = TIMER_INTENCLR_COMPARE2_Msk;
+    NVIC_DisableIRQ(NRF_ESB_SYS_TIMER_IRQn);
+
     reset_fifos();
 
     memset(m_rx_pipe_info, 0, sizeof(m_rx_pipe_info));
@@ -945,33 +1212,69 @@ void ESB_EVT_IRQHandler(void)
 {
     ret_code_t      err_code;
     uint32_t        interrupts;
+    uint32_t        tx_count;
+    uint32_t        rx_count;
     nrf_esb_evt_t   event;
 
     event.tx_attempts = m_last_tx_attempts;
 
-    err_code = nrf_esb_get_clear_interrupts(&interrupts);
+    err_code = nrf_esb_get_clear_interrupts(&interrupts, &tx_count, &rx_count);
     if (err_code == NRF_SUCCESS && m_event_handler != 0)
     {
         if (interrupts & NRF_ESB_INT_TX_SUCCESS_MSK)
         {
             event.evt_id = NRF_ESB_EVENT_TX_SUCCESS;
+            event.count  = tx_count;
             m_event_handler(&event);
         }
         if (interrupts & NRF_ESB_INT_TX_FAILED_MSK)
         {
             event.evt_id = NRF_ESB_EVENT_TX_FAILED;
+            event.count  = 1;
             m_event_handler(&event);
         }
         if (interrupts & NRF_ESB_INT_RX_DATA_RECEIVED_MSK)
         {
             event.evt_id = NRF_ESB_EVENT_RX_RECEIVED;
+            event.count  = rx_count;
             m_event_handler(&event);
         }
     }
 }
 
+/**@brief Function for adding a payload to the TX FIFO, and for starting it in automatic TX mode.
+ *
+ * Must be called with the radio interrupt disabled, which this function enables again.
+ */
+static void tx_fifo_push(nrf_esb_payload_t * p_payload)
+{
+    m_pids[p_payload->pipe] = (m_pids[p_payload->pipe] + 1) % (NRF_ESB_PID_MAX + 1);
+    p_payload->pid = m_pids[p_payload->pipe];
+
+    m_tx_fifo.p_payload[m_tx_fifo.entry_point] = p_payload;
+    if (++m_tx_fifo.entry_point >= NRF_ESB_TX_FIFO_SIZE)
+    {
+        m_tx_fifo.entry_point = 0;
+    }
+
+    m_tx_fifo.count++;
+
+    ENABLE_RF_IRQ();
+
+
+    if (m_config_local.mode == NRF_ESB_MODE_PTX &&
+        m_config_local.tx_mode == NRF_ESB_TXMODE_AUTO &&
+        m_nrf_esb_mainstate == NRF_ESB_STATE_IDLE)
+    {
+        start_tx_transaction();
+    }
+}
+
+
 uint32_t nrf_esb_write_payload(nrf_esb_payload_t const * p_payload)
 {
+    nrf_esb_payload_t * p_internal;
+
     VERIFY_TRUE(m_esb_initialized, NRF_ERROR_INVALID_STATE);
     VERIFY_PARAM_NOT_NULL(p_payload);
     VERIFY_PAYLOAD_LENGTH(p_payload);
@@ -985,34 +1288,61 @@ uint32_t nrf_esb_write_payload(nrf_esb_payload_t const * p_payload)
 
     DISABLE_RF_IRQ();
 
-    memcpy(m_tx_fifo.p_payload[m_tx_fifo.entry_point], p_payload, sizeof(nrf_esb_payload_t));
+    // Only the used part of the data is copied
+    p_internal = &m_tx_fifo_payload[m_tx_fifo.entry_point];
+    memcpy(p_internal, p_payload, offsetof(nrf_esb_payload_t, data) + p_payload->length);
 
-    m_pids[p_payload->pipe] = (m_pids[p_payload->pipe] + 1) % (NRF_ESB_PID_MAX + 1);
-    m_tx_fifo.p_payload[m_tx_fifo.entry_point]->pid = m_pids[p_payload->pipe];
+    tx_fifo_push(p_internal);
 
-    if (++m_tx_fifo.entry_point >= NRF_ESB_TX_FIFO_SIZE)
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_esb_write_payload_nocopy(nrf_esb_payload_t * p_payload)
+{
+    VERIFY_TRUE(m_esb_initialized, NRF_ERROR_INVALID_STATE);
+    VERIFY_TRUE(m_config_local.p_tx_pool != NULL, NRF_ERROR_INVALID_STATE);
+    VERIFY_PARAM_NOT_NULL(p_payload);
+    VERIFY_PAYLOAD_LENGTH(p_payload);
+    VERIFY_FALSE(m_tx_fifo.count >= NRF_ESB_TX_FIFO_SIZE, NRF_ERROR_NO_MEM);
+
+    if (m_config_local.mode == NRF_ESB_MODE_PTX &&
+        p_payload->noack && !m_config_local.selective_auto_ack )
     {
-        m_tx_fifo.entry_point = 0;
+        return NRF_ERROR_NOT_SUPPORTED;
     }
 
-    m_tx_fifo.count++;
+    DISABLE_RF_IRQ();
 
-    ENABLE_RF_IRQ();
+    tx_fifo_push(p_payload);
 
+    return NRF_SUCCESS;
+}
 
-    if (m_config_local.mode == NRF_ESB_MODE_PTX &&
-        m_config_local.tx_mode == NRF_ESB_TXMODE_AUTO &&
-        m_nrf_esb_mainstate == NRF_ESB_STATE_IDLE)
+
+/**@brief Function for removing the first payload of the RX FIFO.
+ *
+ * Must be called with the radio interrupt disabled.
+ */
+static nrf_esb_payload_t * rx_fifo_pop(void)
+{
+    nrf_esb_payload_t * p_payload = m_rx_fifo.p_payload[m_rx_fifo.exit_point];
+
+    if (++m_rx_fifo.exit_point >= NRF_ESB_RX_FIFO_SIZE)
     {
-        start_tx_transaction();
+        m_rx_fifo.exit_point = 0;
     }
 
-    return NRF_SUCCESS;
+    m_rx_fifo.count--;
+
+    return p_payload;
 }
 
 
 uint32_t nrf_esb_read_rx_payload(nrf_esb_payload_t * p_payload)
 {
+    nrf_esb_payload_t * p_received;
+
     VERIFY_TRUE(m_esb_initialized, NRF_ERROR_INVALID_STATE);
     VERIFY_PARAM_NOT_NULL(p_payload);
 
@@ -1023,18 +1353,36 @@ uint32_t nrf_esb_read_rx_payload(nrf_esb_payload_t * p_payload)
 
     DISABLE_RF_IRQ();
 
-    p_payload->length = m_rx_fifo.p_payload[m_rx_fifo.exit_point]->length;
-    p_payload->pipe   = m_rx_fifo.p_payload[m_rx_fifo.exit_point]->pipe;
-    p_payload->rssi   = m_rx_fifo.p_payload[m_rx_fifo.exit_point]->rssi;
-    p_payload->pid    = m_rx_fifo.p_payload[m_rx_fifo.exit_point]->pid;
-    memcpy(p_payload->data, m_rx_fifo.p_payload[m_rx_fifo.exit_point]->data, p_payload->length);
+    p_received = m_rx_fifo.p_payload[m_rx_fifo.exit_point];
 
-    if (++m_rx_fifo.exit_point >= NRF_ESB_RX_FIFO_SIZE)
+    p_payload->length = p_received->length;
+    p_payload->pipe   = p_received->pipe;
+    p_payload->rssi   = p_received->rssi;
+    p_payload->pid    = p_received->pid;
+    memcpy(p_payload->data, p_received->data, p_payload->length);
+
+    rx_payload_free(rx_fifo_pop());
+
+    ENABLE_RF_IRQ();
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_esb_read_rx_payload_nocopy(nrf_esb_payload_t ** pp_payload)
+{
+    VERIFY_TRUE(m_esb_initialized, NRF_ERROR_INVALID_STATE);
+    VERIFY_TRUE(m_config_local.p_rx_pool != NULL, NRF_ERROR_INVALID_STATE);
+    VERIFY_PARAM_NOT_NULL(pp_payload);
+
+    if (m_rx_fifo.count == 0)
     {
-        m_rx_fifo.exit_point = 0;
+        return NRF_ERROR_NOT_FOUND;
     }
 
-    m_rx_fifo.count--;
+    DISABLE_RF_IRQ();
+
+    *pp_payload = rx_fifo_pop();
 
     ENABLE_RF_IRQ();
 
@@ -1071,7 +1419,8 @@ uint32_t nrf_esb_start_rx(void)
 
     NRF_RADIO->RXADDRESSES  = m_esb_addr.rx_pipes_enabled;
     NRF_RADIO->FREQUENCY    = m_esb_addr.rf_channel;
-    NRF_RADIO->PACKETPTR    = (uint32_t)m_rx_payload_buffer;
+    rx_payload_prepare();
+    NRF_RADIO->PACKETPTR    = (uint32_t)rx_buffer_get();
 
     NVIC_ClearPendingIRQ(RADIO_IRQn);
     NVIC_EnableIRQ(RADIO_IRQn);
@@ -1111,9 +1460,15 @@ uint32_t nrf_esb_flush_tx(void)
 
     DISABLE_RF_IRQ();
 
-    m_tx_fifo.count = 0;
-    m_tx_fifo.entry_point = 0;
-    m_tx_fifo.exit_point = 0;
+    while (m_tx_fifo.count > 0)
+    {
+        tx_payload_free(m_tx_fifo.p_payload[m_tx_fifo.exit_point]);
+        if (++m_tx_fifo.exit_point >= NRF_ESB_TX_FIFO_SIZE)
+        {
+            m_tx_fifo.exit_point = 0;
+        }
+        m_tx_fifo.count--;
+    }
 
     ENABLE_RF_IRQ();
 
@@ -1126,15 +1481,8 @@ uint32_t nrf_esb_pop_tx(void)
     VERIFY_TRUE(m_esb_initialized, NRF_ERROR_INVALID_STATE);
     VERIFY_TRUE(m_tx_fifo.count > 0, NRF_ERROR_BUFFER_EMPTY);
 
-    DISABLE_RF_IRQ();
-
-    if (++m_tx_fifo.entry_point >= NRF_ESB_TX_FIFO_SIZE)
-    {
-        m_tx_fifo.entry_point = 0;
-    }
-    m_tx_fifo.count--;
-
-    ENABLE_RF_IRQ();
+    // The first item is at the exit point of the FIFO
+    tx_fifo_remove_last();
 
     return NRF_SUCCESS;
 }
@@ -1146,9 +1494,11 @@ uint32_t nrf_esb_flush_rx(void)
 
     DISABLE_RF_IRQ();
 
-    m_rx_fifo.count = 0;
-    m_rx_fifo.entry_point = 0;
-    m_rx_fifo.exit_point = 0;
+    // The entry point is kept, the radio may be receiving in the payload of that entry
+    while (m_rx_fifo.count > 0)
+    {
+        rx_payload_free(rx_fifo_pop());
+    }
 
     memset(m_rx_pipe_info, 0, sizeof(m_rx_pipe_info));
 
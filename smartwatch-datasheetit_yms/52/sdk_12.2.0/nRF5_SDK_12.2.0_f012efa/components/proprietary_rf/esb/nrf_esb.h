@@ -17,6 +17,7 @@
 #include <stdint.h>
 #include "nrf.h"
 #include "app_util.h"
+#include "nrf_balloc.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -51,14 +52,24 @@ extern "C" {
 #define     NRF_ESB_MAX_PAYLOAD_LENGTH          32                  /**< The maximum size of the payload. Valid values are 1 to 252. */
 #endif
 
+#ifndef NRF_ESB_TX_FIFO_SIZE
 #define     NRF_ESB_TX_FIFO_SIZE                8                   /**< The size of the transmission first-in, first-out buffer. */
+#endif
+
+#ifndef NRF_ESB_RX_FIFO_SIZE
 #define     NRF_ESB_RX_FIFO_SIZE                8                   /**< The size of the reception first-in, first-out buffer. */
+#endif
+
+#ifndef NRF_ESB_IRQ_RAMFUNC
+#define     NRF_ESB_IRQ_RAMFUNC                 0                   /**< Run the radio interrupt handler from RAM, see @ref __RAMFUNC. */
+#endif
 
 // 252 is the largest possible payload size according to the nRF5 architecture.
 STATIC_ASSERT(NRF_ESB_MAX_PAYLOAD_LENGTH <= 252);
 
 #define     NRF_ESB_SYS_TIMER                   NRF_TIMER2          /**< The timer that is used by the module. */
 #define     NRF_ESB_SYS_TIMER_IRQ_Handler       TIMER2_IRQHandler   /**< The handler that is used by @ref NRF_ESB_SYS_TIMER. */
+#define     NRF_ESB_SYS_TIMER_IRQn              TIMER2_IRQn         /**< The IRQ number of @ref NRF_ESB_SYS_TIMER. */
 
 #define     NRF_ESB_PPI_TIMER_START             10                  /**< The PPI channel used for timer start. */
 #define     NRF_ESB_PPI_TIMER_STOP              11                  /**< The PPI channel used for timer stop. */
@@ -103,7 +114,11 @@ STATIC_ASSERT(NRF_ESB_MAX_PAYLOAD_LENGTH <= 252);
                                 .radio_irq_priority     = 1,                                \
                                 .event_irq_priority     = 2,                                \
                                 .payload_length         = 32,                               \
-                                .selective_auto_ack     = false                             \
+                                .selective_auto_ack     = false,                            \
+                                .rx_batch_size          = 0,                                \
+                                .rx_batch_timeout_us    = 0,                                \
+                                .p_tx_pool              = NULL,                             \
+                                .p_rx_pool              = NULL                              \
 }
 
 
@@ -120,7 +135,11 @@ STATIC_ASSERT(NRF_ESB_MAX_PAYLOAD_LENGTH <= 252);
                                 .radio_irq_priority     = 1,                                \
                                 .event_irq_priority     = 2,                                \
                                 .payload_length         = 32,                               \
-                                .selective_auto_ack     = false                             \
+                                .selective_auto_ack     = false,                            \
+                                .rx_batch_size          = 0,                                \
+                                .rx_batch_timeout_us    = 0,                                \
+                                .p_tx_pool              = NULL,                             \
+                                .p_rx_pool              = NULL                              \
 }
 
 
@@ -188,7 +207,8 @@ typedef enum {
 typedef enum {
     NRF_ESB_TXMODE_AUTO,        /*< Automatic TX mode: When the TX FIFO contains packets and the radio is idle, packets are sent automatically. */
     NRF_ESB_TXMODE_MANUAL,      /*< Manual TX mode: Packets are not sent until @ref nrf_esb_start_tx is called. This mode can be used to ensure consistent packet timing. */
-    NRF_ESB_TXMODE_MANUAL_START /*< Manual start TX mode: Packets are not sent until @ref nrf_esb_start_tx is called. Then, transmission continues automatically until the TX FIFO is empty. */
+    NRF_ESB_TXMODE_MANUAL_START,/*< Manual start TX mode: Packets are not sent until @ref nrf_esb_start_tx is called. Then, transmission continues automatically until the TX FIFO is empty. */
+    NRF_ESB_TXMODE_BURST        /*< Burst TX mode: Packets are not sent until @ref nrf_esb_start_tx is called. Then, all packets of the TX FIFO are sent back to back, and the events are reported once, when the TX FIFO is empty or a packet failed. Packets without acknowledgment to the same pipe are chained by the radio. */
 } nrf_esb_tx_mode_t;
 
 
@@ -205,6 +225,9 @@ typedef enum
  *
  * @details The payload is used both for transmissions and for acknowledging a
  *          received packet with a payload.
+ *
+ *          The radio sends and receives the packet directly from @p radio_header and @p data,
+ *          so payloads that are queued without copy must stay in Data RAM until they are released.
 */
 typedef struct
 {
@@ -213,6 +236,7 @@ typedef struct
     int8_t  rssi;                                   /**< RSSI for the received packet. */
     uint8_t noack;                                  /**< Flag indicating that this packet will not be acknowledged. */
     uint8_t pid;                                    /**< PID assigned during communication. */
+    uint8_t radio_header[2];                        /**< Header of the packet on air, used by the module. */
     uint8_t data[NRF_ESB_MAX_PAYLOAD_LENGTH];       /**< The payload data. */
 } nrf_esb_payload_t;
 
@@ -222,6 +246,7 @@ typedef struct
 {
     nrf_esb_evt_id_t    evt_id;                     /**< Enhanced ShockBurst event ID. */
     uint32_t            tx_attempts;                /**< Number of TX retransmission attempts. */
+    uint32_t            count;                      /**< Number of packets sent (@ref NRF_ESB_EVENT_TX_SUCCESS) or received (@ref NRF_ESB_EVENT_RX_RECEIVED) since the last event. */
 } nrf_esb_evt_t;
 
 
@@ -253,6 +278,14 @@ typedef struct
     uint8_t                 payload_length;         /**< Length of the payload (maximum length depends on the platforms that are used on each side). */
 
     bool                    selective_auto_ack;     /**< Enable or disable selective auto acknowledgment. */
+
+    // Event batching
+    uint8_t                 rx_batch_size;          /**< Number of packets in the RX FIFO at which an RX event is reported. 0 or 1 reports every packet. */
+    uint16_t                rx_batch_timeout_us;    /**< PRX only: time after the last received packet after which a smaller batch is reported. 0 waits for a full batch. */
+
+    // Payload pools, see @ref nrf_balloc
+    nrf_balloc_t const *    p_tx_pool;              /**< Pool of the payloads queued by @ref nrf_esb_write_payload_nocopy. They are freed to it when they are removed from the TX FIFO. NULL if not used. */
+    nrf_balloc_t const *    p_rx_pool;              /**< Pool in which packets are received, of elements of at least sizeof(@ref nrf_esb_payload_t). NULL: internal payloads, one for each entry of the RX FIFO. */
 } nrf_esb_config_t;
 
 
@@ -263,6 +296,7 @@ typedef struct
  * @retval  NRF_SUCCESS             If initialization was successful.
  * @retval  NRF_ERROR_NULL          If the @p p_config argument was NULL.
  * @retval  NRF_ERROR_BUSY          If the function failed because the radio is busy.
+ * @retval  NRF_ERROR_NOT_SUPPORTED If a payload pool was given, but @ref nrf_balloc is not enabled.
  */
 uint32_t nrf_esb_init(nrf_esb_config_t const * p_config);
 
@@ -315,6 +349,23 @@ bool nrf_esb_is_idle(void);
 uint32_t nrf_esb_write_payload(nrf_esb_payload_t const * p_payload);
 
 
+/**@brief Function for queuing a payload for transmission or acknowledgment without copying it.
+ *
+ * The payload must be allocated from @ref nrf_esb_config_t::p_tx_pool. It belongs to the module
+ * until it is removed from the TX FIFO, sent, popped, or flushed, and is then freed to the pool.
+ *
+ * @param[in]   p_payload     Payload allocated from the TX pool.
+ *
+ * @retval  NRF_SUCCESS                     If the payload was successfully queued.
+ * @retval  NRF_ERROR_NULL                  If the required parameter was NULL.
+ * @retval  NRF_INVALID_STATE               If the module is not initialized, or no TX pool is configured.
+ * @retval  NRF_ERROR_NOT_SUPPORTED         If @p p_payload->noack was false, but selective acknowledgment is not enabled.
+ * @retval  NRF_ERROR_NO_MEM                If the TX FIFO is full.
+ * @retval  NRF_ERROR_INVALID_LENGTH        If the payload length was invalid (zero or larger than the allowed maximum).
+ */
+uint32_t nrf_esb_write_payload_nocopy(nrf_esb_payload_t * p_payload);
+
+
 /**@brief Function for reading an RX payload.
  *
  * @param[in,out]   p_payload   Pointer to the structure that contains information and state of the payload.
@@ -326,7 +377,25 @@ uint32_t nrf_esb_write_payload(nrf_esb_payload_t const * p_payload);
 uint32_t nrf_esb_read_rx_payload(nrf_esb_payload_t * p_payload);
 
 
+/**@brief Function for taking an RX payload without copying it.
+ *
+ * The payload is the one in which the radio received the packet, allocated from
+ * @ref nrf_esb_config_t::p_rx_pool. The application must free it to the pool.
+ *
+ * @param[out]  pp_payload  Received payload.
+ *
+ * @retval  NRF_SUCCESS                     If a payload was taken.
+ * @retval  NRF_ERROR_NULL                  If the required parameter was NULL.
+ * @retval  NRF_INVALID_STATE               If the module is not initialized, or no RX pool is configured.
+ * @retval  NRF_ERROR_NOT_FOUND             If the RX FIFO is empty.
+ */
+uint32_t nrf_esb_read_rx_payload_nocopy(nrf_esb_payload_t ** pp_payload);
+
+
 /**@brief Function for starting transmission.
+ *
+ * In @ref NRF_ESB_TXMODE_BURST mode, this function starts a burst of all packets in the TX FIFO,
+ * including the packets that are written while the burst is ongoing.
  *
  * @retval  NRF_SUCCESS                     If the TX started successfully.
  * @retval  NRF_ERROR_BUFFER_EMPTY          If the TX does not start because the FIFO buffer is empty.
@@ -0,0 +1,549 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "nrf_gzll_afh.h"
+#include <string.h>
+#include "nrf_gzll.h"
+#include "app_util_platform.h"
+
+#define CHANNEL_MASK_ALL(count)     ((uint16_t)((1UL << (count)) - 1))
+
+/**@brief Samples of one channel. They are halved after each evaluation. */
+typedef struct
+{
+    uint16_t success;
+    uint16_t failure;
+} channel_samples_t;
+
+/**@brief Times at which the packets of one TX FIFO were queued. */
+typedef struct
+{
+    uint32_t tick[NRF_GZLL_CONST_FIFO_LENGTH];
+    uint8_t  length[NRF_GZLL_CONST_FIFO_LENGTH];
+    uint8_t  first;
+    uint8_t  count;
+} tx_queue_t;
+
+static nrf_gzll_mode_t      m_mode;
+static bool                 m_initialized;
+
+static uint8_t              m_channels[NRF_GZLL_CONST_MAX_CHANNEL_TABLE_SIZE];  ///< Whole table.
+static uint8_t              m_channel_count;
+static uint16_t             m_channel_mask;                   ///< Channels of the whole table in the current table.
+static uint8_t              m_table_index[NRF_GZLL_CONST_MAX_CHANNEL_TABLE_SIZE]; ///< Index in the whole table of each channel of the current table.
+static uint8_t              m_table_size;
+static uint8_t              m_current;                        ///< Index in the current table of the previous successful channel.
+
+static channel_samples_t    m_samples[NRF_GZLL_CONST_MAX_CHANNEL_TABLE_SIZE];
+static tx_queue_t           m_tx_queue[NRF_GZLL_CONST_PIPE_COUNT];
+
+static uint32_t             m_eval_tick;
+static uint32_t             m_last_rx_tick;
+static uint32_t             m_periods_reduced;                ///< Evaluation periods with a reduced table.
+static uint32_t             m_failures_in_row;
+
+static volatile bool        m_update_queued;                  ///< Device: an update is in the TX FIFO.
+static volatile bool        m_switch_pending;                 ///< The table must be changed to m_switch_mask.
+static volatile uint16_t    m_switch_mask;
+static uint16_t             m_update_mask;
+
+// Counters of the current evaluation period
+static uint32_t             m_period_packets;
+static uint32_t             m_period_bytes;
+static uint32_t             m_period_latency_sum;
+static uint32_t             m_period_latency_count;
+static uint32_t             m_period_latency_max;
+
+static nrf_gzll_afh_stats_t m_stats;
+
+
+static uint32_t ticks_to_us(uint32_t ticks)
+{
+    return ticks * nrf_gzll_get_timeslot_period();
+}
+
+
+static uint32_t mask_count(uint16_t mask)
+{
+    uint32_t count = 0;
+
+    for (; mask != 0; mask &= (mask - 1))
+    {
+        count++;
+    }
+    return count;
+}
+
+
+/**@brief Build the current table from the channels of the whole table in @p mask. */
+static uint32_t table_build(uint16_t mask, uint8_t * p_table)
+{
+    uint32_t size = 0;
+
+    for (uint32_t i = 0; i < m_channel_count; i++)
+    {
+        if (mask & (1 << i))
+        {
+            m_table_index[size] = i;
+            p_table[size++]     = m_channels[i];
+        }
+    }
+    return size;
+}
+
+
+/**@brief Change the channel table, with Gazell disabled. */
+static void table_set(uint16_t mask)
+{
+    uint8_t  table[NRF_GZLL_CONST_MAX_CHANNEL_TABLE_SIZE];
+    uint32_t size;
+    bool     enabled;
+
+    mask &= CHANNEL_MASK_ALL(m_channel_count);
+    if (mask == m_channel_mask || mask_count(mask) == 0)
+    {
+        return;
+    }
+
+    enabled = nrf_gzll_is_enabled();
+    if (enabled)
+    {
+        nrf_gzll_disable();
+        while (nrf_gzll_is_enabled())
+        {
+        }
+    }
+
+    CRITICAL_REGION_ENTER();
+    size = table_build(mask, table);
+    if (nrf_gzll_set_channel_table(table, size))
+    {
+        m_channel_mask = mask;
+        m_table_size   = size;
+        m_current      = 0;
+        m_stats.table_updates++;
+    }
+    else
+    {
+        // Keep the indices of the table that Gazell still uses
+        (void)table_build(m_channel_mask, table);
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (enabled)
+    {
+        (void)nrf_gzll_enable();
+    }
+}
+
+
+static void sample_add(uint32_t table_pos, bool success)
+{
+    channel_samples_t * p_samples = &m_samples[m_table_index[table_pos % m_table_size]];
+
+    if (success)
+    {
+        if (p_samples->success < UINT16_MAX)
+        {
+            p_samples->success++;
+        }
+    }
+    else if (p_samples->failure < UINT16_MAX)
+    {
+        p_samples->failure++;
+    }
+}
+
+
+static uint8_t failure_pct_get(uint32_t index)
+{
+    uint32_t total = m_samples[index].success + m_samples[index].failure;
+
+    if (total < NRF_GZLL_AFH_MIN_SAMPLES)
+    {
+        return NRF_GZLL_AFH_NO_SAMPLES;
+    }
+    return (uint8_t)((m_samples[index].failure * 100) / total);
+}
+
+
+/**@brief Account the latency and the bytes of the first packet of a TX FIFO. */
+static void tx_queue_pop(uint32_t pipe, bool success)
+{
+    tx_queue_t * p_queue = &m_tx_queue[pipe];
+    uint32_t     latency;
+
+    if (p_queue->count == 0)
+    {
+        return;
+    }
+
+    if (success)
+    {
+        latency = nrf_gzll_get_tick_count() - p_queue->tick[p_queue->first];
+
+        m_period_latency_sum += latency;
+        m_period_latency_count++;
+        if (latency > m_period_latency_max)
+        {
+            m_period_latency_max = latency;
+        }
+
+        m_period_bytes += p_queue->length[p_queue->first];
+        m_stats.bytes  += p_queue->length[p_queue->first];
+    }
+
+    p_queue->first = (p_queue->first + 1) % NRF_GZLL_CONST_FIFO_LENGTH;
+    p_queue->count--;
+}
+
+
+/**@brief Queue a channel table update to the Host. */
+static void update_send(uint16_t mask)
+{
+    uint8_t packet[NRF_GZLL_AFH_CMD_TABLE_LENGTH];
+
+    packet[0] = NRF_GZLL_AFH_CMD_TABLE;
+    packet[1] = (uint8_t)mask;
+    packet[2] = (uint8_t)(mask >> 8);
+
+    if (nrf_gzll_add_packet_to_tx_fifo(NRF_GZLL_AFH_PIPE, packet, sizeof(packet)))
+    {
+        m_update_mask   = mask;
+        m_update_queued = true;
+    }
+}
+
+
+/**@brief Choose the channels of the next table from the samples. */
+static uint16_t mask_evaluate(void)
+{
+    uint16_t all  = CHANNEL_MASK_ALL(m_channel_count);
+    uint16_t mask = m_channel_mask;
+    uint8_t  pct[NRF_GZLL_CONST_MAX_CHANNEL_TABLE_SIZE];
+
+    if (mask != all && ++m_periods_reduced >= NRF_GZLL_AFH_RESTORE_PERIODS)
+    {
+        // Measure the removed channels again
+        m_periods_reduced = 0;
+        return all;
+    }
+
+    for (uint32_t i = 0; i < m_channel_count; i++)
+    {
+        pct[i] = failure_pct_get(i);
+        if ((mask & (1 << i)) && pct[i] != NRF_GZLL_AFH_NO_SAMPLES && pct[i] > NRF_GZLL_AFH_BAD_CHANNEL_PCT)
+        {
+            mask &= ~(1 << i);
+        }
+    }
+
+    // Take back the best of the removed channels
+    while (mask_count(mask) < MIN(NRF_GZLL_AFH_MIN_CHANNELS, m_channel_count))
+    {
+        uint32_t best = 0;
+        uint8_t  best_pct = 0xFF;
+
+        for (uint32_t i = 0; i < m_channel_count; i++)
+        {
+            if (!(mask & (1 << i)) && (best_pct == 0xFF || pct[i] < best_pct))
+            {
+                best     = i;
+                best_pct = pct[i];
+            }
+        }
+        mask |= (1 << best);
+    }
+
+    return mask;
+}
+
+
+static void period_end(uint32_t now)
+{
+    uint32_t period_us = ticks_to_us(now - m_eval_tick);
+
+    m_eval_tick = now;
+
+    CRITICAL_REGION_ENTER();
+    if (period_us != 0)
+    {
+        m_stats.packets_per_s = (uint32_t)(((uint64_t)m_period_packets * 1000000) / period_us);
+        m_stats.bytes_per_s   = (uint32_t)(((uint64_t)m_period_bytes * 1000000) / period_us);
+    }
+    m_stats.latency_avg_us = (m_period_latency_count != 0) ?
+                             ticks_to_us(m_period_latency_sum / m_period_latency_count) : 0;
+    m_stats.latency_max_us = ticks_to_us(m_period_latency_max);
+
+    m_period_packets       = 0;
+    m_period_bytes         = 0;
+    m_period_latency_sum   = 0;
+    m_period_latency_count = 0;
+    m_period_latency_max   = 0;
+    CRITICAL_REGION_EXIT();
+}
+
+
+bool nrf_gzll_afh_init(nrf_gzll_mode_t mode)
+{
+    uint8_t  table[NRF_GZLL_CONST_MAX_CHANNEL_TABLE_SIZE];
+    uint32_t size = sizeof(m_channels);
+
+    if (nrf_gzll_is_enabled() || (mode != NRF_GZLL_MODE_DEVICE && mode != NRF_GZLL_MODE_HOST))
+    {
+        return false;
+    }
+
+    if (!nrf_gzll_get_channel_table(m_channels, &size))
+    {
+        return false;
+    }
+
+    if (mode == NRF_GZLL_MODE_DEVICE)
+    {
+        if (!nrf_gzll_set_device_channel_selection_policy(
+                NRF_GZLL_DEVICE_CHANNEL_SELECTION_POLICY_USE_SUCCESSFUL))
+        {
+            return false;
+        }
+    }
+    else if (!nrf_gzll_set_rx_pipes_enabled(nrf_gzll_get_rx_pipes_enabled() | (1 << NRF_GZLL_AFH_PIPE)))
+    {
+        return false;
+    }
+
+    memset(m_samples, 0, sizeof(m_samples));
+    memset(m_tx_queue, 0, sizeof(m_tx_queue));
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    m_mode            = mode;
+    m_channel_count   = size;
+    m_channel_mask    = CHANNEL_MASK_ALL(size);
+    m_table_size      = table_build(m_channel_mask, table);
+    m_current         = 0;
+    m_update_queued   = false;
+    m_switch_pending  = false;
+    m_periods_reduced = 0;
+    m_failures_in_row = 0;
+    m_eval_tick       = nrf_gzll_get_tick_count();
+    m_last_rx_tick    = m_eval_tick;
+    m_initialized     = true;
+
+    return true;
+}
+
+
+bool nrf_gzll_afh_add_packet_to_tx_fifo(uint32_t pipe, uint8_t * payload, uint32_t length)
+{
+    bool         result;
+    tx_queue_t * p_queue;
+
+    if (pipe >= NRF_GZLL_CONST_PIPE_COUNT || pipe == NRF_GZLL_AFH_PIPE)
+    {
+        return false;
+    }
+
+    p_queue = &m_tx_queue[pipe];
+
+    CRITICAL_REGION_ENTER();
+    result = nrf_gzll_add_packet_to_tx_fifo(pipe, payload, length);
+    if (result && p_queue->count < NRF_GZLL_CONST_FIFO_LENGTH)
+    {
+        uint32_t last = (p_queue->first + p_queue->count) % NRF_GZLL_CONST_FIFO_LENGTH;
+
+        p_queue->tick[last]   = nrf_gzll_get_tick_count();
+        p_queue->length[last] = (uint8_t)length;
+        p_queue->count++;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return result;
+}
+
+
+bool nrf_gzll_afh_device_tx_success(uint32_t pipe, nrf_gzll_device_tx_info_t tx_info)
+{
+    if (!m_initialized)
+    {
+        return false;
+    }
+
+    // The channels that were left failed, the last one succeeded
+    for (uint32_t i = 0; i < tx_info.num_channel_switches; i++)
+    {
+        sample_add(m_current + i, false);
+    }
+    sample_add(m_current + tx_info.num_channel_switches, true);
+    m_current = (m_current + tx_info.num_channel_switches) % m_table_size;
+
+    m_failures_in_row = 0;
+    m_stats.attempts += tx_info.num_tx_attempts;
+
+    if (pipe == NRF_GZLL_AFH_PIPE)
+    {
+        // The Host has the update, both sides change the table
+        if (m_update_queued)
+        {
+            m_update_queued  = false;
+            m_switch_mask    = m_update_mask;
+            m_switch_pending = true;
+        }
+        return true;
+    }
+
+    m_stats.packets++;
+    m_period_packets++;
+    tx_queue_pop(pipe, true);
+
+    return false;
+}
+
+
+bool nrf_gzll_afh_device_tx_failed(uint32_t pipe, nrf_gzll_device_tx_info_t tx_info)
+{
+    if (!m_initialized)
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i <= tx_info.num_channel_switches; i++)
+    {
+        sample_add(m_current + i, false);
+    }
+
+    m_stats.attempts += tx_info.num_tx_attempts;
+
+    if (++m_failures_in_row >= NRF_GZLL_AFH_FAILURE_LIMIT &&
+        m_channel_mask != CHANNEL_MASK_ALL(m_channel_count))
+    {
+        // The Host may not use the same table, use the whole table
+        m_failures_in_row = 0;
+        m_switch_mask     = CHANNEL_MASK_ALL(m_channel_count);
+        m_switch_pending  = true;
+    }
+
+    if (pipe == NRF_GZLL_AFH_PIPE)
+    {
+        m_update_queued = false;
+        return true;
+    }
+
+    m_stats.packets_failed++;
+    tx_queue_pop(pipe, false);
+
+    return false;
+}
+
+
+bool nrf_gzll_afh_host_rx_data_ready(uint32_t pipe, nrf_gzll_host_rx_info_t rx_info)
+{
+    uint8_t  packet[NRF_GZLL_CONST_MAX_PAYLOAD_LENGTH];
+    uint32_t length = sizeof(packet);
+
+    UNUSED_PARAMETER(rx_info);
+
+    if (!m_initialized)
+    {
+        return false;
+    }
+
+    m_last_rx_tick = nrf_gzll_get_tick_count();
+
+    if (pipe != NRF_GZLL_AFH_PIPE)
+    {
+        m_stats.packets++;
+        m_period_packets++;
+        return false;
+    }
+
+    if (nrf_gzll_fetch_packet_from_rx_fifo(pipe, packet, &length) &&
+        length == NRF_GZLL_AFH_CMD_TABLE_LENGTH && packet[0] == NRF_GZLL_AFH_CMD_TABLE)
+    {
+        m_switch_mask    = packet[1] | ((uint16_t)packet[2] << 8);
+        m_switch_pending = true;
+    }
+
+    return true;
+}
+
+
+void nrf_gzll_afh_process(void)
+{
+    uint32_t now;
+    uint16_t mask;
+
+    if (!m_initialized)
+    {
+        return;
+    }
+
+    now = nrf_gzll_get_tick_count();
+
+    if (m_switch_pending)
+    {
+        CRITICAL_REGION_ENTER();
+        mask             = m_switch_mask;
+        m_switch_pending = false;
+        CRITICAL_REGION_EXIT();
+
+        table_set(mask);
+    }
+
+    if (m_mode == NRF_GZLL_MODE_HOST)
+    {
+        if ((now - m_last_rx_tick) >= NRF_GZLL_AFH_HOST_TIMEOUT_TICKS)
+        {
+            // The Device may not use the same table, use the whole table
+            m_last_rx_tick = now;
+            table_set(CHANNEL_MASK_ALL(m_channel_count));
+        }
+    }
+
+    if ((now - m_eval_tick) < NRF_GZLL_AFH_EVAL_PERIOD_TICKS)
+    {
+        return;
+    }
+
+    period_end(now);
+
+    if (m_mode == NRF_GZLL_MODE_DEVICE)
+    {
+        CRITICAL_REGION_ENTER();
+        mask = mask_evaluate();
+        for (uint32_t i = 0; i < m_channel_count; i++)
+        {
+            m_samples[i].success >>= 1;
+            m_samples[i].failure >>= 1;
+        }
+        CRITICAL_REGION_EXIT();
+
+        if (mask != m_channel_mask && !m_update_queued)
+        {
+            update_send(mask);
+        }
+    }
+}
+
+
+void nrf_gzll_afh_stats_get(nrf_gzll_afh_stats_t * p_stats)
+{
+    CRITICAL_REGION_ENTER();
+    m_stats.channel_mask  = m_channel_mask;
+    m_stats.channel_count = m_channel_count;
+    memcpy(m_stats.channels, m_channels, sizeof(m_channels));
+    for (uint32_t i = 0; i < NRF_GZLL_CONST_MAX_CHANNEL_TABLE_SIZE; i++)
+    {
+        m_stats.failure_pct[i] = (i < m_channel_count) ? failure_pct_get(i) : NRF_GZLL_AFH_NO_SAMPLES;
+    }
+    *p_stats = m_stats;
+    CRITICAL_REGION_EXIT();
+}
@@ -0,0 +1,194 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**
+ * @file
+ * @brief Gazell adaptive channel hopping and link statistics
+ *
+ * @defgroup nrf_gzll_afh Gazell adaptive channel hopping
+ * @{
+ * @ingroup modules_01_gzll
+ *
+ * @brief Per-channel statistics on the Device, and removal of bad channels from the channel
+ *        table, in sync with the Host.
+ *
+ * @details Gazell does not tell on which channel a packet was sent. With the
+ *          @ref NRF_GZLL_DEVICE_CHANNEL_SELECTION_POLICY_USE_SUCCESSFUL policy, which this module
+ *          sets, a packet starts on the channel of the previous successful packet and moves
+ *          @ref nrf_gzll_device_tx_info_t::num_channel_switches channels on. Every channel that
+ *          is left counts as a failure, and the last channel of a successful packet as a success.
+ *
+ *          Every @ref NRF_GZLL_AFH_EVAL_PERIOD_TICKS, the Device removes the channels that fail more
+ *          than @ref NRF_GZLL_AFH_BAD_CHANNEL_PCT percent from the table. The new table is sent
+ *          to the Host on @ref NRF_GZLL_AFH_PIPE, and both sides change it when the packet is
+ *          acknowledged. After @ref NRF_GZLL_AFH_RESTORE_PERIODS periods, the whole table is used
+ *          again, to measure the removed channels.
+ *
+ *          Every table is a part of the table that was set before @ref nrf_gzll_afh_init. When the
+ *          two sides do not use the same table, the Device still finds the Host when it is out of
+ *          sync. The Device goes back to the whole table after @ref NRF_GZLL_AFH_FAILURE_LIMIT
+ *          failed packets in a row, and the Host when it received nothing for
+ *          @ref NRF_GZLL_AFH_HOST_TIMEOUT_TICKS.
+ *
+ *          The Gazell callbacks are implemented by the application, which calls the functions
+ *          of this module from them. @ref nrf_gzll_afh_process changes the channel table, and
+ *          must be called from the main context, for example in the main loop.
+ */
+
+#ifndef NRF_GZLL_AFH_H__
+#define NRF_GZLL_AFH_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nrf_gzll.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef NRF_GZLL_AFH_PIPE
+#define NRF_GZLL_AFH_PIPE                   7   ///< Pipe reserved for the channel table updates.
+#endif
+
+#ifndef NRF_GZLL_AFH_EVAL_PERIOD_TICKS
+#define NRF_GZLL_AFH_EVAL_PERIOD_TICKS      2000 ///< Timeslots between two evaluations of the channels.
+#endif
+
+#ifndef NRF_GZLL_AFH_MIN_SAMPLES
+#define NRF_GZLL_AFH_MIN_SAMPLES            16  ///< Samples of a channel needed to evaluate it.
+#endif
+
+#ifndef NRF_GZLL_AFH_BAD_CHANNEL_PCT
+#define NRF_GZLL_AFH_BAD_CHANNEL_PCT        50  ///< Failure rate in percent above which a channel is removed.
+#endif
+
+#ifndef NRF_GZLL_AFH_MIN_CHANNELS
+#define NRF_GZLL_AFH_MIN_CHANNELS           3   ///< Minimum number of channels in the table.
+#endif
+
+#ifndef NRF_GZLL_AFH_RESTORE_PERIODS
+#define NRF_GZLL_AFH_RESTORE_PERIODS        30  ///< Evaluation periods after which the removed channels are used again.
+#endif
+
+#ifndef NRF_GZLL_AFH_FAILURE_LIMIT
+#define NRF_GZLL_AFH_FAILURE_LIMIT          4   ///< Failed packets in a row after which the Device uses the whole table.
+#endif
+
+#ifndef NRF_GZLL_AFH_HOST_TIMEOUT_TICKS
+#define NRF_GZLL_AFH_HOST_TIMEOUT_TICKS     5000 ///< Timeslots without packets after which the Host uses the whole table.
+#endif
+
+#define NRF_GZLL_AFH_CMD_TABLE              0xA5 ///< First byte of the channel table update packet.
+#define NRF_GZLL_AFH_CMD_TABLE_LENGTH       3    ///< Length of the channel table update packet: command and channel mask.
+#define NRF_GZLL_AFH_NO_SAMPLES             0xFF ///< Failure rate of a channel without enough samples.
+
+/**
+ * @brief Link statistics.
+ *
+ * The channels are indexed as in the channel table that was set before @ref nrf_gzll_afh_init.
+ */
+typedef struct
+{
+    uint32_t packets;               ///< Packets sent (Device) or received (Host).
+    uint32_t packets_failed;        ///< Device: packets that failed after the maximum number of attempts.
+    uint32_t attempts;              ///< Device: transmission attempts of all packets.
+    uint32_t bytes;                 ///< Device: payload bytes queued by @ref nrf_gzll_afh_add_packet_to_tx_fifo and sent.
+    uint32_t packets_per_s;         ///< Packets per second over the last evaluation period.
+    uint32_t bytes_per_s;           ///< Device: payload bytes per second over the last evaluation period.
+    uint32_t latency_avg_us;        ///< Device: average time from queuing to acknowledgment over the last evaluation period.
+    uint32_t latency_max_us;        ///< Device: longest time from queuing to acknowledgment over the last evaluation period.
+    uint32_t table_updates;         ///< Number of changes of the channel table.
+    uint16_t channel_mask;          ///< Channels in the current table.
+    uint8_t  channel_count;         ///< Number of channels in the whole table.
+    uint8_t  channels[NRF_GZLL_CONST_MAX_CHANNEL_TABLE_SIZE];    ///< The whole table.
+    uint8_t  failure_pct[NRF_GZLL_CONST_MAX_CHANNEL_TABLE_SIZE]; ///< Device: failure rate of each channel, or @ref NRF_GZLL_AFH_NO_SAMPLES.
+} nrf_gzll_afh_stats_t;
+
+
+/**
+ * @brief Initialize the module.
+ *
+ * Must be called after @ref nrf_gzll_init and after the channel table is set, while Gazell is
+ * disabled. The current channel table is the whole table. On the Host, @ref NRF_GZLL_AFH_PIPE
+ * is added to the enabled RX pipes.
+ *
+ * @param mode @ref NRF_GZLL_MODE_DEVICE or @ref NRF_GZLL_MODE_HOST.
+ *
+ * @retval true  If the module was initialized.
+ * @retval false If Gazell was enabled, or the mode was invalid.
+ */
+bool nrf_gzll_afh_init(nrf_gzll_mode_t mode);
+
+
+/**
+ * @brief Add a packet to a TX FIFO, and record when it was queued.
+ *
+ * Use this function instead of @ref nrf_gzll_add_packet_to_tx_fifo for the latency and the bytes
+ * to be measured. All packets of a pipe must be added through it.
+ *
+ * @retval true  If the packet was added.
+ * @retval false If @ref nrf_gzll_add_packet_to_tx_fifo failed, or the pipe is @ref NRF_GZLL_AFH_PIPE.
+ */
+bool nrf_gzll_afh_add_packet_to_tx_fifo(uint32_t pipe, uint8_t * payload, uint32_t length);
+
+
+/**
+ * @brief Account a successful packet. To be called from @ref nrf_gzll_device_tx_success.
+ *
+ * @retval true  If the packet was a channel table update, which the application ignores.
+ * @retval false If the packet belongs to the application.
+ */
+bool nrf_gzll_afh_device_tx_success(uint32_t pipe, nrf_gzll_device_tx_info_t tx_info);
+
+
+/**
+ * @brief Account a failed packet. To be called from @ref nrf_gzll_device_tx_failed.
+ *
+ * @retval true  If the packet was a channel table update, which the application ignores.
+ * @retval false If the packet belongs to the application.
+ */
+bool nrf_gzll_afh_device_tx_failed(uint32_t pipe, nrf_gzll_device_tx_info_t tx_info);
+
+
+/**
+ * @brief Account a received packet. To be called from @ref nrf_gzll_host_rx_data_ready.
+ *
+ * Packets of @ref NRF_GZLL_AFH_PIPE are fetched from the RX FIFO by this function.
+ *
+ * @retval true  If the packet was a channel table update, which the application ignores.
+ * @retval false If the packet belongs to the application.
+ */
+bool nrf_gzll_afh_host_rx_data_ready(uint32_t pipe, nrf_gzll_host_rx_info_t rx_info);
+
+
+/**
+ * @brief Evaluate the channels, and change the channel table when needed.
+ *
+ * Gazell is disabled and enabled again while the table is changed.
+ */
+void nrf_gzll_afh_process(void);
+
+
+/**
+ * @brief Get the link statistics.
+ *
+ * @param[out] p_stats Statistics.
+ */
+void nrf_gzll_afh_stats_get(nrf_gzll_afh_stats_t * p_stats);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_GZLL_AFH_H__
@@ -56,6 +56,18 @@ extern "C" {
 
 #define GZP_HOST_RX_POWER_THRESHOLD -64 ///< RSSI threshold for when signal strength in RX packet power is high enough.
 
+/**
+ * Define GZP_WARM_RECONNECT in nrf_gzp_config.h to keep the system address, Host ID, dynamic key,
+ * session token and channel table of the Device in RAM that is not initialized at startup.
+ * After a wake-up or reset that retains RAM, gzp_init() restores them, so the first encrypted
+ * packet needs no key update. The state is forgotten when a transmission fails, and the Device
+ * falls back to a key update, or to pairing.
+ *
+ * The state is placed in section ".noinit" (GCC), ".bss.noinit" (Keil) or declared with
+ * __no_init (IAR). The linker configuration must place this section in RAM that is not
+ * cleared by the startup code, and the RAM must be retained in System OFF.
+ */
+
 /** @} */
 
 
@@ -515,6 +527,17 @@ gzp_id_req_res_t gzp_id_req_send(void);
 */
 bool gzp_crypt_data_send(const uint8_t *src, uint8_t length);
 
+#ifdef GZP_WARM_RECONNECT
+/**
+  Function for checking whether gzp_init() restored the state of the previous session
+  from retained RAM. See GZP_WARM_RECONNECT.
+
+  @retval true if the state was restored and no transmission has failed since.
+  @retval false otherwise.
+*/
+bool gzp_warm_reconnect_restored(void);
+#endif
+
 
 /**
 @name Host functions
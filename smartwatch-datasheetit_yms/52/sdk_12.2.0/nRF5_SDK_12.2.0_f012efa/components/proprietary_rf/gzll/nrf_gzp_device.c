@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include <stddef.h>
 
 #include "nrf_gzll.h"
 #include "nrf_gzp.h"
@@ -233,6 +234,31 @@ static bool gzp_params_store(bool store_all);
  */
 static bool gzp_params_restore(void);
 
+#ifdef GZP_WARM_RECONNECT
+/**
+ * Function for storing the current state in the warm reconnect cache.
+ */
+static void gzp_warm_cache_save(void);
+
+/**
+ * Function for making the warm reconnect cache invalid.
+ */
+static void gzp_warm_cache_invalidate(void);
+
+/**
+ * Function for restoring the state from the warm reconnect cache.
+ *
+ * @retval true If the cache was valid, and matches the pairing data in flash.
+ */
+static bool gzp_warm_cache_restore(void);
+
+/**
+ * Function for forgetting the restored state after a failed transmission. The channel table
+ * generated from the system address is set again.
+ */
+static void gzp_warm_fallback(void);
+#endif
+
 /**
  * Delay function. Will add a delay equal to GZLL_RX_PERIOD * rx_periods [us].
  *
@@ -298,6 +324,42 @@ static const uint32_t database[GZP_DEVICE_PARAMS_STORAGE_SIZE / 4] __attribute__
 0xFFFFFFFF,0xFFFFFFFF,0xFFFFFFFF,0xFFFFFFFF,0xFFFFFFFF,0xFFFFFFFF,0xFFFFFFFF,0xFFFFFFFF,0xFFFFFFFF,0xFFFFFFFF,0xFFFFFFFF,0xFFFFFFFF,0xFFFFFFFF,0xFFFFFFFF,0xFFFFFFFF,0xFFFFFFFF
 }; ///< Database for storing keys.
 
+#ifdef GZP_WARM_RECONNECT
+
+#ifdef GZP_CRYPT_DISABLE
+#error GZP_WARM_RECONNECT requires encryption: only the keys make a warm reconnect faster.
+#endif
+
+#define GZP_WARM_CACHE_MAGIC 0x4D52415A  ///< "ZARM", the cache is valid.
+
+#if defined(__CC_ARM)
+#define GZP_WARM_CACHE_NOINIT __attribute__((section(".bss.noinit"), zero_init))
+#elif defined(__ICCARM__)
+#define GZP_WARM_CACHE_NOINIT __no_init
+#else
+#define GZP_WARM_CACHE_NOINIT __attribute__((section(".noinit")))
+#endif
+
+/**
+ * State of the last session, kept in retained RAM.
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint8_t  system_address[GZP_SYSTEM_ADDRESS_WIDTH];
+    uint8_t  host_id[GZP_HOST_ID_LENGTH];
+    uint8_t  dyn_key[GZP_DYN_KEY_LENGTH];
+    uint8_t  session_token[GZP_SESSION_TOKEN_LENGTH];
+    uint8_t  channel_table[NRF_GZLL_CONST_MAX_CHANNEL_TABLE_SIZE];
+    uint8_t  channel_table_size;
+    uint32_t check;                   ///< Checksum of the fields above.
+} gzp_warm_cache_t;
+
+static GZP_WARM_CACHE_NOINIT gzp_warm_cache_t gzp_warm_cache;
+static bool gzp_warm = false;         ///< The state was restored and no transmission has failed since.
+
+#endif
+
 
 /** @} */
 
@@ -315,8 +377,32 @@ void gzp_init()
     (void)gzp_params_restore();
 #endif
 
+#ifdef GZP_WARM_RECONNECT
+    gzp_warm = gzp_warm_cache_restore();
+#endif
+
     // Update radio parameters from gzp_system_address
     (void)gzp_update_radio_params(gzp_system_address);
+
+#ifdef GZP_WARM_RECONNECT
+    if (gzp_warm)
+    {
+        // Start on the channel table of the last session, which may have been reduced.
+        bool gzll_enabled_state = nrf_gzll_is_enabled();
+
+        nrf_gzp_disable_gzll();
+        if (!nrf_gzll_set_channel_table(gzp_warm_cache.channel_table, gzp_warm_cache.channel_table_size))
+        {
+            (void)gzp_update_radio_params(gzp_system_address);
+            gzp_warm_cache_invalidate();
+            gzp_warm = false;
+        }
+        if (gzll_enabled_state)
+        {
+            (void)nrf_gzll_enable();
+        }
+    }
+#endif
 }
 
 
@@ -324,6 +410,11 @@ void gzp_erase_pairing_data(void)
 {
     // Erase database flash page so that it can be later written to.
     nrf_nvmc_page_erase((uint32_t)database);
+
+#ifdef GZP_WARM_RECONNECT
+    gzp_warm_cache_invalidate();
+    gzp_warm = false;
+#endif
 }
 
 bool gzp_address_req_send()
@@ -386,6 +477,10 @@ bool gzp_address_req_send()
                 if (rx_payload[0] == (uint8_t)GZP_CMD_HOST_ADDRESS_RESP)
                 {
                     memcpy(gzp_system_address, &rx_payload[GZP_CMD_HOST_ADDRESS_RESP_ADDRESS], GZP_SYSTEM_ADDRESS_WIDTH);
+                    #ifdef GZP_WARM_RECONNECT
+                    gzp_warm_cache_invalidate(); // No Host ID for the new address yet.
+                    gzp_warm = false;
+                    #endif
                     gzll_update_ok &= gzp_update_radio_params(&rx_payload[GZP_CMD_HOST_ADDRESS_RESP_ADDRESS]);
                     #ifndef GZP_NV_STORAGE_DISABLE
                     (void)gzp_params_store(false); // "False" indicates that only "system address" part of DB element will be stored
@@ -482,6 +577,9 @@ gzp_id_req_res_t gzp_id_req_send()
                         #ifndef GZP_NV_STORAGE_DISABLE
                         (void)gzp_params_store(true);
                         #endif
+                        #ifdef GZP_WARM_RECONNECT
+                        gzp_warm_cache_save();
+                        #endif
                         gzp_id_req_pending = false;
                         break;
                     default:
@@ -519,6 +617,9 @@ bool gzp_crypt_data_send(const uint8_t *src, uint8_t length)
         else
         {
             //print_string("GZP_CRYPT_TX failed\r\n");
+            #ifdef GZP_WARM_RECONNECT
+            gzp_warm_fallback();
+            #endif
             // Attempt key update if user data transmission failed
             // during normal operation (!gzp_id_req_pending)
             if (!gzp_id_req_pending)
@@ -679,6 +780,9 @@ static bool gzp_crypt_tx_transaction(const uint8_t *src, uint8_t length)
                 if (!gzp_id_req_pending)
                 {
                     gzp_crypt_set_session_token(&rx_packet[GZP_CMD_ENCRYPTED_USER_DATA_RESP_SESSION_TOKEN]);
+                    #ifdef GZP_WARM_RECONNECT
+                    gzp_warm_cache_save();
+                    #endif
                 }
                 return true;
             }
@@ -1033,6 +1137,94 @@ static bool gzp_params_store(bool store_all)
     return false;
 }
 
+#ifdef GZP_WARM_RECONNECT
+
+static uint32_t gzp_warm_cache_check(void)
+{
+    // FNV-1a.
+    uint8_t const * p_byte = (uint8_t const *)&gzp_warm_cache;
+    uint32_t check = 2166136261UL;
+    uint32_t i;
+
+    for (i = 0; i < offsetof(gzp_warm_cache_t, check); i++)
+    {
+        check = (check ^ p_byte[i]) * 16777619UL;
+    }
+    return check;
+}
+
+static void gzp_warm_cache_save(void)
+{
+    uint32_t size = NRF_GZLL_CONST_MAX_CHANNEL_TABLE_SIZE;
+
+    if (gzp_array_is_set(gzp_host_id, GZP_HOST_ID_LENGTH) ||
+        !nrf_gzll_get_channel_table(gzp_warm_cache.channel_table, &size))
+    {
+        gzp_warm_cache_invalidate();
+        return;
+    }
+
+    gzp_warm_cache.magic = GZP_WARM_CACHE_MAGIC;
+    memcpy(gzp_warm_cache.system_address, gzp_system_address, GZP_SYSTEM_ADDRESS_WIDTH);
+    memcpy(gzp_warm_cache.host_id, gzp_host_id, GZP_HOST_ID_LENGTH);
+    gzp_crypt_get_dyn_key(gzp_warm_cache.dyn_key);
+    gzp_crypt_get_session_token(gzp_warm_cache.session_token);
+    gzp_warm_cache.channel_table_size = (uint8_t)size;
+    gzp_warm_cache.check = gzp_warm_cache_check();
+}
+
+static void gzp_warm_cache_invalidate(void)
+{
+    gzp_warm_cache.magic = 0;
+}
+
+static bool gzp_warm_cache_restore(void)
+{
+    if ((gzp_warm_cache.magic != GZP_WARM_CACHE_MAGIC) ||
+        (gzp_warm_cache.check != gzp_warm_cache_check()) ||
+        (gzp_warm_cache.channel_table_size == 0) ||
+        (gzp_warm_cache.channel_table_size > NRF_GZLL_CONST_MAX_CHANNEL_TABLE_SIZE))
+    {
+        gzp_warm_cache_invalidate();
+        return false;
+    }
+
+#ifndef GZP_NV_STORAGE_DISABLE
+    // The flash is the reference: the Device may have paired with another Host since.
+    if ((memcmp(gzp_warm_cache.system_address, gzp_system_address, GZP_SYSTEM_ADDRESS_WIDTH) != 0) ||
+        (memcmp(gzp_warm_cache.host_id, gzp_host_id, GZP_HOST_ID_LENGTH) != 0))
+    {
+        gzp_warm_cache_invalidate();
+        return false;
+    }
+#else
+    memcpy(gzp_system_address, gzp_warm_cache.system_address, GZP_SYSTEM_ADDRESS_WIDTH);
+    gzp_set_host_id(gzp_warm_cache.host_id);
+#endif
+
+    memcpy(dyn_key, gzp_warm_cache.dyn_key, GZP_DYN_KEY_LENGTH);
+    gzp_crypt_set_dyn_key(dyn_key);
+    gzp_crypt_set_session_token(gzp_warm_cache.session_token);
+    return true;
+}
+
+static void gzp_warm_fallback(void)
+{
+    gzp_warm_cache_invalidate();
+    if (gzp_warm)
+    {
+        gzp_warm = false;
+        (void)gzp_update_radio_params(gzp_system_address);
+    }
+}
+
+bool gzp_warm_reconnect_restored(void)
+{
+    return gzp_warm;
+}
+
+#endif
+
 static bool gzp_params_restore(void)
 {
     uint8_t i;
@@ -401,6 +401,16 @@ uint32_t _sd_ble_gattc_write(uint16_t                               conn_handle,
                                                       &buffer_length);
     APP_ERROR_CHECK(err_code);
 
+#if SER_SD_PIPELINE_ENABLED
+    if (ser_sd_transport_pipeline_is_enabled() &&
+        p_write_params && (p_write_params->write_op == BLE_GATT_OP_WRITE_CMD))
+    {
+        return ser_sd_transport_cmd_pipeline(p_buffer,
+                                             (++buffer_length),
+                                             gattc_write_rsp_dec);
+    }
+#endif
+
     //@note: Increment buffer length as internally managed packet type field must be included.
     return ser_sd_transport_cmd_write(p_buffer,
                                       (++buffer_length),
@@ -104,6 +104,31 @@ static uint32_t gatts_hvx_rsp_dec(const uint8_t * p_buffer, uint16_t length)
     return result_code;
 }
 
+#if SER_SD_PIPELINE_ENABLED
+/**@brief Command response callback function for a pipelined @ref sd_ble_gatts_hvx BLE command.
+ *
+ * The length written is not returned, as the command has returned already.
+ *
+ * @param[in] p_buffer  Pointer to begin of command response buffer.
+ * @param[in] length    Length of data in bytes.
+ *
+ * @return Decoded command response return code.
+ */
+static uint32_t gatts_hvx_pipelined_rsp_dec(const uint8_t * p_buffer, uint16_t length)
+{
+    uint32_t   result_code;
+    uint16_t   bytes_written;
+    uint16_t * p_bytes_written = &bytes_written;
+
+    const uint32_t err_code = ble_gatts_hvx_rsp_dec(p_buffer, length, &result_code,
+                                                    &p_bytes_written);
+
+    APP_ERROR_CHECK(err_code);
+
+    return result_code;
+}
+#endif
+
 #ifndef _sd_ble_gatts_hvx
 #define _sd_ble_gatts_hvx sd_ble_gatts_hvx
 #endif
@@ -121,6 +146,15 @@ uint32_t _sd_ble_gatts_hvx(uint16_t conn_handle, ble_gatts_hvx_params_t const *
                                                     &buffer_length);
     APP_ERROR_CHECK(err_code);
 
+#if SER_SD_PIPELINE_ENABLED
+    if (ser_sd_transport_pipeline_is_enabled())
+    {
+        return ser_sd_transport_cmd_pipeline(p_buffer,
+                                             (++buffer_length),
+                                             gatts_hvx_pipelined_rsp_dec);
+    }
+#endif
+
     //@note: Increment buffer length as internally managed packet type field must be included.
     return ser_sd_transport_cmd_write(p_buffer,
                                       (++buffer_length),
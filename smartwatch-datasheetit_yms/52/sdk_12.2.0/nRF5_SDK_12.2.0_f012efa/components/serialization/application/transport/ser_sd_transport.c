@@ -18,9 +18,13 @@
 #include "nrf_error.h"
 #include "app_error.h"
 #include "ble_serialization.h"
+#include "ser_config.h"
 #include "ser_dbg_sd_str.h"
 #include "ser_app_power_system_off.h"
 #include "app_util.h"
+#if SER_SD_PIPELINE_ENABLED
+#include "app_util_platform.h"
+#endif
 #define NRF_LOG_MODULE_NAME "SER_XFER"
 #include "nrf_log.h"
 
@@ -48,6 +52,60 @@ static volatile bool m_rsp_wait = false;
 /** SoftDevice call return value decoded by user decoder handler. */
 static uint32_t m_return_value;
 
+#if SER_SD_PIPELINE_ENABLED
+/** Pipelined commands waiting for their responses, oldest first. */
+static struct
+{
+    ser_sd_transport_rsp_handler_t       rsp_dec[SER_SD_PIPELINE_MAX_PENDING];
+    uint8_t                              op_code[SER_SD_PIPELINE_MAX_PENDING];
+    volatile uint8_t                     head;
+    volatile uint8_t                     count;
+    volatile bool                        wait;    /**< A command waits for a free entry. */
+    ser_sd_transport_pipeline_handler_t  handler; /**< Handler of the errors, NULL if disabled. */
+} m_pipe;
+
+
+/**@brief Function for handling the response of the oldest pipelined command, or its failure.
+ *
+ * @param[in] p_data  Response, or NULL if the transport failed.
+ * @param[in] length  Length of the response.
+ */
+static void pipe_rsp_handle(uint8_t * p_data, uint16_t length)
+{
+    uint8_t  op_code = m_pipe.op_code[m_pipe.head];
+    uint32_t result  = NRF_ERROR_INTERNAL;
+
+    if (p_data)
+    {
+        result = m_pipe.rsp_dec[m_pipe.head](p_data, length);
+        (void)ser_sd_transport_rx_free(p_data);
+    }
+
+    m_pipe.head = (m_pipe.head + 1) % SER_SD_PIPELINE_MAX_PENDING;
+    m_pipe.count--;
+
+    if ((result != NRF_SUCCESS) && m_pipe.handler)
+    {
+        m_pipe.handler(op_code, result);
+    }
+
+    /* An entry is free for the waiting command. */
+    if (m_pipe.wait)
+    {
+        m_pipe.wait = false;
+        if (m_os_rsp_set_handler)
+        {
+            m_os_rsp_set_handler();
+        }
+    }
+}
+#endif
+
+#if SER_EVT_BATCH_ENABLED
+/** Flag indicating that the events of a batch are handled. The packet is freed after the last one. */
+static bool m_rx_batch = false;
+#endif
+
 /**@brief Function for handling the rx packets comming from hal_transport.
  *
  * @details
@@ -71,6 +129,15 @@ static void ser_sd_transport_rx_packet_handler(uint8_t * p_data, uint16_t length
             case SER_PKT_TYPE_RESP:
             case SER_PKT_TYPE_DTM_RESP:
 
+#if SER_SD_PIPELINE_ENABLED
+                /* Responses come in the order of the commands, and pipelined commands are never
+                 * sent after a command waiting for its response. */
+                if (m_pipe.count > 0)
+                {
+                    pipe_rsp_handle(p_data, length);
+                }
+                else
+#endif
                 if (m_rsp_wait)
                 {
                     m_return_value = m_rsp_dec_handler(p_data, length);
@@ -99,6 +166,42 @@ static void ser_sd_transport_rx_packet_handler(uint8_t * p_data, uint16_t length
                 m_evt_handler(p_data, length);
                 break;
 
+#if SER_EVT_BATCH_ENABLED
+            case SER_PKT_TYPE_EVT_BATCH:
+            {
+                uint8_t * p_evt = p_data;
+                uint16_t  rest  = length;
+
+                m_rx_batch = true;
+                while (rest >= SER_EVT_BATCH_LEN_SIZE + SER_OP_CODE_SIZE)
+                {
+                    uint16_t evt_len = uint16_decode(p_evt);
+
+                    if (evt_len > rest - SER_EVT_BATCH_LEN_SIZE)
+                    {
+                        break;
+                    }
+                    p_evt += SER_EVT_BATCH_LEN_SIZE;
+                    rest  -= SER_EVT_BATCH_LEN_SIZE;
+
+                    NRF_LOG_DEBUG("[EVT]: %s \r\n", (uint32_t)ser_dbg_sd_evt_str_get(uint16_decode(&p_evt[SER_EVT_ID_POS])));
+                    m_evt_handler(p_evt, evt_len);
+                    p_evt += evt_len;
+                    rest  -= evt_len;
+                }
+                m_rx_batch = false;
+
+                (void)ser_sd_transport_rx_free(p_data);
+                if (rest != 0)
+                {
+                    /* Malformed batch. */
+                    APP_ERROR_HANDLER(packet_type);
+                }
+                break;
+            }
+#endif
+
+
             default:
                 (void)ser_sd_transport_rx_free(p_data);
                 APP_ERROR_HANDLER(packet_type);
@@ -133,6 +236,12 @@ static void ser_sd_transport_hal_handler(ser_hal_transport_evt_t event)
         break;
     case SER_HAL_TRANSP_EVT_PHY_ERROR:
 
+#if SER_SD_PIPELINE_ENABLED
+        while (m_pipe.count > 0)
+        {
+            pipe_rsp_handle(NULL, 0);
+        }
+#endif
         if (m_rsp_wait)
         {
             m_return_value = NRF_ERROR_INTERNAL;
@@ -192,6 +301,12 @@ uint32_t ser_sd_transport_ot_rsp_wait_handler_set(ser_sd_transport_rsp_wait_hand
 
 bool ser_sd_transport_is_busy(void)
 {
+#if SER_SD_PIPELINE_ENABLED
+    if (m_pipe.wait)
+    {
+        return true;
+    }
+#endif
     return m_rsp_wait;
 }
 
@@ -217,6 +332,13 @@ uint32_t ser_sd_transport_tx_free(uint8_t * p_data)
 
 uint32_t ser_sd_transport_rx_free(uint8_t * p_data)
 {
+#if SER_EVT_BATCH_ENABLED
+    if (m_rx_batch)
+    {
+        /* The packet holds more events. It is freed after the batch. */
+        return NRF_SUCCESS;
+    }
+#endif
     p_data -= SER_PKT_TYPE_SIZE;
     return ser_hal_transport_rx_pkt_free(p_data);
 }
@@ -252,3 +374,50 @@ uint32_t ser_sd_transport_cmd_write(const uint8_t *                p_buffer,
     NRF_LOG_DEBUG("[SD_CALL]:%s, err_code= 0x%X\r\n", (uint32_t)ser_dbg_sd_call_str_get(p_buffer[1]), err_code);
     return err_code;
 }
+
+#if SER_SD_PIPELINE_ENABLED
+void ser_sd_transport_pipeline_set(ser_sd_transport_pipeline_handler_t handler)
+{
+    m_pipe.handler = handler;
+}
+
+bool ser_sd_transport_pipeline_is_enabled(void)
+{
+    return (m_pipe.handler != NULL);
+}
+
+uint32_t ser_sd_transport_cmd_pipeline(const uint8_t *                p_buffer,
+                                       uint16_t                       length,
+                                       ser_sd_transport_rsp_handler_t cmd_rsp_decode_callback)
+{
+    uint32_t err_code;
+
+    CRITICAL_REGION_ENTER();
+    if (m_pipe.count == SER_SD_PIPELINE_MAX_PENDING)
+    {
+        m_pipe.wait = true;
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (m_pipe.wait)
+    {
+        /* Wait for a response. */
+        m_os_rsp_wait_handler();
+    }
+
+    /* The entry is added before the command is sent, as the response can come at any time. */
+    CRITICAL_REGION_ENTER();
+    uint8_t tail = (m_pipe.head + m_pipe.count) % SER_SD_PIPELINE_MAX_PENDING;
+
+    m_pipe.rsp_dec[tail] = cmd_rsp_decode_callback;
+    m_pipe.op_code[tail] = p_buffer[SER_PKT_OP_CODE_POS];
+    m_pipe.count++;
+    CRITICAL_REGION_EXIT();
+
+    err_code = ser_hal_transport_tx_pkt_send(p_buffer, length);
+    APP_ERROR_CHECK(err_code);
+
+    NRF_LOG_DEBUG("[SD_CALL]:%s, pipelined\r\n", (uint32_t)ser_dbg_sd_call_str_get(p_buffer[1]));
+    return NRF_SUCCESS;
+}
+#endif
@@ -37,6 +37,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "ser_config.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -49,6 +50,15 @@ typedef void (*ser_sd_transport_rx_notification_handler_t)(void);
 
 typedef uint32_t (*ser_sd_transport_rsp_handler_t)(const uint8_t * p_buffer, uint16_t length);
 
+/**@brief Handler of the failures of pipelined commands. Called in serial peripheral interrupt
+ *        context.
+ *
+ * @param[in] op_code  Op code of the command (@ref BLE_GATTS_SVCS, @ref BLE_GATTC_SVCS).
+ * @param[in] result   Return value of the SoftDevice call, or NRF_ERROR_INTERNAL if the transport
+ *                     failed.
+ */
+typedef void (*ser_sd_transport_pipeline_handler_t)(uint8_t op_code, uint32_t result);
+
 /**@brief Function for opening the module.
  *
  * @note 'Wait for response' and 'Response set' callbacks can be set in RTOS environment.
@@ -154,6 +164,44 @@ uint32_t ser_sd_transport_cmd_write(const uint8_t *                p_buffer,
                                     uint16_t                       length,
                                     ser_sd_transport_rsp_handler_t cmd_resp_decode_callback);
 
+#if SER_SD_PIPELINE_ENABLED
+/**@brief Function for enabling or disabling the pipelined mode.
+ *
+ * @details In pipelined mode, @ref sd_ble_gatts_hvx and @ref sd_ble_gattc_write with
+ *          @ref BLE_GATT_OP_WRITE_CMD return NRF_SUCCESS once the command is sent, without waiting
+ *          for the response. Up to @ref SER_SD_PIPELINE_MAX_PENDING commands are waiting for their
+ *          responses, and a failure is reported to the handler. The length written by
+ *          @ref sd_ble_gatts_hvx is not returned. The application counts its packets with
+ *          @ref BLE_EVT_TX_COMPLETE instead of retrying on @ref BLE_ERROR_NO_TX_PACKETS.
+ *
+ * @param[in] handler  Handler of the failures, or NULL to disable the pipelined mode.
+ */
+void ser_sd_transport_pipeline_set(ser_sd_transport_pipeline_handler_t handler);
+
+/**@brief Function for checking if the pipelined mode is enabled.
+ *
+ * @retval true      Pipelined mode.
+ * @retval false     Every command waits for its response.
+ */
+bool ser_sd_transport_pipeline_is_enabled(void);
+
+/**@brief Function for sending a SoftDevice command without waiting for its response.
+ *
+ * @note If @ref SER_SD_PIPELINE_MAX_PENDING commands are waiting for their responses, the function
+ *       blocks task context until one is received.
+ *
+ * @param[in] p_buffer                 Pointer to command.
+ * @param[in] length                   Pointer to allocated buffer length.
+ * @param[in] cmd_resp_decode_callback Pointer to a function for decoding the response packet. It is
+ *                                     called in serial peripheral interrupt context.
+ *
+ * @retval NRF_SUCCESS          Command sent.
+ */
+uint32_t ser_sd_transport_cmd_pipeline(const uint8_t *                p_buffer,
+                                       uint16_t                       length,
+                                       ser_sd_transport_rsp_handler_t cmd_resp_decode_callback);
+#endif
+
 
 #ifdef __cplusplus
 }
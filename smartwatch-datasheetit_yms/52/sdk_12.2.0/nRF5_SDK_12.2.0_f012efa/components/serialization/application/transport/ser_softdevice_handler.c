@@ -16,12 +16,18 @@
 #include "app_scheduler.h"
 #include "softdevice_handler.h"
 #include "ser_sd_transport.h"
+#include "ser_softdevice_handler.h"
 #include "ser_app_hal.h"
 #include "ser_config.h"
 #include "nrf_soc.h"
 
 
+#if SER_EVT_BATCH_ENABLED
+/* A batch of events is decoded at once. */
+#define SD_BLE_EVT_MAILBOX_QUEUE_SIZE (5 + SER_EVT_BATCH_MAX_EVENTS) /**< Size of mailbox queue. */
+#else
 #define SD_BLE_EVT_MAILBOX_QUEUE_SIZE 5 /**< Size of mailbox queue. */
+#endif
 
 /** @brief Structure used to pass packet details through mailbox.
  */
@@ -74,17 +80,22 @@ static void connectivity_reset_high(void)
 
 static void ser_softdevice_evt_handler(uint8_t * p_data, uint16_t length)
 {
-    ser_sd_handler_evt_data_t item;
-    uint32_t                  err_code;
-    uint32_t                  len32 = sizeof (item.evt_data);
+    nrf_queue_span_t spans[2];
+    uint32_t         err_code;
+    uint32_t         len32 = sizeof (ser_sd_handler_evt_data_t);
 
-    err_code = ble_event_dec(p_data, length, (ble_evt_t *)item.evt_data, &len32);
+    //decode the event straight into the mailbox slot
+    err_code = nrf_queue_write_reserve(&m_sd_ble_evt_mailbox, 1, spans);
     APP_ERROR_CHECK(err_code);
 
+    err_code = ble_event_dec(p_data, length, (ble_evt_t *)spans[0].p_data, &len32);
+    APP_ERROR_CHECK(err_code);
+
+    //the transport buffer cannot be held longer, as event handlers wait for responses in it
     err_code = ser_sd_transport_rx_free(p_data);
     APP_ERROR_CHECK(err_code);
 
-    err_code = nrf_queue_push(&m_sd_ble_evt_mailbox, &item);
+    err_code = nrf_queue_write_commit(&m_sd_ble_evt_mailbox, 1);
     APP_ERROR_CHECK(err_code);
 
     ser_app_hal_nrf_evt_pending();
@@ -122,25 +133,43 @@ uint32_t sd_evt_get(uint32_t * p_evt_id)
 
 uint32_t sd_ble_evt_get(uint8_t * p_data, uint16_t * p_len)
 {
-    uint32_t err_code = nrf_queue_pop(&m_sd_ble_evt_mailbox, p_data);
+    ble_evt_t const * p_evt;
+    uint32_t          err_code = ser_softdevice_ble_evt_peek(&p_evt);
 
     if (err_code == NRF_SUCCESS) //if anything in the mailbox
     {
-        if (((ble_evt_t *)p_data)->header.evt_len > *p_len)
+        if (p_evt->header.evt_len > *p_len)
         {
             err_code = NRF_ERROR_DATA_SIZE;
         }
         else
         {
-            *p_len = ((ble_evt_t *)p_data)->header.evt_len;
+            //only the decoded length is copied, not the whole mailbox slot
+            *p_len = p_evt->header.evt_len;
+            memcpy(p_data, p_evt, *p_len);
         }
+        ser_softdevice_ble_evt_release();
     }
-    else
+
+    return err_code;
+}
+
+uint32_t ser_softdevice_ble_evt_peek(ble_evt_t const ** pp_evt)
+{
+    nrf_queue_span_t spans[2];
+
+    if (nrf_queue_read_peek_contiguous(&m_sd_ble_evt_mailbox, spans) == 0)
     {
-        err_code = NRF_ERROR_NOT_FOUND;
+        return NRF_ERROR_NOT_FOUND;
     }
 
-    return err_code;
+    *pp_evt = (ble_evt_t const *)spans[0].p_data;
+    return NRF_SUCCESS;
+}
+
+void ser_softdevice_ble_evt_release(void)
+{
+    UNUSED_RETURN_VALUE(nrf_queue_read_release(&m_sd_ble_evt_mailbox, 1));
 }
 
 uint32_t sd_ble_evt_mailbox_length_get(uint32_t * p_mailbox_length)
@@ -29,6 +29,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "ble.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -44,6 +45,24 @@ extern "C" {
  */
 uint32_t sd_ble_evt_mailbox_length_get(uint32_t * p_mailbox_length);
 
+/**@brief Function for getting the oldest event in the internal mailbox without copying it.
+ *
+ * @details Events are decoded into the mailbox when they are received. The event stays valid,
+ *          and in the mailbox, until @ref ser_softdevice_ble_evt_release is called, so it can be
+ *          passed to the event handlers in place. @ref sd_ble_evt_get copies it instead.
+ *
+ * @param[out] pp_evt Pointer to the event.
+ *
+ * @retval ::NRF_SUCCESS         Event obtained.
+ * @retval ::NRF_ERROR_NOT_FOUND No event in the mailbox.
+ */
+uint32_t ser_softdevice_ble_evt_peek(ble_evt_t const ** pp_evt);
+
+/**@brief Function for removing the event obtained with @ref ser_softdevice_ble_evt_peek from the
+ *        internal mailbox.
+ */
+void ser_softdevice_ble_evt_release(void);
+
 
 #ifdef __cplusplus
 }
@@ -32,6 +32,7 @@ typedef enum
     SER_PKT_TYPE_DTM_CMD,     /**< DTM Command packet type. */
     SER_PKT_TYPE_DTM_RESP,    /**< DTM Response packet type. */
     SER_PKT_TYPE_RESET_CMD,   /**< System Reset Command packet type. */
+    SER_PKT_TYPE_EVT_BATCH,   /**< Batch of Event packets, each as length (2 bytes) and event. */
     SER_PKT_TYPE_MAX          /**< Upper bound. */
 } ser_pkt_type_t;
 
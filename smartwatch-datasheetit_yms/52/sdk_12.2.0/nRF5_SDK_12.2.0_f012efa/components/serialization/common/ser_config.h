@@ -57,6 +57,48 @@ extern "C" {
 #endif /* SER_CONNECTIVITY */
 
 
+/***********************************************************************************************//**
+ * Event aggregation configuration.
+ **************************************************************************************************/
+
+/** Send SoftDevice events queued back to back in one packet of type SER_PKT_TYPE_EVT_BATCH.
+ *  Must be the same on both sides of the link. */
+#ifndef SER_EVT_BATCH_ENABLED
+#define SER_EVT_BATCH_ENABLED           0
+#endif
+
+/** Highest number of events in a batch. The Application Chip decodes a whole batch at once, so its
+ *  event mailbox grows by the same number. */
+#ifndef SER_EVT_BATCH_MAX_EVENTS
+#define SER_EVT_BATCH_MAX_EVENTS        4
+#endif
+
+/** Longest time an event waits in a batch for more events, in milliseconds. With 0, a batch is
+ *  sent as soon as no more events are queued. Other values need the app_timer module. */
+#ifndef SER_EVT_BATCH_MAX_DELAY_MS
+#define SER_EVT_BATCH_MAX_DELAY_MS      0
+#endif
+
+/** Size of the length field of an event in a batch. */
+#define SER_EVT_BATCH_LEN_SIZE          2
+
+
+/***********************************************************************************************//**
+ * Command pipelining configuration.
+ **************************************************************************************************/
+
+/** Send some commands of the Application Chip without waiting for their responses, see
+ *  ser_sd_transport_pipeline_set. Only the Application Chip uses it. */
+#ifndef SER_SD_PIPELINE_ENABLED
+#define SER_SD_PIPELINE_ENABLED         0
+#endif
+
+/** Highest number of pipelined commands waiting for their responses. */
+#ifndef SER_SD_PIPELINE_MAX_PENDING
+#define SER_SD_PIPELINE_MAX_PENDING     4
+#endif
+
+
 /***********************************************************************************************//**
  * SER_PHY layer configuration.
  **************************************************************************************************/
@@ -68,6 +110,16 @@ extern "C" {
 /** Max transfer unit for SPI MASTER and SPI SLAVE. */
 #define SER_PHY_SPI_MTU_SIZE            255
 
+/** Send batches of packets in SPI transactions. Must be the same on both sides of the link. */
+#ifndef SER_PHY_SPI_BATCH_ENABLED
+#define SER_PHY_SPI_BATCH_ENABLED       0
+#endif
+
+/** Size of a batch of packets. Must hold the largest packet and its length field. */
+#ifndef SER_PHY_SPI_BATCH_SIZE
+#define SER_PHY_SPI_BATCH_SIZE          (SER_HAL_TRANSPORT_MAX_PKT_SIZE + 2)
+#endif
+
 /** UART transmission parameters */
 #define SER_PHY_UART_FLOW_CTRL          APP_UART_FLOW_CONTROL_ENABLED
 #define SER_PHY_UART_PARITY             true
@@ -0,0 +1,175 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ser_phy_spi_batch SPI PHY packet batching
+ * @{
+ * @ingroup ser_phy
+ *
+ * @brief Packet batches and link statistics shared by the SPI master and SPI slave PHY drivers.
+ *
+ * @details When @ref SER_PHY_SPI_BATCH_ENABLED is set, the payload of an SPI transaction is a
+ *          batch of packets instead of a single packet. Each packet in the batch is preceded by
+ *          its 16-bit length, encoded with uint16_encode. The length in the PHY header is the
+ *          length of the whole batch.
+ *
+ *          Packets are copied into a batch, and @ref SER_PHY_EVT_TX_PKT_SENT is reported as soon
+ *          as a packet has been copied, so that the HAL Transport layer can give the next packet
+ *          while the batch is still waiting for, or being sent on, the bus. Two batches are used:
+ *          packets are added to the first one until its transaction is started, and to the second
+ *          one after that. Small packets that are given while the bus is busy are thus sent in one
+ *          transaction and with one REQ/RDY handshake.
+ *
+ * @note Both sides of the link must use the same setting of @ref SER_PHY_SPI_BATCH_ENABLED.
+ */
+
+#ifndef SER_PHY_SPI_BATCH_H__
+#define SER_PHY_SPI_BATCH_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "app_util.h"
+#include "ser_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**@brief Size of the length field of a packet in a batch. */
+#define SER_PHY_SPI_BATCH_RECORD_HEADER_SIZE  2
+
+/**@brief Link statistics of the SPI PHY drivers. */
+typedef struct
+{
+    uint32_t tx_transactions; /**< Transactions with a payload sent. */
+    uint32_t rx_transactions; /**< Transactions with a payload received. */
+    uint32_t tx_packets;      /**< Packets sent. */
+    uint32_t rx_packets;      /**< Packets received, including dropped packets. */
+    uint32_t tx_bytes;        /**< Bytes of the packets sent. */
+    uint32_t rx_bytes;        /**< Bytes of the packets received. */
+    uint32_t overhead_bytes;  /**< Bytes of PHY headers and packet lengths, in both directions. */
+} ser_phy_spi_stats_t;
+
+/**@brief Batch of packets. */
+typedef struct
+{
+    uint8_t * p_buffer; /**< Buffer of @ref SER_PHY_SPI_BATCH_SIZE bytes. */
+    uint16_t  length;   /**< Number of bytes in the batch. */
+    uint16_t  count;    /**< Number of packets in the batch. */
+} ser_phy_spi_batch_t;
+
+/**@brief Reader of the packets of a received batch. */
+typedef struct
+{
+    uint8_t const * p_buffer; /**< Received batch. */
+    uint16_t        length;   /**< Length of the batch. */
+    uint16_t        pos;      /**< Position of the next packet. */
+} ser_phy_spi_batch_reader_t;
+
+/**@brief Function for adding a packet to a batch.
+ *
+ * @param[in] p_batch  Batch.
+ * @param[in] p_packet Packet.
+ * @param[in] length   Length of the packet.
+ *
+ * @retval true  If the packet was copied into the batch.
+ * @retval false If it does not fit.
+ */
+__STATIC_INLINE bool ser_phy_spi_batch_add(ser_phy_spi_batch_t * p_batch,
+                                           uint8_t const *       p_packet,
+                                           uint16_t              length)
+{
+    if ((uint32_t)length + SER_PHY_SPI_BATCH_RECORD_HEADER_SIZE >
+        (uint32_t)SER_PHY_SPI_BATCH_SIZE - p_batch->length)
+    {
+        return false;
+    }
+
+    p_batch->length += uint16_encode(length, &p_batch->p_buffer[p_batch->length]);
+    memcpy(&p_batch->p_buffer[p_batch->length], p_packet, length);
+    p_batch->length += length;
+    p_batch->count++;
+    return true;
+}
+
+/**@brief Function for emptying a batch. */
+__STATIC_INLINE void ser_phy_spi_batch_clear(ser_phy_spi_batch_t * p_batch)
+{
+    p_batch->length = 0;
+    p_batch->count  = 0;
+}
+
+/**@brief Function for starting to read a received batch. */
+__STATIC_INLINE void ser_phy_spi_batch_reader_init(ser_phy_spi_batch_reader_t * p_reader,
+                                                   uint8_t const *              p_buffer,
+                                                   uint16_t                     length)
+{
+    p_reader->p_buffer = p_buffer;
+    p_reader->length   = length;
+    p_reader->pos      = 0;
+}
+
+/**@brief Function for getting the next packet of a received batch.
+ *
+ * @param[in]  p_reader  Reader.
+ * @param[out] pp_packet Packet, in the batch.
+ * @param[out] p_length  Length of the packet.
+ *
+ * @retval true  If a packet was found.
+ * @retval false If the end of the batch was reached, or the rest of the batch is malformed.
+ */
+__STATIC_INLINE bool ser_phy_spi_batch_next(ser_phy_spi_batch_reader_t * p_reader,
+                                            uint8_t const **             pp_packet,
+                                            uint16_t *                   p_length)
+{
+    uint16_t length;
+
+    if ((uint32_t)p_reader->pos + SER_PHY_SPI_BATCH_RECORD_HEADER_SIZE > p_reader->length)
+    {
+        return false;
+    }
+    length = uint16_decode(&p_reader->p_buffer[p_reader->pos]);
+    if ((length == 0) ||
+        ((uint32_t)p_reader->pos + SER_PHY_SPI_BATCH_RECORD_HEADER_SIZE + length > p_reader->length))
+    {
+        return false;
+    }
+
+    *pp_packet      = &p_reader->p_buffer[p_reader->pos + SER_PHY_SPI_BATCH_RECORD_HEADER_SIZE];
+    *p_length       = length;
+    p_reader->pos  += SER_PHY_SPI_BATCH_RECORD_HEADER_SIZE + length;
+    return true;
+}
+
+/**@brief Function for getting the link statistics of the SPI PHY driver.
+ *
+ * @details The statistics are counted with and without @ref SER_PHY_SPI_BATCH_ENABLED. The share
+ *          of the bus used by packets is tx_bytes + rx_bytes over the sum of tx_bytes, rx_bytes
+ *          and overhead_bytes. The number of packets per transaction shows how much batching
+ *          saves.
+ *
+ * @param[out] p_stats Statistics.
+ */
+void ser_phy_spi_stats_get(ser_phy_spi_stats_t * p_stats);
+
+/**@brief Function for clearing the link statistics of the SPI PHY driver.
+ */
+void ser_phy_spi_stats_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SER_PHY_SPI_BATCH_H__ */
+/** @} */
@@ -20,9 +20,11 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include "nrf_drv_gpiote.h"
 #include "nrf_drv_spi.h"
 #include "ser_phy.h"
+#include "ser_phy_spi_batch.h"
 #include "ser_config.h"
 #include "app_util.h"
 #include "app_util_platform.h"
@@ -61,6 +63,7 @@ typedef enum
     SER_PHY_STATE_RX_HEADER,
     SER_PHY_STATE_MEMORY_REQUEST,
     SER_PHY_STATE_RX_PAYLOAD,
+    SER_PHY_STATE_RX_DELIVER,
     SER_PHY_STATE_DISABLED
 } ser_phy_spi_master_state_t;
 
@@ -103,6 +106,22 @@ _static volatile bool m_slave_request_flag = false;
 _static ser_phy_events_handler_t   m_callback_events_handler = NULL;
 _static ser_phy_spi_master_state_t m_spi_master_state        = SER_PHY_STATE_DISABLED;
 
+_static ser_phy_spi_stats_t m_stats;
+
+#if SER_PHY_SPI_BATCH_ENABLED
+_static uint8_t                    m_tx_batch_buffers[2][SER_PHY_SPI_BATCH_SIZE];
+_static ser_phy_spi_batch_t        m_tx_batches[2] = {{m_tx_batch_buffers[0], 0, 0},
+                                                      {m_tx_batch_buffers[1], 0, 0}};
+_static uint8_t                    m_tx_batch_bus         = 0;     //batch sent in the next or current TX transaction
+_static bool                       m_tx_batch_started     = false; //the TX transaction of the batch has started
+_static const uint8_t * volatile   mp_tx_packet           = NULL;  //packet of the upper layer, not yet in a batch
+_static uint16_t                   m_tx_packet_len        = 0;
+
+_static uint8_t                    m_rx_batch_buffer[SER_PHY_SPI_BATCH_SIZE];
+_static ser_phy_spi_batch_reader_t m_rx_batch_reader;
+_static const uint8_t *            mp_rx_batch_packet     = NULL;  //packet of the received batch being delivered
+#endif
+
 _static const nrf_drv_spi_t m_spi_master = SER_PHY_SPI_MASTER_INSTANCE;
 
 static void ser_phy_switch_state(ser_phy_event_source_t evt_src);
@@ -112,6 +131,73 @@ static void spi_master_raw_assert(bool cond)
     APP_ERROR_CHECK_BOOL(cond);
 }
 
+/* Send event SER_PHY_EVT_TX_PKT_SENT */
+static __INLINE void callback_packet_sent(void);
+
+#if SER_PHY_SPI_BATCH_ENABLED
+/* Copy the packet of the upper layer into a batch and report it as sent. Packets are added to the
+ * batch of the bus until its transaction starts, and to the other batch after that. Returns true
+ * if the batch of the bus became non-empty, so a TX transaction has to be scheduled. */
+static bool tx_batch_accept(void)
+{
+    ser_phy_spi_batch_t * p_batch;
+    bool                  bus_batch;
+
+    if (mp_tx_packet == NULL)
+    {
+        return false;
+    }
+
+    bus_batch = (mp_tx_buffer == NULL) || !m_tx_batch_started;
+    p_batch   = &m_tx_batches[bus_batch ? m_tx_batch_bus : (m_tx_batch_bus ^ 1)];
+    if (!ser_phy_spi_batch_add(p_batch, mp_tx_packet, m_tx_packet_len))
+    {
+        //no room - the packet is taken when the batch of the bus has been sent
+        return false;
+    }
+    mp_tx_packet    = NULL;
+    m_tx_packet_len = 0;
+
+    if (bus_batch)
+    {
+        bool first   = (mp_tx_buffer == NULL);
+        mp_tx_buffer = p_batch->p_buffer;
+        m_tx_buf_len = p_batch->length;
+        callback_packet_sent();
+        return first;
+    }
+    callback_packet_sent();
+    return false;
+}
+
+/* Release the batch that has been sent and make the other one the batch of the bus. */
+static void tx_batch_sent(void)
+{
+    ser_phy_spi_batch_t * p_batch = &m_tx_batches[m_tx_batch_bus];
+
+    m_stats.tx_packets     += p_batch->count;
+    m_stats.tx_bytes       += p_batch->length - (p_batch->count * SER_PHY_SPI_BATCH_RECORD_HEADER_SIZE);
+    m_stats.overhead_bytes += p_batch->count * SER_PHY_SPI_BATCH_RECORD_HEADER_SIZE;
+
+    ser_phy_spi_batch_clear(p_batch);
+    m_tx_batch_started = false;
+    m_tx_batch_bus    ^= 1;
+    p_batch            = &m_tx_batches[m_tx_batch_bus];
+
+    if (p_batch->length != 0)
+    {
+        mp_tx_buffer = p_batch->p_buffer;
+        m_tx_buf_len = p_batch->length;
+    }
+    else
+    {
+        mp_tx_buffer = NULL;
+        m_tx_buf_len = 0;
+    }
+    (void)tx_batch_accept();
+}
+#endif
+
 void SW_IRQ_Handler()
 {
     if (m_pend_req_flag)
@@ -146,7 +232,12 @@ void SW_IRQ_Handler()
     {
         m_pend_tx_api_flag = false;
         DEBUG_EVT_SPI_MASTER_RAW_API_CALL(0);
-        ser_phy_switch_state(SER_PHY_EVT_TX_API_CALL);
+#if SER_PHY_SPI_BATCH_ENABLED
+        if (tx_batch_accept())
+#endif
+        {
+            ser_phy_switch_state(SER_PHY_EVT_TX_API_CALL);
+        }
     }
 }
 
@@ -185,7 +276,7 @@ static void ser_phy_spi_master_request(nrf_drv_gpiote_pin_t pin,
 }
 
 /* Send event SER_PHY_EVT_TX_PKT_SENT */
-static __INLINE void callback_packet_sent()
+static __INLINE void callback_packet_sent(void)
 {
     ser_phy_evt_t event;
 
@@ -257,9 +348,19 @@ static __INLINE uint32_t header_send(const uint16_t length)
 {
     uint8_t buf_len_size = uint16_encode(length, m_header_buffer);
 
+    m_stats.overhead_bytes += buf_len_size;
     return nrf_drv_spi_transfer(&m_spi_master, m_header_buffer, buf_len_size, NULL, 0);
 }
 
+/* Send the header of the TX packet. In batch mode, no more packets are added to the batch. */
+static __INLINE uint32_t tx_header_send(void)
+{
+#if SER_PHY_SPI_BATCH_ENABLED
+    m_tx_batch_started = true;
+#endif
+    return header_send(m_tx_buf_len);
+}
+
 
 static __INLINE uint32_t frame_send()
 {
@@ -279,6 +380,7 @@ static __INLINE uint32_t frame_send()
 
 static __INLINE uint32_t header_get()
 {
+    m_stats.overhead_bytes += SER_PHY_HEADER_SIZE;
     return nrf_drv_spi_transfer(&m_spi_master, NULL, 0, m_header_buffer, SER_PHY_HEADER_SIZE);
 }
 
@@ -309,6 +411,61 @@ static __INLINE uint32_t frame_get()
 }
 
 
+/* Schedule the next transaction after an RX transaction: the pending TX packet first, then the
+ * next RX packet if the slave requests it. */
+static uint32_t rx_transaction_end(void)
+{
+    uint32_t err_code = NRF_SUCCESS;
+
+    if (mp_tx_buffer != NULL) //mp_tx_buffer !=NULL, this means that API_EVT was scheduled
+    {
+        if (m_slave_ready_flag )
+        {
+            err_code           = tx_header_send();
+            m_spi_master_state = SER_PHY_STATE_TX_HEADER;
+        }
+        else
+        {
+            m_spi_master_state = SER_PHY_STATE_TX_WAIT_FOR_RDY;
+        }
+    }
+    else if (m_slave_request_flag)
+    {
+        if (m_slave_ready_flag)
+        {
+            m_spi_master_state = SER_PHY_STATE_TX_ZERO_HEADER;
+            err_code           = header_send(0);
+        }
+        else
+        {
+            m_spi_master_state = SER_PHY_STATE_RX_WAIT_FOR_RDY;
+        }
+    }
+    else
+    {
+        m_spi_master_state = SER_PHY_STATE_IDLE;
+
+    }
+    return err_code;
+}
+
+#if SER_PHY_SPI_BATCH_ENABLED
+/* Request memory for the next packet of the received batch. Returns false at the end of the
+ * batch. */
+static bool rx_batch_deliver_next(void)
+{
+    if (!ser_phy_spi_batch_next(&m_rx_batch_reader, &mp_rx_batch_packet, &m_rx_buf_len))
+    {
+        return false;
+    }
+    m_stats.rx_packets++;
+    m_stats.rx_bytes       += m_rx_buf_len;
+    m_stats.overhead_bytes += SER_PHY_SPI_BATCH_RECORD_HEADER_SIZE;
+    callback_mem_request();
+    return true;
+}
+#endif
+
 /**
  * \brief Master driver main state machine
  * Executed only in the context of PendSV_Handler()
@@ -346,7 +503,7 @@ static void ser_phy_switch_state(ser_phy_event_source_t evt_src)
                 if (m_slave_ready_flag)
                 {
                     m_spi_master_state = SER_PHY_STATE_TX_HEADER;
-                    err_code           = header_send(m_tx_buf_len);
+                    err_code           = tx_header_send();
                 }
                 else
                 {
@@ -360,7 +517,7 @@ static void ser_phy_switch_state(ser_phy_event_source_t evt_src)
             if (evt_src == SER_PHY_EVT_GPIO_RDY)
             {
                 m_spi_master_state = SER_PHY_STATE_TX_HEADER;
-                err_code           = header_send(m_tx_buf_len);
+                err_code           = tx_header_send();
             }
             break;
 
@@ -419,8 +576,15 @@ static void ser_phy_switch_state(ser_phy_event_source_t evt_src)
                 else
                 {
                     spi_master_raw_assert(m_accumulated_tx_packet_length == m_tx_packet_length);
+                    m_stats.tx_transactions++;
+#if SER_PHY_SPI_BATCH_ENABLED
+                    tx_batch_sent(); //packets were reported as sent when they were added to the batch
+#else
+                    m_stats.tx_packets++;
+                    m_stats.tx_bytes += m_tx_packet_length;
                     buffer_release(&mp_tx_buffer, &m_tx_buf_len);
                     callback_packet_sent();
+#endif
                     if ( m_slave_request_flag)
                     {
                         if (m_slave_ready_flag)
@@ -433,6 +597,20 @@ static void ser_phy_switch_state(ser_phy_event_source_t evt_src)
                             m_spi_master_state = SER_PHY_STATE_RX_WAIT_FOR_RDY;
                         }
                     }
+#if SER_PHY_SPI_BATCH_ENABLED
+                    else if (mp_tx_buffer != NULL) //the next batch is waiting
+                    {
+                        if (m_slave_ready_flag)
+                        {
+                            m_spi_master_state = SER_PHY_STATE_TX_HEADER;
+                            err_code           = tx_header_send();
+                        }
+                        else
+                        {
+                            m_spi_master_state = SER_PHY_STATE_TX_WAIT_FOR_RDY;
+                        }
+                    }
+#endif
                     else
                     {
                         m_spi_master_state = SER_PHY_STATE_IDLE; //m_Tx_buffer is NULL - have to wait for API event
@@ -476,7 +654,15 @@ static void ser_phy_switch_state(ser_phy_event_source_t evt_src)
                 m_spi_master_state = SER_PHY_STATE_MEMORY_REQUEST;
                 m_rx_buf_len       = uint16_decode(m_header_buffer);
                 m_rx_packet_length = m_rx_buf_len;
+#if SER_PHY_SPI_BATCH_ENABLED
+                //the batch is received into the PHY buffer, and its packets are delivered after that
+                mp_rx_buffer       = (m_rx_packet_length <= SER_PHY_SPI_BATCH_SIZE) ?
+                                     m_rx_batch_buffer : NULL;
+                m_pend_rx_api_flag = true;
+                SET_Pend_SW_IRQ();
+#else
                 callback_mem_request();
+#endif
 
             }
             break;
@@ -525,45 +711,43 @@ static void ser_phy_switch_state(ser_phy_event_source_t evt_src)
                 else
                 {
                     spi_master_raw_assert(m_accumulated_rx_packet_length == m_rx_packet_length);
+                    m_stats.rx_transactions++;
 
-                    if (mp_rx_buffer == NULL)
+#if SER_PHY_SPI_BATCH_ENABLED
+                    if (mp_rx_buffer != NULL)
                     {
-                        callback_packet_dropped();
+                        ser_phy_spi_batch_reader_init(&m_rx_batch_reader,
+                                                      m_rx_batch_buffer,
+                                                      m_rx_packet_length);
                     }
                     else
                     {
-                        callback_packet_received();
+                        //the batch did not fit and was received to a dummy location
+                        ser_phy_spi_batch_reader_init(&m_rx_batch_reader, NULL, 0);
                     }
                     buffer_release(&mp_rx_buffer, &m_rx_buf_len);
-                    if (mp_tx_buffer != NULL) //mp_tx_buffer !=NULL, this means that API_EVT was scheduled
+                    if (rx_batch_deliver_next())
                     {
-                        if (m_slave_ready_flag )
-                        {
-                            err_code           = header_send(m_tx_buf_len);
-                            m_spi_master_state = SER_PHY_STATE_TX_HEADER;
-                        }
-                        else
-                        {
-                            m_spi_master_state = SER_PHY_STATE_TX_WAIT_FOR_RDY;
-                        }
+                        m_spi_master_state = SER_PHY_STATE_RX_DELIVER;
                     }
-                    else if (m_slave_request_flag)
+                    else
                     {
-                        if (m_slave_ready_flag)
-                        {
-                            m_spi_master_state = SER_PHY_STATE_TX_ZERO_HEADER;
-                            err_code           = header_send(0);
-                        }
-                        else
-                        {
-                            m_spi_master_state = SER_PHY_STATE_RX_WAIT_FOR_RDY;
-                        }
+                        err_code = rx_transaction_end();
+                    }
+#else
+                    m_stats.rx_packets++;
+                    m_stats.rx_bytes += m_rx_packet_length;
+                    if (mp_rx_buffer == NULL)
+                    {
+                        callback_packet_dropped();
                     }
                     else
                     {
-                        m_spi_master_state = SER_PHY_STATE_IDLE;
-
+                        callback_packet_received();
                     }
+                    buffer_release(&mp_rx_buffer, &m_rx_buf_len);
+                    err_code = rx_transaction_end();
+#endif
                 }
 
             }
@@ -574,6 +758,30 @@ static void ser_phy_switch_state(ser_phy_event_source_t evt_src)
             }
             break;
 
+#if SER_PHY_SPI_BATCH_ENABLED
+        case SER_PHY_STATE_RX_DELIVER:
+
+            if (evt_src == SER_PHY_EVT_RX_API_CALL)
+            {
+                if (mp_rx_buffer == NULL)
+                {
+                    callback_packet_dropped();
+                }
+                else
+                {
+                    memcpy(mp_rx_buffer, mp_rx_batch_packet, m_rx_buf_len);
+                    callback_packet_received();
+                }
+                buffer_release(&mp_rx_buffer, &m_rx_buf_len);
+
+                if (!rx_batch_deliver_next())
+                {
+                    err_code = rx_transaction_end();
+                }
+            }
+            break;
+#endif
+
         default:
             break;
     }
@@ -661,6 +869,22 @@ uint32_t ser_phy_tx_pkt_send(const uint8_t * p_buffer, uint16_t num_of_bytes)
         return NRF_ERROR_INVALID_PARAM;
     }
 
+#if SER_PHY_SPI_BATCH_ENABLED
+    if (num_of_bytes > SER_PHY_SPI_BATCH_SIZE - SER_PHY_SPI_BATCH_RECORD_HEADER_SIZE)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if (mp_tx_packet != NULL)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    CRITICAL_REGION_ENTER();
+    mp_tx_packet       = p_buffer;
+    m_tx_packet_len    = num_of_bytes;
+    m_pend_tx_api_flag = true;
+#else
     if (mp_tx_buffer != NULL)
     {
         return NRF_ERROR_BUSY;
@@ -671,6 +895,7 @@ uint32_t ser_phy_tx_pkt_send(const uint8_t * p_buffer, uint16_t num_of_bytes)
     mp_tx_buffer       = (uint8_t *)p_buffer;
     m_tx_buf_len       = num_of_bytes;
     m_pend_tx_api_flag = true;
+#endif
     SET_Pend_SW_IRQ();
     //ser_phy_interrupts_enable();
     CRITICAL_REGION_EXIT();
@@ -680,7 +905,11 @@ uint32_t ser_phy_tx_pkt_send(const uint8_t * p_buffer, uint16_t num_of_bytes)
 /* ser_phy API function */
 uint32_t ser_phy_rx_buf_set(uint8_t * p_buffer)
 {
+#if SER_PHY_SPI_BATCH_ENABLED
+    if (m_spi_master_state != SER_PHY_STATE_RX_DELIVER)
+#else
     if (m_spi_master_state != SER_PHY_STATE_MEMORY_REQUEST)
+#endif
     {
         return NRF_ERROR_INVALID_STATE;
     }
@@ -754,6 +983,15 @@ void ser_phy_close(void)
     m_accumulated_rx_packet_length = 0;
     m_current_rx_packet_length     = 0;
 
+#if SER_PHY_SPI_BATCH_ENABLED
+    ser_phy_spi_batch_clear(&m_tx_batches[0]);
+    ser_phy_spi_batch_clear(&m_tx_batches[1]);
+    m_tx_batch_bus     = 0;
+    m_tx_batch_started = false;
+    mp_tx_packet       = NULL;
+    m_tx_packet_len    = 0;
+#endif
+
     ser_phy_deinit_gpiote();
     nrf_drv_spi_uninit(&m_spi_master);
 }
@@ -771,4 +1009,18 @@ void ser_phy_interrupts_disable(void)
     NVIC_DisableIRQ(SW_IRQn);
 }
 
+void ser_phy_spi_stats_get(ser_phy_spi_stats_t * p_stats)
+{
+    CRITICAL_REGION_ENTER();
+    *p_stats = m_stats;
+    CRITICAL_REGION_EXIT();
+}
+
+void ser_phy_spi_stats_clear(void)
+{
+    CRITICAL_REGION_ENTER();
+    memset(&m_stats, 0, sizeof(m_stats));
+    CRITICAL_REGION_EXIT();
+}
+
 /** @} */
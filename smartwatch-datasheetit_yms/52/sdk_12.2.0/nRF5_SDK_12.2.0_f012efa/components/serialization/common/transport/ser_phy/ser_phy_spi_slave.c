@@ -33,10 +33,17 @@
 #include "ser_phy.h"
 #include "ser_phy_config_conn.h"
 #include "ser_phy_debug_conn.h"
+#include "ser_phy_spi_batch.h"
 
 #define SER_PHY_SPI_DEF_CHARACTER 0xFF //SPI default character. Character clocked out in case of an ignored transaction
 #define SER_PHY_SPI_ORC_CHARACTER 0xFF //SPI over-read character. Character clocked out after an over-read of the transmit buffer
 
+#if SER_PHY_SPI_BATCH_ENABLED
+#define SW_IRQn              SWI3_IRQn
+#define SW_IRQ_Handler()     SWI3_IRQHandler()
+#define SET_Pend_SW_IRQ()    (void)sd_nvic_SetPendingIRQ(SWI3_IRQn)
+#endif
+
 static nrf_drv_spis_t m_spis = NRF_DRV_SPIS_INSTANCE(SER_PHY_SPI_SLAVE_INSTANCE);
 
 //SPI raw peripheral device configuration data
@@ -58,6 +65,7 @@ typedef enum
     SPI_RAW_STATE_RX_PAYLOAD,
     SPI_RAW_STATE_TX_HEADER,
     SPI_RAW_STATE_TX_PAYLOAD,
+    SPI_RAW_STATE_RX_DELIVER,
 } trans_state_t;
 
 #define _static static
@@ -87,6 +95,23 @@ _static bool m_buffer_reqested_flag;
 _static trans_state_t            m_trans_state      = SPI_RAW_STATE_UNKNOWN;
 _static ser_phy_events_handler_t m_ser_phy_callback = NULL;
 
+_static ser_phy_spi_stats_t m_stats;
+
+#if SER_PHY_SPI_BATCH_ENABLED
+_static uint8_t                    m_tx_batch_buffers[2][SER_PHY_SPI_BATCH_SIZE];
+_static ser_phy_spi_batch_t        m_tx_batches[2] = {{m_tx_batch_buffers[0], 0, 0},
+                                                      {m_tx_batch_buffers[1], 0, 0}};
+_static uint8_t                    m_tx_batch_bus       = 0;     //batch sent in the next or current TX transaction
+_static bool                       m_tx_batch_started   = false; //the header of the batch has been given to the master
+_static const uint8_t * volatile   m_p_tx_packet        = NULL;  //packet of the upper layer, not yet in a batch
+_static uint16_t                   m_tx_packet_len      = 0;
+
+_static uint8_t                    m_rx_batch_buffer[SER_PHY_SPI_BATCH_SIZE];
+_static ser_phy_spi_batch_reader_t m_rx_batch_reader;
+_static const uint8_t *            m_p_rx_batch_packet  = NULL;  //packet of the received batch being delivered
+_static uint16_t                   m_rx_batch_packet_len = 0;
+#endif
+
 static void spi_slave_raw_assert(bool cond)
 {
     APP_ERROR_CHECK_BOOL(cond);
@@ -161,6 +186,8 @@ static uint32_t header_get()
 {
     uint32_t err_code;
 
+    m_stats.overhead_bytes += SER_PHY_HEADER_SIZE;
+
     err_code = nrf_drv_spis_buffers_set(&m_spis,
                                         (uint8_t *) m_zero_buffer,
                                         SER_PHY_HEADER_SIZE,
@@ -200,6 +227,8 @@ static uint32_t header_send(uint16_t len)
 {
     uint32_t err_code;
 
+    m_stats.overhead_bytes += SER_PHY_HEADER_SIZE;
+
     (void) uint16_encode(len, m_header_tx_buffer);
     err_code =
         nrf_drv_spis_buffers_set(&m_spis,
@@ -247,6 +276,90 @@ static void clear_request_line(void)
     DEBUG_EVT_SPI_SLAVE_RAW_REQ_SET(0);
 }
 
+#if SER_PHY_SPI_BATCH_ENABLED
+/* Copy the packet of the upper layer into a batch and report it as sent. Packets are added to the
+ * batch of the bus until its header is given to the master, and to the other batch after that. */
+static void tx_batch_accept(void)
+{
+    ser_phy_spi_batch_t * p_batch;
+    bool                  bus_batch;
+
+    if (m_p_tx_packet == NULL)
+    {
+        return;
+    }
+
+    bus_batch = (m_p_tx_buffer == NULL) || !m_tx_batch_started;
+    p_batch   = &m_tx_batches[bus_batch ? m_tx_batch_bus : (m_tx_batch_bus ^ 1)];
+    if (!ser_phy_spi_batch_add(p_batch, m_p_tx_packet, m_tx_packet_len))
+    {
+        //no room - the packet is taken when the batch of the bus has been sent
+        return;
+    }
+    m_p_tx_packet   = NULL;
+    m_tx_packet_len = 0;
+
+    if (bus_batch)
+    {
+        m_p_tx_buffer      = p_batch->p_buffer;
+        m_tx_packet_length = p_batch->length;
+        set_request_line();
+    }
+    callback_packet_transmitted();
+}
+
+/* Release the batch that has been sent and make the other one the batch of the bus. */
+static void tx_batch_sent(void)
+{
+    ser_phy_spi_batch_t * p_batch = &m_tx_batches[m_tx_batch_bus];
+
+    m_stats.tx_packets     += p_batch->count;
+    m_stats.tx_bytes       += p_batch->length - (p_batch->count * SER_PHY_SPI_BATCH_RECORD_HEADER_SIZE);
+    m_stats.overhead_bytes += p_batch->count * SER_PHY_SPI_BATCH_RECORD_HEADER_SIZE;
+
+    ser_phy_spi_batch_clear(p_batch);
+    m_tx_batch_started = false;
+    m_tx_batch_bus    ^= 1;
+    p_batch            = &m_tx_batches[m_tx_batch_bus];
+
+    if (p_batch->length != 0)
+    {
+        m_p_tx_buffer      = p_batch->p_buffer;
+        m_tx_packet_length = p_batch->length;
+        set_request_line();
+    }
+    else
+    {
+        m_p_tx_buffer      = NULL;
+        m_tx_packet_length = 0;
+    }
+    tx_batch_accept();
+}
+
+/* Request memory for the next packet of the received batch. Returns false at the end of the
+ * batch. */
+static bool rx_batch_deliver_next(void)
+{
+    if (!ser_phy_spi_batch_next(&m_rx_batch_reader, &m_p_rx_batch_packet, &m_rx_batch_packet_len))
+    {
+        return false;
+    }
+    m_stats.rx_packets++;
+    m_stats.rx_bytes       += m_rx_batch_packet_len;
+    m_stats.overhead_bytes += SER_PHY_SPI_BATCH_RECORD_HEADER_SIZE;
+
+    m_trans_state          = SPI_RAW_STATE_RX_DELIVER;
+    m_buffer_reqested_flag = true;
+    callback_memory_request(m_rx_batch_packet_len);
+    return true;
+}
+
+void SW_IRQ_Handler()
+{
+    tx_batch_accept();
+}
+#endif
+
 /**
  * \brief Slave driver main state machine
  * For UML graph, please refer to SDK documentation
@@ -279,16 +392,30 @@ static void spi_slave_event_handle(nrf_drv_spis_event_t event)
 
                 if (packetLength != 0 )
                 {
+#if SER_PHY_SPI_BATCH_ENABLED
+                    //the batch is received into the PHY buffer, and its packets are delivered after that
+                    m_rx_packet_length             = packetLength;
+                    m_p_rx_buffer                  = m_rx_batch_buffer;
+                    m_trash_payload_flag           = (packetLength > SER_PHY_SPI_BATCH_SIZE);
+                    m_trans_state                  = SPI_RAW_STATE_RX_PAYLOAD;
+                    m_accumulated_rx_packet_length = 0;
+                    err_code                       = frame_get();
+#else
                     m_trans_state          = SPI_RAW_STATE_MEM_REQUESTED;
                     m_buffer_reqested_flag = true;
                     m_rx_packet_length     = packetLength;
                     callback_memory_request(packetLength);
+#endif
                 }
                 else
                 {
                     if (m_p_tx_buffer)
                     {
                         clear_request_line();
+#if SER_PHY_SPI_BATCH_ENABLED
+                        //packets given from now on go to the other batch
+                        m_tx_batch_started = true;
+#endif
                         m_trans_state = SPI_RAW_STATE_TX_HEADER;
                         err_code      = header_send(m_tx_packet_length);
                     }
@@ -334,6 +461,30 @@ static void spi_slave_event_handle(nrf_drv_spis_event_t event)
                 else
                 {
                     spi_slave_raw_assert(m_accumulated_rx_packet_length == m_rx_packet_length);
+                    m_stats.rx_transactions++;
+#if SER_PHY_SPI_BATCH_ENABLED
+                    if (!m_trash_payload_flag)
+                    {
+                        ser_phy_spi_batch_reader_init(&m_rx_batch_reader,
+                                                      m_rx_batch_buffer,
+                                                      m_rx_packet_length);
+                    }
+                    else
+                    {
+                        //the batch did not fit and was received to the trash storage
+                        ser_phy_spi_batch_reader_init(&m_rx_batch_reader, NULL, 0);
+                        callback_packet_dropped();
+                    }
+
+                    //the master waits for the RDY line until the whole batch has been delivered
+                    if (!rx_batch_deliver_next())
+                    {
+                        m_trans_state = SPI_RAW_STATE_RX_HEADER;
+                        err_code      = header_get();
+                    }
+#else
+                    m_stats.rx_packets++;
+                    m_stats.rx_bytes += m_rx_packet_length;
                     m_trans_state = SPI_RAW_STATE_RX_HEADER;
                     err_code      = header_get();
 
@@ -345,10 +496,37 @@ static void spi_slave_event_handle(nrf_drv_spis_event_t event)
                     {
                         callback_packet_dropped();
                     }
+#endif
                 }
             }
             break;
 
+#if SER_PHY_SPI_BATCH_ENABLED
+        case SPI_RAW_STATE_RX_DELIVER:
+
+            if (event.evt_type == NRF_DRV_SPIS_EVT_TYPE_MAX) //This is API dummy event
+            {
+                m_buffer_reqested_flag = false;
+
+                if (!m_trash_payload_flag)
+                {
+                    memcpy(m_p_rx_buffer, m_p_rx_batch_packet, m_rx_batch_packet_len);
+                    callback_packet_received(m_p_rx_buffer, m_rx_batch_packet_len);
+                }
+                else
+                {
+                    callback_packet_dropped();
+                }
+
+                if (!rx_batch_deliver_next())
+                {
+                    m_trans_state = SPI_RAW_STATE_RX_HEADER;
+                    err_code      = header_get();
+                }
+            }
+            break;
+#endif
+
         case SPI_RAW_STATE_TX_HEADER:
 
             if (event.evt_type == NRF_DRV_SPIS_BUFFERS_SET_DONE)
@@ -389,9 +567,16 @@ static void spi_slave_event_handle(nrf_drv_spis_event_t event)
                 else
                 {
                     spi_slave_raw_assert(m_accumulated_tx_packet_length == m_tx_packet_length);
+                    m_stats.tx_transactions++;
+#if SER_PHY_SPI_BATCH_ENABLED
+                    tx_batch_sent(); //packets were reported as sent when they were added to the batch
+#else
+                    m_stats.tx_packets++;
+                    m_stats.tx_bytes += m_tx_packet_length;
                     //clear pointer before callback
                     m_p_tx_buffer = NULL;
                     callback_packet_transmitted();
+#endif
                     //spi slave TX transfer is possible only when RX is ready, so return to waiting for a header
                     m_trans_state = SPI_RAW_STATE_RX_HEADER;
                     err_code      = header_get();
@@ -442,12 +627,18 @@ static void spi_slave_gpio_init(void)
 void ser_phy_interrupts_enable(void)
 {
     (void)sd_nvic_EnableIRQ(m_spis.irq);
+#if SER_PHY_SPI_BATCH_ENABLED
+    (void)sd_nvic_EnableIRQ(SW_IRQn);
+#endif
 }
 
 /* ser_phy API function */
 void ser_phy_interrupts_disable(void)
 {
     (void)sd_nvic_DisableIRQ(m_spis.irq);
+#if SER_PHY_SPI_BATCH_ENABLED
+    (void)sd_nvic_DisableIRQ(SW_IRQn);
+#endif
 }
 
 /* ser_phy API function */
@@ -458,7 +649,11 @@ uint32_t ser_phy_rx_buf_set(uint8_t * p_buffer)
 
     ser_phy_interrupts_disable();
 
+#if SER_PHY_SPI_BATCH_ENABLED
+    if (m_buffer_reqested_flag && (m_trans_state == SPI_RAW_STATE_RX_DELIVER))
+#else
     if (m_buffer_reqested_flag && (m_trans_state == SPI_RAW_STATE_MEM_REQUESTED))
+#endif
     {
         m_p_rx_buffer = p_buffer;
 
@@ -494,14 +689,31 @@ uint32_t ser_phy_tx_pkt_send(const uint8_t * p_buffer, uint16_t num_of_bytes)
         return NRF_ERROR_NULL;
     }
 
+#if SER_PHY_SPI_BATCH_ENABLED
+    if (num_of_bytes > SER_PHY_SPI_BATCH_SIZE - SER_PHY_SPI_BATCH_RECORD_HEADER_SIZE)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+#endif
+
     ser_phy_interrupts_disable();
 
+#if SER_PHY_SPI_BATCH_ENABLED
+    //the packet is copied into a batch, and reported as sent, from the software interrupt
+    if (m_p_tx_packet == NULL)
+    {
+        m_tx_packet_len = num_of_bytes;
+        m_p_tx_packet   = p_buffer;
+        SET_Pend_SW_IRQ();
+    }
+#else
     if ( m_p_tx_buffer == NULL)
     {
         m_tx_packet_length = num_of_bytes;
         m_p_tx_buffer      = p_buffer;
         set_request_line();
     }
+#endif
     else
     {
         status = NRF_ERROR_BUSY;
@@ -561,6 +773,13 @@ uint32_t ser_phy_open(ser_phy_events_handler_t events_handler)
     {
         m_ser_phy_callback = events_handler;
 
+#if SER_PHY_SPI_BATCH_ENABLED
+        //same priority as the SPIS interrupt, so that the two do not preempt each other
+        (void)sd_nvic_ClearPendingIRQ(SW_IRQn);
+        (void)sd_nvic_SetPriority(SW_IRQn, APP_IRQ_PRIORITY_LOWEST);
+        (void)sd_nvic_EnableIRQ(SW_IRQn);
+#endif
+
         m_trans_state   = SPI_RAW_STATE_SETUP_HEADER;
         event.evt_type  = NRF_DRV_SPIS_EVT_TYPE_MAX; //force transition for dummy event
         event.rx_amount = 0;
@@ -574,7 +793,31 @@ uint32_t ser_phy_open(ser_phy_events_handler_t events_handler)
 /* ser_phy API function */
 void ser_phy_close(void)
 {
+#if SER_PHY_SPI_BATCH_ENABLED
+    (void)sd_nvic_DisableIRQ(SW_IRQn);
+    ser_phy_spi_batch_clear(&m_tx_batches[0]);
+    ser_phy_spi_batch_clear(&m_tx_batches[1]);
+    m_tx_batch_bus     = 0;
+    m_tx_batch_started = false;
+    m_p_tx_packet      = NULL;
+    m_tx_packet_len    = 0;
+    m_p_tx_buffer      = NULL;
+#endif
     nrf_drv_spis_uninit(&m_spis);
     m_ser_phy_callback = NULL;
     m_trans_state      = SPI_RAW_STATE_UNKNOWN;
 }
+
+void ser_phy_spi_stats_get(ser_phy_spi_stats_t * p_stats)
+{
+    ser_phy_interrupts_disable();
+    *p_stats = m_stats;
+    ser_phy_interrupts_enable();
+}
+
+void ser_phy_spi_stats_clear(void)
+{
+    ser_phy_interrupts_disable();
+    memset(&m_stats, 0, sizeof(m_stats));
+    ser_phy_interrupts_enable();
+}
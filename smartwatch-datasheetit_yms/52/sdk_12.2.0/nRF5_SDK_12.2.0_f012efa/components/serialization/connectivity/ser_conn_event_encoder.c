@@ -19,6 +19,195 @@
 #include "ser_config.h"
 #include "ser_hal_transport.h"
 #include "ser_conn_event_encoder.h"
+#if SER_EVT_BATCH_ENABLED && (SER_EVT_BATCH_MAX_DELAY_MS > 0)
+#include "app_timer.h"
+
+#ifndef APP_TIMER_PRESCALER
+#define APP_TIMER_PRESCALER 0
+#endif
+#endif
+
+#if SER_EVT_BATCH_ENABLED
+/** Largest payload of a packet, after the packet type. */
+#define BATCH_PAYLOAD_MAX_SIZE (SER_HAL_TRANSPORT_TX_MAX_PKT_SIZE - SER_PKT_TYPE_SIZE)
+
+/** Events encoded but not sent yet, each as length and event (opcode + data). The buffer can hold
+ *  one event of the largest size with its length, which is sent alone as SER_PKT_TYPE_EVT. */
+static struct
+{
+    uint8_t           buf[BATCH_PAYLOAD_MAX_SIZE + SER_EVT_BATCH_LEN_SIZE];
+    uint16_t          len;
+    uint8_t           count;
+    volatile bool     expired;
+} m_batch;
+
+#if (SER_EVT_BATCH_MAX_DELAY_MS > 0)
+APP_TIMER_DEF(m_batch_timer_id);
+
+static void batch_timeout_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+    m_batch.expired = true;
+}
+#endif
+
+
+/**@brief Function for sending the events of the batch in one packet. */
+static void batch_flush(void)
+{
+    uint32_t  err_code   = NRF_SUCCESS;
+    uint8_t * p_tx_buf   = NULL;
+    uint16_t  tx_buf_len = 0;
+
+    if (m_batch.count == 0)
+    {
+        return;
+    }
+
+    /* Allocate a memory buffer from HAL Transport layer for transmitting the batch.
+     * Loop until a buffer is available. */
+    do
+    {
+        err_code = ser_hal_transport_tx_pkt_alloc(&p_tx_buf, &tx_buf_len);
+    }
+    while (err_code == NRF_ERROR_NO_MEM);
+    APP_ERROR_CHECK(err_code);
+
+    if (m_batch.count == 1)
+    {
+        /* A single event is sent without its length, as when batching is disabled. */
+        p_tx_buf[SER_PKT_TYPE_POS] = SER_PKT_TYPE_EVT;
+        tx_buf_len                 = m_batch.len - SER_EVT_BATCH_LEN_SIZE;
+        memcpy(&p_tx_buf[SER_PKT_OP_CODE_POS], &m_batch.buf[SER_EVT_BATCH_LEN_SIZE], tx_buf_len);
+    }
+    else
+    {
+        p_tx_buf[SER_PKT_TYPE_POS] = SER_PKT_TYPE_EVT_BATCH;
+        tx_buf_len                 = m_batch.len;
+        memcpy(&p_tx_buf[SER_PKT_OP_CODE_POS], m_batch.buf, tx_buf_len);
+    }
+    tx_buf_len += SER_PKT_TYPE_SIZE;
+
+    m_batch.len     = 0;
+    m_batch.count   = 0;
+    m_batch.expired = false;
+#if (SER_EVT_BATCH_MAX_DELAY_MS > 0)
+    (void)app_timer_stop(m_batch_timer_id);
+#endif
+
+    err_code = ser_hal_transport_tx_pkt_send(p_tx_buf, tx_buf_len);
+    APP_ERROR_CHECK(err_code);
+    /* Scheduler is paused until the packet is sent, see ser_conn_ble_event_encoder. */
+    app_sched_pause();
+}
+
+
+/**@brief Function for encoding an event at the end of the batch.
+ *
+ * @retval NRF_SUCCESS             If the event was added.
+ * @retval NRF_ERROR_NOT_SUPPORTED If the event is not supported.
+ * @return Other errors from the encoder, if the event does not fit.
+ */
+static uint32_t batch_add(ble_evt_t * p_ble_evt)
+{
+    uint32_t err_code;
+    uint32_t evt_len;
+
+    /* The first event is allowed the size of a packet, as it may be sent alone. */
+    if (m_batch.count == 0)
+    {
+        evt_len = BATCH_PAYLOAD_MAX_SIZE;
+    }
+    else if (m_batch.len + SER_EVT_BATCH_LEN_SIZE < BATCH_PAYLOAD_MAX_SIZE)
+    {
+        evt_len = BATCH_PAYLOAD_MAX_SIZE - m_batch.len - SER_EVT_BATCH_LEN_SIZE;
+    }
+    else
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    err_code = ble_event_enc(p_ble_evt, 0, &m_batch.buf[m_batch.len + SER_EVT_BATCH_LEN_SIZE],
+                             &evt_len);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    (void)uint16_encode((uint16_t)evt_len, &m_batch.buf[m_batch.len]);
+    m_batch.len += (uint16_t)(SER_EVT_BATCH_LEN_SIZE + evt_len);
+    m_batch.count++;
+
+    return NRF_SUCCESS;
+}
+
+
+void ser_conn_event_batch_process(void)
+{
+    if ((m_batch.count > 0) && ((SER_EVT_BATCH_MAX_DELAY_MS == 0) || m_batch.expired))
+    {
+        batch_flush();
+    }
+}
+
+
+void ser_conn_ble_event_encoder(void * p_event_data, uint16_t event_size)
+{
+    uint32_t err_code;
+
+    if (NULL == p_event_data)
+    {
+        APP_ERROR_CHECK(NRF_ERROR_NULL);
+    }
+    UNUSED_PARAMETER(event_size);
+
+#if (SER_EVT_BATCH_MAX_DELAY_MS > 0)
+    static bool timer_created = false;
+
+    if (!timer_created)
+    {
+        err_code = app_timer_create(&m_batch_timer_id, APP_TIMER_MODE_SINGLE_SHOT,
+                                    batch_timeout_handler);
+        APP_ERROR_CHECK(err_code);
+        timer_created = true;
+    }
+#endif
+
+    err_code = batch_add((ble_evt_t *)p_event_data);
+    if ((err_code != NRF_SUCCESS) && (err_code != NRF_ERROR_NOT_SUPPORTED) && (m_batch.count > 0))
+    {
+        /* The event does not fit: send the batch and start a new one. */
+        batch_flush();
+        err_code = batch_add((ble_evt_t *)p_event_data);
+    }
+
+    if (err_code == NRF_ERROR_NOT_SUPPORTED)
+    {
+        APP_ERROR_CHECK(SER_WARNING_CODE);
+        return;
+    }
+    APP_ERROR_CHECK(err_code);
+
+    if (m_batch.count >= SER_EVT_BATCH_MAX_EVENTS)
+    {
+        batch_flush();
+    }
+#if (SER_EVT_BATCH_MAX_DELAY_MS > 0)
+    else if (m_batch.count == 1)
+    {
+        err_code = app_timer_start(m_batch_timer_id,
+                                   APP_TIMER_TICKS(SER_EVT_BATCH_MAX_DELAY_MS, APP_TIMER_PRESCALER),
+                                   NULL);
+        APP_ERROR_CHECK(err_code);
+    }
+#endif
+}
+
+#else
+
+void ser_conn_event_batch_process(void)
+{
+}
 
 
 void ser_conn_ble_event_encoder(void * p_event_data, uint16_t event_size)
@@ -73,3 +262,4 @@ void ser_conn_ble_event_encoder(void * p_event_data, uint16_t event_size)
     }
 }
 
+#endif // SER_EVT_BATCH_ENABLED
@@ -44,12 +44,22 @@ extern "C" {
  *          pulled from BLE SoftDevice.
  *          The function creates a new packet, calls an appropriate event encoder and sends the
  *          packet to the Application Chip.
+ *          With SER_EVT_BATCH_ENABLED, the event is encoded at the end of a batch instead, which is
+ *          sent when it is full, or by @ref ser_conn_event_batch_process.
  *
  * @param[in]   p_event_data   Pointer to event data of type @ref ble_evt_t.
  * @param[in]   event_size     Event data size.
  */
 void ser_conn_ble_event_encoder(void * p_event_data, uint16_t event_size);
 
+/**@brief A function for sending the batch of encoded events.
+ *
+ * @details The function must be called from the main loop once the application scheduler queue has
+ *          been processed. The batch is sent if SER_EVT_BATCH_MAX_DELAY_MS is 0, or if its first
+ *          event has waited for that long. Does nothing when SER_EVT_BATCH_ENABLED is 0.
+ */
+void ser_conn_event_batch_process(void);
+
 
 #ifdef __cplusplus
 }
@@ -34,6 +34,18 @@ extern "C" {
 #define ANT_STACK_EVT_MSG_BUF_SIZE      32                                                /**< Size of ANT event message buffer. This will be provided to the SoftDevice while fetching an event. */
 #define ANT_STACK_EVT_STRUCT_SIZE       (sizeof(ant_evt_t))                               /**< Size of the @ref ant_evt_t structure. This will be used by the @ref softdevice_handler to internal event buffer size needed. */
 
+/** @brief Number of ANT events pulled from the SoftDevice before they are dispatched.
+ *
+ * When several channels are open, the events pending in the ANT stack are drained in one
+ * loop and then passed to the handler one after the other, in place of alternating with the
+ * System (SOC) and BLE events. Each event takes a buffer of @ref ANT_STACK_EVT_STRUCT_SIZE.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef ANT_STACK_EVT_BATCH_SIZE
+#define ANT_STACK_EVT_BATCH_SIZE        1
+#endif
+
 /**@brief ANT stack event type. */
 typedef struct
 {
@@ -0,0 +1,344 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(SOFTDEVICE_BLE_OBSERVER) && defined(BLE_STACK_SUPPORT_REQD)
+#include "softdevice_ble_observer.h"
+#include <string.h>
+#include "nrf.h"
+#include "app_error.h"
+#include "app_util_platform.h"
+#include "nrf_assert.h"
+#if SOFTDEVICE_BLE_OBSERVER_DEFER_ENABLED
+#include "app_scheduler.h"
+#include "nrf_soc.h"
+#include "nrf_nvic.h"
+#include "ble_stack_handler_types.h"
+#endif
+
+#define NRF_LOG_MODULE_NAME "SDH_OBS"
+#include "nrf_log.h"
+
+// Create section "sdh_ble_observers".
+//lint -esym(526, sdh_ble_observersBase) -esym(526, sdh_ble_observersLimit)
+NRF_SECTION_VARS_CREATE_SECTION(sdh_ble_observers, softdevice_ble_observer_t const);
+
+// Helper macros for section variables.
+#define OBSERVER_SECTION_VARS_GET(i)    NRF_SECTION_VARS_GET((i),                              \
+                                                             softdevice_ble_observer_t const,  \
+                                                             sdh_ble_observers)
+#define OBSERVER_SECTION_VARS_COUNT     NRF_SECTION_VARS_COUNT(softdevice_ble_observer_t const,\
+                                                               sdh_ble_observers)
+
+static uint8_t m_groups[SOFTDEVICE_BLE_OBSERVER_PRIO_COUNT]; /**< Groups handled by each class. */
+static bool    m_groups_valid;                               /**< m_groups has been computed. */
+
+#if SOFTDEVICE_BLE_OBSERVER_DEFER_ENABLED
+#if (SOFTDEVICE_BLE_OBSERVER_DEFER_RING_SIZE < 1) || (SOFTDEVICE_BLE_OBSERVER_DEFER_RING_SIZE > 32)
+#error "SOFTDEVICE_BLE_OBSERVER_DEFER_RING_SIZE must be from 1 to 32."
+#endif
+
+#define EVT_RING_SLOT_WORDS CEIL_DIV(BLE_STACK_EVT_MSG_BUF_SIZE, sizeof(uint32_t))
+
+static uint32_t          m_evt_ring[SOFTDEVICE_BLE_OBSERVER_DEFER_RING_SIZE][EVT_RING_SLOT_WORDS]; /**< Buffers of the deferred events. */
+static volatile uint32_t m_evt_ring_used;    /**< Bit n is set while buffer n waits for the scheduler. */
+static volatile bool     m_evt_ring_starved; /**< An event was left in the SoftDevice because all buffers were in use. */
+#endif
+
+
+uint32_t softdevice_ble_observer_count(void)
+{
+    return OBSERVER_SECTION_VARS_COUNT;
+}
+
+
+/**@brief Function for getting the group of an event. */
+static uint8_t evt_group_get(uint16_t evt_id)
+{
+    if (evt_id < BLE_GAP_EVT_BASE)
+    {
+        return SOFTDEVICE_BLE_OBSERVER_GROUP_COMMON;
+    }
+    if (evt_id < BLE_GATTC_EVT_BASE)
+    {
+        return SOFTDEVICE_BLE_OBSERVER_GROUP_GAP;
+    }
+    if (evt_id < BLE_GATTS_EVT_BASE)
+    {
+        return SOFTDEVICE_BLE_OBSERVER_GROUP_GATTC;
+    }
+    if (evt_id < BLE_L2CAP_EVT_BASE)
+    {
+        return SOFTDEVICE_BLE_OBSERVER_GROUP_GATTS;
+    }
+    return SOFTDEVICE_BLE_OBSERVER_GROUP_L2CAP;
+}
+
+
+/**@brief Function for computing the groups handled by each class.
+ *
+ * @details The observers are constant, so this is only done for the first event.
+ */
+static void groups_init(void)
+{
+    memset(m_groups, 0, sizeof(m_groups));
+
+    for (uint32_t i = 0; i < OBSERVER_SECTION_VARS_COUNT; i++)
+    {
+        softdevice_ble_observer_t const * p_observer = OBSERVER_SECTION_VARS_GET(i);
+
+        ASSERT(p_observer->prio < SOFTDEVICE_BLE_OBSERVER_PRIO_COUNT);
+        m_groups[p_observer->prio] |= p_observer->groups;
+    }
+
+#if SOFTDEVICE_BLE_OBSERVER_STATS_ENABLED && !defined(NRF51)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+    m_groups_valid = true;
+}
+
+
+/**@brief Function for calling an observer. */
+static void observer_call(softdevice_ble_observer_t const * p_observer, ble_evt_t * p_ble_evt)
+{
+#if SOFTDEVICE_BLE_OBSERVER_STATS_ENABLED
+#if defined(NRF51)
+    p_observer->handler(p_observer->p_context, p_ble_evt);
+    p_observer->p_stats->count++;
+#else
+    uint32_t start = DWT->CYCCNT;
+    p_observer->handler(p_observer->p_context, p_ble_evt);
+    uint32_t cycles = DWT->CYCCNT - start;
+
+    // Observers of a lower class can be interrupted by the link observers of the next event.
+    CRITICAL_REGION_ENTER();
+    p_observer->p_stats->count++;
+    p_observer->p_stats->total_cycles += cycles;
+    p_observer->p_stats->max_cycles    = MAX(p_observer->p_stats->max_cycles, cycles);
+    CRITICAL_REGION_EXIT();
+#endif
+#else
+    p_observer->handler(p_observer->p_context, p_ble_evt);
+#endif
+}
+
+
+/**@brief Function for passing an event to the observers of a class. */
+static void class_notify(uint8_t prio, uint8_t group, ble_evt_t * p_ble_evt)
+{
+    if ((m_groups[prio] & group) == 0)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < OBSERVER_SECTION_VARS_COUNT; i++)
+    {
+        softdevice_ble_observer_t const * p_observer = OBSERVER_SECTION_VARS_GET(i);
+
+        if ((p_observer->prio == prio) && (p_observer->groups & group))
+        {
+            observer_call(p_observer, p_ble_evt);
+        }
+    }
+}
+
+
+/**@brief Function for passing an event to the service and application observers. */
+static void late_classes_notify(uint8_t group, ble_evt_t * p_ble_evt)
+{
+    class_notify(SOFTDEVICE_BLE_OBSERVER_PRIO_SERVICE, group, p_ble_evt);
+    class_notify(SOFTDEVICE_BLE_OBSERVER_PRIO_APP, group, p_ble_evt);
+}
+
+
+#if SOFTDEVICE_BLE_OBSERVER_DEFER_ENABLED
+/**@brief Function for checking if the CPU is in an interrupt. */
+static bool in_interrupt(void)
+{
+    return ((SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk) != 0);
+}
+
+
+/**@brief Function for getting the index of the ring buffer holding an event.
+ *
+ * @return Index, or SOFTDEVICE_BLE_OBSERVER_DEFER_RING_SIZE if the event is not in the ring.
+ */
+static uint32_t evt_ring_index_get(ble_evt_t const * p_ble_evt)
+{
+    uint32_t offset = (uint32_t)p_ble_evt - (uint32_t)m_evt_ring;
+
+    if (offset >= sizeof(m_evt_ring))
+    {
+        return SOFTDEVICE_BLE_OBSERVER_DEFER_RING_SIZE;
+    }
+    return offset / sizeof(m_evt_ring[0]);
+}
+
+
+/**@brief Function for releasing a ring buffer, and resuming the pulling if it was stopped. */
+static void evt_ring_release(uint32_t index)
+{
+    bool starved;
+
+    CRITICAL_REGION_ENTER();
+    m_evt_ring_used   &= ~(1UL << index);
+    starved            = m_evt_ring_starved;
+    m_evt_ring_starved = false;
+    CRITICAL_REGION_EXIT();
+
+    if (starved)
+    {
+#ifdef SOFTDEVICE_PRESENT
+        ret_code_t err_code = sd_nvic_SetPendingIRQ(SD_EVT_IRQn);
+        APP_ERROR_CHECK(err_code);
+#else
+        NVIC_SetPendingIRQ(SD_EVT_IRQn);
+#endif
+    }
+}
+
+
+ret_code_t softdevice_ble_observer_evt_buffer_get(uint8_t ** pp_buffer, uint16_t * p_len)
+{
+    if (!in_interrupt())
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+
+    // The buffer is only marked as used if the event is deferred.
+    for (uint32_t i = 0; i < SOFTDEVICE_BLE_OBSERVER_DEFER_RING_SIZE; i++)
+    {
+        if ((m_evt_ring_used & (1UL << i)) == 0)
+        {
+            *pp_buffer = (uint8_t *)m_evt_ring[i];
+            *p_len     = sizeof(m_evt_ring[i]);
+            return NRF_SUCCESS;
+        }
+    }
+
+    m_evt_ring_starved = true;
+    return NRF_ERROR_NO_MEM;
+}
+
+
+/**@brief Scheduler handler of a deferred event. */
+static void deferred_evt_handle(void * p_event_data, uint16_t event_size)
+{
+    ble_evt_t * p_ble_evt = *(ble_evt_t **)p_event_data;
+
+    UNUSED_PARAMETER(event_size);
+    late_classes_notify(evt_group_get(p_ble_evt->header.evt_id), p_ble_evt);
+    evt_ring_release(evt_ring_index_get(p_ble_evt));
+}
+#endif
+
+
+void softdevice_ble_observers_notify(ble_evt_t * p_ble_evt)
+{
+    uint8_t group = evt_group_get(p_ble_evt->header.evt_id);
+
+    if (!m_groups_valid)
+    {
+        groups_init();
+    }
+
+    class_notify(SOFTDEVICE_BLE_OBSERVER_PRIO_LINK, group, p_ble_evt);
+
+    if (((m_groups[SOFTDEVICE_BLE_OBSERVER_PRIO_SERVICE] |
+          m_groups[SOFTDEVICE_BLE_OBSERVER_PRIO_APP]) & group) == 0)
+    {
+        return;
+    }
+
+#if SOFTDEVICE_BLE_OBSERVER_DEFER_ENABLED
+    // Only events pulled into the ring are deferred. The buffer stays in use until the
+    // scheduler has run the observers, so only the pointer is queued.
+    uint32_t index = evt_ring_index_get(p_ble_evt);
+
+    if (index < SOFTDEVICE_BLE_OBSERVER_DEFER_RING_SIZE)
+    {
+        m_evt_ring_used |= (1UL << index);
+
+        uint32_t err_code = app_sched_lane_event_put(SOFTDEVICE_BLE_OBSERVER_DEFER_LANE,
+                                                     &p_ble_evt,
+                                                     sizeof(p_ble_evt),
+                                                     deferred_evt_handle);
+        APP_ERROR_CHECK(err_code);
+        return;
+    }
+#endif
+
+    late_classes_notify(group, p_ble_evt);
+}
+
+
+#if SOFTDEVICE_BLE_OBSERVER_STATS_ENABLED
+ret_code_t softdevice_ble_observer_stats_get(uint32_t                           index,
+                                             softdevice_ble_observer_t const ** pp_observer,
+                                             softdevice_ble_observer_stats_t  * p_stats)
+{
+    VERIFY_PARAM_NOT_NULL(pp_observer);
+    VERIFY_PARAM_NOT_NULL(p_stats);
+
+    if (index >= OBSERVER_SECTION_VARS_COUNT)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    *pp_observer = OBSERVER_SECTION_VARS_GET(index);
+
+    CRITICAL_REGION_ENTER();
+    *p_stats = *(*pp_observer)->p_stats;
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+
+
+void softdevice_ble_observer_stats_clear(void)
+{
+    for (uint32_t i = 0; i < OBSERVER_SECTION_VARS_COUNT; i++)
+    {
+        softdevice_ble_observer_t const * p_observer = OBSERVER_SECTION_VARS_GET(i);
+
+        CRITICAL_REGION_ENTER();
+        memset(p_observer->p_stats, 0, sizeof(softdevice_ble_observer_stats_t));
+        CRITICAL_REGION_EXIT();
+    }
+}
+
+
+void softdevice_ble_observer_stats_log(void)
+{
+    for (uint32_t i = 0; i < OBSERVER_SECTION_VARS_COUNT; i++)
+    {
+        softdevice_ble_observer_t const * p_observer;
+        softdevice_ble_observer_stats_t   stats;
+
+        (void)softdevice_ble_observer_stats_get(i, &p_observer, &stats);
+        if (stats.count == 0)
+        {
+            continue;
+        }
+
+        NRF_LOG_INFO("%s: prio %d, %d calls, avg %d, max %d cycles\r\n",
+                     (uint32_t)p_observer->p_name,
+                     p_observer->prio,
+                     stats.count,
+                     (uint32_t)(stats.total_cycles / stats.count),
+                     stats.max_cycles);
+    }
+}
+#endif // SOFTDEVICE_BLE_OBSERVER_STATS_ENABLED
+
+#endif // NRF_MODULE_ENABLED(SOFTDEVICE_BLE_OBSERVER) && defined(BLE_STACK_SUPPORT_REQD)
@@ -0,0 +1,240 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup softdevice_ble_observer BLE event observers
+ * @{
+ * @ingroup  softdevice_handler
+ * @brief    Registry of the modules that handle BLE events.
+ *
+ * @details  Instead of one application handler that calls every module's on_ble_evt function in
+ *           turn, each module registers an observer with @ref SOFTDEVICE_BLE_OBSERVER_DEF. The
+ *           @ref softdevice_handler calls the observers for every BLE event it pulls, in the
+ *           order of their priority class:
+ *           - @ref SOFTDEVICE_BLE_OBSERVER_PRIO_LINK: connection state, GATT and queued writes,
+ *             which the other observers rely on.
+ *           - @ref SOFTDEVICE_BLE_OBSERVER_PRIO_SERVICE: services and service clients.
+ *           - @ref SOFTDEVICE_BLE_OBSERVER_PRIO_APP: the application.
+ *
+ *           Every observer gives the groups of events (GAP, GATTS, ...) it handles. An event is
+ *           only passed to the observers of its group, and a class with no observer for the
+ *           group is skipped.
+ *
+ *           If @ref SOFTDEVICE_BLE_OBSERVER_DEFER_ENABLED is set and the events are pulled in
+ *           the interrupt (softdevice_handler_init() without a scheduler function), the link
+ *           observers run in the interrupt, and the service and application observers are
+ *           run from the @ref app_scheduler. The events are pulled directly into a ring of
+ *           @ref SOFTDEVICE_BLE_OBSERVER_DEFER_RING_SIZE buffers, and only a pointer to the buffer
+ *           goes through the scheduler, so the scheduler event size only needs to be
+ *           sizeof(ble_evt_t *). The buffer is released when the deferred observers have run.
+ *           While all the buffers are in use, the events are left in the SoftDevice. The
+ *           application handler set with softdevice_ble_evt_handler_set() is still called when
+ *           the event is pulled.
+ *
+ *           The observers are placed in the section "sdh_ble_observers", which the linker
+ *           script must keep.
+ */
+
+#ifndef SOFTDEVICE_BLE_OBSERVER_H__
+#define SOFTDEVICE_BLE_OBSERVER_H__
+
+#include <stdint.h>
+#include "sdk_common.h"
+#include "sdk_errors.h"
+#include "section_vars.h"
+#if defined(BLE_STACK_SUPPORT_REQD)
+    #include "ble.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Defer the service and application observers to the scheduler.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef SOFTDEVICE_BLE_OBSERVER_DEFER_ENABLED
+#define SOFTDEVICE_BLE_OBSERVER_DEFER_ENABLED 0
+#endif
+
+/** @brief Scheduler lane of the deferred observers. See @ref app_scheduler_lanes.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef SOFTDEVICE_BLE_OBSERVER_DEFER_LANE
+#define SOFTDEVICE_BLE_OBSERVER_DEFER_LANE 0
+#endif
+
+/** @brief Number of event buffers of the deferred observers, from 1 to 32.
+ *
+ * Each buffer is @ref BLE_STACK_EVT_MSG_BUF_SIZE bytes.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef SOFTDEVICE_BLE_OBSERVER_DEFER_RING_SIZE
+#define SOFTDEVICE_BLE_OBSERVER_DEFER_RING_SIZE 4
+#endif
+
+/** @brief Count the calls and the cycles of every observer.
+ *
+ * The cycles are counted with the DWT cycle counter, so they are 0 on nRF51.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ */
+#ifndef SOFTDEVICE_BLE_OBSERVER_STATS_ENABLED
+#define SOFTDEVICE_BLE_OBSERVER_STATS_ENABLED 0
+#endif
+
+/**@defgroup SOFTDEVICE_BLE_OBSERVER_PRIOS Priority classes
+ * @{ */
+#define SOFTDEVICE_BLE_OBSERVER_PRIO_LINK    0 /**< Link layer. Always run when the event is pulled. */
+#define SOFTDEVICE_BLE_OBSERVER_PRIO_SERVICE 1 /**< Services and service clients. */
+#define SOFTDEVICE_BLE_OBSERVER_PRIO_APP     2 /**< Application. */
+#define SOFTDEVICE_BLE_OBSERVER_PRIO_COUNT   3 /**< Number of priority classes. */
+/** @} */
+
+/**@defgroup SOFTDEVICE_BLE_OBSERVER_GROUPS Event groups
+ * @{ */
+#define SOFTDEVICE_BLE_OBSERVER_GROUP_COMMON (1 << 0) /**< Common events, for example @ref BLE_EVT_TX_COMPLETE. */
+#define SOFTDEVICE_BLE_OBSERVER_GROUP_GAP    (1 << 1) /**< GAP events. */
+#define SOFTDEVICE_BLE_OBSERVER_GROUP_GATTC  (1 << 2) /**< GATT client events. */
+#define SOFTDEVICE_BLE_OBSERVER_GROUP_GATTS  (1 << 3) /**< GATT server events. */
+#define SOFTDEVICE_BLE_OBSERVER_GROUP_L2CAP  (1 << 4) /**< L2CAP events. */
+#define SOFTDEVICE_BLE_OBSERVER_GROUP_ALL    0x1F     /**< All events. */
+/** @} */
+
+#if defined(BLE_STACK_SUPPORT_REQD)
+
+/**@brief BLE event observer handler type. */
+typedef void (*softdevice_ble_observer_handler_t)(void * p_context, ble_evt_t * p_ble_evt);
+
+/**@brief Calls and cycles of an observer. */
+typedef struct
+{
+    uint32_t count;        /**< Number of calls. */
+    uint32_t max_cycles;   /**< Longest call. */
+    uint64_t total_cycles; /**< Sum of all calls. */
+} softdevice_ble_observer_stats_t;
+
+/**@brief BLE event observer. Use @ref SOFTDEVICE_BLE_OBSERVER_DEF to create one. */
+typedef struct
+{
+    softdevice_ble_observer_handler_t handler;   /**< Handler of the observer. */
+    void                            * p_context; /**< Passed to the handler. */
+    uint8_t                           prio;      /**< Priority class, see @ref SOFTDEVICE_BLE_OBSERVER_PRIOS. */
+    uint8_t                           groups;    /**< Groups of events to handle, see @ref SOFTDEVICE_BLE_OBSERVER_GROUPS. */
+#if SOFTDEVICE_BLE_OBSERVER_STATS_ENABLED
+    char const                      * p_name;    /**< Name of the observer, for the log. */
+    softdevice_ble_observer_stats_t * p_stats;   /**< Statistics of the observer. */
+#endif
+} softdevice_ble_observer_t;
+
+/**@brief Macro for registering a BLE event observer.
+ *
+ * @param[in] _name      Name of the observer.
+ * @param[in] _prio      Priority class, see @ref SOFTDEVICE_BLE_OBSERVER_PRIOS.
+ * @param[in] _groups    Groups of events to handle, see @ref SOFTDEVICE_BLE_OBSERVER_GROUPS.
+ * @param[in] _handler   Handler of type @ref softdevice_ble_observer_handler_t.
+ * @param[in] _p_context Passed to the handler, for example the instance of a service.
+ */
+#if SOFTDEVICE_BLE_OBSERVER_STATS_ENABLED
+#define SOFTDEVICE_BLE_OBSERVER_DEF(_name, _prio, _groups, _handler, _p_context)                   \
+    static softdevice_ble_observer_stats_t CONCAT_2(_name, _stats);                                \
+    NRF_SECTION_VARS_REGISTER_VAR(sdh_ble_observers, softdevice_ble_observer_t const _name) =      \
+    {                                                                                              \
+        .handler   = (_handler),                                                                   \
+        .p_context = (_p_context),                                                                 \
+        .prio      = (_prio),                                                                      \
+        .groups    = (_groups),                                                                    \
+        .p_name    = #_name,                                                                       \
+        .p_stats   = &CONCAT_2(_name, _stats),                                                     \
+    }
+#else
+#define SOFTDEVICE_BLE_OBSERVER_DEF(_name, _prio, _groups, _handler, _p_context)                   \
+    NRF_SECTION_VARS_REGISTER_VAR(sdh_ble_observers, softdevice_ble_observer_t const _name) =      \
+    {                                                                                              \
+        .handler   = (_handler),                                                                   \
+        .p_context = (_p_context),                                                                 \
+        .prio      = (_prio),                                                                      \
+        .groups    = (_groups),                                                                    \
+    }
+#endif
+
+
+/**@brief Function for getting the number of registered observers. */
+uint32_t softdevice_ble_observer_count(void);
+
+
+/**@brief Function for passing an event to the observers.
+ *
+ * @note Called by the @ref softdevice_handler for every BLE event it pulls.
+ *
+ * @param[in] p_ble_evt Event.
+ */
+void softdevice_ble_observers_notify(ble_evt_t * p_ble_evt);
+
+
+#if SOFTDEVICE_BLE_OBSERVER_DEFER_ENABLED
+/**@brief Function for getting the buffer to pull the next event into.
+ *
+ * @note Called by the @ref softdevice_handler before it pulls a BLE event.
+ *
+ * @param[out] pp_buffer Buffer, word aligned.
+ * @param[out] p_len     Size of the buffer.
+ *
+ * @retval NRF_SUCCESS             If a free buffer of the ring was found.
+ * @retval NRF_ERROR_NOT_SUPPORTED If the events are not pulled in the interrupt, so they are
+ *                                 not deferred. The handler's own buffer is used.
+ * @retval NRF_ERROR_NO_MEM        If all the buffers are in use. The SoftDevice interrupt is
+ *                                 set pending again when one is released.
+ */
+ret_code_t softdevice_ble_observer_evt_buffer_get(uint8_t ** pp_buffer, uint16_t * p_len);
+#endif
+
+
+#if SOFTDEVICE_BLE_OBSERVER_STATS_ENABLED
+/**@brief Function for getting an observer and its statistics.
+ *
+ * @param[in]  index      Index of the observer, less than @ref softdevice_ble_observer_count.
+ * @param[out] pp_observer Observer.
+ * @param[out] p_stats    Statistics of the observer.
+ *
+ * @retval NRF_SUCCESS             If the statistics were copied.
+ * @retval NRF_ERROR_NULL          If a parameter was NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If @p index was not valid.
+ */
+ret_code_t softdevice_ble_observer_stats_get(uint32_t                           index,
+                                             softdevice_ble_observer_t const ** pp_observer,
+                                             softdevice_ble_observer_stats_t  * p_stats);
+
+
+/**@brief Function for clearing the statistics of all observers. */
+void softdevice_ble_observer_stats_clear(void);
+
+
+/**@brief Function for logging the statistics of all observers that have been called, through
+ *        @ref nrf_log.
+ */
+void softdevice_ble_observer_stats_log(void);
+#endif // SOFTDEVICE_BLE_OBSERVER_STATS_ENABLED
+
+#endif // BLE_STACK_SUPPORT_REQD
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOFTDEVICE_BLE_OBSERVER_H__
+
+/** @} */
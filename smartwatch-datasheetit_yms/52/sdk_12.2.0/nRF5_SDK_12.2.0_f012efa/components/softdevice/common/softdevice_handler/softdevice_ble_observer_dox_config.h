@@ -0,0 +1,48 @@
+/**
+ *
+ * @defgroup softdevice_ble_observer_config BLE event observer configuration
+ * @{
+ * @ingroup softdevice_ble_observer
+ */
+/** @brief Enable the BLE event observers.
+ *
+ *  Set to 1 to activate.
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define SOFTDEVICE_BLE_OBSERVER_ENABLED
+
+
+/** @brief Defer the service and application observers to the scheduler.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define SOFTDEVICE_BLE_OBSERVER_DEFER_ENABLED
+
+
+/** @brief Scheduler lane of the deferred observers.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define SOFTDEVICE_BLE_OBSERVER_DEFER_LANE
+
+
+/** @brief Number of event buffers of the deferred observers, from 1 to 32.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define SOFTDEVICE_BLE_OBSERVER_DEFER_RING_SIZE
+
+
+/** @brief Count the calls and the cycles of every observer.
+ *
+ *
+ * @note This is an NRF_CONFIG macro.
+ */
+#define SOFTDEVICE_BLE_OBSERVER_STATS_ENABLED
+
+
+/** @} */
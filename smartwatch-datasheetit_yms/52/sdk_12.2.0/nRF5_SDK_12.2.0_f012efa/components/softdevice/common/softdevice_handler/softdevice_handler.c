@@ -19,6 +19,7 @@
 #include "nrf_soc.h"
 #include "nrf_nvic.h"
 #include "sdk_common.h"
+#include "cpu_profiler_hooks.h"
 
 #if NRF_MODULE_ENABLED(CLOCK)
 #include "nrf_drv_clock.h"
@@ -37,6 +38,12 @@
     #include "ant_interface.h"
 #elif defined(BLE_STACK_SUPPORT_REQD)
     #include "ble.h"
+    #ifdef SVCALL_AS_NORMAL_FUNCTION
+        #include "ser_softdevice_handler.h"
+    #endif
+    #if NRF_MODULE_ENABLED(SOFTDEVICE_BLE_OBSERVER)
+        #include "softdevice_ble_observer.h"
+    #endif
 #endif
 
 #define RAM_START_ADDRESS         0x20000000
@@ -66,12 +73,27 @@ static ble_evt_handler_t              m_ble_evt_handler;                /**< App
 
 #ifdef ANT_STACK_SUPPORT_REQD
 // The following two definitions are needed only if ANT events are needed to be pulled from the stack.
-static ant_evt_t                      m_ant_evt_buffer;                 /**< Buffer for receiving ANT events from the SoftDevice. */
+static ant_evt_t                      m_ant_evt_buffer[ANT_STACK_EVT_BATCH_SIZE]; /**< Buffers for receiving ANT events from the SoftDevice. */
 static ant_evt_handler_t              m_ant_evt_handler;                /**< Application event handler for handling ANT events.  */
 #endif
 
 static sys_evt_handler_t              m_sys_evt_handler;                /**< Application event handler for handling System (SOC) events.  */
 
+#ifdef BLE_STACK_SUPPORT_REQD
+/**@brief Function for passing a BLE event to the observers and the application's handler.
+ */
+static void ble_evt_dispatch(ble_evt_t * p_ble_evt)
+{
+#if NRF_MODULE_ENABLED(SOFTDEVICE_BLE_OBSERVER)
+    softdevice_ble_observers_notify(p_ble_evt);
+#endif
+    if (m_ble_evt_handler != NULL)
+    {
+        m_ble_evt_handler(p_ble_evt);
+    }
+}
+#endif
+
 /**@brief       Callback function for asserts in the SoftDevice.
  *
  * @details     A pointer to this function will be passed to the SoftDevice. This function will be
@@ -105,8 +127,12 @@ void intern_softdevice_events_execute(void)
     bool no_more_soc_evts = (m_sys_evt_handler == NULL);
 #endif
 #ifdef BLE_STACK_SUPPORT_REQD
+#if NRF_MODULE_ENABLED(SOFTDEVICE_BLE_OBSERVER)
+    bool no_more_ble_evts = (m_ble_evt_handler == NULL) && (softdevice_ble_observer_count() == 0);
+#else
     bool no_more_ble_evts = (m_ble_evt_handler == NULL);
 #endif
+#endif
 #ifdef ANT_STACK_SUPPORT_REQD
     bool no_more_ant_evts = (m_ant_evt_handler == NULL);
 #endif
@@ -161,23 +187,52 @@ void intern_softdevice_events_execute(void)
                 return;
             }
 
-            // Pull event from stack
-            uint16_t evt_len = m_ble_evt_buffer_size;
+#ifdef SVCALL_AS_NORMAL_FUNCTION
+            // Serialization: the event was decoded into the mailbox, so it is handled in place and
+            // released when the handler returns.
+            ble_evt_t const * p_ble_evt;
 
-            err_code = sd_ble_evt_get(mp_ble_evt_buffer, &evt_len);
+            err_code = ser_softdevice_ble_evt_peek(&p_ble_evt);
             if (err_code == NRF_ERROR_NOT_FOUND)
             {
                 no_more_ble_evts = true;
             }
+            else
+            {
+                // Call the observers and application's BLE stack event handler.
+                ble_evt_dispatch((ble_evt_t *)p_ble_evt);
+                ser_softdevice_ble_evt_release();
+            }
+#else
+            // Pull event from stack
+            uint8_t * p_evt_buffer = mp_ble_evt_buffer;
+            uint16_t  evt_len      = m_ble_evt_buffer_size;
+
+#if NRF_MODULE_ENABLED(SOFTDEVICE_BLE_OBSERVER) && SOFTDEVICE_BLE_OBSERVER_DEFER_ENABLED
+            // Deferred events are pulled directly into a buffer of the observers, which is
+            // released after they have run.
+            // If none is free, the events are left in the SoftDevice until one is released.
+            err_code = softdevice_ble_observer_evt_buffer_get(&p_evt_buffer, &evt_len);
+            if (err_code != NRF_ERROR_NO_MEM)
+#endif
+            {
+                err_code = sd_ble_evt_get(p_evt_buffer, &evt_len);
+            }
+
+            if ((err_code == NRF_ERROR_NOT_FOUND) || (err_code == NRF_ERROR_NO_MEM))
+            {
+                no_more_ble_evts = true;
+            }
             else if (err_code != NRF_SUCCESS)
             {
                 APP_ERROR_HANDLER(err_code);
             }
             else
             {
-                // Call application's BLE stack event handler.
-                m_ble_evt_handler((ble_evt_t *)mp_ble_evt_buffer);
+                // Call the observers and application's BLE stack event handler.
+                ble_evt_dispatch((ble_evt_t *)p_evt_buffer);
             }
+#endif
         }
 #endif
 
@@ -191,22 +246,37 @@ void intern_softdevice_events_execute(void)
                 return;
             }
 
-            // Pull event from stack
-            err_code = sd_ant_event_get(&m_ant_evt_buffer.channel,
-                                        &m_ant_evt_buffer.event,
-                                        m_ant_evt_buffer.msg.evt_buffer);
-            if (err_code == NRF_ERROR_NOT_FOUND)
-            {
-                no_more_ant_evts = true;
-            }
-            else if (err_code != NRF_SUCCESS)
+            uint32_t ant_evt_count = 0;
+
+            // Pull a batch of events from stack
+            while (ant_evt_count < ANT_STACK_EVT_BATCH_SIZE)
             {
-                APP_ERROR_HANDLER(err_code);
+                ant_evt_t * p_ant_evt = &m_ant_evt_buffer[ant_evt_count];
+
+                err_code = sd_ant_event_get(&p_ant_evt->channel,
+                                            &p_ant_evt->event,
+                                            p_ant_evt->msg.evt_buffer);
+                if (err_code == NRF_ERROR_NOT_FOUND)
+                {
+                    no_more_ant_evts = true;
+                    break;
+                }
+                else if (err_code != NRF_SUCCESS)
+                {
+                    APP_ERROR_HANDLER(err_code);
+                    break;
+                }
+                else
+                {
+                    ant_evt_count++;
+                }
             }
-            else
+
+            // Call application's ANT stack event handler. The events already pulled are passed on
+            // even if the handler suspends the event handling, since they are no longer in the stack.
+            for (uint32_t i = 0; i < ant_evt_count; i++)
             {
-                // Call application's ANT stack event handler.
-                m_ant_evt_handler(&m_ant_evt_buffer);
+                m_ant_evt_handler(&m_ant_evt_buffer[i]);
             }
         }
 #endif
@@ -393,6 +463,8 @@ uint32_t softdevice_sys_evt_handler_set(sys_evt_handler_t sys_evt_handler)
  */
 void SOFTDEVICE_EVT_IRQHandler(void)
 {
+    CPU_PROFILER_ISR_ENTER(CPU_PROFILER_ISR_SOFTDEVICE_EVT);
+
     if (m_evt_schedule_func != NULL)
     {
         uint32_t err_code = m_evt_schedule_func();
@@ -402,6 +474,8 @@ void SOFTDEVICE_EVT_IRQHandler(void)
     {
         intern_softdevice_events_execute();
     }
+
+    CPU_PROFILER_ISR_EXIT(CPU_PROFILER_ISR_SOFTDEVICE_EVT);
 }
 
 void softdevice_handler_suspend()
@@ -37,6 +37,7 @@
 #include "fstorage.h"
 #include "ble_conn_state.h"
 #include "nrf_ble_gatt.h"
+#include "ble_scan_filter.h"
 #define NRF_LOG_MODULE_NAME "APP"
 #include "nrf_log.h"
 #include "nrf_log_ctrl.h"
@@ -70,24 +71,6 @@
 
 
 
-/**@breif Macro to unpack 16bit unsigned UUID from octet stream. */
-#define UUID16_EXTRACT(DST, SRC) \
-    do                           \
-    {                            \
-        (*(DST))   = (SRC)[1];   \
-        (*(DST)) <<= 8;          \
-        (*(DST))  |= (SRC)[0];   \
-    } while (0)
-
-
-/**@brief Variable length data encapsulation in terms of length and pointer to data */
-typedef struct
-{
-    uint8_t  * p_data;      /**< Pointer to data. */
-    uint16_t   data_len;    /**< Length of data. */
-} data_t;
-
-
 static ble_db_discovery_t    m_ble_db_discovery;           /**< Structure used to identify the DB Discovery module. */
 static ble_hrs_c_t           m_ble_hrs_c;                  /**< Structure used to identify the heart rate client module. */
 static ble_bas_c_t           m_ble_bas_c;                  /**< Structure used to identify the Battery Service client module. */
@@ -96,6 +79,7 @@ static uint16_t              m_conn_handle;                /**< Current connecti
 static bool                  m_whitelist_disabled;         /**< True if whitelist has been temporarily disabled. */
 static bool                  m_memory_access_in_progress;  /**< Flag to keep track of ongoing operations on persistent memory. */
 static nrf_ble_gatt_t        m_gatt;                       /**< Structure for gatt module*/
+static ble_scan_filter_t     m_scan_filter;                /**< Filter of the advertising reports. */
 
 static bool                  m_retry_db_disc;              /**< Flag to keep track of whether the DB discovery should be retried. */
 static uint16_t              m_pending_db_disc_conn = BLE_CONN_HANDLE_INVALID;  /**< Connection handle for which the DB discovery is retried. */
@@ -264,42 +248,6 @@ static void pm_evt_handler(pm_evt_t const * p_evt)
 }
 
 
-/**
- * @brief Parses advertisement data, providing length and location of the field in case
- *        matching data is found.
- *
- * @param[in]  Type of data to be looked for in advertisement data.
- * @param[in]  Advertisement report length and pointer to report.
- * @param[out] If data type requested is found in the data report, type data length and
- *             pointer to data will be populated here.
- *
- * @retval NRF_SUCCESS if the data type is found in the report.
- * @retval NRF_ERROR_NOT_FOUND if the data type could not be found.
- */
-static uint32_t adv_report_parse(uint8_t type, data_t * p_advdata, data_t * p_typedata)
-{
-    uint32_t  index = 0;
-    uint8_t * p_data;
-
-    p_data = p_advdata->p_data;
-
-    while (index < p_advdata->data_len)
-    {
-        uint8_t field_length = p_data[index];
-        uint8_t field_type   = p_data[index + 1];
-
-        if (field_type == type)
-        {
-            p_typedata->p_data   = &p_data[index + 2];
-            p_typedata->data_len = field_length - 1;
-            return NRF_SUCCESS;
-        }
-        index += field_length + 1;
-    }
-    return NRF_ERROR_NOT_FOUND;
-}
-
-
 /**@brief Function for putting the chip into sleep mode.
  *
  * @note This function will not return.
@@ -319,131 +267,6 @@ static void sleep_mode_enter(void)
 }
 
 
-/**@brief Function for searching a given name in the advertisement packets.
- *
- * @details Use this function to parse received advertising data and to find a given
- * name in them either as 'complete_local_name' or as 'short_local_name'.
- *
- * @param[in]   p_adv_report   advertising data to parse.
- * @param[in]   name_to_find   name to search.
- * @return   true if the given name was found, false otherwise.
- */
-static bool find_adv_name(const ble_gap_evt_adv_report_t *p_adv_report, const char * name_to_find)
-{
-    uint32_t err_code;
-    data_t   adv_data;
-    data_t   dev_name;
-
-    // Initialize advertisement report for parsing
-    adv_data.p_data     = (uint8_t *)p_adv_report->data;
-    adv_data.data_len   = p_adv_report->dlen;
-
-
-    //search for advertising names
-    err_code = adv_report_parse(BLE_GAP_AD_TYPE_COMPLETE_LOCAL_NAME,
-                                &adv_data,
-                                &dev_name);
-    if (err_code == NRF_SUCCESS)
-    {
-        if (memcmp(name_to_find, dev_name.p_data, dev_name.data_len )== 0)
-        {
-            return true;
-        }
-    }
-    else
-    {
-        // Look for the short local name if it was not found as complete
-        err_code = adv_report_parse(BLE_GAP_AD_TYPE_SHORT_LOCAL_NAME,
-                                    &adv_data,
-                                    &dev_name);
-        if (err_code != NRF_SUCCESS)
-        {
-            return false;
-        }
-        if (memcmp(m_target_periph_name, dev_name.p_data, dev_name.data_len )== 0)
-        {
-            return true;
-        }
-    }
-    return false;
-}
-
-
-/**@brief Function for searching a given addr in the advertisement packets.
- *
- * @details Use this function to parse received advertising data and to find a given
- * addr in them.
- *
- * @param[in]   p_adv_report   advertising data to parse.
- * @param[in]   p_addr   name to search.
- * @return   true if the given name was found, false otherwise.
- */
-static bool find_peer_addr(const ble_gap_evt_adv_report_t *p_adv_report, const ble_gap_addr_t * p_addr)
-{
-    if (p_addr->addr_type == p_adv_report->peer_addr.addr_type)
-    {
-        if (memcmp(p_addr->addr, p_adv_report->peer_addr.addr, sizeof(p_adv_report->peer_addr.addr)) == 0)
-        {
-            return true;
-        }
-    }
-    return false;
-}
-
-
-/**@brief Function for searching a UUID in the advertisement packets.
- *
- * @details Use this function to parse received advertising data and to find a given
- * UUID in them.
- *
- * @param[in]   p_adv_report   advertising data to parse.
- * @param[in]   uuid_to_find   UUIID to search.
- * @return   true if the given UUID was found, false otherwise.
- */
-static bool find_adv_uuid(const ble_gap_evt_adv_report_t *p_adv_report, const uint16_t uuid_to_find)
-{
-    uint32_t err_code;
-    data_t   adv_data;
-    data_t   type_data;
-
-    // Initialize advertisement report for parsing.
-    adv_data.p_data     = (uint8_t *)p_adv_report->data;
-    adv_data.data_len   = p_adv_report->dlen;
-
-    err_code = adv_report_parse(BLE_GAP_AD_TYPE_16BIT_SERVICE_UUID_MORE_AVAILABLE,
-                                &adv_data,
-                                &type_data);
-
-    if (err_code != NRF_SUCCESS)
-    {
-        // Look for the services in 'complete' if it was not found in 'more available'.
-        err_code = adv_report_parse(BLE_GAP_AD_TYPE_16BIT_SERVICE_UUID_COMPLETE,
-                                    &adv_data,
-                                    &type_data);
-
-        if (err_code != NRF_SUCCESS)
-        {
-            // If we can't parse the data, then exit.
-            return false;
-        }
-    }
-
-    // Verify if any UUID match the given UUID.
-    for (uint32_t u_index = 0; u_index < (type_data.data_len / sizeof(uint16_t)); u_index++)
-    {
-        uint16_t extracted_uuid;
-
-        UUID16_EXTRACT(&extracted_uuid, &type_data.p_data[u_index * sizeof(uint16_t)]);
-
-        if (extracted_uuid == uuid_to_find)
-        {
-            return true;
-        }
-    }
-    return false;
-}
-
-
 /**@brief Function for handling the Application's BLE Stack events.
  *
  * @param[in]   p_ble_evt   Bluetooth stack event.
@@ -483,33 +306,12 @@ static void on_ble_evt(ble_evt_t * p_ble_evt)
 
         case BLE_GAP_EVT_ADV_REPORT:
         {
-            bool do_connect = false;
-            if (is_connect_per_addr)
-            {
-                if (find_peer_addr(&p_gap_evt->params.adv_report, &m_target_periph_addr))
-                {
-                    NRF_LOG_INFO("Address match send connect_request.\r\n");
-                    do_connect = true;
-                }
-            }
-            else if (strlen(m_target_periph_name) != 0)
-            {
-                if (find_adv_name(&p_gap_evt->params.adv_report, m_target_periph_name))
-                {
-                    do_connect = true;
-                    NRF_LOG_INFO("Name match send connect_request.\r\n");
-                }
-            }
-            else
-            {
-                if (find_adv_uuid(&p_gap_evt->params.adv_report, TARGET_UUID))
-                {
-                    do_connect = true;
-                    NRF_LOG_INFO("UUID match send connect_request.\r\n");
-                }
-            }
-            if (do_connect)
+            uint8_t matched = ble_scan_filter_match(&m_scan_filter, &p_gap_evt->params.adv_report);
+
+            if (matched != 0)
             {
+                NRF_LOG_INFO("Filter match 0x%x, send connect_request.\r\n", matched);
+
                 // Stop scanning.
                 (void) sd_ble_gap_scan_stop();
 
@@ -884,6 +686,7 @@ static void hrs_c_init(void)
     ble_hrs_c_init_t hrs_c_init_obj;
 
     hrs_c_init_obj.evt_handler = hrs_c_evt_handler;
+    hrs_c_init_obj.p_gatt_queue = NULL;
 
     uint32_t err_code = ble_hrs_c_init(&m_ble_hrs_c, &hrs_c_init_obj);
     APP_ERROR_CHECK(err_code);
@@ -964,6 +767,41 @@ static void whitelist_load()
 }
 
 
+/**@brief Function for compiling the filter of the advertising reports.
+ *
+ * @details Connects to the address if is_connect_per_addr is set, else to the name if there is
+ *          one, else to the devices that advertise TARGET_UUID.
+ */
+static void scan_filter_init(void)
+{
+    static const uint16_t    target_uuid = TARGET_UUID;
+    ble_scan_filter_config_t config;
+    ret_code_t               err_code;
+
+    memset(&config, 0, sizeof(config));
+    config.mode     = BLE_SCAN_FILTER_MODE_ANY;
+    config.rssi_min = BLE_SCAN_FILTER_RSSI_ANY;
+
+    if (is_connect_per_addr)
+    {
+        config.p_addrs    = &m_target_periph_addr;
+        config.addr_count = 1;
+    }
+    else if (strlen(m_target_periph_name) != 0)
+    {
+        config.p_name_prefix = m_target_periph_name;
+    }
+    else
+    {
+        config.p_uuids    = &target_uuid;
+        config.uuid_count = 1;
+    }
+
+    err_code = ble_scan_filter_init(&m_scan_filter, &config);
+    APP_ERROR_CHECK(err_code);
+}
+
+
 /**@brief Function to start scanning.
  */
 static void scan_start(void)
@@ -1151,6 +989,7 @@ int main(void)
     db_discovery_init();
     hrs_c_init();
     bas_c_init();
+    scan_filter_init();
 
     // Start scanning for peripherals and initiate connection
     // with devices that advertise Heart Rate UUID.
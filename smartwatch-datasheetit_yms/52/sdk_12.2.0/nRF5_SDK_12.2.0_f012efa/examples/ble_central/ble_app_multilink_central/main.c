@@ -33,6 +33,7 @@
 #include "ble_db_discovery.h"
 #include "ble_lbs_c.h"
 #include "ble_conn_state.h"
+#include "ble_conn_sched.h"
 
 #define NRF_LOG_MODULE_NAME "APP"
 #include "nrf_log.h"
@@ -57,8 +58,8 @@
 #define SCAN_WINDOW               0x0050                                     /**< Determines scan window in units of 0.625 millisecond. */
 #define SCAN_TIMEOUT              0x0000                                     /**< Timout when scanning. 0x0000 disables timeout. */
 
-#define MIN_CONNECTION_INTERVAL   MSEC_TO_UNITS(7.5, UNIT_1_25_MS)           /**< Determines minimum connection interval in milliseconds. */
-#define MAX_CONNECTION_INTERVAL   MSEC_TO_UNITS(30, UNIT_1_25_MS)            /**< Determines maximum connection interval in milliseconds. */
+#define BASE_CONNECTION_INTERVAL  MSEC_TO_UNITS(30, UNIT_1_25_MS)            /**< Base connection interval. The interval of every link is a multiple of it. */
+#define CONNECT_TIMEOUT           5                                          /**< Duration of a connection attempt to the known peers, in seconds. */
 #define SLAVE_LATENCY             0                                          /**< Determines slave latency in terms of connection events. */
 #define SUPERVISION_TIMEOUT       MSEC_TO_UNITS(4000, UNIT_10_MS)            /**< Determines supervision time-out in units of 10 milliseconds. */
 
@@ -91,15 +92,6 @@ static const ble_gap_scan_params_t m_scan_params =
     #endif
 };
 
-/**@brief Connection parameters requested for connection. */
-static const ble_gap_conn_params_t m_connection_param =
-{
-    (uint16_t)MIN_CONNECTION_INTERVAL,
-    (uint16_t)MAX_CONNECTION_INTERVAL,
-    (uint16_t)SLAVE_LATENCY,
-    (uint16_t)SUPERVISION_TIMEOUT
-};
-
 static ble_lbs_c_t        m_ble_lbs_c[TOTAL_LINK_COUNT];           /**< Main structures used by the LED Button client module. */
 static uint8_t            m_ble_lbs_c_count;                       /**< Keeps track of how many instances of LED Button client module have been initialized. >*/
 static ble_db_discovery_t m_ble_db_discovery[TOTAL_LINK_COUNT];    /**< list of DB structures used by the database discovery module. */
@@ -286,8 +278,8 @@ static void on_adv_report(const ble_evt_t * const p_ble_evt)
 
     if (do_connect)
     {
-        // Initiate connection.
-        err_code = sd_ble_gap_connect(peer_addr, &m_scan_params, &m_connection_param);
+        // Remember the peer, so that it is reconnected after a disconnection, and connect to it.
+        err_code = ble_conn_sched_peer_add(peer_addr, 1, NULL);
         if (err_code != NRF_SUCCESS)
         {
             NRF_LOG_ERROR("Connection Request Failed, reason %d\r\n", err_code);
@@ -336,23 +328,14 @@ static void on_ble_evt(const ble_evt_t * const p_ble_evt)
                 APP_ERROR_CHECK(err_code);
             }
 
-            // Update LEDs status, and check if we should be looking for more
-            // peripherals to connect to.
+            // Update LEDs status. Scanning is resumed by conn_sched_evt_handler() once the
+            // other known peers are connected.
             bsp_board_led_on(CENTRAL_CONNECTED_LED);
-            if (ble_conn_state_n_centrals() == CENTRAL_LINK_COUNT)
-            {
-                bsp_board_led_off(CENTRAL_SCANNING_LED);
-            }
-            else
-            {
-                // Resume scanning.
-                bsp_board_led_on(CENTRAL_SCANNING_LED);
-                scan_start();
-            }
+            bsp_board_led_off(CENTRAL_SCANNING_LED);
         } break; // BLE_GAP_EVT_CONNECTED
 
-        // Upon disconnection, reset the connection handle of the peer which disconnected, update
-        // the LEDs status and start scanning again.
+        // Upon disconnection, update the LEDs status. The peer is reconnected by the connection
+        // scheduler.
         case BLE_GAP_EVT_DISCONNECTED:
         {
             uint32_t central_link_cnt; // Number of central links.
@@ -364,11 +347,7 @@ static void on_ble_evt(const ble_evt_t * const p_ble_evt)
             err_code = app_button_disable();
             APP_ERROR_CHECK(err_code);
 
-            // Start scanning
-            scan_start();
-
             // Update LEDs status.
-            bsp_board_led_on(CENTRAL_SCANNING_LED);
             central_link_cnt = ble_conn_state_n_centrals();
             if (central_link_cnt == 0)
             {
@@ -389,14 +368,6 @@ static void on_ble_evt(const ble_evt_t * const p_ble_evt)
             }
         } break;
 
-        case BLE_GAP_EVT_CONN_PARAM_UPDATE_REQUEST:
-        {
-            // Accept parameters requested by peer.
-            err_code = sd_ble_gap_conn_param_update(p_gap_evt->conn_handle,
-                                        &p_gap_evt->params.conn_param_update_request.conn_params);
-            APP_ERROR_CHECK(err_code);
-        } break;
-
         case BLE_GATTC_EVT_TIMEOUT:
         {
             // Disconnect on GATT Client timeout event.
@@ -443,6 +414,7 @@ static void ble_evt_dispatch(ble_evt_t * p_ble_evt)
     conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
 
     ble_conn_state_on_ble_evt(p_ble_evt);
+    ble_conn_sched_on_ble_evt(p_ble_evt);
     on_ble_evt(p_ble_evt);
 
     // Make sure taht an invalid connection handle are not passed since
@@ -600,6 +572,65 @@ static void db_disc_handler(ble_db_discovery_evt_t * p_evt)
 }
 
 
+/**@brief Function for handling the events of the connection scheduler.
+ *
+ * @param[in] p_evt Event.
+ */
+static void conn_sched_evt_handler(ble_conn_sched_evt_t const * p_evt)
+{
+    switch (p_evt->evt_type)
+    {
+        case BLE_CONN_SCHED_EVT_CONNECTED:
+            NRF_LOG_INFO("Peer %d connected, interval %d.\r\n",
+                         p_evt->peer_id,
+                         p_evt->params.interval);
+            break;
+
+        case BLE_CONN_SCHED_EVT_CONFLICT:
+            NRF_LOG_WARNING("Link 0x%x conflicts with the other links, load %d permille.\r\n",
+                            p_evt->conn_handle,
+                            p_evt->params.conflict.load_permille);
+            break;
+
+        case BLE_CONN_SCHED_EVT_IDLE:
+            // The known peers are connected, or not in range. Look for new ones.
+            if (ble_conn_state_n_centrals() < CENTRAL_LINK_COUNT)
+            {
+                bsp_board_led_on(CENTRAL_SCANNING_LED);
+                scan_start();
+            }
+            break;
+
+        case BLE_CONN_SCHED_EVT_ERROR:
+            NRF_LOG_ERROR("Connection scheduler error 0x%x.\r\n", p_evt->params.err_code);
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+/**@brief Connection scheduler initialization.
+ */
+static void conn_sched_init(void)
+{
+    ble_conn_sched_init_t init;
+
+    memset(&init, 0, sizeof(init));
+    init.base_interval   = BASE_CONNECTION_INTERVAL;
+    init.slave_latency   = SLAVE_LATENCY;
+    init.sup_timeout     = SUPERVISION_TIMEOUT;
+    init.scan_interval   = SCAN_INTERVAL;
+    init.scan_window     = SCAN_WINDOW;
+    init.connect_timeout = CONNECT_TIMEOUT;
+    init.evt_handler     = conn_sched_evt_handler;
+
+    ret_code_t err_code = ble_conn_sched_init(&init);
+    APP_ERROR_CHECK(err_code);
+}
+
+
 /** @brief Database discovery initialization.
  */
 static void db_discovery_init(void)
@@ -633,6 +664,7 @@ int main(void)
 
     db_discovery_init();
     lbs_c_init();
+    conn_sched_init();
 
     // Start scanning for peripherals and initiate connection to devices which
     // advertise.
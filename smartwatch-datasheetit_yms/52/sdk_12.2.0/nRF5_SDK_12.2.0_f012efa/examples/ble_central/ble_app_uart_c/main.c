@@ -59,6 +59,13 @@
 static ble_nus_c_t              m_ble_nus_c;                    /**< Instance of NUS service. Must be passed to all NUS_C API calls. */
 static ble_db_discovery_t       m_ble_db_discovery;             /**< Instance of database discovery module. Must be passed to all db_discovert API calls */
 
+#if NRF_MODULE_ENABLED(BLE_NUS_C_RX_FIFO)
+#define NUS_RX_FIFO_SIZE        1024                            /**< Size of the FIFO of the data received from the peer. Must be a power of two. */
+
+static app_fifo_t               m_nus_rx_fifo;                  /**< FIFO of the data received from the peer, drained in the main loop. */
+static uint8_t                  m_nus_rx_buf[NUS_RX_FIFO_SIZE]; /**< Buffer of the RX FIFO. */
+#endif
+
 /**
  * @brief Connection parameters requested for connection.
  */
@@ -216,6 +223,14 @@ static void ble_nus_c_evt_handler(ble_nus_c_t * p_ble_nus_c, const ble_nus_c_evt
             }
             break;
 
+        case BLE_NUS_C_EVT_RX_FIFO_DATA:
+            // The data are sent to the UART from the main loop.
+            break;
+
+        case BLE_NUS_C_EVT_RX_FIFO_OVERFLOW:
+            printf("%d bytes lost\r\n", p_ble_nus_evt->data_len);
+            break;
+
         case BLE_NUS_C_EVT_DISCONNECTED:
             printf("Disconnected\r\n");
             scan_start();
@@ -541,6 +556,11 @@ static void nus_c_init(void)
     ble_nus_c_init_t nus_c_init_t;
 
     nus_c_init_t.evt_handler = ble_nus_c_evt_handler;
+#if NRF_MODULE_ENABLED(BLE_NUS_C_RX_FIFO)
+    err_code = app_fifo_init(&m_nus_rx_fifo, m_nus_rx_buf, sizeof(m_nus_rx_buf));
+    APP_ERROR_CHECK(err_code);
+    nus_c_init_t.p_rx_fifo   = &m_nus_rx_fifo;
+#endif
 
     err_code = ble_nus_c_init(&m_ble_nus_c, &nus_c_init_t);
     APP_ERROR_CHECK(err_code);
@@ -570,6 +590,25 @@ static void db_discovery_init(void)
     APP_ERROR_CHECK(err_code);
 }
 
+#if NRF_MODULE_ENABLED(BLE_NUS_C_RX_FIFO)
+/** @brief Function for sending the data received from the peer to the UART, one block at a time.
+ */
+static void nus_rx_drain(void)
+{
+    uint8_t * p_data;
+    uint32_t  size;
+
+    while (ble_nus_c_rx_span_get(&m_ble_nus_c, &p_data, &size) == NRF_SUCCESS)
+    {
+        for (uint32_t i = 0; i < size; i++)
+        {
+            while (app_uart_put(p_data[i]) != NRF_SUCCESS);
+        }
+        (void)ble_nus_c_rx_span_release(&m_ble_nus_c, size);
+    }
+}
+#endif
+
 /** @brief Function for the Power manager.
  */
 static void power_manage(void)
@@ -597,6 +636,9 @@ int main(void)
 
     for (;;)
     {
+#if NRF_MODULE_ENABLED(BLE_NUS_C_RX_FIFO)
+        nus_rx_drain();
+#endif
         power_manage();
     }
 }
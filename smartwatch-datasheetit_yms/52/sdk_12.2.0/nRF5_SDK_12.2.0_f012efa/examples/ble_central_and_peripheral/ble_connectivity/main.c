@@ -27,6 +27,11 @@
 #include "softdevice_handler.h"
 #include "ser_hal_transport.h"
 #include "ser_conn_handlers.h"
+#include "ser_conn_event_encoder.h"
+#include "ser_config.h"
+#if SER_EVT_BATCH_ENABLED && (SER_EVT_BATCH_MAX_DELAY_MS > 0)
+#include "app_timer.h"
+#endif
 #include "boards.h"
 
 #define NRF_LOG_MODULE_NAME "CONN"
@@ -52,6 +57,10 @@ int main(void)
 
     /* Initialize scheduler queue. */
     APP_SCHED_INIT(SER_CONN_SCHED_MAX_EVENT_DATA_SIZE, SER_CONN_SCHED_QUEUE_SIZE);
+#if SER_EVT_BATCH_ENABLED && (SER_EVT_BATCH_MAX_DELAY_MS > 0)
+    /* The timer limits the time events wait in a batch. */
+    APP_TIMER_INIT(0, 4, NULL);
+#endif
     /* Initialize SoftDevice.
      * SoftDevice Event IRQ is not scheduled but immediately copies BLE events to the application
      * scheduler queue */
@@ -72,6 +81,10 @@ int main(void)
     {
         /* Process SoftDevice events. */
         app_sched_execute();
+
+        /* Send the events batched by the scheduler run. */
+        ser_conn_event_batch_process();
+
         if (softdevice_handler_is_suspended())
         {
             // Resume pulling new events if queue utilization drops below 50%.
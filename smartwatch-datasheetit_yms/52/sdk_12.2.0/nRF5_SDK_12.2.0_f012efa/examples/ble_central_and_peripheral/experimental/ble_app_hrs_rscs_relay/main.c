@@ -990,6 +990,7 @@ static void hrs_c_init(void)
     ble_hrs_c_init_t hrs_c_init_obj;
 
     hrs_c_init_obj.evt_handler = hrs_c_evt_handler;
+    hrs_c_init_obj.p_gatt_queue = NULL;
 
     err_code = ble_hrs_c_init(&m_ble_hrs_c, &hrs_c_init_obj);
     APP_ERROR_CHECK(err_code);
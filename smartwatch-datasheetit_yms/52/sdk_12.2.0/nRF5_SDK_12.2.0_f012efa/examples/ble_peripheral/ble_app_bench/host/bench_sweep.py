@@ -0,0 +1,280 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+#
+# The information contained herein is property of Nordic Semiconductor ASA.
+# Terms and conditions of usage are described in detail in NORDIC
+# SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+#
+# Licensees are granted free, non-transferable use of the information. NO
+# WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+# the file.
+#
+
+"""Host side of the ble_app_bench example.
+
+Sweeps the link parameters of the benchmark application and prints one CSV line per
+configuration and test:
+
+    python3 bench_sweep.py --name BLE_Bench --bytes 65536 > results.csv
+
+Each configuration is sent with the "cfg" command, after which the device disconnects and
+advertises with the new parameters. The script then reconnects and runs:
+    - ping: round trip time of a command and its reply, in milliseconds.
+    - nus:  notifications of the Nordic UART Service.
+    - bts:  GET of an object of the Bulk Transfer Service, with receipts.
+
+The throughput and the link figures come from the result line of the device. The host also
+reports the throughput it measured itself. Requires Python 3.7 and the bleak package.
+"""
+
+import argparse
+import asyncio
+import statistics
+import struct
+import sys
+import time
+import zlib
+
+from bleak import BleakClient, BleakScanner
+
+NUS_RX   = '6e400002-b5a3-f393-e0a9-e50e24dcca9e'
+NUS_TX   = '6e400003-b5a3-f393-e0a9-e50e24dcca9e'
+BTS_CP   = '1e6b0002-57c8-2da6-904b-1f84e25a713c'
+BTS_DATA = '1e6b0003-57c8-2da6-904b-1f84e25a713c'
+
+OP_GET, OP_RECEIPT, OP_RECEIPT_REQUEST, OP_ABORT, OP_RESPONSE = 2, 3, 4, 5, 0x80
+
+BENCH_OBJECT_ID = 0x0001
+
+# mtu, connection interval (1.25 ms units), data length, bandwidth, event extension
+DEFAULT_SWEEP = [
+    (23,  6,  27,  3, 1),
+    (23,  6,  27,  3, 0),
+    (247, 6,  27,  3, 1),
+    (247, 6,  251, 3, 1),
+    (247, 6,  251, 1, 0),
+    (247, 12, 251, 3, 1),
+    (247, 24, 251, 3, 1),
+    (247, 40, 251, 3, 1),
+    (158, 12, 162, 2, 1),
+]
+
+
+class Lines:
+    """Lines received on the NUS TX characteristic.
+
+    The data of a NUS test is counted, not stored. It comes before the result line, so the
+    first data_expected bytes are taken as data.
+    """
+
+    def __init__(self):
+        self.buf = b''
+        self.queue = asyncio.Queue()
+        self.data_expected = 0
+        self.data_bytes = 0
+        self.first_data = None
+        self.last_data = None
+
+    def expect(self, count):
+        self.data_expected = count
+        self.data_bytes = 0
+        self.first_data = None
+        self.last_data = None
+
+    def on_notify(self, _sender, data):
+        data = bytes(data)
+        take = min(len(data), self.data_expected - self.data_bytes)
+        if take > 0:
+            now = time.monotonic()
+            if self.first_data is None:
+                self.first_data = now
+            self.last_data = now
+            self.data_bytes += take
+            data = data[take:]
+        self.buf += data
+        while b'\n' in self.buf:
+            line, self.buf = self.buf.split(b'\n', 1)
+            self.queue.put_nowait(line.decode())
+
+    async def get(self, timeout=30.0):
+        return await asyncio.wait_for(self.queue.get(), timeout)
+
+
+class BtsReceiver:
+    """Receiver of a GET, the peer side of the Bulk Transfer Service."""
+
+    def __init__(self, client):
+        self.client = client
+        self.done = asyncio.Event()
+        self.rsp = asyncio.Event()
+        self.result = None
+        self.size = 0
+        self.pkt_size = 0
+        self.window = 0
+        self.pkts = {}
+        self.base = 0
+        self.crc = 0
+        self.since_receipt = 0
+        self.received = 0
+        self.duplicates = 0
+        self.first = None
+        self.last = None
+
+    def pkt_count(self):
+        return (self.size + self.pkt_size - 1) // self.pkt_size if self.pkt_size else 0
+
+    def receipt(self):
+        bitmap = 0
+        for i in range(1, 33):
+            if (self.base + i) in self.pkts:
+                bitmap |= 1 << (i - 1)
+        self.since_receipt = 0
+        return struct.pack('<BHII', OP_RECEIPT, self.base & 0xFFFF, bitmap, self.crc)
+
+    def send(self, msg):
+        asyncio.ensure_future(self.client.write_gatt_char(BTS_CP, msg, response=True))
+
+    def on_cp(self, _sender, data):
+        data = bytes(data)
+        if data[0] == OP_RESPONSE and data[1] == OP_GET:
+            _, _, self.result, _offset, self.size, self.pkt_size, self.window = \
+                struct.unpack('<BBBIIHB', data[:15])
+            self.rsp.set()
+            if self.result != 0 or self.size == 0:
+                self.done.set()
+        elif data[0] == OP_RECEIPT_REQUEST:
+            self.send(self.receipt())
+        elif data[0] == OP_ABORT:
+            self.result = data[2]
+            self.rsp.set()
+            self.done.set()
+
+    def on_data(self, _sender, data):
+        now = time.monotonic()
+        data = bytes(data)
+        seq = struct.unpack('<H', data[:2])[0]
+        if self.first is None:
+            self.first = now
+        self.last = now
+        if seq < self.base or seq in self.pkts:
+            self.duplicates += 1
+            return
+        self.pkts[seq] = data[2:]
+        gap = seq != self.base
+        while self.base in self.pkts:
+            chunk = self.pkts.pop(self.base)
+            self.crc = zlib.crc32(chunk, self.crc)
+            self.received += len(chunk)
+            self.base += 1
+        self.since_receipt += 1
+        complete = self.base == self.pkt_count()
+        if complete or gap or self.since_receipt >= max(1, self.window // 2):
+            self.send(self.receipt())
+        if complete:
+            self.done.set()
+
+
+async def find(name):
+    device = await BleakScanner.find_device_by_filter(
+        lambda d, ad: (d.name == name) or (ad.local_name == name), timeout=20.0)
+    if device is None:
+        raise RuntimeError('%s not found' % name)
+    return device
+
+
+def parse_res(line):
+    fields = {}
+    for item in line.split()[2:]:
+        key, value = item.split('=')
+        fields[key] = value
+    return fields
+
+
+async def run_config(args, cfg, writer):
+    # The parameters apply from the next connection.
+    async with BleakClient(await find(args.name)) as client:
+        lines = Lines()
+        await client.start_notify(NUS_TX, lines.on_notify)
+        await client.write_gatt_char(NUS_RX, ('cfg %d %d %d %d %d' % cfg).encode(), response=True)
+        if await lines.get() != 'ok':
+            raise RuntimeError('configuration %s rejected' % (cfg,))
+        t_end = time.monotonic() + 5.0
+        while client.is_connected and time.monotonic() < t_end:
+            await asyncio.sleep(0.1)
+
+    await asyncio.sleep(0.5)
+    async with BleakClient(await find(args.name)) as client:
+        lines = Lines()
+        await client.start_notify(NUS_TX, lines.on_notify)
+        # Let the MTU exchange, data length update and connection parameter update finish.
+        await asyncio.sleep(2.0)
+
+        rtts = []
+        for i in range(args.pings):
+            t0 = time.monotonic()
+            await client.write_gatt_char(NUS_RX, ('ping %d' % i).encode(), response=False)
+            await lines.get()
+            rtts.append((time.monotonic() - t0) * 1000.0)
+        writer(cfg, 'ping', {'rtt_med_ms': '%.1f' % statistics.median(rtts),
+                             'rtt_max_ms': '%.1f' % max(rtts)})
+
+        lines.expect(args.bytes)
+        t0 = time.monotonic()
+        await client.write_gatt_char(NUS_RX, ('nus %d' % args.bytes).encode(), response=True)
+        res = parse_res(await lines.get(timeout=120.0))
+        host_s = (lines.last_data or time.monotonic()) - (lines.first_data or t0)
+        res['host_kbps'] = '%d' % (lines.data_bytes * 8 / 1000.0 / host_s) if host_s > 0 else '0'
+        res['host_bytes'] = str(lines.data_bytes)
+        writer(cfg, 'nus', res)
+
+        await client.write_gatt_char(NUS_RX, ('bts %d' % args.bytes).encode(), response=True)
+        await lines.get()
+        rx = BtsReceiver(client)
+        await client.start_notify(BTS_CP, rx.on_cp)
+        await client.start_notify(BTS_DATA, rx.on_data)
+        await client.write_gatt_char(
+            BTS_CP, struct.pack('<BHIIB', OP_GET, BENCH_OBJECT_ID, 0, 0, args.window), response=True)
+        await asyncio.wait_for(rx.done.wait(), 120.0)
+        if rx.result != 0:
+            writer(cfg, 'bts', {'result': str(rx.result)})
+        else:
+            res = parse_res(await lines.get(timeout=30.0))
+            host_s = (rx.last or 0) - (rx.first or 0)
+            res['host_kbps'] = '%d' % (rx.received * 8 / 1000.0 / host_s) if host_s > 0 else '0'
+            res['host_bytes'] = str(rx.received)
+            res['duplicates'] = str(rx.duplicates)
+            writer(cfg, 'bts', res)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--name', default='BLE_Bench', help='advertised name of the device')
+    parser.add_argument('--bytes', type=int, default=65536, help='bytes per throughput test')
+    parser.add_argument('--pings', type=int, default=20, help='pings per configuration')
+    parser.add_argument('--window', type=int, default=16, help='window of the GET, in packets')
+    parser.add_argument('--cfg', action='append', default=[],
+                        help='configuration "mtu,ci,dl,bw,ext", can be repeated; default is a sweep')
+    args = parser.parse_args()
+
+    sweep = [tuple(int(v) for v in c.split(',')) for c in args.cfg] or DEFAULT_SWEEP
+    columns = ['mtu_req', 'ci_req', 'dl_req', 'bw', 'ext', 'test',
+               'bytes', 'ms', 'kbps', 'host_kbps', 'pkts', 'evts', 'ppe', 'cpu',
+               'mtu', 'dl', 'ci', 'rtt_med_ms', 'rtt_max_ms', 'duplicates', 'result']
+    print(','.join(columns))
+
+    def writer(cfg, test, fields):
+        row = [str(v) for v in cfg] + [test] + [fields.get(c, '') for c in columns[6:]]
+        print(','.join(row))
+        sys.stdout.flush()
+
+    loop = asyncio.get_event_loop()
+    for cfg in sweep:
+        try:
+            loop.run_until_complete(run_config(args, cfg, writer))
+        except Exception as err:  # Keep sweeping, the link may fail at some settings.
+            print('# %s: %s' % (cfg, err), file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
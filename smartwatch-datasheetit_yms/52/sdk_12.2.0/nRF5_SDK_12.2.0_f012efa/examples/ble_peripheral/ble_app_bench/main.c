@@ -0,0 +1,829 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ble_sdk_app_bench_main main.c
+ * @{
+ * @ingroup  ble_sdk_app_bench
+ * @brief    BLE throughput and latency benchmark application main file.
+ *
+ * This application measures the GATT throughput, the notification latency and the use of the
+ * connection events, driven by the host script in the host folder. The host writes text
+ * commands to the RX characteristic of the Nordic UART Service, and the application replies
+ * with lines on the stream of the service (@ref ble_nus_stream):
+ *
+ * - "cfg <mtu> <ci> <dl> <bw> <ext>": ATT_MTU, connection interval in 1.25 ms units, link
+ *   layer payload size, connection bandwidth (1 to 3, sets the event length) and connection
+ *   event extension (0 or 1). The application replies "ok" and disconnects, and the parameters
+ *   apply from the next connection.
+ * - "nus <bytes>": sends the given number of bytes as notifications of the stream, then a
+ *   result line.
+ * - "bts <bytes>": sets the size of object 1 of the Bulk Transfer Service. The host reads it
+ *   with a GET, then the application sends a result line.
+ * - "ping <token>": replies "pong <token>" at once, for the round trip latency.
+ *
+ * A result line has the form
+ * "res <test> bytes=<n> ms=<n> kbps=<n> pkts=<n> evts=<n> ppe=<n.nn> cpu=<n> mtu=<n> dl=<n> ci=<n>".
+ * The packets are counted from @ref BLE_EVT_TX_COMPLETE, the connection events from the radio
+ * notification, and the CPU load from the DWT cycle counter, which stops while the CPU sleeps.
+ *
+ * @note Attaching a debugger keeps the CPU clock running, so the CPU load reads 100%.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "nordic_common.h"
+#include "nrf.h"
+#include "ble_hci.h"
+#include "ble_advdata.h"
+#include "ble_advertising.h"
+#include "softdevice_handler.h"
+#include "nrf_ble_gatt.h"
+#include "app_timer.h"
+#include "app_util_platform.h"
+#include "ble_nus.h"
+#include "ble_nus_stream.h"
+#include "ble_bts.h"
+#include "bsp.h"
+#include "bsp_btn_ble.h"
+#define NRF_LOG_MODULE_NAME "APP"
+#include "nrf_log.h"
+#include "nrf_log_ctrl.h"
+
+#define IS_SRVC_CHANGED_CHARACT_PRESENT 0                                           /**< Include the service_changed characteristic. If not enabled, the server's database cannot be changed for the lifetime of the device. */
+
+#define CENTRAL_LINK_COUNT              0                                           /**< Number of central links used by the application. When changing this number remember to adjust the RAM settings*/
+#define PERIPHERAL_LINK_COUNT           1                                           /**< Number of peripheral links used by the application. When changing this number remember to adjust the RAM settings*/
+
+#define DEVICE_NAME                     "BLE_Bench"                                 /**< Name of device. Will be included in the advertising data. */
+#define NUS_SERVICE_UUID_TYPE           BLE_UUID_TYPE_VENDOR_BEGIN                  /**< UUID type for the Nordic UART Service (vendor specific). */
+
+#define APP_ADV_INTERVAL                64                                          /**< The advertising interval (in units of 0.625 ms. This value corresponds to 40 ms). */
+#define APP_ADV_TIMEOUT_IN_SECONDS      0                                           /**< No advertising timeout, the host reconnects after each configuration. */
+
+#define APP_TIMER_PRESCALER             0                                           /**< Value of the RTC1 PRESCALER register. */
+#define APP_TIMER_OP_QUEUE_SIZE         4                                           /**< Size of timer operation queues. */
+#define APP_TIMER_FREQ                  32768                                       /**< Frequency of the app_timer ticks with the prescaler above. */
+
+#define CONN_INTERVAL_DEFAULT           MSEC_TO_UNITS(7.5, UNIT_1_25_MS)            /**< Connection interval requested until the host configures another one. */
+#define CONN_SUP_TIMEOUT                MSEC_TO_UNITS(4000, UNIT_10_MS)             /**< Connection supervisory timeout (4 seconds), Supervision Timeout uses 10 ms units. */
+
+#define LL_HEADER_LEN                   4                                           /**< Length of the L2CAP header in a link layer payload. */
+#define LL_PAYLOAD_MAX                  251                                         /**< Largest link layer payload. */
+
+#define DISCONNECT_DELAY                APP_TIMER_TICKS(200, APP_TIMER_PRESCALER)   /**< Time for the reply to a configuration to reach the host before the link is closed. */
+
+#define NUS_STREAM_BUF_SIZE             2048                                        /**< Size of the FIFO of the stream. Must be a power of two. */
+#define BENCH_CHUNK_LEN                 64                                          /**< Bytes written to the stream at a time. */
+#define BENCH_OBJECT_ID                 0x0001                                      /**< Object of the Bulk Transfer Service read by the host. */
+#define REPLY_MAX_LEN                   160                                         /**< Longest reply line. */
+
+#define DEAD_BEEF                       0xDEADBEEF                                  /**< Value used as error code on stack dump, can be used to identify stack location on stack unwind. */
+
+/**@brief Link parameters set by the host. */
+typedef struct
+{
+    uint16_t att_mtu;        /**< ATT_MTU, in bytes. */
+    uint16_t conn_interval;  /**< Connection interval, in 1.25 ms units. */
+    uint8_t  data_len;       /**< Link layer payload size, in bytes. */
+    uint8_t  conn_bw;        /**< Connection bandwidth, see @ref BLE_CONN_BWS. */
+    bool     conn_evt_ext;   /**< Connection event extension. */
+} bench_cfg_t;
+
+/**@brief Measurement of a test. */
+typedef struct
+{
+    bool     running;        /**< A test is in progress. */
+    uint32_t start_ticks;    /**< app_timer counter at the start. */
+    uint32_t start_cycles;   /**< DWT cycle counter at the start. */
+    uint32_t packets;        /**< Packets completed, from BLE_EVT_TX_COMPLETE. */
+    uint32_t radio_events;   /**< Radio events, from the radio notification. */
+} bench_meas_t;
+
+static ble_nus_t                        m_nus;                                      /**< Structure to identify the Nordic UART Service. */
+static ble_nus_stream_t                 m_stream;                                   /**< Stream of the Nordic UART Service. */
+static ble_bts_t                        m_bts;                                      /**< Structure to identify the Bulk Transfer Service. */
+static nrf_ble_gatt_t                   m_gatt;                                     /**< GATT module instance. */
+static uint16_t                         m_conn_handle = BLE_CONN_HANDLE_INVALID;    /**< Handle of the current connection. */
+static uint8_t                          m_stream_buf[NUS_STREAM_BUF_SIZE];          /**< Memory of the FIFO of the stream. */
+
+static bench_cfg_t m_cfg =
+{
+    .att_mtu       = NRF_BLE_GATT_MAX_MTU_SIZE,
+    .conn_interval = CONN_INTERVAL_DEFAULT,
+    .data_len      = MIN(NRF_BLE_GATT_MAX_MTU_SIZE + LL_HEADER_LEN, LL_PAYLOAD_MAX),
+    .conn_bw       = BLE_CONN_BW_HIGH,
+    .conn_evt_ext  = true,
+};
+
+static bench_meas_t volatile            m_meas;                                     /**< Measurement of the current test. */
+static uint32_t                         m_nus_remaining;                            /**< Bytes of the NUS test still to be written to the stream. */
+static uint32_t                         m_nus_total;                                /**< Bytes of the NUS test. */
+static uint32_t                         m_bts_size = 65536;                         /**< Size of the object of the Bulk Transfer Service. */
+static uint16_t                         m_data_len = 27;                            /**< Link layer payload size of the current connection. */
+
+APP_TIMER_DEF(m_disconnect_timer_id);                                               /**< Timer for closing the link after a configuration. */
+
+static ble_uuid_t                       m_adv_uuids[] = {{BLE_UUID_NUS_SERVICE, NUS_SERVICE_UUID_TYPE}};  /**< Universally unique service identifier. */
+
+
+/**@brief Function for assert macro callback.
+ *
+ * @details This function will be called in case of an assert in the SoftDevice.
+ *
+ * @warning This handler is an example only and does not fit a final product. You need to analyse
+ *          how your product is supposed to react in case of Assert.
+ * @warning On assert from the SoftDevice, the system can only recover on reset.
+ *
+ * @param[in] line_num    Line number of the failing ASSERT call.
+ * @param[in] p_file_name File name of the failing ASSERT call.
+ */
+void assert_nrf_callback(uint16_t line_num, const uint8_t * p_file_name)
+{
+    app_error_handler(DEAD_BEEF, line_num, p_file_name);
+}
+
+
+/**@brief Function for counting the radio events of a test.
+ *
+ * @details The active notification comes once before each radio event. While connected and not
+ *          advertising, each one is a connection event.
+ */
+void RADIO_NOTIFICATION_IRQHandler(void)
+{
+    if (m_meas.running)
+    {
+        m_meas.radio_events++;
+    }
+}
+
+
+/**@brief Function for sending a reply line to the host on the stream. */
+static void reply_send(char const * p_line)
+{
+    uint32_t len = strlen(p_line);
+
+    // A short line always fits in the FIFO between tests.
+    (void)ble_nus_stream_write(&m_stream, (uint8_t const *)p_line, &len);
+}
+
+
+/**@brief Function for starting a measurement. */
+static void bench_start(void)
+{
+    m_meas.packets      = 0;
+    m_meas.radio_events = 0;
+    m_meas.start_ticks  = app_timer_cnt_get();
+    m_meas.start_cycles = DWT->CYCCNT;
+    m_meas.running      = true;
+}
+
+
+/**@brief Function for ending a measurement and sending the result line.
+ *
+ * @param[in] p_test Name of the test.
+ * @param[in] bytes  Bytes of payload transferred.
+ */
+static void bench_stop(char const * p_test, uint32_t bytes)
+{
+    char     line[REPLY_MAX_LEN];
+    uint32_t cycles = DWT->CYCCNT - m_meas.start_cycles;
+    uint32_t ticks;
+    uint32_t ms;
+    uint32_t kbps;
+    uint32_t ppe_x100;
+    uint32_t cpu;
+
+    m_meas.running = false;
+    (void)app_timer_cnt_diff_compute(app_timer_cnt_get(), m_meas.start_ticks, &ticks);
+    ticks = MAX(ticks, 1);
+
+    ms       = (uint32_t)(((uint64_t)ticks * 1000) / APP_TIMER_FREQ);
+    kbps     = (uint32_t)(((uint64_t)bytes * 8 * APP_TIMER_FREQ) / ((uint64_t)ticks * 1000));
+    ppe_x100 = (m_meas.radio_events == 0) ? 0 : ((m_meas.packets * 100) / m_meas.radio_events);
+    cpu      = (uint32_t)(((uint64_t)cycles * 100 * APP_TIMER_FREQ) / ((uint64_t)ticks * SystemCoreClock));
+
+    (void)snprintf(line, sizeof(line),
+                   "res %s bytes=%lu ms=%lu kbps=%lu pkts=%lu evts=%lu ppe=%lu.%02lu cpu=%lu mtu=%u dl=%u ci=%u\n",
+                   p_test,
+                   (unsigned long)bytes,
+                   (unsigned long)ms,
+                   (unsigned long)kbps,
+                   (unsigned long)m_meas.packets,
+                   (unsigned long)m_meas.radio_events,
+                   (unsigned long)(ppe_x100 / 100),
+                   (unsigned long)(ppe_x100 % 100),
+                   (unsigned long)cpu,
+                   nrf_ble_gatt_eff_mtu_get(&m_gatt, m_conn_handle),
+                   m_data_len,
+                   m_cfg.conn_interval);
+
+    NRF_LOG_INFO("%s", (uint32_t)line);
+    reply_send(line);
+}
+
+
+/**@brief Function for writing the data of the NUS test until the FIFO of the stream is full. */
+static void nus_test_fill(void)
+{
+    uint8_t chunk[BENCH_CHUNK_LEN];
+
+    while (m_nus_remaining > 0)
+    {
+        uint32_t offset    = m_nus_total - m_nus_remaining;
+        uint32_t chunk_len = MIN(m_nus_remaining, sizeof(chunk));
+        uint32_t len       = chunk_len;
+
+        // Letters only, so that the data cannot be taken for the end of a reply line.
+        for (uint32_t i = 0; i < len; i++)
+        {
+            chunk[i] = 'a' + ((offset + i) % 26);
+        }
+
+        if ((ble_nus_stream_write(&m_stream, chunk, &len) != NRF_SUCCESS) || (len == 0))
+        {
+            break;
+        }
+        m_nus_remaining -= len;
+
+        if (len < chunk_len)
+        {
+            // The FIFO is full, continued on BLE_NUS_STREAM_EVT_TX_RDY.
+            break;
+        }
+    }
+}
+
+
+/**@brief Function for handling a command from the host.
+ *
+ * @param[in] p_cmd Command, terminated.
+ */
+static void command_handle(char * p_cmd)
+{
+    char     line[REPLY_MAX_LEN];
+    char   * p_arg = strchr(p_cmd, ' ');
+    uint32_t arg   = (p_arg != NULL) ? strtoul(p_arg + 1, NULL, 0) : 0;
+
+    if (strncmp(p_cmd, "ping", 4) == 0)
+    {
+        (void)snprintf(line, sizeof(line), "pong%s\n", (p_arg != NULL) ? p_arg : "");
+        reply_send(line);
+    }
+    else if (strncmp(p_cmd, "nus", 3) == 0)
+    {
+        m_nus_total     = arg;
+        m_nus_remaining = arg;
+        bench_start();
+        nus_test_fill();
+    }
+    else if (strncmp(p_cmd, "bts", 3) == 0)
+    {
+        m_bts_size = arg;
+        reply_send("ok\n");
+    }
+    else if (strncmp(p_cmd, "cfg", 3) == 0)
+    {
+        unsigned int mtu, ci, dl, bw, ext;
+
+        if ((sscanf(p_cmd, "cfg %u %u %u %u %u", &mtu, &ci, &dl, &bw, &ext) != 5)  ||
+            (mtu < GATT_MTU_SIZE_DEFAULT) || (mtu > NRF_BLE_GATT_MAX_MTU_SIZE)      ||
+            (ci < BLE_GAP_CP_MIN_CONN_INTVL_MIN) || (ci > BLE_GAP_CP_MAX_CONN_INTVL_MAX) ||
+            (dl < 27) || (dl > LL_PAYLOAD_MAX)                                       ||
+            (bw < BLE_CONN_BW_LOW) || (bw > BLE_CONN_BW_HIGH))
+        {
+            reply_send("err\n");
+            return;
+        }
+
+        m_cfg.att_mtu       = (uint16_t)mtu;
+        m_cfg.conn_interval = (uint16_t)ci;
+        m_cfg.data_len      = (uint8_t)dl;
+        m_cfg.conn_bw       = (uint8_t)bw;
+        m_cfg.conn_evt_ext  = (ext != 0);
+
+        reply_send("ok\n");
+        APP_ERROR_CHECK(app_timer_start(m_disconnect_timer_id, DISCONNECT_DELAY, NULL));
+    }
+    else
+    {
+        reply_send("err\n");
+    }
+}
+
+
+/**@brief Function for handling the data from the Nordic UART Service.
+ *
+ * @param[in] p_nus    Nordic UART Service structure.
+ * @param[in] p_data   Command from the host.
+ * @param[in] length   Length of the command.
+ */
+static void nus_data_handler(ble_nus_t * p_nus, uint8_t * p_data, uint16_t length)
+{
+    char cmd[BLE_NUS_MAX_DATA_LEN + 1];
+
+    length = MIN(length, BLE_NUS_MAX_DATA_LEN);
+    memcpy(cmd, p_data, length);
+    cmd[length] = '\0';
+
+    command_handle(cmd);
+}
+
+
+/**@brief Function for handling the events of the stream. */
+static void stream_evt_handler(ble_nus_stream_t * p_stream, ble_nus_stream_evt_t const * p_evt)
+{
+    switch (p_evt->type)
+    {
+        case BLE_NUS_STREAM_EVT_TX_RDY:
+            nus_test_fill();
+            break;
+
+        case BLE_NUS_STREAM_EVT_TX_DONE:
+            if (m_meas.running && (m_nus_total != 0) && (m_nus_remaining == 0))
+            {
+                bench_stop("nus", m_nus_total);
+                m_nus_total = 0;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+/**@brief Function for reading the object of the Bulk Transfer Service.
+ *
+ * @details The object is generated from its offset, so no memory is needed for it.
+ */
+static ret_code_t bts_data_read(ble_bts_t * p_bts,
+                                uint16_t    object_id,
+                                uint32_t    offset,
+                                uint8_t   * p_buf,
+                                uint16_t    len)
+{
+    for (uint16_t i = 0; i < len; i++)
+    {
+        p_buf[i] = (uint8_t)(offset + i);
+    }
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for handling the events of the Bulk Transfer Service. */
+static void bts_evt_handler(ble_bts_t * p_bts, ble_bts_evt_t const * p_evt)
+{
+    switch (p_evt->evt_type)
+    {
+        case BLE_BTS_EVT_TX_REQUEST:
+            if ((p_evt->object_id != BENCH_OBJECT_ID) || (p_evt->offset != 0))
+            {
+                (void)ble_bts_abort(p_bts, BLE_BTS_OP_GET);
+                break;
+            }
+            bench_start();
+            (void)ble_bts_send_start(p_bts, m_bts_size);
+            break;
+
+        case BLE_BTS_EVT_TX_DONE:
+            if (m_meas.running)
+            {
+                if (p_evt->result == BLE_BTS_RESULT_SUCCESS)
+                {
+                    bench_stop("bts", p_evt->size);
+                }
+                else
+                {
+                    m_meas.running = false;
+                    reply_send("err\n");
+                }
+            }
+            NRF_LOG_INFO("GET done, result %u, %u resent.\r\n", p_evt->result, p_bts->stats.tx_resent);
+            break;
+
+        default:
+            // PUT is not used.
+            break;
+    }
+}
+
+
+/**@brief Function for closing the link after a configuration. */
+static void disconnect_timeout_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    if (m_conn_handle != BLE_CONN_HANDLE_INVALID)
+    {
+        uint32_t err_code = sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+        if (err_code != NRF_ERROR_INVALID_STATE)
+        {
+            APP_ERROR_CHECK(err_code);
+        }
+    }
+}
+
+
+/**@brief Function for the timer and cycle counter initialization. */
+static void timers_init(void)
+{
+    uint32_t err_code;
+
+    APP_TIMER_INIT(APP_TIMER_PRESCALER, APP_TIMER_OP_QUEUE_SIZE, false);
+
+    err_code = app_timer_create(&m_disconnect_timer_id,
+                                APP_TIMER_MODE_SINGLE_SHOT,
+                                disconnect_timeout_handler);
+    APP_ERROR_CHECK(err_code);
+
+    // The cycle counter only runs while the CPU is awake.
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT       = 0;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+
+/**@brief Function for the GAP initialization.
+ *
+ * @details This function will set up all the necessary GAP (Generic Access Profile) parameters of
+ *          the device. It also sets the permissions and appearance.
+ */
+static void gap_params_init(void)
+{
+    uint32_t                err_code;
+    ble_gap_conn_sec_mode_t sec_mode;
+
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&sec_mode);
+
+    err_code = sd_ble_gap_device_name_set(&sec_mode,
+                                          (const uint8_t *) DEVICE_NAME,
+                                          strlen(DEVICE_NAME));
+    APP_ERROR_CHECK(err_code);
+}
+
+
+/**@brief Function for applying the link parameters of the next connection.
+ *
+ * @details The ATT_MTU, data length and bandwidth options take effect when a connection is
+ *          established, so they are set before advertising.
+ */
+static void link_params_apply(void)
+{
+    uint32_t  err_code;
+    ble_opt_t opt;
+
+    err_code = nrf_ble_gatt_att_mtu_periph_set(&m_gatt, m_cfg.att_mtu);
+    APP_ERROR_CHECK(err_code);
+
+    memset(&opt, 0x00, sizeof(opt));
+    opt.gap_opt.ext_len.rxtx_max_pdu_payload_size = m_cfg.data_len;
+    err_code = sd_ble_opt_set(BLE_GAP_OPT_EXT_LEN, &opt);
+    APP_ERROR_CHECK(err_code);
+
+    memset(&opt, 0x00, sizeof(opt));
+    opt.common_opt.conn_evt_ext.enable = m_cfg.conn_evt_ext ? 1 : 0;
+    err_code = sd_ble_opt_set(BLE_COMMON_OPT_CONN_EVT_EXT, &opt);
+    APP_ERROR_CHECK(err_code);
+
+    memset(&opt, 0x00, sizeof(opt));
+    opt.common_opt.conn_bw.role               = BLE_GAP_ROLE_PERIPH;
+    opt.common_opt.conn_bw.conn_bw.conn_bw_tx = m_cfg.conn_bw;
+    opt.common_opt.conn_bw.conn_bw.conn_bw_rx = m_cfg.conn_bw;
+    err_code = sd_ble_opt_set(BLE_COMMON_OPT_CONN_BW, &opt);
+    APP_ERROR_CHECK(err_code);
+}
+
+
+/**@brief Function for initializing services that will be used by the application.
+ */
+static void services_init(void)
+{
+    uint32_t              err_code;
+    ble_nus_init_t        nus_init;
+    ble_nus_stream_init_t stream_init;
+    ble_bts_init_t        bts_init;
+
+    memset(&nus_init, 0, sizeof(nus_init));
+    nus_init.data_handler = nus_data_handler;
+
+    err_code = ble_nus_init(&m_nus, &nus_init);
+    APP_ERROR_CHECK(err_code);
+
+    memset(&stream_init, 0, sizeof(stream_init));
+    stream_init.p_nus           = &m_nus;
+    stream_init.p_gatt          = &m_gatt;
+    stream_init.p_buf           = m_stream_buf;
+    stream_init.buf_size        = sizeof(m_stream_buf);
+    stream_init.timer_prescaler = APP_TIMER_PRESCALER;
+    stream_init.evt_handler     = stream_evt_handler;
+
+    err_code = ble_nus_stream_init(&m_stream, &stream_init);
+    APP_ERROR_CHECK(err_code);
+
+    memset(&bts_init, 0, sizeof(bts_init));
+    bts_init.evt_handler = bts_evt_handler;
+    bts_init.data_read   = bts_data_read;
+    bts_init.p_gatt      = &m_gatt;
+
+    err_code = ble_bts_init(&m_bts, &bts_init);
+    APP_ERROR_CHECK(err_code);
+}
+
+
+/**@brief Function for enabling the radio notification, used to count the connection events.
+ */
+static void radio_notification_init(void)
+{
+    uint32_t err_code;
+
+    err_code = sd_nvic_ClearPendingIRQ(RADIO_NOTIFICATION_IRQn);
+    APP_ERROR_CHECK(err_code);
+
+    err_code = sd_nvic_SetPriority(RADIO_NOTIFICATION_IRQn, APP_IRQ_PRIORITY_LOW);
+    APP_ERROR_CHECK(err_code);
+
+    err_code = sd_nvic_EnableIRQ(RADIO_NOTIFICATION_IRQn);
+    APP_ERROR_CHECK(err_code);
+
+    err_code = sd_radio_notification_cfg_set(NRF_RADIO_NOTIFICATION_TYPE_INT_ON_ACTIVE,
+                                             NRF_RADIO_NOTIFICATION_DISTANCE_800US);
+    APP_ERROR_CHECK(err_code);
+}
+
+
+/**@brief Function for handling advertising events.
+ *
+ * @param[in] ble_adv_evt  Advertising event.
+ */
+static void on_adv_evt(ble_adv_evt_t ble_adv_evt)
+{
+    uint32_t err_code;
+
+    switch (ble_adv_evt)
+    {
+        case BLE_ADV_EVT_FAST:
+            err_code = bsp_indication_set(BSP_INDICATE_ADVERTISING);
+            APP_ERROR_CHECK(err_code);
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+/**@brief Function for the application's SoftDevice event handler.
+ *
+ * @param[in] p_ble_evt SoftDevice event.
+ */
+static void on_ble_evt(ble_evt_t * p_ble_evt)
+{
+    uint32_t err_code;
+
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GAP_EVT_CONNECTED:
+        {
+            ble_gap_conn_params_t conn_params;
+
+            err_code = bsp_indication_set(BSP_INDICATE_CONNECTED);
+            APP_ERROR_CHECK(err_code);
+            m_conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+            m_data_len    = 27;
+
+            conn_params.min_conn_interval = m_cfg.conn_interval;
+            conn_params.max_conn_interval = m_cfg.conn_interval;
+            conn_params.slave_latency     = 0;
+            conn_params.conn_sup_timeout  = CONN_SUP_TIMEOUT;
+
+            err_code = sd_ble_gap_conn_param_update(m_conn_handle, &conn_params);
+            if (err_code != NRF_SUCCESS)
+            {
+                NRF_LOG_WARNING("Connection interval not requested: 0x%x.\r\n", err_code);
+            }
+        } break; // BLE_GAP_EVT_CONNECTED
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            err_code = bsp_indication_set(BSP_INDICATE_IDLE);
+            APP_ERROR_CHECK(err_code);
+            m_conn_handle   = BLE_CONN_HANDLE_INVALID;
+            m_meas.running  = false;
+            m_nus_remaining = 0;
+            m_nus_total     = 0;
+
+            // Applied before the advertising module restarts advertising.
+            link_params_apply();
+            break; // BLE_GAP_EVT_DISCONNECTED
+
+        case BLE_GAP_EVT_CONN_PARAM_UPDATE:
+            NRF_LOG_INFO("Connection interval %u.\r\n",
+                         p_ble_evt->evt.gap_evt.params.conn_param_update.conn_params.max_conn_interval);
+            break; // BLE_GAP_EVT_CONN_PARAM_UPDATE
+
+        case BLE_EVT_DATA_LENGTH_CHANGED:
+            m_data_len = p_ble_evt->evt.common_evt.params.data_length_changed.max_tx_octets;
+            NRF_LOG_INFO("Data length %u.\r\n", m_data_len);
+            break; // BLE_EVT_DATA_LENGTH_CHANGED
+
+        case BLE_EVT_TX_COMPLETE:
+            if (m_meas.running)
+            {
+                m_meas.packets += p_ble_evt->evt.common_evt.params.tx_complete.count;
+            }
+            break; // BLE_EVT_TX_COMPLETE
+
+        case BLE_GAP_EVT_SEC_PARAMS_REQUEST:
+            // Pairing not supported
+            err_code = sd_ble_gap_sec_params_reply(m_conn_handle, BLE_GAP_SEC_STATUS_PAIRING_NOT_SUPP, NULL, NULL);
+            APP_ERROR_CHECK(err_code);
+            break; // BLE_GAP_EVT_SEC_PARAMS_REQUEST
+
+        case BLE_GATTS_EVT_SYS_ATTR_MISSING:
+            // No system attributes have been stored.
+            err_code = sd_ble_gatts_sys_attr_set(m_conn_handle, NULL, 0, 0);
+            APP_ERROR_CHECK(err_code);
+            break; // BLE_GATTS_EVT_SYS_ATTR_MISSING
+
+        case BLE_GATTC_EVT_TIMEOUT:
+            // Disconnect on GATT Client timeout event.
+            err_code = sd_ble_gap_disconnect(p_ble_evt->evt.gattc_evt.conn_handle,
+                                             BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+            APP_ERROR_CHECK(err_code);
+            break; // BLE_GATTC_EVT_TIMEOUT
+
+        case BLE_GATTS_EVT_TIMEOUT:
+            // Disconnect on GATT Server timeout event.
+            err_code = sd_ble_gap_disconnect(p_ble_evt->evt.gatts_evt.conn_handle,
+                                             BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+            APP_ERROR_CHECK(err_code);
+            break; // BLE_GATTS_EVT_TIMEOUT
+
+        case BLE_EVT_USER_MEM_REQUEST:
+            err_code = sd_ble_user_mem_reply(p_ble_evt->evt.gattc_evt.conn_handle, NULL);
+            APP_ERROR_CHECK(err_code);
+            break; // BLE_EVT_USER_MEM_REQUEST
+
+        default:
+            // No implementation needed.
+            break;
+    }
+}
+
+
+/**@brief Function for dispatching a SoftDevice event to all modules with a SoftDevice
+ *        event handler.
+ *
+ * @param[in] p_ble_evt  SoftDevice event.
+ */
+static void ble_evt_dispatch(ble_evt_t * p_ble_evt)
+{
+    nrf_ble_gatt_on_ble_evt(&m_gatt, p_ble_evt);
+    ble_nus_on_ble_evt(&m_nus, p_ble_evt);
+    ble_nus_stream_on_ble_evt(&m_stream, p_ble_evt);
+    ble_bts_on_ble_evt(&m_bts, p_ble_evt);
+    on_ble_evt(p_ble_evt);
+    ble_advertising_on_ble_evt(p_ble_evt);
+    bsp_btn_ble_on_ble_evt(p_ble_evt);
+}
+
+
+/**@brief Function for the SoftDevice initialization.
+ *
+ * @details This function initializes the SoftDevice and the BLE event interrupt.
+ */
+static void ble_stack_init(void)
+{
+    uint32_t err_code;
+
+    nrf_clock_lf_cfg_t clock_lf_cfg = NRF_CLOCK_LFCLKSRC;
+
+    // Initialize SoftDevice.
+    SOFTDEVICE_HANDLER_INIT(&clock_lf_cfg, NULL);
+
+    ble_enable_params_t ble_enable_params;
+    err_code = softdevice_enable_get_default_config(CENTRAL_LINK_COUNT,
+                                                    PERIPHERAL_LINK_COUNT,
+                                                    &ble_enable_params);
+    APP_ERROR_CHECK(err_code);
+
+    //Check the ram settings against the used number of links
+    CHECK_RAM_START_ADDR(CENTRAL_LINK_COUNT,PERIPHERAL_LINK_COUNT);
+
+    // Enable BLE stack.
+    ble_enable_params.gatt_enable_params.att_mtu = NRF_BLE_GATT_MAX_MTU_SIZE;
+    err_code = softdevice_enable(&ble_enable_params);
+    APP_ERROR_CHECK(err_code);
+
+    // Subscribe for BLE events.
+    err_code = softdevice_ble_evt_handler_set(ble_evt_dispatch);
+    APP_ERROR_CHECK(err_code);
+}
+
+
+/**@brief Function for initializing the GATT module. */
+static void gatt_init(void)
+{
+    ret_code_t err_code = nrf_ble_gatt_init(&m_gatt, NULL);
+    APP_ERROR_CHECK(err_code);
+}
+
+
+/**@brief Function for initializing the Advertising functionality.
+ */
+static void advertising_init(void)
+{
+    uint32_t               err_code;
+    ble_advdata_t          advdata;
+    ble_advdata_t          scanrsp;
+    ble_adv_modes_config_t options;
+
+    memset(&advdata, 0, sizeof(advdata));
+    advdata.name_type          = BLE_ADVDATA_FULL_NAME;
+    advdata.include_appearance = false;
+    advdata.flags              = BLE_GAP_ADV_FLAGS_LE_ONLY_GENERAL_DISC_MODE;
+
+    memset(&scanrsp, 0, sizeof(scanrsp));
+    scanrsp.uuids_complete.uuid_cnt = sizeof(m_adv_uuids) / sizeof(m_adv_uuids[0]);
+    scanrsp.uuids_complete.p_uuids  = m_adv_uuids;
+
+    memset(&options, 0, sizeof(options));
+    options.ble_adv_fast_enabled  = true;
+    options.ble_adv_fast_interval = APP_ADV_INTERVAL;
+    options.ble_adv_fast_timeout  = APP_ADV_TIMEOUT_IN_SECONDS;
+
+    err_code = ble_advertising_init(&advdata, &scanrsp, &options, on_adv_evt, NULL);
+    APP_ERROR_CHECK(err_code);
+}
+
+
+/**@brief Function for initializing buttons and leds.
+ */
+static void buttons_leds_init(void)
+{
+    uint32_t err_code = bsp_init(BSP_INIT_LED,
+                                 APP_TIMER_TICKS(100, APP_TIMER_PRESCALER),
+                                 NULL);
+    APP_ERROR_CHECK(err_code);
+}
+
+
+/**@brief Function for placing the application in low power state while waiting for events.
+ */
+static void power_manage(void)
+{
+    uint32_t err_code = sd_app_evt_wait();
+    APP_ERROR_CHECK(err_code);
+}
+
+
+/**@brief Application main function.
+ */
+int main(void)
+{
+    uint32_t err_code;
+
+    // Initialize.
+    err_code = NRF_LOG_INIT(NULL);
+    APP_ERROR_CHECK(err_code);
+
+    timers_init();
+    buttons_leds_init();
+    ble_stack_init();
+    gap_params_init();
+    gatt_init();
+    services_init();
+    advertising_init();
+    radio_notification_init();
+    link_params_apply();
+
+    NRF_LOG_INFO("Benchmark started.\r\n");
+    err_code = ble_advertising_start(BLE_ADV_MODE_FAST);
+    APP_ERROR_CHECK(err_code);
+
+    // Enter main loop.
+    for (;;)
+    {
+        if (NRF_LOG_PROCESS() == false)
+        {
+            power_manage();
+        }
+    }
+}
+
+
+/**
+ * @}
+ */
@@ -110,6 +110,7 @@
 #define INPUT_REPORT_COUNT              3                                           /**< Number of input reports in this application. */
 #define INPUT_REP_BUTTONS_LEN           3                                           /**< Length of Mouse Input Report containing button data. */
 #define INPUT_REP_MOVEMENT_LEN          3                                           /**< Length of Mouse Input Report containing movement data. */
+#define INPUT_REP_MOVEMENT_DELTA_MAX    0x07FF                                      /**< Largest movement of the Mouse Input Report containing movement data (12-bit signed values). */
 #define INPUT_REP_MEDIA_PLAYER_LEN      1                                           /**< Length of Mouse Input Report containing media player data. */
 #define INPUT_REP_BUTTONS_INDEX         0                                           /**< Index of Mouse Input Report containing button data. */
 #define INPUT_REP_MOVEMENT_INDEX        1                                           /**< Index of Mouse Input Report containing movement data. */
@@ -510,6 +511,27 @@ static void bas_init(void)
 }
 
 
+/**@brief Function for encoding a movement into the Mouse Input Report containing movement data.
+ *
+ * @details Used by the report queue of the HID Service, as the movements are encoded when they
+ *          are sent, after queued movements have been merged.
+ */
+static uint16_t mouse_movement_encode(uint8_t   buttons,
+                                      int16_t   x_delta,
+                                      int16_t   y_delta,
+                                      uint8_t * p_data)
+{
+    UNUSED_PARAMETER(buttons);
+    APP_ERROR_CHECK_BOOL(INPUT_REP_MOVEMENT_LEN == 3);
+
+    p_data[0] = x_delta & 0x00ff;
+    p_data[1] = ((y_delta & 0x000f) << 4) | ((x_delta & 0x0f00) >> 8);
+    p_data[2] = (y_delta & 0x0ff0) >> 4;
+
+    return INPUT_REP_MOVEMENT_LEN;
+}
+
+
 /**@brief Function for initializing HID Service.
  */
 static void hids_init(void)
@@ -650,6 +672,8 @@ static void hids_init(void)
     hids_init_obj.hid_information.flags          = hid_info_flags;
     hids_init_obj.included_services_count        = 0;
     hids_init_obj.p_included_services_array      = NULL;
+    hids_init_obj.mouse_rep_encode               = mouse_movement_encode;
+    hids_init_obj.mouse_delta_max                = INPUT_REP_MOVEMENT_DELTA_MAX;
 
     BLE_GAP_CONN_SEC_MODE_SET_ENC_NO_MITM(&hids_init_obj.rep_map.security_mode.read_perm);
     BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&hids_init_obj.rep_map.security_mode.write_perm);
@@ -1168,6 +1192,9 @@ static void scheduler_init(void)
 
 
 /**@brief Function for sending a Mouse Movement.
+ *
+ * @details The movement is queued in the HID Service. While the link is backlogged, it is merged
+ *          with the movements queued before it.
  *
  * @param[in]   x_delta   Horizontal movement.
  * @param[in]   y_delta   Vertical movement.
@@ -1176,41 +1203,16 @@ static void mouse_movement_send(int16_t x_delta, int16_t y_delta)
 {
     uint32_t err_code;
 
-    if (m_in_boot_mode)
-    {
-        x_delta = MIN(x_delta, 0x00ff);
-        y_delta = MIN(y_delta, 0x00ff);
-
-        err_code = ble_hids_boot_mouse_inp_rep_send(&m_hids,
-                                                    0x00,
-                                                    (int8_t)x_delta,
-                                                    (int8_t)y_delta,
-                                                    0,
-                                                    NULL);
-    }
-    else
-    {
-        uint8_t buffer[INPUT_REP_MOVEMENT_LEN];
-
-        APP_ERROR_CHECK_BOOL(INPUT_REP_MOVEMENT_LEN == 3);
-
-        x_delta = MIN(x_delta, 0x0fff);
-        y_delta = MIN(y_delta, 0x0fff);
-
-        buffer[0] = x_delta & 0x00ff;
-        buffer[1] = ((y_delta & 0x000f) << 4) | ((x_delta & 0x0f00) >> 8);
-        buffer[2] = (y_delta & 0x0ff0) >> 4;
-
-        err_code = ble_hids_inp_rep_send(&m_hids,
-                                         INPUT_REP_MOVEMENT_INDEX,
-                                         INPUT_REP_MOVEMENT_LEN,
-                                         buffer);
-    }
+    err_code = ble_hids_mouse_rep_queue(&m_hids,
+                                        m_in_boot_mode ? BLE_HIDS_BOOT_MOUSE_REP_INDEX :
+                                                         INPUT_REP_MOVEMENT_INDEX,
+                                        0x00,
+                                        x_delta,
+                                        y_delta);
 
     if ((err_code != NRF_SUCCESS) &&
         (err_code != NRF_ERROR_INVALID_STATE) &&
-        (err_code != BLE_ERROR_NO_TX_PACKETS) &&
-        (err_code != BLE_ERROR_GATTS_SYS_ATTR_MISSING)
+        (err_code != NRF_ERROR_NO_MEM)
        )
     {
         APP_ERROR_HANDLER(err_code);
@@ -48,6 +48,7 @@
 
 #define APP_CONFIG_TLM_TEMP_INTERVAL_SECONDS  (30)                                      //!< How often should the temperature of the beacon be updated when TLM slot is configured.
 #define APP_CONFIG_TLM_VBATT_INTERVAL_SECONDS (30)                                      //!< How often should the battery voltage of the beacon be updated when TLM slot is configured.    
+#define APP_CONFIG_FLASH_COMMIT_QUIET_MS    10000                                       //!< Time without configuration writes after which the configuration is stored to flash while connected (in milliseconds).
 
 // HW CONFIGS
 #define BUTTON_REGISTRATION                 BUTTON_1                                    //!< Button to push when putting the beacon in registration mode.
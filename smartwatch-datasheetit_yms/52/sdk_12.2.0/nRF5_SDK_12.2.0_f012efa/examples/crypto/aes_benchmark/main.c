@@ -0,0 +1,154 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup aes_benchmark_example AES benchmark example
+ * @{
+ * @ingroup crypto_examples
+ *
+ * @brief Measures the time of AES-128 encryption with tiny-AES128, and with the ECB peripheral.
+ *
+ * The time is counted by TIMER0 at 16 MHz, because Cortex-M0 has no cycle counter: on nRF51,
+ * which runs at 16 MHz, a tick is a CPU cycle. tiny-AES128
+ * is measured with one key, for which the key expansion is kept, and with two keys in turn,
+ * for which the key is expanded on every block. Build with AES128_TTABLE=0 or AES128_TTABLE=1
+ * to compare the byte-oriented and the table version.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "nrf.h"
+#include "nrf_ecb.h"
+#include "app_error.h"
+#include "aes.h"
+#define NRF_LOG_MODULE_NAME "APP"
+#include "nrf_log.h"
+#include "nrf_log_ctrl.h"
+
+#define AES_BLOCKS          256                             /**< Number of blocks that are encrypted in one measurement. */
+
+static uint8_t m_key_a[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                              0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+static uint8_t m_key_b[16] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                              0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+static uint8_t m_block[16];
+
+
+/**@brief Start TIMER0 as a free-running 32-bit counter at 16 MHz. */
+static void timer_init(void)
+{
+    NRF_TIMER0->MODE      = TIMER_MODE_MODE_Timer;
+    NRF_TIMER0->BITMODE   = TIMER_BITMODE_BITMODE_32Bit;
+    NRF_TIMER0->PRESCALER = 0;
+    NRF_TIMER0->TASKS_CLEAR = 1;
+    NRF_TIMER0->TASKS_START = 1;
+}
+
+
+static uint32_t timer_get(void)
+{
+    NRF_TIMER0->TASKS_CAPTURE[0] = 1;
+    return NRF_TIMER0->CC[0];
+}
+
+
+/**@brief Log the time of one block. */
+static void result_log(char const * p_name, uint32_t ticks)
+{
+    NRF_LOG_INFO("%s: %d ticks per block\r\n", (uint32_t)p_name, ticks / AES_BLOCKS);
+    NRF_LOG_FLUSH();
+}
+
+
+static void tiny_aes_same_key(void)
+{
+    for (uint32_t i = 0; i < AES_BLOCKS; i++)
+    {
+        AES128_ECB_encrypt(m_block, m_key_a, m_block);
+    }
+}
+
+
+static void tiny_aes_key_change(void)
+{
+    for (uint32_t i = 0; i < AES_BLOCKS; i++)
+    {
+        AES128_ECB_encrypt(m_block, (i & 1) ? m_key_b : m_key_a, m_block);
+    }
+}
+
+
+static void ecb_peripheral(void)
+{
+    for (uint32_t i = 0; i < AES_BLOCKS; i++)
+    {
+        if (!nrf_ecb_crypt(m_block, m_block))
+        {
+            APP_ERROR_CHECK(NRF_ERROR_TIMEOUT);
+        }
+    }
+}
+
+
+/**@brief Measure one function that encrypts AES_BLOCKS blocks. */
+#define BENCHMARK(p_name, function)                 \
+    do                                              \
+    {                                               \
+        uint32_t start = timer_get();               \
+        function();                                 \
+        result_log((p_name), timer_get() - start);  \
+    } while (0)
+
+
+int main(void)
+{
+    static uint8_t const expected[16] = {0x3a, 0xd7, 0x7b, 0xb4, 0x0d, 0x7a, 0x36, 0x60,
+                                         0xa8, 0x9e, 0xca, 0xf3, 0x24, 0x66, 0xef, 0x97};
+    static uint8_t const plain[16]    = {0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+                                         0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a};
+    uint32_t err_code;
+
+    err_code = NRF_LOG_INIT(NULL);
+    APP_ERROR_CHECK(err_code);
+
+    timer_init();
+
+    NRF_LOG_INFO("AES benchmark, tiny-AES128 with AES128_TTABLE=%d\r\n", AES128_TTABLE);
+
+    // Check the implementation against the test vector of SP 800-38A.
+    memcpy(m_block, plain, sizeof(m_block));
+    AES128_ECB_encrypt(m_block, m_key_a, m_block);
+    NRF_LOG_INFO("Test vector %s\r\n",
+                 (uint32_t)((memcmp(m_block, expected, sizeof(m_block)) == 0) ? "passed" : "FAILED"));
+
+    BENCHMARK("tiny-AES128, same key", tiny_aes_same_key);
+    BENCHMARK("tiny-AES128, key change", tiny_aes_key_change);
+
+    if (!nrf_ecb_init())
+    {
+        APP_ERROR_CHECK(NRF_ERROR_INTERNAL);
+    }
+    nrf_ecb_set_key(m_key_a);
+    BENCHMARK("ECB peripheral", ecb_peripheral);
+
+    NRF_LOG_INFO("Done\r\n");
+    NRF_LOG_FLUSH();
+
+    for (;;)
+    {
+        __WFE();
+    }
+}
+
+/** @} */
@@ -0,0 +1,177 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ecc_benchmark_example ECC benchmark example
+ * @{
+ * @ingroup crypto_examples
+ *
+ * @brief Measures the time of the P-256 operations of the @ref ecc backend that is built in,
+ *        and of AES-128 on the ECB peripheral.
+ *
+ * The time is counted in CPU cycles by the DWT cycle counter, and logged in microseconds.
+ * The pca10040 project uses micro-ecc, the pca10056 project the CryptoCell CC310. The CC310
+ * backend does not compute a public key from a private key: that operation fails there.
+ *
+ * The micro-ecc library that is linked is chosen with MICRO_ECC_VARIANT, for example
+ * "make MICRO_ECC_VARIANT=speed" after "make micro_ecc_lib_speed" in
+ * external/micro-ecc/nrf52_armgcc/armgcc. Its name is logged first, so that the logs of the
+ * variants can be told apart.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "nrf.h"
+#include "app_error.h"
+#include "app_util.h"
+#include "nrf_drv_rng.h"
+#include "ecc.h"
+#include "sha256.h"
+#include "nrf_crypto.h"
+#define NRF_LOG_MODULE_NAME "APP"
+#include "nrf_log.h"
+#include "nrf_log_ctrl.h"
+
+#define BENCHMARK_ROUNDS    8                               /**< Number of times each operation is measured. */
+#define AES_BLOCKS          1024                            /**< Number of blocks that are encrypted in one round. */
+#define CPU_FREQ_MHZ        64                              /**< CPU frequency, for the conversion of cycles. */
+
+#ifndef ECC_BENCHMARK_VARIANT
+#define ECC_BENCHMARK_VARIANT "default"                     /**< Name of the ECC library that is linked, set by the project. */
+#endif
+
+__ALIGN(4) static uint8_t m_sk_a[ECC_P256_SK_LEN];
+__ALIGN(4) static uint8_t m_pk_a[ECC_P256_PK_LEN];
+__ALIGN(4) static uint8_t m_sk_b[ECC_P256_SK_LEN];
+__ALIGN(4) static uint8_t m_pk_b[ECC_P256_PK_LEN];
+__ALIGN(4) static uint8_t m_ss_a[ECC_P256_SK_LEN];
+__ALIGN(4) static uint8_t m_ss_b[ECC_P256_SK_LEN];
+__ALIGN(4) static uint8_t m_hash[32];
+__ALIGN(4) static uint8_t m_sig[ECC_P256_PK_LEN];
+
+static const char m_message[] = "Nordic Semiconductor ECC benchmark";
+
+
+/**@brief Start the cycle counter. */
+static void cycles_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT       = 0;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+
+/**@brief Log the cycles of an operation, and the number of rounds in which it failed. */
+static void result_log(char const * p_name, uint32_t cycles_total, uint32_t failures)
+{
+    uint32_t cycles = cycles_total / BENCHMARK_ROUNDS;
+
+    NRF_LOG_INFO("%s: %d cycles, %d us, %d failed\r\n",
+                 (uint32_t)p_name, cycles, cycles / CPU_FREQ_MHZ, failures);
+    NRF_LOG_FLUSH();
+}
+
+
+/**@brief Measure one operation over all rounds.
+ *
+ * @param[in] p_name    Name of the operation, logged.
+ * @param[in] operation Expression that returns NRF_SUCCESS.
+ */
+#define BENCHMARK(p_name, operation)                                \
+    do                                                              \
+    {                                                               \
+        uint32_t total    = 0;                                      \
+        uint32_t failures = 0;                                      \
+        for (uint32_t round = 0; round < BENCHMARK_ROUNDS; round++) \
+        {                                                           \
+            uint32_t start = DWT->CYCCNT;                           \
+            if ((operation) != NRF_SUCCESS)                         \
+            {                                                       \
+                failures++;                                         \
+            }                                                       \
+            total += DWT->CYCCNT - start;                           \
+        }                                                           \
+        result_log((p_name), total, failures);                      \
+    } while (0)
+
+
+/**@brief Encrypt AES_BLOCKS blocks in place. */
+static uint32_t aes_blocks_encrypt(void)
+{
+    static uint8_t const key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+    uint8_t        block[16] = {0};
+    uint32_t       err_code  = NRF_SUCCESS;
+
+    for (uint32_t i = 0; (i < AES_BLOCKS) && (err_code == NRF_SUCCESS); i++)
+    {
+        err_code = nrf_crypto_aes128_encrypt(key, block, block);
+    }
+    return err_code;
+}
+
+
+static uint32_t hash_compute(void)
+{
+    nrf_crypto_key_t hash = {.p_le_data = m_hash, .len = sizeof(m_hash)};
+
+    return nrf_crypto_hash_compute(NRF_CRYPTO_HASH_ALG_SHA256,
+                                   (uint8_t const *)m_message, sizeof(m_message) - 1, &hash);
+}
+
+
+int main(void)
+{
+    uint32_t err_code;
+
+    err_code = NRF_LOG_INIT(NULL);
+    APP_ERROR_CHECK(err_code);
+
+    err_code = nrf_drv_rng_init(NULL);
+    APP_ERROR_CHECK(err_code);
+
+    cycles_init();
+    ecc_init(true);
+
+    NRF_LOG_INFO("ECC benchmark, %s, %d rounds\r\n", (uint32_t)ECC_BENCHMARK_VARIANT, BENCHMARK_ROUNDS);
+
+    err_code = hash_compute();
+    APP_ERROR_CHECK(err_code);
+
+    BENCHMARK("Key pair", ecc_p256_keypair_gen(m_sk_a, m_pk_a));
+    err_code = ecc_p256_keypair_gen(m_sk_b, m_pk_b);
+    APP_ERROR_CHECK(err_code);
+
+    BENCHMARK("Public key", ecc_p256_public_key_compute(m_sk_a, m_pk_a));
+    BENCHMARK("ECDH", ecc_p256_shared_secret_compute(m_sk_a, m_pk_b, m_ss_a));
+    BENCHMARK("Sign", ecc_p256_sign(m_sk_a, m_hash, sizeof(m_hash), m_sig));
+    BENCHMARK("Verify", ecc_p256_verify(m_pk_a, m_hash, sizeof(m_hash), m_sig));
+    BENCHMARK("SHA-256", hash_compute());
+    BENCHMARK("AES-128, 1024 blocks", aes_blocks_encrypt());
+
+    // Both sides of the key exchange must agree.
+    err_code = ecc_p256_shared_secret_compute(m_sk_b, m_pk_a, m_ss_b);
+    APP_ERROR_CHECK(err_code);
+    NRF_LOG_INFO("ECDH secrets %s\r\n",
+                 (uint32_t)((memcmp(m_ss_a, m_ss_b, sizeof(m_ss_a)) == 0) ? "match" : "DIFFER"));
+
+    NRF_LOG_INFO("Done\r\n");
+    NRF_LOG_FLUSH();
+
+    for (;;)
+    {
+        __WFE();
+    }
+}
+
+/** @} */
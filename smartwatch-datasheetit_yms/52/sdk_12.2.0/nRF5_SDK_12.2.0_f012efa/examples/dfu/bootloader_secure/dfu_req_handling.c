@@ -33,6 +33,7 @@
 #include "nrf_sdm.h"
 #include "sdk_macros.h"
 #include "nrf_crypto.h"
+#include "sha256.h"
 
 STATIC_ASSERT(DFU_SIGNED_COMMAND_SIZE <= INIT_COMMAND_MAX_SIZE);
 
@@ -52,18 +53,39 @@ STATIC_ASSERT(DFU_SIGNED_COMMAND_SIZE <= INIT_COMMAND_MAX_SIZE);
 /** @brief Cyclic buffers for storing data that is to be written to flash.
  *         This is because the RAM copy must be kept alive until copying is
  *         done and the DFU process must be able to progress while waiting for flash.
+ *         Packets are received into the next buffers while the previous ones are written.
  *
  */
+#ifndef FLASH_BUFFER_CHUNK_LENGTH
 #define FLASH_BUFFER_CHUNK_LENGTH 256   //< Length of a flash buffer chunk. must be a power of 4.
-#define FLASH_BUFFER_CHUNK_COUNT  4     //< Number of flash buffer chunks. Must be a power of 2.
-#define FLASH_BUFFER_SWAP()  do                                                                   \
-            {m_current_data_buffer = (m_current_data_buffer + 1) & 0x03; m_data_buf_pos = 0;}   \
+#endif
+#ifndef FLASH_BUFFER_CHUNK_COUNT
+#define FLASH_BUFFER_CHUNK_COUNT  8     //< Number of flash buffer chunks. Must be a power of 2.
+#endif
+#define FLASH_BUFFER_SWAP()  do                                                                                             \
+            {m_current_data_buffer = (m_current_data_buffer + 1) & (FLASH_BUFFER_CHUNK_COUNT - 1); m_data_buf_pos = 0;}   \
             while (0)
 
+STATIC_ASSERT(IS_POWER_OF_TWO(FLASH_BUFFER_CHUNK_COUNT));
+
+/** @brief Number of pages erased ahead of the received data when the image is written to bank 0,
+ *         over the current application.
+ *
+ * @details The current application is erased one object ahead of the data, not all at once when
+ *          the update starts. In bank 1, the whole image area is erased ahead.
+ */
+#ifndef NRF_DFU_IN_PLACE_ERASE_AHEAD_PAGES
+#define NRF_DFU_IN_PLACE_ERASE_AHEAD_PAGES (DATA_OBJECT_MAX_SIZE / CODE_PAGE_SIZE)
+#endif
+
 __ALIGN(4) static uint8_t  m_data_buf[FLASH_BUFFER_CHUNK_COUNT][FLASH_BUFFER_CHUNK_LENGTH];
 
 static uint16_t m_data_buf_pos;                         /**< The number of bytes written in the current buffer. */
 static uint8_t  m_current_data_buffer;                  /**< Index of the current data buffer. Must be between 0 and FLASH_BUFFER_CHUNK_COUNT - 1. */
+static uint8_t  m_data_buf_busy;                        /**< The number of buffers before the current one that are being written to flash. */
+static uint32_t m_data_buf_full;                        /**< The number of write requests refused because no buffer was free. */
+static uint32_t m_data_buf_full_seen;                   /**< The value of m_data_buf_full when the receive capacity was last updated. */
+static uint32_t m_rx_capacity;                          /**< Bytes the host should send between two receipt notifications. */
 static uint32_t m_flash_operations_pending;             /**< A counter holding the number of pending flash operations. This will prevent flooding of the buffers. */
 
 static uint32_t             m_firmware_start_addr;      /**< Start address of the current firmware image. */
@@ -71,6 +93,10 @@ static uint32_t             m_firmware_size_req;        /**< The size of the ent
 
 static bool m_valid_init_packet_present;                /**< Global variable holding the current flags indicating the state of the DFU process. */
 
+static sha256_context_t m_image_hash_ctx;               /**< Hash of the firmware image received so far. */
+static sha256_context_t m_image_hash_ctx_last;          /**< Hash of the firmware image up to the last executed object. */
+static bool             m_image_hash_valid;             /**< The hash covers the image from its start, and all of it was stored. If not, the image is hashed from flash in postvalidate. */
+
 
 
 
@@ -108,6 +134,93 @@ static void dfu_data_write_handler(fs_evt_t const * const evt, fs_ret_t result)
 }
 
 
+static void dfu_data_store_handler(fs_evt_t const * const evt, fs_ret_t result)
+{
+    if (result != FS_SUCCESS)
+    {
+        // The received data may differ from the data in flash.
+        m_image_hash_valid = false;
+    }
+    --m_data_buf_busy;
+    --m_flash_operations_pending;
+}
+
+
+/** @brief Function for writing the current data buffer to flash and starting to fill the next one.
+ *
+ * @param[out] p_res    Response, updated if the write failed.
+ */
+static void data_buf_store(nrf_dfu_res_t * p_res)
+{
+    uint32_t const * p_write_addr = (uint32_t const *)(m_firmware_start_addr + s_dfu_settings.write_offset);
+
+    ++m_flash_operations_pending;
+    ++m_data_buf_busy;
+    if (nrf_dfu_flash_store(p_write_addr, (uint32_t*)&m_data_buf[m_current_data_buffer][0], CEIL_DIV(m_data_buf_pos,4), dfu_data_store_handler) == FS_SUCCESS)
+    {
+        NRF_LOG_INFO("Storing %d B at: 0x%08x\r\n", m_data_buf_pos, (uint32_t)p_write_addr);
+        // Pre-calculate Offset + CRC assuming flash operation went OK
+        s_dfu_settings.write_offset += m_data_buf_pos;
+    }
+    else
+    {
+        --m_data_buf_busy;
+        --m_flash_operations_pending;
+        NRF_LOG_INFO("!!! Failed storing %d B at address: 0x%08x\r\n", m_data_buf_pos, (uint32_t)p_write_addr);
+        // Previous flash operation failed. Revert CRC, hash and offset.
+        s_dfu_settings.progress.firmware_image_crc = s_dfu_settings.progress.firmware_image_crc_last;
+        s_dfu_settings.progress.firmware_image_offset = s_dfu_settings.progress.firmware_image_offset_last;
+        m_image_hash_ctx = m_image_hash_ctx_last;
+
+        // Update the return values
+        p_res->offset = s_dfu_settings.progress.firmware_image_offset_last;
+        p_res->crc = s_dfu_settings.progress.firmware_image_crc_last;
+    }
+
+    FLASH_BUFFER_SWAP();
+}
+
+
+/** @brief Function for getting the end of the area to erase ahead of the given image offset.
+ */
+static uint32_t erase_ahead_end(uint32_t offset)
+{
+    if (m_firmware_start_addr != MAIN_APPLICATION_START_ADDR)
+    {
+        return m_firmware_size_req;
+    }
+
+    return MIN(offset + NRF_DFU_IN_PLACE_ERASE_AHEAD_PAGES * CODE_PAGE_SIZE, m_firmware_size_req);
+}
+
+
+/** @brief Function for starting to erase ahead from the given image offset.
+ */
+static void erase_ahead_start(uint32_t offset)
+{
+    offset = CEIL_DIV(offset, CODE_PAGE_SIZE) * CODE_PAGE_SIZE;
+    if (offset < m_firmware_size_req)
+    {
+        (void)nrf_dfu_flash_erase_ahead((uint32_t *)(m_firmware_start_addr + offset),
+                                        CEIL_DIV(erase_ahead_end(offset) - offset, CODE_PAGE_SIZE));
+    }
+}
+
+
+/** @brief Function for logging the statistics of the image transfer.
+ */
+static void transfer_stats_log(void)
+{
+    nrf_dfu_flash_stats_t stats;
+
+    nrf_dfu_flash_stats_get(&stats);
+    NRF_LOG_INFO("Flash: %d stores, %d B, %d erases, %d erases skipped, %d pages erased ahead\r\n",
+                 stats.stores, stats.bytes_stored, stats.erases, stats.erases_skipped, stats.pages_erased_ahead);
+    NRF_LOG_INFO("Flash: max %d operations queued, %d writes refused for full buffers\r\n",
+                 stats.max_ops_pending, m_data_buf_full);
+}
+
+
 static void pb_decoding_callback(pb_istream_t *str, uint32_t tag, pb_wire_type_t wire_type, void *iter)
 {
     pb_field_iter_t* p_iter = (pb_field_iter_t *) iter;
@@ -375,6 +488,12 @@ static nrf_dfu_res_code_t dfu_handle_prevalidate(dfu_signed_command_t const * p_
 
     NRF_LOG_INFO("Write address set to 0x%08x\r\n", m_firmware_start_addr);
 
+    // Erase the image area while the data objects are being received.
+    nrf_dfu_flash_stats_clear();
+    m_data_buf_full = 0;
+    m_data_buf_full_seen = 0;
+    erase_ahead_start(0);
+
     NRF_LOG_INFO("DFU prevalidate SUCCESSFUL!\r\n");
 
     return NRF_DFU_RES_CODE_SUCCESS;
@@ -395,7 +514,16 @@ static nrf_dfu_res_code_t nrf_dfu_postvalidate(dfu_init_command_t * p_init)
         case DFU_HASH_TYPE_SHA256:
             hash_data.p_le_data = &hash[0];
             hash_data.len = sizeof(hash);
-            err_code = nrf_crypto_hash_compute(NRF_CRYPTO_HASH_ALG_SHA256, (uint8_t*)m_firmware_start_addr, m_firmware_size_req, &hash_data);
+            if (m_image_hash_valid)
+            {
+                // The image was hashed while it was received. Little endian, as nrf_crypto.
+                err_code = sha256_final(&m_image_hash_ctx_last, &hash[0], 1);
+            }
+            else
+            {
+                NRF_LOG_INFO("Hashing the image from flash\r\n");
+                err_code = nrf_crypto_hash_compute(NRF_CRYPTO_HASH_ALG_SHA256, (uint8_t*)m_firmware_start_addr, m_firmware_size_req, &hash_data);
+            }
             if (err_code != NRF_SUCCESS)
             {
                 res_code = NRF_DFU_RES_CODE_OPERATION_FAILED;
@@ -708,7 +836,6 @@ static nrf_dfu_res_code_t nrf_dfu_command_req(void * p_context, nrf_dfu_req_t *
 
 static nrf_dfu_res_code_t nrf_dfu_data_req(void * p_context, nrf_dfu_req_t * p_req, nrf_dfu_res_t * p_res)
 {
-    uint32_t            const * p_write_addr;
     nrf_dfu_res_code_t          ret_val = NRF_DFU_RES_CODE_SUCCESS;
 
 #ifndef NRF51
@@ -764,6 +891,15 @@ static nrf_dfu_res_code_t nrf_dfu_data_req(void * p_context, nrf_dfu_req_t * p_r
             s_dfu_settings.progress.firmware_image_offset = s_dfu_settings.progress.firmware_image_offset_last;
             s_dfu_settings.write_offset                   = s_dfu_settings.progress.firmware_image_offset_last;
 
+            // The hash is restarted with the image. After a resume from the stored progress, the
+            // hash of the part received before the reset is not known.
+            if (s_dfu_settings.progress.firmware_image_offset_last == 0)
+            {
+                (void)sha256_init(&m_image_hash_ctx_last);
+                m_image_hash_valid = true;
+            }
+            m_image_hash_ctx = m_image_hash_ctx_last;
+
             FLASH_BUFFER_SWAP();
 
             // Erase the page we're at.
@@ -795,6 +931,16 @@ static nrf_dfu_res_code_t nrf_dfu_data_req(void * p_context, nrf_dfu_req_t * p_r
                 return NRF_DFU_RES_CODE_INSUFFICIENT_RESOURCES;
             }
 
+            // A buffer is not reused before it is written to flash. The current buffer, and the
+            // next one if the current one gets full, must be free.
+            if (m_data_buf_busy + ((m_data_buf_pos + p_req->req_len < FLASH_BUFFER_CHUNK_LENGTH) ? 1 : 2) >
+                FLASH_BUFFER_CHUNK_COUNT)
+            {
+                NRF_LOG_INFO("No free flash buffer\r\n");
+                m_data_buf_full++;
+                return NRF_DFU_RES_CODE_INSUFFICIENT_RESOURCES;
+            }
+
             if ((p_req->req_len + s_dfu_settings.progress.firmware_image_offset - s_dfu_settings.progress.firmware_image_offset_last) > s_dfu_settings.progress.data_object_size)
             {
                 // Can't accept data because too much data has been received.
@@ -802,8 +948,12 @@ static nrf_dfu_res_code_t nrf_dfu_data_req(void * p_context, nrf_dfu_req_t * p_r
                 return NRF_DFU_RES_CODE_INVALID_PARAMETER;
             }
 
-            // Update the CRC of the firmware image.
+            // Update the CRC and the hash of the firmware image.
             s_dfu_settings.progress.firmware_image_crc = crc32_compute(p_req->p_req, p_req->req_len, &s_dfu_settings.progress.firmware_image_crc);
+            if (m_image_hash_valid)
+            {
+                (void)sha256_update(&m_image_hash_ctx, p_req->p_req, p_req->req_len);
+            }
             s_dfu_settings.progress.firmware_image_offset += p_req->req_len;
 
             // Update the return values
@@ -834,28 +984,7 @@ static nrf_dfu_res_code_t nrf_dfu_data_req(void * p_context, nrf_dfu_req_t * p_r
                 p_req->p_req += first_segment_length;
 
                 // Write to flash.
-                p_write_addr = (uint32_t const *)(m_firmware_start_addr + s_dfu_settings.write_offset);
-                ++m_flash_operations_pending;
-                if (nrf_dfu_flash_store(p_write_addr, (uint32_t*)&m_data_buf[m_current_data_buffer][0], CEIL_DIV(m_data_buf_pos,4), dfu_data_write_handler) == FS_SUCCESS)
-                {
-                    NRF_LOG_INFO("Storing %d B at: 0x%08x\r\n", m_data_buf_pos, (uint32_t)p_write_addr);
-                    // Pre-calculate Offset + CRC assuming flash operation went OK
-                    s_dfu_settings.write_offset += m_data_buf_pos;
-                }
-                else
-                {
-                    --m_flash_operations_pending;
-                    NRF_LOG_INFO("!!! Failed storing %d B at address: 0x%08x\r\n", m_data_buf_pos, (uint32_t)p_write_addr);
-                    // Previous flash operation failed. Revert CRC and offset.
-                    s_dfu_settings.progress.firmware_image_crc = s_dfu_settings.progress.firmware_image_crc_last;
-                    s_dfu_settings.progress.firmware_image_offset = s_dfu_settings.progress.firmware_image_offset_last;
-
-                    // Update the return values
-                    p_res->offset = s_dfu_settings.progress.firmware_image_offset_last;
-                    p_res->crc = s_dfu_settings.progress.firmware_image_crc_last;
-                }
-
-                FLASH_BUFFER_SWAP();
+                data_buf_store(p_res);
 
                 //Copy the remaining segment of the request into the next buffer.
                 if (p_req->req_len)
@@ -874,28 +1003,7 @@ static nrf_dfu_res_code_t nrf_dfu_data_req(void * p_context, nrf_dfu_req_t * p_r
                )
             {
                 //End of an object and there is still data in the write buffer. Flush the write buffer.
-                p_write_addr = (uint32_t const *)(m_firmware_start_addr + s_dfu_settings.write_offset);
-                ++m_flash_operations_pending;
-                if (nrf_dfu_flash_store(p_write_addr, (uint32_t*)&m_data_buf[m_current_data_buffer][0], CEIL_DIV(m_data_buf_pos,4), dfu_data_write_handler) == FS_SUCCESS)
-                {
-                    NRF_LOG_INFO("Storing %d B at: 0x%08x\r\n", m_data_buf_pos, (uint32_t)p_write_addr);
-                    s_dfu_settings.write_offset += m_data_buf_pos;
-                }
-                else
-                {
-                    --m_flash_operations_pending;
-                    NRF_LOG_INFO("!!! Failed storing %d B at address: 0x%08x\r\n", m_data_buf_pos, (uint32_t)p_write_addr);
-                    // Previous flash operation failed. Revert CRC and offset.
-                    s_dfu_settings.progress.firmware_image_crc = s_dfu_settings.progress.firmware_image_crc_last;
-                    s_dfu_settings.progress.firmware_image_offset = s_dfu_settings.progress.firmware_image_offset_last;
-
-                    // Update the return values
-                    p_res->offset = s_dfu_settings.progress.firmware_image_offset_last;
-                    p_res->crc = s_dfu_settings.progress.firmware_image_crc_last;
-                }
-
-                // Swap buffers.
-                FLASH_BUFFER_SWAP();
+                data_buf_store(p_res);
             }
 
             break;
@@ -923,11 +1031,16 @@ static nrf_dfu_res_code_t nrf_dfu_data_req(void * p_context, nrf_dfu_req_t * p_r
             s_dfu_settings.progress.data_object_size = 0;
             s_dfu_settings.progress.firmware_image_offset_last = s_dfu_settings.progress.firmware_image_offset;
             s_dfu_settings.progress.firmware_image_crc_last = s_dfu_settings.progress.firmware_image_crc;
+            m_image_hash_ctx_last = m_image_hash_ctx;
             if (nrf_dfu_settings_write(NULL) != NRF_SUCCESS)
             {
                 return NRF_DFU_RES_CODE_OPERATION_FAILED;
             }
 
+            // Move the erased window over the next object.
+            nrf_dfu_flash_erase_ahead_extend((uint32_t *)(m_firmware_start_addr +
+                                             erase_ahead_end(s_dfu_settings.progress.firmware_image_offset_last)));
+
             if (s_dfu_settings.progress.firmware_image_offset == m_firmware_size_req)
             {
                 NRF_LOG_INFO("Waiting for %d pending flash operations before doing postvalidate.\r\n", m_flash_operations_pending);
@@ -935,6 +1048,7 @@ static nrf_dfu_res_code_t nrf_dfu_data_req(void * p_context, nrf_dfu_req_t * p_r
                 {
                     nrf_dfu_wait();
                 }
+                transfer_stats_log();
                 // Received the whole image. Doing postvalidate.
                 NRF_LOG_INFO("Doing postvalidate\r\n");
                 ret_val = nrf_dfu_postvalidate(&packet.signed_command.command.init);
@@ -969,6 +1083,8 @@ uint32_t nrf_dfu_req_handler_init(void)
     VERIFY_SUCCESS(ret_val);
 
     m_flash_operations_pending = 0;
+    m_data_buf_busy = 0;
+    m_rx_capacity = (FLASH_BUFFER_CHUNK_COUNT - 1) * FLASH_BUFFER_CHUNK_LENGTH;
 
     // If the command is stored to flash, init command was valid.
     if (s_dfu_settings.progress.command_size != 0 && dfu_decode_commmand())
@@ -990,6 +1106,9 @@ uint32_t nrf_dfu_req_handler_init(void)
         // Location should still be valid, expecting result of find-cache to be true
         (void)nrf_dfu_find_cache(m_firmware_size_req, false, &m_firmware_start_addr);
 
+        // Erase the rest of the image area while the remaining data objects are being received.
+        erase_ahead_start(s_dfu_settings.progress.firmware_image_offset_last);
+
         // Setting valid init command to true to
         m_valid_init_packet_present = true;
     }
@@ -998,6 +1117,19 @@ uint32_t nrf_dfu_req_handler_init(void)
 }
 
 
+uint32_t nrf_dfu_req_handler_rx_capacity_get(void)
+{
+    // Refused data means that the host filled the buffers faster than the flash emptied them.
+    if (m_data_buf_full != m_data_buf_full_seen)
+    {
+        m_data_buf_full_seen = m_data_buf_full;
+        m_rx_capacity = MAX(m_rx_capacity / 2, FLASH_BUFFER_CHUNK_LENGTH);
+    }
+
+    return m_rx_capacity;
+}
+
+
 nrf_dfu_res_code_t nrf_dfu_req_handler_on_req(void * p_context, nrf_dfu_req_t * p_req, nrf_dfu_res_t * p_res)
 {
     nrf_dfu_res_code_t ret_val;
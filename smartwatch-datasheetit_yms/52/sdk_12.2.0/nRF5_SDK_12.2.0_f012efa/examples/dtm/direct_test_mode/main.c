@@ -49,6 +49,24 @@
  */
 #define MAX_ITERATIONS_NEEDED_FOR_NEXT_BYTE ((5000 + 2 * UART_POLL_CYCLE) / UART_POLL_CYCLE)
 
+#define SWEEP_MAX_STEPS                     40         /**< Steps of the sweep results, one for each channel of the default sweep. */
+
+/**@brief Default sweep: all channels, BLE 1 Mbit, PRBS9. Started with the vendor specific
+ *        commands SWEEP_RX_START and SWEEP_TX_START.
+ */
+static dtm_sweep_config_t const m_sweep_config =
+{
+    .channel_mask    = 0xFFFFFFFFFFULL,
+    .mode_mask       = 1 << RADIO_MODE_MODE_Ble_1Mbit,
+    .pattern_mask    = 1 << DTM_PKT_PRBS9,
+    .length          = 37,
+    .packets         = 100,
+    .sync_timeout_ms = 10000,
+};
+
+static dtm_sweep_result_t m_sweep_results[SWEEP_MAX_STEPS]; /**< Results of the sweep, on the receiving device. */
+static bool               m_sweep_rx;                        /**< The last sweep was started as the receiving device. */
+
 /**@brief Function for UART initialization.
  */
 static void uart_init(void)
@@ -74,6 +92,77 @@ static void uart_init(void)
 }
 
 
+/**@brief Function for writing a byte to the UART and waiting until it is sent.
+ */
+static void uart_put(uint8_t byte)
+{
+    NRF_UART0->TXD = byte;
+    while (NRF_UART0->EVENTS_TXDRDY != 1)
+    {
+        // Do nothing.
+    }
+    NRF_UART0->EVENTS_TXDRDY = 0;
+}
+
+
+/**@brief Function for writing a decimal number and a separator to the UART.
+ */
+static void uart_put_dec(uint32_t value, char separator)
+{
+    char     digits[10];
+    uint32_t count = 0;
+
+    do
+    {
+        digits[count++] = '0' + (value % 10);
+        value          /= 10;
+    } while (value != 0);
+
+    while (count > 0)
+    {
+        uart_put(digits[--count]);
+    }
+    uart_put(separator);
+}
+
+
+/**@brief Function for writing the results of a sweep to the UART, as text.
+ *
+ * @details The first line is "SWEEP <status> <steps>". Each next line is one step:
+ *          "<channel> <mode> <pattern> <received> <crc errors> <rssi avg> <rssi min> <rssi max>"
+ *          followed by the RSSI histogram. The transmitting device only sends the first line.
+ */
+static void sweep_results_put(dtm_sweep_status_t status, uint32_t steps)
+{
+    for (char const * p_char = "SWEEP "; *p_char != '\0'; p_char++)
+    {
+        uart_put(*p_char);
+    }
+    uart_put_dec(status, ' ');
+    uart_put_dec(steps, '\r');
+    uart_put('\n');
+
+    for (uint32_t i = 0; m_sweep_rx && (i < steps); i++)
+    {
+        dtm_sweep_result_t const * p_result = &m_sweep_results[i];
+
+        uart_put_dec(p_result->channel, ' ');
+        uart_put_dec(p_result->mode, ' ');
+        uart_put_dec(p_result->pattern, ' ');
+        uart_put_dec(p_result->received, ' ');
+        uart_put_dec(p_result->crc_errors, ' ');
+        uart_put_dec(p_result->rssi_avg, ' ');
+        uart_put_dec(p_result->rssi_min, ' ');
+        uart_put_dec(p_result->rssi_max, ' ');
+        for (uint32_t j = 0; j < BLE_DTM_SWEEP_RSSI_BINS; j++)
+        {
+            uart_put_dec(p_result->rssi_hist[j], (j == BLE_DTM_SWEEP_RSSI_BINS - 1) ? '\r' : ' ');
+        }
+        uart_put('\n');
+    }
+}
+
+
 /**@brief Function for splitting UART command bit fields into separate command parameters for the DTM library.
 *
  * @param[in]   command   The packed UART command.
@@ -95,6 +184,12 @@ static uint32_t dtm_cmd_put(uint16_t command)
            to avoid the risk of confusion, should the code be extended to greater coverage.
         */
         payload = DTM_PKT_VENDORSPECIFIC;
+
+        if ((command_code == LE_TRANSMITTER_TEST) &&
+            ((length == SWEEP_RX_START) || (length == SWEEP_TX_START)))
+        {
+            m_sweep_rx = (length == SWEEP_RX_START);
+        }
     }
     return dtm_cmd(command_code, freq, length, payload);
 }
@@ -115,6 +210,8 @@ int main(void)
     uint16_t    dtm_cmd_from_uart = 0;     // Packed command containing command_code:freqency:length:payload in 2:6:6:2 bits.
     uint8_t     rx_byte;                   // Last byte read from UART.
     dtm_event_t result;                    // Result of a DTM operation.
+    uint32_t    sweep_steps;               // Steps finished by the sweep.
+    bool        is_sweep_running  = false; // True while a sweep runs, to send its results when it ends.
 
     uart_init();
 
@@ -125,11 +222,29 @@ int main(void)
         return -1;
     }
 
+    dtm_error_code = dtm_sweep_config_set(&m_sweep_config, m_sweep_results, SWEEP_MAX_STEPS);
+    if (dtm_error_code != DTM_SUCCESS)
+    {
+        return -1;
+    }
+
     for (;;)
     {
         // Will return every timeout, 625 us.
         current_time = dtm_wait();
 
+        // Send the results after the sweep, when the UART is not in use by a command.
+        dtm_sweep_status_t sweep_status = dtm_sweep_status_get(&sweep_steps);
+        if ((sweep_status == DTM_SWEEP_SYNC) || (sweep_status == DTM_SWEEP_RUNNING))
+        {
+            is_sweep_running = true;
+        }
+        else if (is_sweep_running && !is_msb_read)
+        {
+            is_sweep_running = false;
+            sweep_results_put(sweep_status, sweep_steps);
+        }
+
         if (NRF_UART0->EVENTS_RXDRDY == 0)
         {
             // Nothing read from the UART.
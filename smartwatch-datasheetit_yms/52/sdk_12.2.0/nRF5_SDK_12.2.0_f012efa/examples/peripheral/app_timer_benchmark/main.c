@@ -0,0 +1,180 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ * @defgroup app_timer_benchmark_example_main main.c
+ * @{
+ * @ingroup app_timer_benchmark_example
+ * @brief Application Timer Benchmark Example Application main file.
+ *
+ * This file contains the source code for an application that measures the number of CPU cycles
+ * spent starting and stopping a timer while a growing number of other timers are running, using
+ * the DWT cycle counter. The SWI handler that orders the running timers preempts thread mode, so
+ * its cost is included. Build with APP_TIMER_CONFIG_BACKEND set to 0 or 1 to compare the list and
+ * heap backends. Results are printed using the logger module.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nrf.h"
+#include "nrf_delay.h"
+#include "app_error.h"
+#include "app_timer.h"
+
+#define NRF_LOG_MODULE_NAME "APP"
+#include "nrf_log.h"
+#include "nrf_log_ctrl.h"
+
+#define APP_TIMER_PRESCALER     0                                       /**< Value of the RTC1 PRESCALER register. */
+#define APP_TIMER_OP_QUEUE_SIZE 4                                       /**< Size of timer operation queues. */
+
+#define BENCHMARK_TIMERS        32                                      /**< Largest number of running timers measured. */
+#define BENCHMARK_ITERATIONS    16                                      /**< Number of start/stop pairs per measurement. */
+#define BACKGROUND_TIMEOUT      APP_TIMER_TICKS(10000, APP_TIMER_PRESCALER) /**< Base timeout of the timers running in the background. */
+#define MEASURED_TIMEOUT        APP_TIMER_TICKS(60000, APP_TIMER_PRESCALER) /**< Timeout of the measured timer. Expires after all others, which is the worst case for the list backend. */
+
+static app_timer_t m_timer_data[BENCHMARK_TIMERS];                      /**< Timer nodes, allocated as in @ref APP_TIMER_DEF. */
+
+
+/**@brief Function for starting the low-frequency clock, which drives the RTC.
+ */
+static void lfclk_start(void)
+{
+    NRF_CLOCK->LFCLKSRC            = (CLOCK_LFCLKSRC_SRC_Xtal << CLOCK_LFCLKSRC_SRC_Pos);
+    NRF_CLOCK->EVENTS_LFCLKSTARTED = 0;
+    NRF_CLOCK->TASKS_LFCLKSTART    = 1;
+
+    while (NRF_CLOCK->EVENTS_LFCLKSTARTED == 0)
+    {
+        // Do nothing.
+    }
+}
+
+
+/**@brief Function for enabling the DWT cycle counter.
+ */
+static void cycle_counter_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT       = 0;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+
+/**@brief Timeout handler. The timers are stopped before they expire.
+ */
+static void timeout_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+}
+
+
+/**@brief Function for measuring start and stop of one timer while other timers are running.
+ *
+ * @param[in]  background   Number of timers running in the background.
+ * @param[out] p_start      Average number of cycles spent in @ref app_timer_start.
+ * @param[out] p_stop       Average number of cycles spent in @ref app_timer_stop.
+ */
+static void measure(uint32_t background, uint32_t * p_start, uint32_t * p_stop)
+{
+    app_timer_id_t timer_id     = &m_timer_data[background];
+    uint32_t       start_cycles = 0;
+    uint32_t       stop_cycles  = 0;
+    uint32_t       err_code;
+
+    for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        uint32_t cycles = DWT->CYCCNT;
+
+        err_code = app_timer_start(timer_id, MEASURED_TIMEOUT, NULL);
+        APP_ERROR_CHECK(err_code);
+
+        start_cycles += DWT->CYCCNT - cycles;
+        cycles        = DWT->CYCCNT;
+
+        err_code = app_timer_stop(timer_id);
+        APP_ERROR_CHECK(err_code);
+
+        stop_cycles += DWT->CYCCNT - cycles;
+    }
+
+    *p_start = start_cycles / BENCHMARK_ITERATIONS;
+    *p_stop  = stop_cycles / BENCHMARK_ITERATIONS;
+}
+
+
+/**@brief Function for running the measurement for an increasing number of running timers and
+ *        printing the results.
+ */
+static void benchmark_run(void)
+{
+    uint32_t err_code;
+
+    NRF_LOG_INFO("%s backend:\r\n",
+                 (uint32_t)((APP_TIMER_CONFIG_BACKEND == APP_TIMER_BACKEND_HEAP) ? "Heap" : "List"));
+
+    for (uint32_t running = 0; running < BENCHMARK_TIMERS; running++)
+    {
+        uint32_t start;
+        uint32_t stop;
+
+        measure(running, &start, &stop);
+
+        NRF_LOG_INFO("  %2d running: start %d cycles, stop %d cycles\r\n", running, start, stop);
+        NRF_LOG_FLUSH();
+
+        // Add one more background timer. Interleave the timeouts so that insertions do not always
+        // go to the same end of the list.
+        err_code = app_timer_start(&m_timer_data[running],
+                                   BACKGROUND_TIMEOUT + ((running * 37) % BENCHMARK_TIMERS) * 100,
+                                   NULL);
+        APP_ERROR_CHECK(err_code);
+    }
+
+    err_code = app_timer_stop_all();
+    APP_ERROR_CHECK(err_code);
+}
+
+
+/**@brief Function for main application entry.
+ */
+int main(void)
+{
+    uint32_t err_code;
+
+    err_code = NRF_LOG_INIT(NULL);
+    APP_ERROR_CHECK(err_code);
+
+    lfclk_start();
+    cycle_counter_init();
+
+    APP_TIMER_INIT(APP_TIMER_PRESCALER, APP_TIMER_OP_QUEUE_SIZE, NULL);
+
+    for (uint32_t i = 0; i < BENCHMARK_TIMERS; i++)
+    {
+        app_timer_id_t timer_id = &m_timer_data[i];
+
+        err_code = app_timer_create(&timer_id, APP_TIMER_MODE_SINGLE_SHOT, timeout_handler);
+        APP_ERROR_CHECK(err_code);
+    }
+
+    NRF_LOG_INFO("Application timer benchmark example.\r\n");
+
+    while (true)
+    {
+        benchmark_run();
+        nrf_delay_ms(2000);
+    }
+}
+
+
+/** @} */
@@ -0,0 +1,155 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "bench.h"
+#include "nrf.h"
+#include "app_util.h"
+
+#define NRF_LOG_MODULE_NAME "BENCH"
+#include "nrf_log.h"
+#include "nrf_log_ctrl.h"
+
+static uint32_t m_samples[BENCH_MAX_ITERATIONS]; /**< Time of each run. */
+static uint32_t m_overhead;                      /**< Cost of a measurement of an empty function. */
+
+
+/**@brief Empty case, for measuring the cost of a measurement. */
+static void empty_run(void)
+{
+    __NOP();
+}
+
+
+void bench_init(void)
+{
+    bench_fn_t volatile fn = empty_run;
+    uint32_t            min = UINT32_MAX;
+
+#if defined(NRF51)
+    NRF_TIMER2->TASKS_STOP  = 1;
+    NRF_TIMER2->MODE        = TIMER_MODE_MODE_Timer;
+    NRF_TIMER2->BITMODE     = TIMER_BITMODE_BITMODE_16Bit << TIMER_BITMODE_BITMODE_Pos;
+    NRF_TIMER2->PRESCALER   = 0;
+    NRF_TIMER2->TASKS_CLEAR = 1;
+    NRF_TIMER2->TASKS_START = 1;
+#else
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT       = 0;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+    m_overhead = 0;
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        uint32_t start = bench_cycles_get();
+        fn();
+        uint32_t cycles = (bench_cycles_get() - start);
+
+        min = MIN(min, cycles);
+    }
+    m_overhead = min;
+}
+
+
+uint32_t bench_cycles_get(void)
+{
+#if defined(NRF51)
+    NRF_TIMER2->TASKS_CAPTURE[0] = 1;
+    return NRF_TIMER2->CC[0];
+#else
+    return DWT->CYCCNT;
+#endif
+}
+
+
+/**@brief Function for sorting the samples, for the median.
+ *
+ * @details Insertion sort, the samples are few and often nearly sorted.
+ */
+static void samples_sort(uint32_t * p_samples, uint32_t count)
+{
+    for (uint32_t i = 1; i < count; i++)
+    {
+        uint32_t value = p_samples[i];
+        uint32_t j     = i;
+
+        while ((j > 0) && (p_samples[j - 1] > value))
+        {
+            p_samples[j] = p_samples[j - 1];
+            j--;
+        }
+        p_samples[j] = value;
+    }
+}
+
+
+ret_code_t bench_run(bench_case_t const * p_case, bench_result_t * p_result)
+{
+    uint32_t iterations = (p_case->iterations == 0) ? BENCH_MAX_ITERATIONS : p_case->iterations;
+
+    if (iterations > BENCH_MAX_ITERATIONS)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if (p_case->setup != NULL)
+    {
+        p_case->setup();
+    }
+
+    for (uint32_t i = 0; i < BENCH_WARMUP_ITERATIONS; i++)
+    {
+        p_case->run();
+        if (p_case->after_run != NULL)
+        {
+            p_case->after_run();
+        }
+    }
+
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        uint32_t start = bench_cycles_get();
+        p_case->run();
+        uint32_t cycles = bench_cycles_get() - start;
+
+#if defined(NRF51)
+        cycles &= 0xFFFF;
+#endif
+        m_samples[i] = (cycles > m_overhead) ? (cycles - m_overhead) : 0;
+
+        if (p_case->after_run != NULL)
+        {
+            p_case->after_run();
+        }
+    }
+
+    samples_sort(m_samples, iterations);
+
+    p_result->min        = m_samples[0];
+    p_result->median     = m_samples[iterations / 2];
+    p_result->max        = m_samples[iterations - 1];
+    p_result->iterations = iterations;
+
+    return NRF_SUCCESS;
+}
+
+
+void bench_result_log(bench_case_t const * p_case, bench_result_t const * p_result)
+{
+    NRF_LOG_INFO("bench %s n=%d min=%d med=%d max=%d\r\n",
+                 (uint32_t)p_case->p_name,
+                 p_result->iterations,
+                 p_result->min,
+                 p_result->median,
+                 p_result->max);
+    NRF_LOG_FLUSH();
+}
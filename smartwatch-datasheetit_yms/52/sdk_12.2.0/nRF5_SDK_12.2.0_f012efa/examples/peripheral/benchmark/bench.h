@@ -0,0 +1,104 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ * @defgroup benchmark_example_harness bench.h
+ * @{
+ * @ingroup benchmark_example
+ * @brief Micro-benchmark harness of the benchmark example.
+ *
+ * A case is a function that is run a number of times. After a few warm-up runs, which fill the
+ * cache and take the first-call paths, every run is timed on its own. The minimum, median and
+ * maximum are reported, in CPU cycles, without the cost of the measurement itself.
+ *
+ * The time base is the DWT cycle counter on nRF52. nRF51 has no DWT, so TIMER2 runs at 16 MHz,
+ * which is the CPU clock. TIMER2 of nRF51 is 16 bits wide, so a run must take less than
+ * 65536 cycles (4 ms).
+ *
+ * Interrupts stay enabled, so that the libraries that defer work to an interrupt (for example
+ * @ref app_timer) are measured with that work. The maximum shows the runs that were also
+ * interrupted by something else.
+ */
+
+#ifndef BENCH_H__
+#define BENCH_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BENCH_WARMUP_ITERATIONS 2   /**< Runs of a case before the measurement. */
+#define BENCH_MAX_ITERATIONS    64  /**< Largest number of measured runs of a case. */
+
+/**@brief Function of a case. */
+typedef void (*bench_fn_t)(void);
+
+/**@brief A case. */
+typedef struct
+{
+    char const * p_name;     /**< Name of the case, without spaces. */
+    bench_fn_t   setup;      /**< Called once before the warm-up, not measured. Can be NULL. */
+    bench_fn_t   run;        /**< The measured function. */
+    bench_fn_t   after_run;  /**< Called after every run, not measured. Can be NULL. */
+    uint32_t     iterations; /**< Measured runs. 0 for @ref BENCH_MAX_ITERATIONS. */
+} bench_case_t;
+
+/**@brief Result of a case, in CPU cycles. */
+typedef struct
+{
+    uint32_t min;        /**< Fastest run. */
+    uint32_t median;     /**< Median run. */
+    uint32_t max;        /**< Slowest run. */
+    uint32_t iterations; /**< Measured runs. */
+} bench_result_t;
+
+
+/**@brief Function for starting the time base and measuring the cost of a measurement. */
+void bench_init(void);
+
+
+/**@brief Function for reading the time base, in CPU cycles.
+ *
+ * @note Wraps at 2^16 on nRF51.
+ */
+uint32_t bench_cycles_get(void);
+
+
+/**@brief Function for running a case.
+ *
+ * @param[in]  p_case   Case.
+ * @param[out] p_result Result.
+ *
+ * @retval NRF_SUCCESS             If the case was run.
+ * @retval NRF_ERROR_INVALID_PARAM If the case has more than @ref BENCH_MAX_ITERATIONS runs.
+ */
+ret_code_t bench_run(bench_case_t const * p_case, bench_result_t * p_result);
+
+
+/**@brief Function for logging the result of a case.
+ *
+ * @details The line has the form "bench <name> n=<runs> min=<cycles> med=<cycles> max=<cycles>",
+ *          so that it can be collected from RTT by a script and compared between builds.
+ */
+void bench_result_log(bench_case_t const * p_case, bench_result_t const * p_result);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BENCH_H__
+
+/** @} */
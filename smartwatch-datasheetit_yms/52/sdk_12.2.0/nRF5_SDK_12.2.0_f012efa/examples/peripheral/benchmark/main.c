@@ -0,0 +1,430 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ * @defgroup benchmark_example_main main.c
+ * @{
+ * @ingroup benchmark_example
+ * @brief Library Benchmark Example Application main file.
+ *
+ * This file contains the source code for an application that measures the hot functions of the
+ * core libraries with the harness in bench.h: nrf_queue, nrf_balloc, app_fifo, app_scheduler,
+ * app_timer, crc16, crc32, sha256, fds and nrf_log. Every case prints one line with the minimum,
+ * median and maximum number of CPU cycles. Use the RTT backend of the logger, so that the
+ * output does not disturb the measurements.
+ *
+ * The SoftDevice is enabled for the flash operations of fds, and for the low-frequency clock.
+ * BLE is not enabled.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "nrf.h"
+#include "nrf_delay.h"
+#include "boards.h"
+#include "app_error.h"
+#include "app_util.h"
+#include "softdevice_handler.h"
+#include "nrf_queue.h"
+#include "nrf_balloc.h"
+#include "app_fifo.h"
+#include "app_scheduler.h"
+#include "app_timer.h"
+#include "crc16.h"
+#include "crc32.h"
+#include "sha256.h"
+#include "fstorage.h"
+#include "fds.h"
+#include "bench.h"
+
+#define NRF_LOG_MODULE_NAME "APP"
+#include "nrf_log.h"
+#include "nrf_log_ctrl.h"
+
+#define APP_TIMER_PRESCALER     0                                       /**< Value of the RTC1 PRESCALER register. */
+#define APP_TIMER_OP_QUEUE_SIZE 4                                       /**< Size of timer operation queues. */
+#define TIMER_TIMEOUT           APP_TIMER_TICKS(60000, APP_TIMER_PRESCALER) /**< Timeout of the measured timer. It is stopped before it expires. */
+
+#define SCHED_MAX_EVENT_SIZE    8                                       /**< Size of the events of the scheduler. */
+#define SCHED_QUEUE_SIZE        8                                       /**< Size of the queue of the scheduler. */
+
+#define QUEUE_SIZE              32                                      /**< Elements in the queues. */
+#define QUEUE_BLOCK_LEN         16                                      /**< Elements moved by one write or read. */
+#define FIFO_SIZE               256                                     /**< Size of the FIFO. Must be a power of two. */
+#define FIFO_BLOCK_LEN          64                                      /**< Bytes moved by one write or read. */
+#define BALLOC_ELEMENT_SIZE     32                                      /**< Size of a block of the allocator. */
+#define BALLOC_POOL_SIZE        8                                       /**< Blocks in the allocator. */
+
+#if defined(NRF51)
+#define PLATFORM_NAME           "nRF51"                                 /**< Printed before the results. */
+#define DATA_LEN                64                                      /**< Bytes of the CRC and hash cases, short enough for the 16-bit timer. */
+#else
+#define PLATFORM_NAME           "nRF52"                                 /**< Printed before the results. */
+#define DATA_LEN                256                                     /**< Bytes of the CRC and hash cases. */
+#endif
+
+#define FDS_FILE                0x4200                                  /**< File of the fds cases. */
+#define FDS_KEY                 0x0042                                  /**< Record key of the records found by the fds cases. */
+#define FDS_FILLER_KEY          0x0043                                  /**< Record key of the records in front of them. */
+#define FDS_FILLER_RECORDS      16                                      /**< Records written before the ones found. */
+#define FDS_RECORD_WORDS        4                                       /**< Size of the records, in words. */
+#define FDS_WRITE_ITERATIONS    16                                      /**< Measured writes, rewritten on every loop. */
+
+#define LOG_ITERATIONS          16                                      /**< Measured log calls. Each one prints a line. */
+
+#define CENTRAL_LINK_COUNT      0                                       /**< Number of central links, the BLE stack is not enabled. */
+#define PERIPHERAL_LINK_COUNT   0                                       /**< Number of peripheral links, the BLE stack is not enabled. */
+
+NRF_QUEUE_DEF(uint32_t, m_queue, QUEUE_SIZE, NRF_QUEUE_MODE_NO_OVERFLOW);
+NRF_QUEUE_SPSC_DEF(uint32_t, m_queue_spsc, QUEUE_SIZE);
+NRF_BALLOC_DEF(m_balloc, BALLOC_ELEMENT_SIZE, BALLOC_POOL_SIZE);
+APP_TIMER_DEF(m_timer_id);
+
+static app_fifo_t        m_fifo;
+static uint8_t           m_fifo_buf[FIFO_SIZE];
+static uint8_t           m_data[DATA_LEN] __ALIGN(4);
+static uint32_t          m_block[QUEUE_BLOCK_LEN];
+static uint32_t          m_record_data[FDS_RECORD_WORDS];
+static fds_record_desc_t m_record_desc;
+static uint32_t volatile m_sink;                                        /**< Results of the cases, so that they are not optimized away. */
+static bool volatile     m_fds_busy;                                    /**< An fds operation is in progress. */
+static ret_code_t        m_fds_result;                                  /**< Result of the last fds operation. */
+
+
+/**@brief Function for handling the events of fds. */
+static void fds_evt_handler(fds_evt_t const * const p_evt)
+{
+    m_fds_result = p_evt->result;
+    m_fds_busy   = false;
+}
+
+
+/**@brief Function for waiting until the fds operation in progress is done. */
+static void fds_wait(void)
+{
+    while (m_fds_busy)
+    {
+        (void)sd_app_evt_wait();
+    }
+    APP_ERROR_CHECK(m_fds_result);
+}
+
+
+/**@brief Function for writing a record and waiting until it is written. */
+static void fds_write_sync(uint16_t key)
+{
+    fds_record_chunk_t chunk  = {.p_data = m_record_data, .length_words = FDS_RECORD_WORDS};
+    fds_record_t       record = {.file_id = FDS_FILE, .key = key, .data = {.p_chunks = &chunk, .num_chunks = 1}};
+    fds_record_desc_t  desc;
+
+    m_fds_busy = true;
+    APP_ERROR_CHECK(fds_record_write(&desc, &record));
+    fds_wait();
+}
+
+
+/**@brief Function for deleting the records of the cases and collecting the garbage. */
+static void fds_clean(void)
+{
+    m_fds_busy = true;
+    APP_ERROR_CHECK(fds_file_delete(FDS_FILE));
+    fds_wait();
+
+    m_fds_busy = true;
+    APP_ERROR_CHECK(fds_gc());
+    fds_wait();
+}
+
+
+static void queue_push_pop(void)
+{
+    uint32_t value = m_sink;
+
+    (void)nrf_queue_push(&m_queue, &value);
+    (void)nrf_queue_pop(&m_queue, &value);
+    m_sink = value;
+}
+
+
+static void queue_spsc_push_pop(void)
+{
+    uint32_t value = m_sink;
+
+    (void)nrf_queue_push(&m_queue_spsc, &value);
+    (void)nrf_queue_pop(&m_queue_spsc, &value);
+    m_sink = value;
+}
+
+
+static void queue_write_read(void)
+{
+    (void)nrf_queue_write(&m_queue, m_block, QUEUE_BLOCK_LEN);
+    (void)nrf_queue_read(&m_queue, m_block, QUEUE_BLOCK_LEN);
+}
+
+
+static void balloc_setup(void)
+{
+    APP_ERROR_CHECK(nrf_balloc_init(&m_balloc));
+}
+
+
+static void balloc_alloc_free(void)
+{
+    void * p_block = nrf_balloc_alloc(&m_balloc);
+
+    nrf_balloc_free(&m_balloc, p_block);
+    m_sink = (uint32_t)p_block;
+}
+
+
+static void fifo_setup(void)
+{
+    APP_ERROR_CHECK(app_fifo_init(&m_fifo, m_fifo_buf, sizeof(m_fifo_buf)));
+}
+
+
+static void fifo_put_get(void)
+{
+    uint8_t byte = (uint8_t)m_sink;
+
+    (void)app_fifo_put(&m_fifo, byte);
+    (void)app_fifo_get(&m_fifo, &byte);
+    m_sink = byte;
+}
+
+
+static void fifo_write_read(void)
+{
+    uint32_t len = FIFO_BLOCK_LEN;
+
+    (void)app_fifo_write(&m_fifo, m_data, &len);
+    len = FIFO_BLOCK_LEN;
+    (void)app_fifo_read(&m_fifo, m_data, &len);
+}
+
+
+static void sched_evt_handler(void * p_event_data, uint16_t event_size)
+{
+    m_sink += event_size;
+}
+
+
+static void sched_put_execute(void)
+{
+    uint32_t evt[2] = {0};
+
+    (void)app_sched_event_put(evt, sizeof(evt), sched_evt_handler);
+    app_sched_execute();
+}
+
+
+static void timer_timeout_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+}
+
+
+static void timer_start_stop(void)
+{
+    (void)app_timer_start(m_timer_id, TIMER_TIMEOUT, NULL);
+    (void)app_timer_stop(m_timer_id);
+}
+
+
+static void crc16_run(void)
+{
+    m_sink = crc16_compute(m_data, DATA_LEN, NULL);
+}
+
+
+static void crc32_run(void)
+{
+    m_sink = crc32_compute(m_data, DATA_LEN, NULL);
+}
+
+
+static void sha256_run(void)
+{
+    sha256_context_t ctx;
+    uint8_t          hash[32];
+
+    (void)sha256_init(&ctx);
+    (void)sha256_update(&ctx, m_data, DATA_LEN);
+    (void)sha256_final(&ctx, hash, 0);
+    m_sink = hash[0];
+}
+
+
+/**@brief Function for writing the records that the find cases look for, behind other records. */
+static void fds_find_setup(void)
+{
+    fds_clean();
+
+    for (uint32_t i = 0; i < FDS_FILLER_RECORDS; i++)
+    {
+        fds_write_sync(FDS_FILLER_KEY);
+    }
+    fds_write_sync(FDS_KEY);
+}
+
+
+static void fds_find(void)
+{
+    fds_find_token_t token;
+
+    memset(&token, 0x00, sizeof(token));
+    (void)fds_record_find(FDS_FILE, FDS_KEY, &m_record_desc, &token);
+}
+
+
+static void fds_open_close(void)
+{
+    fds_flash_record_t record;
+
+    (void)fds_record_open(&m_record_desc, &record);
+    (void)fds_record_close(&m_record_desc);
+}
+
+
+static void fds_write_setup(void)
+{
+    fds_clean();
+}
+
+
+/**@brief Measures the queuing of a write, the flash operation itself runs in the SoftDevice. */
+static void fds_write(void)
+{
+    fds_record_chunk_t chunk  = {.p_data = m_record_data, .length_words = FDS_RECORD_WORDS};
+    fds_record_t       record = {.file_id = FDS_FILE, .key = FDS_KEY, .data = {.p_chunks = &chunk, .num_chunks = 1}};
+    fds_record_desc_t  desc;
+
+    m_fds_busy = (fds_record_write(&desc, &record) == FDS_SUCCESS);
+}
+
+
+static void log_run(void)
+{
+    NRF_LOG_INFO("log %d %d\r\n", m_sink, DATA_LEN);
+}
+
+
+static void log_after_run(void)
+{
+    NRF_LOG_FLUSH();
+}
+
+
+static const bench_case_t m_cases[] =
+{
+    {"nrf_queue_push_pop",      NULL,            queue_push_pop,      NULL,          0},
+    {"nrf_queue_spsc_push_pop", NULL,            queue_spsc_push_pop, NULL,          0},
+    {"nrf_queue_write_read_16", NULL,            queue_write_read,    NULL,          0},
+    {"nrf_balloc_alloc_free",   balloc_setup,    balloc_alloc_free,   NULL,          0},
+    {"app_fifo_put_get",        fifo_setup,      fifo_put_get,        NULL,          0},
+    {"app_fifo_write_read_64",  fifo_setup,      fifo_write_read,     NULL,          0},
+    {"app_sched_put_execute",   NULL,            sched_put_execute,   NULL,          0},
+    {"app_timer_start_stop",    NULL,            timer_start_stop,    NULL,          0},
+    {"crc16_compute",           NULL,            crc16_run,           NULL,          0},
+    {"crc32_compute",           NULL,            crc32_run,           NULL,          0},
+    {"sha256",                  NULL,            sha256_run,          NULL,          0},
+    {"fds_record_find",         fds_find_setup,  fds_find,            NULL,          0},
+    {"fds_record_open_close",   NULL,            fds_open_close,      NULL,          0},
+    {"fds_record_write",        fds_write_setup, fds_write,           fds_wait,      FDS_WRITE_ITERATIONS},
+    {"nrf_log_info",            NULL,            log_run,             log_after_run, LOG_ITERATIONS},
+};
+
+
+/**@brief Function for dispatching a system event to the modules that use them.
+ */
+static void sys_evt_dispatch(uint32_t sys_evt)
+{
+    fs_sys_event_handler(sys_evt);
+}
+
+
+/**@brief Function for enabling the SoftDevice, without the BLE stack.
+ */
+static void softdevice_init(void)
+{
+    uint32_t err_code;
+
+    nrf_clock_lf_cfg_t clock_lf_cfg = NRF_CLOCK_LFCLKSRC;
+
+    SOFTDEVICE_HANDLER_INIT(&clock_lf_cfg, NULL);
+
+    err_code = softdevice_sys_evt_handler_set(sys_evt_dispatch);
+    APP_ERROR_CHECK(err_code);
+}
+
+
+/**@brief Function for running all cases and printing the results.
+ */
+static void benchmark_run(void)
+{
+    NRF_LOG_INFO("%s, %d Hz, data %d bytes:\r\n", (uint32_t)PLATFORM_NAME, SystemCoreClock, DATA_LEN);
+    NRF_LOG_FLUSH();
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(m_cases); i++)
+    {
+        bench_result_t result;
+
+        APP_ERROR_CHECK(bench_run(&m_cases[i], &result));
+        bench_result_log(&m_cases[i], &result);
+    }
+}
+
+
+/**@brief Function for main application entry.
+ */
+int main(void)
+{
+    uint32_t err_code;
+
+    err_code = NRF_LOG_INIT(NULL);
+    APP_ERROR_CHECK(err_code);
+
+    softdevice_init();
+
+    APP_TIMER_INIT(APP_TIMER_PRESCALER, APP_TIMER_OP_QUEUE_SIZE, NULL);
+    err_code = app_timer_create(&m_timer_id, APP_TIMER_MODE_SINGLE_SHOT, timer_timeout_handler);
+    APP_ERROR_CHECK(err_code);
+
+    APP_SCHED_INIT(SCHED_MAX_EVENT_SIZE, SCHED_QUEUE_SIZE);
+
+    err_code = fds_register(fds_evt_handler);
+    APP_ERROR_CHECK(err_code);
+    m_fds_busy = true;
+    err_code   = fds_init();
+    APP_ERROR_CHECK(err_code);
+    fds_wait();
+
+    for (uint32_t i = 0; i < sizeof(m_data); i++)
+    {
+        m_data[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    bench_init();
+
+    NRF_LOG_INFO("Library benchmark example.\r\n");
+
+    while (true)
+    {
+        benchmark_run();
+        nrf_delay_ms(2000);
+    }
+}
+
+
+/** @} */
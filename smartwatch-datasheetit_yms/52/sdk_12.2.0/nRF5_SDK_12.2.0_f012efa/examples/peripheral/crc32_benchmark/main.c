@@ -0,0 +1,147 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ * @defgroup crc32_benchmark_example_main main.c
+ * @{
+ * @ingroup crc32_benchmark_example
+ * @brief CRC32 Benchmark Example Application main file.
+ *
+ * This file contains the source code for an application that measures the number of CPU cycles
+ * per byte spent by each CRC-32 engine, using the DWT cycle counter. Results are printed
+ * using the logger module.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nrf.h"
+#include "nrf_delay.h"
+#include "app_error.h"
+#include "crc32.h"
+
+#define NRF_LOG_MODULE_NAME "APP"
+#include "nrf_log.h"
+#include "nrf_log_ctrl.h"
+
+#define BENCHMARK_BUFFER_SIZE   1024    /**< Size of the buffer to calculate the CRC over, in bytes. */
+#define BENCHMARK_ITERATIONS    16      /**< Number of times each engine is run per measurement. */
+
+typedef uint32_t (*crc32_engine_t)(uint8_t const * p_data, uint32_t size, uint32_t const * p_crc);
+
+typedef struct
+{
+    char const *   p_name;
+    crc32_engine_t engine;
+} crc32_benchmark_t;
+
+static const crc32_benchmark_t m_benchmarks[] =
+{
+    {"bitwise",    crc32_compute_bitwise},
+    {"nibble",     crc32_compute_nibble},
+    {"slice-by-4", crc32_compute_slice_by_4},
+};
+
+static uint8_t m_buffer[BENCHMARK_BUFFER_SIZE + 1] __ALIGN(4);  /**< One byte extra for the unaligned run. */
+
+
+/**@brief Function for enabling the DWT cycle counter.
+ */
+static void cycle_counter_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT       = 0;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+
+/**@brief Function for measuring one engine.
+ *
+ * @param[in]  engine  Engine to measure.
+ * @param[in]  p_data  Data to calculate the CRC over.
+ * @param[out] p_crc   Resulting CRC, used for verifying that all engines agree.
+ *
+ * @return Number of cycles per byte, multiplied by 100.
+ */
+static uint32_t cycles_per_byte_x100(crc32_engine_t engine, uint8_t const * p_data, uint32_t * p_crc)
+{
+    uint32_t start = DWT->CYCCNT;
+
+    for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        *p_crc = engine(p_data, BENCHMARK_BUFFER_SIZE, NULL);
+    }
+
+    uint32_t cycles = DWT->CYCCNT - start;
+
+    return (cycles * 100) / (BENCHMARK_ITERATIONS * BENCHMARK_BUFFER_SIZE);
+}
+
+
+/**@brief Function for running all engines on aligned or unaligned data and printing the results.
+ */
+static void benchmark_run(bool aligned)
+{
+    uint8_t const * p_data    = aligned ? &m_buffer[0] : &m_buffer[1];
+    uint32_t        reference = 0;
+
+    NRF_LOG_INFO("%s buffer, %d bytes:\r\n", (uint32_t)(aligned ? "Aligned" : "Unaligned"),
+                 BENCHMARK_BUFFER_SIZE);
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(m_benchmarks); i++)
+    {
+        uint32_t crc;
+        uint32_t result = cycles_per_byte_x100(m_benchmarks[i].engine, p_data, &crc);
+
+        if (i == 0)
+        {
+            reference = crc;
+        }
+
+        NRF_LOG_INFO("  %s: %d.%02d cycles/byte, CRC 0x%08x%s\r\n",
+                     (uint32_t)m_benchmarks[i].p_name,
+                     result / 100,
+                     result % 100,
+                     crc,
+                     (uint32_t)((crc == reference) ? "" : " MISMATCH"));
+        NRF_LOG_FLUSH();
+    }
+}
+
+
+/**@brief Function for main application entry.
+ */
+int main(void)
+{
+    uint32_t err_code;
+
+    err_code = NRF_LOG_INIT(NULL);
+    APP_ERROR_CHECK(err_code);
+
+    for (uint32_t i = 0; i < sizeof(m_buffer); i++)
+    {
+        m_buffer[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    cycle_counter_init();
+
+    NRF_LOG_INFO("CRC32 benchmark example.\r\n");
+
+    while (true)
+    {
+        benchmark_run(true);
+        benchmark_run(false);
+        nrf_delay_ms(2000);
+    }
+}
+
+
+/** @} */
@@ -28,6 +28,7 @@
 #include "bsp.h"
 #include "nrf.h"
 #include "radio_test.h"
+#include "radio_bench.h"
 #include "app_uart.h"
 #include "app_error.h"
 #include "nordic_common.h"
@@ -97,11 +98,17 @@ static void help(void)
     printf("d: Enter time on each channel (1ms-99ms)\r\n");
     printf("e: Cancel sweep/carrier\r\n");
     printf("m: Enter data rate\r\n");
+#ifndef NRF51
+    printf("n: Start benchmark transmitter on the start channel\r\n");
+#endif
     printf("o: Start modulated TX carrier\r\n");
     printf("p: Enter output power\r\n");
     printf("s: Print current delay, channels and so on\r\n");
     printf("r: Start RX sweep\r\n");
     printf("t: Start TX sweep\r\n");
+#ifndef NRF51
+    printf("v: Start benchmark receiver on the start channel\r\n");
+#endif
     printf("x: Start RX carrier\r\n");
 }
 
@@ -270,6 +277,82 @@ void print_parameters(void)
 }
 
 
+#ifndef NRF51
+/** @brief Function for stopping the benchmark when 'e' is received.
+*/
+static bool bench_abort(void)
+{
+    uint8_t c;
+
+    return (app_uart_get(&c) == NRF_SUCCESS) && (c == 'e');
+}
+
+
+/** @brief Function for printing the result of a benchmark step as a CSV line.
+ *
+ * Packets per second are counted over the burst on the transmitter, and between the first and the
+ * last packet received on the receiver. The packet error rate is in permille.
+*/
+static void bench_report(radio_bench_result_t const * p_result)
+{
+    static uint16_t const kbps[] =
+    {
+        [RADIO_MODE_MODE_Nrf_1Mbit]   = 1000,
+        [RADIO_MODE_MODE_Nrf_2Mbit]   = 2000,
+        [RADIO_MODE_MODE_Nrf_250Kbit] = 250,
+    };
+    uint32_t pps = 0;
+    uint32_t per = 0;
+
+    if (p_result->received == 0)
+    {
+        // Transmitter.
+        pps = (uint32_t)(((uint64_t)p_result->sent * 1000000) / MAX(p_result->time_us, 1));
+    }
+    else
+    {
+        pps = (uint32_t)(((uint64_t)(p_result->received - 1) * 1000000) / MAX(p_result->time_us, 1));
+    }
+    if (p_result->sent > 0)
+    {
+        per = ((uint32_t)(p_result->sent - MIN(p_result->received, p_result->sent)) * 1000) /
+              p_result->sent;
+    }
+
+    printf("%d,%d,%d,%s,%d,%d,%d,%ld,%ld,%ld\r\n",
+           p_result->index,
+           kbps[p_result->step.mode],
+           p_result->step.length,
+           p_result->step.fast_ramp_up ? "fast" : "default",
+           (int8_t)p_result->step.txpower,
+           p_result->sent,
+           p_result->received,
+           (long)per,
+           (long)pps,
+           (long)((pps * p_result->step.length * 8) / 1000));
+}
+
+
+/** @brief Function for running the benchmark as the transmitter or the receiver.
+*/
+static void bench_run(bool tx)
+{
+    printf("Benchmark %s on channel %d, %d steps, 'e' to stop\r\n",
+           tx ? "transmitter" : "receiver", channel_start_, radio_bench_step_count());
+    printf("step,kbit/s,length,ramp-up,dBm,sent,received,per_permille,packets/s,payload_kbit/s\r\n");
+    if (tx)
+    {
+        radio_bench_tx_run(channel_start_, bench_report, bench_abort);
+    }
+    else
+    {
+        radio_bench_rx_run(channel_start_, bench_report, bench_abort);
+    }
+    printf("Benchmark done\r\n");
+}
+#endif // NRF51
+
+
 /** @brief Function for main application entry.
  */
 int main(void)
@@ -367,6 +450,21 @@ int main(void)
                 test = cur_test;
                 break;
 
+#ifndef NRF51
+            case 'n':
+                // Fall through.
+            case 'v':
+                if (sweep)
+                {
+                    radio_sweep_end();
+                    sweep = false;
+                }
+                bench_run(control == 'n');
+                cur_test = RADIO_TEST_NOP;
+                test     = RADIO_TEST_NOP;
+                break;
+#endif
+
             case 'o':
                 test = RADIO_TEST_TXMC;
                 printf("TX modulated carrier\r\n");
@@ -0,0 +1,373 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+/** @file
+* @addtogroup nrf_radio_test_example_main
+* @{
+*/
+
+#include "radio_bench.h"
+#include <stdbool.h>
+#include "nrf.h"
+#include "boards.h"
+#include "nordic_common.h"
+#include "app_util.h"
+
+#ifndef NRF51
+
+#define BENCH_PACKET_ANNOUNCE       0xA5    /**< Type of the packet announcing a step. */
+#define BENCH_PACKET_DATA           0x5A    /**< Type of the packets of a burst. */
+#define BENCH_HEADER_LENGTH         4       /**< Type, step index and 16 bit sequence number. */
+
+#define BENCH_ANNOUNCE_REPEAT       3       /**< Announcements sent for each step. */
+#define BENCH_GUARD_US              2000    /**< Time between the announcement and the burst, for the receiver to switch. */
+#define BENCH_IDLE_TIMEOUT_US       20000   /**< Time without packet that ends a step on the receiver. Longer than a 255 byte packet at 250 kbit/s. */
+#define BENCH_STEP_GAP_US           50000   /**< Time between two steps on the transmitter. */
+
+#define BENCH_PPI_CH_READY          0       /**< PPI channel setting the packet marker. */
+#define BENCH_PPI_CH_END            1       /**< PPI channel clearing the packet marker. */
+#define BENCH_GPIOTE_CH             0       /**< GPIOTE channel of the packet marker. */
+
+static uint8_t const m_modes[]    = {RADIO_MODE_MODE_Nrf_250Kbit,
+                                     RADIO_MODE_MODE_Nrf_1Mbit,
+                                     RADIO_MODE_MODE_Nrf_2Mbit};
+static uint8_t const m_lengths[]  = {8, 32, 128, 255};
+static uint8_t const m_txpowers[] = {RADIO_TXPOWER_TXPOWER_Pos4dBm,
+                                     RADIO_TXPOWER_TXPOWER_0dBm,
+                                     RADIO_TXPOWER_TXPOWER_Neg8dBm,
+                                     RADIO_TXPOWER_TXPOWER_Neg20dBm};
+
+#define BENCH_RAMP_UP_COUNT 2       /**< Default and fast ramp-up. */
+#define BENCH_STEP_COUNT    (ARRAY_SIZE(m_modes) * ARRAY_SIZE(m_lengths) * \
+                             BENCH_RAMP_UP_COUNT * ARRAY_SIZE(m_txpowers))
+
+/** Settings of the announcements. */
+static radio_bench_step_t const m_control =
+{
+    .mode         = RADIO_MODE_MODE_Nrf_1Mbit,
+    .length       = BENCH_HEADER_LENGTH,
+    .fast_ramp_up = false,
+    .txpower      = RADIO_TXPOWER_TXPOWER_0dBm,
+};
+
+static uint8_t packet[256];
+
+
+/**
+ * @brief Function for getting the settings of a step. The output power changes fastest, then the
+ * ramp-up, the payload length and the data rate.
+*/
+static void step_get(uint8_t index, radio_bench_step_t * p_step)
+{
+    p_step->txpower      = m_txpowers[index % ARRAY_SIZE(m_txpowers)];
+    index               /= ARRAY_SIZE(m_txpowers);
+    p_step->fast_ramp_up = (index % BENCH_RAMP_UP_COUNT) != 0;
+    index               /= BENCH_RAMP_UP_COUNT;
+    p_step->length       = m_lengths[index % ARRAY_SIZE(m_lengths)];
+    index               /= ARRAY_SIZE(m_lengths);
+    p_step->mode         = m_modes[index];
+}
+
+
+/**
+ * @brief Function for starting Timer 1 as a free running 32 bit timer with 1 us resolution.
+*/
+static void timer1_init(void)
+{
+    NRF_TIMER1->TASKS_STOP  = 1;
+    NRF_TIMER1->SHORTS      = 0;
+    NRF_TIMER1->INTENCLR    = 0xFFFFFFFF;
+    NRF_TIMER1->MODE        = TIMER_MODE_MODE_Timer;
+    NRF_TIMER1->BITMODE     = (TIMER_BITMODE_BITMODE_32Bit << TIMER_BITMODE_BITMODE_Pos);
+    NRF_TIMER1->PRESCALER   = 4;  // 1us resolution
+    NRF_TIMER1->TASKS_CLEAR = 1;
+    NRF_TIMER1->TASKS_START = 1;
+}
+
+
+static uint32_t timer1_now(void)
+{
+    NRF_TIMER1->TASKS_CAPTURE[0] = 1;
+    return NRF_TIMER1->CC[0];
+}
+
+
+static void timer1_wait(uint32_t time_us)
+{
+    uint32_t start = timer1_now();
+
+    while ((timer1_now() - start) < time_us)
+    {
+        // Do nothing.
+    }
+}
+
+
+/**
+ * @brief Function for configuring the marker pins. The packet marker is set on READY, when the
+ * ramp-up is over and the packet starts, and cleared on END.
+*/
+static void markers_init(void)
+{
+    NRF_GPIO->DIRSET = (1UL << RADIO_BENCH_STEP_PIN);
+    NRF_GPIO->OUTCLR = (1UL << RADIO_BENCH_STEP_PIN);
+
+    NRF_GPIOTE->CONFIG[BENCH_GPIOTE_CH] = (GPIOTE_CONFIG_MODE_Task << GPIOTE_CONFIG_MODE_Pos) |
+                                          (RADIO_BENCH_PACKET_PIN << GPIOTE_CONFIG_PSEL_Pos) |
+                                          (GPIOTE_CONFIG_POLARITY_LoToHi << GPIOTE_CONFIG_POLARITY_Pos) |
+                                          (GPIOTE_CONFIG_OUTINIT_Low << GPIOTE_CONFIG_OUTINIT_Pos);
+
+    NRF_PPI->CH[BENCH_PPI_CH_READY].EEP = (uint32_t)&NRF_RADIO->EVENTS_READY;
+    NRF_PPI->CH[BENCH_PPI_CH_READY].TEP = (uint32_t)&NRF_GPIOTE->TASKS_SET[BENCH_GPIOTE_CH];
+    NRF_PPI->CH[BENCH_PPI_CH_END].EEP   = (uint32_t)&NRF_RADIO->EVENTS_END;
+    NRF_PPI->CH[BENCH_PPI_CH_END].TEP   = (uint32_t)&NRF_GPIOTE->TASKS_CLR[BENCH_GPIOTE_CH];
+    NRF_PPI->CHENSET                    = (1UL << BENCH_PPI_CH_READY) | (1UL << BENCH_PPI_CH_END);
+}
+
+
+static void markers_uninit(void)
+{
+    NRF_PPI->CHENCLR                    = (1UL << BENCH_PPI_CH_READY) | (1UL << BENCH_PPI_CH_END);
+    NRF_GPIOTE->CONFIG[BENCH_GPIOTE_CH] = 0;
+    NRF_GPIO->OUTCLR                    = (1UL << RADIO_BENCH_STEP_PIN);
+}
+
+
+static void radio_disable(void)
+{
+    NRF_RADIO->SHORTS          = 0;
+    NRF_RADIO->EVENTS_DISABLED = 0;
+    NRF_RADIO->TASKS_DISABLE   = 1;
+    while (NRF_RADIO->EVENTS_DISABLED == 0)
+    {
+        // Do nothing.
+    }
+    NRF_RADIO->EVENTS_DISABLED = 0;
+}
+
+
+/**
+ * @brief Function for configuring the radio for a step. Both nodes use the same fixed address, a
+ * 8 bit length field, whitening and a 16 bit CRC.
+*/
+static void radio_setup(radio_bench_step_t const * p_step, uint8_t channel)
+{
+    radio_disable();
+
+    NRF_RADIO->PREFIX0     = 0xC0;
+    NRF_RADIO->BASE0       = 0x5A5AE1E1;
+    NRF_RADIO->TXADDRESS   = 0x00UL;
+    NRF_RADIO->RXADDRESSES = 0x01UL;
+
+    NRF_RADIO->PCNF0  = (0UL << RADIO_PCNF0_S1LEN_Pos) |
+                        (0UL << RADIO_PCNF0_S0LEN_Pos) |
+                        (8UL << RADIO_PCNF0_LFLEN_Pos);
+    NRF_RADIO->PCNF1  = (RADIO_PCNF1_WHITEEN_Enabled << RADIO_PCNF1_WHITEEN_Pos) |
+                        (RADIO_PCNF1_ENDIAN_Big << RADIO_PCNF1_ENDIAN_Pos) |
+                        (4UL << RADIO_PCNF1_BALEN_Pos) |
+                        (0UL << RADIO_PCNF1_STATLEN_Pos) |
+                        (255UL << RADIO_PCNF1_MAXLEN_Pos);
+    NRF_RADIO->CRCCNF = (RADIO_CRCCNF_LEN_Two << RADIO_CRCCNF_LEN_Pos);
+
+    NRF_RADIO->CRCINIT     = 0xFFFFUL;   // Initial value
+    NRF_RADIO->CRCPOLY     = 0x11021UL;  // CRC poly: x^16 + x^12^x^5 + 1
+    NRF_RADIO->DATAWHITEIV = channel;
+
+    NRF_RADIO->TXPOWER   = (p_step->txpower << RADIO_TXPOWER_TXPOWER_Pos);
+    NRF_RADIO->MODE      = (p_step->mode << RADIO_MODE_MODE_Pos);
+    NRF_RADIO->MODECNF0  = (p_step->fast_ramp_up ? RADIO_MODECNF0_RU_Fast : RADIO_MODECNF0_RU_Default)
+                           << RADIO_MODECNF0_RU_Pos;
+    NRF_RADIO->FREQUENCY = channel;
+    NRF_RADIO->PACKETPTR = (uint32_t)packet;
+}
+
+
+static void packet_header_set(uint8_t type, uint8_t index, uint16_t seq, uint8_t length)
+{
+    packet[0] = length;
+    packet[1] = type;
+    packet[2] = index;
+    packet[3] = (uint8_t)seq;
+    packet[4] = (uint8_t)(seq >> 8);
+}
+
+
+/**
+ * @brief Function for sending one packet, ramp-up included, and waiting until the radio is disabled.
+*/
+static void packet_send(void)
+{
+    NRF_RADIO->SHORTS          = RADIO_SHORTS_READY_START_Msk | RADIO_SHORTS_END_DISABLE_Msk;
+    NRF_RADIO->EVENTS_DISABLED = 0;
+    NRF_RADIO->TASKS_TXEN      = 1;
+    while (NRF_RADIO->EVENTS_DISABLED == 0)
+    {
+        // Do nothing.
+    }
+}
+
+
+/**
+ * @brief Function for starting to receive continuously. The radio is restarted on each END,
+ * without a new ramp-up.
+*/
+static void rx_start(void)
+{
+    NRF_RADIO->SHORTS     = RADIO_SHORTS_READY_START_Msk | RADIO_SHORTS_END_START_Msk;
+    NRF_RADIO->EVENTS_END = 0;
+    NRF_RADIO->TASKS_RXEN = 1;
+}
+
+
+/**
+ * @brief Function for checking if a packet with a valid CRC was received. The header must be read
+ * at once, before the next packet overwrites it.
+*/
+static bool packet_received(void)
+{
+    if (NRF_RADIO->EVENTS_END == 0)
+    {
+        return false;
+    }
+    NRF_RADIO->EVENTS_END = 0;
+    return (NRF_RADIO->CRCSTATUS == RADIO_CRCSTATUS_CRCSTATUS_CRCOk);
+}
+
+
+uint8_t radio_bench_step_count(void)
+{
+    return BENCH_STEP_COUNT;
+}
+
+
+void radio_bench_tx_run(uint8_t channel, radio_bench_report_t report, radio_bench_abort_t abort)
+{
+    radio_bench_result_t result;
+
+    timer1_init();
+    markers_init();
+
+    for (uint16_t i = BENCH_HEADER_LENGTH + 1; i < sizeof(packet); i++)
+    {
+        packet[i] = (uint8_t)i;
+    }
+
+    for (uint8_t index = 0; (index < BENCH_STEP_COUNT) && !abort(); index++)
+    {
+        uint32_t start;
+
+        result.index    = index;
+        result.sent     = RADIO_BENCH_PACKETS;
+        result.received = 0;
+        step_get(index, &result.step);
+
+        radio_setup(&m_control, channel);
+        packet_header_set(BENCH_PACKET_ANNOUNCE, index, RADIO_BENCH_PACKETS, BENCH_HEADER_LENGTH);
+        for (uint8_t i = 0; i < BENCH_ANNOUNCE_REPEAT; i++)
+        {
+            packet_send();
+        }
+
+        radio_setup(&result.step, channel);
+        timer1_wait(BENCH_GUARD_US);
+
+        NRF_GPIO->OUTSET = (1UL << RADIO_BENCH_STEP_PIN);
+        start = timer1_now();
+        for (uint16_t seq = 0; seq < RADIO_BENCH_PACKETS; seq++)
+        {
+            packet_header_set(BENCH_PACKET_DATA, index, seq, result.step.length);
+            packet_send();
+        }
+        result.time_us = timer1_now() - start;
+        NRF_GPIO->OUTCLR = (1UL << RADIO_BENCH_STEP_PIN);
+
+        report(&result);
+        timer1_wait(BENCH_STEP_GAP_US);
+    }
+
+    radio_disable();
+    markers_uninit();
+    NRF_TIMER1->TASKS_STOP = 1;
+}
+
+
+void radio_bench_rx_run(uint8_t channel, radio_bench_report_t report, radio_bench_abort_t abort)
+{
+    radio_bench_result_t result;
+
+    timer1_init();
+
+    while (!abort())
+    {
+        uint32_t deadline;
+        uint32_t first     = 0;
+        uint32_t last      = 0;
+        bool     announced = false;
+
+        // Wait for the announcement of a step.
+        radio_setup(&m_control, channel);
+        rx_start();
+        while (!announced && !abort())
+        {
+            announced = packet_received() && (packet[1] == BENCH_PACKET_ANNOUNCE);
+        }
+        if (!announced)
+        {
+            break;
+        }
+
+        result.index    = packet[2];
+        result.sent     = uint16_decode(&packet[3]);
+        result.received = 0;
+        if (result.index >= BENCH_STEP_COUNT)
+        {
+            continue;
+        }
+        step_get(result.index, &result.step);
+
+        radio_setup(&result.step, channel);
+        rx_start();
+        deadline = timer1_now() + BENCH_GUARD_US + BENCH_IDLE_TIMEOUT_US;
+
+        while ((int32_t)(timer1_now() - deadline) < 0)
+        {
+            if (packet_received() && (packet[1] == BENCH_PACKET_DATA) && (packet[2] == result.index))
+            {
+                uint16_t seq = uint16_decode(&packet[3]);
+
+                last = timer1_now();
+                if (result.received == 0)
+                {
+                    first = last;
+                }
+                result.received++;
+                deadline = last + BENCH_IDLE_TIMEOUT_US;
+
+                if (seq + 1 >= result.sent)
+                {
+                    break;
+                }
+            }
+        }
+
+        result.time_us = last - first;
+        report(&result);
+    }
+
+    radio_disable();
+    NRF_TIMER1->TASKS_STOP = 1;
+}
+
+#endif // NRF51
+
+/**
+ * @}
+ */
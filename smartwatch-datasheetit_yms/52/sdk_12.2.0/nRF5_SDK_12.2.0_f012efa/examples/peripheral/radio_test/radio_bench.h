@@ -0,0 +1,104 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+#ifndef RADIO_BENCH_H
+#define RADIO_BENCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @file
+* @addtogroup nrf_radio_test_example_main
+* @{
+*
+* @brief Two-node radio benchmark.
+*
+* A transmitter node sweeps the data rate, the payload length, the ramp-up mode and the output
+* power. For each step, it announces the step on a control setting (1 Mbit/s, 0 dBm), and then
+* sends a burst of RADIO_BENCH_PACKETS packets back to back with the settings of the step. The
+* receiver node follows the announcements, counts the packets received with a valid CRC, and
+* reports the packet error rate and the delivered packets per second.
+*
+* On the transmitter, RADIO_BENCH_STEP_PIN is high during each burst, and RADIO_BENCH_PACKET_PIN
+* is high from the end of the ramp-up to the end of each packet, through PPI. Triggering a power
+* analyzer on them gives the charge of each step, and dividing it by the packets sent gives the
+* energy per packet.
+*/
+
+#ifndef RADIO_BENCH_PACKETS
+#define RADIO_BENCH_PACKETS     500     /**< Packets sent in each step. */
+#endif
+
+#ifndef RADIO_BENCH_STEP_PIN
+#define RADIO_BENCH_STEP_PIN    LED_3   /**< Marker pin, high during the burst of a step. */
+#endif
+
+#ifndef RADIO_BENCH_PACKET_PIN
+#define RADIO_BENCH_PACKET_PIN  LED_4   /**< Marker pin, high while a packet is sent. */
+#endif
+
+/**@brief Settings of a benchmark step. */
+typedef struct
+{
+    uint8_t mode;           /**< Data rate, RADIO_MODE_MODE_*. */
+    uint8_t length;         /**< Payload length, in bytes. */
+    bool    fast_ramp_up;   /**< Fast ramp-up. */
+    uint8_t txpower;        /**< Output power, RADIO_TXPOWER_TXPOWER_*. */
+} radio_bench_step_t;
+
+/**@brief Result of a benchmark step. */
+typedef struct
+{
+    uint8_t            index;       /**< Index of the step. */
+    radio_bench_step_t step;        /**< Settings of the step. */
+    uint16_t           sent;        /**< Packets sent. */
+    uint16_t           received;    /**< Packets received with a valid CRC, 0 on the transmitter. */
+    uint32_t           time_us;     /**< On the transmitter, time to send all packets. On the receiver, time between the first and the last packet received. In microseconds. */
+} radio_bench_result_t;
+
+/**@brief Function called with the result of each step. */
+typedef void (* radio_bench_report_t)(radio_bench_result_t const * p_result);
+
+/**@brief Function polled between steps and while waiting for a step, returning true to stop the benchmark. */
+typedef bool (* radio_bench_abort_t)(void);
+
+/**@brief Function for getting the number of steps of the sweep. */
+uint8_t radio_bench_step_count(void);
+
+/**@brief Function for running the sweep as the transmitter node. Returns when it is done or aborted.
+ *
+ * @param[in] channel Radio channel of the benchmark.
+ * @param[in] report  Function called with the result of each step.
+ * @param[in] abort   Function polled to stop the benchmark.
+ */
+void radio_bench_tx_run(uint8_t channel, radio_bench_report_t report, radio_bench_abort_t abort);
+
+/**@brief Function for running the receiver node. Returns when it is aborted.
+ *
+ * @param[in] channel Radio channel of the benchmark.
+ * @param[in] report  Function called with the result of each step that was announced.
+ * @param[in] abort   Function polled to stop the benchmark.
+ */
+void radio_bench_rx_run(uint8_t channel, radio_bench_report_t report, radio_bench_abort_t abort);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
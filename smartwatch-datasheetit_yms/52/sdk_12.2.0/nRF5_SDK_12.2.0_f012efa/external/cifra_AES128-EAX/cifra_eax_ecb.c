@@ -0,0 +1,150 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include "nrf.h"
+#include "handy.h"
+#include "cifra_eax_ecb.h"
+#include "tassert.h"
+
+#ifdef SOFTDEVICE_PRESENT
+#include "nrf_soc.h"
+#endif
+
+void cf_ecb_init(cf_ecb_context *ctx, const uint8_t *key, size_t nkey)
+{
+  assert(nkey == ECB_BLOCKSZ);
+  memcpy(ctx->key, key, ECB_BLOCKSZ);
+}
+
+#ifdef SOFTDEVICE_PRESENT
+
+void cf_ecb_encrypt_blocks(const cf_ecb_context *ctx, const uint8_t *in, uint8_t *out, size_t nblocks)
+{
+  nrf_ecb_hal_data_block_t blocks[CF_ECB_BATCH_BLOCKS];
+
+  while (nblocks)
+  {
+    size_t n = MIN(nblocks, CF_ECB_BATCH_BLOCKS);
+
+    for (size_t i = 0; i < n; i++)
+    {
+      blocks[i].p_key        = (soc_ecb_key_t *) ctx->key;
+      blocks[i].p_cleartext  = (soc_ecb_cleartext_t *) (in + i * ECB_BLOCKSZ);
+      blocks[i].p_ciphertext = (soc_ecb_ciphertext_t *) (out + i * ECB_BLOCKSZ);
+    }
+
+    uint32_t err_code = sd_ecb_blocks_encrypt((uint8_t) n, blocks);
+    assert(err_code == NRF_SUCCESS);
+    (void) err_code;
+
+    in += n * ECB_BLOCKSZ;
+    out += n * ECB_BLOCKSZ;
+    nblocks -= n;
+  }
+}
+
+#else
+
+/* ECB data structure read and written by the peripheral. There are two, so
+ * that the next block can be prepared while one is encrypted. */
+typedef struct
+{
+  uint8_t key[ECB_BLOCKSZ];
+  uint8_t cleartext[ECB_BLOCKSZ];
+  uint8_t ciphertext[ECB_BLOCKSZ];
+} ecb_data_t;
+
+static ecb_data_t m_ecb_data[2];
+
+static void ecb_start(ecb_data_t *data)
+{
+  NRF_ECB->ECBDATAPTR = (uint32_t) data;
+  NRF_ECB->EVENTS_ENDECB = 0;
+  NRF_ECB->EVENTS_ERRORECB = 0;
+  NRF_ECB->TASKS_STARTECB = 1;
+}
+
+static void ecb_wait(ecb_data_t *data)
+{
+  while (NRF_ECB->EVENTS_ENDECB == 0)
+  {
+    if (NRF_ECB->EVENTS_ERRORECB)
+    {
+      /* Aborted, for example by the CCM peripheral: run it again. */
+      ecb_start(data);
+    }
+  }
+  NRF_ECB->EVENTS_ENDECB = 0;
+}
+
+void cf_ecb_encrypt_blocks(const cf_ecb_context *ctx, const uint8_t *in, uint8_t *out, size_t nblocks)
+{
+  if (nblocks == 0)
+    return;
+
+  /* Other users of the peripheral, such as nrf_ecb, keep their pointer. */
+  uint32_t data_ptr = NRF_ECB->ECBDATAPTR;
+
+  memcpy(m_ecb_data[0].key, ctx->key, ECB_BLOCKSZ);
+  memcpy(m_ecb_data[1].key, ctx->key, ECB_BLOCKSZ);
+  memcpy(m_ecb_data[0].cleartext, in, ECB_BLOCKSZ);
+  ecb_start(&m_ecb_data[0]);
+
+  for (size_t i = 0; i < nblocks; i++)
+  {
+    ecb_data_t *current = &m_ecb_data[i & 1];
+    ecb_data_t *next = &m_ecb_data[(i + 1) & 1];
+    int more = (i + 1) < nblocks;
+
+    /* The next input is read before this output is written, so they may alias. */
+    if (more)
+      memcpy(next->cleartext, in + (i + 1) * ECB_BLOCKSZ, ECB_BLOCKSZ);
+
+    ecb_wait(current);
+
+    if (more)
+      ecb_start(next);
+
+    memcpy(out + i * ECB_BLOCKSZ, current->ciphertext, ECB_BLOCKSZ);
+  }
+
+  NRF_ECB->ECBDATAPTR = data_ptr;
+}
+
+#endif
+
+void cf_ecb_encrypt(const cf_ecb_context *ctx, const uint8_t in[ECB_BLOCKSZ], uint8_t out[ECB_BLOCKSZ])
+{
+  cf_ecb_encrypt_blocks(ctx, in, out, 1);
+}
+
+void cf_ecb_decrypt(const cf_ecb_context *ctx, const uint8_t in[ECB_BLOCKSZ], uint8_t out[ECB_BLOCKSZ])
+{
+  (void) ctx;
+  (void) in;
+  (void) out;
+  abort();
+}
+
+void cf_ecb_finish(cf_ecb_context *ctx)
+{
+  mem_clean(ctx, sizeof *ctx);
+}
+
+const cf_prp cf_ecb = {
+  .blocksz = ECB_BLOCKSZ,
+  .encrypt = (cf_prp_block) cf_ecb_encrypt,
+  .decrypt = (cf_prp_block) cf_ecb_decrypt,
+  .encrypt_blocks = (cf_prp_blocks) cf_ecb_encrypt_blocks
+};
@@ -0,0 +1,101 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**
+ * AES-128 on the ECB peripheral
+ * =============================
+ * A :c:type:`cf_prp` for the block cipher modes, which encrypts on the AES ECB
+ * peripheral of the nRF5 chips instead of in software.
+ *
+ * When a SoftDevice is present, the peripheral is used through
+ * `sd_ecb_blocks_encrypt`, which takes a batch of blocks in one call.
+ * Otherwise the peripheral is used directly: the next block is started
+ * before the result of the previous one is copied out, so that the copies
+ * overlap with the encryption.
+ *
+ * The peripheral only encrypts. That is enough for CTR, CMAC and EAX, in
+ * both directions. :c:func:`cf_ecb_decrypt` calls `abort(3)`.
+ */
+
+#ifndef CIFRA_EAX_ECB_H
+#define CIFRA_EAX_ECB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "prp.h"
+
+/* .. c:macro:: ECB_BLOCKSZ
+ * Block and key size of the peripheral, in bytes.
+ */
+#define ECB_BLOCKSZ 16
+
+/* .. c:macro:: CF_ECB_BATCH_BLOCKS
+ * Maximum number of blocks given to the SoftDevice in one call.
+ */
+#ifndef CF_ECB_BATCH_BLOCKS
+# define CF_ECB_BATCH_BLOCKS 4
+#endif
+
+/* .. c:type:: cf_ecb_context
+ * The key, as given to the peripheral.
+ */
+typedef struct
+{
+  uint8_t key[ECB_BLOCKSZ];
+} cf_ecb_context;
+
+/* .. c:function:: $DECL
+ * Sets the key.
+ *
+ * :param ctx: context, filled in by this function.
+ * :param key: pointer to key material, of :c:data:`nkey` bytes.
+ * :param nkey: length of key material. Must be `16`.
+ */
+extern void cf_ecb_init(cf_ecb_context *ctx,
+                        const uint8_t *key,
+                        size_t nkey);
+
+/* .. c:function:: $DECL
+ * Encrypts the given block, from :c:data:`in` to :c:data:`out`.
+ * These may alias.
+ */
+extern void cf_ecb_encrypt(const cf_ecb_context *ctx,
+                           const uint8_t in[ECB_BLOCKSZ],
+                           uint8_t out[ECB_BLOCKSZ]);
+
+/* .. c:function:: $DECL
+ * Encrypts :c:data:`nblocks` consecutive blocks, from :c:data:`in` to
+ * :c:data:`out`. These may alias.
+ */
+extern void cf_ecb_encrypt_blocks(const cf_ecb_context *ctx,
+                                  const uint8_t *in,
+                                  uint8_t *out,
+                                  size_t nblocks);
+
+/* .. c:function:: $DECL
+ * Not supported by the peripheral: calls `abort(3)`.
+ */
+extern void cf_ecb_decrypt(const cf_ecb_context *ctx,
+                           const uint8_t in[ECB_BLOCKSZ],
+                           uint8_t out[ECB_BLOCKSZ]);
+
+/* .. c:function:: $DECL
+ * Erases the key. */
+extern void cf_ecb_finish(cf_ecb_context *ctx);
+
+/* .. c:var:: const cf_prp cf_ecb
+ * Abstract interface to AES-128 on the peripheral.  See :c:type:`cf_prp` for
+ * more information. */
+extern const cf_prp cf_ecb;
+
+#endif
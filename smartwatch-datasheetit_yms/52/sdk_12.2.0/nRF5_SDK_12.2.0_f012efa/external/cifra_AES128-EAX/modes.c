@@ -16,6 +16,7 @@
 #include "modes.h"
 #include "bitops.h"
 #include "blockwise.h"
+#include "handy.h"
 
 #include <string.h>
 #include "tassert.h"
@@ -86,6 +87,33 @@ static void ctr_next_block(void *vctx, uint8_t *out)
 
 void cf_ctr_cipher(cf_ctr *ctx, const uint8_t *input, uint8_t *output, size_t bytes)
 {
+  size_t nblk = ctx->prp->blocksz;
+
+  /* Whole blocks are ciphered in batches of key stream when the prp supports
+   * it, once the key stream left from a previous call is used up. */
+  if (ctx->prp->encrypt_blocks && ctx->nkeymat == 0)
+  {
+    uint8_t keystream[CF_CTR_BATCH_BLOCKS * CF_MAXBLOCK];
+
+    while (bytes >= nblk)
+    {
+      size_t blocks = MIN(bytes / nblk, CF_CTR_BATCH_BLOCKS);
+
+      for (size_t i = 0; i < blocks; i++)
+      {
+        memcpy(keystream + i * nblk, ctx->nonce, nblk);
+        incr_be(ctx->nonce + ctx->counter_offset, ctx->counter_width);
+      }
+
+      ctx->prp->encrypt_blocks(ctx->prpctx, keystream, keystream, blocks);
+      xor_bb(output, input, keystream, blocks * nblk);
+
+      input += blocks * nblk;
+      output += blocks * nblk;
+      bytes -= blocks * nblk;
+    }
+  }
+
   cf_blockwise_xor(ctx->keymat, &ctx->nkeymat,
                    ctx->prp->blocksz,
                    input, output, bytes,
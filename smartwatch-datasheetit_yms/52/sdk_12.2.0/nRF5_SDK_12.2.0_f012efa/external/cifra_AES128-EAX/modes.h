@@ -133,6 +133,14 @@ void cf_ctr_init(cf_ctr *ctx, const cf_prp *prp, void *prpctx, const uint8_t non
  * at the end of the nonce. */
 void cf_ctr_custom_counter(cf_ctr *ctx, size_t offset, size_t width);
 
+/* .. c:macro:: CF_CTR_BATCH_BLOCKS
+ * Number of blocks of key stream that are generated in one call, when the
+ * prp has :c:member:`cf_prp.encrypt_blocks`.
+ */
+#ifndef CF_CTR_BATCH_BLOCKS
+# define CF_CTR_BATCH_BLOCKS 4
+#endif
+
 /* .. c:function:: $DECL
  * Encrypt or decrypt bytes in CTR mode.
  * input and output may alias and must point to specified number of bytes. */
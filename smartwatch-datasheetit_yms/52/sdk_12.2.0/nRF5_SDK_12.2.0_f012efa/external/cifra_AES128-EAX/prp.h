@@ -37,6 +37,19 @@
  */
 typedef void (*cf_prp_block)(void *ctx, const uint8_t *in, uint8_t *out);
 
+/* .. c:type:: cf_prp_blocks
+ * Function type for processing several consecutive blocks in one call.
+ *
+ * The `in` and `out` blocks may alias.
+ *
+ * :rtype: void
+ * :param ctx: block cipher-specific context object.
+ * :param in: input blocks.
+ * :param out: output blocks.
+ * :param nblocks: number of blocks.
+ */
+typedef void (*cf_prp_blocks)(void *ctx, const uint8_t *in, uint8_t *out, size_t nblocks);
+
 /* .. c:type:: cf_prp
  * Describes an PRP in a general way.
  *
@@ -48,12 +61,17 @@ typedef void (*cf_prp_block)(void *ctx, const uint8_t *in, uint8_t *out);
  *
  * .. c:member:: cf_prp.decrypt
  * Block decryption function.
+ *
+ * .. c:member:: cf_prp.encrypt_blocks
+ * Optional encryption function for several blocks, for a cipher that is
+ * faster on batches, such as a hardware peripheral. NULL if not available.
  */
 typedef struct
 {
   size_t blocksz;
   cf_prp_block encrypt;
   cf_prp_block decrypt;
+  cf_prp_blocks encrypt_blocks;
 } cf_prp;
 
 /* .. c:macro:: CF_MAXBLOCK
@@ -10,7 +10,9 @@
  *
  */
 
+#include <string.h>
 #include "diskio_blkdev.h"
+#include "app_util_platform.h"
 
 
 /**
@@ -23,6 +25,599 @@ static diskio_blkdev_t * m_drives;
  * */
 static BYTE m_drives_count;
 
+/**
+ * @brief Completes the oldest queued request.
+ * */
+static void queue_complete(diskio_blkdev_t * p_drive, nrf_block_dev_result_t result)
+{
+    diskio_blkdev_req_t const * p_req = &p_drive->queue[p_drive->queue_tail];
+
+    switch (p_req->type)
+    {
+        case DISKIO_BLKDEV_REQ_READ:
+        case DISKIO_BLKDEV_REQ_WRITE:
+            p_drive->last_result = result;
+            break;
+#if DISKIO_BLKDEV_WRITE_BUFFER_SIZE
+        case DISKIO_BLKDEV_REQ_WRITE_BUFFERED:
+        {
+            uint32_t blk_size = nrf_blk_dev_geometry(p_drive->config.p_block_device)->blk_size;
+            if (result != NRF_BLOCK_DEV_RESULT_SUCCESS)
+            {
+                p_drive->write_error = true;
+            }
+
+            /*Buffered writes are freed in the order they were allocated*/
+            p_drive->write_tail = ((uint8_t *)p_req->req.p_buff - (uint8_t *)p_drive->write_buff)
+                                  + p_req->req.blk_count * blk_size;
+            p_drive->write_count--;
+            break;
+        }
+#endif
+#if DISKIO_BLKDEV_READ_AHEAD_SIZE
+        case DISKIO_BLKDEV_REQ_READ_AHEAD:
+            p_drive->ra_valid = (result == NRF_BLOCK_DEV_RESULT_SUCCESS);
+            p_drive->ra_pending = false;
+            break;
+#endif
+        default:
+            break;
+    }
+
+    p_drive->queue_tail = (p_drive->queue_tail + 1) % DISKIO_BLKDEV_QUEUE_SIZE;
+    p_drive->queue_count--;
+    p_drive->done_count++;
+    p_drive->in_progress = false;
+}
+
+/**
+ * @brief Starts queued requests until one is in progress.
+ *
+ * Called from the event handler and from the loops waiting for requests. Requests completed
+ * while one is being started are followed by the loop, not by a nested call. A request that
+ * the block device rejects as busy is retried on the next call.
+ * */
+static void queue_submit(uint8_t drv)
+{
+    diskio_blkdev_t * p_drive = &m_drives[drv];
+
+    for (;;)
+    {
+        bool start;
+
+        CRITICAL_REGION_ENTER();
+        start = !p_drive->in_progress && !p_drive->submitting && (p_drive->queue_count != 0);
+        if (start)
+        {
+            p_drive->in_progress = true;
+            p_drive->submitting = true;
+        }
+        CRITICAL_REGION_EXIT();
+
+        if (!start)
+        {
+            return;
+        }
+
+        diskio_blkdev_req_t const * p_req = &p_drive->queue[p_drive->queue_tail];
+        ret_code_t err_code;
+        if ((p_req->type == DISKIO_BLKDEV_REQ_WRITE) ||
+            (p_req->type == DISKIO_BLKDEV_REQ_WRITE_BUFFERED))
+        {
+            err_code = nrf_blk_dev_write_req(p_drive->config.p_block_device, &p_req->req);
+        }
+        else
+        {
+            err_code = nrf_blk_dev_read_req(p_drive->config.p_block_device, &p_req->req);
+        }
+
+        if (err_code == NRF_ERROR_BUSY)
+        {
+            p_drive->in_progress = false;
+            p_drive->submitting = false;
+            return;
+        }
+
+        if (err_code != NRF_SUCCESS)
+        {
+            queue_complete(p_drive, NRF_BLOCK_DEV_RESULT_IO_ERROR);
+        }
+
+        p_drive->submitting = false;
+    }
+}
+
+/**
+ * @brief Queues a request.
+ *
+ * @param[in]  drv      Drive number.
+ * @param[in]  type     Request type.
+ * @param[in]  p_buff   Data buffer.
+ * @param[in]  sector   Sector start number.
+ * @param[in]  count    Sector count.
+ * @param[in]  wait     Wait for a free queue entry.
+ * @param[out] p_ticket Number of requests that complete before this one (optional).
+ *
+ * @retval true If the request was queued.
+ * */
+static bool queue_put(uint8_t drv, diskio_blkdev_req_type_t type, void * p_buff,
+                      DWORD sector, UINT count, bool wait, uint32_t * p_ticket)
+{
+    diskio_blkdev_t * p_drive = &m_drives[drv];
+
+    while (p_drive->queue_count == DISKIO_BLKDEV_QUEUE_SIZE)
+    {
+        if (!wait)
+        {
+            return false;
+        }
+
+        queue_submit(drv);
+        if (p_drive->queue_count == DISKIO_BLKDEV_QUEUE_SIZE)
+        {
+            p_drive->config.wait_func();
+        }
+    }
+
+    diskio_blkdev_req_t * p_req = &p_drive->queue[p_drive->queue_head];
+    p_req->req.p_buff = p_buff;
+    p_req->req.blk_id = sector;
+    p_req->req.blk_count = count;
+    p_req->type = type;
+
+    if (p_ticket)
+    {
+        *p_ticket = p_drive->queued_count;
+    }
+
+    p_drive->queued_count++;
+    p_drive->queue_head = (p_drive->queue_head + 1) % DISKIO_BLKDEV_QUEUE_SIZE;
+    CRITICAL_REGION_ENTER();
+    p_drive->queue_count++;
+    CRITICAL_REGION_EXIT();
+
+    queue_submit(drv);
+    return true;
+}
+
+/**
+ * @brief Waits until a request has completed.
+ *
+ * @param[in] drv    Drive number.
+ * @param[in] ticket Ticket returned by @ref queue_put.
+ * */
+static void queue_wait(uint8_t drv, uint32_t ticket)
+{
+    diskio_blkdev_t * p_drive = &m_drives[drv];
+
+    while ((int32_t)(p_drive->done_count - ticket) <= 0)
+    {
+        queue_submit(drv);
+        if ((int32_t)(p_drive->done_count - ticket) <= 0)
+        {
+            p_drive->config.wait_func();
+        }
+    }
+}
+
+/**
+ * @brief Waits until all queued requests have completed.
+ * */
+static void queue_drain(uint8_t drv)
+{
+    diskio_blkdev_t * p_drive = &m_drives[drv];
+
+    while (p_drive->queue_count != 0)
+    {
+        queue_submit(drv);
+        if (p_drive->queue_count != 0)
+        {
+            p_drive->config.wait_func();
+        }
+    }
+}
+
+#if DISKIO_BLKDEV_WRITE_BUFFER_SIZE
+/**
+ * @brief Allocates a part of the write buffer, waiting for buffered writes to complete.
+ *
+ * @param[in] drv  Drive number.
+ * @param[in] size Size, not larger than @ref DISKIO_BLKDEV_WRITE_BUFFER_SIZE.
+ *
+ * @return Allocated buffer.
+ * */
+static uint8_t * write_buff_alloc(uint8_t drv, uint32_t size)
+{
+    diskio_blkdev_t * p_drive = &m_drives[drv];
+    uint32_t offset = DISKIO_BLKDEV_WRITE_BUFFER_SIZE;
+
+    for (;;)
+    {
+        CRITICAL_REGION_ENTER();
+        uint32_t tail = p_drive->write_tail;
+        if (p_drive->write_count == 0)
+        {
+            offset = 0;
+        }
+        else if (p_drive->write_head > tail)
+        {
+            if (DISKIO_BLKDEV_WRITE_BUFFER_SIZE - p_drive->write_head >= size)
+            {
+                offset = p_drive->write_head;
+            }
+            else if (tail >= size)
+            {
+                /*The end of the buffer is skipped*/
+                offset = 0;
+            }
+        }
+        else if ((p_drive->write_head < tail) && (tail - p_drive->write_head >= size))
+        {
+            offset = p_drive->write_head;
+        }
+
+        if (offset != DISKIO_BLKDEV_WRITE_BUFFER_SIZE)
+        {
+            /*Counted here, so that the tail is not moved before the write is queued*/
+            p_drive->write_count++;
+        }
+        CRITICAL_REGION_EXIT();
+
+        if (offset != DISKIO_BLKDEV_WRITE_BUFFER_SIZE)
+        {
+            break;
+        }
+
+        queue_submit(drv);
+        p_drive->config.wait_func();
+    }
+
+    p_drive->write_head = offset + size;
+    return (uint8_t *)p_drive->write_buff + offset;
+}
+#endif
+
+#if DISKIO_BLKDEV_READ_AHEAD_SIZE
+/**
+ * @brief Queues a read of the sectors from a sector into the read-ahead buffer.
+ * */
+static void read_ahead_start(uint8_t drv, DWORD sector)
+{
+    diskio_blkdev_t * p_drive = &m_drives[drv];
+    nrf_block_dev_geometry_t const * p_geometry =
+                                     nrf_blk_dev_geometry(p_drive->config.p_block_device);
+
+    if (p_drive->ra_pending || (sector >= p_geometry->blk_count))
+    {
+        return;
+    }
+
+    UINT count = MIN(DISKIO_BLKDEV_READ_AHEAD_SIZE / p_geometry->blk_size,
+                     p_geometry->blk_count - sector);
+    if (count == 0)
+    {
+        return;
+    }
+
+    p_drive->ra_sector = sector;
+    p_drive->ra_count = count;
+    p_drive->ra_valid = false;
+    p_drive->ra_pending = true;
+    if (!queue_put(drv, DISKIO_BLKDEV_REQ_READ_AHEAD, p_drive->ra_buff, sector, count, false, NULL))
+    {
+        p_drive->ra_count = 0;
+        p_drive->ra_pending = false;
+    }
+}
+
+/**
+ * @brief Drops the read-ahead buffer if it holds one of the sectors.
+ * */
+static void read_ahead_invalidate(uint8_t drv, DWORD sector, UINT count)
+{
+    diskio_blkdev_t * p_drive = &m_drives[drv];
+
+    if ((sector < p_drive->ra_sector + p_drive->ra_count) &&
+        (p_drive->ra_sector < sector + count))
+    {
+        p_drive->ra_count = 0;
+    }
+}
+#endif
+
+/**
+ * @brief Reads sectors from the read-ahead buffer or the block device.
+ * */
+static DRESULT drive_read(BYTE drv, BYTE *buff, DWORD sector, UINT count)
+{
+#if DISKIO_BLKDEV_READ_AHEAD_SIZE
+    diskio_blkdev_t * p_drive = &m_drives[drv];
+    bool sequential = (sector == p_drive->next_sector);
+    p_drive->next_sector = sector + count;
+
+    if ((sector >= p_drive->ra_sector) &&
+        (sector + count <= p_drive->ra_sector + p_drive->ra_count))
+    {
+        while (p_drive->ra_pending)
+        {
+            queue_submit(drv);
+            if (p_drive->ra_pending)
+            {
+                p_drive->config.wait_func();
+            }
+        }
+
+        /*The range is dropped if a write to it was queued meanwhile*/
+        if (p_drive->ra_valid &&
+            (sector + count <= p_drive->ra_sector + p_drive->ra_count))
+        {
+            uint32_t blk_size = nrf_blk_dev_geometry(p_drive->config.p_block_device)->blk_size;
+            memcpy(buff,
+                   (uint8_t *)p_drive->ra_buff + (sector - p_drive->ra_sector) * blk_size,
+                   count * blk_size);
+
+            if (sector + count == p_drive->ra_sector + p_drive->ra_count)
+            {
+                read_ahead_start(drv, sector + count);
+            }
+            return RES_OK;
+        }
+    }
+#endif
+
+    uint32_t ticket;
+    (void)queue_put(drv, DISKIO_BLKDEV_REQ_READ, buff, sector, count, true, &ticket);
+
+#if DISKIO_BLKDEV_READ_AHEAD_SIZE
+    if (sequential)
+    {
+        /*Performed while the caller uses the sectors just read*/
+        read_ahead_start(drv, sector + count);
+    }
+#endif
+
+    queue_wait(drv, ticket);
+    if (m_drives[drv].last_result == NRF_BLOCK_DEV_RESULT_SUCCESS)
+    {
+        return RES_OK;
+    }
+    return RES_ERROR;
+}
+
+/**
+ * @brief Writes sectors through the write buffer or to the block device.
+ * */
+static DRESULT drive_write(BYTE drv, const BYTE *buff, DWORD sector, UINT count)
+{
+#if DISKIO_BLKDEV_READ_AHEAD_SIZE
+    read_ahead_invalidate(drv, sector, count);
+#endif
+
+#if DISKIO_BLKDEV_WRITE_BUFFER_SIZE
+    uint32_t size = count * nrf_blk_dev_geometry(m_drives[drv].config.p_block_device)->blk_size;
+    if (size <= DISKIO_BLKDEV_WRITE_BUFFER_SIZE)
+    {
+        uint8_t * p_buff = write_buff_alloc(drv, size);
+        memcpy(p_buff, buff, size);
+        (void)queue_put(drv, DISKIO_BLKDEV_REQ_WRITE_BUFFERED, p_buff, sector, count, true, NULL);
+        return RES_OK;
+    }
+#endif
+
+    uint32_t ticket;
+    (void)queue_put(drv, DISKIO_BLKDEV_REQ_WRITE, (void *)buff, sector, count, true, &ticket);
+    queue_wait(drv, ticket);
+    if (m_drives[drv].last_result == NRF_BLOCK_DEV_RESULT_SUCCESS)
+    {
+        return RES_OK;
+    }
+    return RES_ERROR;
+}
+
+#if DISKIO_BLKDEV_CACHE_SECTORS
+STATIC_ASSERT(DISKIO_BLKDEV_CACHE_SECTOR_SIZE >= 512);
+
+#define CACHE_VALID 0x01
+#define CACHE_DIRTY 0x02
+#define CACHE_NONE  (-1)
+
+/**
+ * @brief Finds the cache entry of a sector.
+ *
+ * @return Entry index or @ref CACHE_NONE.
+ * */
+static int cache_find(diskio_blkdev_t const * p_drive, DWORD sector)
+{
+    for (int i = 0; i < DISKIO_BLKDEV_CACHE_SECTORS; i++)
+    {
+        if ((p_drive->cache_flags[i] & CACHE_VALID) && (p_drive->cache_sector[i] == sector))
+        {
+            return i;
+        }
+    }
+    return CACHE_NONE;
+}
+
+/**
+ * @brief Marks a cache entry as the most recently used one.
+ * */
+static void cache_touch(diskio_blkdev_t * p_drive, int idx)
+{
+    p_drive->cache_used[idx] = ++p_drive->cache_clock;
+}
+
+/**
+ * @brief Writes a dirty cache entry to the block device.
+ *
+ * @retval true If the entry is clean.
+ * */
+static bool cache_entry_flush(BYTE drv, int idx)
+{
+    diskio_blkdev_t * p_drive = &m_drives[drv];
+
+    if (!(p_drive->cache_flags[idx] & CACHE_DIRTY))
+    {
+        return true;
+    }
+
+    if (drive_write(drv, (BYTE const *)p_drive->cache_buff[idx], p_drive->cache_sector[idx], 1)
+        != RES_OK)
+    {
+        return false;
+    }
+
+    p_drive->cache_flags[idx] &= ~CACHE_DIRTY;
+    p_drive->cache_stats.flushes++;
+    return true;
+}
+
+/**
+ * @brief Writes all dirty cache entries to the block device.
+ *
+ * @retval true If all entries are clean.
+ * */
+static bool cache_flush(BYTE drv)
+{
+    bool result = true;
+
+    for (int i = 0; i < DISKIO_BLKDEV_CACHE_SECTORS; i++)
+    {
+        result = cache_entry_flush(drv, i) && result;
+    }
+    return result;
+}
+
+/**
+ * @brief Takes a cache entry for a sector, evicting the least recently used one.
+ *
+ * @return Entry index, or @ref CACHE_NONE if the evicted entry could not be written.
+ * */
+static int cache_alloc(BYTE drv, DWORD sector)
+{
+    diskio_blkdev_t * p_drive = &m_drives[drv];
+    int idx = 0;
+
+    for (int i = 0; i < DISKIO_BLKDEV_CACHE_SECTORS; i++)
+    {
+        if (!(p_drive->cache_flags[i] & CACHE_VALID))
+        {
+            idx = i;
+            break;
+        }
+        if ((p_drive->cache_clock - p_drive->cache_used[i]) >
+            (p_drive->cache_clock - p_drive->cache_used[idx]))
+        {
+            idx = i;
+        }
+    }
+
+    if ((p_drive->cache_flags[idx] & CACHE_VALID) && !cache_entry_flush(drv, idx))
+    {
+        return CACHE_NONE;
+    }
+
+    p_drive->cache_sector[idx] = sector;
+    p_drive->cache_flags[idx] = 0;
+    return idx;
+}
+
+/**
+ * @brief Copies the sector to a clean cache entry.
+ * */
+static void cache_insert(BYTE drv, BYTE const * buff, DWORD sector)
+{
+    diskio_blkdev_t * p_drive = &m_drives[drv];
+    int idx = cache_alloc(drv, sector);
+
+    if (idx != CACHE_NONE)
+    {
+        memcpy(p_drive->cache_buff[idx], buff, DISKIO_BLKDEV_CACHE_SECTOR_SIZE);
+        p_drive->cache_flags[idx] = CACHE_VALID;
+        cache_touch(p_drive, idx);
+    }
+}
+
+/**
+ * @brief Copies the dirty cache entries of a range of sectors to data read from the block device.
+ * */
+static void cache_overlay(diskio_blkdev_t const * p_drive, BYTE * buff, DWORD sector, UINT count)
+{
+    for (int i = 0; i < DISKIO_BLKDEV_CACHE_SECTORS; i++)
+    {
+        if ((p_drive->cache_flags[i] & CACHE_DIRTY) &&
+            (p_drive->cache_sector[i] >= sector) && (p_drive->cache_sector[i] - sector < count))
+        {
+            memcpy(buff + (p_drive->cache_sector[i] - sector) * DISKIO_BLKDEV_CACHE_SECTOR_SIZE,
+                   p_drive->cache_buff[i], DISKIO_BLKDEV_CACHE_SECTOR_SIZE);
+        }
+    }
+}
+
+/**
+ * @brief Updates, or drops, the cache entries of a range of sectors written to the block device.
+ * */
+static void cache_update(diskio_blkdev_t * p_drive, BYTE const * buff, DWORD sector, UINT count,
+                         bool drop)
+{
+    for (int i = 0; i < DISKIO_BLKDEV_CACHE_SECTORS; i++)
+    {
+        if ((p_drive->cache_flags[i] & CACHE_VALID) &&
+            (p_drive->cache_sector[i] >= sector) && (p_drive->cache_sector[i] - sector < count))
+        {
+            if (drop)
+            {
+                p_drive->cache_flags[i] = 0;
+            }
+            else
+            {
+                memcpy(p_drive->cache_buff[i],
+                       buff + (p_drive->cache_sector[i] - sector) * DISKIO_BLKDEV_CACHE_SECTOR_SIZE,
+                       DISKIO_BLKDEV_CACHE_SECTOR_SIZE);
+                p_drive->cache_flags[i] = CACHE_VALID;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Finds the FAT area of a volume if the sector is its boot sector.
+ *
+ * The reserved sectors, the FATs and the FAT12/16 root directory precede the data area.
+ * */
+static void cache_meta_detect(diskio_blkdev_t * p_drive, BYTE const * buff, DWORD sector)
+{
+    uint16_t sector_size = uint16_decode(&buff[11]);
+    uint16_t reserved    = uint16_decode(&buff[14]);
+    uint8_t  fat_count   = buff[16];
+    uint16_t root_count  = uint16_decode(&buff[17]);
+    uint32_t fat_size    = uint16_decode(&buff[22]);
+
+    if ((buff[510] != 0x55) || (buff[511] != 0xAA)   ||
+        ((buff[0] != 0xEB) && (buff[0] != 0xE9))     ||
+        (sector_size != DISKIO_BLKDEV_CACHE_SECTOR_SIZE) ||
+        (reserved == 0) || (fat_count == 0) || (fat_count > 2))
+    {
+        return;
+    }
+
+    if (fat_size == 0)
+    {
+        fat_size = uint32_decode(&buff[36]);
+    }
+
+    p_drive->meta_start = sector;
+    p_drive->meta_end   = sector + reserved + fat_count * fat_size
+                          + CEIL_DIV(root_count * 32, DISKIO_BLKDEV_CACHE_SECTOR_SIZE);
+}
+
+void diskio_blkdev_cache_stats_get(BYTE drv, diskio_blkdev_cache_stats_t * p_stats)
+{
+    ASSERT(drv < m_drives_count);
+
+    *p_stats = m_drives[drv].cache_stats;
+}
+#endif // DISKIO_BLKDEV_CACHE_SECTORS
+
 /**
  * @brief Block device handler.
  *
@@ -38,11 +633,14 @@ static void block_dev_handler(struct nrf_block_dev_s const * p_blk_dev,
     {
         case NRF_BLOCK_DEV_EVT_INIT:
         case NRF_BLOCK_DEV_EVT_UNINIT:
-        case NRF_BLOCK_DEV_EVT_BLK_WRITE_DONE:
-        case NRF_BLOCK_DEV_EVT_BLK_READ_DONE:
             m_drives[drv].last_result = p_event->result;
             m_drives[drv].busy = false;
             break;
+        case NRF_BLOCK_DEV_EVT_BLK_WRITE_DONE:
+        case NRF_BLOCK_DEV_EVT_BLK_READ_DONE:
+            queue_complete(&m_drives[drv], p_event->result);
+            queue_submit(drv);
+            break;
         default:
             break;
     }
@@ -81,6 +679,28 @@ DSTATUS disk_initialize(BYTE drv)
         m_drives[drv].config.wait_func = default_wait_func;
     }
 
+    m_drives[drv].queue_head = 0;
+    m_drives[drv].queue_tail = 0;
+    m_drives[drv].queue_count = 0;
+    m_drives[drv].in_progress = false;
+    m_drives[drv].submitting = false;
+    m_drives[drv].write_error = false;
+#if DISKIO_BLKDEV_WRITE_BUFFER_SIZE
+    m_drives[drv].write_count = 0;
+#endif
+#if DISKIO_BLKDEV_READ_AHEAD_SIZE
+    m_drives[drv].ra_count = 0;
+    m_drives[drv].ra_pending = false;
+    m_drives[drv].next_sector = 0;
+#endif
+#if DISKIO_BLKDEV_CACHE_SECTORS
+    memset(m_drives[drv].cache_flags, 0, sizeof(m_drives[drv].cache_flags));
+    memset(&m_drives[drv].cache_stats, 0, sizeof(m_drives[drv].cache_stats));
+    m_drives[drv].cache_clock = 0;
+    m_drives[drv].meta_start = 0;
+    m_drives[drv].meta_end = 0;
+#endif
+
     m_drives[drv].busy = true;
     ret_code_t err_code = nrf_blk_dev_init(m_drives[drv].config.p_block_device,
                                            block_dev_handler,
@@ -96,6 +716,11 @@ DSTATUS disk_initialize(BYTE drv)
         {
             m_drives[drv].state &= ~STA_NOINIT;
         }
+#if DISKIO_BLKDEV_CACHE_SECTORS
+        m_drives[drv].cache_enabled =
+            (nrf_blk_dev_geometry(m_drives[drv].config.p_block_device)->blk_size
+             == DISKIO_BLKDEV_CACHE_SECTOR_SIZE);
+#endif
     }
 
     return m_drives[drv].state;
@@ -121,15 +746,29 @@ DSTATUS disk_uninitialize(BYTE drv)
         return m_drives[drv].state;
     }
 
+#if DISKIO_BLKDEV_CACHE_SECTORS
+    if (m_drives[drv].cache_enabled)
+    {
+        (void)cache_flush(drv);
+    }
+#endif
+    queue_drain(drv);
     (void)nrf_blk_dev_ioctl(m_drives[drv].config.p_block_device,
                             NRF_BLOCK_DEV_IOCTL_REQ_CACHE_FLUSH,
                             NULL);
     ret_code_t ret;
-    do
+    for (;;)
     {
         /*Perform synchronous uninit.*/
         ret = nrf_blk_dev_uninit(m_drives[drv].config.p_block_device);
-    } while (ret == NRF_ERROR_BUSY);
+        if (ret != NRF_ERROR_BUSY)
+        {
+            break;
+        }
+
+        /*Asynchronous cache flush in progress*/
+        m_drives[drv].config.wait_func();
+    }
 
     if (ret == NRF_SUCCESS)
     {
@@ -157,6 +796,7 @@ DSTATUS disk_status(BYTE drv)
     return m_drives[drv].state;
 }
 
+
 DRESULT disk_read(BYTE drv, BYTE *buff, DWORD sector, UINT count)
 {
     ASSERT(m_drives);
@@ -172,28 +812,40 @@ DRESULT disk_read(BYTE drv, BYTE *buff, DWORD sector, UINT count)
         return RES_NOTRDY;    // Disk not initialized.
     }
 
-    const nrf_block_req_t req = {
-        .p_buff = buff,
-        .blk_id = sector,
-        .blk_count = count
-    };
-
-    m_drives[drv].busy = true;
-    ret_code_t err_code = nrf_blk_dev_read_req(m_drives[drv].config.p_block_device, &req);
+#if DISKIO_BLKDEV_CACHE_SECTORS
+    diskio_blkdev_t * p_drive = &m_drives[drv];
+    if (!p_drive->cache_enabled)
+    {
+        return drive_read(drv, buff, sector, count);
+    }
 
-    if (err_code == NRF_SUCCESS)
+    if (count == 1)
     {
-        while (m_drives[drv].busy)
+        int idx = cache_find(p_drive, sector);
+        if (idx != CACHE_NONE)
         {
-            m_drives[drv].config.wait_func();
+            memcpy(buff, p_drive->cache_buff[idx], DISKIO_BLKDEV_CACHE_SECTOR_SIZE);
+            cache_touch(p_drive, idx);
+            p_drive->cache_stats.hits++;
+            return RES_OK;
         }
+        p_drive->cache_stats.misses++;
+    }
 
-        if (m_drives[drv].last_result == NRF_BLOCK_DEV_RESULT_SUCCESS)
+    DRESULT res = drive_read(drv, buff, sector, count);
+    if (res == RES_OK)
+    {
+        cache_overlay(p_drive, buff, sector, count);
+        if (count == 1)
         {
-            return RES_OK;
+            cache_meta_detect(p_drive, buff, sector);
+            cache_insert(drv, buff, sector);
         }
     }
-    return RES_ERROR;
+    return res;
+#else
+    return drive_read(drv, buff, sector, count);
+#endif
 }
 
 DRESULT disk_write(BYTE drv, const BYTE *buff, DWORD sector, UINT count)
@@ -216,27 +868,56 @@ DRESULT disk_write(BYTE drv, const BYTE *buff, DWORD sector, UINT count)
         return RES_WRPRT;    // Disk protection is enabled.
     }
 
-    const nrf_block_req_t req = {
-        .p_buff = (void *)buff,
-        .blk_id = sector,
-        .blk_count = count
-    };
+    if (m_drives[drv].write_error)
+    {
+        /*An earlier buffered write failed*/
+        m_drives[drv].write_error = false;
+        return RES_ERROR;
+    }
 
-    m_drives[drv].busy = true;
-    ret_code_t err_code = nrf_blk_dev_write_req(m_drives[drv].config.p_block_device, &req);
-    if (err_code == NRF_SUCCESS)
+#if DISKIO_BLKDEV_CACHE_SECTORS
+    diskio_blkdev_t * p_drive = &m_drives[drv];
+    if (!p_drive->cache_enabled)
     {
-        while (m_drives[drv].busy)
+        return drive_write(drv, buff, sector, count);
+    }
+
+    int idx = (count == 1) ? cache_find(p_drive, sector) : CACHE_NONE;
+    if ((count == 1) && (sector >= p_drive->meta_start) && (sector < p_drive->meta_end))
+    {
+        /*FAT sectors are written many times between two CTRL_SYNC requests*/
+        if (idx == CACHE_NONE)
         {
-            m_drives[drv].config.wait_func();
+            idx = cache_alloc(drv, sector);
         }
-
-        if (m_drives[drv].last_result == NRF_BLOCK_DEV_RESULT_SUCCESS)
+        if (idx != CACHE_NONE)
         {
+            memcpy(p_drive->cache_buff[idx], buff, DISKIO_BLKDEV_CACHE_SECTOR_SIZE);
+            p_drive->cache_flags[idx] = CACHE_VALID | CACHE_DIRTY;
+            cache_touch(p_drive, idx);
+            p_drive->cache_stats.write_backs++;
             return RES_OK;
         }
     }
-    return RES_ERROR;
+
+    DRESULT res = drive_write(drv, buff, sector, count);
+    cache_update(p_drive, buff, sector, count, (res != RES_OK));
+    if ((res == RES_OK) && (count == 1))
+    {
+        if (idx == CACHE_NONE)
+        {
+            /*Directory sectors are read again after they are written*/
+            cache_insert(drv, buff, sector);
+        }
+        else
+        {
+            cache_touch(p_drive, idx);
+        }
+    }
+    return res;
+#else
+    return drive_write(drv, buff, sector, count);
+#endif
 }
 
 DRESULT disk_ioctl(BYTE drv, BYTE cmd, void *buff)
@@ -252,6 +933,16 @@ DRESULT disk_ioctl(BYTE drv, BYTE cmd, void *buff)
     {
         case CTRL_SYNC:
         {
+            if (m_drives[drv].config.p_block_device == NULL)
+            {
+                return RES_NOTRDY;
+            }
+
+#if DISKIO_BLKDEV_CACHE_SECTORS
+            bool cache_error = !cache_flush(drv);
+#endif
+            queue_drain(drv);
+
             bool flush_in_progress = true;
             do {
                 /*Perform synchronous FLUSH operation on block device*/
@@ -263,8 +954,23 @@ DRESULT disk_ioctl(BYTE drv, BYTE cmd, void *buff)
                     break;
                 }
 
+                if (flush_in_progress)
+                {
+                    m_drives[drv].config.wait_func();
+                }
             } while (flush_in_progress);
 
+            if (m_drives[drv].write_error)
+            {
+                m_drives[drv].write_error = false;
+                return RES_ERROR;
+            }
+#if DISKIO_BLKDEV_CACHE_SECTORS
+            if (cache_error)
+            {
+                return RES_ERROR;
+            }
+#endif
             return RES_OK;
         }
         case GET_SECTOR_COUNT:
@@ -289,6 +995,48 @@ DRESULT disk_ioctl(BYTE drv, BYTE cmd, void *buff)
             *val = nrf_blk_dev_geometry(m_drives[drv].config.p_block_device)->blk_size;
             return RES_OK;
         }
+        case CTRL_TRIM:
+        {
+            if (m_drives[drv].config.p_block_device == NULL)
+            {
+                return RES_NOTRDY;
+            }
+
+            DWORD const * p_range = buff;
+            if (p_range[1] < p_range[0])
+            {
+                return RES_PARERR;
+            }
+
+            /*Start and end sector, inclusive. Their data is dropped by all layers.*/
+            DWORD count = p_range[1] - p_range[0] + 1;
+#if DISKIO_BLKDEV_CACHE_SECTORS
+            cache_update(&m_drives[drv], NULL, p_range[0], count, true);
+#endif
+#if DISKIO_BLKDEV_READ_AHEAD_SIZE
+            read_ahead_invalidate(drv, p_range[0], count);
+#endif
+            queue_drain(drv);
+
+            NRF_BLOCK_DEV_REQUEST(req, p_range[0], count, NULL);
+            ret_code_t ret;
+            do {
+                ret = nrf_blk_dev_ioctl(m_drives[drv].config.p_block_device,
+                                        NRF_BLOCK_DEV_IOCTL_REQ_DISCARD,
+                                        &req);
+                if (ret == NRF_ERROR_BUSY)
+                {
+                    m_drives[drv].config.wait_func();
+                }
+            } while (ret == NRF_ERROR_BUSY);
+
+            /*The discard is only a hint, devices without it keep the data*/
+            if ((ret == NRF_SUCCESS) || (ret == NRF_ERROR_NOT_SUPPORTED))
+            {
+                return RES_OK;
+            }
+            return RES_ERROR;
+        }
         default:
             break;
     }
@@ -15,6 +15,7 @@
 
 #include "diskio.h"
 #include "nrf_block_dev.h"
+#include "app_util.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -27,8 +28,75 @@ extern "C" {
  *
  * @brief This module implements the FatFs disk API. Internals of this module are based on block device.
  *
+ * @details Requests of a drive are queued and started one after the other from the event handler
+ *          of the block device, so that the block device is never idle while requests are
+ *          waiting. Multi-sector requests of FatFs are passed to the block device unchanged.
+ *
+ *          If @ref DISKIO_BLKDEV_WRITE_BUFFER_SIZE is set, writes that fit in the write buffer
+ *          are copied to it and succeed before they are performed. A failure of such a write is
+ *          reported by the next @ref disk_write or CTRL_SYNC request.
+ *
+ *          If @ref DISKIO_BLKDEV_READ_AHEAD_SIZE is set, a read that follows the previous one
+ *          queues a read of the next sectors into the read-ahead buffer. Sequential reads of a
+ *          file are then served from RAM while the block device reads ahead.
+ *
+ *          If @ref DISKIO_BLKDEV_CACHE_SECTORS is set, single sectors read or written by FatFs
+ *          are kept in a cache with LRU replacement, so that the FAT and directory sectors that
+ *          FatFs loads again for every file operation are read only once. Writes of the sectors
+ *          in front of the data area of the volume, the FAT and the FAT12/16 root directory, are
+ *          kept in the cache until the sector is evicted or CTRL_SYNC is requested. All other
+ *          writes are performed right away, and update the cache. The area is found in the boot
+ *          sector of the volume when FatFs reads it on mount.
  */
 
+/**
+ * @brief Number of requests that can be queued on a drive, 1 to 255.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ * */
+#ifndef DISKIO_BLKDEV_QUEUE_SIZE
+#define DISKIO_BLKDEV_QUEUE_SIZE 4
+#endif
+
+/**
+ * @brief Size of the write buffer of a drive, in bytes. 0 disables buffered writes.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ * */
+#ifndef DISKIO_BLKDEV_WRITE_BUFFER_SIZE
+#define DISKIO_BLKDEV_WRITE_BUFFER_SIZE 0
+#endif
+
+/**
+ * @brief Size of the read-ahead buffer of a drive, in bytes. 0 disables read-ahead.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ * */
+#ifndef DISKIO_BLKDEV_READ_AHEAD_SIZE
+#define DISKIO_BLKDEV_READ_AHEAD_SIZE 0
+#endif
+
+/**
+ * @brief Number of sectors in the cache of a drive. 0 disables the cache.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ * */
+#ifndef DISKIO_BLKDEV_CACHE_SECTORS
+#define DISKIO_BLKDEV_CACHE_SECTORS 0
+#endif
+
+/**
+ * @brief Sector size of the cache, in bytes. The cache is not used by block devices with another
+ *        block size.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ * */
+#ifndef DISKIO_BLKDEV_CACHE_SECTOR_SIZE
+#define DISKIO_BLKDEV_CACHE_SECTOR_SIZE 512
+#endif
+
+STATIC_ASSERT((DISKIO_BLKDEV_QUEUE_SIZE > 0) && (DISKIO_BLKDEV_QUEUE_SIZE <= UINT8_MAX));
+
 /**
  * @brief FatFs disk I/O block device configuration structure.
  * */
@@ -45,6 +113,37 @@ typedef struct
 } diskio_blkdev_config_t;
 
 
+/**
+ * @brief Counters of the sector cache.
+ * */
+typedef struct
+{
+    uint32_t hits;                      ///< Sector reads served from the cache.
+    uint32_t misses;                    ///< Sector reads from the block device.
+    uint32_t write_backs;               ///< Sector writes kept in the cache.
+    uint32_t flushes;                   ///< Sectors written back to the block device.
+} diskio_blkdev_cache_stats_t;
+
+/**
+ * @brief Queued request types.
+ * */
+typedef enum
+{
+    DISKIO_BLKDEV_REQ_READ,             ///< Read, waited for.
+    DISKIO_BLKDEV_REQ_WRITE,            ///< Write, waited for.
+    DISKIO_BLKDEV_REQ_WRITE_BUFFERED,   ///< Write from the write buffer.
+    DISKIO_BLKDEV_REQ_READ_AHEAD,       ///< Read into the read-ahead buffer.
+} diskio_blkdev_req_type_t;
+
+/**
+ * @brief Queued request.
+ * */
+typedef struct
+{
+    nrf_block_req_t req;                ///< Block device request.
+    uint8_t         type;               ///< Request type, @ref diskio_blkdev_req_type_t.
+} diskio_blkdev_req_t;
+
 /**
  * @brief Disk I/O block device.
  * */
@@ -54,6 +153,41 @@ typedef struct
     nrf_block_dev_result_t last_result;  ///< Result of the last I/O operation.
     volatile DSTATUS state;              ///< Current disk state.
     volatile bool    busy;               ///< Disk busy flag.
+
+    diskio_blkdev_req_t queue[DISKIO_BLKDEV_QUEUE_SIZE]; ///< Queued requests, the oldest one is in progress.
+    uint8_t           queue_head;        ///< Next free queue entry.
+    volatile uint8_t  queue_tail;        ///< Oldest queue entry.
+    volatile uint8_t  queue_count;       ///< Number of queued requests.
+    volatile bool     in_progress;       ///< The oldest request was started.
+    volatile bool     submitting;        ///< A request is being started.
+    volatile bool     write_error;       ///< A buffered write failed.
+    uint32_t          queued_count;      ///< Number of requests queued, ticket of the next request.
+    volatile uint32_t done_count;        ///< Number of requests completed.
+#if DISKIO_BLKDEV_WRITE_BUFFER_SIZE
+    uint32_t          write_buff[DISKIO_BLKDEV_WRITE_BUFFER_SIZE / sizeof(uint32_t)]; ///< Write buffer.
+    uint32_t          write_head;        ///< Offset of the free part of the write buffer.
+    volatile uint32_t write_tail;        ///< Offset of the oldest buffered write.
+    volatile uint8_t  write_count;       ///< Number of buffered writes queued.
+#endif
+#if DISKIO_BLKDEV_READ_AHEAD_SIZE
+    uint32_t          ra_buff[DISKIO_BLKDEV_READ_AHEAD_SIZE / sizeof(uint32_t)]; ///< Read-ahead buffer.
+    DWORD             ra_sector;         ///< First sector in the read-ahead buffer.
+    UINT              ra_count;          ///< Number of sectors in the read-ahead buffer.
+    DWORD             next_sector;       ///< Sector following the last read.
+    volatile bool     ra_pending;        ///< Read-ahead is queued.
+    volatile bool     ra_valid;          ///< Read-ahead succeeded.
+#endif
+#if DISKIO_BLKDEV_CACHE_SECTORS
+    uint32_t          cache_buff[DISKIO_BLKDEV_CACHE_SECTORS][DISKIO_BLKDEV_CACHE_SECTOR_SIZE / sizeof(uint32_t)]; ///< Cached sectors.
+    DWORD             cache_sector[DISKIO_BLKDEV_CACHE_SECTORS]; ///< Sector number of each entry.
+    uint32_t          cache_used[DISKIO_BLKDEV_CACHE_SECTORS];   ///< Last use of each entry, for LRU replacement.
+    uint8_t           cache_flags[DISKIO_BLKDEV_CACHE_SECTORS];  ///< Entry is valid and dirty flags.
+    uint32_t          cache_clock;       ///< Number of cache accesses.
+    bool              cache_enabled;     ///< The block size matches the cache.
+    DWORD             meta_start;        ///< First sector of the FAT area, written back.
+    DWORD             meta_end;          ///< Sector following the FAT area.
+    diskio_blkdev_cache_stats_t cache_stats; ///< Cache counters.
+#endif
 } diskio_blkdev_t;
 
 /**
@@ -139,6 +273,16 @@ DRESULT disk_write(BYTE drv, const BYTE* buff, DWORD sector, UINT count);
 DRESULT disk_ioctl(BYTE drv, BYTE cmd, void* buff);
 
 
+#if DISKIO_BLKDEV_CACHE_SECTORS
+/**
+ * @brief Gets the counters of the sector cache of a drive.
+ *
+ * @param[in]  drv     Drive number.
+ * @param[out] p_stats Counters since the drive was initialized.
+ * */
+void diskio_blkdev_cache_stats_get(BYTE drv, diskio_blkdev_cache_stats_t * p_stats);
+#endif
+
 /**
  * @brief Registers a block device array.
  *
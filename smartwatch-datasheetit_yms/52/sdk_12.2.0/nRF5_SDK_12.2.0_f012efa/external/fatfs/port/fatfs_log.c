@@ -0,0 +1,335 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include <string.h>
+#include "fatfs_log.h"
+#include "app_util.h"
+
+#if !_USE_FASTSEEK || !_USE_EXPAND
+#error "fatfs_log needs _USE_FASTSEEK and _USE_EXPAND."
+#endif
+
+STATIC_ASSERT(_MIN_SS == _MAX_SS);
+
+#define LOG_SECTOR_SIZE  _MAX_SS            /**< Sector size of the volume.*/
+#define LOG_DATA_OFFSET  LOG_SECTOR_SIZE    /**< Offset of the data in the file, after the header.*/
+#define LOG_MAGIC        0x474F4C46         /**< Header magic ("FLOG").*/
+
+/**
+ * @brief Header of a log file, at the start of its first sector.
+ * */
+typedef struct
+{
+    uint32_t magic;         ///< @ref LOG_MAGIC
+    uint32_t length;        ///< Bytes of data.
+    uint32_t length_inv;    ///< Inverted length, to check the header.
+    uint32_t capacity;      ///< Bytes of data the file can hold.
+} log_header_t;
+
+/**
+ * @brief Writes whole sectors of data straight from a buffer.
+ *
+ * The file is allocated, so FatFs writes them without reading them first.
+ * */
+static FRESULT log_sectors_write(fatfs_log_t * p_log, FSIZE_t offset, void const * p_data,
+                                 UINT count)
+{
+    UINT written;
+    FRESULT res = f_lseek(&p_log->file, LOG_DATA_OFFSET + offset);
+
+    if (res == FR_OK)
+    {
+        res = f_write(&p_log->file, p_data, count * LOG_SECTOR_SIZE, &written);
+    }
+    if ((res == FR_OK) && (written != count * LOG_SECTOR_SIZE))
+    {
+        res = FR_DISK_ERR;
+    }
+    return res;
+}
+
+/**
+ * @brief Writes the header. It goes through the sector buffer of the file.
+ * */
+static FRESULT log_header_write(fatfs_log_t * p_log)
+{
+    log_header_t header = {
+        .magic      = LOG_MAGIC,
+        .length     = (uint32_t)p_log->length,
+        .length_inv = ~(uint32_t)p_log->length,
+        .capacity   = (uint32_t)p_log->capacity,
+    };
+    UINT written;
+    FRESULT res = f_lseek(&p_log->file, 0);
+
+    if (res == FR_OK)
+    {
+        res = f_write(&p_log->file, &header, sizeof(header), &written);
+    }
+    if ((res == FR_OK) && (written != sizeof(header)))
+    {
+        res = FR_DISK_ERR;
+    }
+    if (res == FR_OK)
+    {
+        p_log->header_dirty = false;
+    }
+    return res;
+}
+
+/**
+ * @brief Allocates a new log file, contiguous if there is a free area large enough.
+ * */
+static FRESULT log_create(fatfs_log_t * p_log, FSIZE_t capacity)
+{
+    FSIZE_t size = LOG_DATA_OFFSET + capacity;
+    FRESULT res = f_expand(&p_log->file, size, 1);
+
+    if (res == FR_DENIED)
+    {
+        /*No free area is large enough: clusters are allocated one by one*/
+        res = f_lseek(&p_log->file, size);
+        if ((res == FR_OK) && (f_size(&p_log->file) != size))
+        {
+            res = FR_DENIED;
+        }
+    }
+    if (res != FR_OK)
+    {
+        return res;
+    }
+
+    p_log->capacity = capacity;
+    p_log->length = 0;
+    res = log_header_write(p_log);
+    if (res == FR_OK)
+    {
+        res = f_sync(&p_log->file);
+    }
+    return res;
+}
+
+/**
+ * @brief Reads the header of an existing log file and its partial last sector.
+ * */
+static FRESULT log_load(fatfs_log_t * p_log)
+{
+    log_header_t header;
+    UINT read;
+    FRESULT res = f_read(&p_log->file, &header, sizeof(header), &read);
+
+    if (res != FR_OK)
+    {
+        return res;
+    }
+    if ((read != sizeof(header)) || (header.magic != LOG_MAGIC) ||
+        (header.length != ~header.length_inv) || (header.length > header.capacity) ||
+        (header.capacity > f_size(&p_log->file) - LOG_DATA_OFFSET))
+    {
+        return FR_INVALID_OBJECT;
+    }
+
+    p_log->capacity = header.capacity;
+    p_log->length = header.length;
+
+    UINT used = p_log->length % LOG_SECTOR_SIZE;
+    if (used != 0)
+    {
+        res = f_lseek(&p_log->file, LOG_DATA_OFFSET + p_log->length - used);
+        if (res == FR_OK)
+        {
+            res = f_read(&p_log->file, p_log->tail, LOG_SECTOR_SIZE, &read);
+        }
+        if ((res == FR_OK) && (read != LOG_SECTOR_SIZE))
+        {
+            res = FR_DISK_ERR;
+        }
+    }
+    return res;
+}
+
+FRESULT fatfs_log_open(fatfs_log_t * p_log, TCHAR const * path, FSIZE_t capacity)
+{
+    FRESULT res;
+
+    memset(p_log, 0, sizeof(fatfs_log_t));
+    res = f_open(&p_log->file, path, FA_READ | FA_WRITE | FA_OPEN_ALWAYS);
+    if (res != FR_OK)
+    {
+        return res;
+    }
+
+    bool created = (f_size(&p_log->file) == 0);
+    if (created)
+    {
+        res = log_create(p_log, CEIL_DIV(capacity, LOG_SECTOR_SIZE) * LOG_SECTOR_SIZE);
+    }
+    else if (f_size(&p_log->file) < LOG_DATA_OFFSET)
+    {
+        res = FR_INVALID_OBJECT;
+    }
+
+    if (res == FR_OK)
+    {
+        /*The size of the file does not change, so the map stays valid*/
+        p_log->link_map[0] = FATFS_LOG_LINK_MAP_SIZE;
+        p_log->file.cltbl = p_log->link_map;
+        res = f_lseek(&p_log->file, CREATE_LINKMAP);
+        if (res == FR_NOT_ENOUGH_CORE)
+        {
+            /*Too many fragments: FatFs follows the FAT*/
+            p_log->file.cltbl = NULL;
+            res = FR_OK;
+        }
+    }
+
+    if ((res == FR_OK) && !created)
+    {
+        res = f_lseek(&p_log->file, 0);
+        if (res == FR_OK)
+        {
+            res = log_load(p_log);
+        }
+    }
+
+    if (res != FR_OK)
+    {
+        (void)f_close(&p_log->file);
+    }
+    return res;
+}
+
+FRESULT fatfs_log_append(fatfs_log_t * p_log, void const * p_data, UINT size)
+{
+    BYTE const * p_src = p_data;
+
+    if (size > p_log->capacity - p_log->length)
+    {
+        return FR_DENIED;
+    }
+
+    while (size > 0)
+    {
+        UINT used = p_log->length % LOG_SECTOR_SIZE;
+        UINT count;
+
+        if ((used == 0) && (size >= LOG_SECTOR_SIZE))
+        {
+            /*Whole sectors from the caller buffer*/
+            count = size - size % LOG_SECTOR_SIZE;
+            FRESULT res = log_sectors_write(p_log, p_log->length, p_src,
+                                            count / LOG_SECTOR_SIZE);
+            if (res != FR_OK)
+            {
+                return res;
+            }
+        }
+        else
+        {
+            count = MIN(LOG_SECTOR_SIZE - used, size);
+            memcpy(&p_log->tail[used], p_src, count);
+            if (used + count == LOG_SECTOR_SIZE)
+            {
+                FRESULT res = log_sectors_write(p_log, p_log->length - used, p_log->tail, 1);
+                if (res != FR_OK)
+                {
+                    return res;
+                }
+            }
+        }
+
+        p_log->length += count;
+        p_log->header_dirty = true;
+        p_src += count;
+        size -= count;
+    }
+
+    return FR_OK;
+}
+
+FRESULT fatfs_log_read(fatfs_log_t * p_log,
+                       FSIZE_t       offset,
+                       void        * p_data,
+                       UINT          size,
+                       UINT        * p_read)
+{
+    FSIZE_t written = p_log->length - p_log->length % LOG_SECTOR_SIZE;
+    UINT    read = 0;
+
+    *p_read = 0;
+    if (offset >= p_log->length)
+    {
+        return FR_OK;
+    }
+    size = (UINT)MIN(size, p_log->length - offset);
+
+    if (offset < written)
+    {
+        UINT count = (UINT)MIN(size, written - offset);
+        FRESULT res = f_lseek(&p_log->file, LOG_DATA_OFFSET + offset);
+        if (res == FR_OK)
+        {
+            res = f_read(&p_log->file, p_data, count, &read);
+        }
+        if ((res == FR_OK) && (read != count))
+        {
+            res = FR_DISK_ERR;
+        }
+        if (res != FR_OK)
+        {
+            return res;
+        }
+    }
+
+    /*The rest is in the partial last sector*/
+    if (read < size)
+    {
+        memcpy((BYTE *)p_data + read, &p_log->tail[offset + read - written], size - read);
+    }
+
+    *p_read = size;
+    return FR_OK;
+}
+
+FRESULT fatfs_log_sync(fatfs_log_t * p_log)
+{
+    FRESULT res = FR_OK;
+
+    if (!p_log->header_dirty)
+    {
+        return f_sync(&p_log->file);
+    }
+
+    UINT used = p_log->length % LOG_SECTOR_SIZE;
+    if (used != 0)
+    {
+        memset(&p_log->tail[used], 0xFF, LOG_SECTOR_SIZE - used);
+        res = log_sectors_write(p_log, p_log->length - used, p_log->tail, 1);
+    }
+    if (res == FR_OK)
+    {
+        res = log_header_write(p_log);
+    }
+    if (res == FR_OK)
+    {
+        res = f_sync(&p_log->file);
+    }
+    return res;
+}
+
+FRESULT fatfs_log_close(fatfs_log_t * p_log)
+{
+    FRESULT res = fatfs_log_sync(p_log);
+    FRESULT close_res = f_close(&p_log->file);
+
+    return (res != FR_OK) ? res : close_res;
+}
@@ -0,0 +1,148 @@
+/* Copyright (c) 2017 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef FATFS_LOG_H_
+#define FATFS_LOG_H_
+
+#include <stdbool.h>
+#include "ff.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**@file
+ *
+ * @defgroup fatfs_log Log files on FatFs
+ * @{
+ *
+ * @brief Append-only log files with constant time appends and random reads.
+ *
+ * @details A log file is allocated to its full capacity when it is created, with f_expand, so
+ *          that its clusters are contiguous if the volume has a free area large enough. Its
+ *          cluster link map is created when it is opened and kept with the file, so that FatFs
+ *          seeks in it without following the FAT chain (fast seek).
+ *
+ *          The first sector of the file holds a header with the length of the data. The data
+ *          follows it. Appended data is written in whole sectors: sectors filled by the caller
+ *          buffer are written straight from it, and the last, partial, sector is kept in RAM.
+ *          A sector of the file is therefore never read before it is written.
+ *
+ *          As with FatFs files, appended data is kept over a reset only after
+ *          @ref fatfs_log_sync or @ref fatfs_log_close.
+ *
+ * @note _USE_FASTSEEK and _USE_EXPAND must be enabled in ffconf.h.
+ */
+
+/**
+ * @brief Number of items of the cluster link map of a log file. A file in one fragment needs 4,
+ *        every other fragment 2 more. A file with more fragments is read by following the FAT.
+ *
+ * This define should be defined in the sdk_config.h file to override the default.
+ * */
+#ifndef FATFS_LOG_LINK_MAP_SIZE
+#define FATFS_LOG_LINK_MAP_SIZE 8
+#endif
+
+/**
+ * @brief Log file. Its content must not be accessed by the application.
+ * */
+typedef struct
+{
+    FIL     file;                               ///< FatFs file.
+    DWORD   link_map[FATFS_LOG_LINK_MAP_SIZE];  ///< Cluster link map of the file.
+    FSIZE_t capacity;                           ///< Bytes of data the file can hold.
+    FSIZE_t length;                             ///< Bytes of data in the file.
+    bool    header_dirty;                       ///< The length changed since the header was written.
+    BYTE    tail[_MAX_SS];                      ///< Data of the partial last sector.
+} fatfs_log_t;
+
+/**
+ * @brief Opens a log file, or creates it.
+ *
+ * @param[out] p_log    Log file.
+ * @param[in]  path     Path of the file.
+ * @param[in]  capacity Bytes of data of a new file, rounded up to whole sectors. Not used if the
+ *                      file exists.
+ *
+ * @retval FR_OK             If the log file was opened.
+ * @retval FR_DENIED         If the volume has no space for a new file.
+ * @retval FR_INVALID_OBJECT If the file exists, but is not a log file.
+ * @return Any error returned by FatFs.
+ */
+FRESULT fatfs_log_open(fatfs_log_t * p_log, TCHAR const * path, FSIZE_t capacity);
+
+/**
+ * @brief Appends data to a log file.
+ *
+ * @param[in] p_log  Log file.
+ * @param[in] p_data Data.
+ * @param[in] size   Bytes of data.
+ *
+ * @retval FR_OK     If the data was appended.
+ * @retval FR_DENIED If the data does not fit in the capacity of the file. Nothing is appended.
+ * @return Any error returned by FatFs.
+ */
+FRESULT fatfs_log_append(fatfs_log_t * p_log, void const * p_data, UINT size);
+
+/**
+ * @brief Reads data from a log file.
+ *
+ * @param[in]  p_log  Log file.
+ * @param[in]  offset Offset of the data.
+ * @param[out] p_data Buffer.
+ * @param[in]  size   Bytes to read.
+ * @param[out] p_read Bytes read, less than size at the end of the data.
+ *
+ * @return FR_OK or any error returned by FatFs.
+ */
+FRESULT fatfs_log_read(fatfs_log_t * p_log,
+                       FSIZE_t       offset,
+                       void        * p_data,
+                       UINT          size,
+                       UINT        * p_read);
+
+/**
+ * @brief Writes the appended data and the length of a log file to the volume.
+ *
+ * @param[in] p_log Log file.
+ *
+ * @return FR_OK or any error returned by FatFs.
+ */
+FRESULT fatfs_log_sync(fatfs_log_t * p_log);
+
+/**
+ * @brief Synchronizes and closes a log file.
+ *
+ * @param[in] p_log Log file.
+ *
+ * @return FR_OK or any error returned by FatFs.
+ */
+FRESULT fatfs_log_close(fatfs_log_t * p_log);
+
+/**
+ * @brief Returns the length of the data of a log file.
+ *
+ * @param[in] p_log Log file.
+ */
+static inline FSIZE_t fatfs_log_length(fatfs_log_t const * p_log)
+{
+    return p_log->length;
+}
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FATFS_LOG_H_ */
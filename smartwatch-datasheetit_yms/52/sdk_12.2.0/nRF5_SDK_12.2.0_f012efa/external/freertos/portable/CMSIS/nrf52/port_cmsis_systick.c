@@ -150,23 +150,98 @@ void vPortSetupTimerInterrupt( void )
 #include "nrf_rtc.h"
 #include "nrf_drv_clock.h"
 
+/*
+ * The RTC runs at the full LFCLK rate and every tick is set up on compare 0.
+ * The LFCLK is not a multiple of the tick rate, so the remainder of the tick
+ * period is accumulated and adds one RTC count when it is complete. Over time
+ * the ticks follow the RTC exactly, which a prescaled RTC does not do
+ * (32768 Hz / 33 is 993 Hz instead of 1000 Hz).
+ */
+#define portNRF_RTC_TICK_COUNTS     ( configSYSTICK_CLOCK_HZ / configTICK_RATE_HZ )
+#define portNRF_RTC_TICK_REMAINDER  ( configSYSTICK_CLOCK_HZ % configTICK_RATE_HZ )
+
+/* Ticks that can be suppressed: the wakeup must stay within half of the counter
+ * range to be told apart from a time in the past. */
+#define portNRF_RTC_MAX_IDLE_TICKS  ( ( portNRF_RTC_MAXTICKS / 2 ) / ( portNRF_RTC_TICK_COUNTS + 1 ) )
+
+/* The RTC does not generate a compare event for a value less than 2 counts ahead. */
+#define portNRF_RTC_MIN_CC_DISTANCE 2
+
+static uint32_t m_tick_cc;    /* RTC counter value of the next tick. */
+static uint32_t m_tick_frac;  /* Accumulated remainder, in 1/configTICK_RATE_HZ of an RTC count. */
+
+/*-----------------------------------------------------------*/
+
+/* Move the RTC counter value of a tick forward by a number of ticks. */
+static void prvTickAdvance( uint32_t * pulCC, uint32_t * pulFrac, uint32_t ulTicks )
+{
+    uint64_t ullFrac = *pulFrac + (uint64_t)ulTicks * portNRF_RTC_TICK_REMAINDER;
+
+    *pulCC   = ( *pulCC + ulTicks * portNRF_RTC_TICK_COUNTS + (uint32_t)( ullFrac / configTICK_RATE_HZ ) ) & portNRF_RTC_MAXTICKS;
+    *pulFrac = (uint32_t)( ullFrac % configTICK_RATE_HZ );
+}
+
+/* Check if the RTC counter has reached a value. */
+static BaseType_t prvTickReached( uint32_t ulCC, uint32_t ulCounter )
+{
+    return ( ( ( ulCounter - ulCC ) & portNRF_RTC_MAXTICKS ) < ( portNRF_RTC_MAXTICKS / 2 ) ) ? pdTRUE : pdFALSE;
+}
+
+/*
+ * Count the ticks that have passed since the last call, and set compare 0 to
+ * the next tick. No tick is lost when the interrupt was delayed, or when the
+ * tick was suppressed.
+ */
+static uint32_t prvTicksElapsed( void )
+{
+    uint32_t ulTicks = 0;
+
+    for ( ;; )
+    {
+        uint32_t ulCounter = nrf_rtc_counter_get(portNRF_RTC_REG);
+
+        while ( prvTickReached(m_tick_cc, ulCounter) != pdFALSE )
+        {
+            prvTickAdvance(&m_tick_cc, &m_tick_frac, 1);
+            ulTicks++;
+        }
+
+        nrf_rtc_cc_set(portNRF_RTC_REG, 0, m_tick_cc);
+
+        /* Too close to generate an event: wait for the tick here instead. */
+        if ( ( ( m_tick_cc - nrf_rtc_counter_get(portNRF_RTC_REG) ) & portNRF_RTC_MAXTICKS ) >= portNRF_RTC_MIN_CC_DISTANCE )
+        {
+            break;
+        }
+    }
+
+    return ulTicks;
+}
 
 /*-----------------------------------------------------------*/
 
 void xPortSysTickHandler( void )
 {
-    nrf_rtc_event_clear(portNRF_RTC_REG, NRF_RTC_EVENT_TICK);
-#if configUSE_TICKLESS_IDLE == 1
+    uint32_t ulTicks;
+    BaseType_t xSwitchRequired = pdFALSE;
+
     nrf_rtc_event_clear(portNRF_RTC_REG, NRF_RTC_EVENT_COMPARE_0);
-#endif
 
     /* The SysTick runs at the lowest interrupt priority, so when this interrupt
     executes all interrupts must be unmasked.  There is therefore no need to
     save and then restore the interrupt mask value as its value is already
     known. */
     ( void ) portSET_INTERRUPT_MASK_FROM_ISR();
-    /* Increment the RTOS tick. */
-    if ( xTaskIncrementTick() != pdFALSE )
+    ulTicks = prvTicksElapsed();
+    while ( ulTicks-- > 0 )
+    {
+        /* Increment the RTOS tick. */
+        if ( xTaskIncrementTick() != pdFALSE )
+        {
+            xSwitchRequired = pdTRUE;
+        }
+    }
+    if ( xSwitchRequired != pdFALSE )
     {
         /* A context switch is required.  Context switching is performed in
         the PendSV interrupt.  Pend the PendSV interrupt. */
@@ -185,10 +260,17 @@ void vPortSetupTimerInterrupt( void )
     /* Request LF clock */
     nrf_drv_clock_lfclk_request(NULL);
 
-    /* Configure SysTick to interrupt at the requested rate. */
-    nrf_rtc_prescaler_set(portNRF_RTC_REG, portNRF_RTC_PRESCALER);
-    nrf_rtc_int_enable   (portNRF_RTC_REG, RTC_INTENSET_TICK_Msk);
+    /* Configure the RTC to interrupt at the requested rate. */
+    nrf_rtc_prescaler_set(portNRF_RTC_REG, 0);
     nrf_rtc_task_trigger (portNRF_RTC_REG, NRF_RTC_TASK_CLEAR);
+
+    m_tick_cc   = 0;
+    m_tick_frac = 0;
+    prvTickAdvance(&m_tick_cc, &m_tick_frac, 1);
+
+    nrf_rtc_cc_set       (portNRF_RTC_REG, 0, m_tick_cc);
+    nrf_rtc_event_clear  (portNRF_RTC_REG, NRF_RTC_EVENT_COMPARE_0);
+    nrf_rtc_int_enable   (portNRF_RTC_REG, NRF_RTC_INT_COMPARE0_MASK);
     nrf_rtc_task_trigger (portNRF_RTC_REG, NRF_RTC_TASK_START);
 
     NVIC_SetPriority(portNRF_RTC_IRQn, configKERNEL_INTERRUPT_PRIORITY);
@@ -209,12 +291,9 @@ void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
      * Normally RTC works all the time even if firmware execution was stopped
      * and that may lead to skipping too much of ticks.
      */
-    TickType_t enterTime;
-
-    /* Make sure the SysTick reload value does not overflow the counter. */
-    if ( xExpectedIdleTime > portNRF_RTC_MAXTICKS - configEXPECTED_IDLE_TIME_BEFORE_SLEEP )
+    if ( xExpectedIdleTime > portNRF_RTC_MAX_IDLE_TICKS )
     {
-        xExpectedIdleTime = portNRF_RTC_MAXTICKS - configEXPECTED_IDLE_TIME_BEFORE_SLEEP;
+        xExpectedIdleTime = portNRF_RTC_MAX_IDLE_TICKS;
     }
     /* Block all the interrupts globally */
 #ifdef SOFTDEVICE_PRESENT
@@ -227,20 +306,17 @@ void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
     __disable_irq();
 #endif
 
-    enterTime = nrf_rtc_counter_get(portNRF_RTC_REG);
-
     if ( eTaskConfirmSleepModeStatus() != eAbortSleep )
     {
         TickType_t xModifiableIdleTime;
-        TickType_t wakeupTime = (enterTime + xExpectedIdleTime) & portNRF_RTC_MAXTICKS;
-
-        /* Stop tick events */
-        nrf_rtc_int_disable(portNRF_RTC_REG, NRF_RTC_INT_TICK_MASK);
+        TickType_t xElapsed;
+        TickType_t xStep;
+        uint32_t   wakeupCC   = m_tick_cc;
+        uint32_t   wakeupFrac = m_tick_frac;
 
-        /* Configure CTC interrupt */
-        nrf_rtc_cc_set(portNRF_RTC_REG, 0, wakeupTime);
-        nrf_rtc_event_clear(portNRF_RTC_REG, NRF_RTC_EVENT_COMPARE_0);
-        nrf_rtc_int_enable(portNRF_RTC_REG, NRF_RTC_INT_COMPARE0_MASK);
+        /* The next tick is the first one suppressed, wake up at the last one. */
+        prvTickAdvance(&wakeupCC, &wakeupFrac, xExpectedIdleTime - 1);
+        nrf_rtc_cc_set(portNRF_RTC_REG, 0, wakeupCC);
 
         __DSB();
 
@@ -253,36 +329,48 @@ void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
         configPRE_SLEEP_PROCESSING( xModifiableIdleTime );
         if ( xModifiableIdleTime > 0 )
         {
-            do{
-                __WFE();
-            } while (0 == (NVIC->ISPR[0] | NVIC->ISPR[1]));
-        }
-        configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
-        nrf_rtc_int_disable(portNRF_RTC_REG, NRF_RTC_INT_COMPARE0_MASK);
-
-        /* Correct the system ticks */
-        {
-            TickType_t diff;
-            TickType_t hwTicks     = nrf_rtc_counter_get(portNRF_RTC_REG);
-
-            nrf_rtc_event_clear(portNRF_RTC_REG, NRF_RTC_EVENT_TICK);
-            nrf_rtc_int_enable (portNRF_RTC_REG, NRF_RTC_INT_TICK_MASK);
-
-            if(enterTime > hwTicks)
+#ifdef SOFTDEVICE_PRESENT
+            if ( softdevice_handler_is_enabled() )
             {
-                hwTicks += portNRF_RTC_MAXTICKS + 1U;
+                /* The SoftDevice wakes up on the pending interrupts that are
+                 * disabled by the critical region. */
+                uint32_t err_code = sd_app_evt_wait();
+                APP_ERROR_CHECK(err_code);
             }
-
-            diff = (hwTicks - enterTime);
-            if((configUSE_TICKLESS_IDLE_SIMPLE_DEBUG) && (diff > xExpectedIdleTime))
+            else
+#endif
             {
-                diff = xExpectedIdleTime;
+                do{
+                    __WFE();
+                } while (0 == (NVIC->ISPR[0] | NVIC->ISPR[1]));
             }
+        }
+        configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
 
-            if (diff > 0)
-            {
-                vTaskStepTick(diff);
-            }
+        /* Correct the system ticks. The ticks are counted here from the RTC,
+         * including the one that woke up the CPU, so the tick interrupt must
+         * not count it again. */
+        nrf_rtc_event_clear(portNRF_RTC_REG, NRF_RTC_EVENT_COMPARE_0);
+        NVIC_ClearPendingIRQ(portNRF_RTC_IRQn);
+
+        xElapsed = prvTicksElapsed();
+        if ( (configUSE_TICKLESS_IDLE_SIMPLE_DEBUG) && (xElapsed > xExpectedIdleTime) )
+        {
+            xElapsed = xExpectedIdleTime;
+        }
+
+        /* The tick count is stepped up to the tick before the next task
+         * unblocks. The other ticks go through xTaskIncrementTick(), which
+         * keeps them pending while the scheduler is suspended, so that the
+         * task is unblocked on time. */
+        xStep = ( xElapsed < xExpectedIdleTime ) ? xElapsed : ( xExpectedIdleTime - 1 );
+        if ( xStep > 0 )
+        {
+            vTaskStepTick(xStep);
+        }
+        while ( xElapsed-- > xStep )
+        {
+            ( void ) xTaskIncrementTick();
         }
     }
 #ifdef SOFTDEVICE_PRESENT
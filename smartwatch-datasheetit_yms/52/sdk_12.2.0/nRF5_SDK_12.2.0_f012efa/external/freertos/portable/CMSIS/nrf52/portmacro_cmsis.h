@@ -121,8 +121,6 @@ typedef unsigned long UBaseType_t;
 #define portNRF_RTC_REG        NRF_RTC1
 /* IRQn used by the selected RTC */
 #define portNRF_RTC_IRQn       RTC1_IRQn
-/* Constants required to manipulate the NVIC. */
-#define portNRF_RTC_PRESCALER  ( (uint32_t) (ROUNDED_DIV(configSYSTICK_CLOCK_HZ, configTICK_RATE_HZ) - 1) )
 /* Maximum RTC ticks */
 #define portNRF_RTC_MAXTICKS   ((1U<<24)-1U)
 /*-----------------------------------------------------------*/
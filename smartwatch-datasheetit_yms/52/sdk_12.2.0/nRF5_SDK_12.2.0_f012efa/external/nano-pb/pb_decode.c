@@ -24,6 +24,11 @@
 typedef bool (*pb_decoder_t)(pb_istream_t *stream, const pb_field_t *field, void *dest) checkreturn;
 
 static bool checkreturn buf_read(pb_istream_t *stream, pb_byte_t *buf, size_t count);
+#ifndef PB_BUFFER_ONLY
+static bool checkreturn chunk_read(pb_istream_t *stream, pb_byte_t *buf, size_t count);
+#endif
+static size_t direct_bytes(pb_istream_t *stream, const pb_byte_t **data);
+static void direct_skip(pb_istream_t *stream, size_t count);
 static bool checkreturn pb_decode_varint32(pb_istream_t *stream, uint32_t *dest);
 static bool checkreturn read_raw_value(pb_istream_t *stream, pb_wire_type_t wire_type, pb_byte_t *buf, size_t *size);
 static bool checkreturn decode_static_field(pb_istream_t *stream, pb_wire_type_t wire_type, pb_field_iter_t *iter);
@@ -89,7 +94,7 @@ static bool checkreturn buf_read(pb_istream_t *stream, pb_byte_t *buf, size_t co
 bool checkreturn pb_read(pb_istream_t *stream, pb_byte_t *buf, size_t count)
 {
 #ifndef PB_BUFFER_ONLY
-	if (buf == NULL && stream->callback != buf_read)
+	if (buf == NULL && stream->callback != buf_read && stream->callback != chunk_read)
 	{
 		/* Skip input bytes */
 		pb_byte_t tmp[16];
@@ -165,6 +170,99 @@ pb_istream_t pb_istream_from_buffer(const pb_byte_t *buf, size_t bufsize)
     return stream;
 }
 
+#ifndef PB_BUFFER_ONLY
+/* Copies from the current chunk, and gets the next one when it has been read.
+ * buf may be NULL for skipping. */
+static bool checkreturn chunk_read(pb_istream_t *stream, pb_byte_t *buf, size_t count)
+{
+    pb_chunk_state_t *state = (pb_chunk_state_t*)stream->state;
+    
+    while (count > 0)
+    {
+        size_t len;
+        
+        if (state->chunk_left == 0)
+        {
+            if (!state->callback(state->context, &state->chunk, &state->chunk_left))
+                return false;
+            
+            if (state->chunk_left == 0)
+            {
+                /* End of data. Between two fields, this ends the message. */
+                stream->bytes_left = 0;
+                return false;
+            }
+        }
+        
+        len = (count < state->chunk_left) ? count : state->chunk_left;
+        if (buf != NULL)
+        {
+            memcpy(buf, state->chunk, len);
+            buf += len;
+        }
+        state->chunk += len;
+        state->chunk_left -= len;
+        count -= len;
+    }
+    
+    return true;
+}
+
+pb_istream_t pb_istream_from_chunks(pb_chunk_state_t *state, pb_chunk_callback_t callback, void *context, size_t msgsize)
+{
+    pb_istream_t stream;
+    state->callback = callback;
+    state->context = context;
+    state->chunk = NULL;
+    state->chunk_left = 0;
+    stream.callback = &chunk_read;
+    stream.state = state;
+    stream.bytes_left = msgsize;
+    stream.decoding_callback = NULL;
+#ifndef PB_NO_ERRMSG
+    stream.errmsg = NULL;
+#endif
+    return stream;
+}
+#endif
+
+/* Give the bytes of the stream that are already in memory, so that they can
+ * be decoded in place without the stream callback. Returns their count. */
+static size_t direct_bytes(pb_istream_t *stream, const pb_byte_t **data)
+{
+#ifndef PB_BUFFER_ONLY
+    if (stream->callback == &chunk_read)
+    {
+        pb_chunk_state_t *state = (pb_chunk_state_t*)stream->state;
+        *data = state->chunk;
+        return (state->chunk_left < stream->bytes_left) ? state->chunk_left : stream->bytes_left;
+    }
+    
+    if (stream->callback != &buf_read)
+        return 0;
+#endif
+    *data = (const pb_byte_t*)stream->state;
+    return stream->bytes_left;
+}
+
+/* Consume count bytes that were given by direct_bytes. */
+static void direct_skip(pb_istream_t *stream, size_t count)
+{
+#ifndef PB_BUFFER_ONLY
+    if (stream->callback == &chunk_read)
+    {
+        pb_chunk_state_t *state = (pb_chunk_state_t*)stream->state;
+        state->chunk += count;
+        state->chunk_left -= count;
+    }
+    else
+#endif
+    {
+        stream->state = (pb_byte_t*)stream->state + count;
+    }
+    stream->bytes_left -= count;
+}
+
 /********************
  * Helper functions *
  ********************/
@@ -173,6 +271,37 @@ static bool checkreturn pb_decode_varint32(pb_istream_t *stream, uint32_t *dest)
 {
     pb_byte_t byte;
     uint32_t result;
+    const pb_byte_t *data;
+    size_t avail = direct_bytes(stream, &data);
+    
+    if (avail > 0)
+    {
+        /* Fast path: the varint is decoded in place when all of its
+         * bytes are in memory. A 32-bit value has at most 5 bytes. */
+        size_t i = 0;
+        result = 0;
+        if (avail > 5)
+            avail = 5;
+        
+        do
+        {
+            byte = data[i];
+            result |= (uint32_t)(byte & 0x7F) << (7 * i);
+            i++;
+        } while ((byte & 0x80) && i < avail);
+        
+        if ((byte & 0x80) == 0)
+        {
+            direct_skip(stream, i);
+            *dest = result;
+            return true;
+        }
+        
+        if (i == 5)
+            PB_RETURN_ERROR(stream, "varint overflow");
+        
+        /* The varint continues in the next chunk, read it byte by byte. */
+    }
     
     if (!pb_readbyte(stream, &byte))
         return false;
@@ -210,6 +339,35 @@ bool checkreturn pb_decode_varint(pb_istream_t *stream, uint64_t *dest)
     pb_byte_t byte;
     uint_fast8_t bitpos = 0;
     uint64_t result = 0;
+    const pb_byte_t *data;
+    size_t avail = direct_bytes(stream, &data);
+    
+    if (avail > 0)
+    {
+        /* Fast path as in pb_decode_varint32, with at most 10 bytes. */
+        size_t i = 0;
+        if (avail > 10)
+            avail = 10;
+        
+        do
+        {
+            byte = data[i];
+            result |= (uint64_t)(byte & 0x7F) << (7 * i);
+            i++;
+        } while ((byte & 0x80) && i < avail);
+        
+        if ((byte & 0x80) == 0)
+        {
+            direct_skip(stream, i);
+            *dest = result;
+            return true;
+        }
+        
+        if (i == 10)
+            PB_RETURN_ERROR(stream, "varint overflow");
+        
+        result = 0;
+    }
     
     do
     {
@@ -643,6 +801,24 @@ static bool checkreturn decode_callback_field(pb_istream_t *stream, pb_wire_type
     }
 }
 
+#ifdef PB_OLD_CALLBACK_STYLE
+bool checkreturn pb_decode_repeated_item(pb_istream_t *stream, const pb_field_t *field, void *arg)
+{
+    pb_repeated_item_t *item = (pb_repeated_item_t*)arg;
+#else
+bool checkreturn pb_decode_repeated_item(pb_istream_t *stream, const pb_field_t *field, void **arg)
+{
+    pb_repeated_item_t *item = (pb_repeated_item_t*)*arg;
+#endif
+    PB_UNUSED(field);
+    
+    /* The substream holds exactly one item. */
+    if (!pb_decode(stream, item->fields, item->dest_struct))
+        return false;
+    
+    return item->callback(item->dest_struct, item->context);
+}
+
 static bool checkreturn decode_field(pb_istream_t *stream, pb_wire_type_t wire_type, pb_field_iter_t *iter)
 {
 #ifdef PB_ENABLE_MALLOC
@@ -108,6 +108,33 @@ void pb_release(const pb_field_t fields[], void *dest_struct);
  */
 pb_istream_t pb_istream_from_buffer(const pb_byte_t *buf, size_t bufsize);
 
+#ifndef PB_BUFFER_ONLY
+/* Callback that gives the next chunk of a chunked input stream, for example
+ * the next received packet. Sets *buf and *count to the chunk, which must
+ * stay valid until the next call. At the end of the data, sets *count to 0
+ * and returns true. Returns false on IO errors.
+ */
+typedef bool (*pb_chunk_callback_t)(void *context, const pb_byte_t **buf, size_t *count);
+
+typedef struct pb_chunk_state_s
+{
+    pb_chunk_callback_t callback;
+    void *context;
+    const pb_byte_t *chunk;  /* Unread part of the current chunk */
+    size_t chunk_left;
+} pb_chunk_state_t;
+
+/* Create an input stream that reads the chunks given by callback, in place.
+ * Only the current chunk has to be in memory. state is used by the stream
+ * and must outlive it. msgsize is the message size, or SIZE_MAX when the
+ * message ends with the data.
+ *
+ * Varints that are whole in a chunk, and in buffer streams, are decoded in
+ * place without calling the stream callback for each byte.
+ */
+pb_istream_t pb_istream_from_chunks(pb_chunk_state_t *state, pb_chunk_callback_t callback, void *context, size_t msgsize);
+#endif
+
 /* Function to read from a pb_istream_t. You can use this if you need to
  * read some custom header data, or to read data in field callbacks.
  */
@@ -141,6 +168,26 @@ bool pb_decode_fixed32(pb_istream_t *stream, void *dest);
  * a 8-byte wide C variable. */
 bool pb_decode_fixed64(pb_istream_t *stream, void *dest);
 
+/* Streaming decoding of a repeated submessage into one structure.
+ * Set funcs.decode of the callback field to pb_decode_repeated_item, and arg
+ * to a pb_repeated_item_t. Each item is decoded into dest_struct, which is
+ * reused, and given to callback. Only one item is in RAM at a time.
+ * Decoding is aborted when callback returns false.
+ */
+typedef struct pb_repeated_item_s
+{
+    const pb_field_t *fields;   /* Fields of the submessage */
+    void *dest_struct;          /* One submessage */
+    bool (*callback)(void *dest_struct, void *context);
+    void *context;
+} pb_repeated_item_t;
+
+#ifdef PB_OLD_CALLBACK_STYLE
+bool pb_decode_repeated_item(pb_istream_t *stream, const pb_field_t *field, void *arg);
+#else
+bool pb_decode_repeated_item(pb_istream_t *stream, const pb_field_t *field, void **arg);
+#endif
+
 /* Make a limited-length substream for reading a PB_WT_STRING field. */
 bool pb_make_string_substream(pb_istream_t *stream, pb_istream_t *substream);
 void pb_close_string_substream(pb_istream_t *stream, pb_istream_t *substream);
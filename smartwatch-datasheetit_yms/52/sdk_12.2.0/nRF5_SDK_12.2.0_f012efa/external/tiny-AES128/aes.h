@@ -18,7 +18,17 @@
   #define ECB 1
 #endif
 
+// AES128_TTABLE selects the implementation of the encryption rounds:
+// 0 is the compact byte-oriented version, 1 works on 32-bit columns with a 1 kB lookup table,
+// which is several times faster on Cortex-M0. Decryption is byte-oriented in both.
+#ifndef AES128_TTABLE
+  #define AES128_TTABLE 0
+#endif
+
+
 
+// The key expansion is kept for the last key that was used: calls with the same key
+// do not expand it again. The functions are not reentrant.
 
 #if defined(ECB) && ECB
 